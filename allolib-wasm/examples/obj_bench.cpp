@@ -0,0 +1,100 @@
+/**
+ * OBJ Parse Benchmark
+ *
+ * Times WebOBJ::parse on a generated ~1M-triangle grid OBJ, in the three
+ * common layouts (positions only, v//vn, v/vt/vn), then shows the mesh.
+ */
+
+#include "al_WebApp.hpp"
+#include "al_WebOBJ.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace al;
+
+// (n + 1)^2 vertices, 2 n^2 triangles; n = 708 gives just over 1M
+static std::string makeGridOBJ(int n, bool normals, bool texcoords) {
+    std::string obj;
+    obj.reserve(size_t(n + 1) * (n + 1) * 64 + size_t(n) * n * 64);
+    char line[128];
+    for (int y = 0; y <= n; y++) {
+        for (int x = 0; x <= n; x++) {
+            snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n",
+                     x / float(n) - 0.5f, y / float(n) - 0.5f, 0.02f * ((x * y) % 7));
+            obj += line;
+        }
+    }
+    if (texcoords) {
+        for (int y = 0; y <= n; y++) {
+            for (int x = 0; x <= n; x++) {
+                snprintf(line, sizeof(line), "vt %.6f %.6f\n", x / float(n), y / float(n));
+                obj += line;
+            }
+        }
+    }
+    if (normals) obj += "vn 0 0 1\n";
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            int a = y * (n + 1) + x + 1, b = a + 1, c = a + n + 1, d = c + 1;
+            if (normals && texcoords) {
+                snprintf(line, sizeof(line), "f %d/%d/1 %d/%d/1 %d/%d/1 %d/%d/1\n",
+                         a, a, b, b, d, d, c, c);
+            } else if (normals) {
+                snprintf(line, sizeof(line), "f %d//1 %d//1 %d//1 %d//1\n", a, b, d, c);
+            } else {
+                snprintf(line, sizeof(line), "f %d %d %d %d\n", a, b, d, c);
+            }
+            obj += line;
+        }
+    }
+    return obj;
+}
+
+class OBJBench : public WebApp {
+public:
+    Mesh mesh;
+    double angle = 0;
+
+    void onCreate() override {
+        const char* layouts[] = {"v", "v//vn", "v/vt/vn"};
+        bool optimize = MeshOptimizer::autoOptimize();
+        MeshOptimizer::setAutoOptimize(false);  // Parse time only
+
+        for (int layout = 0; layout < 3; layout++) {
+            std::string obj = makeGridOBJ(708, layout >= 1, layout == 2);
+            auto start = std::chrono::steady_clock::now();
+            WebOBJ::parse(reinterpret_cast<const uint8_t*>(obj.data()), obj.size(), mesh);
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            printf("[OBJBench] %-8s %6.1f MB  %7.1f ms  %6.1f MB/s  %zu vertices\n",
+                   layouts[layout], obj.size() / 1e6, ms, obj.size() / 1e3 / ms,
+                   mesh.vertices().size());
+        }
+
+        MeshOptimizer::setAutoOptimize(optimize);
+        nav().pos(0, 0, 2);
+    }
+
+    void onAnimate(double dt) override {
+        angle += dt * 20.0;
+    }
+
+    void onDraw(Graphics& g) override {
+        g.clear(0.1, 0.1, 0.15);
+        g.depthTesting(true);
+        g.lighting(true);
+        g.pushMatrix();
+        g.rotate(angle, 0, 1, 0);
+        g.color(0.9, 0.85, 0.8);
+        g.draw(mesh);
+        g.popMatrix();
+    }
+};
+
+int main() {
+    OBJBench app;
+    app.start();
+    return 0;
+}
@@ -6,10 +6,13 @@
  * - rotate
  * - scale
  * - Model/View/Projection matrices
+ * - A draw-heavy grid, with onDraw's CPU time reported every 300 frames
+ *   (the per-draw matrix work is in al_WebTransformSIMD.hpp)
  */
 
 #include "al_WebApp.hpp"
 #include "al/graphics/al_Shapes.hpp"
+#include <chrono>
 #include <cmath>
 
 using namespace al;
@@ -21,6 +24,10 @@ public:
     Mesh axes;
     double time = 0;
 
+    // onDraw timing
+    double drawMs = 0;
+    int drawFrames = 0;
+
     void onCreate() override {
         // Create cube
         addCube(cube, 0.5);
@@ -55,6 +62,8 @@ public:
     }
 
     void onDraw(Graphics& g) override {
+        auto start = std::chrono::steady_clock::now();
+
         g.clear(0.1f, 0.1f, 0.15f);
         g.depthTesting(true);
         g.lighting(true);
@@ -180,6 +189,35 @@ public:
         }
 
         g.popMatrix();
+
+        // === Test 5: Draw-heavy grid ===
+        // 20x20 small cubes, each with its own transform and lit draw
+        g.pushMatrix();
+        g.translate(0, -4, -6);
+        g.rotate(time * 10, 0, 1, 0);
+
+        for (int i = 0; i < 20; i++) {
+            for (int j = 0; j < 20; j++) {
+                g.pushMatrix();
+                g.translate((i - 9.5f) * 0.5f, 0, (j - 9.5f) * 0.5f);
+                g.rotate(time * 40 + i * 9 + j * 7, 1, 1, 0);
+                g.scale(0.15f);
+                g.color(HSV((i * 20 + j) / 400.0f, 0.6f, 1.0f));
+                g.draw(cube);
+                g.popMatrix();
+            }
+        }
+
+        g.popMatrix();
+
+        drawMs += std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - start).count();
+        if (++drawFrames == 300) {
+            std::cout << "[INFO] onDraw CPU: " << drawMs / drawFrames
+                      << " ms/frame (420 draws)" << std::endl;
+            drawMs = 0;
+            drawFrames = 0;
+        }
     }
 };
 
@@ -23,6 +23,7 @@
 
 #include "_studio_shared/audio_features.hpp"
 #include "_studio_shared/automation.hpp"
+#include "_studio_shared/batch_spatializer.hpp"
 #include "_studio_shared/draw_canvas.hpp"
 #include "_studio_shared/param_graph.hpp"
 #include "_studio_shared/pickable.hpp"
@@ -60,6 +61,8 @@ void smoke_post_fx() {
   (void)&studio::PostFXChain::beginCapture;
   (void)&studio::PostFXChain::endCaptureAndRender;
   (void)&studio::PostFXChain::setUniform;
+  (void)&studio::PostFXChain::setFusion;
+  (void)&studio::PostFXChain::passCount;
   fx.push(studio::FX::Phosphor, 0.92f);
   fx.push(studio::FX::Bloom, 0.6f);
   fx.push(studio::FX::Vignette, 0.4f);
@@ -75,6 +78,14 @@ void smoke_automation() {
   (void)&studio::AutomationLane::tick;
   (void)&studio::AutomationLane::saveCSV;
   (void)&studio::AutomationLane::loadCSV;
+  (void)&studio::AutomationLane::saveBinary;
+  (void)&studio::AutomationLane::loadBinary;
+  float control[128];
+  lane.renderBlock(0.0, 48000.0, control, 128);
+  (void)lane.valueAt(0.25);
+  (void)&studio::AutomationSet::saveBundleBinary;
+  (void)&studio::AutomationSet::loadBundleBinary;
+  (void)&studio::AutomationSet::renderBlock;
 }
 
 void smoke_draw_canvas() {
@@ -86,6 +97,12 @@ void smoke_draw_canvas() {
   (void)&studio::DrawCanvas::draw;
   (void)&studio::DrawCanvas::sampleAt;
   (void)&studio::DrawCanvas::sampleColumn;
+  (void)&studio::DrawCanvas::undo;
+  (void)&studio::DrawCanvas::grid;
+  (void)&studio::DrawCanvas::dirtyRect;
+  canvas.setGridSize(512);
+  std::vector<float> column(static_cast<size_t>(canvas.gridSize()));
+  canvas.readColumn(0.5f, column.data());
   canvas.clear();
 }
 
@@ -97,6 +114,10 @@ void smoke_param_graph() {
   (void)&studio::ParamGraph::tick;
   (void)&studio::ParamGraph::saveJSON;
   (void)&studio::ParamGraph::loadJSON;
+  graph.compile();
+  graph.evaluate();
+  graph.apply();
+  (void)graph.value(graph.slotOf(0));
   graph.tick(0.016f);
 }
 
@@ -108,6 +129,18 @@ void smoke_pickable() {
   studio::Ray r{al::Vec3f(0,0,0), al::Vec3f(0,0,-1)};
   studio::Hit h;
   (void)pk.intersect(r, h);
+  studio::MeshBVH bvh;
+  bvh.build(std::vector<al::Mesh::Vertex>{}, std::vector<unsigned>{});
+  (void)bvh.intersect(r.origin, r.direction);
+  studio::PickManager picks;
+  const int id = picks.add(pk);
+  picks.hover(r.origin, r.direction);
+  picks.onMouseDown(r.origin, r.direction);
+  picks.onMouseDrag(r.origin, r.direction);
+  picks.onMouseUp();
+  picks.moved(id);
+  (void)picks.pick(r.origin, r.direction).id;
+  picks.remove(id);
 }
 
 void smoke_pixel_audio_bridge() {
@@ -116,6 +149,16 @@ void smoke_pixel_audio_bridge() {
   bridge.writePixel(0, 0, row[0], row[1], row[2], row[3]);
   std::vector<uint8_t> out(512 * 4);
   bridge.readRow(0, out.data());
+  bridge.enableFrames(studio::PixelAudioBridge::Layout::ColumnMajor);
+  std::vector<uint8_t> image(bridge.frameBytes(), 0);
+  bridge.publishFrom(image);
+  if (uint8_t* back = bridge.backFrame()) back[0] = 1;
+  bridge.publishFrame();
+  (void)bridge.acquireFrame();
+  (void)bridge.column(0);
+  (void)bridge.row(0);
+  (void)bridge.pixel(1, 1);
+  (void)bridge.frameNumber();
 }
 
 void smoke_pv_resynth() {
@@ -124,6 +167,9 @@ void smoke_pv_resynth() {
   pv.analyze(in, 256);
   pv.resynthesize(out, 256);
   pv.setBinMag(0, 0.5f);
+  pv.applyGain(pv.magnitudes(), 0, pv.numBins());
+  pv.setPhases(pv.phases());
+  pv.scaleMagnitudes(0.5f, 4, 16);
   pv.freezeFrame(true);
 }
 
@@ -132,7 +178,27 @@ void smoke_web_convolver() {
   (void)&studio::WebConvolver::loadIR;
   (void)&studio::WebConvolver::process;
   (void)&studio::WebConvolver::setBlockSize;
+  (void)&studio::WebConvolver::setMaxPartitionSize;
   conv.setBlockSize(128);
+
+  studio::WebMultiConvolver multi;
+  (void)&studio::WebMultiConvolver::loadIRs;
+  (void)&studio::WebMultiConvolver::loadTrueStereo;
+  (void)&studio::WebMultiConvolver::process;
+  multi.setBlockSize(128);
+}
+
+void smoke_batch_spatializer() {
+  studio::BatchSpatializer spat(64, 48000.f, 128);
+  const int id = spat.addSource();
+  spat.setPosition(id, al::Vec3f(1, 0, -2));
+  spat.setListener(al::Pose());
+  spat.setBinauralVoices(8);
+  float src[128] = {0.f}, l[128] = {0.f}, r[128] = {0.f};
+  const float* in[64] = {nullptr};
+  in[id] = src;
+  spat.process(in, l, r, 128);
+  (void)spat.stats().culled;
 }
 
 void smoke_hrfilter() {
@@ -158,5 +224,6 @@ void smoke_all() {
   smoke_pixel_audio_bridge();
   smoke_pv_resynth();
   smoke_web_convolver();
+  smoke_batch_spatializer();
   smoke_hrfilter();
 }
@@ -18,15 +18,27 @@
 //   - Spectral (STFT): centroid, flatness, rolloff85, magBands[32]
 //   - MFCC: 13 coefficients via 26-band mel filterbank + DCT-II
 //   - Pitch: YIN algorithm (de Cheveigné & Kawahara 2002), parabolic-interp.
+//
+// Cost: pitch and MFCC are cheap enough to run on every hop. YIN's
+// difference function comes from one FFT cross-correlation (O(W log W),
+// not O(W²)), mel filters only visit their non-zero bins, and the spectral
+// sums run 4-wide with wasm SIMD128 over a contiguous magnitude copy.
+// cost() reports the time each stage takes per hop.
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
-#include <utility>
 #include <vector>
 
 #include "Gamma/DFT.h"
+#include "Gamma/FFT.h"
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
 
 namespace studio {
 
@@ -43,6 +55,20 @@ struct FeatureFrame {
   double timestampSec = 0.0;
 };
 
+// Per-hop processing time of each feature stage, in milliseconds. mean is an
+// exponential moving average; peak holds until resetCost(). Disabled stages
+// stay at 0.
+struct FeatureCost {
+  struct Stage {
+    float meanMs = 0.f;
+    float peakMs = 0.f;
+  };
+  Stage spectral;   // centroid, flatness, rolloff, magBands
+  Stage mfcc;
+  Stage pitch;
+  uint64_t hops = 0;
+};
+
 class AudioFeatureExtractor {
  public:
   AudioFeatureExtractor(int fftSize = 2048, int hop = 512,
@@ -59,9 +85,13 @@ class AudioFeatureExtractor {
         mWriteIdx(0),
         mSeq(0),
         mSamplesSeen(0),
+        mMag(static_cast<size_t>(fftSize / 2), 0.f),
         mYinW(fftSize / 2),
         mYinBufSize(fftSize),
+        mYinFFT(fftSize),
         mYinBuf(static_cast<size_t>(fftSize), 0.f),
+        mYinSpecA(static_cast<size_t>(fftSize + 2), 0.f),
+        mYinSpecB(static_cast<size_t>(fftSize + 2), 0.f),
         mYinDiff(static_cast<size_t>(fftSize / 2 + 1), 0.f),
         mYinCmnd(static_cast<size_t>(fftSize / 2 + 1), 1.f),
         mYinWriteIdx(0),
@@ -84,7 +114,9 @@ class AudioFeatureExtractor {
     mLastMfcc.fill(0.f);
   }
 
-  // Call from onSound() with the (possibly mixed-down) input buffer.
+  // Call from onSound() with the (possibly mixed-down) input buffer. For
+  // live input pass io.inBuffer(0) as is: the runtime fills it straight from
+  // the worklet's input ring, so the STFT window is the only copy made.
   // numFrames may be ≤256 (transpiler clamp); inner STFT hops every 512.
   void processBlock(const float* in, int numFrames) {
     if (!in || numFrames <= 0) return;
@@ -125,11 +157,17 @@ class AudioFeatureExtractor {
         f.rms = blockRms;
         f.peak = pk;
         f.zcr = blockZcr;
+        double t0 = nowMs();
         computeSpectral(f);
+        double t1 = nowMs();
+        addCost(mCost.spectral, t1 - t0);
 
         // MFCC — real DCT-II of log-mel-energies. Gated by mEnableMFCC.
         if (mEnableMFCC) {
           computeMfcc(f);
+          t0 = nowMs();
+          addCost(mCost.mfcc, t0 - t1);
+          t1 = t0;
           mLastMfcc = f.mfcc;
         } else {
           // Hold previous values so consumers don't see jumps when toggled off.
@@ -139,6 +177,7 @@ class AudioFeatureExtractor {
         // Pitch — YIN. Gated by mEnablePitch and a non-silent frame.
         if (mEnablePitch && mYinFilled >= mYinBufSize) {
           f.pitchHz = computeYin();
+          addCost(mCost.pitch, nowMs() - t1);
         } else if (mEnablePitch) {
           f.pitchHz = -1.f;  // not enough samples yet
         } else {
@@ -150,6 +189,7 @@ class AudioFeatureExtractor {
             static_cast<double>(mSamplesSeen + i) / mSampleRate;
         publish(f);
         ++mFrameCounter;
+        ++mCost.hops;
       }
     }
     mSamplesSeen += numFrames;
@@ -186,36 +226,149 @@ class AudioFeatureExtractor {
   int fftSize() const { return mFFTSize; }
   int hopSize() const { return mHop; }
 
+  // Per-stage processing time. Written on the audio thread without
+  // synchronization, so a read from another thread may mix two hops.
+  FeatureCost cost() const { return mCost; }
+  void resetCost() { mCost = FeatureCost(); }
+
  private:
+  static double nowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  static void addCost(FeatureCost::Stage& st, double ms) {
+    const float v = static_cast<float>(ms);
+    st.meanMs = st.meanMs == 0.f ? v : st.meanMs + 0.05f * (v - st.meanMs);
+    if (v > st.peakMs) st.peakMs = v;
+  }
+
+  // ---- SIMD reductions -----------------------------------------------------
+  // Σ x[i], i in [0, n)
+  static float sum(const float* x, int n) {
+    int i = 0;
+    float acc = 0.f;
+#if defined(__wasm_simd128__)
+    v128_t v = wasm_f32x4_splat(0.f);
+    for (; i + 4 <= n; i += 4) v = wasm_f32x4_add(v, wasm_v128_load(x + i));
+    acc = wasm_f32x4_extract_lane(v, 0) + wasm_f32x4_extract_lane(v, 1) +
+          wasm_f32x4_extract_lane(v, 2) + wasm_f32x4_extract_lane(v, 3);
+#endif
+    for (; i < n; ++i) acc += x[i];
+    return acc;
+  }
+
+  // Σ w[i]·x[i], i in [0, n)
+  static float dot(const float* w, const float* x, int n) {
+    int i = 0;
+    float acc = 0.f;
+#if defined(__wasm_simd128__)
+    v128_t v = wasm_f32x4_splat(0.f);
+    for (; i + 4 <= n; i += 4) {
+      v = wasm_f32x4_add(v, wasm_f32x4_mul(wasm_v128_load(w + i),
+                                           wasm_v128_load(x + i)));
+    }
+    acc = wasm_f32x4_extract_lane(v, 0) + wasm_f32x4_extract_lane(v, 1) +
+          wasm_f32x4_extract_lane(v, 2) + wasm_f32x4_extract_lane(v, 3);
+#endif
+    for (; i < n; ++i) acc += w[i] * x[i];
+    return acc;
+  }
+
+  // Σ (first+i)·x[i], i in [0, n)
+  static float rampDot(int first, const float* x, int n) {
+    int i = 0;
+    float acc = 0.f;
+#if defined(__wasm_simd128__)
+    v128_t v = wasm_f32x4_splat(0.f);
+    v128_t k = wasm_f32x4_make(float(first), float(first + 1), float(first + 2),
+                               float(first + 3));
+    const v128_t four = wasm_f32x4_splat(4.f);
+    for (; i + 4 <= n; i += 4) {
+      v = wasm_f32x4_add(v, wasm_f32x4_mul(k, wasm_v128_load(x + i)));
+      k = wasm_f32x4_add(k, four);
+    }
+    acc = wasm_f32x4_extract_lane(v, 0) + wasm_f32x4_extract_lane(v, 1) +
+          wasm_f32x4_extract_lane(v, 2) + wasm_f32x4_extract_lane(v, 3);
+#endif
+    for (; i < n; ++i) acc += static_cast<float>(first + i) * x[i];
+    return acc;
+  }
+
+  // Σ log2(x[i]) over x[i] > floor, and how many there were. Instead of a
+  // log per bin, values are multiplied into a running product whose
+  // exponent bits are moved into an integer sum after every step, leaving
+  // a mantissa in [1, 2); one log2 of the remaining mantissas at the end.
+  static float sumLog2(const float* x, int n, float floor, int& count) {
+    int i = 0;
+    int64_t exps = 0;
+    int cnt = 0;
+    float mant = 1.f;
+#if defined(__wasm_simd128__)
+    const v128_t vfloor = wasm_f32x4_splat(floor);
+    const v128_t one = wasm_f32x4_splat(1.f);
+    const v128_t mantMask = wasm_i32x4_splat(0x007fffff);
+    const v128_t oneBits = wasm_i32x4_splat(0x3f800000);
+    const v128_t bias = wasm_i32x4_splat(127);
+    v128_t vm = one;
+    v128_t ve = wasm_i32x4_splat(0);
+    v128_t vc = wasm_i32x4_splat(0);
+    for (; i + 4 <= n; i += 4) {
+      v128_t v = wasm_v128_load(x + i);
+      v128_t keep = wasm_f32x4_gt(v, vfloor);          // all-ones where counted
+      vc = wasm_i32x4_sub(vc, keep);                   // -(-1) per counted lane
+      v128_t p = wasm_f32x4_mul(vm, wasm_v128_bitselect(v, one, keep));
+      ve = wasm_i32x4_add(ve, wasm_i32x4_sub(wasm_u32x4_shr(p, 23), bias));
+      vm = wasm_v128_or(wasm_v128_and(p, mantMask), oneBits);
+    }
+    for (int l = 0; l < 4; ++l) {
+      exps += wasm_i32x4_extract_lane(ve, l);
+      cnt += wasm_i32x4_extract_lane(vc, l);
+    }
+    float lanes[4];
+    wasm_v128_store(lanes, vm);
+    for (int l = 0; l < 4; ++l) mant *= lanes[l];  // < 16: no overflow
+#endif
+    for (; i < n; ++i) {
+      if (!(x[i] > floor)) continue;
+      ++cnt;
+      const float p = mant * x[i];
+      uint32_t bits;
+      std::memcpy(&bits, &p, sizeof(bits));
+      exps += static_cast<int>(bits >> 23) - 127;
+      bits = (bits & 0x007fffffu) | 0x3f800000u;
+      std::memcpy(&mant, &bits, sizeof(bits));
+    }
+    count = cnt;
+    return static_cast<float>(static_cast<double>(exps) + std::log2(mant));
+  }
+
   // ---- Spectral features (centroid, flatness, rolloff85, magBands) ---------
   void computeSpectral(FeatureFrame& f) {
     // gam::STFT in MAG_FREQ mode stores magnitude in real() of each bin.
+    // Copy them out once so every reduction below (and MFCC) runs over
+    // contiguous floats.
     const gam::Complex<float>* bins = mStft.bins();
+    float* mag = mMag.data();
+    for (int k = 0; k < mNumBins; ++k) mag[k] = bins[k].r;
 
-    float sumMag = 0.f;
-    float sumMagF = 0.f;       // for centroid: Σ k·|X[k]|
-    float sumLogMag = 0.f;     // for flatness numerator
-    int countNonzero = 0;
     const float binHz = mSampleRate / static_cast<float>(mFFTSize);
 
     // Skip bin 0 (DC) and Nyquist for stability.
-    for (int k = 1; k < mNumBins; ++k) {
-      const float mag = bins[k].r;
-      sumMag += mag;
-      sumMagF += static_cast<float>(k) * mag;
-      if (mag > 1e-12f) {
-        sumLogMag += std::log(mag);
-        ++countNonzero;
-      }
-    }
+    const int n = mNumBins - 1;
+    const float sumMag = sum(mag + 1, n);
+    const float sumMagF = rampDot(1, mag + 1, n);   // for centroid: Σ k·|X[k]|
 
     if (sumMag > 1e-12f) {
       f.centroid = (sumMagF / sumMag) * binHz;
       // Spectral flatness: geometric mean / arithmetic mean.
-      const float arith = sumMag / static_cast<float>(mNumBins - 1);
+      int countNonzero = 0;
+      const float sumLog2Mag = sumLog2(mag + 1, n, 1e-12f, countNonzero);
+      const float arith = sumMag / static_cast<float>(n);
       const float geom =
           countNonzero > 0
-              ? std::exp(sumLogMag / static_cast<float>(countNonzero))
+              ? std::exp2(sumLog2Mag / static_cast<float>(countNonzero))
               : 0.f;
       f.flatness = arith > 1e-12f ? (geom / arith) : 0.f;
       if (f.flatness > 1.f) f.flatness = 1.f;
@@ -225,7 +378,7 @@ class AudioFeatureExtractor {
       float cum = 0.f;
       int rk = mNumBins - 1;
       for (int k = 1; k < mNumBins; ++k) {
-        cum += bins[k].r;
+        cum += mag[k];
         if (cum >= thresh) { rk = k; break; }
       }
       f.rolloff85 = static_cast<float>(rk) * binHz;
@@ -242,9 +395,7 @@ class AudioFeatureExtractor {
       if (lo < 1) lo = 1;
       if (hi > mNumBins) hi = mNumBins;
       if (hi <= lo) hi = lo + 1;
-      float acc = 0.f;
-      for (int k = lo; k < hi; ++k) acc += bins[k].r;
-      f.magBands[b] = acc / static_cast<float>(hi - lo);
+      f.magBands[b] = sum(mag + lo, hi - lo) / static_cast<float>(hi - lo);
     }
   }
 
@@ -259,8 +410,8 @@ class AudioFeatureExtractor {
 
   void buildMelFilterbank() {
     const int M = 26;
-    mMelFilters.clear();
-    mMelFilters.resize(static_cast<size_t>(M));
+    mMelFilters.assign(static_cast<size_t>(M), MelFilter());
+    mMelWeights.clear();
 
     const float fLo = 80.f;
     const float fHi = 0.5f * mSampleRate;
@@ -298,7 +449,18 @@ class AudioFeatureExtractor {
         }
         w[static_cast<size_t>(k - kL)] = v;
       }
-      mMelFilters[static_cast<size_t>(m)] = std::make_pair(kL, std::move(w));
+
+      // Keep only the non-zero span [first, last] of the triangle.
+      int first = 0;
+      int last = static_cast<int>(w.size()) - 1;
+      while (first <= last && w[static_cast<size_t>(first)] == 0.f) ++first;
+      while (last >= first && w[static_cast<size_t>(last)] == 0.f) --last;
+      MelFilter& filt = mMelFilters[static_cast<size_t>(m)];
+      filt.startBin = kL + first;
+      filt.count = last - first + 1;
+      filt.offset = static_cast<int>(mMelWeights.size());
+      mMelWeights.insert(mMelWeights.end(), w.begin() + first,
+                         w.begin() + first + filt.count);
     }
   }
 
@@ -316,34 +478,28 @@ class AudioFeatureExtractor {
     }
   }
 
+  // Uses the magnitudes computeSpectral() copied into mMag this hop.
   void computeMfcc(FeatureFrame& f) {
-    const gam::Complex<float>* bins = mStft.bins();
     const int M = static_cast<int>(mMelFilters.size());
     const int C = 13;
 
-    // 1) mel-filter energies + log
+    // 1) mel-filter energies + log. Filter spans are clamped to
+    //    [1, mNumBins) when built, so no per-bin bounds checks here.
     float logMel[32];  // M=26, headroom of 32
     for (int m = 0; m < M; ++m) {
-      const auto& filt = mMelFilters[static_cast<size_t>(m)];
-      const int kStart = filt.first;
-      const std::vector<float>& w = filt.second;
-      float energy = 0.f;
-      const int n = static_cast<int>(w.size());
-      for (int i = 0; i < n; ++i) {
-        const int k = kStart + i;
-        if (k < 1 || k >= mNumBins) continue;
-        energy += w[static_cast<size_t>(i)] * bins[k].r;
-      }
+      const MelFilter& filt = mMelFilters[static_cast<size_t>(m)];
+      const float energy =
+          filt.count > 0 ? dot(&mMelWeights[static_cast<size_t>(filt.offset)],
+                               &mMag[static_cast<size_t>(filt.startBin)],
+                               filt.count)
+                         : 0.f;
       logMel[m] = std::log(energy > 1e-10f ? energy : 1e-10f);
     }
 
     // 2) DCT-II → 13 cepstral coeffs.
     for (int c = 0; c < C; ++c) {
-      float acc = 0.f;
-      for (int m = 0; m < M; ++m) {
-        acc += logMel[m] * mDct[static_cast<size_t>(c * M + m)];
-      }
-      f.mfcc[static_cast<size_t>(c)] = acc;
+      f.mfcc[static_cast<size_t>(c)] =
+          dot(&mDct[static_cast<size_t>(c * M)], logMel, M);
     }
   }
 
@@ -355,23 +511,60 @@ class AudioFeatureExtractor {
 
     const int W = mYinW;  // = fftSize/2 = 1024 for default config
 
-    // Linearize the ring buffer into a flat view via index math.
-    // x(j) = mYinBuf[(start + j) % bufSize], where start = mYinWriteIdx (oldest).
-    const int bufSize = mYinBufSize;
+    // Step 1: difference function d[τ] = Σ (x[j] - x[j+τ])², j in [0,W),
+    // expanded as e0 + e[τ] - 2·r[τ]:
+    //   e0   = Σ x[j]²,        j in [0,W)
+    //   e[τ] = Σ x[j+τ]²,      j in [0,W)   (sliding, updated per τ)
+    //   r[τ] = Σ x[j]·x[j+τ],  j in [0,W)   (cross-correlation via FFT)
+    // r comes from a circular correlation of length 2W between the first W
+    // samples (zero-padded) and all 2W; j+τ < 2W for τ ≤ W, so nothing wraps.
+    //
+    // RFFT complexBuf=true layout: samples at [1..N], spectrum interleaved
+    // [r0,0,r1,i1,...,r(N/2),0] in N+2 floats (N = 2W = mYinBufSize).
+    const int N = mYinBufSize;
     const int start = mYinWriteIdx;  // oldest sample (next slot to overwrite)
+    float* a = mYinSpecA.data();
+    float* b = mYinSpecB.data();
+    std::memset(a, 0, mYinSpecA.size() * sizeof(float));
+    b[0] = 0.f;
+    b[N + 1] = 0.f;
+    // Linearize the ring: x[j] = mYinBuf[(start + j) % N], oldest first.
+    const int tail = N - start;
+    std::memcpy(b + 1, &mYinBuf[static_cast<size_t>(start)],
+                static_cast<size_t>(tail) * sizeof(float));
+    std::memcpy(b + 1 + tail, mYinBuf.data(),
+                static_cast<size_t>(start) * sizeof(float));
+    std::memcpy(a + 1, b + 1, static_cast<size_t>(W) * sizeof(float));
+    const float* x = b + 1;
+
+    double e0 = 0.0;
+    for (int j = 0; j < W; ++j) e0 += static_cast<double>(x[j]) * x[j];
+    double e = e0;  // e[0]
+
+    mYinFFT.forward(a, /*complexBuf=*/true, /*normalize=*/false);
+    mYinFFT.forward(b, /*complexBuf=*/true, /*normalize=*/false);
+    // b ← conj(A)·B
+    for (int k = 0; k <= N / 2; ++k) {
+      const float ar = a[2 * k], ai = a[2 * k + 1];
+      const float br = b[2 * k], bi = b[2 * k + 1];
+      b[2 * k] = ar * br + ai * bi;
+      b[2 * k + 1] = ar * bi - ai * br;
+    }
+    mYinFFT.inverse(b, /*complexBuf=*/true);
+    const float norm = 1.f / static_cast<float>(N);
+
+    // e[τ] slides by dropping x[τ-1]² and adding x[τ-1+W]²; the samples
+    // were overwritten by the FFT, so read them back from the ring.
     auto X = [&](int j) -> float {
-      return mYinBuf[static_cast<size_t>((start + j) % bufSize)];
+      return mYinBuf[static_cast<size_t>((start + j) % N)];
     };
-
-    // Step 1: difference function d[τ] = Σ (x[j] - x[j+τ])², j in [0,W).
     mYinDiff[0] = 0.f;
     for (int tau = 1; tau <= W; ++tau) {
-      float acc = 0.f;
-      for (int j = 0; j < W; ++j) {
-        const float dx = X(j) - X(j + tau);
-        acc += dx * dx;
-      }
-      mYinDiff[static_cast<size_t>(tau)] = acc;
+      const double xo = X(tau - 1);
+      const double xn = X(tau - 1 + W);
+      e += xn * xn - xo * xo;
+      const double d = e0 + e - 2.0 * static_cast<double>(b[1 + tau] * norm);
+      mYinDiff[static_cast<size_t>(tau)] = d > 0.0 ? static_cast<float>(d) : 0.f;
     }
 
     // Step 2: cumulative mean normalized difference.
@@ -464,9 +657,20 @@ class AudioFeatureExtractor {
 
   float mBandEdges[33] = {0};
 
+  // Contiguous magnitudes of the current hop (bins 0..N/2-1).
+  std::vector<float> mMag;
+  FeatureCost mCost;
+
   // ---- Mel filterbank + DCT (preallocated in ctor / setSampleRate) --------
-  // Each entry: (startBin, weights[]) — applied as energy += w[i]*|X[start+i]|.
-  std::vector<std::pair<int, std::vector<float>>> mMelFilters;
+  // Each filter covers only its non-zero bins:
+  //   energy = Σ mMelWeights[offset+i] · mMag[startBin+i], i in [0, count).
+  struct MelFilter {
+    int startBin = 1;
+    int count = 0;
+    int offset = 0;
+  };
+  std::vector<MelFilter> mMelFilters;
+  std::vector<float> mMelWeights;
   // Row-major 13×26 DCT-II cosine matrix.
   std::vector<float> mDct;
   // Last MFCC vector — used to hold values when mEnableMFCC is toggled off.
@@ -475,7 +679,10 @@ class AudioFeatureExtractor {
   // ---- YIN buffers ---------------------------------------------------------
   int mYinW;          // window length = fftSize/2
   int mYinBufSize;    // ring buffer size = 2*W = fftSize
+  gam::RFFT<float> mYinFFT;       // size 2W, for the correlation
   std::vector<float> mYinBuf;     // ring buffer of recent samples
+  std::vector<float> mYinSpecA;   // first W samples → spectrum (N+2)
+  std::vector<float> mYinSpecB;   // all 2W samples → spectrum → r[τ] (N+2)
   std::vector<float> mYinDiff;    // d[τ], size W+1
   std::vector<float> mYinCmnd;    // d'[τ], size W+1
   int mYinWriteIdx;  // next slot in mYinBuf (also = oldest sample)
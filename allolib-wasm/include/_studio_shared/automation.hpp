@@ -18,16 +18,28 @@
  * supplied per lane; if no font is set, the lane prints its index/name to
  * stdout via printf so the user can still tell lanes apart by color.
  *
+ * Lookup: playback keeps a cursor on the current segment, so a tick or a
+ * sample only looks at the next breakpoint or two; jumps (loop wrap,
+ * seek) fall back to a binary search. renderBlock() writes a lane
+ * straight into a per-sample control buffer for onSound(), ramping
+ * linearly inside each segment, so dense lanes can drive audio
+ * parameters at sample accuracy without going through Parameter::set().
+ *
  * Persistence: per-lane CSV (time,value) and an AutomationSet bundle that
  * concatenates all lanes into one CSV with a leading header row of names
- * and an unrolled "lane,time,value" body. Both round-trip on /-rooted
- * paths, which resolve to IDBFS in the web build (see compile.sh
- * -lidbfs.js linkage).
+ * and an unrolled "lane,time,value" body. saveBinary()/saveBundleBinary()
+ * write the same data as a compact little-endian binary (12 bytes per
+ * breakpoint, exact doubles) for dense lanes where CSV is slow and lossy.
+ * All of them round-trip on /-rooted paths, which resolve to IDBFS in the
+ * web build (see compile.sh -lidbfs.js linkage).
  *
  * Threading: callbacks fire on the parameter owner's thread (typically the
  * main / graphics thread); we never spawn threads. State coordination uses
  * std::atomic for the small flag bits that may be inspected from a
  * different stack frame, but all mutation runs on the owning thread.
+ * renderBlock() may run on the audio thread: it only reads breakpoints and
+ * owns its cursor, so don't record into or load a lane while audio is
+ * rendering it.
  */
 
 #include "al/graphics/al_Graphics.hpp"
@@ -38,7 +50,9 @@
 #include <algorithm>
 #include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <memory>
 #include <sstream>
@@ -60,6 +74,18 @@
 // v0.10.3: dropped surrounding `namespace al` to match the other helpers (file-scope ::studio)
 namespace studio {
 
+// Persist IDBFS so writes survive a browser reload.
+inline void syncAutomationFS() {
+#ifdef __EMSCRIPTEN__
+  EM_ASM({
+    try {
+      if (typeof FS !== 'undefined' && FS.syncfs)
+        FS.syncfs(false, function(err) {});
+    } catch (e) {}
+  });
+#endif
+}
+
 struct Breakpoint {
   double t;       // seconds since startRecording
   float value;    // parameter value at this instant
@@ -160,29 +186,70 @@ public:
     }
     if (t < 0.0) t = 0.0;
 
-    // Advance cursor forward to the segment that brackets t. Reset to 0
-    // if t went backward (loop wrap or external reset).
-    if (mPlayCursor + 1 >= mBreakpoints.size() ||
-        t < mBreakpoints[mPlayCursor].t) {
-      mPlayCursor = 0;
-    }
-    while (mPlayCursor + 1 < mBreakpoints.size() &&
-           mBreakpoints[mPlayCursor + 1].t < t) {
-      ++mPlayCursor;
-    }
+    setTargetSilently(interpolate(t, segmentAt(t, mPlayCursor)));
+    mLastPlayheadT = t;
+  }
+
+  // Curve value at time t (seconds from the start of the curve), held
+  // flat outside it. Binary search; no cursor.
+  float valueAt(double t) const {
+    if (mBreakpoints.empty()) return mTarget->get();
+    if (mBreakpoints.size() == 1) return mBreakpoints.front().value;
+    return interpolate(t, seek(t));
+  }
 
-    const Breakpoint& a = mBreakpoints[mPlayCursor];
-    const Breakpoint& b =
-        mBreakpoints[std::min(mPlayCursor + 1, mBreakpoints.size() - 1)];
-    float v;
-    if (b.t <= a.t) {
-      v = a.value;
-    } else {
-      const double u = (t - a.t) / (b.t - a.t);
-      v = static_cast<float>(a.value + (b.value - a.value) * u);
+  // Render the curve into one value per sample, starting at curve time
+  // t0 (seconds) and stepping 1/sampleRate. Follows setLoop(); past the
+  // end of a non-looping curve it holds the last value. Safe to call
+  // from onSound(): no allocation, no Parameter writes. A lane with no
+  // breakpoints fills with the parameter's current value.
+  void renderBlock(double t0, double sampleRate, float* out, int frames) {
+    if (!out || frames <= 0 || sampleRate <= 0.0) return;
+    const size_t n = mBreakpoints.size();
+    if (n < 2) {
+      const float v = n ? mBreakpoints.front().value : mTarget->get();
+      std::fill(out, out + frames, v);
+      return;
+    }
+    const double total = mBreakpoints.back().t;
+    const double dt = 1.0 / sampleRate;
+    const bool wrap = mLoop && total > 0.0;
+    int i = 0;
+    while (i < frames) {
+      // Sample times come from t0 each run, so long blocks don't drift
+      double t = t0 + i * dt;
+      if (t >= total) {
+        if (!wrap) {
+          std::fill(out + i, out + frames, mBreakpoints.back().value);
+          return;
+        }
+        t = std::fmod(t, total);
+      }
+      const size_t s = segmentAt(t, mBlockCursor);
+      const Breakpoint& a = mBreakpoints[s];
+      const Breakpoint& b = mBreakpoints[s + 1];
+      // Samples before the next breakpoint (at least one, so a run
+      // always advances)
+      const double next = t < a.t ? a.t : b.t;
+      int run = frames - i;
+      if (t < next) {
+        const double left = std::ceil((next - t) * sampleRate);
+        if (left < run) run = left < 1.0 ? 1 : static_cast<int>(left);
+      } else {
+        run = 1;
+      }
+      if (b.t <= a.t || t < a.t) {
+        std::fill(out + i, out + i + run, interpolate(t, s));
+      } else {
+        const double slope = (b.value - a.value) / (b.t - a.t);
+        const double v0 = a.value + slope * (t - a.t);
+        const double step = slope * dt;
+        for (int k = 0; k < run; ++k) {
+          out[i + k] = static_cast<float>(v0 + step * k);
+        }
+      }
+      i += run;
     }
-    setTargetSilently(v);
-    mLastPlayheadT = t;
   }
 
   // ----------------------- introspection -------------------------------
@@ -209,6 +276,7 @@ public:
   // ----------------------- font label (optional) -----------------------
 #if AL_STUDIO_AUTOMATION_HAS_WEBFONT
   void setFont(al::WebFont* f) { mFont = f; }
+  al::WebFont* font() const { return mFont; }
 #endif
 
   // ----------------------- drawing -------------------------------------
@@ -218,8 +286,9 @@ public:
   // parameter's [min, max] are mapped to y=[0, h]; time is mapped to
   // x=[0, w] using the lane's full duration. A vertical playhead line is
   // drawn during playback; a record indicator dot is drawn during
-  // recording.
-  void drawCurve(al::Graphics& g, float w, float h) {
+  // recording. The name label (with a font set) can be left to the
+  // caller, as AutomationSet does to batch all lane names.
+  void drawCurve(al::Graphics& g, float w, float h, bool drawLabel = true) {
     if (w <= 0.f || h <= 0.f) return;
 
     const float pmin = mTarget->min();
@@ -284,9 +353,11 @@ public:
     }
 
 #if AL_STUDIO_AUTOMATION_HAS_WEBFONT
-    if (mFont) {
+    if (mFont && drawLabel) {
       mFont->render(g, mName, 6.f, h - 18.f);
     }
+#else
+    (void)drawLabel;
 #endif
   }
 
@@ -305,15 +376,7 @@ public:
     }
     out.flush();
     if (!out) return false;
-#ifdef __EMSCRIPTEN__
-    // Persist IDBFS so writes survive a browser reload.
-    EM_ASM({
-      try {
-        if (typeof FS !== 'undefined' && FS.syncfs)
-          FS.syncfs(false, function(err) {});
-      } catch (e) {}
-    });
-#endif
+    syncAutomationFS();
     return true;
   }
 
@@ -340,10 +403,126 @@ public:
     }
     if (bps.empty()) return false;
     mBreakpoints = std::move(bps);
+    resetCursors();
+    return true;
+  }
+
+  // ----------------------- binary I/O ----------------------------------
+  // "ALAN", u32 version, then one lane record: u32 name length, name,
+  // u32 count, count x (f64 time, f32 value). Little-endian, as in wasm
+  // memory.
+
+  bool saveBinary(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    out.write(kLaneMagic, 4);
+    putU32(out, kBinaryVersion);
+    writeRecord(out, mName, mBreakpoints);
+    out.flush();
+    if (!out) return false;
+    syncAutomationFS();
+    return true;
+  }
+
+  bool loadBinary(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    uint32_t version = 0;
+    if (!in.read(magic, 4) || std::memcmp(magic, kLaneMagic, 4) != 0 ||
+        !getU32(in, version) || version != kBinaryVersion) {
+      return false;
+    }
+    std::string name;
+    std::vector<Breakpoint> bps;
+    if (!readRecord(in, name, bps) || bps.empty()) return false;
+    mBreakpoints = std::move(bps);
+    resetCursors();
     return true;
   }
 
 private:
+  friend class AutomationSet;
+
+  static constexpr const char* kLaneMagic = "ALAN";
+  static constexpr const char* kSetMagic = "ALAS";
+  static constexpr uint32_t kBinaryVersion = 1;
+  // Upper bounds that keep a corrupt header from allocating gigabytes
+  static constexpr uint32_t kMaxNameBytes = 4096;
+  static constexpr uint32_t kMaxBreakpoints = 1u << 26;
+
+  static void putU32(std::ostream& out, uint32_t v) {
+    out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+  }
+  static bool getU32(std::istream& in, uint32_t& v) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&v), sizeof(v)));
+  }
+
+  static void writeRecord(std::ostream& out, const std::string& name,
+                          const std::vector<Breakpoint>& bps) {
+    putU32(out, static_cast<uint32_t>(name.size()));
+    out.write(name.data(), static_cast<std::streamsize>(name.size()));
+    putU32(out, static_cast<uint32_t>(bps.size()));
+    for (const auto& bp : bps) {
+      out.write(reinterpret_cast<const char*>(&bp.t), sizeof(bp.t));
+      out.write(reinterpret_cast<const char*>(&bp.value), sizeof(bp.value));
+    }
+  }
+
+  static bool readRecord(std::istream& in, std::string& name,
+                         std::vector<Breakpoint>& bps) {
+    uint32_t len = 0, count = 0;
+    if (!getU32(in, len) || len > kMaxNameBytes) return false;
+    name.resize(len);
+    if (len && !in.read(&name[0], len)) return false;
+    if (!getU32(in, count) || count > kMaxBreakpoints) return false;
+    bps.resize(count);
+    for (auto& bp : bps) {
+      if (!in.read(reinterpret_cast<char*>(&bp.t), sizeof(bp.t)) ||
+          !in.read(reinterpret_cast<char*>(&bp.value), sizeof(bp.value))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void resetCursors() {
+    mPlayCursor = 0;
+    mBlockCursor = 0;
+  }
+
+  // Segment [s, s+1] for time t (needs >= 2 breakpoints): a.t <= t < b.t,
+  // clamped to the first/last segment. Checks the cached segment and the
+  // one after it before searching, so playback is O(1) amortized.
+  size_t segmentAt(double t, size_t& cursor) const {
+    const size_t last = mBreakpoints.size() - 2;
+    size_t c = cursor > last ? last : cursor;
+    if (t >= mBreakpoints[c].t) {
+      if (c == last || t < mBreakpoints[c + 1].t) return cursor = c;
+      if (c + 1 == last || t < mBreakpoints[c + 2].t) return cursor = c + 1;
+    } else if (c == 0) {
+      return cursor = 0;
+    }
+    return cursor = seek(t);
+  }
+
+  size_t seek(double t) const {
+    const size_t last = mBreakpoints.size() - 2;
+    const auto it = std::upper_bound(
+        mBreakpoints.begin(), mBreakpoints.end(), t,
+        [](double x, const Breakpoint& bp) { return x < bp.t; });
+    const size_t first = static_cast<size_t>(it - mBreakpoints.begin());
+    return first == 0 ? 0 : std::min(first - 1, last);
+  }
+
+  float interpolate(double t, size_t s) const {
+    const Breakpoint& a = mBreakpoints[s];
+    const Breakpoint& b = mBreakpoints[s + 1];
+    if (b.t <= a.t || t <= a.t) return a.value;
+    if (t >= b.t) return b.value;
+    const double u = (t - a.t) / (b.t - a.t);
+    return static_cast<float>(a.value + (b.value - a.value) * u);
+  }
+
   void setTargetSilently(float v) {
     // We don't have a public unregister, so we suppress recording while
     // the lane itself drives the parameter via the gate flag.
@@ -387,6 +566,7 @@ private:
   double mPlayStart{0.0};
   double mLastPlayheadT{0.0};
   size_t mPlayCursor{0};
+  size_t mBlockCursor{0};  // renderBlock()'s, so audio and tick() don't fight
   al::Color mColor{0.4f, 0.85f, 1.f, 1.f};
 #if AL_STUDIO_AUTOMATION_HAS_WEBFONT
   al::WebFont* mFont{nullptr};
@@ -451,13 +631,25 @@ public:
     const float gap = 4.f;
     const float laneH = std::max(8.f, (h - gap * (mLanes.size() - 1)) /
                                           static_cast<float>(mLanes.size()));
+#if AL_STUDIO_AUTOMATION_HAS_WEBFONT
+    // Lane names go into one batch drawn after the curves
+    mLabels.clear();
+#endif
     for (size_t i = 0; i < mLanes.size(); ++i) {
       const float ly = y + i * (laneH + gap);
       g.pushMatrix();
       g.translate(x, ly);
-      mLanes[i]->drawCurve(g, w, laneH);
+      mLanes[i]->drawCurve(g, w, laneH, false);
       g.popMatrix();
+#if AL_STUDIO_AUTOMATION_HAS_WEBFONT
+      if (al::WebFont* font = mLanes[i]->font()) {
+        mLabels.add(*font, mLanes[i]->name(), x + 6.f, ly + laneH - 18.f);
+      }
+#endif
     }
+#if AL_STUDIO_AUTOMATION_HAS_WEBFONT
+    mLabels.draw(g);
+#endif
   }
 
   // ----------------------- bundle I/O ----------------------------------
@@ -482,14 +674,7 @@ public:
     }
     out.flush();
     if (!out) return false;
-#ifdef __EMSCRIPTEN__
-    EM_ASM({
-      try {
-        if (typeof FS !== 'undefined' && FS.syncfs)
-          FS.syncfs(false, function(err) {});
-      } catch (e) {}
-    });
-#endif
+    syncAutomationFS();
     return true;
   }
 
@@ -521,11 +706,65 @@ public:
         continue;
       }
     }
+    for (auto& l : mLanes) l->resetCursors();
+    return true;
+  }
+
+  // Binary bundle: "ALAS", u32 version, u32 lane count, then one
+  // AutomationLane::saveBinary() record per lane. Loads by index like
+  // loadBundle(); the stored names are informational.
+  bool saveBundleBinary(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    out.write(AutomationLane::kSetMagic, 4);
+    AutomationLane::putU32(out, AutomationLane::kBinaryVersion);
+    AutomationLane::putU32(out, static_cast<uint32_t>(mLanes.size()));
+    for (const auto& l : mLanes) {
+      AutomationLane::writeRecord(out, l->name(), l->breakpoints());
+    }
+    out.flush();
+    if (!out) return false;
+    syncAutomationFS();
+    return true;
+  }
+
+  bool loadBundleBinary(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    uint32_t version = 0, lanes = 0;
+    if (!in.read(magic, 4) ||
+        std::memcmp(magic, AutomationLane::kSetMagic, 4) != 0 ||
+        !AutomationLane::getU32(in, version) ||
+        version != AutomationLane::kBinaryVersion ||
+        !AutomationLane::getU32(in, lanes) || lanes > kMaxBinaryLanes) {
+      return false;
+    }
+    // Read everything first so a truncated file leaves the lanes intact
+    std::vector<std::vector<Breakpoint>> loaded(lanes);
+    std::string name;
+    for (auto& bps : loaded) {
+      if (!AutomationLane::readRecord(in, name, bps)) return false;
+    }
+    for (size_t i = 0; i < loaded.size() && i < mLanes.size(); ++i) {
+      mLanes[i]->breakpoints() = std::move(loaded[i]);
+      mLanes[i]->resetCursors();
+    }
     return true;
   }
 
+  // Render lane i into out (see AutomationLane::renderBlock)
+  void renderBlock(size_t i, double t0, double sampleRate, float* out,
+                   int frames) {
+    if (i < mLanes.size()) mLanes[i]->renderBlock(t0, sampleRate, out, frames);
+  }
+
 private:
+  static constexpr uint32_t kMaxBinaryLanes = 4096;
+
   std::vector<std::unique_ptr<AutomationLane>> mLanes;
+#if AL_STUDIO_AUTOMATION_HAS_WEBFONT
+  al::TextBatch mLabels;
+#endif
   // drawAllImGui() needs a Graphics* but the API is parameterless; set
   // by drawAllAt() so the no-arg form keeps working after the explicit
   // form has been called once. Examples that only call drawAllImGui()
@@ -0,0 +1,470 @@
+#pragma once
+
+/**
+ * AlloLib Studio Online - BatchSpatializer
+ *
+ * Block-based binaural spatializer for scenes with hundreds of moving
+ * sources. gam::HRFilter / HRScene<N> run one filter chain per source, per
+ * sample (see _hrfilter_notes.md), which tops out at a few dozen sources.
+ * BatchSpatializer keeps the parts of that model that carry most of the
+ * localisation -- spherical-head ITD, far-ear head shadow, rear darkening,
+ * distance roll-off and air absorption -- and runs them on all sources at
+ * once:
+ *
+ *   - Source state is structure-of-arrays indexed by source id.
+ *   - Binaural tier: the loudest binauralVoices() sources (default 32) run
+ *     four per wasm SIMD128 vector -- fractional ITD delay, one-pole
+ *     shadow filter and gain per ear, one lane per source.
+ *   - Panned tier: the remaining audible sources get a constant-power
+ *     stereo pan (al_WebAudioSIMD mixRamp), no filtering.
+ *   - Culled: sources quieter than cullThreshold() (distance and gain
+ *     combined) or past the far distance cost nothing.
+ *
+ * Tiers are re-ranked every block by audible gain. Gains, ITD and filter
+ * cutoffs are ramped across the block, and a source changing tier
+ * crossfades between the two, so moving sources don't click.
+ *
+ * Coordinates are AlloLib's: listener right = pose.ur(), forward =
+ * pose.uf(). There is no elevation cue beyond rear darkening; use
+ * gam::HRFilter for a handful of sources that need pinna cues.
+ *
+ * Thread model: everything runs on the audio thread (or the main thread
+ * between blocks in the default build). Nothing allocates after
+ * construction except setMaxBlock().
+ *
+ * Header-only. Depends on al::Pose and al_WebAudioSIMD.hpp.
+ *
+ * Usage:
+ *
+ *   studio::BatchSpatializer spat(512, audioIO().framesPerSecond());
+ *   int id = spat.addSource();
+ *   // per block (onSound):
+ *   spat.setListener(nav());
+ *   spat.setPosition(id, pos);
+ *   spat.process(sourceBlocks, io.outBuffer(0), io.outBuffer(1),
+ *                io.framesPerBuffer());   // sourceBlocks[id] = mono block
+ */
+
+#include "al/math/al_Vec.hpp"
+#include "al/spatial/al_Pose.hpp"
+
+#include "al_WebAudioSIMD.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+namespace studio {
+
+struct SpatializerStats {
+  int binaural = 0;  // rendered with ITD + head shadow
+  int panned = 0;    // far-field constant-power pan
+  int culled = 0;    // inaudible, skipped
+};
+
+class BatchSpatializer {
+public:
+  // Per-source ITD history; bounds the delay to kHistory - 2 samples
+  // (1.3 ms at 48 kHz, a spherical head needs ~0.7 ms).
+  static constexpr int kHistory = 64;
+
+  BatchSpatializer(int maxSources = 256, float sampleRate = 48000.f,
+                   int maxBlock = 512)
+      : mMaxSources(std::max(1, maxSources)),
+        mSampleRate(sampleRate > 0.f ? sampleRate : 48000.f) {
+    const size_t n = static_cast<size_t>(mMaxSources);
+    mActive.assign(n, 0);
+    mX.assign(n, 0.f);
+    mY.assign(n, 0.f);
+    mZ.assign(n, 0.f);
+    mGain.assign(n, 1.f);
+    mTarget.assign(n, 0.f);
+    for (auto* v : {&mBinL, &mBinR, &mPanL, &mPanR, &mDelayL, &mDelayR,
+                    &mStateL, &mStateR, &mTgtBinL, &mTgtBinR, &mTgtPanL,
+                    &mTgtPanR, &mTgtDelayL, &mTgtDelayR, &mTgtCoefL, &mTgtCoefR})
+      v->assign(n, 0.f);
+    mLive.assign(n, 0);
+    // One extra history row for padding lanes, always silent
+    mHistory.assign((n + 1) * kHistory, 0.f);
+    mOrder.reserve(n);
+    mGroup.reserve(n);
+    setMaxBlock(maxBlock);
+  }
+
+  // ---- sources -------------------------------------------------------
+  // Returns a source id in [0, maxSources), or -1 when all are in use.
+  int addSource() {
+    for (int i = 0; i < mMaxSources; ++i) {
+      if (mActive[i]) continue;
+      mActive[i] = 1;
+      mGain[i] = 1.f;
+      mX[i] = mY[i] = 0.f;
+      mZ[i] = -1.f;
+      mBinL[i] = mBinR[i] = mPanL[i] = mPanR[i] = 0.f;
+      mLive[i] = 0;
+      return i;
+    }
+    return -1;
+  }
+
+  // Stops the source at once (no fade); fade with setGain first if needed.
+  void removeSource(int id) {
+    if (!valid(id)) return;
+    mActive[id] = 0;
+    mLive[id] = 0;
+    mBinL[id] = mBinR[id] = mPanL[id] = mPanR[id] = 0.f;
+  }
+
+  void setPosition(int id, float x, float y, float z) {
+    if (!valid(id)) return;
+    mX[id] = x;
+    mY[id] = y;
+    mZ[id] = z;
+  }
+  void setPosition(int id, const al::Vec3f& p) { setPosition(id, p.x, p.y, p.z); }
+
+  void setGain(int id, float g) {
+    if (valid(id)) mGain[id] = g;
+  }
+
+  // ---- listener ------------------------------------------------------
+  void setListener(const al::Pose& pose) {
+    const al::Vec3d p = pose.pos(), r = pose.ur(), f = pose.uf();
+    for (int i = 0; i < 3; ++i) {
+      mListenerPos[i] = static_cast<float>(p[i]);
+      mRight[i] = static_cast<float>(r[i]);
+      mForward[i] = static_cast<float>(f[i]);
+    }
+  }
+
+  // ---- model ---------------------------------------------------------
+  // Inverse-distance roll-off: gain = ref / (ref + rolloff * (d - ref)),
+  // 1 inside ref, fading to 0 over the last 10% before far.
+  void setDistanceModel(float ref, float far, float rolloff = 1.f) {
+    mRefDistance = std::max(1e-3f, ref);
+    mFarDistance = std::max(mRefDistance * 1.01f, far);
+    mRolloff = std::max(0.f, rolloff);
+  }
+  // Interaural distance in metres (HRFilter::earDist); ITD follows
+  // Woodworth's spherical-head formula.
+  void earDist(float metres) { mHeadRadius = std::max(0.01f, metres * 0.5f); }
+  // Max sources in the binaural tier; rounded up to a multiple of 4.
+  void setBinauralVoices(int n) { mBinauralVoices = std::max(0, (n + 3) & ~3); }
+  // Sources whose distance-scaled gain is below this are culled.
+  void setCullThreshold(float gain) { mCullThreshold = std::max(0.f, gain); }
+  // Largest numFrames per internal pass; process() splits longer blocks.
+  void setMaxBlock(int frames) {
+    mMaxBlock = std::max(16, frames);
+    mAccL.assign(static_cast<size_t>(mMaxBlock) * 4, 0.f);
+    mAccR.assign(static_cast<size_t>(mMaxBlock) * 4, 0.f);
+    mSilence.assign(static_cast<size_t>(mMaxBlock), 0.f);
+  }
+
+  int binauralVoices() const { return mBinauralVoices; }
+  float cullThreshold() const { return mCullThreshold; }
+  int maxSources() const { return mMaxSources; }
+  const SpatializerStats& stats() const { return mStats; }
+
+  // ---- render --------------------------------------------------------
+  // Adds every active source into outL/outR. in[id] is source id's mono
+  // block of numFrames samples, nullptr for silence; in has maxSources()
+  // entries.
+  void process(const float* const* in, float* outL, float* outR, int numFrames) {
+    if (!in || !outL || !outR) return;
+    for (int off = 0; off < numFrames; off += mMaxBlock) {
+      const int n = std::min(mMaxBlock, numFrames - off);
+      updateTargets();
+      renderBinaural(in, off, outL + off, outR + off, n);
+      renderPanned(in, off, outL + off, outR + off, n);
+    }
+  }
+
+private:
+  bool valid(int id) const { return id >= 0 && id < mMaxSources && mActive[id]; }
+
+  // Per-block geometry: audible gain for every source, then tier targets.
+  void updateTargets() {
+    mOrder.clear();
+    mStats = SpatializerStats();
+    for (int i = 0; i < mMaxSources; ++i) {
+      if (!mActive[i]) continue;
+      const float dx = mX[i] - mListenerPos[0];
+      const float dy = mY[i] - mListenerPos[1];
+      const float dz = mZ[i] - mListenerPos[2];
+      const float d = std::sqrt(dx * dx + dy * dy + dz * dz);
+      float g = 0.f;
+      if (d < mFarDistance) {
+        const float dc = std::max(d, mRefDistance);
+        g = mGain[i] * mRefDistance / (mRefDistance + mRolloff * (dc - mRefDistance));
+        g *= std::min(1.f, (mFarDistance - d) / (0.1f * mFarDistance));
+      }
+      mTarget[i] = g;
+      if (std::fabs(g) >= mCullThreshold && g != 0.f) mOrder.push_back(i);
+    }
+
+    // Loudest binauralVoices() sources get the binaural tier
+    const int nb = std::min<int>(mBinauralVoices, static_cast<int>(mOrder.size()));
+    if (nb < static_cast<int>(mOrder.size())) {
+      std::nth_element(mOrder.begin(), mOrder.begin() + nb, mOrder.end(),
+                       [this](int a, int b) {
+                         return std::fabs(mTarget[a]) > std::fabs(mTarget[b]);
+                       });
+    }
+
+    // Anything not ranked below is culled: all four gains head to 0
+    for (int i = 0; i < mMaxSources; ++i) {
+      mTgtBinL[i] = mTgtBinR[i] = mTgtPanL[i] = mTgtPanR[i] = 0.f;
+    }
+    for (int k = 0; k < static_cast<int>(mOrder.size()); ++k) {
+      const int i = mOrder[k];
+      const float g = mTarget[i];
+      const float dx = mX[i] - mListenerPos[0];
+      const float dy = mY[i] - mListenerPos[1];
+      const float dz = mZ[i] - mListenerPos[2];
+      const float d = std::max(1e-6f, std::sqrt(dx * dx + dy * dy + dz * dz));
+      // Direction in head coordinates: lateral (+right) and frontal
+      const float lat = std::clamp((dx * mRight[0] + dy * mRight[1] + dz * mRight[2]) / d, -1.f, 1.f);
+      const float front = (dx * mForward[0] + dy * mForward[1] + dz * mForward[2]) / d;
+      if (k < nb) {
+        ++mStats.binaural;
+        // Woodworth: tau = r/c * (theta + sin theta), theta = asin(lateral)
+        const float theta = std::asin(std::fabs(lat));
+        const float itd = std::min(static_cast<float>(kHistory - 2),
+                                   mHeadRadius / kSpeedOfSound * (theta + std::fabs(lat)) * mSampleRate);
+        // Far ear: ~1.5 kHz shadow at 90 degrees; behind: darker both ears;
+        // distance: air absorption
+        const float shadowHz = 20000.f * std::pow(0.075f, std::fabs(lat));
+        const float rearHz = 20000.f * std::pow(0.4f, std::max(0.f, -front));
+        const float airHz = 20000.f / (1.f + 0.02f * d);
+        const float nearHz = std::min(rearHz, airHz);
+        const float farHz = std::min(nearHz, shadowHz);
+        const float farGain = g * (1.f - 0.35f * std::fabs(lat));
+        const bool rightIsNear = lat >= 0.f;
+        mTgtBinL[i] = rightIsNear ? farGain : g;
+        mTgtBinR[i] = rightIsNear ? g : farGain;
+        mTgtDelayL[i] = rightIsNear ? itd : 0.f;
+        mTgtDelayR[i] = rightIsNear ? 0.f : itd;
+        mTgtCoefL[i] = coef(rightIsNear ? farHz : nearHz);
+        mTgtCoefR[i] = coef(rightIsNear ? nearHz : farHz);
+      } else {
+        ++mStats.panned;
+        const float p = (lat + 1.f) * 0.78539816f;  // [0, pi/2]
+        mTgtPanL[i] = g * std::cos(p);
+        mTgtPanR[i] = g * std::sin(p);
+      }
+    }
+    mStats.culled = -mStats.binaural - mStats.panned;
+    for (int i = 0; i < mMaxSources; ++i) mStats.culled += mActive[i];
+  }
+
+  float coef(float hz) const {
+    return std::min(1.f, 1.f - std::exp(-6.2831853f * hz / mSampleRate));
+  }
+
+  // Sources audible in the binaural tier this block or fading out of it,
+  // four lanes per pass.
+  void renderBinaural(const float* const* in, int off, float* outL, float* outR, int n) {
+    mGroup.clear();
+    for (int i = 0; i < mMaxSources; ++i) {
+      if (mBinL[i] == 0.f && mBinR[i] == 0.f && mTgtBinL[i] == 0.f && mTgtBinR[i] == 0.f) {
+        mLive[i] = 0;
+        continue;
+      }
+      if (!mLive[i]) {
+        // Entering the tier from silence: start the delay and filters at
+        // their targets with empty history
+        std::fill_n(mHistory.begin() + static_cast<size_t>(i) * kHistory, kHistory, 0.f);
+        mStateL[i] = mStateR[i] = 0.f;
+        mDelayL[i] = mTgtDelayL[i];
+        mDelayR[i] = mTgtDelayR[i];
+        mLive[i] = 1;
+      }
+      mGroup.push_back(i);
+    }
+    if (mGroup.empty()) return;
+    std::fill_n(mAccL.begin(), static_cast<size_t>(n) * 4, 0.f);
+    std::fill_n(mAccR.begin(), static_cast<size_t>(n) * 4, 0.f);
+    for (size_t g = 0; g < mGroup.size(); g += 4) {
+      int ids[4];
+      const float* src[4];
+      for (int l = 0; l < 4; ++l) {
+        const size_t k = g + static_cast<size_t>(l);
+        ids[l] = k < mGroup.size() ? mGroup[k] : -1;
+        src[l] = ids[l] >= 0 && in[ids[l]] ? in[ids[l]] + off : mSilence.data();
+      }
+      renderGroup(ids, src, n);
+    }
+    mWrite = (mWrite + n) & (kHistory - 1);
+    // Fold the four lanes of each frame into the outputs
+    for (int f = 0; f < n; ++f) {
+      const float* l = &mAccL[static_cast<size_t>(f) * 4];
+      const float* r = &mAccR[static_cast<size_t>(f) * 4];
+      outL[f] += (l[0] + l[1]) + (l[2] + l[3]);
+      outR[f] += (r[0] + r[1]) + (r[2] + r[3]);
+    }
+  }
+
+  // One lane per source: history write, ITD read (linear interpolation),
+  // one-pole shadow filter and ramped gain per ear, summed into mAcc*.
+  // Padding lanes (id -1) read the spare silent history row with zero gain.
+  void renderGroup(const int ids[4], const float* const src[4], int n) {
+    float gL0[4], gL1[4], gR0[4], gR1[4], dL0[4], dL1[4], dR0[4], dR1[4];
+    float aL[4], aR[4], zL[4], zR[4];
+    float* hist[4];
+    for (int l = 0; l < 4; ++l) {
+      const int i = ids[l];
+      const bool pad = i < 0;
+      hist[l] = mHistory.data() + static_cast<size_t>(pad ? mMaxSources : i) * kHistory;
+      gL0[l] = pad ? 0.f : mBinL[i];
+      gL1[l] = pad ? 0.f : mTgtBinL[i];
+      gR0[l] = pad ? 0.f : mBinR[i];
+      gR1[l] = pad ? 0.f : mTgtBinR[i];
+      dL0[l] = pad ? 0.f : mDelayL[i];
+      dL1[l] = pad ? 0.f : mTgtDelayL[i];
+      dR0[l] = pad ? 0.f : mDelayR[i];
+      dR1[l] = pad ? 0.f : mTgtDelayR[i];
+      aL[l] = pad ? 1.f : mTgtCoefL[i];
+      aR[l] = pad ? 1.f : mTgtCoefR[i];
+      zL[l] = pad ? 0.f : mStateL[i];
+      zR[l] = pad ? 0.f : mStateR[i];
+    }
+    const float inv = 1.f / static_cast<float>(n);
+    constexpr int kMask = kHistory - 1;
+    float* accL = mAccL.data();
+    float* accR = mAccR.data();
+
+#if defined(__wasm_simd128__)
+    const v128_t vInv = wasm_f32x4_splat(inv);
+    v128_t gL = wasm_v128_load(gL0), gR = wasm_v128_load(gR0);
+    v128_t dL = wasm_v128_load(dL0), dR = wasm_v128_load(dR0);
+    const v128_t sgL = wasm_f32x4_mul(wasm_f32x4_sub(wasm_v128_load(gL1), gL), vInv);
+    const v128_t sgR = wasm_f32x4_mul(wasm_f32x4_sub(wasm_v128_load(gR1), gR), vInv);
+    const v128_t sdL = wasm_f32x4_mul(wasm_f32x4_sub(wasm_v128_load(dL1), dL), vInv);
+    const v128_t sdR = wasm_f32x4_mul(wasm_f32x4_sub(wasm_v128_load(dR1), dR), vInv);
+    const v128_t vaL = wasm_v128_load(aL), vaR = wasm_v128_load(aR);
+    v128_t vzL = wasm_v128_load(zL), vzR = wasm_v128_load(zR);
+    for (int f = 0; f < n; ++f) {
+      const int w = (mWrite + f) & kMask;
+      for (int l = 0; l < 4; ++l) hist[l][w] = src[l][f];
+      // ITD taps: integer part per lane, fraction stays in the vector
+      const v128_t iL = wasm_i32x4_trunc_sat_f32x4(dL);
+      const v128_t iR = wasm_i32x4_trunc_sat_f32x4(dR);
+      const v128_t fL = wasm_f32x4_sub(dL, wasm_f32x4_convert_i32x4(iL));
+      const v128_t fR = wasm_f32x4_sub(dR, wasm_f32x4_convert_i32x4(iR));
+      int il[4], ir[4];
+      wasm_v128_store(il, iL);
+      wasm_v128_store(ir, iR);
+      const v128_t l0 = wasm_f32x4_make(hist[0][(w - il[0]) & kMask], hist[1][(w - il[1]) & kMask],
+                                        hist[2][(w - il[2]) & kMask], hist[3][(w - il[3]) & kMask]);
+      const v128_t l1 = wasm_f32x4_make(hist[0][(w - il[0] - 1) & kMask], hist[1][(w - il[1] - 1) & kMask],
+                                        hist[2][(w - il[2] - 1) & kMask], hist[3][(w - il[3] - 1) & kMask]);
+      const v128_t r0 = wasm_f32x4_make(hist[0][(w - ir[0]) & kMask], hist[1][(w - ir[1]) & kMask],
+                                        hist[2][(w - ir[2]) & kMask], hist[3][(w - ir[3]) & kMask]);
+      const v128_t r1 = wasm_f32x4_make(hist[0][(w - ir[0] - 1) & kMask], hist[1][(w - ir[1] - 1) & kMask],
+                                        hist[2][(w - ir[2] - 1) & kMask], hist[3][(w - ir[3] - 1) & kMask]);
+      const v128_t xL = wasm_f32x4_add(l0, wasm_f32x4_mul(wasm_f32x4_sub(l1, l0), fL));
+      const v128_t xR = wasm_f32x4_add(r0, wasm_f32x4_mul(wasm_f32x4_sub(r1, r0), fR));
+      vzL = wasm_f32x4_add(vzL, wasm_f32x4_mul(vaL, wasm_f32x4_sub(xL, vzL)));
+      vzR = wasm_f32x4_add(vzR, wasm_f32x4_mul(vaR, wasm_f32x4_sub(xR, vzR)));
+      float* al = accL + f * 4;
+      float* ar = accR + f * 4;
+      wasm_v128_store(al, wasm_f32x4_add(wasm_v128_load(al), wasm_f32x4_mul(vzL, gL)));
+      wasm_v128_store(ar, wasm_f32x4_add(wasm_v128_load(ar), wasm_f32x4_mul(vzR, gR)));
+      gL = wasm_f32x4_add(gL, sgL);
+      gR = wasm_f32x4_add(gR, sgR);
+      dL = wasm_f32x4_add(dL, sdL);
+      dR = wasm_f32x4_add(dR, sdR);
+    }
+    wasm_v128_store(zL, vzL);
+    wasm_v128_store(zR, vzR);
+#else
+    for (int f = 0; f < n; ++f) {
+      const int w = (mWrite + f) & kMask;
+      const float t = static_cast<float>(f) * inv;
+      float* al = accL + f * 4;
+      float* ar = accR + f * 4;
+      for (int l = 0; l < 4; ++l) {
+        hist[l][w] = src[l][f];
+        const float dl = dL0[l] + (dL1[l] - dL0[l]) * t;
+        const float dr = dR0[l] + (dR1[l] - dR0[l]) * t;
+        const int il = static_cast<int>(dl), ir = static_cast<int>(dr);
+        const float l0 = hist[l][(w - il) & kMask], l1 = hist[l][(w - il - 1) & kMask];
+        const float r0 = hist[l][(w - ir) & kMask], r1 = hist[l][(w - ir - 1) & kMask];
+        zL[l] += aL[l] * (l0 + (l1 - l0) * (dl - il) - zL[l]);
+        zR[l] += aR[l] * (r0 + (r1 - r0) * (dr - ir) - zR[l]);
+        al[l] += zL[l] * (gL0[l] + (gL1[l] - gL0[l]) * t);
+        ar[l] += zR[l] * (gR0[l] + (gR1[l] - gR0[l]) * t);
+      }
+    }
+#endif
+
+    for (int l = 0; l < 4; ++l) {
+      const int i = ids[l];
+      if (i < 0) continue;
+      mBinL[i] = gL1[l];
+      mBinR[i] = gR1[l];
+      mDelayL[i] = dL1[l];
+      mDelayR[i] = dR1[l];
+      mStateL[i] = zL[l];
+      mStateR[i] = zR[l];
+    }
+  }
+
+  void renderPanned(const float* const* in, int off, float* outL, float* outR, int n) {
+    for (int i = 0; i < mMaxSources; ++i) {
+      const float l0 = mPanL[i], r0 = mPanR[i];
+      const float l1 = mTgtPanL[i], r1 = mTgtPanR[i];
+      if (l0 == 0.f && r0 == 0.f && l1 == 0.f && r1 == 0.f) continue;
+      if (in[i]) {
+        al::audio_simd::mixRamp(outL, in[i] + off, l0, l1, n);
+        al::audio_simd::mixRamp(outR, in[i] + off, r0, r1, n);
+      }
+      mPanL[i] = l1;
+      mPanR[i] = r1;
+    }
+  }
+
+  static constexpr float kSpeedOfSound = 343.f;
+
+  int mMaxSources;
+  float mSampleRate;
+  int mMaxBlock = 512;
+  int mBinauralVoices = 32;
+  float mCullThreshold = 1e-3f;  // -60 dB
+  float mRefDistance = 1.f;
+  float mFarDistance = 100.f;
+  float mRolloff = 1.f;
+  float mHeadRadius = 0.0875f;
+
+  float mListenerPos[3] = {0.f, 0.f, 0.f};
+  float mRight[3] = {1.f, 0.f, 0.f};
+  float mForward[3] = {0.f, 0.f, -1.f};
+
+  // Source parameters
+  std::vector<char> mActive;
+  std::vector<float> mX, mY, mZ, mGain;
+  std::vector<float> mTarget;  // audible gain this block
+  // Rendered state, ramped towards the targets each block
+  std::vector<float> mBinL, mBinR, mPanL, mPanR;
+  std::vector<float> mDelayL, mDelayR;  // ITD in samples
+  std::vector<float> mStateL, mStateR;  // one-pole state
+  std::vector<char> mLive;              // history valid (binaural last block)
+  // Targets for the current block
+  std::vector<float> mTgtBinL, mTgtBinR, mTgtPanL, mTgtPanR;
+  std::vector<float> mTgtDelayL, mTgtDelayR, mTgtCoefL, mTgtCoefR;
+
+  std::vector<float> mHistory;  // kHistory per source + one silent row
+  int mWrite = 0;
+  std::vector<int> mOrder;
+  std::vector<int> mGroup;
+  std::vector<float> mAccL, mAccR;  // 4 lanes per frame
+  std::vector<float> mSilence;
+  SpatializerStats mStats;
+};
+
+}  // namespace studio
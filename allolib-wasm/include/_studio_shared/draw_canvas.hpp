@@ -14,8 +14,12 @@
  * Design:
  *   - In-progress stroke held in std::optional<Stroke> mActive.
  *   - Committed strokes live in mStrokes.
- *   - sampleAt / sampleColumn rasterize strokes into a 256x256 grid the first
- *     time they're called after a mutation; cache invalidated on add/clear.
+ *   - sampleAt / sampleColumn read a rasterized grid (256x256 by default,
+ *     setGridSize() for finer wavetables). Reads after drawing rasterize
+ *     only the segments added since the last read, the live stroke
+ *     included; clear(), undo(), setBounds() and setGridSize() re-raster
+ *     everything. dirtyRect() reports the cells changed since it was
+ *     last taken, for partial texture uploads.
  *
  * No <thread> or pthread dependency. No Phase 1c deps.
  */
@@ -51,8 +55,12 @@ public:
   void setBounds(float x, float y, float w, float h) {
     mX = x;
     mY = y;
-    mW = (w > 1.f) ? w : 1.f;
-    mH = (h > 1.f) ? h : 1.f;
+    w = (w > 1.f) ? w : 1.f;
+    h = (h > 1.f) ? h : 1.f;
+    // Brush radius in cells depends on the size, so existing strokes re-raster
+    if (w != mW || h != mH) mGridDirty = true;
+    mW = w;
+    mH = h;
   }
 
   float x() const { return mX; }
@@ -69,6 +77,8 @@ public:
     if (!hitTest(static_cast<float>(m.x()), static_cast<float>(m.y()))) {
       return;
     }
+    // A stroke still in progress is dropped, and with it its raster
+    if (mActive.has_value()) mGridDirty = true;
     Stroke s;
     s.color = mPenColor;
     s.thickness = mPenThickness;
@@ -93,10 +103,8 @@ public:
 
   void onMouseUp(const al::Mouse& /*m*/) {
     if (!mActive.has_value()) return;
-    if (mActive->points.size() >= 2) {
-      mStrokes.push_back(std::move(*mActive));
-      mGridDirty = true;
-    }
+    // A committed stroke keeps the segments already rasterized while live
+    if (mActive->points.size() >= 2) mStrokes.push_back(std::move(*mActive));
     mActive.reset();
   }
 
@@ -107,6 +115,13 @@ public:
     mGridDirty = true;
   }
 
+  /// Remove the most recent committed stroke
+  void undo() {
+    if (mStrokes.empty()) return;
+    mStrokes.pop_back();
+    mGridDirty = true;
+  }
+
   // Set an attribute on the in-progress stroke, falling back to the most
   // recently completed stroke if no stroke is active.
   void setStrokeAttr(const std::string& name, float value) {
@@ -138,35 +153,69 @@ public:
   // normalized.x in [0,1], y in [0,1] (top-down).
   float sampleAt(al::Vec2f normalized) const {
     ensureGrid();
-    const float fx = clamp01(normalized.x) * (kGrid - 1);
-    const float fy = clamp01(normalized.y) * (kGrid - 1);
+    const int n = mGridSize;
+    const float fx = clamp01(normalized.x) * (n - 1);
+    const float fy = clamp01(normalized.y) * (n - 1);
     const int x0 = static_cast<int>(std::floor(fx));
     const int y0 = static_cast<int>(std::floor(fy));
-    const int x1 = std::min(x0 + 1, kGrid - 1);
-    const int y1 = std::min(y0 + 1, kGrid - 1);
+    const int x1 = std::min(x0 + 1, n - 1);
+    const int y1 = std::min(y0 + 1, n - 1);
     const float tx = fx - x0;
     const float ty = fy - y0;
-    const float a = mGrid[y0 * kGrid + x0];
-    const float b = mGrid[y0 * kGrid + x1];
-    const float c = mGrid[y1 * kGrid + x0];
-    const float d = mGrid[y1 * kGrid + x1];
+    const float a = mGrid[y0 * n + x0];
+    const float b = mGrid[y0 * n + x1];
+    const float c = mGrid[y1 * n + x0];
+    const float d = mGrid[y1 * n + x1];
     return (a * (1 - tx) + b * tx) * (1 - ty) +
            (c * (1 - tx) + d * tx) * ty;
   }
 
-  // Column read: returns kGrid samples (one per row) at column xNorm.
+  // Column read: returns gridSize() samples (one per row) at column xNorm.
   std::vector<float> sampleColumn(float xNorm) const {
+    std::vector<float> out(static_cast<size_t>(mGridSize));
+    readColumn(xNorm, out.data());
+    return out;
+  }
+
+  // sampleColumn into caller storage of gridSize() floats, no allocation.
+  void readColumn(float xNorm, float* out) const {
     ensureGrid();
+    const int n = mGridSize;
     const int col = std::clamp(
-        static_cast<int>(std::round(clamp01(xNorm) * (kGrid - 1))),
-        0, kGrid - 1);
-    std::vector<float> out(kGrid);
-    for (int y = 0; y < kGrid; ++y) out[y] = mGrid[y * kGrid + col];
-    return out;
+        static_cast<int>(std::round(clamp01(xNorm) * (n - 1))), 0, n - 1);
+    for (int y = 0; y < n; ++y) out[y] = mGrid[static_cast<size_t>(y) * n + col];
   }
 
-  // Public grid resolution (256x256).
-  static constexpr int gridSize() { return kGrid; }
+  // Grid resolution, gridSize() x gridSize() (256 by default).
+  int gridSize() const { return mGridSize; }
+
+  // Resize the grid (clamped to [16, 4096]); strokes re-raster on next read.
+  void setGridSize(int n) {
+    n = std::clamp(n, 16, 4096);
+    if (n == mGridSize) return;
+    mGridSize = n;
+    mGridDirty = true;
+  }
+
+  // Row-major gridSize() x gridSize() field, current as of this call.
+  const float* grid() const {
+    ensureGrid();
+    return mGrid.data();
+  }
+
+  // Cells changed since the last call, as [x0, x1) x [y0, y1); false when
+  // nothing changed. A full re-raster reports the whole grid.
+  bool dirtyRect(int& x0, int& y0, int& x1, int& y1) const {
+    ensureGrid();
+    if (mDirtyX0 >= mDirtyX1 || mDirtyY0 >= mDirtyY1) return false;
+    x0 = mDirtyX0;
+    y0 = mDirtyY0;
+    x1 = mDirtyX1;
+    y1 = mDirtyY1;
+    mDirtyX0 = mDirtyY0 = mGridSize;
+    mDirtyX1 = mDirtyY1 = 0;
+    return true;
+  }
 
 private:
   // -- helpers -----------------------------------------------------------
@@ -193,23 +242,40 @@ private:
     g.draw(m);
   }
 
-  // Lazy rasterization into a kGrid x kGrid float field. Each stroke
-  // contributes thickness-weighted coverage along its segments. Updates
-  // are accumulated; resulting field is in [0, ~strokeCount].
+  // Lazy rasterization into a gridSize() x gridSize() float field. Each
+  // stroke contributes thickness-weighted coverage along its segments.
+  // Updates are accumulated; resulting field is in [0, ~strokeCount].
+  //
+  // Strokes are only ever appended (the live one becoming the last
+  // committed one on mouse-up), so the grid is brought up to date by
+  // rasterizing whatever lies past (mRasterStrokes, mRasterSegments).
   void ensureGrid() const {
-    if (!mGridDirty) return;
-    mGrid.assign(static_cast<size_t>(kGrid) * kGrid, 0.f);
-    for (const auto& s : mStrokes) rasterStroke(s);
-    if (mActive.has_value()) rasterStroke(*mActive);
-    mGridDirty = false;
+    if (mGridDirty) {
+      const int n = mGridSize;
+      mGrid.assign(static_cast<size_t>(n) * n, 0.f);
+      mRasterStrokes = 0;
+      mRasterSegments = 0;
+      mDirtyX0 = mDirtyY0 = 0;
+      mDirtyX1 = mDirtyY1 = n;
+      mGridDirty = false;
+    }
+    for (; mRasterStrokes < mStrokes.size(); ++mRasterStrokes) {
+      rasterStroke(mStrokes[mRasterStrokes], mRasterSegments);
+      mRasterSegments = 0;
+    }
+    if (mActive.has_value()) {
+      rasterStroke(*mActive, mRasterSegments);
+      mRasterSegments = mActive->points.empty() ? 0 : mActive->points.size() - 1;
+    }
   }
 
-  void rasterStroke(const Stroke& s) const {
+  // Rasterize segments [first, last] of a stroke
+  void rasterStroke(const Stroke& s, size_t first) const {
     const float maxDim = (mW > mH) ? mW : mH;
     // Map pen thickness (screen pixels) to grid cells.
-    const float radius = std::max(0.5f, s.thickness * (kGrid / maxDim) * 0.5f);
+    const float radius = std::max(0.5f, s.thickness * (mGridSize / maxDim) * 0.5f);
     const float intensity = s.color.a;  // alpha-weighted contribution
-    for (size_t i = 1; i < s.points.size(); ++i) {
+    for (size_t i = first + 1; i < s.points.size(); ++i) {
       rasterSegment(s.points[i - 1], s.points[i], radius, intensity);
     }
   }
@@ -218,37 +284,43 @@ private:
                      float radius, float intensity) const {
     // March along the segment in fractional grid steps and stamp a small
     // square brush. Cheap; fine for a 256x256 LUT.
-    const float ax = a.x * (kGrid - 1);
-    const float ay = a.y * (kGrid - 1);
-    const float bx = b.x * (kGrid - 1);
-    const float by = b.y * (kGrid - 1);
+    const int n = mGridSize;
+    const float ax = a.x * (n - 1);
+    const float ay = a.y * (n - 1);
+    const float bx = b.x * (n - 1);
+    const float by = b.y * (n - 1);
     const float dx = bx - ax;
     const float dy = by - ay;
     const float len = std::sqrt(dx * dx + dy * dy);
     const int steps = std::max(1, static_cast<int>(std::ceil(len)));
     const int r = std::max(1, static_cast<int>(std::ceil(radius)));
+    // Cells the brush can reach, clipped to the grid
+    mDirtyX0 = std::max(0, std::min(mDirtyX0, static_cast<int>(std::round(std::min(ax, bx))) - r));
+    mDirtyY0 = std::max(0, std::min(mDirtyY0, static_cast<int>(std::round(std::min(ay, by))) - r));
+    mDirtyX1 = std::min(n, std::max(mDirtyX1, static_cast<int>(std::round(std::max(ax, bx))) + r + 1));
+    mDirtyY1 = std::min(n, std::max(mDirtyY1, static_cast<int>(std::round(std::max(ay, by))) + r + 1));
     for (int s = 0; s <= steps; ++s) {
       const float t = static_cast<float>(s) / static_cast<float>(steps);
       const int cx = static_cast<int>(std::round(ax + dx * t));
       const int cy = static_cast<int>(std::round(ay + dy * t));
       for (int oy = -r; oy <= r; ++oy) {
         const int y = cy + oy;
-        if (y < 0 || y >= kGrid) continue;
+        if (y < 0 || y >= n) continue;
         for (int ox = -r; ox <= r; ++ox) {
           const int x = cx + ox;
-          if (x < 0 || x >= kGrid) continue;
+          if (x < 0 || x >= n) continue;
           const float d2 =
               static_cast<float>(ox * ox + oy * oy);
           if (d2 > radius * radius) continue;
           const float w = 1.f - std::sqrt(d2) / radius;
-          mGrid[y * kGrid + x] += intensity * w;
+          mGrid[static_cast<size_t>(y) * n + x] += intensity * w;
         }
       }
     }
   }
 
   // -- state -------------------------------------------------------------
-  static constexpr int kGrid = 256;
+  static constexpr int kDefaultGrid = 256;
 
   float mX{0.f}, mY{0.f}, mW{1.f}, mH{1.f};
   al::Color mPenColor{1.f, 1.f, 1.f, 1.f};
@@ -257,8 +329,14 @@ private:
   std::vector<Stroke> mStrokes;
   std::optional<Stroke> mActive;
 
+  int mGridSize{kDefaultGrid};
   mutable std::vector<float> mGrid;
-  mutable bool mGridDirty{true};
+  mutable bool mGridDirty{true};   // Re-raster everything on next read
+  // Rasterized so far: whole strokes of mStrokes, then segments of the next
+  mutable size_t mRasterStrokes{0};
+  mutable size_t mRasterSegments{0};
+  // Changed cells since dirtyRect() last returned them, [x0, x1) x [y0, y1)
+  mutable int mDirtyX0{0}, mDirtyY0{0}, mDirtyX1{0}, mDirtyY1{0};
 };
 
 // Free-function form requested by the plan: targets the in-progress stroke
@@ -18,6 +18,17 @@
  * checks for a path back to `src`. If found, the connection is refused
  * and a printf warning is emitted.
  *
+ * Evaluation plan: any topology change (add, connect, disconnect, rebind,
+ * load) marks the graph dirty, and the next tick() / compile() flattens
+ * it into a topologically sorted instruction list of (source slot, scale,
+ * offset, destination slot) over a dense value array. A parameter that is
+ * both a destination and a source feeds its downstream edges within the
+ * same tick. Per tick, root sources are sampled once, the instructions
+ * run as a single loop with no lookups or allocation, and destinations
+ * are written in one batch, skipping parameters that already hold the
+ * value. evaluate() runs the plan without writing parameters, so an
+ * onSound() can evaluate at block rate and read value(slotOf(id)).
+ *
  * JSON persistence: every node's id, name, kind, x, y is written along
  * with every edge's (src, dst, scale, offset). Loading restores the
  * graph topology and node positions; sampler bodies cannot be
@@ -32,8 +43,10 @@
  * another to create a connection. Layout is persisted in the graph
  * itself so JSON round-trips preserve the editor state.
  *
- * Threading: tick(), connect(), and drawing all run on the main thread.
- * No std::thread / pthread.
+ * Threading: tick(), connect(), compile() and drawing all run on the main
+ * thread. evaluate() / value() may run on the audio thread once the graph
+ * is compiled, provided the samplers are audio-safe and the topology is
+ * not edited meanwhile. No std::thread / pthread.
  */
 
 #include "al/graphics/al_Graphics.hpp"
@@ -107,6 +120,7 @@ public:
     layoutNew(n);
     mNodes.push_back(std::move(n));
     mIndex[mNodes.back().id] = mNodes.size() - 1;
+    mPlanDirty = true;
     return mNodes.back().id;
   }
 
@@ -120,6 +134,7 @@ public:
     layoutNew(n);
     mNodes.push_back(std::move(n));
     mIndex[mNodes.back().id] = mNodes.size() - 1;
+    mPlanDirty = true;
     return mNodes.back().id;
   }
 
@@ -127,6 +142,7 @@ public:
   void setSampler(NodeId id, std::function<float()> sampler) {
     if (Node* n = nodeOpt(id)) {
       n->sampler = std::move(sampler);
+      mPlanDirty = true;
     }
   }
 
@@ -140,6 +156,7 @@ public:
         n->name = p->getName();
         n->sampler = [p]() { return p->get(); };
       }
+      mPlanDirty = true;
     }
   }
 
@@ -170,6 +187,7 @@ public:
       if (e.src == src && e.dst == dst) {
         e.scale = scale;
         e.offset = offset;
+        mPlanDirty = true;
         return true;
       }
     }
@@ -182,6 +200,7 @@ public:
     }
     mEdges.push_back(Edge{src, dst, scale, offset});
     d->isDestination = true;
+    mPlanDirty = true;
     return true;
   }
 
@@ -196,30 +215,126 @@ public:
     for (const auto& e : mEdges) {
       if (Node* d = nodeOpt(e.dst)) d->isDestination = true;
     }
+    mPlanDirty = true;
   }
 
   // ---------------- evaluation ------------------------------------------
 
+  // Evaluate and write every destination parameter (main thread).
   void tick() {
     if (mEdges.empty()) return;
-    // Sum incoming contributions per destination parameter.
-    std::unordered_map<NodeId, float> sums;
-    sums.reserve(mEdges.size());
-    for (const auto& e : mEdges) {
-      Node* s = nodeOpt(e.src);
-      Node* d = nodeOpt(e.dst);
+    compile();
+    evaluate();
+    apply();
+  }
+
+  // Rebuild the plan if the topology changed since the last compile.
+  // Allocates; main thread only. tick() calls it for you.
+  void compile() {
+    if (!mPlanDirty) return;
+    mPlanDirty = false;
+    mRoots.clear();
+    mOps.clear();
+    mWrites.clear();
+    mSlot.assign(mNodes.size(), -1);
+
+    // Kahn's algorithm over the nodes that take part in an edge
+    std::vector<int> indegree(mNodes.size(), 0);
+    std::vector<std::vector<size_t>> inbound(mNodes.size());
+    std::vector<std::vector<size_t>> outbound(mNodes.size());
+    std::vector<bool> used(mNodes.size(), false);
+    for (size_t i = 0; i < mEdges.size(); ++i) {
+      const Node* s = nodeOpt(mEdges[i].src);
+      const Node* d = nodeOpt(mEdges[i].dst);
       if (!s || !d || d->param == nullptr) continue;
-      float v = 0.f;
-      if (s->sampler) v = s->sampler();
-      const float contrib = v * e.scale + e.offset;
-      sums[e.dst] += contrib;
+      const size_t si = mIndex[s->id], di = mIndex[d->id];
+      used[si] = used[di] = true;
+      indegree[di]++;
+      inbound[di].push_back(i);
+      outbound[si].push_back(di);
+    }
+    std::vector<size_t> order, ready;
+    for (size_t i = 0; i < mNodes.size(); ++i) {
+      if (used[i] && indegree[i] == 0) ready.push_back(i);
+    }
+    while (!ready.empty()) {
+      const size_t i = ready.back();
+      ready.pop_back();
+      mSlot[i] = static_cast<int>(order.size());
+      order.push_back(i);
+      for (size_t di : outbound[i]) {
+        if (--indegree[di] == 0) ready.push_back(di);
+      }
+    }
+    // connect() refuses cycles, but loadJSON() doesn't check; drop any
+    // node left over rather than read a slot that's never computed
+    for (size_t i = 0; i < mNodes.size(); ++i) {
+      if (used[i] && mSlot[i] < 0) {
+        std::printf("[ParamGraph] node %d is on a cycle; skipped\n",
+                    mNodes[i].id);
+      }
+    }
+
+    for (size_t i : order) {
+      const Node& n = mNodes[i];
+      const int slot = mSlot[i];
+      if (inbound[i].empty()) {
+        mRoots.push_back(Root{slot, n.param, n.param ? nullptr : &n.sampler});
+        continue;
+      }
+      for (size_t ei : inbound[i]) {
+        const Edge& e = mEdges[ei];
+        const int src = mSlot[mIndex[e.src]];
+        if (src < 0) continue;
+        mOps.push_back(Op{src, e.scale, e.offset, slot});
+      }
+      mWrites.push_back(Write{slot, n.param});
+    }
+    mValues.assign(order.size(), 0.f);
+  }
+
+  // Run the compiled plan into value() slots without touching any
+  // parameter. No allocation. Does nothing while the plan is dirty (the
+  // old plan may point at moved nodes); values hold until compile().
+  void evaluate() {
+    if (mPlanDirty) return;
+    float* v = mValues.data();
+    for (const Root& r : mRoots) {
+      if (r.param) v[r.slot] = r.param->get();
+      else v[r.slot] = (r.sampler && *r.sampler) ? (*r.sampler)() : 0.f;
     }
-    for (auto& kv : sums) {
-      Node* d = nodeOpt(kv.first);
-      if (d && d->param) d->param->set(kv.second);
+    for (const Write& w : mWrites) v[w.slot] = 0.f;
+    for (const Op& op : mOps) v[op.dst] += v[op.src] * op.scale + op.offset;
+  }
+
+  // Batched destination writes for the last evaluate(). Parameters that
+  // already hold the value are skipped, so their callbacks stay quiet.
+  void apply() {
+    if (mPlanDirty) return;
+    for (const Write& w : mWrites) {
+      const float v = mValues[w.slot];
+      if (w.param->get() != v) w.param->set(v);
     }
   }
 
+  // Slot of a node in the compiled plan, or -1 if it takes no part in
+  // any edge (or compile() hasn't seen it yet).
+  int slotOf(NodeId id) const {
+    auto it = mIndex.find(id);
+    if (it == mIndex.end() || it->second >= mSlot.size()) return -1;
+    return mSlot[it->second];
+  }
+
+  // Value of a slot after the last evaluate()
+  float value(int slot) const {
+    return (slot >= 0 && slot < static_cast<int>(mValues.size()))
+               ? mValues[slot]
+               : 0.f;
+  }
+
+  bool planDirty() const { return mPlanDirty; }
+  size_t planSize() const { return mOps.size(); }
+
   // ---------------- introspection --------------------------------------
 
   const std::vector<Node>& nodes() const { return mNodes; }
@@ -414,10 +529,13 @@ public:
 
 #if AL_STUDIO_PARAM_GRAPH_HAS_WEBFONT
     if (mFont) {
+      // One draw for every label; unchanged labels reuse the font's meshes
+      mLabels.clear();
       for (const auto& n : mNodes) {
-        mFont->render(g, n.name, n.x + 6.f, n.y + 4.f);
+        mLabels.add(*mFont, n.name, n.x + 6.f, n.y + 4.f);
       }
-      if (windowTitle) mFont->render(g, windowTitle, 6.f, h - 18.f);
+      if (windowTitle) mLabels.add(*mFont, windowTitle, 6.f, h - 18.f);
+      mLabels.draw(g);
     } else {
       labelOnceViaPrintf(windowTitle);
     }
@@ -496,6 +614,7 @@ public:
     mNodes.clear();
     mEdges.clear();
     mIndex.clear();
+    mPlanDirty = true;
     if (j.contains("nextId")) mNextId = j["nextId"].get<int>();
     if (j.contains("nodes")) {
       for (const auto& jn : j["nodes"]) {
@@ -608,6 +727,29 @@ private:
   std::unordered_map<NodeId, size_t> mIndex;
   int mNextId{0};
 
+  // Compiled plan. Slots index mValues in topological order.
+  struct Root {
+    int slot;
+    al::Parameter* param;                   // read directly when set
+    const std::function<float()>* sampler;  // otherwise; may be empty
+  };
+  struct Op {
+    int src;
+    float scale;
+    float offset;
+    int dst;
+  };
+  struct Write {
+    int slot;
+    al::Parameter* param;
+  };
+  bool mPlanDirty{true};
+  std::vector<int> mSlot;  // per mNodes index, -1 = not in the plan
+  std::vector<Root> mRoots;
+  std::vector<Op> mOps;
+  std::vector<Write> mWrites;
+  std::vector<float> mValues;
+
   // Editor state.
   float mEditorX{0.f}, mEditorY{0.f}, mEditorW{800.f}, mEditorH{600.f};
   NodeId mDragNode{-1};
@@ -617,6 +759,7 @@ private:
   bool mPrintedLabels{false};
 #if AL_STUDIO_PARAM_GRAPH_HAS_WEBFONT
   al::WebFont* mFont{nullptr};
+  al::TextBatch mLabels;
 #endif
 
   inline static al::Graphics* sLastGraphics = nullptr;
@@ -12,9 +12,10 @@
  * Real ray-intersection routines:
  *   - Ray-sphere: solve quadratic |O + tD - C|^2 = r^2.
  *   - Ray-AABB:   slab method with tmin/tmax bookkeeping.
- *   - Ray-mesh:   Möller-Trumbore per triangle (TRIANGLES primitive only;
- *                 TRIANGLE_STRIP and TRIANGLE_FAN are expanded into a
- *                 cached triangle list at setMesh time).
+ *   - Ray-mesh:   Möller-Trumbore over a BVH (MeshBVH, binned SAH) built
+ *                 at setMesh time (TRIANGLE_STRIP and TRIANGLE_FAN are
+ *                 expanded to triangles first), so a pick visits a few
+ *                 dozen triangles instead of all of them.
  *
  * Real drag math: the mouse ray on each onMouseDrag is intersected against
  * the plane that is perpendicular to the *camera forward direction* and
@@ -24,6 +25,10 @@
  * through it). Default drag axis is the zero vector, which means "free
  * planar drag".
  *
+ * PickManager holds many Pickables in a dynamic AABB tree and routes
+ * hover, click and drag to the nearest one, so a scene with hundreds of
+ * handles tests a few per mouse event rather than all of them.
+ *
  * `screenToRay(WebApp& app, Vec2f screen)` is a free function in this
  * header. It unprojects (mouseX, mouseY) -- in screen pixels with origin at
  * the top-left -- through the WebApp's active camera, returning a ray with
@@ -44,6 +49,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <vector>
@@ -66,6 +72,306 @@ struct Ray {
   al::Vec3f direction{0.f, 0.f, -1.f};  // normalized
 };
 
+// =====================================================================
+// MeshBVH
+// =====================================================================
+
+/// Bounding volume hierarchy over a triangle list, built with binned SAH.
+/// Nodes are 32 bytes -- box min + first/left, box max + count -- so two
+/// share a cache line and the slab test reads six contiguous floats;
+/// children are adjacent. Triangles are stored ready for Möller-Trumbore
+/// (v0, e1, e2) in leaf order, so a leaf is one contiguous run.
+class MeshBVH {
+public:
+  /// Build from a TRIANGLES index list; out-of-range triangles are dropped
+  void build(const std::vector<al::Mesh::Vertex>& vertices,
+             const std::vector<unsigned>& indices) {
+    clear();
+    const std::size_t count = indices.size() / 3;
+    std::vector<Tri> tris;
+    tris.reserve(count);
+    mBoxes.clear();
+    mBoxes.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      const unsigned a = indices[3 * i], b = indices[3 * i + 1], c = indices[3 * i + 2];
+      if (a >= vertices.size() || b >= vertices.size() || c >= vertices.size()) continue;
+      const al::Vec3f& v0 = vertices[a];
+      const al::Vec3f& v1 = vertices[b];
+      const al::Vec3f& v2 = vertices[c];
+      tris.push_back(Tri{v0, v1 - v0, v2 - v0});
+      Box box;
+      box.grow(v0);
+      box.grow(v1);
+      box.grow(v2);
+      mBoxes.push_back(box);
+    }
+    if (tris.empty()) return;
+
+    mOrder.resize(tris.size());
+    for (uint32_t i = 0; i < mOrder.size(); ++i) mOrder[i] = i;
+    mNodes.reserve(2 * tris.size());
+    mNodes.push_back(Node{});
+    mNodes[0].leftFirst = 0;
+    mNodes[0].count = static_cast<uint32_t>(tris.size());
+
+    // Depth-first, iteratively; the depth cap keeps intersect()'s stack safe
+    std::vector<std::pair<uint32_t, int>> todo{{0u, 0}};
+    while (!todo.empty()) {
+      const uint32_t node = todo.back().first;
+      const int depth = todo.back().second;
+      todo.pop_back();
+      fitBounds(node);
+      if (depth < kMaxDepth && split(node)) {
+        const uint32_t left = mNodes[node].leftFirst;
+        todo.push_back({left + 1, depth + 1});
+        todo.push_back({left, depth + 1});
+      }
+    }
+
+    mTris.resize(tris.size());
+    for (std::size_t i = 0; i < mOrder.size(); ++i) mTris[i] = tris[mOrder[i]];
+    mOrder.clear();
+    mOrder.shrink_to_fit();
+    mBoxes.clear();
+    mBoxes.shrink_to_fit();
+  }
+
+  void clear() {
+    mNodes.clear();
+    mTris.clear();
+  }
+
+  bool empty() const { return mTris.empty(); }
+  std::size_t nodeCount() const { return mNodes.size(); }
+  std::size_t triangleCount() const { return mTris.size(); }
+
+  /// Nearest hit with t > 1e-4 along O + tD (same tolerances as a
+  /// brute-force Möller-Trumbore loop)
+  Hit intersect(const al::Vec3f& O, const al::Vec3f& D) const {
+    Hit best;
+    if (mNodes.empty()) return best;
+    const float inv[3] = {1.f / nonZero(D.x), 1.f / nonZero(D.y), 1.f / nonZero(D.z)};
+    const float org[3] = {O.x, O.y, O.z};
+
+    struct Entry {
+      uint32_t node;
+      float t;
+    };
+    Entry stack[kMaxDepth + 2];
+    int sp = 0;
+    const float tRoot = slab(mNodes[0], org, inv, best.t);
+    if (tRoot == kMiss) return best;
+    stack[sp++] = Entry{0, tRoot};
+
+    while (sp > 0) {
+      const Entry e = stack[--sp];
+      if (e.t >= best.t) continue;  // A nearer hit was found meanwhile
+      const Node& node = mNodes[e.node];
+      if (node.count > 0) {
+        for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+          intersectTri(mTris[i], O, D, best);
+        }
+        continue;
+      }
+      // Visit the nearer child first: push it last
+      uint32_t near = node.leftFirst, far = near + 1;
+      float tNear = slab(mNodes[near], org, inv, best.t);
+      float tFar = slab(mNodes[far], org, inv, best.t);
+      if (tFar < tNear) {
+        std::swap(near, far);
+        std::swap(tNear, tFar);
+      }
+      if (tFar != kMiss) stack[sp++] = Entry{far, tFar};
+      if (tNear != kMiss) stack[sp++] = Entry{near, tNear};
+    }
+    return best;
+  }
+
+private:
+  struct Node {
+    float bmin[3];
+    uint32_t leftFirst;  // Leaf: first triangle; inner: left child (right = +1)
+    float bmax[3];
+    uint32_t count;      // Triangles in a leaf, 0 for inner nodes
+  };
+  static_assert(sizeof(Node) == 32, "MeshBVH::Node should stay 32 bytes");
+
+  struct Tri {
+    al::Vec3f v0, e1, e2;
+  };
+
+  struct Box {
+    float lo[3] = {1e30f, 1e30f, 1e30f};
+    float hi[3] = {-1e30f, -1e30f, -1e30f};
+    void grow(const al::Vec3f& p) {
+      for (int a = 0; a < 3; ++a) {
+        lo[a] = std::min(lo[a], p[a]);
+        hi[a] = std::max(hi[a], p[a]);
+      }
+    }
+    void grow(const Box& b) {
+      for (int a = 0; a < 3; ++a) {
+        lo[a] = std::min(lo[a], b.lo[a]);
+        hi[a] = std::max(hi[a], b.hi[a]);
+      }
+    }
+    float area() const {
+      const float x = hi[0] - lo[0], y = hi[1] - lo[1], z = hi[2] - lo[2];
+      return (x < 0.f) ? 0.f : x * y + y * z + z * x;
+    }
+    float centroid(int a) const { return 0.5f * (lo[a] + hi[a]); }
+  };
+
+  static constexpr int kBins = 12;
+  static constexpr uint32_t kLeafSize = 4;  // Never split below this
+  static constexpr int kMaxDepth = 48;
+  static constexpr float kMiss = std::numeric_limits<float>::infinity();
+
+  static float nonZero(float d) {
+    return std::abs(d) < 1e-12f ? (d < 0.f ? -1e-12f : 1e-12f) : d;
+  }
+
+  // Entry distance into the node's box, or kMiss beyond tMax / behind
+  static float slab(const Node& n, const float* o, const float* inv, float tMax) {
+    float tmin = -kMiss, tmax = kMiss;
+    for (int a = 0; a < 3; ++a) {
+      const float t1 = (n.bmin[a] - o[a]) * inv[a];
+      const float t2 = (n.bmax[a] - o[a]) * inv[a];
+      tmin = std::max(tmin, std::min(t1, t2));
+      tmax = std::min(tmax, std::max(t1, t2));
+    }
+    return (tmax >= tmin && tmax > 0.f && tmin < tMax) ? tmin : kMiss;
+  }
+
+  static void intersectTri(const Tri& tri, const al::Vec3f& O, const al::Vec3f& D, Hit& best) {
+    const al::Vec3f p = D.cross(tri.e2);
+    const float det = tri.e1.dot(p);
+    if (std::abs(det) < 1e-8f) return;
+    const float invDet = 1.f / det;
+    const al::Vec3f tvec = O - tri.v0;
+    const float u = tvec.dot(p) * invDet;
+    if (u < 0.f || u > 1.f) return;
+    const al::Vec3f q = tvec.cross(tri.e1);
+    const float v = D.dot(q) * invDet;
+    if (v < 0.f || u + v > 1.f) return;
+    const float t = tri.e2.dot(q) * invDet;
+    if (t > 1e-4f && t < best.t) {
+      best.hit = true;
+      best.t = t;
+      best.point = O + D * t;
+    }
+  }
+
+  void fitBounds(uint32_t index) {
+    Node& node = mNodes[index];
+    Box box;
+    for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+      box.grow(mBoxes[mOrder[i]]);
+    }
+    for (int a = 0; a < 3; ++a) {
+      node.bmin[a] = box.lo[a];
+      node.bmax[a] = box.hi[a];
+    }
+  }
+
+  // Binned SAH over triangle centroids. Splits the node into two new
+  // children and returns true, or leaves it a leaf when splitting
+  // wouldn't pay.
+  bool split(uint32_t index) {
+    const uint32_t first = mNodes[index].leftFirst;
+    const uint32_t count = mNodes[index].count;
+    if (count <= kLeafSize) return false;
+
+    Box nodeBox;
+    for (int a = 0; a < 3; ++a) {
+      nodeBox.lo[a] = mNodes[index].bmin[a];
+      nodeBox.hi[a] = mNodes[index].bmax[a];
+    }
+
+    int bestAxis = -1, bestSplit = 0;
+    float bestCost = count * nodeBox.area();  // Cost of staying a leaf
+    float bestLo = 0.f, bestScale = 0.f;
+    for (int a = 0; a < 3; ++a) {
+      float lo = 1e30f, hi = -1e30f;
+      for (uint32_t i = first; i < first + count; ++i) {
+        const float c = mBoxes[mOrder[i]].centroid(a);
+        lo = std::min(lo, c);
+        hi = std::max(hi, c);
+      }
+      if (hi <= lo) continue;
+
+      Box bins[kBins];
+      uint32_t binCount[kBins] = {};
+      const float scale = kBins / (hi - lo);
+      for (uint32_t i = first; i < first + count; ++i) {
+        const Box& b = mBoxes[mOrder[i]];
+        const int bin = std::min(kBins - 1, static_cast<int>((b.centroid(a) - lo) * scale));
+        bins[bin].grow(b);
+        binCount[bin]++;
+      }
+
+      // Sweep from both ends: cost of splitting after bin s-1
+      float leftArea[kBins - 1], rightArea[kBins - 1];
+      uint32_t leftCount[kBins - 1], rightCount[kBins - 1];
+      Box left, right;
+      uint32_t nl = 0, nr = 0;
+      for (int s = 0; s < kBins - 1; ++s) {
+        left.grow(bins[s]);
+        nl += binCount[s];
+        leftArea[s] = left.area();
+        leftCount[s] = nl;
+        right.grow(bins[kBins - 1 - s]);
+        nr += binCount[kBins - 1 - s];
+        rightArea[kBins - 2 - s] = right.area();
+        rightCount[kBins - 2 - s] = nr;
+      }
+      for (int s = 0; s < kBins - 1; ++s) {
+        if (leftCount[s] == 0 || rightCount[s] == 0) continue;
+        const float cost = leftCount[s] * leftArea[s] + rightCount[s] * rightArea[s];
+        if (cost < bestCost) {
+          bestCost = cost;
+          bestAxis = a;
+          bestSplit = s + 1;
+          bestLo = lo;
+          bestScale = scale;
+        }
+      }
+    }
+    if (bestAxis < 0) return false;
+
+    // Partition by the same binning, so the counts match the sweep
+    uint32_t i = first, j = first + count;
+    while (i < j) {
+      const float c = mBoxes[mOrder[i]].centroid(bestAxis);
+      const int bin = std::min(kBins - 1, static_cast<int>((c - bestLo) * bestScale));
+      if (bin < bestSplit) {
+        ++i;
+      } else {
+        std::swap(mOrder[i], mOrder[--j]);
+      }
+    }
+    const uint32_t leftCount = i - first;
+    if (leftCount == 0 || leftCount == count) return false;
+
+    const uint32_t left = static_cast<uint32_t>(mNodes.size());
+    mNodes.push_back(Node{});
+    mNodes.push_back(Node{});
+    mNodes[left].leftFirst = first;
+    mNodes[left].count = leftCount;
+    mNodes[left + 1].leftFirst = i;
+    mNodes[left + 1].count = count - leftCount;
+    mNodes[index].leftFirst = left;
+    mNodes[index].count = 0;
+    return true;
+  }
+
+  std::vector<Node> mNodes;
+  std::vector<Tri> mTris;
+  // Build scratch: triangle order and per-triangle bounds
+  std::vector<uint32_t> mOrder;
+  std::vector<Box> mBoxes;
+};
+
 // =====================================================================
 // Pickable
 // =====================================================================
@@ -97,17 +403,17 @@ public:
     rebuildHandleMesh();
   }
 
-  /// Takes a copy of the mesh's vertex positions and indices. If the mesh
-  /// is TRIANGLES, indices/vertices are stored verbatim. TRIANGLE_STRIP /
-  /// TRIANGLE_FAN are expanded to a TRIANGLES index list. LINES / POINTS
-  /// are not pickable — setMesh on those degrades to bounding-sphere mode.
+  /// Builds a BVH over the mesh's triangles. TRIANGLES meshes are used
+  /// verbatim; TRIANGLE_STRIP / TRIANGLE_FAN are expanded to a TRIANGLES
+  /// index list first. LINES / POINTS are not pickable — setMesh on those
+  /// degrades to bounding-sphere mode.
   void setMesh(const al::Mesh& m) {
     mKind = Mesh;
-    mMeshVertices = m.vertices();  // copy
-    mMeshIndices.clear();
+    const auto& vertices = m.vertices();
+    std::vector<unsigned> indices;  // expanded to TRIANGLES
     al::Vec3f minP{1e30f, 1e30f, 1e30f};
     al::Vec3f maxP{-1e30f, -1e30f, -1e30f};
-    for (const auto& v : mMeshVertices) {
+    for (const auto& v : vertices) {
       minP.x = std::min(minP.x, v.x);
       minP.y = std::min(minP.y, v.y);
       minP.z = std::min(minP.z, v.z);
@@ -126,45 +432,46 @@ public:
     const auto& src = m.indices();
     if (prim == al::Mesh::TRIANGLES) {
       if (!src.empty()) {
-        mMeshIndices.assign(src.begin(), src.end());
+        indices.assign(src.begin(), src.end());
       } else {
-        mMeshIndices.reserve(mMeshVertices.size());
-        for (unsigned i = 0; i < mMeshVertices.size(); ++i) mMeshIndices.push_back(i);
+        indices.reserve(vertices.size());
+        for (unsigned i = 0; i < vertices.size(); ++i) indices.push_back(i);
       }
     } else if (prim == al::Mesh::TRIANGLE_STRIP) {
       // Expand strip a,b,c,d,e -> (a,b,c),(c,b,d),(c,d,e),...
       const std::size_t N =
-          src.empty() ? mMeshVertices.size() : src.size();
+          src.empty() ? vertices.size() : src.size();
       auto idx = [&](std::size_t i) -> unsigned {
         return src.empty() ? static_cast<unsigned>(i) : src[i];
       };
       for (std::size_t i = 0; i + 2 < N; ++i) {
         if (i & 1u) {
-          mMeshIndices.push_back(idx(i + 1));
-          mMeshIndices.push_back(idx(i));
-          mMeshIndices.push_back(idx(i + 2));
+          indices.push_back(idx(i + 1));
+          indices.push_back(idx(i));
+          indices.push_back(idx(i + 2));
         } else {
-          mMeshIndices.push_back(idx(i));
-          mMeshIndices.push_back(idx(i + 1));
-          mMeshIndices.push_back(idx(i + 2));
+          indices.push_back(idx(i));
+          indices.push_back(idx(i + 1));
+          indices.push_back(idx(i + 2));
         }
       }
     } else if (prim == al::Mesh::TRIANGLE_FAN) {
       const std::size_t N =
-          src.empty() ? mMeshVertices.size() : src.size();
+          src.empty() ? vertices.size() : src.size();
       auto idx = [&](std::size_t i) -> unsigned {
         return src.empty() ? static_cast<unsigned>(i) : src[i];
       };
       for (std::size_t i = 1; i + 1 < N; ++i) {
-        mMeshIndices.push_back(idx(0));
-        mMeshIndices.push_back(idx(i));
-        mMeshIndices.push_back(idx(i + 1));
+        indices.push_back(idx(0));
+        indices.push_back(idx(i));
+        indices.push_back(idx(i + 1));
       }
     } else {
       // Non-triangulated — fall back to bounding sphere by leaving
-      // mMeshIndices empty; intersect() will use the AABB sphere reject.
-      mMeshIndices.clear();
+      // the BVH empty; intersect() will use the bounding sphere.
+      indices.clear();
     }
+    mBVH.build(vertices, indices);
     rebuildHandleMesh();
   }
 
@@ -175,6 +482,29 @@ public:
 
   Kind kind() const { return mKind; }
 
+  /// World-space box containing every point intersect() can hit. Under a
+  /// rotation the local box is widened to its bounding sphere.
+  void bounds(al::Vec3f& lo, al::Vec3f& hi) const {
+    al::Vec3f localLo{-mRadius, -mRadius, -mRadius};
+    al::Vec3f localHi{mRadius, mRadius, mRadius};
+    if (mKind == AABB) {
+      localLo = mMin - mCenter;
+      localHi = mMax - mCenter;
+    } else if (mKind == Mesh && !mBVH.empty()) {
+      localLo = mMin;  // BVH triangles are relative to mPosition
+      localHi = mMax;
+    }
+    if (!isIdentityQuat()) {
+      float r2 = 0.f;
+      for (int a = 0; a < 3; ++a) r2 += std::max(localLo[a] * localLo[a], localHi[a] * localHi[a]);
+      const float r = std::sqrt(r2);
+      localLo = al::Vec3f{-r, -r, -r};
+      localHi = al::Vec3f{r, r, r};
+    }
+    lo = mPosition + localLo;
+    hi = mPosition + localHi;
+  }
+
   // ---- Intersection ---------------------------------------------------
 
   /// Intersect a world-space ray against this pickable. Returns the
@@ -221,16 +551,12 @@ public:
         break;
       }
       case Mesh: {
-        if (mMeshIndices.empty()) {
+        if (mBVH.empty()) {
           // Fallback bounding sphere
           h = intersectSphere(localOrigin, localDir, al::Vec3f{0, 0, 0}, mRadius);
         } else {
-          // Quick AABB reject
-          const al::Vec3f localMin = mMin - mCenter;
-          const al::Vec3f localMax = mMax - mCenter;
-          Hit aabb = intersectAABB(localOrigin, localDir, localMin, localMax);
-          if (!aabb.hit) return Hit{};
-          h = intersectMesh(localOrigin, localDir);
+          // The root box is the quick reject
+          h = mBVH.intersect(localOrigin, localDir);
         }
         break;
       }
@@ -346,8 +672,7 @@ private:
   al::Vec3f mMin{-1, -1, -1};
   al::Vec3f mMax{1, 1, 1};
   al::Pose mPose;
-  std::vector<al::Mesh::Vertex> mMeshVertices;  // local-space copy
-  std::vector<unsigned> mMeshIndices;           // expanded to TRIANGLES
+  MeshBVH mBVH;  // local-space triangles, Mesh kind only
 
   al::Mesh mHandleMesh;  // small visualizer drawn at draw()
 
@@ -422,35 +747,6 @@ private:
     return h;
   }
 
-  // Möller-Trumbore. Returns nearest positive-t hit across all triangles.
-  Hit intersectMesh(const al::Vec3f& O, const al::Vec3f& D) const {
-    Hit best;
-    for (std::size_t i = 0; i + 2 < mMeshIndices.size(); i += 3) {
-      const auto& v0 = mMeshVertices[mMeshIndices[i + 0]];
-      const auto& v1 = mMeshVertices[mMeshIndices[i + 1]];
-      const auto& v2 = mMeshVertices[mMeshIndices[i + 2]];
-      const al::Vec3f e1 = v1 - v0;
-      const al::Vec3f e2 = v2 - v0;
-      const al::Vec3f p = D.cross(e2);
-      const float det = e1.dot(p);
-      if (std::abs(det) < 1e-8f) continue;
-      const float invDet = 1.f / det;
-      const al::Vec3f tvec = O - v0;
-      const float u = tvec.dot(p) * invDet;
-      if (u < 0.f || u > 1.f) continue;
-      const al::Vec3f q = tvec.cross(e1);
-      const float v = D.dot(q) * invDet;
-      if (v < 0.f || u + v > 1.f) continue;
-      const float t = e2.dot(q) * invDet;
-      if (t > 1e-4f && t < best.t) {
-        best.hit = true;
-        best.t = t;
-        best.point = O + D * t;
-      }
-    }
-    return best;
-  }
-
   void rebuildHandleMesh() {
     mHandleMesh.reset();
     mHandleMesh.primitive(al::Mesh::TRIANGLES);
@@ -461,6 +757,390 @@ private:
   }
 };
 
+// =====================================================================
+// PickManager
+// =====================================================================
+
+/// Scene-level picking across many Pickables. World bounds live in a
+/// dynamic AABB tree (insertion by surface-area cost, AVL-style
+/// rotations), so a hover or click ray tests only the handles whose
+/// boxes it crosses, nearest first, and stops once the boxes left are
+/// beyond the nearest hit. Leaves are fattened by a margin so small moves
+/// don't touch the tree; drags routed through onMouseDrag() refit the
+/// dragged handle themselves, and moved(id) does it for handles the app
+/// repositions (setPosition, setTransform, set* shape calls).
+///
+/// Pickables are not owned and must stay at the same address while
+/// registered (e.g. reserve() the vector holding them before add()).
+class PickManager {
+public:
+  struct PickHit {
+    int id = -1;
+    Pickable* pickable = nullptr;
+    Hit hit;
+  };
+
+  /// Register a pickable; returns its id
+  int add(Pickable& p) {
+    int id;
+    if (!mFreeEntries.empty()) {
+      id = mFreeEntries.back();
+      mFreeEntries.pop_back();
+    } else {
+      id = static_cast<int>(mEntries.size());
+      mEntries.push_back(Entry{});
+    }
+    mEntries[id].pickable = &p;
+    mEntries[id].leaf = allocNode();
+    Node& leaf = mNodes[mEntries[id].leaf];
+    leaf.entry = id;
+    fatBounds(p, leaf.lo, leaf.hi);
+    insertLeaf(mEntries[id].leaf);
+    ++mCount;
+    return id;
+  }
+
+  void remove(int id) {
+    if (!valid(id)) return;
+    removeLeaf(mEntries[id].leaf);
+    freeNode(mEntries[id].leaf);
+    mEntries[id] = Entry{};
+    mFreeEntries.push_back(id);
+    --mCount;
+    if (mHovered == id) mHovered = -1;
+    if (mActive == id) mActive = -1;
+  }
+
+  void clear() {
+    mNodes.clear();
+    mFreeNodes.clear();
+    mEntries.clear();
+    mFreeEntries.clear();
+    mRoot = -1;
+    mCount = 0;
+    mHovered = mActive = -1;
+  }
+
+  /// The pickable moved or changed shape; refit its leaf if it left the margin
+  void moved(int id) {
+    if (!valid(id)) return;
+    const int leaf = mEntries[id].leaf;
+    al::Vec3f lo, hi;
+    mEntries[id].pickable->bounds(lo, hi);
+    const Node& n = mNodes[leaf];
+    if (contains(n.lo, n.hi, lo, hi)) return;
+    removeLeaf(leaf);
+    fatBounds(*mEntries[id].pickable, mNodes[leaf].lo, mNodes[leaf].hi);
+    insertLeaf(leaf);
+  }
+
+  /// moved() for every pickable, after the app repositioned many at once
+  void refitAll() {
+    for (int id = 0; id < static_cast<int>(mEntries.size()); ++id) moved(id);
+  }
+
+  bool valid(int id) const {
+    return id >= 0 && id < static_cast<int>(mEntries.size()) && mEntries[id].pickable;
+  }
+  Pickable* get(int id) const { return valid(id) ? mEntries[id].pickable : nullptr; }
+  std::size_t size() const { return mCount; }
+
+  /// Nearest pickable hit by the ray, if any
+  PickHit pick(const al::Vec3f& rayOrigin, const al::Vec3f& rayDir) const {
+    PickHit best;
+    mLastTests = 0;
+    const float len = rayDir.mag();
+    if (mRoot < 0 || len <= 0.f) return best;
+    const al::Vec3f D = rayDir * (1.f / len);
+    const float inv[3] = {1.f / nonZero(D.x), 1.f / nonZero(D.y), 1.f / nonZero(D.z)};
+
+    std::vector<StackItem>& stack = mStack;  // Kept to avoid allocating per pick
+    stack.clear();
+    const float tRoot = slab(mNodes[mRoot], rayOrigin, inv, best.hit.t);
+    if (tRoot != kMiss) stack.push_back(StackItem{mRoot, tRoot});
+    while (!stack.empty()) {
+      const StackItem it = stack.back();
+      stack.pop_back();
+      if (it.t >= best.hit.t) continue;
+      const Node& n = mNodes[it.node];
+      if (n.left < 0) {
+        const Entry& e = mEntries[n.entry];
+        ++mLastTests;
+        const Hit h = e.pickable->intersect(rayOrigin, rayDir);
+        if (h.hit && h.t < best.hit.t) {
+          best.id = n.entry;
+          best.pickable = e.pickable;
+          best.hit = h;
+        }
+        continue;
+      }
+      int near = n.left, far = n.right;
+      float tNear = slab(mNodes[near], rayOrigin, inv, best.hit.t);
+      float tFar = slab(mNodes[far], rayOrigin, inv, best.hit.t);
+      if (tFar < tNear) {
+        std::swap(near, far);
+        std::swap(tNear, tFar);
+      }
+      if (tFar != kMiss) stack.push_back(StackItem{far, tFar});
+      if (tNear != kMiss) stack.push_back(StackItem{near, tNear});
+    }
+    return best;
+  }
+
+  /// Update the hovered pickable from a mouse ray; returns its id or -1
+  int hover(const al::Vec3f& rayOrigin, const al::Vec3f& rayDir) {
+    mHovered = pick(rayOrigin, rayDir).id;
+    return mHovered;
+  }
+
+  // ---- Drag routing ----------------------------------------------------
+
+  /// Start dragging the nearest pickable under the ray
+  bool onMouseDown(const al::Vec3f& rayOrigin, const al::Vec3f& rayDir) {
+    mActive = -1;
+    const PickHit h = pick(rayOrigin, rayDir);
+    if (h.id < 0 || !h.pickable->onMouseDown(rayOrigin, rayDir)) return false;
+    mActive = h.id;
+    mHovered = h.id;
+    return true;
+  }
+
+  bool onMouseDrag(const al::Vec3f& rayOrigin, const al::Vec3f& rayDir) {
+    if (!valid(mActive)) return false;
+    const bool moving = mEntries[mActive].pickable->onMouseDrag(rayOrigin, rayDir);
+    if (moving) moved(mActive);
+    return moving;
+  }
+
+  void onMouseUp() {
+    if (valid(mActive)) mEntries[mActive].pickable->onMouseUp();
+    mActive = -1;
+  }
+
+  int hovered() const { return mHovered; }
+  int active() const { return mActive; }  // Being dragged, or -1
+
+  /// Draw every registered pickable, highlighting the hovered one
+  void draw(al::Graphics& g) const {
+    for (int id = 0; id < static_cast<int>(mEntries.size()); ++id) {
+      if (mEntries[id].pickable) mEntries[id].pickable->draw(g, id == mHovered);
+    }
+  }
+
+  /// Pickable::intersect calls made by the last pick (diagnostics)
+  int lastTests() const { return mLastTests; }
+  /// Height of the tree (0 for a single leaf, -1 when empty)
+  int height() const { return mRoot < 0 ? -1 : mNodes[mRoot].height; }
+
+private:
+  struct Node {
+    al::Vec3f lo, hi;
+    int parent = -1;
+    int left = -1;   // -1 for leaves
+    int right = -1;
+    int entry = -1;  // Leaves: pickable id
+    int height = 0;  // Leaves: 0
+  };
+
+  struct Entry {
+    Pickable* pickable = nullptr;
+    int leaf = -1;
+  };
+
+  struct StackItem {
+    int node;
+    float t;  // Ray entry into the node's box
+  };
+
+  static constexpr float kMiss = std::numeric_limits<float>::infinity();
+
+  static float nonZero(float d) {
+    return std::abs(d) < 1e-12f ? (d < 0.f ? -1e-12f : 1e-12f) : d;
+  }
+
+  static float slab(const Node& n, const al::Vec3f& o, const float* inv, float tMax) {
+    float tmin = -kMiss, tmax = kMiss;
+    for (int a = 0; a < 3; ++a) {
+      const float t1 = (n.lo[a] - o[a]) * inv[a];
+      const float t2 = (n.hi[a] - o[a]) * inv[a];
+      tmin = std::max(tmin, std::min(t1, t2));
+      tmax = std::min(tmax, std::max(t1, t2));
+    }
+    return (tmax >= tmin && tmax > 0.f && tmin < tMax) ? tmin : kMiss;
+  }
+
+  static float area(const al::Vec3f& lo, const al::Vec3f& hi) {
+    const al::Vec3f d = hi - lo;
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+  }
+
+  static void merge(const Node& a, const Node& b, al::Vec3f& lo, al::Vec3f& hi) {
+    lo = al::Vec3f{std::min(a.lo.x, b.lo.x), std::min(a.lo.y, b.lo.y), std::min(a.lo.z, b.lo.z)};
+    hi = al::Vec3f{std::max(a.hi.x, b.hi.x), std::max(a.hi.y, b.hi.y), std::max(a.hi.z, b.hi.z)};
+  }
+
+  static bool contains(const al::Vec3f& outerLo, const al::Vec3f& outerHi,
+                       const al::Vec3f& lo, const al::Vec3f& hi) {
+    return outerLo.x <= lo.x && outerLo.y <= lo.y && outerLo.z <= lo.z &&
+           hi.x <= outerHi.x && hi.y <= outerHi.y && hi.z <= outerHi.z;
+  }
+
+  // Tight bounds plus a margin of 10% of the extent
+  static void fatBounds(const Pickable& p, al::Vec3f& lo, al::Vec3f& hi) {
+    p.bounds(lo, hi);
+    const al::Vec3f d = hi - lo;
+    const float m = 0.1f * std::max(d.x, std::max(d.y, d.z)) + 1e-4f;
+    lo = lo - al::Vec3f{m, m, m};
+    hi = hi + al::Vec3f{m, m, m};
+  }
+
+  int allocNode() {
+    if (!mFreeNodes.empty()) {
+      const int n = mFreeNodes.back();
+      mFreeNodes.pop_back();
+      mNodes[n] = Node{};
+      return n;
+    }
+    mNodes.push_back(Node{});
+    return static_cast<int>(mNodes.size()) - 1;
+  }
+
+  void freeNode(int n) { mFreeNodes.push_back(n); }
+
+  void fit(int n) {
+    Node& node = mNodes[n];
+    merge(mNodes[node.left], mNodes[node.right], node.lo, node.hi);
+    node.height = 1 + std::max(mNodes[node.left].height, mNodes[node.right].height);
+  }
+
+  void insertLeaf(int leaf) {
+    if (mRoot < 0) {
+      mRoot = leaf;
+      mNodes[leaf].parent = -1;
+      return;
+    }
+
+    // Descend towards the sibling that grows the tree's surface area least
+    const Node& box = mNodes[leaf];
+    int index = mRoot;
+    while (mNodes[index].left >= 0) {
+      const Node& n = mNodes[index];
+      al::Vec3f lo, hi;
+      merge(n, box, lo, hi);
+      const float combined = area(lo, hi);
+      const float cost = 2.f * combined;              // Pair with this node
+      const float inherit = 2.f * (combined - area(n.lo, n.hi));
+      auto childCost = [&](int c) {
+        const Node& child = mNodes[c];
+        merge(child, box, lo, hi);
+        const float grown = area(lo, hi);
+        return (child.left < 0 ? grown : grown - area(child.lo, child.hi)) + inherit;
+      };
+      const float costLeft = childCost(n.left);
+      const float costRight = childCost(n.right);
+      if (cost < costLeft && cost < costRight) break;
+      index = costLeft < costRight ? n.left : n.right;
+    }
+
+    const int sibling = index;
+    const int oldParent = mNodes[sibling].parent;
+    const int parent = allocNode();
+    mNodes[parent].parent = oldParent;
+    mNodes[parent].left = sibling;
+    mNodes[parent].right = leaf;
+    mNodes[sibling].parent = parent;
+    mNodes[leaf].parent = parent;
+    fit(parent);
+    if (oldParent < 0) {
+      mRoot = parent;
+    } else if (mNodes[oldParent].left == sibling) {
+      mNodes[oldParent].left = parent;
+    } else {
+      mNodes[oldParent].right = parent;
+    }
+
+    for (int n = mNodes[leaf].parent; n >= 0; n = mNodes[n].parent) {
+      n = balance(n);
+      fit(n);
+    }
+  }
+
+  void removeLeaf(int leaf) {
+    if (leaf == mRoot) {
+      mRoot = -1;
+      return;
+    }
+    const int parent = mNodes[leaf].parent;
+    const int grandParent = mNodes[parent].parent;
+    const int sibling = mNodes[parent].left == leaf ? mNodes[parent].right : mNodes[parent].left;
+    freeNode(parent);
+    if (grandParent < 0) {
+      mRoot = sibling;
+      mNodes[sibling].parent = -1;
+      return;
+    }
+    if (mNodes[grandParent].left == parent) mNodes[grandParent].left = sibling;
+    else mNodes[grandParent].right = sibling;
+    mNodes[sibling].parent = grandParent;
+    for (int n = grandParent; n >= 0; n = mNodes[n].parent) {
+      n = balance(n);
+      fit(n);
+    }
+  }
+
+  // Rotate a child up when the subtree heights differ by more than one;
+  // returns the subtree's new root
+  int balance(int a) {
+    Node& A = mNodes[a];
+    if (A.left < 0 || A.height < 2) return a;
+    const int b = A.left, c = A.right;
+    const int diff = mNodes[c].height - mNodes[b].height;
+    if (diff > 1) return rotate(a, c, b);
+    if (diff < -1) return rotate(a, b, c);
+    return a;
+  }
+
+  // Promote `up` (a child of a) over a; `other` is a's remaining child
+  int rotate(int a, int up, int other) {
+    Node& U = mNodes[up];
+    const int f = U.left, g = U.right;
+
+    // `up` takes a's place
+    U.left = a;
+    U.parent = mNodes[a].parent;
+    mNodes[a].parent = up;
+    if (U.parent < 0) {
+      mRoot = up;
+    } else if (mNodes[U.parent].left == a) {
+      mNodes[U.parent].left = up;
+    } else {
+      mNodes[U.parent].right = up;
+    }
+
+    // The taller grandchild stays under `up`, the shorter moves under a
+    const int keep = mNodes[f].height > mNodes[g].height ? f : g;
+    const int give = keep == f ? g : f;
+    U.right = keep;
+    mNodes[a].left = other;
+    mNodes[a].right = give;
+    mNodes[give].parent = a;
+    fit(a);
+    fit(up);
+    return up;
+  }
+
+  std::vector<Node> mNodes;
+  std::vector<int> mFreeNodes;
+  std::vector<Entry> mEntries;
+  std::vector<int> mFreeEntries;
+  int mRoot = -1;
+  std::size_t mCount = 0;
+  int mHovered = -1;
+  int mActive = -1;
+  mutable int mLastTests = 0;
+  mutable std::vector<StackItem> mStack;
+};
+
 // =====================================================================
 // screenToRay
 // =====================================================================
@@ -13,6 +13,20 @@
  * reads via readRow() which copies into a caller-owned buffer (no
  * allocation in the audio path -- the caller pre-sizes dst).
  *
+ * readRow() can still catch a row while the graphics thread rewrites it.
+ * For large images, enableFrames() switches on a triple-buffered frame
+ * mode: the graphics thread fills backFrame() (or calls publishFrom())
+ * and publishes whole frames; the audio thread calls acquireFrame() once
+ * per block and then reads row(), column() or pixel() straight out of a
+ * frame nobody is writing -- no copy, no torn rows, no waiting on either
+ * side. Layout::ColumnMajor stores each column contiguously, for patches
+ * that scan the image left to right (one column per block or grain).
+ *
+ *   bridge.enableFrames(studio::PixelAudioBridge::Layout::ColumnMajor);
+ *   bridge.publishFrom(canvasPixels);       // graphics: RGBA, row-major in
+ *   bridge.acquireFrame();                  // audio: once per block
+ *   const uint8_t* col = bridge.column(x);  // height*channels bytes
+ *
  * Header-only. No <thread> / pthread.
  */
 
@@ -27,6 +41,10 @@ namespace studio {
 
 class PixelAudioBridge {
 public:
+  // Frame-mode storage order. RowMajor: pixel (x, y) at
+  // (y*width + x)*channels. ColumnMajor: at (x*height + y)*channels.
+  enum class Layout { RowMajor, ColumnMajor };
+
   PixelAudioBridge(int width, int height, int channels = 4)
       : mWidth(width > 0 ? width : 1),
         mHeight(height > 0 ? height : 1),
@@ -78,6 +96,117 @@ public:
     return mRow.load(std::memory_order_acquire);
   }
 
+  // ---------------- Frame mode: graphics-thread side --------------------
+
+  // Allocate three frames in `layout` (call before audio starts; this is
+  // the only allocation). Calling it again re-lays out and clears them.
+  void enableFrames(Layout layout = Layout::RowMajor) {
+    mLayout = layout;
+    mFrames.assign(frameBytes() * 3, 0);
+    mShared.store(1, std::memory_order_relaxed);
+    mBack = 0;
+    mFront = 2;
+    mPublished.store(0, std::memory_order_release);
+    mAcquired = 0;
+  }
+
+  bool framesEnabled() const { return !mFrames.empty(); }
+  Layout layout() const { return mLayout; }
+  size_t frameBytes() const {
+    return static_cast<size_t>(mWidth) * mHeight * mChannels;
+  }
+
+  // Frame being built, in layout() order; frameBytes() long. Its contents
+  // are whatever that slot last held, so overwrite it entirely.
+  uint8_t* backFrame() {
+    if (mFrames.empty()) return nullptr;
+    return mFrames.data() + static_cast<size_t>(mBack) * frameBytes();
+  }
+
+  // Make backFrame() the latest frame and hand over a fresh back slot.
+  void publishFrame() {
+    if (mFrames.empty()) return;
+    mPublished.fetch_add(1, std::memory_order_relaxed);
+    mBack = mShared.exchange(mBack | kFresh, std::memory_order_acq_rel) &
+            kIndex;
+  }
+
+  // Copy a row-major image (as from uploadFrom / readPixels) into the
+  // back frame, transposing for ColumnMajor, and publish it. Short
+  // sources leave the remainder zeroed.
+  void publishFrom(const uint8_t* src, size_t bytes) {
+    uint8_t* dst = backFrame();
+    if (!dst) return;
+    const size_t n = bytes < frameBytes() ? bytes : frameBytes();
+    if (mLayout == Layout::RowMajor) {
+      std::memcpy(dst, src, n);
+      std::memset(dst + n, 0, frameBytes() - n);
+    } else {
+      if (n < frameBytes()) std::memset(dst, 0, frameBytes());
+      const size_t ch = static_cast<size_t>(mChannels);
+      const size_t pixels = n / ch;
+      for (size_t i = 0; i < pixels; ++i) {
+        const size_t x = i % mWidth, y = i / mWidth;
+        std::memcpy(dst + (x * mHeight + y) * ch, src + i * ch, ch);
+      }
+    }
+    publishFrame();
+  }
+
+  void publishFrom(const std::vector<uint8_t>& src) {
+    publishFrom(src.data(), src.size());
+  }
+
+  // ---------------- Frame mode: audio-thread side (no alloc, no copy) ---
+
+  // Switch to the latest published frame, if there is a newer one. The
+  // frame stays stable until the next acquireFrame(). Returns true when
+  // it changed.
+  bool acquireFrame() {
+    if (mFrames.empty()) return false;
+    if (!(mShared.load(std::memory_order_relaxed) & kFresh)) return false;
+    mFront = mShared.exchange(mFront, std::memory_order_acq_rel) & kIndex;
+    mAcquired = mPublished.load(std::memory_order_relaxed);
+    return true;
+  }
+
+  // The acquired frame (all zeros before the first publish)
+  const uint8_t* frame() const {
+    if (mFrames.empty()) return nullptr;
+    return mFrames.data() + static_cast<size_t>(mFront) * frameBytes();
+  }
+
+  // Publish count seen at the last acquire (may already count a frame
+  // published just after it); changes only when a new frame arrived.
+  uint32_t frameNumber() const { return mAcquired; }
+
+  // width*channels contiguous bytes. RowMajor only; nullptr otherwise or
+  // when out of range.
+  const uint8_t* row(int y) const {
+    if (mLayout != Layout::RowMajor || y < 0 || y >= mHeight) return nullptr;
+    const uint8_t* f = frame();
+    return f ? f + static_cast<size_t>(y) * mWidth * mChannels : nullptr;
+  }
+
+  // height*channels contiguous bytes. ColumnMajor only; nullptr otherwise
+  // or when out of range.
+  const uint8_t* column(int x) const {
+    if (mLayout != Layout::ColumnMajor || x < 0 || x >= mWidth) return nullptr;
+    const uint8_t* f = frame();
+    return f ? f + static_cast<size_t>(x) * mHeight * mChannels : nullptr;
+  }
+
+  // Channel 0 of pixel (x, y) in the acquired frame, either layout.
+  const uint8_t* pixel(int x, int y) const {
+    if (x < 0 || x >= mWidth || y < 0 || y >= mHeight) return nullptr;
+    const uint8_t* f = frame();
+    if (!f) return nullptr;
+    const size_t i = mLayout == Layout::RowMajor
+                         ? static_cast<size_t>(y) * mWidth + x
+                         : static_cast<size_t>(x) * mHeight + y;
+    return f + i * static_cast<size_t>(mChannels);
+  }
+
   // ---------------- Shape -----------------------------------------------
   int width() const { return mWidth; }
   int height() const { return mHeight; }
@@ -89,6 +218,19 @@ private:
   int mChannels;
   std::vector<uint8_t> mBuf;
   std::atomic<int> mRow{0};
+
+  // Frame mode: three slots; mShared holds the middle slot's index plus
+  // kFresh when it's newer than the reader's (same scheme as
+  // al::LockFreeSnapshot).
+  static constexpr int kIndex = 3;
+  static constexpr int kFresh = 4;
+  Layout mLayout = Layout::RowMajor;
+  std::vector<uint8_t> mFrames;
+  std::atomic<int> mShared{1};
+  std::atomic<uint32_t> mPublished{0};
+  int mBack = 0;           // Graphics-thread owned
+  int mFront = 2;          // Audio-thread owned
+  uint32_t mAcquired = 0;  // Audio-thread owned
 };
 
 }  // namespace studio
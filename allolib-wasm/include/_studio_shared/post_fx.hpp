@@ -4,8 +4,8 @@
 // MAT200B Studio Online — Post-FX chain helper (header-only).
 //
 // Ping-pong EasyFBO chain that runs a stack of 2D fragment shaders over a
-// captured scene. Effects: Phosphor (CRT decay), Bloom, ChromaticAberration,
-// Glitch, Vignette.
+// captured scene. Effects: Phosphor (CRT decay), Bloom (dual-filter mip
+// chain), ChromaticAberration, Glitch, Vignette.
 //
 // Web-specific notes:
 //   - All shader sources are embedded as static const char*, ES 3.0 dialect
@@ -14,7 +14,15 @@
 //     fragile in the worker).
 //   - al::EasyFBO comes from the web-replaced version (al_EasyFBO_Web.cpp,
 //     linked into libal_web.a per plan §0.6) — same API as upstream.
+//   - The capture target, ping-pong and bloom level targets are borrowed
+//     from al::RenderTargetPool for the duration of a frame, so chains and
+//     other pooled effects at the same size share them and a resize only
+//     allocates what the next frame actually asks for.
 //   - Effects render a fullscreen triangle via inline geometry (no Mesh).
+//   - Consecutive ChromaticAberration / Glitch / Vignette effects are fused
+//     into one generated shader (see kChromaStage), so a run of them costs
+//     a single full-screen pass. Phosphor (frame history) and Bloom
+//     (neighbourhood blur) always run as their own passes.
 //
 // Usage sketch:
 //
@@ -29,13 +37,17 @@
 //     // ... draw scene with `g` against the captured FBO ...
 //   fx.endCaptureAndRender(g);
 
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "al/graphics/al_EasyFBO.hpp"
 #include "al/graphics/al_Graphics.hpp"
 #include "al/graphics/al_Shader.hpp"
 #include "al/graphics/al_VAOMesh.hpp"
+#include "al_WebRenderTargetPool.hpp"
 
 namespace studio {
 
@@ -81,36 +93,68 @@ void main() {
 }
 )";
 
-// ─── Bloom (single-pass gaussian blur on bright extract, additive) ─────────
-// For brevity this is one combined pass; quality-conscious examples can
-// chain two FX::Bloom pushes for a separable HV blur.
-static const char* kBloomFS = R"(#version 300 es
+// ─── Bloom (dual-filter mip chain) ─────────────────────────────────────────
+// Bright parts are downsampled to 1/2, 1/4, ... resolution with a 5-tap
+// box-corner filter, then upsampled back with a 9-tap tent, each level
+// adding the one below it. The glow spreads across the whole chain while
+// every pass after the first touches a quarter of the pixels of the last.
+//
+// Down: uTexel is the source's texel size; uPrefilter applies the
+// brightness threshold on the first (full-resolution) step.
+static const char* kBloomDownFS = R"(#version 300 es
 precision highp float;
 in vec2 vUV;
 uniform sampler2D uCurrent;
 uniform vec2 uTexel;
-uniform float uStrength;
 uniform float uThreshold;
+uniform int uPrefilter;
 out vec4 fragColor;
-const float W[5] = float[5](0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);
 void main() {
-  vec3 base = texture(uCurrent, vUV).rgb;
-  // Brightness extract.
-  float lum = dot(base, vec3(0.2126, 0.7152, 0.0722));
-  vec3 hi = base * smoothstep(uThreshold, uThreshold + 0.1, lum);
-  // Two-direction 9-tap gaussian on the brightness channel.
-  vec3 acc = hi * W[0];
-  for (int i = 1; i < 5; ++i) {
-    float fi = float(i);
-    acc += texture(uCurrent, vUV + vec2(uTexel.x * fi, 0.0)).rgb * W[i];
-    acc += texture(uCurrent, vUV - vec2(uTexel.x * fi, 0.0)).rgb * W[i];
-    acc += texture(uCurrent, vUV + vec2(0.0, uTexel.y * fi)).rgb * W[i];
-    acc += texture(uCurrent, vUV - vec2(0.0, uTexel.y * fi)).rgb * W[i];
+  vec3 c = texture(uCurrent, vUV).rgb * 4.0;
+  c += texture(uCurrent, vUV - uTexel).rgb;
+  c += texture(uCurrent, vUV + uTexel).rgb;
+  c += texture(uCurrent, vUV + vec2(uTexel.x, -uTexel.y)).rgb;
+  c += texture(uCurrent, vUV - vec2(uTexel.x, -uTexel.y)).rgb;
+  c *= 0.125;
+  if (uPrefilter == 1) {
+    float lum = dot(c, vec3(0.2126, 0.7152, 0.0722));
+    c *= smoothstep(uThreshold, uThreshold + 0.1, lum);
   }
-  fragColor = vec4(base + acc * uStrength, 1.0);
+  fragColor = vec4(c, 1.0);
 }
 )";
 
+// Up: tent-filters the lower level (uCurrent, texel uTexel) and adds it to
+// uBase. Intermediate levels use uStrength 1; the last step composites onto
+// the scene with the effect's strength.
+static const char* kBloomUpFS = R"(#version 300 es
+precision highp float;
+in vec2 vUV;
+uniform sampler2D uCurrent;
+uniform sampler2D uBase;
+uniform vec2 uTexel;
+uniform float uStrength;
+out vec4 fragColor;
+void main() {
+  vec2 h = uTexel * 0.5;
+  vec3 acc = texture(uCurrent, vUV + vec2(-uTexel.x, 0.0)).rgb;
+  acc += texture(uCurrent, vUV + vec2(uTexel.x, 0.0)).rgb;
+  acc += texture(uCurrent, vUV + vec2(0.0, -uTexel.y)).rgb;
+  acc += texture(uCurrent, vUV + vec2(0.0, uTexel.y)).rgb;
+  acc += texture(uCurrent, vUV + vec2(-h.x, -h.y)).rgb * 2.0;
+  acc += texture(uCurrent, vUV + vec2(h.x, -h.y)).rgb * 2.0;
+  acc += texture(uCurrent, vUV + vec2(-h.x, h.y)).rgb * 2.0;
+  acc += texture(uCurrent, vUV + vec2(h.x, h.y)).rgb * 2.0;
+  vec3 base = texture(uBase, vUV).rgb;
+  fragColor = vec4(base + acc * (uStrength / 12.0), 1.0);
+}
+)";
+
+// Levels below full resolution, stopping early once a level would be
+// smaller than this on either side
+static constexpr int kBloomMaxLevels = 6;
+static constexpr int kBloomMinSize = 8;
+
 // ─── Chromatic aberration (radial RGB split) ───────────────────────────────
 static const char* kChromaFS = R"(#version 300 es
 precision highp float;
@@ -164,10 +208,87 @@ void main() {
 }
 )";
 
+// ─── Fused stages ──────────────────────────────────────────────────────────
+// Effects that only move where their input is sampled (Chroma, Glitch) or
+// scale the sampled color (Vignette) compose as functions: stage i is
+// fx<i>(uv) and reads stage i-1 through SRC(uv), the first stage reads
+// uCurrent. `$` becomes the stage index, which also suffixes the uniforms.
+static const char* kFusedHeader = R"(#version 300 es
+precision highp float;
+in vec2 vUV;
+uniform sampler2D uCurrent;
+out vec4 fragColor;
+float fxHash(float n) { return fract(sin(n) * 43758.5453); }
+)";
+
+static const char* kChromaStage = R"(
+uniform float uStrength$;
+vec4 fx$(vec2 uv) {
+  vec2 d = uv - vec2(0.5);
+  vec2 off = d * dot(d, d) * uStrength$;
+  return vec4(SRC(uv - off).r, SRC(uv).g, SRC(uv + off).b, 1.0);
+}
+)";
+
+static const char* kGlitchStage = R"(
+uniform float uStrength$;
+uniform float uTime$;
+vec4 fx$(vec2 uv) {
+  float r = fxHash(floor(uv.y * 64.0) + floor(uTime$ * 30.0));
+  float xoff = (r - 0.5) * 0.1 * uStrength$ * step(0.92, r);
+  return SRC(vec2(uv.x + xoff, uv.y));
+}
+)";
+
+static const char* kVignetteStage = R"(
+uniform float uStrength$;
+vec4 fx$(vec2 uv) {
+  vec2 d = uv - vec2(0.5);
+  float v = clamp(1.0 - dot(d, d) * 4.0 * uStrength$, 0.0, 1.0);
+  return vec4(SRC(uv).rgb * v, 1.0);
+}
+)";
+
+// Input reads per invocation multiply down a fused run (three chroma stages
+// would be 27 fetches), so runs are split past this many
+static constexpr int kMaxFusedFetches = 9;
+
+// Stage template for a fusable effect, nullptr for the rest
+inline const char* stageSource(FX fx) {
+  switch (fx) {
+    case FX::ChromaticAberration: return kChromaStage;
+    case FX::Glitch:              return kGlitchStage;
+    case FX::Vignette:            return kVignetteStage;
+    default:                      return nullptr;
+  }
+}
+
+inline int stageFetches(FX fx) { return fx == FX::ChromaticAberration ? 3 : 1; }
+
+inline void replaceAll(std::string& s, const std::string& from, const std::string& to) {
+  for (size_t pos = s.find(from); pos != std::string::npos; pos = s.find(from, pos + to.size())) {
+    s.replace(pos, from.size(), to);
+  }
+}
+
+// Fragment shader running `stages` (all fusable) as one pass
+inline std::string fusedSource(const std::vector<FX>& stages) {
+  std::string source = kFusedHeader;
+  for (size_t i = 0; i < stages.size(); ++i) {
+    std::string stage = stageSource(stages[i]);
+    replaceAll(stage, "SRC(", i == 0 ? std::string("texture(uCurrent, ")
+                                     : "fx" + std::to_string(i - 1) + "(");
+    replaceAll(stage, "$", std::to_string(i));
+    source += stage;
+  }
+  source += "void main() { fragColor = fx" + std::to_string(stages.size() - 1) + "(vUV); }\n";
+  return source;
+}
+
 inline const char* fragmentSource(FX fx) {
   switch (fx) {
     case FX::Phosphor:            return kPhosphorFS;
-    case FX::Bloom:               return kBloomFS;
+    case FX::Bloom:               return kBloomUpFS;
     case FX::ChromaticAberration: return kChromaFS;
     case FX::Glitch:              return kGlitchFS;
     case FX::Vignette:            return kVignetteFS;
@@ -187,27 +308,18 @@ class PostFXChain {
     std::vector<std::pair<std::string, float>> overrides;
   };
 
-  // Compile shaders + create ping-pong FBOs sized (w,h).
+  // Compile shaders for a (w,h) frame; targets come from the pool per frame.
   void init(int w, int h) {
     if (mInitialized) return;
     mWidth = w;
     mHeight = h;
 
-    al::EasyFBOSetting s;
-    s.internal = 0x8814;  // GL_RGBA16F — extended dynamic range for bloom.
-    s.format = 0x1908;    // GL_RGBA
-    s.type = 0x1406;      // GL_FLOAT
-    s.filterMin = 0x2601; // GL_LINEAR
-    s.filterMag = 0x2601; // GL_LINEAR
-    mInputFBO.init(w, h, s);
-    mPing.init(w, h, s);
-    mPong.init(w, h, s);
-
     // Per-effect shader programs; compile lazily to keep startup cheap, but
     // since we know the kit is small we just compile all up front.
     using namespace post_fx_detail;
     mShaders[(int)FX::Phosphor].compile(kFullscreenVS, kPhosphorFS);
-    mShaders[(int)FX::Bloom].compile(kFullscreenVS, kBloomFS);
+    mShaders[(int)FX::Bloom].compile(kFullscreenVS, kBloomUpFS);
+    mBloomDown.compile(kFullscreenVS, kBloomDownFS);
     mShaders[(int)FX::ChromaticAberration].compile(kFullscreenVS, kChromaFS);
     mShaders[(int)FX::Glitch].compile(kFullscreenVS, kGlitchFS);
     mShaders[(int)FX::Vignette].compile(kFullscreenVS, kVignetteFS);
@@ -224,58 +336,95 @@ class PostFXChain {
     if (w == mWidth && h == mHeight) return;
     mWidth = w;
     mHeight = h;
-    al::EasyFBOSetting s;
-    s.internal = 0x8814;
-    s.format = 0x1908;
-    s.type = 0x1406;
-    s.filterMin = 0x2601;
-    s.filterMag = 0x2601;
-    // EasyFBO has no resize() — re-init in place; the destructor of the old
-    // attachments is invoked on new init() because GPUObject manages handles.
-    mInputFBO.init(w, h, s);
-    mPing.init(w, h, s);
-    mPong.init(w, h, s);
+    // Pooled targets of the old size go idle and are evicted by the pool.
+    // EasyFBO has no resize() — re-init the history in place; the old
+    // attachments are released because GPUObject manages handles.
+    al::EasyFBOSetting s = fboSetting();
+    for (auto& history : mHistory) history->init(w, h, s);
   }
 
   void push(FX fx, float strength = 1.f) {
     mPasses.push_back(PassEntry{fx, strength, {}});
+    mPlanDirty = true;
+  }
+
+  void clear() {
+    mPasses.clear();
+    mPlanDirty = true;
+  }
+
+  // Fuse runs of ChromaticAberration / Glitch / Vignette into one pass
+  // (default on). Off runs one pass per effect, for A/B comparisons.
+  void setFusion(bool enabled) {
+    if (enabled == mFusion) return;
+    mFusion = enabled;
+    mPlanDirty = true;
   }
+  bool fusion() const { return mFusion; }
 
-  void clear() { mPasses.clear(); }
+  // Full-screen passes the chain currently costs per frame.
+  int passCount() {
+    updatePlan();
+    return static_cast<int>(mPlan.size());
+  }
 
   // Bind the input FBO so the user's scene draws into it.
   // Caller is responsible for clearing.
   void beginCapture() {
-    mInputFBO.begin();
+    mInput = al::RenderTargetPool::instance().acquire(mWidth, mHeight, fboSetting());
+    mInput->begin();
   }
 
   // Run the FX chain to the default framebuffer.
   void endCaptureAndRender(al::Graphics& g) {
-    mInputFBO.end();
+    auto& pool = al::RenderTargetPool::instance();
+    mInput->end();
     if (mPasses.empty()) {
       // Pass-through: blit to default framebuffer via a textured quad.
-      g.quadViewport(mInputFBO.tex(), -1.f, -1.f, 2.f, 2.f);
+      g.quadViewport(mInput->tex(), -1.f, -1.f, 2.f, 2.f);
+      pool.release(mInput);
+      mInput = nullptr;
       return;
     }
+    updatePlan();
+
+    // Ping-pong: each pass renders into a pooled target and then hands back
+    // the one it read, so the chain alternates between two of them; the last
+    // pass renders straight to the default framebuffer.
+    al::EasyFBO* srcFbo = mInput;  // Pooled target behind `src`, if any
+    al::Texture* src = &mInput->tex();
+    mInput = nullptr;
+
+    for (size_t i = 0; i < mPlan.size(); ++i) {
+      const Stage& stage = mPlan[i];
+      const bool isLast = (i + 1 == mPlan.size());
+
+      if (stage.history >= 0) {
+        // Phosphor decays last frame's output of this same pass, so it
+        // renders into its own history pair instead of the ping-pong FBOs.
+        al::EasyFBO& out = *mHistory[2 * stage.history + mHistoryFrame];
+        al::EasyFBO& prev = *mHistory[2 * stage.history + (mHistoryFrame ^ 1)];
+        runPass(mPasses[stage.first], *src, &out, &prev.tex());
+        if (srcFbo) pool.release(srcFbo);
+        srcFbo = nullptr;
+        src = &out.tex();
+        if (isLast) g.quadViewport(*src, -1.f, -1.f, 2.f, 2.f);
+        continue;
+      }
 
-    // Ping-pong: source starts as input; for the final pass we render to the
-    // default framebuffer via Graphics::quadViewport using the last result.
-    al::Texture* src = &mInputFBO.tex();
-    al::EasyFBO* dst = &mPing;
-
-    for (size_t i = 0; i < mPasses.size(); ++i) {
-      const PassEntry& p = mPasses[i];
-      const bool isLast = (i + 1 == mPasses.size());
-
-      if (isLast) {
-        // Render last pass directly to the screen.
-        runPass(p, *src, nullptr);
+      al::EasyFBO* target = isLast ? nullptr : pool.acquire(mWidth, mHeight, fboSetting());
+      if (stage.fused) {
+        runFused(stage, *src, target);
+      } else if (mPasses[stage.first].fx == FX::Bloom) {
+        runBloom(mPasses[stage.first], *src, target);
       } else {
-        runPass(p, *src, dst);
-        src = &dst->tex();
-        dst = (dst == &mPing) ? &mPong : &mPing;
+        runPass(mPasses[stage.first], *src, target, nullptr);
       }
+      if (srcFbo) pool.release(srcFbo);
+      srcFbo = target;
+      if (target) src = &target->tex();
     }
+    mHistoryFrame ^= 1;
   }
 
   // Override a uniform on the most recently pushed effect of type `fx`.
@@ -298,6 +447,24 @@ class PostFXChain {
   bool initialized() const { return mInitialized; }
 
  private:
+  // One full-screen pass: a single effect, or a fused run of them.
+  struct Stage {
+    size_t first = 0;                      // Index into mPasses
+    size_t count = 1;                      // Effects covered (> 1 when fused)
+    al::ShaderProgram* fused = nullptr;    // Generated shader for the run
+    int history = -1;                      // Phosphor: its mHistory pair
+  };
+
+  static al::EasyFBOSetting fboSetting() {
+    al::EasyFBOSetting s;
+    s.internal = 0x8814;  // GL_RGBA16F — extended dynamic range for bloom.
+    s.format = 0x1908;    // GL_RGBA
+    s.type = 0x1406;      // GL_FLOAT
+    s.filterMin = 0x2601; // GL_LINEAR
+    s.filterMag = 0x2601; // GL_LINEAR
+    return s;
+  }
+
   void buildQuad() {
     // Fullscreen triangle covering NDC; UV mapped 0..1.
     mQuad.reset();
@@ -311,9 +478,62 @@ class PostFXChain {
     mQuad.update();
   }
 
+  // Group the chain into passes; rerun whenever the effect list changes.
+  void updatePlan() {
+    if (!mPlanDirty || !mInitialized) return;
+    mPlanDirty = false;
+    mPlan.clear();
+
+    using namespace post_fx_detail;
+    int phosphors = 0;
+    for (size_t i = 0; i < mPasses.size();) {
+      Stage stage;
+      stage.first = i;
+      FX fx = mPasses[i].fx;
+      if (fx == FX::Phosphor) stage.history = phosphors++;
+
+      size_t end = i + 1;
+      if (mFusion && stageSource(fx)) {
+        int fetches = stageFetches(fx);
+        while (end < mPasses.size() && stageSource(mPasses[end].fx) &&
+               fetches * stageFetches(mPasses[end].fx) <= kMaxFusedFetches) {
+          fetches *= stageFetches(mPasses[end].fx);
+          ++end;
+        }
+      }
+      stage.count = end - i;
+      if (stage.count > 1) stage.fused = &fusedShader(i, stage.count);
+      mPlan.push_back(stage);
+      i = end;
+    }
+
+    while (mHistory.size() < size_t(2 * phosphors)) {
+      mHistory.push_back(std::make_unique<al::EasyFBO>());
+      mHistory.back()->init(mWidth, mHeight, fboSetting());
+    }
+  }
+
+  // Generated shader for mPasses[first, first + count), compiled once per
+  // distinct sequence of effects.
+  al::ShaderProgram& fusedShader(size_t first, size_t count) {
+    std::vector<FX> stages;
+    std::string key;
+    for (size_t k = 0; k < count; ++k) {
+      stages.push_back(mPasses[first + k].fx);
+      key += static_cast<char>('0' + static_cast<int>(stages.back()));
+    }
+    auto& shader = mFused[key];
+    if (!shader) {
+      shader = std::make_unique<al::ShaderProgram>();
+      shader->compile(post_fx_detail::kFullscreenVS, post_fx_detail::fusedSource(stages));
+    }
+    return *shader;
+  }
+
   // Run one pass. If `dst` is null, render to the currently bound framebuffer
-  // (typically the default FB at the end of the chain).
-  void runPass(const PassEntry& p, al::Texture& src, al::EasyFBO* dst) {
+  // (typically the default FB at the end of the chain). `prev` is Phosphor's
+  // previous-frame output.
+  void runPass(const PassEntry& p, al::Texture& src, al::EasyFBO* dst, al::Texture* prev) {
     al::ShaderProgram& sp = mShaders[(int)p.fx];
     if (dst) dst->begin();
 
@@ -326,14 +546,7 @@ class PostFXChain {
       case FX::Phosphor:
         sp.uniform("uPrev", 1);
         sp.uniform("uDecay", 0.92f);
-        // Phosphor reads previous-frame from the alternate ping-pong FBO.
-        mPong.tex().bind(1);
-        break;
-      case FX::Bloom:
-        sp.uniform("uTexel",
-                   1.f / static_cast<float>(mWidth),
-                   1.f / static_cast<float>(mHeight));
-        sp.uniform("uThreshold", 0.7f);
+        if (prev) prev->bind(1);
         break;
       case FX::Glitch:
         sp.uniform("uTime", mGlitchTime);
@@ -354,22 +567,152 @@ class PostFXChain {
     mQuad.draw();
     src.unbind(0);
 
-    if (p.fx == FX::Phosphor) mPong.tex().unbind(1);
+    if (prev && p.fx == FX::Phosphor) prev->unbind(1);
 
     sp.end();
     if (dst) dst->end();
   }
 
+  // Run a fused stage; each effect's uniforms carry its index in the run
+  // as a suffix (uStrength0, uTime1, ...), overrides included.
+  void runFused(const Stage& stage, al::Texture& src, al::EasyFBO* dst) {
+    al::ShaderProgram& sp = *stage.fused;
+    if (dst) dst->begin();
+
+    sp.begin();
+    sp.uniform("uCurrent", 0);
+    for (size_t k = 0; k < stage.count; ++k) {
+      const PassEntry& p = mPasses[stage.first + k];
+      const std::string suffix = std::to_string(k);
+      sp.uniform(("uStrength" + suffix).c_str(), p.strength);
+      if (p.fx == FX::Glitch) {
+        sp.uniform(("uTime" + suffix).c_str(), mGlitchTime);
+        mGlitchTime += 1.f / 60.f;
+      }
+      for (const auto& kv : p.overrides) {
+        sp.uniform((kv.first + suffix).c_str(), kv.second);
+      }
+    }
+
+    src.bind(0);
+    mQuad.draw();
+    src.unbind(0);
+
+    sp.end();
+    if (dst) dst->end();
+  }
+
+  // Bloom: threshold + downsample into a mip chain of pooled targets,
+  // upsample back up adding each level, then composite onto `src` into `dst`.
+  void runBloom(const PassEntry& p, al::Texture& src, al::EasyFBO* dst) {
+    using namespace post_fx_detail;
+    auto& pool = al::RenderTargetPool::instance();
+    const al::EasyFBOSetting setting = fboSetting();
+
+    // Level sizes: 1/2, 1/4, ... until a side would drop below kBloomMinSize
+    int levelW[kBloomMaxLevels], levelH[kBloomMaxLevels];
+    int levels = 0;
+    for (int w = mWidth, h = mHeight; levels < kBloomMaxLevels; ++levels) {
+      w = std::max(1, w / 2);
+      h = std::max(1, h / 2);
+      if (levels > 0 && (w < kBloomMinSize || h < kBloomMinSize)) break;
+      levelW[levels] = w;
+      levelH[levels] = h;
+    }
+    al::EasyFBO* down[kBloomMaxLevels] = {};
+    al::EasyFBO* up[kBloomMaxLevels] = {};
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    auto texel = [](al::Texture& t) {
+      return al::Vec2f(1.f / static_cast<float>(t.width()), 1.f / static_cast<float>(t.height()));
+    };
+    auto applyOverrides = [&p](al::ShaderProgram& sp) {
+      for (const auto& kv : p.overrides) sp.uniform(kv.first.c_str(), kv.second);
+    };
+
+    // Downsample: full resolution -> 1/2 -> 1/4 ...
+    mBloomDown.begin();
+    mBloomDown.uniform("uCurrent", 0);
+    mBloomDown.uniform("uThreshold", 0.7f);
+    applyOverrides(mBloomDown);
+    al::Texture* from = &src;
+    for (int i = 0; i < levels; ++i) {
+      al::EasyFBO& to = *(down[i] = pool.acquire(levelW[i], levelH[i], setting));
+      al::Vec2f t = texel(*from);
+      mBloomDown.uniform("uTexel", t.x, t.y);
+      mBloomDown.uniform("uPrefilter", i == 0 ? 1 : 0);
+      to.begin();
+      glViewport(0, 0, levelW[i], levelH[i]);
+      from->bind(0);
+      mQuad.draw();
+      from->unbind(0);
+      to.end();
+      from = &to.tex();
+    }
+    mBloomDown.end();
+
+    // Upsample: each level = its downsample + tent(level below)
+    al::ShaderProgram& sp = mShaders[(int)FX::Bloom];
+    sp.begin();
+    sp.uniform("uCurrent", 0);
+    sp.uniform("uBase", 1);
+    for (int i = levels - 2; i >= 0; --i) {
+      al::EasyFBO& to = *(up[i] = pool.acquire(levelW[i], levelH[i], setting));
+      al::Vec2f t = texel(*from);
+      sp.uniform("uTexel", t.x, t.y);
+      sp.uniform("uStrength", 1.f);
+      to.begin();
+      glViewport(0, 0, levelW[i], levelH[i]);
+      from->bind(0);
+      down[i]->tex().bind(1);
+      mQuad.draw();
+      down[i]->tex().unbind(1);
+      from->unbind(0);
+      to.end();
+      from = &to.tex();
+    }
+
+    // Composite onto the full-resolution scene
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (dst) dst->begin();
+    al::Vec2f t = texel(*from);
+    sp.uniform("uTexel", t.x, t.y);
+    sp.uniform("uStrength", p.strength);
+    applyOverrides(sp);
+    from->bind(0);
+    src.bind(1);
+    mQuad.draw();
+    src.unbind(1);
+    from->unbind(0);
+    sp.end();
+    if (dst) dst->end();
+
+    for (int i = 0; i < levels; ++i) {
+      pool.release(down[i]);
+      if (up[i]) pool.release(up[i]);
+    }
+  }
+
   bool mInitialized = false;
   int mWidth = 0;
   int mHeight = 0;
-  al::EasyFBO mInputFBO;
-  al::EasyFBO mPing;
-  al::EasyFBO mPong;
+  al::EasyFBO* mInput = nullptr;   // Pooled, between beginCapture() and render
   al::ShaderProgram mShaders[5];   // one per FX
   std::vector<PassEntry> mPasses;
   al::VAOMesh mQuad;
   float mGlitchTime = 0.f;
+
+  // Fusion plan, rebuilt after push()/clear()/setFusion()
+  bool mFusion = true;
+  bool mPlanDirty = true;
+  std::vector<Stage> mPlan;
+  std::unordered_map<std::string, std::unique_ptr<al::ShaderProgram>> mFused;
+  al::ShaderProgram mBloomDown;    // Bloom threshold + downsample
+  // Two FBOs per Phosphor pass: this frame's output and last frame's
+  std::vector<std::unique_ptr<al::EasyFBO>> mHistory;
+  int mHistoryFrame = 0;
 };
 
 }  // namespace studio
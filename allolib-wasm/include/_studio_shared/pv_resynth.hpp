@@ -10,6 +10,12 @@
  * so freezeFrame() doesn't smear (analysis writes are gated; user-edited
  * phases still accumulate the expected per-hop drift).
  *
+ * Bins are stored structure-of-arrays: magnitudes(), phases() and
+ * frequencies() are contiguous float arrays of numBins(). Analysis,
+ * per-hop phase advance and the bulk edits below run four bins at a time
+ * with wasm SIMD128 (al_WebAudioSIMD.hpp kernels), so 4096/8192-point
+ * frames stay within the audio budget.
+ *
  * Header-only. No <thread> / pthread.
  *
  * Usage (audio thread):
@@ -17,28 +23,27 @@
  *   PVResynth pv(2048, 512, audioIO().framesPerSecond());
  *   // per-block:
  *   pv.analyze(in, numFrames);
- *   for (int k = 0; k < pv.numBins(); ++k) {
- *     pv.setBinMag(k, pv.currentFrame()[k].magnitude * gain[k]);
- *   }
+ *   pv.applyGain(gain);           // gain[numBins()], e.g. painted column
  *   pv.resynthesize(out, numFrames);
  */
 
 #include "Gamma/DFT.h"
 #include "Gamma/Types.h"  // Complex<float>
 
+#include "al_WebAudioSIMD.hpp"
+
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <vector>
 
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
 // v0.10.3: dropped surrounding `namespace al` to match the other helpers (file-scope ::studio)
 namespace studio {
 
-struct PVBin {
-  float magnitude;
-  float phase;
-};
-
 class PVResynth {
 public:
   PVResynth(int fftSize = 2048, int hop = 512, float sampleRate = 48000.f)
@@ -51,43 +56,51 @@ public:
               gam::HANN,
               gam::MAG_PHASE,
               0u),
-        mBins(static_cast<size_t>((mFFTSize / 2) + 1)),
-        mPhaseAccum(mBins.size(), 0.0),
-        mTwoPiHopOverFFT(static_cast<float>(
-            2.0 * 3.14159265358979323846 * mHop / mFFTSize)) {}
+        mNumBins((mFFTSize / 2) + 1),
+        mMag(static_cast<size_t>(mNumBins), 0.f),
+        mPhase(static_cast<size_t>(mNumBins), 0.f),
+        mFreq(static_cast<size_t>(mNumBins), 0.f),
+        mPhaseAccum(static_cast<size_t>(mNumBins), 0.0),
+        mOutPhase(static_cast<size_t>(mNumBins), 0.f),
+        mTwoPiHopOverSR(2.0 * 3.14159265358979323846 * mHop / mSampleRate) {
+    resetFrequencies();
+  }
 
   // ---- forward STFT --------------------------------------------------
   // Push numFrames input samples; whenever a frame completes, the
-  // internal mBins are refreshed (unless freezeFrame is true, in which
-  // case magnitudes are left alone but advance bookkeeping still runs).
+  // magnitude and phase arrays are refreshed (unless freezeFrame is true,
+  // in which case they are left alone but advance bookkeeping still runs).
   void analyze(const float* in, int numFrames) {
     if (!in || numFrames <= 0) return;
     for (int i = 0; i < numFrames; ++i) {
-      if (mSTFT(in[i])) {
-        // A new frame is ready in MAG_PHASE format.
-        const unsigned nb = mSTFT.numBins();
-        const gam::Complex<float>* src = mSTFT.bins();
-        if (!mFrozen) {
-          for (unsigned k = 0; k < nb && k < mBins.size(); ++k) {
-            mBins[k].magnitude = src[k][0];  // mag
-            mBins[k].phase     = src[k][1];  // phase
-          }
-        }
-        // else: keep last user-visible mBins; user edits still apply.
+      if (mSTFT(in[i]) && !mFrozen) {
+        // A new frame is ready in MAG_PHASE format: [mag, phase] pairs.
+        const int nb = std::min(static_cast<int>(mSTFT.numBins()), mNumBins);
+        float* dst[2] = {mMag.data(), mPhase.data()};
+        al::audio_simd::deinterleave(
+            dst, reinterpret_cast<const float*>(mSTFT.bins()), 2, nb);
       }
+      // else: keep the last user-visible bins; user edits still apply.
     }
   }
 
-  // Editable bin buffer (graphics-thread side may mutate between
-  // analyze/resynthesize calls).
-  std::vector<PVBin>& currentFrame() { return mBins; }
-  const std::vector<PVBin>& currentFrame() const { return mBins; }
+  // ---- bin arrays ----------------------------------------------------
+  // Editable between analyze/resynthesize calls; numBins() entries each.
+  float* magnitudes() { return mMag.data(); }
+  const float* magnitudes() const { return mMag.data(); }
+  // Phase offset (radians) added on top of the running phase advance.
+  float* phases() { return mPhase.data(); }
+  const float* phases() const { return mPhase.data(); }
+  // Per-bin advance frequency in Hz; resetFrequencies() restores the bin
+  // centres k * sampleRate / fftSize.
+  float* frequencies() { return mFreq.data(); }
+  const float* frequencies() const { return mFreq.data(); }
 
   // ---- inverse STFT --------------------------------------------------
-  // Pull numFrames output samples. Before pulling, the current mBins are
+  // Pull numFrames output samples. Before pulling, the current bins are
   // committed back into the STFT, with per-bin phase advanced by
-  // 2*pi*k*hop/N (so freezing a frame does not produce a static, phasey
-  // resynth -- partials still progress in time).
+  // 2*pi*freq*hop/sampleRate (so freezing a frame does not produce a
+  // static, phasey resynth -- partials still progress in time).
   void resynthesize(float* out, int numFrames) {
     if (!out || numFrames <= 0) return;
     for (int i = 0; i < numFrames; ++i) {
@@ -99,13 +112,59 @@ public:
 
   // ---- per-bin edits -------------------------------------------------
   void setBinMag(int bin, float m) {
-    if (bin < 0 || static_cast<size_t>(bin) >= mBins.size()) return;
-    mBins[bin].magnitude = m;
+    if (bin < 0 || bin >= mNumBins) return;
+    mMag[bin] = m;
   }
 
   void setBinPhase(int bin, float p) {
-    if (bin < 0 || static_cast<size_t>(bin) >= mBins.size()) return;
-    mBins[bin].phase = p;
+    if (bin < 0 || bin >= mNumBins) return;
+    mPhase[bin] = p;
+  }
+
+  void setBinFreq(int bin, float hz) {
+    if (bin < 0 || bin >= mNumBins) return;
+    mFreq[bin] = hz;
+  }
+
+  float binMag(int bin) const {
+    return bin >= 0 && bin < mNumBins ? mMag[bin] : 0.f;
+  }
+  float binPhase(int bin) const {
+    return bin >= 0 && bin < mNumBins ? mPhase[bin] : 0.f;
+  }
+
+  // ---- bulk edits ----------------------------------------------------
+  // Ranges are clamped to [0, numBins()); count < 0 means "to the end".
+  void setMagnitudes(const float* src, int first = 0, int count = -1) {
+    if (!src || !clampRange(first, count)) return;
+    std::copy(src, src + count, mMag.begin() + first);
+  }
+
+  void setPhases(const float* src, int first = 0, int count = -1) {
+    if (!src || !clampRange(first, count)) return;
+    std::copy(src, src + count, mPhase.begin() + first);
+  }
+
+  void setFrequencies(const float* hz, int first = 0, int count = -1) {
+    if (!hz || !clampRange(first, count)) return;
+    std::copy(hz, hz + count, mFreq.begin() + first);
+  }
+
+  // magnitude[first + i] *= gains[i]
+  void applyGain(const float* gains, int first = 0, int count = -1) {
+    if (!gains || !clampRange(first, count)) return;
+    al::audio_simd::mul(mMag.data() + first, gains, count);
+  }
+
+  // magnitude[k] *= g over the range
+  void scaleMagnitudes(float g, int first = 0, int count = -1) {
+    if (!clampRange(first, count)) return;
+    al::audio_simd::gain(mMag.data() + first, g, count);
+  }
+
+  void resetFrequencies() {
+    const float binHz = mSampleRate / static_cast<float>(mFFTSize);
+    for (int k = 0; k < mNumBins; ++k) mFreq[k] = static_cast<float>(k) * binHz;
   }
 
   // ---- freeze --------------------------------------------------------
@@ -115,29 +174,55 @@ public:
   bool frozen() const { return mFrozen; }
 
   // ---- shape ---------------------------------------------------------
-  int numBins() const { return static_cast<int>(mBins.size()); }
+  int numBins() const { return mNumBins; }
   int fftSize() const { return mFFTSize; }
   int hopSize() const { return mHop; }
   float sampleRate() const { return mSampleRate; }
 
 private:
-  // Commit the user-visible mBins back into the STFT, advancing the
-  // accumulator phase by 2*pi*k*hop/N for each bin. The bin's stored
-  // phase is treated as an offset on top of the running accumulator.
+  bool clampRange(int& first, int& count) const {
+    if (first < 0) first = 0;
+    if (count < 0 || first + count > mNumBins) count = mNumBins - first;
+    return count > 0;
+  }
+
+  // Commit the user-visible bins back into the STFT, advancing the
+  // accumulator phase by 2*pi*freq*hop/sampleRate for each bin. The bin's
+  // stored phase is treated as an offset on top of the running accumulator.
   void commitFrameToSTFT() {
-    const unsigned nb = mSTFT.numBins();
-    gam::Complex<float>* dst = mSTFT.bins();
+    const int nb = std::min(static_cast<int>(mSTFT.numBins()), mNumBins);
+    constexpr double kPi = 3.14159265358979323846;
     constexpr double kTwoPi = 6.28318530717958647692;
-    for (unsigned k = 0; k < nb && k < mBins.size(); ++k) {
-      mPhaseAccum[k] += static_cast<double>(k) * mTwoPiHopOverFFT;
+    constexpr double kInvTwoPi = 0.15915494309189533577;
+    // The accumulator stays double (two bins per f64x2): a float increment
+    // of up to ~pi * hop per hop would drift audibly over a long freeze.
+    double* acc = mPhaseAccum.data();
+    int k = 0;
+#if defined(__wasm_simd128__)
+    const v128_t step = wasm_f64x2_splat(mTwoPiHopOverSR);
+    const v128_t twoPi = wasm_f64x2_splat(kTwoPi);
+    const v128_t invTwoPi = wasm_f64x2_splat(kInvTwoPi);
+    for (; k + 2 <= nb; k += 2) {
+      const v128_t f = wasm_f64x2_promote_low_f32x4(wasm_v128_load64_zero(&mFreq[k]));
+      v128_t a = wasm_f64x2_add(wasm_v128_load(acc + k), wasm_f64x2_mul(f, step));
+      // wrap into [-pi, pi]
+      a = wasm_f64x2_sub(a, wasm_f64x2_mul(twoPi,
+                                           wasm_f64x2_nearest(wasm_f64x2_mul(a, invTwoPi))));
+      wasm_v128_store(acc + k, a);
+      const v128_t p = wasm_f32x4_add(wasm_v128_load64_zero(&mPhase[k]),
+                                      wasm_f32x4_demote_f64x2_zero(a));
+      wasm_v128_store64_lane(&mOutPhase[k], p, 0);
+    }
+#endif
+    for (; k < nb; ++k) {
+      double a = acc[k] + static_cast<double>(mFreq[k]) * mTwoPiHopOverSR;
       // wrap into [-pi, pi]
-      while (mPhaseAccum[k] >  3.14159265358979323846) mPhaseAccum[k] -= kTwoPi;
-      while (mPhaseAccum[k] < -3.14159265358979323846) mPhaseAccum[k] += kTwoPi;
-      const float effectivePhase =
-          mBins[k].phase + static_cast<float>(mPhaseAccum[k]);
-      dst[k][0] = mBins[k].magnitude;
-      dst[k][1] = effectivePhase;
+      if (a > kPi || a < -kPi) a -= kTwoPi * std::nearbyint(a * kInvTwoPi);
+      acc[k] = a;
+      mOutPhase[k] = mPhase[k] + static_cast<float>(a);
     }
+    const float* src[2] = {mMag.data(), mOutPhase.data()};
+    al::audio_simd::interleave(reinterpret_cast<float*>(mSTFT.bins()), src, 2, nb);
   }
 
   int mFFTSize;
@@ -145,9 +230,13 @@ private:
   float mSampleRate;
 
   gam::STFT mSTFT;
-  std::vector<PVBin> mBins;
-  std::vector<double> mPhaseAccum;  // running per-bin phase advance
-  float mTwoPiHopOverFFT;
+  int mNumBins;
+  std::vector<float> mMag;
+  std::vector<float> mPhase;
+  std::vector<float> mFreq;
+  std::vector<double> mPhaseAccum; // running per-bin phase advance, [-pi, pi]
+  std::vector<float> mOutPhase;    // phase + accumulator, committed per hop
+  double mTwoPiHopOverSR;
   bool mFrozen{false};
 };
 
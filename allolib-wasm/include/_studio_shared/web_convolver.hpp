@@ -7,41 +7,49 @@
  * `al_ext/spatialaudio/al_Convolver.hpp` (zita-convolver), which is not
  * linked into libal_web.a.
  *
- * Algorithm: uniformly-partitioned overlap-save with frequency-domain
- * accumulation (the JUCE `dsp::Convolution` / Wikipedia "Overlap-save method"
- * shape). The IR is split into K = ceil(irLen / blockSize) partitions, each
- * of length P = blockSize, zero-padded to N = 2*P, FFT'd, and stored as a
- * flat array of K*N real-valued slots holding interleaved RFFT spectra.
- * Each audio block:
- *   1. Append the new P-sample input chunk to a length-N rolling input
- *      window (last block + this block); FFT into a fresh spectrum slot in a
- *      ring buffer of K spectra (indexed by mFifoHead).
- *   2. For each partition k = 0..K-1: complex-multiply the partition's
- *      spectrum by the input spectrum at ring position
- *      (mFifoHead - k + K) % K, and accumulate (add) into a length-N
- *      frequency-domain accumulator.
- *   3. IFFT the accumulator; output the second half (samples [P..2P-1]) as
- *      the next block of audio (overlap-save discards the first half).
+ * Algorithm: non-uniformly partitioned overlap-save with frequency-domain
+ * accumulation (Gardner 1995 / Garcia 2002 layout). The IR is cut into
+ * stages of growing partition size:
+ *
+ *   stage 0: P0 = partitionSize() (default = blockSize), IR offset 0
+ *   stage s: P_s = 2 * P_{s-1}, until maxPartitionSize() (default 8192);
+ *            the last stage takes the rest of the IR at that size
+ *
+ * Each stage is a uniformly-partitioned convolver over its slice of the IR:
+ * K_s partitions of length P_s, zero-padded to N_s = 2*P_s, FFT'd once at
+ * load into Gamma RFFT spectra. Its input is the same signal, gathered in
+ * P_s-sample chunks; per chunk it FFTs the [previous | current] window into
+ * a ring of K_s input spectra, complex-multiply-accumulates every partition
+ * against the matching ring entry, inverse-FFTs, keeps the second half, and
+ * adds that into a time-domain output ring at its IR offset.
+ *
+ * Stage 0 does all of this in the step that completes its chunk, so the
+ * convolver's latency is P0 samples, the same as the uniform scheme. A
+ * larger stage has P_s / P0 steps before its output is due, and spreads
+ * its multiply-accumulates evenly over those steps instead of doing them
+ * all at once. That is why each stage has to start far enough into the IR:
+ * stage s needs offset >= 2*P_s - 2*P0. The layout gives every stage but
+ * the last just enough partitions (normally 2) to push the next one there.
+ *
+ * Cost: a 6 s IR at 48 kHz with P0 = 128 is 2250 uniform partitions, i.e.
+ * 2250 spectral MACs per 128-sample block. Non-uniformly it is 2 partitions
+ * each of 128..4096 plus 34 of 8192, whose MACs are spread over 64 blocks,
+ * roughly 40x less work per block. FFTs are not split, so the largest
+ * stages' transforms still land together once per maxPartitionSize()
+ * samples. setMaxPartitionSize(partitionSize()) restores the uniform
+ * scheme.
  *
  * Complex spectra are stored in Gamma's RFFT<float> "complexBuf=true" layout:
  * N/2 + 1 complex bins packed as 2*(N/2+1) = N+2 real samples
  * [re0, im0, re1, im1, ..., re_{N/2}, im_{N/2}], where bin 0 (DC) and
  * bin N/2 (Nyquist) have zero imaginary parts.
  *
- * Performance: O(N log N) per block, dominated by 2 forward + 1 inverse
- * RFFT plus K complex-multiply-accumulates. For a typical 1-second IR at
- * 48 kHz with blockSize=128, K = ceil(48000/128) = 375 partitions; that's
- * ~750 forward FFTs of length 256 per second of audio (one input FFT per
- * block, and K complex MACs reused across all blocks via the spectrum
- * ring), well under realtime budget for the AudioWorklet quantum.
+ * WebMultiConvolver runs the same stages over an IR matrix (true stereo,
+ * 1 -> N, N x M), FFTing each input once per chunk for all of its paths;
+ * WebConvolver is its 1 x 1 case. The spectral multiply-accumulate uses
+ * wasm SIMD128 (two bins per vector) when built with -msimd128.
  *
- * Non-uniform partitioning (an early small block + a tail of larger
- * partitions, JUCE-style) is intentionally NOT implemented: at worklet
- * blockSize=128 the uniform scheme already meets the quantum budget, and
- * non-uniform bookkeeping doubles the surface area without a measured
- * win for IR lengths typical in the MAT200B examples (rooms < 4 s).
- *
- * Thread model: WebConvolver instances are owned and processed by the
+ * Thread model: WebConvolver / WebMultiConvolver instances are owned and processed by the
  * AudioWorklet thread. loadIR / setBlockSize / setPartitionSize must be
  * called from the same thread (e.g. inside onCreate() before audio starts,
  * or guarded by a swap pointer if the user wants live IR replacement).
@@ -58,6 +66,10 @@
 #include <memory>
 #include <vector>
 
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
 // v0.10.2: dropped the surrounding `namespace al { ... }` so this helper
 // lives in `::studio` (matching the eight other _studio_shared/ headers).
 // Pre-fix, web_convolver was nested as `::al::studio` which collided with
@@ -68,275 +80,468 @@
 // `al::studio`"). Phase 1 acceptance demo failed to build because of it.
 namespace studio {
 
-class WebConvolver {
+/**
+ * Matrix convolver: numInputs x numOutputs IR paths sharing one input FFT
+ * per input per chunk. Output o is the sum over inputs i of in[i] * ir(o, i),
+ * which covers true stereo (2x2), mono-to-N (e.g. ambisonic or binaural
+ * IRs) and arbitrary N x M matrices. Each input spectrum is computed once
+ * and multiplied against every IR that reads it; each output is inverse
+ * FFT'd once after its paths are summed in the frequency domain. Spatial
+ * reverbs therefore cost ins + outs transforms per chunk instead of
+ * 2 * ins * outs with one WebConvolver per path.
+ */
+class WebMultiConvolver {
 public:
-  WebConvolver()
+  WebMultiConvolver()
     : mBlockSize(128),
       mPartitionSize(128),
-      mPaddedSize(256),
-      mNumPartitions(0),
-      mFifoHead(0),
+      mMaxPartitionSize(8192),
+      mNumInputs(0),
+      mNumOutputs(0),
       mIrLength(0),
       mReady(false) {}
 
-  /// Load IR from raw float array. numSamples may be any length; partitions
-  /// will tile it and the tail is zero-padded into the final partition.
-  bool loadIR(const float* ir, std::size_t numSamples) {
-    if (!ir || numSamples == 0) {
+  /// Load an IR matrix. irs[out * numInputs + in] is the path from input
+  /// `in` to output `out`; an empty entry means no path. IRs may differ in
+  /// length (the longest sets the layout).
+  bool loadIRs(std::size_t numInputs, std::size_t numOutputs,
+               const std::vector<std::vector<float>>& irs) {
+    std::size_t longest = 0;
+    for (const auto& ir : irs) longest = std::max(longest, ir.size());
+    if (numInputs == 0 || numOutputs == 0 ||
+        irs.size() != numInputs * numOutputs || longest == 0) {
       clear();
       return false;
     }
-    mIrLength = numSamples;
-    rebuildFromCurrentSizes(ir, numSamples);
+    mNumInputs = numInputs;
+    mNumOutputs = numOutputs;
+    mIrCopy = irs;
+    mIrLength = longest;
+    rebuild();
     return mReady;
   }
 
-  bool loadIR(const std::vector<float>& ir) {
-    return loadIR(ir.data(), ir.size());
+  /// Stereo in, stereo out: left' = L*ll + R*rl, right' = L*lr + R*rr
+  bool loadTrueStereo(const std::vector<float>& ll, const std::vector<float>& rl,
+                      const std::vector<float>& lr, const std::vector<float>& rr) {
+    return loadIRs(2, 2, {ll, rl, lr, rr});
   }
 
-  /// Set audio block size (frames per process() call). Triggers rebuild if
-  /// an IR is already loaded.
+  /// See WebConvolver::setBlockSize
   void setBlockSize(std::size_t blockSize) {
     if (blockSize == 0) blockSize = 128;
     if (blockSize == mBlockSize) return;
     mBlockSize = blockSize;
     // Partition size tracks block size by default; user can override after.
     mPartitionSize = blockSize;
-    if (!mIrCopy.empty()) rebuildFromCurrentSizes(mIrCopy.data(), mIrCopy.size());
+    if (!mIrCopy.empty()) rebuild();
   }
 
-  /// Override partition size (must be a power of two >= blockSize).
-  /// Default is blockSize. Larger partitions reduce per-block FFT count
-  /// (fewer ring slots) at the cost of higher per-partition FFT length.
+  /// See WebConvolver::setPartitionSize
   void setPartitionSize(std::size_t parts) {
     if (parts == 0) parts = mBlockSize;
-    // Round up to next power of two.
-    std::size_t pow2 = 1;
-    while (pow2 < parts) pow2 <<= 1;
+    std::size_t pow2 = nextPow2(parts);
     if (pow2 == mPartitionSize) return;
     mPartitionSize = pow2;
-    if (!mIrCopy.empty()) rebuildFromCurrentSizes(mIrCopy.data(), mIrCopy.size());
+    if (!mIrCopy.empty()) rebuild();
   }
 
-  /// Convolve `numFrames` samples from `in` into `out`. The caller may
-  /// invoke this with numFrames smaller than mBlockSize; the internal
-  /// scheduler buffers the input until a full partition is ready, and
-  /// emits previously-computed output samples in the meantime.
-  void process(const float* in, float* out, std::size_t numFrames) {
-    if (!mReady || mNumPartitions == 0) {
-      // Pass-through when no IR has been loaded yet.
-      if (out && in && out != in) {
-        std::memcpy(out, in, numFrames * sizeof(float));
+  /// See WebConvolver::setMaxPartitionSize
+  void setMaxPartitionSize(std::size_t size) {
+    std::size_t pow2 = nextPow2(size == 0 ? 1 : size);
+    if (pow2 == mMaxPartitionSize) return;
+    mMaxPartitionSize = pow2;
+    if (!mIrCopy.empty()) rebuild();
+  }
+
+  /// Convolve planar blocks: in[numInputs()][numFrames] into
+  /// out[numOutputs()][numFrames]. Buffers may alias (every input sample
+  /// of a frame is read before that frame's outputs are written).
+  void process(const float* const* in, float* const* out, std::size_t numFrames) {
+    if (!mReady || mStages.empty()) {
+      // Pass-through on matching channels, silence on the rest.
+      for (std::size_t o = 0; o < mNumOutputs; ++o) {
+        if (!out || !out[o]) continue;
+        if (in && o < mNumInputs && in[o]) {
+          if (out[o] != in[o]) std::memcpy(out[o], in[o], numFrames * sizeof(float));
+        } else {
+          std::memset(out[o], 0, numFrames * sizeof(float));
+        }
       }
       return;
     }
     const std::size_t P = mPartitionSize;
+    const std::size_t mask = mRingSize - 1;
     for (std::size_t i = 0; i < numFrames; ++i) {
-      // mInputAccum is laid out [old_partition | new_partition]; new samples
-      // fill the upper half. When the upper half is full we run the FFT
-      // step and slide.
-      mInputAccum[P + mInputCursor] = in[i];
-      out[i] = mOutputAccum[mOutputCursor];
-      ++mInputCursor;
-      ++mOutputCursor;
-      if (mInputCursor >= P) {
-        // Full partition collected: run one overlap-save step that emits
-        // the next P output samples and advances the spectrum ring.
-        runPartitionStep();
+      // Read before write: in and out may alias.
+      for (std::size_t c = 0; c < mNumInputs; ++c) {
+        mInputChunk[c * P + mInputCursor] = in[c][i];
+      }
+      const std::size_t slot = mTime & mask;
+      for (std::size_t o = 0; o < mNumOutputs; ++o) {
+        float& y = mOutputRing[o * mRingSize + slot];
+        out[o][i] = y;
+        y = 0.f;
+      }
+      ++mTime;
+      if (++mInputCursor >= P) {
+        // Full head partition collected: feed every stage and run this
+        // step's share of their work.
+        runStep();
         mInputCursor = 0;
-        mOutputCursor = 0;
       }
     }
   }
 
   /// Reset internal state and free buffers.
   void clear() {
-    mNumPartitions = 0;
     mIrLength = 0;
-    mFifoHead = 0;
     mReady = false;
-    mIrSpectra.clear();
-    mInputSpectraRing.clear();
-    mInputAccum.clear();
-    mOutputAccum.clear();
-    mScratch.clear();
-    mAcc.clear();
+    mStages.clear();
+    mInputChunk.clear();
+    mOutputRing.clear();
+    mRingSize = 0;
     mInputCursor = 0;
-    mOutputCursor = 0;
+    mTime = 0;
     mIrCopy.clear();
   }
 
   bool isReady() const { return mReady; }
+  std::size_t numInputs() const { return mNumInputs; }
+  std::size_t numOutputs() const { return mNumOutputs; }
   std::size_t irLength() const { return mIrLength; }
   std::size_t blockSize() const { return mBlockSize; }
   std::size_t partitionSize() const { return mPartitionSize; }
-  std::size_t numPartitions() const { return mNumPartitions; }
+  std::size_t maxPartitionSize() const { return mMaxPartitionSize; }
+  std::size_t numStages() const { return mStages.size(); }
+
+  /// Partitions per IR path across all stages
+  std::size_t numPartitions() const {
+    std::size_t n = 0;
+    for (const auto& st : mStages) n += st.numPartitions;
+    return n;
+  }
+
+  // Multiply spectrum a by b and add into acc. Spectra layout: N/2+1
+  // complex bins as [re0,im0,re1,im1,...,reN/2,imN/2] in N+2 floats. DC
+  // and Nyquist have zero imag and we still write through the same
+  // complex-mul; that's numerically identical because their imag is zero.
+  static void mulAddSpectrum(const float* a, const float* b, float* acc,
+                             std::size_t numComplex) {
+    std::size_t i = 0;
+#if defined(__wasm_simd128__)
+    // Two bins per vector: [ar0 ai0 ar1 ai1] * [br0 bi0 br1 bi1]
+    const v128_t sign = wasm_f32x4_make(-1.f, 1.f, -1.f, 1.f);
+    for (; i + 2 <= numComplex; i += 2) {
+      const v128_t va = wasm_v128_load(a + 2 * i);
+      const v128_t vb = wasm_v128_load(b + 2 * i);
+      const v128_t re = wasm_i32x4_shuffle(va, va, 0, 0, 2, 2);  // ar ar
+      const v128_t im = wasm_i32x4_shuffle(va, va, 1, 1, 3, 3);  // ai ai
+      const v128_t bs = wasm_i32x4_shuffle(vb, vb, 1, 0, 3, 2);  // bi br
+      // [ar*br - ai*bi, ar*bi + ai*br] per bin
+      v128_t prod = wasm_f32x4_add(wasm_f32x4_mul(re, vb),
+                                   wasm_f32x4_mul(wasm_f32x4_mul(im, bs), sign));
+      wasm_v128_store(acc + 2 * i, wasm_f32x4_add(wasm_v128_load(acc + 2 * i), prod));
+    }
+#endif
+    for (; i < numComplex; ++i) {
+      const float ar = a[2 * i + 0];
+      const float ai = a[2 * i + 1];
+      const float br = b[2 * i + 0];
+      const float bi = b[2 * i + 1];
+      // (ar + i*ai) * (br + i*bi) = (ar*br - ai*bi) + i*(ar*bi + ai*br)
+      acc[2 * i + 0] += ar * br - ai * bi;
+      acc[2 * i + 1] += ar * bi + ai * br;
+    }
+  }
 
 private:
+  // One uniformly-partitioned convolver over a slice of the IRs. Each
+  // spectrum has N+2 real-valued slots (see the layout note above).
+  struct Stage {
+    std::size_t partitionSize = 0;   // P_s
+    std::size_t paddedSize = 0;      // N_s = 2*P_s
+    std::size_t numPartitions = 0;   // K_s
+    std::size_t irOffset = 0;        // first IR sample this stage covers
+    std::size_t period = 1;          // head steps per chunk = P_s / P0
+    std::size_t fill = 0;            // samples of the current chunk gathered
+    std::size_t fifoHead = 0;        // newest entry in each input's spectrum ring
+    std::size_t step = 0;            // head steps into the running job (== period: idle)
+    std::size_t macsDone = 0;        // partitions accumulated by the running job
+    std::size_t chunkEnd = 0;        // mTime when the running job's chunk completed
+
+    std::unique_ptr<gam::RFFT<float>> fft;
+    // Per path (out * ins + in), K * (N+2) flat: partition k @ k*(N+2).
+    // Empty for paths without an IR.
+    std::vector<std::vector<float>> irSpectra;
+    std::vector<std::vector<float>> inputSpectraRing; // per input, K * (N+2)
+    std::vector<std::vector<float>> window;           // per input, N samples
+    std::vector<std::vector<float>> acc;              // per output, N+2
+    std::vector<float> scratch;                       // (N+2) for the FFT roundtrip
+  };
+
   // ---- Geometry --------------------------------------------------------
 
   std::size_t mBlockSize;        // worklet block size (typ. 128)
-  std::size_t mPartitionSize;    // partition length P (default = blockSize)
-  std::size_t mPaddedSize;       // FFT length N = 2*P
-  std::size_t mNumPartitions;    // K = ceil(irLen / P)
-  std::size_t mFifoHead;         // ring head in [0..K)
-  std::size_t mIrLength;
-  std::size_t mInputCursor = 0;  // 0..P  index into next input partition
-  std::size_t mOutputCursor = 0; // 0..P  index into pending output buffer
+  std::size_t mPartitionSize;    // head partition P0 (default = blockSize)
+  std::size_t mMaxPartitionSize; // tail partitions stop growing here
+  std::size_t mNumInputs;
+  std::size_t mNumOutputs;
+  std::size_t mIrLength;         // longest path
+  std::size_t mInputCursor = 0;  // 0..P0 index into mInputChunk
+  std::size_t mTime = 0;         // samples consumed; indexes mOutputRing
+  std::size_t mRingSize = 0;     // pow2 length of each output's ring
   bool mReady;
 
-  std::vector<float> mIrCopy;       // full IR (so rebuilds work after resize)
-
-  // ---- Spectra (each spectrum has N+2 real-valued slots) ---------------
-
-  std::vector<float> mIrSpectra;        // K * (N+2) flat: partition k @ k*(N+2)
-  std::vector<float> mInputSpectraRing; // K * (N+2) ring of input spectra
-  std::vector<float> mAcc;              // (N+2) frequency-domain accumulator
-
-  // ---- Time-domain scratch / output ------------------------------------
-
-  std::vector<float> mInputAccum;   // last 2 input partitions concatenated (N samples)
-  std::vector<float> mOutputAccum;  // P samples ready to emit
-  std::vector<float> mScratch;      // scratch of length N+2 for FFT roundtrip
-
-  // ---- FFT engine ------------------------------------------------------
-
-  std::unique_ptr<gam::RFFT<float>> mFFT;
+  std::vector<std::vector<float>> mIrCopy; // IR matrix (so rebuilds work after resize)
+  std::vector<Stage> mStages;              // stage 0 is the head
+  std::vector<float> mInputChunk;          // per input, the P0 samples being gathered
+  std::vector<float> mOutputRing;          // per output, pending output by output time
 
   // ---------------------------------------------------------------------
 
-  void rebuildFromCurrentSizes(const float* ir, std::size_t numSamples) {
-    const std::size_t P = mPartitionSize;
-    const std::size_t N = 2 * P;
-    const std::size_t SPEC = N + 2;
-    mPaddedSize = N;
-    mNumPartitions = (numSamples + P - 1) / P;
+  static std::size_t nextPow2(std::size_t n) {
+    std::size_t pow2 = 1;
+    while (pow2 < n) pow2 <<= 1;
+    return pow2;
+  }
 
-    mFFT.reset(new gam::RFFT<float>(static_cast<int>(N)));
+  void rebuild() {
+    const std::size_t P0 = mPartitionSize;
+    const std::size_t maxP = std::max(mMaxPartitionSize, P0);
+    const std::size_t numSamples = mIrLength;
+    mStages.clear();
+
+    std::size_t P = P0;
+    std::size_t offset = 0;
+    while (offset < numSamples) {
+      const std::size_t remaining = (numSamples - offset + P - 1) / P;
+      std::size_t K = remaining;
+      if (P < maxP) {
+        // Enough partitions that the next (2x) stage starts at least
+        // 2*P_next - 2*P0 in, so its spread-out result is never late.
+        const std::size_t need = 4 * P - 2 * P0;
+        const std::size_t k = need > offset ? (need - offset + P - 1) / P : 1;
+        K = std::min(std::max<std::size_t>(k, 1), remaining);
+      }
+      mStages.emplace_back();
+      buildStage(mStages.back(), P, offset, K);
+      offset += K * P;
+      if (P < maxP) P *= 2;
+    }
 
-    mIrSpectra.assign(mNumPartitions * SPEC, 0.f);
-    mInputSpectraRing.assign(mNumPartitions * SPEC, 0.f);
-    mAcc.assign(SPEC, 0.f);
-    mInputAccum.assign(N, 0.f);
-    mOutputAccum.assign(P, 0.f);
-    mScratch.assign(SPEC, 0.f);
+    // Output ring must reach the furthest sample the last stage writes
+    const Stage& last = mStages.back();
+    mRingSize = nextPow2(last.irOffset + last.partitionSize + 2 * P0);
+    mOutputRing.assign(mNumOutputs * mRingSize, 0.f);
+    mInputChunk.assign(mNumInputs * P0, 0.f);
     mInputCursor = 0;
-    mOutputCursor = 0;
-    mFifoHead = 0;
-
-    // Cache IR copy so size changes can rebuild without re-asking the user.
-    if (ir != mIrCopy.data()) {
-      mIrCopy.assign(ir, ir + numSamples);
-    } else if (mIrCopy.size() != numSamples) {
-      mIrCopy.resize(numSamples);
-    }
+    mTime = 0;
+    mReady = true;
+  }
 
-    // FFT each partition into mIrSpectra.
+  void buildStage(Stage& st, std::size_t P, std::size_t offset, std::size_t K) {
+    const std::size_t N = 2 * P;
+    const std::size_t SPEC = N + 2;
+    st.partitionSize = P;
+    st.paddedSize = N;
+    st.numPartitions = K;
+    st.irOffset = offset;
+    st.period = P / mPartitionSize;
+    st.step = st.period;
+    st.fft.reset(new gam::RFFT<float>(static_cast<int>(N)));
+    st.inputSpectraRing.assign(mNumInputs, std::vector<float>(K * SPEC, 0.f));
+    st.window.assign(mNumInputs, std::vector<float>(N, 0.f));
+    st.acc.assign(mNumOutputs, std::vector<float>(SPEC, 0.f));
+    st.scratch.assign(SPEC, 0.f);
+    st.irSpectra.assign(mIrCopy.size(), std::vector<float>());
+
+    // FFT each partition into irSpectra.
     // RFFT complexBuf=true layout: input is [*, x0, x1, ..., x(N-1), *]
     // — i.e. the N real samples sit at indices 1..N in an (N+2)-sized
     // scratch buffer. Output (in-place) is the standard interleaved
     // [r0,0,r1,i1,...,r(N/2),0] layout.
-    for (std::size_t k = 0; k < mNumPartitions; ++k) {
-      float* dst = mScratch.data();
-      std::memset(dst, 0, SPEC * sizeof(float));
-      const std::size_t kp = k * P;
-      const std::size_t copy = (kp + P <= numSamples) ? P : (numSamples - kp);
-      // Place P samples at offset 1; the remaining N-P slots (1+P .. N) and
-      // the trailing pad slot are zero — this is standard partitioned
-      // overlap-save (each IR partition is zero-padded to length N=2P).
-      if (copy > 0) std::memcpy(dst + 1, ir + kp, copy * sizeof(float));
-      mFFT->forward(dst, /*complexBuf=*/true, /*normalize=*/false);
-      std::memcpy(&mIrSpectra[k * SPEC], dst, SPEC * sizeof(float));
+    for (std::size_t path = 0; path < mIrCopy.size(); ++path) {
+      const std::vector<float>& ir = mIrCopy[path];
+      // Paths that end before this stage contribute nothing to it
+      if (ir.size() <= offset) continue;
+      std::vector<float>& spectra = st.irSpectra[path];
+      spectra.assign(K * SPEC, 0.f);
+      for (std::size_t k = 0; k < K; ++k) {
+        float* dst = st.scratch.data();
+        std::memset(dst, 0, SPEC * sizeof(float));
+        const std::size_t kp = offset + k * P;
+        if (kp >= ir.size()) break;
+        const std::size_t copy = std::min(P, ir.size() - kp);
+        // Place P samples at offset 1; the remaining N-P slots (1+P .. N)
+        // and the trailing pad slot are zero — this is standard partitioned
+        // overlap-save (each IR partition is zero-padded to length N=2P).
+        std::memcpy(dst + 1, ir.data() + kp, copy * sizeof(float));
+        st.fft->forward(dst, /*complexBuf=*/true, /*normalize=*/false);
+        std::memcpy(&spectra[k * SPEC], dst, SPEC * sizeof(float));
+      }
     }
-
-    mReady = true;
   }
 
-  // Multiply partition spectrum P_k by ring spectrum X_{head-k} and add into
-  // the accumulator. Spectra layout: N/2+1 complex bins as
-  // [re0,im0,re1,im1,...,reN/2,imN/2] in N+2 floats. DC and Nyquist have
-  // zero imag and we still write through the same complex-mul; that's
-  // numerically identical because their imag is zero.
-  inline void mulAddSpectrum(const float* a, const float* b, float* acc,
-                             std::size_t numComplex) {
-    for (std::size_t i = 0; i < numComplex; ++i) {
-      const float ar = a[2 * i + 0];
-      const float ai = a[2 * i + 1];
-      const float br = b[2 * i + 0];
-      const float bi = b[2 * i + 1];
-      // (ar + i*ai) * (br + i*bi) = (ar*br - ai*bi) + i*(ar*bi + ai*br)
-      acc[2 * i + 0] += ar * br - ai * bi;
-      acc[2 * i + 1] += ar * bi + ai * br;
+  // One head step (every P0 input samples, mTime a multiple of P0): append
+  // the new chunk to every stage, start jobs for stages whose chunk is now
+  // complete, and advance every running job by one step.
+  void runStep() {
+    const std::size_t P0 = mPartitionSize;
+    for (Stage& st : mStages) {
+      for (std::size_t c = 0; c < mNumInputs; ++c) {
+        std::memcpy(&st.window[c][st.partitionSize + st.fill], &mInputChunk[c * P0],
+                    P0 * sizeof(float));
+      }
+      st.fill += P0;
+      if (st.fill == st.partitionSize) {
+        startJob(st);
+        st.fill = 0;
+      }
+      if (st.step < st.period) advanceJob(st);
     }
   }
 
-  // Run one overlap-save step. Pre: mInputAccum's first P samples hold the
-  // previous partition's input, last P samples hold the just-collected new
-  // input. Post: mOutputAccum holds the next P output samples; the input
-  // ring is rotated so the new partition becomes "the previous" half.
-  void runPartitionStep() {
-    const std::size_t P = mPartitionSize;
-    const std::size_t N = mPaddedSize;
+  // FFT every input's [previous | current] window into its ring (once,
+  // shared by all outputs) and reset the accumulators; the MACs and
+  // inverse FFTs follow over `period` steps.
+  void startJob(Stage& st) {
+    const std::size_t P = st.partitionSize;
+    const std::size_t N = st.paddedSize;
     const std::size_t SPEC = N + 2;
-    const std::size_t numComplex = (N / 2) + 1;
 
-    // Shift input window: old new -> the next call's "old" half is what
-    // we just consumed. Concretely: copy the upper half (the just-arrived
-    // P samples currently sitting in mInputAccum[P..2P-1]) to the lower
-    // half. The new arrivals will be written into the upper half by the
-    // next batch of process() samples writing into mInputAccum[mInputCursor].
-    // Because mInputAccum is laid out [old | new], we save the new chunk
-    // before we overwrite it.
-
-    // Build an FFT-input buffer of length N from mInputAccum (it already
-    // has the right [old | new] contents) and FFT into the ring slot.
-    // complexBuf=true expects samples at offset 1.
-    {
-      float* dst = mScratch.data();
+    st.fifoHead = (st.fifoHead + 1) % st.numPartitions;
+    for (std::size_t c = 0; c < mNumInputs; ++c) {
+      std::vector<float>& window = st.window[c];
+      // complexBuf=true expects samples at offset 1.
+      float* dst = st.scratch.data();
       std::memset(dst, 0, SPEC * sizeof(float));
-      std::memcpy(dst + 1, mInputAccum.data(), N * sizeof(float));
-      mFFT->forward(dst, /*complexBuf=*/true, /*normalize=*/false);
-      std::memcpy(&mInputSpectraRing[mFifoHead * SPEC], dst, SPEC * sizeof(float));
+      std::memcpy(dst + 1, window.data(), N * sizeof(float));
+      st.fft->forward(dst, /*complexBuf=*/true, /*normalize=*/false);
+      std::memcpy(&st.inputSpectraRing[c][st.fifoHead * SPEC], dst, SPEC * sizeof(float));
+
+      // Slide the window: this chunk becomes the next FFT's "previous" half.
+      std::memmove(window.data(), window.data() + P, P * sizeof(float));
+      std::memset(window.data() + P, 0, P * sizeof(float));
     }
 
-    // Reset accumulator and accumulate K partitions.
-    std::memset(mAcc.data(), 0, SPEC * sizeof(float));
-    for (std::size_t k = 0; k < mNumPartitions; ++k) {
-      // ring index: most recent input spectrum is at mFifoHead, paired
-      // with partition 0; next-most-recent at (mFifoHead - 1 + K) % K
+    for (auto& acc : st.acc) std::fill(acc.begin(), acc.end(), 0.f);
+    st.step = 0;
+    st.macsDone = 0;
+    st.chunkEnd = mTime;
+  }
+
+  // This step's share of the MACs; the last step also runs the inverse FFTs
+  // and mixes the results into the output rings.
+  void advanceJob(Stage& st) {
+    const std::size_t P = st.partitionSize;
+    const std::size_t N = st.paddedSize;
+    const std::size_t SPEC = N + 2;
+    const std::size_t numComplex = (N / 2) + 1;
+    const std::size_t K = st.numPartitions;
+
+    const std::size_t target = (K * (st.step + 1) + st.period - 1) / st.period;
+    for (std::size_t k = st.macsDone; k < target; ++k) {
+      // ring index: most recent input spectrum is at fifoHead, paired
+      // with partition 0; next-most-recent at (fifoHead - 1 + K) % K
       // is paired with partition 1; etc.
-      const std::size_t r = (mFifoHead + mNumPartitions - k) % mNumPartitions;
-      const float* irSpec = &mIrSpectra[k * SPEC];
-      const float* inSpec = &mInputSpectraRing[r * SPEC];
-      mulAddSpectrum(irSpec, inSpec, mAcc.data(), numComplex);
+      const std::size_t r = (st.fifoHead + K - k) % K;
+      for (std::size_t o = 0; o < mNumOutputs; ++o) {
+        for (std::size_t c = 0; c < mNumInputs; ++c) {
+          const std::vector<float>& spectra = st.irSpectra[o * mNumInputs + c];
+          if (spectra.empty()) continue;
+          mulAddSpectrum(&spectra[k * SPEC], &st.inputSpectraRing[c][r * SPEC],
+                         st.acc[o].data(), numComplex);
+        }
+      }
     }
+    st.macsDone = target;
+    if (++st.step < st.period) return;
 
     // Inverse FFT in place. RFFT::inverse with complexBuf=true reads the
     // interleaved [r0,0,r1,i1,...,r(N/2),0] layout and writes the N real
     // samples at offsets 1..N. We discard the first P (overlap-save aliased
-    // tail) and emit samples [P+1 .. 2P]. Forward+inverse with no
+    // tail) and keep samples [P+1 .. 2P], which are this stage's output for
+    // input times [chunkEnd - P, chunkEnd). Forward+inverse with no
     // normalization multiplies by N, so divide by N.
-    {
-      float* buf = mScratch.data();
-      std::memcpy(buf, mAcc.data(), SPEC * sizeof(float));
-      mFFT->inverse(buf, /*complexBuf=*/true);
-      const float norm = 1.f / static_cast<float>(N);
+    const float norm = 1.f / static_cast<float>(N);
+    // Output for input time t is due at t + irOffset + P0 (head latency)
+    const std::size_t mask = mRingSize - 1;
+    const std::size_t due = st.chunkEnd - P + st.irOffset + mPartitionSize;
+    for (std::size_t o = 0; o < mNumOutputs; ++o) {
+      float* buf = st.scratch.data();
+      std::memcpy(buf, st.acc[o].data(), SPEC * sizeof(float));
+      st.fft->inverse(buf, /*complexBuf=*/true);
+      float* ring = &mOutputRing[o * mRingSize];
       for (std::size_t i = 0; i < P; ++i) {
-        mOutputAccum[i] = buf[1 + P + i] * norm;
+        ring[(due + i) & mask] += buf[1 + P + i] * norm;
       }
     }
+  }
+};
 
-    // Slide the input window: next call's "old" half is what we just had
-    // as "new". Move upper half down.
-    std::memmove(mInputAccum.data(), mInputAccum.data() + P, P * sizeof(float));
-    // Upper half will be overwritten by next P incoming samples; clear so
-    // any underrun doesn't leak stale data.
-    std::memset(mInputAccum.data() + P, 0, P * sizeof(float));
+/// Mono convolver: one input, one IR, one output.
+class WebConvolver {
+public:
+  /// Load IR from raw float array. numSamples may be any length; partitions
+  /// will tile it and the tail is zero-padded into the final partition.
+  bool loadIR(const float* ir, std::size_t numSamples) {
+    if (!ir || numSamples == 0) {
+      clear();
+      return false;
+    }
+    return mEngine.loadIRs(1, 1, {std::vector<float>(ir, ir + numSamples)});
+  }
+
+  bool loadIR(const std::vector<float>& ir) {
+    return loadIR(ir.data(), ir.size());
+  }
 
-    // Advance the spectrum ring.
-    mFifoHead = (mFifoHead + 1) % mNumPartitions;
+  /// Set audio block size (frames per process() call). Triggers rebuild if
+  /// an IR is already loaded.
+  void setBlockSize(std::size_t blockSize) { mEngine.setBlockSize(blockSize); }
+
+  /// Override the head partition size (rounded up to a power of two).
+  /// Default is blockSize. This is the convolver's latency; the tail
+  /// partitions grow from it.
+  void setPartitionSize(std::size_t parts) { mEngine.setPartitionSize(parts); }
+
+  /// Largest tail partition (rounded up to a power of two, default 8192).
+  /// Values <= partitionSize() give uniform partitioning.
+  void setMaxPartitionSize(std::size_t size) { mEngine.setMaxPartitionSize(size); }
+
+  /// Convolve `numFrames` samples from `in` into `out`. The caller may
+  /// invoke this with numFrames smaller than mBlockSize; the internal
+  /// scheduler buffers the input until a full partition is ready, and
+  /// emits previously-computed output samples in the meantime.
+  void process(const float* in, float* out, std::size_t numFrames) {
+    if (!mEngine.isReady()) {
+      // Pass-through when no IR has been loaded yet.
+      if (out && in && out != in) {
+        std::memcpy(out, in, numFrames * sizeof(float));
+      }
+      return;
+    }
+    const float* ins[1] = {in};
+    float* outs[1] = {out};
+    mEngine.process(ins, outs, numFrames);
   }
+
+  /// Reset internal state and free buffers.
+  void clear() { mEngine.clear(); }
+
+  bool isReady() const { return mEngine.isReady(); }
+  std::size_t irLength() const { return mEngine.irLength(); }
+  std::size_t blockSize() const { return mEngine.blockSize(); }
+  std::size_t partitionSize() const { return mEngine.partitionSize(); }
+  std::size_t maxPartitionSize() const { return mEngine.maxPartitionSize(); }
+  std::size_t numStages() const { return mEngine.numStages(); }
+
+  /// Partitions across all stages
+  std::size_t numPartitions() const { return mEngine.numPartitions(); }
+
+private:
+  WebMultiConvolver mEngine;
 };
 
 }  // namespace studio
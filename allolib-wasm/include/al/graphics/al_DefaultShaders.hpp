@@ -15,6 +15,12 @@
 
 inline constexpr int al_max_num_lights() { return 8; }
 
+// froxel grid of the clustered lighting shaders (al_WebClusteredLights.hpp):
+// screen tiles in x/y, exponential depth slices in z
+inline constexpr int al_cluster_grid_x() { return 16; }
+inline constexpr int al_cluster_grid_y() { return 9; }
+inline constexpr int al_cluster_grid_z() { return 24; }
+
 struct per_light_uniform_locations {
   int ambient = -1;
   int diffuse = -1;
@@ -220,6 +226,50 @@ void main() {
 )";
 }
 
+// ---------------------------------------------------------
+
+// fragment shader functions reading the froxel grid uploaded by
+// ClusteredLights::bind(), for point lights beyond light()/numLight()
+inline std::string al_clustered_lights_frag_functions() {
+  using namespace std::string_literals;
+  return R"(
+uniform highp sampler2D al_ClusterLights;   // 2 texels per light: view pos + radius, color
+uniform highp usampler2D al_ClusterRanges;  // froxel (offset, count), one row per slice
+uniform highp usampler2D al_ClusterIndices; // light indices, 1024 per row
+uniform vec4 al_ClusterViewport;            // x, y, width, height in pixels
+uniform vec2 al_ClusterDepth;               // slice = log(depth) * x + y
+const ivec3 AL_CLUSTER_GRID = ivec3()"s +
+         std::to_string(al_cluster_grid_x()) + ", "s +
+         std::to_string(al_cluster_grid_y()) + ", "s +
+         std::to_string(al_cluster_grid_z()) + R"();
+
+// light list (offset, count) of the froxel holding this fragment,
+// depth being its positive view-space distance along -z
+uvec2 al_clusterRange(float depth) {
+  vec2 tile = (gl_FragCoord.xy - al_ClusterViewport.xy) / al_ClusterViewport.zw;
+  ivec2 xy = clamp(ivec2(tile * vec2(AL_CLUSTER_GRID.xy)), ivec2(0), AL_CLUSTER_GRID.xy - 1);
+  int z = clamp(int(log(max(depth, 1e-4)) * al_ClusterDepth.x + al_ClusterDepth.y),
+                0, AL_CLUSTER_GRID.z - 1);
+  return texelFetch(al_ClusterRanges, ivec2(xy.x + xy.y * AL_CLUSTER_GRID.x, z), 0).rg;
+}
+
+// view-space position + radius and color * intensity of the i-th light of
+// a range
+void al_clusterLight(uint i, out vec4 pos_radius, out vec3 color) {
+  int index = int(texelFetch(al_ClusterIndices, ivec2(int(i & 1023u), int(i >> 10u)), 0).r);
+  pos_radius = texelFetch(al_ClusterLights, ivec2(0, index), 0);
+  color = texelFetch(al_ClusterLights, ivec2(1, index), 0).rgb;
+}
+
+// inverse-square falloff windowed to reach zero at the radius
+float al_clusterAttenuation(float dist, float radius) {
+  float x = dist / radius;
+  float window = clamp(1.0 - x * x * x * x, 0.0, 1.0);
+  return window * window / (dist * dist + 1.0);
+}
+)"s;
+}
+
 // --------------------------------------------------------
 
 namespace al {
@@ -249,6 +299,14 @@ std::string multilight_frag_shader(ShaderType type, int num_lights);
 void compileMultiLightShader(ShaderProgram& s, ShaderType type, int num_lights,
                              bool is_omni = false);
 
+// return fragment shader string for specified configuration that also adds
+// the point lights of a clustered froxel grid
+std::string clustered_multilight_frag_shader(ShaderType type, int num_lights);
+
+// compile lighting shader that also reads clustered point lights (not omni)
+void compileClusteredLightShader(ShaderProgram& s, ShaderType type,
+                                 int num_lights);
+
 }  // namespace al
 
 #endif
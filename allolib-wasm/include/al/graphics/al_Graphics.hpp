@@ -18,6 +18,9 @@
 
 namespace al {
 
+struct InterleavedMesh;  // al_WebMeshAdapter.hpp
+class ClusteredLights;   // al_WebClusteredLights.hpp
+
 /**
 @defgroup Graphics Graphics
 */
@@ -137,6 +140,8 @@ public:
   void draw(EasyVAO &vao);
   void draw(const Mesh &mesh);
   void draw(Mesh &&mesh);
+  // Pre-interleaved render-only geometry (e.g. WebGLTF::parseInterleaved)
+  void draw(const InterleavedMesh &mesh);
 
   // ─── WebGPU-aware viewport methods (hide RenderManager::viewport) ──────────
   // These update the viewport stack but skip glViewport() in WebGPU mode
@@ -205,6 +210,12 @@ public:
   // does not enable lighting, call lighting(true) to enable lighting
   void light(Light const &l, int idx = 0);
 
+  // add the point lights of a froxel grid to lit draws, on top of light()
+  // (call lights->update(*this) once the camera is set); nullptr goes back
+  // to the per-light shaders. ignored in omni mode.
+  void clusteredLights(ClusteredLights *lights);
+  ClusteredLights *clusteredLights() const { return mClusteredLights; }
+
   void quad(Texture &tex, float x, float y, float w, float h,
             bool flip = false);
   void quadViewport(Texture &tex, float x = -1, float y = -1, float w = 2,
@@ -221,6 +232,7 @@ public:
   void send_lighting_uniforms(ShaderProgram &s,
                               lighting_shader_uniforms const &u);
   void update() override;
+  void update_clustered();
 
   // to pass to the shader, combined with mLens.eyeSep()
   static const float LEFT_EYE;
@@ -317,6 +329,18 @@ private:
   lighting_shader_uniforms omni_lighting_tex_uniforms[al_max_num_lights()];
   lighting_shader_uniforms omni_lighting_material_uniforms[al_max_num_lights()];
 
+  // clustered variants of the lighting shaders, compiled on first use,
+  // indexed [coloring mode][num_lights - 1]
+  struct ClusteredShader {
+    ShaderProgram shader;
+    lighting_shader_uniforms uniforms;
+    int color_location = -1;
+    int tint_location = -1;
+    bool compiled = false;
+  };
+  ClusteredLights *mClusteredLights = nullptr;
+  ClusteredShader clustered_lighting[4][al_max_num_lights()];
+
   Lens mLens;
   float mEye = 0.0f;
 };
@@ -12,7 +12,11 @@
  * - OES_texture_float_linear: Float texture linear filtering (optional)
  * - WEBGL_debug_renderer_info: GPU vendor/renderer info
  * - EXT_texture_filter_anisotropic: Anisotropic filtering
- * - WEBGL_compressed_texture_*: Various compression formats
+ * - WEBGL_compressed_texture_*, EXT_texture_compression_bptc: GPU
+ *   block-compressed formats (see WebKTX2)
+ * - WEBGL_multi_draw: Many draws per call, with gl_DrawID in shaders
+ * - KHR_parallel_shader_compile: Poll shader/program completion instead of
+ *   blocking on the first status query
  *
  * Note: Cubemap textures are fully supported in WebGL2 core, no extension needed.
  */
@@ -28,6 +32,27 @@
 #include "al/graphics/al_OpenGL.hpp"
 #endif
 
+// Compressed texture formats (WEBGL_compressed_texture_s3tc, _etc, _astc and
+// EXT_texture_compression_bptc). These may not be defined in all GLES headers.
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM_EXT
+#define GL_COMPRESSED_RGBA_BPTC_UNORM_EXT 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+
 namespace al {
 
 /**
@@ -47,11 +72,14 @@ struct WebGL2Capabilities {
     // Other features
     bool anisotropicFiltering = false;
     float maxAnisotropy = 1.0f;
+    bool multiDraw = false;                // WEBGL_multi_draw
+    bool parallelShaderCompile = false;    // KHR_parallel_shader_compile
 
     // Compression formats
-    bool s3tcCompression = false;
-    bool etc2Compression = true;           // ETC2 is mandatory in WebGL2
+    bool s3tcCompression = false;          // BC1-BC3
+    bool etc2Compression = false;          // WEBGL_compressed_texture_etc (mostly mobile)
     bool astcCompression = false;
+    bool bptcCompression = false;          // BC7 (EXT_texture_compression_bptc)
 
     // Debug info
     bool hasDebugInfo = false;
@@ -127,6 +155,20 @@ public:
             var astc = gl.getExtension('WEBGL_compressed_texture_astc');
             Module._al_webgl2_set_capability(6, astc ? 1 : 0);
 
+            var bptc = gl.getExtension('EXT_texture_compression_bptc');
+            Module._al_webgl2_set_capability(8, bptc ? 1 : 0);
+
+            var etc = gl.getExtension('WEBGL_compressed_texture_etc');
+            Module._al_webgl2_set_capability(9, etc ? 1 : 0);
+
+            // Multi-draw
+            var multiDraw = gl.getExtension('WEBGL_multi_draw');
+            Module._al_webgl2_set_capability(7, multiDraw ? 1 : 0);
+
+            // Non-blocking shader compilation
+            var parallelCompile = gl.getExtension('KHR_parallel_shader_compile');
+            Module._al_webgl2_set_capability(10, parallelCompile ? 1 : 0);
+
             // Query limits
             Module._al_webgl2_set_int_param(0, gl.getParameter(gl.MAX_TEXTURE_SIZE));
             Module._al_webgl2_set_int_param(1, gl.getParameter(gl.MAX_CUBE_MAP_TEXTURE_SIZE));
@@ -30,6 +30,7 @@
  * or other features that don't work in the browser.
  */
 
+#include "al/graphics/al_EasyFBO.hpp"
 #include "al/graphics/al_Graphics.hpp"
 #include "al/graphics/al_Mesh.hpp"
 #include "al/graphics/al_Shapes.hpp"
@@ -56,10 +57,17 @@
 #include "al/math/al_Matrix4.hpp"
 #include "al/math/al_Random.hpp"
 #include "al/spatial/al_Pose.hpp"
+#include "al_WebAudioGraph.hpp"
+#include "al_WebAudioMonitor.hpp"
+#include "al_WebAudioWorklet.hpp"
 #include "al_WebAutoLOD.hpp"
+#include "al_WebFrameStats.hpp"
 #include "al_WebGraphicsBackend.hpp"
+#include "al_WebProfiler.hpp"
 #include "al_GraphicsWebExtension.hpp"
 
+#include <atomic>
+#include <string>
 #include <vector>
 #include <memory>
 
@@ -78,6 +86,29 @@ struct WebAudioConfig {
     int bufferSize = 128;  // Web Audio worklets process 128 samples at a time
     int outputChannels = 2;
     int inputChannels = 0;
+    // Output buffered ahead of the worklet. When adaptive, the runtime grows
+    // it on underruns and main-thread stalls and shrinks it after quiet
+    // stretches, within [minLatencyFrames, maxLatencyFrames]
+    bool adaptiveLatency = true;
+    int minLatencyFrames = 256;
+    int maxLatencyFrames = 3072;
+};
+
+/**
+ * Offline ("bounce") render settings, see WebApp::renderOffline()
+ */
+struct OfflineRenderOptions {
+    double seconds = 10.0;
+    // Any filesystem path: MEMFS by default, kept across reloads under an
+    // IDBFS mount such as /presets
+    std::string path = "/tmp/render.wav";
+    bool download = true;     // Hand the file to the browser when done
+    bool float32 = false;     // 32-bit float samples instead of 16-bit PCM
+    // Run onAnimate (and with draw, the whole frame including onDraw)
+    // between blocks at a fixed dt of 1 / frameRate, as the live loop would
+    bool animate = false;
+    bool draw = false;
+    double frameRate = 60.0;
 };
 
 /**
@@ -253,31 +284,22 @@ public:
     // Automatic LOD (Level of Detail)
     // =========================================================================
 
+    // Defined in al_WebAutoLOD.cpp with the JS bridge, so sketches that
+    // never use auto-LOD don't link either.
+
     /// Get the auto-LOD manager for configuration
-    AutoLODManager& autoLOD() { return mAutoLOD; }
-    const AutoLODManager& autoLOD() const { return mAutoLOD; }
+    AutoLODManager& autoLOD();
+    const AutoLODManager& autoLOD() const;
 
     /// Draw a mesh with automatic LOD selection
     /// Uses camera distance to select appropriate detail level
-    void drawLOD(Graphics& g, const Mesh& mesh) {
-        if (mAutoLOD.enabled()) {
-            const Mesh& selected = mAutoLOD.selectMesh(mesh, g.modelMatrix());
-            g.draw(selected);
-        } else {
-            g.draw(mesh);
-        }
-    }
+    void drawLOD(Graphics& g, const Mesh& mesh);
 
     /// Convenience: Enable auto-LOD with default settings
-    void enableAutoLOD(int levels = 4) {
-        mAutoLOD.enable();
-        mAutoLOD.setLevels(levels);
-    }
+    void enableAutoLOD(int levels = 4);
 
     /// Convenience: Disable auto-LOD
-    void disableAutoLOD() {
-        mAutoLOD.disable();
-    }
+    void disableAutoLOD();
 
     // =========================================================================
     // Audio processing (called from JavaScript)
@@ -286,6 +308,95 @@ public:
     /// Fill the audio buffer (called from AudioWorklet via JavaScript)
     void processAudioBuffer(float* outputBuffer, int numFrames, int numChannels);
 
+    /// Adaptive output buffering (see WebAudioConfig); applies while running
+    void setAdaptiveLatency(bool enabled, int minFrames = 256, int maxFrames = 3072);
+
+    /// Frames from onSound writing a sample to it leaving the device: the
+    /// runtime's current buffering target plus the browser's output latency
+    int audioLatencyFrames() const { return mAudioLatencyFrames.load(std::memory_order_relaxed); }
+    double audioLatency() const {
+        return mAudioIOReal.framesPerSecond() > 0
+            ? audioLatencyFrames() / mAudioIOReal.framesPerSecond() : 0.0;
+    }
+
+    /// Called by the runtime whenever its buffering target changes
+    void setAudioLatencyFrames(int frames) {
+        mAudioLatencyFrames.store(frames, std::memory_order_relaxed);
+    }
+
+    /**
+     * Render `options.seconds` of onSound (plus appended callbacks) as fast
+     * as the CPU allows into a WAV file, then download it. Call after
+     * start(), e.g. from onCreate or a key handler; the page is busy until
+     * it returns and the live output is silent meanwhile. Input reads as
+     * silence. Returns false if the file could not be written.
+     */
+    bool renderOffline(const OfflineRenderOptions& options = OfflineRenderOptions());
+
+    /// Per-block DSP timing against the block deadline (al_WebAudioMonitor.hpp)
+    AudioMonitor& audioMonitor() { return mAudioMonitor; }
+
+    /// Recent frame intervals: FPS and frame-time percentiles (al_WebFrameStats.hpp)
+    FrameStats& frameStats() { return mFrameStats; }
+
+    /// Last frame's interval, CPU time and GPU time. GPU time stays 0 until
+    /// setGPUTiming(true) and lags the CPU by a few frames.
+    const FrameTimings& frameTimings() const { return mFrameStats.last(); }
+
+    /// Measure GPU time per frame with the backend's timestamp queries.
+    /// Returns false when the device has none (see GraphicsBackend).
+    bool setGPUTiming(bool enabled);
+
+    /**
+     * Dynamic resolution. Below 1 the frame is drawn offscreen at `scale`
+     * times the canvas size in each dimension, then stretched over the
+     * canvas with bilinear filtering, which cuts fill cost by about
+     * scale^2. The offscreen target is canvas-sized and frames use its
+     * lower-left corner, so changing the scale every frame allocates
+     * nothing. Clamped to [0.25, 1]; 1 (the default) draws to the canvas
+     * directly.
+     *
+     * Typically driven by QualityManager:
+     *   quality.update(dt, frameTimings());
+     *   setRenderScale(quality.resolutionScale());
+     *
+     * onDraw sees a viewport of the scaled size. Sketches that set their
+     * own full-canvas viewport in onDraw should stay at 1.
+     */
+    void setRenderScale(float scale);
+    float renderScale() const { return mRenderScale; }
+
+    /// audioIO().append(cb) with cb timed in its own audioMonitor() section
+    void appendAudioCallback(AudioCallback& cb, const std::string& name) {
+        int section = mAudioMonitor.addSection(name);
+        mTimedCallbacks.push_back(std::make_unique<TimedAudioCallback>(cb, mAudioMonitor, section));
+        mAudioIOReal.append(*mTimedCallbacks.back());
+    }
+
+    /// Callback dependency graph (al_WebAudioGraph.hpp), appended to
+    /// audioIO() on first use; nodes are timed in audioMonitor()
+    AudioCallbackGraph& audioGraph() {
+        if (!mAudioGraph) {
+            mAudioGraph = std::make_unique<AudioCallbackGraph>(&mAudioMonitor);
+            mAudioIOReal.append(*mAudioGraph);
+        }
+        return *mAudioGraph;
+    }
+
+    /// Parameter values handed to onSound once per frame (see
+    /// al_WebAudioWorklet.hpp). Add on the main thread, read() in onSound.
+    AudioParamSnapshot& audioParams() { return mAudioParams; }
+
+    /// True when onSound runs on the Web Audio rendering thread
+    /// (library built with ALLOLIB_AUDIO_WORKLET) rather than the main thread
+    static constexpr bool audioOnWorkletThread() {
+#ifdef AL_WEB_AUDIO_WORKLET
+        return true;
+#else
+        return false;
+#endif
+    }
+
     /// Set listener pose for spatial audio
     void setListenerPose(const Pose& pose);
 
@@ -399,9 +510,9 @@ private:
     int mHeight = 600;
     BackendType mBackendType = BackendType::WebGL2;  // Default to WebGL2 for compatibility
 
-    // Runtime state
-    bool mRunning = false;
-    bool mAudioInitialized = false;
+    // Runtime state (atomic: read by the audio thread in worklet builds)
+    std::atomic<bool> mRunning{false};
+    std::atomic<bool> mAudioInitialized{false};
     double mLastTime = 0;
 
     // Graphics
@@ -416,6 +527,54 @@ private:
     AudioIO mAudioIOReal;
     static void audioCBThunk(AudioIOData& io);
 
+    // Zero the AudioIO and run the callback chain for one block; false
+    // (output left silent) until the app is running or while renderOffline()
+    // owns the AudioIO
+    bool renderAudioBlock();
+    void processAudioBlock();
+
+    // onAnimate with the queued panel writes before it and the parameter
+    // snapshot published after it: the audio-facing part of tick()
+    void animateFrame(double dt);
+
+    // Everything tick() does, inside the profiler's "frame" zone
+    void renderFrame(double dt);
+
+    // Dynamic resolution (setRenderScale): onDraw goes to mScaledTarget
+    // when beginScaledFrame() returns true, and endScaledFrame() upscales
+    // it to the canvas
+    bool beginScaledFrame();
+    void endScaledFrame();
+    float mRenderScale = 1.0f;
+    float mScaledU = 1.0f, mScaledV = 1.0f;  // Drawn fraction of the target
+    std::unique_ptr<EasyFBO> mScaledTarget;
+
+    // renderOffline() takes the AudioIO from the live output; mAudioInBlock
+    // lets it wait out a block in flight on the worklet thread
+    std::atomic<bool> mOfflineRendering{false};
+    std::atomic<bool> mAudioInBlock{false};
+
+    // Published after onAnimate() every frame
+    AudioParamSnapshot mAudioParams;
+
+    // Last total reported by the runtime (setAudioLatencyFrames)
+    std::atomic<int> mAudioLatencyFrames{0};
+    // Hand the adaptive latency limits to runtime.ts (Module.alloAudioLatency)
+    void publishLatencyConfig();
+
+    AudioMonitor mAudioMonitor;
+    FrameStats mFrameStats;
+    std::vector<std::unique_ptr<TimedAudioCallback>> mTimedCallbacks;
+    std::unique_ptr<AudioCallbackGraph> mAudioGraph;
+
+#ifdef AL_WEB_AUDIO_WORKLET
+    // Wasm Audio Worklet bring-up (initAudio → thread → processor → node);
+    // the Emscripten callbacks live in al_WebApp.cpp
+    friend struct AudioWorkletGlue;
+    void startAudioWorklet();
+    int mAudioContext = 0;
+#endif
+
     // M5.6: lazy-constructed ParameterServer; null until first
     // parameterServer() call. unique_ptr so the forward declaration
     // is enough at this header level.
@@ -496,6 +655,20 @@ private:
                 gWebApp->processAudioBuffer(buffer, frames, channels);   \
             }                                                            \
         }                                                                \
+        EMSCRIPTEN_KEEPALIVE int allolib_audio_input_channels() {       \
+            return gWebApp ? (int)gWebApp->audioIO().channelsIn() : 0;   \
+        }                                                                \
+        /* runtime.ts reads the input ring straight into these */       \
+        EMSCRIPTEN_KEEPALIVE float* allolib_audio_input_buffer(int ch) {\
+            if (!gWebApp || ch < 0 ||                                    \
+                ch >= (int)gWebApp->audioIO().channelsIn()) {            \
+                return nullptr;                                          \
+            }                                                            \
+            return gWebApp->audioIO().inBuffer(ch);                      \
+        }                                                                \
+        EMSCRIPTEN_KEEPALIVE void allolib_set_audio_latency(int frames) {\
+            if (gWebApp) gWebApp->setAudioLatencyFrames(frames);         \
+        }                                                                \
         EMSCRIPTEN_KEEPALIVE void allolib_configure_audio(              \
             int sampleRate, int bufferSize, int outCh, int inCh) {      \
             if (gWebApp) {                                               \
@@ -0,0 +1,310 @@
+/**
+ * Web Asset Loader - shared, prioritized scheduler for asset requests
+ *
+ * Every web loader (WebImage, WebTexture, WebOBJ, WebHDR, WebKTX2,
+ * WebSamplePlayer) used to start its fetch the moment load() was called,
+ * so a scene with a few hundred assets queued them all at once and the
+ * visible ones finished whenever the browser got round to them. They now
+ * go through this scheduler instead, which:
+ * - caps the requests in flight (default 6, the browser's per-host limit)
+ *   and optionally the bandwidth they may use
+ * - starts the highest-priority request first (e.g. projected screen size
+ *   or distancePriority(lodDistance); higher is sooner, ties are FIFO)
+ * - runs identical requests (same URL and result type) once and hands the
+ *   result to everyone who asked
+ * - drops cancelled requests that haven't started yet
+ *
+ * Usage:
+ *   auto& loader = AssetLoader::instance();
+ *   loader.setMaxConcurrent(4);
+ *
+ *   // Raw bytes, shared with any other request for the same URL
+ *   auto ticket = loader.fetch("/assets/meshes/bunny.obj",
+ *                              AssetLoader::distancePriority(distance),
+ *                              [](const UploadedFile& file) { ... });
+ *   loader.setPriority(ticket, AssetLoader::distancePriority(newDistance));
+ *   loader.cancel(ticket);   // Callback won't run
+ *
+ *   // Through the loaders
+ *   obj.setPriority(screenPixels);
+ *   obj.load("/assets/meshes/bunny.obj");
+ *
+ * Requests already in flight can't be aborted (fetch completes and the
+ * result is dropped once nobody is waiting for it).
+ */
+
+#ifndef AL_WEB_ASSET_LOADER_HPP
+#define AL_WEB_ASSET_LOADER_HPP
+
+#include <emscripten.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "al_WebFile.hpp"
+
+namespace al {
+
+class AssetLoader {
+public:
+    /// Identifies one request; 0 is never issued
+    using Ticket = uint64_t;
+
+    /// Completes a request: the result (nullptr on failure) and its size in bytes
+    template <typename T>
+    using Done = std::function<void(const T* result, size_t bytes)>;
+
+    static AssetLoader& instance() {
+        static AssetLoader loader;
+        return loader;
+    }
+
+    /// Requests in flight at once (default 6)
+    void setMaxConcurrent(int n) {
+        mMaxConcurrent = std::max(1, n);
+        pump();
+    }
+    int maxConcurrent() const { return mMaxConcurrent; }
+
+    /**
+     * Bandwidth budget in bytes per second (0 = unlimited, the default).
+     * Requests are started only while the budget isn't overdrawn; bytes are
+     * charged as requests complete, with up to one second of burst.
+     */
+    void setBandwidthLimit(double bytesPerSecond) {
+        mBandwidth = std::max(0.0, bytesPerSecond);
+        mBudget = mBandwidth;
+        mBudgetTime = emscripten_get_now();
+        pump();
+    }
+    double bandwidthLimit() const { return mBandwidth; }
+
+    /// Priority for an object at an LOD / camera distance: nearer is sooner
+    static float distancePriority(float distance) {
+        return 1.0f / (1.0f + std::max(distance, 0.0f));
+    }
+
+    /**
+     * Schedule a request. `start` runs once a slot is free and must call
+     * the Done it is given exactly once, possibly asynchronously. If a
+     * request with the same key is queued or in flight, this one joins it
+     * (raising its priority if higher) and `callback` gets the shared
+     * result. Keys must identify the result type as well as the source.
+     */
+    template <typename T>
+    Ticket request(const std::string& key, float priority,
+                   std::function<void(Done<T>)> start,
+                   std::function<void(const T*)> callback) {
+        Ticket ticket = mNextTicket++;
+        Waiter waiter{ticket, priority, [callback](const void* result) {
+            if (callback) callback(static_cast<const T*>(result));
+        }};
+
+        auto it = mJobs.find(key);
+        if (it != mJobs.end()) {
+            it->second->waiters.push_back(std::move(waiter));
+            mTickets[ticket] = key;
+            return ticket;
+        }
+
+        auto job = std::make_shared<Job>();
+        job->key = key;
+        job->order = mNextOrder++;
+        job->waiters.push_back(std::move(waiter));
+        job->start = [start](Done<void> done) {
+            start([done](const T* result, size_t bytes) { done(result, bytes); });
+        };
+        mJobs.emplace(key, job);
+        mTickets[ticket] = key;
+        pump();
+        return ticket;
+    }
+
+    /**
+     * Fetch a URL's bytes (WebFile::loadFromURL). On failure the callback
+     * gets an empty file.
+     */
+    Ticket fetch(const std::string& url, float priority,
+                 std::function<void(const UploadedFile&)> callback) {
+        return request<UploadedFile>("file:" + url, priority,
+            [url](Done<UploadedFile> done) {
+                WebFile::loadFromURL(url, [done](const UploadedFile& file) {
+                    done(&file, file.data.size());
+                });
+            },
+            [callback](const UploadedFile* file) {
+                if (callback) callback(*file);
+            });
+    }
+
+    /// Re-rank a queued request (no effect once it has started)
+    void setPriority(Ticket ticket, float priority) {
+        Job* job = find(ticket);
+        if (!job) return;
+        for (auto& w : job->waiters) {
+            if (w.ticket == ticket) w.priority = priority;
+        }
+    }
+
+    /// Forget a request: its callback won't run, and if nobody else is
+    /// waiting for the same asset and it hasn't started, it never will
+    void cancel(Ticket ticket) {
+        Job* job = find(ticket);
+        if (!job) return;
+        auto& waiters = job->waiters;
+        waiters.erase(std::remove_if(waiters.begin(), waiters.end(),
+                                     [ticket](const Waiter& w) { return w.ticket == ticket; }),
+                      waiters.end());
+        mTickets.erase(ticket);
+        if (waiters.empty() && !job->running) mJobs.erase(job->key);
+    }
+
+    /// True while the request is queued or in flight
+    bool pending(Ticket ticket) const { return mTickets.count(ticket) != 0; }
+
+    // ── Stats ──
+
+    int queued() const { return (int)mJobs.size() - mInFlight; }
+    int inFlight() const { return mInFlight; }
+    /// Requests answered from another identical request
+    uint64_t deduplicated() const { return mDeduplicated; }
+    uint64_t completed() const { return mCompleted; }
+    uint64_t bytesLoaded() const { return mBytesLoaded; }
+
+private:
+    struct Waiter {
+        Ticket ticket;
+        float priority;
+        std::function<void(const void*)> callback;
+    };
+
+    struct Job {
+        std::string key;
+        uint64_t order = 0;
+        bool running = false;
+        std::vector<Waiter> waiters;
+        std::function<void(Done<void>)> start;
+
+        float priority() const {
+            float p = waiters.empty() ? 0.0f : waiters[0].priority;
+            for (const auto& w : waiters) p = std::max(p, w.priority);
+            return p;
+        }
+    };
+
+    AssetLoader() = default;
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    Job* find(Ticket ticket) {
+        auto t = mTickets.find(ticket);
+        if (t == mTickets.end()) return nullptr;
+        auto it = mJobs.find(t->second);
+        return it == mJobs.end() ? nullptr : it->second.get();
+    }
+
+    /// Start queued jobs, best first, while slots and bandwidth allow.
+    /// Linear scan: the queue is at most a few hundred entries.
+    void pump() {
+        if (mPumping) {
+            mPumpAgain = true;
+            return;
+        }
+        mPumping = true;
+        do {
+            mPumpAgain = false;
+            while (mInFlight < mMaxConcurrent && haveBandwidth()) {
+                std::shared_ptr<Job> best;
+                float bestPriority = 0.0f;
+                for (auto& entry : mJobs) {
+                    const auto& job = entry.second;
+                    if (job->running) continue;
+                    float p = job->priority();
+                    if (!best || p > bestPriority ||
+                        (p == bestPriority && job->order < best->order)) {
+                        best = job;
+                        bestPriority = p;
+                    }
+                }
+                if (!best) break;
+                launch(best);
+            }
+        } while (mPumpAgain);
+        mPumping = false;
+    }
+
+    void launch(const std::shared_ptr<Job>& job) {
+        job->running = true;
+        mInFlight++;
+        std::weak_ptr<Job> weak = job;
+        job->start([this, weak](const void* result, size_t bytes) {
+            auto job = weak.lock();
+            if (!job) return;
+            finish(job, result, bytes);
+        });
+    }
+
+    void finish(const std::shared_ptr<Job>& job, const void* result, size_t bytes) {
+        mInFlight--;
+        mCompleted++;
+        mBytesLoaded += bytes;
+        if (mBandwidth > 0) mBudget -= (double)bytes;
+        mJobs.erase(job->key);
+
+        // Callbacks may schedule more requests, so detach the waiters first
+        std::vector<Waiter> waiters = std::move(job->waiters);
+        if (waiters.size() > 1) mDeduplicated += waiters.size() - 1;
+        for (const auto& w : waiters) mTickets.erase(w.ticket);
+        for (const auto& w : waiters) w.callback(result);
+
+        pump();
+    }
+
+    bool haveBandwidth() {
+        if (mBandwidth <= 0) return true;
+        double now = emscripten_get_now();
+        mBudget = std::min(mBandwidth, mBudget + mBandwidth * (now - mBudgetTime) / 1000.0);
+        mBudgetTime = now;
+        if (mBudget > 0) return true;
+
+        // Overdrawn: come back when the deficit has refilled
+        if (!mRetryScheduled && queued() > 0) {
+            mRetryScheduled = true;
+            int ms = (int)std::ceil(-mBudget / mBandwidth * 1000.0) + 1;
+            emscripten_async_call([](void*) {
+                AssetLoader& loader = AssetLoader::instance();
+                loader.mRetryScheduled = false;
+                loader.pump();
+            }, nullptr, ms);
+        }
+        return false;
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<Job>> mJobs;  // Queued + in flight
+    std::unordered_map<Ticket, std::string> mTickets;
+    Ticket mNextTicket = 1;
+    uint64_t mNextOrder = 0;
+    int mMaxConcurrent = 6;
+    int mInFlight = 0;
+    bool mPumping = false;
+    bool mPumpAgain = false;
+
+    double mBandwidth = 0;       // Bytes per second, 0 = unlimited
+    double mBudget = 0;
+    double mBudgetTime = 0;
+    bool mRetryScheduled = false;
+
+    uint64_t mDeduplicated = 0;
+    uint64_t mCompleted = 0;
+    uint64_t mBytesLoaded = 0;
+};
+
+} // namespace al
+
+#endif // AL_WEB_ASSET_LOADER_HPP
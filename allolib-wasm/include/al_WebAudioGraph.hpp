@@ -0,0 +1,294 @@
+/**
+ * Web Audio Graph - appended callbacks as a dependency graph
+ *
+ * audioIO().append() runs post-FX strictly in order, even when the
+ * callbacks don't depend on each other. AudioCallbackGraph lets the app
+ * declare which callback feeds which; nodes whose inputs are ready run in
+ * parallel on a small worker pool when the library is built with
+ * ALLOLIB_AUDIO_THREADS (AL_WEB_AUDIO_THREADS, pthreads), and one after
+ * another in declaration order otherwise, with the same result.
+ *
+ * Each node processes its own copy of the block:
+ *   - a node without inputs starts from the graph's input (onSound and any
+ *     callbacks appended before the graph);
+ *   - a node with inputs starts from the sum of their outputs;
+ *   - the block's output becomes the sum of every Mix node nothing else
+ *     consumes; Tap nodes (meters, analyzers) only read.
+ *
+ * Parallel in-place effects both carry the dry signal, so their sum has
+ * it twice; make such branches wet-only, or chain them.
+ *
+ *   auto& g = audioGraph();                         // WebApp, main thread
+ *   int verb = g.add(reverb, "reverb");
+ *   int conv = g.add(convolver, "convolver");       // runs beside reverb
+ *   g.add(limiter, "limiter", {verb, conv});        // waits for both
+ *   g.add(analyzer, "analyzer", {}, AudioCallbackGraph::Tap);
+ *   g.setThreads(2);                                // AL_WEB_AUDIO_THREADS only
+ *
+ * Per block the audio thread publishes a generation number, workers woken
+ * on it claim nodes in declaration order from one atomic word, spin until
+ * the claimed node's inputs are marked done for this generation, run it and
+ * mark it done; the audio thread works too and spins until every node is
+ * done. Nothing locks. Idle workers sleep on a futex between blocks.
+ *
+ * Graph edits (add, setThreads) happen on the main thread before audio
+ * starts. Nodes are timed into audioMonitor() sections when the graph
+ * comes from WebApp::audioGraph().
+ */
+
+#ifndef AL_WEB_AUDIO_GRAPH_HPP
+#define AL_WEB_AUDIO_GRAPH_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "al/io/al_AudioIO.hpp"
+#include "al_WebAudioMonitor.hpp"
+#include "al_WebAudioSIMD.hpp"
+
+#ifdef AL_WEB_AUDIO_THREADS
+#include <emscripten/threading.h>
+#include <pthread.h>
+#include <cmath>
+#endif
+
+namespace al {
+
+class AudioCallbackGraph : public AudioCallback {
+public:
+    enum Output {
+        Mix,  ///< Output feeds consumers, or the block output if none
+        Tap   ///< Output is never mixed into the block (analysis only)
+    };
+
+    /// Nodes are timed into `monitor` sections when given
+    explicit AudioCallbackGraph(AudioMonitor* monitor = nullptr) : mMonitor(monitor) {}
+    ~AudioCallbackGraph() override { stopWorkers(); }
+
+    AudioCallbackGraph(const AudioCallbackGraph&) = delete;
+    AudioCallbackGraph& operator=(const AudioCallbackGraph&) = delete;
+
+    /**
+     * Add a node fed by the nodes in `inputs` (ids returned by earlier
+     * add() calls; empty = graph input). Returns the node id, or -1.
+     */
+    int add(AudioCallback& cb, const std::string& name,
+            std::initializer_list<int> inputs = {}, Output output = Mix) {
+        return add(cb, name, std::vector<int>(inputs), output);
+    }
+
+    int add(AudioCallback& cb, const std::string& name,
+            const std::vector<int>& inputs, Output output = Mix) {
+        if ((int)mNodes.size() >= kMaxNodes) {
+            printf("[AudioCallbackGraph] Limit of %d nodes reached\n", kMaxNodes);
+            return -1;
+        }
+        auto node = std::make_unique<Node>();
+        node->cb = &cb;
+        node->output = output;
+        node->section = mMonitor ? mMonitor->addSection(name) : -1;
+        const int id = (int)mNodes.size();
+        for (int in : inputs) {
+            // Inputs must already exist, which keeps ids in topological order
+            if (in < 0 || in >= id) {
+                printf("[AudioCallbackGraph] %s: ignoring unknown input %d\n", name.c_str(), in);
+                continue;
+            }
+            node->inputs.push_back(in);
+            mNodes[in]->consumers++;
+        }
+        mNodes.push_back(std::move(node));
+        return id;
+    }
+
+    /**
+     * Worker threads besides the audio thread (0 = run serially there).
+     * Without AL_WEB_AUDIO_THREADS the graph is always serial.
+     */
+    void setThreads(int n) {
+#ifdef AL_WEB_AUDIO_THREADS
+        stopWorkers();
+        mQuit.store(false, std::memory_order_relaxed);
+        for (int i = 0; i < n && i < kMaxThreads; ++i) {
+            pthread_t t;
+            if (pthread_create(&t, nullptr, &AudioCallbackGraph::workerMain, this) != 0) {
+                printf("[AudioCallbackGraph] Could not start worker %d\n", i);
+                break;
+            }
+            mWorkers.push_back(t);
+        }
+#else
+        if (n > 0) printf("[AudioCallbackGraph] Built without AL_WEB_AUDIO_THREADS; running serially\n");
+#endif
+    }
+
+    int threads() const { return (int)mWorkers.size(); }
+    int size() const { return (int)mNodes.size(); }
+
+    void onAudioCB(AudioIOData& io) override {
+        const int n = (int)mNodes.size();
+        if (n == 0) return;
+        prepare(io);
+
+        // Publish the block: claims restart at node 0 under a new generation
+        mGeneration = (mGeneration + 1) & kGenMask;
+        mIO = &io;
+        mDone.store(0, std::memory_order_relaxed);
+        mClaim.store(mGeneration << kGenShift, std::memory_order_release);
+#ifdef AL_WEB_AUDIO_THREADS
+        if (!mWorkers.empty()) {
+            mWake.fetch_add(1, std::memory_order_release);
+            emscripten_futex_wake(&mWake, (int)mWorkers.size());
+        }
+#endif
+        runNodes(mGeneration);
+        while (mDone.load(std::memory_order_acquire) < n) {
+            // Other threads are finishing their last nodes
+        }
+
+        // Block output: sum of the Mix nodes nothing consumes
+        bool first = true;
+        const int frames = (int)io.framesPerBuffer();
+        for (auto& node : mNodes) {
+            if (node->output != Mix || node->consumers > 0) continue;
+            for (int c = 0; c < (int)io.channelsOut(); ++c) {
+                if (first) std::memcpy(io.outBuffer(c), node->io.outBuffer(c), sizeof(float) * frames);
+                else audio_simd::mix(io.outBuffer(c), node->io.outBuffer(c), 1.0f, frames);
+            }
+            first = false;
+        }
+    }
+
+private:
+    static constexpr int kMaxNodes = 64;
+    static constexpr int kMaxThreads = 8;
+    // mClaim: generation in the high bits, next node index in the low bits
+    static constexpr uint32_t kGenShift = 16;
+    static constexpr uint32_t kGenMask = 0xFFFF;
+    static constexpr uint32_t kIndexMask = 0xFFFF;
+
+    struct Node {
+        AudioCallback* cb = nullptr;
+        std::vector<int> inputs;
+        Output output = Mix;
+        int consumers = 0;
+        int section = -1;
+        AudioIOData io;
+        std::atomic<uint32_t> doneGen{kGenMask + 1};  // Never a real generation
+    };
+
+    // Size every node's buffers like io's (allocates only when that changes)
+    void prepare(AudioIOData& io) {
+        for (auto& node : mNodes) {
+            AudioIOData& d = node->io;
+            if (d.framesPerBuffer() != io.framesPerBuffer()) d.framesPerBuffer(io.framesPerBuffer());
+            if (d.channelsOut() != io.channelsOut()) d.channelsOut(io.channelsOut());
+            if (d.channelsIn() != io.channelsIn()) d.channelsIn(io.channelsIn());
+            if (d.framesPerSecond() != io.framesPerSecond()) d.framesPerSecond(io.framesPerSecond());
+        }
+    }
+
+    // Claim and run nodes until none are left in this generation
+    void runNodes(uint32_t gen) {
+        const uint32_t n = (uint32_t)mNodes.size();
+        for (;;) {
+            uint32_t word = mClaim.load(std::memory_order_acquire);
+            uint32_t index;
+            do {
+                // A late worker must not claim from a newer block
+                if ((word >> kGenShift) != gen) return;
+                index = word & kIndexMask;
+                if (index >= n) return;
+            } while (!mClaim.compare_exchange_weak(word, word + 1, std::memory_order_acq_rel,
+                                                   std::memory_order_acquire));
+            Node& node = *mNodes[index];
+            for (int in : node.inputs) {
+                while (mNodes[in]->doneGen.load(std::memory_order_acquire) != gen) {
+                    // Input is running on another thread
+                }
+            }
+            runNode(node);
+            node.doneGen.store(gen, std::memory_order_release);
+            mDone.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+
+    void runNode(Node& node) {
+        AudioIOData& io = *mIO;
+        AudioIOData& d = node.io;
+        const int frames = (int)io.framesPerBuffer();
+        for (int c = 0; c < (int)io.channelsIn(); ++c) {
+            std::memcpy(d.inBuffer(c), io.inBuffer(c), sizeof(float) * frames);
+        }
+        for (int c = 0; c < (int)io.channelsOut(); ++c) {
+            float* out = d.outBuffer(c);
+            if (node.inputs.empty()) {
+                std::memcpy(out, io.outBuffer(c), sizeof(float) * frames);
+                continue;
+            }
+            std::memcpy(out, mNodes[node.inputs[0]]->io.outBuffer(c), sizeof(float) * frames);
+            for (size_t i = 1; i < node.inputs.size(); ++i) {
+                audio_simd::mix(out, mNodes[node.inputs[i]]->io.outBuffer(c), 1.0f, frames);
+            }
+        }
+        d.frame(0);
+        if (mMonitor && node.section >= 0) {
+            AudioMonitor::Scope t(*mMonitor, node.section);
+            node.cb->onAudioCB(d);
+        } else {
+            node.cb->onAudioCB(d);
+        }
+    }
+
+#ifdef AL_WEB_AUDIO_THREADS
+    static void* workerMain(void* arg) {
+        auto* self = static_cast<AudioCallbackGraph*>(arg);
+        uint32_t seen = self->mWake.load(std::memory_order_acquire);
+        while (!self->mQuit.load(std::memory_order_acquire)) {
+            const uint32_t wake = self->mWake.load(std::memory_order_acquire);
+            if (wake == seen) {
+                emscripten_futex_wait(&self->mWake, seen, INFINITY);
+                continue;
+            }
+            seen = wake;
+            self->runNodes(self->mClaim.load(std::memory_order_acquire) >> kGenShift);
+        }
+        return nullptr;
+    }
+#endif
+
+    void stopWorkers() {
+#ifdef AL_WEB_AUDIO_THREADS
+        if (mWorkers.empty()) return;
+        mQuit.store(true, std::memory_order_release);
+        mWake.fetch_add(1, std::memory_order_release);
+        emscripten_futex_wake(&mWake, (int)mWorkers.size());
+        for (pthread_t t : mWorkers) pthread_join(t, nullptr);
+        mWorkers.clear();
+#endif
+    }
+
+    AudioMonitor* mMonitor;
+    std::vector<std::unique_ptr<Node>> mNodes;
+    AudioIOData* mIO = nullptr;
+    uint32_t mGeneration = 0;  // Audio thread only
+    std::atomic<uint32_t> mClaim{0};
+    std::atomic<int> mDone{0};
+#ifdef AL_WEB_AUDIO_THREADS
+    std::atomic<uint32_t> mWake{0};
+    std::atomic<bool> mQuit{false};
+    std::vector<pthread_t> mWorkers;
+#else
+    std::vector<int> mWorkers;  // Always empty
+#endif
+};
+
+} // namespace al
+
+#endif // AL_WEB_AUDIO_GRAPH_HPP
@@ -0,0 +1,195 @@
+/**
+ * Web Audio Monitor - per-block DSP time against the block deadline
+ *
+ * The worklet's underrun count can't tell slow DSP from late scheduling.
+ * WebApp times every rendered block and compares it with the block's
+ * real-time budget (framesPerBuffer / sampleRate): a block that overruns
+ * its deadline is DSP cost; underruns without overruns are scheduling.
+ *
+ * Time is split into sections. "onSound" and "callbacks" (everything
+ * appended to audioIO() after it) are built in and add up to the block.
+ * Further sections break those down: appendAudioCallback(cb, name) gives
+ * an appended callback its own, and user code can time any stretch of
+ * onSound with a Scope:
+ *
+ *   int reverb = audioMonitor().addSection("reverb");   // main thread
+ *   { auto t = audioMonitor().scope(reverb); mReverb(io); }  // onSound
+ *
+ * Studio reads AudioMonitorTelemetry from the heap next to the worklet
+ * stats (window.allolib.audioMonitor). The block is written by the audio
+ * thread and read without locking, so a read may mix two blocks' values.
+ */
+
+#ifndef AL_WEB_AUDIO_MONITOR_HPP
+#define AL_WEB_AUDIO_MONITOR_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "al/io/al_AudioIO.hpp"
+
+namespace al {
+
+/**
+ * Audio timing telemetry, laid out for JS to read straight from the wasm
+ * heap: every field is a 4-byte uint32 or float, so field n is
+ * HEAPU32/HEAPF32[(ptr >> 2) + n]. Bump kVersion whenever the layout changes.
+ */
+struct AudioMonitorTelemetry {
+    static constexpr uint32_t kVersion = 1;
+    static constexpr int kBins = 12;        // Load histogram, see AudioMonitor::bin()
+    static constexpr int kMaxSections = 8;
+
+    uint32_t version = kVersion;
+    uint32_t blocks = 0;
+    uint32_t overruns = 0;                  // Blocks that took longer than deadlineMs
+    uint32_t framesPerBlock = 0;
+    float deadlineMs = 0.0f;
+    float lastMs = 0.0f;
+    float meanMs = 0.0f;                    // Exponential moving average
+    float peakMs = 0.0f;                    // Since the last reset
+    uint32_t histogram[kBins] = {};         // Blocks by load (time / deadline)
+    uint32_t sections = 0;
+    float sectionMeanMs[kMaxSections] = {};
+    float sectionPeakMs[kMaxSections] = {};
+};
+static_assert(sizeof(AudioMonitorTelemetry) == 37 * 4,
+              "AudioMonitorTelemetry is read by field offset from JS");
+
+class AudioMonitor {
+public:
+    static constexpr int kOnSound = 0;
+    static constexpr int kCallbacks = 1;
+
+    AudioMonitor() {
+        mNames = {"onSound", "callbacks"};
+        mTelemetry.sections = 2;
+    }
+
+    /// Block budget in real time; called by WebApp whenever the config changes
+    void setDeadline(int framesPerBlock, double sampleRate) {
+        mTelemetry.framesPerBlock = uint32_t(framesPerBlock);
+        mTelemetry.deadlineMs = sampleRate > 0 ? float(1000.0 * framesPerBlock / sampleRate) : 0.0f;
+    }
+
+    /// Main thread: new named section; returns -1 when all are taken
+    int addSection(const std::string& name) {
+        if ((int)mNames.size() >= AudioMonitorTelemetry::kMaxSections) return -1;
+        mNames.push_back(name);
+        mTelemetry.sections = uint32_t(mNames.size());
+        return int(mNames.size()) - 1;
+    }
+
+    const std::string& sectionName(int i) const {
+        static const std::string empty;
+        return i >= 0 && i < (int)mNames.size() ? mNames[i] : empty;
+    }
+
+    static double nowMs() {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// Times the enclosing block into a section
+    class Scope {
+    public:
+        Scope(AudioMonitor& m, int section) : mMonitor(m), mSection(section), mStart(nowMs()) {}
+        ~Scope() { mMonitor.addSectionTime(mSection, nowMs() - mStart); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        AudioMonitor& mMonitor;
+        int mSection;
+        double mStart;
+    };
+
+    Scope scope(int section) { return Scope(*this, section); }
+
+    /// Audio thread: accumulate time for a section in the current block
+    void addSectionTime(int section, double ms) {
+        if (section >= 0 && section < AudioMonitorTelemetry::kMaxSections) {
+            mBlockSection[section] += ms;
+        }
+    }
+
+    /// Audio thread: bracket one rendered block
+    void beginBlock() {
+        std::fill(std::begin(mBlockSection), std::end(mBlockSection), 0.0);
+        mBlockStart = nowMs();
+    }
+
+    void endBlock() {
+        AudioMonitorTelemetry& t = mTelemetry;
+        double ms = nowMs() - mBlockStart;
+
+        // Everything after onSound is the appended chain
+        mBlockSection[kCallbacks] = std::max(0.0, ms - mBlockSection[kOnSound]);
+
+        t.blocks++;
+        t.lastMs = float(ms);
+        t.meanMs = t.blocks == 1 ? float(ms) : t.meanMs + kSmoothing * (float(ms) - t.meanMs);
+        t.peakMs = std::max(t.peakMs, float(ms));
+        if (t.deadlineMs > 0.0f) {
+            if (ms > t.deadlineMs) t.overruns++;
+            t.histogram[bin(ms / t.deadlineMs)]++;
+        }
+        for (uint32_t i = 0; i < t.sections; ++i) {
+            float s = float(mBlockSection[i]);
+            t.sectionMeanMs[i] = t.blocks == 1 ? s : t.sectionMeanMs[i] + kSmoothing * (s - t.sectionMeanMs[i]);
+            t.sectionPeakMs[i] = std::max(t.sectionPeakMs[i], s);
+        }
+    }
+
+    /// Histogram bin for a load: 10% steps to 100%, then 100-150%, >150%
+    static int bin(double load) {
+        if (load < 1.0) return std::max(0, int(load * 10.0));
+        return load < 1.5 ? 10 : 11;
+    }
+
+    /// Clear counters, histogram and peaks (keeps sections and deadline)
+    void reset() {
+        AudioMonitorTelemetry fresh;
+        fresh.framesPerBlock = mTelemetry.framesPerBlock;
+        fresh.deadlineMs = mTelemetry.deadlineMs;
+        fresh.sections = mTelemetry.sections;
+        mTelemetry = fresh;
+    }
+
+    const AudioMonitorTelemetry& telemetry() const { return mTelemetry; }
+
+private:
+    static constexpr float kSmoothing = 0.05f;
+
+    AudioMonitorTelemetry mTelemetry;
+    std::vector<std::string> mNames;
+    double mBlockSection[AudioMonitorTelemetry::kMaxSections] = {};
+    double mBlockStart = 0.0;
+};
+
+/**
+ * Forwards to an AudioCallback and times it into its own monitor section.
+ * Created by WebApp::appendAudioCallback.
+ */
+class TimedAudioCallback : public AudioCallback {
+public:
+    TimedAudioCallback(AudioCallback& inner, AudioMonitor& monitor, int section)
+        : mInner(inner), mMonitor(monitor), mSection(section) {}
+
+    void onAudioCB(AudioIOData& io) override {
+        AudioMonitor::Scope t(mMonitor, mSection);
+        mInner.onAudioCB(io);
+    }
+
+private:
+    AudioCallback& mInner;
+    AudioMonitor& mMonitor;
+    int mSection;
+};
+
+} // namespace al
+
+#endif // AL_WEB_AUDIO_MONITOR_HPP
@@ -0,0 +1,135 @@
+/**
+ * Web Audio SIMD - block kernels for the audio I/O path
+ *
+ * zero / interleave / deinterleave / gain / mul / mix / mixRamp over float
+ * blocks, four lanes at a time with wasm SIMD128 when built with -msimd128
+ * (the default for libal_web and compile.sh) and a scalar loop otherwise.
+ * WebApp uses them to move AudioIO's planar buffers into the worklet's
+ * interleaved block; user code may call them from onSound on its own
+ * buffers.
+ *
+ * Usage:
+ *   float* ch[2] = { io.outBuffer(0), io.outBuffer(1) };
+ *   audio_simd::interleave(out, ch, 2, io.framesPerBuffer());
+ *   audio_simd::mix(io.outBuffer(0), reverbL, 0.3f, io.framesPerBuffer());
+ *
+ * Pointers need no particular alignment; counts need not be multiples of 4.
+ */
+
+#ifndef AL_WEB_AUDIO_SIMD_HPP
+#define AL_WEB_AUDIO_SIMD_HPP
+
+#include <cstring>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+namespace al {
+namespace audio_simd {
+
+/// dst[0..n) = 0
+inline void zero(float* dst, int n) {
+    std::memset(dst, 0, sizeof(float) * (n > 0 ? n : 0));
+}
+
+/// dst[i] *= g
+inline void gain(float* dst, float g, int n) {
+    int i = 0;
+#if defined(__wasm_simd128__)
+    const v128_t vg = wasm_f32x4_splat(g);
+    for (; i + 4 <= n; i += 4) {
+        wasm_v128_store(dst + i, wasm_f32x4_mul(wasm_v128_load(dst + i), vg));
+    }
+#endif
+    for (; i < n; ++i) dst[i] *= g;
+}
+
+/// dst[i] *= src[i]
+inline void mul(float* dst, const float* src, int n) {
+    int i = 0;
+#if defined(__wasm_simd128__)
+    for (; i + 4 <= n; i += 4) {
+        wasm_v128_store(dst + i, wasm_f32x4_mul(wasm_v128_load(dst + i), wasm_v128_load(src + i)));
+    }
+#endif
+    for (; i < n; ++i) dst[i] *= src[i];
+}
+
+/// dst[i] += src[i] * g
+inline void mix(float* dst, const float* src, float g, int n) {
+    int i = 0;
+#if defined(__wasm_simd128__)
+    const v128_t vg = wasm_f32x4_splat(g);
+    for (; i + 4 <= n; i += 4) {
+        v128_t acc = wasm_v128_load(dst + i);
+        acc = wasm_f32x4_add(acc, wasm_f32x4_mul(wasm_v128_load(src + i), vg));
+        wasm_v128_store(dst + i, acc);
+    }
+#endif
+    for (; i < n; ++i) dst[i] += src[i] * g;
+}
+
+/// dst[i] += src[i] * (g0 + (g1 - g0) * i / n): mix with a linear gain ramp
+inline void mixRamp(float* dst, const float* src, float g0, float g1, int n) {
+    if (n <= 0) return;
+    const float dg = (g1 - g0) / float(n);
+    int i = 0;
+#if defined(__wasm_simd128__)
+    v128_t vg = wasm_f32x4_make(g0, g0 + dg, g0 + 2 * dg, g0 + 3 * dg);
+    const v128_t vstep = wasm_f32x4_splat(4 * dg);
+    for (; i + 4 <= n; i += 4) {
+        v128_t acc = wasm_v128_load(dst + i);
+        acc = wasm_f32x4_add(acc, wasm_f32x4_mul(wasm_v128_load(src + i), vg));
+        wasm_v128_store(dst + i, acc);
+        vg = wasm_f32x4_add(vg, vstep);
+    }
+#endif
+    for (; i < n; ++i) dst[i] += src[i] * (g0 + dg * float(i));
+}
+
+/// Planar channels → interleaved frames: dst[f * channels + c] = src[c][f]
+inline void interleave(float* dst, const float* const* src, int channels, int frames) {
+    int f = 0;
+#if defined(__wasm_simd128__)
+    if (channels == 2) {
+        // Stereo (the common case): zip four L and four R into two vectors
+        const float* l = src[0];
+        const float* r = src[1];
+        for (; f + 4 <= frames; f += 4) {
+            v128_t vl = wasm_v128_load(l + f);
+            v128_t vr = wasm_v128_load(r + f);
+            wasm_v128_store(dst + 2 * f, wasm_i32x4_shuffle(vl, vr, 0, 4, 1, 5));
+            wasm_v128_store(dst + 2 * f + 4, wasm_i32x4_shuffle(vl, vr, 2, 6, 3, 7));
+        }
+    }
+#endif
+    for (; f < frames; ++f) {
+        for (int c = 0; c < channels; ++c) dst[f * channels + c] = src[c][f];
+    }
+}
+
+/// Interleaved frames → planar channels: dst[c][f] = src[f * channels + c]
+inline void deinterleave(float* const* dst, const float* src, int channels, int frames) {
+    int f = 0;
+#if defined(__wasm_simd128__)
+    if (channels == 2) {
+        float* l = dst[0];
+        float* r = dst[1];
+        for (; f + 4 <= frames; f += 4) {
+            v128_t a = wasm_v128_load(src + 2 * f);      // L0 R0 L1 R1
+            v128_t b = wasm_v128_load(src + 2 * f + 4);  // L2 R2 L3 R3
+            wasm_v128_store(l + f, wasm_i32x4_shuffle(a, b, 0, 2, 4, 6));
+            wasm_v128_store(r + f, wasm_i32x4_shuffle(a, b, 1, 3, 5, 7));
+        }
+    }
+#endif
+    for (; f < frames; ++f) {
+        for (int c = 0; c < channels; ++c) dst[c][f] = src[f * channels + c];
+    }
+}
+
+} // namespace audio_simd
+} // namespace al
+
+#endif // AL_WEB_AUDIO_SIMD_HPP
@@ -0,0 +1,187 @@
+/**
+ * Web Audio Worklet - state handoff between the main and audio threads
+ *
+ * A library built with ALLOLIB_AUDIO_WORKLET=ON (AL_WEB_AUDIO_WORKLET) runs
+ * AudioIO::callback and the appended AudioCallback chain on the Web Audio
+ * rendering thread via Emscripten Wasm Audio Worklets, so onSound no longer
+ * waits behind onDraw, ASYNCIFY loaders or the UI. onAnimate/onDraw stay on
+ * the main thread, and nothing here may block either side.
+ *
+ * LockFreeSnapshot<T> is a triple buffer: the writer publishes a whole T,
+ * the reader always sees the most recent complete one, neither ever waits.
+ * AudioParamSnapshot applies it to parameters. WebApp publishes it once per
+ * frame after onAnimate(), so onSound reads the values of one frame together
+ * instead of racing individual Parameter writes from the GUI or presets.
+ * WebApp latches it once per audio block, so every read() in a block sees
+ * the same values, and ramp() interpolates from the previous block's value
+ * across the block to avoid zipper noise when a slider is dragged.
+ *
+ * Usage:
+ *   // onCreate() (main thread)
+ *   mFreqIdx = audioParams().add(freq);
+ *   mGainIdx = audioParams().add(gain);
+ *
+ *   // onSound() (audio thread in worklet builds, main thread otherwise)
+ *   const auto& p = audioParams().read();
+ *   osc.freq(p[mFreqIdx]);
+ *   auto g = audioParams().ramp(mGainIdx);
+ *   while (io()) io.out(0) = osc() * g.next();
+ *
+ * Both work unchanged in the default build, where onSound runs on the main
+ * thread between frames.
+ */
+
+#ifndef AL_WEB_AUDIO_WORKLET_HPP
+#define AL_WEB_AUDIO_WORKLET_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "al/ui/al_Parameter.hpp"
+
+namespace al {
+
+/**
+ * Single-writer / single-reader triple buffer. write() and read() are
+ * wait-free; the reader keeps its slot until a newer one is published.
+ */
+template <typename T>
+class LockFreeSnapshot {
+public:
+    /// Writer: slot to fill before publish()
+    T& back() { return mSlots[mBack]; }
+
+    /// Writer: make back() the latest snapshot
+    void publish() {
+        mBack = mShared.exchange(mBack | kFresh, std::memory_order_acq_rel) & kIndex;
+    }
+
+    /// Writer: copy a value in and publish it
+    void write(const T& value) {
+        back() = value;
+        publish();
+    }
+
+    /// Reader: latest published snapshot, stable until the next read()
+    const T& read() {
+        if (mShared.load(std::memory_order_relaxed) & kFresh) {
+            mFront = mShared.exchange(mFront, std::memory_order_acq_rel) & kIndex;
+        }
+        return mSlots[mFront];
+    }
+
+private:
+    static constexpr int kIndex = 3;
+    static constexpr int kFresh = 4;
+
+    std::array<T, 3> mSlots{};
+    std::atomic<int> mShared{1};
+    int mBack = 0;   // Writer-owned
+    int mFront = 2;  // Reader-owned
+};
+
+/**
+ * Per-frame parameter values for onSound. Sources are added and published
+ * on the main thread; beginBlock(), read() and ramp() are the audio
+ * thread's side.
+ */
+class AudioParamSnapshot {
+public:
+    static constexpr int kMaxParams = 64;
+    using Values = std::array<float, kMaxParams>;
+
+    /// Linear ramp across one block: value(frame) or next() per frame
+    struct Ramp {
+        float start = 0.0f;
+        float step = 0.0f;
+        float value(int frame) const { return start + step * float(frame); }
+        float next() {
+            float v = start;
+            start += step;
+            return v;
+        }
+    };
+
+    /// Track a parameter; returns its index into read(), or -1 when full
+    int add(Parameter& p) {
+        return addSource([&p]() { return p.get(); });
+    }
+    int add(ParameterInt& p) {
+        return addSource([&p]() { return float(p.get()); });
+    }
+    /// Track any main-thread value (e.g. animation state)
+    int addSource(std::function<float()> source) {
+        if (mSources.size() >= kMaxParams) {
+            printf("[AudioParamSnapshot] Limit of %d values reached\n", kMaxParams);
+            return -1;
+        }
+        mSources.push_back(std::move(source));
+        int index = int(mSources.size()) - 1;
+        // Visible from the next read() even before the first frame
+        publish();
+        // Counted only once a snapshot holds its value (see beginBlock)
+        mCount.store(int(mSources.size()), std::memory_order_release);
+        return index;
+    }
+
+    /// Main thread: sample every source into a new snapshot
+    void publish() {
+        if (mSources.empty()) return;
+        Values& v = mSnapshot.back();
+        for (size_t i = 0; i < mSources.size(); ++i) v[i] = mSources[i]();
+        mSnapshot.publish();
+    }
+
+    /**
+     * Audio thread, once per block before onSound (WebApp does this):
+     * latch the latest snapshot for read() and ramp()
+     */
+    void beginBlock(int frames) {
+        // Count first: the snapshot read after it holds every counted value
+        const int count = mCount.load(std::memory_order_acquire);
+        mPrevious = mCurrent;
+        mCurrent = mSnapshot.read();
+        // Values added since the last block start where they are, not at 0
+        for (int i = mLatched; i < count; ++i) mPrevious[i] = mCurrent[i];
+        mLatched = count;
+        mInvFrames = frames > 0 ? 1.0f / float(frames) : 0.0f;
+    }
+
+    /// Audio thread: values latched by beginBlock(), indexed by add()
+    const Values& read() const { return mCurrent; }
+
+    /// Audio thread: previous block's value ramping to this block's
+    Ramp ramp(int index) const {
+        Ramp r;
+        if (index < 0 || index >= kMaxParams) return r;
+        r.start = mPrevious[index];
+        r.step = (mCurrent[index] - mPrevious[index]) * mInvFrames;
+        return r;
+    }
+
+    size_t size() const { return mSources.size(); }
+
+    /// Main thread, with audio stopped
+    void clear() {
+        mSources.clear();
+        mCount.store(0, std::memory_order_release);
+        mLatched = 0;
+    }
+
+private:
+    std::vector<std::function<float()>> mSources;
+    LockFreeSnapshot<Values> mSnapshot;
+    std::atomic<int> mCount{0};
+    // Audio-thread side
+    Values mCurrent{};
+    Values mPrevious{};
+    int mLatched = 0;
+    float mInvFrames = 0.0f;
+};
+
+} // namespace al
+
+#endif // AL_WEB_AUDIO_WORKLET_HPP
@@ -10,6 +10,7 @@
  * - Smooth LOD transitions
  * - Integration with QualityManager settings
  * - Texture LOD integration for automatic resolution switching
+ * - Per-cluster LOD for very large meshes (ClusterLODMesh, drawClusterLOD)
  *
  * Usage:
  *   // Enable in onCreate - that's it!
@@ -34,8 +35,16 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
 
 #include "al_WebLOD.hpp"
+#include "al_WebClusterLOD.hpp"
+#include "al_WebProfiler.hpp"
 #include "al/graphics/al_Mesh.hpp"
 #include "al/math/al_Vec.hpp"
 #include "al/math/al_Matrix4.hpp"
@@ -68,11 +77,43 @@ struct MeshIdentityHash {
  */
 struct CachedLODMesh {
     LODMesh lodMesh;
-    bool generated = false;
+    bool generated = false;      // All levels built (the source is drawn until then)
+    bool building = false;       // Levels being built on the job pool
     float boundingSphereRadius = 1.0f;
     Vec3f boundingCenter;
 };
 
+/**
+ * Per-frame LOD telemetry, laid out for JS to read straight from the wasm
+ * heap: every field is a 4-byte uint32 or float, so field n is
+ * HEAPU32/HEAPF32[(ptr >> 2) + n]. Holds the last completed frame.
+ * Bump kVersion whenever the layout changes.
+ */
+struct LODTelemetry {
+    static constexpr uint32_t kVersion = 1;
+    static constexpr int kMaxLevels = 16;
+    static constexpr int kTextureLevels = 8;
+
+    uint32_t version = kVersion;
+    uint32_t frame = 0;
+    uint32_t triangles = 0;              // Submitted (needs enableStats)
+    uint32_t meshes = 0;                 // selectMesh/selectClusters calls
+    uint32_t objectsDrawn = 0;           // LODGroup objects (recordCulling)
+    uint32_t objectsFrustumCulled = 0;
+    uint32_t objectsOccluded = 0;
+    uint32_t meshesUnloaded = 0;         // Beyond the unload distance
+    uint32_t levelTriangles[kMaxLevels] = {};  // selectMesh triangles by level
+    uint32_t levelDraws[kMaxLevels] = {};
+    float generationMs = 0.0f;           // LOD generation this frame
+    uint32_t pendingGenerations = 0;
+    uint32_t cachedMeshes = 0;
+    uint32_t cacheBytes = 0;             // CPU memory of cached LOD levels
+    uint32_t textureLevels[kTextureLevels] = {};  // getTextureLODLevel results
+    uint32_t triangleBudget = 0;
+    float bias = 1.0f;
+};
+static_assert(sizeof(LODTelemetry) == 54 * 4, "LODTelemetry is read by field offset from JS");
+
 /**
  * LOD selection mode - like Unreal's options
  */
@@ -139,6 +180,11 @@ public:
         mTextureResolutions = {4096, 2048, 1024, 512, 256, 128};
     }
 
+    // Chains still building on the job pool complete into this manager
+    ~AutoLODManager() {
+        for (auto& job : mGenerationJobs) job.cancel();
+    }
+
     // =========================================================================
     // Enable/Disable
     // =========================================================================
@@ -204,6 +250,17 @@ public:
     void setTriangleBudget(int budget) { mTriangleBudget = std::max(1000, budget); }
     int triangleBudget() const { return mTriangleBudget; }
 
+    /**
+     * TriangleBudget mode: fraction by which the solver favours each
+     * object's previous level, so near-tie objects don't pop every frame
+     */
+    void setBudgetHysteresis(float h) { mBudgetHysteresis = std::max(0.0f, std::min(h, 0.9f)); }
+    float budgetHysteresis() const { return mBudgetHysteresis; }
+
+    /// Triangles and summed pixel error of the last budget solution
+    int budgetTriangles() const { return mBudgetSolvedTriangles; }
+    float budgetError() const { return mBudgetSolvedError; }
+
     // Screen error threshold in pixels (for ScreenError mode)
     void setScreenErrorThreshold(float pixels) { mScreenErrorThreshold = std::max(0.5f, pixels); }
     float screenErrorThreshold() const { return mScreenErrorThreshold; }
@@ -274,7 +331,7 @@ public:
      * @return LOD level index (0 = highest quality)
      */
     int getTextureLODLevel(float distance, int numLevels = -1) const {
-        if (!mTextureLODEnabled) return 0;  // Always highest quality if disabled
+        if (!mTextureLODEnabled) return countTextureLevel(0);  // Always highest quality if disabled
 
         int maxLevel = (numLevels > 0) ? numLevels - 1 : (int)mTextureDistances.size();
 
@@ -283,10 +340,10 @@ public:
 
         for (size_t i = 0; i < mTextureDistances.size(); i++) {
             if (effectiveDistance < mTextureDistances[i]) {
-                return std::min((int)i, maxLevel);
+                return countTextureLevel(std::min((int)i, maxLevel));
             }
         }
-        return maxLevel;
+        return countTextureLevel(maxLevel);
     }
 
     /**
@@ -434,6 +491,8 @@ public:
     // Called each frame to adjust quality if needed
     void adaptQuality() {
         if (!mAdaptiveEnabled) return;
+        // The budget solver fixes geometry cost directly; nudging bias too oscillates
+        if (mSelectionMode == LODSelectionMode::TriangleBudget) return;
 
         // If frame time is too high, increase LOD bias
         if (mFrameTime > mTargetFrameTime * 1.2f) {
@@ -449,9 +508,34 @@ public:
     // Cache Management
     // =========================================================================
 
-    void clearCache() { mCache.clear(); }
+    void clearCache() {
+        for (auto& job : mGenerationJobs) job.cancel();
+        mGenerationJobs.clear();
+        mCache.clear();
+        mPendingGeneration.clear();
+        mBudgetRequests.clear();
+        mBudgetOccurrences.clear();
+        mBudgetLevels.clear();
+    }
     size_t cacheSize() const { return mCache.size(); }
 
+    // =========================================================================
+    // Background Generation
+    // =========================================================================
+
+    /**
+     * Milliseconds per frame spent simplifying newly seen meshes. Levels are
+     * built one per step, and at least one step runs per frame, so a single
+     * huge level can still overrun. 0 builds every level as soon as a mesh
+     * is first drawn. With JobSystem workers (threaded builds) chains are
+     * built on the pool instead and the budget only gates that.
+     */
+    void setGenerationBudget(float ms) { mGenerationBudgetMs = std::max(0.0f, ms); }
+    float generationBudget() const { return mGenerationBudgetMs; }
+
+    /// Meshes still drawn at full resolution while their levels are built
+    size_t pendingGenerations() const { return mPendingGeneration.size(); }
+
     // =========================================================================
     // Statistics
     // =========================================================================
@@ -459,16 +543,44 @@ public:
     void enableStats(bool e = true) { mStatsEnabled = e ? 1 : 0; }
     bool statsEnabled() const { return mStatsEnabled != 0; }
 
+    // Called once per frame by WebApp; also restarts the generation budget
+    // and solves the triangle budget from the frame just drawn
     void resetFrameStats() {
+        if (!mBudgetRequests.empty()) solveTriangleBudget();
+        mBudgetRequests.clear();
+        mBudgetOccurrences.clear();
+        publishTelemetry();
+
         mTotalTriangles = 0;
         mMeshCount = 0;
         mCurrentTriangles = 0;
+        mGenerationSpentMs = 0.0f;
+        mGenerationStepped = false;
+        mObjectsDrawn = 0;
+        mObjectsFrustumCulled = 0;
+        mObjectsOccluded = 0;
     }
 
     int frameTriangles() const { return mTotalTriangles; }
     int frameMeshes() const { return mMeshCount; }
+
+    /// Fold an updated LODGroup's culling results into this frame's stats
+    void recordCulling(const LODGroup& group) {
+        mObjectsDrawn += group.drawnCount();
+        mObjectsFrustumCulled += group.frustumCulledCount();
+        mObjectsOccluded += group.occludedCount();
+        if (mStatsEnabled) mTotalTriangles += group.totalTriangles();
+    }
+
+    int frameObjectsDrawn() const { return mObjectsDrawn; }
+    int frameObjectsCulled() const { return mObjectsFrustumCulled + mObjectsOccluded; }
+    int frameObjectsFrustumCulled() const { return mObjectsFrustumCulled; }
+    int frameObjectsOccluded() const { return mObjectsOccluded; }
     int currentTriangles() const { return mCurrentTriangles; }
 
+    /// Stats of the last completed frame, published by resetFrameStats()
+    const LODTelemetry& telemetry() const { return mTelemetry; }
+
     // =========================================================================
     // LOD Selection (main entry point)
     // =========================================================================
@@ -496,6 +608,7 @@ public:
         // Check for unload (return empty mesh)
         if (mUnloadEnabled && rawDistance > mUnloadDistance * mDistanceScale) {
             // Don't count triangles for unloaded meshes
+            mLiveTelemetry.meshesUnloaded++;
             return mEmptyMesh;
         }
 
@@ -515,14 +628,21 @@ public:
 
         CachedLODMesh* cached;
         if (it == mCache.end()) {
+            AL_PROFILE_ZONE("LOD generate");
             auto& entry = mCache[id];
-            generateLOD(mesh, entry);
+            startLOD(mesh, entry);
+            if (mGenerationBudgetMs <= 0.0f || !entry.lodMesh.generating()) {
+                finishLOD(entry);
+            } else {
+                mPendingGeneration.push_back(id);
+            }
             cached = &entry;
         } else {
             cached = &it->second;
         }
+        advanceGeneration();
 
-        // If generation failed, return original
+        // If generation failed or is still running, return original
         if (!cached->generated || !cached->lodMesh.ready()) {
             if (mStatsEnabled) {
                 int tris = getTriangleCount(mesh);
@@ -547,6 +667,38 @@ public:
             int tris = getTriangleCount(selected);
             mTotalTriangles += tris;
             mCurrentTriangles += tris;
+            int slot = std::max(0, std::min(lodLevel, LODTelemetry::kMaxLevels - 1));
+            mLiveTelemetry.levelTriangles[slot] += tris;
+            mLiveTelemetry.levelDraws[slot]++;
+        }
+        return selected;
+    }
+
+    /**
+     * Pick the cluster cut of a ClusterLODMesh whose per-cluster projected
+     * error stays within the screen error threshold (scaled by bias)
+     */
+    const Mesh& selectClusters(ClusterLODMesh& clusters, const Matrix4f& modelMatrix) {
+        if (mStatsEnabled) mMeshCount++;
+
+        // Camera into model space; columns are the scaled basis vectors
+        Vec3f axisX(modelMatrix[0], modelMatrix[1], modelMatrix[2]);
+        Vec3f axisY(modelMatrix[4], modelMatrix[5], modelMatrix[6]);
+        Vec3f axisZ(modelMatrix[8], modelMatrix[9], modelMatrix[10]);
+        Vec3f d = mCameraPos - Vec3f(modelMatrix[12], modelMatrix[13], modelMatrix[14]);
+        auto project = [&d](const Vec3f& axis) {
+            float len2 = dot(axis, axis);
+            return len2 > 0.0f ? dot(d, axis) / len2 : 0.0f;
+        };
+        Vec3f localCamera(project(axisX), project(axisY), project(axisZ));
+
+        float tanHalfFOV = tanf(mFOV * 0.5f * 3.14159f / 180.0f);
+        float pixelScale = mScreenHeight / (2.0f * tanHalfFOV) * mBias;
+        const Mesh& selected = clusters.select(localCamera, pixelScale, mScreenErrorThreshold);
+
+        if (mStatsEnabled) {
+            mTotalTriangles += clusters.selectedTriangles();
+            mCurrentTriangles += clusters.selectedTriangles();
         }
         return selected;
     }
@@ -562,6 +714,52 @@ public:
         return mDistances.size() - 1;
     }
 
+    // =========================================================================
+    // Batch Selection
+    // =========================================================================
+
+    /**
+     * Select LOD levels for many instances at once.
+     * @param centerX,centerY,centerZ World-space bounding sphere centers (SoA)
+     * @param radius World-space bounding sphere radii
+     * @param count Number of instances
+     * @param levels Output level index per instance
+     *
+     * Matches the per-mesh selection for the current mode, with TriangleBudget
+     * evaluated as ScreenSize (what selectByBudget does while under budget).
+     * Each mode reduces to one metric per instance compared against a
+     * per-level table, evaluated four lanes at a time with wasm SIMD128 when
+     * built with -msimd128.
+     */
+    void selectLevels(const float* centerX, const float* centerY, const float* centerZ,
+                      const float* radius, size_t count, int* levels) const {
+        BatchTables tables = batchTables();
+        size_t i = 0;
+#if defined(__wasm_simd128__)
+        i = selectLevelsSimd(centerX, centerY, centerZ, radius, count, levels, tables);
+#endif
+        for (; i < count; i++) {
+            float dx = centerX[i] - mCameraPos.x;
+            float dy = centerY[i] - mCameraPos.y;
+            float dz = centerZ[i] - mCameraPos.z;
+            float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+            float metric = tables.useRatio
+                ? radius[i] / std::max(distance, 0.001f) * tables.scale
+                : distance * tables.scale;
+
+            // Same leading-failure count as the SIMD lanes (branch-free inner loop)
+            int level = 0;
+            bool searching = true;
+            for (int l = 0; l < tables.count; l++) {
+                searching = searching && !(metric < tables.table[l]);
+                level += searching;
+            }
+            if (level == tables.count) level = mNumLevels - 1;
+            if (distance < tables.minFullQuality) level = 0;
+            levels[i] = level;
+        }
+    }
+
     // =========================================================================
     // Apply settings from frontend (called via JS bridge)
     // =========================================================================
@@ -599,11 +797,48 @@ private:
         return mesh.vertices().size() / 3;
     }
 
-    void generateLOD(const Mesh& mesh, CachedLODMesh& cached) {
-        cached.lodMesh.generate(mesh, mNumLevels, mReductionFactor);
-        if (!mDistances.empty()) {
-            cached.lodMesh.setDistances(mDistances);
+    int countTextureLevel(int level) const {
+        int slot = std::max(0, std::min(level, LODTelemetry::kTextureLevels - 1));
+        mLiveTelemetry.textureLevels[slot]++;
+        return level;
+    }
+
+    static size_t meshBytes(const Mesh& m) {
+        return m.vertices().size() * sizeof(Vec3f) + m.normals().size() * sizeof(Vec3f) +
+               m.indices().size() * sizeof(unsigned int);
+    }
+
+    // Snapshot the frame that just ended into mTelemetry for JS, then start
+    // accumulating the next one. Cache memory skips LOD 0, a copy of the
+    // caller's own mesh.
+    void publishTelemetry() {
+        LODTelemetry& t = mLiveTelemetry;
+        t.frame = mTelemetry.frame + 1;
+        t.triangles = (uint32_t)mTotalTriangles;
+        t.meshes = (uint32_t)mMeshCount;
+        t.objectsDrawn = (uint32_t)mObjectsDrawn;
+        t.objectsFrustumCulled = (uint32_t)mObjectsFrustumCulled;
+        t.objectsOccluded = (uint32_t)mObjectsOccluded;
+        t.generationMs = mGenerationSpentMs;
+        t.pendingGenerations = (uint32_t)mPendingGeneration.size();
+        t.cachedMeshes = (uint32_t)mCache.size();
+        size_t bytes = 0;
+        for (const auto& pair : mCache) {
+            const LODMesh& lod = pair.second.lodMesh;
+            for (int l = 1; l < lod.numLevels(); l++) bytes += meshBytes(lod.level(l));
         }
+        t.cacheBytes = (uint32_t)std::min<size_t>(bytes, UINT32_MAX);
+        t.triangleBudget = (uint32_t)std::max(0, mTriangleBudget);
+        t.bias = mBias;
+
+        mTelemetry = t;
+        mLiveTelemetry = LODTelemetry();
+    }
+
+    // Copy the source and compute bounds; levels are built by generateStep()
+    // unless LODMesh found them in its disk cache
+    void startLOD(const Mesh& mesh, CachedLODMesh& cached) {
+        cached.lodMesh.beginGenerate(mesh, mNumLevels, mReductionFactor);
 
         // Calculate bounding sphere
         Vec3f minB(1e10, 1e10, 1e10), maxB(-1e10, -1e10, -1e10);
@@ -617,10 +852,169 @@ private:
         }
         cached.boundingCenter = (minB + maxB) * 0.5f;
         cached.boundingSphereRadius = (maxB - minB).mag() * 0.5f;
+    }
 
+    void finishLOD(CachedLODMesh& cached) {
+        cached.lodMesh.generateRemaining();
+        if (!mDistances.empty()) {
+            cached.lodMesh.setDistances(mDistances);
+        }
         cached.generated = true;
     }
 
+    // Run generation steps, oldest mesh first, until this frame's budget is spent
+    void advanceGeneration() {
+        if (JobSystem::instance().threads() > 0) {
+            submitGeneration();
+            return;
+        }
+
+        using Clock = std::chrono::steady_clock;
+        while (!mPendingGeneration.empty() &&
+               (!mGenerationStepped || mGenerationSpentMs < mGenerationBudgetMs)) {
+            auto it = mCache.find(mPendingGeneration.front());
+            if (it == mCache.end() || it->second.generated) {
+                mPendingGeneration.erase(mPendingGeneration.begin());
+                continue;
+            }
+
+            AL_PROFILE_ZONE("LOD generate");
+            auto start = Clock::now();
+            bool more = it->second.lodMesh.generateStep();
+            mGenerationSpentMs += std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+            mGenerationStepped = true;
+
+            if (!more) {
+                finishLOD(it->second);
+                mPendingGeneration.erase(mPendingGeneration.begin());
+            }
+        }
+    }
+
+    // Threaded builds: build each pending chain on the job pool. The entry's
+    // LODMesh moves into the job and back when it completes, so the cache
+    // never holds a mesh a worker is writing; the source is drawn meanwhile.
+    void submitGeneration() {
+        mGenerationJobs.erase(std::remove_if(mGenerationJobs.begin(), mGenerationJobs.end(),
+                                             [](const JobFuture<void>& job) { return job.ready(); }),
+                              mGenerationJobs.end());
+        for (const MeshIdentity& id : mPendingGeneration) {
+            auto found = mCache.find(id);
+            if (found == mCache.end()) continue;
+            CachedLODMesh& cached = found->second;
+            if (cached.generated || cached.building) continue;
+            cached.building = true;
+            auto staged = std::make_shared<LODMesh>(std::move(cached.lodMesh));
+            mGenerationJobs.push_back(JobSystem::instance().submit(
+                [staged] { staged->generateRemaining(); },
+                [this, id, staged] {
+                    auto it = mCache.find(id);
+                    if (it != mCache.end() && it->second.building) {
+                        it->second.lodMesh = std::move(*staged);
+                        it->second.building = false;
+                        finishLOD(it->second);
+                    }
+                    mPendingGeneration.erase(std::remove(mPendingGeneration.begin(),
+                                                         mPendingGeneration.end(), id),
+                                             mPendingGeneration.end());
+                }));
+        }
+    }
+
+    /**
+     * Per-level thresholds for selectLevels(): level = first i where
+     * metric < table[i], else the last level
+     */
+    struct BatchTables {
+        float table[16];
+        int count = 0;
+        float scale = 1.0f;
+        bool useRatio = false;          // metric from radius / distance
+        float minFullQuality = 0.0f;
+    };
+
+    BatchTables batchTables() const {
+        BatchTables t;
+        t.minFullQuality = mMinFullQualityDistance * mDistanceScale;
+        float tanHalfFOV = tanf(mFOV * 0.5f * 3.14159f / 180.0f);
+        int maxCount = std::min(mNumLevels, 16);
+
+        switch (mSelectionMode) {
+            case LODSelectionMode::Distance:
+                // distance * bias / distanceScale < mDistances[i]
+                t.scale = mBias / mDistanceScale;
+                t.count = std::min((int)mDistances.size(), maxCount);
+                for (int i = 0; i < t.count; i++) t.table[i] = mDistances[i];
+                break;
+
+            case LODSelectionMode::ScreenError: {
+                // radius * r^i * pixelsPerUnit * bias < threshold, solved for radius / distance
+                t.useRatio = true;
+                float pixelScale = mScreenHeight / (2.0f * tanHalfFOV) * mBias;
+                t.count = maxCount;
+                for (int i = 0; i < t.count; i++) {
+                    float levelScale = pixelScale * powf(mReductionFactor, i);
+                    t.table[i] = levelScale > 0.0f ? mScreenErrorThreshold / levelScale : 1e30f;
+                }
+                break;
+            }
+
+            case LODSelectionMode::ScreenSize:
+            case LODSelectionMode::TriangleBudget:
+                // screenFraction > threshold[i], negated so every mode tests "<"
+                t.useRatio = true;
+                t.scale = -mDistanceScale / (2.0f * tanHalfFOV * mBias);
+                t.count = std::min((int)mScreenSizeThresholds.size(), maxCount);
+                for (int i = 0; i < t.count; i++) t.table[i] = -mScreenSizeThresholds[i];
+                break;
+        }
+        return t;
+    }
+
+#if defined(__wasm_simd128__)
+    // Four instances per iteration; returns how many were handled
+    size_t selectLevelsSimd(const float* centerX, const float* centerY, const float* centerZ,
+                            const float* radius, size_t count, int* levels,
+                            const BatchTables& t) const {
+        const v128_t camX = wasm_f32x4_splat(mCameraPos.x);
+        const v128_t camY = wasm_f32x4_splat(mCameraPos.y);
+        const v128_t camZ = wasm_f32x4_splat(mCameraPos.z);
+        const v128_t scale = wasm_f32x4_splat(t.scale);
+        const v128_t minDistance = wasm_f32x4_splat(0.001f);
+        const v128_t minFullQuality = wasm_f32x4_splat(t.minFullQuality);
+        const v128_t tableCount = wasm_i32x4_splat(t.count);
+        const v128_t lastLevel = wasm_i32x4_splat(mNumLevels - 1);
+        const v128_t zero = wasm_i32x4_splat(0);
+
+        size_t n = count & ~(size_t)3;
+        for (size_t i = 0; i < n; i += 4) {
+            v128_t dx = wasm_f32x4_sub(wasm_v128_load(centerX + i), camX);
+            v128_t dy = wasm_f32x4_sub(wasm_v128_load(centerY + i), camY);
+            v128_t dz = wasm_f32x4_sub(wasm_v128_load(centerZ + i), camZ);
+            v128_t distance = wasm_f32x4_sqrt(wasm_f32x4_add(
+                wasm_f32x4_add(wasm_f32x4_mul(dx, dx), wasm_f32x4_mul(dy, dy)),
+                wasm_f32x4_mul(dz, dz)));
+            v128_t metric = t.useRatio
+                ? wasm_f32x4_mul(wasm_f32x4_div(wasm_v128_load(radius + i),
+                                                wasm_f32x4_max(distance, minDistance)), scale)
+                : wasm_f32x4_mul(distance, scale);
+
+            // Count leading failures: lanes stay "searching" (-1) until a level passes
+            v128_t searching = wasm_i32x4_splat(-1);
+            v128_t level = zero;
+            for (int l = 0; l < t.count; l++) {
+                v128_t pass = wasm_f32x4_lt(metric, wasm_f32x4_splat(t.table[l]));
+                searching = wasm_v128_andnot(searching, pass);
+                level = wasm_i32x4_sub(level, searching);
+            }
+            level = wasm_v128_bitselect(lastLevel, level, wasm_i32x4_eq(level, tableCount));
+            level = wasm_v128_bitselect(zero, level, wasm_f32x4_lt(distance, minFullQuality));
+            wasm_v128_store(levels + i, level);
+        }
+        return n;
+    }
+#endif
+
     /**
      * Select LOD level based on current mode
      */
@@ -711,21 +1105,99 @@ private:
 
     /**
      * Budget-based selection
-     * Tries to stay within triangle budget
+     *
+     * Each draw is recorded with its screen-space error scale and gets the
+     * level the solver assigned to the same draw (mesh + nth draw of it) last
+     * frame; draws the solver hasn't seen yet use screen-size selection.
      */
     int selectByBudget(CachedLODMesh* cached, float distance, float boundingRadius) {
-        // If we're over budget, force lower LOD
-        if (mCurrentTriangles > mTriangleBudget) {
-            // Use lowest LOD for objects far away
-            float normalizedDist = distance / 100.0f;  // Normalize
-            int forcedLOD = std::min(mNumLevels - 1, (int)(normalizedDist * mNumLevels * mBias));
-            return forcedLOD;
-        }
+        float tanHalfFOV = tanf(mFOV * 0.5f * 3.14159f / 180.0f);
+        float pixelsPerUnit = mScreenHeight / (2.0f * tanHalfFOV * std::max(0.001f, distance));
+
+        BudgetKey key{cached, mBudgetOccurrences[cached]++};
+        mBudgetRequests.push_back({key, boundingRadius * pixelsPerUnit * mBias});
 
-        // Otherwise, use screen size selection
+        auto it = mBudgetLevels.find(key);
+        if (it != mBudgetLevels.end()) {
+            return std::min(it->second, cached->lodMesh.numLevels() - 1);
+        }
         return selectByScreenSize(distance, boundingRadius);
     }
 
+    /**
+     * Greedy multiple-choice knapsack over last frame's draws: start every
+     * draw at its coarsest level, then repeatedly take the refinement with
+     * the most pixel error removed per triangle added while it fits the
+     * budget. Error at level i is errorScale * reductionFactor^i (0 at LOD 0),
+     * the same model as ScreenError mode.
+     */
+    void solveTriangleBudget() {
+        struct Upgrade {
+            float gain;     // Error removed per triangle added
+            int request;
+            int toLevel;
+            bool operator<(const Upgrade& o) const { return gain < o.gain; }
+        };
+
+        auto levelError = [this](float errorScale, int level) {
+            return level == 0 ? 0.0f : errorScale * powf(mReductionFactor, level);
+        };
+
+        std::vector<int> assigned(mBudgetRequests.size());
+        std::vector<int> previous(mBudgetRequests.size(), -1);
+        std::vector<Upgrade> heap;
+        heap.reserve(mBudgetRequests.size());
+        long long total = 0;
+
+        auto pushUpgrade = [&](int r) {
+            const BudgetRequest& req = mBudgetRequests[r];
+            const LODMesh& lod = req.key.mesh->lodMesh;
+            int from = assigned[r];
+            if (from == 0) return;
+            int to = from - 1;
+            int cost = std::max(1, lod.triangleCount(to) - lod.triangleCount(from));
+            float gain = (levelError(req.errorScale, from) - levelError(req.errorScale, to)) / cost;
+            // Hysteresis: refining back toward last frame's level is cheaper
+            // than refining past it
+            if (previous[r] >= 0) gain *= (to >= previous[r]) ? 1.0f + mBudgetHysteresis
+                                                              : 1.0f - mBudgetHysteresis;
+            heap.push_back({gain, r, to});
+            std::push_heap(heap.begin(), heap.end());
+        };
+
+        for (size_t r = 0; r < mBudgetRequests.size(); r++) {
+            const BudgetRequest& req = mBudgetRequests[r];
+            auto it = mBudgetLevels.find(req.key);
+            if (it != mBudgetLevels.end()) previous[r] = it->second;
+            assigned[r] = req.key.mesh->lodMesh.numLevels() - 1;
+            total += req.key.mesh->lodMesh.triangleCount(assigned[r]);
+        }
+        for (size_t r = 0; r < mBudgetRequests.size(); r++) pushUpgrade((int)r);
+
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end());
+            Upgrade up = heap.back();
+            heap.pop_back();
+
+            const LODMesh& lod = mBudgetRequests[up.request].key.mesh->lodMesh;
+            int cost = lod.triangleCount(up.toLevel) - lod.triangleCount(assigned[up.request]);
+            if (total + cost > mTriangleBudget) continue;  // Cheaper refinements may still fit
+
+            total += cost;
+            assigned[up.request] = up.toLevel;
+            pushUpgrade(up.request);
+        }
+
+        mBudgetLevels.clear();
+        float error = 0.0f;
+        for (size_t r = 0; r < mBudgetRequests.size(); r++) {
+            mBudgetLevels[mBudgetRequests[r].key] = assigned[r];
+            error += levelError(mBudgetRequests[r].errorScale, assigned[r]);
+        }
+        mBudgetSolvedTriangles = (int)std::min<long long>(total, INT32_MAX);
+        mBudgetSolvedError = error;
+    }
+
     // Settings
     bool mEnabled;
     int mNumLevels;
@@ -752,6 +1224,29 @@ private:
     // Budget & quality
     int mTriangleBudget;
     int mCurrentTriangles;
+
+    // Budget solver (TriangleBudget mode): draws recorded this frame, and the
+    // levels solved from the previous frame's draws
+    struct BudgetKey {
+        const CachedLODMesh* mesh;
+        int occurrence;     // nth draw of this mesh in the frame
+        bool operator==(const BudgetKey& o) const { return mesh == o.mesh && occurrence == o.occurrence; }
+    };
+    struct BudgetKeyHash {
+        size_t operator()(const BudgetKey& k) const {
+            return std::hash<const void*>()(k.mesh) ^ ((size_t)k.occurrence * 0x9E3779B9u);
+        }
+    };
+    struct BudgetRequest {
+        BudgetKey key;
+        float errorScale;   // Pixel error of the source-sized error at this distance
+    };
+    std::vector<BudgetRequest> mBudgetRequests;
+    std::unordered_map<const CachedLODMesh*, int> mBudgetOccurrences;
+    std::unordered_map<BudgetKey, int, BudgetKeyHash> mBudgetLevels;
+    float mBudgetHysteresis = 0.15f;
+    int mBudgetSolvedTriangles = 0;
+    float mBudgetSolvedError = 0.0f;
     float mTargetScreenPixels;
     float mScreenErrorThreshold;
     float mMinFullQualityDistance;
@@ -774,16 +1269,30 @@ private:
     // Cache
     std::unordered_map<MeshIdentity, CachedLODMesh, MeshIdentityHash> mCache;
 
+    // Time-sliced generation (FIFO of meshes with levels still to build)
+    std::vector<MeshIdentity> mPendingGeneration;
+    std::vector<JobFuture<void>> mGenerationJobs;  // Threaded builds: chains on the pool
+    float mGenerationBudgetMs = 4.0f;
+    float mGenerationSpentMs = 0.0f;
+    bool mGenerationStepped = false;  // A step ran this frame
+
     // Stats - using int instead of bool to avoid potential WASM optimization issues
     int mStatsEnabled;
     int mTotalTriangles;
     int mMeshCount;
+    int mObjectsDrawn = 0;          // LODGroup objects (recordCulling)
+    int mObjectsFrustumCulled = 0;
+    int mObjectsOccluded = 0;
+    LODTelemetry mTelemetry;
+    mutable LODTelemetry mLiveTelemetry;  // getTextureLODLevel() is const
 };
 
 // =========================================================================
 // Global AutoLOD instance for JS bridge
 // =========================================================================
-inline AutoLODManager* gAutoLODInstance = nullptr;
+// Defined in al_WebAutoLOD.cpp: using any of the helpers below links that
+// file, and with it the JS bridge, which WebApp attaches at start().
+extern AutoLODManager* gAutoLODInstance;
 
 inline void setGlobalAutoLOD(AutoLODManager* lod) {
     gAutoLODInstance = lod;
@@ -817,6 +1326,36 @@ inline void drawLOD(Graphics& g, const Mesh& mesh) {
     }
 }
 
+/**
+ * Cull, LOD-select and draw a LODGroup from the current view, recording the
+ * drawn/culled counts in the global AutoLODManager's frame stats.
+ *
+ * Usage:
+ *   void onDraw(Graphics& g) {
+ *       al::drawLODGroup(g, myGroup);
+ *   }
+ */
+inline void drawLODGroup(Graphics& g, LODGroup& group) {
+    Vec3f cameraPos = gAutoLODInstance ? gAutoLODInstance->cameraPos() : Vec3f(0, 0, 0);
+    group.update(cameraPos, g.projMatrix() * g.viewMatrix());
+    if (gAutoLODInstance) gAutoLODInstance->recordCulling(group);
+    group.draw(g);
+}
+
+/**
+ * Draw a ClusterLODMesh with per-cluster detail from the global
+ * AutoLODManager's camera and screen error threshold. Without an enabled
+ * manager the finest cut is drawn.
+ */
+inline void drawClusterLOD(Graphics& g, ClusterLODMesh& mesh) {
+    if (!mesh.ready()) return;
+    if (gAutoLODInstance && gAutoLODInstance->enabled()) {
+        g.draw(gAutoLODInstance->selectClusters(mesh, g.modelMatrix()));
+    } else {
+        g.draw(mesh.selectFinest());
+    }
+}
+
 /**
  * Enable auto-LOD globally with default settings.
  * Call this in onCreate() to enable automatic LOD for all drawLOD() calls.
@@ -983,7 +1522,7 @@ inline float getTextureReferenceDistance() {
 
 // =========================================================================
 // JavaScript bridge functions (called from frontend settings)
-// Declarations only - definitions are in al_WebApp.cpp
+// Declarations only - definitions are in al_WebAutoLOD.cpp
 // =========================================================================
 extern "C" {
     EMSCRIPTEN_KEEPALIVE void al_autolod_set_bias(float bias);
@@ -1001,6 +1540,8 @@ extern "C" {
     EMSCRIPTEN_KEEPALIVE int al_autolod_get_levels();
     EMSCRIPTEN_KEEPALIVE void al_autolod_set_unload_distance(float distance);
     EMSCRIPTEN_KEEPALIVE void al_autolod_set_unload_enabled(int enabled);
+    // Pointer to the LODTelemetry block (0 without an app)
+    EMSCRIPTEN_KEEPALIVE uintptr_t al_autolod_get_telemetry();
 
     // Texture LOD functions
     EMSCRIPTEN_KEEPALIVE void al_texture_lod_set_enabled(int enabled);
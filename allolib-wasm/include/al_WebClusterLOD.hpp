@@ -0,0 +1,509 @@
+/**
+ * Web Cluster LOD - Per-cluster level of detail for very large meshes
+ *
+ * Whole-mesh LOD switching picks one level for an entire terrain or scan,
+ * so the far side is drawn at the detail the near side needs. ClusterLODMesh
+ * instead splits the mesh into clusters of ~128 triangles and builds a
+ * hierarchy over them (Nanite-style):
+ *
+ * - Level 0 clusters are grown over the source triangles.
+ * - Each pass groups ~4 neighbouring clusters, simplifies the group to half
+ *   its triangles with the vertices shared with other groups locked (so no
+ *   cracks open between groups), and splits the result into new clusters.
+ *   Groups that cannot shrink are retried in the next pass.
+ * - Every cluster records its own error and the error of the group that
+ *   replaced it, with bounds that grow monotonically up the hierarchy.
+ *
+ * select() then draws each cluster whose projected error is within the
+ * threshold while its parent's is not, which is a crack-free cut whose
+ * triangle count follows screen coverage instead of object count.
+ *
+ * Usage:
+ *   ClusterLODMesh terrainLOD;
+ *   terrainLOD.build(terrainMesh);
+ *
+ *   // In onDraw (uses AutoLOD's screen error threshold)
+ *   drawClusterLOD(g, terrainLOD);
+ */
+
+#ifndef AL_WEB_CLUSTER_LOD_HPP
+#define AL_WEB_CLUSTER_LOD_HPP
+
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+
+#include "al_WebLOD.hpp"
+#include "al/graphics/al_Mesh.hpp"
+#include "al/math/al_Vec.hpp"
+
+namespace al {
+
+class ClusterLODMesh {
+public:
+    struct Cluster {
+        Mesh mesh;
+        int triangleCount = 0;
+        int depth = 0;                // 0 = source triangles
+        Vec3f centroid{0, 0, 0};      // Centre of this cluster's own geometry
+
+        // Bounds and error of the group this cluster was built from
+        Vec3f center{0, 0, 0};
+        float radius = 0.0f;
+        float error = 0.0f;
+
+        // Bounds and error of the group that replaced it (infinite at roots)
+        Vec3f parentCenter{0, 0, 0};
+        float parentRadius = 0.0f;
+        float parentError = std::numeric_limits<float>::infinity();
+    };
+
+    /**
+     * Build the cluster hierarchy
+     * @param source Triangle mesh (indexed or not)
+     * @param trianglesPerCluster Cluster size target
+     * @param clustersPerGroup Clusters merged per simplification group
+     */
+    void build(const Mesh& source, int trianglesPerCluster = 128, int clustersPerGroup = 4) {
+        mClusters.clear();
+        mSelected.clear();
+        mSelection.reset();
+        mDepth = 0;
+        trianglesPerCluster = std::max(8, trianglesPerCluster);
+        clustersPerGroup = std::max(2, clustersPerGroup);
+
+        auto startTime = std::chrono::steady_clock::now();
+
+        Mesh working;
+        working.copy(source);
+        if (working.indices().empty()) working.compress();
+        if (working.normals().size() != working.vertices().size()) working.generateNormals();
+
+        std::vector<Vec3f> positions(working.vertices().begin(), working.vertices().end());
+        std::vector<Vec3f> normals(working.normals().begin(), working.normals().end());
+        const auto& indices = working.indices();
+        std::vector<int> corners(indices.begin(), indices.begin() + (indices.size() - indices.size() % 3));
+        if (corners.empty()) return;
+
+        mBoundsMin = mBoundsMax = positions[corners[0]];
+        for (int c : corners) {
+            const Vec3f& p = positions[c];
+            mBoundsMin.x = std::min(mBoundsMin.x, p.x); mBoundsMax.x = std::max(mBoundsMax.x, p.x);
+            mBoundsMin.y = std::min(mBoundsMin.y, p.y); mBoundsMax.y = std::max(mBoundsMax.y, p.y);
+            mBoundsMin.z = std::min(mBoundsMin.z, p.z); mBoundsMax.z = std::max(mBoundsMax.z, p.z);
+        }
+
+        // Level 0: leaves carry zero error and their own bounds
+        std::vector<int> current;
+        for (const auto& part : partition(positions, corners, trianglesPerCluster)) {
+            current.push_back(addCluster(positions, normals, corners, part, 0));
+            Cluster& leaf = mClusters.back();
+            sphereOf(leaf.mesh, leaf.center, leaf.radius);
+        }
+        int sourceTriangles = (int)(corners.size() / 3);
+
+        while (current.size() > 1 && mDepth < kMaxDepth) {
+            std::vector<std::vector<int>> groups = groupClusters(current, clustersPerGroup);
+
+            // Vertices seen by more than one group stay put this pass
+            std::unordered_map<PositionKey, int, PositionKeyHash> owner;
+            for (size_t g = 0; g < groups.size(); g++) {
+                for (int ci : groups[g]) {
+                    for (const auto& p : mClusters[ci].mesh.vertices()) {
+                        auto it = owner.emplace(PositionKey(p), (int)g).first;
+                        if (it->second != (int)g) it->second = -1;
+                    }
+                }
+            }
+
+            std::vector<int> next;
+            bool simplifiedAny = false;
+            for (const auto& group : groups) {
+                Mesh merged;
+                std::vector<uint8_t> locked;
+                mergeGroup(group, owner, merged, locked);
+                int inTriangles = (int)(merged.indices().size() / 3);
+
+                Mesh simplified;
+                float simplifyError = 0.0f;
+                SimplifyOptions options;
+                options.lockedVertices = &locked;
+                options.resultError = &simplifyError;
+                options.verbose = false;
+                MeshSimplifier::simplify(merged, simplified, 0.5f, options);
+                int outTriangles = (int)(simplified.indices().size() / 3);
+
+                // Too constrained by locked borders: carry the clusters into
+                // the next pass, where regrouping can free their borders
+                // (dropping them would leave their borders unlocked)
+                if (outTriangles == 0 || outTriangles > inTriangles * 0.85f) {
+                    next.insert(next.end(), group.begin(), group.end());
+                    continue;
+                }
+                simplifiedAny = true;
+
+                // Parent bounds enclose every child's and the error never
+                // decreases, so the projected error is monotonic up the tree
+                Vec3f groupCenter = mClusters[group[0]].center;
+                float groupRadius = mClusters[group[0]].radius;
+                float groupError = simplifyError;
+                for (int ci : group) {
+                    const Cluster& c = mClusters[ci];
+                    mergeSphere(groupCenter, groupRadius, c.center, c.radius);
+                    groupError = std::max(groupError, c.error);
+                }
+                for (int ci : group) {
+                    mClusters[ci].parentCenter = groupCenter;
+                    mClusters[ci].parentRadius = groupRadius;
+                    mClusters[ci].parentError = groupError;
+                }
+
+                std::vector<Vec3f> sPositions(simplified.vertices().begin(), simplified.vertices().end());
+                std::vector<Vec3f> sNormals(simplified.normals().begin(), simplified.normals().end());
+                std::vector<int> sCorners(simplified.indices().begin(), simplified.indices().end());
+                for (const auto& part : partition(sPositions, sCorners, trianglesPerCluster)) {
+                    next.push_back(addCluster(sPositions, sNormals, sCorners, part, mDepth + 1));
+                    Cluster& c = mClusters.back();
+                    c.center = groupCenter;
+                    c.radius = groupRadius;
+                    c.error = groupError;
+                }
+            }
+
+            if (!simplifiedAny) break;  // Whatever is left are roots
+            current.swap(next);
+            mDepth++;
+        }
+
+        int rootTriangles = 0;
+        for (const auto& c : mClusters) {
+            if (std::isinf(c.parentError)) rootTriangles += c.triangleCount;
+        }
+        double elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - startTime).count();
+        printf("[ClusterLOD] Built %zu clusters over %d levels: %d tris -> %d root tris (%.1f ms)\n",
+               mClusters.size(), mDepth + 1, sourceTriangles, rootTriangles, elapsedMs);
+    }
+
+    /**
+     * Select the cluster cut for a view and return it as one mesh
+     * @param cameraPos Camera position in the mesh's model space
+     * @param pixelScale Screen height / (2 tan(fovy / 2)): pixels per unit at distance 1
+     * @param thresholdPixels Largest projected error allowed
+     *
+     * The returned mesh is rebuilt only when the selected set changes.
+     */
+    const Mesh& select(const Vec3f& cameraPos, float pixelScale, float thresholdPixels) {
+        mCut.clear();
+        int triangles = 0;
+        for (size_t i = 0; i < mClusters.size(); i++) {
+            const Cluster& c = mClusters[i];
+            if (projectedError(c.center, c.radius, c.error, cameraPos, pixelScale) <= thresholdPixels &&
+                projectedError(c.parentCenter, c.parentRadius, c.parentError, cameraPos, pixelScale) > thresholdPixels) {
+                mCut.push_back((int)i);
+                triangles += c.triangleCount;
+            }
+        }
+        mSelectedTriangles = triangles;
+
+        if (mCut != mSelected) {
+            mSelected.swap(mCut);
+            rebuildSelection();
+        }
+        return mSelection;
+    }
+
+    /// Finest cut (every cluster at full detail), for drawing without a view
+    const Mesh& selectFinest() { return select(Vec3f(0, 0, 0), 1.0f, 0.0f); }
+
+    bool ready() const { return !mClusters.empty(); }
+    int clusterCount() const { return (int)mClusters.size(); }
+    int depth() const { return mDepth; }
+    const Cluster& cluster(int i) const { return mClusters[i]; }
+
+    int selectedClusters() const { return (int)mSelected.size(); }
+    int selectedTriangles() const { return mSelectedTriangles; }
+
+private:
+    static constexpr int kMaxDepth = 24;
+
+    // Exact position identity, used to find vertices shared across clusters
+    struct PositionKey {
+        uint32_t bits[3];
+        explicit PositionKey(const Vec3f& p) {
+            std::memcpy(&bits[0], &p.x, 4);
+            std::memcpy(&bits[1], &p.y, 4);
+            std::memcpy(&bits[2], &p.z, 4);
+        }
+        bool operator==(const PositionKey& o) const {
+            return bits[0] == o.bits[0] && bits[1] == o.bits[1] && bits[2] == o.bits[2];
+        }
+    };
+    struct PositionKeyHash {
+        size_t operator()(const PositionKey& k) const {
+            uint64_t h = k.bits[0] * 0x9E3779B97F4A7C15ull;
+            h ^= k.bits[1] + 0x7F4A7C159E3779B9ull + (h << 6) + (h >> 2);
+            h ^= k.bits[2] + 0x94D049BB133111EBull + (h << 6) + (h >> 2);
+            return (size_t)h;
+        }
+    };
+
+    static float projectedError(const Vec3f& center, float radius, float error,
+                                const Vec3f& cameraPos, float pixelScale) {
+        if (error <= 0.0f) return 0.0f;
+        if (std::isinf(error)) return error;
+        float distance = (center - cameraPos).mag() - radius;
+        if (distance <= 1e-6f) return std::numeric_limits<float>::infinity();
+        return error / distance * pixelScale;
+    }
+
+    static void sphereOf(const Mesh& mesh, Vec3f& center, float& radius) {
+        const auto& verts = mesh.vertices();
+        if (verts.empty()) { center = Vec3f(0, 0, 0); radius = 0.0f; return; }
+        Vec3f minB = verts[0], maxB = verts[0];
+        for (const auto& v : verts) {
+            minB.x = std::min(minB.x, v.x); maxB.x = std::max(maxB.x, v.x);
+            minB.y = std::min(minB.y, v.y); maxB.y = std::max(maxB.y, v.y);
+            minB.z = std::min(minB.z, v.z); maxB.z = std::max(maxB.z, v.z);
+        }
+        center = (minB + maxB) * 0.5f;
+        radius = 0.0f;
+        for (const auto& v : verts) radius = std::max(radius, (v - center).mag());
+    }
+
+    // Grow sphere (c, r) to enclose sphere (oc, orad)
+    static void mergeSphere(Vec3f& c, float& r, const Vec3f& oc, float orad) {
+        Vec3f d = oc - c;
+        float dist = d.mag();
+        if (dist + orad <= r) return;
+        if (dist + r <= orad) { c = oc; r = orad; return; }
+        float newR = (dist + r + orad) * 0.5f;
+        c = c + d * ((newR - r) / dist);
+        r = newR;
+    }
+
+    // 30-bit Morton code of a point inside the source bounds
+    uint32_t morton(const Vec3f& p) const {
+        auto spread = [](uint32_t v) {
+            v = (v | (v << 16)) & 0x030000FF;
+            v = (v | (v << 8)) & 0x0300F00F;
+            v = (v | (v << 4)) & 0x030C30C3;
+            v = (v | (v << 2)) & 0x09249249;
+            return v;
+        };
+        auto cell = [](float v, float lo, float hi) {
+            float t = hi > lo ? (v - lo) / (hi - lo) : 0.0f;
+            return (uint32_t)std::min(1023.0f, std::max(0.0f, t * 1023.0f));
+        };
+        return (spread(cell(p.x, mBoundsMin.x, mBoundsMax.x)) << 2) |
+               (spread(cell(p.y, mBoundsMin.y, mBoundsMax.y)) << 1) |
+                spread(cell(p.z, mBoundsMin.z, mBoundsMax.z));
+    }
+
+    /**
+     * Split triangles into connected patches of up to perCluster triangles,
+     * growing breadth-first from seeds taken in Morton order
+     */
+    std::vector<std::vector<int>> partition(const std::vector<Vec3f>& positions,
+                                            const std::vector<int>& corners, int perCluster) const {
+        int triangleCount = (int)(corners.size() / 3);
+        int vertexCount = (int)positions.size();
+
+        // CSR vertex -> triangle adjacency
+        std::vector<int> adjStart(vertexCount + 1, 0);
+        for (int c : corners) adjStart[c + 1]++;
+        for (int v = 0; v < vertexCount; v++) adjStart[v + 1] += adjStart[v];
+        std::vector<int> adj(corners.size());
+        {
+            std::vector<int> cursor(adjStart.begin(), adjStart.end() - 1);
+            for (size_t i = 0; i < corners.size(); i++) adj[cursor[corners[i]]++] = (int)(i / 3);
+        }
+
+        std::vector<std::pair<uint32_t, int>> order(triangleCount);
+        for (int t = 0; t < triangleCount; t++) {
+            Vec3f centroid = (positions[corners[t * 3]] + positions[corners[t * 3 + 1]] +
+                              positions[corners[t * 3 + 2]]) * (1.0f / 3.0f);
+            order[t] = {morton(centroid), t};
+        }
+        std::sort(order.begin(), order.end());
+
+        std::vector<uint8_t> assigned(triangleCount, 0);
+        std::vector<std::vector<int>> parts;
+        std::vector<int> queue;
+        for (const auto& seed : order) {
+            if (assigned[seed.second]) continue;
+            parts.emplace_back();
+            auto& part = parts.back();
+            queue.assign(1, seed.second);
+            assigned[seed.second] = 1;
+            for (size_t head = 0; head < queue.size() && (int)part.size() < perCluster; head++) {
+                int t = queue[head];
+                part.push_back(t);
+                for (int k = 0; k < 3; k++) {
+                    int v = corners[t * 3 + k];
+                    for (int a = adjStart[v]; a < adjStart[v + 1]; a++) {
+                        int n = adj[a];
+                        if (!assigned[n]) {
+                            assigned[n] = 1;
+                            queue.push_back(n);
+                        }
+                    }
+                }
+            }
+            // Queued but not taken: free for the next seed
+            for (size_t i = part.size(); i < queue.size(); i++) assigned[queue[i]] = 0;
+        }
+        return parts;
+    }
+
+    int addCluster(const std::vector<Vec3f>& positions, const std::vector<Vec3f>& normals,
+                   const std::vector<int>& corners, const std::vector<int>& triangles, int depth) {
+        mClusters.emplace_back();
+        Cluster& c = mClusters.back();
+        c.depth = depth;
+        c.mesh.primitive(Mesh::TRIANGLES);
+
+        std::unordered_map<int, unsigned int> remap;
+        for (int t : triangles) {
+            for (int k = 0; k < 3; k++) {
+                int v = corners[t * 3 + k];
+                auto it = remap.find(v);
+                if (it == remap.end()) {
+                    it = remap.emplace(v, (unsigned int)c.mesh.vertices().size()).first;
+                    c.mesh.vertex(positions[v]);
+                    if (v < (int)normals.size()) c.mesh.normal(normals[v]);
+                }
+                c.mesh.index(it->second);
+            }
+        }
+        c.triangleCount = (int)triangles.size();
+
+        float unused;
+        sphereOf(c.mesh, c.centroid, unused);
+        return (int)mClusters.size() - 1;
+    }
+
+    /**
+     * Greedily group clusters with the neighbours they share the most
+     * vertices with, seeding in Morton order of cluster centroids
+     */
+    std::vector<std::vector<int>> groupClusters(const std::vector<int>& clusters, int perGroup) const {
+        std::unordered_map<PositionKey, std::vector<int>, PositionKeyHash> users;
+        for (size_t i = 0; i < clusters.size(); i++) {
+            for (const auto& p : mClusters[clusters[i]].mesh.vertices()) {
+                auto& list = users[PositionKey(p)];
+                if (list.empty() || list.back() != (int)i) list.push_back((int)i);
+            }
+        }
+
+        // Shared-vertex counts between clusters (local indices)
+        std::vector<std::unordered_map<int, int>> shared(clusters.size());
+        for (const auto& entry : users) {
+            const auto& list = entry.second;
+            for (size_t a = 0; a < list.size(); a++) {
+                for (size_t b = a + 1; b < list.size(); b++) {
+                    shared[list[a]][list[b]]++;
+                    shared[list[b]][list[a]]++;
+                }
+            }
+        }
+
+        std::vector<std::pair<uint32_t, int>> order(clusters.size());
+        for (size_t i = 0; i < clusters.size(); i++) {
+            order[i] = {morton(mClusters[clusters[i]].centroid), (int)i};
+        }
+        std::sort(order.begin(), order.end());
+
+        std::vector<uint8_t> assigned(clusters.size(), 0);
+        std::vector<std::vector<int>> groups;
+        for (const auto& seed : order) {
+            if (assigned[seed.second]) continue;
+            std::vector<int> members(1, seed.second);
+            assigned[seed.second] = 1;
+            while ((int)members.size() < perGroup) {
+                // Best unassigned neighbour of the whole group so far
+                std::unordered_map<int, int> score;
+                for (int m : members) {
+                    for (const auto& n : shared[m]) {
+                        if (!assigned[n.first]) score[n.first] += n.second;
+                    }
+                }
+                int best = -1, bestScore = 0;
+                for (const auto& s : score) {
+                    if (s.second > bestScore || (s.second == bestScore && s.first < best)) {
+                        best = s.first;
+                        bestScore = s.second;
+                    }
+                }
+                if (best < 0) break;
+                members.push_back(best);
+                assigned[best] = 1;
+            }
+            groups.emplace_back();
+            for (int m : members) groups.back().push_back(clusters[m]);
+        }
+        return groups;
+    }
+
+    // Weld a group's clusters by position and flag vertices other groups share
+    void mergeGroup(const std::vector<int>& group,
+                    const std::unordered_map<PositionKey, int, PositionKeyHash>& owner,
+                    Mesh& merged, std::vector<uint8_t>& locked) const {
+        merged.reset();
+        merged.primitive(Mesh::TRIANGLES);
+        std::unordered_map<PositionKey, unsigned int, PositionKeyHash> welded;
+        for (int ci : group) {
+            const Mesh& m = mClusters[ci].mesh;
+            const auto& verts = m.vertices();
+            const auto& norms = m.normals();
+            std::vector<unsigned int> local(verts.size());
+            for (size_t v = 0; v < verts.size(); v++) {
+                PositionKey key(verts[v]);
+                auto it = welded.find(key);
+                if (it == welded.end()) {
+                    it = welded.emplace(key, (unsigned int)merged.vertices().size()).first;
+                    merged.vertex(verts[v]);
+                    if (v < norms.size()) merged.normal(norms[v]);
+                    auto own = owner.find(key);
+                    locked.push_back(own != owner.end() && own->second < 0 ? 1 : 0);
+                }
+                local[v] = it->second;
+            }
+            for (unsigned int idx : m.indices()) merged.index(local[idx]);
+        }
+    }
+
+    void rebuildSelection() {
+        mSelection.reset();
+        mSelection.primitive(Mesh::TRIANGLES);
+        auto& verts = mSelection.vertices();
+        auto& norms = mSelection.normals();
+        auto& indices = mSelection.indices();
+        for (int ci : mSelected) {
+            const Mesh& m = mClusters[ci].mesh;
+            unsigned int base = (unsigned int)verts.size();
+            verts.insert(verts.end(), m.vertices().begin(), m.vertices().end());
+            norms.insert(norms.end(), m.normals().begin(), m.normals().end());
+            for (unsigned int idx : m.indices()) indices.push_back(base + idx);
+        }
+    }
+
+    std::vector<Cluster> mClusters;
+    Vec3f mBoundsMin{0, 0, 0};
+    Vec3f mBoundsMax{0, 0, 0};
+    int mDepth = 0;
+
+    std::vector<int> mSelected;     // Cluster indices in mSelection
+    std::vector<int> mCut;          // Scratch for select()
+    Mesh mSelection;
+    int mSelectedTriangles = 0;
+};
+
+} // namespace al
+
+#endif // AL_WEB_CLUSTER_LOD_HPP
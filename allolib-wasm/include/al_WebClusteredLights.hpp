@@ -0,0 +1,435 @@
+/**
+ * Web Clustered Lights - froxel-culled point lights for forward shading
+ *
+ * Lets lit draws take hundreds of point lights without every fragment
+ * looping over all of them. Each frame the view frustum is cut into a 3D
+ * grid of froxels (al_cluster_grid_x/y/z(): screen tiles in x/y,
+ * exponential depth slices in z); every light's sphere of influence is
+ * binned into the froxels it touches, giving a compact per-froxel light
+ * index list. Fragments then only shade the lights of their own froxel.
+ *
+ * Culling runs on the CPU (WebGL2 has no compute stage, and the grid is
+ * small - a few thousand froxels), the results go to the GPU as:
+ * - WebGL2: an RGBA32F light texture, an RG32UI (offset, count) texture
+ *   with one row per slice and an R32UI index texture, read with
+ *   texelFetch (al_clustered_lights_frag_functions())
+ * - WebGPU: three read-only storage buffers bound to the lit and PBR
+ *   pipelines (WebGPUBackend::setClusteredLights)
+ *
+ * Usage:
+ *   ClusteredLights clustered;
+ *   clustered.add({Vec3f(0, 1, 0), 4.0f, Color(1, 0.5f, 0.2f), 2.0f});
+ *
+ *   void onDraw(Graphics& g) {
+ *     g.lighting(true);
+ *     clustered.update(g);          // after the camera is set
+ *     g.clusteredLights(&clustered);
+ *     g.draw(mesh);                 // light() lights + clustered lights
+ *
+ *     pbr.clusteredLights(&clustered);
+ *     pbr.begin(g, nav().pos());
+ *     ...
+ *   }
+ *
+ * Lights are in world space and shade with a windowed inverse-square
+ * falloff that reaches zero at their radius, so the radius bounds both
+ * the culling and the lit area. Omni (cubemap) rendering keeps using the
+ * per-light shaders.
+ */
+
+#ifndef AL_WEB_CLUSTERED_LIGHTS_HPP
+#define AL_WEB_CLUSTERED_LIGHTS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "al/graphics/al_DefaultShaders.hpp"
+#include "al/graphics/al_Graphics.hpp"
+#include "al/graphics/al_OpenGL.hpp"
+#include "al/graphics/al_Shader.hpp"
+#include "al/math/al_Matrix4.hpp"
+#include "al/math/al_Vec.hpp"
+#include "al/types/al_Color.hpp"
+#include "al_WebGraphicsBackend.hpp"
+
+#ifdef ALLOLIB_WEBGPU
+#include "al_WebGPUBackend.hpp"
+#endif
+
+namespace al {
+
+/**
+ * Point light for ClusteredLights
+ */
+struct ClusterLight {
+    Vec3f pos{0, 0, 0};     // World space
+    float radius = 5.0f;    // No contribution beyond this distance
+    Color color{1, 1, 1};
+    float intensity = 1.0f;
+};
+
+class ClusteredLights {
+public:
+    static constexpr int kGridX = al_cluster_grid_x();
+    static constexpr int kGridY = al_cluster_grid_y();
+    static constexpr int kGridZ = al_cluster_grid_z();
+    static constexpr int kFroxels = kGridX * kGridY * kGridZ;
+    static constexpr int kMaxLights = 4096;       // Rows of the light texture
+    static constexpr int kIndexRowWidth = 1024;   // Matches al_clusterLight()
+
+    // WebGL2 texture units of the grid, above the ones PBR materials use
+    static constexpr int kLightsUnit = 13;
+    static constexpr int kRangesUnit = 14;
+    static constexpr int kIndicesUnit = 15;
+
+    ClusteredLights() = default;
+    ~ClusteredLights() { destroy(); }
+    ClusteredLights(const ClusteredLights&) = delete;
+    ClusteredLights& operator=(const ClusteredLights&) = delete;
+
+    // ── Lights ──────────────────────────────────────────────────────────
+
+    /// Add a light, returning its index (kMaxLights at most are shaded)
+    int add(const ClusterLight& light) {
+        mLights.push_back(light);
+        return (int)mLights.size() - 1;
+    }
+
+    void clear() { mLights.clear(); }
+    int size() const { return (int)mLights.size(); }
+    ClusterLight& operator[](int i) { return mLights[i]; }
+    const ClusterLight& operator[](int i) const { return mLights[i]; }
+    std::vector<ClusterLight>& lights() { return mLights; }
+
+    /// Depth the slices end at; lights wholly beyond it are culled, so
+    /// keep it near the scene's extent rather than the far plane
+    float maxDistance() const { return mMaxDistance; }
+    void maxDistance(float d) { mMaxDistance = std::max(d, 0.01f); }
+
+    // ── Per-frame culling ───────────────────────────────────────────────
+
+    /**
+     * Bin the lights against g's current view, projection and viewport
+     * and upload the grid. Call once per view, after the camera is set.
+     */
+    void update(Graphics& g) {
+        int viewport[4] = {0, 0, 1, 1};
+        if (Graphics_isWebGPU()) {
+            if (GraphicsBackend* backend = Graphics_getBackend()) {
+                viewport[2] = backend->getWidth();
+                viewport[3] = backend->getHeight();
+            }
+        } else {
+            glGetIntegerv(GL_VIEWPORT, viewport);
+        }
+        update(g.viewMatrix(), g.projMatrix(), viewport[0], viewport[1],
+               viewport[2], viewport[3]);
+    }
+
+    /// Bin against explicit matrices (perspective projection) and a
+    /// viewport in pixels
+    void update(const Mat4f& view, const Mat4f& proj, int x, int y, int width, int height) {
+        mViewport[0] = (float)x;
+        mViewport[1] = (float)y;
+        mViewport[2] = (float)std::max(width, 1);
+        mViewport[3] = (float)std::max(height, 1);
+
+        updateFroxels(proj);
+        cull(view, proj);
+        upload();
+    }
+
+    /**
+     * Bind the WebGL2 grid for a shader using
+     * al_clustered_lights_frag_functions() (the shader must be current)
+     */
+    void bind(ShaderProgram& shader) const {
+        glActiveTexture(GL_TEXTURE0 + kLightsUnit);
+        glBindTexture(GL_TEXTURE_2D, mLightTexture);
+        glActiveTexture(GL_TEXTURE0 + kRangesUnit);
+        glBindTexture(GL_TEXTURE_2D, mRangeTexture);
+        glActiveTexture(GL_TEXTURE0 + kIndicesUnit);
+        glBindTexture(GL_TEXTURE_2D, mIndexTexture);
+        glActiveTexture(GL_TEXTURE0);
+
+        shader.uniform("al_ClusterLights", kLightsUnit);
+        shader.uniform("al_ClusterRanges", kRangesUnit);
+        shader.uniform("al_ClusterIndices", kIndicesUnit);
+        shader.uniform4v("al_ClusterViewport", mViewport);
+        shader.uniform("al_ClusterDepth", mSliceScale, mSliceBias);
+    }
+
+    // ── Stats (last update) ─────────────────────────────────────────────
+
+    int visibleLights() const { return mVisible; }
+    int indexCount() const { return mIndexCount; }
+    int maxLightsPerFroxel() const { return mMaxPerFroxel; }
+
+    /// Release GPU resources (recreated by the next update())
+    void destroy() {
+        if (mLightTexture) glDeleteTextures(1, &mLightTexture);
+        if (mRangeTexture) glDeleteTextures(1, &mRangeTexture);
+        if (mIndexTexture) glDeleteTextures(1, &mIndexTexture);
+        mLightTexture = mRangeTexture = mIndexTexture = 0;
+        mLightRows = mIndexRows = 0;
+    }
+
+private:
+    struct Bounds {
+        Vec3f min, max;
+    };
+
+    static float sliceDepth(float zNear, float zFar, int slice) {
+        return zNear * std::pow(zFar / zNear, (float)slice / kGridZ);
+    }
+
+    /**
+     * View-space bounds of every froxel, rebuilt when the projection or
+     * depth range changes. Tile edges are rays through NDC x/y, which for
+     * a perspective matrix (off-axis included) sit at
+     * x = (ndc + P[2][0]) * depth / P[0][0].
+     */
+    void updateFroxels(const Mat4f& proj) {
+        const float* p = proj.elems();
+        // near = P[3][2] / (P[2][2] - 1) for a GL perspective matrix
+        float zNear = std::max(p[14] / (p[10] - 1.0f), 1e-4f);
+        float zFar = std::max(mMaxDistance, zNear * 1.01f);
+        bool same = zNear == mNear && zFar == mFar;
+        for (int i = 0; same && i < 16; i++) same = p[i] == mProj[i];
+        if (same && !mFroxels.empty()) return;
+
+        std::copy(p, p + 16, mProj);
+        mNear = zNear;
+        mFar = zFar;
+        float logRange = std::log(zFar / zNear);
+        mSliceScale = kGridZ / logRange;
+        mSliceBias = -kGridZ * std::log(zNear) / logRange;
+
+        mFroxels.resize(kFroxels);
+        for (int z = 0; z < kGridZ; z++) {
+            float d0 = sliceDepth(zNear, zFar, z);
+            float d1 = sliceDepth(zNear, zFar, z + 1);
+            for (int y = 0; y < kGridY; y++) {
+                float ny0 = -1.0f + 2.0f * y / kGridY;
+                float ny1 = -1.0f + 2.0f * (y + 1) / kGridY;
+                for (int x = 0; x < kGridX; x++) {
+                    float nx0 = -1.0f + 2.0f * x / kGridX;
+                    float nx1 = -1.0f + 2.0f * (x + 1) / kGridX;
+                    Bounds& b = mFroxels[x + kGridX * (y + kGridY * z)];
+                    b.min = Vec3f(1e30f, 1e30f, -d1);
+                    b.max = Vec3f(-1e30f, -1e30f, -d0);
+                    for (float d : {d0, d1}) {
+                        for (float nx : {nx0, nx1}) {
+                            float vx = (nx + p[8]) * d / p[0];
+                            b.min.x = std::min(b.min.x, vx);
+                            b.max.x = std::max(b.max.x, vx);
+                        }
+                        for (float ny : {ny0, ny1}) {
+                            float vy = (ny + p[9]) * d / p[5];
+                            b.min.y = std::min(b.min.y, vy);
+                            b.max.y = std::max(b.max.y, vy);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    int slice(float depth) const {
+        int s = (int)std::floor(std::log(std::max(depth, mNear)) * mSliceScale + mSliceBias);
+        return std::min(std::max(s, 0), kGridZ - 1);
+    }
+
+    /// Froxel range [t0, t1] along one screen axis for a sphere spanning
+    /// view-space [lo, hi] on it between depths dMin and dMax
+    static bool tileRange(float lo, float hi, float dMin, float dMax, float scale,
+                          float offset, int tiles, int& t0, int& t1) {
+        // ndc = coord * scale / depth - offset, monotonic in both
+        float n0 = std::min(lo * scale / dMin, lo * scale / dMax) - offset;
+        float n1 = std::max(hi * scale / dMin, hi * scale / dMax) - offset;
+        if (n1 < -1.0f || n0 > 1.0f) return false;
+        t0 = std::max((int)std::floor((n0 + 1.0f) * 0.5f * tiles), 0);
+        t1 = std::min((int)std::floor((n1 + 1.0f) * 0.5f * tiles), tiles - 1);
+        return t0 <= t1;
+    }
+
+    void cull(const Mat4f& view, const Mat4f& proj) {
+        const float* p = proj.elems();
+        mCounts.assign(kFroxels, 0);
+        mPairs.clear();
+        mLightData.clear();
+        mVisible = 0;
+
+        int count = std::min((int)mLights.size(), kMaxLights);
+        for (int i = 0; i < count; i++) {
+            const ClusterLight& light = mLights[i];
+            float r = light.radius;
+            if (r <= 0.0f || light.intensity <= 0.0f) continue;
+
+            Vec4f c = view * Vec4f(light.pos.x, light.pos.y, light.pos.z, 1.0f);
+            float depth = -c.z;
+            if (depth + r < mNear || depth - r > mFar) continue;
+
+            // Screen bounds of the sphere's box, depths clamped to the near
+            // plane (which only widens them)
+            float dMin = std::max(depth - r, mNear);
+            float dMax = std::max(depth + r, mNear);
+            int x0, x1, y0, y1;
+            if (!tileRange(c.x - r, c.x + r, dMin, dMax, p[0], p[8], kGridX, x0, x1)) continue;
+            if (!tileRange(c.y - r, c.y + r, dMin, dMax, p[5], p[9], kGridY, y0, y1)) continue;
+            int z0 = slice(dMin);
+            int z1 = slice(std::min(depth + r, mFar));
+
+            // Exact sphere / froxel box test inside that range
+            uint32_t index = (uint32_t)mVisible;
+            size_t before = mPairs.size();
+            for (int z = z0; z <= z1; z++) {
+                for (int y = y0; y <= y1; y++) {
+                    for (int x = x0; x <= x1; x++) {
+                        uint32_t froxel = x + kGridX * (y + kGridY * z);
+                        const Bounds& b = mFroxels[froxel];
+                        float dx = std::max(std::max(b.min.x - c.x, c.x - b.max.x), 0.0f);
+                        float dy = std::max(std::max(b.min.y - c.y, c.y - b.max.y), 0.0f);
+                        float dz = std::max(std::max(b.min.z - c.z, c.z - b.max.z), 0.0f);
+                        if (dx * dx + dy * dy + dz * dz > r * r) continue;
+                        mPairs.push_back({froxel, index});
+                        mCounts[froxel]++;
+                    }
+                }
+            }
+            if (mPairs.size() == before) continue;
+
+            float scale = light.intensity;
+            float data[8] = {c.x, c.y, c.z, r,
+                             light.color.r * scale, light.color.g * scale,
+                             light.color.b * scale, 0.0f};
+            mLightData.insert(mLightData.end(), data, data + 8);
+            mVisible++;
+        }
+
+        // Counting sort of the (froxel, light) pairs into per-froxel lists
+        mRanges.resize(kFroxels * 2);
+        uint32_t offset = 0;
+        mMaxPerFroxel = 0;
+        for (int f = 0; f < kFroxels; f++) {
+            mRanges[f * 2] = offset;
+            mRanges[f * 2 + 1] = mCounts[f];
+            offset += mCounts[f];
+            mMaxPerFroxel = std::max(mMaxPerFroxel, (int)mCounts[f]);
+            mCounts[f] = mRanges[f * 2];  // Becomes the fill cursor
+        }
+        mIndices.resize(offset);
+        mIndexCount = (int)offset;
+        for (const Pair& pair : mPairs) {
+            mIndices[mCounts[pair.froxel]++] = pair.light;
+        }
+    }
+
+    void upload() {
+#ifdef ALLOLIB_WEBGPU
+        if (Graphics_isWebGPU()) {
+            auto* backend = dynamic_cast<WebGPUBackend*>(Graphics_getBackend());
+            if (!backend) return;
+            float params[8] = {mViewport[0], mViewport[1], mViewport[2], mViewport[3],
+                               mSliceScale, mSliceBias, 0.0f, 0.0f};
+            backend->setClusteredLights(mLightData.data(), (uint32_t)mVisible,
+                                        mRanges.data(), kFroxels,
+                                        mIndices.data(), (uint32_t)mIndexCount, params);
+            return;
+        }
+#endif
+        if (!mRangeTexture) {
+            mRangeTexture = createTexture();
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, kGridX * kGridY, kGridZ, 0,
+                         GL_RG_INTEGER, GL_UNSIGNED_INT, nullptr);
+        }
+        glBindTexture(GL_TEXTURE_2D, mRangeTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kGridX * kGridY, kGridZ,
+                        GL_RG_INTEGER, GL_UNSIGNED_INT, mRanges.data());
+
+        // Light and index textures grow in rows, never shrink
+        int lightRows = std::max(mVisible, 1);
+        if (lightRows > mLightRows) {
+            if (!mLightTexture) mLightTexture = createTexture();
+            mLightRows = std::max(lightRows, mLightRows * 2);
+            glBindTexture(GL_TEXTURE_2D, mLightTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, 2, mLightRows, 0,
+                         GL_RGBA, GL_FLOAT, nullptr);
+        }
+        if (mVisible > 0) {
+            glBindTexture(GL_TEXTURE_2D, mLightTexture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 2, mVisible,
+                            GL_RGBA, GL_FLOAT, mLightData.data());
+        }
+
+        int indexRows = std::max((mIndexCount + kIndexRowWidth - 1) / kIndexRowWidth, 1);
+        if (indexRows > mIndexRows) {
+            if (!mIndexTexture) mIndexTexture = createTexture();
+            mIndexRows = std::max(indexRows, mIndexRows * 2);
+            glBindTexture(GL_TEXTURE_2D, mIndexTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, kIndexRowWidth, mIndexRows, 0,
+                         GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+            printf("[ClusteredLights] Index texture grown to %d rows\n", mIndexRows);
+        }
+        if (mIndexCount > 0) {
+            // Whole rows only; the padding is never referenced by a range
+            mIndices.resize((size_t)indexRows * kIndexRowWidth, 0);
+            glBindTexture(GL_TEXTURE_2D, mIndexTexture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kIndexRowWidth, indexRows,
+                            GL_RED_INTEGER, GL_UNSIGNED_INT, mIndices.data());
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    /// Nearest-filtered data texture, left bound
+    static GLuint createTexture() {
+        GLuint tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return tex;
+    }
+
+    struct Pair {
+        uint32_t froxel;
+        uint32_t light;  // Index among the visible lights
+    };
+
+    std::vector<ClusterLight> mLights;
+    float mMaxDistance = 100.0f;
+
+    // Froxel bounds for the last projection
+    std::vector<Bounds> mFroxels;
+    float mProj[16] = {};
+    float mNear = 0.0f;
+    float mFar = 0.0f;
+    float mSliceScale = 0.0f;
+    float mSliceBias = 0.0f;
+    float mViewport[4] = {0, 0, 1, 1};
+
+    // Last update's grid
+    std::vector<uint32_t> mCounts;
+    std::vector<Pair> mPairs;
+    std::vector<float> mLightData;      // 8 floats per visible light
+    std::vector<uint32_t> mRanges;      // (offset, count) per froxel
+    std::vector<uint32_t> mIndices;
+    int mIndexCount = 0;
+    int mVisible = 0;
+    int mMaxPerFroxel = 0;
+
+    GLuint mLightTexture = 0;
+    GLuint mRangeTexture = 0;
+    GLuint mIndexTexture = 0;
+    int mLightRows = 0;
+    int mIndexRows = 0;
+};
+
+}  // namespace al
+
+#endif  // AL_WEB_CLUSTERED_LIGHTS_HPP
@@ -171,8 +171,9 @@ public:
         // In web builds, the Vue panel handles drawing
         // This is called in the render loop but does nothing
 #ifdef __EMSCRIPTEN__
-        // Update any parameter values that changed from C++ side
-        syncParametersToJS();
+        // Push values changed since the frame started (WebApp syncs once a
+        // frame as well, so apps that never draw the GUI still update)
+        syncParameterTable();
 #endif
     }
 
@@ -218,6 +219,21 @@ public:
     static void         dispatchSetPose(ParameterMeta* p, float x, float y, float z,
                                         float qw, float qx, float qy, float qz);
 
+    // Panel slider writes arrive faster than frames. They are queued (last
+    // value per parameter wins) and applied once per frame by WebApp::tick
+    // before onAnimate, so each parameter's set() and change callbacks run
+    // at most once per frame. dispatchGetValue reports queued values.
+    static void         queueSetValue(ParameterMeta* p, float value);
+    static void         flushQueuedValues();
+
+    // Scalar values are mirrored into a table in wasm memory, indexed like
+    // the registry, with a dirty bitmask each way. syncParameterTable marks
+    // values that changed in C++ and hands the panel all of them in a single
+    // onParametersSynced(headerPtr) call; the panel writes slider values
+    // into the table and flushQueuedValues picks them up. Hundreds of
+    // parameters cost one interop call per frame instead of one per value.
+    static void         syncParameterTable();
+
     // Get parameter info for JavaScript
     WebParamInfo getParameterInfo(size_t index) {
         WebParamInfo info;
@@ -396,9 +412,6 @@ private:
     bool mUsingInput = false;
 
 #ifdef __EMSCRIPTEN__
-    // Track last known values for change detection
-    std::vector<float> mLastValues;
-
     void notifyParameterAdded(ParameterMeta& param) {
         (void)param;
         // Notify JavaScript that a parameter was added
@@ -446,23 +459,6 @@ private:
         }, index, info.name.c_str(), info.group.c_str(),
            static_cast<int>(info.type), info.min, info.max, info.value, info.defaultValue,
            menuJson.c_str(), compJson.c_str(), info.stringValue.c_str());
-
-        mLastValues.push_back(info.value);
-    }
-
-    void syncParametersToJS() {
-        // Check for value changes and notify JS
-        for (size_t i = 0; i < mParameters.size(); i++) {
-            float currentValue = getParameterValue(i);
-            if (i < mLastValues.size() && mLastValues[i] != currentValue) {
-                mLastValues[i] = currentValue;
-                EM_ASM({
-                    if (window.allolib && window.allolib.onParameterChanged) {
-                        window.allolib.onParameterChanged($0, $1);
-                    }
-                }, i, currentValue);
-            }
-        }
     }
 
     // Global instance management for JS access
@@ -2,7 +2,11 @@
  * Web Environment Map System
  *
  * Provides skybox rendering and environment mapping for HDR environments.
- * Works with equirectangular HDR images loaded via WebHDR.
+ * Works with equirectangular HDR images loaded via WebHDR; on upload the
+ * map is converted to a cubemap on the GPU (IBLBaker::cubemap /
+ * WebGPUBackend::bakeEnvironmentCube), so the skybox and reflections do
+ * one cube lookup instead of an atan/acos per fragment. Without float
+ * render targets they sample the equirect map.
  *
  * Usage:
  *   WebEnvironment env;
@@ -32,7 +36,9 @@
 #include <cmath>
 
 #include "al_WebHDR.hpp"
+#include "al_WebIBL.hpp"
 #include "al_WebGraphicsBackend.hpp"
+#include "al_WebResourceCache.hpp"
 #ifdef ALLOLIB_WEBGPU
 #include "al_WebGPUBackend.hpp"
 #endif
@@ -77,7 +83,8 @@ void main() {
 }
 
 /**
- * Skybox fragment shader for equirectangular HDR maps
+ * Skybox fragment shader for equirectangular HDR maps (cubemaps with
+ * ENV_CUBE, see env_cube_variant())
  */
 inline std::string skybox_frag_shader() {
     return R"(#version 300 es
@@ -85,7 +92,11 @@ precision highp float;
 precision highp int;
 
 in vec3 vDirection;
+#ifdef ENV_CUBE
+uniform samplerCube envMap;
+#else
 uniform sampler2D envMap;
+#endif
 uniform float exposure;
 uniform float gamma;
 out vec4 frag_color;
@@ -105,9 +116,13 @@ vec2 directionToUV(vec3 dir) {
 
 void main() {
     vec3 dir = normalize(vDirection);
+#ifdef ENV_CUBE
+    vec3 hdrColor = texture(envMap, dir).rgb;
+#else
     vec2 uv = directionToUV(dir);
 
     vec3 hdrColor = texture(envMap, uv).rgb;
+#endif
 
     // Tone mapping (Reinhard)
     vec3 mapped = hdrColor * exposure;
@@ -158,7 +173,7 @@ void main() {
 }
 
 /**
- * Environment reflection fragment shader
+ * Environment reflection fragment shader (cubemap with ENV_CUBE)
  */
 inline std::string envmap_reflect_frag_shader() {
     return R"(#version 300 es
@@ -170,7 +185,11 @@ in vec3 vPosition;
 in vec3 vViewDir;
 in vec3 vLocalPos;
 
+#ifdef ENV_CUBE
+uniform samplerCube envMap;
+#else
 uniform sampler2D envMap;
+#endif
 uniform float exposure;
 uniform float gamma;
 uniform float reflectivity;
@@ -195,8 +214,12 @@ void main() {
     vec3 reflectDir = reflect(-viewDir, normal);
 
     // Sample environment map
+#ifdef ENV_CUBE
+    vec3 envColor = texture(envMap, reflectDir).rgb;
+#else
     vec2 uv = directionToUV(reflectDir);
     vec3 envColor = texture(envMap, uv).rgb;
+#endif
 
     // Tone mapping
     vec3 mapped = envColor * exposure;
@@ -212,6 +235,15 @@ void main() {
 )";
 }
 
+/**
+ * Cubemap build of an environment shader: defines ENV_CUBE after #version
+ */
+inline std::string env_cube_variant(const std::string& source) {
+    size_t lineEnd = source.find('\n');
+    if (lineEnd == std::string::npos) return source;
+    return source.substr(0, lineEnd + 1) + "#define ENV_CUBE\n" + source.substr(lineEnd + 1);
+}
+
 /**
  * Environment map system for skybox and reflections
  */
@@ -221,7 +253,10 @@ public:
 
     WebEnvironment() : mTextureId(0), mReady(false), mCreated(false),
                        mExposure(1.0f), mGamma(2.2f),
-                       mWebGPUTextureId(0), mWebGPUTextureCreated(false) {}
+                       mWebGPUTextureId(0), mWebGPUTextureCreated(false) {
+        // Decode straight to upload-ready texels; sample() uses the preview
+        mHdr.setFormat(WebHDR::Format::RGB9E5);
+    }
 
     ~WebEnvironment() {
         destroy();
@@ -268,16 +303,14 @@ public:
         // Compile shaders
         mSkyboxShader.compile(skybox_vert_shader(), skybox_frag_shader());
         mReflectShader.compile(envmap_reflect_vert_shader(), envmap_reflect_frag_shader());
+        if (!Graphics_isWebGPU() && IBLBaker::supported()) {
+            mCubeShadersCompiled =
+                mSkyboxCubeShader.compile(skybox_vert_shader(), env_cube_variant(skybox_frag_shader())) &&
+                mReflectCubeShader.compile(envmap_reflect_vert_shader(),
+                                           env_cube_variant(envmap_reflect_frag_shader()));
+        }
 
-        // Create texture (will upload HDR data when ready)
-        glGenTextures(1, &mTextureId);
-        glBindTexture(GL_TEXTURE_2D, mTextureId);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glBindTexture(GL_TEXTURE_2D, 0);
-
+        // The texture itself comes from GPUResourceCache once the HDR is in
         mCreated = true;
     }
 
@@ -285,10 +318,12 @@ public:
      * Destroy GPU resources
      */
     void destroy() {
-        if (mTextureId) {
-            glDeleteTextures(1, &mTextureId);
-            mTextureId = 0;
-        }
+        // Deleted by the cache once nothing else shares them
+        mTexture.reset();
+        mCubeTexture.reset();
+        mTextureId = 0;
+        mWebGPUTextureId = 0;
+        mWebGPUTextureCreated = false;
         mCreated = false;
     }
 
@@ -323,15 +358,16 @@ public:
         glDepthMask(GL_FALSE);
         glDepthFunc(GL_LEQUAL);
 
-        // Bind shader
-        g.shader(mSkyboxShader);
-        mSkyboxShader.uniform("envMap", 0);
-        mSkyboxShader.uniform("exposure", mExposure);
-        mSkyboxShader.uniform("gamma", mGamma);
+        // Bind shader (cubemap variant once the conversion is done)
+        ShaderProgram& shader = mCubeTexture ? mSkyboxCubeShader : mSkyboxShader;
+        g.shader(shader);
+        shader.uniform("envMap", 0);
+        shader.uniform("exposure", mExposure);
+        shader.uniform("gamma", mGamma);
 
         // Bind texture
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, mTextureId);
+        bindEnvTexture();
 
         // Draw skybox
         g.draw(mSkyboxMesh);
@@ -339,14 +375,15 @@ public:
         // Restore state
         glDepthMask(depthMask);
         glDepthFunc(depthFunc);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        unbindEnvTexture();
     }
 
     /**
-     * Get shader for reflective objects
+     * Get shader for reflective objects (the cubemap variant once the
+     * environment is converted)
      * Set uniforms: cameraPos, reflectivity (0-1), baseColor
      */
-    ShaderProgram& reflectShader() { return mReflectShader; }
+    ShaderProgram& reflectShader() { return mCubeTexture ? mReflectCubeShader : mReflectShader; }
 
     /**
      * Begin drawing reflective objects
@@ -370,16 +407,17 @@ public:
 
         uploadIfNeeded();
 
-        g.shader(mReflectShader);
-        mReflectShader.uniform("envMap", 0);
-        mReflectShader.uniform("exposure", mExposure);
-        mReflectShader.uniform("gamma", mGamma);
-        mReflectShader.uniform("cameraPos", cameraPos);
-        mReflectShader.uniform("reflectivity", reflectivity);
-        mReflectShader.uniform("baseColor", baseColor);
+        ShaderProgram& shader = reflectShader();
+        g.shader(shader);
+        shader.uniform("envMap", 0);
+        shader.uniform("exposure", mExposure);
+        shader.uniform("gamma", mGamma);
+        shader.uniform("cameraPos", cameraPos);
+        shader.uniform("reflectivity", reflectivity);
+        shader.uniform("baseColor", baseColor);
 
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, mTextureId);
+        bindEnvTexture();
     }
 
     /**
@@ -393,7 +431,7 @@ public:
         }
 
         // WebGL2 path
-        glBindTexture(GL_TEXTURE_2D, 0);
+        unbindEnvTexture();
     }
 
     /**
@@ -458,10 +496,16 @@ public:
     const WebHDR& hdr() const { return mHdr; }
 
     /**
-     * Get texture ID for custom shaders
+     * Get texture ID for custom shaders (equirect GL_TEXTURE_2D)
      */
     GLuint textureId() const { return mTextureId; }
 
+    /**
+     * Get the GL_TEXTURE_CUBE_MAP conversion, for samplerCube shaders
+     * (0 until uploaded, or without float render targets)
+     */
+    GLuint cubeTextureId() const { return mCubeTexture ? mCubeTexture->id : 0; }
+
     /**
      * Get URL that was loaded
      */
@@ -508,36 +552,47 @@ private:
 #ifdef ALLOLIB_WEBGPU
         if (!mReady || mWebGPUTextureCreated) return;
 
-        // HDR data is RGB float, but WebGPU prefers RGBA
-        // Convert RGB to RGBA
-        int w = mHdr.width();
-        int h = mHdr.height();
-        std::vector<float> rgbaData(w * h * 4);
-        const float* rgb = mHdr.pixels();
-
-        for (int i = 0; i < w * h; i++) {
-            rgbaData[i * 4 + 0] = rgb[i * 3 + 0];
-            rgbaData[i * 4 + 1] = rgb[i * 3 + 1];
-            rgbaData[i * 4 + 2] = rgb[i * 3 + 2];
-            rgbaData[i * 4 + 3] = 1.0f;  // Alpha
-        }
+        if (!mHdr.texels()) return;
 
         // Create texture descriptor
         TextureDesc desc;
-        desc.width = w;
-        desc.height = h;
-        desc.format = PixelFormat::RGBA32F;  // HDR float texture
+        desc.width = mHdr.width();
+        desc.height = mHdr.height();
+        desc.format = PixelFormat::RGB9E5;  // Shared-exponent HDR, 4 bytes/texel
         desc.minFilter = FilterMode::Linear;
         desc.magFilter = FilterMode::Linear;
         desc.wrapS = WrapMode::Repeat;      // Equirectangular wraps horizontally
         desc.wrapT = WrapMode::ClampToEdge; // Clamp vertically
 
-        // Create texture with HDR pixel data (converted to RGBA)
-        TextureHandle handle = backend->createTexture(desc, rgbaData.data());
-        if (handle.valid()) {
-            mWebGPUTextureId = handle.id;
+        // Create texture with the packed texels (unless another user of
+        // this environment already did), then drop the CPU copy
+        GPUTextureRef texture = GPUResourceCache::instance().acquire(cacheKey(), [&](GPUTexture& t) {
+            t.handle = backend->createTexture(desc, mHdr.texels());
+            t.backend = backend;
+            t.width = desc.width;
+            t.height = desc.height;
+            t.bytes = (size_t)desc.width * desc.height * 4;
+            return t.handle.valid();
+        });
+        if (texture) {
+            // Convert to a cubemap for the texture_cube pipelines; the
+            // equirect is only kept if that fails
+            auto* webgpu = static_cast<WebGPUBackend*>(backend);
+            mCubeTexture = GPUResourceCache::instance().acquire(cubeKey(), [&](GPUTexture& t) {
+                int size = IBLBaker::cubeFaceSize(desc.width);
+                t.handle = webgpu->bakeEnvironmentCube(texture->handle, size);
+                t.backend = backend;
+                t.width = t.height = size;
+                t.cube = true;
+                t.bytes = (size_t)size * size * 6 * 8 * 4 / 3;
+                return t.handle.valid();
+            });
+            if (!mCubeTexture) mTexture = texture;
+            mWebGPUTextureId = mCubeTexture ? mCubeTexture->handle.id : texture->handle.id;
             mWebGPUTextureCreated = true;
-            printf("[WebEnvironment] Created WebGPU texture %llu (%dx%d)\n",
+            mHdr.releasePixels();
+            printf("[WebEnvironment] Using WebGPU %s texture %llu (%dx%d)\n",
+                   mCubeTexture ? "cube" : "equirect",
                    (unsigned long long)mWebGPUTextureId, desc.width, desc.height);
         } else {
             printf("[WebEnvironment] ERROR: Failed to create WebGPU texture!\n");
@@ -583,23 +638,67 @@ private:
     void uploadIfNeeded() {
         if (!mNeedsUpload || !mReady) return;
 
-        // Upload HDR data as RGB float texture
-        glBindTexture(GL_TEXTURE_2D, mTextureId);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F,
-                     mHdr.width(), mHdr.height(), 0,
-                     GL_RGB, GL_FLOAT, mHdr.pixels());
-        glBindTexture(GL_TEXTURE_2D, 0);
+        // Upload HDR data as shared-exponent texture (unless another user
+        // of this environment already did), then drop the CPU copy
+        bool uploaded = false;
+        mTexture = GPUResourceCache::instance().acquire(cacheKey(), [&](GPUTexture& t) {
+            glGenTextures(1, &t.id);
+            glBindTexture(GL_TEXTURE_2D, t.id);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB9_E5,
+                         mHdr.width(), mHdr.height(), 0,
+                         GL_RGB, GL_UNSIGNED_INT_5_9_9_9_REV, mHdr.texels());
+            glBindTexture(GL_TEXTURE_2D, 0);
+            t.width = mHdr.width();
+            t.height = mHdr.height();
+            t.bytes = (size_t)t.width * t.height * 4;
+            uploaded = true;
+            return true;
+        });
+        mTextureId = mTexture ? mTexture->id : 0;
+        mHdr.releasePixels();
+
+        // Cubemap for the skybox and reflections (needs float render
+        // targets, as the cube shaders)
+        if (mTexture && mCubeShadersCompiled) {
+            mCubeTexture = GPUResourceCache::instance().acquire(cubeKey(), [&](GPUTexture& t) {
+                return IBLBaker::cubemap(mTexture->id, mTexture->width, mTexture->height, t);
+            });
+        }
 
         mNeedsUpload = false;
-        printf("[WebEnvironment] Uploaded HDR texture: %dx%d\n", mHdr.width(), mHdr.height());
+        printf("[WebEnvironment] %s HDR texture: %dx%d%s\n", uploaded ? "Uploaded" : "Shared",
+               mHdr.width(), mHdr.height(), mCubeTexture ? " (+cubemap)" : "");
+    }
+
+    void bindEnvTexture() {
+        if (mCubeTexture) glBindTexture(GL_TEXTURE_CUBE_MAP, mCubeTexture->id);
+        else glBindTexture(GL_TEXTURE_2D, mTextureId);
+    }
+
+    void unbindEnvTexture() {
+        glBindTexture(mCubeTexture ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D, 0);
     }
 
+    /// Shared with WebPBR environments of the same URL (same format and wrap)
+    std::string cacheKey() const { return "env:" + mUrl; }
+    /// Cubemap conversion, shared with WebPBR's skybox
+    std::string cubeKey() const { return "envcube:" + mUrl; }
+
     std::string mUrl;
     WebHDR mHdr;
+    GPUTextureRef mTexture;
+    GPUTextureRef mCubeTexture;  // Equirect converted to a cubemap
     GLuint mTextureId;
     Mesh mSkyboxMesh;
     ShaderProgram mSkyboxShader;
     ShaderProgram mReflectShader;
+    ShaderProgram mSkyboxCubeShader;   // ENV_CUBE variants
+    ShaderProgram mReflectCubeShader;
+    bool mCubeShadersCompiled = false;
     bool mReady;
     bool mCreated;
     bool mNeedsUpload = false;
@@ -8,6 +8,7 @@
  *   // Download data as file
  *   WebFile::download("mydata.txt", textContent);
  *   WebFile::downloadBinary("mydata.bin", binaryData, size);
+ *   WebFile::downloadFile("/tmp/render.wav");   // straight from MEMFS/IDBFS
  *
  *   // Upload file with callback
  *   WebFile::upload([](const std::string& name, const uint8_t* data, size_t size) {
@@ -134,6 +135,41 @@ public:
         }, filename.c_str(), json.c_str());
     }
 
+    /**
+     * Download a file from the virtual filesystem (MEMFS/IDBFS) without
+     * copying it through the WASM heap
+     * @param path Filesystem path, e.g. a WavFileWriter output
+     * @param filename Suggested filename (default: the path's basename)
+     */
+    static void downloadFile(const std::string& path, const std::string& filename = "",
+                             const std::string& mimeType = "application/octet-stream") {
+        EM_ASM({
+            var path = UTF8ToString($0);
+            var filename = UTF8ToString($1) || path.split('/').pop();
+            var mimeType = UTF8ToString($2);
+
+            var data;
+            try {
+                data = FS.readFile(path);
+            } catch (e) {
+                console.error('[WebFile] Cannot read', path, e);
+                return;
+            }
+            var blob = new Blob([data], { type: mimeType });
+            var url = URL.createObjectURL(blob);
+
+            var a = document.createElement('a');
+            a.href = url;
+            a.download = filename;
+            document.body.appendChild(a);
+            a.click();
+            document.body.removeChild(a);
+            URL.revokeObjectURL(url);
+
+            console.log('[WebFile] Downloaded file:', path, data.length, 'bytes');
+        }, path.c_str(), filename.c_str(), mimeType.c_str());
+    }
+
     /**
      * Open file upload dialog (single file)
      * @param callback Function called when file is uploaded
@@ -13,18 +13,43 @@
  *
  * Note: This creates a texture atlas at load time with ASCII characters.
  * For full Unicode support, consider loading a pre-made font atlas.
+ *
+ * Signed distance fields:
+ *   font.loadSDF("Arial", 16);            // 16 px by default, any size later
+ *   font.render(g, "gain", 10, 10, 40);   // same atlas, 40 px, still sharp
+ *
+ * loadSDF rasterizes the glyphs once at 48 px and stores distance to the
+ * glyph edge instead of coverage, so one linear-filtered texture stays
+ * crisp from small labels to titles. On WebGL2 SDF text is drawn by the
+ * font's own shader in g.currentColor(); on WebGPU it goes through g.draw()
+ * like bitmap text.
+ *
+ * Text meshes are cached per string (up to 256, least recently used
+ * evicted), in atlas units; position and size are applied as a transform,
+ * so a label that doesn't change is never rebuilt or, for SDF fonts,
+ * re-uploaded. For many labels per frame, TextBatch collects them and
+ * draws each font's labels in one call:
+ *
+ *   TextBatch labels;                     // member, reused every frame
+ *   labels.clear();
+ *   labels.add(font, "cutoff", 10, 10);
+ *   labels.add(font, "resonance", 10, 30, 12, Color(1, 0.8f, 0.2f));
+ *   labels.draw(g);
  */
 
 #ifndef AL_WEB_FONT_HPP
 #define AL_WEB_FONT_HPP
 
 #include <emscripten.h>
+#include <algorithm>
+#include <cmath>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <cstdint>
 #include "al/graphics/al_Graphics.hpp"
 #include "al/graphics/al_Mesh.hpp"
+#include "al/graphics/al_OpenGL.hpp"
 
 namespace al {
 
@@ -39,7 +64,7 @@ struct Glyph {
 };
 
 /**
- * Bitmap font using texture atlas
+ * Bitmap or signed-distance-field font using a texture atlas
  */
 class WebFont {
 public:
@@ -47,8 +72,13 @@ public:
 
     ~WebFont() {
         // Texture cleanup handled by Texture destructor
+        clearTextCache();
+        delete mSDFShader;
     }
 
+    WebFont(const WebFont&) = delete;
+    WebFont& operator=(const WebFont&) = delete;
+
     /**
      * Load a font with specified family and size
      * @param fontFamily CSS font family (e.g., "Arial", "monospace")
@@ -56,9 +86,35 @@ public:
      * @param bold Whether to use bold weight
      */
     void load(const std::string& fontFamily = "Arial", int size = 24, bool bold = false) {
+        mSDFSpread = 0;
+        generateAtlas(fontFamily, size, size, bold);
+    }
+
+    /**
+     * Load a signed-distance-field font, drawable at any size
+     * @param fontFamily CSS font family (e.g., "Arial", "monospace")
+     * @param size Default size in pixels for render() without a size
+     * @param bold Whether to use bold weight
+     */
+    void loadSDF(const std::string& fontFamily = "Arial", int size = 24, bool bold = false) {
+        mSDFSpread = kSDFSpread;
+        generateAtlas(fontFamily, size, kSDFGlyphSize, bold);
+    }
+
+    /**
+     * Whether the atlas holds distance fields (loadSDF) rather than coverage
+     */
+    bool isSDF() const { return mSDFSpread > 0; }
+
+private:
+    // Rasterize the ASCII glyphs at glyphSize px; an SDF atlas leaves
+    // mSDFSpread px around each glyph for the distance ramp
+    void generateAtlas(const std::string& fontFamily, int size, int glyphSize, bool bold) {
         mFontFamily = fontFamily;
         mSize = size;
         mBold = bold;
+        mLoaded = false;
+        clearTextCache();
 
         // Generate font atlas using Canvas 2D
         EM_ASM({
@@ -66,22 +122,12 @@ public:
             var fontFamily = UTF8ToString($1);
             var size = $2;
             var bold = $3;
+            var margin = $4;  // Empty border around each glyph (SDF ramp)
 
-            // Create offscreen canvas
             var canvas = document.createElement('canvas');
-            var atlasSize = 512;  // Power of 2 for WebGL
-            canvas.width = atlasSize;
-            canvas.height = atlasSize;
             var ctx = canvas.getContext('2d');
-
-            // Set font
             var fontStyle = (bold ? 'bold ' : '') + size + 'px ' + fontFamily;
             ctx.font = fontStyle;
-            ctx.textBaseline = 'top';
-            ctx.fillStyle = 'white';
-
-            // Clear with transparent black
-            ctx.clearRect(0, 0, atlasSize, atlasSize);
 
             // Characters to include (ASCII printable range)
             var chars = '';
@@ -89,43 +135,67 @@ public:
                 chars += String.fromCharCode(i);
             }
 
-            // Layout characters in grid
             var padding = 2;
-            var x = padding;
-            var y = padding;
-            var maxHeight = 0;
-            var glyphData = [];
-
+            var charHeight = size + 4 + 2 * margin;  // Approximate height
+            var cells = [];
             for (var i = 0; i < chars.length; i++) {
-                var ch = chars[i];
-                var metrics = ctx.measureText(ch);
-                var charWidth = Math.ceil(metrics.width) + 1;
-                var charHeight = size + 4;  // Approximate height
-
-                // Check if we need to move to next row
-                if (x + charWidth + padding > atlasSize) {
-                    x = padding;
-                    y += maxHeight + padding;
-                    maxHeight = 0;
+                var metrics = ctx.measureText(chars[i]);
+                cells.push({
+                    advance: metrics.width,
+                    width: Math.ceil(metrics.width) + 1 + 2 * margin
+                });
+            }
+
+            // Layout characters in rows; returns false if they don't fit
+            function layout(atlasSize) {
+                var x = padding;
+                var y = padding;
+                for (var i = 0; i < cells.length; i++) {
+                    if (x + cells[i].width + padding > atlasSize) {
+                        x = padding;
+                        y += charHeight + padding;
+                    }
+                    cells[i].x = x;
+                    cells[i].y = y;
+                    x += cells[i].width + padding;
                 }
+                return y + charHeight + padding <= atlasSize;
+            }
+
+            // Smallest power of 2 (for WebGL) that holds every glyph
+            var atlasSize = 256;
+            while (!layout(atlasSize) && atlasSize < 4096) atlasSize *= 2;
+
+            // Resizing resets the context, so set the font afterwards
+            canvas.width = atlasSize;
+            canvas.height = atlasSize;
+            ctx.font = fontStyle;
+            ctx.textBaseline = 'top';
+            ctx.fillStyle = 'white';
+
+            // Clear with transparent black
+            ctx.clearRect(0, 0, atlasSize, atlasSize);
+
+            var glyphData = [];
+            for (var i = 0; i < chars.length; i++) {
+                var c = cells[i];
 
                 // Draw character
-                ctx.fillText(ch, x, y);
+                ctx.fillText(chars[i], c.x + margin, c.y + margin);
 
-                // Store glyph info
+                // Store glyph info; the quad covers the margin too
                 glyphData.push({
                     code: chars.charCodeAt(i),
-                    u0: x / atlasSize,
-                    v0: y / atlasSize,
-                    u1: (x + charWidth) / atlasSize,
-                    v1: (y + charHeight) / atlasSize,
-                    width: charWidth,
+                    u0: c.x / atlasSize,
+                    v0: c.y / atlasSize,
+                    u1: (c.x + c.width) / atlasSize,
+                    v1: (c.y + charHeight) / atlasSize,
+                    width: c.width,
                     height: charHeight,
-                    advance: metrics.width
+                    xOffset: -margin,
+                    yOffset: -margin,
+                    advance: c.advance
                 });
-
-                x += charWidth + padding;
-                maxHeight = Math.max(maxHeight, charHeight);
             }
 
             // Get pixel data
@@ -154,9 +224,10 @@ public:
             _free(ptr);
             _free(glyphPtr);
 
-        }, this, fontFamily.c_str(), size, bold ? 1 : 0);
+        }, this, fontFamily.c_str(), glyphSize, bold ? 1 : 0, mSDFSpread);
     }
 
+public:
     /**
      * Check if font is loaded and ready
      */
@@ -173,9 +244,9 @@ public:
     float lineHeight() const { return mLineHeight; }
 
     /**
-     * Measure text width
+     * Measure text width (at size(), or at `size` px)
      */
-    float measureWidth(const std::string& text) const {
+    float measureWidth(const std::string& text, float size = 0) const {
         if (!mLoaded) return 0;
 
         float width = 0;
@@ -185,7 +256,7 @@ public:
                 width += it->second.advance;
             }
         }
-        return width;
+        return width * scaleFor(size);
     }
 
     /**
@@ -197,16 +268,154 @@ public:
     void buildMesh(Mesh& mesh, const std::string& text, float x = 0, float y = 0) const {
         if (!mLoaded) return;
 
+        std::vector<float> quads;
+        appendQuads(quads, text);
         mesh.reset();
-        mesh.primitive(Mesh::TRIANGLES);
+        appendToMesh(mesh, quads, x, y, scaleFor(0));
+    }
 
-        float curX = x;
-        float curY = y;
+    /**
+     * Render text directly, at size() or at `size` px
+     * Note: bitmap fonts require proper shader setup for textured quads
+     */
+    void render(Graphics& g, const std::string& text, float x, float y, float size = 0) {
+        if (!mLoaded || text.empty()) return;
+
+        CachedText& cached = cachedText(text);
+        if (cached.quads.empty()) return;
+        const float s = scaleFor(size);
+
+        g.pushMatrix();
+        g.translate(x, y);
+        g.scale(s);
+        if (isSDF() && !Graphics_isWebGPU() && beginSDF(g)) {
+            if (!cached.vao) {
+                glGenVertexArrays(1, &cached.vao);
+                glGenBuffers(1, &cached.vbo);
+                glBindVertexArray(cached.vao);
+                glBindBuffer(GL_ARRAY_BUFFER, cached.vbo);
+                glBufferData(GL_ARRAY_BUFFER, cached.quads.size() * sizeof(float),
+                             cached.quads.data(), GL_STATIC_DRAW);
+                glEnableVertexAttribArray(0);
+                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+                glEnableVertexAttribArray(2);
+                glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                                      (void*)(2 * sizeof(float)));
+            }
+            glBindVertexArray(cached.vao);
+            // No per-vertex color: attribute 1 reads this constant instead
+            const Color& c = g.currentColor();
+            glVertexAttrib4f(1, c.r, c.g, c.b, c.a);
+            glDrawArrays(GL_TRIANGLES, 0, GLsizei(cached.quads.size() / 4));
+            endSDF(g);
+        } else {
+            if (!cached.meshBuilt) {
+                appendToMesh(cached.mesh, cached.quads, 0, 0, 1);
+                cached.meshBuilt = true;
+            }
+            // Bind texture and draw
+            mTexture.bind();
+            g.draw(cached.mesh);
+            mTexture.unbind();
+        }
+        g.popMatrix();
+    }
+
+    /**
+     * Strings currently held in the text mesh cache
+     */
+    size_t cachedTextCount() const { return mTextCache.size(); }
+
+    /**
+     * Get the font texture for manual rendering
+     */
+    Texture& texture() { return mTexture; }
+
+    // Internal callback from JavaScript
+    void _onLoaded(uint8_t* atlasData, int atlasSize, int fontSize, const char* glyphJson) {
+        mGlyphSize = fontSize;
+        mLineHeight = mSize * 1.2f;
+
+        // Create texture from atlas data
+        mTexture.create2D(atlasSize, atlasSize, Texture::R8, Texture::RED, Texture::UBYTE);
+        if (isSDF()) {
+            const std::vector<uint8_t> field = distanceField(atlasData, atlasSize, mSDFSpread);
+            mTexture.filter(Texture::LINEAR);
+            mTexture.submit(field.data());
+        } else {
+            mTexture.submit(atlasData);
+        }
+
+        // Parse glyph data from JSON
+        std::string json(glyphJson);
+        parseGlyphs(json);
+
+        mLoaded = true;
+        printf("[WebFont] Loaded: %s %dpx%s, %zu glyphs, %dx%d atlas\n",
+               mFontFamily.c_str(), mSize, isSDF() ? " SDF" : "", mGlyphs.size(),
+               atlasSize, atlasSize);
+    }
+
+    /**
+     * Signed distance field of an 8-bit coverage image (size x size).
+     * 128 is the glyph edge, 255 is `spread` px inside, 0 `spread` px
+     * outside. Exact Euclidean distances (Felzenszwalb & Huttenlocher).
+     */
+    static std::vector<uint8_t> distanceField(const uint8_t* coverage, int size, int spread) {
+        const size_t n = size_t(size) * size;
+        std::vector<float> outside(n), inside(n);
+        for (size_t i = 0; i < n; ++i) {
+            const bool in = coverage[i] >= 128;
+            outside[i] = in ? 0.f : kFar;  // Squared distance to the glyph
+            inside[i] = in ? kFar : 0.f;   // Squared distance to the background
+        }
+        squaredDistance2D(outside.data(), size);
+        squaredDistance2D(inside.data(), size);
+
+        std::vector<uint8_t> field(n);
+        for (size_t i = 0; i < n; ++i) {
+            // Pixel centers sit half a pixel from the edge between them
+            const float dOut = outside[i] > 0.f ? std::sqrt(outside[i]) - 0.5f : 0.f;
+            const float dIn = inside[i] > 0.f ? std::sqrt(inside[i]) - 0.5f : 0.f;
+            const float v = 0.5f + 0.5f * (dIn - dOut) / float(spread);
+            field[i] = uint8_t(std::min(255.f, std::max(0.f, v * 255.f + 0.5f)));
+        }
+        return field;
+    }
+
+private:
+    friend class TextBatch;
+
+    static constexpr int kSDFGlyphSize = 48;
+    static constexpr int kSDFSpread = 6;
+    static constexpr size_t kMaxCachedText = 256;
+    static constexpr float kFar = 1e20f;
+
+    // Glyph quads of one string in atlas units: 6 vertices of x, y, u, v
+    struct CachedText {
+        std::vector<float> quads;
+        Mesh mesh;
+        bool meshBuilt = false;
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        uint64_t lastUse = 0;
+    };
+
+    // Scale from atlas units to `size` px (0 = size())
+    float scaleFor(float size) const {
+        const float target = size > 0 ? size : float(mSize);
+        return mGlyphSize > 0 ? target / float(mGlyphSize) : 1.f;
+    }
+
+    void appendQuads(std::vector<float>& out, const std::string& text) const {
+        const float lineHeight = mGlyphSize * 1.2f;
+        float curX = 0;
+        float curY = 0;
 
         for (char c : text) {
             if (c == '\n') {
-                curX = x;
-                curY += mLineHeight;
+                curX = 0;
+                curY += lineHeight;
                 continue;
             }
 
@@ -216,71 +425,175 @@ public:
             const Glyph& g = it->second;
 
             // Quad vertices (two triangles)
-            float x0 = curX;
-            float y0 = curY;
-            float x1 = curX + g.width;
-            float y1 = curY + g.height;
-
-            // First triangle
-            mesh.vertex(x0, y0, 0);
-            mesh.texCoord(g.u0, g.v0);
-            mesh.vertex(x1, y0, 0);
-            mesh.texCoord(g.u1, g.v0);
-            mesh.vertex(x1, y1, 0);
-            mesh.texCoord(g.u1, g.v1);
-
-            // Second triangle
-            mesh.vertex(x0, y0, 0);
-            mesh.texCoord(g.u0, g.v0);
-            mesh.vertex(x1, y1, 0);
-            mesh.texCoord(g.u1, g.v1);
-            mesh.vertex(x0, y1, 0);
-            mesh.texCoord(g.u0, g.v1);
+            const float x0 = curX + g.xOffset;
+            const float y0 = curY + g.yOffset;
+            const float x1 = x0 + g.width;
+            const float y1 = y0 + g.height;
+            const float quad[24] = {
+                x0, y0, g.u0, g.v0,  x1, y0, g.u1, g.v0,  x1, y1, g.u1, g.v1,
+                x0, y0, g.u0, g.v0,  x1, y1, g.u1, g.v1,  x0, y1, g.u0, g.v1,
+            };
+            out.insert(out.end(), quad, quad + 24);
 
             curX += g.advance;
         }
     }
 
-    /**
-     * Render text directly
-     * Note: Requires proper shader setup for textured quads
-     */
-    void render(Graphics& g, const std::string& text, float x, float y) {
-        if (!mLoaded) return;
+    static void appendToMesh(Mesh& mesh, const std::vector<float>& quads,
+                             float x, float y, float scale) {
+        mesh.primitive(Mesh::TRIANGLES);
+        for (size_t i = 0; i + 3 < quads.size(); i += 4) {
+            mesh.vertex(x + quads[i] * scale, y + quads[i + 1] * scale, 0);
+            mesh.texCoord(quads[i + 2], quads[i + 3]);
+        }
+    }
 
-        Mesh textMesh;
-        buildMesh(textMesh, text, x, y);
+    CachedText& cachedText(const std::string& text) {
+        auto it = mTextCache.find(text);
+        if (it == mTextCache.end()) {
+            if (mTextCache.size() >= kMaxCachedText) {
+                auto oldest = mTextCache.begin();
+                for (auto e = mTextCache.begin(); e != mTextCache.end(); ++e) {
+                    if (e->second.lastUse < oldest->second.lastUse) oldest = e;
+                }
+                releaseGL(oldest->second);
+                mTextCache.erase(oldest);
+            }
+            it = mTextCache.emplace(text, CachedText()).first;
+            appendQuads(it->second.quads, text);
+        }
+        it->second.lastUse = ++mUseClock;
+        return it->second;
+    }
 
-        // Bind texture and draw
-        mTexture.bind();
-        g.draw(textMesh);
-        mTexture.unbind();
+    static void releaseGL(CachedText& cached) {
+        if (cached.vao) glDeleteVertexArrays(1, &cached.vao);
+        if (cached.vbo) glDeleteBuffers(1, &cached.vbo);
+        cached.vao = cached.vbo = 0;
     }
 
-    /**
-     * Get the font texture for manual rendering
-     */
-    Texture& texture() { return mTexture; }
+    void clearTextCache() {
+        for (auto& e : mTextCache) releaseGL(e.second);
+        mTextCache.clear();
+    }
 
-    // Internal callback from JavaScript
-    void _onLoaded(uint8_t* atlasData, int atlasSize, int fontSize, const char* glyphJson) {
-        mSize = fontSize;
-        mLineHeight = fontSize * 1.2f;
+    // Separable exact squared Euclidean distance transform, in place
+    static void squaredDistance2D(float* grid, int size) {
+        std::vector<float> f(size), d(size), z(size + 1);
+        std::vector<int> v(size);
+        for (int x = 0; x < size; ++x) {
+            for (int y = 0; y < size; ++y) f[y] = grid[size_t(y) * size + x];
+            squaredDistance1D(f.data(), d.data(), v.data(), z.data(), size);
+            for (int y = 0; y < size; ++y) grid[size_t(y) * size + x] = d[y];
+        }
+        for (int y = 0; y < size; ++y) {
+            float* row = grid + size_t(y) * size;
+            std::copy(row, row + size, f.begin());
+            squaredDistance1D(f.data(), row, v.data(), z.data(), size);
+        }
+    }
 
-        // Create texture from atlas data
-        mTexture.create2D(atlasSize, atlasSize, Texture::R8, Texture::RED, Texture::UBYTE);
-        mTexture.submit(atlasData);
+    // Where the parabolas rooted at q and p cross
+    static float intersect(const float* f, int q, int p) {
+        return ((f[q] + float(q) * q) - (f[p] + float(p) * p)) / float(2 * q - 2 * p);
+    }
 
-        // Parse glyph data from JSON
-        std::string json(glyphJson);
-        parseGlyphs(json);
+    // Lower envelope of the parabolas rooted at f
+    static void squaredDistance1D(const float* f, float* d, int* v, float* z, int n) {
+        int k = 0;
+        v[0] = 0;
+        z[0] = -kFar;
+        z[1] = kFar;
+        for (int q = 1; q < n; ++q) {
+            // z[0] = -inf keeps k from going below 0
+            float s = intersect(f, q, v[k]);
+            while (s <= z[k]) s = intersect(f, q, v[--k]);
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = kFar;
+        }
+        k = 0;
+        for (int q = 0; q < n; ++q) {
+            while (z[k + 1] < float(q)) ++k;
+            const float dq = float(q - v[k]);
+            d[q] = dq * dq + f[v[k]];
+        }
+    }
 
-        mLoaded = true;
-        printf("[WebFont] Loaded: %s %dpx, %zu glyphs\n",
-               mFontFamily.c_str(), mSize, mGlyphs.size());
+    static const char* sdfVertShader() {
+        return R"(#version 300 es
+precision highp float;
+
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec4 color;
+layout (location = 2) in vec2 texcoord;
+
+uniform mat4 al_ModelViewMatrix;
+uniform mat4 al_ProjectionMatrix;
+
+out vec4 vColor;
+out vec2 vTexcoord;
+
+void main() {
+    vColor = color;
+    vTexcoord = texcoord;
+    gl_Position = al_ProjectionMatrix * al_ModelViewMatrix * vec4(position, 0.0, 1.0);
+}
+)";
+    }
+
+    static const char* sdfFragShader() {
+        return R"(#version 300 es
+precision highp float;
+
+in vec4 vColor;
+in vec2 vTexcoord;
+
+uniform sampler2D atlas;
+
+out vec4 frag_color;
+
+void main() {
+    float d = texture(atlas, vTexcoord).r;
+    // About one screen pixel of antialiasing at any scale
+    float w = max(fwidth(d) * 0.7, 1e-4);
+    float a = smoothstep(0.5 - w, 0.5 + w, d) * vColor.a;
+    if (a <= 0.0) discard;
+    frag_color = vec4(vColor.rgb, a);
+}
+)";
+    }
+
+    // Bind the SDF shader and atlas with the current matrices; false if the
+    // shader isn't available (text then draws through g.draw)
+    bool beginSDF(Graphics& g) {
+        if (!mSDFShader) {
+            mSDFShader = new ShaderProgram();
+            mSDFShaderOk = mSDFShader->compile(sdfVertShader(), sdfFragShader());
+            if (!mSDFShaderOk) printf("[WebFont] SDF shader failed to compile\n");
+        }
+        if (!mSDFShaderOk) return false;
+
+        mSDFShader->use();
+        mSDFShader->uniform("al_ModelViewMatrix", g.viewMatrix() * g.modelMatrix());
+        mSDFShader->uniform("al_ProjectionMatrix", g.projMatrix());
+        mSDFShader->uniform("atlas", 0);
+        mTexture.bind(0);
+        mBlendWasOn = glIsEnabled(GL_BLEND);
+        if (!mBlendWasOn) glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        return true;
+    }
+
+    void endSDF(Graphics& g) {
+        glBindVertexArray(0);
+        if (!mBlendWasOn) glDisable(GL_BLEND);
+        mTexture.unbind(0);
+        // Graphics expects its own program to still be bound
+        if (ShaderProgram* current = g.shaderPtr()) current->use();
     }
 
-private:
     void parseGlyphs(const std::string& json) {
         mGlyphs.clear();
 
@@ -314,8 +627,8 @@ private:
             g.width = getNumber("width");
             g.height = getNumber("height");
             g.advance = getNumber("advance");
-            g.xOffset = 0;
-            g.yOffset = 0;
+            g.xOffset = getNumber("xOffset");
+            g.yOffset = getNumber("yOffset");
 
             if (code > 0) {
                 mGlyphs[(char)code] = g;
@@ -327,11 +640,137 @@ private:
 
     std::string mFontFamily;
     int mSize;
+    int mGlyphSize = 24;   // Size the atlas glyphs were rasterized at
+    int mSDFSpread = 0;    // 0 for a coverage (bitmap) atlas
     bool mBold;
     float mLineHeight;
     bool mLoaded;
     Texture mTexture;
     std::unordered_map<char, Glyph> mGlyphs;
+
+    std::unordered_map<std::string, CachedText> mTextCache;
+    uint64_t mUseClock = 0;
+    ShaderProgram* mSDFShader = nullptr;
+    bool mSDFShaderOk = false;
+    bool mBlendWasOn = false;
+};
+
+/**
+ * Labels collected over a frame and drawn with one call per font.
+ *
+ * Glyph quads come from each font's text cache, so add() is a copy with a
+ * scale and offset. For SDF fonts on WebGL2 the vertex buffer is only
+ * re-uploaded when the labels differ from the last draw. Fonts must
+ * outlive the batch.
+ */
+class TextBatch {
+public:
+    TextBatch() = default;
+    ~TextBatch() {
+        for (Run& r : mRuns) {
+            if (r.vao) glDeleteVertexArrays(1, &r.vao);
+            if (r.vbo) glDeleteBuffers(1, &r.vbo);
+        }
+    }
+
+    TextBatch(const TextBatch&) = delete;
+    TextBatch& operator=(const TextBatch&) = delete;
+
+    /// Start over (keeps GPU buffers for the next draw)
+    void clear() {
+        for (Run& r : mRuns) r.vertices.clear();
+    }
+
+    /// Queue `text` at (x, y), `size` px (0 = font.size())
+    void add(WebFont& font, const std::string& text, float x, float y,
+             float size = 0, const Color& color = Color(1, 1, 1, 1)) {
+        if (!font.ready() || text.empty()) return;
+        const WebFont::CachedText& cached = font.cachedText(text);
+        const float s = font.scaleFor(size);
+        std::vector<float>& out = run(font).vertices;
+        out.reserve(out.size() + cached.quads.size() * 2);
+        for (size_t i = 0; i + 3 < cached.quads.size(); i += 4) {
+            const float v[8] = {x + cached.quads[i] * s, y + cached.quads[i + 1] * s,
+                                cached.quads[i + 2], cached.quads[i + 3],
+                                color.r, color.g, color.b, color.a};
+            out.insert(out.end(), v, v + 8);
+        }
+    }
+
+    /// Draw everything queued since clear()
+    void draw(Graphics& g) {
+        for (Run& r : mRuns) {
+            if (r.vertices.empty()) continue;
+            const GLsizei count = GLsizei(r.vertices.size() / 8);
+            if (r.font->isSDF() && !Graphics_isWebGPU() && r.font->beginSDF(g)) {
+                if (!r.vao) createBuffers(r);
+                glBindVertexArray(r.vao);
+                if (r.vertices != r.uploaded) {
+                    glBindBuffer(GL_ARRAY_BUFFER, r.vbo);
+                    glBufferData(GL_ARRAY_BUFFER, r.vertices.size() * sizeof(float),
+                                 r.vertices.data(), GL_DYNAMIC_DRAW);
+                    r.uploaded = r.vertices;
+                }
+                glDrawArrays(GL_TRIANGLES, 0, count);
+                r.font->endSDF(g);
+            } else {
+                r.mesh.reset();
+                r.mesh.primitive(Mesh::TRIANGLES);
+                for (size_t i = 0; i + 7 < r.vertices.size(); i += 8) {
+                    const float* v = &r.vertices[i];
+                    r.mesh.vertex(v[0], v[1], 0);
+                    r.mesh.texCoord(v[2], v[3]);
+                    r.mesh.color(v[4], v[5], v[6], v[7]);
+                }
+                r.font->texture().bind();
+                g.draw(r.mesh);
+                r.font->texture().unbind();
+            }
+        }
+    }
+
+    /// Glyphs queued since clear()
+    size_t glyphCount() const {
+        size_t n = 0;
+        for (const Run& r : mRuns) n += r.vertices.size() / 48;
+        return n;
+    }
+
+private:
+    // Interleaved x, y, u, v, r, g, b, a per vertex, for one font
+    struct Run {
+        WebFont* font = nullptr;
+        std::vector<float> vertices;
+        std::vector<float> uploaded;
+        Mesh mesh;
+        GLuint vao = 0;
+        GLuint vbo = 0;
+    };
+
+    Run& run(WebFont& font) {
+        for (Run& r : mRuns) {
+            if (r.font == &font) return r;
+        }
+        mRuns.emplace_back();
+        mRuns.back().font = &font;
+        return mRuns.back();
+    }
+
+    static void createBuffers(Run& r) {
+        glGenVertexArrays(1, &r.vao);
+        glGenBuffers(1, &r.vbo);
+        glBindVertexArray(r.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, r.vbo);
+        const GLsizei stride = 8 * sizeof(float);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(4 * sizeof(float)));
+    }
+
+    std::vector<Run> mRuns;
 };
 
 } // namespace al
@@ -0,0 +1,117 @@
+/**
+ * Web Frame Stats - frame interval window for FPS and frame-time percentiles
+ *
+ * The profiler answers where a frame goes but is off by default and keeps
+ * far more than a summary needs. WebApp records the interval between
+ * main-loop callbacks here every frame, always: a window of the last
+ * kWindow intervals in a fixed ring, one store per frame.
+ *
+ * summary() sorts a copy of the window, so call it from tooling (the perf
+ * regression suite polls window.allolib.perf.getStats()), not per frame.
+ * Intervals are measured before WebApp clamps dt for onAnimate, so stalls
+ * show up at their real length.
+ *
+ * Each frame also carries its CPU and GPU cost (FrameTimings), which is
+ * what QualityManager::update(dt, timings) steers by: the interval alone
+ * cannot tell a GPU-bound frame from a CPU-bound one, or show headroom
+ * under vsync.
+ */
+
+#ifndef AL_WEB_FRAME_STATS_HPP
+#define AL_WEB_FRAME_STATS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace al {
+
+/// One frame's cost, as recorded by WebApp (WebApp::frameTimings())
+struct FrameTimings {
+    float intervalMs = 0.0f;    // Since the previous frame
+    float cpuMs = 0.0f;         // Main-thread frame work: onAnimate, onDraw, submit
+    float gpuMs = 0.0f;         // Backend GPU time, a few frames old; 0 if unmeasured
+    float renderScale = 1.0f;   // Render scale the frame was drawn at
+};
+
+/**
+ * Summary of the window, laid out for JS to read from the wasm heap:
+ * field n is HEAPU32/HEAPF32[(ptr >> 2) + n].
+ */
+struct FrameStatsSummary {
+    uint32_t frames = 0;       // Intervals in the window
+    float meanMs = 0.0f;
+    float p50Ms = 0.0f;
+    float p95Ms = 0.0f;
+    float p99Ms = 0.0f;
+    float maxMs = 0.0f;
+    uint32_t total = 0;        // Intervals recorded since the last reset
+    float cpuMs = 0.0f;        // Moving average of FrameTimings::cpuMs
+    float gpuMs = 0.0f;        // Latest FrameTimings::gpuMs
+    float renderScale = 1.0f;  // Latest FrameTimings::renderScale
+};
+static_assert(sizeof(FrameStatsSummary) == 10 * 4, "FrameStatsSummary is read by offset from JS");
+
+class FrameStats {
+public:
+    static constexpr uint32_t kWindow = 600;  // About 10 s at 60 Hz
+
+    void record(const FrameTimings& timings) {
+        mIntervals[mNext] = timings.intervalMs;
+        mNext = (mNext + 1) % kWindow;
+        if (mCount < kWindow) ++mCount;
+        ++mTotal;
+        mCpuMs = mTotal == 1 ? timings.cpuMs : mCpuMs * 0.95f + timings.cpuMs * 0.05f;
+        mLast = timings;
+    }
+
+    /// The most recently recorded frame
+    const FrameTimings& last() const { return mLast; }
+
+    void reset() {
+        mNext = 0;
+        mCount = 0;
+        mTotal = 0;
+        mCpuMs = 0.0f;
+    }
+
+    const FrameStatsSummary& summary() {
+        mSummary = FrameStatsSummary();
+        mSummary.total = mTotal;
+        mSummary.cpuMs = mCpuMs;
+        mSummary.gpuMs = mLast.gpuMs;
+        mSummary.renderScale = mLast.renderScale;
+        if (mCount == 0) return mSummary;
+
+        std::array<float, kWindow> sorted;
+        std::copy(mIntervals.begin(), mIntervals.begin() + mCount, sorted.begin());
+        std::sort(sorted.begin(), sorted.begin() + mCount);
+        double sum = 0.0;
+        for (uint32_t i = 0; i < mCount; ++i) sum += sorted[i];
+
+        const auto percentile = [&](double p) {
+            uint32_t i = static_cast<uint32_t>(p * (mCount - 1) + 0.5);
+            return sorted[std::min(i, mCount - 1)];
+        };
+        mSummary.frames = mCount;
+        mSummary.meanMs = static_cast<float>(sum / mCount);
+        mSummary.p50Ms = percentile(0.50);
+        mSummary.p95Ms = percentile(0.95);
+        mSummary.p99Ms = percentile(0.99);
+        mSummary.maxMs = sorted[mCount - 1];
+        return mSummary;
+    }
+
+private:
+    std::array<float, kWindow> mIntervals{};
+    uint32_t mNext = 0;
+    uint32_t mCount = 0;
+    uint32_t mTotal = 0;
+    float mCpuMs = 0.0f;
+    FrameTimings mLast;
+    FrameStatsSummary mSummary;
+};
+
+} // namespace al
+
+#endif // AL_WEB_FRAME_STATS_HPP
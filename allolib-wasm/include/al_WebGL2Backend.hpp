@@ -53,6 +53,7 @@ public:
     void clear(const ClearValues& values) override;
     void viewport(int x, int y, int w, int h) override;
     void setDrawState(const DrawState& state) override;
+    DrawState getDrawState() const override { return mDrawState; }
 
     // ── Buffers ──────────────────────────────────────────────────────────
 
@@ -89,6 +90,8 @@ public:
 
     void generateMipmaps(TextureHandle handle) override;
     void destroyTexture(TextureHandle handle) override;
+    bool supportsTextureFormat(PixelFormat format) const override;
+    bool uploadImageBitmap(TextureHandle handle, int bitmapId) override;
 
     // ── Render Targets ───────────────────────────────────────────────────
 
@@ -103,10 +106,30 @@ public:
     // ── Shaders ──────────────────────────────────────────────────────────
 
     ShaderHandle createShader(const ShaderDesc& desc) override;
+    ShaderHandle createShaderAsync(const ShaderDesc& desc) override;
+    bool isShaderReady(ShaderHandle handle) override;
     void destroyShader(ShaderHandle handle) override;
     void useShader(ShaderHandle handle) override;
 
+    /// KHR_parallel_shader_compile is enabled: isShaderReady() polls
+    /// instead of blocking on the link
+    bool supportsParallelShaderCompile() const { return mParallelCompile; }
+
     // ── Uniforms ─────────────────────────────────────────────────────────
+    //
+    // Locations are resolved from a per-program table built at link time.
+    // Programs that declare the standard block (same layout as the WebGPU
+    // backend's uniform buffer)
+    //
+    //   layout(std140) uniform al_Uniforms {
+    //       mat4 modelViewMatrix;
+    //       mat4 projectionMatrix;
+    //       vec4 tint;
+    //       float pointSize, eyeSep, focLen, _pad;
+    //   };
+    //
+    // get those uniforms through one shared UBO, uploaded once per draw
+    // when something changed; other uniforms still use glUniform*.
 
     void setUniform(const char* name, int value) override;
     void setUniform(const char* name, float value) override;
@@ -153,6 +176,46 @@ public:
         int firstInstance = 0
     ) override;
 
+    /// Binds locations 4-8 with divisor 1. Programs opt in by declaring
+    /// `in mat4 al_InstanceModelView;` (and optionally `in vec4 al_InstanceTint;`).
+    void setInstanceBuffer(BufferHandle handle, size_t offset = 0) override;
+    bool supportsInstanceBuffer() const override;
+
+    // ── Multi-Draw ───────────────────────────────────────────────────────
+
+    /// One WEBGL_multi_draw call when the extension is available, else a
+    /// loop that sets the `al_DrawID` uniform per draw. Vertex shaders that
+    /// use AL_DRAW_ID get a prelude defining it (gl_DrawID or the uniform)
+    /// plus `al_drawTransforms[]`, filled by setDrawTransforms().
+    /// Base vertex is not available through the extension.
+    void multiDraw(PrimitiveType primitive, const int* firsts,
+                   const int* counts, int drawCount) override;
+    void multiDrawIndexed(PrimitiveType primitive, const int* firsts,
+                          const int* counts, int drawCount) override;
+    void multiDrawInstanced(PrimitiveType primitive, const int* firsts,
+                            const int* counts, const int* instanceCounts,
+                            int drawCount) override;
+    void multiDrawIndexedInstanced(PrimitiveType primitive, const int* firsts,
+                                   const int* counts, const int* instanceCounts,
+                                   int drawCount) override;
+    bool supportsMultiDraw() const override { return mMultiDraw; }
+
+    /// Upload per-draw records read as al_drawTransforms[AL_DRAW_ID];
+    /// at most kMaxDrawTransforms, so larger multi-draws must be split
+    void setDrawTransforms(const InstanceAttributes* transforms, int count);
+    static constexpr int kMaxDrawTransforms = 128;  // 10 KB, under the 16 KB UBO minimum
+
+    // ── GPU Timing ───────────────────────────────────────────────────────
+    //
+    // A TIME_ELAPSED query spans beginFrame() to endFrame(), so it needs
+    // the frame bracketed by them; queries nested inside it by user code
+    // are not allowed by the extension.
+
+    bool isGPUProfilingSupported() const override { return mTimerSupported; }
+    bool setGPUProfilingEnabled(bool enabled) override;
+    bool isGPUProfilingEnabled() const override { return mTimerEnabled; }
+    double getGPUFrameTimeMs() const override { return mGPUFrameMs; }
+
     // ── Compute (Not supported in WebGL2) ────────────────────────────────
 
     bool supportsCompute() const override { return false; }
@@ -196,11 +259,25 @@ private:
         TextureDesc desc;
     };
 
+    struct UniformSlot {
+        uint32_t hash = 0;
+        GLint location = -1;
+        std::string name;
+    };
+
     struct ShaderResource {
         GLuint glProgram = 0;
         std::string name;
-        // Cache uniform locations
-        mutable std::unordered_map<std::string, GLint> uniformCache;
+        bool instanceAttributes = false;  // Declares al_InstanceModelView
+        bool standardBlock = false;       // Declares the al_Uniforms block
+        GLint drawIdLocation = -1;        // al_DrawID (multi-draw fallback)
+        // Stages of a link whose status hasn't been read yet (createShaderAsync);
+        // kept attached so a failure can still print their logs
+        GLuint pendingVertex = 0;
+        GLuint pendingFragment = 0;
+        bool pending = false;
+        // Active uniforms outside blocks, sorted by name hash (filled at link)
+        std::vector<UniformSlot> uniforms;
     };
 
     struct RenderTargetResource {
@@ -210,10 +287,10 @@ private:
     };
 
     // Resource maps (handle ID -> resource)
-    std::unordered_map<uint64_t, BufferResource> mBuffers;
-    std::unordered_map<uint64_t, TextureResource> mTextures;
-    std::unordered_map<uint64_t, ShaderResource> mShaders;
-    std::unordered_map<uint64_t, RenderTargetResource> mRenderTargets;
+    HandleTable<BufferResource> mBuffers;
+    HandleTable<TextureResource> mTextures;
+    HandleTable<ShaderResource> mShaders;
+    HandleTable<RenderTargetResource> mRenderTargets;
 
     // Handle generation
     uint64_t mNextHandleId = 1;
@@ -225,13 +302,92 @@ private:
     ShaderHandle mCurrentShader;
     GLuint mCurrentVao = 0;
     bool mIndexBuffer32Bit = false;
-
-    // VAO for vertex attribute setup
+    DrawState mDrawState;
+
+    // Vertex input is recorded by setVertexBuffer/setIndexBuffer/
+    // setInstanceBuffer and resolved into a VAO at draw time
+    BufferHandle mPendingVertexBuffer;
+    VertexLayout mPendingLayout;
+    uint64_t mPendingLayoutHash = 0;
+    BufferHandle mPendingIndexBuffer;
+    BufferHandle mInstanceBuffer;
+    size_t mInstanceBufferOffset = 0;
+    uint32_t mScratchAttribMask = 0;  // Locations enabled on mVao
+
+    static constexpr GLuint kInstanceModelViewLocation = 4;  // mat4: 4-7
+    static constexpr GLuint kInstanceTintLocation = 8;
+
+    // Standard uniform block: CPU copy and the UBO it is uploaded to.
+    // Bound to the last binding point ES 3.0 guarantees, clear of
+    // setUniformBuffer() users that count up from 0.
+    static constexpr GLuint kStandardBlockBinding = 23;
+    static constexpr size_t kStandardBlockSize = 160;
+    GLuint mStandardUbo = 0;
+    float mStandardUniforms[kStandardBlockSize / sizeof(float)] = {};
+    bool mStandardUniformsDirty = true;
+
+    // WEBGL_multi_draw and the al_DrawTransforms block
+    static constexpr GLuint kDrawTransformBinding = 22;
+    bool mMultiDraw = false;
+    GLuint mDrawTransformUbo = 0;
+    std::vector<int32_t> mMultiDrawOffsets;  // Byte offsets for multiDrawElements
+
+    // KHR_parallel_shader_compile: COMPLETION_STATUS_KHR can be polled
+    static constexpr GLenum kCompletionStatus = 0x91B1;
+    bool mParallelCompile = false;
+
+    // EXT_disjoint_timer_query_webgl2; mGPUFrameMs is a moving average
+    bool mTimerSupported = false;
+    bool mTimerEnabled = false;
+    double mGPUFrameMs = 0.0;
+
+    // Compressed texture extensions enabled on the context
+    static constexpr int kCompressionS3TC = 1;
+    static constexpr int kCompressionBPTC = 2;
+    static constexpr int kCompressionETC = 4;
+    static constexpr int kCompressionASTC = 8;
+    int mCompression = 0;
+
+    // Scratch VAO for instanced draws; everything else goes through the cache
     GLuint mVao = 0;
 
+    // One VAO per (vertex buffer, layout, index buffer), dropped when
+    // either buffer is destroyed
+    struct VaoKey {
+        uint64_t vertexBuffer;
+        uint64_t indexBuffer;
+        uint64_t layoutHash;
+        bool operator==(const VaoKey& o) const {
+            return vertexBuffer == o.vertexBuffer && indexBuffer == o.indexBuffer &&
+                   layoutHash == o.layoutHash;
+        }
+    };
+    struct VaoKeyHash {
+        size_t operator()(const VaoKey& k) const {
+            return std::hash<uint64_t>()(k.vertexBuffer * 31 + k.indexBuffer) ^ (k.layoutHash << 1);
+        }
+    };
+    std::unordered_map<VaoKey, GLuint, VaoKeyHash> mVaoCache;
+
     // ── Helper Methods ───────────────────────────────────────────────────
 
     GLint getUniformLocation(const char* name);
+    void cacheUniformLocations(ShaderResource& shader);
+    bool currentShaderUsesStandardBlock() const;
+    /// Write into the standard block if `name` is one of its members and
+    /// the current program declares it; false means use glUniform*
+    bool setStandardUniform(const char* name, const float* value, int floats);
+    void resetStandardUniforms();
+    void flushStandardUniforms();
+    /// Per-draw al_DrawID for the non-extension multi-draw loop
+    void setDrawId(int drawId);
+    /// Bind the VAO for the pending vertex input, creating it on first use
+    void bindVertexInput(bool indexed);
+    void bindVertexArray(GLuint vao);
+    void specifyVertexAttributes(GLuint buffer, const VertexLayout& layout);
+    /// The element binding is VAO state; move off cached VAOs before
+    /// binding an index buffer for upload
+    void protectVaoElementBinding(GLenum target);
     GLenum toGLBufferType(BufferType type);
     GLenum toGLBufferUsage(BufferUsage usage);
     GLenum toGLPixelFormat(PixelFormat format);
@@ -244,8 +400,10 @@ private:
     GLenum toGLFilter(FilterMode mode, bool minFilter);
     GLenum toGLWrap(WrapMode mode);
 
-    bool compileShader(GLuint shader, const char* source);
-    bool linkProgram(GLuint program);
+    /// Compile and link without reading status, so the driver can work in
+    /// the background; finishShader() checks the result and reflects it
+    void submitShader(const ShaderDesc& desc, ShaderResource& resource);
+    bool finishShader(ShaderResource& resource);
 };
 
 // ─── Factory Function Implementation ─────────────────────────────────────────
@@ -11,6 +11,8 @@
  *   - static meshes only (no skeletal animation — M8.3)
  *   - no PBR material binding yet (M8.2)
  *   - synchronous parse from in-memory buffer; async fetch via WebFile
+ *   - EXT_meshopt_compression buffer views are decoded on load
+ *     (al_WebMeshoptDecode.hpp); KHR_draco_mesh_compression is not
  *   - flattens all primitives in the file into a single al::Mesh (or one
  *     al::Mesh per primitive via primitiveCount() / primitiveMesh(i))
  *
@@ -26,6 +28,30 @@
  * Or synchronous from bytes:
  *   al::Mesh m;
  *   if (al::WebGLTF::parse(bytes.data(), bytes.size(), m)) { ... }
+ *
+ * Render-only assets can skip al::Mesh and go straight to the backend
+ * vertex layout (keeps the source index sharing and 16-bit indices):
+ *   al::InterleavedMesh im;
+ *   if (al::WebGLTF::parseInterleaved(bytes.data(), bytes.size(), im)) g.draw(im);
+ *
+ * parseCached() stores the finished geometry in the binary mesh cache so
+ * repeat loads of the same bytes skip cgltf entirely.
+ *
+ * Progressive loading: load() fetches a .gltf's external buffers (.bin)
+ * separately and each primitive becomes drawable as soon as the buffers
+ * it reads have arrived. Until then primitiveMesh(i) is a box spanning
+ * the POSITION accessor's min/max, so large scans show their layout
+ * straight away:
+ *   gltf.onPrimitiveReady([&](size_t i) { upload(gltf.primitiveMesh(i)); });
+ *   gltf.load("/assets/scan/scene.gltf");
+ *   ...
+ *   for (size_t i = 0; i < gltf.primitiveCount(); ++i)
+ *     if (gltf.primitiveReady(i)) g.draw(gltf.primitiveMesh(i));
+ * ready() still means everything (geometry, images, skins) is loaded.
+ *
+ * load() parses on the JobSystem pool in threaded builds (al_WebJobs.hpp):
+ * the file is decoded into a staging asset off the main thread and taken
+ * over between frames. External buffers are bound on the main thread.
  */
 
 #include <cstdint>
@@ -39,7 +65,10 @@
 #include "al/math/al_Vec.hpp"
 #include "al/types/al_Color.hpp"
 
+#include "al_WebAssetLoader.hpp"
 #include "al_WebFile.hpp"
+#include "al_WebJobs.hpp"
+#include "al_WebMeshAdapter.hpp"
 
 // cgltf forward declarations — keep the 7k-line cgltf.h out of every TU
 // that includes al_WebGLTF.hpp. Pointers to these types in SkinnedPrim
@@ -49,10 +78,13 @@
 // sites in al_WebGLTF.cpp.
 struct cgltf_data;
 struct cgltf_node;
+struct cgltf_primitive;
 struct cgltf_skin;
 
 namespace al {
 
+struct MeshBundle;
+
 /// Per-primitive PBR material extracted from a glTF asset (M8.2).
 /// Mirrors glTF 2.0's metallic-roughness workflow plus optional emissive
 /// and normal maps. Texture indices are -1 when absent; otherwise they
@@ -115,6 +147,7 @@ struct WebGLTFSkinInfo {
 class WebGLTF {
 public:
     using LoadCallback = std::function<void(bool success)>;
+    using PrimitiveCallback = std::function<void(size_t index)>;
 
     WebGLTF() = default;
     ~WebGLTF();
@@ -127,28 +160,72 @@ public:
     /// false on parse error or empty asset.
     static bool parse(const uint8_t* data, size_t size, Mesh& out);
 
+    /// Parse glTF or GLB bytes straight into the backend's interleaved
+    /// vertex format: accessors are read into the InterleavedVertex fields
+    /// in place and indices stay 16-bit while they fit, with no temporary
+    /// per-attribute arrays or al::Mesh. Primitives are flattened like
+    /// parse(); strips and fans become indexed triangle lists. Skips the
+    /// MeshOptimizer pass. Returns false on parse error or empty asset.
+    static bool parseInterleaved(const uint8_t* data, size_t size, InterleavedMesh& out);
+
+    /// Parse into a render-ready MeshBundle (al_WebMeshCache.hpp), reusing
+    /// the bundle cached for these exact bytes. lodLevels > 1 goes through
+    /// parse() and LODMesh; 1 uses parseInterleaved() with no al::Mesh.
+    static bool parseCached(const uint8_t* data, size_t size, MeshBundle& out, int lodLevels = 1);
+
     /// Parse and keep the cgltf_data alive on this instance so callers can
     /// query primitiveCount() / primitiveMesh(i) for per-primitive access.
     /// The combined mesh is also available via mesh().
     bool parseAndRetain(const uint8_t* data, size_t size);
 
-    /// Async load via WebFile (browser fetch). Mesh becomes available when
-    /// `ready()` returns true. Optional callback fires on completion.
+    /// Async load through AssetLoader (browser fetch). Primitives become
+    /// drawable one by one (primitiveReady()) as their buffers arrive; the
+    /// whole asset is available when `ready()` returns true. Optional
+    /// callback fires on completion.
     void load(const std::string& url);
     void load(const std::string& url, LoadCallback cb);
 
+    /// Fetch priority of the file and its buffers (AssetLoader, higher is sooner)
+    void setPriority(float priority);
+    float priority() const { return mPriority; }
+
+    /// Drop the fetches still outstanding; the load callback won't run
+    void cancel();
+
     bool ready() const { return mReady; }
     const std::string& url() const { return mUrl; }
 
+    /// Called with each primitive index as its geometry replaces the
+    /// placeholder (also for synchronous parseAndRetain, in order)
+    void onPrimitiveReady(PrimitiveCallback cb) { mPrimitiveCallback = std::move(cb); }
+
+    /// Fraction of the external buffer bytes received (1 with none)
+    float progress() const {
+        return mStreamBytesTotal ? (float)mStreamBytesLoaded / (float)mStreamBytesTotal : 1.0f;
+    }
+
     /// The flattened mesh containing every primitive.
     const Mesh& mesh() const { return mCombined; }
     Mesh&       mesh()       { return mCombined; }
 
     /// Per-primitive access — populated by parseAndRetain. Returns 0 if the
-    /// instance was used via the static `parse()` form only.
+    /// instance was used via the static `parse()` form only. During a
+    /// progressive load the count is final once the JSON has arrived and
+    /// primitives that aren't ready yet hold a bounding-box placeholder.
     size_t primitiveCount() const { return mPrimitives.size(); }
     const Mesh& primitiveMesh(size_t i) const { return mPrimitives.at(i); }
 
+    /// True once primitiveMesh(i) holds the real geometry
+    bool primitiveReady(size_t i) const { return i < mSlots.size() && mSlots[i].ready; }
+    size_t readyPrimitiveCount() const { return mReadyCount; }
+
+    /// World-space bounds of primitive i, from its POSITION accessor
+    /// min/max — available before the geometry arrives
+    void primitiveBounds(size_t i, Vec3f& min, Vec3f& max) const {
+        min = mSlots.at(i).min;
+        max = mSlots.at(i).max;
+    }
+
     /// Per-primitive PBR material (M8.2). Index parallel to primitiveMesh(i).
     /// If the primitive has no material, returns a default WebGLTFMaterial
     /// (baseColor white, metallic=1, roughness=1, no textures).
@@ -160,6 +237,11 @@ public:
     size_t imageCount() const { return mImages.size(); }
     const WebGLTFImage& image(size_t i) const { return mImages.at(i); }
 
+    /// GPUResourceCache key for image(i), a hash of its bytes: textures
+    /// created under it are shared by every material, asset and reload
+    /// that embeds the same image.
+    std::string imageKey(size_t i) const;
+
     /// Animation accessors (M8.3).
     size_t animationCount() const { return mAnimations.size(); }
     const WebGLTFAnimation& animation(size_t i) const { return mAnimations.at(i); }
@@ -212,6 +294,16 @@ private:
     static void cacheNode(const cgltf_node* node,
                           std::vector<SkinnedPrim>& out);
 
+    /// One entry per primitiveMesh(i): where its data lives and whether
+    /// it has replaced the placeholder yet
+    struct PrimitiveSlot {
+        const cgltf_node*      node = nullptr;
+        const cgltf_primitive* prim = nullptr;
+        Vec3f min{0, 0, 0};
+        Vec3f max{0, 0, 0};
+        bool ready = false;
+    };
+
     static bool extractAllPrimitives(const cgltf_data* data,
                                      Mesh& combined,
                                      std::vector<Mesh>* perPrim,
@@ -221,6 +313,15 @@ private:
     void buildSkinCache();
     void rebuildAnimatedMesh();
 
+    // Progressive loading (al_WebGLTF.cpp)
+    bool retain(const uint8_t* data, size_t size);
+    void promoteReadyPrimitives();
+    bool finishRetain();
+    void onBufferLoaded(size_t buffer, const UploadedFile& file);
+    void finishLoad(bool ok);
+    void adopt(WebGLTF& staged);
+    void onRetained();
+
     std::string                  mUrl;
     Mesh                         mCombined;
     Mesh                         mAnimated;     // M8.3 — re-skinned per sampleAnimation
@@ -230,8 +331,21 @@ private:
     std::vector<WebGLTFAnimation> mAnimations;  // M8.3 metadata
     std::vector<WebGLTFSkinInfo>  mSkins;       // M8.3 metadata
     std::vector<SkinnedPrim>     mCache;        // M8.3b — bind-pose + skin attrs
+    std::vector<PrimitiveSlot>   mSlots;        // Parallel to mPrimitives
+    size_t                       mReadyCount = 0;
     bool                         mReady = false;
     LoadCallback                 mCallback;
+    PrimitiveCallback            mPrimitiveCallback;
+
+    // In-flight fetches: the file, then its external buffers
+    float                              mPriority = 0.0f;
+    AssetLoader::Ticket                mTicket = 0;
+    std::vector<AssetLoader::Ticket>   mBufferTickets;
+    size_t                             mPendingBuffers = 0;
+    bool                               mBufferFailed = false;
+    size_t                             mStreamBytesTotal = 0;
+    size_t                             mStreamBytesLoaded = 0;
+    JobFuture<bool>                    mJob;          // Parse in flight
 
     // Owned cgltf_data, freed in dtor. Held only when parseAndRetain was
     // used so per-primitive node hierarchies stay queryable. Static
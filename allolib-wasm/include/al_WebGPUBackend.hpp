@@ -18,6 +18,7 @@
 #define AL_WEBGPU_BACKEND_HPP
 
 #include "al_WebGraphicsBackend.hpp"
+#include <list>
 #include <unordered_map>
 #include <vector>
 
@@ -53,6 +54,9 @@ public:
     void clear(const ClearValues& values) override;
     void viewport(int x, int y, int w, int h) override;
     void setDrawState(const DrawState& state) override;
+    DrawState getDrawState() const override;
+    void setDrawSorting(bool enabled) override;
+    bool drawSorting() const override { return mDrawSorting; }
 
     // ── Buffers ──────────────────────────────────────────────────────────
 
@@ -89,6 +93,10 @@ public:
 
     void generateMipmaps(TextureHandle handle) override;
     void destroyTexture(TextureHandle handle) override;
+    /// BC, ETC2 and ASTC need the device features of the same name
+    bool supportsTextureFormat(PixelFormat format) const override;
+    /// copyExternalImageToTexture; the texture needs desc.externalImage
+    bool uploadImageBitmap(TextureHandle handle, int bitmapId) override;
 
     // ── Render Targets ───────────────────────────────────────────────────
 
@@ -103,6 +111,10 @@ public:
     // ── Shaders ──────────────────────────────────────────────────────────
 
     ShaderHandle createShader(const ShaderDesc& desc) override;
+    /// Modules are created at once; the default pipeline goes through
+    /// prewarmPipelineAsync() instead of blocking on the compile
+    ShaderHandle createShaderAsync(const ShaderDesc& desc) override;
+    bool isShaderReady(ShaderHandle handle) override;
     void destroyShader(ShaderHandle handle) override;
     void useShader(ShaderHandle handle) override;
 
@@ -153,10 +165,21 @@ public:
         int firstInstance = 0
     ) override;
 
+    /// Instanced draws without a custom shader switch to an instanced
+    /// variant of the default shader while an instance buffer is bound.
+    /// Custom shaders read it when their vertex source declares
+    /// al_InstanceModelView (locations 4-8, as on WebGL2).
+    void setInstanceBuffer(BufferHandle handle, size_t offset = 0) override;
+    bool supportsInstanceBuffer() const override;
+
     // ── Compute ──────────────────────────────────────────────────────────
 
     bool supportsCompute() const override { return true; }
 
+    /// Compute pipelines take their layout from the shader (entry point
+    /// cs_main, everything in @group(0)). dispatch() binds the storage
+    /// buffers set with bindStorageBuffer(), which must be exactly the
+    /// bindings the shader declares.
     ComputePipelineHandle createComputePipeline(const ShaderDesc& desc) override;
     void destroyComputePipeline(ComputePipelineHandle handle) override;
     void bindStorageBuffer(int binding, BufferHandle handle) override;
@@ -180,6 +203,19 @@ public:
         size_t offset = 0
     ) override;
 
+    /// Copies into a pooled MapRead staging buffer and maps it after the
+    /// frame is submitted, so results from frame N arrive while frame N+1
+    /// is encoded. Offset must be 4-byte aligned.
+    bool readBufferAsync(
+        BufferHandle handle,
+        size_t size,
+        size_t offset,
+        ReadbackCallback callback
+    ) override;
+
+    /// Readbacks requested but not yet delivered to their callback
+    size_t getPendingReadbackCount() const;
+
     void copyBuffer(
         BufferHandle src,
         BufferHandle dst,
@@ -216,9 +252,28 @@ public:
     /// Set normal matrix (inverse transpose of modelView 3x3)
     void setNormalMatrix(const float* mat3x3);
 
+    // ── Clustered Lights ─────────────────────────────────────────────────
+    // Froxel grid built by ClusteredLights (al_WebClusteredLights.hpp),
+    // read by the lit and PBR shaders from read-only storage buffers
+
+    /// Upload a grid: 8 floats per light (view pos + radius, color),
+    /// (offset, count) per froxel, the light index lists, and params =
+    /// viewport x, y, width, height, slice scale, slice bias
+    void setClusteredLights(const float* lights, uint32_t lightCount,
+                            const uint32_t* ranges, uint32_t froxelCount,
+                            const uint32_t* indices, uint32_t indexCount,
+                            const float* params);
+
+    /// Add the uploaded lights to lit draws (Graphics::clusteredLights)
+    void setClusteredLighting(bool enabled);
+
+    /// Add the uploaded lights to PBR draws (WebPBR::clusteredLights)
+    void setPBRClusteredLights(bool enabled);
+
     // ── Skybox/Environment (Phase 4) ────────────────────────────────────────
 
-    /// Set environment texture for skybox rendering
+    /// Set environment texture for skybox rendering: equirect, or a
+    /// cubemap (bakeEnvironmentCube) for the texture_cube pipelines
     void setEnvironmentTexture(TextureHandle handle);
 
     /// Set environment rendering parameters
@@ -276,13 +331,19 @@ public:
     void setPBRMaterial(const float* albedo, float metallic, float roughness,
                         float ao, const float* emission);
 
-    /// Set IBL environment texture for PBR
+    /// Set the IBL maps for PBR. envMap is the prefiltered specular chain
+    /// (bakeIBLPrefiltered), sampled at roughness * envMaxLod.
     void setPBREnvironment(TextureHandle envMap, TextureHandle irradianceMap,
-                           TextureHandle brdfLUT);
+                           TextureHandle brdfLUT, float envMaxLod = 0.0f);
 
     /// Set PBR rendering parameters
     void setPBRParams(float envIntensity, float exposure, float gamma);
 
+    /// Take diffuse IBL from 9 L2 SH coefficients (36 floats, rgb + pad per
+    /// coefficient, see SHIrradiance) instead of the irradiance map;
+    /// nullptr goes back to the map
+    void setPBRDiffuseSH(const float* coeffs);
+
     /// Set inverse view rotation matrix for environment sampling
     void setPBRInvViewRotation(const float* mat3x3);
 
@@ -292,6 +353,29 @@ public:
     /// End PBR rendering pass
     void endPBR();
 
+    // ── IBL Baking ──
+    // Compute-shader precomputation of the PBR environment maps, for
+    // GPUResourceCache creators. Every map is RGBA16F (equirect unless
+    // noted); each call
+    // submits its own work and returns an invalid handle on failure.
+
+    /// Mipmapped copy of an environment (at most 1024 wide) to convolve from;
+    /// destroy it once the maps are baked
+    TextureHandle bakeIBLSource(TextureHandle env);
+
+    /// Specular chain: level i prefiltered for roughness i / (levels - 1)
+    TextureHandle bakeIBLPrefiltered(TextureHandle source, int width, int height, int levels);
+
+    /// Diffuse irradiance (pi * mean cosine-weighted radiance)
+    TextureHandle bakeIBLIrradiance(TextureHandle source, int width, int height);
+
+    /// Split-sum BRDF LUT in .rg: x = NdotV, y = roughness
+    TextureHandle bakeIBLBrdfLUT(int size);
+
+    /// The environment resampled into a mipmapped RGBA16F cubemap of
+    /// faceSize faces, for the skybox and reflections
+    TextureHandle bakeEnvironmentCube(TextureHandle env, int faceSize);
+
     /// Draw with PBR shader (upload transforms and draw)
     /// Call after beginPBR() and setPBRMaterial()
     void drawPBR(
@@ -315,6 +399,176 @@ public:
         PrimitiveType primitive = PrimitiveType::Triangles
     );
 
+    // ── Pipeline Cache ───────────────────────────────────────────────────
+
+    /// Pipeline cache counters (reset on shutdown)
+    struct PipelineCacheStats {
+        uint64_t hits = 0;     ///< Lookups served from the cache
+        uint64_t misses = 0;   ///< Lookups that had to create a pipeline
+        size_t pipelines = 0;  ///< Pipelines currently cached
+    };
+
+    /// Get pipeline cache hit/miss counters
+    PipelineCacheStats getPipelineCacheStats() const;
+
+    /// Create the pipeline for (shader, primitive, state) ahead of time so the
+    /// first draw with that combination doesn't compile mid-frame.
+    /// Uses the formats of the currently bound render target.
+    void prewarmPipeline(ShaderHandle shader, PrimitiveType primitive,
+                         const DrawState& state);
+
+    /// prewarmPipeline() through createRenderPipelineAsync: the browser
+    /// compiles off the main thread and the pipeline joins the cache when
+    /// it resolves. A draw that needs it sooner builds it synchronously.
+    void prewarmPipelineAsync(ShaderHandle shader, PrimitiveType primitive,
+                              const DrawState& state);
+
+    /// Async pipeline requests that haven't resolved yet
+    size_t pendingPipelineCount() const;
+
+    // ── GPU Profiler ─────────────────────────────────────────────────────
+
+    /// Rolling GPU time for one pass category
+    struct GPUPassTiming {
+        const char* name = "";  ///< "main", "render-target", "compute"
+        double lastMs = 0.0;    ///< Most recent frame
+        double avgMs = 0.0;     ///< Exponential moving average
+        uint64_t samples = 0;
+    };
+
+    /// True when the device was created with the "timestamp-query" feature
+    bool isGPUProfilingSupported() const override;
+
+    /// Enable timestamp bracketing of render/compute passes. Returns false
+    /// (and stays disabled) when timestamp queries are unavailable.
+    bool setGPUProfilingEnabled(bool enabled) override;
+    bool isGPUProfilingEnabled() const override { return mProfilerEnabled; }
+
+    /// Per-category GPU timings (results lag the CPU by a few frames)
+    std::vector<GPUPassTiming> getGPUPassTimings() const;
+
+    /// Sum of the averaged pass times (GPU ms per frame)
+    double getGPUFrameTimeMs() const override;
+
+    // ── Render Bundles ───────────────────────────────────────────────────
+
+    struct RenderBundleHandle {
+        uint64_t id = 0;
+        bool valid() const { return id != 0; }
+        operator bool() const { return valid(); }
+    };
+
+    /// Start recording draw()/drawIndexed()/drawInstanced()/drawIndexedInstanced()
+    /// into a reusable bundle instead of the current pass. The bundle targets
+    /// the attachment formats of the render target bound at this point.
+    void beginBundle();
+
+    /// Finish recording. Uniforms of the recorded draws are snapshotted into
+    /// bundle-owned buffers, so later setUniform calls don't affect it.
+    RenderBundleHandle endBundle();
+
+    /// Replay a bundle into the current pass. Returns false when the bundle
+    /// was invalidated (a referenced buffer, texture or shader was destroyed)
+    /// or was recorded for different attachment formats.
+    bool executeBundle(RenderBundleHandle handle);
+
+    /// Re-aim the recorded built-in shader draws at a new camera without
+    /// re-recording: modelView becomes viewDelta * recorded modelView (normals
+    /// follow its rotation), where viewDelta = view * inverse(recorded view).
+    /// A non-null projection replaces the recorded one. Either may be null.
+    void setBundleView(RenderBundleHandle handle, const float* viewDelta, const float* projection);
+
+    bool isBundleValid(RenderBundleHandle handle) const;
+    bool isRecordingBundle() const { return mRecordingBundleId != 0; }
+    void destroyBundle(RenderBundleHandle handle);
+
+    // ── GPU-Driven Instancing ────────────────────────────────────────────
+
+    /// One instance for drawIndirectInstances() (matches the WGSL struct)
+    struct IndirectInstance {
+        float model[16];       ///< Column-major model matrix
+        float color[4];
+        uint32_t mesh = 0;     ///< Index returned by createIndirectMesh()
+        uint32_t pad[3] = {};
+    };
+
+    /// Per-instance material, parallel to the instance array (matches the
+    /// WGSL struct). Albedo is the instance color; shading 0 keeps the
+    /// flat / headlight look, 1 shades with WebPBR's analytical lights.
+    struct IndirectMaterial {
+        float metallic = 0.0f;
+        float roughness = 0.5f;
+        float ao = 1.0f;
+        uint32_t shading = 0;
+        float emission[4] = {};
+    };
+
+    /// Register triangle-list geometry for GPU-driven drawing (normals may
+    /// be null). Returns the mesh index, or -1 on failure.
+    int createIndirectMesh(const float* positions, const float* normals, uint32_t vertexCount,
+                           const uint32_t* indices, uint32_t indexCount);
+
+    /// Replace the instance set. Instances are bucketed by mesh on upload,
+    /// so only call this when something changed. materials (optional) holds
+    /// one entry per instance; PBR exposure / gamma come from setPBRParams().
+    void setIndirectInstances(const IndirectInstance* instances, uint32_t count,
+                              const IndirectMaterial* materials = nullptr);
+
+    /// Frustum-cull every instance in a compute pass, then issue one
+    /// drawIndexedIndirect per mesh. Up to 4 calls per frame (e.g. stereo).
+    void drawIndirectInstances(const float* view, const float* projection);
+
+    uint32_t getIndirectInstanceCount() const { return mIndirectInstanceCount; }
+
+    // ── Primitive Conversion Index Pool ──────────────────────────────────
+
+    /// Index patterns for primitives WebGPU can't draw directly
+    enum class ConversionIndexKind {
+        TriangleFan,  ///< (0, i+1, i+2) triangles
+        LineLoop,     ///< (i, i+1) segments, then (k, 0) closing segments
+        Quads,        ///< (4q, 4q+1, 4q+2, 4q, 4q+2, 4q+3) triangles
+        Count
+    };
+
+    /// Get a shared 32-bit index buffer that converts `vertexCount` vertices of
+    /// `kind` into a list primitive (use with baseVertex = first vertex).
+    /// Grows geometrically; the buffer is owned by the backend.
+#ifdef __EMSCRIPTEN__
+    WGPUBuffer getConversionIndexBuffer(ConversionIndexKind kind, uint32_t vertexCount);
+#endif
+
+    /// Current vertex capacity of a conversion index buffer (0 = not created)
+    uint32_t getConversionIndexCapacity(ConversionIndexKind kind) const;
+
+    // ── Bind Group Cache ─────────────────────────────────────────────────
+
+    /// Bind group cache counters (reset on shutdown)
+    struct BindGroupCacheStats {
+        uint64_t hits = 0;       ///< Lookups served from the cache
+        uint64_t misses = 0;     ///< Lookups that created a bind group
+        uint64_t evictions = 0;  ///< Bind groups dropped by LRU eviction
+        size_t bindGroups = 0;   ///< Bind groups currently cached
+        size_t capacity = 0;     ///< Maximum cached bind groups
+    };
+
+    /// Get bind group cache hit/miss/eviction counters
+    BindGroupCacheStats getBindGroupCacheStats() const;
+
+    /// Set how many bind groups are kept before evicting the least recently
+    /// used one (default 64, minimum 8)
+    void setBindGroupCacheCapacity(size_t capacity);
+
+    // ── Draw Sorting ─────────────────────────────────────────────────────
+
+    /// Sorted draw queue counters for the last completed frame
+    struct DrawQueueStats {
+        uint64_t draws = 0;                ///< Draws replayed from the queue
+        uint64_t pipelineChanges = 0;      ///< setPipeline calls after sorting
+        uint64_t vertexBufferChanges = 0;  ///< Vertex buffer binds after sorting
+    };
+
+    DrawQueueStats getDrawQueueStats() const { return mDrawQueueStats; }
+
 #ifdef __EMSCRIPTEN__
     // ── WebGPU-specific accessors ────────────────────────────────────────
 
@@ -337,21 +591,23 @@ private:
         WGPUTexture texture = nullptr;
         WGPUTextureView view = nullptr;
         WGPUSampler sampler = nullptr;
+        WGPUTextureFormat format = WGPUTextureFormat_Undefined; // Actual GPU format
+        uint32_t mipLevels = 1;
         TextureDesc desc;
     };
 
     struct ShaderResource {
         WGPUShaderModule vertModule = nullptr;
         WGPUShaderModule fragModule = nullptr;
-        // Pipelines per primitive topology (WebGPU requires separate pipelines)
-        std::unordered_map<int, WGPURenderPipeline> pipelines; // keyed by PrimitiveType
-        WGPURenderPipeline defaultPipeline = nullptr; // TriangleList for fallback
+        // Validation pipeline built at creation; draws go through mPipelineCache
+        WGPURenderPipeline defaultPipeline = nullptr;
         WGPUBindGroupLayout bindGroupLayout = nullptr;
         WGPUPipelineLayout pipelineLayout = nullptr;
         std::string name;
         // Uniform buffer for this shader
         WGPUBuffer uniformBuffer = nullptr;
         WGPUBindGroup bindGroup = nullptr;
+        bool instanceAttributes = false;  // Reads InstanceAttributes from buffer slot 1
     };
 
     struct RenderTargetResource {
@@ -359,25 +615,136 @@ private:
         TextureHandle depthAttachment;
         WGPUTextureView colorView = nullptr;
         WGPUTextureView depthView = nullptr;
+        WGPUTextureFormat colorFormat = WGPUTextureFormat_Undefined;
+        WGPUTextureFormat depthFormat = WGPUTextureFormat_Undefined;
         int width = 0;   // For viewport management
         int height = 0;  // For viewport management
     };
 
+    // Everything a render pipeline bakes in. WebGPU pipelines are immutable,
+    // so any change here (blend mode, depth func, RT format...) needs its own.
+    struct PipelineKey {
+        uint64_t shaderId = 0;
+        uint32_t layoutHash = 0;  // Hash of the vertex layout (stride + attributes)
+        uint8_t primitive = 0;    // PrimitiveType (post fan/loop emulation)
+        uint8_t blend = 0;        // BlendMode
+        uint8_t depthFunc = 0;    // DepthFunc (Always when depth test is off)
+        uint8_t cull = 0;         // CullFace
+        bool depthWrite = true;
+        WGPUIndexFormat stripIndexFormat = WGPUIndexFormat_Undefined;
+        WGPUTextureFormat colorFormat = WGPUTextureFormat_Undefined;
+        WGPUTextureFormat depthFormat = WGPUTextureFormat_Undefined;
+
+        bool operator==(const PipelineKey& o) const {
+            return shaderId == o.shaderId && layoutHash == o.layoutHash &&
+                   primitive == o.primitive && blend == o.blend &&
+                   depthFunc == o.depthFunc && cull == o.cull &&
+                   depthWrite == o.depthWrite &&
+                   stripIndexFormat == o.stripIndexFormat &&
+                   colorFormat == o.colorFormat && depthFormat == o.depthFormat;
+        }
+    };
+
+    struct PipelineKeyHash {
+        size_t operator()(const PipelineKey& k) const {
+            uint64_t h = k.shaderId * 0x9E3779B97F4A7C15ull;
+            h ^= (uint64_t)k.layoutHash << 1;
+            h ^= ((uint64_t)k.primitive << 8) | ((uint64_t)k.blend << 16) |
+                 ((uint64_t)k.depthFunc << 24) | ((uint64_t)k.cull << 32) |
+                 ((uint64_t)k.depthWrite << 40) | ((uint64_t)k.stripIndexFormat << 44);
+            h ^= ((uint64_t)k.colorFormat << 48) ^ ((uint64_t)k.depthFormat << 56);
+            return (size_t)(h ^ (h >> 29));
+        }
+    };
+
+    // Bind groups are immutable too: identified by their layout plus the
+    // exact resources bound to each slot.
+    static constexpr size_t kMaxBindGroupEntries = 8;
+
+    struct BindGroupKey {
+        struct Entry {
+            uint32_t binding = 0;
+            WGPUBuffer buffer = nullptr;
+            uint64_t offset = 0;
+            uint64_t size = 0;
+            WGPUTextureView textureView = nullptr;
+            WGPUSampler sampler = nullptr;
+        };
+        WGPUBindGroupLayout layout = nullptr;
+        uint32_t entryCount = 0;
+        Entry entries[kMaxBindGroupEntries];
+
+        bool operator==(const BindGroupKey& o) const {
+            if (layout != o.layout || entryCount != o.entryCount) return false;
+            for (uint32_t i = 0; i < entryCount; i++) {
+                const Entry& a = entries[i];
+                const Entry& b = o.entries[i];
+                if (a.binding != b.binding || a.buffer != b.buffer ||
+                    a.offset != b.offset || a.size != b.size ||
+                    a.textureView != b.textureView || a.sampler != b.sampler) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    struct BindGroupKeyHash {
+        size_t operator()(const BindGroupKey& k) const {
+            uint64_t h = (uint64_t)(uintptr_t)k.layout * 0x9E3779B97F4A7C15ull;
+            auto mix = [&h](uint64_t v) {
+                h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+            };
+            for (uint32_t i = 0; i < k.entryCount; i++) {
+                const BindGroupKey::Entry& e = k.entries[i];
+                mix(e.binding);
+                mix((uint64_t)(uintptr_t)e.buffer);
+                mix(e.offset ^ (e.size << 32));
+                mix((uint64_t)(uintptr_t)e.textureView);
+                mix((uint64_t)(uintptr_t)e.sampler);
+            }
+            return (size_t)h;
+        }
+    };
+
+    struct BindGroupCacheEntry {
+        WGPUBindGroup bindGroup = nullptr;
+        std::list<BindGroupKey>::iterator lruIt;  // Position in mBindGroupLru
+    };
+
     struct ComputeResource {
         WGPUShaderModule module = nullptr;
         WGPUComputePipeline pipeline = nullptr;
         WGPUBindGroupLayout bindGroupLayout = nullptr;
         WGPUPipelineLayout pipelineLayout = nullptr;
         WGPUBindGroup bindGroup = nullptr;
+        std::vector<uint64_t> boundBuffers;  // Storage buffer ids bindGroup was built from
     };
 
     // Resource maps (handle ID -> resource)
-    std::unordered_map<uint64_t, BufferResource> mBuffers;
-    std::unordered_map<uint64_t, TextureResource> mTextures;
-    std::unordered_map<uint64_t, ShaderResource> mShaders;
-    std::unordered_map<uint64_t, RenderTargetResource> mRenderTargets;
+    HandleTable<BufferResource> mBuffers;
+    HandleTable<TextureResource> mTextures;
+    HandleTable<ShaderResource> mShaders;
+    HandleTable<RenderTargetResource> mRenderTargets;
     std::unordered_map<uint64_t, ComputeResource> mComputePipelines;
 
+    // Render pipelines keyed by full state (shared by all shaders)
+    std::unordered_map<PipelineKey, WGPURenderPipeline, PipelineKeyHash> mPipelineCache;
+
+    // createRenderPipelineAsync requests in flight. The callback owns and
+    // frees the request; owner is cleared if the shader or the backend is
+    // released first, so a late pipeline is just dropped.
+    struct PendingPipeline {
+        WebGPUBackend* owner = nullptr;
+        PipelineKey key;
+    };
+    std::unordered_map<PipelineKey, PendingPipeline*, PipelineKeyHash> mPendingPipelines;
+
+    // Bind groups keyed by (layout, resources); the cache owns them and the
+    // mXxxBindGroup members below are non-owning references into it.
+    std::unordered_map<BindGroupKey, BindGroupCacheEntry, BindGroupKeyHash> mBindGroupCache;
+    std::list<BindGroupKey> mBindGroupLru;  // Front = most recently used
+
     // Core WebGPU objects
     WGPUDevice mDevice = nullptr;
     WGPUQueue mQueue = nullptr;
@@ -390,6 +757,7 @@ private:
 
     // Current frame state
     WGPUTextureView mCurrentSwapChainView = nullptr;
+    int32_t mFrameAcquireInfo[3] = {0, 0, 0};  // Written by beginFrame's JS: {resized, width, height}
     WGPUCommandEncoder mCommandEncoder = nullptr;
     WGPURenderPassEncoder mRenderPassEncoder = nullptr;
     WGPUComputePassEncoder mComputePassEncoder = nullptr;
@@ -404,6 +772,7 @@ private:
     // Current pipeline state
     ShaderHandle mCurrentShader;
     ShaderHandle mDefaultShader;    // Default mesh shader for fallback
+    ShaderHandle mInstancedShader;  // Default shader, per-instance modelView + tint
     ShaderHandle mTexturedShader;   // Textured mesh shader
     ShaderHandle mScreenSpaceShader; // Screen-space textured shader (for post-processing)
     ShaderHandle mLitShader;        // Lighting shader (Phase 2)
@@ -421,6 +790,9 @@ private:
     WGPUBindGroup mSkyboxBindGroup = nullptr;
     WGPUBindGroupLayout mSkyboxBindGroupLayout = nullptr;
     WGPURenderPipeline mSkyboxPipeline = nullptr;
+    WGPUBindGroupLayout mSkyboxCubeBindGroupLayout = nullptr;  // texture_cube variant
+    WGPURenderPipeline mSkyboxCubePipeline = nullptr;
+    bool mSkyboxCube = false;  // mSkyboxBindGroup holds a cubemap
     TextureHandle mBoundEnvironmentTexture;
     float mEnvExposure = 1.0f;
     float mEnvGamma = 2.2f;
@@ -432,7 +804,11 @@ private:
     WGPUBuffer mEnvReflectUniformBuffer = nullptr;
     WGPUBindGroup mEnvReflectBindGroup = nullptr;
     WGPUBindGroupLayout mEnvReflectBindGroupLayout = nullptr;
+    WGPUSampler mEnvReflectSampler = nullptr;  // Shared so the bind group can be cached
     WGPURenderPipeline mEnvReflectPipeline = nullptr;
+    WGPUBindGroupLayout mEnvReflectCubeBindGroupLayout = nullptr;  // texture_cube variant
+    WGPURenderPipeline mEnvReflectCubePipeline = nullptr;
+    bool mEnvReflectCube = false;  // mEnvReflectBindGroup holds a cubemap
     bool mEnvReflectBindingDirty = true;
     bool mEnvReflectActive = false;
 
@@ -481,9 +857,13 @@ private:
         float envIntensity;
         float exposure;
         float gamma;
-        float _pad;
+        float envMaxLod;      // Last mip of the prefiltered env map
         float invViewRot[12]; // mat3 stored as 3x vec4 for WGSL alignment
         float cameraPos[4];   // xyz + padding
+        float diffuseSH[4];   // x = 1 to use sh instead of the irradiance map
+        float sh[36];         // 9 SH coefficients as vec4 (rgb + padding)
+        float clusterViewport[4];
+        float clusterDepth[4];  // slice scale, bias, 1 = enabled
     };
 
     PBRMaterialData mPBRMaterial;
@@ -513,7 +893,52 @@ private:
     LightData mLights[8];
     MaterialData mMaterial;
     float mNormalMatrix[16];  // Stored as 4x4 for WGSL padding
+
+    // Clustered lights (setClusteredLights); the buffers grow, never shrink
+    WGPUBuffer mClusterLightBuffer = nullptr;
+    WGPUBuffer mClusterRangeBuffer = nullptr;
+    WGPUBuffer mClusterIndexBuffer = nullptr;
+    size_t mClusterLightCapacity = 0;   // Bytes
+    size_t mClusterRangeCapacity = 0;
+    size_t mClusterIndexCapacity = 0;
+    float mClusterParams[8] = {0, 0, 1, 1, 0, 0, 0, 0};  // viewport, depth
+    bool mClusteredLighting = false;
     BufferHandle mCurrentVertexBuffer;
+    BufferHandle mInstanceBuffer;       // setInstanceBuffer(), vertex slot 1
+    size_t mInstanceBufferOffset = 0;
+
+    // bindStorageBuffer() slots, read by the next dispatch()
+    static constexpr int kMaxStorageBindings = 8;
+    BufferHandle mStorageBuffers[kMaxStorageBindings];
+
+    // One draw captured by the sorted queue, with everything it binds
+    struct QueuedDraw {
+        enum Order : uint8_t { Opaque, Blended, Fence };
+        WGPURenderPipeline pipeline = nullptr;
+        WGPUBindGroup bindGroup = nullptr;
+        uint32_t dynamicOffset = 0;
+        WGPUBuffer vertexBuffer = nullptr;
+        uint64_t vertexSize = 0;
+        WGPUBuffer instanceBuffer = nullptr;
+        uint64_t instanceOffset = 0;
+        uint64_t instanceSize = 0;
+        WGPUBuffer indexBuffer = nullptr;
+        WGPUIndexFormat indexFormat = WGPUIndexFormat_Undefined;
+        uint64_t indexSize = 0;
+        bool indexed = false;
+        uint32_t count = 0;
+        uint32_t instanceCount = 1;
+        uint32_t first = 0;
+        int32_t baseVertex = 0;
+        uint32_t firstInstance = 0;
+        Order order = Opaque;
+        uint32_t segment = 0;   // Bumped after each Fence draw
+        uint32_t sequence = 0;  // Submission order
+        float depth = 0.0f;     // View-space distance, front to back
+    };
+    QueuedDraw mQueueState;               // Bindings captured since the last draw
+    std::vector<QueuedDraw> mDrawQueue;   // Flushed before the pass ends
+    uint32_t mDrawQueueSegment = 0;
     BufferHandle mCurrentIndexBuffer;
     bool mIndexBuffer32Bit = false;
     VertexLayout mCurrentVertexLayout;
@@ -529,23 +954,163 @@ private:
     bool mUniformsDirty = false;
 
     // Dynamic uniform buffer for multiple draw calls per frame
-    // WebGPU requires 256-byte alignment for dynamic offsets
+    // WebGPU requires 256-byte alignment for dynamic offsets.
+    // Per-draw blocks are staged on the CPU and uploaded once per frame;
+    // when a chunk fills up another one is chained rather than falling back.
     static constexpr size_t kUniformAlignment = 256;
-    static constexpr size_t kMaxDrawsPerFrame = 256;
-    WGPUBuffer mUniformRingBuffer = nullptr;
+    static constexpr size_t kDrawsPerRingChunk = 256;
+    static constexpr size_t kUniformRingChunkSize = kUniformAlignment * kDrawsPerRingChunk;
+    std::vector<WGPUBuffer> mUniformRingChunks;  // Owned, kUniformRingChunkSize each
+    std::vector<uint8_t> mUniformStaging;        // CPU mirror of all chunks
+    size_t mUniformUploadedOffset = 0;           // Staged bytes already uploaded this frame
+    size_t mUniformRingChunk = 0;                // Chunk used by the current draw
+    WGPUBuffer mUniformRingBuffer = nullptr;     // Current chunk (non-owning)
     WGPUBindGroup mDynamicBindGroup = nullptr;
     WGPUBindGroupLayout mDynamicBindGroupLayout = nullptr;
     size_t mUniformRingOffset = 0;
     uint32_t mCurrentDynamicOffset = 0;
 
+    // GPU profiler: one query pair per pass, resolved at endFrame and read
+    // back asynchronously through a small ring of MapRead buffers
+    static constexpr uint32_t kMaxProfiledPasses = 32;
+    static constexpr int kProfilerReadbackSlots = 3;
+    struct ProfilerReadback {
+        WGPUBuffer buffer = nullptr;
+        bool inFlight = false;      // Copy recorded, results not read yet
+        bool mapRequested = false;  // mapAsync issued after submit
+        uint32_t passCount = 0;
+        uint8_t passKinds[kMaxProfiledPasses] = {};
+        WebGPUBackend* owner = nullptr;
+    };
+    bool mProfilerSupported = false;
+    bool mCompressionBC = false;    // texture-compression-* device features
+    bool mCompressionETC2 = false;
+    bool mCompressionASTC = false;
+    WGPUQuerySet mProfilerQuerySet = nullptr;
+    WGPUBuffer mProfilerResolveBuffer = nullptr;
+    ProfilerReadback mProfilerReadbacks[kProfilerReadbackSlots];
+    uint32_t mProfilerPassCount = 0;               // Passes bracketed this frame
+    uint8_t mProfilerPassKinds[kMaxProfiledPasses] = {};
+
+    // Async readback staging (MapRead). Slots live on the heap so map
+    // callbacks keep a stable pointer; a slot is reused once delivered.
+    static constexpr size_t kMaxReadbackSlots = 16;
+    struct ReadbackSlot {
+        WebGPUBackend* owner = nullptr;
+        WGPUBuffer buffer = nullptr;
+        size_t capacity = 0;        // Staging buffer size
+        size_t size = 0;            // Bytes requested by the caller
+        size_t mapSize = 0;         // Copied/mapped bytes (4-byte aligned)
+        ReadbackCallback callback;
+        bool busy = false;          // Copy recorded, callback not yet run
+        bool mapRequested = false;  // mapAsync issued (after submit)
+    };
+    std::vector<std::unique_ptr<ReadbackSlot>> mReadbackSlots;
+
+    // GPU-driven instancing: instances sorted by mesh in one storage buffer,
+    // a cull pass appends visible indices per mesh and bumps the indirect
+    // instanceCount, then one drawIndexedIndirect per mesh
+    static constexpr uint32_t kMaxIndirectMeshes = 16;
+    static constexpr uint32_t kMaxIndirectViews = 4;      // drawIndirectInstances() per frame
+    static constexpr size_t kIndirectParamsStride = 512;  // CullParams, 256-aligned
+    struct IndirectMesh {
+        WGPUBuffer vertexBuffer = nullptr;  // position + normal, 24-byte stride
+        WGPUBuffer indexBuffer = nullptr;   // uint32
+        uint32_t indexCount = 0;
+        float radius = 0.0f;                // Bounding sphere around the origin
+    };
+    std::vector<IndirectMesh> mIndirectMeshes;
+    WGPUBuffer mIndirectInstanceBuffer = nullptr;
+    WGPUBuffer mIndirectVisibleBuffer = nullptr;   // kMaxIndirectViews * capacity indices
+    WGPUBuffer mIndirectArgsBuffer = nullptr;      // kMaxIndirectViews * kMaxIndirectMeshes args
+    WGPUBuffer mIndirectParamsBuffer = nullptr;    // Per view CullParams
+    WGPUBuffer mIndirectDrawInfoBuffer = nullptr;  // Per view+mesh DrawInfo (dynamic offset)
+    WGPUBuffer mIndirectMaterialBuffer = nullptr;  // IndirectMaterial per sorted instance
+    uint32_t mIndirectInstanceCapacity = 0;
+    uint32_t mIndirectMeshBase[kMaxIndirectMeshes] = {};   // First sorted instance per mesh
+    uint32_t mIndirectMeshInstances[kMaxIndirectMeshes] = {};
+    uint32_t mIndirectViewSlot = 0;                // Reset every frame
+    WGPUShaderModule mIndirectCullShader = nullptr;
+    WGPUShaderModule mIndirectRenderShader = nullptr;
+    WGPUBindGroupLayout mIndirectCullLayout = nullptr;
+    WGPUBindGroupLayout mIndirectRenderLayout = nullptr;
+    WGPUPipelineLayout mIndirectCullPipelineLayout = nullptr;
+    WGPUPipelineLayout mIndirectRenderPipelineLayout = nullptr;
+    WGPUComputePipeline mIndirectCullPipeline = nullptr;
+    std::unordered_map<uint64_t, WGPURenderPipeline> mIndirectRenderPipelines;  // By attachment formats
+    WGPUBindGroup mIndirectCullBindGroup = nullptr;    // Rebuilt when the instance buffers grow
+    WGPUBindGroup mIndirectRenderBindGroup = nullptr;
+
+    // Shared primitive-conversion index buffers (uint32, indexed by ConversionIndexKind)
+    struct ConversionIndexBuffer {
+        WGPUBuffer buffer = nullptr;
+        uint32_t vertexCapacity = 0;
+    };
+    ConversionIndexBuffer mConversionIndices[(int)ConversionIndexKind::Count];
+
+    // Mipmap generation (render-pass blit; one encoder per batch)
+    std::vector<uint64_t> mPendingMipmaps;  // Texture IDs awaiting generation
+    std::unordered_map<int, WGPURenderPipeline> mMipmapPipelines;  // By WGPUTextureFormat
+    WGPUShaderModule mMipmapShader = nullptr;
+    WGPUBindGroupLayout mMipmapBindGroupLayout = nullptr;
+    WGPUPipelineLayout mMipmapPipelineLayout = nullptr;
+    WGPUSampler mMipmapSampler = nullptr;
+
+    // IBL baking (compute passes, see bakeIBL*)
+    enum IBLPass { kIBLCopy, kIBLPrefilter, kIBLIrradiance, kIBLBrdf, kIBLCube, kIBLPassCount };
+    struct IBLBakeParams {     // Matches BakeParams in kIBLBakeShader
+        float roughness = 0.0f;
+        float srcMaxLod = 0.0f;
+        float texelSolidAngle = 1.0f;
+        uint32_t sampleCount = 1;
+        uint32_t face = 0;     // kIBLCube
+        float srcLod = 0.0f;   // kIBLCube
+    };
+    static constexpr uint32_t kIBLParamsStride = 256;  // Dynamic offset alignment
+    static constexpr uint32_t kMaxIBLDispatches = 16;  // Per submit (one per mip)
+    WGPUShaderModule mIBLShader = nullptr;
+    WGPUBindGroupLayout mIBLBindGroupLayout = nullptr;
+    WGPUPipelineLayout mIBLPipelineLayout = nullptr;
+    WGPUComputePipeline mIBLPipelines[kIBLPassCount] = {};
+    WGPUSampler mIBLSampler = nullptr;
+    WGPUBuffer mIBLParamsBuffer = nullptr;
+    bool mIBLFailed = false;
+
+    // Render bundles. While recording, the draw paths encode into
+    // mBundleEncoder and stage uniforms into the bundle's own chunks.
+    enum : uint8_t { kBundleLayoutCustom, kBundleLayoutDefault, kBundleLayoutLit };
+    struct RenderBundleResource {
+        WGPURenderBundle bundle = nullptr;
+        WGPUTextureFormat colorFormat = WGPUTextureFormat_Undefined;
+        WGPUTextureFormat depthFormat = WGPUTextureFormat_Undefined;
+        std::vector<WGPUBuffer> uniformChunks;  // Bundle-owned uniform ring chunks
+        std::vector<uint8_t> uniforms;          // Recorded blocks, kUniformAlignment each
+        std::vector<uint8_t> blockLayouts;      // kBundleLayout* per block
+        std::vector<uint64_t> buffers;          // Referenced resources (for invalidation)
+        std::vector<uint64_t> textures;
+        std::vector<uint64_t> shaders;
+        uint32_t drawCount = 0;
+        bool valid = true;
+    };
+    std::unordered_map<uint64_t, RenderBundleResource> mBundles;
+    WGPURenderBundleEncoder mBundleEncoder = nullptr;
+
     // Viewport state
     int mViewportX = 0, mViewportY = 0;
     int mViewportW = 0, mViewportH = 0;
 
-    // Draw state
-    DrawState mCurrentDrawState;
+    // Draw state (initialized to match the legacy fixed pipelines:
+    // alpha blending, no culling, depth test + write)
+    DrawState mCurrentDrawState = makeDefaultDrawState();
     bool mDrawStateDirty = true;
 
+    static DrawState makeDefaultDrawState() {
+        DrawState state;
+        state.blend = BlendMode::Alpha;
+        state.cull = CullFace::None;
+        return state;
+    }
+
 #endif // __EMSCRIPTEN__
 
     // Handle generation
@@ -556,12 +1121,38 @@ private:
     int mWidth = 0;
     int mHeight = 0;
 
+    // Pipeline cache counters
+    PipelineCacheStats mPipelineStats;
+
+    // Instances uploaded with setIndirectInstances()
+    uint32_t mIndirectInstanceCount = 0;
+
+    // Bundle currently being recorded (0 = none)
+    uint64_t mRecordingBundleId = 0;
+
+    // GPU profiler state (indexed by pass kind: main, render-target, compute)
+    static constexpr int kProfilerPassKinds = 3;
+    bool mProfilerEnabled = false;
+    GPUPassTiming mProfilerTimings[kProfilerPassKinds];
+
+    // Bind group cache counters and LRU capacity
+    BindGroupCacheStats mBindGroupStats;
+    size_t mBindGroupCacheCapacity = 64;
+
+    // Sorted draw queue (setDrawSorting)
+    bool mDrawSorting = false;
+    DrawQueueStats mDrawQueueStats;
+    DrawQueueStats mDrawQueueFrameStats;
+
 #ifdef __EMSCRIPTEN__
     // ── Helper Methods ───────────────────────────────────────────────────
 
     void createSwapChain();
     void createDepthBuffer();
+    ShaderHandle createShader(const ShaderDesc& desc, bool instanceAttributes,
+                              bool async = false);
     void createDefaultShader();
+    void createInstancedShader();
     void createTexturedShader();
     void createScreenSpaceShader();    // Screen-space shader for post-processing
     void createLightingShader();       // Phase 2: Lighting
@@ -572,21 +1163,103 @@ private:
     void createEnvReflectShader();     // Phase 6: Environment reflections
     void updateTexturedBindGroup(ShaderHandle shaderToUse = {});
     void updateLightingBindGroup();    // Phase 2: Lighting
+    void createClusterBuffers();       // Empty grid, so lit/PBR bind groups are complete
+    void writeClusterBuffer(WGPUBuffer& buffer, size_t& capacity, const void* data, size_t bytes);
     void updateSkyboxBindGroup();      // Phase 4: Skybox
     void updatePBRBindGroup();         // Phase 5: PBR
     void updateEnvReflectBindGroup();  // Phase 6: Environment reflections
     void beginRenderPass();
     void endRenderPass();
     void flushUniforms();
-    void drawTriangleFanEmulated(int vertexCount, int firstVertex); // WebGPU doesn't support TriangleFan
-
-    // Get or create pipeline for a specific primitive type
-    WGPURenderPipeline getPipelineForPrimitive(ShaderResource& shader, PrimitiveType primitive);
-    WGPURenderPipeline createPipelineForPrimitive(ShaderResource& shader, PrimitiveType primitive);
+    void uploadStagedUniforms();  // One write per chunk touched since the last upload
+    WGPUBuffer getUniformRingChunk(size_t index);
+    WGPUBindGroup getUniformBindGroup(const ShaderResource& shader);
+    WGPUBindGroup computeBindGroup(ComputeResource& compute);  // From mStorageBuffers
+    // WebGPU doesn't support TriangleFan / LineLoop - draw them through the
+    // shared conversion index buffers
+    void drawEmulatedPrimitive(PrimitiveType primitive, int vertexCount, int firstVertex);
+    void flushPendingMipmaps();        // Downsample every queued texture in one submit
+    bool encodeMipmaps(WGPUCommandEncoder encoder, const TextureResource& tex);
+    bool createProfilerResources();
+    // Draw encoding goes to the bundle encoder while recording, else the pass
+    bool beginDrawEncoding();
+    void encodeSetPipeline(WGPURenderPipeline pipeline);
+    void encodeSetBindGroup(WGPUBindGroup bindGroup, uint32_t dynamicOffset);
+    void encodeSetVertexBuffer(WGPUBuffer buffer, uint64_t size);
+    void encodeSetInstanceBuffer(WGPUBuffer buffer, uint64_t offset, uint64_t size);
+    void queueDraw(bool indexed, uint32_t count, uint32_t instanceCount,
+                   uint32_t first, int32_t baseVertex, uint32_t firstInstance);
+    // Replay queued draws into the pass in sorted order
+    void flushDrawQueue();
+    void encodeSetIndexBuffer(WGPUBuffer buffer, WGPUIndexFormat format, uint64_t size);
+    void encodeDraw(uint32_t vertexCount, uint32_t instanceCount,
+                    uint32_t firstVertex, uint32_t firstInstance);
+    void encodeDrawIndexed(uint32_t indexCount, uint32_t instanceCount,
+                           uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance);
+    void stageBundleUniforms(uint8_t layout);
+    void uploadBundleUniforms(RenderBundleResource& bundle, const uint8_t* data);
+    void releaseBundleResources(RenderBundleResource& bundle);
+    void invalidateBundlesUsing(uint64_t bufferId, uint64_t textureId, uint64_t shaderId);
+    void currentAttachmentFormats(WGPUTextureFormat& color, WGPUTextureFormat& depth) const;
+    void releaseProfilerResources();
+    // Reserves a begin/end query pair for the next pass (false when
+    // profiling is off or this frame's query slots are used up)
+    bool nextProfilerTimestampWrites(uint8_t passKind, uint32_t& beginIndex, uint32_t& endIndex);
+    void resolveProfilerQueries();     // Before the frame's command buffer is finished
+    void readProfilerResults();        // After submit: start the async map
+    ReadbackSlot* acquireReadbackSlot(size_t size);
+    bool createIndirectPipelines();
+    WGPURenderPipeline getIndirectRenderPipeline();
+    bool ensureIndirectCapacity(uint32_t instanceCount);
+    void releaseIndirectResources();
+    void mapReadbackSlot(ReadbackSlot* slot);
+    void requestReadbackMaps();        // After submit: map this frame's copies
+    void releaseReadbackSlots();
+    static void onReadbackMapped(WGPUBufferMapAsyncStatus status, void* userdata);
+    static void onProfilerReadback(WGPUBufferMapAsyncStatus status, void* userdata);
+    WGPURenderPipeline getMipmapPipeline(WGPUTextureFormat format);
+    void releaseMipmapResources();
+    bool createIBLPipelines();
+    TextureHandle createIBLTarget(int width, int height, int levels);
+    void encodeIBLPass(WGPUCommandEncoder encoder, IBLPass pass,
+                       const TextureResource& src, const TextureResource& dst,
+                       uint32_t level, uint32_t slot, const IBLBakeParams& params,
+                       uint32_t layer = 0);
+    void submitIBL(WGPUCommandEncoder encoder);
+    void releaseIBLResources();
+    static bool isMipmapRenderable(WGPUTextureFormat format);
+    static void compressedLayout(PixelFormat format, int width, int height,
+                                 WGPUTextureDataLayout& layout, WGPUExtent3D& extent);
+
+    // Get or create the pipeline for a primitive type under the current
+    // draw state, vertex layout and render target formats
+    WGPURenderPipeline getPipelineForPrimitive(uint64_t shaderId, const ShaderResource& shader,
+                                               PrimitiveType primitive);
+    PipelineKey makePipelineKey(uint64_t shaderId, PrimitiveType primitive,
+                                const DrawState& state) const;
+    // With `async` the pipeline is requested from createRenderPipelineAsync
+    // and nullptr returned; onPipelineCreated() caches it
+    WGPURenderPipeline createPipeline(const ShaderResource& shader, const PipelineKey& key,
+                                      PendingPipeline* async = nullptr);
+    static void onPipelineCreated(WGPUCreatePipelineAsyncStatus status,
+                                  WGPURenderPipeline pipeline, const char* message,
+                                  void* userdata);
+    void releaseShaderPipelines(uint64_t shaderId);
+    static uint32_t hashVertexLayout(const VertexLayout& layout);
+
+    // Look up (or create and cache) the bind group for these entries.
+    // The returned bind group is owned by the cache - don't release it.
+    WGPUBindGroup getOrCreateBindGroup(WGPUBindGroupLayout layout,
+                                       const WGPUBindGroupEntry* entries, size_t count);
+    void evictLeastRecentBindGroup();
+    void purgeBindGroupsUsing(WGPUBuffer buffer, WGPUTextureView view, WGPUSampler sampler);
+    void forgetBindGroup(WGPUBindGroup bindGroup);  // Clear member references
+    void releaseBindGroupCache();
 
     WGPUBufferUsageFlags toWGPUBufferUsage(BufferType type, BufferUsage usage);
     WGPUTextureFormat toWGPUFormat(PixelFormat format);
     WGPUPrimitiveTopology toWGPUPrimitive(PrimitiveType type);
+    static WGPUVertexFormat toWGPUVertexFormat(VertexFormat format, int components);
     WGPUAddressMode toWGPUAddressMode(WrapMode mode);
     WGPUFilterMode toWGPUFilterMode(FilterMode mode);
     WGPUCompareFunction toWGPUCompareFunc(DepthFunc func);
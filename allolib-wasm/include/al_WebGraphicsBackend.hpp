@@ -32,6 +32,8 @@
 #include <string>
 #include <cstdint>
 #include <functional>
+#include <utility>
+#include <vector>
 
 namespace al {
 
@@ -72,6 +74,116 @@ struct ComputePipelineHandle {
     operator bool() const { return valid(); }
 };
 
+// ─── Handle Table ────────────────────────────────────────────────────────────
+
+/// Generational slot map backends use to store resources behind handles.
+///
+/// Handle ids pack (generation << 32) | (slot + 1), so lookups are an array
+/// index plus a compare, and a handle kept after destroy* stops resolving
+/// once its slot is reused. The interface mirrors the subset of
+/// std::unordered_map<uint64_t, T> the backends use (find/end/erase/
+/// iteration over {id, resource} pairs).
+template <typename T>
+class HandleTable {
+public:
+    using value_type = std::pair<uint64_t, T>;
+
+    template <typename Slot, typename Value>
+    class Iterator {
+    public:
+        Iterator(Slot* slot, Slot* end) : mSlot(slot), mEnd(end) { skipFree(); }
+        Value& operator*() const { return mSlot->entry; }
+        Value* operator->() const { return &mSlot->entry; }
+        Iterator& operator++() { ++mSlot; skipFree(); return *this; }
+        bool operator==(const Iterator& o) const { return mSlot == o.mSlot; }
+        bool operator!=(const Iterator& o) const { return mSlot != o.mSlot; }
+
+    private:
+        friend class HandleTable;
+        void skipFree() { while (mSlot != mEnd && mSlot->entry.first == 0) ++mSlot; }
+        Slot* mSlot;
+        Slot* mEnd;
+    };
+
+    struct Slot {
+        value_type entry{0, T{}};  // entry.first == 0 while free
+        uint32_t generation = 0;
+    };
+
+    using iterator = Iterator<Slot, value_type>;
+    using const_iterator = Iterator<const Slot, const value_type>;
+
+    /// Store a resource and return its handle id (never 0)
+    uint64_t insert(T value) {
+        uint32_t index;
+        if (!mFree.empty()) {
+            index = mFree.back();
+            mFree.pop_back();
+        } else {
+            index = static_cast<uint32_t>(mSlots.size());
+            mSlots.emplace_back();
+        }
+        Slot& slot = mSlots[index];
+        slot.generation++;
+        slot.entry.first = (static_cast<uint64_t>(slot.generation) << 32) | (index + 1);
+        slot.entry.second = std::move(value);
+        mSize++;
+        return slot.entry.first;
+    }
+
+    iterator find(uint64_t id) {
+        Slot* slot = lookup(id);
+        return slot ? iterator(slot, endSlot()) : end();
+    }
+    const_iterator find(uint64_t id) const {
+        const Slot* slot = const_cast<HandleTable*>(this)->lookup(id);
+        return slot ? const_iterator(slot, endSlot()) : end();
+    }
+
+    /// Free the slot; returns the next live entry
+    iterator erase(iterator it) {
+        Slot* slot = it.mSlot;
+        slot->entry.first = 0;
+        slot->entry.second = T{};
+        mFree.push_back(static_cast<uint32_t>(slot - mSlots.data()));
+        mSize--;
+        return ++it;
+    }
+
+    void clear() {
+        // Generations survive so handles from before the clear stay stale
+        mFree.clear();
+        for (uint32_t i = static_cast<uint32_t>(mSlots.size()); i-- > 0;) {
+            mSlots[i].entry.first = 0;
+            mSlots[i].entry.second = T{};
+            mFree.push_back(i);
+        }
+        mSize = 0;
+    }
+
+    iterator begin() { return iterator(mSlots.data(), endSlot()); }
+    iterator end() { return iterator(endSlot(), endSlot()); }
+    const_iterator begin() const { return const_iterator(mSlots.data(), endSlot()); }
+    const_iterator end() const { return const_iterator(endSlot(), endSlot()); }
+
+    size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+
+private:
+    Slot* lookup(uint64_t id) {
+        uint32_t index = static_cast<uint32_t>(id) - 1;  // id 0 wraps out of range
+        if (index >= mSlots.size()) return nullptr;
+        Slot& slot = mSlots[index];
+        return slot.entry.first == id ? &slot : nullptr;
+    }
+    Slot* endSlot() { return mSlots.data() + mSlots.size(); }
+    const Slot* endSlot() const { return mSlots.data() + mSlots.size(); }
+
+    std::vector<Slot> mSlots;
+    std::vector<uint32_t> mFree;
+    size_t mSize = 0;
+};
+
 // ─── Enumerations ────────────────────────────────────────────────────────────
 
 /// Backend type selection
@@ -102,12 +214,20 @@ enum class PixelFormat {
     RG8,        ///< 8-bit two channel
     RGB8,       ///< 8-bit RGB
     RGBA8,      ///< 8-bit RGBA (most common)
+    SRGBA8,     ///< 8-bit sRGB-encoded RGBA (color textures)
     R16F,       ///< 16-bit float single channel
     RG16F,      ///< 16-bit float two channel
     RGBA16F,    ///< 16-bit float RGBA (HDR)
     R32F,       ///< 32-bit float single channel
     RG32F,      ///< 32-bit float two channel
     RGBA32F,    ///< 32-bit float RGBA (compute)
+    RGB9E5,     ///< Shared-exponent HDR RGB, 4 bytes (sample-only)
+    BC1,        ///< 4x4 blocks, 8 bytes (RGB + 1-bit alpha, desktop)
+    BC3,        ///< 4x4 blocks, 16 bytes (RGBA, desktop)
+    BC7,        ///< 4x4 blocks, 16 bytes (high-quality RGBA, desktop)
+    ETC2_RGB8,  ///< 4x4 blocks, 8 bytes (RGB, mobile)
+    ETC2_RGBA8, ///< 4x4 blocks, 16 bytes (RGBA, mobile)
+    ASTC_4x4,   ///< 4x4 blocks, 16 bytes (RGBA, mobile / Apple)
     Depth16,    ///< 16-bit depth
     Depth24,    ///< 24-bit depth
     Depth32F,   ///< 32-bit float depth
@@ -131,7 +251,8 @@ enum class BlendMode {
     Alpha,      ///< Standard alpha blending
     Additive,   ///< Additive blending (glow effects)
     Multiply,   ///< Multiply blending
-    PreMultiplied  ///< Pre-multiplied alpha
+    PreMultiplied, ///< Pre-multiplied alpha
+    Screen      ///< Screen blending (1 - (1-src)(1-dst))
 };
 
 /// Face culling modes
@@ -168,6 +289,42 @@ enum class WrapMode {
     ClampToBorder
 };
 
+/// Block-compressed formats are sample-only and cannot be mipmapped on the GPU
+inline bool isCompressedFormat(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::BC1:
+        case PixelFormat::BC3:
+        case PixelFormat::BC7:
+        case PixelFormat::ETC2_RGB8:
+        case PixelFormat::ETC2_RGBA8:
+        case PixelFormat::ASTC_4x4:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Bytes per 4x4 block of a compressed format (0 if uncompressed)
+inline int compressedBlockBytes(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::BC1:
+        case PixelFormat::ETC2_RGB8:
+            return 8;
+        case PixelFormat::BC3:
+        case PixelFormat::BC7:
+        case PixelFormat::ETC2_RGBA8:
+        case PixelFormat::ASTC_4x4:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+/// Size of one width x height image of a compressed format
+inline size_t compressedImageBytes(PixelFormat format, int width, int height) {
+    return size_t((width + 3) / 4) * size_t((height + 3) / 4) * compressedBlockBytes(format);
+}
+
 // ─── Descriptor Structures ───────────────────────────────────────────────────
 
 /// Texture creation descriptor
@@ -182,8 +339,11 @@ struct TextureDesc {
     WrapMode wrapT = WrapMode::ClampToEdge;
     WrapMode wrapR = WrapMode::ClampToEdge;
     bool mipmaps = false;
+    int mipLevels = 0;          ///< Pre-baked level count, filled by updateTexture() (0 = from mipmaps)
     bool renderTarget = false;  ///< Can be used as render target
     bool storageTexture = false; ///< Can be written from compute (WebGPU)
+    bool externalImage = false; ///< Filled by uploadImageBitmap() (WebGPU adds the usage it needs)
+    bool cubemap = false;       ///< Six width x width layers viewed as a cube (WebGPU)
     int samples = 1;            ///< MSAA sample count
 };
 
@@ -195,12 +355,23 @@ struct ShaderDesc {
     std::string name;           ///< Debug name
 };
 
+/// Vertex attribute component type
+enum class VertexFormat {
+    Float32,    ///< 4 bytes per component
+    Float16,    ///< Half float, 2 bytes per component
+    Snorm16,    ///< int16 mapped to [-1, 1]
+    Unorm16,    ///< uint16 mapped to [0, 1]
+    Snorm8,     ///< int8 mapped to [-1, 1]
+    Unorm8      ///< uint8 mapped to [0, 1]
+};
+
 /// Vertex attribute descriptor
 struct VertexAttribute {
     int location;       ///< Shader attribute location
     int components;     ///< Number of components (1-4)
     int offset;         ///< Byte offset in vertex
     bool normalized = false;
+    VertexFormat format = VertexFormat::Float32;  ///< 8/16-bit formats occupy 2 or 4 components
 };
 
 /// Vertex layout descriptor
@@ -223,6 +394,13 @@ struct DrawState {
     float pointSize = 1.0f;
 };
 
+/// Per-instance record read by setInstanceBuffer() draws (80 bytes).
+/// Shaders see it at locations 4-7 (modelView columns) and 8 (tint).
+struct InstanceAttributes {
+    float modelView[16];  // Column-major, replaces the modelViewMatrix uniform
+    float tint[4];        // Multiplies the vertex color
+};
+
 /// Clear values for render pass
 struct ClearValues {
     float r = 0.0f, g = 0.0f, b = 0.0f, a = 1.0f;
@@ -281,6 +459,18 @@ public:
     /// Set draw state (blending, culling, depth)
     virtual void setDrawState(const DrawState& state) = 0;
 
+    /// Draw state last passed to setDrawState()
+    virtual DrawState getDrawState() const { return {}; }
+
+    /**
+     * Queue draws and submit them sorted by state when the pass ends
+     * (pipeline, bind group, mesh, front-to-back depth). Blended and
+     * depth-write-off draws keep their order after the opaque ones; draws
+     * without a depth test are never moved across. Default: unsupported.
+     */
+    virtual void setDrawSorting(bool enabled) {}
+    virtual bool drawSorting() const { return false; }
+
     // ── Buffers ──────────────────────────────────────────────────────────
 
     /// Create a GPU buffer
@@ -322,6 +512,21 @@ public:
     /// Generate mipmaps for a texture
     virtual void generateMipmaps(TextureHandle handle) = 0;
 
+    /**
+     * Fill level 0 of a 2D RGBA8 texture from a browser-decoded bitmap
+     * (WebImage::loadBitmap()) without the pixels passing through the wasm
+     * heap; mipmapped textures get their chain regenerated. Create the
+     * texture with desc.externalImage and the bitmap's size.
+     * Default: unsupported.
+     */
+    virtual bool uploadImageBitmap(TextureHandle handle, int bitmapId) { return false; }
+
+    /// Whether textures of `format` can be created on this device.
+    /// Default: everything but the block-compressed formats.
+    virtual bool supportsTextureFormat(PixelFormat format) const {
+        return !isCompressedFormat(format);
+    }
+
     /// Destroy a texture
     virtual void destroyTexture(TextureHandle handle) = 0;
 
@@ -347,6 +552,18 @@ public:
     /// Create a shader program/pipeline
     virtual ShaderHandle createShader(const ShaderDesc& desc) = 0;
 
+    /**
+     * Start compiling a shader without waiting for the driver. The handle
+     * is usable at once; binding it before isShaderReady() reports true
+     * waits for the compile instead of drawing with a missing program.
+     * Backends without background compilation compile synchronously.
+     */
+    virtual ShaderHandle createShaderAsync(const ShaderDesc& desc) { return createShader(desc); }
+
+    /// True once the shader can be bound without stalling (a shader that
+    /// failed to compile is also ready; the error has been logged)
+    virtual bool isShaderReady(ShaderHandle handle) { return true; }
+
     /// Destroy a shader
     virtual void destroyShader(ShaderHandle handle) = 0;
 
@@ -411,6 +628,59 @@ public:
         int firstInstance = 0
     ) = 0;
 
+    /**
+     * Bind per-instance attributes for drawInstanced()/drawIndexedInstanced().
+     * The buffer holds InstanceAttributes records starting at `offset`;
+     * an invalid handle unbinds it. Default: ignored.
+     */
+    virtual void setInstanceBuffer(BufferHandle handle, size_t offset = 0) {}
+
+    /// Whether the next instanced draw, with the current shader and
+    /// texture bindings, would read the bound instance buffer
+    virtual bool supportsInstanceBuffer() const { return false; }
+
+    /**
+     * Submit `drawCount` draws from the bound vertex/index buffers in one
+     * call. Range i is firsts[i] / counts[i] (vertices, or indices for the
+     * indexed variants). Default: loops over the single-draw calls; backends
+     * with native multi-draw override them.
+     */
+    virtual void multiDraw(PrimitiveType primitive, const int* firsts,
+                           const int* counts, int drawCount) {
+        for (int i = 0; i < drawCount; i++) draw(primitive, counts[i], firsts[i]);
+    }
+
+    virtual void multiDrawIndexed(PrimitiveType primitive, const int* firsts,
+                                  const int* counts, int drawCount) {
+        for (int i = 0; i < drawCount; i++) drawIndexed(primitive, counts[i], firsts[i]);
+    }
+
+    virtual void multiDrawInstanced(PrimitiveType primitive, const int* firsts,
+                                    const int* counts, const int* instanceCounts,
+                                    int drawCount) {
+        for (int i = 0; i < drawCount; i++) {
+            drawInstanced(primitive, counts[i], instanceCounts[i], firsts[i]);
+        }
+    }
+
+    virtual void multiDrawIndexedInstanced(PrimitiveType primitive, const int* firsts,
+                                           const int* counts, const int* instanceCounts,
+                                           int drawCount) {
+        for (int i = 0; i < drawCount; i++) {
+            drawIndexedInstanced(primitive, counts[i], instanceCounts[i], firsts[i]);
+        }
+    }
+
+    /// Whether multiDraw*() map to a single native call
+    virtual bool supportsMultiDraw() const { return false; }
+
+    /**
+     * Called before anything that depends on draw order (clear, render
+     * target or viewport change, end of frame), so callers deferring draws
+     * can submit them first. Not called re-entrantly.
+     */
+    void setFlushHook(std::function<void()> hook) { mFlushHook = std::move(hook); }
+
     // ── Compute (WebGPU only) ────────────────────────────────────────────
 
     /// Check if compute shaders are supported
@@ -424,7 +694,8 @@ public:
     /// Destroy a compute pipeline
     virtual void destroyComputePipeline(ComputePipelineHandle handle) {}
 
-    /// Bind a storage buffer for compute
+    /// Bind a storage buffer for the next dispatch(); an invalid handle
+    /// unbinds it
     virtual void bindStorageBuffer(int binding, BufferHandle handle) {}
 
     /// Bind a storage texture for compute
@@ -451,6 +722,27 @@ public:
         size_t offset = 0
     ) {}
 
+    /// Receives readBufferAsync() results. `data` is only valid during the
+    /// call; it is null (and size 0) if the readback failed.
+    using ReadbackCallback = std::function<void(const void* data, size_t size)>;
+
+    /// Read buffer data back without blocking. The callback runs once the
+    /// copy has completed on the GPU (typically a frame or two later on
+    /// WebGPU). Returns false if the request couldn't be queued.
+    /// Default: synchronous readBuffer(), then the callback immediately.
+    virtual bool readBufferAsync(
+        BufferHandle handle,
+        size_t size,
+        size_t offset,
+        ReadbackCallback callback
+    ) {
+        if (!callback) return false;
+        std::vector<uint8_t> data(size);
+        readBuffer(handle, data.data(), size, offset);
+        callback(data.data(), size);
+        return true;
+    }
+
     /// Copy data between buffers
     virtual void copyBuffer(
         BufferHandle src,
@@ -460,6 +752,23 @@ public:
         size_t dstOffset = 0
     ) {}
 
+    // ── GPU Timing ───────────────────────────────────────────────────────
+    //
+    // GPU time per frame from timestamp queries (WebGPU "timestamp-query",
+    // WebGL2 EXT_disjoint_timer_query_webgl2). Results lag the CPU by a
+    // few frames. Default: unsupported.
+
+    /// True when the device can measure GPU time
+    virtual bool isGPUProfilingSupported() const { return false; }
+
+    /// Start or stop measuring. Returns false (and stays disabled) when
+    /// the device cannot measure GPU time.
+    virtual bool setGPUProfilingEnabled(bool enabled) { return !enabled; }
+    virtual bool isGPUProfilingEnabled() const { return false; }
+
+    /// Averaged GPU ms per frame; 0 until measured
+    virtual double getGPUFrameTimeMs() const { return 0.0; }
+
     // ── Queries ──────────────────────────────────────────────────────────
 
     /// Get the backend type
@@ -485,6 +794,19 @@ public:
         int h = getHeight();
         return h > 0 ? float(getWidth()) / float(h) : 1.0f;
     }
+
+protected:
+    /// Run the flush hook (see setFlushHook)
+    void runFlushHook() {
+        if (!mFlushHook || mInFlushHook) return;
+        mInFlushHook = true;
+        mFlushHook();
+        mInFlushHook = false;
+    }
+
+private:
+    std::function<void()> mFlushHook;
+    bool mInFlushHook = false;
 };
 
 // ─── Factory Functions ───────────────────────────────────────────────────────
@@ -20,19 +20,34 @@
  *   - Standard Radiance HDR format (.hdr)
  *   - RLE compressed and uncompressed data
  *   - Returns floating-point RGB (3 floats per pixel)
+ *
+ * For GPU use, setFormat(WebHDR::Format::RGB9E5) (or RGBA16F) decodes
+ * straight into upload-ready texels (4 or 8 bytes instead of 12, SIMD128
+ * where available) plus a small prefiltered preview for sampleDirection().
+ * Call releasePixels() after uploading to drop the full-size data.
+ *
+ * load() decodes on the JobSystem pool in threaded builds (al_WebJobs.hpp).
  */
 
 #ifndef AL_WEB_HDR_HPP
 #define AL_WEB_HDR_HPP
 
 #include <emscripten.h>
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <cstring>
 #include <cmath>
 #include <functional>
 
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+#include "al_WebAssetLoader.hpp"
 #include "al_WebFile.hpp"
+#include "al_WebJobs.hpp"
 
 namespace al {
 
@@ -45,6 +60,13 @@ public:
 
     WebHDR() : mWidth(0), mHeight(0), mReady(false) {}
 
+    /// Storage for decoded texels (see setFormat())
+    enum class Format {
+        Float32,   ///< RGB float, 12 bytes/texel, kept for CPU access (default)
+        RGBA16F,   ///< Half-float RGBA, 8 bytes/texel, GPU staging only
+        RGB9E5     ///< Shared-exponent RGB, 4 bytes/texel, GPU staging only
+    };
+
     /**
      * Parse HDR data from memory buffer
      * @param data Raw HDR file data
@@ -56,162 +78,170 @@ public:
      */
     static bool parse(const uint8_t* data, size_t size,
                       std::vector<float>& pixels, int& width, int& height) {
-        if (size < 10) return false;
-
-        const char* ptr = reinterpret_cast<const char*>(data);
-        const char* end = ptr + size;
-
-        printf("[WebHDR] Parsing %zu bytes\n", size);
-
-        // Check magic number
-        if (strncmp(ptr, "#?RADIANCE", 10) != 0 && strncmp(ptr, "#?RGBE", 6) != 0) {
-            // Try to continue anyway - some files don't have the magic
-            printf("[WebHDR] Warning: Missing HDR magic number, first bytes: %02x %02x %02x %02x\n",
-                   (unsigned char)ptr[0], (unsigned char)ptr[1], (unsigned char)ptr[2], (unsigned char)ptr[3]);
-        } else {
-            printf("[WebHDR] Magic number found\n");
-        }
-
-        // Skip header lines until empty line
-        int lineCount = 0;
-        while (ptr < end && lineCount < 50) {  // Safety limit
-            // Find end of line
-            const char* lineEnd = ptr;
-            while (lineEnd < end && *lineEnd != '\n' && *lineEnd != '\r') lineEnd++;
-
-            size_t lineLen = lineEnd - ptr;
-
-            // Debug: print first few header lines
-            if (lineCount < 10) {
-                std::string line(ptr, std::min(lineLen, (size_t)60));
-                printf("[WebHDR] Header line %d: '%s'\n", lineCount, line.c_str());
-            }
+        bool ok = readScanlines(data, size, width, height, [&](int y, const uint8_t* rgbe) {
+            if (y == 0) pixels.resize((size_t)width * height * 3);
+            rgbeToFloat(rgbe, pixels.data() + (size_t)y * width * 3, width);
+        });
+        if (ok) printf("[WebHDR] Parsed: %dx%d HDR image\n", width, height);
+        return ok;
+    }
 
-            // Check if empty line (end of header)
-            if (lineLen == 0) {
-                printf("[WebHDR] Found empty line at line %d, header ends\n", lineCount);
-                ptr = lineEnd;
-                while (ptr < end && (*ptr == '\n' || *ptr == '\r')) ptr++;
-                break;
+    /**
+     * Parse HDR data into packed GPU texels, one scanline at a time with
+     * no float image in between
+     * @param format RGBA16F (uint16 halves) or RGB9E5 (one uint32 per texel)
+     * @param texels Output staging data (will be resized)
+     * @param preview If non-null, also box-filtered to at most previewWidth
+     *        texels wide as RGB floats (previewHeight follows the aspect)
+     * @return true on success
+     */
+    static bool parsePacked(const uint8_t* data, size_t size, Format format,
+                            std::vector<uint8_t>& texels, int& width, int& height,
+                            std::vector<float>* preview = nullptr, int previewWidth = 0,
+                            int* previewHeight = nullptr) {
+        if (format == Format::Float32) return false;
+        size_t texelBytes = format == Format::RGB9E5 ? 4 : 8;
+        PreviewBuilder builder;
+        bool ok = readScanlines(data, size, width, height, [&](int y, const uint8_t* rgbe) {
+            if (y == 0) {
+                texels.resize((size_t)width * height * texelBytes);
+                if (preview && previewWidth > 0) builder.begin(width, height, previewWidth, *preview);
             }
-
-            // Check if this is the resolution line (contains -Y or +Y)
-            std::string line(ptr, lineLen);
-            if (line.find("-Y") != std::string::npos || line.find("+Y") != std::string::npos ||
-                line.find("-X") != std::string::npos || line.find("+X") != std::string::npos) {
-                printf("[WebHDR] Found resolution line at line %d: '%s'\n", lineCount, line.c_str());
-                // Parse it
-                if (sscanf(line.c_str(), "-Y %d +X %d", &height, &width) == 2 ||
-                    sscanf(line.c_str(), "+Y %d +X %d", &height, &width) == 2 ||
-                    sscanf(line.c_str(), "-X %d -Y %d", &width, &height) == 2 ||
-                    sscanf(line.c_str(), "+X %d -Y %d", &width, &height) == 2 ||
-                    sscanf(line.c_str(), "+X %d +Y %d", &width, &height) == 2) {
-                    printf("[WebHDR] Parsed resolution: %dx%d\n", width, height);
-                    ptr = lineEnd;
-                    while (ptr < end && (*ptr == '\n' || *ptr == '\r')) ptr++;
-                    break;
-                }
+            uint8_t* row = texels.data() + (size_t)y * width * texelBytes;
+            if (format == Format::RGB9E5) {
+                rgbeToRGB9E5(rgbe, reinterpret_cast<uint32_t*>(row), width);
+            } else {
+                rgbeToHalf(rgbe, reinterpret_cast<uint16_t*>(row), width);
             }
+            builder.addScanline(y, rgbe);
+        });
+        if (!ok) return false;
+        builder.finish();
+        if (previewHeight) *previewHeight = builder.height;
+        printf("[WebHDR] Parsed: %dx%d HDR image as %s (%.1f MB)\n", width, height,
+               format == Format::RGB9E5 ? "RGB9E5" : "RGBA16F", texels.size() / 1e6);
+        return true;
+    }
 
-            ptr = lineEnd;
-            while (ptr < end && (*ptr == '\n' || *ptr == '\r')) ptr++;
-            lineCount++;
-        }
-
-        // Check if we found resolution
-        if (width <= 0 || height <= 0) {
-            printf("[WebHDR] Resolution not found after %d header lines\n", lineCount);
-            return false;
+    // ── RGBE scanline conversion ──
+
+    /// RGBE texels to RGB floats
+    static void rgbeToFloat(const uint8_t* rgbe, float* out, int count) {
+        const float* scale = exponentScale();
+        for (int x = 0; x < count; x++) {
+            float s = scale[rgbe[3]];
+            out[0] = rgbe[0] * s;
+            out[1] = rgbe[1] * s;
+            out[2] = rgbe[2] * s;
+            rgbe += 4;
+            out += 3;
         }
+    }
 
-        if (width > 32768 || height > 32768) {
-            printf("[WebHDR] Invalid dimensions: %dx%d\n", width, height);
-            return false;
+    /**
+     * RGBE texels to RGB9E5. Both store a shared exponent, so this is an
+     * exponent rebias and a mantissa shift (one bit left in the common
+     * range); only texels darker than 2^-15 lose bits, and channels above
+     * 65408 saturate individually.
+     */
+    static void rgbeToRGB9E5(const uint8_t* rgbe, uint32_t* out, int count) {
+        int x = 0;
+#if defined(__wasm_simd128__)
+        // Per-lane shifts go through float: min(511, round(m * 2^k))
+        const v128_t lowByte = wasm_i32x4_splat(0xFF);
+        const v128_t half = wasm_f32x4_splat(0.5f);
+        const v128_t maxMantissa = wasm_i32x4_splat(511);
+        for (; x + 4 <= count; x += 4) {
+            v128_t px = wasm_v128_load(rgbe + x * 4);
+            v128_t e = wasm_u32x4_shr(px, 24);
+            v128_t e5 = wasm_i32x4_min(wasm_i32x4_max(wasm_i32x4_sub(e, wasm_i32x4_splat(113)),
+                                                      wasm_i32x4_splat(0)), wasm_i32x4_splat(31));
+            v128_t k = wasm_i32x4_sub(wasm_i32x4_sub(e, wasm_i32x4_splat(112)), e5);
+            v128_t scale = wasm_i32x4_shl(wasm_i32x4_add(k, wasm_i32x4_splat(127)), 23);
+            auto mantissa = [&](v128_t m) {
+                v128_t f = wasm_f32x4_convert_i32x4(wasm_v128_and(m, lowByte));
+                v128_t v = wasm_i32x4_trunc_sat_f32x4(wasm_f32x4_add(wasm_f32x4_mul(f, scale), half));
+                return wasm_i32x4_min(v, maxMantissa);
+            };
+            v128_t r = mantissa(px);
+            v128_t g = mantissa(wasm_u32x4_shr(px, 8));
+            v128_t b = mantissa(wasm_u32x4_shr(px, 16));
+            v128_t packed = wasm_v128_or(wasm_v128_or(r, wasm_i32x4_shl(g, 9)),
+                                         wasm_v128_or(wasm_i32x4_shl(b, 18), wasm_i32x4_shl(e5, 27)));
+            wasm_v128_store(out + x, packed);
         }
-
-        // Allocate output buffer (RGB floats)
-        pixels.resize(width * height * 3);
-
-        // Temporary buffer for RGBE scanline
-        std::vector<uint8_t> scanline(width * 4);
-
-        const uint8_t* dataPtr = reinterpret_cast<const uint8_t*>(ptr);
-        const uint8_t* dataEnd = reinterpret_cast<const uint8_t*>(end);
-
-        // Read scanlines
-        for (int y = 0; y < height; y++) {
-            if (dataPtr >= dataEnd) {
-                printf("[WebHDR] Unexpected end of data at scanline %d\n", y);
-                return false;
+#endif
+        for (; x < count; x++) {
+            const uint8_t* p = rgbe + x * 4;
+            int e = p[3];
+            if (e >= 113 && e <= 144) {
+                out[x] = ((uint32_t)p[0] << 1) | ((uint32_t)p[1] << 10) |
+                         ((uint32_t)p[2] << 19) | ((uint32_t)(e - 113) << 27);
+                continue;
             }
-
-            // Check for new RLE format (starts with 2, 2, width_high, width_low)
-            if (dataPtr + 4 <= dataEnd &&
-                dataPtr[0] == 2 && dataPtr[1] == 2 &&
-                ((dataPtr[2] << 8) | dataPtr[3]) == width) {
-
-                dataPtr += 4;
-
-                // Read RLE compressed scanline
-                for (int channel = 0; channel < 4; channel++) {
-                    int x = 0;
-                    while (x < width) {
-                        if (dataPtr >= dataEnd) return false;
-                        uint8_t code = *dataPtr++;
-
-                        if (code > 128) {
-                            // Run of same value
-                            int count = code - 128;
-                            if (dataPtr >= dataEnd) return false;
-                            uint8_t value = *dataPtr++;
-                            while (count-- > 0 && x < width) {
-                                scanline[x * 4 + channel] = value;
-                                x++;
-                            }
-                        } else {
-                            // Run of different values
-                            int count = code;
-                            while (count-- > 0 && x < width) {
-                                if (dataPtr >= dataEnd) return false;
-                                scanline[x * 4 + channel] = *dataPtr++;
-                                x++;
-                            }
-                        }
-                    }
-                }
-            } else {
-                // Old format or uncompressed - read raw RGBE
-                for (int x = 0; x < width; x++) {
-                    if (dataPtr + 4 > dataEnd) return false;
-                    scanline[x * 4 + 0] = *dataPtr++;
-                    scanline[x * 4 + 1] = *dataPtr++;
-                    scanline[x * 4 + 2] = *dataPtr++;
-                    scanline[x * 4 + 3] = *dataPtr++;
-                }
-            }
-
-            // Convert RGBE to float RGB
-            float* outPtr = pixels.data() + y * width * 3;
-            for (int x = 0; x < width; x++) {
-                uint8_t r = scanline[x * 4 + 0];
-                uint8_t g = scanline[x * 4 + 1];
-                uint8_t b = scanline[x * 4 + 2];
-                uint8_t e = scanline[x * 4 + 3];
-
-                if (e == 0) {
-                    outPtr[0] = outPtr[1] = outPtr[2] = 0.0f;
+            int e5 = std::max(0, std::min(31, e - 113));
+            int k = e - 112 - e5;   // Mantissa shift, 1 in the common range
+            uint32_t m[3];
+            for (int c = 0; c < 3; c++) {
+                uint32_t v = p[c];
+                if (k >= 0) {
+                    v = (v && k >= 9) ? 511u : std::min(511u, v << k);
                 } else {
-                    float scale = ldexpf(1.0f, (int)e - 128 - 8);
-                    outPtr[0] = r * scale;
-                    outPtr[1] = g * scale;
-                    outPtr[2] = b * scale;
+                    int shift = -k;
+                    v = shift < 10 ? (v + (1u << (shift - 1))) >> shift : 0;
                 }
-                outPtr += 3;
+                m[c] = v;
             }
+            out[x] = m[0] | (m[1] << 9) | (m[2] << 18) | ((uint32_t)e5 << 27);
         }
+    }
 
-        printf("[WebHDR] Parsed: %dx%d HDR image\n", width, height);
-        return true;
+    /// RGBE texels to RGBA half floats (alpha 1), clamped to 65504
+    static void rgbeToHalf(const uint8_t* rgbe, uint16_t* out, int count) {
+        int x = 0;
+#if defined(__wasm_simd128__)
+        const v128_t lowByte = wasm_i32x4_splat(0xFF);
+        const v128_t alpha = wasm_i32x4_splat(0x3C00 << 16);
+        for (; x + 4 <= count; x += 4) {
+            v128_t px = wasm_v128_load(rgbe + x * 4);
+            v128_t e = wasm_u32x4_shr(px, 24);
+            // 2^(e - 136) as float bits; exponents below 10 are under the
+            // half range anyway and flush to zero
+            v128_t scale = wasm_v128_andnot(wasm_i32x4_shl(wasm_i32x4_sub(e, wasm_i32x4_splat(9)), 23),
+                                            wasm_i32x4_lt(e, wasm_i32x4_splat(10)));
+            v128_t r = floatToHalf4(wasm_f32x4_mul(wasm_f32x4_convert_i32x4(wasm_v128_and(px, lowByte)), scale));
+            v128_t g = floatToHalf4(wasm_f32x4_mul(
+                wasm_f32x4_convert_i32x4(wasm_v128_and(wasm_u32x4_shr(px, 8), lowByte)), scale));
+            v128_t b = floatToHalf4(wasm_f32x4_mul(
+                wasm_f32x4_convert_i32x4(wasm_v128_and(wasm_u32x4_shr(px, 16), lowByte)), scale));
+            v128_t rg = wasm_v128_or(r, wasm_i32x4_shl(g, 16));
+            v128_t ba = wasm_v128_or(b, alpha);
+            wasm_v128_store(out + x * 4, wasm_i32x4_shuffle(rg, ba, 0, 4, 1, 5));
+            wasm_v128_store(out + x * 4 + 8, wasm_i32x4_shuffle(rg, ba, 2, 6, 3, 7));
+        }
+#endif
+        const float* scale = exponentScale();
+        for (; x < count; x++) {
+            const uint8_t* p = rgbe + x * 4;
+            float s = p[3] >= 10 ? scale[p[3]] : 0.0f;
+            for (int c = 0; c < 3; c++) out[x * 4 + c] = floatToHalf(p[c] * s);
+            out[x * 4 + 3] = 0x3C00;
+        }
+    }
+
+    /// Non-negative float to half, round to nearest, clamped to 65504
+    static uint16_t floatToHalf(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        if (bits >= 0x477FF000u) return 0x7BFF;
+        if (bits < (113u << 23)) {
+            // Subnormal half: let the FPU align the mantissa
+            float f = value + 0.5f;
+            memcpy(&bits, &f, sizeof(bits));
+            return (uint16_t)(bits - 0x3F000000u);
+        }
+        bits += 0xC8000FFFu + ((bits >> 13) & 1);  // Rebias 127 -> 15, round
+        return (uint16_t)(bits >> 13);
     }
 
     /**
@@ -219,15 +249,20 @@ public:
      * @param url URL to HDR file
      */
     void load(const std::string& url) {
+        cancel();
         mReady = false;
         mUrl = url;
         mPixels.clear();
+        mTexels.clear();
+        mPreview.clear();
         mWidth = mHeight = 0;
+        mPreviewWidth = mPreviewHeight = 0;
 
         printf("[WebHDR] Starting fetch: %s\n", url.c_str());
         fflush(stdout);
 
-        WebFile::loadFromURL(url, [this](const UploadedFile& file) {
+        mTicket = AssetLoader::instance().fetch(url, mPriority, [this](const UploadedFile& file) {
+            mTicket = 0;
             printf("[WebHDR] Fetch callback received: %zu bytes\n", file.data.size());
             fflush(stdout);
 
@@ -237,14 +272,35 @@ public:
                 return;
             }
 
-            if (parse(file.data.data(), file.data.size(), mPixels, mWidth, mHeight)) {
-                mReady = true;
-                printf("[WebHDR] Loaded: %s (%dx%d)\n", mUrl.c_str(), mWidth, mHeight);
-                if (mCallback) mCallback(true);
-            } else {
-                printf("[WebHDR] Failed to parse: %s\n", mUrl.c_str());
-                if (mCallback) mCallback(false);
-            }
+            // Decode off the main thread into a result the job owns
+            auto image = std::make_shared<Decoded>();
+            mJob = JobSystem::instance().submit(
+                [bytes = file.data, image, format = mFormat, previewMax = mPreviewMaxWidth] {
+                    Decoded& d = *image;
+                    return format == Format::Float32
+                        ? parse(bytes.data(), bytes.size(), d.pixels, d.width, d.height)
+                        : parsePacked(bytes.data(), bytes.size(), format, d.texels,
+                                      d.width, d.height, &d.preview, previewMax, &d.previewHeight);
+                },
+                [this, image](bool& ok) {
+                    mJob = JobFuture<bool>();
+                    if (ok) {
+                        Decoded& d = *image;
+                        mPixels = std::move(d.pixels);
+                        mTexels = std::move(d.texels);
+                        mPreview = std::move(d.preview);
+                        mWidth = d.width;
+                        mHeight = d.height;
+                        mPreviewHeight = d.previewHeight;
+                        mPreviewWidth = mPreview.empty() ? 0 : (int)(mPreview.size() / 3 / mPreviewHeight);
+                        mReady = true;
+                        printf("[WebHDR] Loaded: %s (%dx%d)\n", mUrl.c_str(), mWidth, mHeight);
+                        if (mCallback) mCallback(true);
+                    } else {
+                        printf("[WebHDR] Failed to parse: %s\n", mUrl.c_str());
+                        if (mCallback) mCallback(false);
+                    }
+                });
         });
     }
 
@@ -256,6 +312,35 @@ public:
         load(url);
     }
 
+    /**
+     * Decode target for load(). Packed formats skip the float image: the
+     * texels are meant to be uploaded and then dropped with releasePixels(),
+     * leaving the low-res preview for sampleDirection(). Set before load().
+     */
+    void setFormat(Format format) { mFormat = format; }
+    Format format() const { return mFormat; }
+
+    /// Max preview width for packed formats (0 = no preview); default 256
+    void setPreviewWidth(int width) { mPreviewMaxWidth = std::max(0, width); }
+
+    /**
+     * Scheduling priority in the AssetLoader queue (higher loads sooner,
+     * e.g. AssetLoader::distancePriority()). Applies to a queued load too.
+     */
+    void setPriority(float priority) {
+        mPriority = priority;
+        if (mTicket) AssetLoader::instance().setPriority(mTicket, priority);
+    }
+    float priority() const { return mPriority; }
+
+    /// Drop a pending load; the callback won't run
+    void cancel() {
+        if (mTicket) AssetLoader::instance().cancel(mTicket);
+        mTicket = 0;
+        mJob.cancel();
+        mJob = JobFuture<bool>();
+    }
+
     /**
      * Check if HDR is loaded and ready
      */
@@ -281,23 +366,48 @@ public:
      */
     const std::vector<float>& data() const { return mPixels; }
 
+    /// Packed texels for Format::RGBA16F / RGB9E5 (null once released)
+    const void* texels() const { return mTexels.empty() ? nullptr : mTexels.data(); }
+    size_t texelBytes() const { return mTexels.size(); }
+
+    /**
+     * Free the full-resolution pixels (float or packed) once they are on
+     * the GPU. getPixel() and sampleDirection() fall back to the preview.
+     */
+    void releasePixels() {
+        std::vector<float>().swap(mPixels);
+        std::vector<uint8_t>().swap(mTexels);
+    }
+
+    int previewWidth() const { return mPreviewWidth; }
+    int previewHeight() const { return mPreviewHeight; }
+
     /**
      * Get URL that was loaded
      */
     const std::string& url() const { return mUrl; }
 
     /**
-     * Get pixel at x, y
+     * Get pixel at x, y (full-resolution coordinates)
      */
     void getPixel(int x, int y, float& r, float& g, float& b) const {
         if (!mReady || x < 0 || x >= mWidth || y < 0 || y >= mHeight) {
             r = g = b = 0;
             return;
         }
-        int idx = (y * mWidth + x) * 3;
-        r = mPixels[idx];
-        g = mPixels[idx + 1];
-        b = mPixels[idx + 2];
+        size_t i = (size_t)y * mWidth + x;
+        if (!mPixels.empty()) {
+            r = mPixels[i * 3];
+            g = mPixels[i * 3 + 1];
+            b = mPixels[i * 3 + 2];
+        } else if (!mTexels.empty()) {
+            unpackTexel(i, r, g, b);
+        } else if (!mPreview.empty()) {
+            previewTexel((int)((int64_t)x * mPreviewWidth / mWidth),
+                         (int)((int64_t)y * mPreviewHeight / mHeight), r, g, b);
+        } else {
+            r = g = b = 0;
+        }
     }
 
     /**
@@ -319,9 +429,16 @@ public:
         float u = (phi + M_PI) / (2.0f * M_PI);  // 0 to 1
         float v = theta / M_PI;                   // 0 to 1
 
-        // Sample texture (bilinear)
-        float fx = u * mWidth - 0.5f;
-        float fy = v * mHeight - 0.5f;
+        // Sample texture (bilinear), from the prefiltered preview if any
+        bool usePreview = !mPreview.empty();
+        int w = usePreview ? mPreviewWidth : mWidth;
+        int h = usePreview ? mPreviewHeight : mHeight;
+        auto fetch = [&](int px, int py, float& cr, float& cg, float& cb) {
+            if (usePreview) previewTexel(px, py, cr, cg, cb);
+            else getPixel(px, py, cr, cg, cb);
+        };
+        float fx = u * w - 0.5f;
+        float fy = v * h - 0.5f;
 
         int x0 = (int)floorf(fx);
         int y0 = (int)floorf(fy);
@@ -332,17 +449,17 @@ public:
         float wy = fy - y0;
 
         // Wrap coordinates
-        x0 = ((x0 % mWidth) + mWidth) % mWidth;
-        x1 = ((x1 % mWidth) + mWidth) % mWidth;
-        y0 = std::max(0, std::min(mHeight - 1, y0));
-        y1 = std::max(0, std::min(mHeight - 1, y1));
+        x0 = ((x0 % w) + w) % w;
+        x1 = ((x1 % w) + w) % w;
+        y0 = std::max(0, std::min(h - 1, y0));
+        y1 = std::max(0, std::min(h - 1, y1));
 
         // Sample 4 pixels
         float r00, g00, b00, r01, g01, b01, r10, g10, b10, r11, g11, b11;
-        getPixel(x0, y0, r00, g00, b00);
-        getPixel(x1, y0, r10, g10, b10);
-        getPixel(x0, y1, r01, g01, b01);
-        getPixel(x1, y1, r11, g11, b11);
+        fetch(x0, y0, r00, g00, b00);
+        fetch(x1, y0, r10, g10, b10);
+        fetch(x0, y1, r01, g01, b01);
+        fetch(x1, y1, r11, g11, b11);
 
         // Bilinear interpolation
         r = (r00 * (1-wx) + r10 * wx) * (1-wy) + (r01 * (1-wx) + r11 * wx) * wy;
@@ -357,14 +474,23 @@ public:
      * @return Vector of RGBA uint8 data suitable for standard texture
      */
     std::vector<uint8_t> toRGBA(float exposure = 1.0f, float gamma = 2.2f) const {
+        if (mPixels.empty() && mTexels.empty()) return {};  // Released
         std::vector<uint8_t> result(mWidth * mHeight * 4);
         float invGamma = 1.0f / gamma;
 
         for (int i = 0; i < mWidth * mHeight; i++) {
             // Apply exposure
-            float r = mPixels[i * 3 + 0] * exposure;
-            float g = mPixels[i * 3 + 1] * exposure;
-            float b = mPixels[i * 3 + 2] * exposure;
+            float r, g, b;
+            if (!mPixels.empty()) {
+                r = mPixels[i * 3 + 0];
+                g = mPixels[i * 3 + 1];
+                b = mPixels[i * 3 + 2];
+            } else {
+                unpackTexel(i, r, g, b);
+            }
+            r *= exposure;
+            g *= exposure;
+            b *= exposure;
 
             // Reinhard tone mapping
             r = r / (1.0f + r);
@@ -387,12 +513,279 @@ public:
     }
 
 private:
+    /**
+     * Header and RLE decoding shared by parse() and parsePacked(): calls
+     * onScanline(y, rgbe) with each decoded row of width * 4 RGBE bytes
+     */
+    template <typename OnScanline>
+    static bool readScanlines(const uint8_t* data, size_t size, int& width, int& height,
+                              OnScanline&& onScanline) {
+        if (size < 10) return false;
+
+        const char* ptr = reinterpret_cast<const char*>(data);
+        const char* end = ptr + size;
+
+        printf("[WebHDR] Parsing %zu bytes\n", size);
+
+        // Check magic number
+        if (strncmp(ptr, "#?RADIANCE", 10) != 0 && strncmp(ptr, "#?RGBE", 6) != 0) {
+            // Try to continue anyway - some files don't have the magic
+            printf("[WebHDR] Warning: Missing HDR magic number, first bytes: %02x %02x %02x %02x\n",
+                   (unsigned char)ptr[0], (unsigned char)ptr[1], (unsigned char)ptr[2], (unsigned char)ptr[3]);
+        } else {
+            printf("[WebHDR] Magic number found\n");
+        }
+
+        // Skip header lines until empty line
+        int lineCount = 0;
+        while (ptr < end && lineCount < 50) {  // Safety limit
+            // Find end of line
+            const char* lineEnd = ptr;
+            while (lineEnd < end && *lineEnd != '\n' && *lineEnd != '\r') lineEnd++;
+
+            size_t lineLen = lineEnd - ptr;
+
+            // Debug: print first few header lines
+            if (lineCount < 10) {
+                std::string line(ptr, std::min(lineLen, (size_t)60));
+                printf("[WebHDR] Header line %d: '%s'\n", lineCount, line.c_str());
+            }
+
+            // Check if empty line (end of header)
+            if (lineLen == 0) {
+                printf("[WebHDR] Found empty line at line %d, header ends\n", lineCount);
+                ptr = lineEnd;
+                while (ptr < end && (*ptr == '\n' || *ptr == '\r')) ptr++;
+                break;
+            }
+
+            // Check if this is the resolution line (contains -Y or +Y)
+            std::string line(ptr, lineLen);
+            if (line.find("-Y") != std::string::npos || line.find("+Y") != std::string::npos ||
+                line.find("-X") != std::string::npos || line.find("+X") != std::string::npos) {
+                printf("[WebHDR] Found resolution line at line %d: '%s'\n", lineCount, line.c_str());
+                // Parse it
+                if (sscanf(line.c_str(), "-Y %d +X %d", &height, &width) == 2 ||
+                    sscanf(line.c_str(), "+Y %d +X %d", &height, &width) == 2 ||
+                    sscanf(line.c_str(), "-X %d -Y %d", &width, &height) == 2 ||
+                    sscanf(line.c_str(), "+X %d -Y %d", &width, &height) == 2 ||
+                    sscanf(line.c_str(), "+X %d +Y %d", &width, &height) == 2) {
+                    printf("[WebHDR] Parsed resolution: %dx%d\n", width, height);
+                    ptr = lineEnd;
+                    while (ptr < end && (*ptr == '\n' || *ptr == '\r')) ptr++;
+                    break;
+                }
+            }
+
+            ptr = lineEnd;
+            while (ptr < end && (*ptr == '\n' || *ptr == '\r')) ptr++;
+            lineCount++;
+        }
+
+        // Check if we found resolution
+        if (width <= 0 || height <= 0) {
+            printf("[WebHDR] Resolution not found after %d header lines\n", lineCount);
+            return false;
+        }
+
+        if (width > 32768 || height > 32768) {
+            printf("[WebHDR] Invalid dimensions: %dx%d\n", width, height);
+            return false;
+        }
+
+        // Temporary buffer for RGBE scanline
+        std::vector<uint8_t> scanline(width * 4);
+
+        const uint8_t* dataPtr = reinterpret_cast<const uint8_t*>(ptr);
+        const uint8_t* dataEnd = reinterpret_cast<const uint8_t*>(end);
+
+        // Read scanlines
+        for (int y = 0; y < height; y++) {
+            if (dataPtr >= dataEnd) {
+                printf("[WebHDR] Unexpected end of data at scanline %d\n", y);
+                return false;
+            }
+
+            // Check for new RLE format (starts with 2, 2, width_high, width_low)
+            if (dataPtr + 4 <= dataEnd &&
+                dataPtr[0] == 2 && dataPtr[1] == 2 &&
+                ((dataPtr[2] << 8) | dataPtr[3]) == width) {
+
+                dataPtr += 4;
+
+                // Read RLE compressed scanline
+                for (int channel = 0; channel < 4; channel++) {
+                    int x = 0;
+                    while (x < width) {
+                        if (dataPtr >= dataEnd) return false;
+                        uint8_t code = *dataPtr++;
+
+                        if (code > 128) {
+                            // Run of same value
+                            int count = code - 128;
+                            if (dataPtr >= dataEnd) return false;
+                            uint8_t value = *dataPtr++;
+                            while (count-- > 0 && x < width) {
+                                scanline[x * 4 + channel] = value;
+                                x++;
+                            }
+                        } else {
+                            // Run of different values
+                            int count = code;
+                            while (count-- > 0 && x < width) {
+                                if (dataPtr >= dataEnd) return false;
+                                scanline[x * 4 + channel] = *dataPtr++;
+                                x++;
+                            }
+                        }
+                    }
+                }
+            } else {
+                // Old format or uncompressed - read raw RGBE
+                for (int x = 0; x < width; x++) {
+                    if (dataPtr + 4 > dataEnd) return false;
+                    scanline[x * 4 + 0] = *dataPtr++;
+                    scanline[x * 4 + 1] = *dataPtr++;
+                    scanline[x * 4 + 2] = *dataPtr++;
+                    scanline[x * 4 + 3] = *dataPtr++;
+                }
+            }
+
+            onScanline(y, scanline.data());
+        }
+        return true;
+    }
+
+    /// 2^(e - 136) for each RGBE exponent byte (0 maps to black)
+    static const float* exponentScale() {
+        static const float* table = [] {
+            static float t[256];
+            t[0] = 0.0f;
+            for (int e = 1; e < 256; e++) t[e] = ldexpf(1.0f, e - 128 - 8);
+            return t;
+        }();
+        return table;
+    }
+
+#if defined(__wasm_simd128__)
+    /// floatToHalf() on four lanes; result in the low 16 bits of each
+    static v128_t floatToHalf4(v128_t value) {
+        v128_t normal = wasm_u32x4_shr(
+            wasm_i32x4_add(wasm_i32x4_add(value, wasm_i32x4_splat((int32_t)0xC8000FFFu)),
+                           wasm_v128_and(wasm_u32x4_shr(value, 13), wasm_i32x4_splat(1))), 13);
+        v128_t subnormal = wasm_i32x4_sub(wasm_f32x4_add(value, wasm_f32x4_splat(0.5f)),
+                                          wasm_i32x4_splat(0x3F000000));
+        v128_t h = wasm_v128_bitselect(subnormal, normal,
+                                       wasm_i32x4_lt(value, wasm_i32x4_splat(113 << 23)));
+        h = wasm_v128_bitselect(wasm_i32x4_splat(0x7BFF), h,
+                                wasm_i32x4_ge(value, wasm_i32x4_splat(0x477FF000)));
+        return wasm_v128_and(h, wasm_i32x4_splat(0xFFFF));
+    }
+#endif
+
+    static float halfToFloat(uint16_t h) {
+        int e = (h >> 10) & 0x1F, m = h & 0x3FF;
+        if (e == 0) return ldexpf((float)m, -24);
+        return ldexpf((float)(m | 0x400), e - 25);
+    }
+
+    /// Decode texel i of mTexels
+    void unpackTexel(size_t i, float& r, float& g, float& b) const {
+        if (mFormat == Format::RGB9E5) {
+            uint32_t t;
+            memcpy(&t, mTexels.data() + i * 4, sizeof(t));
+            float s = ldexpf(1.0f, (int)(t >> 27) - 24);
+            r = (t & 0x1FF) * s;
+            g = ((t >> 9) & 0x1FF) * s;
+            b = ((t >> 18) & 0x1FF) * s;
+        } else {
+            uint16_t h[3];
+            memcpy(h, mTexels.data() + i * 8, sizeof(h));
+            r = halfToFloat(h[0]);
+            g = halfToFloat(h[1]);
+            b = halfToFloat(h[2]);
+        }
+    }
+
+    void previewTexel(int x, int y, float& r, float& g, float& b) const {
+        const float* p = mPreview.data() + ((size_t)y * mPreviewWidth + x) * 3;
+        r = p[0];
+        g = p[1];
+        b = p[2];
+    }
+
+    /// Box-filters RGBE scanlines into a small RGB float image
+    struct PreviewBuilder {
+        std::vector<float>* out = nullptr;
+        std::vector<float> row;   // Sums for the block row being filled
+        int factor = 1, width = 0, height = 0, srcWidth = 0, srcHeight = 0;
+
+        void begin(int w, int h, int maxWidth, std::vector<float>& dst) {
+            factor = std::max(1, (w + maxWidth - 1) / maxWidth);
+            srcWidth = w;
+            srcHeight = h;
+            width = (w + factor - 1) / factor;
+            height = (h + factor - 1) / factor;
+            out = &dst;
+            out->assign((size_t)width * height * 3, 0.0f);
+            row.assign((size_t)width * 3, 0.0f);
+        }
+
+        void addScanline(int y, const uint8_t* rgbe) {
+            if (!out) return;
+            const float* scale = exponentScale();
+            for (int x = 0; x < srcWidth; x++) {
+                const uint8_t* p = rgbe + x * 4;
+                float s = scale[p[3]];
+                float* sum = row.data() + (x / factor) * 3;
+                sum[0] += p[0] * s;
+                sum[1] += p[1] * s;
+                sum[2] += p[2] * s;
+            }
+            if (y % factor == factor - 1 || y == srcHeight - 1) {
+                int py = y / factor;
+                int rows = y - py * factor + 1;
+                for (int px = 0; px < width; px++) {
+                    int cols = std::min(factor, srcWidth - px * factor);
+                    float inv = 1.0f / (float)(rows * cols);
+                    for (int c = 0; c < 3; c++) {
+                        (*out)[((size_t)py * width + px) * 3 + c] = row[px * 3 + c] * inv;
+                    }
+                }
+                std::fill(row.begin(), row.end(), 0.0f);
+            }
+        }
+
+        void finish() {
+            if (!out) height = 0;
+        }
+    };
+
     std::string mUrl;
     std::vector<float> mPixels;
+    std::vector<uint8_t> mTexels;    // Packed RGBA16F / RGB9E5 staging
+    std::vector<float> mPreview;     // Low-res RGB float for CPU sampling
     int mWidth;
     int mHeight;
+    int mPreviewWidth = 0;
+    int mPreviewHeight = 0;
+    int mPreviewMaxWidth = 256;
+    Format mFormat = Format::Float32;
     bool mReady;
     LoadCallback mCallback;
+    float mPriority = 0.0f;
+    AssetLoader::Ticket mTicket = 0;
+
+    // load()'s decode result, filled on the job pool
+    struct Decoded {
+        std::vector<float> pixels;
+        std::vector<uint8_t> texels;
+        std::vector<float> preview;
+        int width = 0;
+        int height = 0;
+        int previewHeight = 0;
+    };
+    JobFuture<bool> mJob;
 };
 
 } // namespace al
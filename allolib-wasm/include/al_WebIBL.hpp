@@ -0,0 +1,675 @@
+/**
+ * Web IBL Baker - GPU precomputation of image-based lighting maps
+ *
+ * Renders the split-sum IBL inputs WebPBR samples, on WebGL2, with one
+ * fullscreen pass per target (render-to-texture):
+ * - a roughness-prefiltered specular mip chain (GGX importance sampling,
+ *   level 0 = the environment, roughness rising linearly per level)
+ * - a diffuse irradiance map (cosine convolution)
+ * - the BRDF integration LUT (scale/bias on F0, indexed by NdotV and
+ *   roughness)
+ * The maps are equirectangular, matching directionToUV() in the PBR
+ * shaders, except that cubemap() and prefilterCube() render the
+ * environment and specular chain into cube faces instead: a cube lookup
+ * skips the per-fragment atan/acos and its mips are not stretched at the
+ * poles. The convolutions use filtered importance sampling: each sample
+ * reads a mip of a downsampled copy of the environment (Source) sized to
+ * the sample's solid angle, so 64-128 samples come out noise-free.
+ *
+ * Usage (WebPBR does this through GPUResourceCache):
+ *   IBLBaker::Source source(envTexture, envWidth, envHeight);
+ *   GPUTexture specular, specularCube, irradiance, brdf;
+ *   IBLBaker::prefilter(source, specular);
+ *   IBLBaker::irradiance(source, irradiance);
+ *   IBLBaker::brdfLUT(brdf);
+ *   IBLBaker::prefilterCube(source, specularCube);  // samplerCube variant
+ *
+ * Needs RGBA16F render targets (EXT_color_buffer_float or
+ * EXT_color_buffer_half_float); check supported() and fall back to CPU
+ * convolution without them. WebGPU bakes the same maps with compute
+ * shaders (WebGPUBackend::bakeIBL*).
+ *
+ * SHIrradiance is the cheap alternative to the irradiance map: an L2
+ * spherical-harmonics projection of the environment, evaluated from nine
+ * uniforms instead of a texture fetch (WebPBR::diffuseMode()).
+ */
+
+#ifndef AL_WEB_IBL_HPP
+#define AL_WEB_IBL_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include "al/graphics/al_OpenGL.hpp"
+#include "al/graphics/al_WebGL2Extensions.hpp"
+#include "al_WebHDR.hpp"
+#include "al_WebResourceCache.hpp"
+
+namespace al {
+
+class IBLBaker {
+public:
+    // Target sizes (the environment may make the prefiltered map smaller)
+    static constexpr int kPrefilterWidth = 512;
+    static constexpr int kPrefilterHeight = 256;
+    static constexpr int kPrefilterLevels = 6;   // Roughness 0, 0.2, ... 1
+    static constexpr int kIrradianceWidth = 64;
+    static constexpr int kIrradianceHeight = 32;
+    static constexpr int kBrdfSize = 256;
+    static constexpr int kPrefilterCubeSize = 128;  // Per face
+    static constexpr int kCubeMinSize = 64;
+    static constexpr int kCubeMaxSize = 1024;
+
+    /// True if RGBA16F can be rendered to
+    static bool supported() {
+        const WebGL2Capabilities& caps = WebGL2Extensions::capabilities();
+        return caps.floatTexturesRenderable || caps.halfFloatRenderable;
+    }
+
+    /**
+     * Mipmapped RGBA16F copy of an environment (at most 1024 wide), built
+     * on first use and deleted with the Source
+     */
+    class Source {
+    public:
+        Source(GLuint env, int width, int height)
+            : mEnv(env), mEnvWidth(width), mEnvHeight(height) {}
+        ~Source() {
+            if (mTexture) glDeleteTextures(1, &mTexture);
+        }
+        Source(const Source&) = delete;
+        Source& operator=(const Source&) = delete;
+
+        bool ensure() {
+            if (mTexture || mFailed) return mTexture != 0;
+            mFailed = true;
+            if (!mEnv || mEnvWidth <= 0 || mEnvHeight <= 0 || !supported()) return false;
+
+            float scale = std::min(1.0f, 1024.0f / mEnvWidth);
+            mWidth = std::max(1, (int)(mEnvWidth * scale));
+            mHeight = std::max(1, (int)(mEnvHeight * scale));
+            mLevels = levelsFor(mWidth, mHeight);
+            Pass pass;
+            if (!pass.begin(kCopyFrag)) return false;
+            mTexture = createTarget(mWidth, mHeight, mLevels, GL_RGBA16F);
+            pass.bindSource(mEnv);
+            pass.uniform("srcMaxLod", 0.0f);
+            pass.draw(mTexture, 0, mWidth, mHeight);
+            glBindTexture(GL_TEXTURE_2D, mTexture);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            mFailed = false;
+            return true;
+        }
+
+        GLuint texture() const { return mTexture; }
+        int width() const { return mWidth; }
+        int height() const { return mHeight; }
+        int levels() const { return mLevels; }
+        /// Average solid angle of a level-0 texel
+        float texelSolidAngle() const { return 4.0f * (float)M_PI / ((float)mWidth * mHeight); }
+
+    private:
+        GLuint mEnv;
+        int mEnvWidth, mEnvHeight;
+        GLuint mTexture = 0;
+        int mWidth = 0, mHeight = 0, mLevels = 0;
+        bool mFailed = false;
+    };
+
+    /// Specular chain: kPrefilterLevels levels, roughness = level / (levels - 1)
+    static bool prefilter(Source& source, GPUTexture& t) {
+        if (!source.ensure()) return false;
+        int width = std::min(kPrefilterWidth, source.width());
+        int height = std::min(kPrefilterHeight, source.height());
+        int levels = std::min(kPrefilterLevels, levelsFor(width, height));
+
+        Pass pass;
+        if (!pass.begin(kPrefilterFrag)) return false;
+        t.id = createTarget(width, height, levels, GL_RGBA16F);
+        pass.bindSource(source.texture());
+        pass.uniform("srcMaxLod", (float)(source.levels() - 1));
+        pass.uniform("texelSolidAngle", source.texelSolidAngle());
+        for (int level = 0; level < levels; level++) {
+            pass.uniform("roughness", levels > 1 ? (float)level / (levels - 1) : 0.0f);
+            pass.draw(t.id, level, std::max(1, width >> level), std::max(1, height >> level));
+        }
+        t.width = width;
+        t.height = height;
+        t.levels = levels;
+        t.bytes = (size_t)width * height * 8 * 4 / 3;
+        printf("[IBLBaker] Prefiltered specular %dx%d, %d levels\n", width, height, levels);
+        return true;
+    }
+
+    /// Specular chain in a cubemap, same roughness steps as prefilter()
+    static bool prefilterCube(Source& source, GPUTexture& t) {
+        if (!source.ensure()) return false;
+        int size = std::min(kPrefilterCubeSize, source.height());
+        int levels = std::min(kPrefilterLevels, levelsFor(size, size));
+
+        Pass pass;
+        if (!pass.begin(kPrefilterFrag, true)) return false;
+        t.id = createCubeTarget(size, levels);
+        pass.bindSource(source.texture());
+        pass.uniform("srcMaxLod", (float)(source.levels() - 1));
+        pass.uniform("texelSolidAngle", source.texelSolidAngle());
+        for (int level = 0; level < levels; level++) {
+            pass.uniform("roughness", levels > 1 ? (float)level / (levels - 1) : 0.0f);
+            for (int face = 0; face < 6; face++) {
+                pass.drawFace(t.id, face, level, std::max(1, size >> level));
+            }
+        }
+        t.width = t.height = size;
+        t.levels = levels;
+        t.cube = true;
+        t.bytes = (size_t)size * size * 6 * 8 * 4 / 3;
+        printf("[IBLBaker] Prefiltered specular cube %d, %d levels\n", size, levels);
+        return true;
+    }
+
+    /// Cube face size for an equirect width (power of two, clamped)
+    static int cubeFaceSize(int envWidth) {
+        int size = 1 << (int)std::floor(std::log2((float)std::max(1, envWidth / 4)));
+        return std::max(kCubeMinSize, std::min(kCubeMaxSize, size));
+    }
+
+    /**
+     * The environment as a mipmapped RGBA16F cubemap, faces about a
+     * quarter of the equirect width (the equator's texel density), for
+     * skyboxes and mirror reflections
+     */
+    static bool cubemap(GLuint env, int envWidth, int envHeight, GPUTexture& t) {
+        if (!env || envWidth <= 0 || envHeight <= 0 || !supported()) return false;
+        int size = cubeFaceSize(envWidth);
+        int levels = levelsFor(size, size);
+
+        Pass pass;
+        if (!pass.begin(kCubeFrag, true)) return false;
+        t.id = createCubeTarget(size, levels);
+        pass.bindSource(env);
+        for (int face = 0; face < 6; face++) pass.drawFace(t.id, face, 0, size);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, t.id);
+        glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+        t.width = t.height = size;
+        t.levels = levels;
+        t.cube = true;
+        t.bytes = (size_t)size * size * 6 * 8 * 4 / 3;
+        printf("[IBLBaker] Environment cube %d from %dx%d\n", size, envWidth, envHeight);
+        return true;
+    }
+
+    /// Diffuse irradiance, scaled like WebPBR's CPU convolution (pi * mean radiance)
+    static bool irradiance(Source& source, GPUTexture& t) {
+        if (!source.ensure()) return false;
+        Pass pass;
+        if (!pass.begin(kIrradianceFrag)) return false;
+        t.id = createTarget(kIrradianceWidth, kIrradianceHeight, 1, GL_RGBA16F);
+        pass.bindSource(source.texture());
+        pass.uniform("srcMaxLod", (float)(source.levels() - 1));
+        pass.uniform("texelSolidAngle", source.texelSolidAngle());
+        pass.draw(t.id, 0, kIrradianceWidth, kIrradianceHeight);
+        t.width = kIrradianceWidth;
+        t.height = kIrradianceHeight;
+        t.bytes = (size_t)t.width * t.height * 8;
+        printf("[IBLBaker] Irradiance %dx%d\n", t.width, t.height);
+        return true;
+    }
+
+    /// Split-sum BRDF LUT (RG16F): x = NdotV, y = roughness
+    static bool brdfLUT(GPUTexture& t) {
+        if (!supported()) return false;
+        Pass pass;
+        if (!pass.begin(kBrdfFrag)) return false;
+        t.id = createTarget(kBrdfSize, kBrdfSize, 1, GL_RG16F);
+        pass.draw(t.id, 0, kBrdfSize, kBrdfSize);
+        t.width = t.height = kBrdfSize;
+        t.bytes = (size_t)kBrdfSize * kBrdfSize * 4;
+        printf("[IBLBaker] BRDF LUT %dx%d\n", kBrdfSize, kBrdfSize);
+        return true;
+    }
+
+private:
+    static int levelsFor(int width, int height) {
+        return (int)std::floor(std::log2((float)std::max(width, height))) + 1;
+    }
+
+    /// Immutable texture, equirect wrapping (repeat around, clamp at the poles)
+    static GLuint createTarget(int width, int height, int levels, GLenum format) {
+        GLuint tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexStorage2D(GL_TEXTURE_2D, levels, format, width, height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, format == GL_RG16F ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                        levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return tex;
+    }
+
+    static GLuint createCubeTarget(int size, int levels) {
+        GLuint tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, tex);
+        glTexStorage2D(GL_TEXTURE_CUBE_MAP, levels, GL_RGBA16F, size, size);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER,
+                        levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, levels - 1);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+        return tex;
+    }
+
+    /**
+     * One fullscreen program rendering into texture levels. Saves the GL
+     * state it touches and restores it when done.
+     */
+    class Pass {
+    public:
+        Pass() {
+            glGetIntegerv(GL_FRAMEBUFFER_BINDING, &mFramebuffer);
+            glGetIntegerv(GL_VIEWPORT, mViewport);
+            glGetIntegerv(GL_CURRENT_PROGRAM, &mProgramBinding);
+            glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &mVao);
+            glGetIntegerv(GL_ACTIVE_TEXTURE, &mActiveTexture);
+            mDepthTest = glIsEnabled(GL_DEPTH_TEST);
+            mBlend = glIsEnabled(GL_BLEND);
+            mCull = glIsEnabled(GL_CULL_FACE);
+            mScissor = glIsEnabled(GL_SCISSOR_TEST);
+            glDisable(GL_DEPTH_TEST);
+            glDisable(GL_BLEND);
+            glDisable(GL_CULL_FACE);
+            glDisable(GL_SCISSOR_TEST);
+            glActiveTexture(GL_TEXTURE0);
+            glGetIntegerv(GL_TEXTURE_BINDING_2D, &mTexture);
+
+            glGenFramebuffers(1, &mFbo);
+            glGenVertexArrays(1, &mEmptyVao);  // Fullscreen triangle from gl_VertexID
+        }
+
+        ~Pass() {
+            if (mProgram) glDeleteProgram(mProgram);
+            glDeleteVertexArrays(1, &mEmptyVao);
+            glDeleteFramebuffers(1, &mFbo);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+            glViewport(mViewport[0], mViewport[1], mViewport[2], mViewport[3]);
+            glUseProgram(mProgramBinding);
+            glBindVertexArray(mVao);
+            glBindTexture(GL_TEXTURE_2D, mTexture);
+            glActiveTexture(mActiveTexture);
+            if (mDepthTest) glEnable(GL_DEPTH_TEST);
+            if (mBlend) glEnable(GL_BLEND);
+            if (mCull) glEnable(GL_CULL_FACE);
+            if (mScissor) glEnable(GL_SCISSOR_TEST);
+        }
+
+        Pass(const Pass&) = delete;
+        Pass& operator=(const Pass&) = delete;
+
+        /// cubeTarget: render with drawFace(); targetDirection() follows the face
+        bool begin(const char* fragBody, bool cubeTarget = false) {
+            std::string common = kCommonFrag;
+            if (cubeTarget) common.insert(common.find('\n') + 1, "#define CUBE_TARGET\n");
+            std::string frag = common + fragBody;
+            GLuint vs = compile(GL_VERTEX_SHADER, kFullscreenVert);
+            GLuint fs = compile(GL_FRAGMENT_SHADER, frag.c_str());
+            if (vs && fs) {
+                mProgram = glCreateProgram();
+                glAttachShader(mProgram, vs);
+                glAttachShader(mProgram, fs);
+                glLinkProgram(mProgram);
+                GLint ok = 0;
+                glGetProgramiv(mProgram, GL_LINK_STATUS, &ok);
+                if (!ok) {
+                    char log[512];
+                    glGetProgramInfoLog(mProgram, sizeof(log), nullptr, log);
+                    printf("[IBLBaker] Program link error: %s\n", log);
+                    glDeleteProgram(mProgram);
+                    mProgram = 0;
+                }
+            }
+            if (vs) glDeleteShader(vs);
+            if (fs) glDeleteShader(fs);
+            if (!mProgram) return false;
+
+            glUseProgram(mProgram);
+            glUniform1i(glGetUniformLocation(mProgram, "src"), 0);
+            glBindVertexArray(mEmptyVao);
+            return true;
+        }
+
+        void bindSource(GLuint tex) { glBindTexture(GL_TEXTURE_2D, tex); }
+
+        void uniform(const char* name, float v) {
+            glUniform1f(glGetUniformLocation(mProgram, name), v);
+        }
+
+        void draw(GLuint target, int level, int width, int height) {
+            glBindFramebuffer(GL_FRAMEBUFFER, mFbo);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, level);
+            glViewport(0, 0, width, height);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+
+        /// One face (GL order +X -X +Y -Y +Z -Z) of a cube target level
+        void drawFace(GLuint target, int face, int level, int size) {
+            glUniform1i(glGetUniformLocation(mProgram, "face"), face);
+            glBindFramebuffer(GL_FRAMEBUFFER, mFbo);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                   GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, target, level);
+            glViewport(0, 0, size, size);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+
+    private:
+        static GLuint compile(GLenum type, const char* source) {
+            GLuint shader = glCreateShader(type);
+            glShaderSource(shader, 1, &source, nullptr);
+            glCompileShader(shader);
+            GLint ok = 0;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+            if (!ok) {
+                char log[512];
+                glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+                printf("[IBLBaker] Shader compile error: %s\n", log);
+                glDeleteShader(shader);
+                return 0;
+            }
+            return shader;
+        }
+
+        GLuint mProgram = 0;
+        GLuint mFbo = 0;
+        GLuint mEmptyVao = 0;
+        GLint mFramebuffer = 0, mProgramBinding = 0, mVao = 0, mActiveTexture = 0, mTexture = 0;
+        GLint mViewport[4] = {0, 0, 0, 0};
+        GLboolean mDepthTest, mBlend, mCull, mScissor;
+    };
+
+    // ── Shaders ──
+
+    static constexpr const char* kFullscreenVert = R"(#version 300 es
+out vec2 vUV;
+void main() {
+    vec2 p = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    vUV = p;
+    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+    static constexpr const char* kCommonFrag = R"(#version 300 es
+precision highp float;
+in vec2 vUV;
+out vec4 fragColor;
+
+uniform sampler2D src;
+uniform float srcMaxLod;
+uniform float texelSolidAngle;
+uniform float roughness;
+
+const float PI = 3.14159265359;
+
+vec2 directionToUV(vec3 dir) {
+    float phi = atan(dir.z, dir.x);
+    float theta = acos(clamp(dir.y, -1.0, 1.0));
+    return vec2((phi + PI) / (2.0 * PI), theta / PI);
+}
+
+vec3 uvToDirection(vec2 uv) {
+    float phi = uv.x * 2.0 * PI - PI;
+    float theta = uv.y * PI;
+    return vec3(sin(theta) * cos(phi), cos(theta), sin(theta) * sin(phi));
+}
+
+#ifdef CUBE_TARGET
+uniform int face;
+
+// Direction through a face texel, per the GL cube face orientation
+vec3 targetDirection(vec2 uv) {
+    vec2 st = uv * 2.0 - 1.0;
+    vec3 dir;
+    if (face == 0)      dir = vec3(1.0, -st.y, -st.x);
+    else if (face == 1) dir = vec3(-1.0, -st.y, st.x);
+    else if (face == 2) dir = vec3(st.x, 1.0, st.y);
+    else if (face == 3) dir = vec3(st.x, -1.0, -st.y);
+    else if (face == 4) dir = vec3(st.x, -st.y, 1.0);
+    else                dir = vec3(-st.x, -st.y, -1.0);
+    return normalize(dir);
+}
+#else
+vec3 targetDirection(vec2 uv) { return uvToDirection(uv); }
+#endif
+
+vec2 hammersley(uint i, uint n) {
+    uint b = (i << 16u) | (i >> 16u);
+    b = ((b & 0x55555555u) << 1u) | ((b & 0xAAAAAAAAu) >> 1u);
+    b = ((b & 0x33333333u) << 2u) | ((b & 0xCCCCCCCCu) >> 2u);
+    b = ((b & 0x0F0F0F0Fu) << 4u) | ((b & 0xF0F0F0F0u) >> 4u);
+    b = ((b & 0x00FF00FFu) << 8u) | ((b & 0xFF00FF00u) >> 8u);
+    return vec2(float(i) / float(n), float(b) * 2.3283064365386963e-10);
+}
+
+// Source mip whose texels cover the solid angle one sample stands for
+float sampleLod(float pdf, uint count) {
+    float sampleSolidAngle = 1.0 / (float(count) * pdf + 1e-4);
+    return clamp(0.5 * log2(sampleSolidAngle / texelSolidAngle) + 1.0, 0.0, srcMaxLod);
+}
+
+mat3 tangentFrame(vec3 N) {
+    vec3 up = abs(N.y) < 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+    vec3 T = normalize(cross(up, N));
+    return mat3(T, cross(N, T), N);
+}
+)";
+
+    static constexpr const char* kCopyFrag = R"(
+void main() {
+    fragColor = vec4(textureLod(src, vUV, 0.0).rgb, 1.0);
+}
+)";
+
+    static constexpr const char* kCubeFrag = R"(
+void main() {
+    fragColor = vec4(textureLod(src, directionToUV(targetDirection(vUV)), 0.0).rgb, 1.0);
+}
+)";
+
+    static constexpr const char* kPrefilterFrag = R"(
+const uint SAMPLES = 64u;
+void main() {
+    vec3 N = targetDirection(vUV);
+    if (roughness <= 0.0) {
+        fragColor = vec4(textureLod(src, directionToUV(N), 0.0).rgb, 1.0);
+        return;
+    }
+    mat3 frame = tangentFrame(N);
+    float a = roughness * roughness;
+    float a2 = a * a;
+    vec3 sum = vec3(0.0);
+    float weight = 0.0;
+    for (uint i = 0u; i < SAMPLES; i++) {
+        vec2 xi = hammersley(i, SAMPLES);
+        float phi = 2.0 * PI * xi.x;
+        float cosTheta = sqrt((1.0 - xi.y) / (1.0 + (a2 - 1.0) * xi.y));
+        float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+        vec3 H = frame * vec3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+        vec3 L = 2.0 * dot(N, H) * H - N;   // V = N
+        float NdotL = dot(N, L);
+        if (NdotL > 0.0) {
+            float d = cosTheta * cosTheta * (a2 - 1.0) + 1.0;
+            float D = a2 / (PI * d * d);
+            float pdf = D * 0.25;            // D * NdotH / (4 * VdotH), V = N
+            sum += textureLod(src, directionToUV(L), sampleLod(pdf, SAMPLES)).rgb * NdotL;
+            weight += NdotL;
+        }
+    }
+    fragColor = vec4(sum / max(weight, 1e-4), 1.0);
+}
+)";
+
+    static constexpr const char* kIrradianceFrag = R"(
+const uint SAMPLES = 128u;
+void main() {
+    vec3 N = targetDirection(vUV);
+    mat3 frame = tangentFrame(N);
+    vec3 sum = vec3(0.0);
+    for (uint i = 0u; i < SAMPLES; i++) {
+        vec2 xi = hammersley(i, SAMPLES);
+        float phi = 2.0 * PI * xi.x;
+        float cosTheta = sqrt(1.0 - xi.y);   // Cosine-weighted
+        float sinTheta = sqrt(xi.y);
+        vec3 L = frame * vec3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+        float pdf = max(cosTheta, 1e-3) / PI;
+        sum += textureLod(src, directionToUV(L), sampleLod(pdf, SAMPLES)).rgb;
+    }
+    fragColor = vec4(sum * (PI / float(SAMPLES)), 1.0);
+}
+)";
+
+    static constexpr const char* kBrdfFrag = R"(
+const uint SAMPLES = 256u;
+void main() {
+    float NdotV = max(vUV.x, 0.001);
+    float r = vUV.y;
+    vec3 V = vec3(sqrt(1.0 - NdotV * NdotV), 0.0, NdotV);
+    float a = r * r;
+    float k = a / 2.0;
+    float A = 0.0;
+    float B = 0.0;
+    for (uint i = 0u; i < SAMPLES; i++) {
+        vec2 xi = hammersley(i, SAMPLES);
+        float phi = 2.0 * PI * xi.x;
+        float cosTheta = sqrt((1.0 - xi.y) / (1.0 + (a * a - 1.0) * xi.y));
+        float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+        vec3 H = vec3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+        vec3 L = 2.0 * dot(V, H) * H - V;
+        float NdotL = max(L.z, 0.0);
+        float NdotH = max(H.z, 0.0);
+        float VdotH = max(dot(V, H), 0.0);
+        if (NdotL > 0.0) {
+            float G = (NdotV / (NdotV * (1.0 - k) + k)) * (NdotL / (NdotL * (1.0 - k) + k));
+            float visibility = G * VdotH / (NdotH * NdotV);
+            float Fc = pow(1.0 - VdotH, 5.0);
+            A += (1.0 - Fc) * visibility;
+            B += Fc * visibility;
+        }
+    }
+    fragColor = vec4(A / float(SAMPLES), B / float(SAMPLES), 0.0, 1.0);
+}
+)";
+};
+
+/**
+ * L2 spherical-harmonics diffuse irradiance (Ramamoorthi & Hanrahan).
+ * The cosine lobe and basis constants are folded into the coefficients,
+ * so with n the world-space normal a shader evaluates
+ *   E(n) = c0 + c1 y + c2 z + c3 x + c4 xy + c5 yz + c6 (3z^2 - 1)
+ *        + c7 xz + c8 (x^2 - y^2)
+ * at the irradiance map's scale (pi * mean cosine-weighted radiance).
+ * Coefficients are std140 vec4s (rgb + padding) for a uniform block.
+ */
+struct SHIrradiance {
+    static constexpr int kCoefficients = 9;
+
+    float coeffs[kCoefficients][4] = {};
+    bool valid = false;
+
+    /**
+     * Project an environment on a width x height equirect grid. Reads
+     * through sampleDirection(), so it works after releasePixels() (from
+     * the preview); a few thousand samples are plenty for L2.
+     */
+    static SHIrradiance project(const WebHDR& hdr, int width = 128, int height = 64) {
+        SHIrradiance sh;
+        if (!hdr.ready() || hdr.width() <= 0 || hdr.height() <= 0) return sh;
+
+        // Basis constants times the cosine lobe's band factors
+        // (pi, 2pi/3, pi/4); projection and evaluation each take one
+        // basis constant, so they appear squared
+        const float pi = (float)M_PI;
+        const float k[kCoefficients] = {
+            0.282095f * 0.282095f * pi,
+            0.488603f * 0.488603f * 2.0f * pi / 3.0f,
+            0.488603f * 0.488603f * 2.0f * pi / 3.0f,
+            0.488603f * 0.488603f * 2.0f * pi / 3.0f,
+            1.092548f * 1.092548f * pi / 4.0f,
+            1.092548f * 1.092548f * pi / 4.0f,
+            0.315392f * 0.315392f * pi / 4.0f,
+            1.092548f * 1.092548f * pi / 4.0f,
+            0.546274f * 0.546274f * pi / 4.0f,
+        };
+
+        double sum[kCoefficients][3] = {};
+        float dPhi = 2.0f * pi / width;
+        float dTheta = pi / height;
+        for (int y = 0; y < height; y++) {
+            float theta = (y + 0.5f) * dTheta;
+            float sinTheta = sinf(theta);
+            float dOmega = dPhi * dTheta * sinTheta;
+            for (int x = 0; x < width; x++) {
+                // Same mapping as directionToUV() / generateIrradianceMap()
+                float phi = (x + 0.5f) * dPhi - pi;
+                float dx = sinTheta * cosf(phi);
+                float dy = cosf(theta);
+                float dz = sinTheta * sinf(phi);
+
+                float r, g, b;
+                hdr.sampleDirection(dx, dy, dz, r, g, b);
+
+                float basis[kCoefficients];
+                polynomial(dx, dy, dz, basis);
+                for (int i = 0; i < kCoefficients; i++) {
+                    float w = basis[i] * dOmega;
+                    sum[i][0] += r * w;
+                    sum[i][1] += g * w;
+                    sum[i][2] += b * w;
+                }
+            }
+        }
+
+        for (int i = 0; i < kCoefficients; i++) {
+            sh.coeffs[i][0] = (float)sum[i][0] * k[i];
+            sh.coeffs[i][1] = (float)sum[i][1] * k[i];
+            sh.coeffs[i][2] = (float)sum[i][2] * k[i];
+        }
+        sh.valid = true;
+        return sh;
+    }
+
+    /// Irradiance for a unit world-space direction (CPU reference)
+    void evaluate(float x, float y, float z, float& r, float& g, float& b) const {
+        float basis[kCoefficients];
+        polynomial(x, y, z, basis);
+        r = g = b = 0.0f;
+        for (int i = 0; i < kCoefficients; i++) {
+            r += coeffs[i][0] * basis[i];
+            g += coeffs[i][1] * basis[i];
+            b += coeffs[i][2] * basis[i];
+        }
+    }
+
+    /// Unnormalized L2 basis, in the order the shaders expect
+    static void polynomial(float x, float y, float z, float* out) {
+        out[0] = 1.0f;
+        out[1] = y;
+        out[2] = z;
+        out[3] = x;
+        out[4] = x * y;
+        out[5] = y * z;
+        out[6] = 3.0f * z * z - 1.0f;
+        out[7] = x * z;
+        out[8] = x * x - y * y;
+    }
+};
+
+} // namespace al
+
+#endif // AL_WEB_IBL_HPP
@@ -14,6 +14,18 @@
  *       texture.submit(img.pixels());
  *   }
  *
+ * Texture-only usage (pixels never enter the wasm heap):
+ *   img.loadBitmap("path/to/image.png");  // Decoded in a worker
+ *
+ *   // Once ready, into the bound GL texture or a backend texture
+ *   img.uploadBitmapGL();
+ *   backend->uploadImageBitmap(handle, img.bitmapId());
+ *   img.release();
+ *
+ * Loads are queued in the shared AssetLoader: setPriority() before load()
+ * ranks them (higher sooner), cancel() drops one, and images loading the
+ * same URL share a single fetch and decode.
+ *
  * Supports: PNG, JPG, GIF, WebP, BMP, and other browser-supported formats.
  */
 
@@ -25,6 +37,9 @@
 #include <vector>
 #include <cstdint>
 #include <functional>
+#include <memory>
+
+#include "al_WebAssetLoader.hpp"
 
 namespace al {
 
@@ -35,10 +50,20 @@ class WebImage {
 public:
     using LoadCallback = std::function<void(bool success)>;
 
+    /// One decode, shared by every WebImage that asked for the same URL
+    struct Decoded {
+        int width = 0;
+        int height = 0;
+        const uint8_t* pixels = nullptr;  // RGBA8, valid during the callback
+        size_t size = 0;
+        std::shared_ptr<int> bitmap;      // Set for loadBitmap()
+    };
+
     WebImage() : mWidth(0), mHeight(0), mReady(false) {}
 
     ~WebImage() {
-        // Cleanup handled automatically
+        // The bitmap closes with its last copy; a pending load is dropped
+        cancel();
     }
 
     /**
@@ -46,61 +71,82 @@ public:
      * @param url Path to image file or data URL
      */
     void load(const std::string& url) {
-        mReady = false;
-        mUrl = url;
-        mPixels.clear();
-
-        EM_ASM({
-            var imgPtr = $0;
-            var url = UTF8ToString($1);
-
-            var img = new Image();
-            img.crossOrigin = 'anonymous';  // Enable CORS for external images
+        begin(url);
+        mTicket = AssetLoader::instance().request<Decoded>("image:" + url, mPriority,
+            [url](AssetLoader::Done<Decoded> done) {
+                decodePixels(url, new AssetLoader::Done<Decoded>(std::move(done)));
+            },
+            [this](const Decoded* image) { _onDecoded(image); });
+    }
 
-            img.onload = function() {
-                // Create canvas to extract pixel data
-                var canvas = document.createElement('canvas');
-                canvas.width = img.width;
-                canvas.height = img.height;
-                var ctx = canvas.getContext('2d');
-                ctx.drawImage(img, 0, 0);
+    /**
+     * Load image with completion callback
+     */
+    void load(const std::string& url, LoadCallback callback) {
+        mLoadCallback = callback;
+        load(url);
+    }
 
-                // Get RGBA pixel data
-                var imageData = ctx.getImageData(0, 0, img.width, img.height);
-                var pixels = imageData.data;
+    /**
+     * Texture-only load. The file is fetched and decoded off the main thread
+     * (createImageBitmap in a worker) and the decoded bitmap stays on the JS
+     * side: nothing is copied into the wasm heap, so pixels() stays empty.
+     * Upload with uploadBitmapGL() or GraphicsBackend::uploadImageBitmap(),
+     * then release(). Falls back to load() where createImageBitmap is
+     * unavailable.
+     */
+    void loadBitmap(const std::string& url, LoadCallback callback = nullptr) {
+        mLoadCallback = callback;
+        begin(url);
+        mTicket = AssetLoader::instance().request<Decoded>("bitmap:" + url, mPriority,
+            [url](AssetLoader::Done<Decoded> done) {
+                auto* pending = new AssetLoader::Done<Decoded>(std::move(done));
+                if (!decodeBitmap(url, pending)) decodePixels(url, pending);
+            },
+            [this](const Decoded* image) { _onDecoded(image); });
+    }
 
-                // Copy to WASM memory
-                var ptr = Module._malloc(pixels.length);
-                Module.HEAPU8.set(pixels, ptr);
+    /**
+     * Scheduling priority in the AssetLoader queue (higher loads sooner,
+     * e.g. projected pixels or AssetLoader::distancePriority()). Applies
+     * to a queued load too.
+     */
+    void setPriority(float priority) {
+        mPriority = priority;
+        if (mTicket) AssetLoader::instance().setPriority(mTicket, priority);
+    }
+    float priority() const { return mPriority; }
 
-                // Call C++ callback
-                Module.ccall('_al_web_image_loaded', null,
-                    ['number', 'number', 'number', 'number', 'number'],
-                    [imgPtr, ptr, img.width, img.height, pixels.length]);
+    /// Drop a pending load; the callback won't run
+    void cancel() {
+        if (mTicket) AssetLoader::instance().cancel(mTicket);
+        mTicket = 0;
+    }
 
-                // Note: Don't free ptr here, C++ will copy the data
-            };
+    /// True while a load is queued or in flight
+    bool loading() const { return mTicket != 0; }
 
-            img.onerror = function() {
-                console.error('[WebImage] Failed to load:', url);
-                Module.ccall('_al_web_image_error', null, ['number'], [imgPtr]);
-            };
+    /// Decoded bitmap held on the JS side (see loadBitmap())
+    bool hasBitmap() const { return mBitmap != nullptr; }
 
-            // Prepend app base path so /assets/... works on GitHub Pages subdirectory deployments
-            var basePath = window.__alloBasePath || '/';
-            if (url.charAt(0) === '/' && url.indexOf('/assets/') === 0) {
-                url = basePath + url.slice(1);
-            }
-            img.src = url;
-        }, this, url.c_str());
-    }
+    /// Key of the bitmap in Module._alImageBitmaps, 0 if none
+    int bitmapId() const { return mBitmap ? *mBitmap : 0; }
 
     /**
-     * Load image with completion callback
+     * Upload the bitmap as RGBA8 into `level` of the texture bound to
+     * `target` (default GL_TEXTURE_2D). The browser copies it straight to
+     * the GPU.
      */
-    void load(const std::string& url, LoadCallback callback) {
-        mLoadCallback = callback;
-        load(url);
+    bool uploadBitmapGL(int target = 0x0DE1, int level = 0) const {
+        if (!mBitmap) return false;
+        return EM_ASM_INT({
+            var state = Module._alImageBitmaps;
+            var bitmap = state && state.bitmaps[$0];
+            if (!bitmap || typeof GLctx === 'undefined' || !GLctx) return 0;
+            // RGBA8 / RGBA / UNSIGNED_BYTE
+            GLctx.texImage2D($1, $2, 0x8058, 0x1908, 0x1401, bitmap);
+            return 1;
+        }, *mBitmap, target, level) != 0;
     }
 
     /**
@@ -159,28 +205,61 @@ public:
         return true;
     }
 
-    // Internal callback from JavaScript
-    void _onLoaded(uint8_t* pixels, int width, int height, int size) {
-        mWidth = width;
-        mHeight = height;
-        mPixels.assign(pixels, pixels + size);
-        mReady = true;
+    /**
+     * Free the pixel data or bitmap (e.g. once it has been uploaded to the
+     * GPU). width() and height() keep the loaded size.
+     */
+    void release() {
+        std::vector<uint8_t>().swap(mPixels);
+        mBitmap.reset();
+        mReady = false;
+    }
+
+    // Internal callbacks from JavaScript: finish the shared decode, which
+    // hands it to every WebImage waiting on it
+    static void _onPixelsDecoded(AssetLoader::Done<Decoded>* done, uint8_t* pixels,
+                                 int width, int height, int size) {
+        Decoded image;
+        image.width = width;
+        image.height = height;
+        image.pixels = pixels;
+        image.size = (size_t)size;
+        (*done)(&image, image.size);
+        delete done;
 
         // Free the malloc'd buffer from JS
         EM_ASM({ Module._free($0); }, pixels);
+    }
 
-        printf("[WebImage] Loaded: %s (%dx%d)\n", mUrl.c_str(), width, height);
-
-        if (mLoadCallback) {
-            mLoadCallback(true);
+    // bitmapId 0 means the load failed
+    static void _onBitmapDecoded(AssetLoader::Done<Decoded>* done, int bitmapId,
+                                 int width, int height) {
+        if (bitmapId == 0) {
+            (*done)(nullptr, 0);
+            delete done;
+            return;
         }
+        Decoded image;
+        image.width = width;
+        image.height = height;
+        image.bitmap = std::shared_ptr<int>(new int(bitmapId), [](int* id) {
+            EM_ASM({
+                var state = Module._alImageBitmaps;
+                var bitmap = state && state.bitmaps[$0];
+                if (bitmap) {
+                    bitmap.close();
+                    delete state.bitmaps[$0];
+                }
+            }, *id);
+            delete id;
+        });
+        (*done)(&image, (size_t)width * height * 4);
+        delete done;
     }
 
-    void _onError() {
-        mReady = false;
-        if (mLoadCallback) {
-            mLoadCallback(false);
-        }
+    static void _onDecodeError(AssetLoader::Done<Decoded>* done) {
+        (*done)(nullptr, 0);
+        delete done;
     }
 
 private:
@@ -188,8 +267,183 @@ private:
     unsigned int mWidth;
     unsigned int mHeight;
     std::vector<uint8_t> mPixels;
+    std::shared_ptr<int> mBitmap;  // Closed with the last copy
     bool mReady;
     LoadCallback mLoadCallback;
+    float mPriority = 0.0f;
+    AssetLoader::Ticket mTicket = 0;
+
+    void begin(const std::string& url) {
+        cancel();
+        mReady = false;
+        mUrl = url;
+        mPixels.clear();
+        mBitmap.reset();
+    }
+
+    void _onDecoded(const Decoded* image) {
+        mTicket = 0;
+        if (!image) {
+            mReady = false;
+            if (mLoadCallback) mLoadCallback(false);
+            return;
+        }
+        mWidth = image->width;
+        mHeight = image->height;
+        if (image->bitmap) {
+            mBitmap = image->bitmap;
+            printf("[WebImage] Decoded: %s (%dx%d, bitmap)\n", mUrl.c_str(),
+                   image->width, image->height);
+        } else {
+            mPixels.assign(image->pixels, image->pixels + image->size);
+            printf("[WebImage] Loaded: %s (%dx%d)\n", mUrl.c_str(),
+                   image->width, image->height);
+        }
+        mReady = true;
+
+        if (mLoadCallback) {
+            mLoadCallback(true);
+        }
+    }
+
+    /// Decode with an Image element and copy the RGBA pixels to the heap
+    static void decodePixels(const std::string& url, AssetLoader::Done<Decoded>* done) {
+        EM_ASM({
+            var donePtr = $0;
+            var url = UTF8ToString($1);
+
+            var img = new Image();
+            img.crossOrigin = 'anonymous';  // Enable CORS for external images
+
+            img.onload = function() {
+                // Create canvas to extract pixel data
+                var canvas = document.createElement('canvas');
+                canvas.width = img.width;
+                canvas.height = img.height;
+                var ctx = canvas.getContext('2d');
+                ctx.drawImage(img, 0, 0);
+
+                // Get RGBA pixel data
+                var imageData = ctx.getImageData(0, 0, img.width, img.height);
+                var pixels = imageData.data;
+
+                // Copy to WASM memory
+                var ptr = Module._malloc(pixels.length);
+                Module.HEAPU8.set(pixels, ptr);
+
+                // Call C++ callback
+                Module.ccall('_al_web_image_loaded', null,
+                    ['number', 'number', 'number', 'number', 'number'],
+                    [donePtr, ptr, img.width, img.height, pixels.length]);
+
+                // Note: Don't free ptr here, C++ will copy the data
+            };
+
+            img.onerror = function() {
+                console.error('[WebImage] Failed to load:', url);
+                Module.ccall('_al_web_image_error', null, ['number'], [donePtr]);
+            };
+
+            // Prepend app base path so /assets/... works on GitHub Pages subdirectory deployments
+            var basePath = window.__alloBasePath || '/';
+            if (url.charAt(0) === '/' && url.indexOf('/assets/') === 0) {
+                url = basePath + url.slice(1);
+            }
+            img.src = url;
+        }, done, url.c_str());
+    }
+
+    /// Fetch + createImageBitmap in the shared worker; false if unsupported
+    static bool decodeBitmap(const std::string& url, AssetLoader::Done<Decoded>* done) {
+        return EM_ASM_INT({
+            var donePtr = $0;
+            var url = UTF8ToString($1);
+            if (typeof createImageBitmap === 'undefined') return 0;
+
+            var basePath = window.__alloBasePath || '/';
+            if (url.charAt(0) === '/' && url.indexOf('/assets/') === 0) {
+                url = basePath + url.slice(1);
+            }
+            // Worker fetches resolve against the blob URL, so go absolute
+            var absolute = new URL(url, document.baseURI).href;
+
+            var state = Module._alImageBitmaps;
+            if (!state) {
+                state = Module._alImageBitmaps = { next: 1, bitmaps: {}, pending: {}, worker: null };
+                state.decode = function(id, src, done) {
+                    fetch(src)
+                        .then(function(r) {
+                            if (!r.ok) throw new Error('HTTP error ' + r.status);
+                            return r.blob();
+                        })
+                        .then(function(blob) {
+                            return createImageBitmap(blob, { premultiplyAlpha: 'none' });
+                        })
+                        .then(function(bitmap) { done(bitmap); })
+                        .catch(function(err) { done(null, String(err)); });
+                };
+                try {
+                    // Same fetch + decode, posting the bitmap back as a transferable
+                    var source = '(' + (function() {
+                        self.onmessage = function(e) {
+                            var id = e.data.id;
+                            fetch(e.data.url)
+                                .then(function(r) {
+                                    if (!r.ok) throw new Error('HTTP error ' + r.status);
+                                    return r.blob();
+                                })
+                                .then(function(blob) {
+                                    return createImageBitmap(blob, { premultiplyAlpha: 'none' });
+                                })
+                                .then(function(bitmap) {
+                                    self.postMessage({ id: id, bitmap: bitmap }, [bitmap]);
+                                })
+                                .catch(function(err) {
+                                    self.postMessage({ id: id, error: String(err) });
+                                });
+                        };
+                    }).toString() + ')()';
+                    state.worker = new Worker(URL.createObjectURL(
+                        new Blob([source], { type: 'text/javascript' })));
+                    state.worker.onmessage = function(e) {
+                        var job = state.pending[e.data.id];
+                        delete state.pending[e.data.id];
+                        if (job) job.done(e.data.bitmap, e.data.error);
+                    };
+                    state.worker.onerror = function() {
+                        // Blocked (e.g. by CSP): decode the queued jobs here instead
+                        state.worker = null;
+                        var jobs = state.pending;
+                        state.pending = {};
+                        for (var key in jobs) state.decode(key, jobs[key].url, jobs[key].done);
+                    };
+                } catch (e) {
+                    state.worker = null;
+                }
+            }
+
+            var id = state.next++;
+            var done = function(bitmap, error) {
+                if (!bitmap) {
+                    console.error('[WebImage] Failed to load:', url, error || '');
+                    Module.ccall('_al_web_image_bitmap_loaded', null,
+                        ['number', 'number', 'number', 'number'], [donePtr, 0, 0, 0]);
+                    return;
+                }
+                state.bitmaps[id] = bitmap;
+                Module.ccall('_al_web_image_bitmap_loaded', null,
+                    ['number', 'number', 'number', 'number'],
+                    [donePtr, id, bitmap.width, bitmap.height]);
+            };
+            if (state.worker) {
+                state.pending[id] = { url: absolute, done: done };
+                state.worker.postMessage({ id: id, url: absolute });
+            } else {
+                state.decode(id, absolute, done);
+            }
+            return 1;
+        }, done, url.c_str()) != 0;
+    }
 };
 
 /**
@@ -203,17 +457,27 @@ public:
 
     /**
      * Add an image to the batch
+     * @param priority AssetLoader priority (higher loads sooner)
      * @return Index of the image
      */
-    int add(const std::string& url) {
+    int add(const std::string& url, float priority = 0.0f) {
         int index = mImages.size();
         mImages.emplace_back();
+        mImages.back().setPriority(priority);
         mUrls.push_back(url);
         return index;
     }
 
+    /// Re-rank an image, e.g. as the camera moves while the batch loads
+    void setPriority(int index, float priority) { mImages[index].setPriority(priority); }
+
+    /// Drop the images that haven't loaded yet
+    void cancel() {
+        for (auto& img : mImages) img.cancel();
+    }
+
     /**
-     * Start loading all images
+     * Queue all images with the AssetLoader, highest priority first
      */
     void loadAll(BatchCallback callback = nullptr) {
         mCallback = callback;
@@ -271,15 +535,26 @@ private:
 
 // C callbacks for JavaScript
 extern "C" {
-    void _al_web_image_loaded(al::WebImage* img, uint8_t* pixels, int width, int height, int size) {
-        if (img) {
-            img->_onLoaded(pixels, width, height, size);
+    EMSCRIPTEN_KEEPALIVE
+    inline void _al_web_image_loaded(al::AssetLoader::Done<al::WebImage::Decoded>* done,
+                                     uint8_t* pixels, int width, int height, int size) {
+        if (done) {
+            al::WebImage::_onPixelsDecoded(done, pixels, width, height, size);
+        }
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    inline void _al_web_image_error(al::AssetLoader::Done<al::WebImage::Decoded>* done) {
+        if (done) {
+            al::WebImage::_onDecodeError(done);
         }
     }
 
-    void _al_web_image_error(al::WebImage* img) {
-        if (img) {
-            img->_onError();
+    EMSCRIPTEN_KEEPALIVE
+    inline void _al_web_image_bitmap_loaded(al::AssetLoader::Done<al::WebImage::Decoded>* done,
+                                            int bitmapId, int width, int height) {
+        if (done) {
+            al::WebImage::_onBitmapDecoded(done, bitmapId, width, height);
         }
     }
 }
@@ -0,0 +1,419 @@
+/**
+ * Web Jobs - work-stealing job pool for decode and generation work
+ *
+ * libal_web runs everything on the main thread, so glTF/OBJ/HDR decode,
+ * LOD simplification and procedural textures stall the render loop for as
+ * long as they take. JobSystem runs that work on a pool of pthreads when
+ * the library is built with ALLOLIB_JOB_THREADS (AL_WEB_JOB_THREADS, the
+ * "threads" build: -pthread, cross-origin isolated pages). Without it there
+ * are no workers and every job runs inline where it is submitted, so the
+ * same code works, serially, in every build (native included).
+ *
+ *   auto& jobs = JobSystem::instance();
+ *
+ *   // Result on the main thread, between frames (WebApp calls pump())
+ *   jobs.submit([bytes] { Mesh m; WebOBJ::parse(bytes.data(), bytes.size(), m); return m; },
+ *               [this](Mesh& m) { mMesh = std::move(m); mReady = true; });
+ *
+ *   // Or poll / wait for it
+ *   JobFuture<float> f = jobs.submit([] { return heavy(); });
+ *   if (f.ready()) use(f.get());
+ *
+ *   // Split a loop across the pool; the caller works too
+ *   jobs.parallelFor(0, height, 16, [&](int y0, int y1) { ... rows y0..y1-1 ... });
+ *
+ * Each worker owns a deque: it takes its own newest job first (LIFO, so
+ * nested work stays cache-warm), then jobs submitted from other threads,
+ * then steals the oldest job of another worker. Idle workers sleep on a
+ * futex. Nothing waits by blocking: get(), wait() and parallelFor() run
+ * queued jobs until their own work is done, so nested submits can't starve
+ * the pool and the main thread never sleeps.
+ *
+ * Completions (the second argument of submit()) run on the main thread in
+ * pump() and must be submitted from it; loaders use them so results land
+ * between frames like the fetch callbacks they replace. cancel() drops a
+ * completion that hasn't run; the job itself still runs to the end, so it
+ * must own (or share) everything it touches.
+ */
+
+#ifndef AL_WEB_JOBS_HPP
+#define AL_WEB_JOBS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef AL_WEB_JOB_THREADS
+#include <emscripten/threading.h>
+#include <pthread.h>
+#include <cmath>
+#endif
+
+namespace al {
+
+namespace detail {
+
+struct JobStateBase {
+    std::atomic<bool> done{false};
+    std::atomic<bool> cancelled{false};
+};
+
+template <typename T>
+struct JobState : JobStateBase {
+    std::optional<T> value;
+};
+
+template <>
+struct JobState<void> : JobStateBase {};
+
+} // namespace detail
+
+class JobSystem;
+
+/// Handle to a submitted job's result; copies share the result
+template <typename T>
+class JobFuture {
+public:
+    JobFuture() = default;
+    explicit JobFuture(std::shared_ptr<detail::JobState<T>> state) : mState(std::move(state)) {}
+
+    bool valid() const { return mState != nullptr; }
+
+    /// The job has finished (its completion may not have run yet)
+    bool ready() const { return mState && mState->done.load(std::memory_order_acquire); }
+
+    /// Wait for the job, running other queued jobs meanwhile
+    void wait() const;
+
+    /// Wait, then return the result
+    template <typename U = T>
+    typename std::enable_if<!std::is_void<U>::value, U&>::type get() {
+        wait();
+        return *mState->value;
+    }
+
+    /// Drop the completion if it hasn't run; the job still finishes
+    void cancel() {
+        if (mState) mState->cancelled.store(true, std::memory_order_release);
+    }
+
+private:
+    friend class JobSystem;
+    std::shared_ptr<detail::JobState<T>> mState;
+};
+
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    static constexpr int kMaxThreads = 8;
+
+    static JobSystem& instance() {
+        static JobSystem jobs;
+        return jobs;
+    }
+
+    ~JobSystem() { stopWorkers(); }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * Worker threads (0 = run jobs inline). Without AL_WEB_JOB_THREADS
+     * there are never any. Defaults to one less than the logical cores, at
+     * most 4, started on the first submit. Call from the main thread while
+     * no jobs are running.
+     */
+    void setThreads(int n) {
+#ifdef AL_WEB_JOB_THREADS
+        stopWorkers();
+        n = std::max(0, std::min(n, kMaxThreads));
+        mQueues.clear();
+        for (int i = 0; i < n; ++i) mQueues.push_back(std::make_unique<Queue>());
+        mQuit.store(false, std::memory_order_relaxed);
+        for (int i = 0; i < n; ++i) {
+            auto* start = new WorkerStart{this, i};
+            pthread_t t;
+            if (pthread_create(&t, nullptr, &JobSystem::workerMain, start) != 0) {
+                delete start;
+                printf("[JobSystem] Started %d of %d workers\n", i, n);
+                break;
+            }
+            mWorkers.push_back(t);
+        }
+        mStarted = true;
+#else
+        if (n > 0) printf("[JobSystem] Built without AL_WEB_JOB_THREADS; running jobs inline\n");
+        mStarted = true;
+#endif
+    }
+
+    /// Worker threads running (starts the default pool if none was set)
+    int threads() {
+        ensureStarted();
+        return (int)mWorkers.size();
+    }
+
+    /**
+     * Run `work` on the pool. The future holds its return value.
+     */
+    template <typename F>
+    auto submit(F work) -> JobFuture<typename std::invoke_result<F&>::type> {
+        using R = typename std::invoke_result<F&>::type;
+        auto state = std::make_shared<detail::JobState<R>>();
+        enqueue([state, work]() mutable {
+            if constexpr (std::is_void<R>::value) {
+                work();
+            } else {
+                state->value.emplace(work());
+            }
+            state->done.store(true, std::memory_order_release);
+        });
+        return JobFuture<R>(state);
+    }
+
+    /**
+     * Run `work` on the pool, then `done` on the main thread with the
+     * result (done(R&), or done() for void jobs) from pump(). Main thread
+     * only. Without workers both run before submit() returns.
+     */
+    template <typename F, typename Done>
+    auto submit(F work, Done done) -> JobFuture<typename std::invoke_result<F&>::type> {
+        using R = typename std::invoke_result<F&>::type;
+        JobFuture<R> future = submit(std::move(work));
+        auto state = future.mState;
+        mCompletions.push_back({state, [state, done]() mutable {
+            if constexpr (std::is_void<R>::value) {
+                done();
+            } else {
+                done(*state->value);
+            }
+        }});
+        if (threads() == 0) pump();
+        return future;
+    }
+
+    /**
+     * Call fn(begin, end) over [first, last) in chunks of `grain` spread
+     * across the pool, and return once every chunk is done. The calling
+     * thread takes chunks too.
+     */
+    template <typename F>
+    void parallelFor(int first, int last, int grain, F&& fn) {
+        if (last <= first) return;
+        grain = std::max(1, grain);
+        const int chunks = (last - first + grain - 1) / grain;
+        const int helpers = std::min(threads(), chunks - 1);
+        if (helpers <= 0) {
+            fn(first, last);
+            return;
+        }
+
+        // Chunks are claimed from a shared counter; a helper that starts
+        // after the last claim leaves without touching fn, which only
+        // lives until every chunk is done
+        struct Range {
+            std::atomic<int> next{0};
+            std::atomic<int> done{0};
+        };
+        auto range = std::make_shared<Range>();
+        auto* body = &fn;
+        auto run = [range, body, first, last, grain, chunks]() {
+            int c;
+            while ((c = range->next.fetch_add(1, std::memory_order_relaxed)) < chunks) {
+                const int begin = first + c * grain;
+                (*body)(begin, std::min(last, begin + grain));
+                range->done.fetch_add(1, std::memory_order_acq_rel);
+            }
+        };
+        for (int i = 0; i < helpers; ++i) enqueue(run);
+        run();
+        while (range->done.load(std::memory_order_acquire) < chunks) helpOrYield();
+    }
+
+    /**
+     * Run the completions of finished jobs. WebApp calls this once per
+     * frame before onAnimate.
+     */
+    void pump() {
+        if (mPumping || mCompletions.empty()) return;
+        mPumping = true;
+        // Completions may submit more jobs (and so append completions)
+        for (size_t i = 0; i < mCompletions.size();) {
+            auto& c = mCompletions[i];
+            if (c.state->cancelled.load(std::memory_order_acquire)) {
+                mCompletions.erase(mCompletions.begin() + i);
+            } else if (c.state->done.load(std::memory_order_acquire)) {
+                Job run = std::move(c.run);
+                mCompletions.erase(mCompletions.begin() + i);
+                run();
+            } else {
+                ++i;
+            }
+        }
+        mPumping = false;
+    }
+
+    /// Completions waiting for their job or for pump()
+    size_t pending() const { return mCompletions.size(); }
+
+    /// Wait for `state`, running queued jobs meanwhile
+    void waitFor(const detail::JobStateBase& state) {
+        while (!state.done.load(std::memory_order_acquire)) helpOrYield();
+    }
+
+private:
+    JobSystem() = default;
+
+    struct Queue {
+        std::mutex lock;
+        std::deque<Job> jobs;
+
+        void push(Job job) {
+            std::lock_guard<std::mutex> guard(lock);
+            jobs.push_back(std::move(job));
+        }
+        bool popBack(Job& out) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (jobs.empty()) return false;
+            out = std::move(jobs.back());
+            jobs.pop_back();
+            return true;
+        }
+        bool popFront(Job& out) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (jobs.empty()) return false;
+            out = std::move(jobs.front());
+            jobs.pop_front();
+            return true;
+        }
+    };
+
+    struct Completion {
+        std::shared_ptr<detail::JobStateBase> state;
+        Job run;
+    };
+
+    struct WorkerStart {
+        JobSystem* self;
+        int index;
+    };
+
+    /// Index of the calling worker, -1 off the pool
+    static int& workerIndex() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    void ensureStarted() {
+        if (mStarted) return;
+#ifdef AL_WEB_JOB_THREADS
+        setThreads(std::min(4, std::max(1, emscripten_num_logical_cores() - 1)));
+#else
+        mStarted = true;
+#endif
+    }
+
+    void enqueue(Job job) {
+        if (threads() == 0) {
+            job();
+            return;
+        }
+#ifdef AL_WEB_JOB_THREADS
+        const int self = workerIndex();
+        if (self >= 0) mQueues[self]->push(std::move(job));
+        else mInject.push(std::move(job));
+        mSignal.fetch_add(1, std::memory_order_release);
+        emscripten_futex_wake(&mSignal, 1);
+#endif
+    }
+
+    bool take(Job& out) {
+        const int self = workerIndex();
+        if (self >= 0 && mQueues[self]->popBack(out)) return true;
+        if (mInject.popFront(out)) return true;
+        const int n = (int)mQueues.size();
+        for (int k = 1; k <= n; ++k) {
+            const int victim = ((self < 0 ? 0 : self) + k) % n;
+            if (victim != self && mQueues[victim]->popFront(out)) return true;
+        }
+        return false;
+    }
+
+    void helpOrYield() {
+        Job job;
+        if (take(job)) {
+            job();
+            return;
+        }
+#ifdef AL_WEB_JOB_THREADS
+        // Workers proxy file system calls to the main thread; serve them
+        // here, or a worker writing a cache file would wait forever
+        if (emscripten_is_main_runtime_thread()) emscripten_current_thread_process_queued_calls();
+#endif
+        std::this_thread::yield();
+    }
+
+#ifdef AL_WEB_JOB_THREADS
+    static void* workerMain(void* arg) {
+        auto* start = static_cast<WorkerStart*>(arg);
+        JobSystem* self = start->self;
+        workerIndex() = start->index;
+        delete start;
+
+        while (!self->mQuit.load(std::memory_order_acquire)) {
+            const uint32_t seen = self->mSignal.load(std::memory_order_acquire);
+            Job job;
+            if (self->take(job)) {
+                job();
+                continue;
+            }
+            emscripten_futex_wait(&self->mSignal, seen, INFINITY);
+        }
+        return nullptr;
+    }
+#endif
+
+    void stopWorkers() {
+#ifdef AL_WEB_JOB_THREADS
+        if (mWorkers.empty()) return;
+        mQuit.store(true, std::memory_order_release);
+        mSignal.fetch_add(1, std::memory_order_release);
+        emscripten_futex_wake(&mSignal, (int)mWorkers.size());
+        for (pthread_t t : mWorkers) pthread_join(t, nullptr);
+        mWorkers.clear();
+#endif
+    }
+
+    std::vector<std::unique_ptr<Queue>> mQueues;  // One per worker
+    Queue mInject;                                 // Submitted off the pool
+    std::vector<Completion> mCompletions;          // Main thread only
+    bool mPumping = false;
+    bool mStarted = false;
+    std::atomic<uint32_t> mSignal{0};
+    std::atomic<bool> mQuit{false};
+#ifdef AL_WEB_JOB_THREADS
+    std::vector<pthread_t> mWorkers;
+#else
+    std::vector<int> mWorkers;  // Always empty
+#endif
+};
+
+template <typename T>
+void JobFuture<T>::wait() const {
+    if (mState) JobSystem::instance().waitFor(*mState);
+}
+
+} // namespace al
+
+#endif // AL_WEB_JOBS_HPP
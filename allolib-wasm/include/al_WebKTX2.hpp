@@ -0,0 +1,606 @@
+/**
+ * Web KTX2 Texture Loader
+ *
+ * Loads KTX2 containers holding GPU block-compressed textures with their
+ * pre-baked mip chains, so textures stay compressed in GPU memory:
+ * BC7 / BC3 / ETC2 RGBA / ASTC 4x4 take 1 byte per texel and BC1 / ETC2
+ * RGB half a byte, against 4 for RGBA8.
+ *
+ * Usage:
+ *   WebKTX2 ktx;
+ *   ktx.load("/assets/textures/brick.ktx2", [&](bool ok) { ... });
+ *
+ *   // Raw GL: fills the texture bound to GL_TEXTURE_2D, every level
+ *   bool mipmapped = ktx.uploadGL();
+ *
+ *   // Through the graphics backend (WebGL2 or WebGPU)
+ *   TextureHandle tex = ktx.createTexture(*backend);
+ *   ktx.release();
+ *
+ * WebTexture, MipmapTexture and PBRTextureSet load .ktx2 URLs through this.
+ *
+ * Supports:
+ *   - 2D textures (no arrays, cubemaps or 3D)
+ *   - vkFormat BC1 / BC3 / BC7 / ETC2 / ASTC 4x4 (UNORM or SRGB) and
+ *     R8G8B8A8, uploaded as stored if the device supports the format.
+ *     SRGB formats upload as UNORM, matching the RGBA8 path, which leaves
+ *     decoding to the shaders.
+ *   - Basis Universal (ETC1S / BasisLZ or UASTC, Zstd or not), transcoded
+ *     to the best format the device has: ASTC 4x4, BC7, ETC2, BC3 / BC1,
+ *     then RGBA8. Transcoding goes through setTranscoder(); the default
+ *     uses the Basis Universal JS transcoder (basis_transcoder.js) when the
+ *     page has put its initialized module on Module.basisTranscoder.
+ */
+
+#ifndef AL_WEB_KTX2_HPP
+#define AL_WEB_KTX2_HPP
+
+#include <emscripten.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "al/graphics/al_OpenGL.hpp"
+#include "al/graphics/al_WebGL2Extensions.hpp"
+#include "al_WebAssetLoader.hpp"
+#include "al_WebFile.hpp"
+#include "al_WebGraphicsBackend.hpp"
+
+namespace al {
+
+// Defined in al_Graphics_Web.cpp
+GraphicsBackend* Graphics_getBackend();
+
+/**
+ * KTX2 container loader and uploader
+ */
+class WebKTX2 {
+public:
+    using LoadCallback = std::function<void(bool success)>;
+
+    /// One mip level in the level data, level 0 first
+    struct Level {
+        int width = 0;
+        int height = 0;
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    /**
+     * Transcodes the Basis Universal KTX2 file `data` to `target`, writing
+     * `levelCount` levels (level 0 first) to `out` and describing each in
+     * `levels`. Returns false if it cannot.
+     */
+    using Transcoder = std::function<bool(const uint8_t* data, size_t size,
+                                          PixelFormat target, int levelCount,
+                                          std::vector<uint8_t>& out,
+                                          std::vector<Level>& levels)>;
+
+    WebKTX2() = default;
+
+    /// Replace the Basis Universal transcoder (nullptr restores the JS one)
+    static void setTranscoder(Transcoder transcoder) { customTranscoder() = std::move(transcoder); }
+
+    /**
+     * Load a .ktx2 file from URL asynchronously
+     */
+    void load(const std::string& url, LoadCallback callback = nullptr) {
+        cancel();
+        mReady = false;
+        mUrl = url;
+        mCallback = callback;
+
+        mTicket = AssetLoader::instance().fetch(url, mPriority, [this](const UploadedFile& file) {
+            mTicket = 0;
+            bool ok = !file.data.empty() && parse(file.data.data(), file.data.size());
+            if (ok) {
+                printf("[WebKTX2] Loaded: %s (%dx%d, %d levels, %s, %zu KB)\n",
+                       mUrl.c_str(), mWidth, mHeight, numLevels(),
+                       formatName(mFormat), mByteSize / 1024);
+            } else {
+                printf("[WebKTX2] Failed to load: %s\n", mUrl.c_str());
+            }
+            if (mCallback) mCallback(ok);
+        });
+    }
+
+    /**
+     * Parse a KTX2 file, transcoding Basis payloads for this device
+     * @return true if the texture is ready to upload
+     */
+    bool parse(const uint8_t* data, size_t size) {
+        mReady = false;
+        mData.clear();
+        mLevels.clear();
+        mByteSize = 0;
+
+        Header header;
+        if (!readHeader(data, size, header)) return false;
+
+        mWidth = (int)header.pixelWidth;
+        mHeight = (int)header.pixelHeight;
+        int levelCount = (int)std::max(1u, header.levelCount);
+        readDFD(data, size, header);
+
+        bool ok;
+        if (header.basis) {
+            mFormat = chooseTranscodeTarget(mHasAlpha);
+            ok = transcode(data, size, levelCount);
+        } else {
+            ok = copyLevels(data, size, header, levelCount);
+        }
+        if (!ok) return false;
+
+        for (const Level& level : mLevels) mByteSize += level.size;
+        mReady = true;
+        return true;
+    }
+
+    /**
+     * Scheduling priority in the AssetLoader queue (higher loads sooner,
+     * e.g. AssetLoader::distancePriority()). Applies to a queued load too.
+     */
+    void setPriority(float priority) {
+        mPriority = priority;
+        if (mTicket) AssetLoader::instance().setPriority(mTicket, priority);
+    }
+    float priority() const { return mPriority; }
+
+    /// Drop a pending load; the callback won't run
+    void cancel() {
+        if (mTicket) AssetLoader::instance().cancel(mTicket);
+        mTicket = 0;
+    }
+
+    // ── Accessors ──
+
+    bool ready() const { return mReady; }
+    int width() const { return mWidth; }
+    int height() const { return mHeight; }
+    int numLevels() const { return (int)mLevels.size(); }
+    PixelFormat format() const { return mFormat; }
+    bool compressed() const { return isCompressedFormat(mFormat); }
+    bool hasAlpha() const { return mHasAlpha; }
+    const Level& level(int i) const { return mLevels[i]; }
+
+    /// Level data, or nullptr after release()
+    const uint8_t* levelData(int i) const {
+        if (mData.empty()) return nullptr;
+        return mData.data() + mLevels[i].offset;
+    }
+
+    /// GPU memory of every level; kept after release()
+    size_t byteSize() const { return mByteSize; }
+
+    /// Whether the levels form a full chain down to 1x1
+    bool fullMipChain() const {
+        int full = 1, size = std::max(mWidth, mHeight);
+        while (size > 1) { size >>= 1; full++; }
+        return numLevels() >= full;
+    }
+
+    /**
+     * Free the level data (e.g. once it has been uploaded to the GPU).
+     * Size, format, levels and byteSize() are kept.
+     */
+    void release() {
+        std::vector<uint8_t>().swap(mData);
+    }
+
+    // ── Upload ──
+
+    /**
+     * Upload every level into the texture bound to GL_TEXTURE_2D. A
+     * single-level RGBA8 file gets GPU-generated mipmaps; otherwise
+     * GL_TEXTURE_MAX_LEVEL is clamped to the stored chain.
+     * @return true if the texture has more than one level to filter between
+     */
+    bool uploadGL() const {
+        if (mData.empty() || mLevels.empty()) return false;
+
+        GLenum internalFormat = glInternalFormat(mFormat);
+        for (int i = 0; i < numLevels(); i++) {
+            const Level& lvl = mLevels[i];
+            if (compressed()) {
+                glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, lvl.width, lvl.height,
+                                       0, (GLsizei)lvl.size, levelData(i));
+            } else {
+                glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, lvl.width, lvl.height, 0,
+                             GL_RGBA, GL_UNSIGNED_BYTE, levelData(i));
+            }
+        }
+
+        if (!compressed() && numLevels() == 1) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+            return true;
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels() - 1);
+        return numLevels() > 1;
+    }
+
+    /**
+     * Create a backend texture holding every level
+     * @return Invalid handle if the data was released or the device
+     *         cannot take the format
+     */
+    TextureHandle createTexture(GraphicsBackend& backend,
+                                WrapMode wrap = WrapMode::Repeat) const {
+        if (mData.empty() || mLevels.empty()) return {};
+
+        // WebGPU sizes compressed textures in whole blocks
+        if (compressed() && backend.isWebGPU() && (mWidth % 4 != 0 || mHeight % 4 != 0)) {
+            printf("[WebKTX2] %s: %dx%d is not a multiple of the 4x4 block size\n",
+                   mUrl.c_str(), mWidth, mHeight);
+            return {};
+        }
+
+        TextureDesc desc;
+        desc.width = mWidth;
+        desc.height = mHeight;
+        desc.format = mFormat;
+        desc.wrapS = desc.wrapT = wrap;
+        desc.magFilter = FilterMode::Linear;
+        if (compressed()) {
+            desc.mipLevels = numLevels();
+        } else {
+            // Level 0 only; the GPU fills the chain
+            desc.mipmaps = true;
+        }
+        desc.minFilter = (desc.mipmaps || desc.mipLevels > 1) ? FilterMode::Trilinear
+                                                              : FilterMode::Linear;
+
+        TextureHandle handle = backend.createTexture(desc, levelData(0));
+        if (!handle.valid() || !compressed()) return handle;
+        for (int i = 1; i < numLevels(); i++) {
+            backend.updateTexture(handle, levelData(i), i, 0, 0,
+                                  mLevels[i].width, mLevels[i].height);
+        }
+        return handle;
+    }
+
+    // ── Device support ──
+
+    /// Whether the device takes `format`: the graphics backend's answer
+    /// when one is set, otherwise the WebGL2 extensions'
+    static bool supportsFormat(PixelFormat format) {
+        if (GraphicsBackend* backend = Graphics_getBackend()) {
+            return backend->supportsTextureFormat(format);
+        }
+        const WebGL2Capabilities& caps = WebGL2Extensions::capabilities();
+        switch (format) {
+            case PixelFormat::BC1:
+            case PixelFormat::BC3:        return caps.s3tcCompression;
+            case PixelFormat::BC7:        return caps.bptcCompression;
+            case PixelFormat::ETC2_RGB8:
+            case PixelFormat::ETC2_RGBA8: return caps.etc2Compression;
+            case PixelFormat::ASTC_4x4:   return caps.astcCompression;
+            default:                      return !isCompressedFormat(format);
+        }
+    }
+
+    /// Best format a Basis payload transcodes to on this device. ASTC and
+    /// BC7 keep alpha at full quality; ETC2 RGB and BC1 halve opaque maps.
+    static PixelFormat chooseTranscodeTarget(bool hasAlpha) {
+        if (supportsFormat(PixelFormat::ASTC_4x4)) return PixelFormat::ASTC_4x4;
+        if (supportsFormat(PixelFormat::BC7)) return PixelFormat::BC7;
+        if (supportsFormat(PixelFormat::ETC2_RGBA8)) {
+            return hasAlpha ? PixelFormat::ETC2_RGBA8 : PixelFormat::ETC2_RGB8;
+        }
+        if (supportsFormat(PixelFormat::BC3)) {
+            return hasAlpha ? PixelFormat::BC3 : PixelFormat::BC1;
+        }
+        return PixelFormat::RGBA8;
+    }
+
+    /// URL names a KTX2 file
+    static bool isKTX2(const std::string& url) {
+        return url.size() >= 5 && url.compare(url.size() - 5, 5, ".ktx2") == 0;
+    }
+
+    static const char* formatName(PixelFormat format) {
+        switch (format) {
+            case PixelFormat::BC1:        return "BC1";
+            case PixelFormat::BC3:        return "BC3";
+            case PixelFormat::BC7:        return "BC7";
+            case PixelFormat::ETC2_RGB8:  return "ETC2 RGB";
+            case PixelFormat::ETC2_RGBA8: return "ETC2 RGBA";
+            case PixelFormat::ASTC_4x4:   return "ASTC 4x4";
+            default:                      return "RGBA8";
+        }
+    }
+
+    static GLenum glInternalFormat(PixelFormat format) {
+        switch (format) {
+            case PixelFormat::BC1:        return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+            case PixelFormat::BC3:        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case PixelFormat::BC7:        return GL_COMPRESSED_RGBA_BPTC_UNORM_EXT;
+            case PixelFormat::ETC2_RGB8:  return GL_COMPRESSED_RGB8_ETC2;
+            case PixelFormat::ETC2_RGBA8: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+            case PixelFormat::ASTC_4x4:   return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+            default:                      return GL_RGBA8;
+        }
+    }
+
+private:
+    // File layout: identifier, Header fields, level index, DFD, KVD,
+    // supercompression global data, then the levels (smallest first)
+    static constexpr size_t kHeaderSize = 80;
+    static constexpr size_t kLevelIndexEntrySize = 24;
+
+    // Data format descriptor colour models of Basis payloads
+    static constexpr uint8_t kModelETC1S = 163;
+    static constexpr uint8_t kModelUASTC = 166;
+
+    struct Header {
+        uint32_t vkFormat = 0;
+        uint32_t pixelWidth = 0;
+        uint32_t pixelHeight = 0;
+        uint32_t pixelDepth = 0;
+        uint32_t layerCount = 0;
+        uint32_t faceCount = 0;
+        uint32_t levelCount = 0;
+        uint32_t supercompression = 0;  // 0 none, 1 BasisLZ, 2 Zstd, 3 Zlib
+        uint32_t dfdOffset = 0;
+        uint32_t dfdLength = 0;
+        bool basis = false;
+    };
+
+    static uint32_t readU32(const uint8_t* p) {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+
+    static uint64_t readU64(const uint8_t* p) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        return v;
+    }
+
+    bool readHeader(const uint8_t* data, size_t size, Header& h) {
+        static const uint8_t kIdentifier[12] = {
+            0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+        };
+        if (size < kHeaderSize || memcmp(data, kIdentifier, 12) != 0) {
+            printf("[WebKTX2] Not a KTX2 file\n");
+            return false;
+        }
+
+        h.vkFormat = readU32(data + 12);
+        h.pixelWidth = readU32(data + 20);
+        h.pixelHeight = readU32(data + 24);
+        h.pixelDepth = readU32(data + 28);
+        h.layerCount = readU32(data + 32);
+        h.faceCount = readU32(data + 36);
+        h.levelCount = readU32(data + 40);
+        h.supercompression = readU32(data + 44);
+        h.dfdOffset = readU32(data + 48);
+        h.dfdLength = readU32(data + 52);
+
+        if (h.pixelWidth == 0 || h.pixelHeight == 0 || h.pixelWidth > 16384 ||
+            h.pixelHeight > 16384) {
+            printf("[WebKTX2] Invalid dimensions: %ux%u\n", h.pixelWidth, h.pixelHeight);
+            return false;
+        }
+        if (h.pixelDepth > 1 || h.layerCount > 1 || h.faceCount != 1) {
+            printf("[WebKTX2] Only 2D textures are supported (depth %u, layers %u, faces %u)\n",
+                   h.pixelDepth, h.layerCount, h.faceCount);
+            return false;
+        }
+        size_t levels = std::max(1u, h.levelCount);
+        if (levels > 16 || kHeaderSize + levels * kLevelIndexEntrySize > size) {
+            printf("[WebKTX2] Truncated level index\n");
+            return false;
+        }
+        return true;
+    }
+
+    // Basic descriptor block: colour model, and from the samples whether
+    // a Basis payload carries alpha
+    void readDFD(const uint8_t* data, size_t size, Header& h) {
+        mHasAlpha = false;
+        if (h.dfdLength < 28 || (size_t)h.dfdOffset + h.dfdLength > size) {
+            h.basis = h.vkFormat == 0;
+            return;
+        }
+        const uint8_t* dfd = data + h.dfdOffset + 4;  // Past dfdTotalSize
+        uint8_t colorModel = dfd[8];
+        uint16_t blockSize;
+        memcpy(&blockSize, dfd + 6, 2);
+        int samples = blockSize >= 24 ? (blockSize - 24) / 16 : 0;
+        if ((size_t)h.dfdOffset + 4 + 24 + samples * 16 > size) samples = 0;
+
+        h.basis = h.vkFormat == 0 && (colorModel == kModelETC1S || colorModel == kModelUASTC);
+        if (colorModel == kModelETC1S) {
+            mHasAlpha = samples > 1;               // RGB slice, then alpha slice
+        } else if (colorModel == kModelUASTC && samples > 0) {
+            uint8_t channel = dfd[24 + 3] & 0x0F;  // 3 = RGBA, 5 = RRRG
+            mHasAlpha = channel == 3 || channel == 5;
+        } else {
+            mHasAlpha = true;
+        }
+    }
+
+    static PixelFormat fromVkFormat(uint32_t vkFormat) {
+        switch (vkFormat) {
+            case 37: case 43:   return PixelFormat::RGBA8;       // R8G8B8A8 UNORM / SRGB
+            case 133: case 134: return PixelFormat::BC1;         // BC1 RGBA
+            case 131: case 132: return PixelFormat::BC1;         // BC1 RGB
+            case 137: case 138: return PixelFormat::BC3;
+            case 145: case 146: return PixelFormat::BC7;
+            case 147: case 148: return PixelFormat::ETC2_RGB8;
+            case 151: case 152: return PixelFormat::ETC2_RGBA8;
+            case 157: case 158: return PixelFormat::ASTC_4x4;
+            default:            return PixelFormat::R8;          // Not supported
+        }
+    }
+
+    bool copyLevels(const uint8_t* data, size_t size, const Header& h, int levelCount) {
+        if (h.supercompression != 0) {
+            printf("[WebKTX2] %s: supercompression %u needs a Basis transcoder\n",
+                   mUrl.c_str(), h.supercompression);
+            return false;
+        }
+        mFormat = fromVkFormat(h.vkFormat);
+        if (mFormat == PixelFormat::R8) {
+            printf("[WebKTX2] %s: unsupported vkFormat %u\n", mUrl.c_str(), h.vkFormat);
+            return false;
+        }
+        if (!supportsFormat(mFormat)) {
+            printf("[WebKTX2] %s: device has no %s support\n", mUrl.c_str(), formatName(mFormat));
+            return false;
+        }
+
+        size_t total = 0;
+        mLevels.resize(levelCount);
+        for (int i = 0; i < levelCount; i++) {
+            const uint8_t* entry = data + kHeaderSize + i * kLevelIndexEntrySize;
+            uint64_t offset = readU64(entry);
+            uint64_t length = readU64(entry + 8);
+            Level& lvl = mLevels[i];
+            lvl.width = std::max(1, mWidth >> i);
+            lvl.height = std::max(1, mHeight >> i);
+            size_t expected = compressed() ? compressedImageBytes(mFormat, lvl.width, lvl.height)
+                                           : size_t(lvl.width) * lvl.height * 4;
+            if (offset > size || length > size - offset || length < expected) {
+                printf("[WebKTX2] %s: level %d out of bounds\n", mUrl.c_str(), i);
+                mLevels.clear();
+                return false;
+            }
+            lvl.offset = total;
+            lvl.size = expected;
+            total += expected;
+        }
+
+        mData.resize(total);
+        for (int i = 0; i < levelCount; i++) {
+            uint64_t offset = readU64(data + kHeaderSize + i * kLevelIndexEntrySize);
+            memcpy(mData.data() + mLevels[i].offset, data + offset, mLevels[i].size);
+        }
+        return true;
+    }
+
+    bool transcode(const uint8_t* data, size_t size, int levelCount) {
+        const Transcoder& custom = customTranscoder();
+        bool ok = custom ? custom(data, size, mFormat, levelCount, mData, mLevels)
+                         : transcodeJS(data, size, mFormat, levelCount, mData, mLevels);
+        if (!ok || mLevels.empty()) {
+            printf("[WebKTX2] %s: Basis transcode to %s failed%s\n", mUrl.c_str(),
+                   formatName(mFormat), custom ? "" : " (is Module.basisTranscoder set?)");
+            mData.clear();
+            mLevels.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // basis_transcoder.js transcoder_texture_format values
+    static int basisFormat(PixelFormat format) {
+        switch (format) {
+            case PixelFormat::ETC2_RGB8:  return 0;   // ETC1 decodes as ETC2 RGB
+            case PixelFormat::ETC2_RGBA8: return 1;
+            case PixelFormat::BC1:        return 2;
+            case PixelFormat::BC3:        return 3;
+            case PixelFormat::BC7:        return 6;
+            case PixelFormat::ASTC_4x4:   return 10;
+            default:                      return 13;  // RGBA32
+        }
+    }
+
+    static bool transcodeJS(const uint8_t* data, size_t size, PixelFormat target, int levelCount,
+                            std::vector<uint8_t>& out, std::vector<Level>& levels) {
+#ifdef __EMSCRIPTEN__
+        // Open the file and size every level; the KTX2File stays on Module
+        // until the levels are written
+        std::vector<int32_t> sizes(levelCount, 0);
+        std::vector<int32_t> dims(levelCount * 2, 0);
+        int count = EM_ASM_INT({
+            var basis = Module.basisTranscoder;
+            if (!basis || !basis.KTX2File) return -1;
+            var file = new basis.KTX2File(HEAPU8.subarray($0, $0 + $1));
+            if (!file.isValid() || !file.startTranscoding()) {
+                file.close();
+                file.delete();
+                return -1;
+            }
+            var n = Math.min(file.getLevels(), $3);
+            for (var i = 0; i < n; i++) {
+                var info = file.getImageLevelInfo(i, 0, 0);
+                HEAP32[($5 >> 2) + i * 2] = info.origWidth;
+                HEAP32[($5 >> 2) + i * 2 + 1] = info.origHeight;
+                HEAP32[($4 >> 2) + i] = file.getImageTranscodedSizeInBytes(i, 0, 0, $2);
+            }
+            Module._alKTX2File = file;
+            return n;
+        }, data, size, basisFormat(target), levelCount, sizes.data(), dims.data());
+        if (count <= 0) return false;
+
+        size_t total = 0;
+        levels.resize(count);
+        for (int i = 0; i < count; i++) {
+            levels[i].width = dims[i * 2];
+            levels[i].height = dims[i * 2 + 1];
+            levels[i].offset = total;
+            levels[i].size = (size_t)sizes[i];
+            total += levels[i].size;
+        }
+        out.resize(total);
+
+        int ok = EM_ASM_INT({
+            var file = Module._alKTX2File;
+            Module._alKTX2File = null;
+            var ok = 1;
+            for (var i = 0; i < $3 && ok; i++) {
+                var offset = HEAP32[($4 >> 2) + i * 2];
+                var length = HEAP32[($4 >> 2) + i * 2 + 1];
+                var dst = HEAPU8.subarray($0 + offset, $0 + offset + length);
+                ok = file.transcodeImage(dst, i, 0, 0, $2, 0, -1, -1) ? 1 : 0;
+            }
+            file.close();
+            file.delete();
+            return ok;
+        }, out.data(), total, basisFormat(target), count, packRanges(levels).data());
+        return ok != 0;
+#else
+        (void)data; (void)size; (void)target; (void)levelCount; (void)out; (void)levels;
+        return false;
+#endif
+    }
+
+    // Offset / length pairs for the JS side
+    static std::vector<int32_t> packRanges(const std::vector<Level>& levels) {
+        std::vector<int32_t> ranges;
+        ranges.reserve(levels.size() * 2);
+        for (const Level& lvl : levels) {
+            ranges.push_back((int32_t)lvl.offset);
+            ranges.push_back((int32_t)lvl.size);
+        }
+        return ranges;
+    }
+
+    static Transcoder& customTranscoder() {
+        static Transcoder transcoder;
+        return transcoder;
+    }
+
+    std::string mUrl;
+    std::vector<uint8_t> mData;
+    std::vector<Level> mLevels;
+    PixelFormat mFormat = PixelFormat::RGBA8;
+    int mWidth = 0;
+    int mHeight = 0;
+    bool mHasAlpha = false;
+    bool mReady = false;
+    size_t mByteSize = 0;
+    LoadCallback mCallback;
+    float mPriority = 0.0f;
+    AssetLoader::Ticket mTicket = 0;
+};
+
+} // namespace al
+
+#endif // AL_WEB_KTX2_HPP
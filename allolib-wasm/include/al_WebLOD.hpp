@@ -21,6 +21,16 @@
  *
  *   // Or use automatic selection
  *   lodMesh.draw(g, objectPos, nav().pos());
+ *
+ * LODGroup culls objects against the view frustum and, optionally, a
+ * coarse CPU occlusion buffer before drawing them.
+ *
+ * Generated levels are cached on disk (IDBFS at /lodcache in the browser),
+ * keyed by a hash of the source mesh and LOD settings, so each chain is only
+ * simplified once. See LODMesh::setCacheDirectory().
+ *
+ * Every level is simplified from LOD 0, so generate() builds them in
+ * parallel on the JobSystem pool in threaded builds (al_WebJobs.hpp).
  */
 
 #ifndef AL_WEB_LOD_HPP
@@ -33,11 +43,21 @@
 #include <unordered_set>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 #include <functional>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
 
 #include "al/graphics/al_Mesh.hpp"
 #include "al/graphics/al_Graphics.hpp"
 #include "al/math/al_Vec.hpp"
+#include "al_WebJobs.hpp"
+#include "al_WebMeshOptimize.hpp"
 
 namespace al {
 
@@ -111,6 +131,18 @@ struct EdgeCollapse {
     }
 };
 
+/**
+ * Optional controls for MeshSimplifier::simplify
+ */
+struct SimplifyOptions {
+    /// Per input vertex, nonzero = never moved or collapsed (indexed input only)
+    const std::vector<uint8_t>* lockedVertices = nullptr;
+    /// Receives the largest geometric error (model units) of any collapse
+    float* resultError = nullptr;
+    /// Print the [Simplify] summary lines
+    bool verbose = true;
+};
+
 /**
  * Mesh simplifier using quadric error metrics with topological constraints
  *
@@ -119,6 +151,14 @@ struct EdgeCollapse {
  * - Triangle flip prevention (checks normal direction before collapse)
  * - Minimum triangle quality enforcement
  * - Proper vertex attribute interpolation
+ *
+ * Working data is flat arrays sized up front: CSR vertex-to-triangle
+ * adjacency, one quadric per vertex and a binary heap of edges. A collapse
+ * appends the survivor's merged, still-valid triangle list to the end of
+ * the adjacency pool and points the survivor at it. Heap entries are
+ * invalidated lazily: one popped after a collapse touched either endpoint
+ * (detected by per-vertex stamps) is re-costed against the survivors and
+ * pushed back instead of being acted on.
  */
 class MeshSimplifier {
 public:
@@ -128,22 +168,30 @@ public:
      * @param output Output simplified mesh
      * @param targetRatio Ratio of vertices to keep (0.0-1.0)
      */
-    static void simplify(const Mesh& input, Mesh& output, float targetRatio) {
+    static void simplify(const Mesh& input, Mesh& output, float targetRatio,
+                         const SimplifyOptions& options = SimplifyOptions()) {
+        if (options.resultError) *options.resultError = 0.0f;
         if (input.vertices().empty() || targetRatio >= 1.0f) {
             output.copy(input);
             return;
         }
 
+        auto startTime = std::chrono::steady_clock::now();
+
         // Convert non-indexed mesh to indexed form for proper edge collapse
         Mesh working;
         working.copy(input);
         size_t origVerts = working.vertices().size();
         size_t origIndices = working.indices().size();
 
+        const std::vector<uint8_t>* locked = options.lockedVertices;
         if (working.indices().empty() && working.vertices().size() >= 3) {
             working.compress();  // Merge duplicate vertices and create indices
-            printf("[Simplify] compress(): %zu verts -> %zu verts, %zu indices\n",
-                   origVerts, working.vertices().size(), working.indices().size());
+            locked = nullptr;    // Indices no longer match the caller's
+            if (options.verbose) {
+                printf("[Simplify] compress(): %zu verts -> %zu verts, %zu indices\n",
+                       origVerts, working.vertices().size(), working.indices().size());
+            }
         }
 
         // Copy vertices from the (now indexed) working mesh
@@ -152,59 +200,70 @@ public:
         if (!working.normals().empty()) {
             normals.assign(working.normals().begin(), working.normals().end());
         }
+        const int vertexCount = (int)vertices.size();
 
-        // Build triangle list from indices
-        std::vector<std::array<int, 3>> triangles;
-        std::vector<bool> triangleValid;  // Track which triangles are still valid
+        // Flat triangle list: triangle t owns corners 3t..3t+2
+        std::vector<int> corners;
         if (!working.indices().empty()) {
-            for (size_t i = 0; i + 2 < working.indices().size(); i += 3) {
-                triangles.push_back({
-                    (int)working.indices()[i],
-                    (int)working.indices()[i+1],
-                    (int)working.indices()[i+2]
-                });
-                triangleValid.push_back(true);
-            }
+            const auto& indices = working.indices();
+            corners.assign(indices.begin(), indices.begin() + (indices.size() - indices.size() % 3));
         } else {
-            for (size_t i = 0; i + 2 < vertices.size(); i += 3) {
-                triangles.push_back({(int)i, (int)(i+1), (int)(i+2)});
-                triangleValid.push_back(true);
-            }
+            corners.resize(vertices.size() - vertices.size() % 3);
+            for (size_t i = 0; i < corners.size(); i++) corners[i] = (int)i;
         }
+        const int triangleCount = (int)(corners.size() / 3);
 
-        if (triangles.empty()) {
+        if (triangleCount == 0) {
             output.copy(input);
             return;
         }
+        std::vector<uint8_t> triangleValid(triangleCount, 1);
 
         // Compute quadrics for each vertex
-        std::vector<QuadricErrorMetric> quadrics(vertices.size());
-        std::vector<std::unordered_set<int>> vertexTriangles(vertices.size());
-
-        for (size_t ti = 0; ti < triangles.size(); ti++) {
-            auto& tri = triangles[ti];
+        std::vector<QuadricErrorMetric> quadrics(vertexCount);
+        for (int t = 0; t < triangleCount; t++) {
+            const int* tri = &corners[t * 3];
             QuadricErrorMetric q = QuadricErrorMetric::fromTriangle(
                 vertices[tri[0]], vertices[tri[1]], vertices[tri[2]]
             );
-            for (int i = 0; i < 3; i++) {
-                quadrics[tri[i]] += q;
-                vertexTriangles[tri[i]].insert(ti);
+            for (int i = 0; i < 3; i++) quadrics[tri[i]] += q;
+        }
+
+        // CSR adjacency: triangles of vertex v are
+        // adjPool[adjStart[v] .. adjStart[v] + adjCount[v])
+        std::vector<int> adjStart(vertexCount, 0);
+        std::vector<int> adjCount(vertexCount, 0);
+        for (int c : corners) adjCount[c]++;
+        for (int v = 1; v < vertexCount; v++) adjStart[v] = adjStart[v - 1] + adjCount[v - 1];
+        std::vector<int> adjPool;
+        adjPool.reserve(corners.size() * 2);  // Room for merged lists
+        adjPool.resize(corners.size());
+        {
+            std::vector<int> cursor(adjStart);
+            for (size_t i = 0; i < corners.size(); i++) {
+                adjPool[cursor[corners[i]]++] = (int)(i / 3);
             }
         }
 
-        // Build edge map to count edge usage (for boundary detection)
-        std::unordered_map<uint64_t, int> edgeCount;
-        auto edgeKey = [](int a, int b) -> uint64_t {
-            if (a > b) std::swap(a, b);
-            return ((uint64_t)a << 32) | (uint64_t)b;
-        };
+        // vertexMap points collapsed vertices at their survivor
+        std::vector<int> vertexMap(vertexCount);
+        for (int v = 0; v < vertexCount; v++) vertexMap[v] = v;
 
-        for (const auto& tri : triangles) {
-            for (int i = 0; i < 3; i++) {
-                int v1 = tri[i], v2 = tri[(i+1)%3];
-                edgeCount[edgeKey(v1, v2)]++;
+        auto findRoot = [&](int v) {
+            int root = v;
+            while (vertexMap[root] != root) root = vertexMap[root];
+            while (vertexMap[v] != root) {
+                int next = vertexMap[v];
+                vertexMap[v] = root;
+                v = next;
             }
-        }
+            return root;
+        };
+
+        // Indexed rather than by pointer: fn may append to adjPool
+        auto forEachTriangle = [&](int v, auto&& fn) {
+            for (int i = adjStart[v], end = adjStart[v] + adjCount[v]; i < end; i++) fn(adjPool[i]);
+        };
 
         // Helper: compute triangle normal
         auto triangleNormal = [](const Vec3f& v0, const Vec3f& v1, const Vec3f& v2) -> Vec3f {
@@ -213,30 +272,20 @@ public:
             return len > 1e-10f ? n / len : Vec3f(0, 1, 0);
         };
 
-        // Helper: check if collapse would flip any triangle (relaxed check)
-        auto wouldFlipTriangle = [&](int v1, int v2, const Vec3f& newPos,
-                                     const std::vector<int>& vertexMap) -> bool {
-            auto findRoot = [&](int v) {
-                while (vertexMap[v] != v) v = vertexMap[v];
-                return v;
-            };
-
-            // Check all triangles connected to v1 or v2
-            std::unordered_set<int> affectedTris;
-            for (int ti : vertexTriangles[v1]) affectedTris.insert(ti);
-            for (int ti : vertexTriangles[v2]) affectedTris.insert(ti);
-
+        // Helper: check if collapse would flip any triangle (relaxed check).
+        // Triangles shared by v1 and v2 are seen twice but degenerate, so skipped.
+        auto wouldFlipTriangle = [&](int v1, int v2, const Vec3f& newPos) -> bool {
             int flipCount = 0;
-            for (int ti : affectedTris) {
-                if (!triangleValid[ti]) continue;
+            auto check = [&](int ti) {
+                if (flipCount > 1 || !triangleValid[ti]) return;
 
-                auto& tri = triangles[ti];
+                const int* tri = &corners[ti * 3];
                 int i0 = findRoot(tri[0]);
                 int i1 = findRoot(tri[1]);
                 int i2 = findRoot(tri[2]);
 
                 // Skip already degenerate triangles
-                if (i0 == i1 || i1 == i2 || i2 == i0) continue;
+                if (i0 == i1 || i1 == i2 || i2 == i0) return;
 
                 // Get current normal
                 Vec3f oldNormal = triangleNormal(vertices[i0], vertices[i1], vertices[i2]);
@@ -248,134 +297,169 @@ public:
 
                 // Skip if this triangle becomes degenerate (will be removed anyway)
                 if ((p0 - p1).mag() < 1e-8f || (p1 - p2).mag() < 1e-8f || (p2 - p0).mag() < 1e-8f) {
-                    continue;
+                    return;
                 }
 
                 Vec3f newNormal = triangleNormal(p0, p1, p2);
 
                 // Relaxed flip check: allow small negative dot products (numerical precision)
                 // Only reject severe flips (> 90 degree change)
-                if (dot(oldNormal, newNormal) < -0.2f) {
-                    flipCount++;
-                    if (flipCount > 1) {
-                        return true;  // Multiple flips - definitely bad
-                    }
-                }
-            }
-            return false;  // Allow collapse
+                if (dot(oldNormal, newNormal) < -0.2f) flipCount++;
+            };
+            forEachTriangle(v1, check);
+            forEachTriangle(v2, check);
+            return flipCount > 1;  // Multiple flips - definitely bad
         };
 
-        // Build priority queue with boundary penalty
-        std::priority_queue<EdgeCollapse, std::vector<EdgeCollapse>, std::greater<EdgeCollapse>> pq;
-        std::unordered_set<uint64_t> processedEdges;
-
         const float BOUNDARY_PENALTY = 100.0f;  // Heavy penalty for boundary edges
 
-        for (const auto& tri : triangles) {
-            for (int i = 0; i < 3; i++) {
-                int v1 = tri[i], v2 = tri[(i+1)%3];
-                uint64_t key = edgeKey(v1, v2);
-                if (processedEdges.find(key) == processedEdges.end()) {
-                    processedEdges.insert(key);
-
-                    QuadricErrorMetric combined = quadrics[v1] + quadrics[v2];
-                    Vec3f newPos = combined.optimalPoint(vertices[v1], vertices[v2]);
-                    float error = combined.error(newPos);
-
-                    // Check if this is a boundary edge (only 1 adjacent triangle)
-                    bool isBoundary = (edgeCount[key] == 1);
-                    if (isBoundary) {
-                        error += BOUNDARY_PENALTY;  // Penalize boundary edges
-                    }
-
-                    // Add edge length factor to prefer collapsing short edges
-                    float edgeLen = (vertices[v1] - vertices[v2]).mag();
-                    error += edgeLen * 0.1f;
+        auto edgeCost = [&](int v1, int v2, bool isBoundary) {
+            QuadricErrorMetric combined = quadrics[v1] + quadrics[v2];
+            float error = combined.error(combined.optimalPoint(vertices[v1], vertices[v2]));
+            if (isBoundary) error += BOUNDARY_PENALTY;  // Penalize boundary edges
+            // Add edge length factor to prefer collapsing short edges
+            return error + (vertices[v1] - vertices[v2]).mag() * 0.1f;
+        };
 
-                    pq.push({v1, v2, error, newPos, isBoundary});
-                }
+        // Boundary edges are used by exactly one triangle. Sorting all edge
+        // keys counts them without a hash map and yields the unique edges.
+        auto edgeKey = [](int a, int b) -> uint64_t {
+            if (a > b) std::swap(a, b);
+            return ((uint64_t)a << 32) | (uint64_t)(uint32_t)b;
+        };
+        std::vector<uint64_t> edgeKeys;
+        edgeKeys.reserve(corners.size());
+        for (int t = 0; t < triangleCount; t++) {
+            for (int i = 0; i < 3; i++) {
+                edgeKeys.push_back(edgeKey(corners[t * 3 + i], corners[t * 3 + (i + 1) % 3]));
             }
         }
+        std::sort(edgeKeys.begin(), edgeKeys.end());
 
-        // Collapse edges until target reached
-        std::vector<int> vertexMap(vertices.size());
-        for (size_t i = 0; i < vertices.size(); i++) vertexMap[i] = i;
-
-        auto findRoot = [&](int v) {
-            while (vertexMap[v] != v) v = vertexMap[v];
-            return v;
+        // Build the heap with a single O(E) make_heap
+        auto isLocked = [&](int v) {
+            return locked && v < (int)locked->size() && (*locked)[v];
         };
+        std::vector<HeapEdge> heap;
+        heap.reserve(edgeKeys.size() / 2 + 1);
+        for (size_t i = 0; i < edgeKeys.size();) {
+            size_t j = i + 1;
+            while (j < edgeKeys.size() && edgeKeys[j] == edgeKeys[i]) j++;
+            int v1 = (int)(edgeKeys[i] >> 32);
+            int v2 = (int)(uint32_t)edgeKeys[i];
+            bool isBoundary = (j - i) == 1;
+            if (isLocked(v1) || isLocked(v2)) {
+                i = j;
+                continue;  // Locked vertices never move
+            }
+            heap.push_back({edgeCost(v1, v2, isBoundary), v1, v2, 0, 0, isBoundary});
+            i = j;
+        }
+        std::vector<uint64_t>().swap(edgeKeys);
+        std::make_heap(heap.begin(), heap.end(), HeapOrder());
 
-        int targetTriangles = std::max(4, (int)(triangles.size() * targetRatio));
-        int currentTriangles = triangles.size();
+        // Bumped whenever a vertex survives a collapse; heap entries carry
+        // the stamps they were costed with
+        std::vector<uint32_t> vertexStamp(vertexCount, 0);
+
+        int targetTriangles = std::max(4, (int)(triangleCount * targetRatio));
+        int currentTriangles = triangleCount;
         int skippedFlips = 0;
         int collapseCount = 0;
-        int skippedAlreadyCollapsed = 0;
-
-        printf("[Simplify] Target: %d triangles (from %d, ratio %.2f)\n",
-               targetTriangles, currentTriangles, targetRatio);
+        int skippedStale = 0;
+        int recosted = 0;
+        float maxError = 0.0f;
 
-        while (!pq.empty() && currentTriangles > targetTriangles) {
-            EdgeCollapse collapse = pq.top();
-            pq.pop();
+        if (options.verbose) {
+            printf("[Simplify] Target: %d triangles (from %d, ratio %.2f)\n",
+                   targetTriangles, currentTriangles, targetRatio);
+        }
 
-            int v1 = findRoot(collapse.v1);
-            int v2 = findRoot(collapse.v2);
+        while (!heap.empty() && currentTriangles > targetTriangles) {
+            std::pop_heap(heap.begin(), heap.end(), HeapOrder());
+            HeapEdge edge = heap.back();
+            heap.pop_back();
 
+            int v1 = findRoot(edge.v1);
+            int v2 = findRoot(edge.v2);
             if (v1 == v2) {
-                skippedAlreadyCollapsed++;
+                skippedStale++;
                 continue;  // Already collapsed
             }
+            if (v1 != edge.v1 || v2 != edge.v2 ||
+                vertexStamp[v1] != edge.stamp1 || vertexStamp[v2] != edge.stamp2) {
+                // A collapse moved an endpoint since this was costed
+                recosted++;
+                heap.push_back({edgeCost(v1, v2, edge.isBoundary), v1, v2,
+                                vertexStamp[v1], vertexStamp[v2], edge.isBoundary});
+                std::push_heap(heap.begin(), heap.end(), HeapOrder());
+                continue;
+            }
+
+            Vec3f newPos = (quadrics[v1] + quadrics[v2]).optimalPoint(vertices[v1], vertices[v2]);
 
             // Check if this collapse would flip any triangles
-            if (wouldFlipTriangle(v1, v2, collapse.newPos, vertexMap)) {
+            if (wouldFlipTriangle(v1, v2, newPos)) {
                 skippedFlips++;
                 continue;  // Skip this collapse
             }
 
-            collapseCount++;
-
             // Perform the collapse: v2 -> v1
-            vertices[v1] = collapse.newPos;
+            float collapseError = (quadrics[v1] + quadrics[v2]).error(newPos);
+            maxError = std::max(maxError, std::sqrt(std::max(0.0f, collapseError)));
+            vertices[v1] = newPos;
             if (!normals.empty() && v1 < (int)normals.size() && v2 < (int)normals.size()) {
                 normals[v1] = (normals[v1] + normals[v2]).normalize();
             }
-            quadrics[v1] = quadrics[v1] + quadrics[v2];
+            quadrics[v1] += quadrics[v2];
             vertexMap[v2] = v1;
-
-            // Mark degenerate triangles as invalid and count remaining
-            for (int ti : vertexTriangles[v2]) {
-                vertexTriangles[v1].insert(ti);
-            }
-
-            // Count how many triangles become degenerate
-            for (int ti : vertexTriangles[v1]) {
-                if (!triangleValid[ti]) continue;
-                auto& tri = triangles[ti];
-                int i0 = findRoot(tri[0]);
-                int i1 = findRoot(tri[1]);
-                int i2 = findRoot(tri[2]);
-                if (i0 == i1 || i1 == i2 || i2 == i0) {
-                    triangleValid[ti] = false;
+            vertexStamp[v1]++;
+
+            // Merge both lists into a fresh span, dropping triangles that
+            // became degenerate (which includes every one they shared)
+            int mergedStart = (int)adjPool.size();
+            auto merge = [&](int ti) {
+                if (!triangleValid[ti]) return;
+                const int* tri = &corners[ti * 3];
+                int roots[3] = {findRoot(tri[0]), findRoot(tri[1]), findRoot(tri[2])};
+                if (roots[0] == roots[1] || roots[1] == roots[2] || roots[2] == roots[0]) {
+                    triangleValid[ti] = 0;
                     currentTriangles--;
+                    return;
                 }
-            }
+                adjPool.push_back(ti);
+            };
+            forEachTriangle(v1, merge);
+            forEachTriangle(v2, merge);
+            adjStart[v1] = mergedStart;
+            adjCount[v1] = (int)adjPool.size() - mergedStart;
+            adjCount[v2] = 0;
+
+            collapseCount++;
         }
 
-        printf("[Simplify] Done: %d collapses, %d skipped (flips), %d skipped (already), %d tris remaining\n",
-               collapseCount, skippedFlips, skippedAlreadyCollapsed, currentTriangles);
+        if (options.resultError) *options.resultError = maxError;
+        if (options.verbose) {
+            double elapsedMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - startTime).count();
+            printf("[Simplify] Done: %d collapses, %d skipped (flips), %d skipped (already), "
+                   "%d re-costed, %d tris remaining\n",
+                   collapseCount, skippedFlips, skippedStale, recosted, currentTriangles);
+            printf("[Simplify] %d tris in %.1f ms (%.2f Mtris/s)\n", triangleCount, elapsedMs,
+                   elapsedMs > 0.0 ? triangleCount / (elapsedMs * 1000.0) : 0.0);
+        }
 
         // Rebuild mesh with remaining valid triangles
         output.reset();
         output.primitive(Mesh::TRIANGLES);
 
-        std::unordered_map<int, int> newIndices;
+        std::vector<int> newIndices(vertexCount, -1);
         int nextIndex = 0;
 
-        for (size_t ti = 0; ti < triangles.size(); ti++) {
+        for (int ti = 0; ti < triangleCount; ti++) {
             if (!triangleValid[ti]) continue;
 
-            const auto& tri = triangles[ti];
+            const int* tri = &corners[ti * 3];
             int i0 = findRoot(tri[0]);
             int i1 = findRoot(tri[1]);
             int i2 = findRoot(tri[2]);
@@ -384,7 +468,7 @@ public:
             if (i0 == i1 || i1 == i2 || i2 == i0) continue;
 
             for (int idx : {i0, i1, i2}) {
-                if (newIndices.find(idx) == newIndices.end()) {
+                if (newIndices[idx] < 0) {
                     newIndices[idx] = nextIndex++;
                     output.vertex(vertices[idx]);
                     if (!normals.empty() && idx < (int)normals.size()) {
@@ -400,6 +484,21 @@ public:
             output.generateNormals();
         }
     }
+
+private:
+    /// Collapse candidate in the edge heap; stale once either endpoint's
+    /// stamp has moved on
+    struct HeapEdge {
+        float error;
+        int v1, v2;
+        uint32_t stamp1, stamp2;
+        bool isBoundary;      // Used by one triangle; kept through re-costing
+    };
+
+    // Min-heap on error for std::push_heap/pop_heap (a functor so it inlines)
+    struct HeapOrder {
+        bool operator()(const HeapEdge& a, const HeapEdge& b) const { return a.error > b.error; }
+    };
 };
 
 /**
@@ -412,6 +511,7 @@ public:
         float maxDistance;      // Max distance for this LOD
         float screenCoverage;   // Min screen coverage for this LOD
         int triangleCount;
+        float acmr = 0.0f;      // Vertex cache misses per triangle
     };
 
     LODMesh() : mBias(1.0f) {}
@@ -429,16 +529,23 @@ public:
      * for efficient culling at extreme distances.
      */
     void generate(const Mesh& source, int levels = 4, float reductionFactor = 0.5f) {
+        beginGenerate(source, levels, reductionFactor);
+        generateRemaining();
+    }
+
+    /**
+     * Incremental form of generate(): copies the source into LOD 0 and plans
+     * the remaining levels, which generateStep() then simplifies one at a
+     * time. ready() stays false until the last level is done.
+     */
+    void beginGenerate(const Mesh& source, int levels = 4, float reductionFactor = 0.5f) {
         // Clamp levels to reasonable range
         levels = std::max(1, std::min(levels, 16));
 
         mLevels.clear();
         mLevels.resize(levels);
-
-        // Calculate source triangle count
-        int sourceTriangles = source.indices().empty()
-            ? source.vertices().size() / 3
-            : source.indices().size() / 3;
+        mRatios.assign(levels, 1.0f);
+        mNextLevel = 0;
 
         // For many levels, adjust reduction factor to spread out more gradually
         float effectiveReduction = reductionFactor;
@@ -449,15 +556,10 @@ public:
             effectiveReduction = std::max(effectiveReduction, 0.5f);  // Don't go above 0.5
         }
 
-        // Generate LOD levels with progressive simplification
+        // Plan progressive simplification
         float ratio = 1.0f;
         for (int i = 0; i < levels; i++) {
-            if (i == 0) {
-                // LOD 0: TRUE FULL QUALITY - preserve exact original mesh unchanged
-                // Do NOT call compress() as it can merge vertices and lose detail
-                mLevels[i].mesh.copy(source);
-            } else {
-                // LOD 1+: Simplified versions
+            if (i > 0) {
                 ratio *= effectiveReduction;
 
                 // For the last few levels, go very aggressive
@@ -467,16 +569,9 @@ public:
 
                 // Minimum ratio floor - allow very low for high level counts
                 float minRatio = (levels > 8) ? 0.001f : 0.01f;
-                float effectiveRatio = std::max(ratio, minRatio);
-
-                MeshSimplifier::simplify(source, mLevels[i].mesh, effectiveRatio);
+                mRatios[i] = std::max(ratio, minRatio);
             }
 
-            // Calculate triangle count (handle both indexed and non-indexed)
-            mLevels[i].triangleCount = mLevels[i].mesh.indices().empty()
-                ? mLevels[i].mesh.vertices().size() / 3
-                : mLevels[i].mesh.indices().size() / 3;
-
             // Set distance thresholds - spread more for more levels
             // Use sqrt for more gradual spacing with many levels
             float distMultiplier = (levels > 4) ? powf(1.5f, i) : powf(2.0f, i);
@@ -484,31 +579,119 @@ public:
             mLevels[i].screenCoverage = 0.5f / distMultiplier;
         }
 
-        // Print LOD generation summary
-        printf("[LODMesh] Generated %d levels: ", levels);
-        for (int i = 0; i < levels; i++) {
-            printf("%d tris%s", mLevels[i].triangleCount, i < levels-1 ? " -> " : "\n");
+        // LOD 0: TRUE FULL QUALITY - preserve exact original mesh unchanged
+        // Do NOT call compress() as it can merge vertices and lose detail
+        mLevels[0].mesh.copy(source);
+        computeBounds(source);
+
+        // Reuse levels simplified in an earlier session
+        mCacheKey = (levels > 1 && !cacheDirectory().empty())
+            ? contentKey(source, levels, reductionFactor) : 0;
+        if (mCacheKey && loadCached()) {
+            mNextLevel = levels;
+            printf("[LODMesh] Loaded %d levels from %s\n", levels, cachePath(mCacheKey).c_str());
+            return;
         }
+
+        finishLevel(0);
+    }
+
+    /**
+     * Simplify the next pending level (from LOD 0, the unchanged source)
+     * @return true while levels remain
+     */
+    bool generateStep() {
+        if (!generating()) return false;
+        int i = mNextLevel;
+        simplifyLevel(i);
+        finishLevel(i);
+        return generating();
+    }
+
+    /**
+     * Simplify every pending level at once, one job per level on the
+     * JobSystem pool (inline without one)
+     */
+    void generateRemaining() {
+        const int first = mNextLevel;
+        const int last = (int)mLevels.size();
+        if (first >= last) return;
+        JobSystem::instance().parallelFor(first, last, 1, [this](int begin, int end) {
+            for (int i = begin; i < end; i++) simplifyLevel(i);
+        });
+        for (int i = first; i < last; i++) finishLevel(i);
     }
 
+    /// beginGenerate() was called and levels remain to be simplified
+    bool generating() const { return mNextLevel < (int)mLevels.size(); }
+
     /**
      * Generate LOD levels with custom ratios
      */
     void generate(const Mesh& source, const std::vector<float>& ratios) {
         mLevels.clear();
         mLevels.resize(ratios.size());
-
-        for (size_t i = 0; i < ratios.size(); i++) {
-            if (ratios[i] >= 1.0f) {
-                mLevels[i].mesh.copy(source);
-            } else {
-                MeshSimplifier::simplify(source, mLevels[i].mesh, ratios[i]);
+        computeBounds(source);
+
+        JobSystem::instance().parallelFor(0, (int)ratios.size(), 1, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                if (ratios[i] >= 1.0f) {
+                    mLevels[i].mesh.copy(source);
+                } else {
+                    MeshSimplifier::simplify(source, mLevels[i].mesh, ratios[i]);
+                    if (MeshOptimizer::autoOptimize()) MeshOptimizer::optimize(mLevels[i].mesh);
+                }
             }
+        });
 
-            mLevels[i].triangleCount = mLevels[i].mesh.vertices().size() / 3;
+        for (size_t i = 0; i < ratios.size(); i++) {
+            mLevels[i].triangleCount = countTriangles(mLevels[i].mesh);
+            mLevels[i].acmr = levelACMR(mLevels[i].mesh);
             mLevels[i].maxDistance = 10.0f * powf(2.0f, i);
             mLevels[i].screenCoverage = 0.5f / powf(2.0f, i);
         }
+        mNextLevel = (int)mLevels.size();
+        mCacheKey = 0;
+    }
+
+    // ── Disk Cache ──
+
+    /**
+     * Directory generated levels are persisted to. Defaults to /lodcache,
+     * which runtime.ts mounts as IDBFS and restores before main(); native
+     * builds default to empty, which disables the cache.
+     */
+    static void setCacheDirectory(const std::string& dir) { cacheDirectory() = dir; }
+    static std::string& cacheDirectory() {
+#ifdef __EMSCRIPTEN__
+        static std::string dir = "/lodcache";
+#else
+        static std::string dir;
+#endif
+        return dir;
+    }
+
+    /**
+     * 64-bit FNV-1a over the source geometry and the settings that shape
+     * the chain, so edited meshes or changed settings miss the cache.
+     */
+    static uint64_t contentKey(const Mesh& source, int levels, float reductionFactor) {
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](const void* data, size_t bytes) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < bytes; i++) {
+                h ^= p[i];
+                h *= 1099511628211ull;
+            }
+        };
+        const uint32_t header[4] = { kCacheVersion, (uint32_t)source.primitive(),
+                                     (uint32_t)levels, 0 };
+        mix(header, sizeof(header));
+        mix(&reductionFactor, sizeof(reductionFactor));
+        mix(source.vertices().data(), source.vertices().size() * sizeof(Vec3f));
+        mix(source.normals().data(), source.normals().size() * sizeof(Vec3f));
+        mix(source.indices().data(), source.indices().size() * sizeof(unsigned int));
+        return h ? h : 1;
     }
 
     /**
@@ -589,24 +772,380 @@ public:
         i = std::max(0, std::min(i, (int)mLevels.size() - 1));
         return mLevels[i].mesh;
     }
+    const LODLevel& levelInfo(int i) const {
+        i = std::max(0, std::min(i, (int)mLevels.size() - 1));
+        return mLevels[i];
+    }
 
     /**
      * Get LOD stats
      */
     int triangleCount(int level) const { return mLevels[level].triangleCount; }
+    /// Post-transform cache misses per triangle (3.0 for non-indexed levels)
+    float acmr(int level) const { return mLevels[level].acmr; }
+
+    /**
+     * Check if LOD data exists (and incremental generation has finished)
+     */
+    bool ready() const { return !mLevels.empty() && !generating(); }
 
     /**
-     * Check if LOD data exists
+     * Bounding sphere of the source mesh in model space (for culling)
      */
-    bool ready() const { return !mLevels.empty(); }
+    const Vec3f& boundingCenter() const { return mBoundingCenter; }
+    float boundingRadius() const { return mBoundingRadius; }
 
 private:
+    void computeBounds(const Mesh& source) {
+        const auto& verts = source.vertices();
+        if (verts.empty()) {
+            mBoundingCenter = Vec3f(0, 0, 0);
+            mBoundingRadius = 0.0f;
+            return;
+        }
+        Vec3f minB = verts[0], maxB = verts[0];
+        for (const auto& v : verts) {
+            minB.x = std::min(minB.x, v.x); maxB.x = std::max(maxB.x, v.x);
+            minB.y = std::min(minB.y, v.y); maxB.y = std::max(maxB.y, v.y);
+            minB.z = std::min(minB.z, v.z); maxB.z = std::max(maxB.z, v.z);
+        }
+        mBoundingCenter = (minB + maxB) * 0.5f;
+        mBoundingRadius = (maxB - minB).mag() * 0.5f;
+    }
+
+    // Handles both indexed and non-indexed levels
+    static int countTriangles(const Mesh& m) {
+        return m.indices().empty() ? m.vertices().size() / 3 : m.indices().size() / 3;
+    }
+    static float levelACMR(const Mesh& m) {
+        if (m.indices().empty()) return m.vertices().empty() ? 0.0f : 3.0f;
+        return MeshOptimizer::acmr(m.indices(), (int)m.vertices().size());
+    }
+
+    // Level i from LOD 0; touches only level i, so levels can run in parallel
+    void simplifyLevel(int i) {
+        MeshSimplifier::simplify(mLevels[0].mesh, mLevels[i].mesh, mRatios[i]);
+        if (MeshOptimizer::autoOptimize()) MeshOptimizer::optimize(mLevels[i].mesh);
+    }
+
+    void finishLevel(int i) {
+        mLevels[i].triangleCount = countTriangles(mLevels[i].mesh);
+        mLevels[i].acmr = levelACMR(mLevels[i].mesh);
+        mNextLevel = i + 1;
+
+        if (!generating()) {
+            // Print LOD generation summary
+            int levels = (int)mLevels.size();
+            printf("[LODMesh] Generated %d levels: ", levels);
+            for (int l = 0; l < levels; l++) {
+                printf("%d tris (ACMR %.2f)%s", mLevels[l].triangleCount, mLevels[l].acmr,
+                       l < levels-1 ? " -> " : "\n");
+            }
+            if (mCacheKey) storeCached();
+        }
+    }
+
+    // Cache file: header, then for each level past LOD 0 its vertex, normal
+    // and index arrays, each prefixed by a uint32 count
+    static constexpr uint32_t kCacheMagic = 0x444F4C41;  // "ALOD"
+    static constexpr uint32_t kCacheVersion = 2;  // 2: levels stored cache-optimized
+
+    static std::string cachePath(uint64_t key) {
+        char name[32];
+        snprintf(name, sizeof(name), "/%016llx.lod", (unsigned long long)key);
+        return cacheDirectory() + name;
+    }
+
+    template <typename T>
+    static void writeArray(FILE* f, const std::vector<T>& v) {
+        uint32_t n = (uint32_t)v.size();
+        fwrite(&n, sizeof(n), 1, f);
+        if (n) fwrite(v.data(), sizeof(T), n, f);
+    }
+
+    template <typename T>
+    static bool readArray(FILE* f, std::vector<T>& v) {
+        uint32_t n = 0;
+        if (fread(&n, sizeof(n), 1, f) != 1) return false;
+        v.resize(n);
+        return n == 0 || fread(v.data(), sizeof(T), n, f) == n;
+    }
+
+    bool loadCached() {
+        FILE* f = fopen(cachePath(mCacheKey).c_str(), "rb");
+        if (!f) return false;
+
+        uint32_t magic = 0, version = 0, levels = 0;
+        uint64_t key = 0;
+        bool ok = fread(&magic, sizeof(magic), 1, f) == 1 &&
+                  fread(&version, sizeof(version), 1, f) == 1 &&
+                  fread(&key, sizeof(key), 1, f) == 1 &&
+                  fread(&levels, sizeof(levels), 1, f) == 1 &&
+                  magic == kCacheMagic && version == kCacheVersion &&
+                  key == mCacheKey && levels == mLevels.size();
+
+        for (size_t i = 1; ok && i < mLevels.size(); i++) {
+            Mesh& m = mLevels[i].mesh;
+            m.reset();
+            m.primitive(Mesh::TRIANGLES);
+            ok = readArray(f, m.vertices()) && readArray(f, m.normals()) &&
+                 readArray(f, m.indices());
+            mLevels[i].triangleCount = countTriangles(m);
+            mLevels[i].acmr = levelACMR(m);
+        }
+        fclose(f);
+
+        if (!ok) {
+            // Truncated or stale: rebuild, which overwrites the file
+            for (size_t i = 1; i < mLevels.size(); i++) mLevels[i].mesh.reset();
+            return false;
+        }
+        mLevels[0].triangleCount = countTriangles(mLevels[0].mesh);
+        mLevels[0].acmr = levelACMR(mLevels[0].mesh);
+        return true;
+    }
+
+    void storeCached() const {
+        std::string path = cachePath(mCacheKey);
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) {
+            printf("[LODMesh] Cannot write LOD cache %s\n", path.c_str());
+            return;
+        }
+
+        uint32_t levels = (uint32_t)mLevels.size();
+        fwrite(&kCacheMagic, sizeof(kCacheMagic), 1, f);
+        fwrite(&kCacheVersion, sizeof(kCacheVersion), 1, f);
+        fwrite(&mCacheKey, sizeof(mCacheKey), 1, f);
+        fwrite(&levels, sizeof(levels), 1, f);
+        for (size_t i = 1; i < mLevels.size(); i++) {
+            const Mesh& m = mLevels[i].mesh;
+            writeArray(f, m.vertices());
+            writeArray(f, m.normals());
+            writeArray(f, m.indices());
+        }
+        fclose(f);
+
+#ifdef __EMSCRIPTEN__
+        // Persist to IndexedDB so the next page load skips simplification
+        EM_ASM({
+            if (typeof FS !== 'undefined' && FS.syncfs) {
+                FS.syncfs(false, function(err) {
+                    if (err) console.warn('[IDBFS] LOD cache persist failed:', err);
+                });
+            }
+        });
+#endif
+    }
+
     std::vector<LODLevel> mLevels;
+    std::vector<float> mRatios;  // Simplification ratio per level (beginGenerate)
+    int mNextLevel = 0;          // First level generateStep() has yet to build
+    uint64_t mCacheKey = 0;      // contentKey() of the chain, 0 = not cached
+    Vec3f mBoundingCenter{0, 0, 0};
+    float mBoundingRadius = 0.0f;
     float mBias;
 };
 
+/**
+ * View frustum as six inward-facing planes (ax + by + cz + d >= 0 inside)
+ */
+struct ViewFrustum {
+    float planes[6][4];
+
+    /// Extract planes from a world-to-clip matrix (Gribb & Hartmann)
+    void fromMatrix(const Mat4f& viewProj) {
+        const Mat4f& m = viewProj;
+        for (int i = 0; i < 3; i++) {
+            for (int c = 0; c < 4; c++) {
+                planes[i * 2][c]     = m(3, c) + m(i, c);
+                planes[i * 2 + 1][c] = m(3, c) - m(i, c);
+            }
+        }
+        for (auto& p : planes) {
+            float len = std::sqrt(p[0]*p[0] + p[1]*p[1] + p[2]*p[2]);
+            if (len > 0.0f) {
+                for (int c = 0; c < 4; c++) p[c] /= len;
+            }
+        }
+    }
+
+    bool sphereVisible(const Vec3f& center, float radius) const {
+        for (const auto& p : planes) {
+            if (p[0]*center.x + p[1]*center.y + p[2]*center.z + p[3] < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * Coarse CPU depth buffer for occlusion culling
+ *
+ * Occluder meshes are rasterized at low resolution (point-sampled at texel
+ * centers, so slightly optimistic at silhouettes), then reduced into a
+ * max-depth pyramid. A bounding sphere is occluded when its nearest depth
+ * lies behind every pyramid texel its screen rectangle touches.
+ */
+class OcclusionBuffer {
+public:
+    void resize(int width, int height) {
+        mWidth = std::max(1, width);
+        mHeight = std::max(1, height);
+        mLevels.clear();
+        mLevelSize.clear();
+        int w = mWidth, h = mHeight;
+        while (true) {
+            mLevels.emplace_back((size_t)w * h, 1.0f);
+            mLevelSize.push_back({w, h});
+            if (w == 1 && h == 1) break;
+            w = std::max(1, (w + 1) / 2);
+            h = std::max(1, (h + 1) / 2);
+        }
+    }
+
+    int width() const { return mWidth; }
+    int height() const { return mHeight; }
+
+    /// Reset to far depth and set the world-to-clip matrix for this frame
+    void begin(const Mat4f& viewProj) {
+        if (mLevels.empty()) resize(mWidth, mHeight);
+        std::fill(mLevels[0].begin(), mLevels[0].end(), 1.0f);
+        mViewProj = viewProj;
+    }
+
+    /// Rasterize a mesh placed at pos with uniform scale (triangles only)
+    void rasterize(const Mesh& mesh, const Vec3f& pos, float scale) {
+        const auto& verts = mesh.vertices();
+        const auto& indices = mesh.indices();
+        size_t count = indices.empty() ? verts.size() : indices.size();
+
+        mScreen.resize(verts.size());
+        for (size_t i = 0; i < verts.size(); i++) {
+            mScreen[i] = project(pos + verts[i] * scale);
+        }
+
+        for (size_t t = 0; t + 2 < count; t += 3) {
+            const Vec4f& a = mScreen[indices.empty() ? t     : indices[t]];
+            const Vec4f& b = mScreen[indices.empty() ? t + 1 : indices[t + 1]];
+            const Vec4f& c = mScreen[indices.empty() ? t + 2 : indices[t + 2]];
+            // Skip triangles crossing the near plane; dropping an occluder is safe
+            if (a.w <= 0.0f || b.w <= 0.0f || c.w <= 0.0f) continue;
+            rasterizeTriangle(a, b, c);
+        }
+    }
+
+    /// Build the max-depth pyramid; call after the last rasterize()
+    void buildHierarchy() {
+        for (size_t l = 1; l < mLevels.size(); l++) {
+            int sw = mLevelSize[l - 1][0], sh = mLevelSize[l - 1][1];
+            int dw = mLevelSize[l][0], dh = mLevelSize[l][1];
+            const auto& src = mLevels[l - 1];
+            auto& dst = mLevels[l];
+            for (int y = 0; y < dh; y++) {
+                int y0 = std::min(y * 2, sh - 1), y1 = std::min(y * 2 + 1, sh - 1);
+                for (int x = 0; x < dw; x++) {
+                    int x0 = std::min(x * 2, sw - 1), x1 = std::min(x * 2 + 1, sw - 1);
+                    dst[y * dw + x] = std::max(std::max(src[y0 * sw + x0], src[y0 * sw + x1]),
+                                               std::max(src[y1 * sw + x0], src[y1 * sw + x1]));
+                }
+            }
+        }
+    }
+
+    /// True when the world-space sphere is hidden behind rasterized occluders
+    bool sphereOccluded(const Vec3f& center, float radius) const {
+        if (mLevels.empty()) return false;
+
+        float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, minZ = 1e30f;
+        for (int i = 0; i < 8; i++) {
+            Vec3f corner(center.x + ((i & 1) ? radius : -radius),
+                         center.y + ((i & 2) ? radius : -radius),
+                         center.z + ((i & 4) ? radius : -radius));
+            Vec4f p = project(corner);
+            if (p.w <= 0.0f) return false;  // Straddles the camera
+            minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+            minZ = std::min(minZ, p.z);
+        }
+        if (minZ <= 0.0f) return false;
+
+        int x0 = std::max(0, (int)std::floor(minX));
+        int y0 = std::max(0, (int)std::floor(minY));
+        int x1 = std::min(mWidth - 1, (int)std::floor(maxX));
+        int y1 = std::min(mHeight - 1, (int)std::floor(maxY));
+        if (x0 > x1 || y0 > y1) return false;
+
+        // Pick the level where the rectangle spans at most 2x2 texels
+        int extent = std::max(x1 - x0, y1 - y0) + 1;
+        int level = 0;
+        while ((extent >> level) > 2 && level + 1 < (int)mLevels.size()) level++;
+
+        const auto& depth = mLevels[level];
+        int lw = mLevelSize[level][0];
+        for (int y = y0 >> level; y <= (y1 >> level); y++) {
+            for (int x = x0 >> level; x <= (x1 >> level); x++) {
+                if (depth[y * lw + x] >= minZ) return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    // Returns (screen x, screen y, depth 0..1, clip w)
+    Vec4f project(const Vec3f& p) const {
+        Vec4f c = mViewProj * Vec4f(p.x, p.y, p.z, 1.0f);
+        if (c.w <= 1e-6f) return Vec4f(0, 0, 0, -1.0f);
+        float inv = 1.0f / c.w;
+        return Vec4f((c.x * inv * 0.5f + 0.5f) * mWidth,
+                     (c.y * inv * 0.5f + 0.5f) * mHeight,
+                     c.z * inv * 0.5f + 0.5f,
+                     c.w);
+    }
+
+    void rasterizeTriangle(const Vec4f& a, const Vec4f& b, const Vec4f& c) {
+        float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (std::fabs(area) < 1e-8f) return;
+        float invArea = 1.0f / area;
+
+        int x0 = std::max(0, (int)std::floor(std::min({a.x, b.x, c.x})));
+        int y0 = std::max(0, (int)std::floor(std::min({a.y, b.y, c.y})));
+        int x1 = std::min(mWidth - 1, (int)std::ceil(std::max({a.x, b.x, c.x})));
+        int y1 = std::min(mHeight - 1, (int)std::ceil(std::max({a.y, b.y, c.y})));
+
+        auto& depth = mLevels[0];
+        for (int y = y0; y <= y1; y++) {
+            float py = y + 0.5f;
+            for (int x = x0; x <= x1; x++) {
+                float px = x + 0.5f;
+                // Barycentrics, normalized so either winding passes
+                float w0 = ((b.x - px) * (c.y - py) - (b.y - py) * (c.x - px)) * invArea;
+                float w1 = ((c.x - px) * (a.y - py) - (c.y - py) * (a.x - px)) * invArea;
+                float w2 = 1.0f - w0 - w1;
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+                float z = w0 * a.z + w1 * b.z + w2 * c.z;
+                float& d = depth[y * mWidth + x];
+                if (z < d) d = z;
+            }
+        }
+    }
+
+    int mWidth = 128;
+    int mHeight = 64;
+    Mat4f mViewProj;
+    std::vector<std::vector<float>> mLevels;      // [0] = full res, then max-reduced
+    std::vector<std::array<int, 2>> mLevelSize;
+    std::vector<Vec4f> mScreen;                   // Projected vertices (scratch)
+};
+
 /**
  * LOD Group - Manages LOD for multiple objects
+ *
+ * update(cameraPos, viewProj) also culls each object's bounding sphere
+ * against the view frustum and, when enabled, against a coarse occlusion
+ * buffer filled with the nearest visible objects; draw() then skips
+ * everything that was culled.
  */
 class LODGroup {
 public:
@@ -615,6 +1154,8 @@ public:
         Vec3f position;
         float scale;
         int currentLOD;
+        bool visible = true;
+        float distance = 0.0f;
     };
 
     void add(LODMesh* mesh, const Vec3f& pos, float scale = 1.0f) {
@@ -624,25 +1165,54 @@ public:
     void clear() { mObjects.clear(); }
 
     /**
-     * Update LOD selections based on camera
+     * Update LOD selections based on camera (no culling)
      */
     void update(const Vec3f& cameraPos) {
-        mTotalTriangles = 0;
+        resetCounts();
         for (auto& obj : mObjects) {
-            if (obj.lodMesh && obj.lodMesh->ready()) {
-                float distance = (cameraPos - obj.position).mag() / obj.scale;
-                obj.currentLOD = obj.lodMesh->getLODIndex(distance);
-                mTotalTriangles += obj.lodMesh->triangleCount(obj.currentLOD);
+            obj.visible = obj.lodMesh && obj.lodMesh->ready();
+            if (obj.visible) selectLOD(obj, cameraPos);
+        }
+        countVisible();
+    }
+
+    /**
+     * Update LOD selections and cull against the view
+     * @param viewProj World-to-clip matrix, e.g. g.projMatrix() * g.viewMatrix()
+     */
+    void update(const Vec3f& cameraPos, const Mat4f& viewProj) {
+        resetCounts();
+        ViewFrustum frustum;
+        frustum.fromMatrix(viewProj);
+
+        mCandidates.clear();
+        for (size_t i = 0; i < mObjects.size(); i++) {
+            auto& obj = mObjects[i];
+            obj.visible = obj.lodMesh && obj.lodMesh->ready();
+            if (!obj.visible) continue;
+
+            if (mFrustumCulling &&
+                !frustum.sphereVisible(worldCenter(obj), worldRadius(obj))) {
+                obj.visible = false;
+                mFrustumCulled++;
+                continue;
             }
+            selectLOD(obj, cameraPos);
+            mCandidates.push_back(i);
         }
+
+        if (mOcclusionCulling && mCandidates.size() > 1) {
+            cullOccluded(viewProj);
+        }
+        countVisible();
     }
 
     /**
-     * Draw all objects with their current LOD
+     * Draw all visible objects with their current LOD
      */
     void draw(Graphics& g) {
         for (auto& obj : mObjects) {
-            if (obj.lodMesh && obj.lodMesh->ready()) {
+            if (obj.visible && obj.lodMesh && obj.lodMesh->ready()) {
                 g.pushMatrix();
                 g.translate(obj.position);
                 g.scale(obj.scale);
@@ -652,12 +1222,106 @@ public:
         }
     }
 
+    // ── Culling Settings ──
+
+    void setFrustumCulling(bool enable) { mFrustumCulling = enable; }
+    bool frustumCulling() const { return mFrustumCulling; }
+
+    /// Off by default; pays a CPU raster of the nearest objects per update
+    void setOcclusionCulling(bool enable) { mOcclusionCulling = enable; }
+    bool occlusionCulling() const { return mOcclusionCulling; }
+
+    /// Nearest visible objects rasterized as occluders each update
+    void setMaxOccluders(int n) { mMaxOccluders = std::max(1, n); }
+    int maxOccluders() const { return mMaxOccluders; }
+
+    /// Occluders use their finest LOD level at or below this triangle count
+    void setOccluderTriangles(int tris) { mOccluderTriangles = std::max(1, tris); }
+
+    OcclusionBuffer& occlusionBuffer() { return mOcclusion; }
+
+    // ── Stats ──
+
     int totalTriangles() const { return mTotalTriangles; }
     int objectCount() const { return mObjects.size(); }
+    int drawnCount() const { return mDrawn; }
+    int frustumCulledCount() const { return mFrustumCulled; }
+    int occludedCount() const { return mOccluded; }
 
 private:
+    void resetCounts() {
+        mTotalTriangles = 0;
+        mDrawn = 0;
+        mFrustumCulled = 0;
+        mOccluded = 0;
+    }
+
+    void selectLOD(LODObject& obj, const Vec3f& cameraPos) {
+        obj.distance = (cameraPos - obj.position).mag();
+        obj.currentLOD = obj.lodMesh->getLODIndex(obj.distance / obj.scale);
+    }
+
+    void countVisible() {
+        for (auto& obj : mObjects) {
+            if (!obj.visible) continue;
+            mDrawn++;
+            mTotalTriangles += obj.lodMesh->triangleCount(obj.currentLOD);
+        }
+    }
+
+    static Vec3f worldCenter(const LODObject& obj) {
+        return obj.position + obj.lodMesh->boundingCenter() * obj.scale;
+    }
+    static float worldRadius(const LODObject& obj) {
+        return obj.lodMesh->boundingRadius() * std::fabs(obj.scale);
+    }
+
+    int occluderLevel(const LODMesh& mesh) const {
+        for (int l = 0; l < mesh.numLevels(); l++) {
+            if (mesh.triangleCount(l) <= mOccluderTriangles) return l;
+        }
+        return mesh.numLevels() - 1;
+    }
+
+    // Front-to-back: rasterize the nearest objects, then test every candidate
+    void cullOccluded(const Mat4f& viewProj) {
+        std::sort(mCandidates.begin(), mCandidates.end(), [this](size_t a, size_t b) {
+            return mObjects[a].distance < mObjects[b].distance;
+        });
+
+        size_t occluders = std::min(mCandidates.size(), (size_t)mMaxOccluders);
+        mOcclusion.begin(viewProj);
+        for (size_t i = 0; i < occluders; i++) {
+            const auto& obj = mObjects[mCandidates[i]];
+            mOcclusion.rasterize(obj.lodMesh->level(occluderLevel(*obj.lodMesh)),
+                                 obj.position, obj.scale);
+        }
+        mOcclusion.buildHierarchy();
+
+        // Occluders are tested too: a sphere's nearest point lies in front of
+        // the object's own surface, so only other occluders can hide it
+        for (size_t i = 0; i < mCandidates.size(); i++) {
+            auto& obj = mObjects[mCandidates[i]];
+            if (mOcclusion.sphereOccluded(worldCenter(obj), worldRadius(obj))) {
+                obj.visible = false;
+                mOccluded++;
+            }
+        }
+    }
+
     std::vector<LODObject> mObjects;
     int mTotalTriangles = 0;
+
+    bool mFrustumCulling = true;
+    bool mOcclusionCulling = false;
+    int mMaxOccluders = 8;
+    int mOccluderTriangles = 1024;
+    OcclusionBuffer mOcclusion;
+    std::vector<size_t> mCandidates;   // Frustum survivors (scratch)
+
+    int mDrawn = 0;
+    int mFrustumCulled = 0;
+    int mOccluded = 0;
 };
 
 /**
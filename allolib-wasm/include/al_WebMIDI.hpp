@@ -17,6 +17,23 @@
  *   if (midi.hasMessage()) {
  *       auto msg = midi.getMessage();
  *   }
+ *
+ * Dense controller streams (MPE, 14-bit CCs) cost a JS→WASM call per
+ * message on that path. With the input ring on, JS writes messages with
+ * their timestamps straight into a ring in wasm memory, and one consumer
+ * takes them from there:
+ *   - the audio thread, sample-accurately:
+ *       midi.dispatchAudio(io.framesPerBuffer(), io.framesPerSecond(),
+ *           [&](const MIDIMessage& m, int offset) { ... });
+ *   - or the main loop: midi.poll() runs the callbacks and fills the
+ *     hasMessage()/getMessage() queue as before.
+ * With coalesceCC, a control change superseded by a later one for the
+ * same (channel, controller) in the same batch is skipped.
+ *
+ *   MIDIRingOptions ring;
+ *   ring.enabled = true;
+ *   ring.coalesceCC = true;
+ *   midi.setInputRing(ring);
  */
 
 #ifndef AL_WEB_MIDI_HPP
@@ -27,6 +44,8 @@
 #include <vector>
 #include <functional>
 #include <queue>
+#include <array>
+#include <atomic>
 #include <cstdint>
 
 namespace al {
@@ -143,6 +162,34 @@ public:
     bool isPortOpen() const { return false; }
 };
 
+/**
+ * One message in the input ring, as written by JS (24 bytes)
+ */
+struct MIDIRingEvent {
+    double frame;      ///< Audio frame it is due at on dispatchAudio's clock, < 0 = now
+    double timestamp;  ///< event.timeStamp, ms on the performance.now() clock
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+    uint8_t flags;
+    uint32_t reserved;
+};
+static_assert(sizeof(MIDIRingEvent) == 24, "JS writes MIDIRingEvent with a 24-byte stride");
+
+struct MIDIRingOptions {
+    bool enabled = false;
+    size_t capacity = 1024;   ///< Messages (rounded up to a power of two)
+    bool coalesceCC = false;  ///< Last value wins per (channel, controller) in a batch
+    int latencyFrames = 256;  ///< Added to timestamps; covers an audio block plus clock jitter
+};
+
+struct MIDIRingStats {
+    uint32_t dispatched = 0;  ///< Handed to the consumer
+    uint32_t coalesced = 0;   ///< Skipped for a later value of the same CC
+    uint32_t dropped = 0;     ///< Lost to a full ring
+    uint32_t pending = 0;     ///< In the ring right now
+};
+
 /**
  * MIDI device information
  */
@@ -169,6 +216,7 @@ public:
 
     ~WebMIDI() {
         close();
+        detachRing();
     }
 
     /**
@@ -208,9 +256,50 @@ public:
                         // Set up message handler
                         input.onmidimessage = function(event) {
                             var data = event.data;
-                            Module.ccall('_al_web_midi_message', null,
-                                ['number', 'number', 'number', 'number', 'number'],
-                                [midiPtr, data[0], data[1] || 0, data[2] || 0, event.timeStamp]);
+                            var ring = window._alWebMIDIRing && window._alWebMIDIRing[midiPtr];
+                            if (!ring) {
+                                Module.ccall('_al_web_midi_message', null,
+                                    ['number', 'number', 'number', 'number', 'number'],
+                                    [midiPtr, data[0], data[1] || 0, data[2] || 0, event.timeStamp]);
+                                return;
+                            }
+                            // MIDIRingHeader: head, tail, mask, dropped,
+                            // latencyFrames (u32) | audioFrame, sampleRate
+                            // (f64, at byte 24) | events (u32, at byte 40)
+                            var h = ring.ptr >> 2;
+                            var head = Atomics.load(HEAP32, h) >>> 0;
+                            var tail = Atomics.load(HEAP32, h + 1) >>> 0;
+                            var mask = HEAPU32[h + 2];
+                            if (((tail - head) >>> 0) > mask) {
+                                Atomics.add(HEAP32, h + 3, 1);
+                                return;
+                            }
+                            // Audio frame estimate: the consumer publishes
+                            // its clock after each block; the largest
+                            // (clock - now) seen, decaying slowly for drift,
+                            // maps performance.now() onto it
+                            var frame = -1;
+                            var seen = HEAPF64[(ring.ptr >> 3) + 3];
+                            var sr = HEAPF64[(ring.ptr >> 3) + 4];
+                            if (sr > 0 && seen > 0) {
+                                var now = performance.now();
+                                if (seen !== ring.seen) {
+                                    var sample = seen - now * sr / 1000;
+                                    ring.offset = ring.seen === undefined ? sample
+                                        : Math.max(sample, ring.offset - (now - ring.seenAt) * sr * 1e-6);
+                                    ring.seen = seen;
+                                    ring.seenAt = now;
+                                }
+                                frame = event.timeStamp * sr / 1000 + ring.offset + HEAPU32[h + 4];
+                            }
+                            var rec = HEAPU32[h + 10] + (tail & mask) * 24;
+                            HEAPF64[rec >> 3] = frame;
+                            HEAPF64[(rec >> 3) + 1] = event.timeStamp;
+                            HEAPU8[rec + 16] = data[0];
+                            HEAPU8[rec + 17] = data[1] || 0;
+                            HEAPU8[rec + 18] = data[2] || 0;
+                            HEAPU8[rec + 19] = 0;
+                            Atomics.store(HEAP32, h + 1, (tail + 1) | 0);
                         };
                     });
 
@@ -379,9 +468,170 @@ public:
         send(MIDI_PITCH_BEND | (channel & 0x0F), bendValue & 0x7F, (bendValue >> 7) & 0x7F);
     }
 
+    // =========================================================================
+    // Input ring
+    // =========================================================================
+
+    /**
+     * Turn the shared-memory input ring on or off. Messages still in the
+     * ring are lost when it is reallocated, so call this before MIDI
+     * arrives (or between pieces). Only one consumer may drain it: either
+     * dispatchAudio() from the audio callback or poll() from the main loop.
+     */
+    void setInputRing(const MIDIRingOptions& options) {
+        detachRing();
+        mRingOptions = options;
+        if (!options.enabled) return;
+
+        size_t capacity = 16;
+        while (capacity < options.capacity) capacity <<= 1;
+        mRingEvents.assign(capacity, MIDIRingEvent{});
+        mRing.head.store(0, std::memory_order_relaxed);
+        mRing.tail.store(0, std::memory_order_relaxed);
+        mRing.mask = uint32_t(capacity - 1);
+        mRing.dropped.store(0, std::memory_order_relaxed);
+        mRing.latencyFrames = uint32_t(options.latencyFrames > 0 ? options.latencyFrames : 0);
+        mRing.audioFrame = 0.0;
+        mRing.sampleRate = 0.0;
+        mRing.events = mRingEvents.data();
+        mRingDispatched = 0;
+        mRingCoalesced = 0;
+
+        EM_ASM({
+            window._alWebMIDIRing = window._alWebMIDIRing || {};
+            window._alWebMIDIRing[$0] = { ptr: $1 };
+        }, this, &mRing);
+    }
+
+    MIDIRingOptions inputRing() const { return mRingOptions; }
+
+    MIDIRingStats inputRingStats() const {
+        MIDIRingStats stats;
+        stats.dispatched = mRingDispatched;
+        stats.coalesced = mRingCoalesced;
+        stats.dropped = mRing.dropped.load(std::memory_order_relaxed);
+        stats.pending = mRing.tail.load(std::memory_order_acquire) -
+                        mRing.head.load(std::memory_order_acquire);
+        return stats;
+    }
+
+    /**
+     * Audio thread, once per block: call fn(msg, offset) for every ring
+     * message due before the end of this block, offset being its frame
+     * within the block (late messages play at 0), then advance the clock
+     * JS stamps messages against. Returns the number delivered.
+     */
+    template <class F>
+    int dispatchAudio(int numFrames, double sampleRate, F&& fn) {
+        if (!mRing.events || numFrames <= 0) return 0;
+        const double start = mRing.audioFrame;
+        const double end = start + numFrames;
+        const uint32_t head = mRing.head.load(std::memory_order_relaxed);
+        const uint32_t tail = mRing.tail.load(std::memory_order_acquire);
+
+        // Messages arrive in time order; stop at the first one not yet due.
+        // An estimate more than a second out is treated as due now.
+        uint32_t due = head;
+        for (; due != tail; ++due) {
+            const double frame = mRing.events[due & mRing.mask].frame;
+            if (frame >= end && frame < end + sampleRate) break;
+        }
+
+        int delivered = drainRing(head, due, [&](const MIDIRingEvent& e, const MIDIMessage& msg) {
+            double offset = e.frame - start;
+            if (!(offset > 0.0)) offset = 0.0;
+            if (offset > numFrames - 1) offset = numFrames - 1;
+            fn(msg, int(offset));
+        });
+
+        mRing.sampleRate = sampleRate;
+        mRing.audioFrame = end;
+        return delivered;
+    }
+
+    /**
+     * Main loop: run everything in the ring through the usual callbacks
+     * and the hasMessage()/getMessage() queue. Returns the number delivered.
+     */
+    int poll() {
+        if (!mRing.events) return 0;
+        const uint32_t head = mRing.head.load(std::memory_order_relaxed);
+        const uint32_t tail = mRing.tail.load(std::memory_order_acquire);
+        return drainRing(head, tail, [&](const MIDIRingEvent&, const MIDIMessage& msg) {
+            deliver(msg);
+        });
+    }
+
     // Internal callback from JavaScript
     void _onMessage(uint8_t status, uint8_t data1, uint8_t data2, double timestamp) {
-        MIDIMessage msg{status, data1, data2, timestamp};
+        deliver(MIDIMessage{status, data1, data2, timestamp});
+    }
+
+    void _onOpened() {
+        mIsOpen = true;
+        printf("[WebMIDI] Ready\n");
+    }
+
+private:
+    // Ring control block; JS reads and writes it at fixed byte offsets
+    // (see the onmidimessage handler in open())
+    struct MIDIRingHeader {
+        std::atomic<uint32_t> head{0};      // 0: consumer
+        std::atomic<uint32_t> tail{0};      // 4: producer (JS)
+        uint32_t mask = 0;                  // 8
+        std::atomic<uint32_t> dropped{0};   // 12: producer (JS)
+        uint32_t latencyFrames = 0;         // 16
+        uint32_t reserved = 0;              // 20
+        double audioFrame = 0.0;            // 24: consumer clock, end of last block
+        double sampleRate = 0.0;            // 32
+        MIDIRingEvent* events = nullptr;    // 40
+    };
+
+    void detachRing() {
+        if (!mRing.events) return;
+        EM_ASM({
+            if (window._alWebMIDIRing) delete window._alWebMIDIRing[$0];
+        }, this);
+        mRing.events = nullptr;
+    }
+
+    // Hand [head, end) to fn, skipping CCs superseded within the range
+    // when coalescing, and release the slots to the producer
+    template <class F>
+    int drainRing(uint32_t head, uint32_t end, F&& fn) {
+        if (head == end) return 0;
+        const bool coalesce = mRingOptions.coalesceCC;
+        if (coalesce) {
+            ++mCCBatch;
+            for (uint32_t i = head; i != end; ++i) {
+                const MIDIRingEvent& e = mRing.events[i & mRing.mask];
+                if ((e.status & 0xF0) != MIDI_CONTROL_CHANGE) continue;
+                const size_t key = size_t(e.status & 0x0F) * 128 + (e.data1 & 0x7F);
+                mCCLast[key] = i;
+                mCCBatchOf[key] = mCCBatch;
+            }
+        }
+        int delivered = 0;
+        for (uint32_t i = head; i != end; ++i) {
+            const MIDIRingEvent& e = mRing.events[i & mRing.mask];
+            if (coalesce && (e.status & 0xF0) == MIDI_CONTROL_CHANGE) {
+                const size_t key = size_t(e.status & 0x0F) * 128 + (e.data1 & 0x7F);
+                if (mCCBatchOf[key] == mCCBatch && mCCLast[key] != i) {
+                    ++mRingCoalesced;
+                    continue;
+                }
+            }
+            fn(e, MIDIMessage{e.status, e.data1, e.data2, e.timestamp});
+            ++delivered;
+        }
+        mRing.head.store(end, std::memory_order_release);
+        mRingDispatched += uint32_t(delivered);
+        return delivered;
+    }
+
+    void deliver(const MIDIMessage& msg) {
+        const uint8_t data1 = msg.data1;
+        const uint8_t data2 = msg.data2;
 
         // Add to queue
         mMessageQueue.push(msg);
@@ -423,12 +673,6 @@ public:
         }
     }
 
-    void _onOpened() {
-        mIsOpen = true;
-        printf("[WebMIDI] Ready\n");
-    }
-
-private:
     bool mIsOpen;
     bool mHasSysex;
     std::vector<MIDIDevice> mInputDevices;
@@ -440,19 +684,29 @@ private:
     CCCallback mCCCallback;
     PitchBendCallback mPitchBendCallback;
     MessageCallback mMessageCallback;
+
+    MIDIRingOptions mRingOptions;
+    MIDIRingHeader mRing;
+    std::vector<MIDIRingEvent> mRingEvents;
+    uint32_t mRingDispatched = 0;
+    uint32_t mRingCoalesced = 0;
+    // Per (channel, controller): last ring index in the current batch
+    std::array<uint32_t, 16 * 128> mCCLast{};
+    std::array<uint32_t, 16 * 128> mCCBatchOf{};
+    uint32_t mCCBatch = 0;
 };
 
 } // namespace al
 
 // C callbacks for JavaScript
 extern "C" {
-    void _al_web_midi_message(al::WebMIDI* midi, int status, int data1, int data2, double timestamp) {
+    EMSCRIPTEN_KEEPALIVE inline void _al_web_midi_message(al::WebMIDI* midi, int status, int data1, int data2, double timestamp) {
         if (midi) {
             midi->_onMessage(status, data1, data2, timestamp);
         }
     }
 
-    void _al_web_midi_opened(al::WebMIDI* midi) {
+    EMSCRIPTEN_KEEPALIVE inline void _al_web_midi_opened(al::WebMIDI* midi) {
         if (midi) {
             midi->_onOpened();
         }
@@ -11,6 +11,29 @@
  *   Location 2: TexCoord (vec2f) - offset 28
  *   Location 3: Normal (vec3f) - offset 36
  *   Stride: 48 bytes
+ *
+ * Compact layouts (setVertexCompression), same locations:
+ *   Compact:   float32x3 position, unorm8x4 color, float16x2 texcoord,
+ *              snorm16x4 normal - 28 bytes
+ *   Quantized: as Compact with snorm16x4 positions, decoded by a per-mesh
+ *              uniform scale + offset folded into the modelView matrix
+ *              (see applyPositionDecode) - 24 bytes
+ *   Colors are clamped to [0, 1] in both.
+ *
+ * Change tracking: each cache entry keeps a CPU copy of the source
+ * attributes. prepareMesh() compares the mesh against it, so in-place edits
+ * are detected, and only the changed vertex/index range is re-uploaded.
+ * Buffers grow by doubling, so growing meshes reallocate O(log n) times.
+ *
+ * Render-only geometry can skip al::Mesh entirely: an InterleavedMesh is
+ * already in the 48-byte layout and is uploaded straight from its arrays,
+ * with 16-bit indices when it has them. It is re-uploaded whole when its
+ * version changes instead of being diffed.
+ *
+ * Eviction: entries are keyed by mesh address, so a destroyed mesh would
+ * otherwise keep its buffers forever. beginFrame() drops entries not
+ * drawn for evictionAge frames, then least recently drawn ones while the
+ * cache is over its memory budget. Entries drawn this frame are kept.
  */
 
 #ifndef AL_WEB_MESH_ADAPTER_HPP
@@ -20,6 +43,8 @@
 #include "al/graphics/al_Mesh.hpp"
 #include <unordered_map>
 #include <vector>
+#include <memory>
+#include <cstdint>
 
 namespace al {
 
@@ -32,6 +57,97 @@ struct InterleavedVertex {
     // Total: 48 bytes
 };
 
+/**
+ * InterleavedMesh - render-only geometry in the backend vertex layout
+ *
+ * Filled by importers that write vertices in place (e.g.
+ * WebGLTF::parseInterleaved) and drawn with Graphics::draw() without an
+ * intermediate al::Mesh. Indices are 16-bit unless wideIndices is set.
+ * Bump version after editing the arrays so the cached buffers re-upload.
+ */
+struct InterleavedMesh {
+    std::vector<InterleavedVertex> vertices;
+    std::vector<uint16_t> indices16;   // Used while !wideIndices
+    std::vector<uint32_t> indices32;   // Used once wideIndices is set
+    bool wideIndices = false;
+    Mesh::Primitive primitive = Mesh::TRIANGLES;
+    float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+    float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+    uint32_t version = 1;
+
+    size_t indexCount() const { return wideIndices ? indices32.size() : indices16.size(); }
+    const void* indexData() const {
+        return wideIndices ? static_cast<const void*>(indices32.data())
+                           : static_cast<const void*>(indices16.data());
+    }
+
+    /// Append an index, switching to 32-bit storage when it doesn't fit
+    void pushIndex(uint32_t index) {
+        if (!wideIndices && index > 0xFFFFu) widenIndices();
+        if (wideIndices) indices32.push_back(index);
+        else indices16.push_back(static_cast<uint16_t>(index));
+    }
+    void widenIndices();
+
+    /// Recompute boundsMin / boundsMax from the vertices
+    void computeBounds();
+
+    void clear();
+
+    /**
+     * Copy into an al::Mesh for paths that need one (the WebGL2 renderer).
+     * Graphics::draw() keeps this copy in `fallback` and rebuilds it only
+     * when version changes.
+     */
+    void toMesh(Mesh& out) const;
+
+    /// Replace the contents with an al::Mesh's attributes (missing ones get
+    /// the same defaults WebMeshAdapter uploads) and bump version
+    void fromMesh(const Mesh& in);
+
+    mutable std::unique_ptr<Mesh> fallback;
+    mutable uint32_t fallbackVersion = 0;
+};
+
+/**
+ * FrameArena - bump allocator for transient geometry
+ *
+ * Interleaved vertices and converted indices live only until they are
+ * handed to updateBuffer(), so they are carved out of one retained block
+ * instead of fresh vectors. reset() rewinds it; if the previous frame
+ * overflowed into extra blocks, they are replaced by one block sized for
+ * the whole frame, so steady-state frames don't touch malloc.
+ */
+class FrameArena {
+public:
+    template <typename T>
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T)));
+    }
+
+    /// Rewind; grow the main block to last frame's high-water mark if needed
+    void reset();
+
+    size_t used() const { return mUsed; }
+    size_t capacity() const { return mBlockSize; }
+
+private:
+    void* allocateBytes(size_t bytes, size_t align);
+
+    std::unique_ptr<char[]> mBlock;
+    size_t mBlockSize = 0;
+    size_t mOffset = 0;
+    size_t mUsed = 0;                                 // Bytes handed out since reset()
+    std::vector<std::unique_ptr<char[]>> mOverflow;   // Freed on reset()
+};
+
+/// Vertex storage layout for cached meshes
+enum class VertexCompression {
+    None,       ///< InterleavedVertex, 48 bytes
+    Compact,    ///< 8/16-bit color, texcoord and normal, 28 bytes
+    Quantized   ///< Compact + snorm16 positions, 24 bytes
+};
+
 /// Cache entry for a mesh's GPU resources
 struct MeshCacheEntry {
     BufferHandle vertexBuffer;
@@ -39,10 +155,28 @@ struct MeshCacheEntry {
     VertexLayout layout;
     size_t vertexCount = 0;
     size_t indexCount = 0;
-    uint32_t meshVersion = 0;
+    size_t vertexCapacity = 0;     // Vertices the buffer can hold
+    size_t indexCapacity = 0;      // Indices the buffer can hold
+    size_t indexSize = sizeof(uint32_t); // 2 for 16-bit InterleavedMesh indices
+    uint32_t meshVersion = 0;      // Bumped on every upload
+    uint32_t sourceVersion = 0;    // InterleavedMesh::version last uploaded
+    uint64_t lastUsedFrame = 0;    // For LRU eviction
     bool hasIndices = false;
+    bool opaque = true;            // No vertex color alpha below 1
     PrimitiveType convertedPrimitive = PrimitiveType::Triangles; // After conversion
     Mesh::Primitive originalPrimitive = Mesh::TRIANGLES;
+    VertexCompression compression = VertexCompression::None;
+
+    // Quantized positions decode as position * positionScale + positionOffset
+    float positionScale = 1.0f;
+    float positionOffset[3] = {0.0f, 0.0f, 0.0f};
+
+    // Last uploaded source attributes, compared against to find dirty ranges
+    std::vector<char> positions;
+    std::vector<char> colors;
+    std::vector<char> texCoords;
+    std::vector<char> normals;
+    std::vector<char> indices;
 };
 
 /**
@@ -65,6 +199,9 @@ public:
     /// Get the current backend
     GraphicsBackend* backend() const { return mBackend; }
 
+    /// Start of frame: recycle the transient geometry arena and evict
+    void beginFrame();
+
     /**
      * Prepare a mesh for rendering
      *
@@ -73,6 +210,14 @@ public:
      */
     bool prepareMesh(const Mesh& mesh);
 
+    /**
+     * Prepare pre-interleaved geometry for rendering
+     *
+     * Uploads the vertex array as-is (packing it first under a compact
+     * layout) and keeps 16-bit indices. Only a version change re-uploads.
+     */
+    bool prepareInterleaved(const InterleavedMesh& mesh);
+
     /**
      * Bind the mesh's buffers and draw
      *
@@ -82,9 +227,17 @@ public:
     void drawMesh(PrimitiveType primitive, int vertexCount = 0);
 
     /**
-     * Get cache entry for a mesh (if exists)
+     * Draw a cached mesh instanceCount times, reading per-instance data
+     * from the backend's instance buffer. Returns false if the mesh isn't
+     * cached or can only be drawn through primitive emulation (non-indexed
+     * TRIANGLE_FAN / LINE_LOOP), which has no instanced path.
+     */
+    bool drawMeshInstanced(const Mesh* mesh, int instanceCount);
+
+    /**
+     * Get cache entry for a Mesh or InterleavedMesh (if exists)
      */
-    const MeshCacheEntry* getCacheEntry(const Mesh* mesh) const;
+    const MeshCacheEntry* getCacheEntry(const void* mesh) const;
 
     /**
      * Clear all cached GPU resources
@@ -92,9 +245,9 @@ public:
     void clearCache();
 
     /**
-     * Remove a specific mesh from cache
+     * Remove a specific Mesh or InterleavedMesh from cache
      */
-    void removeMesh(const Mesh* mesh);
+    void removeMesh(const void* mesh);
 
     /**
      * Get statistics
@@ -102,52 +255,204 @@ public:
     size_t cacheSize() const { return mCache.size(); }
     size_t totalBufferMemory() const { return mTotalBufferMemory; }
 
+    /**
+     * Compare mesh contents on every prepareMesh() (default on).
+     * When off, only vertex/index count changes trigger an upload, which
+     * skips the per-frame compare for large static meshes.
+     */
+    void setContentTracking(bool enabled) { mContentTracking = enabled; }
+    bool contentTracking() const { return mContentTracking; }
+
+    /// Cache statistics (bytes are GPU buffer capacity)
+    struct CacheStats {
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t budget = 0;
+        uint64_t evictions = 0;
+        uint64_t evictedBytes = 0;
+    };
+    CacheStats cacheStats() const;
+
+    /// GPU memory budget for cached meshes in bytes (0 = unlimited)
+    void setMemoryBudget(size_t bytes);
+    size_t memoryBudget() const { return mMemoryBudget; }
+
+    /// Evict meshes not drawn for this many frames (0 = never)
+    void setEvictionAge(uint32_t frames) { mEvictionAge = frames; }
+    uint32_t evictionAge() const { return mEvictionAge; }
+
+    /**
+     * Select the vertex layout for meshes uploaded from now on.
+     * Cached meshes switch on their next prepareMesh().
+     */
+    void setVertexCompression(VertexCompression compression) { mCompression = compression; }
+    VertexCompression vertexCompression() const { return mCompression; }
+
+    /**
+     * Fold an entry's position decode into a column-major modelView matrix.
+     * Call after prepareMesh() and re-upload the matrix; no-op unless the
+     * entry uses VertexCompression::Quantized.
+     */
+    static void applyPositionDecode(const MeshCacheEntry& entry, float* modelView);
+
 private:
     GraphicsBackend* mBackend = nullptr;
-    std::unordered_map<const Mesh*, MeshCacheEntry> mCache;
-    const Mesh* mCurrentMesh = nullptr;
+    std::unordered_map<const void*, MeshCacheEntry> mCache;  // Mesh or InterleavedMesh
+    const void* mCurrentMesh = nullptr;
     size_t mTotalBufferMemory = 0;
+    bool mContentTracking = true;
+    VertexCompression mCompression = VertexCompression::None;
+    FrameArena mArena;
+
+    // Eviction
+    uint64_t mFrame = 1;
+    size_t mMemoryBudget = 256 * 1024 * 1024;
+    uint32_t mEvictionAge = 600;  // ~10 s at 60 fps
+    uint64_t mEvictions = 0;
+    uint64_t mEvictedBytes = 0;
+
+    /// Drop stale entries, then LRU ones until under budget
+    void evict();
 
     /**
-     * Create interleaved vertex data from mesh
+     * Interleave vertices [first, first + count) into outVertices
+     * (count must not exceed the mesh's vertex count past first)
      */
     void createInterleavedData(
         const Mesh& mesh,
-        std::vector<InterleavedVertex>& outVertices
+        InterleavedVertex* outVertices,
+        size_t first,
+        size_t count
     );
 
     /**
-     * Create vertex layout for interleaved format
+     * Find or (re)create the entry for a mesh; a primitive or layout change
+     * starts over. Sets isNew when the entry has no uploads yet.
+     */
+    MeshCacheEntry& acquireEntry(const void* key, Mesh::Primitive primitive,
+                                 size_t vertexCount, bool& isNew);
+
+    /**
+     * Make room for `needed` elements of elemSize bytes, growing by
+     * doubling; returns true if the buffer was (re)created and so is empty
+     */
+    bool reserveBuffer(BufferHandle& buffer, size_t& capacity, size_t needed,
+                       size_t elemSize, BufferType type);
+
+    /**
+     * Upload vertices [first, last) of the mesh, growing the buffer if needed
+     */
+    void uploadVertices(MeshCacheEntry& entry, const Mesh& mesh, size_t first, size_t last);
+
+    /**
+     * Upload indices [first, last), growing the buffer if needed
+     */
+    void uploadIndices(MeshCacheEntry& entry, const uint32_t* indices, size_t count,
+                       size_t first, size_t last);
+
+    /**
+     * Destroy an entry's buffers and subtract them from the memory total
+     */
+    void releaseEntry(MeshCacheEntry& entry);
+
+    /**
+     * Create vertex layout for the given storage format
      */
-    VertexLayout createVertexLayout();
+    VertexLayout createVertexLayout(VertexCompression compression);
 
     /**
-     * Convert unsupported primitives (TRIANGLE_FAN, LINE_LOOP) to supported ones.
-     * WebGPU only supports: Points, Lines, LineStrip, Triangles, TriangleStrip.
+     * Encode interleaved vertices into the entry's compact layout
+     * (output is count * layout.stride bytes from the frame arena)
+     */
+    const void* packVertices(const MeshCacheEntry& entry, const InterleavedVertex* vertices,
+                             size_t count);
+
+    /**
+     * Fit the quantization range to the mesh; returns true if it changed
+     * (existing GPU vertices then need re-encoding)
+     */
+    bool fitQuantization(MeshCacheEntry& entry, const Mesh& mesh, size_t first, size_t last);
+
+    /// Center the quantization range on [lo, hi] with some headroom
+    static void setQuantizationRange(MeshCacheEntry& entry, const float lo[3], const float hi[3]);
+
+    /**
+     * Convert indexed unsupported primitives (TRIANGLE_FAN, LINE_LOOP) to
+     * supported ones. WebGPU only supports: Points, Lines, LineStrip,
+     * Triangles, TriangleStrip. Vertices are shared, so only indices change.
      *
      * @param primitive Original primitive type
-     * @param vertices Input vertices
-     * @param indices Input indices (may be empty for non-indexed)
-     * @param outVertices Output vertices (may be expanded)
-     * @param outIndices Output indices
+     * @param indices Input indices
+     * @param outIndices Output indices, allocated from the frame arena
+     * @param outCount Number of output indices
      * @return Converted primitive type
      */
     PrimitiveType convertPrimitive(
         Mesh::Primitive primitive,
-        const std::vector<InterleavedVertex>& vertices,
         const std::vector<unsigned int>& indices,
-        std::vector<InterleavedVertex>& outVertices,
-        std::vector<uint32_t>& outIndices
+        uint32_t*& outIndices,
+        size_t& outCount
     );
 
     /**
      * Check if primitive type needs conversion for WebGPU
+     * (only applied to indexed meshes; non-indexed fans/loops are
+     * expanded by the backend's shared conversion index buffers)
      */
     static bool needsPrimitiveConversion(Mesh::Primitive p) {
         return p == Mesh::TRIANGLE_FAN || p == Mesh::LINE_LOOP;
     }
 };
 
+/**
+ * Select the vertex layout of the mesh adapter behind Graphics::draw()
+ * (defined in al_Graphics_Web.cpp)
+ */
+void Graphics_setVertexCompression(VertexCompression compression);
+
+/**
+ * Defer eligible Graphics::draw() calls and submit repeats of the same mesh
+ * as one instanced draw (default off; defined in al_Graphics_Web.cpp).
+ * Only unlit, untextured, opaque depth-tested draws are deferred; see the
+ * notes there for when pending batches are submitted.
+ */
+void Graphics_setAutoInstancing(bool enabled);
+bool Graphics_autoInstancing();
+
+/**
+ * Skip Graphics::draw() calls whose mesh bounds lie outside the view
+ * frustum (default off; defined in al_Graphics_Web.cpp). Draws with a
+ * custom shader, in omni mode or with a stereo eye offset are never culled.
+ * VAOMesh and InterleavedMesh bounds are cached; see the notes there.
+ */
+void Graphics_setFrustumCulling(bool enabled);
+bool Graphics_frustumCulling();
+
+/// Forget the cached bounds of a VAOMesh edited in place (same vertex count)
+void Graphics_invalidateMeshBounds(const void* mesh);
+
+struct FrustumCullStats {
+    uint64_t tested = 0;          // Draws tested against the frustum
+    uint64_t culled = 0;          // Draws skipped as off-screen
+    uint64_t culledVertices = 0;  // Vertices those draws would have sent
+};
+
+/// Counts for the last completed frame
+FrustumCullStats Graphics_frustumCullStats();
+
+struct DrawStats {
+    uint64_t draws = 0;     // Graphics::draw() calls that were not culled
+    uint64_t vertices = 0;  // Vertices those draws submitted
+};
+
+/// Draw counts for the last completed frame. Auto-instancing may merge
+/// several of these draws into one backend draw call.
+DrawStats Graphics_drawStats();
+
+/// The mesh adapter behind Graphics::draw() and its cache statistics
+WebMeshAdapter& Graphics_meshAdapter();
+WebMeshAdapter::CacheStats Graphics_meshCacheStats();
+
 /**
  * Convert al::Mesh::Primitive to PrimitiveType
  * (Free function for use by other modules)
@@ -0,0 +1,552 @@
+/**
+ * Web Mesh Cache - preprocessed binary mesh container
+ *
+ * Importing a mesh costs far more than drawing it: OBJ/glTF parsing,
+ * normal generation, welding, LOD simplification and interleaving all run
+ * again every session. A MeshBundle holds the finished result (interleaved
+ * vertices, 16/32-bit indices, the LOD chain, bounds and meshlet culling
+ * data) and WebMeshCache stores it as one flat little-endian file whose
+ * sections are laid out exactly as the GPU wants them, so loading is a
+ * header check plus one memcpy per section.
+ *
+ * Usage:
+ *   // Build once from any importer, then reuse the bundle
+ *   MeshBundle bundle;
+ *   WebOBJ::parseCached(bytes.data(), bytes.size(), bundle, 4);
+ *   g.draw(bundle.selectByDistance(distance));
+ *
+ *   // Or ship a preprocessed .almc asset and skip importing entirely
+ *   WebMeshCache::loadFromURL("/assets/meshes/bunny.almc", bundle,
+ *                             [](bool ok) { ... });
+ *
+ * parseCached() keys bundles by a hash of the source bytes and keeps them
+ * under cacheDirectory() (IDBFS at /meshcache in the browser, restored by
+ * runtime.ts before main()). write() produces the same bytes for serving
+ * from the backend; WebFile::downloadBinary() saves them from the browser.
+ *
+ * File layout (all sections 4-byte aligned):
+ *   FileHeader
+ *   LevelRecord[levelCount]
+ *   MeshBundle::Meshlet[meshletCount]
+ *   InterleavedVertex[vertexCount]     all levels, level 0 first
+ *   uint16/uint32[indexCount]          per level, relative to its vertices
+ */
+
+#ifndef AL_WEB_MESH_CACHE_HPP
+#define AL_WEB_MESH_CACHE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+#include "al/graphics/al_Mesh.hpp"
+#include "al_WebFile.hpp"
+#include "al_WebLOD.hpp"
+#include "al_WebMeshAdapter.hpp"
+
+namespace al {
+
+/**
+ * MeshBundle - everything needed to draw a preprocessed mesh
+ *
+ * levels[0] is full detail; further levels are the LOD chain, each with
+ * its own vertices. Meshlets partition levels[0]'s triangles into index
+ * ranges with a bounding sphere and normal cone for CPU culling.
+ */
+struct MeshBundle {
+    struct Meshlet {
+        uint32_t indexOffset = 0;  // Into levels[0]'s index buffer
+        uint32_t indexCount = 0;
+        float center[3] = {0.0f, 0.0f, 0.0f};
+        float radius = 0.0f;
+        float coneAxis[3] = {0.0f, 0.0f, 1.0f};
+        float coneCutoff = 1.0f;   // > 1 disables cone culling
+    };
+
+    std::vector<InterleavedMesh> levels;
+    std::vector<float> maxDistance;     // Per level, as LODMesh::LODLevel
+    std::vector<float> screenCoverage;  // Per level, as LODMesh::LODLevel
+    std::vector<Meshlet> meshlets;
+    float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+    float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+    uint64_t sourceKey = 0;             // WebMeshCache::contentKey of the source
+
+    bool empty() const { return levels.empty() || levels[0].vertices.empty(); }
+    int numLevels() const { return (int)levels.size(); }
+
+    void clear() {
+        levels.clear();
+        maxDistance.clear();
+        screenCoverage.clear();
+        meshlets.clear();
+        for (int c = 0; c < 3; c++) boundsMin[c] = boundsMax[c] = 0.0f;
+        sourceKey = 0;
+    }
+
+    const InterleavedMesh& level(int i) const {
+        i = std::max(0, std::min(i, (int)levels.size() - 1));
+        return levels[i];
+    }
+
+    /// Same thresholds LODMesh::selectByDistance() uses
+    const InterleavedMesh& selectByDistance(float distance) const {
+        for (size_t i = 0; i < levels.size(); i++) {
+            if (distance < maxDistance[i]) return levels[i];
+        }
+        return levels.back();
+    }
+
+    /**
+     * Conservative back-face test for one meshlet: true when every
+     * triangle in it faces away from the camera (model space position)
+     */
+    static bool backfacing(const Meshlet& m, const float cameraPos[3]) {
+        float d[3] = { m.center[0] - cameraPos[0], m.center[1] - cameraPos[1],
+                       m.center[2] - cameraPos[2] };
+        float len = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        float dp = d[0] * m.coneAxis[0] + d[1] * m.coneAxis[1] + d[2] * m.coneAxis[2];
+        return dp >= m.coneCutoff * len + m.radius;
+    }
+};
+
+/**
+ * WebMeshCache - build, serialize and persist MeshBundles
+ */
+class WebMeshCache {
+public:
+    using LoadCallback = std::function<void(bool success)>;
+
+    static constexpr uint32_t kMagic = 0x434D4C41;  // "ALMC"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr int kMeshletTriangles = 64;
+
+    // ── Building ──
+
+    /**
+     * Bundle a mesh, optionally with a generated LOD chain
+     * @param lodLevels 1 = no LOD chain; more runs LODMesh::generate(),
+     *        which reuses its own /lodcache entries
+     */
+    static void build(const Mesh& source, MeshBundle& out, int lodLevels = 1,
+                      float reductionFactor = 0.5f) {
+        out.clear();
+        if (lodLevels > 1) {
+            LODMesh lod;
+            lod.generate(source, lodLevels, reductionFactor);
+            for (int i = 0; i < lod.numLevels(); i++) {
+                out.levels.emplace_back();
+                out.levels.back().fromMesh(lod.level(i));
+                out.maxDistance.push_back(lod.levelInfo(i).maxDistance);
+                out.screenCoverage.push_back(lod.levelInfo(i).screenCoverage);
+            }
+        } else {
+            out.levels.emplace_back();
+            out.levels.back().fromMesh(source);
+            out.maxDistance.push_back(10.0f);
+            out.screenCoverage.push_back(0.5f);
+        }
+        finish(out);
+    }
+
+    /// Bundle already-interleaved geometry (e.g. WebGLTF::parseInterleaved)
+    static void build(InterleavedMesh&& source, MeshBundle& out) {
+        out.clear();
+        out.levels.push_back(std::move(source));
+        out.maxDistance.push_back(10.0f);
+        out.screenCoverage.push_back(0.5f);
+        finish(out);
+    }
+
+    /**
+     * Split levels[0] into runs of kMeshletTriangles consecutive triangles
+     * with bounds and normal cones. Importers leave triangles in
+     * MeshOptimizer's cache order, so consecutive runs are compact.
+     */
+    static void buildMeshlets(MeshBundle& bundle) {
+        bundle.meshlets.clear();
+        if (bundle.empty() || bundle.levels[0].primitive != Mesh::TRIANGLES) return;
+        const InterleavedMesh& m = bundle.levels[0];
+        size_t count = m.indexCount() ? m.indexCount() : m.vertices.size();
+        count -= count % 3;
+        auto index = [&m](size_t i) -> uint32_t {
+            if (!m.indexCount()) return (uint32_t)i;
+            return m.wideIndices ? m.indices32[i] : m.indices16[i];
+        };
+
+        for (size_t first = 0; first < count; first += kMeshletTriangles * 3) {
+            size_t last = std::min(count, first + kMeshletTriangles * 3);
+            MeshBundle::Meshlet ml;
+            ml.indexOffset = (uint32_t)first;
+            ml.indexCount = (uint32_t)(last - first);
+
+            // Bounding sphere about the box centre
+            float lo[3], hi[3];
+            for (int c = 0; c < 3; c++) lo[c] = hi[c] = m.vertices[index(first)].position[c];
+            for (size_t i = first; i < last; i++) {
+                const float* p = m.vertices[index(i)].position;
+                for (int c = 0; c < 3; c++) {
+                    lo[c] = std::min(lo[c], p[c]);
+                    hi[c] = std::max(hi[c], p[c]);
+                }
+            }
+            for (int c = 0; c < 3; c++) ml.center[c] = 0.5f * (lo[c] + hi[c]);
+            float r2 = 0.0f;
+            for (size_t i = first; i < last; i++) {
+                const float* p = m.vertices[index(i)].position;
+                float dx = p[0] - ml.center[0], dy = p[1] - ml.center[1], dz = p[2] - ml.center[2];
+                r2 = std::max(r2, dx * dx + dy * dy + dz * dz);
+            }
+            ml.radius = std::sqrt(r2);
+
+            // Normal cone from face normals
+            std::vector<float> normals;
+            normals.reserve((last - first));
+            float axis[3] = {0.0f, 0.0f, 0.0f};
+            for (size_t i = first; i < last; i += 3) {
+                const float* a = m.vertices[index(i)].position;
+                const float* b = m.vertices[index(i + 1)].position;
+                const float* c = m.vertices[index(i + 2)].position;
+                float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+                float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+                float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2],
+                               e1[0] * e2[1] - e1[1] * e2[0] };
+                float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (len <= 0.0f) continue;  // Degenerate: faces nowhere
+                for (int k = 0; k < 3; k++) {
+                    normals.push_back(n[k] / len);
+                    axis[k] += n[k] / len;
+                }
+            }
+            float axisLen = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+            if (axisLen > 0.0f) {
+                float minDot = 1.0f;
+                for (int k = 0; k < 3; k++) ml.coneAxis[k] = axis[k] / axisLen;
+                for (size_t i = 0; i < normals.size(); i += 3) {
+                    minDot = std::min(minDot, normals[i] * ml.coneAxis[0] +
+                                              normals[i + 1] * ml.coneAxis[1] +
+                                              normals[i + 2] * ml.coneAxis[2]);
+                }
+                // Cone wider than a hemisphere can always see some face
+                ml.coneCutoff = minDot <= 0.0f ? 2.0f : std::sqrt(1.0f - minDot * minDot);
+            } else {
+                ml.coneCutoff = 2.0f;
+            }
+            bundle.meshlets.push_back(ml);
+        }
+    }
+
+    // ── Serialization ──
+
+    /// Serialize to the .almc layout. Returns false for an empty bundle.
+    static bool write(const MeshBundle& bundle, std::vector<uint8_t>& out) {
+        out.clear();
+        if (bundle.empty()) return false;
+
+        FileHeader header;
+        header.sourceKey = bundle.sourceKey;
+        header.primitive = (uint32_t)bundle.levels[0].primitive;
+        header.levelCount = (uint32_t)bundle.levels.size();
+        header.meshletCount = (uint32_t)bundle.meshlets.size();
+        for (const InterleavedMesh& m : bundle.levels) {
+            if (m.wideIndices) header.flags |= kFlagWideIndices;
+            header.vertexCount += (uint32_t)m.vertices.size();
+            header.indexCount += (uint32_t)m.indexCount();
+        }
+        for (int c = 0; c < 3; c++) {
+            header.boundsMin[c] = bundle.boundsMin[c];
+            header.boundsMax[c] = bundle.boundsMax[c];
+        }
+        bool wide = (header.flags & kFlagWideIndices) != 0;
+        size_t indexSize = wide ? sizeof(uint32_t) : sizeof(uint16_t);
+
+        out.resize(fileSize(header));
+        uint8_t* p = out.data();
+        memcpy(p, &header, sizeof(header));
+        p += sizeof(header);
+
+        uint32_t vertexOffset = 0, indexOffset = 0;
+        for (size_t i = 0; i < bundle.levels.size(); i++) {
+            const InterleavedMesh& m = bundle.levels[i];
+            LevelRecord rec;
+            rec.vertexOffset = vertexOffset;
+            rec.vertexCount = (uint32_t)m.vertices.size();
+            rec.indexOffset = indexOffset;
+            rec.indexCount = (uint32_t)m.indexCount();
+            rec.maxDistance = i < bundle.maxDistance.size() ? bundle.maxDistance[i] : 10.0f;
+            rec.screenCoverage = i < bundle.screenCoverage.size() ? bundle.screenCoverage[i] : 0.5f;
+            memcpy(p, &rec, sizeof(rec));
+            p += sizeof(rec);
+            vertexOffset += rec.vertexCount;
+            indexOffset += rec.indexCount;
+        }
+
+        if (!bundle.meshlets.empty()) {
+            memcpy(p, bundle.meshlets.data(), bundle.meshlets.size() * sizeof(MeshBundle::Meshlet));
+            p += bundle.meshlets.size() * sizeof(MeshBundle::Meshlet);
+        }
+        for (const InterleavedMesh& m : bundle.levels) {
+            if (m.vertices.empty()) continue;
+            memcpy(p, m.vertices.data(), m.vertices.size() * sizeof(InterleavedVertex));
+            p += m.vertices.size() * sizeof(InterleavedVertex);
+        }
+        for (const InterleavedMesh& m : bundle.levels) {
+            size_t n = m.indexCount();
+            if (!n) continue;
+            if (wide == m.wideIndices) {
+                memcpy(p, m.indexData(), n * indexSize);
+            } else {
+                // Mixed widths: this level is 16-bit but the file is 32-bit
+                for (size_t i = 0; i < n; i++) {
+                    uint32_t v = m.indices16[i];
+                    memcpy(p + i * sizeof(v), &v, sizeof(v));
+                }
+            }
+            p += n * indexSize;
+        }
+        return true;
+    }
+
+    /**
+     * Load a serialized bundle: validates the header and copies each
+     * section straight into the level arrays. Returns false (and leaves
+     * `out` empty) for a wrong magic or version, or a truncated file.
+     */
+    static bool read(const uint8_t* data, size_t size, MeshBundle& out) {
+        out.clear();
+        FileHeader header;
+        if (!data || size < sizeof(header)) return false;
+        memcpy(&header, data, sizeof(header));
+        if (header.magic != kMagic || header.version != kVersion ||
+            header.vertexStride != sizeof(InterleavedVertex) || header.levelCount == 0 ||
+            size < fileSize(header)) {
+            return false;
+        }
+        bool wide = (header.flags & kFlagWideIndices) != 0;
+        size_t indexSize = wide ? sizeof(uint32_t) : sizeof(uint16_t);
+
+        const uint8_t* records = data + sizeof(header);
+        const uint8_t* meshlets = records + header.levelCount * sizeof(LevelRecord);
+        const uint8_t* vertices = meshlets + header.meshletCount * sizeof(MeshBundle::Meshlet);
+        const uint8_t* indices = vertices + size_t(header.vertexCount) * sizeof(InterleavedVertex);
+
+        out.levels.resize(header.levelCount);
+        for (uint32_t i = 0; i < header.levelCount; i++) {
+            LevelRecord rec;
+            memcpy(&rec, records + i * sizeof(rec), sizeof(rec));
+            if (uint64_t(rec.vertexOffset) + rec.vertexCount > header.vertexCount ||
+                uint64_t(rec.indexOffset) + rec.indexCount > header.indexCount) {
+                out.clear();
+                return false;
+            }
+            InterleavedMesh& m = out.levels[i];
+            m.primitive = (Mesh::Primitive)header.primitive;
+            m.wideIndices = wide;
+            m.vertices.resize(rec.vertexCount);
+            if (rec.vertexCount) {
+                memcpy(m.vertices.data(), vertices + size_t(rec.vertexOffset) * sizeof(InterleavedVertex),
+                       rec.vertexCount * sizeof(InterleavedVertex));
+            }
+            const uint8_t* src = indices + size_t(rec.indexOffset) * indexSize;
+            if (wide) {
+                m.indices32.resize(rec.indexCount);
+                if (rec.indexCount) memcpy(m.indices32.data(), src, rec.indexCount * indexSize);
+            } else {
+                m.indices16.resize(rec.indexCount);
+                if (rec.indexCount) memcpy(m.indices16.data(), src, rec.indexCount * indexSize);
+            }
+            m.computeBounds();
+            out.maxDistance.push_back(rec.maxDistance);
+            out.screenCoverage.push_back(rec.screenCoverage);
+        }
+
+        out.meshlets.resize(header.meshletCount);
+        if (header.meshletCount) {
+            memcpy(out.meshlets.data(), meshlets, header.meshletCount * sizeof(MeshBundle::Meshlet));
+        }
+        for (int c = 0; c < 3; c++) {
+            out.boundsMin[c] = header.boundsMin[c];
+            out.boundsMax[c] = header.boundsMax[c];
+        }
+        out.sourceKey = header.sourceKey;
+        return true;
+    }
+
+    // ── Files ──
+
+    static bool save(const MeshBundle& bundle, const std::string& path) {
+        std::vector<uint8_t> bytes;
+        if (!write(bundle, bytes)) return false;
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) {
+            printf("[WebMeshCache] Cannot write %s\n", path.c_str());
+            return false;
+        }
+        bool ok = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+        fclose(f);
+        if (ok) persist();
+        return ok;
+    }
+
+    static bool load(const std::string& path, MeshBundle& out) {
+        out.clear();
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) return false;
+        fseek(f, 0, SEEK_END);
+        long size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        std::vector<uint8_t> bytes(size > 0 ? (size_t)size : 0);
+        bool ok = size > 0 && fread(bytes.data(), 1, bytes.size(), f) == bytes.size();
+        fclose(f);
+        return ok && read(bytes.data(), bytes.size(), out);
+    }
+
+    /// Fetch a preprocessed .almc file (e.g. served by the backend)
+    static void loadFromURL(const std::string& url, MeshBundle& out, LoadCallback callback) {
+        WebFile::loadFromURL(url, [&out, url, callback](const UploadedFile& file) {
+            bool ok = read(file.data.data(), file.data.size(), out);
+            if (!ok) printf("[WebMeshCache] Not a mesh cache file: %s\n", url.c_str());
+            if (callback) callback(ok);
+        });
+    }
+
+    // ── Content-keyed cache ──
+
+    /**
+     * Directory bundles are cached in. Defaults to /meshcache, which
+     * runtime.ts mounts as IDBFS; native builds default to empty, which
+     * disables the cache.
+     */
+    static void setCacheDirectory(const std::string& dir) { cacheDirectory() = dir; }
+    static std::string& cacheDirectory() {
+#ifdef __EMSCRIPTEN__
+        static std::string dir = "/meshcache";
+#else
+        static std::string dir;
+#endif
+        return dir;
+    }
+
+    /**
+     * 64-bit FNV-1a over the source file, eight bytes per step so hashing
+     * stays well below parse cost. `settings` folds in whatever shapes the
+     * bundle (importer, LOD levels) so different builds don't collide.
+     */
+    static uint64_t contentKey(const uint8_t* data, size_t size, uint64_t settings) {
+        uint64_t h = 1469598103934665603ull ^ kVersion;
+        auto mix = [&h](uint64_t w) {
+            h ^= w;
+            h *= 1099511628211ull;
+        };
+        mix(settings);
+        mix(size);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t w;
+            memcpy(&w, data + i, sizeof(w));
+            mix(w);
+        }
+        uint64_t tail = 0;
+        if (i < size) memcpy(&tail, data + i, size - i);
+        mix(tail);
+        return h ? h : 1;
+    }
+
+    static std::string cachePath(uint64_t key) {
+        char name[32];
+        snprintf(name, sizeof(name), "/%016llx.almc", (unsigned long long)key);
+        return cacheDirectory() + name;
+    }
+
+    /**
+     * Load the bundle cached for these source bytes, or run `build` and
+     * cache its result. With no cache directory this is just `build`.
+     */
+    static bool loadOrBuild(const uint8_t* data, size_t size, uint64_t settings, MeshBundle& out,
+                            const std::function<bool(MeshBundle&)>& buildBundle) {
+        uint64_t key = cacheDirectory().empty() ? 0 : contentKey(data, size, settings);
+        if (key && load(cachePath(key), out) && out.sourceKey == key) {
+            printf("[WebMeshCache] Loaded %s (%d levels, %zu vertices)\n",
+                   cachePath(key).c_str(), out.numLevels(), out.levels[0].vertices.size());
+            return true;
+        }
+        if (!buildBundle(out) || out.empty()) return false;
+        out.sourceKey = key;
+        if (key) save(out, cachePath(key));
+        return true;
+    }
+
+private:
+    static constexpr uint32_t kFlagWideIndices = 1u << 0;
+
+    struct FileHeader {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        uint64_t sourceKey = 0;
+        uint32_t flags = 0;
+        uint32_t primitive = 0;
+        uint32_t vertexStride = sizeof(InterleavedVertex);
+        uint32_t vertexCount = 0;     // Summed over levels
+        uint32_t indexCount = 0;      // Summed over levels
+        uint32_t levelCount = 0;
+        uint32_t meshletCount = 0;
+        uint32_t reserved = 0;
+        float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+        float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+    };
+    static_assert(sizeof(FileHeader) == 72, "FileHeader layout is part of the file format");
+
+    struct LevelRecord {
+        uint32_t vertexOffset = 0;
+        uint32_t vertexCount = 0;
+        uint32_t indexOffset = 0;
+        uint32_t indexCount = 0;
+        float maxDistance = 0.0f;
+        float screenCoverage = 0.0f;
+    };
+    static_assert(sizeof(MeshBundle::Meshlet) == 40, "Meshlet layout is part of the file format");
+
+    static size_t fileSize(const FileHeader& h) {
+        size_t indexSize = (h.flags & kFlagWideIndices) ? sizeof(uint32_t) : sizeof(uint16_t);
+        size_t indexBytes = (size_t(h.indexCount) * indexSize + 3) & ~size_t(3);
+        return sizeof(FileHeader) + h.levelCount * sizeof(LevelRecord) +
+               h.meshletCount * sizeof(MeshBundle::Meshlet) +
+               size_t(h.vertexCount) * sizeof(InterleavedVertex) + indexBytes;
+    }
+
+    /// Bounds over every level, then meshlets for level 0
+    static void finish(MeshBundle& bundle) {
+        for (InterleavedMesh& m : bundle.levels) m.computeBounds();
+        if (bundle.empty()) return;
+        for (int c = 0; c < 3; c++) {
+            bundle.boundsMin[c] = bundle.levels[0].boundsMin[c];
+            bundle.boundsMax[c] = bundle.levels[0].boundsMax[c];
+        }
+        buildMeshlets(bundle);
+    }
+
+    static void persist() {
+#ifdef __EMSCRIPTEN__
+        // Flush to IndexedDB so the next page load finds the bundle
+        EM_ASM({
+            if (typeof FS !== 'undefined' && FS.syncfs) {
+                FS.syncfs(false, function(err) {
+                    if (err) console.warn('[IDBFS] Mesh cache persist failed:', err);
+                });
+            }
+        });
+#endif
+    }
+};
+
+} // namespace al
+
+#endif // AL_WEB_MESH_CACHE_HPP
@@ -0,0 +1,481 @@
+/**
+ * Web Mesh Optimizer - Index and vertex reordering for GPU cache efficiency
+ *
+ * Imported and simplified meshes come out in file or collapse order, which
+ * gives the post-transform vertex cache little reuse and draws dense meshes
+ * with heavy overdraw. MeshOptimizer reorders them in place without changing
+ * what is drawn:
+ *
+ * - Indexing: triangle soups (OBJ, glTF) are welded into an indexed mesh by
+ *   merging vertices whose attributes are bit-identical.
+ * - Vertex cache: triangles are reordered with Tipsify (Sander et al. 2007),
+ *   fanning around the vertex most likely to still be in a FIFO cache.
+ * - Overdraw: the Tipsify order is cut into clusters at cache resets and
+ *   where a cluster's ACMR is already good, then clusters are sorted so the
+ *   outward-facing ones draw first. The result is kept only if ACMR stays
+ *   within the threshold of the cache-optimal order.
+ * - Vertex fetch: vertices are reordered to first use so the vertex buffer
+ *   is read front to back; unreferenced vertices are dropped.
+ *
+ * ACMR (average cache miss ratio, misses per triangle, 0.5-3.0) before and
+ * after is kept in lastStats() and totals().
+ *
+ * Usage:
+ *   MeshOptimizer::optimize(mesh);
+ *   printf("ACMR %.2f\n", MeshOptimizer::lastStats().acmrAfter);
+ *
+ *   // Imports and LOD levels run optimize() automatically; opt out with
+ *   MeshOptimizer::setAutoOptimize(false);
+ */
+
+#ifndef AL_WEB_MESH_OPTIMIZE_HPP
+#define AL_WEB_MESH_OPTIMIZE_HPP
+
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+#include "al/graphics/al_Mesh.hpp"
+#include "al/math/al_Vec.hpp"
+
+namespace al {
+
+class MeshOptimizer {
+public:
+    /// Post-transform cache size the orderings target and ACMR is measured with
+    static constexpr int kCacheSize = 16;
+
+    struct Stats {
+        int vertices = 0;         // After indexing
+        int triangles = 0;
+        float acmrBefore = 0.0f;  // Misses per triangle in the incoming order
+        float acmrAfter = 0.0f;
+        float atvr = 0.0f;        // Misses per vertex after (1.0 is optimal)
+        int clusters = 0;         // Overdraw clusters in the final order
+        double ms = 0.0;
+    };
+
+    struct Totals {
+        int meshes = 0;
+        long long triangles = 0;
+        double missesBefore = 0.0;
+        double missesAfter = 0.0;
+        /// Triangle-weighted ACMR over every optimized mesh
+        float acmrBefore() const { return triangles ? (float)(missesBefore / triangles) : 0.0f; }
+        float acmrAfter() const { return triangles ? (float)(missesAfter / triangles) : 0.0f; }
+    };
+
+    /**
+     * Weld, reorder for vertex cache and overdraw, then reorder vertex fetch
+     * @param overdrawThreshold ACMR the overdraw order may cost, relative to
+     *        the cache-only order (1.0 disables overdraw ordering)
+     * @return false if the mesh is not a triangle list or has no triangles
+     */
+    static bool optimize(Mesh& mesh, float overdrawThreshold = 1.05f, bool verbose = false) {
+        if (mesh.primitive() != Mesh::TRIANGLES) return false;
+        auto start = std::chrono::high_resolution_clock::now();
+
+        Stats s;
+        if (mesh.indices().empty()) {
+            int soup = (int)mesh.vertices().size();
+            // A soup has no reuse to lose: every corner is a miss
+            s.acmrBefore = soup >= 3 ? 3.0f : 0.0f;
+            if (!weld(mesh)) return false;
+        } else {
+            s.acmrBefore = acmr(mesh.indices(), (int)mesh.vertices().size());
+        }
+
+        auto& indices = mesh.indices();
+        int vertexCount = (int)mesh.vertices().size();
+        if (indices.size() < 3 || vertexCount == 0) return false;
+        indices.resize(indices.size() - indices.size() % 3);
+
+        std::vector<unsigned> hardBounds;
+        optimizeVertexCache(indices, vertexCount, &hardBounds);
+        s.clusters = optimizeOverdraw(indices, mesh.vertices(), hardBounds, overdrawThreshold);
+        optimizeVertexFetch(mesh);
+
+        s.vertices = (int)mesh.vertices().size();
+        s.triangles = (int)(indices.size() / 3);
+        s.acmrAfter = acmr(indices, s.vertices);
+        s.atvr = s.vertices ? s.acmrAfter * s.triangles / s.vertices : 0.0f;
+        s.ms = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count();
+
+        lastStats() = s;
+        Totals& t = totals();
+        t.meshes++;
+        t.triangles += s.triangles;
+        t.missesBefore += (double)s.acmrBefore * s.triangles;
+        t.missesAfter += (double)s.acmrAfter * s.triangles;
+
+        if (verbose) {
+            printf("[MeshOpt] %d tris, %d verts: ACMR %.3f -> %.3f (ATVR %.3f), "
+                   "%d clusters, %.1f ms\n",
+                   s.triangles, s.vertices, s.acmrBefore, s.acmrAfter, s.atvr,
+                   s.clusters, s.ms);
+        }
+        return true;
+    }
+
+    /// Stats from the most recent optimize()
+    static Stats& lastStats() {
+        static Stats s;
+        return s;
+    }
+
+    /// Running totals across every optimize() since startup
+    static Totals& totals() {
+        static Totals t;
+        return t;
+    }
+
+    /// Whether WebOBJ, WebGLTF and LODMesh run optimize() on what they build
+    static void setAutoOptimize(bool enabled) { autoFlag() = enabled; }
+    static bool autoOptimize() { return autoFlag(); }
+
+    /**
+     * FIFO cache simulation
+     * @return misses per triangle
+     */
+    static float acmr(const std::vector<unsigned>& indices, int vertexCount,
+                      int cacheSize = kCacheSize) {
+        size_t triangles = indices.size() / 3;
+        if (triangles == 0) return 0.0f;
+        std::vector<unsigned> stamp(vertexCount, 0);
+        unsigned time = cacheSize + 1;
+        size_t misses = 0;
+        for (size_t i = 0; i < triangles * 3; i++) {
+            unsigned v = indices[i];
+            if (v >= (unsigned)vertexCount) continue;
+            if (time - stamp[v] > (unsigned)cacheSize) {
+                stamp[v] = time++;
+                misses++;
+            }
+        }
+        return (float)misses / triangles;
+    }
+
+    // ── Passes ──
+
+    /**
+     * Turn a triangle soup into an indexed mesh, merging vertices whose
+     * position, normal, texcoord and color are bit-identical
+     */
+    static bool weld(Mesh& mesh) {
+        auto& verts = mesh.vertices();
+        auto& normals = mesh.normals();
+        auto& uvs = mesh.texCoord2s();
+        auto& colors = mesh.colors();
+        size_t n = verts.size();
+        if (n < 3 || !mesh.indices().empty()) return false;
+
+        const bool hasN = normals.size() == n;
+        const bool hasT = uvs.size() == n;
+        const bool hasC = colors.size() == n;
+
+        auto hashBytes = [](uint64_t h, const void* p, size_t len) {
+            const unsigned char* b = (const unsigned char*)p;
+            for (size_t i = 0; i < len; i++) { h ^= b[i]; h *= 1099511628211ull; }
+            return h;
+        };
+        auto same = [&](size_t a, size_t b) {
+            return memcmp(&verts[a], &verts[b], sizeof(verts[a])) == 0 &&
+                   (!hasN || memcmp(&normals[a], &normals[b], sizeof(normals[a])) == 0) &&
+                   (!hasT || memcmp(&uvs[a], &uvs[b], sizeof(uvs[a])) == 0) &&
+                   (!hasC || memcmp(&colors[a], &colors[b], sizeof(colors[a])) == 0);
+        };
+
+        std::unordered_map<uint64_t, std::vector<unsigned>> buckets;
+        buckets.reserve(n);
+        std::vector<unsigned> remap(n);
+        std::vector<unsigned> unique;
+        unique.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            uint64_t h = 14695981039346656037ull;
+            h = hashBytes(h, &verts[i], sizeof(verts[i]));
+            if (hasN) h = hashBytes(h, &normals[i], sizeof(normals[i]));
+            if (hasT) h = hashBytes(h, &uvs[i], sizeof(uvs[i]));
+            if (hasC) h = hashBytes(h, &colors[i], sizeof(colors[i]));
+
+            auto& bucket = buckets[h];
+            unsigned found = (unsigned)-1;
+            for (unsigned u : bucket) {
+                if (same(unique[u], i)) { found = u; break; }
+            }
+            if (found == (unsigned)-1) {
+                found = (unsigned)unique.size();
+                unique.push_back((unsigned)i);
+                bucket.push_back(found);
+            }
+            remap[i] = found;
+        }
+
+        auto compact = [&](auto& arr, bool present) {
+            if (!present) { arr.clear(); return; }
+            for (size_t u = 0; u < unique.size(); u++) arr[u] = arr[unique[u]];
+            arr.resize(unique.size());
+        };
+        compact(verts, true);
+        compact(normals, hasN);
+        compact(uvs, hasT);
+        compact(colors, hasC);
+
+        auto& indices = mesh.indices();
+        indices.assign(remap.begin(), remap.begin() + (n - n % 3));
+        return true;
+    }
+
+    /**
+     * Tipsify: emit every live triangle around the current fan vertex, then
+     * move to the adjacent vertex that will still be cached by the time its
+     * remaining triangles are emitted
+     * @param hardBounds if set, receives the triangle offsets where the fan
+     *        jumped to a non-adjacent vertex (the cache is effectively cold)
+     */
+    static void optimizeVertexCache(std::vector<unsigned>& indices, int vertexCount,
+                                    std::vector<unsigned>* hardBounds = nullptr,
+                                    int cacheSize = kCacheSize) {
+        size_t triangles = indices.size() / 3;
+        if (hardBounds) hardBounds->clear();
+        if (triangles == 0) return;
+
+        // Vertex -> triangle adjacency (CSR)
+        std::vector<unsigned> offset(vertexCount + 1, 0);
+        for (size_t i = 0; i < triangles * 3; i++) offset[indices[i] + 1]++;
+        for (int v = 0; v < vertexCount; v++) offset[v + 1] += offset[v];
+        std::vector<unsigned> adjacency(triangles * 3);
+        std::vector<unsigned> live(vertexCount, 0);
+        {
+            std::vector<unsigned> fill(offset.begin(), offset.end() - 1);
+            for (size_t t = 0; t < triangles; t++) {
+                for (int c = 0; c < 3; c++) {
+                    unsigned v = indices[t * 3 + c];
+                    adjacency[fill[v]++] = (unsigned)t;
+                    live[v]++;
+                }
+            }
+        }
+
+        std::vector<unsigned> stamp(vertexCount, 0);
+        std::vector<char> emitted(triangles, 0);
+        std::vector<unsigned> deadEnd;
+        std::vector<unsigned> candidates;
+        std::vector<unsigned> result;
+        result.reserve(triangles * 3);
+
+        unsigned time = cacheSize + 1;
+        int cursor = 0;
+        int fan = 0;
+        while (fan >= 0) {
+            candidates.clear();
+            for (unsigned a = offset[fan]; a < offset[fan + 1]; a++) {
+                unsigned t = adjacency[a];
+                if (emitted[t]) continue;
+                emitted[t] = 1;
+                for (int c = 0; c < 3; c++) {
+                    unsigned v = indices[t * 3 + c];
+                    result.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    live[v]--;
+                    if (time - stamp[v] > (unsigned)cacheSize) stamp[v] = time++;
+                }
+            }
+
+            // Best adjacent vertex that stays cached through its fan
+            int next = -1;
+            int best = 0;
+            for (unsigned v : candidates) {
+                if (live[v] == 0) continue;
+                int age = (int)(time - stamp[v]);
+                int priority = (age + 2 * (int)live[v] <= cacheSize) ? age : 0;
+                if (priority > best) { best = priority; next = (int)v; }
+            }
+            if (next < 0) {
+                while (!deadEnd.empty() && next < 0) {
+                    unsigned v = deadEnd.back();
+                    deadEnd.pop_back();
+                    if (live[v] > 0) next = (int)v;
+                }
+                while (next < 0 && cursor < vertexCount) {
+                    if (live[cursor] > 0) next = cursor;
+                    cursor++;
+                }
+                if (next >= 0 && hardBounds && result.size() < triangles * 3 &&
+                    time - stamp[next] > (unsigned)cacheSize) {
+                    hardBounds->push_back((unsigned)(result.size() / 3));
+                }
+            }
+            fan = next;
+        }
+        indices.swap(result);
+    }
+
+    /**
+     * Reorder clusters of the cache-optimized order so triangles facing away
+     * from the mesh centre draw first and occlude the ones behind them
+     * @return cluster count in the final order (1 when overdraw ordering was
+     *         skipped or rejected)
+     */
+    static int optimizeOverdraw(std::vector<unsigned>& indices,
+                                const std::vector<Vec3f>& positions,
+                                const std::vector<unsigned>& hardBounds,
+                                float threshold = 1.05f,
+                                int cacheSize = kCacheSize) {
+        size_t triangles = indices.size() / 3;
+        int vertexCount = (int)positions.size();
+        if (threshold <= 1.0f || triangles < 2) return 1;
+
+        // Cluster starts: hard bounds, then soft splits wherever a run's own
+        // ACMR already matches its hard cluster's within the threshold
+        std::vector<unsigned> bounds;
+        std::vector<unsigned> stamp(vertexCount, 0);
+        unsigned time = cacheSize + 1;
+        auto miss = [&](unsigned t) {
+            int m = 0;
+            for (int c = 0; c < 3; c++) {
+                unsigned v = indices[t * 3 + c];
+                if (time - stamp[v] > (unsigned)cacheSize) { stamp[v] = time++; m++; }
+            }
+            return m;
+        };
+        auto flush = [&]() { time += cacheSize + 1; };
+
+        std::vector<unsigned> hard;
+        hard.push_back(0);
+        for (unsigned b : hardBounds) if (b > hard.back() && b < triangles) hard.push_back(b);
+        hard.push_back((unsigned)triangles);
+
+        for (size_t h = 0; h + 1 < hard.size(); h++) {
+            unsigned begin = hard[h], end = hard[h + 1];
+            flush();
+            int clusterMisses = 0;
+            for (unsigned t = begin; t < end; t++) clusterMisses += miss(t);
+            float clusterAcmr = (float)clusterMisses / (end - begin);
+
+            flush();
+            bounds.push_back(begin);
+            unsigned first = begin;
+            int misses = 0;
+            for (unsigned t = begin; t < end; t++) {
+                misses += miss(t);
+                unsigned count = t + 1 - first;
+                if (t + 1 < end && count >= 8 &&
+                    (float)misses / count <= clusterAcmr * threshold) {
+                    bounds.push_back(t + 1);
+                    first = t + 1;
+                    misses = 0;
+                    flush();
+                }
+            }
+        }
+        if (bounds.size() < 2) return 1;
+        bounds.push_back((unsigned)triangles);
+
+        // Mesh centroid, area-weighted
+        Vec3f centroid(0, 0, 0);
+        float totalArea = 0.0f;
+        for (size_t t = 0; t < triangles; t++) {
+            const Vec3f& a = positions[indices[t * 3]];
+            const Vec3f& b = positions[indices[t * 3 + 1]];
+            const Vec3f& c = positions[indices[t * 3 + 2]];
+            float area = cross(b - a, c - a).mag();
+            centroid += (a + b + c) * (area / 3.0f);
+            totalArea += area;
+        }
+        if (totalArea <= 0.0f) return 1;
+        centroid /= totalArea;
+
+        // Sort key: how far the cluster faces away from the centroid
+        struct Cluster { unsigned begin, end; float key; };
+        std::vector<Cluster> clusters;
+        clusters.reserve(bounds.size() - 1);
+        for (size_t i = 0; i + 1 < bounds.size(); i++) {
+            Vec3f center(0, 0, 0), normal(0, 0, 0);
+            float area = 0.0f;
+            for (unsigned t = bounds[i]; t < bounds[i + 1]; t++) {
+                const Vec3f& a = positions[indices[t * 3]];
+                const Vec3f& b = positions[indices[t * 3 + 1]];
+                const Vec3f& c = positions[indices[t * 3 + 2]];
+                Vec3f n = cross(b - a, c - a);
+                float ta = n.mag();
+                center += (a + b + c) * (ta / 3.0f);
+                normal += n;
+                area += ta;
+            }
+            float key = 0.0f;
+            float nl = normal.mag();
+            if (area > 0.0f && nl > 0.0f) {
+                center /= area;
+                key = dot(center - centroid, normal / nl);
+            }
+            clusters.push_back({bounds[i], bounds[i + 1], key});
+        }
+        std::stable_sort(clusters.begin(), clusters.end(),
+                         [](const Cluster& a, const Cluster& b) { return a.key > b.key; });
+
+        std::vector<unsigned> sorted;
+        sorted.reserve(indices.size());
+        for (const auto& c : clusters) {
+            sorted.insert(sorted.end(), indices.begin() + c.begin * 3, indices.begin() + c.end * 3);
+        }
+
+        // Keep the cache-optimal order if sorting cost too many misses
+        float before = acmr(indices, vertexCount, cacheSize);
+        float after = acmr(sorted, vertexCount, cacheSize);
+        if (after > before * threshold) return 1;
+        indices.swap(sorted);
+        return (int)clusters.size();
+    }
+
+    /**
+     * Renumber vertices in first-use order and permute every per-vertex
+     * attribute to match; vertices no triangle references are dropped
+     */
+    static void optimizeVertexFetch(Mesh& mesh) {
+        auto& indices = mesh.indices();
+        auto& verts = mesh.vertices();
+        size_t n = verts.size();
+        if (indices.empty() || n == 0) return;
+
+        std::vector<unsigned> remap(n, (unsigned)-1);
+        std::vector<unsigned> order;
+        order.reserve(n);
+        for (auto& idx : indices) {
+            if (remap[idx] == (unsigned)-1) {
+                remap[idx] = (unsigned)order.size();
+                order.push_back(idx);
+            }
+            idx = remap[idx];
+        }
+
+        auto permute = [&](auto& arr) {
+            if (arr.size() != n) return;
+            auto copy = arr;
+            arr.resize(order.size());
+            for (size_t i = 0; i < order.size(); i++) arr[i] = copy[order[i]];
+        };
+        permute(verts);
+        permute(mesh.normals());
+        permute(mesh.colors());
+        permute(mesh.texCoord2s());
+        permute(mesh.texCoord1s());
+        permute(mesh.texCoord3s());
+    }
+
+private:
+    static bool& autoFlag() {
+        static bool enabled = true;
+        return enabled;
+    }
+};
+
+} // namespace al
+
+#endif // AL_WEB_MESH_OPTIMIZE_HPP
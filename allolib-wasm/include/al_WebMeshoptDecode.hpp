@@ -0,0 +1,555 @@
+/**
+ * AlloLib Studio Online - meshopt buffer decoding for glTF imports
+ *
+ * Decodes EXT_meshopt_compression / KHR_meshopt_compression buffer views
+ * (the meshoptimizer vertex and index codecs plus their filters) after
+ * cgltf_load_buffers(). Decoded bytes go into cgltf_buffer_view::data,
+ * which cgltf_buffer_view_data() and the accessor readers prefer, so the
+ * Mesh and interleaved extraction paths read them unchanged.
+ *
+ * Supported:
+ *   - vertex codec version 0 (ATTRIBUTES), index codec (TRIANGLES),
+ *     index sequence codec (INDICES)
+ *   - NONE, OCTAHEDRAL, QUATERNION and EXPONENTIAL filters
+ *
+ * Not supported (the asset fails to load with a message, or falls back to
+ * uncompressed data when the file provides it):
+ *   - vertex codec version 1 and the COLOR filter (KHR_meshopt_compression
+ *     encoders targeting meshoptimizer 0.23+)
+ *   - KHR_draco_mesh_compression; primitives keep their fallback accessors
+ *
+ * Vertex byte streams are delta-decoded 16 vertices at a time with wasm
+ * SIMD128 when built with -msimd128, scalar otherwise.
+ *
+ * Usage (after cgltf_load_buffers):
+ *   if (!al::MeshoptDecoder::decodeGLTF(data)) { cgltf_free(data); return false; }
+ *
+ * Header-only so native_compat/al_NativeGLTF.hpp can share it.
+ */
+
+#ifndef AL_WEB_MESHOPT_DECODE_HPP
+#define AL_WEB_MESHOPT_DECODE_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// The TU defining CGLTF_IMPLEMENTATION must not pull the body in twice
+#ifndef CGLTF_H_INCLUDED__
+#include "cgltf.h"
+#endif
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+namespace al {
+
+/**
+ * MeshoptDecoder - meshoptimizer codec decoding
+ *
+ * The decode functions follow the meshoptimizer reference decoder's
+ * return codes: 0 on success, -1 for an unknown header or version, -2 for
+ * truncated input and -3 for trailing bytes.
+ */
+class MeshoptDecoder {
+public:
+    /**
+     * Decode count vertices of stride bytes (a multiple of 4, at most 256)
+     * into dst from a vertex codec stream
+     */
+    static int decodeVertexBuffer(void* dst, size_t count, size_t stride,
+                                  const uint8_t* buffer, size_t size) {
+        if (stride == 0 || stride > 256 || stride % 4 != 0) return -1;
+        if (size < 1 + stride) return -2;
+        if ((buffer[0] & 0xF0) != kVertexHeader) return -1;
+        if ((buffer[0] & 0x0F) != 0) return -1;  // Only version 0
+
+        const uint8_t* data = buffer + 1;
+        const uint8_t* end = buffer + size;
+        uint8_t* out = static_cast<uint8_t*>(dst);
+
+        // The stream ends with the baseline vertex, padded to kTailSize
+        uint8_t last[256];
+        std::memcpy(last, end - stride, stride);
+
+        size_t blockSize = vertexBlockSize(stride);
+        for (size_t first = 0; first < count; first += blockSize) {
+            size_t n = (first + blockSize < count) ? blockSize : count - first;
+            data = decodeVertexBlock(data, end, out + first * stride, n, stride, last);
+            if (!data) return -2;
+        }
+
+        size_t tail = stride < kTailSize ? kTailSize : stride;
+        return size_t(end - data) == tail ? 0 : -3;
+    }
+
+    /**
+     * Decode a triangle list (count a multiple of 3) of indexSize 2 or 4
+     * bytes from an index codec stream
+     */
+    static int decodeIndexBuffer(void* dst, size_t count, size_t indexSize,
+                                 const uint8_t* buffer, size_t size) {
+        if (count % 3 != 0 || (indexSize != 2 && indexSize != 4)) return -1;
+        // Header, one code byte per triangle and the 16-byte codeaux table
+        if (size < 1 + count / 3 + 16) return -2;
+        if ((buffer[0] & 0xF0) != kIndexHeader) return -1;
+        int version = buffer[0] & 0x0F;
+        if (version > 1) return -1;
+
+        uint32_t edgeFifo[16][2];
+        uint32_t vertexFifo[16];
+        std::memset(edgeFifo, -1, sizeof(edgeFifo));
+        std::memset(vertexFifo, -1, sizeof(vertexFifo));
+        size_t edgeOffset = 0;
+        size_t vertexOffset = 0;
+
+        auto pushEdge = [&](uint32_t a, uint32_t b) {
+            edgeFifo[edgeOffset][0] = a;
+            edgeFifo[edgeOffset][1] = b;
+            edgeOffset = (edgeOffset + 1) & 15;
+        };
+        auto pushVertex = [&](uint32_t v, bool cond = true) {
+            vertexFifo[vertexOffset] = v;
+            vertexOffset = (vertexOffset + cond) & 15;
+        };
+        auto write = [&](size_t i, uint32_t a, uint32_t b, uint32_t c) {
+            if (indexSize == 2) {
+                uint16_t* d = static_cast<uint16_t*>(dst) + i;
+                d[0] = uint16_t(a); d[1] = uint16_t(b); d[2] = uint16_t(c);
+            } else {
+                uint32_t* d = static_cast<uint32_t*>(dst) + i;
+                d[0] = a; d[1] = b; d[2] = c;
+            }
+        };
+
+        uint32_t next = 0;
+        uint32_t last = 0;
+        int fecMax = version >= 1 ? 13 : 15;
+
+        const uint8_t* code = buffer + 1;
+        const uint8_t* data = code + count / 3;
+        const uint8_t* safeEnd = buffer + size - 16;
+        const uint8_t* codeauxTable = safeEnd;
+
+        for (size_t i = 0; i < count; i += 3) {
+            // A triangle reads at most 16 bytes, which the codeaux table
+            // after safeEnd covers, so no further bounds checks below
+            if (data > safeEnd) return -2;
+
+            uint8_t codetri = *code++;
+            if (codetri < 0xF0) {
+                // Triangle shares an edge from the FIFO
+                int fe = codetri >> 4;
+                uint32_t a = edgeFifo[(edgeOffset - 1 - fe) & 15][0];
+                uint32_t b = edgeFifo[(edgeOffset - 1 - fe) & 15][1];
+                int fec = codetri & 15;
+
+                uint32_t c;
+                if (fec < fecMax) {
+                    c = (fec == 0) ? next : vertexFifo[(vertexOffset - 1 - fec) & 15];
+                    bool isNext = fec == 0;
+                    next += isNext;
+                    write(i, a, b, c);
+                    pushVertex(c, isNext);
+                } else {
+                    // 13 / 14 are last -1 / +1 (version 1), 15 a coded delta
+                    last = c = (fec != 15) ? last + (fec - (fec ^ 3)) : decodeIndex(data, last);
+                    write(i, a, b, c);
+                    pushVertex(c);
+                }
+                pushEdge(c, b);
+                pushEdge(a, c);
+            } else if (codetri < 0xFE) {
+                // New triangle, vertex references from the codeaux table
+                uint8_t codeaux = codeauxTable[codetri & 15];
+                int feb = codeaux >> 4;
+                int fec = codeaux & 15;
+
+                uint32_t a = next++;
+                uint32_t b = (feb == 0) ? next : vertexFifo[(vertexOffset - feb) & 15];
+                bool bNext = feb == 0;
+                next += bNext;
+                uint32_t c = (fec == 0) ? next : vertexFifo[(vertexOffset - fec) & 15];
+                bool cNext = fec == 0;
+                next += cNext;
+
+                write(i, a, b, c);
+                pushVertex(a);
+                pushVertex(b, bNext);
+                pushVertex(c, cNext);
+                pushEdge(b, a);
+                pushEdge(c, b);
+                pushEdge(a, c);
+            } else {
+                // New triangle, codeaux byte inline
+                uint8_t codeaux = *data++;
+                int fea = codetri == 0xFE ? 0 : 15;
+                int feb = codeaux >> 4;
+                int fec = codeaux & 15;
+                if (codeaux == 0) next = 0;  // Reset
+
+                uint32_t a = (fea == 0) ? next++ : 0;
+                uint32_t b = (feb == 0) ? next++ : vertexFifo[(vertexOffset - feb) & 15];
+                uint32_t c = (fec == 0) ? next++ : vertexFifo[(vertexOffset - fec) & 15];
+                if (fea == 15) last = a = decodeIndex(data, last);
+                if (feb == 15) last = b = decodeIndex(data, last);
+                if (fec == 15) last = c = decodeIndex(data, last);
+
+                write(i, a, b, c);
+                pushVertex(a);
+                pushVertex(b, feb == 0 || feb == 15);
+                pushVertex(c, fec == 0 || fec == 15);
+                pushEdge(b, a);
+                pushEdge(c, b);
+                pushEdge(a, c);
+            }
+        }
+
+        return data == safeEnd ? 0 : -3;
+    }
+
+    /// Decode an arbitrary index list from an index sequence stream
+    static int decodeIndexSequence(void* dst, size_t count, size_t indexSize,
+                                   const uint8_t* buffer, size_t size) {
+        if (indexSize != 2 && indexSize != 4) return -1;
+        // Header, at least one byte per index and a 4-byte tail
+        if (size < 1 + count + 4) return -2;
+        if ((buffer[0] & 0xF0) != kSequenceHeader) return -1;
+        if ((buffer[0] & 0x0F) > 1) return -1;
+
+        const uint8_t* data = buffer + 1;
+        const uint8_t* safeEnd = buffer + size - 4;
+        uint32_t last[2] = {0, 0};
+
+        for (size_t i = 0; i < count; ++i) {
+            // An index is at most 5 bytes; the tail covers the overrun
+            if (data >= safeEnd) return -2;
+            uint32_t v = decodeVByte(data);
+
+            // Low bit picks one of two baselines, the rest is a zigzag delta
+            uint32_t baseline = v & 1;
+            v >>= 1;
+            uint32_t index = last[baseline] + ((v >> 1) ^ (0u - (v & 1)));
+            last[baseline] = index;
+
+            if (indexSize == 2) static_cast<uint16_t*>(dst)[i] = uint16_t(index);
+            else                static_cast<uint32_t*>(dst)[i] = index;
+        }
+
+        return data == safeEnd ? 0 : -3;
+    }
+
+    // ── Filters (applied in place after decodeVertexBuffer) ──
+
+    /// Octahedral normals: int8x4 (stride 4) or int16x4 (stride 8)
+    static void decodeFilterOct(void* data, size_t count, size_t stride) {
+        if (stride == 4) decodeOct(static_cast<int8_t*>(data), count);
+        else             decodeOct(static_cast<int16_t*>(data), count);
+    }
+
+    /// Quaternions with the largest component dropped: int16x4
+    static void decodeFilterQuat(int16_t* data, size_t count) {
+        const float scale = 1.0f / std::sqrt(2.0f);
+        for (size_t i = 0; i < count; ++i) {
+            int16_t* q = data + i * 4;
+            // The scale is stored in the high bits of the 4th component
+            int sf = q[3] | 3;
+            float ss = scale / float(sf);
+            float x = float(q[0]) * ss;
+            float y = float(q[1]) * ss;
+            float z = float(q[2]) * ss;
+            float ww = 1.0f - x * x - y * y - z * z;
+            float w = std::sqrt(ww >= 0.0f ? ww : 0.0f);
+
+            int qc = q[3] & 3;  // Index of the dropped component
+            q[(qc + 1) & 3] = int16_t(roundSigned(x * 32767.0f));
+            q[(qc + 2) & 3] = int16_t(roundSigned(y * 32767.0f));
+            q[(qc + 3) & 3] = int16_t(roundSigned(z * 32767.0f));
+            q[(qc + 0) & 3] = int16_t(int(w * 32767.0f + 0.5f));
+        }
+    }
+
+    /// 24-bit mantissa + 8-bit exponent to float32, for count 4-byte values
+    static void decodeFilterExp(uint32_t* data, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t v = data[i];
+            int32_t m = int32_t(v << 8) >> 8;
+            int32_t e = int32_t(v) >> 24;
+            // ldexp(m, e) with the exponent written straight into a float
+            uint32_t bits = uint32_t(e + 127) << 23;
+            float f;
+            std::memcpy(&f, &bits, sizeof(f));
+            f *= float(m);
+            std::memcpy(&data[i], &f, sizeof(f));
+        }
+    }
+
+    // ── glTF ──
+
+    /**
+     * Decode every meshopt-compressed buffer view of a loaded asset into
+     * cgltf_buffer_view::data (freed by cgltf_free). Returns false if a
+     * view can't be decoded or the asset requires Draco. With `partial`,
+     * views whose source buffer hasn't arrived yet are left for a later
+     * call (progressive loading) instead of failing.
+     */
+    static bool decodeGLTF(cgltf_data* data, bool partial = false) {
+        if (!data) return false;
+
+        for (cgltf_size i = 0; i < data->extensions_required_count; ++i) {
+            if (std::strcmp(data->extensions_required[i], "KHR_draco_mesh_compression") == 0) {
+                std::printf("[WebGLTF] KHR_draco_mesh_compression is required but not "
+                            "supported; re-export with EXT_meshopt_compression\n");
+                return false;
+            }
+        }
+
+        size_t decodedViews = 0;
+        size_t compressedBytes = 0;
+        size_t decodedBytes = 0;
+        for (cgltf_size i = 0; i < data->buffer_views_count; ++i) {
+            cgltf_buffer_view& view = data->buffer_views[i];
+            if (!view.has_meshopt_compression || view.data) continue;
+
+            const cgltf_meshopt_compression& mc = view.meshopt_compression;
+            const uint8_t* src = mc.buffer ? static_cast<const uint8_t*>(mc.buffer->data) : nullptr;
+            if (!src) {
+                if (partial) continue;
+                std::printf("[WebGLTF] meshopt buffer view %zu has no loaded source buffer\n",
+                            (size_t)i);
+                return false;
+            }
+            src += mc.offset;
+
+            void* dst = data->memory.alloc_func(data->memory.user_data, mc.count * mc.stride);
+            if (!dst) return false;
+
+            int result = -1;
+            switch (mc.mode) {
+                case cgltf_meshopt_compression_mode_attributes:
+                    result = decodeVertexBuffer(dst, mc.count, mc.stride, src, mc.size);
+                    break;
+                case cgltf_meshopt_compression_mode_triangles:
+                    result = decodeIndexBuffer(dst, mc.count, mc.stride, src, mc.size);
+                    break;
+                case cgltf_meshopt_compression_mode_indices:
+                    result = decodeIndexSequence(dst, mc.count, mc.stride, src, mc.size);
+                    break;
+                default:
+                    break;
+            }
+
+            if (result == 0) {
+                switch (mc.filter) {
+                    case cgltf_meshopt_compression_filter_none:
+                        break;
+                    case cgltf_meshopt_compression_filter_octahedral:
+                        decodeFilterOct(dst, mc.count, mc.stride);
+                        break;
+                    case cgltf_meshopt_compression_filter_quaternion:
+                        decodeFilterQuat(static_cast<int16_t*>(dst), mc.count);
+                        break;
+                    case cgltf_meshopt_compression_filter_exponential:
+                        decodeFilterExp(static_cast<uint32_t*>(dst), mc.count * mc.stride / 4);
+                        break;
+                    default:
+                        result = -1;  // COLOR filter (codec version 1)
+                        break;
+                }
+            }
+
+            if (result != 0) {
+                data->memory.free_func(data->memory.user_data, dst);
+                std::printf("[WebGLTF] meshopt decode failed for buffer view %zu "
+                            "(mode %d, filter %d): %d\n",
+                            (size_t)i, (int)mc.mode, (int)mc.filter, result);
+                return false;
+            }
+            view.data = dst;
+            decodedViews++;
+            compressedBytes += mc.size;
+            decodedBytes += mc.count * mc.stride;
+        }
+
+        size_t dracoPrims = 0;
+        for (cgltf_size i = 0; i < data->meshes_count; ++i) {
+            for (cgltf_size j = 0; j < data->meshes[i].primitives_count; ++j) {
+                dracoPrims += data->meshes[i].primitives[j].has_draco_mesh_compression;
+            }
+        }
+        if (dracoPrims > 0 && !partial) {
+            std::printf("[WebGLTF] %zu Draco primitives: KHR_draco_mesh_compression is not "
+                        "supported, using their uncompressed fallback accessors\n", dracoPrims);
+        }
+
+        if (decodedViews > 0) {
+            std::printf("[WebGLTF] meshopt: decoded %zu buffer views, %zu KB -> %zu KB\n",
+                        decodedViews, compressedBytes / 1024, decodedBytes / 1024);
+        }
+        return true;
+    }
+
+private:
+    static constexpr uint8_t kVertexHeader = 0xA0;
+    static constexpr uint8_t kIndexHeader = 0xE0;
+    static constexpr uint8_t kSequenceHeader = 0xD0;
+    static constexpr size_t kVertexBlockSizeBytes = 8192;
+    static constexpr size_t kVertexBlockMaxSize = 256;
+    static constexpr size_t kByteGroupSize = 16;
+    static constexpr size_t kByteGroupDecodeLimit = 24;
+    static constexpr size_t kTailSize = 32;
+
+    // Vertices per block: fits the scratch buffer, multiple of the group size
+    static size_t vertexBlockSize(size_t stride) {
+        size_t n = (kVertexBlockSizeBytes / stride) & ~(kByteGroupSize - 1);
+        return n < kVertexBlockMaxSize ? n : kVertexBlockMaxSize;
+    }
+
+    static uint32_t decodeVByte(const uint8_t*& data) {
+        uint8_t lead = *data++;
+        if (lead < 128) return lead;
+
+        uint32_t result = lead & 127;
+        uint32_t shift = 7;
+        for (int i = 0; i < 4; ++i) {
+            uint8_t group = *data++;
+            result |= uint32_t(group & 127) << shift;
+            shift += 7;
+            if (group < 128) break;
+        }
+        return result;
+    }
+
+    static uint32_t decodeIndex(const uint8_t*& data, uint32_t last) {
+        uint32_t v = decodeVByte(data);
+        return last + ((v >> 1) ^ (0u - (v & 1)));
+    }
+
+    // One group of 16 bytes coded with 0, 2, 4 or 8 bits each; 2- and 4-bit
+    // codes of all ones escape to a literal byte after the packed codes
+    static const uint8_t* decodeBytesGroup(const uint8_t* data, uint8_t* out, int bitsLog2) {
+        if (bitsLog2 == 0) {
+            std::memset(out, 0, kByteGroupSize);
+            return data;
+        }
+        if (bitsLog2 == 3) {
+            std::memcpy(out, data, kByteGroupSize);
+            return data + kByteGroupSize;
+        }
+
+        int bits = bitsLog2 == 1 ? 2 : 4;
+        int perByte = 8 / bits;
+        uint8_t escape = uint8_t((1 << bits) - 1);
+        const uint8_t* literals = data + kByteGroupSize / perByte;
+        for (size_t i = 0; i < kByteGroupSize; i += perByte) {
+            uint8_t byte = *data++;
+            for (int k = 0; k < perByte; ++k) {
+                uint8_t code = byte >> (8 - bits);
+                byte = uint8_t(byte << bits);
+                out[i + k] = (code == escape) ? *literals++ : code;
+            }
+        }
+        return literals;
+    }
+
+    static const uint8_t* decodeBytes(const uint8_t* data, const uint8_t* end,
+                                      uint8_t* out, size_t count) {
+        // Two header bits per group select its bit width
+        const uint8_t* header = data;
+        size_t headerSize = (count / kByteGroupSize + 3) / 4;
+        if (size_t(end - data) < headerSize) return nullptr;
+        data += headerSize;
+
+        for (size_t i = 0; i < count; i += kByteGroupSize) {
+            if (size_t(end - data) < kByteGroupDecodeLimit) return nullptr;
+            size_t group = i / kByteGroupSize;
+            int bitsLog2 = (header[group / 4] >> ((group % 4) * 2)) & 3;
+            data = decodeBytesGroup(data, out + i, bitsLog2);
+        }
+        return data;
+    }
+
+    // Each byte of the vertex is its own stream of zigzag deltas from the
+    // same byte of the previous vertex
+    static const uint8_t* decodeVertexBlock(const uint8_t* data, const uint8_t* end,
+                                            uint8_t* out, size_t count, size_t stride,
+                                            uint8_t last[256]) {
+        uint8_t deltas[kVertexBlockMaxSize];
+        size_t aligned = (count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+        for (size_t k = 0; k < stride; ++k) {
+            data = decodeBytes(data, end, deltas, aligned);
+            if (!data) return nullptr;
+
+            uint8_t p = last[k];
+            size_t i = 0;
+#if defined(__wasm_simd128__)
+            // Prefix sum 16 deltas at a time: log2(16) shifted adds
+            const v128_t one = wasm_i8x16_splat(1);
+            const v128_t zero = wasm_i8x16_splat(0);
+            for (; i + kByteGroupSize <= count; i += kByteGroupSize) {
+                v128_t v = wasm_v128_load(deltas + i);
+                v = wasm_v128_xor(wasm_u8x16_shr(v, 1), wasm_i8x16_neg(wasm_v128_and(v, one)));
+                v = wasm_i8x16_add(v, wasm_i8x16_shuffle(zero, v, 15, 16, 17, 18, 19, 20, 21, 22,
+                                                         23, 24, 25, 26, 27, 28, 29, 30));
+                v = wasm_i8x16_add(v, wasm_i8x16_shuffle(zero, v, 14, 15, 16, 17, 18, 19, 20, 21,
+                                                         22, 23, 24, 25, 26, 27, 28, 29));
+                v = wasm_i8x16_add(v, wasm_i8x16_shuffle(zero, v, 12, 13, 14, 15, 16, 17, 18, 19,
+                                                         20, 21, 22, 23, 24, 25, 26, 27));
+                v = wasm_i8x16_add(v, wasm_i8x16_shuffle(zero, v, 8, 9, 10, 11, 12, 13, 14, 15,
+                                                         16, 17, 18, 19, 20, 21, 22, 23));
+                v = wasm_i8x16_add(v, wasm_i8x16_splat(int8_t(p)));
+
+                uint8_t values[kByteGroupSize];
+                wasm_v128_store(values, v);
+                for (size_t j = 0; j < kByteGroupSize; ++j) {
+                    out[(i + j) * stride + k] = values[j];
+                }
+                p = values[kByteGroupSize - 1];
+            }
+#endif
+            for (; i < count; ++i) {
+                uint8_t d = deltas[i];
+                uint8_t v = uint8_t((d >> 1) ^ (0u - (d & 1))) + p;
+                out[i * stride + k] = v;
+                p = v;
+            }
+        }
+
+        std::memcpy(last, out + (count - 1) * stride, stride);
+        return data;
+    }
+
+    static int roundSigned(float v) {
+        return int(v + (v >= 0.0f ? 0.5f : -0.5f));
+    }
+
+    template <typename T>
+    static void decodeOct(T* data, size_t count) {
+        const float maxValue = float((1 << (sizeof(T) * 8 - 1)) - 1);
+        for (size_t i = 0; i < count; ++i) {
+            T* n = data + i * 4;
+            // z is stored as the 1.0 reference at the same bit count
+            float x = float(n[0]);
+            float y = float(n[1]);
+            float z = float(n[2]) - std::fabs(x) - std::fabs(y);
+
+            // Unfold the lower hemisphere
+            float t = z < 0.0f ? z : 0.0f;
+            x += x >= 0.0f ? t : -t;
+            y += y >= 0.0f ? t : -t;
+
+            float s = maxValue / std::sqrt(x * x + y * y + z * z);
+            n[0] = T(roundSigned(x * s));
+            n[1] = T(roundSigned(y * s));
+            n[2] = T(roundSigned(z * s));
+        }
+    }
+};
+
+} // namespace al
+
+#endif // AL_WEB_MESHOPT_DECODE_HPP
@@ -8,6 +8,10 @@
  * - GPU auto-generates full mipmap chain via glGenerateMipmap()
  * - Continuous LOD selection (float, not discrete levels)
  * - Shader samples mip level using textureLod()
+ * - .ktx2 files upload block-compressed with their pre-baked chain instead
+ *   (see WebKTX2)
+ * - Textures are shared by URL through GPUResourceCache: loading a URL
+ *   that is already on the GPU skips the fetch and the upload
  *
  * Usage:
  *   MipmapTexture tex;
@@ -44,6 +48,8 @@
 #include <algorithm>
 
 #include "al_WebImage.hpp"
+#include "al_WebKTX2.hpp"
+#include "al_WebResourceCache.hpp"
 #include "al/graphics/al_OpenGL.hpp"
 
 // Anisotropic filtering extension constants (EXT_texture_filter_anisotropic)
@@ -91,9 +97,35 @@ public:
         mUrl = url;
         mCallback = callback;
 
+        // Already on the GPU for another texture (or a previous scene)
+        if (GPUTextureRef cached = GPUResourceCache::instance().find(cacheKey())) {
+            adopt(cached);
+            printf("[MipmapTexture] Shared: %s (%dx%d)\n", url.c_str(), mWidth, mHeight);
+            if (mCallback) mCallback(true);
+            return;
+        }
+
         printf("[MipmapTexture] Loading: %s\n", url.c_str());
 
-        mImage.load(url, [this](bool success) {
+        if (WebKTX2::isKTX2(url)) {
+            mKTX.load(url, [this](bool success) {
+                if (success) {
+                    mWidth = mKTX.width();
+                    mHeight = mKTX.height();
+                    // A single uncompressed level still gets a generated chain
+                    mMaxMipLevel = (mKTX.numLevels() == 1 && !mKTX.compressed())
+                        ? (int)floor(log2(std::max(mWidth, mHeight)))
+                        : mKTX.numLevels() - 1;
+                    mNeedsUpload = true;
+                }
+                if (mCallback) mCallback(success);
+            });
+            return;
+        }
+
+        mKTX = WebKTX2();
+        // Texture-only: decoded in a worker, uploaded without a heap copy
+        mImage.loadBitmap(url, [this](bool success) {
             if (success && mImage.width() > 0 && mImage.height() > 0) {
                 mWidth = mImage.width();
                 mHeight = mImage.height();
@@ -118,36 +150,59 @@ public:
     void uploadToGPU() {
         if (!mNeedsUpload || mWidth == 0 || mHeight == 0) return;
 
-        // Create texture if needed
-        if (mTextureId == 0) {
-            glGenTextures(1, &mTextureId);
-        }
+        // Another MipmapTexture may have uploaded the same URL meanwhile
+        GPUTextureRef texture = GPUResourceCache::instance().acquire(cacheKey(), [&](GPUTexture& t) {
+            glGenTextures(1, &t.id);
+            glBindTexture(GL_TEXTURE_2D, t.id);
+
+            bool mipmapped = true;
+            t.bytes = (size_t)mWidth * mHeight * 4 * 4 / 3;
+            if (mKTX.ready()) {
+                // Pre-baked chain, every level uploaded as stored
+                mipmapped = mKTX.uploadGL();
+                t.bytes = mKTX.byteSize();
+            } else if (mImage.uploadBitmapGL()) {
+                // Base level straight from the decoded bitmap
+                glGenerateMipmap(GL_TEXTURE_2D);
+            } else {
+                // Upload base level only
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
+                             mWidth, mHeight, 0,
+                             GL_RGBA, GL_UNSIGNED_BYTE, mImage.pixels());
 
-        glBindTexture(GL_TEXTURE_2D, mTextureId);
+                // GPU generates full mipmap chain automatically
+                glGenerateMipmap(GL_TEXTURE_2D);
+            }
 
-        // Upload base level only
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
-                     mWidth, mHeight, 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, mImage.pixels());
-
-        // GPU generates full mipmap chain automatically
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        // Trilinear filtering for smooth mip transitions
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-        // Enable anisotropic filtering if available
-        GLfloat maxAniso = 1.0f;
-        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAniso);
-        if (maxAniso > 1.0f) {
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
-                           std::min(maxAniso, 4.0f));
-        }
+            // Trilinear filtering for smooth mip transitions
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                            mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+            // Enable anisotropic filtering if available
+            GLfloat maxAniso = 1.0f;
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAniso);
+            if (maxAniso > 1.0f) {
+                glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                               std::min(maxAniso, 4.0f));
+            }
 
-        glBindTexture(GL_TEXTURE_2D, 0);
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            t.width = mWidth;
+            t.height = mHeight;
+            t.levels = mMaxMipLevel + 1;
+            return true;
+        });
+
+        // The GPU copy is the only one needed
+        mKTX.release();
+        mImage.release();
+        if (!texture) return;
+        mTexture = texture;
+        mTextureId = texture->id;
 
         mReady = true;
         mNeedsUpload = false;
@@ -160,10 +215,9 @@ public:
      * Destroy GPU resources
      */
     void destroy() {
-        if (mTextureId != 0) {
-            glDeleteTextures(1, &mTextureId);
-            mTextureId = 0;
-        }
+        // Deleted by the cache once no other texture shares it
+        mTexture.reset();
+        mTextureId = 0;
         mReady = false;
     }
 
@@ -266,10 +320,23 @@ private:
 
     std::string mUrl;
     WebImage mImage;
+    WebKTX2 mKTX;
+    GPUTextureRef mTexture;
     LoadCallback mCallback;
 
     bool mReady;
     bool mNeedsUpload;
+
+    std::string cacheKey() const { return "mip:" + mUrl; }
+
+    void adopt(const GPUTextureRef& texture) {
+        mTexture = texture;
+        mTextureId = texture->id;
+        mWidth = texture->width;
+        mHeight = texture->height;
+        mMaxMipLevel = texture->levels - 1;
+        mReady = true;
+    }
 };
 
 /**
@@ -25,8 +25,15 @@
  *   - Texture coordinates (vt u v)
  *   - Normals (vn x y z)
  *   - Faces (f v1/t1/n1 v2/t2/n2 v3/t3/n3)
- *   - Triangles and quads (quads are triangulated)
- *   - Negative indices (relative to end of buffer)
+ *   - Triangles, quads and larger polygons (fan-triangulated)
+ *   - Negative indices (relative to the elements read so far)
+ *
+ * Files with normals come out indexed (one vertex per distinct v/vt/vn);
+ * files without are a triangle soup until MeshOptimizer welds it. Either
+ * is reordered by MeshOptimizer unless MeshOptimizer::setAutoOptimize(false)
+ * was called. examples/obj_bench.cpp times parse() on a 1M-triangle file.
+ * parseCached() keeps the finished result in the binary mesh cache.
+ * load() parses on the JobSystem pool in threaded builds (al_WebJobs.hpp).
  *
  * Does NOT support:
  *   - Multiple objects/groups (all merged into one mesh)
@@ -38,11 +45,14 @@
 #define AL_WEB_OBJ_HPP
 
 #include <emscripten.h>
-#include <string>
-#include <vector>
-#include <sstream>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <functional>
+#include <string>
+#include <vector>
 
 // Forward declare Mesh to avoid circular includes
 namespace al {
@@ -50,8 +60,12 @@ class Mesh;
 }
 
 #include "al/graphics/al_Mesh.hpp"
+#include "al_WebAssetLoader.hpp"
 #include "al_WebFile.hpp"
+#include "al_WebJobs.hpp"
 #include "al_WebLOD.hpp"
+#include "al_WebMeshCache.hpp"
+#include "al_WebMeshOptimize.hpp"
 
 namespace al {
 
@@ -66,193 +80,215 @@ public:
 
     /**
      * Parse OBJ data from memory buffer
+     *
+     * One pass over the bytes, after a line-count prepass that sizes every
+     * array up front. Numbers are read in place with std::from_chars and
+     * faces are triangulated as they are read, so nothing is allocated per
+     * line or per face. Files with normals are welded while parsing: each
+     * distinct v/vt/vn triple becomes one indexed vertex via a flat hash. Files
+     * without normals stay a triangle soup, so generateNormals() keeps the
+     * faceted look. Indices refer to elements defined earlier in the file
+     * (negative ones count back from there); others drop their triangle.
+     *
      * @param data Raw OBJ file data
      * @param size Size of data in bytes
      * @param mesh Output mesh to populate
      * @return true on success
      */
     static bool parse(const uint8_t* data, size_t size, Mesh& mesh) {
-        return parse(std::string(reinterpret_cast<const char*>(data), size), mesh);
-    }
+        const char* begin = reinterpret_cast<const char*>(data);
+        const char* end = begin + size;
+
+        // Prepass: element counts, and whether corners carry vt / vn at all
+        size_t numPositions = 0, numTexcoords = 0, numNormals = 0, numFaces = 0;
+        for (const char* line = begin; line < end;) {
+            const char* next = nextLine(line, end);
+            const char* p = skipSpaces(line, next);
+            if (next - p >= 2) {
+                if (p[0] == 'v') {
+                    if (isSpace(p[1])) numPositions++;
+                    else if (p[1] == 't') numTexcoords++;
+                    else if (p[1] == 'n') numNormals++;
+                } else if (p[0] == 'f' && isSpace(p[1])) {
+                    numFaces++;
+                }
+            }
+            line = next;
+        }
 
-    /**
-     * Parse OBJ data from string
-     * @param objData OBJ file contents as string
-     * @param mesh Output mesh to populate
-     * @return true on success
-     */
-    static bool parse(const std::string& objData, Mesh& mesh) {
-        // Temporary storage for OBJ data
         std::vector<Vec3f> positions;
         std::vector<Vec2f> texcoords;
         std::vector<Vec3f> normals;
+        positions.reserve(numPositions);
+        texcoords.reserve(numTexcoords);
+        normals.reserve(numNormals);
 
-        // Face indices (each face vertex has position/texcoord/normal indices)
-        struct FaceVertex {
-            int v, vt, vn;  // 1-based indices, 0 means not present
-        };
-        std::vector<std::vector<FaceVertex>> faces;
-
-        // Parse line by line
-        std::istringstream stream(objData);
-        std::string line;
-        int lineNum = 0;
-
-        while (std::getline(stream, line)) {
-            lineNum++;
+        bool hasTexcoords = numTexcoords > 0;
+        bool hasNormals = numNormals > 0;
+        bool weld = hasNormals;
 
-            // Skip empty lines and comments
-            if (line.empty() || line[0] == '#') continue;
+        mesh.reset();
+        mesh.primitive(Mesh::TRIANGLES);
+        // At least one triangle per face; quads grow the arrays once
+        size_t estimate = weld ? std::max({numPositions, numTexcoords, numNormals})
+                               : numFaces * 3;
+        mesh.vertices().reserve(estimate);
+        if (hasTexcoords) mesh.texCoord2s().reserve(estimate);
+        if (hasNormals) mesh.normals().reserve(estimate);
+        if (weld) mesh.indices().reserve(numFaces * 3);
+
+        VertexWelder welder;
+        if (weld) welder.init(estimate);
+
+        // Corner -> output vertex, emitting the vertex the first time
+        auto emit = [&](const Corner& c) -> uint32_t {
+            if (weld) {
+                uint32_t index;
+                if (!welder.find(c, index)) return index;
+            }
+            mesh.vertex(positions[c.v]);
+            if (hasTexcoords) {
+                mesh.texCoord(c.vt >= 0 ? texcoords[c.vt] : Vec2f(0, 0));
+            }
+            if (hasNormals) {
+                mesh.normal(c.vn >= 0 ? normals[c.vn] : Vec3f(0, 0, 1));
+            }
+            return static_cast<uint32_t>(mesh.vertices().size() - 1);
+        };
 
-            // Trim leading whitespace
-            size_t start = line.find_first_not_of(" \t\r");
-            if (start == std::string::npos) continue;
-            line = line.substr(start);
+        size_t faces = 0;
+        for (const char* line = begin; line < end;) {
+            const char* next = nextLine(line, end);
+            const char* p = skipSpaces(line, next);
+            line = next;
+            if (next - p < 2) continue;
 
-            // Parse based on prefix
-            if (line.compare(0, 2, "v ") == 0) {
+            if (p[0] == 'v' && isSpace(p[1])) {
                 // Vertex position: v x y z [w]
                 Vec3f pos;
-                if (sscanf(line.c_str(), "v %f %f %f", &pos.x, &pos.y, &pos.z) >= 3) {
+                p += 2;
+                if (parseFloat(p, next, pos.x) && parseFloat(p, next, pos.y) &&
+                    parseFloat(p, next, pos.z)) {
                     positions.push_back(pos);
                 }
-            }
-            else if (line.compare(0, 3, "vt ") == 0) {
+            } else if (p[0] == 'v' && p[1] == 't') {
                 // Texture coordinate: vt u v [w]
                 Vec2f tc;
-                if (sscanf(line.c_str(), "vt %f %f", &tc.x, &tc.y) >= 2) {
+                p += 2;
+                if (parseFloat(p, next, tc.x) && parseFloat(p, next, tc.y)) {
                     texcoords.push_back(tc);
                 }
-            }
-            else if (line.compare(0, 3, "vn ") == 0) {
+            } else if (p[0] == 'v' && p[1] == 'n') {
                 // Vertex normal: vn x y z
                 Vec3f n;
-                if (sscanf(line.c_str(), "vn %f %f %f", &n.x, &n.y, &n.z) >= 3) {
+                p += 2;
+                if (parseFloat(p, next, n.x) && parseFloat(p, next, n.y) &&
+                    parseFloat(p, next, n.z)) {
                     normals.push_back(n);
                 }
-            }
-            else if (line.compare(0, 2, "f ") == 0) {
+            } else if (p[0] == 'f' && isSpace(p[1])) {
                 // Face: f v1[/vt1][/vn1] v2[/vt2][/vn2] v3[/vt3][/vn3] ...
-                std::vector<FaceVertex> face;
-
-                std::istringstream faceStream(line.substr(2));
-                std::string vertexStr;
-
-                while (faceStream >> vertexStr) {
-                    FaceVertex fv = {0, 0, 0};
-
-                    // Parse v/vt/vn format
-                    // Possible formats: v, v/vt, v/vt/vn, v//vn
-                    size_t slash1 = vertexStr.find('/');
-                    if (slash1 == std::string::npos) {
-                        // Just vertex index
-                        fv.v = std::stoi(vertexStr);
-                    } else {
-                        fv.v = std::stoi(vertexStr.substr(0, slash1));
-                        size_t slash2 = vertexStr.find('/', slash1 + 1);
-                        if (slash2 == std::string::npos) {
-                            // v/vt format
-                            if (slash1 + 1 < vertexStr.size()) {
-                                fv.vt = std::stoi(vertexStr.substr(slash1 + 1));
-                            }
+                // Triangulated fan-style (0-1-2, 0-2-3, ...) while reading
+                p += 1;
+                Corner first, prev, c;
+                int count = 0;
+                while (parseCorner(p, next, c)) {
+                    // Invalid positions come back as -1 and drop their triangles
+                    resolve(c, positions.size(), texcoords.size(), normals.size());
+                    if (count == 0) {
+                        first = c;
+                    } else if (count >= 2 && first.v >= 0 && prev.v >= 0 && c.v >= 0) {
+                        if (weld) {
+                            mesh.index(emit(first));
+                            mesh.index(emit(prev));
+                            mesh.index(emit(c));
                         } else {
-                            // v/vt/vn or v//vn format
-                            if (slash2 > slash1 + 1) {
-                                fv.vt = std::stoi(vertexStr.substr(slash1 + 1, slash2 - slash1 - 1));
-                            }
-                            if (slash2 + 1 < vertexStr.size()) {
-                                fv.vn = std::stoi(vertexStr.substr(slash2 + 1));
-                            }
+                            emit(first);
+                            emit(prev);
+                            emit(c);
                         }
                     }
-
-                    face.push_back(fv);
-                }
-
-                if (face.size() >= 3) {
-                    faces.push_back(face);
+                    prev = c;
+                    count++;
                 }
+                if (count >= 3) faces++;
             }
             // Ignore other lines (mtllib, usemtl, g, o, s, etc.)
         }
 
-        // Build mesh from parsed data
-        mesh.reset();
-        mesh.primitive(Mesh::TRIANGLES);
-
-        bool hasTexcoords = !texcoords.empty();
-        bool hasNormals = !normals.empty();
-
-        // Process faces - triangulate if needed
-        for (const auto& face : faces) {
-            // Triangulate fan-style: 0-1-2, 0-2-3, 0-3-4, ...
-            for (size_t i = 1; i + 1 < face.size(); i++) {
-                // Triangle vertices: face[0], face[i], face[i+1]
-                const FaceVertex* tri[3] = { &face[0], &face[i], &face[i + 1] };
-
-                for (int j = 0; j < 3; j++) {
-                    const FaceVertex& fv = *tri[j];
-
-                    // Resolve indices (1-based, negative = from end)
-                    int vi = fv.v;
-                    if (vi < 0) vi = positions.size() + vi + 1;
-                    if (vi < 1 || vi > (int)positions.size()) continue;
-
-                    // Add vertex position
-                    mesh.vertex(positions[vi - 1]);
-
-                    // Add texture coordinate if present
-                    if (hasTexcoords && fv.vt != 0) {
-                        int ti = fv.vt;
-                        if (ti < 0) ti = texcoords.size() + ti + 1;
-                        if (ti >= 1 && ti <= (int)texcoords.size()) {
-                            mesh.texCoord(texcoords[ti - 1]);
-                        }
-                    }
-
-                    // Add normal if present
-                    if (hasNormals && fv.vn != 0) {
-                        int ni = fv.vn;
-                        if (ni < 0) ni = normals.size() + ni + 1;
-                        if (ni >= 1 && ni <= (int)normals.size()) {
-                            mesh.normal(normals[ni - 1]);
-                        }
-                    }
-                }
-            }
-        }
-
         // Generate normals if not present in file
         if (!hasNormals && mesh.vertices().size() > 0) {
             mesh.generateNormals();
         }
 
         printf("[WebOBJ] Parsed: %zu vertices, %zu normals, %zu texcoords, %zu faces\n",
-               positions.size(), normals.size(), texcoords.size(), faces.size());
-        printf("[WebOBJ] Mesh: %zu vertices, %zu normals\n",
-               mesh.vertices().size(), mesh.normals().size());
+               positions.size(), normals.size(), texcoords.size(), faces);
+
+        // Weld the soup (if still one) and reorder for the vertex cache
+        if (MeshOptimizer::autoOptimize() && MeshOptimizer::optimize(mesh)) {
+            const auto& st = MeshOptimizer::lastStats();
+            printf("[WebOBJ] Optimized: ACMR %.2f -> %.2f\n", st.acmrBefore, st.acmrAfter);
+        }
+        printf("[WebOBJ] Mesh: %zu vertices, %zu normals, %zu indices\n",
+               mesh.vertices().size(), mesh.normals().size(), mesh.indices().size());
 
         return mesh.vertices().size() > 0;
     }
 
+    /**
+     * Parse OBJ data from string
+     * @param objData OBJ file contents as string
+     * @param mesh Output mesh to populate
+     * @return true on success
+     */
+    static bool parse(const std::string& objData, Mesh& mesh) {
+        return parse(reinterpret_cast<const uint8_t*>(objData.data()), objData.size(), mesh);
+    }
+
+    /**
+     * Parse into a render-ready MeshBundle, reusing the one cached for
+     * these exact bytes (see al_WebMeshCache.hpp). Only the first load of
+     * a file parses, optimizes and simplifies; later ones read the bundle.
+     * @param lodLevels LOD chain length stored with the bundle (1 = none)
+     */
+    static bool parseCached(const uint8_t* data, size_t size, MeshBundle& out, int lodLevels = 1) {
+        uint64_t settings = 0x4F424A00u | (uint32_t)lodLevels;  // "OBJ" + levels
+        return WebMeshCache::loadOrBuild(data, size, settings, out, [&](MeshBundle& bundle) {
+            Mesh mesh;
+            if (!parse(data, size, mesh)) return false;
+            WebMeshCache::build(mesh, bundle, lodLevels);
+            return true;
+        });
+    }
+
     /**
      * Load OBJ file from URL asynchronously
      * @param url URL to OBJ file
      */
     void load(const std::string& url) {
+        cancel();
         mReady = false;
         mUrl = url;
         mMesh.reset();
 
-        WebFile::loadFromURL(url, [this](const UploadedFile& file) {
-            if (parse(file.data.data(), file.data.size(), mMesh)) {
-                mReady = true;
-                printf("[WebOBJ] Loaded: %s\n", mUrl.c_str());
-                if (mCallback) mCallback(true);
-            } else {
-                printf("[WebOBJ] Failed to parse: %s\n", mUrl.c_str());
-                if (mCallback) mCallback(false);
-            }
+        mTicket = AssetLoader::instance().fetch(url, mPriority, [this](const UploadedFile& file) {
+            mTicket = 0;
+            // Parse off the main thread; the job owns its copy of the bytes
+            auto mesh = std::make_shared<Mesh>();
+            mJob = JobSystem::instance().submit(
+                [bytes = file.data, mesh] { return parse(bytes.data(), bytes.size(), *mesh); },
+                [this, mesh](bool& ok) {
+                    mJob = JobFuture<bool>();
+                    if (ok) {
+                        mMesh = std::move(*mesh);
+                        mReady = true;
+                        printf("[WebOBJ] Loaded: %s\n", mUrl.c_str());
+                        if (mCallback) mCallback(true);
+                    } else {
+                        printf("[WebOBJ] Failed to parse: %s\n", mUrl.c_str());
+                        if (mCallback) mCallback(false);
+                    }
+                });
         });
     }
 
@@ -264,6 +300,24 @@ public:
         load(url);
     }
 
+    /**
+     * Scheduling priority in the AssetLoader queue (higher loads sooner,
+     * e.g. AssetLoader::distancePriority()). Applies to a queued load too.
+     */
+    void setPriority(float priority) {
+        mPriority = priority;
+        if (mTicket) AssetLoader::instance().setPriority(mTicket, priority);
+    }
+    float priority() const { return mPriority; }
+
+    /// Drop a pending load; the callback won't run
+    void cancel() {
+        if (mTicket) AssetLoader::instance().cancel(mTicket);
+        mTicket = 0;
+        mJob.cancel();
+        mJob = JobFuture<bool>();
+    }
+
     /**
      * Check if mesh is loaded and ready
      */
@@ -301,9 +355,12 @@ public:
     size_t vertexCount() const { return mMesh.vertices().size(); }
 
     /**
-     * Get face count (approximate - vertices/3 for triangles)
+     * Get face count (triangles, indexed or not)
      */
-    size_t faceCount() const { return mMesh.vertices().size() / 3; }
+    size_t faceCount() const {
+        return mMesh.indices().empty() ? mMesh.vertices().size() / 3
+                                       : mMesh.indices().size() / 3;
+    }
 
     /**
      * Generate LOD levels for the loaded mesh
@@ -340,12 +397,170 @@ public:
     }
 
 private:
+    // ── parse() scanning ──
+
+    /// Face corner as element indices (1-based in the file, 0-based once
+    /// resolved; 0 / -1 = absent)
+    struct Corner {
+        int v = 0, vt = 0, vn = 0;
+    };
+
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    static const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && isSpace(*p)) ++p;
+        return p;
+    }
+
+    static const char* nextLine(const char* p, const char* end) {
+        const void* nl = memchr(p, '\n', static_cast<size_t>(end - p));
+        return nl ? static_cast<const char*>(nl) + 1 : end;
+    }
+
+    static bool parseFloat(const char*& p, const char* end, float& out) {
+        p = skipSpaces(p, end);
+        if (p < end && *p == '+') ++p;  // from_chars rejects a leading '+'
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        auto result = std::from_chars(p, end, out);
+        if (result.ec != std::errc()) return false;
+        p = result.ptr;
+        return true;
+#else
+        // No floating-point from_chars in this standard library: decimal
+        // digits into a 64-bit mantissa, scaled once in double precision
+        const char* start = p;
+        bool negative = p < end && *p == '-';
+        if (negative) ++p;
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        int digits = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p, ++digits) {
+            if (mantissa < 1000000000000000000ull) mantissa = mantissa * 10 + (*p - '0');
+            else exponent++;
+        }
+        if (p < end && *p == '.') {
+            for (++p; p < end && *p >= '0' && *p <= '9'; ++p, ++digits) {
+                if (mantissa < 1000000000000000000ull) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    exponent--;
+                }
+            }
+        }
+        if (digits == 0) { p = start; return false; }
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            const char* q = p + 1;
+            if (q < end && *q == '+') ++q;
+            int e = 0;
+            auto result = std::from_chars(q, end, e);
+            if (result.ec == std::errc()) {
+                exponent += e;
+                p = result.ptr;
+            }
+        }
+        double value = static_cast<double>(mantissa);
+        if (exponent != 0) value *= std::pow(10.0, exponent);
+        out = static_cast<float>(negative ? -value : value);
+        return true;
+#endif
+    }
+
+    /// v, v/vt, v/vt/vn or v//vn; false at end of line or on garbage
+    static bool parseCorner(const char*& p, const char* end, Corner& c) {
+        p = skipSpaces(p, end);
+        c = Corner();
+        auto result = std::from_chars(p, end, c.v);
+        if (result.ec != std::errc()) return false;
+        p = result.ptr;
+        if (p < end && *p == '/') {
+            ++p;
+            result = std::from_chars(p, end, c.vt);
+            if (result.ec == std::errc()) p = result.ptr;
+            if (p < end && *p == '/') {
+                ++p;
+                result = std::from_chars(p, end, c.vn);
+                if (result.ec == std::errc()) p = result.ptr;
+            }
+        }
+        return true;
+    }
+
+    /// To 0-based against the counts read so far; -1 if absent or out of range
+    static void resolve(Corner& c, size_t numV, size_t numVt, size_t numVn) {
+        auto fix = [](int i, size_t count) -> int {
+            long r = i < 0 ? static_cast<long>(count) + i : static_cast<long>(i) - 1;
+            return (i != 0 && r >= 0 && r < static_cast<long>(count)) ? static_cast<int>(r) : -1;
+        };
+        c.v = fix(c.v, numV);
+        c.vt = fix(c.vt, numVt);
+        c.vn = fix(c.vn, numVn);
+    }
+
+    /**
+     * Open-addressing map from v/vt/vn triples to output vertices. Keys
+     * are stored once per vertex; slots hold vertex index + 1 (0 = empty).
+     */
+    class VertexWelder {
+    public:
+        void init(size_t expected) {
+            size_t capacity = 64;
+            while (capacity < expected * 2) capacity *= 2;
+            mSlots.assign(capacity, 0);
+            mKeys.clear();
+            mKeys.reserve(expected);
+        }
+
+        /// Index for c; true (and the index it will get) if c is new
+        bool find(const Corner& c, uint32_t& index) {
+            if ((mKeys.size() + 1) * 2 > mSlots.size()) grow();
+            size_t mask = mSlots.size() - 1;
+            for (size_t slot = hash(c) & mask;; slot = (slot + 1) & mask) {
+                uint32_t entry = mSlots[slot];
+                if (entry == 0) {
+                    mKeys.push_back(c);
+                    index = static_cast<uint32_t>(mKeys.size() - 1);
+                    mSlots[slot] = index + 1;
+                    return true;
+                }
+                const Corner& k = mKeys[entry - 1];
+                if (k.v == c.v && k.vt == c.vt && k.vn == c.vn) {
+                    index = entry - 1;
+                    return false;
+                }
+            }
+        }
+
+    private:
+        static size_t hash(const Corner& c) {
+            uint32_t h = static_cast<uint32_t>(c.v) * 0x9E3779B1u;
+            h ^= static_cast<uint32_t>(c.vt) * 0x85EBCA77u + (h << 6) + (h >> 2);
+            h ^= static_cast<uint32_t>(c.vn) * 0xC2B2AE3Du + (h << 6) + (h >> 2);
+            return h ^ (h >> 15);
+        }
+
+        void grow() {
+            std::vector<uint32_t> slots(mSlots.size() * 2, 0);
+            size_t mask = slots.size() - 1;
+            for (uint32_t i = 0; i < mKeys.size(); i++) {
+                size_t slot = hash(mKeys[i]) & mask;
+                while (slots[slot] != 0) slot = (slot + 1) & mask;
+                slots[slot] = i + 1;
+            }
+            mSlots.swap(slots);
+        }
+
+        std::vector<uint32_t> mSlots;
+        std::vector<Corner> mKeys;
+    };
+
     std::string mUrl;
     Mesh mMesh;
     LODMesh mLOD;
     bool mReady;
     bool mHasLOD = false;
     LoadCallback mCallback;
+    float mPriority = 0.0f;
+    AssetLoader::Ticket mTicket = 0;
+    JobFuture<bool> mJob;   // Parse in flight
 };
 
 /**
@@ -360,17 +575,19 @@ public:
     /**
      * Add an OBJ file to the batch
      * @param url URL to OBJ file
+     * @param priority AssetLoader priority (higher loads sooner)
      * @return Index of the mesh
      */
-    int add(const std::string& url) {
+    int add(const std::string& url, float priority = 0.0f) {
         int index = mLoaders.size();
         mLoaders.emplace_back();
+        mLoaders.back().setPriority(priority);
         mUrls.push_back(url);
         return index;
     }
 
     /**
-     * Start loading all meshes
+     * Queue all meshes with the AssetLoader, highest priority first
      */
     void loadAll(BatchCallback callback = nullptr) {
         mCallback = callback;
@@ -387,6 +604,14 @@ public:
         }
     }
 
+    /// Re-rank a mesh, e.g. as the camera moves while the batch loads
+    void setPriority(int index, float priority) { mLoaders[index].setPriority(priority); }
+
+    /// Drop the meshes that haven't loaded yet
+    void cancel() {
+        for (auto& loader : mLoaders) loader.cancel();
+    }
+
     /**
      * Check if all meshes are loaded
      */
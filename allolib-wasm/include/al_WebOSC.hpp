@@ -17,8 +17,14 @@
  *       float value = msg.getFloat(0);
  *   });
  *
- * Note: Requires an OSC-to-WebSocket bridge server (not included).
- * Popular options: oscbridge, osc-web, node-osc-websocket
+ * Transport: standard OSC 1.0 packets, encoded and parsed with oscpack, one
+ * packet per binary WebSocket frame - the same wire format as
+ * osc::Send/Recv in al_OSC_Web.cpp, so the backend's OSC relay (and its UDP
+ * bridge) carries WebOSC traffic too, and bundles are unpacked on receipt.
+ * Outgoing packets are encoded into a reused buffer and handed to the
+ * socket as a view of wasm memory; incoming frames are copied once into a
+ * preallocated receive arena and parsed in place. Numeric messages make no
+ * heap allocations on either side once the buffers have grown.
  */
 
 #ifndef AL_WEB_OSC_HPP
@@ -30,8 +36,13 @@
 #include <functional>
 #include <unordered_map>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 
+#include "osc/OscException.h"
+#include "osc/OscOutboundPacketStream.h"
+#include "osc/OscReceivedElements.h"
+
 namespace al {
 
 /**
@@ -81,6 +92,7 @@ public:
 
     const std::string& address() const { return mAddress; }
     void setAddress(const std::string& addr) { mAddress = addr; }
+    void setAddress(const char* addr) { mAddress.assign(addr); }
 
     size_t argCount() const { return mArgs.size(); }
 
@@ -91,6 +103,9 @@ public:
     OSCMessage& add(const std::string& val) { mArgs.push_back(OSCArg(val)); return *this; }
     OSCMessage& add(const char* val) { mArgs.push_back(OSCArg(std::string(val))); return *this; }
     OSCMessage& add(bool val) { mArgs.push_back(OSCArg(val)); return *this; }
+    OSCMessage& add(const OSCArg& arg) { mArgs.push_back(arg); return *this; }
+
+    const OSCArg& arg(int index) const { return mArgs[index]; }
 
     // Get argument type
     OSCType getType(int index) const {
@@ -146,7 +161,7 @@ public:
         mArgs.clear();
     }
 
-    // Serialize to JSON for WebSocket transport
+    // Serialize to JSON (debugging; the transport is binary OSC)
     std::string toJSON() const {
         std::string json = "{\"address\":\"" + mAddress + "\",\"args\":[";
         for (size_t i = 0; i < mArgs.size(); i++) {
@@ -178,7 +193,9 @@ class WebOSC {
 public:
     using Handler = std::function<void(const OSCMessage&)>;
 
-    WebOSC() : mConnected(false), mReconnect(true), mReconnectDelay(2000) {}
+    WebOSC()
+        : mConnected(false), mReconnect(true), mReconnectDelay(2000),
+          mSendBuffer(kInitialSendBuffer), mArena(kInitialArena) {}
 
     ~WebOSC() {
         disconnect();
@@ -208,16 +225,17 @@ public:
 
             function createWebSocket() {
                 var ws = new WebSocket(url);
+                ws.binaryType = 'arraybuffer';
                 window._alWebOSC[oscPtr].ws = ws;
 
                 ws.onopen = function() {
                     console.log('[WebOSC] Connected to', url);
-                    Module.ccall('_al_web_osc_connected', null, ['number'], [oscPtr]);
+                    __al_web_osc_connected(oscPtr);
                 };
 
                 ws.onclose = function() {
                     console.log('[WebOSC] Disconnected');
-                    Module.ccall('_al_web_osc_disconnected', null, ['number'], [oscPtr]);
+                    __al_web_osc_disconnected(oscPtr);
 
                     // Reconnect after delay
                     var state = window._alWebOSC[oscPtr];
@@ -235,30 +253,20 @@ public:
                 };
 
                 ws.onmessage = function(event) {
-                    try {
-                        // Parse JSON message
-                        var msg = JSON.parse(event.data);
-                        if (msg.address) {
-                            // Convert to string for C++
-                            var argsJson = JSON.stringify(msg.args || []);
-                            var addressPtr = allocateUTF8(msg.address);
-                            var argsPtr = allocateUTF8(argsJson);
-                            Module.ccall('_al_web_osc_message', null,
-                                ['number', 'number', 'number'],
-                                [oscPtr, addressPtr, argsPtr]);
-                            _free(addressPtr);
-                            _free(argsPtr);
-                        }
-                    } catch (e) {
-                        console.error('[WebOSC] Parse error:', e);
-                    }
+                    // Text frames aren't OSC packets
+                    if (!(event.data instanceof ArrayBuffer)) return;
+                    var size = event.data.byteLength;
+                    var arena = __al_web_osc_arena(oscPtr, size);
+                    if (!arena) return;
+                    HEAPU8.set(new Uint8Array(event.data), arena);
+                    __al_web_osc_packet(oscPtr, size);
                 };
             }
 
-            window._alWebOSC[oscPtr].reconnect = true;
-            window._alWebOSC[oscPtr].reconnectDelay = 2000;
+            window._alWebOSC[oscPtr].reconnect = !!$2;
+            window._alWebOSC[oscPtr].reconnectDelay = $3;
             createWebSocket();
-        }, this, url.c_str());
+        }, this, url.c_str(), mReconnect ? 1 : 0, mReconnectDelay);
     }
 
     /**
@@ -306,18 +314,16 @@ public:
      */
     void send(const OSCMessage& msg) {
         if (!mConnected) return;
-        std::string json = msg.toJSON();
+        size_t size = encode(msg);
+        if (size == 0) return;
 
         EM_ASM({
-            var oscPtr = $0;
-            var json = UTF8ToString($1);
-            if (window._alWebOSC && window._alWebOSC[oscPtr] && window._alWebOSC[oscPtr].ws) {
-                var ws = window._alWebOSC[oscPtr].ws;
-                if (ws.readyState === WebSocket.OPEN) {
-                    ws.send(json);
-                }
-            }
-        }, this, json.c_str());
+            var state = window._alWebOSC && window._alWebOSC[$0];
+            if (!state || !state.ws || state.ws.readyState !== WebSocket.OPEN) return;
+            var packet = HEAPU8.subarray($1, $1 + $2);
+            // WebSocket.send() rejects views of shared memory (pthread builds)
+            state.ws.send(packet.buffer instanceof ArrayBuffer ? packet : packet.slice());
+        }, this, mSendBuffer.data(), size);
     }
 
     /**
@@ -377,6 +383,26 @@ public:
         mHandlers.erase(address);
     }
 
+    /**
+     * Size in bytes of msg encoded as an OSC packet
+     */
+    static size_t packetSize(const OSCMessage& msg) {
+        size_t size = pad4(msg.address().size() + 1) + pad4(msg.argCount() + 2);  // ",tags\0"
+        for (size_t i = 0; i < msg.argCount(); i++) {
+            const OSCArg& arg = msg.arg((int)i);
+            switch (arg.type) {
+                case OSC_INT32:
+                case OSC_FLOAT32: size += 4; break;
+                case OSC_INT64:
+                case OSC_DOUBLE:  size += 8; break;
+                case OSC_STRING:  size += pad4(arg.s.size() + 1); break;
+                case OSC_BLOB:    size += 4 + pad4(arg.blob.size()); break;
+                default: break;  // T, F and N carry no data
+            }
+        }
+        return size;
+    }
+
     // Internal callbacks from JavaScript
     void _onConnected() {
         mConnected = true;
@@ -388,88 +414,141 @@ public:
         printf("[WebOSC] Disconnected\n");
     }
 
-    void _onMessage(const char* address, const char* argsJson) {
-        OSCMessage msg(address);
+    // Arena the next incoming frame is copied into, grown to fit
+    char* _arena(size_t size) {
+        if (size > kMaxPacket) {
+            printf("[WebOSC] Dropping %zu-byte packet\n", size);
+            return nullptr;
+        }
+        if (mArena.size() < size) mArena.resize(size);
+        return mArena.data();
+    }
 
-        // Parse JSON args (simple parser for basic types)
-        std::string json(argsJson);
-        if (json.length() > 2) {
-            // Remove [ and ]
-            json = json.substr(1, json.length() - 2);
-
-            // Simple parsing (doesn't handle nested objects/strings with commas)
-            size_t pos = 0;
-            while (pos < json.length()) {
-                // Skip whitespace
-                while (pos < json.length() && (json[pos] == ' ' || json[pos] == ',')) pos++;
-                if (pos >= json.length()) break;
-
-                if (json[pos] == '"') {
-                    // String
-                    size_t end = json.find('"', pos + 1);
-                    if (end != std::string::npos) {
-                        msg.add(json.substr(pos + 1, end - pos - 1));
-                        pos = end + 1;
-                    } else break;
-                } else if (json[pos] == 't' && json.substr(pos, 4) == "true") {
-                    msg.add(true);
-                    pos += 4;
-                } else if (json[pos] == 'f' && json.substr(pos, 5) == "false") {
-                    msg.add(false);
-                    pos += 5;
-                } else if (json[pos] == 'n' && json.substr(pos, 4) == "null") {
-                    pos += 4;
-                } else {
-                    // Number
-                    size_t end = pos;
-                    bool hasDecimal = false;
-                    while (end < json.length() && (isdigit(json[end]) || json[end] == '.' || json[end] == '-' || json[end] == 'e' || json[end] == 'E')) {
-                        if (json[end] == '.') hasDecimal = true;
-                        end++;
-                    }
-                    std::string numStr = json.substr(pos, end - pos);
-                    if (hasDecimal) {
-                        msg.add((float)atof(numStr.c_str()));
-                    } else {
-                        msg.add((int32_t)atoi(numStr.c_str()));
-                    }
-                    pos = end;
+    // Parse the packet in the arena and dispatch its messages
+    void _onPacket(size_t size) {
+        try {
+            dispatch(::osc::ReceivedPacket(mArena.data(), (::osc::osc_bundle_element_size_t)size));
+        } catch (const ::osc::Exception& e) {
+            printf("[WebOSC] Malformed packet: %s\n", e.what());
+        }
+    }
+
+private:
+    static constexpr size_t kInitialSendBuffer = 1024;
+    static constexpr size_t kInitialArena = 8192;
+    static constexpr size_t kMaxPacket = 1 << 20;
+
+    static size_t pad4(size_t n) { return (n + 3) & ~size_t(3); }
+
+    // Encode msg into mSendBuffer (sized up front, so oscpack never runs
+    // out of room); returns the packet size, or 0 if it is too large
+    size_t encode(const OSCMessage& msg) {
+        size_t size = packetSize(msg);
+        if (size > kMaxPacket) {
+            printf("[WebOSC] %s: %zu-byte message too large\n", msg.address().c_str(), size);
+            return 0;
+        }
+        if (mSendBuffer.size() < size) mSendBuffer.resize(size);
+
+        ::osc::OutboundPacketStream p(mSendBuffer.data(), mSendBuffer.size());
+        p << ::osc::BeginMessage(msg.address().c_str());
+        for (size_t i = 0; i < msg.argCount(); i++) {
+            const OSCArg& arg = msg.arg((int)i);
+            switch (arg.type) {
+                case OSC_INT32:   p << (::osc::int32)arg.i; break;
+                case OSC_FLOAT32: p << arg.f; break;
+                case OSC_INT64:   p << (::osc::int64)arg.h; break;
+                case OSC_DOUBLE:  p << arg.d; break;
+                case OSC_STRING:  p << arg.s.c_str(); break;
+                case OSC_BLOB:
+                    p << ::osc::Blob(arg.blob.data(), (::osc::osc_bundle_element_size_t)arg.blob.size());
+                    break;
+                case OSC_TRUE:    p << true; break;
+                case OSC_FALSE:   p << false; break;
+                default:          p << ::osc::OscNil; break;
+            }
+        }
+        p << ::osc::EndMessage;
+        return p.Size();
+    }
+
+    void dispatch(const ::osc::ReceivedPacket& packet) {
+        if (packet.IsBundle()) {
+            ::osc::ReceivedBundle bundle(packet);
+            for (auto it = bundle.ElementsBegin(); it != bundle.ElementsEnd(); ++it) {
+                dispatch(::osc::ReceivedPacket(it->Contents(), it->Size()));
+            }
+        } else {
+            dispatchMessage(::osc::ReceivedMessage(packet));
+        }
+    }
+
+    // Decoded into one reused OSCMessage: numeric arguments don't allocate
+    void dispatchMessage(const ::osc::ReceivedMessage& m) {
+        mIncoming.clear();
+        mIncoming.setAddress(m.AddressPattern());
+        for (auto a = m.ArgumentsBegin(); a != m.ArgumentsEnd(); ++a) {
+            OSCArg arg;
+            switch (a->TypeTag()) {
+                case 'i': arg.type = OSC_INT32;   arg.i = a->AsInt32Unchecked(); break;
+                case 'c': arg.type = OSC_INT32;   arg.i = a->AsCharUnchecked(); break;
+                case 'f': arg.type = OSC_FLOAT32; arg.f = a->AsFloatUnchecked(); break;
+                case 'h': arg.type = OSC_INT64;   arg.h = a->AsInt64Unchecked(); break;
+                case 'd': arg.type = OSC_DOUBLE;  arg.d = a->AsDoubleUnchecked(); break;
+                case 's': arg.type = OSC_STRING;  arg.s = a->AsStringUnchecked(); break;
+                case 'S': arg.type = OSC_STRING;  arg.s = a->AsSymbolUnchecked(); break;
+                case 'T': arg.type = OSC_TRUE; break;
+                case 'F': arg.type = OSC_FALSE; break;
+                case 'b': {
+                    const void* data = nullptr;
+                    ::osc::osc_bundle_element_size_t size = 0;
+                    a->AsBlobUnchecked(data, size);
+                    arg.type = OSC_BLOB;
+                    arg.blob.assign((const uint8_t*)data, (const uint8_t*)data + size);
+                    break;
                 }
+                default: break;  // Nil, and types OSCArg can't hold
             }
+            mIncoming.add(arg);
         }
 
-        // Find handler
-        auto it = mHandlers.find(address);
+        auto it = mHandlers.find(mIncoming.address());
         if (it != mHandlers.end()) {
-            it->second(msg);
+            it->second(mIncoming);
         } else if (mDefaultHandler) {
-            mDefaultHandler(msg);
+            mDefaultHandler(mIncoming);
         }
     }
 
-private:
     bool mConnected;
     bool mReconnect;
     int mReconnectDelay;
     std::string mUrl;
     std::unordered_map<std::string, Handler> mHandlers;
     Handler mDefaultHandler;
+    std::vector<char> mSendBuffer;  // Outgoing packet, reused
+    std::vector<char> mArena;       // Incoming frame, reused
+    OSCMessage mIncoming;
 };
 
 } // namespace al
 
 // C callbacks for JavaScript
 extern "C" {
-    void _al_web_osc_connected(al::WebOSC* osc) {
+    EMSCRIPTEN_KEEPALIVE inline void _al_web_osc_connected(al::WebOSC* osc) {
         if (osc) osc->_onConnected();
     }
 
-    void _al_web_osc_disconnected(al::WebOSC* osc) {
+    EMSCRIPTEN_KEEPALIVE inline void _al_web_osc_disconnected(al::WebOSC* osc) {
         if (osc) osc->_onDisconnected();
     }
 
-    void _al_web_osc_message(al::WebOSC* osc, const char* address, const char* argsJson) {
-        if (osc) osc->_onMessage(address, argsJson);
+    EMSCRIPTEN_KEEPALIVE inline char* _al_web_osc_arena(al::WebOSC* osc, int size) {
+        return osc && size > 0 ? osc->_arena((size_t)size) : nullptr;
+    }
+
+    EMSCRIPTEN_KEEPALIVE inline void _al_web_osc_packet(al::WebOSC* osc, int size) {
+        if (osc && size > 0) osc->_onPacket((size_t)size);
     }
 }
 
@@ -0,0 +1,58 @@
+/**
+ * Web OSC Bundling - coalesce osc::Send traffic into one bundle per frame
+ *
+ * On the web every osc::Send::send() is one WebSocket frame through the
+ * relay, so a sketch streaming a few hundred values at 60 Hz sends tens of
+ * thousands of frames a second. With bundling on, send() appends the
+ * packet to an OSC bundle instead, and the bundle goes out as one frame:
+ *   - at the next animation frame (maxDelayMs = 0, the default), or
+ *     maxDelayMs after its first packet;
+ *   - early, when the next packet would take it past maxBytes.
+ * Packets keep their order. Messages are carried with the "immediately"
+ * time tag as before; packets that are bundles themselves are nested
+ * whole, so their own time tags survive. A bundle holding a single packet
+ * is sent unwrapped. osc::Recv descends into nested bundles.
+ *
+ * Usage:
+ *   osc::Send sender(9010, "127.0.0.1");
+ *   osc::setBundling(sender, {true});          // one frame per animation frame
+ *   sender.send("/sensor/x", x);               // queued
+ *
+ * Implemented in al_OSC_Web.cpp, next to the WebSocket transport.
+ */
+
+#ifndef AL_WEB_OSC_BUNDLE_HPP
+#define AL_WEB_OSC_BUNDLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "al/protocol/al_OSC.hpp"
+
+namespace al {
+namespace osc {
+
+struct SendBundling {
+    bool enabled = false;
+    double maxDelayMs = 0.0;  ///< 0 = flush on the next animation frame
+    size_t maxBytes = 8192;   ///< Flush before a bundle would grow past this
+};
+
+struct SendBundleStats {
+    uint64_t packets = 0;  ///< Packets given to send()
+    uint64_t frames = 0;   ///< WebSocket frames they went out in
+};
+
+/// Turn bundling on or off for `send`; turning it off flushes the bundle
+void setBundling(Send& send, const SendBundling& options);
+SendBundling bundling(const Send& send);
+
+/// Send the pending bundle now; returns its size in bytes (0 if none)
+size_t flushBundle(Send& send);
+
+SendBundleStats bundleStats(const Send& send);
+
+} // namespace osc
+} // namespace al
+
+#endif // AL_WEB_OSC_BUNDLE_HPP
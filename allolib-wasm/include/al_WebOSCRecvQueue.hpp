@@ -0,0 +1,78 @@
+/**
+ * Web OSC Receive Queue - budgeted, coalescing dispatch for osc::Recv
+ *
+ * On the web, osc::Recv runs its handlers from the WebSocket callback as
+ * each packet arrives, so a burst of thousands of messages is all handled
+ * before the next frame. With the queue on, the callback only copies
+ * messages (bundles are split into their messages) into a preallocated
+ * single-producer / single-consumer ring, and they are dispatched in
+ * batches:
+ *   - automatically once per animation frame, within the options' frame
+ *     budget (autoDrain, the default);
+ *   - by recvBatch(recv, maxMessages, maxMicros) from the app;
+ *   - one at a time by recv.recv(), so `while (recv.recv()) {}` still works.
+ * Messages whose address starts with one of the coalesce prefixes are
+ * continuous controls: when a later message for the same address is
+ * already queued, the older one is skipped (last value wins). Everything
+ * else is dispatched in order. A full ring drops new messages, and
+ * messages larger than a slot are dropped; both are counted.
+ *
+ * Usage:
+ *   osc::Recv recv(9010);
+ *   recv.handler(*this);
+ *   osc::RecvQueueOptions q;
+ *   q.enabled = true;
+ *   q.coalesce = {"/sensor/", "/fader"};
+ *   osc::setRecvQueue(recv, q);
+ *
+ * Implemented in al_OSC_Web.cpp, next to the WebSocket transport.
+ */
+
+#ifndef AL_WEB_OSC_RECV_QUEUE_HPP
+#define AL_WEB_OSC_RECV_QUEUE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "al/protocol/al_OSC.hpp"
+
+namespace al {
+namespace osc {
+
+struct RecvQueueOptions {
+    bool enabled = false;
+    size_t capacity = 1024;              ///< Messages the ring holds (rounded up to a power of two)
+    size_t slotBytes = 512;              ///< Largest message kept
+    std::vector<std::string> coalesce;   ///< Address prefixes where last value wins
+    bool autoDrain = true;               ///< Drain once per animation frame
+    int frameMessages = 256;             ///< Per-frame budget: messages dispatched
+    double frameMicros = 2000.0;         ///< Per-frame budget: time (0 = unlimited)
+};
+
+struct RecvQueueStats {
+    uint64_t received = 0;    ///< Messages that arrived
+    uint64_t dispatched = 0;  ///< Messages handed to the handlers
+    uint64_t coalesced = 0;   ///< Skipped for a newer value of the same address
+    uint64_t dropped = 0;     ///< Lost to a full ring
+    uint64_t oversized = 0;   ///< Lost for not fitting a slot
+    size_t pending = 0;       ///< Queued right now
+};
+
+/// Turn the queue on or off for `recv`; pending messages are dispatched first
+void setRecvQueue(Recv& recv, const RecvQueueOptions& options);
+RecvQueueOptions recvQueue(const Recv& recv);
+
+/**
+ * Dispatch queued messages until maxMessages have been handled or
+ * maxMicros have passed (0 = no time limit); returns the number handled
+ */
+int recvBatch(Recv& recv, int maxMessages, double maxMicros = 0.0);
+
+RecvQueueStats recvQueueStats(const Recv& recv);
+
+} // namespace osc
+} // namespace al
+
+#endif // AL_WEB_OSC_RECV_QUEUE_HPP
@@ -3,32 +3,56 @@
  * @brief Object Manager for Allolib Studio Timeline (Header-Only)
  *
  * Manages scene objects with:
- * - Spawn/destroy lifecycle based on timeline time
+ * - Spawn/destroy lifecycle based on timeline time, scheduled in a min-heap
+ *   so a frame only touches objects whose visibility changes
  * - Transform interpolation from keyframes
  * - Primitive mesh rendering (sphere, cube, cylinder, cone, torus, plane)
  * - Material support (basic, PBR)
+ * - GPU-driven drawing on WebGPU: objects are culled in a compute pass and
+ *   drawn with one indirect draw per primitive; PBR parameters ride in a
+ *   per-instance material buffer, so PBR objects instance too
+ * - Instanced drawing on WebGL2: visible objects are grouped by primitive
+ *   and material type, one glDrawElementsInstanced per group; PBR groups
+ *   go through WebPBR's instanced permutation, keeping its IBL lighting
+ *
+ * - Structure-of-arrays storage addressed by stable integer handles
  *
  * Integration:
  * - JS calls spawn/destroy/update via WASM exports
- * - Keyframe interpolation happens in JS, values pushed to WASM
+ * - Keyframe interpolation happens in JS, values pushed to WASM; per frame
+ *   the bridge resolves ids to handles once (al_obj_handle) and sends all
+ *   changed transforms/colors in one bulk call (al_obj_set_transforms etc.)
+ *   with handles and values packed in typed arrays on the WASM heap
  * - Objects rendered in WebApp::onDraw()
  *
+ * C++ usage:
+ *   ObjectHandle h = objectManager().createObject("orb", "Orb", ObjectPrimitive::Sphere);
+ *   objectManager().setColor(h, 1, 0.3, 0.3, 1);
+ *   objectManager().setPosition(h, 0, 1, 0);       // or by string id, one hash lookup
+ *
  * This is a header-only library for easier integration with examples.
  */
 
 #pragma once
 
+#include <emscripten.h>
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <memory>
 #include <functional>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 #include "al/math/al_Vec.hpp"
 #include "al/math/al_Quat.hpp"
 #include "al/graphics/al_Graphics.hpp"
 #include "al/graphics/al_Mesh.hpp"
+#include "al/graphics/al_OpenGL.hpp"
+#include "al/graphics/al_Shader.hpp"
 #include "al/graphics/al_VAOMesh.hpp"
 #include "al/graphics/al_Shapes.hpp"
 #include "al_WebPBR.hpp"
@@ -80,26 +104,19 @@ struct ObjectMaterial {
   Vec3f emissive{0, 0, 0};
 };
 
-struct SceneObject {
-  std::string id;
-  std::string name;
-  bool visible = true;
-  bool locked = false;
-
-  ObjectTransform transform;
-  ObjectPrimitive primitiveType = ObjectPrimitive::Cube;
-  ObjectMaterial material;
-
-  // Lifecycle
-  float spawnTime = -1;   // -1 = always visible
-  float destroyTime = -1; // -1 = never destroyed
-
-  // Internal
-  VAOMesh* mesh = nullptr;
-  bool needsUpdate = true;
-};
+/// Stable integer handle for an object; kInvalidObject when there is none.
+/// A handle stays valid until its object is removed; after that it no
+/// longer resolves, even once the slot is reused (its generation changes).
+using ObjectHandle = int32_t;
+constexpr ObjectHandle kInvalidObject = -1;
 
 // ─── Object Manager ──────────────────────────────────────────────────────────
+//
+// Storage is structure-of-arrays: each property lives in its own dense
+// array, indexed the same way for every live object, so draw(), the
+// lifecycle pass and bulk setters walk contiguous memory. Handles map to
+// dense indices through a slot table; removal swaps the last object into
+// the hole. String ids are kept only for lookup (find()) and the timeline.
 
 class ObjectManager {
 public:
@@ -108,135 +125,322 @@ public:
 
   // ─── Object CRUD ─────────────────────────────────────────────────────────
 
-  SceneObject* createObject(const std::string& id, const std::string& name,
+  /// Returns the new object's handle, or kInvalidObject if `id` exists
+  ObjectHandle createObject(const std::string& id, const std::string& name,
                             ObjectPrimitive primitive = ObjectPrimitive::Cube) {
-    if (mObjects.find(id) != mObjects.end()) {
-      return nullptr; // ID already exists
+    if (mIdIndex.find(id) != mIdIndex.end()) {
+      return kInvalidObject; // ID already exists
     }
 
-    auto obj = std::make_unique<SceneObject>();
-    obj->id = id;
-    obj->name = name;
-    obj->primitiveType = primitive;
-    obj->mesh = getMeshForPrimitive(primitive);
+    int slot;
+    if (!mFreeSlots.empty()) {
+      slot = mFreeSlots.back();
+      mFreeSlots.pop_back();
+    } else {
+      if (mSlots.size() > kSlotMask) return kInvalidObject;
+      slot = (int)mSlots.size();
+      mSlots.push_back(Slot{});
+    }
+    const ObjectHandle handle = (ObjectHandle)((mSlots[slot].generation << kSlotBits) | slot);
+    mSlots[slot].dense = (int32_t)mHandles.size();
+
+    mHandles.push_back(handle);
+    mIds.push_back(id);
+    mNames.push_back(name);
+    mPrimitives.push_back(primitive);
+    mPositions.emplace_back(0, 0, 0);
+    mRotations.emplace_back(1, 0, 0, 0);  // Identity
+    mScales.emplace_back(1, 1, 1);
+    mColors.emplace_back(1, 1, 1, 1);
+    mMaterialTypes.push_back(MaterialType::Basic);
+    mMetallic.push_back(0.0f);
+    mRoughness.push_back(0.5f);
+    mVisible.push_back(1);
+    mLocked.push_back(0);
+    mSpawnTimes.push_back(-1);    // -1 = always visible
+    mDestroyTimes.push_back(-1);  // -1 = never destroyed
+
+    mIdIndex[id] = handle;
+    mInstancesDirty = true;
+    return handle;
+  }
+
+  bool removeObject(ObjectHandle h) {
+    const int i = indexOf(h);
+    if (i < 0) return false;
+    mIdIndex.erase(mIds[i]);
+
+    // Move the last object into the hole
+    const size_t last = mHandles.size() - 1;
+    if ((size_t)i != last) mSlots[mHandles[last] & kSlotMask].dense = i;
+    auto swapPop = [&](auto&... arrays) {
+      ((arrays[i] = std::move(arrays[last]), arrays.pop_back()), ...);
+    };
+    swapPop(mHandles, mIds, mNames, mPrimitives, mPositions, mRotations, mScales,
+            mColors, mMaterialTypes, mMetallic, mRoughness, mVisible, mLocked,
+            mSpawnTimes, mDestroyTimes);
+
+    Slot& slot = mSlots[h & kSlotMask];
+    slot.dense = -1;
+    slot.generation = (slot.generation + 1) & kGenerationMask;
+    mFreeSlots.push_back(h & kSlotMask);
+    mInstancesDirty = true;
+    return true;
+  }
 
-    SceneObject* ptr = obj.get();
-    mObjects[id] = std::move(obj);
+  bool removeObject(const std::string& id) { return removeObject(find(id)); }
 
-    return ptr;
+  /// Handle for a string id, or kInvalidObject
+  ObjectHandle find(const std::string& id) const {
+    auto it = mIdIndex.find(id);
+    return it == mIdIndex.end() ? kInvalidObject : it->second;
   }
 
-  bool removeObject(const std::string& id) {
-    auto it = mObjects.find(id);
-    if (it == mObjects.end()) {
-      return false;
+  bool isValid(ObjectHandle h) const { return indexOf(h) >= 0; }
+
+  void clear() {
+    mHandles.clear();
+    mIds.clear();
+    mNames.clear();
+    mPrimitives.clear();
+    mPositions.clear();
+    mRotations.clear();
+    mScales.clear();
+    mColors.clear();
+    mMaterialTypes.clear();
+    mMetallic.clear();
+    mRoughness.clear();
+    mVisible.clear();
+    mLocked.clear();
+    mSpawnTimes.clear();
+    mDestroyTimes.clear();
+    mIdIndex.clear();
+    // Retire every slot so old handles stay invalid
+    mFreeSlots.clear();
+    for (int s = (int)mSlots.size() - 1; s >= 0; s--) {
+      mSlots[s].dense = -1;
+      mSlots[s].generation = (mSlots[s].generation + 1) & kGenerationMask;
+      mFreeSlots.push_back(s);
     }
-    mObjects.erase(it);
-    return true;
+    mLifecycleEvents.clear();
+    mLifecycleChanged.clear();
+    mLifecycleRebuild = true;
+    mInstancesDirty = true;
   }
 
-  SceneObject* getObject(const std::string& id) {
-    auto it = mObjects.find(id);
-    if (it == mObjects.end()) {
-      return nullptr;
-    }
-    return it->second.get();
+  // ─── Per-object access ───────────────────────────────────────────────────
+
+  const std::string& id(ObjectHandle h) const { return mIds[checked(h)]; }
+  const std::string& name(ObjectHandle h) const { return mNames[checked(h)]; }
+  ObjectPrimitive primitive(ObjectHandle h) const { return mPrimitives[checked(h)]; }
+  ObjectTransform transform(ObjectHandle h) const { return transform((size_t)checked(h)); }
+  ObjectMaterial material(ObjectHandle h) const {
+    const int i = checked(h);
+    ObjectMaterial m;
+    m.type = mMaterialTypes[i];
+    m.color = mColors[i];
+    m.metallic = mMetallic[i];
+    m.roughness = mRoughness[i];
+    return m;
   }
+  bool visible(ObjectHandle h) const { return mVisible[checked(h)] != 0; }
+  float spawnTime(ObjectHandle h) const { return mSpawnTimes[checked(h)]; }
+  float destroyTime(ObjectHandle h) const { return mDestroyTimes[checked(h)]; }
+
+  /// Dense iteration: handleAt(i) for i in [0, objectCount())
+  ObjectHandle handleAt(size_t i) const { return mHandles[i]; }
 
-  const std::unordered_map<std::string, std::unique_ptr<SceneObject>>& objects() const {
-    return mObjects;
+  // ─── Transform Updates (Called from JS) ──────────────────────────────────
+
+  void setPosition(ObjectHandle h, float x, float y, float z) {
+    const int i = indexOf(h);
+    if (i < 0) return;
+    mPositions[i].set(x, y, z);
+    mInstancesDirty = true;
   }
 
-  void clear() {
-    mObjects.clear();
+  void setRotation(ObjectHandle h, float x, float y, float z, float w) {
+    const int i = indexOf(h);
+    if (i < 0) return;
+    mRotations[i] = Quatf(w, x, y, z);
+    mInstancesDirty = true;
   }
 
-  // ─── Transform Updates (Called from JS) ──────────────────────────────────
+  void setScale(ObjectHandle h, float x, float y, float z) {
+    const int i = indexOf(h);
+    if (i < 0) return;
+    mScales[i].set(x, y, z);
+    mInstancesDirty = true;
+  }
 
   void setPosition(const std::string& id, float x, float y, float z) {
-    if (auto* obj = getObject(id)) {
-      obj->transform.position.set(x, y, z);
-      obj->needsUpdate = true;
-    }
+    setPosition(find(id), x, y, z);
   }
-
   void setRotation(const std::string& id, float x, float y, float z, float w) {
-    if (auto* obj = getObject(id)) {
-      obj->transform.rotation.set(x, y, z, w);
-      obj->needsUpdate = true;
-    }
+    setRotation(find(id), x, y, z, w);
   }
-
   void setScale(const std::string& id, float x, float y, float z) {
-    if (auto* obj = getObject(id)) {
-      obj->transform.scale.set(x, y, z);
-      obj->needsUpdate = true;
-    }
+    setScale(find(id), x, y, z);
   }
 
   // ─── Material Updates ────────────────────────────────────────────────────
 
+  void setColor(ObjectHandle h, float r, float g, float b, float a) {
+    const int i = indexOf(h);
+    if (i < 0) return;
+    mColors[i].set(r, g, b, a);
+    mInstancesDirty = true;
+  }
+
+  void setMaterialType(ObjectHandle h, MaterialType type) {
+    const int i = indexOf(h);
+    if (i < 0) return;
+    mMaterialTypes[i] = type;
+    mInstancesDirty = true;
+  }
+
+  void setPBRParams(ObjectHandle h, float metallic, float roughness) {
+    const int i = indexOf(h);
+    if (i < 0) return;
+    mMetallic[i] = metallic;
+    mRoughness[i] = roughness;
+    mInstancesDirty = true;
+  }
+
   void setColor(const std::string& id, float r, float g, float b, float a) {
-    if (auto* obj = getObject(id)) {
-      obj->material.color.set(r, g, b, a);
-      obj->needsUpdate = true;
+    setColor(find(id), r, g, b, a);
+  }
+  void setMaterialType(const std::string& id, MaterialType type) {
+    setMaterialType(find(id), type);
+  }
+  void setPBRParams(const std::string& id, float metallic, float roughness) {
+    setPBRParams(find(id), metallic, roughness);
+  }
+
+  // ─── Bulk Updates ────────────────────────────────────────────────────────
+  // One call per frame for many objects. Values are packed per object in
+  // the same order as `handles`; stale or invalid handles are skipped.
+
+  /// xyz per object
+  void setPositions(const ObjectHandle* handles, const float* xyz, int count) {
+    for (int k = 0; k < count; k++, xyz += 3) {
+      const int i = indexOf(handles[k]);
+      if (i >= 0) mPositions[i].set(xyz[0], xyz[1], xyz[2]);
     }
+    if (count > 0) mInstancesDirty = true;
   }
 
-  void setMaterialType(const std::string& id, MaterialType type) {
-    if (auto* obj = getObject(id)) {
-      obj->material.type = type;
-      obj->needsUpdate = true;
+  /// xyzw per object
+  void setRotations(const ObjectHandle* handles, const float* xyzw, int count) {
+    for (int k = 0; k < count; k++, xyzw += 4) {
+      const int i = indexOf(handles[k]);
+      if (i >= 0) mRotations[i] = Quatf(xyzw[3], xyzw[0], xyzw[1], xyzw[2]);
     }
+    if (count > 0) mInstancesDirty = true;
   }
 
-  void setPBRParams(const std::string& id, float metallic, float roughness) {
-    if (auto* obj = getObject(id)) {
-      obj->material.metallic = metallic;
-      obj->material.roughness = roughness;
-      obj->needsUpdate = true;
+  /// xyz per object
+  void setScales(const ObjectHandle* handles, const float* xyz, int count) {
+    for (int k = 0; k < count; k++, xyz += 3) {
+      const int i = indexOf(handles[k]);
+      if (i >= 0) mScales[i].set(xyz[0], xyz[1], xyz[2]);
     }
+    if (count > 0) mInstancesDirty = true;
   }
 
-  // ─── Visibility & Lifecycle ──────────────────────────────────────────────
+  /// Position xyz, rotation xyzw, scale xyz: 10 floats per object
+  void setTransforms(const ObjectHandle* handles, const float* v, int count) {
+    for (int k = 0; k < count; k++, v += 10) {
+      const int i = indexOf(handles[k]);
+      if (i < 0) continue;
+      mPositions[i].set(v[0], v[1], v[2]);
+      mRotations[i] = Quatf(v[6], v[3], v[4], v[5]);
+      mScales[i].set(v[7], v[8], v[9]);
+    }
+    if (count > 0) mInstancesDirty = true;
+  }
 
-  void setVisible(const std::string& id, bool visible) {
-    if (auto* obj = getObject(id)) {
-      obj->visible = visible;
+  /// rgba per object
+  void setColors(const ObjectHandle* handles, const float* rgba, int count) {
+    for (int k = 0; k < count; k++, rgba += 4) {
+      const int i = indexOf(handles[k]);
+      if (i >= 0) mColors[i].set(rgba[0], rgba[1], rgba[2], rgba[3]);
     }
+    if (count > 0) mInstancesDirty = true;
   }
 
-  void setSpawnTime(const std::string& id, float time) {
-    if (auto* obj = getObject(id)) {
-      obj->spawnTime = time;
+  /// Metallic, roughness per object
+  void setPBRParams(const ObjectHandle* handles, const float* mr, int count) {
+    for (int k = 0; k < count; k++, mr += 2) {
+      const int i = indexOf(handles[k]);
+      if (i < 0) continue;
+      mMetallic[i] = mr[0];
+      mRoughness[i] = mr[1];
     }
+    if (count > 0) mInstancesDirty = true;
   }
 
-  void setDestroyTime(const std::string& id, float time) {
-    if (auto* obj = getObject(id)) {
-      obj->destroyTime = time;
+  /// Spawn time, destroy time per object (-1 = unbounded)
+  void setLifetimes(const ObjectHandle* handles, const float* times, int count) {
+    for (int k = 0; k < count; k++, times += 2) {
+      const int i = indexOf(handles[k]);
+      if (i < 0) continue;
+      mSpawnTimes[i] = times[0];
+      mDestroyTimes[i] = times[1];
+      scheduleLifecycle((size_t)i);
     }
   }
 
-  void updateLifecycles(float currentTime) {
-    mCurrentTime = currentTime;
+  // ─── Visibility & Lifecycle ──────────────────────────────────────────────
 
-    for (auto& [id, obj] : mObjects) {
-      // Check spawn time
-      if (obj->spawnTime >= 0 && currentTime < obj->spawnTime) {
-        obj->visible = false;
-        continue;
-      }
+  void setVisible(ObjectHandle h, bool visible) {
+    const int i = indexOf(h);
+    if (i < 0) return;
+    if ((mVisible[i] != 0) != visible) mInstancesDirty = true;
+    mVisible[i] = visible ? 1 : 0;
+  }
 
-      // Check destroy time
-      if (obj->destroyTime >= 0 && currentTime >= obj->destroyTime) {
-        obj->visible = false;
-        continue;
-      }
+  void setSpawnTime(ObjectHandle h, float time) {
+    const int i = indexOf(h);
+    if (i < 0) return;
+    mSpawnTimes[i] = time;
+    scheduleLifecycle((size_t)i);
+  }
+
+  void setDestroyTime(ObjectHandle h, float time) {
+    const int i = indexOf(h);
+    if (i < 0) return;
+    mDestroyTimes[i] = time;
+    scheduleLifecycle((size_t)i);
+  }
+
+  void setVisible(const std::string& id, bool visible) { setVisible(find(id), visible); }
+  void setSpawnTime(const std::string& id, float time) { setSpawnTime(find(id), time); }
+  void setDestroyTime(const std::string& id, float time) { setDestroyTime(find(id), time); }
 
-      // Object is within its lifecycle
-      obj->visible = true;
+  /// Show objects between their spawn and destroy times. Moving forward
+  /// only pops the spawn/destroy events now due, plus objects whose times
+  /// changed; seeking backwards rescans every object once. Explicit
+  /// setVisible() holds until the object's next lifecycle event.
+  void updateLifecycles(float currentTime) {
+    if (mLifecycleRebuild || currentTime < mCurrentTime) {
+      rebuildLifecycles(currentTime);
+    } else {
+      for (ObjectHandle h : mLifecycleChanged) {
+        const int i = indexOf(h);
+        if (i >= 0) refreshVisibility((size_t)i, currentTime);
+      }
+      while (!mLifecycleEvents.empty() && mLifecycleEvents.front().time <= currentTime) {
+        std::pop_heap(mLifecycleEvents.begin(), mLifecycleEvents.end(), LaterEvent{});
+        const ObjectHandle h = mLifecycleEvents.back().handle;
+        mLifecycleEvents.pop_back();
+        // Events of removed objects (or old times) just recheck, or miss
+        const int i = indexOf(h);
+        if (i >= 0) refreshVisibility((size_t)i, currentTime);
+      }
     }
+    mLifecycleChanged.clear();
+    mCurrentTime = currentTime;
   }
 
   // ─── Rendering ───────────────────────────────────────────────────────────
@@ -248,54 +452,178 @@ public:
   }
 
   void draw(Graphics& g, WebPBR* pbr = nullptr) {
-    for (auto& [id, obj] : mObjects) {
-      if (obj->visible && obj->mesh) {
-        drawObject(g, *obj, pbr);
-      }
+#ifdef ALLOLIB_WEBGPU
+    if (mGPUDriven && drawGPUDriven(g, pbr)) return;
+#endif
+    if (mInstanced && drawInstanced(g, pbr)) return;
+    for (size_t i = 0; i < mHandles.size(); i++) {
+      if (mVisible[i]) drawObject(g, i, pbr);
     }
   }
 
-  void drawObject(Graphics& g, SceneObject& obj, WebPBR* pbr = nullptr) {
-    if (!obj.mesh) {
-      obj.mesh = getMeshForPrimitive(obj.primitiveType);
-      if (!obj.mesh) return;
-    }
-
-    g.pushMatrix();
-    g.translate(obj.transform.position);
-    g.rotate(obj.transform.rotation);
-    g.scale(obj.transform.scale);
+  /// Cull and draw objects on the GPU (WebGPU only, default on)
+  void setGPUDriven(bool enabled) { mGPUDriven = enabled; }
+  bool isGPUDriven() const { return mGPUDriven; }
 
-    if (obj.material.type == MaterialType::PBR && pbr) {
-      // Use PBR rendering - convert Color to Vec3f for PBRMaterial
-      Vec3f albedo(obj.material.color.r, obj.material.color.g, obj.material.color.b);
-      PBRMaterial mat(albedo, obj.material.metallic, obj.material.roughness);
-      pbr->material(mat);
-      g.draw(*obj.mesh);
-    } else {
-      // Basic rendering
-      g.color(obj.material.color);
-      g.draw(*obj.mesh);
-    }
+  /// Draw instanced groups on WebGL2 (default on); off draws object by
+  /// object with Graphics' own lighting shaders. Lit basic objects shade
+  /// with a headlight when instanced, as on the WebGPU GPU-driven path.
+  void setInstanced(bool enabled) { mInstanced = enabled; }
+  bool isInstanced() const { return mInstanced; }
 
-    g.popMatrix();
-    obj.needsUpdate = false;
+  void drawObject(Graphics& g, ObjectHandle h, WebPBR* pbr = nullptr) {
+    const int i = indexOf(h);
+    if (i >= 0) drawObject(g, (size_t)i, pbr);
   }
 
   // ─── State ───────────────────────────────────────────────────────────────
 
-  size_t objectCount() const { return mObjects.size(); }
+  size_t objectCount() const { return mHandles.size(); }
 
   size_t visibleCount() const {
     size_t count = 0;
-    for (const auto& [id, obj] : mObjects) {
-      if (obj->visible) count++;
-    }
+    for (uint8_t v : mVisible) count += v;
     return count;
   }
 
 private:
-  std::unordered_map<std::string, std::unique_ptr<SceneObject>> mObjects;
+  // Handle = generation << kSlotBits | slot
+  static constexpr int kSlotBits = 20;
+  static constexpr uint32_t kSlotMask = (1u << kSlotBits) - 1;
+  static constexpr uint32_t kGenerationMask = (1u << (31 - kSlotBits)) - 1;
+
+  struct Slot {
+    uint32_t generation = 0;
+    int32_t dense = -1;  // Index into the arrays below, -1 when free
+  };
+
+  // Dense index of a live handle, or -1
+  int indexOf(ObjectHandle h) const {
+    if (h < 0) return -1;
+    const uint32_t slot = (uint32_t)h & kSlotMask;
+    if (slot >= mSlots.size()) return -1;
+    const Slot& s = mSlots[slot];
+    if (s.dense < 0 || (uint32_t)h >> kSlotBits != s.generation) return -1;
+    return s.dense;
+  }
+
+  // For accessors, which require a live handle
+  int checked(ObjectHandle h) const {
+    const int i = indexOf(h);
+    assert(i >= 0 && "ObjectManager: stale or invalid handle");
+    return i;
+  }
+
+  struct LifecycleEvent {
+    float time;
+    ObjectHandle handle;
+  };
+
+  // Min-heap order for std::push_heap / pop_heap
+  struct LaterEvent {
+    bool operator()(const LifecycleEvent& a, const LifecycleEvent& b) const {
+      return a.time > b.time;
+    }
+  };
+
+  void refreshVisibility(size_t i, float currentTime) {
+    const float spawn = mSpawnTimes[i];
+    const float destroy = mDestroyTimes[i];
+    // Visible unless not spawned yet or already destroyed
+    const uint8_t visible =
+        !(spawn >= 0 && currentTime < spawn) && !(destroy >= 0 && currentTime >= destroy);
+    if (visible != mVisible[i]) {
+      mVisible[i] = visible;
+      mInstancesDirty = true;
+    }
+  }
+
+  void pushLifecycleEvent(float time, ObjectHandle h) {
+    mLifecycleEvents.push_back({time, h});
+    std::push_heap(mLifecycleEvents.begin(), mLifecycleEvents.end(), LaterEvent{});
+  }
+
+  // Times of object i changed: recheck it next update, queue what's ahead
+  void scheduleLifecycle(size_t i) {
+    if (mLifecycleRebuild) return;
+    mLifecycleChanged.push_back(mHandles[i]);
+    if (mSpawnTimes[i] >= 0 && mSpawnTimes[i] > mCurrentTime) {
+      pushLifecycleEvent(mSpawnTimes[i], mHandles[i]);
+    }
+    if (mDestroyTimes[i] >= 0 && mDestroyTimes[i] > mCurrentTime) {
+      pushLifecycleEvent(mDestroyTimes[i], mHandles[i]);
+    }
+    // Superseded events pile up when times keep changing; start over
+    if (mLifecycleEvents.size() > 2 * mHandles.size() + 1024) mLifecycleRebuild = true;
+  }
+
+  void rebuildLifecycles(float currentTime) {
+    mLifecycleEvents.clear();
+    for (size_t i = 0; i < mHandles.size(); i++) {
+      refreshVisibility(i, currentTime);
+      if (mSpawnTimes[i] >= 0 && mSpawnTimes[i] > currentTime) {
+        mLifecycleEvents.push_back({mSpawnTimes[i], mHandles[i]});
+      }
+      if (mDestroyTimes[i] >= 0 && mDestroyTimes[i] > currentTime) {
+        mLifecycleEvents.push_back({mDestroyTimes[i], mHandles[i]});
+      }
+    }
+    std::make_heap(mLifecycleEvents.begin(), mLifecycleEvents.end(), LaterEvent{});
+    mLifecycleRebuild = false;
+  }
+
+  ObjectTransform transform(size_t i) const {
+    ObjectTransform t;
+    t.position = mPositions[i];
+    t.rotation = mRotations[i];
+    t.scale = mScales[i];
+    return t;
+  }
+
+  void drawObject(Graphics& g, size_t i, WebPBR* pbr) {
+    VAOMesh* mesh = getMeshForPrimitive(mPrimitives[i]);
+    if (!mesh) return;
+
+    g.pushMatrix();
+    g.translate(mPositions[i]);
+    g.rotate(mRotations[i]);
+    g.scale(mScales[i]);
+
+    if (mMaterialTypes[i] == MaterialType::PBR && pbr) {
+      // Use PBR rendering - convert Color to Vec3f for PBRMaterial
+      Vec3f albedo(mColors[i].r, mColors[i].g, mColors[i].b);
+      PBRMaterial mat(albedo, mMetallic[i], mRoughness[i]);
+      pbr->material(mat);
+      g.draw(*mesh);
+    } else {
+      // Basic rendering
+      g.color(mColors[i]);
+      g.draw(*mesh);
+    }
+
+    g.popMatrix();
+  }
+
+  std::vector<Slot> mSlots;
+  std::vector<int> mFreeSlots;
+  std::unordered_map<std::string, ObjectHandle> mIdIndex;
+
+  // Per-object properties, one entry per live object, same order
+  std::vector<ObjectHandle> mHandles;
+  std::vector<std::string> mIds;
+  std::vector<std::string> mNames;
+  std::vector<ObjectPrimitive> mPrimitives;
+  std::vector<Vec3f> mPositions;
+  std::vector<Quatf> mRotations;
+  std::vector<Vec3f> mScales;
+  std::vector<Color> mColors;
+  std::vector<MaterialType> mMaterialTypes;
+  std::vector<float> mMetallic;
+  std::vector<float> mRoughness;
+  std::vector<uint8_t> mVisible;
+  std::vector<uint8_t> mLocked;
+  std::vector<float> mSpawnTimes;
+  std::vector<float> mDestroyTimes;
 
   // Shared primitive meshes
   std::unique_ptr<VAOMesh> mSphereMesh;
@@ -306,7 +634,415 @@ private:
   std::unique_ptr<VAOMesh> mPlaneMesh;
 
   bool mMeshesInitialized = false;
-  float mCurrentTime = 0;
+  float mCurrentTime = 0;  // Of the last updateLifecycles()
+
+  // Spawn/destroy times still ahead of mCurrentTime, earliest on top
+  std::vector<LifecycleEvent> mLifecycleEvents;
+  std::vector<ObjectHandle> mLifecycleChanged;  // Recheck next update
+  bool mLifecycleRebuild = true;                 // Rescan on next update
+
+  // GPU-driven path: instances are rebuilt only when something changed
+  bool mGPUDriven = true;
+  bool mInstancesDirty = true;
+
+  // Indexed triangle list of a primitive mesh, empty if it has no triangles
+  static std::vector<uint32_t> triangleIndices(const Mesh& mesh) {
+    std::vector<uint32_t> source;
+    if (mesh.indices().empty()) {
+      source.resize(mesh.vertices().size());
+      for (uint32_t i = 0; i < source.size(); i++) source[i] = i;
+    } else {
+      source.assign(mesh.indices().begin(), mesh.indices().end());
+    }
+
+    std::vector<uint32_t> triangles;
+    if (mesh.primitive() == Mesh::TRIANGLES) {
+      triangles = std::move(source);
+      triangles.resize(triangles.size() - triangles.size() % 3);
+    } else if (mesh.primitive() == Mesh::TRIANGLE_STRIP) {
+      for (size_t i = 2; i < source.size(); i++) {
+        // Keep the winding consistent on odd triangles
+        if (i % 2 == 0) {
+          triangles.insert(triangles.end(), {source[i - 2], source[i - 1], source[i]});
+        } else {
+          triangles.insert(triangles.end(), {source[i - 1], source[i - 2], source[i]});
+        }
+      }
+    }
+    return triangles;
+  }
+
+  // ─── Instanced path (WebGL2) ─────────────────────────────────────────────
+  //
+  // Visible objects are sorted into one instance buffer by primitive, then
+  // material (basic, PBR), so each (primitive, material) group is a single
+  // glDrawElementsInstanced over a contiguous range. The model matrix in
+  // each instance is the object's own; g's model-view goes in a uniform, so
+  // moving the camera or the enclosing transform doesn't rebuild anything.
+
+  struct GLInstance {
+    float model[16];
+    float color[4];
+    float material[4];  // metallic, roughness, unused, unused
+  };
+
+  struct GLPrimitive {
+    GLuint vao = 0;
+    GLuint positions = 0;
+    GLuint normals = 0;  // 0 when the mesh has none
+    GLuint indices = 0;
+    GLsizei indexCount = 0;
+  };
+
+  struct InstanceGroup {
+    uint32_t first = 0;
+    uint32_t count = 0;
+  };
+
+  static const char* instanceVertShader() {
+    return R"(#version 300 es
+precision highp float;
+
+layout (location = 0) in vec3 position;
+layout (location = 3) in vec3 normal;
+layout (location = 4) in mat4 instanceModel;
+layout (location = 8) in vec4 instanceColor;
+
+uniform mat4 al_ModelViewMatrix;
+uniform mat4 al_ProjectionMatrix;
+
+out vec4 vColor;
+out vec3 vNormal;
+
+void main() {
+    mat4 modelView = al_ModelViewMatrix * instanceModel;
+    vColor = instanceColor;
+    vNormal = mat3(modelView) * normal;
+    gl_Position = al_ProjectionMatrix * modelView * vec4(position, 1.0);
+}
+)";
+  }
+
+  static const char* instanceFragShader() {
+    return R"(#version 300 es
+precision highp float;
+
+in vec4 vColor;
+in vec3 vNormal;
+
+uniform int lit;
+
+out vec4 frag_color;
+
+void main() {
+    if (lit == 0) {
+        frag_color = vColor;
+        return;
+    }
+    // Headlight shading when lighting is on (as the WebGPU indirect shader)
+    vec3 n = normalize(vNormal);
+    float shade = 0.25 + 0.75 * abs(n.z);
+    frag_color = vec4(vColor.rgb * shade, vColor.a);
+}
+)";
+  }
+
+  // Returns false when this path can't draw (WebGPU, no meshes, no shader)
+  bool drawInstanced(Graphics& g, WebPBR* pbr) {
+    if (!mMeshesInitialized || Graphics_isWebGPU()) return false;
+    if (!mGLCreated) createInstancing();
+    if (!mInstanceShaderOk) return false;
+
+    // PBR objects shade as basic without a WebPBR, so its presence is part of the build
+    if ((pbr != nullptr) != mGLPBR) mInstancesDirty = true;
+    if (mInstancesDirty) {
+      buildInstances(pbr != nullptr);
+      mInstancesDirty = false;
+    }
+
+    const Mat4f modelView = g.viewMatrix() * g.modelMatrix();
+    const Mat4f& proj = g.projMatrix();
+
+    bool hasPBR = false;
+    for (int p = 0; p < 6; p++) hasPBR = hasPBR || mGroups[p][1].count > 0;
+    if (hasPBR) {
+      ShaderProgram* shader = pbr->beginInstanced();
+      if (shader) {
+        shader->uniform("al_ModelViewMatrix", modelView);
+        shader->uniform("al_ProjectionMatrix", proj);
+        for (int p = 0; p < 6; p++) drawGroup(p, mGroups[p][1]);
+        glBindVertexArray(0);
+        pbr->endInstanced();
+      } else {
+        // Outside a WebPBR pass (or on a context without one): one by one
+        for (int p = 0; p < 6; p++) {
+          const InstanceGroup& group = mGroups[p][1];
+          for (uint32_t i = group.first; i < group.first + group.count; i++) {
+            drawObject(g, (size_t)mGLInstanceObjects[i], pbr);
+          }
+        }
+      }
+    }
+
+    bool hasBasic = false;
+    for (int p = 0; p < 6; p++) hasBasic = hasBasic || mGroups[p][0].count > 0;
+    if (hasBasic) {
+      mInstanceShader.use();
+      mInstanceShader.uniform("al_ModelViewMatrix", modelView);
+      mInstanceShader.uniform("al_ProjectionMatrix", proj);
+      mInstanceShader.uniform("lit", g.lightingEnabled() ? 1 : 0);
+      for (int p = 0; p < 6; p++) drawGroup(p, mGroups[p][0]);
+      glBindVertexArray(0);
+      // Graphics expects its own program to still be bound
+      if (ShaderProgram* current = g.shaderPtr()) current->use();
+    }
+
+    // Primitives without triangles draw one by one
+    for (size_t o = 0; o < mHandles.size(); o++) {
+      if (mVisible[o] && !mGLPrimitives[(int)mPrimitives[o]].vao) drawObject(g, o, pbr);
+    }
+    return true;
+  }
+
+  void createInstancing() {
+    mGLCreated = true;
+    glGenBuffers(1, &mGLInstanceBuffer);
+
+    VAOMesh* meshes[6] = {mSphereMesh.get(), mCubeMesh.get(), mCylinderMesh.get(),
+                          mConeMesh.get(), mTorusMesh.get(), mPlaneMesh.get()};
+    for (int i = 0; i < 6; i++) {
+      if (meshes[i]) createPrimitive(*meshes[i], mGLPrimitives[i]);
+    }
+
+    mInstanceShaderOk = mInstanceShader.compile(instanceVertShader(), instanceFragShader());
+    if (!mInstanceShaderOk) {
+      printf("[ObjectManager] Instanced shader failed to compile; drawing per object\n");
+    }
+    mInstancesDirty = true;
+  }
+
+  void createPrimitive(const Mesh& mesh, GLPrimitive& prim) {
+    const auto& vertices = mesh.vertices();
+    const std::vector<uint32_t> triangles = triangleIndices(mesh);
+    if (vertices.empty() || triangles.empty()) return;
+
+    glGenVertexArrays(1, &prim.vao);
+    glBindVertexArray(prim.vao);
+
+    glGenBuffers(1, &prim.positions);
+    glBindBuffer(GL_ARRAY_BUFFER, prim.positions);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vec3f), vertices[0].elems(),
+                 GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vec3f), nullptr);
+
+    if (mesh.normals().size() == vertices.size()) {
+      glGenBuffers(1, &prim.normals);
+      glBindBuffer(GL_ARRAY_BUFFER, prim.normals);
+      glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vec3f), mesh.normals()[0].elems(),
+                   GL_STATIC_DRAW);
+      glEnableVertexAttribArray(3);
+      glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vec3f), nullptr);
+    }
+
+    glGenBuffers(1, &prim.indices);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, prim.indices);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, triangles.size() * sizeof(uint32_t), triangles.data(),
+                 GL_STATIC_DRAW);
+    prim.indexCount = (GLsizei)triangles.size();
+
+    // Instance attributes: mat4 model (4-7), color (8), material (9);
+    // drawGroup() points them at the group's range
+    glBindBuffer(GL_ARRAY_BUFFER, mGLInstanceBuffer);
+    for (GLuint loc = 4; loc <= 9; loc++) {
+      glEnableVertexAttribArray(loc);
+      glVertexAttribDivisor(loc, 1);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+
+  void buildInstances(bool pbr) {
+    auto material = [&](size_t o) {
+      return mMaterialTypes[o] == MaterialType::PBR && pbr ? 1 : 0;
+    };
+
+    uint32_t counts[6][2] = {};
+    uint32_t total = 0;
+    for (size_t o = 0; o < mHandles.size(); o++) {
+      const int p = (int)mPrimitives[o];
+      if (!mVisible[o] || !mGLPrimitives[p].vao) continue;
+      counts[p][material(o)]++;
+      total++;
+    }
+
+    uint32_t next[6][2];
+    uint32_t first = 0;
+    for (int p = 0; p < 6; p++) {
+      for (int m = 0; m < 2; m++) {
+        mGroups[p][m].first = next[p][m] = first;
+        mGroups[p][m].count = counts[p][m];
+        first += counts[p][m];
+      }
+    }
+
+    mGLInstances.resize(total);
+    mGLInstanceObjects.resize(total);
+    for (size_t o = 0; o < mHandles.size(); o++) {
+      const int p = (int)mPrimitives[o];
+      if (!mVisible[o] || !mGLPrimitives[p].vao) continue;
+      const uint32_t i = next[p][material(o)]++;
+      GLInstance& inst = mGLInstances[i];
+      const Mat4f model = transform(o).toMatrix();
+      for (int k = 0; k < 16; k++) inst.model[k] = model[k];
+      inst.color[0] = mColors[o].r;
+      inst.color[1] = mColors[o].g;
+      inst.color[2] = mColors[o].b;
+      inst.color[3] = mColors[o].a;
+      inst.material[0] = mMetallic[o];
+      inst.material[1] = mRoughness[o];
+      inst.material[2] = 0;
+      inst.material[3] = 0;
+      mGLInstanceObjects[i] = (uint32_t)o;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, mGLInstanceBuffer);
+    if (total > mGLInstanceCapacity) {
+      mGLInstanceCapacity = total + total / 2;
+      glBufferData(GL_ARRAY_BUFFER, mGLInstanceCapacity * sizeof(GLInstance), nullptr,
+                   GL_DYNAMIC_DRAW);
+    }
+    if (total > 0) {
+      glBufferSubData(GL_ARRAY_BUFFER, 0, total * sizeof(GLInstance), mGLInstances.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    mGLPBR = pbr;
+  }
+
+  void drawGroup(int p, const InstanceGroup& group) {
+    if (group.count == 0) return;
+    const GLPrimitive& prim = mGLPrimitives[p];
+    glBindVertexArray(prim.vao);
+    if (!prim.normals) glVertexAttrib3f(3, 0, 0, 1);
+
+    // WebGL2 has no base instance, so the attributes start at the group
+    glBindBuffer(GL_ARRAY_BUFFER, mGLInstanceBuffer);
+    const size_t base = (size_t)group.first * sizeof(GLInstance);
+    const GLsizei stride = sizeof(GLInstance);
+    for (GLuint c = 0; c < 4; c++) {
+      glVertexAttribPointer(4 + c, 4, GL_FLOAT, GL_FALSE, stride,
+                            (const void*)(base + offsetof(GLInstance, model) + c * 4 * sizeof(float)));
+    }
+    glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, stride,
+                          (const void*)(base + offsetof(GLInstance, color)));
+    glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, stride,
+                          (const void*)(base + offsetof(GLInstance, material)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glDrawElementsInstanced(GL_TRIANGLES, prim.indexCount, GL_UNSIGNED_INT, nullptr,
+                            (GLsizei)group.count);
+  }
+
+  bool mInstanced = true;
+  bool mGLCreated = false;
+  bool mGLPBR = false;                      // PBR groups in the last build
+  GLPrimitive mGLPrimitives[6];             // Per ObjectPrimitive
+  GLuint mGLInstanceBuffer = 0;
+  size_t mGLInstanceCapacity = 0;           // In instances
+  std::vector<GLInstance> mGLInstances;
+  std::vector<uint32_t> mGLInstanceObjects; // Dense index per instance
+  InstanceGroup mGroups[6][2];              // [primitive][basic, PBR]
+  ShaderProgram mInstanceShader;
+  bool mInstanceShaderOk = false;
+
+#ifdef ALLOLIB_WEBGPU
+  WebGPUBackend* mIndirectBackend = nullptr;
+  int mIndirectMesh[6] = {-1, -1, -1, -1, -1, -1};  // Per ObjectPrimitive
+  Mat4f mIndirectModel;                             // g.modelMatrix() of the last build
+  std::vector<WebGPUBackend::IndirectInstance> mIndirectInstances;
+  std::vector<WebGPUBackend::IndirectMaterial> mIndirectMaterials;  // Parallel to instances
+  bool mIndirectPBR = false;                        // PBR shading in the last build
+
+  // Register a primitive with the backend as an indexed triangle list
+  static int registerIndirectMesh(WebGPUBackend* backend, const Mesh& mesh) {
+    const auto& vertices = mesh.vertices();
+    if (vertices.empty()) return -1;
+    const std::vector<uint32_t> triangles = triangleIndices(mesh);
+    if (triangles.empty()) return -1;
+
+    const float* normals = mesh.normals().size() == vertices.size()
+        ? mesh.normals()[0].elems() : nullptr;
+    return backend->createIndirectMesh(vertices[0].elems(), normals, (uint32_t)vertices.size(),
+                                       triangles.data(), (uint32_t)triangles.size());
+  }
+
+  // Returns false when the backend can't take this path (WebGL2, no meshes)
+  bool drawGPUDriven(Graphics& g, WebPBR* pbr) {
+    if (!mMeshesInitialized || !Graphics_isWebGPU()) return false;
+    auto* backend = dynamic_cast<WebGPUBackend*>(Graphics_getBackend());
+    if (!backend) return false;
+
+    if (backend != mIndirectBackend) {
+      VAOMesh* meshes[6] = {mSphereMesh.get(), mCubeMesh.get(), mCylinderMesh.get(),
+                            mConeMesh.get(), mTorusMesh.get(), mPlaneMesh.get()};
+      for (int i = 0; i < 6; i++) {
+        mIndirectMesh[i] = meshes[i] ? registerIndirectMesh(backend, *meshes[i]) : -1;
+      }
+      mIndirectBackend = backend;
+      mInstancesDirty = true;
+    }
+
+    const Mat4f& model = g.modelMatrix();
+    for (int i = 0; i < 16 && !mInstancesDirty; i++) {
+      if (model[i] != mIndirectModel[i]) mInstancesDirty = true;
+    }
+    // PBR objects shade as basic without a WebPBR, so its presence is part of the build
+    if ((pbr != nullptr) != mIndirectPBR) mInstancesDirty = true;
+
+    // Primitives the backend didn't accept draw one by one
+    auto isIndirect = [&](size_t i) {
+      return mIndirectMesh[(int)mPrimitives[i]] >= 0;
+    };
+
+    if (mInstancesDirty) {
+      mIndirectInstances.clear();
+      mIndirectMaterials.clear();
+      for (size_t o = 0; o < mHandles.size(); o++) {
+        if (!mVisible[o] || !isIndirect(o)) continue;
+        WebGPUBackend::IndirectInstance inst;
+        Mat4f world = model * transform(o).toMatrix();
+        for (int i = 0; i < 16; i++) inst.model[i] = world[i];
+        inst.color[0] = mColors[o].r;
+        inst.color[1] = mColors[o].g;
+        inst.color[2] = mColors[o].b;
+        inst.color[3] = mColors[o].a;
+        inst.mesh = (uint32_t)mIndirectMesh[(int)mPrimitives[o]];
+        mIndirectInstances.push_back(inst);
+
+        WebGPUBackend::IndirectMaterial mat;
+        if (mMaterialTypes[o] == MaterialType::PBR && pbr) {
+          mat.metallic = mMetallic[o];
+          mat.roughness = mRoughness[o];
+          mat.shading = 1;
+        }
+        mIndirectMaterials.push_back(mat);
+      }
+      backend->setIndirectInstances(mIndirectInstances.data(), (uint32_t)mIndirectInstances.size(),
+                                    mIndirectMaterials.data());
+      mIndirectModel = model;
+      mIndirectPBR = pbr != nullptr;
+      mInstancesDirty = false;
+    }
+
+    backend->drawIndirectInstances(g.viewMatrix().elems(), g.projMatrix().elems());
+
+    for (size_t o = 0; o < mHandles.size(); o++) {
+      if (mVisible[o] && !isIndirect(o)) drawObject(g, o, pbr);
+    }
+    return true;
+  }
+#endif
 
   VAOMesh* getMeshForPrimitive(ObjectPrimitive type) {
     if (!mMeshesInitialized) {
@@ -407,64 +1143,122 @@ inline MaterialType materialFromString(const std::string& str) {
 
 extern "C" {
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline int al_obj_create(const char* id, const char* name, const char* primitive) {
   auto type = al::primitiveFromString(primitive);
-  auto* obj = al::objectManager().createObject(id, name, type);
-  return obj ? 1 : 0;
+  return al::objectManager().createObject(id, name, type) != al::kInvalidObject ? 1 : 0;
 }
 
+/// Handle for an id (-1 if none); resolve once, then use the bulk setters
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline int al_obj_handle(const char* id) {
+  return al::objectManager().find(id);
+}
+
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline int al_obj_remove(const char* id) {
   return al::objectManager().removeObject(id) ? 1 : 0;
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_obj_clear() {
   al::objectManager().clear();
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_obj_set_position(const char* id, float x, float y, float z) {
   al::objectManager().setPosition(id, x, y, z);
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_obj_set_rotation(const char* id, float x, float y, float z, float w) {
   al::objectManager().setRotation(id, x, y, z, w);
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_obj_set_scale(const char* id, float x, float y, float z) {
   al::objectManager().setScale(id, x, y, z);
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_obj_set_color(const char* id, float r, float g, float b, float a) {
   al::objectManager().setColor(id, r, g, b, a);
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_obj_set_material_type(const char* id, const char* type) {
   al::objectManager().setMaterialType(id, al::materialFromString(type));
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_obj_set_pbr_params(const char* id, float metallic, float roughness) {
   al::objectManager().setPBRParams(id, metallic, roughness);
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_obj_set_visible(const char* id, int visible) {
   al::objectManager().setVisible(id, visible != 0);
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_obj_set_spawn_time(const char* id, float time) {
   al::objectManager().setSpawnTime(id, time);
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_obj_set_destroy_time(const char* id, float time) {
   al::objectManager().setDestroyTime(id, time);
 }
 
+// Bulk setters: `handles` is an Int32Array and `values` a Float32Array on
+// the WASM heap, packed per object as documented on ObjectManager.
+
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline void al_obj_set_positions(const int32_t* handles, const float* xyz, int count) {
+  al::objectManager().setPositions(handles, xyz, count);
+}
+
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline void al_obj_set_rotations(const int32_t* handles, const float* xyzw, int count) {
+  al::objectManager().setRotations(handles, xyzw, count);
+}
+
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline void al_obj_set_scales(const int32_t* handles, const float* xyz, int count) {
+  al::objectManager().setScales(handles, xyz, count);
+}
+
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline void al_obj_set_transforms(const int32_t* handles, const float* values, int count) {
+  al::objectManager().setTransforms(handles, values, count);
+}
+
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline void al_obj_set_colors(const int32_t* handles, const float* rgba, int count) {
+  al::objectManager().setColors(handles, rgba, count);
+}
+
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline void al_obj_set_pbr_params_bulk(const int32_t* handles, const float* mr, int count) {
+  al::objectManager().setPBRParams(handles, mr, count);
+}
+
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline void al_obj_set_lifetimes(const int32_t* handles, const float* times, int count) {
+  al::objectManager().setLifetimes(handles, times, count);
+}
+
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_obj_update_lifecycles(float currentTime) {
   al::objectManager().updateLifecycles(currentTime);
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline int al_obj_count() {
   return static_cast<int>(al::objectManager().objectCount());
 }
 
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline int al_obj_visible_count() {
   return static_cast<int>(al::objectManager().visibleCount());
 }
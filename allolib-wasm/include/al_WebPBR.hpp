@@ -2,7 +2,13 @@
  * Web PBR Material System
  *
  * Physically Based Rendering with Image-Based Lighting for WebGL2.
- * Implements the metallic-roughness workflow with IBL support.
+ * Implements the metallic-roughness workflow with IBL support. The
+ * prefiltered specular chain, irradiance map and BRDF LUT are baked on the
+ * GPU once per environment (IBLBaker, WebGPUBackend::bakeIBL*) and shared
+ * through GPUResourceCache. diffuseMode(PBRDiffuse::SphericalHarmonics)
+ * swaps the irradiance map for an L2 SH projection (cheaper on mobile).
+ * On WebGL2 the specular chain and the skybox are cubemaps (PBR_ENV_CUBE
+ * permutations) whenever they could be baked.
  *
  * Usage:
  *   WebPBR pbr;
@@ -10,6 +16,7 @@
  *
  *   // In onCreate
  *   pbr.create(g);
+ *   pbr.warmUp(sceneMaterials);  // Compile their permutations up front
  *
  *   // In onDraw
  *   pbr.drawSkybox(g);
@@ -29,12 +36,19 @@
 #define AL_WEB_PBR_HPP
 
 #include <emscripten.h>
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <cmath>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <unordered_map>
 
+#include "al_WebClusteredLights.hpp"
 #include "al_WebHDR.hpp"
+#include "al_WebIBL.hpp"
+#include "al_WebResourceCache.hpp"
 #include "al/graphics/al_Mesh.hpp"
 #include "al/graphics/al_Shader.hpp"
 #include "al/graphics/al_Graphics.hpp"
@@ -127,10 +141,30 @@ struct PBRMaterialEx : public PBRMaterial {
     int emissiveMapUnit = 8;
     int heightMapUnit = 9;
 
+    /// Feature bits; each enabled map compiles into its own shader
+    /// permutation, so unused maps cost nothing per fragment
+    enum Feature : uint32_t {
+        AlbedoMap    = 1 << 0,
+        NormalMap    = 1 << 1,
+        RoughnessMap = 1 << 2,
+        MetallicMap  = 1 << 3,
+        AOMap        = 1 << 4,
+        EmissiveMap  = 1 << 5,
+        HeightMap    = 1 << 6,
+        AllFeatures  = (1 << 7) - 1
+    };
+
     PBRMaterialEx() = default;
 
     PBRMaterialEx(const PBRMaterial& base) : PBRMaterial(base) {}
 
+    uint32_t features() const {
+        return (useAlbedoMap ? AlbedoMap : 0) | (useNormalMap ? NormalMap : 0) |
+               (useRoughnessMap ? RoughnessMap : 0) | (useMetallicMap ? MetallicMap : 0) |
+               (useAOMap ? AOMap : 0) | (useEmissiveMap ? EmissiveMap : 0) |
+               (useHeightMap ? HeightMap : 0);
+    }
+
     // Builder pattern for fluent API
     PBRMaterialEx& withAlbedoMap(int unit = 3) {
         useAlbedoMap = true;
@@ -217,6 +251,87 @@ struct PBRMaterialEx : public PBRMaterial {
     }
 };
 
+/**
+ * Diffuse IBL source for the IBL shaders
+ */
+enum class PBRDiffuse {
+    IrradianceMap,       // Equirect irradiance map (one fetch per fragment)
+    SphericalHarmonics   // 9 L2 SH coefficients from a uniform block, no fetch
+};
+
+/**
+ * Shader source with #defines inserted after its #version line, for the
+ * compile-time variants of the shaders below (e.g. PBR_SH_DIFFUSE)
+ */
+inline std::string pbr_shader_variant(const std::string& source,
+                                      const std::vector<std::string>& defines) {
+    size_t lineEnd = source.find('\n');
+    if (lineEnd == std::string::npos) return source;
+    std::string block;
+    for (const auto& define : defines) block += "#define " + define + "\n";
+    return source.substr(0, lineEnd + 1) + block + source.substr(lineEnd + 1);
+}
+
+inline std::string pbr_shader_variant(const std::string& source, const char* define) {
+    return pbr_shader_variant(source, std::vector<std::string>{define});
+}
+
+/**
+ * HAS_*_MAP defines for a PBRMaterialEx::features() mask
+ */
+inline std::vector<std::string> pbr_feature_defines(uint32_t features) {
+    static const char* names[] = {
+        "HAS_ALBEDO_MAP", "HAS_NORMAL_MAP", "HAS_ROUGHNESS_MAP", "HAS_METALLIC_MAP",
+        "HAS_AO_MAP", "HAS_EMISSIVE_MAP", "HAS_HEIGHT_MAP"
+    };
+    std::vector<std::string> defines;
+    for (int i = 0; i < 7; i++) {
+        if (features & (1u << i)) defines.push_back(names[i]);
+    }
+    return defines;
+}
+
+/**
+ * Clustered point lights for the PBR fragment shaders (PBR_CLUSTERED_LIGHTS
+ * variants): Cook-Torrance GGX over the lights of the fragment's froxel,
+ * read from the ClusteredLights grid. Empty without the define.
+ */
+inline std::string pbr_clustered_lights_glsl() {
+    return "#ifdef PBR_CLUSTERED_LIGHTS\nprecision highp int;\n" +
+           al_clustered_lights_frag_functions() + R"(
+// View-space direct lighting from the froxel's point lights
+vec3 clusteredLights(vec3 P, vec3 N, vec3 V, vec3 baseColor, float metal, float rough, vec3 F0) {
+    float a2 = rough * rough * rough * rough;
+    float k = (rough + 1.0) * (rough + 1.0) / 8.0;
+    float NdotV = max(dot(N, V), 0.0);
+    vec3 result = vec3(0.0);
+    uvec2 range = al_clusterRange(-P.z);
+    for (uint i = 0u; i < range.y; i++) {
+        vec4 posRadius;
+        vec3 lightColor;
+        al_clusterLight(range.x + i, posRadius, lightColor);
+        vec3 toLight = posRadius.xyz - P;
+        float dist = length(toLight);
+        if (dist >= posRadius.w) continue;
+        vec3 L = toLight / dist;
+        vec3 H = normalize(V + L);
+        float NdotL = max(dot(N, L), 0.0);
+        float NdotH = max(dot(N, H), 0.0);
+        float d = NdotH * NdotH * (a2 - 1.0) + 1.0;
+        float D = a2 / (PI * d * d);
+        float G = (NdotV / (NdotV * (1.0 - k) + k)) * (NdotL / (NdotL * (1.0 - k) + k));
+        vec3 F = F0 + (1.0 - F0) * pow(clamp(1.0 - max(dot(H, V), 0.0), 0.0, 1.0), 5.0);
+        vec3 kD = (vec3(1.0) - F) * (1.0 - metal);
+        vec3 specular = D * G * F / (4.0 * NdotV * NdotL + 0.0001);
+        result += (kD * baseColor / PI + specular) * lightColor *
+                  al_clusterAttenuation(dist, posRadius.w) * NdotL;
+    }
+    return result;
+}
+#endif
+)";
+}
+
 /**
  * PBR vertex shader
  * Uses view space for calculations, passes data needed for IBL
@@ -238,14 +353,33 @@ out vec3 vViewNormal;
 out vec3 vLocalPos;  // Local position for computing normals if needed
 out vec2 vTexCoord;
 
+#ifdef PBR_INSTANCED
+// Per-instance model matrix and material (WebPBR::beginInstanced)
+layout (location = 4) in mat4 instanceModel;
+layout (location = 8) in vec4 instanceColor;
+layout (location = 9) in vec4 instanceMaterial;  // metallic, roughness
+
+flat out vec3 albedo;
+flat out float metallic;
+flat out float roughness;
+#endif
+
 void main() {
-    vec4 viewPos = al_ModelViewMatrix * vec4(position, 1.0);
+#ifdef PBR_INSTANCED
+    mat4 modelView = al_ModelViewMatrix * instanceModel;
+    albedo = instanceColor.rgb;
+    metallic = instanceMaterial.x;
+    roughness = instanceMaterial.y;
+#else
+    mat4 modelView = al_ModelViewMatrix;
+#endif
+    vec4 viewPos = modelView * vec4(position, 1.0);
     vViewPos = viewPos.xyz;
     vLocalPos = position;
 
     // Use actual vertex normal from mesh (location 3)
     // Transform to view space using upper-left 3x3 of ModelViewMatrix
-    mat3 normalMatrix = mat3(al_ModelViewMatrix);
+    mat3 normalMatrix = mat3(modelView);
     vViewNormal = normalize(normalMatrix * normal);
 
     vTexCoord = texcoord;
@@ -269,16 +403,43 @@ in vec3 vLocalPos;  // Local position (for computing normals if needed)
 in vec2 vTexCoord;
 
 // Material properties
+#ifdef PBR_INSTANCED
+flat in vec3 albedo;
+flat in float metallic;
+flat in float roughness;
+#else
 uniform vec3 albedo;
 uniform float metallic;
 uniform float roughness;
+#endif
 uniform float ao;
 uniform vec3 emission;
 
 // IBL textures
-uniform sampler2D envMap;        // HDR environment
-uniform sampler2D irradianceMap; // Diffuse IBL
+#ifdef PBR_ENV_CUBE
+uniform samplerCube envMap;      // Prefiltered specular (mip = roughness)
+#else
+uniform sampler2D envMap;        // Prefiltered specular (mip = roughness)
+#endif
 uniform sampler2D brdfLUT;       // BRDF lookup
+#ifdef PBR_SH_DIFFUSE
+// L2 spherical-harmonics irradiance (SHIrradiance) instead of a map fetch
+layout(std140) uniform PBRDiffuseSH {
+    vec4 shCoeffs[9];
+};
+
+vec3 irradianceSH(vec3 n) {
+    vec3 e = shCoeffs[0].rgb
+           + shCoeffs[1].rgb * n.y + shCoeffs[2].rgb * n.z + shCoeffs[3].rgb * n.x
+           + shCoeffs[4].rgb * (n.x * n.y) + shCoeffs[5].rgb * (n.y * n.z)
+           + shCoeffs[6].rgb * (3.0 * n.z * n.z - 1.0)
+           + shCoeffs[7].rgb * (n.x * n.z) + shCoeffs[8].rgb * (n.x * n.x - n.y * n.y);
+    return max(e, vec3(0.0));  // L2 rings slightly negative opposite bright sources
+}
+#else
+uniform sampler2D irradianceMap; // Diffuse IBL
+#endif
+uniform float envMaxLod;         // Last mip of envMap
 
 // Camera - inverse view rotation to go from view space to world space
 uniform mat3 invViewRot;
@@ -309,24 +470,16 @@ vec3 fresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness) {
     return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
 }
 
-// Sample pre-filtered environment at roughness level
+// Sample the prefiltered environment: one mip per roughness step
 vec3 sampleEnvLOD(vec3 worldDir, float roughness) {
-    vec2 uv = directionToUV(worldDir);
-    vec3 color = texture(envMap, uv).rgb;
-
-    // Approximate roughness blur by averaging nearby samples
-    if (roughness > 0.1) {
-        float blur = roughness * 0.03;
-        color += texture(envMap, uv + vec2(blur, 0.0)).rgb;
-        color += texture(envMap, uv + vec2(-blur, 0.0)).rgb;
-        color += texture(envMap, uv + vec2(0.0, blur)).rgb;
-        color += texture(envMap, uv + vec2(0.0, -blur)).rgb;
-        color /= 5.0;
-    }
-
-    return color;
+#ifdef PBR_ENV_CUBE
+    return textureLod(envMap, worldDir, roughness * envMaxLod).rgb;
+#else
+    return textureLod(envMap, directionToUV(worldDir), roughness * envMaxLod).rgb;
+#endif
 }
 
+)" + pbr_clustered_lights_glsl() + R"(
 void main() {
     // Everything in view space first
     vec3 N = normalize(vViewNormal);
@@ -342,22 +495,12 @@ void main() {
     F0 = mix(F0, albedo, metallic);
 
     // ========== IBL Diffuse ==========
+#ifdef PBR_SH_DIFFUSE
+    vec3 irradiance = irradianceSH(worldN);
+#else
     vec2 irradianceUV = directionToUV(worldN);
     vec3 irradiance = texture(irradianceMap, irradianceUV).rgb;
-
-    // Fallback: if irradiance map weak, sample env with blur
-    if (length(irradiance) < 0.001) {
-        vec3 up = abs(worldN.y) < 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
-        vec3 tangent = normalize(cross(up, worldN));
-        vec3 bitangent = cross(worldN, tangent);
-
-        irradiance = texture(envMap, directionToUV(worldN)).rgb * 0.3;
-        irradiance += texture(envMap, directionToUV(normalize(worldN + tangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN - tangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN + bitangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN - bitangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN + vec3(0.0, 0.5, 0.0)))).rgb * 0.1;
-    }
+#endif
 
     float NdotV = max(dot(N, V), 0.0);
     vec3 kS = fresnelSchlickRoughness(NdotV, F0, roughness);
@@ -373,18 +516,14 @@ void main() {
     vec2 brdfUV = vec2(NdotV, roughness);
     vec2 brdf = texture(brdfLUT, brdfUV).rg;
 
-    // If BRDF LUT not available, use approximation
-    if (brdf.x < 0.001 && brdf.y < 0.001) {
-        float a = roughness * roughness;
-        brdf.x = 1.0 - a * 0.5;
-        brdf.y = a * 0.5;
-    }
-
     vec3 specular = prefilteredColor * (kS * brdf.x + brdf.y);
 
     // ========== Combine ==========
     vec3 ambient = (kD * diffuse + specular) * ao * envIntensity;
     vec3 color = ambient + emission;
+#ifdef PBR_CLUSTERED_LIGHTS
+    color += clusteredLights(vViewPos, N, V, albedo, metallic, roughness, F0);
+#endif
 
     // Tone mapping (Reinhard)
     color *= exposure;
@@ -428,7 +567,11 @@ inline std::string pbr_skybox_frag() {
 precision highp float;
 
 in vec3 vDirection;
+#ifdef PBR_ENV_CUBE
+uniform samplerCube envMap;
+#else
 uniform sampler2D envMap;
+#endif
 uniform float exposure;
 uniform float gamma;
 out vec4 frag_color;
@@ -437,11 +580,15 @@ const float PI = 3.14159265359;
 
 void main() {
     vec3 dir = normalize(vDirection);
+#ifdef PBR_ENV_CUBE
+    vec3 color = texture(envMap, dir).rgb * exposure;
+#else
     float phi = atan(dir.z, dir.x);
     float theta = acos(dir.y);
     vec2 uv = vec2((phi + PI) / (2.0 * PI), theta / PI);
 
     vec3 color = texture(envMap, uv).rgb * exposure;
+#endif
     color = color / (vec3(1.0) + color);
     color = pow(color, vec3(1.0 / gamma));
 
@@ -463,9 +610,15 @@ in vec3 vViewNormal;
 in vec3 vLocalPos;  // Local position (for computing normals if needed)
 in vec2 vTexCoord;
 
+#ifdef PBR_INSTANCED
+flat in vec3 albedo;
+flat in float metallic;
+flat in float roughness;
+#else
 uniform vec3 albedo;
 uniform float metallic;
 uniform float roughness;
+#endif
 uniform float ao;
 uniform vec3 emission;
 uniform float envIntensity;
@@ -504,6 +657,7 @@ float geometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
     return geometrySchlickGGX(NdotV, roughness) * geometrySchlickGGX(NdotL, roughness);
 }
 
+)" + pbr_clustered_lights_glsl() + R"(
 void main() {
     // Use view-space normal (computed in vertex shader)
     vec3 N = normalize(vViewNormal);
@@ -557,6 +711,9 @@ void main() {
     ambient += vec3(0.15, 0.12, 0.1) * max(N.y, 0.0) * albedo * ao;
 
     vec3 color = ambient + Lo * envIntensity + emission;
+#ifdef PBR_CLUSTERED_LIGHTS
+    color += clusteredLights(vViewPos, N, V, albedo, metallic, roughness, F0);
+#endif
 
     // Tone mapping and gamma
     color *= exposure;
@@ -645,7 +802,8 @@ void main() {
 
 /**
  * Textured PBR fragment shader with texture map support
- * Supports: albedo, normal, roughness, metallic, AO, emissive maps
+ * Supports: albedo, normal, roughness, metallic, AO, emissive and height
+ * (parallax) maps, each compiled in by its HAS_*_MAP define
  */
 inline std::string pbr_textured_frag_shader() {
     return R"(#version 300 es
@@ -657,37 +815,64 @@ in vec3 vViewNormal;
 in vec3 vLocalPos;
 in vec2 vTexCoord;
 
-// Base material properties (used when texture not present)
+// Base material properties (used where a map is not compiled in)
 uniform vec3 albedo;
 uniform float metallic;
 uniform float roughness;
 uniform float ao;
 uniform vec3 emission;
 
-// Texture map flags
-uniform bool useAlbedoMap;
-uniform bool useNormalMap;
-uniform bool useRoughnessMap;
-uniform bool useMetallicMap;
-uniform bool useAOMap;
-uniform bool useEmissiveMap;
-
-// Texture maps
+// Texture maps, one HAS_*_MAP define per PBRMaterialEx feature
+#ifdef HAS_ALBEDO_MAP
 uniform sampler2D albedoMap;
+#endif
+#ifdef HAS_NORMAL_MAP
 uniform sampler2D normalMap;
+uniform float normalStrength;
+#endif
+#ifdef HAS_ROUGHNESS_MAP
 uniform sampler2D roughnessMap;
+#endif
+#ifdef HAS_METALLIC_MAP
 uniform sampler2D metallicMap;
+#endif
+#ifdef HAS_AO_MAP
 uniform sampler2D aoMap;
+#endif
+#ifdef HAS_EMISSIVE_MAP
 uniform sampler2D emissiveMap;
-
-// Texture settings
-uniform float normalStrength;
 uniform float emissiveIntensity;
+#endif
+#ifdef HAS_HEIGHT_MAP
+uniform sampler2D heightMap;
+uniform float heightScale;
+#endif
 
 // IBL textures
+#ifdef PBR_ENV_CUBE
+uniform samplerCube envMap;
+#else
 uniform sampler2D envMap;
-uniform sampler2D irradianceMap;
+#endif
 uniform sampler2D brdfLUT;
+uniform float envMaxLod;
+#ifdef PBR_SH_DIFFUSE
+// L2 spherical-harmonics irradiance (SHIrradiance) instead of a map fetch
+layout(std140) uniform PBRDiffuseSH {
+    vec4 shCoeffs[9];
+};
+
+vec3 irradianceSH(vec3 n) {
+    vec3 e = shCoeffs[0].rgb
+           + shCoeffs[1].rgb * n.y + shCoeffs[2].rgb * n.z + shCoeffs[3].rgb * n.x
+           + shCoeffs[4].rgb * (n.x * n.y) + shCoeffs[5].rgb * (n.y * n.z)
+           + shCoeffs[6].rgb * (3.0 * n.z * n.z - 1.0)
+           + shCoeffs[7].rgb * (n.x * n.z) + shCoeffs[8].rgb * (n.x * n.x - n.y * n.y);
+    return max(e, vec3(0.0));  // L2 rings slightly negative opposite bright sources
+}
+#else
+uniform sampler2D irradianceMap;
+#endif
 
 // Camera and lighting
 uniform mat3 invViewRot;
@@ -730,39 +915,61 @@ vec3 fresnelSchlickRoughness(float cosTheta, vec3 F0, float rough) {
 }
 
 vec3 sampleEnvLOD(vec3 worldDir, float rough) {
-    vec2 uv = directionToUV(worldDir);
-    vec3 color = texture(envMap, uv).rgb;
-    if (rough > 0.1) {
-        float blur = rough * 0.03;
-        color += texture(envMap, uv + vec2(blur, 0.0)).rgb;
-        color += texture(envMap, uv + vec2(-blur, 0.0)).rgb;
-        color += texture(envMap, uv + vec2(0.0, blur)).rgb;
-        color += texture(envMap, uv + vec2(0.0, -blur)).rgb;
-        color /= 5.0;
-    }
-    return color;
+#ifdef PBR_ENV_CUBE
+    return textureLod(envMap, worldDir, rough * envMaxLod).rgb;
+#else
+    return textureLod(envMap, directionToUV(worldDir), rough * envMaxLod).rgb;
+#endif
 }
 
+)" + pbr_clustered_lights_glsl() + R"(
 void main() {
-    // Sample textures or use uniform values
-    vec3 finalAlbedo = useAlbedoMap ? texture(albedoMap, vTexCoord).rgb : albedo;
-    float finalRoughness = useRoughnessMap ? texture(roughnessMap, vTexCoord).r : roughness;
-    float finalMetallic = useMetallicMap ? texture(metallicMap, vTexCoord).r : metallic;
-    float finalAO = useAOMap ? texture(aoMap, vTexCoord).r : ao;
-    vec3 finalEmission = useEmissiveMap
-        ? texture(emissiveMap, vTexCoord).rgb * emissiveIntensity
-        : emission;
+    vec2 uv = vTexCoord;
+#ifdef HAS_HEIGHT_MAP
+    // Offset-limited parallax: shift toward the viewer by the height
+    mat3 parallaxTBN = computeTBN(normalize(vViewNormal), vViewPos, vTexCoord);
+    vec3 tangentV = normalize(-vViewPos) * parallaxTBN;  // transpose(TBN) * V
+    uv += tangentV.xy * ((texture(heightMap, uv).r - 0.5) * heightScale);
+#endif
+
+#ifdef HAS_ALBEDO_MAP
+    vec3 finalAlbedo = texture(albedoMap, uv).rgb;
+#else
+    vec3 finalAlbedo = albedo;
+#endif
+#ifdef HAS_ROUGHNESS_MAP
+    float finalRoughness = texture(roughnessMap, uv).r;
+#else
+    float finalRoughness = roughness;
+#endif
+#ifdef HAS_METALLIC_MAP
+    float finalMetallic = texture(metallicMap, uv).r;
+#else
+    float finalMetallic = metallic;
+#endif
+#ifdef HAS_AO_MAP
+    float finalAO = texture(aoMap, uv).r;
+#else
+    float finalAO = ao;
+#endif
+#ifdef HAS_EMISSIVE_MAP
+    vec3 finalEmission = texture(emissiveMap, uv).rgb * emissiveIntensity;
+#else
+    vec3 finalEmission = emission;
+#endif
 
     // Normal mapping using screen-space derivatives for correct TBN
+#ifdef HAS_NORMAL_MAP
     vec3 N;
-    if (useNormalMap) {
-        vec3 normalSample = texture(normalMap, vTexCoord).rgb * 2.0 - 1.0;
+    {
+        vec3 normalSample = texture(normalMap, uv).rgb * 2.0 - 1.0;
         normalSample.xy *= normalStrength;
         mat3 TBN = computeTBN(normalize(vViewNormal), vViewPos, vTexCoord);
         N = normalize(TBN * normalSample);
-    } else {
-        N = normalize(vViewNormal);
     }
+#else
+    vec3 N = normalize(vViewNormal);
+#endif
 
     vec3 V = normalize(-vViewPos);
     vec3 R = reflect(-V, N);
@@ -776,20 +983,12 @@ void main() {
     F0 = mix(F0, finalAlbedo, finalMetallic);
 
     // IBL Diffuse
+#ifdef PBR_SH_DIFFUSE
+    vec3 irradiance = irradianceSH(worldN);
+#else
     vec2 irradianceUV = directionToUV(worldN);
     vec3 irradiance = texture(irradianceMap, irradianceUV).rgb;
-
-    if (length(irradiance) < 0.001) {
-        vec3 up = abs(worldN.y) < 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
-        vec3 tangent = normalize(cross(up, worldN));
-        vec3 bitangent = cross(worldN, tangent);
-        irradiance = texture(envMap, directionToUV(worldN)).rgb * 0.3;
-        irradiance += texture(envMap, directionToUV(normalize(worldN + tangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN - tangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN + bitangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN - bitangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN + vec3(0.0, 0.5, 0.0)))).rgb * 0.1;
-    }
+#endif
 
     float NdotV = max(dot(N, V), 0.0);
     vec3 kS = fresnelSchlickRoughness(NdotV, F0, finalRoughness);
@@ -803,17 +1002,14 @@ void main() {
     vec2 brdfUV = vec2(NdotV, finalRoughness);
     vec2 brdf = texture(brdfLUT, brdfUV).rg;
 
-    if (brdf.x < 0.001 && brdf.y < 0.001) {
-        float a = finalRoughness * finalRoughness;
-        brdf.x = 1.0 - a * 0.5;
-        brdf.y = a * 0.5;
-    }
-
     vec3 specular = prefilteredColor * (kS * brdf.x + brdf.y);
 
     // Combine
     vec3 ambient = (kD * diffuse + specular) * finalAO * envIntensity;
     vec3 color = ambient + finalEmission;
+#ifdef PBR_CLUSTERED_LIGHTS
+    color += clusteredLights(vViewPos, N, V, finalAlbedo, finalMetallic, finalRoughness, F0);
+#endif
 
     // Tone mapping
     color *= exposure;
@@ -837,28 +1033,39 @@ in vec3 vViewNormal;
 in vec3 vLocalPos;
 in vec2 vTexCoord;
 
+// Base material properties (used where a map is not compiled in)
 uniform vec3 albedo;
 uniform float metallic;
 uniform float roughness;
 uniform float ao;
 uniform vec3 emission;
 
-uniform bool useAlbedoMap;
-uniform bool useNormalMap;
-uniform bool useRoughnessMap;
-uniform bool useMetallicMap;
-uniform bool useAOMap;
-uniform bool useEmissiveMap;
-
+// Texture maps, one HAS_*_MAP define per PBRMaterialEx feature
+#ifdef HAS_ALBEDO_MAP
 uniform sampler2D albedoMap;
+#endif
+#ifdef HAS_NORMAL_MAP
 uniform sampler2D normalMap;
+uniform float normalStrength;
+#endif
+#ifdef HAS_ROUGHNESS_MAP
 uniform sampler2D roughnessMap;
+#endif
+#ifdef HAS_METALLIC_MAP
 uniform sampler2D metallicMap;
+#endif
+#ifdef HAS_AO_MAP
 uniform sampler2D aoMap;
+#endif
+#ifdef HAS_EMISSIVE_MAP
 uniform sampler2D emissiveMap;
-
-uniform float normalStrength;
 uniform float emissiveIntensity;
+#endif
+#ifdef HAS_HEIGHT_MAP
+uniform sampler2D heightMap;
+uniform float heightScale;
+#endif
+
 uniform float envIntensity;
 uniform float exposure;
 uniform float gamma;
@@ -867,7 +1074,7 @@ out vec4 frag_color;
 
 const float PI = 3.14159265359;
 
-// Compute TBN matrix from screen-space derivatives
+// Compute TBN matrix from screen-space derivatives (works for any surface orientation)
 mat3 computeTBN(vec3 N, vec3 pos, vec2 uv) {
     vec3 dp1 = dFdx(pos);
     vec3 dp2 = dFdy(pos);
@@ -908,24 +1115,54 @@ float geometrySmith(vec3 N, vec3 V, vec3 L, float rough) {
     return geometrySchlickGGX(NdotV, rough) * geometrySchlickGGX(NdotL, rough);
 }
 
+)" + pbr_clustered_lights_glsl() + R"(
 void main() {
-    vec3 finalAlbedo = useAlbedoMap ? texture(albedoMap, vTexCoord).rgb : albedo;
-    float finalRoughness = useRoughnessMap ? texture(roughnessMap, vTexCoord).r : roughness;
-    float finalMetallic = useMetallicMap ? texture(metallicMap, vTexCoord).r : metallic;
-    float finalAO = useAOMap ? texture(aoMap, vTexCoord).r : ao;
-    vec3 finalEmission = useEmissiveMap
-        ? texture(emissiveMap, vTexCoord).rgb * emissiveIntensity
-        : emission;
+    vec2 uv = vTexCoord;
+#ifdef HAS_HEIGHT_MAP
+    // Offset-limited parallax: shift toward the viewer by the height
+    mat3 parallaxTBN = computeTBN(normalize(vViewNormal), vViewPos, vTexCoord);
+    vec3 tangentV = normalize(-vViewPos) * parallaxTBN;  // transpose(TBN) * V
+    uv += tangentV.xy * ((texture(heightMap, uv).r - 0.5) * heightScale);
+#endif
 
+#ifdef HAS_ALBEDO_MAP
+    vec3 finalAlbedo = texture(albedoMap, uv).rgb;
+#else
+    vec3 finalAlbedo = albedo;
+#endif
+#ifdef HAS_ROUGHNESS_MAP
+    float finalRoughness = texture(roughnessMap, uv).r;
+#else
+    float finalRoughness = roughness;
+#endif
+#ifdef HAS_METALLIC_MAP
+    float finalMetallic = texture(metallicMap, uv).r;
+#else
+    float finalMetallic = metallic;
+#endif
+#ifdef HAS_AO_MAP
+    float finalAO = texture(aoMap, uv).r;
+#else
+    float finalAO = ao;
+#endif
+#ifdef HAS_EMISSIVE_MAP
+    vec3 finalEmission = texture(emissiveMap, uv).rgb * emissiveIntensity;
+#else
+    vec3 finalEmission = emission;
+#endif
+
+    // Normal mapping using screen-space derivatives for correct TBN
+#ifdef HAS_NORMAL_MAP
     vec3 N;
-    if (useNormalMap) {
-        vec3 normalSample = texture(normalMap, vTexCoord).rgb * 2.0 - 1.0;
+    {
+        vec3 normalSample = texture(normalMap, uv).rgb * 2.0 - 1.0;
         normalSample.xy *= normalStrength;
         mat3 TBN = computeTBN(normalize(vViewNormal), vViewPos, vTexCoord);
         N = normalize(TBN * normalSample);
-    } else {
-        N = normalize(vViewNormal);
     }
+#else
+    vec3 N = normalize(vViewNormal);
+#endif
 
     vec3 V = normalize(-vViewPos);
     vec3 F0 = vec3(0.04);
@@ -968,6 +1205,9 @@ void main() {
     ambient += vec3(0.15, 0.12, 0.1) * max(N.y, 0.0) * finalAlbedo * finalAO;
 
     vec3 color = ambient + Lo * envIntensity + finalEmission;
+#ifdef PBR_CLUSTERED_LIGHTS
+    color += clusteredLights(vViewPos, N, V, finalAlbedo, finalMetallic, finalRoughness, F0);
+#endif
 
     color *= exposure;
     color = color / (vec3(1.0) + color);
@@ -992,41 +1232,68 @@ in vec3 vViewNormal;
 in vec3 vLocalPos;
 in vec2 vTexCoord;
 
-// Base material properties
+// Base material properties (used where a map is not compiled in)
 uniform vec3 albedo;
 uniform float metallic;
 uniform float roughness;
 uniform float ao;
 uniform vec3 emission;
 
-// Texture LOD control
-uniform float u_textureLOD;       // Continuous LOD value (0.0 = full res, 1.0 = half, etc.)
-uniform bool u_useExplicitLOD;    // Enable explicit LOD (vs hardware auto)
-
-// Texture map flags
-uniform bool useAlbedoMap;
-uniform bool useNormalMap;
-uniform bool useRoughnessMap;
-uniform bool useMetallicMap;
-uniform bool useAOMap;
-uniform bool useEmissiveMap;
-
-// Texture maps
+// Texture maps, one HAS_*_MAP define per PBRMaterialEx feature
+#ifdef HAS_ALBEDO_MAP
 uniform sampler2D albedoMap;
+#endif
+#ifdef HAS_NORMAL_MAP
 uniform sampler2D normalMap;
+uniform float normalStrength;
+#endif
+#ifdef HAS_ROUGHNESS_MAP
 uniform sampler2D roughnessMap;
+#endif
+#ifdef HAS_METALLIC_MAP
 uniform sampler2D metallicMap;
+#endif
+#ifdef HAS_AO_MAP
 uniform sampler2D aoMap;
+#endif
+#ifdef HAS_EMISSIVE_MAP
 uniform sampler2D emissiveMap;
-
-// Texture settings
-uniform float normalStrength;
 uniform float emissiveIntensity;
+#endif
+#ifdef HAS_HEIGHT_MAP
+uniform sampler2D heightMap;
+uniform float heightScale;
+#endif
+
+// Texture LOD control
+uniform float u_textureLOD;       // Continuous LOD value (0.0 = full res, 1.0 = half, etc.)
+uniform bool u_useExplicitLOD;    // Enable explicit LOD (vs hardware auto)
 
 // IBL textures
+#ifdef PBR_ENV_CUBE
+uniform samplerCube envMap;
+#else
 uniform sampler2D envMap;
-uniform sampler2D irradianceMap;
+#endif
 uniform sampler2D brdfLUT;
+uniform float envMaxLod;
+#ifdef PBR_SH_DIFFUSE
+// L2 spherical-harmonics irradiance (SHIrradiance) instead of a map fetch
+layout(std140) uniform PBRDiffuseSH {
+    vec4 shCoeffs[9];
+};
+
+vec3 irradianceSH(vec3 n) {
+    vec3 e = shCoeffs[0].rgb
+           + shCoeffs[1].rgb * n.y + shCoeffs[2].rgb * n.z + shCoeffs[3].rgb * n.x
+           + shCoeffs[4].rgb * (n.x * n.y) + shCoeffs[5].rgb * (n.y * n.z)
+           + shCoeffs[6].rgb * (3.0 * n.z * n.z - 1.0)
+           + shCoeffs[7].rgb * (n.x * n.z) + shCoeffs[8].rgb * (n.x * n.x - n.y * n.y);
+    return max(e, vec3(0.0));  // L2 rings slightly negative opposite bright sources
+}
+#else
+uniform sampler2D irradianceMap;
+#endif
 
 // Camera and lighting
 uniform mat3 invViewRot;
@@ -1038,7 +1305,7 @@ out vec4 frag_color;
 
 const float PI = 3.14159265359;
 
-// Compute TBN matrix from screen-space derivatives
+// Compute TBN matrix from screen-space derivatives (works for any surface orientation)
 mat3 computeTBN(vec3 N, vec3 pos, vec2 uv) {
     vec3 dp1 = dFdx(pos);
     vec3 dp2 = dFdy(pos);
@@ -1077,41 +1344,63 @@ vec3 fresnelSchlickRoughness(float cosTheta, vec3 F0, float rough) {
 }
 
 vec3 sampleEnvLOD(vec3 worldDir, float rough) {
-    vec2 uv = directionToUV(worldDir);
-    vec3 color = texture(envMap, uv).rgb;
-    if (rough > 0.1) {
-        float blur = rough * 0.03;
-        color += texture(envMap, uv + vec2(blur, 0.0)).rgb;
-        color += texture(envMap, uv + vec2(-blur, 0.0)).rgb;
-        color += texture(envMap, uv + vec2(0.0, blur)).rgb;
-        color += texture(envMap, uv + vec2(0.0, -blur)).rgb;
-        color /= 5.0;
-    }
-    return color;
+#ifdef PBR_ENV_CUBE
+    return textureLod(envMap, worldDir, rough * envMaxLod).rgb;
+#else
+    return textureLod(envMap, directionToUV(worldDir), rough * envMaxLod).rgb;
+#endif
 }
 
+)" + pbr_clustered_lights_glsl() + R"(
 void main() {
-    // Sample textures with LOD control
-    vec3 finalAlbedo = useAlbedoMap ? sampleWithLOD(albedoMap, vTexCoord).rgb : albedo;
-    float finalRoughness = useRoughnessMap ? sampleWithLOD(roughnessMap, vTexCoord).r : roughness;
-    float finalMetallic = useMetallicMap ? sampleWithLOD(metallicMap, vTexCoord).r : metallic;
-    float finalAO = useAOMap ? sampleWithLOD(aoMap, vTexCoord).r : ao;
-    vec3 finalEmission = useEmissiveMap
-        ? sampleWithLOD(emissiveMap, vTexCoord).rgb * emissiveIntensity
-        : emission;
-
-    // Normal mapping with LOD and proper TBN
+    vec2 uv = vTexCoord;
+#ifdef HAS_HEIGHT_MAP
+    // Offset-limited parallax: shift toward the viewer by the height
+    mat3 parallaxTBN = computeTBN(normalize(vViewNormal), vViewPos, vTexCoord);
+    vec3 tangentV = normalize(-vViewPos) * parallaxTBN;  // transpose(TBN) * V
+    uv += tangentV.xy * ((sampleWithLOD(heightMap, uv).r - 0.5) * heightScale);
+#endif
+
+#ifdef HAS_ALBEDO_MAP
+    vec3 finalAlbedo = sampleWithLOD(albedoMap, uv).rgb;
+#else
+    vec3 finalAlbedo = albedo;
+#endif
+#ifdef HAS_ROUGHNESS_MAP
+    float finalRoughness = sampleWithLOD(roughnessMap, uv).r;
+#else
+    float finalRoughness = roughness;
+#endif
+#ifdef HAS_METALLIC_MAP
+    float finalMetallic = sampleWithLOD(metallicMap, uv).r;
+#else
+    float finalMetallic = metallic;
+#endif
+#ifdef HAS_AO_MAP
+    float finalAO = sampleWithLOD(aoMap, uv).r;
+#else
+    float finalAO = ao;
+#endif
+#ifdef HAS_EMISSIVE_MAP
+    vec3 finalEmission = sampleWithLOD(emissiveMap, uv).rgb * emissiveIntensity;
+#else
+    vec3 finalEmission = emission;
+#endif
+
+    // Normal mapping using screen-space derivatives for correct TBN
+#ifdef HAS_NORMAL_MAP
     vec3 N;
-    if (useNormalMap) {
-        vec3 normalSample = sampleWithLOD(normalMap, vTexCoord).rgb * 2.0 - 1.0;
+    {
+        vec3 normalSample = sampleWithLOD(normalMap, uv).rgb * 2.0 - 1.0;
         // Reduce normal strength at higher LOD (farther = less detail)
         float lodNormalStrength = normalStrength / (1.0 + u_textureLOD * 0.5);
         normalSample.xy *= lodNormalStrength;
         mat3 TBN = computeTBN(normalize(vViewNormal), vViewPos, vTexCoord);
         N = normalize(TBN * normalSample);
-    } else {
-        N = normalize(vViewNormal);
     }
+#else
+    vec3 N = normalize(vViewNormal);
+#endif
 
     vec3 V = normalize(-vViewPos);
     vec3 R = reflect(-V, N);
@@ -1125,20 +1414,12 @@ void main() {
     F0 = mix(F0, finalAlbedo, finalMetallic);
 
     // IBL Diffuse
+#ifdef PBR_SH_DIFFUSE
+    vec3 irradiance = irradianceSH(worldN);
+#else
     vec2 irradianceUV = directionToUV(worldN);
     vec3 irradiance = texture(irradianceMap, irradianceUV).rgb;
-
-    if (length(irradiance) < 0.001) {
-        vec3 up = abs(worldN.y) < 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
-        vec3 tangent = normalize(cross(up, worldN));
-        vec3 bitangent = cross(worldN, tangent);
-        irradiance = texture(envMap, directionToUV(worldN)).rgb * 0.3;
-        irradiance += texture(envMap, directionToUV(normalize(worldN + tangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN - tangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN + bitangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN - bitangent * 0.5))).rgb * 0.15;
-        irradiance += texture(envMap, directionToUV(normalize(worldN + vec3(0.0, 0.5, 0.0)))).rgb * 0.1;
-    }
+#endif
 
     float NdotV = max(dot(N, V), 0.0);
     vec3 kS = fresnelSchlickRoughness(NdotV, F0, finalRoughness);
@@ -1152,17 +1433,14 @@ void main() {
     vec2 brdfUV = vec2(NdotV, finalRoughness);
     vec2 brdf = texture(brdfLUT, brdfUV).rg;
 
-    if (brdf.x < 0.001 && brdf.y < 0.001) {
-        float a = finalRoughness * finalRoughness;
-        brdf.x = 1.0 - a * 0.5;
-        brdf.y = a * 0.5;
-    }
-
     vec3 specular = prefilteredColor * (kS * brdf.x + brdf.y);
 
     // Combine
     vec3 ambient = (kD * diffuse + specular) * finalAO * envIntensity;
     vec3 color = ambient + finalEmission;
+#ifdef PBR_CLUSTERED_LIGHTS
+    color += clusteredLights(vViewPos, N, V, finalAlbedo, finalMetallic, finalRoughness, F0);
+#endif
 
     // Tone mapping
     color *= exposure;
@@ -1186,32 +1464,43 @@ in vec3 vViewNormal;
 in vec3 vLocalPos;
 in vec2 vTexCoord;
 
+// Base material properties (used where a map is not compiled in)
 uniform vec3 albedo;
 uniform float metallic;
 uniform float roughness;
 uniform float ao;
 uniform vec3 emission;
 
-// Texture LOD control
-uniform float u_textureLOD;
-uniform bool u_useExplicitLOD;
-
-uniform bool useAlbedoMap;
-uniform bool useNormalMap;
-uniform bool useRoughnessMap;
-uniform bool useMetallicMap;
-uniform bool useAOMap;
-uniform bool useEmissiveMap;
-
+// Texture maps, one HAS_*_MAP define per PBRMaterialEx feature
+#ifdef HAS_ALBEDO_MAP
 uniform sampler2D albedoMap;
+#endif
+#ifdef HAS_NORMAL_MAP
 uniform sampler2D normalMap;
+uniform float normalStrength;
+#endif
+#ifdef HAS_ROUGHNESS_MAP
 uniform sampler2D roughnessMap;
+#endif
+#ifdef HAS_METALLIC_MAP
 uniform sampler2D metallicMap;
+#endif
+#ifdef HAS_AO_MAP
 uniform sampler2D aoMap;
+#endif
+#ifdef HAS_EMISSIVE_MAP
 uniform sampler2D emissiveMap;
-
-uniform float normalStrength;
 uniform float emissiveIntensity;
+#endif
+#ifdef HAS_HEIGHT_MAP
+uniform sampler2D heightMap;
+uniform float heightScale;
+#endif
+
+// Texture LOD control
+uniform float u_textureLOD;       // Continuous LOD value (0.0 = full res, 1.0 = half, etc.)
+uniform bool u_useExplicitLOD;    // Enable explicit LOD (vs hardware auto)
+
 uniform float envIntensity;
 uniform float exposure;
 uniform float gamma;
@@ -1220,6 +1509,23 @@ out vec4 frag_color;
 
 const float PI = 3.14159265359;
 
+// Compute TBN matrix from screen-space derivatives (works for any surface orientation)
+mat3 computeTBN(vec3 N, vec3 pos, vec2 uv) {
+    vec3 dp1 = dFdx(pos);
+    vec3 dp2 = dFdy(pos);
+    vec2 duv1 = dFdx(uv);
+    vec2 duv2 = dFdy(uv);
+
+    vec3 dp2perp = cross(dp2, N);
+    vec3 dp1perp = cross(N, dp1);
+    vec3 T = dp2perp * duv1.x + dp1perp * duv2.x;
+    vec3 B = dp2perp * duv1.y + dp1perp * duv2.y;
+
+    float invmax = inversesqrt(max(dot(T, T), dot(B, B)));
+    return mat3(T * invmax, B * invmax, N);
+}
+
+// Sample texture with explicit LOD or hardware auto
 vec4 sampleWithLOD(sampler2D tex, vec2 uv) {
     if (u_useExplicitLOD) {
         return textureLod(tex, uv, u_textureLOD);
@@ -1252,41 +1558,56 @@ float geometrySmith(vec3 N, vec3 V, vec3 L, float rough) {
     return geometrySchlickGGX(NdotV, rough) * geometrySchlickGGX(NdotL, rough);
 }
 
-// Compute TBN matrix from screen-space derivatives (works for any surface orientation)
-mat3 computeTBN(vec3 N, vec3 pos, vec2 uv) {
-    vec3 dp1 = dFdx(pos);
-    vec3 dp2 = dFdy(pos);
-    vec2 duv1 = dFdx(uv);
-    vec2 duv2 = dFdy(uv);
-
-    vec3 dp2perp = cross(dp2, N);
-    vec3 dp1perp = cross(N, dp1);
-    vec3 T = dp2perp * duv1.x + dp1perp * duv2.x;
-    vec3 B = dp2perp * duv1.y + dp1perp * duv2.y;
-
-    float invmax = inversesqrt(max(dot(T, T), dot(B, B)));
-    return mat3(T * invmax, B * invmax, N);
-}
-
+)" + pbr_clustered_lights_glsl() + R"(
 void main() {
-    vec3 finalAlbedo = useAlbedoMap ? sampleWithLOD(albedoMap, vTexCoord).rgb : albedo;
-    float finalRoughness = useRoughnessMap ? sampleWithLOD(roughnessMap, vTexCoord).r : roughness;
-    float finalMetallic = useMetallicMap ? sampleWithLOD(metallicMap, vTexCoord).r : metallic;
-    float finalAO = useAOMap ? sampleWithLOD(aoMap, vTexCoord).r : ao;
-    vec3 finalEmission = useEmissiveMap
-        ? sampleWithLOD(emissiveMap, vTexCoord).rgb * emissiveIntensity
-        : emission;
+    vec2 uv = vTexCoord;
+#ifdef HAS_HEIGHT_MAP
+    // Offset-limited parallax: shift toward the viewer by the height
+    mat3 parallaxTBN = computeTBN(normalize(vViewNormal), vViewPos, vTexCoord);
+    vec3 tangentV = normalize(-vViewPos) * parallaxTBN;  // transpose(TBN) * V
+    uv += tangentV.xy * ((sampleWithLOD(heightMap, uv).r - 0.5) * heightScale);
+#endif
+
+#ifdef HAS_ALBEDO_MAP
+    vec3 finalAlbedo = sampleWithLOD(albedoMap, uv).rgb;
+#else
+    vec3 finalAlbedo = albedo;
+#endif
+#ifdef HAS_ROUGHNESS_MAP
+    float finalRoughness = sampleWithLOD(roughnessMap, uv).r;
+#else
+    float finalRoughness = roughness;
+#endif
+#ifdef HAS_METALLIC_MAP
+    float finalMetallic = sampleWithLOD(metallicMap, uv).r;
+#else
+    float finalMetallic = metallic;
+#endif
+#ifdef HAS_AO_MAP
+    float finalAO = sampleWithLOD(aoMap, uv).r;
+#else
+    float finalAO = ao;
+#endif
+#ifdef HAS_EMISSIVE_MAP
+    vec3 finalEmission = sampleWithLOD(emissiveMap, uv).rgb * emissiveIntensity;
+#else
+    vec3 finalEmission = emission;
+#endif
 
+    // Normal mapping using screen-space derivatives for correct TBN
+#ifdef HAS_NORMAL_MAP
     vec3 N;
-    if (useNormalMap) {
-        vec3 normalSample = sampleWithLOD(normalMap, vTexCoord).rgb * 2.0 - 1.0;
+    {
+        vec3 normalSample = sampleWithLOD(normalMap, uv).rgb * 2.0 - 1.0;
+        // Reduce normal strength at higher LOD (farther = less detail)
         float lodNormalStrength = normalStrength / (1.0 + u_textureLOD * 0.5);
         normalSample.xy *= lodNormalStrength;
         mat3 TBN = computeTBN(normalize(vViewNormal), vViewPos, vTexCoord);
         N = normalize(TBN * normalSample);
-    } else {
-        N = normalize(vViewNormal);
     }
+#else
+    vec3 N = normalize(vViewNormal);
+#endif
 
     vec3 V = normalize(-vViewPos);
     vec3 F0 = vec3(0.04);
@@ -1329,6 +1650,9 @@ void main() {
     ambient += vec3(0.15, 0.12, 0.1) * max(N.y, 0.0) * finalAlbedo * finalAO;
 
     vec3 color = ambient + Lo * envIntensity + finalEmission;
+#ifdef PBR_CLUSTERED_LIGHTS
+    color += clusteredLights(vViewPos, N, V, finalAlbedo, finalMetallic, finalRoughness, F0);
+#endif
 
     color *= exposure;
     color = color / (vec3(1.0) + color);
@@ -1349,7 +1673,11 @@ public:
     WebPBR() : mEnvTexture(0), mIrradianceTexture(0), mBrdfLUT(0),
                mReady(false), mEnvLoaded(false), mCreated(false),
                mLoggedRenderMode(false), mLastEnvState(false),
-               mExposure(1.0f), mGamma(2.2f), mEnvIntensity(1.0f) {}
+               mExposure(1.0f), mGamma(2.2f), mEnvIntensity(1.0f) {
+        // Decode straight to upload-ready texels; the irradiance map is
+        // convolved from the low-res preview
+        mHdr.setFormat(WebHDR::Format::RGB9E5);
+    }
 
     ~WebPBR() {
         destroy();
@@ -1371,11 +1699,17 @@ public:
                 mEnvLoaded = true;
                 mReady = true;
                 mNeedsUpload = true;
+                mSHDirty = true;
                 printf("[WebPBR] Environment loaded: %s (%dx%d)\n",
                        mUrl.c_str(), mHdr.width(), mHdr.height());
 
-                // Generate irradiance map
-                generateIrradianceMap();
+                // Convolve irradiance now unless the GPU will bake it
+                // (or it is still cached, or SH replaces it)
+                bool gpuBake = Graphics_isWebGPU() || IBLBaker::supported();
+                if (!gpuBake && mDiffuseMode == PBRDiffuse::IrradianceMap &&
+                    !GPUResourceCache::instance().contains(irradianceKey())) {
+                    generateIrradianceMap();
+                }
 
                 if (mCallback) mCallback(true);
             } else {
@@ -1411,6 +1745,13 @@ public:
         if (!mSkyboxShader.compile(pbr_skybox_vert(), pbr_skybox_frag())) {
             printf("[WebPBR] ERROR: Skybox shader compilation failed!\n");
         }
+        if (!Graphics_isWebGPU() && IBLBaker::supported()) {
+            mSkyboxCubeCompiled = mSkyboxCubeShader.compile(
+                pbr_skybox_vert(), pbr_shader_variant(pbr_skybox_frag(), "PBR_ENV_CUBE"));
+            if (!mSkyboxCubeCompiled) {
+                printf("[WebPBR] ERROR: Cubemap skybox shader compilation failed!\n");
+            }
+        }
         printf("[WebPBR] Compiling fallback PBR shader...\n");
         if (!mFallbackPbrShader.compile(pbr_vert_shader(), pbr_fallback_frag_shader())) {
             printf("[WebPBR] ERROR: Fallback PBR shader compilation failed!\n");
@@ -1419,33 +1760,18 @@ public:
         if (!mFallbackSkyboxShader.compile(pbr_skybox_vert(), pbr_fallback_skybox_frag())) {
             printf("[WebPBR] ERROR: Fallback skybox shader compilation failed!\n");
         }
-        printf("[WebPBR] Compiling textured PBR shader...\n");
-        if (!mTexturedPbrShader.compile(pbr_textured_vert_shader(), pbr_textured_frag_shader())) {
-            printf("[WebPBR] ERROR: Textured PBR shader compilation failed!\n");
-        }
-        printf("[WebPBR] Compiling textured fallback PBR shader...\n");
-        if (!mTexturedFallbackPbrShader.compile(pbr_textured_vert_shader(), pbr_textured_fallback_frag_shader())) {
-            printf("[WebPBR] ERROR: Textured fallback PBR shader compilation failed!\n");
-        }
-        printf("[WebPBR] Compiling LOD-aware PBR shader...\n");
-        if (!mLodPbrShader.compile(pbr_textured_vert_shader(), pbr_lod_frag_shader())) {
-            printf("[WebPBR] ERROR: LOD PBR shader compilation failed!\n");
-        }
-        printf("[WebPBR] Compiling LOD-aware fallback PBR shader...\n");
-        if (!mLodFallbackPbrShader.compile(pbr_textured_vert_shader(), pbr_lod_fallback_frag_shader())) {
-            printf("[WebPBR] ERROR: LOD fallback PBR shader compilation failed!\n");
-        }
+        // Textured and LOD shaders are permutations compiled on first use
         printf("[WebPBR] All shaders compiled\n");
 
-        // Create textures
-        glGenTextures(1, &mEnvTexture);
-        setupTexture(mEnvTexture);
-
-        glGenTextures(1, &mIrradianceTexture);
-        setupTexture(mIrradianceTexture);
-
-        // Generate BRDF LUT
-        generateBrdfLUT();
+        // Environment textures come from GPUResourceCache once the HDR is
+        // in; the BRDF LUT is the same for every WebPBR (WebGPU bakes its
+        // own in createWebGPUTextures)
+        if (!Graphics_isWebGPU()) {
+            mBrdfRef = GPUResourceCache::instance().acquire(brdfKey(), [](GPUTexture& t) {
+                return IBLBaker::brdfLUT(t) || generateBrdfLUT(t);
+            });
+        }
+        mBrdfLUT = mBrdfRef ? mBrdfRef->id : 0;
 
         mCreated = true;
         printf("[WebPBR] GPU resources created\n");
@@ -1455,10 +1781,24 @@ public:
      * Destroy GPU resources
      */
     void destroy() {
-        if (mEnvTexture) glDeleteTextures(1, &mEnvTexture);
-        if (mIrradianceTexture) glDeleteTextures(1, &mIrradianceTexture);
-        if (mBrdfLUT) glDeleteTextures(1, &mBrdfLUT);
-        mEnvTexture = mIrradianceTexture = mBrdfLUT = 0;
+        // Deleted by the cache once nothing else shares them
+        mEnvRef.reset();
+        mEnvCubeRef.reset();
+        mSpecularRef.reset();
+        mIrradianceRef.reset();
+        mBrdfRef.reset();
+        mEnvTexture = mSpecularTexture = mIrradianceTexture = mBrdfLUT = 0;
+        if (mSHUbo) glDeleteBuffers(1, &mSHUbo);
+        mSHUbo = 0;
+        mSHDirty = true;
+        mSHShadersCompiled = false;
+        mVariants.clear();
+        mBoundVariant = kNoVariant;
+#ifdef ALLOLIB_WEBGPU
+        mWebGPUEnvTexture = mWebGPUSpecularTexture = mWebGPUIrradianceTexture = TextureHandle{};
+        mWebGPUBrdfLUT = TextureHandle{};
+        mWebGPUTexturesCreated = false;
+#endif
         mCreated = false;
     }
 
@@ -1492,7 +1832,14 @@ public:
         glDepthMask(GL_FALSE);
         glDepthFunc(GL_LEQUAL);
 
-        if (mEnvLoaded) {
+        if (mEnvLoaded && mEnvCubeRef) {
+            g.shader(mSkyboxCubeShader);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_CUBE_MAP, mEnvCubeRef->id);
+            mSkyboxCubeShader.uniform("envMap", 0);
+            mSkyboxCubeShader.uniform("exposure", mExposure);
+            mSkyboxCubeShader.uniform("gamma", mGamma);
+        } else if (mEnvLoaded) {
             g.shader(mSkyboxShader);
             glActiveTexture(GL_TEXTURE0);
             glBindTexture(GL_TEXTURE_2D, mEnvTexture);
@@ -1510,6 +1857,7 @@ public:
         glDepthMask(depthMask);
         glDepthFunc(depthFunc);
         glBindTexture(GL_TEXTURE_2D, 0);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
     }
 
     /**
@@ -1532,6 +1880,7 @@ public:
         }
 
         uploadIfNeeded();
+        compileWarmUp(kWarmUpPerFrame);
 
         // Log render mode on first use or when it changes
         if (!mLoggedRenderMode || mLastEnvState != mEnvLoaded) {
@@ -1544,30 +1893,31 @@ public:
             mLastEnvState = mEnvLoaded;
         }
 
-        if (mEnvLoaded) {
+        // materialEx() after begin() switches to the textured permutations
+        mGraphics = &g;
+        mPassVariant = lightingVariant();
+        mBoundVariant = kNoVariant;
+
+        if (mEnvLoaded) prepareDiffuse();
+        if (mClustered || (mPassVariant & kVariantEnvCube)) {
+            // Clustered lights and the cubemap specular chain live in the
+            // PBR_CLUSTERED_LIGHTS / PBR_ENV_CUBE permutations
+            bindVariant(mPassVariant | kVariantUntextured);
+        } else if (mEnvLoaded) {
             // Use IBL shader with HDR environment
-            mActiveShader = &mPbrShader;
-            g.shader(mPbrShader);
+            ShaderProgram& shader = useSH() ? mSHPbrShader : mPbrShader;
+            mActiveShader = &shader;
+            g.shader(shader);
 
-            // Bind textures
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, mEnvTexture);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, mIrradianceTexture);
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, mBrdfLUT);
-
-            mPbrShader.uniform("envMap", 0);
-            mPbrShader.uniform("irradianceMap", 1);
-            mPbrShader.uniform("brdfLUT", 2);
-            mPbrShader.uniform("envIntensity", mEnvIntensity);
-            mPbrShader.uniform("exposure", mExposure);
-            mPbrShader.uniform("gamma", mGamma);
+            bindIBL(shader);
+            shader.uniform("envIntensity", mEnvIntensity);
+            shader.uniform("exposure", mExposure);
+            shader.uniform("gamma", mGamma);
 
             // Pass inverse view rotation for environment sampling
             // For now, use identity (camera looking down -Z)
             float invViewRot[9] = {1,0,0, 0,1,0, 0,0,1};
-            mPbrShader.uniformMatrix3("invViewRot", invViewRot);
+            shader.uniformMatrix3("invViewRot", invViewRot);
         } else {
             // Use fallback analytical lighting
             mActiveShader = &mFallbackPbrShader;
@@ -1605,11 +1955,12 @@ public:
 
     /**
      * Set extended material with texture map support
-     * Call this after begin() and after binding your textures
+     * Call this after begin() and after binding your textures. Binds the
+     * shader permutation for the material's features (compiled on first
+     * use), so only the enabled maps are sampled.
      */
     void materialEx(const PBRMaterialEx& mat) {
-        // Use textured shader instead of regular PBR shader
-        ShaderProgram& shader = mEnvLoaded ? mTexturedPbrShader : mTexturedFallbackPbrShader;
+        ShaderProgram& shader = bindVariant(mPassVariant | mat.features());
 
         // Set base material properties
         shader.uniform("albedo", mat.albedo);
@@ -1621,24 +1972,102 @@ public:
         // Set texture transform
         shader.uniform("textureScale", mat.textureScale);
         shader.uniform("textureOffset", mat.textureOffset);
-        shader.uniform("normalStrength", mat.normalStrength);
-        shader.uniform("emissiveIntensity", mat.emissiveIntensity);
-
-        // Set texture map flags
-        shader.uniform("useAlbedoMap", mat.useAlbedoMap);
-        shader.uniform("useNormalMap", mat.useNormalMap);
-        shader.uniform("useRoughnessMap", mat.useRoughnessMap);
-        shader.uniform("useMetallicMap", mat.useMetallicMap);
-        shader.uniform("useAOMap", mat.useAOMap);
-        shader.uniform("useEmissiveMap", mat.useEmissiveMap);
-
-        // Set texture samplers
+
+        // Set texture samplers and per-map settings
         if (mat.useAlbedoMap) shader.uniform("albedoMap", mat.albedoMapUnit);
-        if (mat.useNormalMap) shader.uniform("normalMap", mat.normalMapUnit);
+        if (mat.useNormalMap) {
+            shader.uniform("normalMap", mat.normalMapUnit);
+            shader.uniform("normalStrength", mat.normalStrength);
+        }
         if (mat.useRoughnessMap) shader.uniform("roughnessMap", mat.roughnessMapUnit);
         if (mat.useMetallicMap) shader.uniform("metallicMap", mat.metallicMapUnit);
         if (mat.useAOMap) shader.uniform("aoMap", mat.aoMapUnit);
-        if (mat.useEmissiveMap) shader.uniform("emissiveMap", mat.emissiveMapUnit);
+        if (mat.useEmissiveMap) {
+            shader.uniform("emissiveMap", mat.emissiveMapUnit);
+            shader.uniform("emissiveIntensity", mat.emissiveIntensity);
+        }
+        if (mat.useHeightMap) {
+            shader.uniform("heightMap", mat.heightMapUnit);
+            shader.uniform("heightScale", mat.heightScale);
+        }
+    }
+
+    /**
+     * Bind the instanced permutation of this pass (WebGL2, between begin()
+     * and end()) and return it, or nullptr outside a pass. Per-instance
+     * model matrices, albedo and metallic/roughness come from vertex
+     * attributes 4-7, 8 and 9 (see pbr_vert_shader); the caller sets
+     * al_ModelViewMatrix / al_ProjectionMatrix and draws. endInstanced()
+     * rebinds the shader that was current, so material() works again.
+     */
+    ShaderProgram* beginInstanced() {
+        if (Graphics_isWebGPU() || !mGraphics) return nullptr;
+        mPreInstancedShader = mActiveShader;
+        mPreInstancedVariant = mBoundVariant;
+        ShaderProgram& shader = bindVariant(mPassVariant | kVariantUntextured | kVariantInstanced);
+        shader.uniform("ao", 1.0f);
+        shader.uniform("emission", Vec3f(0, 0, 0));
+        return &shader;
+    }
+
+    void endInstanced() {
+        if (!mPreInstancedShader || !mGraphics) return;
+        mActiveShader = mPreInstancedShader;
+        mBoundVariant = mPreInstancedVariant;
+        mGraphics->shader(*mActiveShader);
+        mPreInstancedShader = nullptr;
+    }
+
+    /**
+     * Declare a material the scene draws so its shader permutation is
+     * compiled before the first frame that binds it. Every begin*()
+     * compiles up to kWarmUpPerFrame pending permutations ahead of its
+     * draws; compileWarmUp() finishes the rest at once (e.g. behind a
+     * loading screen). Declarations persist, so permutations are warmed
+     * again when the lighting setup changes (environment loaded, SH
+     * diffuse, clustered lights).
+     *
+     * @param lod Material is drawn inside beginWithLOD()
+     */
+    void warmUp(const PBRMaterialEx& mat, bool lod = false) { warmUp(mat.features(), lod); }
+
+    void warmUp(const std::vector<PBRMaterialEx>& materials, bool lod = false) {
+        for (const auto& mat : materials) warmUp(mat.features(), lod);
+    }
+
+    /// Declare a PBRMaterialEx::features() mask directly
+    void warmUp(uint32_t features, bool lod = false) {
+        uint32_t entry = (features & PBRMaterialEx::AllFeatures) | (lod ? kVariantLOD : 0);
+        if (std::find(mWarmUp.begin(), mWarmUp.end(), entry) == mWarmUp.end()) {
+            mWarmUp.push_back(entry);
+        }
+    }
+
+    /**
+     * Compile up to `budget` declared permutations for the current
+     * lighting setup. Returns how many are still pending. WebGPU draws
+     * PBR with pipelines built at backend init, so nothing is pending there.
+     */
+    size_t compileWarmUp(size_t budget = SIZE_MAX) {
+        if (Graphics_isWebGPU() || !mCreated || mWarmUp.empty()) return 0;
+
+        uint32_t lighting = lightingVariant();
+        size_t pending = 0;
+        auto warm = [&](uint32_t key) {
+            if (mVariants.count(key)) return;
+            if (budget == 0) {
+                pending++;
+                return;
+            }
+            variant(key);
+            budget--;
+        };
+        // begin() itself draws through the untextured permutation here
+        if (lighting & (kVariantClustered | kVariantEnvCube)) {
+            warm(lighting | kVariantUntextured);
+        }
+        for (uint32_t entry : mWarmUp) warm(entry | lighting);
+        return pending;
     }
 
     /**
@@ -1651,34 +2080,12 @@ public:
         }
 
         uploadIfNeeded();
+        if (mEnvLoaded) prepareDiffuse();
+        compileWarmUp(kWarmUpPerFrame);
 
-        if (mEnvLoaded) {
-            mActiveShader = &mTexturedPbrShader;
-            g.shader(mTexturedPbrShader);
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, mEnvTexture);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, mIrradianceTexture);
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, mBrdfLUT);
-
-            mTexturedPbrShader.uniform("envMap", 0);
-            mTexturedPbrShader.uniform("irradianceMap", 1);
-            mTexturedPbrShader.uniform("brdfLUT", 2);
-            mTexturedPbrShader.uniform("envIntensity", mEnvIntensity);
-            mTexturedPbrShader.uniform("exposure", mExposure);
-            mTexturedPbrShader.uniform("gamma", mGamma);
-
-            float invViewRot[9] = {1,0,0, 0,1,0, 0,0,1};
-            mTexturedPbrShader.uniformMatrix3("invViewRot", invViewRot);
-        } else {
-            mActiveShader = &mTexturedFallbackPbrShader;
-            g.shader(mTexturedFallbackPbrShader);
-            mTexturedFallbackPbrShader.uniform("envIntensity", mEnvIntensity);
-            mTexturedFallbackPbrShader.uniform("exposure", mExposure);
-            mTexturedFallbackPbrShader.uniform("gamma", mGamma);
-        }
+        mGraphics = &g;
+        mPassVariant = lightingVariant();
+        mBoundVariant = kNoVariant;
 
         // Set default material with no texture maps
         PBRMaterialEx defaultMat;
@@ -1699,44 +2106,15 @@ public:
         }
 
         uploadIfNeeded();
+        if (mEnvLoaded) prepareDiffuse();
+        compileWarmUp(kWarmUpPerFrame);
 
         mCurrentTextureLOD = textureLOD;
+        mExplicitLOD = true;
 
-        if (mEnvLoaded) {
-            mActiveShader = &mLodPbrShader;
-            g.shader(mLodPbrShader);
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, mEnvTexture);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, mIrradianceTexture);
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, mBrdfLUT);
-
-            mLodPbrShader.uniform("envMap", 0);
-            mLodPbrShader.uniform("irradianceMap", 1);
-            mLodPbrShader.uniform("brdfLUT", 2);
-            mLodPbrShader.uniform("envIntensity", mEnvIntensity);
-            mLodPbrShader.uniform("exposure", mExposure);
-            mLodPbrShader.uniform("gamma", mGamma);
-
-            float invViewRot[9] = {1,0,0, 0,1,0, 0,0,1};
-            mLodPbrShader.uniformMatrix3("invViewRot", invViewRot);
-
-            // Set LOD uniforms
-            mLodPbrShader.uniform("u_textureLOD", textureLOD);
-            mLodPbrShader.uniform("u_useExplicitLOD", true);
-        } else {
-            mActiveShader = &mLodFallbackPbrShader;
-            g.shader(mLodFallbackPbrShader);
-            mLodFallbackPbrShader.uniform("envIntensity", mEnvIntensity);
-            mLodFallbackPbrShader.uniform("exposure", mExposure);
-            mLodFallbackPbrShader.uniform("gamma", mGamma);
-
-            // Set LOD uniforms
-            mLodFallbackPbrShader.uniform("u_textureLOD", textureLOD);
-            mLodFallbackPbrShader.uniform("u_useExplicitLOD", true);
-        }
+        mGraphics = &g;
+        mPassVariant = lightingVariant() | kVariantLOD;
+        mBoundVariant = kNoVariant;
 
         // Set default material with no texture maps
         PBRMaterialEx defaultMat;
@@ -1765,6 +2143,7 @@ public:
      * Enable or disable explicit LOD control mid-render
      */
     void setExplicitLOD(bool enable) {
+        mExplicitLOD = enable;
         if (mActiveShader) {
             mActiveShader->uniform("u_useExplicitLOD", enable);
         }
@@ -1799,6 +2178,8 @@ public:
         // This exits CUSTOM mode so g.lighting() and g.color() work again
         g.color(1, 1, 1);  // This sets ColoringMode::UNIFORM and mRenderModeChanged
         mActiveShader = nullptr;
+        mGraphics = nullptr;
+        mBoundVariant = kNoVariant;
     }
 
     /**
@@ -1823,6 +2204,8 @@ public:
         glBindTexture(GL_TEXTURE_2D, 0);
         glUseProgram(0);
         mActiveShader = nullptr;
+        mGraphics = nullptr;
+        mBoundVariant = kNoVariant;
     }
 
     // Accessors
@@ -1838,6 +2221,21 @@ public:
     float envIntensity() const { return mEnvIntensity; }
     void envIntensity(float i) { mEnvIntensity = i; }
 
+    /// Diffuse IBL source; SphericalHarmonics evaluates 9 coefficients
+    /// per fragment instead of fetching the irradiance map
+    PBRDiffuse diffuseMode() const { return mDiffuseMode; }
+    void diffuseMode(PBRDiffuse mode) { mDiffuseMode = mode; }
+
+    /// L2 SH projection of the environment (valid once one is loaded and
+    /// SphericalHarmonics has been drawn with)
+    const SHIrradiance& irradianceSH() const { return mSH; }
+
+    /// Point lights added on top of IBL / fallback lighting, culled per
+    /// froxel. Call lights->update(g) each frame before begin(); nullptr
+    /// disables. Not owned.
+    ClusteredLights* clusteredLights() const { return mClustered; }
+    void clusteredLights(ClusteredLights* lights) { mClustered = lights; }
+
     ShaderProgram& shader() { return mPbrShader; }
 
 private:
@@ -1850,6 +2248,32 @@ private:
         glBindTexture(GL_TEXTURE_2D, 0);
     }
 
+    /// Bind the IBL maps on units 0-2; envMap is the prefiltered chain when
+    /// there is one (a cubemap for PBR_ENV_CUBE), else the environment
+    /// itself (every roughness sharp). SH variants get the coefficient
+    /// block instead of irradianceMap.
+    void bindIBL(ShaderProgram& shader) {
+        glActiveTexture(GL_TEXTURE0);
+        if (specularIsCube()) {
+            glBindTexture(GL_TEXTURE_CUBE_MAP, mSpecularTexture);
+        } else {
+            glBindTexture(GL_TEXTURE_2D, mSpecularTexture ? mSpecularTexture : mEnvTexture);
+        }
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, mBrdfLUT);
+
+        shader.uniform("envMap", 0);
+        shader.uniform("brdfLUT", 2);
+        if (useSH()) {
+            glBindBufferBase(GL_UNIFORM_BUFFER, kSHBlockBinding, mSHUbo);
+        } else {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, mIrradianceTexture);
+            shader.uniform("irradianceMap", 1);
+        }
+        shader.uniform("envMaxLod", mSpecularTexture ? (float)(mSpecularRef->levels - 1) : 0.0f);
+    }
+
     void createSkyboxMesh() {
         mSkyboxMesh.reset();
         mSkyboxMesh.primitive(Mesh::TRIANGLES);
@@ -1877,24 +2301,187 @@ private:
     void uploadIfNeeded() {
         if (!mNeedsUpload || !mReady) return;
 
-        // Upload environment map
-        glBindTexture(GL_TEXTURE_2D, mEnvTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F,
-                     mHdr.width(), mHdr.height(), 0,
-                     GL_RGB, GL_FLOAT, mHdr.pixels());
+        // Upload environment map (shared with WebEnvironment and other
+        // WebPBRs of the same URL), then drop the CPU copy
+        auto& cache = GPUResourceCache::instance();
+        mEnvRef = cache.acquire(envKey(), [&](GPUTexture& t) {
+            glGenTextures(1, &t.id);
+            setupTexture(t.id);
+            glBindTexture(GL_TEXTURE_2D, t.id);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB9_E5,
+                         mHdr.width(), mHdr.height(), 0,
+                         GL_RGB, GL_UNSIGNED_INT_5_9_9_9_REV, mHdr.texels());
+            t.width = mHdr.width();
+            t.height = mHdr.height();
+            t.bytes = (size_t)t.width * t.height * 4;
+            return true;
+        });
+
+        // Bake the specular chain (as a cubemap), irradiance and the skybox
+        // cube on the GPU (once per URL); without float render targets
+        // irradiance is convolved on the CPU and the rest stays equirect
+        IBLBaker::Source source(mEnvRef ? mEnvRef->id : 0,
+                                mEnvRef ? mEnvRef->width : 0, mEnvRef ? mEnvRef->height : 0);
+        mSpecularRef = cache.acquire(specularKey(), [&](GPUTexture& t) {
+            return IBLBaker::prefilterCube(source, t) || IBLBaker::prefilter(source, t);
+        });
+        if (mEnvRef && mSkyboxCubeCompiled) {
+            mEnvCubeRef = cache.acquire(envCubeKey(), [&](GPUTexture& t) {
+                return IBLBaker::cubemap(mEnvRef->id, mEnvRef->width, mEnvRef->height, t);
+            });
+        }
+        if (mDiffuseMode == PBRDiffuse::IrradianceMap) acquireIrradiance(source);
 
-        // Upload irradiance map
-        glBindTexture(GL_TEXTURE_2D, mIrradianceTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F,
-                     mIrradianceWidth, mIrradianceHeight, 0,
-                     GL_RGB, GL_FLOAT, mIrradianceData.data());
+        mHdr.releasePixels();
 
         glBindTexture(GL_TEXTURE_2D, 0);
+        mEnvTexture = mEnvRef ? mEnvRef->id : 0;
+        mSpecularTexture = mSpecularRef ? mSpecularRef->id : 0;
         mNeedsUpload = false;
 
         printf("[WebPBR] Uploaded textures\n");
     }
 
+    /// Irradiance map for this environment (GPU-baked, or convolved on the
+    /// CPU from the preview without float render targets)
+    void acquireIrradiance(IBLBaker::Source& source) {
+        mIrradianceRef = GPUResourceCache::instance().acquire(irradianceKey(), [&](GPUTexture& t) {
+            if (IBLBaker::irradiance(source, t)) return true;
+            if (mIrradianceData.empty()) generateIrradianceMap();
+            glGenTextures(1, &t.id);
+            setupTexture(t.id);
+            glBindTexture(GL_TEXTURE_2D, t.id);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F,
+                         mIrradianceWidth, mIrradianceHeight, 0,
+                         GL_RGB, GL_FLOAT, mIrradianceData.data());
+            t.width = mIrradianceWidth;
+            t.height = mIrradianceHeight;
+            t.bytes = (size_t)t.width * t.height * 6;
+            return true;
+        });
+        glBindTexture(GL_TEXTURE_2D, 0);
+        mIrradianceTexture = mIrradianceRef ? mIrradianceRef->id : 0;
+    }
+
+    bool useSH() const { return mDiffuseMode == PBRDiffuse::SphericalHarmonics; }
+
+    /// Diffuse input for the current mode, made on first use: the SH
+    /// variants and coefficient block, or the irradiance map (when the
+    /// mode went back to it after the upload)
+    void prepareDiffuse() {
+        if (!useSH()) {
+            if (!mIrradianceRef && mEnvRef) {
+                IBLBaker::Source source(mEnvRef->id, mEnvRef->width, mEnvRef->height);
+                acquireIrradiance(source);
+            }
+            return;
+        }
+
+        if (!mSHShadersCompiled) {
+            if (mSHPbrShader.compile(pbr_vert_shader(),
+                                     pbr_shader_variant(pbr_frag_shader(), "PBR_SH_DIFFUSE"))) {
+                bindSHBlock(mSHPbrShader);
+            } else {
+                printf("[WebPBR] ERROR: SH diffuse shader variant compilation failed!\n");
+            }
+            mSHShadersCompiled = true;
+        }
+
+        if (mSHDirty) {
+            // Projected from the preview, which outlives releasePixels()
+            mSH = SHIrradiance::project(mHdr);
+            if (!mSHUbo) glGenBuffers(1, &mSHUbo);
+            glBindBuffer(GL_UNIFORM_BUFFER, mSHUbo);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(mSH.coeffs), mSH.coeffs, GL_STATIC_DRAW);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            mSHDirty = false;
+            printf("[WebPBR] Projected environment to L2 SH\n");
+        }
+    }
+
+    void bindSHBlock(ShaderProgram& shader) {
+        GLuint block = glGetUniformBlockIndex(shader.id(), "PBRDiffuseSH");
+        if (block != GL_INVALID_INDEX) {
+            glUniformBlockBinding(shader.id(), block, kSHBlockBinding);
+        }
+    }
+
+    /// Lighting bits of a variant key for the current environment
+    uint32_t lightingVariant() const {
+        uint32_t bits = mClustered ? kVariantClustered : 0;
+        if (!mEnvLoaded) return bits | kVariantFallback;
+        if (specularIsCube()) bits |= kVariantEnvCube;
+        return bits | (useSH() ? kVariantSH : 0);
+    }
+
+    /**
+     * Textured permutation for a key (features | kVariant* bits), compiled
+     * on first use and kept for the life of the GPU resources
+     */
+    ShaderProgram& variant(uint32_t key) {
+        auto it = mVariants.find(key);
+        if (it != mVariants.end()) return *it->second;
+
+        bool lod = key & kVariantLOD;
+        bool fallback = key & kVariantFallback;
+        bool untextured = key & kVariantUntextured;
+        std::string frag = untextured ? (fallback ? pbr_fallback_frag_shader() : pbr_frag_shader())
+                         : lod ? (fallback ? pbr_lod_fallback_frag_shader() : pbr_lod_frag_shader())
+                               : (fallback ? pbr_textured_fallback_frag_shader()
+                                           : pbr_textured_frag_shader());
+        std::vector<std::string> defines = pbr_feature_defines(key & PBRMaterialEx::AllFeatures);
+        if (key & kVariantSH) defines.push_back("PBR_SH_DIFFUSE");
+        if (key & kVariantClustered) defines.push_back("PBR_CLUSTERED_LIGHTS");
+        if (key & kVariantEnvCube) defines.push_back("PBR_ENV_CUBE");
+        if (key & kVariantInstanced) defines.push_back("PBR_INSTANCED");
+
+        auto shader = std::make_unique<ShaderProgram>();
+        std::string vert = untextured ? pbr_vert_shader() : pbr_textured_vert_shader();
+        if (key & kVariantInstanced) vert = pbr_shader_variant(vert, "PBR_INSTANCED");
+        if (shader->compile(vert, pbr_shader_variant(frag, defines))) {
+            if (key & kVariantSH) bindSHBlock(*shader);
+            printf("[WebPBR] Compiled %s variant 0x%04x (%zu cached)\n",
+                   untextured ? "untextured" : "textured", key, mVariants.size() + 1);
+        } else {
+            printf("[WebPBR] ERROR: Variant 0x%04x compilation failed!\n", key);
+        }
+        return *(mVariants[key] = std::move(shader));
+    }
+
+    /// Make a textured permutation current, setting its per-pass uniforms
+    /// when it changes; materials sharing features keep the same program
+    ShaderProgram& bindVariant(uint32_t key) {
+        ShaderProgram& shader = variant(key);
+        if (key == mBoundVariant) return shader;
+        mBoundVariant = key;
+        mActiveShader = &shader;
+        if (mGraphics) mGraphics->shader(shader);
+        else shader.use();
+
+        if (!(key & kVariantFallback)) {
+            bindIBL(shader);
+            float invViewRot[9] = {1,0,0, 0,1,0, 0,0,1};
+            shader.uniformMatrix3("invViewRot", invViewRot);
+        }
+        shader.uniform("envIntensity", mEnvIntensity);
+        shader.uniform("exposure", mExposure);
+        shader.uniform("gamma", mGamma);
+        if (key & kVariantLOD) {
+            shader.uniform("u_textureLOD", mCurrentTextureLOD);
+            shader.uniform("u_useExplicitLOD", mExplicitLOD);
+        }
+        if (key & kVariantClustered) mClustered->bind(shader);
+        return shader;
+    }
+
+    std::string envKey() const { return "env:" + mUrl; }
+    static std::string brdfKey() { return "pbr:brdf-lut"; }
+    std::string specularKey() const { return "specular:" + mUrl; }
+    std::string envCubeKey() const { return "envcube:" + mUrl; }  // As WebEnvironment
+
+    bool specularIsCube() const { return mSpecularTexture && mSpecularRef->cube; }
+    std::string irradianceKey() const { return "irradiance:" + mUrl; }
+
     /**
      * Generate diffuse irradiance map by convolving environment
      */
@@ -1971,7 +2558,7 @@ private:
     /**
      * Generate BRDF integration LUT
      */
-    void generateBrdfLUT() {
+    static bool generateBrdfLUT(GPUTexture& t) {
         const int size = 256;
         std::vector<float> lutData(size * size * 2);
 
@@ -2034,39 +2621,77 @@ private:
         }
 
         // Upload to GPU
-        glGenTextures(1, &mBrdfLUT);
-        glBindTexture(GL_TEXTURE_2D, mBrdfLUT);
+        glGenTextures(1, &t.id);
+        glBindTexture(GL_TEXTURE_2D, t.id);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, size, size, 0, GL_RG, GL_FLOAT, lutData.data());
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glBindTexture(GL_TEXTURE_2D, 0);
+        t.width = t.height = size;
+        t.bytes = (size_t)size * size * 4;
 
         printf("[WebPBR] BRDF LUT generated\n");
+        return true;
     }
 
     std::string mUrl;
     WebHDR mHdr;
+    GPUTextureRef mEnvRef;          // Shared through GPUResourceCache
+    GPUTextureRef mSpecularRef;     // Prefiltered mip chain, null without GPU baking
+    GPUTextureRef mEnvCubeRef;      // Environment as a cubemap, for the skybox
+    GPUTextureRef mIrradianceRef;
+    GPUTextureRef mBrdfRef;
     GLuint mEnvTexture;
+    GLuint mSpecularTexture = 0;
     GLuint mIrradianceTexture;
     GLuint mBrdfLUT;
     Mesh mSkyboxMesh;
     ShaderProgram mPbrShader;
     ShaderProgram mSkyboxShader;
+    ShaderProgram mSkyboxCubeShader;            // PBR_ENV_CUBE (WebGL2 with IBLBaker)
+    bool mSkyboxCubeCompiled = false;
     ShaderProgram mFallbackPbrShader;           // Analytical lighting fallback
     ShaderProgram mFallbackSkyboxShader;        // Gradient sky fallback
-    ShaderProgram mTexturedPbrShader;           // IBL with texture maps
-    ShaderProgram mTexturedFallbackPbrShader;   // Analytical with texture maps
-    ShaderProgram mLodPbrShader;                // LOD-aware IBL with textureLod()
-    ShaderProgram mLodFallbackPbrShader;        // LOD-aware analytical lighting
+    ShaderProgram mSHPbrShader;                 // PBR_SH_DIFFUSE variant, compiled
+    bool mSHShadersCompiled = false;            // on first SphericalHarmonics use
     ShaderProgram* mActiveShader = nullptr;     // Currently active PBR shader
     float mCurrentTextureLOD = 0.0f;            // Current texture LOD value
+    bool mExplicitLOD = true;
+
+    // Textured / LOD-aware permutations, keyed by PBRMaterialEx::features()
+    // plus the kVariant* bits (see variant())
+    static constexpr uint32_t kVariantLOD = 1 << 8;       // pbr_lod_*
+    static constexpr uint32_t kVariantFallback = 1 << 9;  // Analytical lighting
+    static constexpr uint32_t kVariantSH = 1 << 10;       // PBR_SH_DIFFUSE
+    static constexpr uint32_t kVariantClustered = 1 << 11; // PBR_CLUSTERED_LIGHTS
+    static constexpr uint32_t kVariantUntextured = 1 << 12; // pbr_frag / pbr_fallback_frag
+    static constexpr uint32_t kVariantEnvCube = 1 << 13;  // PBR_ENV_CUBE
+    static constexpr uint32_t kVariantInstanced = 1 << 14; // PBR_INSTANCED (untextured only)
+    static constexpr uint32_t kNoVariant = ~0u;
+    std::unordered_map<uint32_t, std::unique_ptr<ShaderProgram>> mVariants;
+    uint32_t mPassVariant = 0;                  // Non-feature bits of this pass
+    // Declared by warmUp(): feature mask | kVariantLOD, without lighting bits
+    std::vector<uint32_t> mWarmUp;
+    static constexpr size_t kWarmUpPerFrame = 2;
+    uint32_t mBoundVariant = kNoVariant;
+    ShaderProgram* mPreInstancedShader = nullptr;  // Restored by endInstanced()
+    uint32_t mPreInstancedVariant = kNoVariant;
+    Graphics* mGraphics = nullptr;              // Between begin*() and end()
+    ClusteredLights* mClustered = nullptr;      // Not owned
 
     std::vector<float> mIrradianceData;
     int mIrradianceWidth = 0;
     int mIrradianceHeight = 0;
 
+    // Below the WebGL2 backend's standard (23) and draw-transform (22) blocks
+    static constexpr GLuint kSHBlockBinding = 21;
+    PBRDiffuse mDiffuseMode = PBRDiffuse::IrradianceMap;
+    SHIrradiance mSH;
+    GLuint mSHUbo = 0;
+    bool mSHDirty = true;  // Environment changed since the last projection
+
     bool mReady;
     bool mEnvLoaded;    // True only if HDR environment loaded successfully
     bool mCreated;
@@ -2080,7 +2705,8 @@ private:
 
     // WebGPU state (Phase 5)
 #ifdef ALLOLIB_WEBGPU
-    TextureHandle mWebGPUEnvTexture;
+    TextureHandle mWebGPUEnvTexture;       // Skybox
+    TextureHandle mWebGPUSpecularTexture;  // Prefiltered, for the PBR shader
     TextureHandle mWebGPUIrradianceTexture;
     TextureHandle mWebGPUBrdfLUT;
     bool mWebGPUTexturesCreated = false;
@@ -2092,48 +2718,110 @@ private:
         auto* backend = dynamic_cast<WebGPUBackend*>(Graphics_getBackend());
         if (!backend) return;
 
-        // Convert RGB to RGBA for WebGPU (prefers 4-component formats)
-        const float* hdrPixels = mHdr.pixels();
-        std::vector<float> rgbaData(mHdr.width() * mHdr.height() * 4);
-        for (int i = 0; i < mHdr.width() * mHdr.height(); i++) {
-            rgbaData[i * 4 + 0] = hdrPixels[i * 3 + 0];
-            rgbaData[i * 4 + 1] = hdrPixels[i * 3 + 1];
-            rgbaData[i * 4 + 2] = hdrPixels[i * 3 + 2];
-            rgbaData[i * 4 + 3] = 1.0f;
-        }
-
-        // Create environment texture
+        // Create environment texture straight from the packed texels
         TextureDesc envDesc;
         envDesc.width = mHdr.width();
         envDesc.height = mHdr.height();
-        envDesc.format = PixelFormat::RGBA32F;
+        envDesc.format = PixelFormat::RGB9E5;
         envDesc.minFilter = FilterMode::Linear;
         envDesc.magFilter = FilterMode::Linear;
         envDesc.wrapS = WrapMode::Repeat;
-        envDesc.wrapT = WrapMode::Repeat;
-        mWebGPUEnvTexture = backend->createTexture(envDesc, rgbaData.data());
-
-        // Create irradiance texture
-        std::vector<float> irrRgba(mIrradianceWidth * mIrradianceHeight * 4);
-        for (int i = 0; i < mIrradianceWidth * mIrradianceHeight; i++) {
-            irrRgba[i * 4 + 0] = mIrradianceData[i * 3 + 0];
-            irrRgba[i * 4 + 1] = mIrradianceData[i * 3 + 1];
-            irrRgba[i * 4 + 2] = mIrradianceData[i * 3 + 2];
-            irrRgba[i * 4 + 3] = 1.0f;
-        }
+        envDesc.wrapT = WrapMode::ClampToEdge;  // As WebEnvironment, which shares it
+        auto& cache = GPUResourceCache::instance();
+        mEnvRef = cache.acquire(envKey(), [&](GPUTexture& t) {
+            t.handle = backend->createTexture(envDesc, mHdr.texels());
+            t.backend = backend;
+            t.width = envDesc.width;
+            t.height = envDesc.height;
+            t.bytes = (size_t)t.width * t.height * 4;
+            return t.handle.valid();
+        });
+        if (mEnvRef) mWebGPUEnvTexture = mEnvRef->handle;
+
+        // Cubemap for the skybox (shared with WebEnvironment)
+        mEnvCubeRef = cache.acquire(envCubeKey(), [&](GPUTexture& t) {
+            if (!mWebGPUEnvTexture.valid()) return false;
+            int size = IBLBaker::cubeFaceSize(envDesc.width);
+            t.handle = backend->bakeEnvironmentCube(mWebGPUEnvTexture, size);
+            t.backend = backend;
+            t.width = t.height = size;
+            t.cube = true;
+            t.bytes = (size_t)size * size * 6 * 8 * 4 / 3;
+            return t.handle.valid();
+        });
+
+        // Bake the specular chain, irradiance and BRDF LUT with compute
+        // (once per URL / once overall); irradiance falls back to the CPU
+        TextureHandle source;
+        auto bakeSource = [&]() {
+            if (!source.valid() && mWebGPUEnvTexture.valid()) {
+                source = backend->bakeIBLSource(mWebGPUEnvTexture);
+            }
+            return source;
+        };
+        auto backendTexture = [&](GPUTexture& t, TextureHandle handle, int w, int h, int levels) {
+            t.handle = handle;
+            t.backend = backend;
+            t.width = w;
+            t.height = h;
+            t.levels = levels;
+            t.bytes = (size_t)w * h * 8;
+            if (levels > 1) t.bytes = t.bytes * 4 / 3;
+            return handle.valid();
+        };
+        mSpecularRef = cache.acquire(specularKey(), [&](GPUTexture& t) {
+            if (!bakeSource().valid()) return false;
+            int w = std::min(IBLBaker::kPrefilterWidth, envDesc.width);
+            int h = std::min(IBLBaker::kPrefilterHeight, envDesc.height);
+            int levels = std::min(IBLBaker::kPrefilterLevels,
+                                  (int)std::floor(std::log2((float)std::max(w, h))) + 1);
+            TextureHandle tex = backend->bakeIBLPrefiltered(source, w, h, levels);
+            return backendTexture(t, tex, w, h, levels);
+        });
+        if (mSpecularRef) mWebGPUSpecularTexture = mSpecularRef->handle;
+
+        mIrradianceRef = cache.acquire(irradianceKey(), [&](GPUTexture& t) {
+            if (bakeSource().valid()) {
+                TextureHandle tex = backend->bakeIBLIrradiance(
+                    source, IBLBaker::kIrradianceWidth, IBLBaker::kIrradianceHeight);
+                if (backendTexture(t, tex, IBLBaker::kIrradianceWidth,
+                                   IBLBaker::kIrradianceHeight, 1)) {
+                    return true;
+                }
+            }
+            if (mIrradianceData.empty()) generateIrradianceMap();
+            std::vector<float> irrRgba(mIrradianceWidth * mIrradianceHeight * 4);
+            for (int i = 0; i < mIrradianceWidth * mIrradianceHeight; i++) {
+                irrRgba[i * 4 + 0] = mIrradianceData[i * 3 + 0];
+                irrRgba[i * 4 + 1] = mIrradianceData[i * 3 + 1];
+                irrRgba[i * 4 + 2] = mIrradianceData[i * 3 + 2];
+                irrRgba[i * 4 + 3] = 1.0f;
+            }
 
-        TextureDesc irrDesc;
-        irrDesc.width = mIrradianceWidth;
-        irrDesc.height = mIrradianceHeight;
-        irrDesc.format = PixelFormat::RGBA32F;
-        irrDesc.minFilter = FilterMode::Linear;
-        irrDesc.magFilter = FilterMode::Linear;
-        irrDesc.wrapS = WrapMode::Repeat;
-        irrDesc.wrapT = WrapMode::Repeat;
-        mWebGPUIrradianceTexture = backend->createTexture(irrDesc, irrRgba.data());
+            TextureDesc irrDesc;
+            irrDesc.width = mIrradianceWidth;
+            irrDesc.height = mIrradianceHeight;
+            irrDesc.format = PixelFormat::RGBA32F;
+            irrDesc.minFilter = FilterMode::Linear;
+            irrDesc.magFilter = FilterMode::Linear;
+            irrDesc.wrapS = WrapMode::Repeat;
+            irrDesc.wrapT = WrapMode::Repeat;
+            t.handle = backend->createTexture(irrDesc, irrRgba.data());
+            t.backend = backend;
+            t.width = irrDesc.width;
+            t.height = irrDesc.height;
+            t.bytes = (size_t)t.width * t.height * 16;
+            return t.handle.valid();
+        });
+        if (mIrradianceRef) mWebGPUIrradianceTexture = mIrradianceRef->handle;
+        if (source.valid()) backend->destroyTexture(source);
+        if (mEnvRef) mHdr.releasePixels();
 
-        // Note: BRDF LUT needs to be created separately with RG16F format
-        // For now, we'll use the fallback shader which doesn't need BRDF LUT
+        mBrdfRef = cache.acquire(brdfKey(), [&](GPUTexture& t) {
+            TextureHandle tex = backend->bakeIBLBrdfLUT(IBLBaker::kBrdfSize);
+            return backendTexture(t, tex, IBLBaker::kBrdfSize, IBLBaker::kBrdfSize, 1);
+        });
+        if (mBrdfRef) mWebGPUBrdfLUT = mBrdfRef->handle;
 
         mWebGPUTexturesCreated = true;
         printf("[WebPBR] WebGPU textures created\n");
@@ -2146,7 +2834,7 @@ private:
         createWebGPUTextures();
 
         if (mWebGPUEnvTexture.valid()) {
-            backend->setEnvironmentTexture(mWebGPUEnvTexture);
+            backend->setEnvironmentTexture(mEnvCubeRef ? mEnvCubeRef->handle : mWebGPUEnvTexture);
             backend->setEnvironmentParams(mExposure, mGamma);
             backend->drawSkybox(g.viewMatrix().elems(), g.projMatrix().elems());
         }
@@ -2160,16 +2848,29 @@ private:
 
         // Set up PBR mode
         backend->setPBRParams(mEnvIntensity, mExposure, mGamma);
+        if (useSH() && mEnvLoaded) {
+            if (mSHDirty) {
+                mSH = SHIrradiance::project(mHdr);
+                mSHDirty = false;
+            }
+            backend->setPBRDiffuseSH(mSH.coeffs[0]);
+        } else {
+            backend->setPBRDiffuseSH(nullptr);
+        }
 
         // Set inverse view rotation for environment sampling
         float invViewRot[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};  // Identity for now
         backend->setPBRInvViewRotation(invViewRot);
 
         // Set environment textures if available
-        if (mWebGPUEnvTexture.valid() && mWebGPUIrradianceTexture.valid()) {
-            backend->setPBREnvironment(mWebGPUEnvTexture, mWebGPUIrradianceTexture, TextureHandle{0});
+        if (mWebGPUSpecularTexture.valid() && mWebGPUIrradianceTexture.valid() &&
+            mWebGPUBrdfLUT.valid()) {
+            backend->setPBREnvironment(mWebGPUSpecularTexture, mWebGPUIrradianceTexture,
+                                       mWebGPUBrdfLUT, (float)(mSpecularRef->levels - 1));
         }
 
+        backend->setPBRClusteredLights(mClustered != nullptr);
+
         float camPosArray[3] = {cameraPos.x, cameraPos.y, cameraPos.z};
         backend->beginPBR(camPosArray);
     }
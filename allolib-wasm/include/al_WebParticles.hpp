@@ -0,0 +1,1065 @@
+/**
+ * Web GPU Particles - particle systems simulated and drawn on the GPU
+ *
+ * Particle state lives in GPU buffers only. Each frame one simulation pass
+ * ages, emits, pushes and collides every particle, and the same buffer
+ * then feeds an instanced draw of camera-facing billboards: nothing is
+ * read back or uploaded per particle, so the CPU cost is the same for a
+ * thousand particles as for a million.
+ * - WebGPU: a compute shader updates a storage buffer in place
+ *   (GraphicsBackend::createComputePipeline / bindStorageBuffer /
+ *   dispatch), which is bound as the instance buffer of the draw
+ * - WebGL2: a vertex shader with transform feedback writes the next state
+ *   into a second buffer (ping-pong), with rasterization discarded
+ *
+ * Usage:
+ *   GPUParticles particles(200000);
+ *   particles.emitter().rate = 20000.0f;
+ *   particles.emitter().shape = ParticleEmitter::Sphere;
+ *   particles.forces().turbulence = 2.0f;
+ *   particles.addPlane(Vec3f(0, 1, 0), -1.0f);   // Floor at y = -1
+ *
+ *   void onAnimate(double dt) { particles.update(dt); }
+ *   void onDraw(Graphics& g) {
+ *     g.clear(0);
+ *     particles.draw(g);    // Steps the simulation, then draws
+ *   }
+ *
+ * Emission is a ring: each step respawns the particles after the previous
+ * step's, wrapping at the capacity, so the oldest particles are recycled
+ * when the rate outruns their lifetime. Randomness is a hash of the
+ * particle index and a per-step seed, the same on both backends.
+ *
+ * The step runs in draw() rather than update() because WebGPU only
+ * records compute work while a frame is open (onAnimate runs before it).
+ * It runs once per update(), so stereo and multi-view draws see the same
+ * state. Sizes are in world units; positions are in the model space
+ * current at draw().
+ */
+
+#ifndef AL_WEB_PARTICLES_HPP
+#define AL_WEB_PARTICLES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "al/graphics/al_Graphics.hpp"
+#include "al/graphics/al_OpenGL.hpp"
+#include "al/math/al_Matrix4.hpp"
+#include "al/math/al_Vec.hpp"
+#include "al/types/al_Color.hpp"
+#include "al_WebGraphicsBackend.hpp"
+
+namespace al {
+
+/**
+ * Where and how particles are born
+ */
+struct ParticleEmitter {
+    enum Shape { Point, Sphere, Box };
+
+    Shape shape = Point;
+    Vec3f position{0, 0, 0};
+    Vec3f extent{1, 1, 1};       // Sphere: x is the radius; Box: half-size
+    Vec3f direction{0, 1, 0};    // Zero emits in every direction
+    float spread = 0.3f;         // Weight of a random unit vector added to direction
+    float speed = 1.0f;
+    float speedJitter = 0.2f;    // Fraction of speed taken off at random
+    float rate = 1000.0f;        // Particles per second
+    float lifeMin = 1.0f;        // Seconds
+    float lifeMax = 2.0f;
+    float sizeStart = 0.05f;     // Billboard half-width, world units
+    float sizeEnd = 0.0f;
+    Color colorStart{1, 1, 1, 1};
+    Color colorEnd{1, 1, 1, 0};
+};
+
+/**
+ * Forces applied to every live particle
+ */
+struct ParticleForces {
+    Vec3f gravity{0, -9.8f, 0};
+    float drag = 0.0f;             // Velocity falls as 1 / (1 + drag * dt) per step
+    float turbulence = 0.0f;       // Acceleration of the swirl field
+    float turbulenceScale = 1.0f;  // Its spatial frequency
+};
+
+class GPUParticles {
+public:
+    // One storage binding holds them all; WebGPU guarantees 128 MB
+    static constexpr int kRecordSize = 80;
+    static constexpr int kMaxParticles = (128 << 20) / kRecordSize;
+    static constexpr int kMaxAttractors = 4;
+    static constexpr int kMaxPlanes = 4;
+    static constexpr int kMaxSpheres = 4;
+    static constexpr float kMaxStep = 0.1f;  // Longer frames are simulated slower
+
+    explicit GPUParticles(int capacity = 100000) { this->capacity(capacity); }
+    ~GPUParticles() { destroy(); }
+    GPUParticles(const GPUParticles&) = delete;
+    GPUParticles& operator=(const GPUParticles&) = delete;
+
+    /// Whether the current backend can run the simulation
+    static bool supported() {
+        if (Graphics_isWebGPU()) {
+            GraphicsBackend* backend = Graphics_getBackend();
+            return backend && backend->supportsCompute();
+        }
+        return true;  // Transform feedback is core WebGL2
+    }
+
+    // ── Configuration ───────────────────────────────────────────────────
+
+    int capacity() const { return mCapacity; }
+
+    /// Maximum live particles; changing it kills every particle
+    void capacity(int n) {
+        n = std::min(std::max(n, 1), kMaxParticles);
+        if (n == mCapacity) return;
+        destroy();
+        mCapacity = n;
+    }
+
+    ParticleEmitter& emitter() { return mEmitter; }
+    ParticleForces& forces() { return mForces; }
+
+    /// Additive (default) needs no sorting; Alpha draws in buffer order
+    void blend(BlendMode mode) { mBlend = mode; }
+
+    /// Point attractor; negative strength repels. Falls off with the
+    /// square of the distance.
+    bool addAttractor(const Vec3f& pos, float strength) {
+        if (mAttractorCount == kMaxAttractors) return false;
+        set(mAttractors[mAttractorCount++], pos, strength);
+        return true;
+    }
+
+    /// Keep particles on the side of dot(normal, p) = offset the normal
+    /// points to
+    bool addPlane(const Vec3f& normal, float offset) {
+        if (mPlaneCount == kMaxPlanes) return false;
+        float len = normal.mag();
+        if (len <= 0.0f) return false;
+        set(mPlanes[mPlaneCount++], normal / len, offset / len);
+        return true;
+    }
+
+    /// Keep particles outside a sphere
+    bool addSphere(const Vec3f& center, float radius) {
+        if (mSphereCount == kMaxSpheres) return false;
+        set(mSpheres[mSphereCount++], center, radius);
+        return true;
+    }
+
+    void clearAttractors() { mAttractorCount = 0; }
+    void clearColliders() { mPlaneCount = mSphereCount = 0; }
+
+    /// Collision response: fraction of the normal speed kept (0 = stick,
+    /// 1 = elastic) and of the tangential speed lost
+    void bounce(float restitution, float friction = 0.0f) {
+        mRestitution = restitution;
+        mFriction = friction;
+    }
+
+    // ── Simulation ──────────────────────────────────────────────────────
+
+    /// Emit n particles on the next step, on top of the rate
+    void burst(int n) { mBurst += std::max(n, 0); }
+
+    /// Advance by dt seconds; the GPU work runs in the next draw()
+    void update(double dt) {
+        if (dt <= 0.0) return;
+        mPendingDt += (float)dt;
+        mEmitDebt += mEmitter.rate * (float)dt;
+        mStepPending = true;
+    }
+
+    /// Kill every particle (buffers are recreated zeroed)
+    void reset() {
+        destroy();
+        mEmitDebt = 0.0f;
+        mBurst = 0;
+        mPendingDt = 0.0f;
+        mStepPending = false;
+    }
+
+    /// Total particles emitted, for stats
+    uint64_t emitted() const { return mEmitted; }
+
+    /// Run the pending step, then draw every live particle with g's
+    /// current view, model and projection
+    void draw(Graphics& g) {
+        if (!ensureResources()) return;
+        if (mStepPending) {
+            step();
+            mStepPending = false;
+        }
+        Mat4f mv = g.viewMatrix() * g.modelMatrix();
+        Mat4f proj = g.projMatrix();
+        if (mWebGPU) {
+            drawWebGPU(mv, proj);
+        } else {
+            drawWebGL2(mv, proj);
+        }
+    }
+
+    /// Release GPU resources (recreated, empty, by the next draw())
+    void destroy() {
+        if (mWebGPU) {
+            GraphicsBackend* backend = Graphics_getBackend();
+            if (backend) {
+                if (mGpuBuffer.valid()) backend->destroyBuffer(mGpuBuffer);
+                if (mGpuParams.valid()) backend->destroyBuffer(mGpuParams);
+                if (mGpuQuad.valid()) backend->destroyBuffer(mGpuQuad);
+                if (mGpuShader.valid()) backend->destroyShader(mGpuShader);
+                if (mGpuCompute.valid()) backend->destroyComputePipeline(mGpuCompute);
+            }
+            mGpuBuffer = mGpuParams = mGpuQuad = {};
+            mGpuShader = {};
+            mGpuCompute = {};
+        } else if (mSimProgram || mDrawProgram) {
+            glDeleteProgram(mSimProgram);
+            glDeleteProgram(mDrawProgram);
+            glDeleteBuffers(2, mBuffers);
+            glDeleteBuffers(1, &mQuad);
+            glDeleteVertexArrays(2, mSimVaos);
+            glDeleteVertexArrays(2, mDrawVaos);
+            glDeleteTransformFeedbacks(1, &mFeedback);
+        }
+        mSimProgram = mDrawProgram = mQuad = mFeedback = 0;
+        mBuffers[0] = mBuffers[1] = mSimVaos[0] = mSimVaos[1] = 0;
+        mDrawVaos[0] = mDrawVaos[1] = 0;
+        mCurrent = 0;
+        mCreated = false;
+        mWebGPU = false;
+    }
+
+private:
+    // Params rows (vec4 each), laid out identically in WGSL and GLSL:
+    //  0 emitter position, shape   1 extent, speed       2 direction, spread
+    //  3 life min/max, size start/end                    4-5 color start/end
+    //  6 gravity, drag             7 turbulence, scale, time, dt
+    //  8 emit start, emit count, capacity, seed
+    //  9 attractor/plane/sphere counts, restitution      10 friction, jitter
+    //  11-14 attractors (pos, strength)  15-18 planes (normal, offset)
+    //  19-22 spheres (center, radius)
+    static constexpr int kParamRows = 23;
+
+    static void set(float* row, const Vec3f& v, float w) {
+        row[0] = v.x;
+        row[1] = v.y;
+        row[2] = v.z;
+        row[3] = w;
+    }
+    static void set(float* row, const Color& c) {
+        row[0] = c.r;
+        row[1] = c.g;
+        row[2] = c.b;
+        row[3] = c.a;
+    }
+
+    void step() {
+        float dt = std::min(mPendingDt, kMaxStep);
+        mPendingDt = 0.0f;
+        mTime += dt;
+
+        // Whole particles only; the fraction carries to the next step
+        float owed = std::floor(mEmitDebt);
+        mEmitDebt -= owed;
+        int count = (int)std::min((double)owed + mBurst, (double)mCapacity);
+        mBurst = 0;
+        int start = mCursor;
+        mCursor = (mCursor + count) % mCapacity;
+        mEmitted += count;
+
+        const ParticleEmitter& e = mEmitter;
+        Vec3f dir = e.direction;
+        float len = dir.mag();
+        if (len > 0.0f) dir /= len;
+
+        float* p = mParams;
+        set(p + 0, e.position, (float)e.shape);
+        set(p + 4, e.extent, e.speed);
+        set(p + 8, dir, e.spread);
+        set(p + 12, Vec3f(e.lifeMin, std::max(e.lifeMax, e.lifeMin), e.sizeStart), e.sizeEnd);
+        set(p + 16, e.colorStart);
+        set(p + 20, e.colorEnd);
+        set(p + 24, mForces.gravity, mForces.drag);
+        set(p + 28, Vec3f(mForces.turbulence, mForces.turbulenceScale, std::fmod(mTime, 1000.0f)), dt);
+        // Counts travel as floats: exact below 2^24, far above kMaxParticles
+        set(p + 32, Vec3f((float)start, (float)count, (float)mCapacity),
+            (float)(mSeed++ & 0xFFFFFF));
+        set(p + 36, Vec3f((float)mAttractorCount, (float)mPlaneCount, (float)mSphereCount),
+            mRestitution);
+        set(p + 40, Vec3f(mFriction, e.speedJitter, 0.0f), 0.0f);
+        std::copy(&mAttractors[0][0], &mAttractors[0][0] + 4 * kMaxAttractors, p + 44);
+        std::copy(&mPlanes[0][0], &mPlanes[0][0] + 4 * kMaxPlanes, p + 60);
+        std::copy(&mSpheres[0][0], &mSpheres[0][0] + 4 * kMaxSpheres, p + 76);
+
+        if (mWebGPU) {
+            stepWebGPU();
+        } else {
+            stepWebGL2();
+        }
+    }
+
+    bool ensureResources() {
+        if (mCreated) return true;
+        if (mFailed) return false;
+        if (!supported()) {
+            printf("[GPUParticles] Not supported by this backend\n");
+            mFailed = true;
+            return false;
+        }
+        mWebGPU = Graphics_isWebGPU();
+        mCreated = mWebGPU ? createWebGPU() : createWebGL2();
+        if (!mCreated) {
+            destroy();
+            mFailed = true;  // Don't retry (and log) every frame
+            return false;
+        }
+        printf("[GPUParticles] %d particles (%s)\n", mCapacity,
+               mWebGPU ? "WebGPU compute" : "WebGL2 transform feedback");
+        return true;
+    }
+
+    // ── WebGPU ──────────────────────────────────────────────────────────
+
+    bool createWebGPU() {
+        GraphicsBackend* backend = Graphics_getBackend();
+        size_t bytes = (size_t)mCapacity * kRecordSize;
+        // Zeroed records have age >= life: every particle starts dead
+        mGpuBuffer = backend->createBuffer(BufferType::Storage, BufferUsage::Dynamic, nullptr, bytes);
+        mGpuParams = backend->createBuffer(BufferType::Storage, BufferUsage::Dynamic, nullptr,
+                                           sizeof(mParams));
+        float quad[6 * 12];
+        quadVertices(quad);
+        mGpuQuad = backend->createBuffer(BufferType::Vertex, BufferUsage::Static, quad, sizeof(quad));
+
+        ShaderDesc compute;
+        compute.name = "GPUParticles Simulate";
+        compute.computeSource = kSimulateWGSL;
+        mGpuCompute = backend->createComputePipeline(compute);
+
+        ShaderDesc render;
+        render.name = "GPUParticles Draw";
+        render.vertexSource = kDrawVertexWGSL;
+        render.fragmentSource = kDrawFragmentWGSL;
+        mGpuShader = backend->createShader(render);
+
+        if (!mGpuBuffer.valid() || !mGpuParams.valid() || !mGpuQuad.valid() ||
+            !mGpuCompute.valid() || !mGpuShader.valid()) {
+            printf("[GPUParticles] Failed to create WebGPU resources\n");
+            return false;
+        }
+        return true;
+    }
+
+    void stepWebGPU() {
+        GraphicsBackend* backend = Graphics_getBackend();
+        backend->updateBuffer(mGpuParams, mParams, sizeof(mParams));
+        backend->bindStorageBuffer(0, mGpuBuffer);
+        backend->bindStorageBuffer(1, mGpuParams);
+        backend->dispatch(mGpuCompute, (mCapacity + 63) / 64);
+        backend->bindStorageBuffer(0, {});
+        backend->bindStorageBuffer(1, {});
+    }
+
+    void drawWebGPU(const Mat4f& mv, const Mat4f& proj) {
+        GraphicsBackend* backend = Graphics_getBackend();
+        DrawState saved = backend->getDrawState();
+        backend->setDrawState(particleDrawState());
+        backend->useShader(mGpuShader);
+        backend->setUniformMat4("modelViewMatrix", mv.elems());
+        backend->setUniformMat4("projectionMatrix", proj.elems());
+        backend->setVertexBuffer(mGpuQuad, {48, {{0, 3, 0}, {1, 4, 12}, {2, 2, 28}, {3, 3, 36}}});
+        backend->setInstanceBuffer(mGpuBuffer);
+        backend->drawInstanced(PrimitiveType::Triangles, 6, mCapacity);
+        backend->setInstanceBuffer({});
+        backend->useShader({});
+        backend->setDrawState(saved);
+    }
+
+    DrawState particleDrawState() const {
+        DrawState state;
+        state.blend = mBlend;
+        state.cull = CullFace::None;
+        state.depthTest = true;
+        state.depthWrite = false;  // Soft edges must not hide what is behind
+        return state;
+    }
+
+    /// Two triangles in the 48-byte vertex layout: corner in position.xy,
+    /// uv in texcoord
+    static void quadVertices(float* out) {
+        const float corners[6][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, -1}, {1, 1}, {-1, 1}};
+        for (int i = 0; i < 6; i++) {
+            float* v = out + i * 12;
+            std::fill(v, v + 12, 0.0f);
+            v[0] = corners[i][0];
+            v[1] = corners[i][1];
+            v[3] = v[4] = v[5] = v[6] = 1.0f;
+            v[7] = corners[i][0] * 0.5f + 0.5f;
+            v[8] = corners[i][1] * 0.5f + 0.5f;
+        }
+    }
+
+    // ── WebGL2 ──────────────────────────────────────────────────────────
+
+    /// Bindings the WebGL2 passes change, put back afterwards so
+    /// al::Graphics and the backend's caches stay valid
+    class GLState {
+    public:
+        GLState() {
+            glGetIntegerv(GL_CURRENT_PROGRAM, &mProgram);
+            glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &mVao);
+            glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &mArrayBuffer);
+            glGetIntegerv(GL_BLEND_SRC_RGB, &mBlendSrcRgb);
+            glGetIntegerv(GL_BLEND_DST_RGB, &mBlendDstRgb);
+            glGetIntegerv(GL_BLEND_SRC_ALPHA, &mBlendSrcAlpha);
+            glGetIntegerv(GL_BLEND_DST_ALPHA, &mBlendDstAlpha);
+            glGetBooleanv(GL_DEPTH_WRITEMASK, &mDepthMask);
+            mBlend = glIsEnabled(GL_BLEND);
+            mDepthTest = glIsEnabled(GL_DEPTH_TEST);
+            mCull = glIsEnabled(GL_CULL_FACE);
+        }
+
+        ~GLState() {
+            glUseProgram(mProgram);
+            glBindVertexArray(mVao);
+            glBindBuffer(GL_ARRAY_BUFFER, mArrayBuffer);
+            glBlendFuncSeparate(mBlendSrcRgb, mBlendDstRgb, mBlendSrcAlpha, mBlendDstAlpha);
+            glDepthMask(mDepthMask);
+            enable(GL_BLEND, mBlend);
+            enable(GL_DEPTH_TEST, mDepthTest);
+            enable(GL_CULL_FACE, mCull);
+        }
+
+        GLState(const GLState&) = delete;
+        GLState& operator=(const GLState&) = delete;
+
+        static void enable(GLenum cap, bool on) {
+            if (on) {
+                glEnable(cap);
+            } else {
+                glDisable(cap);
+            }
+        }
+
+    private:
+        GLint mProgram = 0, mVao = 0, mArrayBuffer = 0;
+        GLint mBlendSrcRgb = 0, mBlendDstRgb = 0, mBlendSrcAlpha = 0, mBlendDstAlpha = 0;
+        GLboolean mDepthMask = GL_TRUE, mBlend = GL_FALSE, mDepthTest = GL_FALSE, mCull = GL_FALSE;
+    };
+
+    bool createWebGL2() {
+        GLState state;
+        static const char* varyings[] = {"o0", "o1", "o2", "o3", "o4"};
+        mSimProgram = link(kSimulateGLSL, kDiscardFragGLSL, varyings, 5);
+        mDrawProgram = link(kDrawVertexGLSL, kDrawFragmentGLSL, nullptr, 0);
+        if (!mSimProgram || !mDrawProgram) return false;
+        mParamsLocation = glGetUniformLocation(mSimProgram, "uParams");
+        mModelViewLocation = glGetUniformLocation(mDrawProgram, "uModelView");
+        mProjectionLocation = glGetUniformLocation(mDrawProgram, "uProjection");
+
+        // Zeroed records have age >= life: every particle starts dead
+        GLsizeiptr bytes = (GLsizeiptr)mCapacity * kRecordSize;
+        glGenBuffers(2, mBuffers);
+        for (GLuint buffer : mBuffers) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_DYNAMIC_COPY);
+        }
+        const float corners[12] = {-1, -1, 1, -1, 1, 1, -1, -1, 1, 1, -1, 1};
+        glGenBuffers(1, &mQuad);
+        glBindBuffer(GL_ARRAY_BUFFER, mQuad);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+
+        // Per buffer: a VAO reading it per vertex (simulation input) and one
+        // reading it per instance under the quad (drawing)
+        glGenVertexArrays(2, mSimVaos);
+        glGenVertexArrays(2, mDrawVaos);
+        for (int i = 0; i < 2; i++) {
+            glBindVertexArray(mSimVaos[i]);
+            glBindBuffer(GL_ARRAY_BUFFER, mBuffers[i]);
+            for (GLuint loc = 0; loc < 5; loc++) {
+                glEnableVertexAttribArray(loc);
+                glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, kRecordSize,
+                                      (const void*)(uintptr_t)(loc * 16));
+            }
+
+            glBindVertexArray(mDrawVaos[i]);
+            glBindBuffer(GL_ARRAY_BUFFER, mQuad);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+            glBindBuffer(GL_ARRAY_BUFFER, mBuffers[i]);
+            const GLuint records[4] = {0, 1, 3, 4};  // pos/age, vel/life, sizes, color
+            for (GLuint loc = 1; loc <= 4; loc++) {
+                glEnableVertexAttribArray(loc);
+                glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, kRecordSize,
+                                      (const void*)(uintptr_t)(records[loc - 1] * 16));
+                glVertexAttribDivisor(loc, 1);
+            }
+        }
+        glGenTransformFeedbacks(1, &mFeedback);
+        return true;
+    }
+
+    void stepWebGL2() {
+        GLState state;
+        int next = 1 - mCurrent;
+        glUseProgram(mSimProgram);
+        glUniform4fv(mParamsLocation, kParamRows, mParams);
+        glBindVertexArray(mSimVaos[mCurrent]);
+        // A buffer may not be bound for feedback and anything else at once
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, mFeedback);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, mBuffers[next]);
+
+        glEnable(GL_RASTERIZER_DISCARD);
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, mCapacity);
+        glEndTransformFeedback();
+        glDisable(GL_RASTERIZER_DISCARD);
+
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+        mCurrent = next;
+    }
+
+    void drawWebGL2(const Mat4f& mv, const Mat4f& proj) {
+        GLState state;
+        glUseProgram(mDrawProgram);
+        glUniformMatrix4fv(mModelViewLocation, 1, GL_FALSE, mv.elems());
+        glUniformMatrix4fv(mProjectionLocation, 1, GL_FALSE, proj.elems());
+        glBindVertexArray(mDrawVaos[mCurrent]);
+
+        GLState::enable(GL_BLEND, mBlend != BlendMode::None);
+        switch (mBlend) {
+            case BlendMode::Alpha: glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); break;
+            case BlendMode::Multiply: glBlendFunc(GL_DST_COLOR, GL_ZERO); break;
+            case BlendMode::PreMultiplied: glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); break;
+            case BlendMode::Screen: glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR); break;
+            default: glBlendFunc(GL_SRC_ALPHA, GL_ONE); break;
+        }
+        glEnable(GL_DEPTH_TEST);
+        glDepthMask(GL_FALSE);
+        glDisable(GL_CULL_FACE);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, mCapacity);
+    }
+
+    static GLuint compile(GLenum type, const char* source) {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        GLint ok = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        if (!ok) {
+            char log[512];
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            printf("[GPUParticles] Shader compile error: %s\n", log);
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    /// Varyings, if any, are captured interleaved by transform feedback
+    static GLuint link(const char* vert, const char* frag, const char* const* varyings,
+                       int varyingCount) {
+        GLuint vs = compile(GL_VERTEX_SHADER, vert);
+        GLuint fs = compile(GL_FRAGMENT_SHADER, frag);
+        GLuint program = 0;
+        if (vs && fs) {
+            program = glCreateProgram();
+            glAttachShader(program, vs);
+            glAttachShader(program, fs);
+            if (varyingCount > 0) {
+                glTransformFeedbackVaryings(program, varyingCount, varyings, GL_INTERLEAVED_ATTRIBS);
+            }
+            glLinkProgram(program);
+            GLint ok = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &ok);
+            if (!ok) {
+                char log[512];
+                glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+                printf("[GPUParticles] Program link error: %s\n", log);
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+        return program;
+    }
+
+    // ── Shaders ──
+    //
+    // Particle record (kRecordSize bytes, five vec4s):
+    //   p0 position, age        p1 velocity, life      p2 color at birth
+    //   p3 size start, size end, random, 0             p4 color now
+    // On WebGPU the draw reads it through the instance attribute slots
+    // (locations 4-8, al_InstanceModelView / al_InstanceTint).
+
+    static constexpr const char* kSimulateWGSL = R"(
+struct Particle {
+    p0: vec4f,
+    p1: vec4f,
+    p2: vec4f,
+    p3: vec4f,
+    p4: vec4f,
+}
+
+struct Params {
+    emitPos: vec4f,
+    emitExtent: vec4f,
+    emitDir: vec4f,
+    emitLife: vec4f,
+    colorStart: vec4f,
+    colorEnd: vec4f,
+    gravity: vec4f,
+    turbulence: vec4f,
+    emission: vec4f,
+    counts: vec4f,
+    collide: vec4f,
+    attractors: array<vec4f, 4>,
+    planes: array<vec4f, 4>,
+    spheres: array<vec4f, 4>,
+}
+
+@group(0) @binding(0) var<storage, read_write> particles: array<Particle>;
+@group(0) @binding(1) var<storage, read> params: Params;
+
+fn pcg(v: u32) -> u32 {
+    let state = v * 747796405u + 2891336453u;
+    let word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+fn rand(s: ptr<function, u32>) -> f32 {
+    *s = pcg(*s);
+    return f32(*s >> 8u) / 16777216.0;
+}
+
+fn randomUnit(s: ptr<function, u32>) -> vec3f {
+    let z = rand(s) * 2.0 - 1.0;
+    let phi = rand(s) * 6.2831853;
+    let r = sqrt(max(1.0 - z * z, 0.0));
+    return vec3f(r * cos(phi), r * sin(phi), z);
+}
+
+fn spawnParticle(i: u32) -> Particle {
+    var s = pcg(i ^ pcg(u32(params.emission.w)));
+    var pos = params.emitPos.xyz;
+    if (params.emitPos.w > 1.5) {
+        pos += (vec3f(rand(&s), rand(&s), rand(&s)) * 2.0 - 1.0) * params.emitExtent.xyz;
+    } else if (params.emitPos.w > 0.5) {
+        pos += randomUnit(&s) * (params.emitExtent.x * pow(rand(&s), 1.0 / 3.0));
+    }
+    let scatter = randomUnit(&s);
+    let d = params.emitDir.xyz + scatter * params.emitDir.w;
+    let dir = select(scatter, normalize(d), dot(d, d) > 1e-8);
+    let speed = params.emitExtent.w * (1.0 - params.collide.y * rand(&s));
+    let life = mix(params.emitLife.x, params.emitLife.y, rand(&s));
+
+    var p: Particle;
+    p.p0 = vec4f(pos, 0.0);
+    p.p1 = vec4f(dir * speed, life);
+    p.p2 = params.colorStart;
+    p.p3 = vec4f(params.emitLife.z, params.emitLife.w, rand(&s), 0.0);
+    p.p4 = params.colorStart;
+    return p;
+}
+
+// Divergence-free (no component depends on its own axis): it stirs
+// without bunching particles up
+fn swirl(p: vec3f, t: f32) -> vec3f {
+    return vec3f(sin(p.y + t) + cos(p.z * 1.3 - t * 0.7),
+                 sin(p.z + t * 1.1) + cos(p.x * 1.3 + t * 0.5),
+                 sin(p.x - t * 0.9) + cos(p.y * 1.3 + t * 0.3));
+}
+
+fn bounce(vel: vec3f, n: vec3f) -> vec3f {
+    let vn = dot(vel, n);
+    if (vn >= 0.0) {
+        return vel;
+    }
+    let vt = vel - n * vn;
+    return vt * (1.0 - params.collide.x) - n * (vn * params.counts.w);
+}
+
+@compute @workgroup_size(64)
+fn cs_main(@builtin(global_invocation_id) id: vec3u) {
+    let i = id.x;
+    let capacity = u32(params.emission.z);
+    if (i >= capacity) {
+        return;
+    }
+    if ((i + capacity - u32(params.emission.x)) % capacity < u32(params.emission.y)) {
+        particles[i] = spawnParticle(i);
+        return;
+    }
+
+    var p = particles[i];
+    if (p.p0.w >= p.p1.w) {
+        return;  // Dead until respawned
+    }
+    let dt = params.turbulence.w;
+    let age = p.p0.w + dt;
+    var pos = p.p0.xyz;
+    var vel = p.p1.xyz;
+
+    var acc = params.gravity.xyz;
+    for (var a = 0u; a < u32(params.counts.x); a++) {
+        let attractor = params.attractors[a];
+        let d = attractor.xyz - pos;
+        let r2 = max(dot(d, d), 0.01);
+        acc += d * (attractor.w * inverseSqrt(r2) / r2);
+    }
+    if (params.turbulence.x != 0.0) {
+        acc += swirl(pos * params.turbulence.y, params.turbulence.z) * params.turbulence.x;
+    }
+    vel = (vel + acc * dt) / (1.0 + params.gravity.w * dt);
+    pos += vel * dt;
+
+    for (var k = 0u; k < u32(params.counts.y); k++) {
+        let plane = params.planes[k];
+        let dist = dot(plane.xyz, pos) - plane.w;
+        if (dist < 0.0) {
+            pos -= plane.xyz * dist;
+            vel = bounce(vel, plane.xyz);
+        }
+    }
+    for (var k = 0u; k < u32(params.counts.z); k++) {
+        let sphere = params.spheres[k];
+        let d = pos - sphere.xyz;
+        let len = length(d);
+        if (len < sphere.w && len > 1e-6) {
+            let n = d / len;
+            pos = sphere.xyz + n * sphere.w;
+            vel = bounce(vel, n);
+        }
+    }
+
+    p.p0 = vec4f(pos, age);
+    p.p1 = vec4f(vel, p.p1.w);
+    p.p4 = mix(p.p2, params.colorEnd, min(age / p.p1.w, 1.0));
+    particles[i] = p;
+}
+)";
+
+    static constexpr const char* kDrawVertexWGSL = R"(
+struct Uniforms {
+    modelViewMatrix: mat4x4f,
+    projectionMatrix: mat4x4f,
+}
+
+@group(0) @binding(0) var<uniform> uniforms: Uniforms;
+
+// The particle record arrives in the instance attribute slots:
+// al_InstanceModelView0-3 = p0-p3, al_InstanceTint = p4
+struct VertexInput {
+    @location(0) position: vec3f,
+    @location(2) texcoord: vec2f,
+    @location(4) al_InstanceModelView0: vec4f,
+    @location(5) al_InstanceModelView1: vec4f,
+    @location(7) al_InstanceModelView3: vec4f,
+    @location(8) al_InstanceTint: vec4f,
+}
+
+struct VertexOutput {
+    @builtin(position) position: vec4f,
+    @location(0) color: vec4f,
+    @location(1) uv: vec2f,
+}
+
+@vertex
+fn vs_main(in: VertexInput) -> VertexOutput {
+    var out: VertexOutput;
+    let p0 = in.al_InstanceModelView0;
+    let p1 = in.al_InstanceModelView1;
+    let p3 = in.al_InstanceModelView3;
+    out.color = in.al_InstanceTint;
+    out.uv = in.texcoord;
+    if (p0.w >= p1.w) {
+        out.position = vec4f(2.0, 2.0, 2.0, 1.0);  // Dead: outside the clip volume
+        return out;
+    }
+
+    // Camera-facing: the corner offset is applied in view space
+    let size = mix(p3.x, p3.y, p0.w / p1.w);
+    let viewPos = uniforms.modelViewMatrix * vec4f(p0.xyz, 1.0) + vec4f(in.position.xy * size, 0.0, 0.0);
+    var clipPos = uniforms.projectionMatrix * viewPos;
+    clipPos.z = clipPos.z * 0.5 + clipPos.w * 0.5;
+    out.position = clipPos;
+    return out;
+}
+)";
+
+    static constexpr const char* kDrawFragmentWGSL = R"(
+struct FragmentInput {
+    @location(0) color: vec4f,
+    @location(1) uv: vec2f,
+}
+
+@fragment
+fn fs_main(in: FragmentInput) -> @location(0) vec4f {
+    let c = in.uv * 2.0 - 1.0;
+    let r2 = dot(c, c);
+    if (r2 > 1.0) {
+        discard;
+    }
+    return vec4f(in.color.rgb, in.color.a * (1.0 - r2));
+}
+)";
+
+    static constexpr const char* kSimulateGLSL = R"(#version 300 es
+precision highp float;
+precision highp int;
+
+layout(location = 0) in vec4 a0;
+layout(location = 1) in vec4 a1;
+layout(location = 2) in vec4 a2;
+layout(location = 3) in vec4 a3;
+layout(location = 4) in vec4 a4;
+out vec4 o0;
+out vec4 o1;
+out vec4 o2;
+out vec4 o3;
+out vec4 o4;
+
+uniform vec4 uParams[23];
+#define emitPos uParams[0]
+#define emitExtent uParams[1]
+#define emitDir uParams[2]
+#define emitLife uParams[3]
+#define colorStart uParams[4]
+#define colorEnd uParams[5]
+#define gravity uParams[6]
+#define turbulence uParams[7]
+#define emission uParams[8]
+#define counts uParams[9]
+#define collide uParams[10]
+#define attractors(i) uParams[11 + (i)]
+#define planes(i) uParams[15 + (i)]
+#define spheres(i) uParams[19 + (i)]
+
+uint pcg(uint v) {
+    uint state = v * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float rand(inout uint s) {
+    s = pcg(s);
+    return float(s >> 8u) / 16777216.0;
+}
+
+vec3 randomUnit(inout uint s) {
+    float z = rand(s) * 2.0 - 1.0;
+    float phi = rand(s) * 6.2831853;
+    float r = sqrt(max(1.0 - z * z, 0.0));
+    return vec3(r * cos(phi), r * sin(phi), z);
+}
+
+void spawnParticle(uint i) {
+    uint s = pcg(i ^ pcg(uint(emission.w)));
+    vec3 pos = emitPos.xyz;
+    if (emitPos.w > 1.5) {
+        vec3 r = vec3(rand(s), rand(s), rand(s));
+        pos += (r * 2.0 - 1.0) * emitExtent.xyz;
+    } else if (emitPos.w > 0.5) {
+        vec3 u = randomUnit(s);
+        pos += u * (emitExtent.x * pow(rand(s), 1.0 / 3.0));
+    }
+    vec3 scatter = randomUnit(s);
+    vec3 d = emitDir.xyz + scatter * emitDir.w;
+    vec3 dir = dot(d, d) > 1e-8 ? normalize(d) : scatter;
+    float speed = emitExtent.w * (1.0 - collide.y * rand(s));
+    float life = mix(emitLife.x, emitLife.y, rand(s));
+
+    o0 = vec4(pos, 0.0);
+    o1 = vec4(dir * speed, life);
+    o2 = colorStart;
+    o3 = vec4(emitLife.z, emitLife.w, rand(s), 0.0);
+    o4 = colorStart;
+}
+
+// Divergence-free (no component depends on its own axis): it stirs
+// without bunching particles up
+vec3 swirl(vec3 p, float t) {
+    return vec3(sin(p.y + t) + cos(p.z * 1.3 - t * 0.7),
+                sin(p.z + t * 1.1) + cos(p.x * 1.3 + t * 0.5),
+                sin(p.x - t * 0.9) + cos(p.y * 1.3 + t * 0.3));
+}
+
+vec3 bounce(vec3 vel, vec3 n) {
+    float vn = dot(vel, n);
+    if (vn >= 0.0) return vel;
+    vec3 vt = vel - n * vn;
+    return vt * (1.0 - collide.x) - n * (vn * counts.w);
+}
+
+void main() {
+    uint i = uint(gl_VertexID);
+    uint capacity = uint(emission.z);
+    if ((i + capacity - uint(emission.x)) % capacity < uint(emission.y)) {
+        spawnParticle(i);
+        return;
+    }
+
+    o0 = a0;
+    o1 = a1;
+    o2 = a2;
+    o3 = a3;
+    o4 = a4;
+    if (a0.w >= a1.w) return;  // Dead until respawned
+
+    float dt = turbulence.w;
+    float age = a0.w + dt;
+    vec3 pos = a0.xyz;
+    vec3 vel = a1.xyz;
+
+    vec3 acc = gravity.xyz;
+    for (int a = 0; a < int(counts.x); a++) {
+        vec4 attractor = attractors(a);
+        vec3 d = attractor.xyz - pos;
+        float r2 = max(dot(d, d), 0.01);
+        acc += d * (attractor.w * inversesqrt(r2) / r2);
+    }
+    if (turbulence.x != 0.0) {
+        acc += swirl(pos * turbulence.y, turbulence.z) * turbulence.x;
+    }
+    vel = (vel + acc * dt) / (1.0 + gravity.w * dt);
+    pos += vel * dt;
+
+    for (int k = 0; k < int(counts.y); k++) {
+        vec4 plane = planes(k);
+        float dist = dot(plane.xyz, pos) - plane.w;
+        if (dist < 0.0) {
+            pos -= plane.xyz * dist;
+            vel = bounce(vel, plane.xyz);
+        }
+    }
+    for (int k = 0; k < int(counts.z); k++) {
+        vec4 sphere = spheres(k);
+        vec3 d = pos - sphere.xyz;
+        float len = length(d);
+        if (len < sphere.w && len > 1e-6) {
+            vec3 n = d / len;
+            pos = sphere.xyz + n * sphere.w;
+            vel = bounce(vel, n);
+        }
+    }
+
+    o0 = vec4(pos, age);
+    o1 = vec4(vel, a1.w);
+    o4 = mix(a2, colorEnd, min(age / a1.w, 1.0));
+}
+)";
+
+    static constexpr const char* kDiscardFragGLSL = R"(#version 300 es
+precision mediump float;
+out vec4 fragColor;
+void main() { fragColor = vec4(0.0); }
+)";
+
+    static constexpr const char* kDrawVertexGLSL = R"(#version 300 es
+precision highp float;
+
+layout(location = 0) in vec2 aCorner;
+layout(location = 1) in vec4 aP0;     // position, age
+layout(location = 2) in vec4 aP1;     // velocity, life
+layout(location = 3) in vec4 aP3;     // size start, size end
+layout(location = 4) in vec4 aColor;
+
+uniform mat4 uModelView;
+uniform mat4 uProjection;
+
+out vec4 vColor;
+out vec2 vUV;
+
+void main() {
+    vColor = aColor;
+    vUV = aCorner * 0.5 + 0.5;
+    if (aP0.w >= aP1.w) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);  // Dead: outside the clip volume
+        return;
+    }
+
+    // Camera-facing: the corner offset is applied in view space
+    float size = mix(aP3.x, aP3.y, aP0.w / aP1.w);
+    vec4 viewPos = uModelView * vec4(aP0.xyz, 1.0) + vec4(aCorner * size, 0.0, 0.0);
+    gl_Position = uProjection * viewPos;
+}
+)";
+
+    static constexpr const char* kDrawFragmentGLSL = R"(#version 300 es
+precision mediump float;
+
+in vec4 vColor;
+in vec2 vUV;
+out vec4 fragColor;
+
+void main() {
+    vec2 c = vUV * 2.0 - 1.0;
+    float r2 = dot(c, c);
+    if (r2 > 1.0) discard;
+    fragColor = vec4(vColor.rgb, vColor.a * (1.0 - r2));
+}
+)";
+
+    int mCapacity = 0;
+    ParticleEmitter mEmitter;
+    ParticleForces mForces;
+    BlendMode mBlend = BlendMode::Additive;
+    float mAttractors[kMaxAttractors][4] = {};
+    float mPlanes[kMaxPlanes][4] = {};
+    float mSpheres[kMaxSpheres][4] = {};
+    int mAttractorCount = 0;
+    int mPlaneCount = 0;
+    int mSphereCount = 0;
+    float mRestitution = 0.5f;
+    float mFriction = 0.1f;
+
+    // CPU side of the simulation: time, emission ring and the next step
+    float mParams[kParamRows * 4] = {};
+    float mPendingDt = 0.0f;
+    float mEmitDebt = 0.0f;
+    float mTime = 0.0f;
+    int mBurst = 0;
+    int mCursor = 0;
+    uint32_t mSeed = 1;
+    uint64_t mEmitted = 0;
+    bool mStepPending = false;
+
+    bool mCreated = false;
+    bool mWebGPU = false;  // Which set of resources below exists
+    bool mFailed = false;
+
+    // WebGPU
+    BufferHandle mGpuBuffer;
+    BufferHandle mGpuParams;
+    BufferHandle mGpuQuad;
+    ShaderHandle mGpuShader;
+    ComputePipelineHandle mGpuCompute;
+
+    // WebGL2 (ping-pong: mBuffers[mCurrent] holds the latest state)
+    GLuint mSimProgram = 0;
+    GLuint mDrawProgram = 0;
+    GLint mParamsLocation = -1;
+    GLint mModelViewLocation = -1;
+    GLint mProjectionLocation = -1;
+    GLuint mBuffers[2] = {0, 0};
+    GLuint mSimVaos[2] = {0, 0};
+    GLuint mDrawVaos[2] = {0, 0};
+    GLuint mQuad = 0;
+    GLuint mFeedback = 0;
+    int mCurrent = 0;
+};
+
+} // namespace al
+
+#endif // AL_WEB_PARTICLES_HPP
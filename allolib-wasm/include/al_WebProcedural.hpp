@@ -9,23 +9,52 @@
  *   tex.perlinNoise(512, 512, 4.0f, 6);
  *   tex.uploadToTexture(gpuTexture);
  *
+ *   // Or share one GPU copy between identical textures
+ *   GPUTextureRef shared = tex.acquireTexture();
+ *
  * Or use presets for complete PBR materials:
  *   ProceduralTexture albedo, normal, roughness;
  *   ProceduralPresets::generateBrickPBR(albedo, normal, roughness, ao, 1024);
+ *
+ * The noise generators (perlin/simplex/fbm, worley, marble, woodGrain,
+ * roughnessMap) evaluate four pixels at a time with wasm SIMD128 when built
+ * with -msimd128, bit-identical to the scalar path. They also split their
+ * rows across the JobSystem pool in threaded builds (al_WebJobs.hpp).
+ *
+ * For large textures, ProceduralTextureGPU renders the same generators
+ * straight into a GL texture with a fragment shader (WebGL2). It uses the
+ * same permutation table and Worley cells for a given seed, so output
+ * matches the CPU to within one 8-bit level (GPU sin/sqrt precision):
+ *   ProceduralTextureGPU gpu;
+ *   GLuint id = gpu.createTexture();
+ *   if (!gpu.fbmNoise(id, 2048, 2048, 4.0f, 6)) { ... CPU fallback ... }
  */
 
 #ifndef AL_WEB_PROCEDURAL_HPP
 #define AL_WEB_PROCEDURAL_HPP
 
+#include <string>
 #include <vector>
 #include <cstdint>
 #include <cmath>
 #include <functional>
 #include <random>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/html5.h>
+#endif
 
 // Use allolib's OpenGL header which properly handles GLAD
 #include "al/graphics/al_OpenGL.hpp"
+#include "al_WebJobs.hpp"
+#include "al_WebResourceCache.hpp"
 
 namespace al {
 
@@ -48,6 +77,38 @@ public:
         initPermutation(0);
     }
 
+    /**
+     * Seed the noise generators (default 0). ProceduralTextureGPU with the
+     * same seed produces the same textures.
+     */
+    void setSeed(unsigned int seed) {
+        mSeed = seed;
+        initPermutation(seed);
+    }
+    unsigned int seed() const { return mSeed; }
+
+    /// Permutation table behind the noise for `seed` (256 entries)
+    static std::vector<int> permutation(unsigned int seed) {
+        std::vector<int> p(256);
+        for (int i = 0; i < 256; i++) p[i] = i;
+
+        std::mt19937 rng(seed);
+        std::shuffle(p.begin(), p.end(), rng);
+        return p;
+    }
+
+    /// Worley feature points for `seed`: x0, y0, x1, y1, ... in [0, 1)
+    static std::vector<float> worleyCells(int cellCount, unsigned int seed) {
+        std::vector<float> cells(size_t(std::max(cellCount, 0)) * 2);
+        std::mt19937 rng(42 + seed);
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        for (int i = 0; i < cellCount; i++) {
+            cells[2 * i] = dist(rng);
+            cells[2 * i + 1] = dist(rng);
+        }
+        return cells;
+    }
+
     // ========== Noise Generators ==========
 
     /**
@@ -61,18 +122,23 @@ public:
                      int octaves = 6, float persistence = 0.5f) {
         resize(width, height);
 
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                float nx = (float)x / width * scale;
-                float ny = (float)y / height * scale;
+        forRows(height, [&](int y0, int y1) {
+            std::vector<float> xs(width), ys(width), values(width);
+            for (int y = y0; y < y1; y++) {
+                for (int x = 0; x < width; x++) {
+                    xs[x] = (float)x / width * scale;
+                    ys[x] = (float)y / height * scale;
+                }
+                fbmRow(xs.data(), ys.data(), values.data(), width, octaves, persistence);
 
-                float value = fbm(nx, ny, octaves, persistence);
-                value = (value + 1.0f) * 0.5f;  // Normalize to 0-1
+                for (int x = 0; x < width; x++) {
+                    float value = (values[x] + 1.0f) * 0.5f;  // Normalize to 0-1
 
-                uint8_t v = (uint8_t)(std::clamp(value, 0.0f, 1.0f) * 255);
-                setPixel(x, y, v, v, v, 255);
+                    uint8_t v = (uint8_t)(std::clamp(value, 0.0f, 1.0f) * 255);
+                    setPixel(x, y, v, v, v, 255);
+                }
             }
-        }
+        });
     }
 
     /**
@@ -103,56 +169,41 @@ public:
         resize(width, height);
 
         // Generate random cell centers
-        std::vector<float> cellsX(cellCount), cellsY(cellCount);
-        std::mt19937 rng(42);
-        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-
-        for (int i = 0; i < cellCount; i++) {
-            cellsX[i] = dist(rng);
-            cellsY[i] = dist(rng);
-        }
+        const std::vector<float> cells = worleyCells(cellCount, mSeed);
+
+        forRows(height, [&](int y0, int y1) {
+            std::vector<float> row1(width), row2(width);
+            std::vector<int> rowCell(width);
+            for (int y = y0; y < y1; y++) {
+                const float py = (float)y / height;
+                int x = 0;
+#if defined(__wasm_simd128__)
+                for (; x + 4 <= width; x += 4) {
+                    worley4(cells.data(), cellCount, x, width, py, &row1[x], &row2[x], &rowCell[x]);
+                }
+#endif
+                for (; x < width; x++) {
+                    worley1(cells.data(), cellCount, (float)x / width, py, row1[x], row2[x], rowCell[x]);
+                }
 
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                float px = (float)x / width;
-                float py = (float)y / height;
-
-                // Find two nearest cell centers
-                float d1 = 1000.0f, d2 = 1000.0f;
-                int nearestCell = 0;
-
-                for (int i = 0; i < cellCount; i++) {
-                    // Check 3x3 grid for tiling
-                    for (int ox = -1; ox <= 1; ox++) {
-                        for (int oy = -1; oy <= 1; oy++) {
-                            float cx = cellsX[i] + ox;
-                            float cy = cellsY[i] + oy;
-                            float d = sqrtf((px - cx) * (px - cx) + (py - cy) * (py - cy));
-                            if (d < d1) {
-                                d2 = d1;
-                                d1 = d;
-                                nearestCell = i;
-                            } else if (d < d2) {
-                                d2 = d;
-                            }
-                        }
+                for (x = 0; x < width; x++) {
+                    const float d1 = row1[x], d2 = row2[x];
+                    const int nearestCell = rowCell[x];
+                    float value;
+                    switch (modeInt) {
+                        case 0: value = d1 * 2.0f; break;  // F1
+                        case 1: value = (d2 - d1) * 4.0f; break;  // F2-F1 (edges)
+                        case 2: value = (float)nearestCell / cellCount; break;  // Cell ID
+                        case 3: value = d1 * d2 * 8.0f; break;  // F1*F2
+                        default: value = d1 * 2.0f;
                     }
-                }
 
-                float value;
-                switch (modeInt) {
-                    case 0: value = d1 * 2.0f; break;  // F1
-                    case 1: value = (d2 - d1) * 4.0f; break;  // F2-F1 (edges)
-                    case 2: value = (float)nearestCell / cellCount; break;  // Cell ID
-                    case 3: value = d1 * d2 * 8.0f; break;  // F1*F2
-                    default: value = d1 * 2.0f;
+                    value = std::clamp(value, 0.0f, 1.0f);
+                    uint8_t v = (uint8_t)(value * 255);
+                    setPixel(x, y, v, v, v, 255);
                 }
-
-                value = std::clamp(value, 0.0f, 1.0f);
-                uint8_t v = (uint8_t)(value * 255);
-                setPixel(x, y, v, v, v, 255);
             }
-        }
+        });
     }
 
     // ========== Pattern Generators ==========
@@ -280,24 +331,38 @@ public:
         uint32_t lightWood = 0xFFD4A574;
         uint32_t darkWood = 0xFF8B5A2B;
 
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                float nx = (float)x / width;
-                float ny = (float)y / height;
+        forRows(height, [&](int y0, int y1) {
+            std::vector<float> xs(width), ys(width), ringNoise(width), grainNoise(width);
+            for (int y = y0; y < y1; y++) {
+                const float ny = (float)y / height;
+                for (int x = 0; x < width; x++) {
+                    xs[x] = (float)x / width * grainScale;
+                    ys[x] = ny * grainScale;
+                }
+                fbmRow(xs.data(), ys.data(), ringNoise.data(), width, 4, 0.5f);
+                for (int x = 0; x < width; x++) {
+                    xs[x] = (float)x / width * grainScale * 2;
+                    ys[x] = ny * grainScale * 0.5f;
+                }
+                fbmRow(xs.data(), ys.data(), grainNoise.data(), width, 3, 0.5f);
+
+                for (int x = 0; x < width; x++) {
+                    float nx = (float)x / width;
 
-                // Create ring pattern
-                float dist = sqrtf(nx * nx + ny * ny);
-                float rings = sinf(dist * ringFreq + fbm(nx * grainScale, ny * grainScale, 4, 0.5f) * 3.0f);
-                rings = (rings + 1.0f) * 0.5f;
+                    // Create ring pattern
+                    float dist = sqrtf(nx * nx + ny * ny);
+                    float rings = sinf(dist * ringFreq + ringNoise[x] * 3.0f);
+                    rings = (rings + 1.0f) * 0.5f;
 
-                // Add grain noise
-                float grain = fbm(nx * grainScale * 2, ny * grainScale * 0.5f, 3, 0.5f);
-                grain = (grain + 1.0f) * 0.5f * 0.2f;
+                    // Add grain noise
+                    float grain = grainNoise[x];
+                    grain = (grain + 1.0f) * 0.5f * 0.2f;
 
-                float t = std::clamp(rings + grain, 0.0f, 1.0f);
-                setPixelRGBA(x, y, lerpColor(lightWood, darkWood, t));
+                    float t = std::clamp(rings + grain, 0.0f, 1.0f);
+                    setPixelRGBA(x, y, lerpColor(lightWood, darkWood, t));
+                }
             }
-        }
+        });
     }
 
     /**
@@ -310,18 +375,27 @@ public:
         uint32_t white = 0xFFF0F0F0;
         uint32_t gray = 0xFF404040;
 
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                float nx = (float)x / width * scale;
-                float ny = (float)y / height * scale;
+        forRows(height, [&](int y0, int y1) {
+            std::vector<float> xs(width), ys(width), turbs(width);
+            for (int y = y0; y < y1; y++) {
+                const float ny = (float)y / height * scale;
+                for (int x = 0; x < width; x++) {
+                    xs[x] = (float)x / width * scale * turbulence;
+                    ys[x] = ny * turbulence;
+                }
+                fbmRow(xs.data(), ys.data(), turbs.data(), width, 6, 0.5f);
+
+                for (int x = 0; x < width; x++) {
+                    float nx = (float)x / width * scale;
 
-                float turb = fbm(nx * turbulence, ny * turbulence, 6, 0.5f);
-                float value = sinf(nx * 10.0f + turb * 5.0f);
-                value = (value + 1.0f) * 0.5f;
+                    float turb = turbs[x];
+                    float value = sinf(nx * 10.0f + turb * 5.0f);
+                    value = (value + 1.0f) * 0.5f;
 
-                setPixelRGBA(x, y, lerpColor(white, gray, value));
+                    setPixelRGBA(x, y, lerpColor(white, gray, value));
+                }
             }
-        }
+        });
     }
 
     // ========== PBR Map Generation ==========
@@ -332,17 +406,29 @@ public:
      */
     void normalMapFromHeight(int width, int height, float strength = 1.0f) {
         // Assumes current data is height map (grayscale)
-        if (mPixels.empty()) return;
-
-        std::vector<uint8_t> original = mPixels;
+        if (mPixels.empty() || (size_t)width * height * 4 > mPixels.size()) return;
+
+        // In place: keep the heights of the first, previous and current rows,
+        // which are overwritten before their last read
+        mScratch.resize((size_t)width * 3);
+        uint8_t* first = mScratch.data();
+        uint8_t* prev = first + width;
+        uint8_t* cur = prev + width;
+        grayRow(first, 0, width);
+        grayRow(prev, height - 1, width);
+        std::copy(first, first + width, cur);
 
         for (int y = 0; y < height; y++) {
+            const uint8_t* below = nullptr;
+            if (y + 1 < height) {
+                below = &mPixels[(size_t)(y + 1) * width * 4];
+            }
             for (int x = 0; x < width; x++) {
                 // Sample neighbors (with wrapping)
-                float l = getGray(original, (x - 1 + width) % width, y, width);
-                float r = getGray(original, (x + 1) % width, y, width);
-                float t = getGray(original, x, (y - 1 + height) % height, width);
-                float b = getGray(original, x, (y + 1) % height, width);
+                float l = cur[(x - 1 + width) % width] / 255.0f;
+                float r = cur[(x + 1) % width] / 255.0f;
+                float t = prev[x] / 255.0f;
+                float b = (below ? below[x * 4] : first[x]) / 255.0f;
 
                 // Calculate normal
                 float dx = (r - l) * strength;
@@ -362,6 +448,10 @@ public:
 
                 setPixel(x, y, nx, ny, nz, 255);
             }
+            std::swap(prev, cur);
+            if (below) {
+                for (int x = 0; x < width; x++) cur[x] = below[x * 4];
+            }
         }
     }
 
@@ -372,19 +462,25 @@ public:
                       float variation = 0.3f) {
         resize(width, height);
 
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                float nx = (float)x / width * 8.0f;
-                float ny = (float)y / height * 8.0f;
+        forRows(height, [&](int y0, int y1) {
+            std::vector<float> xs(width), ys(width), noises(width);
+            for (int y = y0; y < y1; y++) {
+                for (int x = 0; x < width; x++) {
+                    xs[x] = (float)x / width * 8.0f;
+                    ys[x] = (float)y / height * 8.0f;
+                }
+                fbmRow(xs.data(), ys.data(), noises.data(), width, 4, 0.5f);
 
-                float noise = fbm(nx, ny, 4, 0.5f);
-                float value = baseRoughness + noise * variation;
-                value = std::clamp(value, 0.0f, 1.0f);
+                for (int x = 0; x < width; x++) {
+                    float noise = noises[x];
+                    float value = baseRoughness + noise * variation;
+                    value = std::clamp(value, 0.0f, 1.0f);
 
-                uint8_t v = (uint8_t)(value * 255);
-                setPixel(x, y, v, v, v, 255);
+                    uint8_t v = (uint8_t)(value * 255);
+                    setPixel(x, y, v, v, v, 255);
+                }
             }
-        }
+        });
     }
 
     // ========== Effects ==========
@@ -395,34 +491,41 @@ public:
     void applySeamless() {
         if (mPixels.empty()) return;
 
-        std::vector<uint8_t> original = mPixels;
-        int blendWidth = mWidth / 4;
-
-        for (int y = 0; y < mHeight; y++) {
-            for (int x = 0; x < mWidth; x++) {
-                float bx = 1.0f, by = 1.0f;
-
-                // Horizontal blend
-                if (x < blendWidth) {
-                    bx = (float)x / blendWidth;
-                } else if (x >= mWidth - blendWidth) {
-                    bx = (float)(mWidth - x) / blendWidth;
-                }
-
-                // Vertical blend
-                if (y < blendWidth) {
-                    by = (float)y / blendWidth;
-                } else if (y >= mHeight - blendWidth) {
-                    by = (float)(mHeight - y) / blendWidth;
+        const int w = mWidth, h = mHeight;
+        if (w % 2 == 0 && h % 2 == 0) {
+            // Each pixel blends with the one half a tile away, and that one
+            // with it: update both of a pair at once, in place
+            for (int y = 0; y < h / 2; y++) {
+                for (int x = 0; x < w; x++) {
+                    const int ox = (x + w / 2) % w;
+                    const int oy = y + h / 2;
+                    const float blend1 = seamlessBlend(x, y);
+                    const float blend2 = seamlessBlend(ox, oy);
+                    if (blend1 >= 1.0f && blend2 >= 1.0f) continue;
+                    uint8_t* p1 = &mPixels[((size_t)y * w + x) * 4];
+                    uint8_t* p2 = &mPixels[((size_t)oy * w + ox) * 4];
+                    for (int c = 0; c < 4; c++) {
+                        const uint8_t a = p1[c], b = p2[c];
+                        if (blend1 < 1.0f) p1[c] = (uint8_t)(a * blend1 + b * (1.0f - blend1));
+                        if (blend2 < 1.0f) p2[c] = (uint8_t)(b * blend2 + a * (1.0f - blend2));
+                    }
                 }
+            }
+            return;
+        }
 
-                float blend = std::min(bx, by);
+        // Odd sizes: partners don't pair up, read from a copy
+        mScratch.assign(mPixels.begin(), mPixels.end());
+        const std::vector<uint8_t>& original = mScratch;
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                float blend = seamlessBlend(x, y);
                 if (blend < 1.0f) {
-                    int ox = (x + mWidth / 2) % mWidth;
-                    int oy = (y + mHeight / 2) % mHeight;
+                    int ox = (x + w / 2) % w;
+                    int oy = (y + h / 2) % h;
 
-                    size_t idx1 = (y * mWidth + x) * 4;
-                    size_t idx2 = (oy * mWidth + ox) * 4;
+                    size_t idx1 = ((size_t)y * w + x) * 4;
+                    size_t idx2 = ((size_t)oy * w + ox) * 4;
 
                     for (int c = 0; c < 4; c++) {
                         mPixels[idx1 + c] = (uint8_t)(
@@ -436,61 +539,55 @@ public:
     }
 
     /**
-     * Apply Gaussian blur
+     * Box blur, `passes` times (2 = the default tent-like falloff).
+     * Sliding-window sums with wrap-around: cost per pixel does not
+     * depend on the radius.
      */
-    void applyBlur(int radius) {
+    void applyBlur(int radius, int passes = 2) {
         if (mPixels.empty() || radius <= 0) return;
+        for (int pass = 0; pass < passes; pass++) boxBlur(radius);
+    }
 
-        std::vector<uint8_t> temp = mPixels;
-
-        // Simple box blur (faster approximation)
-        for (int pass = 0; pass < 2; pass++) {
-            // Horizontal
-            for (int y = 0; y < mHeight; y++) {
-                for (int x = 0; x < mWidth; x++) {
-                    int r = 0, g = 0, b = 0, a = 0, count = 0;
-                    for (int dx = -radius; dx <= radius; dx++) {
-                        int sx = (x + dx + mWidth) % mWidth;
-                        size_t idx = (y * mWidth + sx) * 4;
-                        r += temp[idx];
-                        g += temp[idx + 1];
-                        b += temp[idx + 2];
-                        a += temp[idx + 3];
-                        count++;
-                    }
-                    size_t idx = (y * mWidth + x) * 4;
-                    mPixels[idx] = r / count;
-                    mPixels[idx + 1] = g / count;
-                    mPixels[idx + 2] = b / count;
-                    mPixels[idx + 3] = a / count;
-                }
-            }
-            temp = mPixels;
-
-            // Vertical
-            for (int y = 0; y < mHeight; y++) {
-                for (int x = 0; x < mWidth; x++) {
-                    int r = 0, g = 0, b = 0, a = 0, count = 0;
-                    for (int dy = -radius; dy <= radius; dy++) {
-                        int sy = (y + dy + mHeight) % mHeight;
-                        size_t idx = (sy * mWidth + x) * 4;
-                        r += temp[idx];
-                        g += temp[idx + 1];
-                        b += temp[idx + 2];
-                        a += temp[idx + 3];
-                        count++;
-                    }
-                    size_t idx = (y * mWidth + x) * 4;
-                    mPixels[idx] = r / count;
-                    mPixels[idx + 1] = g / count;
-                    mPixels[idx + 2] = b / count;
-                    mPixels[idx + 3] = a / count;
-                }
-            }
-            temp = mPixels;
+    /**
+     * Gaussian blur of standard deviation `sigma` pixels, approximated by
+     * three box blurs of matched radii; cost independent of sigma
+     */
+    void applyGaussianBlur(float sigma) {
+        if (mPixels.empty() || sigma <= 0.0f) return;
+        // Box widths whose three-fold convolution has variance sigma^2
+        // (Kovesi, "Fast almost-Gaussian filtering")
+        const int n = 3;
+        const float ideal = sqrtf(12.0f * sigma * sigma / n + 1.0f);
+        int wl = (int)floorf(ideal);
+        if (wl % 2 == 0) wl--;
+        const int wu = wl + 2;
+        const float mIdeal = (12.0f * sigma * sigma - n * wl * wl - 4.0f * n * wl - 3.0f * n) /
+                             (-4.0f * wl - 4.0f);
+        const int m = (int)roundf(mIdeal);
+        for (int i = 0; i < n; i++) {
+            const int r = ((i < m ? wl : wu) - 1) / 2;
+            if (r > 0) boxBlur(r);
         }
     }
 
+    /**
+     * Post-process steps run in order, in place, sharing one scratch buffer
+     */
+    struct PostProcess {
+        bool seamless = false;      // applySeamless()
+        int blurRadius = 0;         // applyBlur(blurRadius, blurPasses) when > 0
+        int blurPasses = 2;
+        float blurSigma = 0.0f;     // applyGaussianBlur(blurSigma) when > 0
+        float normalStrength = 0.0f;  // normalMapFromHeight(strength) last, when > 0
+    };
+
+    void applyPostProcess(const PostProcess& steps) {
+        if (steps.seamless) applySeamless();
+        if (steps.blurRadius > 0) applyBlur(steps.blurRadius, steps.blurPasses);
+        if (steps.blurSigma > 0.0f) applyGaussianBlur(steps.blurSigma);
+        if (steps.normalStrength > 0.0f) normalMapFromHeight(mWidth, mHeight, steps.normalStrength);
+    }
+
     /**
      * Custom procedural with callback
      */
@@ -541,10 +638,37 @@ public:
         return texId;
     }
 
+    /**
+     * Texture shared through GPUResourceCache, keyed by the pixel content:
+     * identical textures (same generator and parameters) upload once.
+     * Freed when the last reference is dropped.
+     */
+    GPUTextureRef acquireTexture() {
+        std::string key = GPUResourceCache::contentKey(mPixels.data(), mPixels.size(), "proc:") +
+                          ":" + std::to_string(mWidth) + "x" + std::to_string(mHeight);
+        return GPUResourceCache::instance().acquire(key, [this](GPUTexture& t) {
+            glGenTextures(1, &t.id);
+            uploadToTexture(t.id);
+            t.width = mWidth;
+            t.height = mHeight;
+            t.bytes = (size_t)mWidth * mHeight * 4 * 4 / 3;
+            return true;
+        });
+    }
+
 private:
     std::vector<uint8_t> mPixels;
     int mWidth, mHeight, mChannels;
+    unsigned int mSeed = 0;
     std::vector<int> mPerm;
+    std::vector<uint8_t> mScratch;  // Shared by the post-process steps
+
+    // Rows [y0, y1) in parallel chunks; the generators only read shared
+    // state (permutation table, cells) and write their own rows
+    template <typename F>
+    void forRows(int height, F&& rows) {
+        JobSystem::instance().parallelFor(0, height, 16, rows);
+    }
 
     void resize(int w, int h) {
         mWidth = w;
@@ -568,9 +692,78 @@ private:
                  (rgba >> 24) & 0xFF);
     }
 
-    float getGray(const std::vector<uint8_t>& data, int x, int y, int w) {
-        size_t idx = (y * w + x) * 4;
-        return data[idx] / 255.0f;
+    // Red channel of row y
+    void grayRow(uint8_t* out, int y, int w) const {
+        const uint8_t* row = &mPixels[(size_t)y * w * 4];
+        for (int x = 0; x < w; x++) out[x] = row[x * 4];
+    }
+
+    // applySeamless weight of the pixel itself (1 = untouched)
+    float seamlessBlend(int x, int y) const {
+        const int blendWidth = mWidth / 4;
+        float bx = 1.0f, by = 1.0f;
+
+        // Horizontal blend
+        if (x < blendWidth) {
+            bx = (float)x / blendWidth;
+        } else if (x >= mWidth - blendWidth) {
+            bx = (float)(mWidth - x) / blendWidth;
+        }
+
+        // Vertical blend
+        if (y < blendWidth) {
+            by = (float)y / blendWidth;
+        } else if (y >= mHeight - blendWidth) {
+            by = (float)(mHeight - y) / blendWidth;
+        }
+
+        return std::min(bx, by);
+    }
+
+    // One horizontal and one vertical box pass of the given radius
+    void boxBlur(int radius) {
+        mScratch.resize((size_t)std::max(mWidth, mHeight) * 4);
+        for (int y = 0; y < mHeight; y++) {
+            boxLine(&mPixels[(size_t)y * mWidth * 4], mWidth, 4, radius);
+        }
+        for (int x = 0; x < mWidth; x++) {
+            boxLine(&mPixels[(size_t)x * 4], mHeight, (size_t)mWidth * 4, radius);
+        }
+    }
+
+    // Box-filter n RGBA pixels `stride` bytes apart, wrapping around
+    void boxLine(uint8_t* data, int n, size_t stride, int radius) {
+        uint8_t* line = mScratch.data();
+        for (int i = 0; i < n; i++) {
+            std::memcpy(line + i * 4, data + i * stride, 4);
+        }
+
+        // Window of 2r+1 taps starting at -r: whole laps of the line, then the rest
+        const int taps = 2 * radius + 1;
+        int sum[4] = {0, 0, 0, 0};
+        const int laps = taps / n;
+        if (laps > 0) {
+            for (int i = 0; i < n; i++) {
+                for (int c = 0; c < 4; c++) sum[c] += line[i * 4 + c];
+            }
+            for (int c = 0; c < 4; c++) sum[c] *= laps;
+        }
+        int tail = ((-radius) % n + n) % n;  // Oldest tap in the window
+        for (int k = 0, i = tail; k < taps % n; k++) {
+            for (int c = 0; c < 4; c++) sum[c] += line[i * 4 + c];
+            if (++i == n) i = 0;
+        }
+        int head = (radius + 1) % n;  // Next tap to enter
+
+        for (int i = 0; i < n; i++) {
+            uint8_t* out = data + i * stride;
+            for (int c = 0; c < 4; c++) {
+                out[c] = (uint8_t)(sum[c] / taps);
+                sum[c] += line[head * 4 + c] - line[tail * 4 + c];
+            }
+            if (++head == n) head = 0;
+            if (++tail == n) tail = 0;
+        }
     }
 
     uint32_t lerpColor(uint32_t c1, uint32_t c2, float t) {
@@ -592,11 +785,7 @@ private:
     // Perlin noise helpers
     void initPermutation(unsigned int seed) {
         mPerm.resize(512);
-        std::vector<int> p(256);
-        for (int i = 0; i < 256; i++) p[i] = i;
-
-        std::mt19937 rng(seed);
-        std::shuffle(p.begin(), p.end(), rng);
+        const std::vector<int> p = permutation(seed);
 
         for (int i = 0; i < 256; i++) {
             mPerm[i] = mPerm[i + 256] = p[i];
@@ -653,9 +842,587 @@ private:
 
         return total / maxValue;
     }
+
+    // out[i] = fbm(xs[i], ys[i]), four at a time where SIMD is available
+    void fbmRow(const float* xs, const float* ys, float* out, int n,
+                int octaves, float persistence) {
+        int i = 0;
+#if defined(__wasm_simd128__)
+        for (; i + 4 <= n; i += 4) {
+            wasm_v128_store(out + i, fbm4(wasm_v128_load(xs + i), wasm_v128_load(ys + i),
+                                          octaves, persistence));
+        }
+#endif
+        for (; i < n; i++) out[i] = fbm(xs[i], ys[i], octaves, persistence);
+    }
+
+    // Nearest and second-nearest distance to the tiled cells, and the nearest cell
+    static void worley1(const float* cells, int cellCount, float px, float py,
+                        float& d1, float& d2, int& nearestCell) {
+        d1 = 1000.0f;
+        d2 = 1000.0f;
+        nearestCell = 0;
+        for (int i = 0; i < cellCount; i++) {
+            // Check 3x3 grid for tiling
+            for (int ox = -1; ox <= 1; ox++) {
+                for (int oy = -1; oy <= 1; oy++) {
+                    float cx = cells[2 * i] + ox;
+                    float cy = cells[2 * i + 1] + oy;
+                    float d = sqrtf((px - cx) * (px - cx) + (py - cy) * (py - cy));
+                    if (d < d1) {
+                        d2 = d1;
+                        d1 = d;
+                        nearestCell = i;
+                    } else if (d < d2) {
+                        d2 = d;
+                    }
+                }
+            }
+        }
+    }
+
+#if defined(__wasm_simd128__)
+    // The scalar helpers above on four lanes, operation for operation, so
+    // results are bit-identical. Permutation lookups stay scalar (no gather).
+
+    static v128_t fade4(v128_t t) {
+        const v128_t t3 = wasm_f32x4_mul(wasm_f32x4_mul(t, t), t);
+        v128_t k = wasm_f32x4_sub(wasm_f32x4_mul(t, wasm_f32x4_splat(6.0f)), wasm_f32x4_splat(15.0f));
+        k = wasm_f32x4_add(wasm_f32x4_mul(t, k), wasm_f32x4_splat(10.0f));
+        return wasm_f32x4_mul(t3, k);
+    }
+
+    static v128_t lerp4(v128_t a, v128_t b, v128_t t) {
+        return wasm_f32x4_add(a, wasm_f32x4_mul(t, wasm_f32x4_sub(b, a)));
+    }
+
+    static v128_t grad4(v128_t hash, v128_t x, v128_t y) {
+        const v128_t h = wasm_v128_and(hash, wasm_i32x4_splat(7));
+        const v128_t low = wasm_i32x4_lt(h, wasm_i32x4_splat(4));
+        const v128_t u = wasm_v128_bitselect(x, y, low);
+        const v128_t v = wasm_v128_bitselect(y, x, low);
+        const v128_t negU = wasm_i32x4_ne(wasm_v128_and(h, wasm_i32x4_splat(1)), wasm_i32x4_splat(0));
+        const v128_t negV = wasm_i32x4_ne(wasm_v128_and(h, wasm_i32x4_splat(2)), wasm_i32x4_splat(0));
+        const v128_t v2 = wasm_f32x4_mul(wasm_f32x4_splat(2.0f), v);
+        return wasm_f32x4_add(wasm_v128_bitselect(wasm_f32x4_neg(u), u, negU),
+                              wasm_v128_bitselect(wasm_f32x4_neg(v2), v2, negV));
+    }
+
+    v128_t perlin4(v128_t x, v128_t y) const {
+        const v128_t fx = wasm_f32x4_floor(x);
+        const v128_t fy = wasm_f32x4_floor(y);
+        const v128_t mask = wasm_i32x4_splat(255);
+        alignas(16) int X[4], Y[4];
+        wasm_v128_store(X, wasm_v128_and(wasm_i32x4_trunc_sat_f32x4(fx), mask));
+        wasm_v128_store(Y, wasm_v128_and(wasm_i32x4_trunc_sat_f32x4(fy), mask));
+
+        x = wasm_f32x4_sub(x, fx);
+        y = wasm_f32x4_sub(y, fy);
+        const v128_t u = fade4(x);
+        const v128_t v = fade4(y);
+
+        alignas(16) int hAA[4], hBA[4], hAB[4], hBB[4];
+        for (int l = 0; l < 4; l++) {
+            const int A = mPerm[X[l]] + Y[l];
+            const int B = mPerm[X[l] + 1] + Y[l];
+            hAA[l] = mPerm[A];
+            hBA[l] = mPerm[B];
+            hAB[l] = mPerm[A + 1];
+            hBB[l] = mPerm[B + 1];
+        }
+
+        const v128_t one = wasm_f32x4_splat(1.0f);
+        const v128_t x1 = wasm_f32x4_sub(x, one);
+        const v128_t y1 = wasm_f32x4_sub(y, one);
+        return lerp4(
+            lerp4(grad4(wasm_v128_load(hAA), x, y), grad4(wasm_v128_load(hBA), x1, y), u),
+            lerp4(grad4(wasm_v128_load(hAB), x, y1), grad4(wasm_v128_load(hBB), x1, y1), u),
+            v);
+    }
+
+    v128_t fbm4(v128_t x, v128_t y, int octaves, float persistence) const {
+        v128_t total = wasm_f32x4_splat(0.0f);
+        float amplitude = 1;
+        float frequency = 1;
+        float maxValue = 0;
+
+        for (int i = 0; i < octaves; i++) {
+            const v128_t f = wasm_f32x4_splat(frequency);
+            const v128_t p = perlin4(wasm_f32x4_mul(x, f), wasm_f32x4_mul(y, f));
+            total = wasm_f32x4_add(total, wasm_f32x4_mul(p, wasm_f32x4_splat(amplitude)));
+            maxValue += amplitude;
+            amplitude *= persistence;
+            frequency *= 2;
+        }
+
+        return wasm_f32x4_div(total, wasm_f32x4_splat(maxValue));
+    }
+
+    // worley1 for pixels x .. x + 3 of a row
+    static void worley4(const float* cells, int cellCount, int x, int width, float py,
+                        float* d1Out, float* d2Out, int* cellOut) {
+        const v128_t px = wasm_f32x4_make((float)x / width, (float)(x + 1) / width,
+                                          (float)(x + 2) / width, (float)(x + 3) / width);
+        const v128_t vpy = wasm_f32x4_splat(py);
+        v128_t d1 = wasm_f32x4_splat(1000.0f);
+        v128_t d2 = d1;
+        v128_t nearest = wasm_i32x4_splat(0);
+        for (int i = 0; i < cellCount; i++) {
+            const v128_t cell = wasm_i32x4_splat(i);
+            for (int ox = -1; ox <= 1; ox++) {
+                for (int oy = -1; oy <= 1; oy++) {
+                    const v128_t dx = wasm_f32x4_sub(px, wasm_f32x4_splat(cells[2 * i] + ox));
+                    const v128_t dy = wasm_f32x4_sub(vpy, wasm_f32x4_splat(cells[2 * i + 1] + oy));
+                    const v128_t d = wasm_f32x4_sqrt(
+                        wasm_f32x4_add(wasm_f32x4_mul(dx, dx), wasm_f32x4_mul(dy, dy)));
+                    const v128_t closer = wasm_f32x4_lt(d, d1);
+                    const v128_t second = wasm_f32x4_lt(d, d2);
+                    d2 = wasm_v128_bitselect(d1, wasm_v128_bitselect(d, d2, second), closer);
+                    d1 = wasm_v128_bitselect(d, d1, closer);
+                    nearest = wasm_v128_bitselect(cell, nearest, closer);
+                }
+            }
+        }
+        wasm_v128_store(d1Out, d1);
+        wasm_v128_store(d2Out, d2);
+        wasm_v128_store(cellOut, nearest);
+    }
+#endif
 };
 
 
+/**
+ * Fragment-shader backend for ProceduralTexture's noise generators
+ *
+ * Each generator (re)allocates `texture` as RGBA8 width x height, renders
+ * the pattern into it through a framebuffer, builds mipmaps and sets the
+ * same sampling parameters as ProceduralTexture::uploadToTexture. The GL
+ * state it touches is restored afterwards. Returns false without a WebGL2
+ * context or if the shader fails; the caller then falls back to the CPU.
+ */
+class ProceduralTextureGPU {
+public:
+    explicit ProceduralTextureGPU(unsigned int seed = 0) : mSeed(seed) {}
+
+    ~ProceduralTextureGPU() {
+        if (!mCreated) return;
+        for (GLuint program : mPrograms) {
+            if (program) glDeleteProgram(program);
+        }
+        glDeleteTextures(1, &mPermTexture);
+        glDeleteTextures(1, &mCellTexture);
+        glDeleteFramebuffers(1, &mFbo);
+        glDeleteVertexArrays(1, &mEmptyVao);
+    }
+
+    ProceduralTextureGPU(const ProceduralTextureGPU&) = delete;
+    ProceduralTextureGPU& operator=(const ProceduralTextureGPU&) = delete;
+
+    /// Same meaning as ProceduralTexture::setSeed
+    void setSeed(unsigned int seed) {
+        if (seed == mSeed) return;
+        mSeed = seed;
+        mPermUploaded = false;
+        mCellCount = -1;
+    }
+    unsigned int seed() const { return mSeed; }
+
+    /// A WebGL2 context is current
+    static bool available() {
+#ifdef __EMSCRIPTEN__
+        return emscripten_webgl_get_current_context() != 0;
+#else
+        return true;
+#endif
+    }
+
+    /// A texture name to generate into
+    GLuint createTexture() {
+        GLuint tex = 0;
+        glGenTextures(1, &tex);
+        return tex;
+    }
+
+    bool perlinNoise(GLuint texture, int width, int height, float scale = 4.0f,
+                     int octaves = 6, float persistence = 0.5f) {
+        if (!begin(Kind::Perlin, width, height)) return false;
+        uniform("scale", scale);
+        uniform("persistence", persistence);
+        uniform("octaves", octaves);
+        return end(texture, width, height);
+    }
+
+    bool simplexNoise(GLuint texture, int width, int height, float scale = 4.0f,
+                      int octaves = 6, float persistence = 0.5f) {
+        return perlinNoise(texture, width, height, scale, octaves, persistence);
+    }
+
+    bool fbmNoise(GLuint texture, int width, int height, float scale = 4.0f,
+                  int octaves = 6, float persistence = 0.5f) {
+        return perlinNoise(texture, width, height, scale, octaves, persistence);
+    }
+
+    bool worleyNoise(GLuint texture, int width, int height, int cellCount = 16,
+                     WorleyMode mode = WorleyMode::F1) {
+        if (cellCount < 1 || !begin(Kind::Worley, width, height)) return false;
+        if (cellCount != mCellCount) {
+            const std::vector<float> cells = ProceduralTexture::worleyCells(cellCount, mSeed);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, mCellTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, cellCount, 1, 0, GL_RG, GL_FLOAT, cells.data());
+            mCellCount = cellCount;
+        }
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, mCellTexture);
+        glActiveTexture(GL_TEXTURE0);
+        uniform("cellCount", cellCount);
+        uniform("mode", static_cast<int>(mode));
+        return end(texture, width, height);
+    }
+
+    bool marble(GLuint texture, int width, int height,
+                float scale = 3.0f, float turbulence = 5.0f) {
+        if (!begin(Kind::Marble, width, height)) return false;
+        uniform("scale", scale);
+        uniform("turbulence", turbulence);
+        return end(texture, width, height);
+    }
+
+    bool woodGrain(GLuint texture, int width, int height,
+                   float grainScale = 10.0f, float ringFreq = 20.0f) {
+        if (!begin(Kind::Wood, width, height)) return false;
+        uniform("grainScale", grainScale);
+        uniform("ringFreq", ringFreq);
+        return end(texture, width, height);
+    }
+
+private:
+    enum class Kind { Perlin, Worley, Marble, Wood, Count };
+
+    // GL state saved by begin() and restored by end()
+    struct SavedState {
+        GLint framebuffer = 0, program = 0, vao = 0, activeTexture = 0;
+        GLint texture0 = 0, texture1 = 0;
+        GLint viewport[4] = {0, 0, 0, 0};
+        GLboolean depthTest = GL_FALSE, blend = GL_FALSE, cull = GL_FALSE, scissor = GL_FALSE;
+    };
+
+    bool begin(Kind kind, int width, int height) {
+        if (width <= 0 || height <= 0 || !available()) return false;
+        if (!mCreated) create();
+        GLuint& program = mPrograms[static_cast<int>(kind)];
+        if (!program && !mFailed[static_cast<int>(kind)]) {
+            program = link(kind);
+            mFailed[static_cast<int>(kind)] = !program;
+        }
+        if (!program) return false;
+
+        SavedState& s = mSaved;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &s.framebuffer);
+        glGetIntegerv(GL_VIEWPORT, s.viewport);
+        glGetIntegerv(GL_CURRENT_PROGRAM, &s.program);
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &s.vao);
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &s.activeTexture);
+        glActiveTexture(GL_TEXTURE1);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &s.texture1);
+        glActiveTexture(GL_TEXTURE0);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &s.texture0);
+        s.depthTest = glIsEnabled(GL_DEPTH_TEST);
+        s.blend = glIsEnabled(GL_BLEND);
+        s.cull = glIsEnabled(GL_CULL_FACE);
+        s.scissor = glIsEnabled(GL_SCISSOR_TEST);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_BLEND);
+        glDisable(GL_CULL_FACE);
+        glDisable(GL_SCISSOR_TEST);
+
+        if (!mPermUploaded) {
+            const std::vector<int> p = ProceduralTexture::permutation(mSeed);
+            uint8_t bytes[256];
+            for (int i = 0; i < 256; i++) bytes[i] = (uint8_t)p[i];
+            glBindTexture(GL_TEXTURE_2D, mPermTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, 256, 1, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, bytes);
+            mPermUploaded = true;
+        }
+        glBindTexture(GL_TEXTURE_2D, mPermTexture);
+
+        mProgram = program;
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "perm"), 0);
+        glUniform1i(glGetUniformLocation(program, "cells"), 1);
+        glUniform2f(glGetUniformLocation(program, "size"), (float)width, (float)height);
+        return true;
+    }
+
+    bool end(GLuint texture, int width, int height) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, mFbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+        const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        if (complete) {
+            // The permutation table stays on unit 0 until the draw
+            glBindTexture(GL_TEXTURE_2D, mPermTexture);
+            glViewport(0, 0, width, height);
+            glBindVertexArray(mEmptyVao);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        } else {
+            printf("[ProceduralTextureGPU] %dx%d RGBA8 target is not renderable\n", width, height);
+        }
+
+        const SavedState& s = mSaved;
+        glBindFramebuffer(GL_FRAMEBUFFER, s.framebuffer);
+        glViewport(s.viewport[0], s.viewport[1], s.viewport[2], s.viewport[3]);
+        glUseProgram(s.program);
+        glBindVertexArray(s.vao);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, s.texture1);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, s.texture0);
+        glActiveTexture(s.activeTexture);
+        if (s.depthTest) glEnable(GL_DEPTH_TEST);
+        if (s.blend) glEnable(GL_BLEND);
+        if (s.cull) glEnable(GL_CULL_FACE);
+        if (s.scissor) glEnable(GL_SCISSOR_TEST);
+        return complete;
+    }
+
+    void uniform(const char* name, float v) { glUniform1f(glGetUniformLocation(mProgram, name), v); }
+    void uniform(const char* name, int v) { glUniform1i(glGetUniformLocation(mProgram, name), v); }
+
+    void create() {
+        mCreated = true;
+        glGenFramebuffers(1, &mFbo);
+        glGenVertexArrays(1, &mEmptyVao);  // Fullscreen triangle from gl_VertexID
+        GLuint tables[2];
+        glGenTextures(2, tables);
+        mPermTexture = tables[0];
+        mCellTexture = tables[1];
+        for (GLuint tex : tables) {
+            glBindTexture(GL_TEXTURE_2D, tex);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    static GLuint compile(GLenum type, const char* src) {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &src, nullptr);
+        glCompileShader(shader);
+        GLint ok = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        if (!ok) {
+            char log[512];
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            printf("[ProceduralTextureGPU] Shader compile error: %s\n", log);
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    static GLuint link(Kind kind) {
+        static const char* bodies[] = {kPerlinFrag, kWorleyFrag, kMarbleFrag, kWoodFrag};
+        const std::string frag = std::string(kCommonFrag) + bodies[static_cast<int>(kind)];
+        GLuint vs = compile(GL_VERTEX_SHADER, kFullscreenVert);
+        GLuint fs = compile(GL_FRAGMENT_SHADER, frag.c_str());
+        GLuint program = 0;
+        if (vs && fs) {
+            program = glCreateProgram();
+            glAttachShader(program, vs);
+            glAttachShader(program, fs);
+            glLinkProgram(program);
+            GLint ok = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &ok);
+            if (!ok) {
+                char log[512];
+                glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+                printf("[ProceduralTextureGPU] Program link error: %s\n", log);
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+        return program;
+    }
+
+    static constexpr const char* kFullscreenVert = R"(#version 300 es
+void main() {
+    vec2 p = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+    // The scalar CPU helpers, written out in the same order of operations.
+    // Outputs are quantized the way the CPU truncates to 8 bits.
+    static constexpr const char* kCommonFrag = R"(#version 300 es
+precision highp float;
+precision highp int;
+precision highp usampler2D;
+
+uniform usampler2D perm;
+uniform vec2 size;
+
+out vec4 fragColor;
+
+int P(int i) { return int(texelFetch(perm, ivec2(i & 255, 0), 0).r); }
+
+float fade(float t) { return t * t * t * (t * (t * 6.0 - 15.0) + 10.0); }
+float lerp(float a, float b, float t) { return a + t * (b - a); }
+
+float grad(int hash, float x, float y) {
+    int h = hash & 7;
+    float u = h < 4 ? x : y;
+    float v = h < 4 ? y : x;
+    return ((h & 1) != 0 ? -u : u) + ((h & 2) != 0 ? -2.0 * v : 2.0 * v);
+}
+
+float perlin2D(float x, float y) {
+    float fx = floor(x);
+    float fy = floor(y);
+    int X = int(fx) & 255;
+    int Y = int(fy) & 255;
+    x -= fx;
+    y -= fy;
+    float u = fade(x);
+    float v = fade(y);
+    int A = P(X) + Y;
+    int B = P(X + 1) + Y;
+    return lerp(lerp(grad(P(A), x, y), grad(P(B), x - 1.0, y), u),
+                lerp(grad(P(A + 1), x, y - 1.0), grad(P(B + 1), x - 1.0, y - 1.0), u), v);
+}
+
+float fbm(float x, float y, int octaves, float persistence) {
+    float total = 0.0;
+    float amplitude = 1.0;
+    float frequency = 1.0;
+    float maxValue = 0.0;
+    for (int i = 0; i < octaves; i++) {
+        total += perlin2D(x * frequency, y * frequency) * amplitude;
+        maxValue += amplitude;
+        amplitude *= persistence;
+        frequency *= 2.0;
+    }
+    return total / maxValue;
+}
+
+// CPU pixel (x, y); row 0 is the first row uploaded
+vec2 pixel() { return floor(gl_FragCoord.xy); }
+
+float level(float v) { return floor(clamp(v, 0.0, 1.0) * 255.0) / 255.0; }
+
+// lerpColor of two 0xAARRGGBB colors given as 0-255 channels
+vec4 lerpColor(vec4 c1, vec4 c2, float t) { return floor(c1 + (c2 - c1) * t) / 255.0; }
+)";
+
+    static constexpr const char* kPerlinFrag = R"(
+uniform float scale;
+uniform float persistence;
+uniform int octaves;
+
+void main() {
+    vec2 p = pixel();
+    float value = fbm(p.x / size.x * scale, p.y / size.y * scale, octaves, persistence);
+    float v = level((value + 1.0) * 0.5);
+    fragColor = vec4(v, v, v, 1.0);
+}
+)";
+
+    static constexpr const char* kWorleyFrag = R"(
+uniform sampler2D cells;
+uniform int cellCount;
+uniform int mode;
+
+void main() {
+    vec2 p = pixel();
+    float px = p.x / size.x;
+    float py = p.y / size.y;
+    float d1 = 1000.0, d2 = 1000.0;
+    int nearestCell = 0;
+    for (int i = 0; i < cellCount; i++) {
+        vec2 c = texelFetch(cells, ivec2(i, 0), 0).xy;
+        for (int ox = -1; ox <= 1; ox++) {
+            for (int oy = -1; oy <= 1; oy++) {
+                float cx = c.x + float(ox);
+                float cy = c.y + float(oy);
+                float d = sqrt((px - cx) * (px - cx) + (py - cy) * (py - cy));
+                if (d < d1) {
+                    d2 = d1;
+                    d1 = d;
+                    nearestCell = i;
+                } else if (d < d2) {
+                    d2 = d;
+                }
+            }
+        }
+    }
+    float value;
+    if (mode == 1) value = (d2 - d1) * 4.0;
+    else if (mode == 2) value = float(nearestCell) / float(cellCount);
+    else if (mode == 3) value = d1 * d2 * 8.0;
+    else value = d1 * 2.0;
+    float v = level(value);
+    fragColor = vec4(v, v, v, 1.0);
+}
+)";
+
+    static constexpr const char* kMarbleFrag = R"(
+uniform float scale;
+uniform float turbulence;
+
+void main() {
+    vec2 p = pixel();
+    float nx = p.x / size.x * scale;
+    float ny = p.y / size.y * scale;
+    float turb = fbm(nx * turbulence, ny * turbulence, 6, 0.5);
+    float value = (sin(nx * 10.0 + turb * 5.0) + 1.0) * 0.5;
+    fragColor = lerpColor(vec4(240.0, 240.0, 240.0, 255.0), vec4(64.0, 64.0, 64.0, 255.0), value);
+}
+)";
+
+    static constexpr const char* kWoodFrag = R"(
+uniform float grainScale;
+uniform float ringFreq;
+
+void main() {
+    vec2 p = pixel();
+    float nx = p.x / size.x;
+    float ny = p.y / size.y;
+    float dist = sqrt(nx * nx + ny * ny);
+    float rings = sin(dist * ringFreq + fbm(nx * grainScale, ny * grainScale, 4, 0.5) * 3.0);
+    rings = (rings + 1.0) * 0.5;
+    float grain = fbm(nx * grainScale * 2.0, ny * grainScale * 0.5, 3, 0.5);
+    grain = (grain + 1.0) * 0.5 * 0.2;
+    float t = clamp(rings + grain, 0.0, 1.0);
+    fragColor = lerpColor(vec4(212.0, 165.0, 116.0, 255.0), vec4(139.0, 90.0, 43.0, 255.0), t);
+}
+)";
+
+    unsigned int mSeed;
+    bool mPermUploaded = false;  // Permutation texture holds mSeed's table
+    int mCellCount = -1;         // Cells the cell texture holds
+    bool mCreated = false;
+    GLuint mPrograms[static_cast<int>(Kind::Count)] = {};
+    bool mFailed[static_cast<int>(Kind::Count)] = {};
+    GLuint mProgram = 0;
+    GLuint mFbo = 0;
+    GLuint mEmptyVao = 0;
+    GLuint mPermTexture = 0;
+    GLuint mCellTexture = 0;
+    SavedState mSaved;
+};
+
 /**
  * Pre-built procedural texture presets for complete PBR materials
  */
@@ -0,0 +1,399 @@
+/**
+ * Web Profiler - scoped CPU zones per frame, with trace export
+ *
+ * AudioMonitor times the audio block and the GPU profiler the render
+ * passes, but nothing shows where the main thread's frame goes. Zones
+ * mark stretches of code; each one that closes while the profiler is
+ * enabled is written to a ring of recent events:
+ *
+ *   void onDraw(Graphics& g) {
+ *       AL_PROFILE_ZONE("particles");
+ *       ...
+ *   }
+ *
+ * WebApp::tick has zones for onAnimate, the auto-LOD update, beginFrame,
+ * onDraw and endFrame inside a "frame" zone; the backends, the mesh
+ * adapter, LOD generation and the audio block add their own. While
+ * disabled (the default) a zone costs one atomic load and no rings are
+ * allocated.
+ *
+ * There is one ring per track, main and audio, each with a single writer.
+ * The audio block runs its zones on the audio track (TrackScope), so
+ * zones inside onSound land there even when the audio callback runs on a
+ * worklet thread. The main thread reads the audio ring without locking,
+ * and a read may see an event that is being overwritten.
+ *
+ * The overlay draws per-frame zone averages over the canvas, refreshed
+ * four times a second. exportTrace() downloads the rings as Chrome
+ * trace-event JSON for chrome://tracing or ui.perfetto.dev. Studio drives
+ * both through window.allolib.profiler.
+ */
+
+#ifndef AL_WEB_PROFILER_HPP
+#define AL_WEB_PROFILER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+
+#include "al_WebFile.hpp"
+#endif
+
+#define AL_PROFILE_CONCAT_INNER(a, b) a##b
+#define AL_PROFILE_CONCAT(a, b) AL_PROFILE_CONCAT_INNER(a, b)
+
+/// Times the rest of the enclosing block; `name` must outlive the profiler
+/// (a string literal)
+#define AL_PROFILE_ZONE(name) \
+    ::al::FrameProfiler::Scope AL_PROFILE_CONCAT(alProfileZone_, __LINE__)(name)
+
+namespace al {
+
+struct ProfileEvent {
+    static constexpr uint8_t kZone = 0;
+    static constexpr uint8_t kCounter = 1;
+
+    const char* name = nullptr;
+    double startMs = 0.0;
+    float value = 0.0f;                 // Duration (zone) or sample (counter)
+    int16_t depth = 0;                  // Nesting on its track
+    uint8_t kind = kZone;
+};
+
+class FrameProfiler {
+public:
+    enum Track { kMain = 0, kAudio = 1, kTracks = 2 };
+
+    static constexpr uint32_t kMainCapacity = 16384;
+    static constexpr uint32_t kAudioCapacity = 4096;
+    static constexpr double kOverlayIntervalMs = 250.0;
+
+    static FrameProfiler& instance() {
+        static FrameProfiler profiler;
+        return profiler;
+    }
+
+    static bool enabled() {
+        return instance().mEnabled.load(std::memory_order_acquire);
+    }
+
+    static double nowMs() {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// Track the calling thread's zones go to (main unless in a TrackScope)
+    static int& threadTrack() {
+        static thread_local int track = kMain;
+        return track;
+    }
+
+    /// Times the enclosing block; see AL_PROFILE_ZONE
+    class Scope {
+    public:
+        explicit Scope(const char* name)
+            : mName(name), mStart(enabled() ? instance().open() : -1.0) {}
+        ~Scope() { if (mStart >= 0.0) instance().close(mName, mStart); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        const char* mName;
+        double mStart;
+    };
+
+    /// Sends the calling thread's zones to `track` until destroyed
+    class TrackScope {
+    public:
+        explicit TrackScope(int track) : mPrevious(threadTrack()) { threadTrack() = track; }
+        ~TrackScope() { threadTrack() = mPrevious; }
+        TrackScope(const TrackScope&) = delete;
+        TrackScope& operator=(const TrackScope&) = delete;
+    private:
+        int mPrevious;
+    };
+
+    /// Main thread; the rings are allocated on first enable
+    void setEnabled(bool enabled) {
+        if (enabled && !mRings[kMain].events) {
+            mRings[kMain].allocate(kMainCapacity);
+            mRings[kAudio].allocate(kAudioCapacity);
+        }
+        mEnabled.store(enabled, std::memory_order_release);
+        if (!enabled) setOverlay(false);
+    }
+
+    /// Record a counter sample (e.g. GPU frame ms) on the calling thread's track
+    void counter(const char* name, double value) {
+        if (!enabled()) return;
+        ProfileEvent e;
+        e.name = name;
+        e.startMs = nowMs();
+        e.value = float(value);
+        e.depth = 0;
+        e.kind = ProfileEvent::kCounter;
+        mRings[threadTrack()].push(e);
+    }
+
+    /// Main thread: count a finished frame and refresh the overlay if due
+    void endFrame() {
+        if (!enabled()) return;
+        mFrames++;
+        if (!mOverlay) return;
+        double now = nowMs();
+        if (now - mOverlayAt >= kOverlayIntervalMs) {
+            drawOverlay(now - mOverlayAt);
+            mOverlayAt = now;
+        }
+    }
+
+    /// Show per-frame zone averages over the canvas (enables profiling)
+    void setOverlay(bool show) {
+        if (show && !enabled()) setEnabled(true);
+        if (show && !mOverlay) {
+            for (int t = 0; t < kTracks; ++t) mOverlayFrom[t] = mRings[t].written();
+            mOverlayAt = nowMs();
+            mOverlayFrames = mFrames;
+        }
+        mOverlay = show;
+#ifdef __EMSCRIPTEN__
+        if (!show) {
+            EM_ASM({
+                var overlay = document.getElementById('al-profiler-overlay');
+                if (overlay) overlay.style.display = 'none';
+            });
+        }
+#endif
+    }
+
+    bool overlay() const { return mOverlay; }
+
+    /// Drop every recorded event (the rings stay allocated)
+    void clear() {
+        for (int t = 0; t < kTracks; ++t) {
+            mFirst[t] = mOverlayFrom[t] = mRings[t].written();
+        }
+    }
+
+    /// Chrome trace-event JSON of everything still in the rings
+    std::string traceJSON() const {
+        std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}},";
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"audio\"}}";
+        char buf[128];
+        for (int t = 0; t < kTracks; ++t) {
+            for (const ProfileEvent& e : mRings[t].since(mFirst[t])) {
+                out += ",{\"name\":\"";
+                appendEscaped(out, e.name);
+                if (e.kind == ProfileEvent::kCounter) {
+                    std::snprintf(buf, sizeof(buf),
+                                  "\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"value\":%.4f}}",
+                                  e.startMs * 1000.0, t + 1, e.value);
+                } else {
+                    std::snprintf(buf, sizeof(buf),
+                                  "\",\"cat\":\"allolib\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                                  e.startMs * 1000.0, e.value * 1000.0, t + 1);
+                }
+                out += buf;
+            }
+        }
+        out += "]}";
+        return out;
+    }
+
+    /// Download traceJSON(); returns the number of events written
+    size_t exportTrace(const std::string& filename = "allolib-trace.json") const {
+        size_t count = 0;
+        for (int t = 0; t < kTracks; ++t) count += mRings[t].since(mFirst[t]).size();
+#ifdef __EMSCRIPTEN__
+        WebFile::download(filename, traceJSON());
+#endif
+        printf("[FrameProfiler] Exported %zu events to %s\n", count, filename.c_str());
+        return count;
+    }
+
+private:
+    struct Ring {
+        std::unique_ptr<ProfileEvent[]> events;
+        uint32_t capacity = 0;
+        std::atomic<uint32_t> count{0};  // Events ever written; slot is count % capacity
+        int depth = 0;                   // Open zones, touched by the writer only
+
+        void allocate(uint32_t n) {
+            events.reset(new ProfileEvent[n]);
+            capacity = n;
+        }
+
+        uint32_t written() const { return count.load(std::memory_order_acquire); }
+
+        void push(const ProfileEvent& e) {
+            uint32_t n = count.load(std::memory_order_relaxed);
+            events[n % capacity] = e;
+            count.store(n + 1, std::memory_order_release);
+        }
+
+        /// Events written since `from` that the ring still holds, oldest first
+        std::vector<ProfileEvent> since(uint32_t from) const {
+            std::vector<ProfileEvent> out;
+            if (!events) return out;
+            uint32_t end = written();
+            uint32_t begin = std::max(from, end > capacity ? end - capacity : 0u);
+            out.reserve(end - begin);
+            for (uint32_t i = begin; i < end; ++i) out.push_back(events[i % capacity]);
+            return out;
+        }
+    };
+
+    FrameProfiler() = default;
+
+    double open() {
+        mRings[threadTrack()].depth++;
+        return nowMs();
+    }
+
+    void close(const char* name, double start) {
+        Ring& ring = mRings[threadTrack()];
+        ring.depth = std::max(0, ring.depth - 1);
+        // Enabled mid-zone on a thread whose ring was just allocated
+        if (!ring.events) return;
+        ProfileEvent e;
+        e.name = name;
+        e.startMs = start;
+        e.value = float(nowMs() - start);
+        e.depth = int16_t(ring.depth);
+        ring.push(e);
+    }
+
+    static void appendEscaped(std::string& out, const char* s) {
+        for (; s && *s; ++s) {
+            char c = *s;
+            if (c == '"' || c == '\\') { out += '\\'; out += c; }
+            else if ((unsigned char)c < 0x20) out += ' ';
+            else out += c;
+        }
+    }
+
+    struct ZoneTotal {
+        const char* name;
+        int track;
+        int depth;
+        double ms;
+        uint32_t count;
+    };
+
+    /// Per-frame averages since the last refresh, one line per zone
+    void drawOverlay(double windowMs) {
+        uint32_t frames = mFrames - mOverlayFrames;
+        mOverlayFrames = mFrames;
+        if (frames == 0) return;
+
+        std::vector<ZoneTotal> zones;
+        std::vector<ZoneTotal> counters;
+        for (int t = 0; t < kTracks; ++t) {
+            for (const ProfileEvent& e : mRings[t].since(mOverlayFrom[t])) {
+                auto& list = e.kind == ProfileEvent::kCounter ? counters : zones;
+                auto it = std::find_if(list.begin(), list.end(), [&](const ZoneTotal& z) {
+                    return z.track == t && (z.name == e.name || std::strcmp(z.name, e.name) == 0);
+                });
+                if (it == list.end()) {
+                    list.push_back({e.name, t, e.depth, e.value, 1});
+                } else {
+                    it->depth = std::min(it->depth, int(e.depth));
+                    it->ms += e.value;
+                    it->count++;
+                }
+            }
+            mOverlayFrom[t] = mRings[t].written();
+        }
+        std::stable_sort(zones.begin(), zones.end(), [](const ZoneTotal& a, const ZoneTotal& b) {
+            return a.track != b.track ? a.track < b.track : a.ms > b.ms;
+        });
+
+        std::string text;
+        char line[160];
+        std::snprintf(line, sizeof(line), "%.1f fps", 1000.0 * frames / windowMs);
+        text += line;
+        for (const ZoneTotal& c : counters) {
+            std::snprintf(line, sizeof(line), "\n%-22s %7.2f", c.name, c.ms / c.count);
+            text += line;
+        }
+        const size_t kMaxLines = 24;
+        size_t lines = 0;
+        int track = -1;
+        for (const ZoneTotal& z : zones) {
+            if (z.track != track) {
+                track = z.track;
+                text += track == kMain ? "\n-- main, ms/frame" : "\n-- audio, ms/block";
+            }
+            if (++lines > kMaxLines) continue;
+            // Audio zones are averaged per call, main ones per frame
+            double ms = z.track == kMain ? z.ms / frames : z.ms / z.count;
+            std::string label(size_t(std::min(z.depth, 6)) * 2, ' ');
+            label += z.name;
+            std::snprintf(line, sizeof(line), "\n%-22.22s %7.2f", label.c_str(), ms);
+            text += line;
+        }
+
+#ifdef __EMSCRIPTEN__
+        EM_ASM({
+            var text = UTF8ToString($0);
+            var canvas = Module.canvas || document.getElementById('canvas');
+            var overlay = document.getElementById('al-profiler-overlay');
+            if (!overlay) {
+                overlay = document.createElement('canvas');
+                overlay.id = 'al-profiler-overlay';
+                overlay.style.position = 'absolute';
+                overlay.style.pointerEvents = 'none';
+                overlay.style.zIndex = 10;
+                var parent = (canvas && canvas.parentElement) || document.body;
+                parent.appendChild(overlay);
+            }
+            if (canvas) {
+                overlay.style.left = canvas.offsetLeft + 'px';
+                overlay.style.top = canvas.offsetTop + 'px';
+            }
+            overlay.style.display = 'block';
+
+            var lines = text.split('\n');
+            var ratio = window.devicePixelRatio || 1;
+            var lineHeight = 13;
+            overlay.width = 220 * ratio;
+            overlay.height = (lines.length * lineHeight + 8) * ratio;
+            overlay.style.width = '220px';
+            overlay.style.height = (lines.length * lineHeight + 8) + 'px';
+
+            var ctx = overlay.getContext('2d');
+            ctx.setTransform(ratio, 0, 0, ratio, 0, 0);
+            ctx.fillStyle = 'rgba(0, 0, 0, 0.65)';
+            ctx.fillRect(0, 0, 220, lines.length * lineHeight + 8);
+            ctx.font = '11px monospace';
+            ctx.textBaseline = 'top';
+            for (var i = 0; i < lines.length; i++) {
+                ctx.fillStyle = lines[i].lastIndexOf('--', 0) === 0 ? '#8cf' : '#e0e0e0';
+                ctx.fillText(lines[i], 4, 4 + i * lineHeight);
+            }
+        }, text.c_str());
+#endif
+    }
+
+    std::atomic<bool> mEnabled{false};
+    Ring mRings[kTracks];
+    uint32_t mFirst[kTracks] = {};          // Export starts here (clear())
+    uint32_t mOverlayFrom[kTracks] = {};
+    uint32_t mFrames = 0;
+    uint32_t mOverlayFrames = 0;
+    double mOverlayAt = 0.0;
+    bool mOverlay = false;
+};
+
+} // namespace al
+
+#endif // AL_WEB_PROFILER_HPP
@@ -6,9 +6,10 @@
  *
  * Features:
  * - FPS monitoring and automatic quality adjustment
+ * - Frame-time driven adjustment from measured CPU and GPU time
  * - Quality presets (Low/Medium/High/Ultra)
  * - Per-feature quality settings
- * - Resolution scaling
+ * - Continuous resolution scaling (WebApp::setRenderScale)
  * - Shader complexity levels
  *
  * Usage:
@@ -22,16 +23,32 @@
  *   // In onDraw
  *   if (quality.shadowsEnabled()) { ... }
  *   lodMesh.bias(quality.lodBias());
+ *
+ * Frame-time driven (Auto preset): FPS alone cannot say whether the CPU or
+ * the GPU is the bottleneck, or how much headroom is left under vsync.
+ * Given the measured cost of each frame, a GPU-bound frame is held at the
+ * target frame time by the render scale (GPU time taken as proportional
+ * to pixel count), and the feature steps below are used only when the
+ * scale is at its minimum or the CPU is the bottleneck:
+ *
+ *   void onCreate() override { setGPUTiming(true); }
+ *   void onAnimate(double dt) override {
+ *       quality.update(dt, frameTimings());
+ *       setRenderScale(quality.resolutionScale());
+ *   }
  */
 
 #ifndef AL_WEB_QUALITY_HPP
 #define AL_WEB_QUALITY_HPP
 
 #include <emscripten.h>
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <functional>
 
+#include "al_WebFrameStats.hpp"
+
 namespace al {
 
 /**
@@ -111,26 +128,37 @@ public:
      * Update with frame time (call every frame)
      */
     void update(double dt) {
-        // Accumulate frame times
-        mFrameTimeAccum += dt;
-        mFrameCount++;
+        // Adaptive quality adjustment
+        if (sampleFPS(dt) && mAdaptiveEnabled && mPreset == QualityPreset::Auto) {
+            adaptQuality();
+        }
+    }
 
-        // Update FPS every 0.5 seconds
-        if (mFrameTimeAccum >= 0.5) {
-            mCurrentFPS = mFrameCount / mFrameTimeAccum;
-            mFrameTimeAccum = 0;
-            mFrameCount = 0;
-
-            // Record FPS history
-            for (int i = FPS_HISTORY_SIZE - 1; i > 0; i--) {
-                mFPSHistory[i] = mFPSHistory[i-1];
-            }
-            mFPSHistory[0] = mCurrentFPS;
+    /**
+     * Update with the measured cost of the last frame (call every frame,
+     * e.g. with WebApp::frameTimings()). In Auto mode this replaces the
+     * FPS-driven steps: see the header comment. timings.gpuMs of 0 means
+     * unmeasured; a GPU bottleneck is then inferred from frames that run
+     * long while the CPU is within budget.
+     */
+    void update(double dt, const FrameTimings& timings) {
+        sampleFPS(dt);
 
-            // Adaptive quality adjustment
-            if (mAdaptiveEnabled && mPreset == QualityPreset::Auto) {
-                adaptQuality();
-            }
+        const auto smooth = [](float& avg, float sample) {
+            avg = avg > 0.0f ? avg + (sample - avg) * 0.1f : sample;
+        };
+        smooth(mCpuMs, timings.cpuMs);
+        smooth(mIntervalMs, timings.intervalMs);
+        if (timings.gpuMs > 0.0f) smooth(mGpuMs, timings.gpuMs);
+        else mGpuMs = 0.0f;
+
+        // GPU results lag a few frames; give each change time to show
+        mControlTimer += dt;
+        if (mControlTimer < CONTROL_INTERVAL) return;
+        mControlTimer = 0;
+
+        if (mAdaptiveEnabled && mPreset == QualityPreset::Auto) {
+            adaptToFrameTime();
         }
     }
 
@@ -269,6 +297,28 @@ public:
         return sum / FPS_HISTORY_SIZE;
     }
 
+    /**
+     * Frame time the time-driven mode holds (1000 / target FPS, in ms)
+     */
+    float targetFrameMs() const { return 1000.0f / std::max(1.0f, mTargetFPS); }
+
+    /**
+     * Smoothed CPU and GPU ms per frame from update(dt, timings); GPU is 0
+     * when unmeasured
+     */
+    float cpuFrameMs() const { return mCpuMs; }
+    float gpuFrameMs() const { return mGpuMs; }
+
+    /**
+     * Range the time-driven mode moves the resolution scale in
+     */
+    void setRenderScaleRange(float minScale, float maxScale = 1.0f) {
+        mMinRenderScale = std::min(1.0f, std::max(0.25f, minScale));
+        mMaxRenderScale = std::min(1.0f, std::max(mMinRenderScale, maxScale));
+    }
+    float minRenderScale() const { return mMinRenderScale; }
+    float maxRenderScale() const { return mMaxRenderScale; }
+
     /**
      * Enable/disable adaptive quality
      */
@@ -317,9 +367,12 @@ public:
     }
 
     /**
-     * Get estimated GPU load (0-1)
+     * Get estimated GPU load (0-1): measured GPU time over the target frame
+     * time when update(dt, timings) has it, otherwise a guess from settings
      */
     float estimatedGPULoad() const {
+        if (mGpuMs > 0.0f) return std::min(1.0f, mGpuMs / targetFrameMs());
+
         // Rough estimate based on settings
         float load = 0;
         load += mSettings.resolutionScale * 0.3f;
@@ -334,6 +387,76 @@ public:
 
 private:
     static const int FPS_HISTORY_SIZE = 10;
+    static constexpr double CONTROL_INTERVAL = 0.25;  // Seconds between time-driven steps
+    static constexpr float FRAME_HEADROOM = 0.9f;     // Fraction of the frame time to fill
+
+    // Accumulate frame times; true when the FPS sample was refreshed
+    bool sampleFPS(double dt) {
+        mFrameTimeAccum += dt;
+        mFrameCount++;
+
+        // Update FPS every 0.5 seconds
+        if (mFrameTimeAccum < 0.5) return false;
+        mCurrentFPS = mFrameCount / mFrameTimeAccum;
+        mFrameTimeAccum = 0;
+        mFrameCount = 0;
+
+        // Record FPS history
+        for (int i = FPS_HISTORY_SIZE - 1; i > 0; i--) {
+            mFPSHistory[i] = mFPSHistory[i-1];
+        }
+        mFPSHistory[0] = mCurrentFPS;
+        return true;
+    }
+
+    void adaptToFrameTime() {
+        const float target = targetFrameMs();
+        const float budget = target * FRAME_HEADROOM;
+        const bool cpuBound = mCpuMs > budget;
+
+        // GPU cost: measured, or the frame interval when frames run long
+        // with the CPU inside its budget. 0 = no sign of GPU pressure.
+        float gpu = mGpuMs;
+        if (gpu <= 0.0f && !cpuBound && mIntervalMs > target * 1.1f) gpu = mIntervalMs;
+
+        // Render scale: GPU time ~ pixels ~ scale^2. Drop fast, recover
+        // slowly, and leave small errors alone so the image doesn't pump.
+        float scale = std::min(mMaxRenderScale, std::max(mMinRenderScale, mSettings.resolutionScale));
+        if (!cpuBound) {
+            float ideal = gpu > 0.0f ? scale * std::sqrt(budget / gpu) : mMaxRenderScale;
+            if (std::abs(ideal - scale) > 0.02f * scale) {
+                scale += std::min(0.05f, std::max(-0.1f, ideal - scale));
+            }
+            scale = std::min(mMaxRenderScale, std::max(mMinRenderScale, scale));
+        }
+        bool changed = std::abs(scale - mSettings.resolutionScale) >= 0.005f;
+        mSettings.resolutionScale = scale;
+
+        // Feature steps: when the CPU is the bottleneck, or the GPU is over
+        // budget at the minimum scale; back up once everything has room
+        const bool gpuOver = gpu > budget && scale <= mMinRenderScale;
+        const bool roomy = mCpuMs < budget * 0.7f && scale >= mMaxRenderScale &&
+                           (mGpuMs > 0.0f ? mGpuMs < budget * 0.7f : gpu <= 0.0f);
+        if (cpuBound || gpuOver) {
+            mStabilityCounter = std::min(0, mStabilityCounter) - 1;
+            if (mStabilityCounter <= -4) {
+                decreaseQuality(false);
+                mStabilityCounter = 0;
+                changed = false;  // decreaseQuality reported it
+            }
+        } else if (roomy) {
+            mStabilityCounter = std::max(0, mStabilityCounter) + 1;
+            if (mStabilityCounter >= 12) {
+                increaseQuality(false);
+                mStabilityCounter = 0;
+                changed = false;
+            }
+        } else {
+            mStabilityCounter = 0;
+        }
+
+        if (changed && mCallback) mCallback(mSettings);
+    }
 
     void adaptQuality() {
         float avgFPS = averageFPS();
@@ -360,7 +483,8 @@ private:
         }
     }
 
-    void decreaseQuality() {
+    // withResolution = false leaves the resolution scale to adaptToFrameTime()
+    void decreaseQuality(bool withResolution = true) {
         // Decrease quality in priority order
         if (mSettings.ambientOcclusion) {
             mSettings.ambientOcclusion = false;
@@ -380,7 +504,7 @@ private:
         } else if (mSettings.lodBias < 3.0f) {
             mSettings.lodBias += 0.5f;
             printf("[Quality] Increased LOD bias (FPS: %.1f)\n", mCurrentFPS);
-        } else if (mSettings.resolutionScale > 0.5f) {
+        } else if (withResolution && mSettings.resolutionScale > 0.5f) {
             mSettings.resolutionScale -= 0.1f;
             printf("[Quality] Reduced resolution scale (FPS: %.1f)\n", mCurrentFPS);
         } else if (mSettings.shadowsEnabled) {
@@ -391,12 +515,12 @@ private:
         if (mCallback) mCallback(mSettings);
     }
 
-    void increaseQuality() {
+    void increaseQuality(bool withResolution = true) {
         // Increase quality in reverse priority order
         if (!mSettings.shadowsEnabled) {
             mSettings.shadowsEnabled = true;
             printf("[Quality] Enabled shadows (FPS: %.1f)\n", mCurrentFPS);
-        } else if (mSettings.resolutionScale < 1.0f) {
+        } else if (withResolution && mSettings.resolutionScale < 1.0f) {
             mSettings.resolutionScale = std::min(1.0f, mSettings.resolutionScale + 0.1f);
             printf("[Quality] Increased resolution scale (FPS: %.1f)\n", mCurrentFPS);
         } else if (mSettings.lodBias > 1.0f) {
@@ -432,6 +556,14 @@ private:
     bool mAdaptiveEnabled;
     int mStabilityCounter;
     QualityChangeCallback mCallback;
+
+    // Time-driven mode (update(dt, timings))
+    float mCpuMs = 0.0f;
+    float mGpuMs = 0.0f;
+    float mIntervalMs = 0.0f;
+    double mControlTimer = 0.0;
+    float mMinRenderScale = 0.5f;
+    float mMaxRenderScale = 1.0f;
 };
 
 /**
@@ -0,0 +1,188 @@
+/**
+ * Web Render Target Pool - transient EasyFBOs shared within a frame
+ *
+ * Post-processing code used to own one EasyFBO per intermediate image and
+ * re-init all of them on every resize, so each effect chain paid for its
+ * own VRAM and a window drag reallocated everything at once. Intermediate
+ * targets are now borrowed here by (size, EasyFBOSetting) for as long as a
+ * pass needs them: a target released by one effect is handed to the next
+ * effect that asks for the same size and format in that frame.
+ *
+ * Usage:
+ *   auto& pool = RenderTargetPool::instance();
+ *   EasyFBO* tmp = pool.acquire(w / 2, h / 2, setting);
+ *   tmp->begin();  ...  tmp->end();
+ *   pool.release(tmp);  // Free for the next user this frame
+ *
+ * WebApp calls endFrame() after every frame; targets nobody has acquired
+ * for setMaxIdleFrames() frames (e.g. the old size after a resize) are
+ * destroyed, so sizes are (re)allocated lazily as they are first asked for.
+ * Targets whose contents must survive to the next frame (history buffers)
+ * should stay owned by their user.
+ */
+
+#ifndef AL_WEB_RENDER_TARGET_POOL_HPP
+#define AL_WEB_RENDER_TARGET_POOL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "al/graphics/al_EasyFBO.hpp"
+
+namespace al {
+
+class RenderTargetPool {
+public:
+    static RenderTargetPool& instance() {
+        static RenderTargetPool pool;
+        return pool;
+    }
+
+    /**
+     * Borrow a target of this size and format, creating one if every
+     * matching target is in use. Contents are whatever the last user left.
+     */
+    EasyFBO* acquire(int width, int height, const EasyFBOSetting& setting) {
+        Key key = makeKey(width, height, setting);
+        for (auto& entry : mEntries) {
+            if (!entry.inUse && entry.key == key) {
+                entry.inUse = true;
+                entry.lastUsed = mFrame;
+                mStats.reuses++;
+                return entry.fbo.get();
+            }
+        }
+
+        Entry entry;
+        entry.key = key;
+        entry.fbo = std::make_unique<EasyFBO>();
+        entry.fbo->init(width, height, setting);
+        entry.inUse = true;
+        entry.lastUsed = mFrame;
+        mEntries.push_back(std::move(entry));
+        mStats.allocations++;
+        return mEntries.back().fbo.get();
+    }
+
+    /// Return a target from acquire(); it may be handed out again at once
+    void release(EasyFBO* fbo) {
+        for (auto& entry : mEntries) {
+            if (entry.fbo.get() == fbo) {
+                entry.inUse = false;
+                entry.lastUsed = mFrame;
+                return;
+            }
+        }
+    }
+
+    /// Advance the frame and destroy targets idle for too long
+    void endFrame() {
+        ++mFrame;
+        size_t before = mEntries.size();
+        mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(),
+                                      [this](const Entry& e) {
+                                          return !e.inUse && mFrame - e.lastUsed > mMaxIdleFrames;
+                                      }),
+                       mEntries.end());
+        mStats.evictions += before - mEntries.size();
+    }
+
+    /// Frames an unused target is kept before it is destroyed (default 8)
+    void setMaxIdleFrames(uint64_t frames) { mMaxIdleFrames = frames; }
+
+    /// Destroy every target that isn't in use
+    void trim() {
+        mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(),
+                                      [](const Entry& e) { return !e.inUse; }),
+                       mEntries.end());
+    }
+
+    struct Stats {
+        uint64_t allocations = 0;  ///< Targets created
+        uint64_t reuses = 0;       ///< acquire() calls served by an existing target
+        uint64_t evictions = 0;    ///< Targets destroyed after going idle
+        size_t targets = 0;        ///< Targets alive
+        size_t inUse = 0;          ///< Targets currently acquired
+    };
+
+    Stats stats() const {
+        Stats s = mStats;
+        s.targets = mEntries.size();
+        for (const auto& entry : mEntries) {
+            if (entry.inUse) s.inUse++;
+        }
+        return s;
+    }
+
+    void printStats() const {
+        Stats s = stats();
+        printf("[RenderTargetPool] %zu targets (%zu in use), %llu allocated, %llu reused, "
+               "%llu evicted\n",
+               s.targets, s.inUse, (unsigned long long)s.allocations,
+               (unsigned long long)s.reuses, (unsigned long long)s.evictions);
+    }
+
+private:
+    // Everything EasyFBO::init() bakes into the attachments
+    struct Key {
+        int width = 0;
+        int height = 0;
+        int internal = 0;
+        unsigned int format = 0;
+        unsigned int type = 0;
+        unsigned int depthFormat = 0;
+        unsigned int filterMin = 0;
+        unsigned int filterMag = 0;
+        unsigned int wrapS = 0;
+        unsigned int wrapT = 0;
+        bool depthTexture = false;
+        bool mipmap = false;
+
+        bool operator==(const Key& o) const {
+            return width == o.width && height == o.height && internal == o.internal &&
+                   format == o.format && type == o.type && depthFormat == o.depthFormat &&
+                   filterMin == o.filterMin && filterMag == o.filterMag &&
+                   wrapS == o.wrapS && wrapT == o.wrapT &&
+                   depthTexture == o.depthTexture && mipmap == o.mipmap;
+        }
+    };
+
+    struct Entry {
+        Key key;
+        std::unique_ptr<EasyFBO> fbo;
+        bool inUse = false;
+        uint64_t lastUsed = 0;
+    };
+
+    static Key makeKey(int width, int height, const EasyFBOSetting& s) {
+        Key key;
+        key.width = width;
+        key.height = height;
+        key.internal = s.internal;
+        key.format = s.format;
+        key.type = s.type;
+        key.depthFormat = s.depth_format;
+        key.filterMin = s.filterMin;
+        key.filterMag = s.filterMag;
+        key.wrapS = s.wrapS;
+        key.wrapT = s.wrapT;
+        key.depthTexture = s.use_depth_texture;
+        key.mipmap = s.mUseMipmap;
+        return key;
+    }
+
+    RenderTargetPool() = default;
+
+    // Few targets live at once, so a linear scan beats hashing the key
+    std::vector<Entry> mEntries;
+    uint64_t mFrame = 0;
+    uint64_t mMaxIdleFrames = 8;
+    Stats mStats;
+};
+
+} // namespace al
+
+#endif // AL_WEB_RENDER_TARGET_POOL_HPP
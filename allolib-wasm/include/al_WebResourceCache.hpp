@@ -0,0 +1,206 @@
+/**
+ * Web GPU Resource Cache - shared, refcounted GPU textures
+ *
+ * WebEnvironment, WebPBR, MipmapTexture and ProceduralTexture each used to
+ * create their own GPU texture, so two objects (or a scene reload) using
+ * the same environment map or material texture uploaded it twice. They now
+ * acquire textures here by key - the source URL ("env:/assets/sky.hdr") or,
+ * for generated data, a content hash (contentKey()) - and the first user
+ * creates the texture while later ones share it.
+ *
+ * Usage:
+ *   GPUTextureRef tex = GPUResourceCache::instance().acquire("mip:" + url,
+ *       [&](GPUTexture& t) {
+ *           glGenTextures(1, &t.id);
+ *           ... upload ...
+ *           t.width = w; t.height = h; t.bytes = w * h * 4;
+ *           return true;
+ *       });
+ *   glBindTexture(GL_TEXTURE_2D, tex->id);
+ *   tex.reset();  // Released when the last reference goes
+ *
+ * The texture is freed once nothing references it, except that unused
+ * textures are kept (least recently used first out) up to
+ * setRetainBudget() bytes, so a reload finds them still on the GPU.
+ * A GPUTexture holds either a GL texture (WebGL2 code that calls gl*
+ * directly) or a GraphicsBackend handle, never both.
+ */
+
+#ifndef AL_WEB_RESOURCE_CACHE_HPP
+#define AL_WEB_RESOURCE_CACHE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "al/graphics/al_OpenGL.hpp"
+#include "al_WebGraphicsBackend.hpp"
+
+namespace al {
+
+/**
+ * One cached GPU texture; deleted with its last reference
+ */
+struct GPUTexture {
+    GLuint id = 0;                       ///< GL texture
+    TextureHandle handle;                ///< Backend texture (id is 0)
+    GraphicsBackend* backend = nullptr;  ///< Owner of handle
+    int width = 0;
+    int height = 0;
+    int levels = 1;                      ///< Mip levels
+    bool cube = false;                   ///< GL_TEXTURE_CUBE_MAP (width = face size)
+    size_t bytes = 0;                    ///< GPU memory, for the stats and the retain budget
+
+    GPUTexture() = default;
+    GPUTexture(const GPUTexture&) = delete;
+    GPUTexture& operator=(const GPUTexture&) = delete;
+
+    ~GPUTexture() {
+        if (id) glDeleteTextures(1, &id);
+        if (handle.valid() && backend) backend->destroyTexture(handle);
+    }
+};
+
+using GPUTextureRef = std::shared_ptr<const GPUTexture>;
+
+class GPUResourceCache {
+public:
+    using Create = std::function<bool(GPUTexture&)>;
+
+    static GPUResourceCache& instance() {
+        static GPUResourceCache cache;
+        return cache;
+    }
+
+    /**
+     * The texture cached under `key`, or null. A retained (unused) texture
+     * is handed out again.
+     */
+    GPUTextureRef find(const std::string& key) {
+        auto it = mEntries.find(key);
+        if (it == mEntries.end()) return nullptr;
+        it->second.lastUse = ++mClock;
+        mHits++;
+        return it->second.texture;
+    }
+
+    /**
+     * The texture cached under `key`, or the one `create` fills in. If
+     * create returns false nothing is cached (and anything it allocated is
+     * freed).
+     */
+    GPUTextureRef acquire(const std::string& key, const Create& create) {
+        if (GPUTextureRef found = find(key)) return found;
+
+        auto texture = std::make_shared<GPUTexture>();
+        if (!create(*texture)) return nullptr;
+        mMisses++;
+        mEntries[key] = Entry{texture, ++mClock};
+        trim();
+        return texture;
+    }
+
+    /// True if `key` is cached (in use or retained)
+    bool contains(const std::string& key) const { return mEntries.count(key) != 0; }
+
+    /**
+     * Key for generated or embedded data: 64-bit FNV-1a over the bytes,
+     * eight at a time. `tag` keeps different uses of equal bytes apart.
+     */
+    static std::string contentKey(const void* data, size_t size, const char* tag = "") {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](uint64_t w) {
+            h ^= w;
+            h *= 1099511628211ull;
+        };
+        mix(size);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t w;
+            memcpy(&w, bytes + i, sizeof(w));
+            mix(w);
+        }
+        uint64_t tail = 0;
+        if (i < size) memcpy(&tail, bytes + i, size - i);
+        mix(tail);
+
+        char key[24];
+        snprintf(key, sizeof(key), "%016llx", (unsigned long long)h);
+        return std::string("hash:") + tag + key;
+    }
+
+    /// Bytes of unused textures kept for reuse (default 64 MB)
+    void setRetainBudget(size_t bytes) {
+        mRetainBudget = bytes;
+        trim();
+    }
+    size_t retainBudget() const { return mRetainBudget; }
+
+    /// Free unused textures beyond the retain budget, oldest first
+    void trim() {
+        std::vector<std::pair<uint64_t, std::string>> unused;
+        size_t unusedBytes = 0;
+        for (const auto& entry : mEntries) {
+            if (entry.second.texture.use_count() > 1) continue;
+            unused.push_back({entry.second.lastUse, entry.first});
+            unusedBytes += entry.second.texture->bytes;
+        }
+        if (unusedBytes <= mRetainBudget) return;
+
+        std::sort(unused.begin(), unused.end());
+        for (const auto& u : unused) {
+            if (unusedBytes <= mRetainBudget) break;
+            auto it = mEntries.find(u.second);
+            unusedBytes -= it->second.texture->bytes;
+            mEntries.erase(it);
+        }
+    }
+
+    /// Free every unused texture (textures still referenced stay cached)
+    void clear() {
+        for (auto it = mEntries.begin(); it != mEntries.end();) {
+            if (it->second.texture.use_count() > 1) ++it;
+            else it = mEntries.erase(it);
+        }
+    }
+
+    // ── Stats ──
+
+    int count() const { return (int)mEntries.size(); }
+    /// GPU memory of every cached texture, in use or retained
+    size_t memoryUsage() const {
+        size_t total = 0;
+        for (const auto& entry : mEntries) total += entry.second.texture->bytes;
+        return total;
+    }
+    /// Acquires served from the cache / that had to create the texture
+    uint64_t hits() const { return mHits; }
+    uint64_t misses() const { return mMisses; }
+
+private:
+    struct Entry {
+        std::shared_ptr<GPUTexture> texture;
+        uint64_t lastUse = 0;
+    };
+
+    GPUResourceCache() = default;
+    GPUResourceCache(const GPUResourceCache&) = delete;
+    GPUResourceCache& operator=(const GPUResourceCache&) = delete;
+
+    std::unordered_map<std::string, Entry> mEntries;
+    size_t mRetainBudget = 64u * 1024u * 1024u;
+    uint64_t mClock = 0;
+    uint64_t mHits = 0;
+    uint64_t mMisses = 0;
+};
+
+} // namespace al
+
+#endif // AL_WEB_RESOURCE_CACHE_HPP
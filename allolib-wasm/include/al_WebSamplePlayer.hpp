@@ -6,7 +6,10 @@
  *
  * Usage:
  *   WebSamplePlayer player;
- *   player.load("path/to/sample.wav");  // suspends via Asyncify; returns when ready
+ *   player.load("path/to/sample.wav", [&](bool ok) {  // returns at once
+ *       if (ok) duration = player.duration();
+ *   });
+ *   ...
  *   if (player.ready()) {
  *       float sample = player.read(channel, frame);
  *   }
@@ -21,69 +24,367 @@
  * at link time; conversely, if it wasn't exported, runtime calls
  * aborted with "Cannot call unknown function _al_web_sample_loaded".
  *
- * The fix is structural: load() now uses EM_ASYNC_JS, which suspends
- * the wasm caller until the JS coroutine resolves and returns a
- * pointer to a packed buffer (header + interleaved samples). No
- * C-callable symbol is exposed to JS, so no export contract exists,
- * so neither the link nor the runtime can fail on a missing name.
- * ASYNCIFY=1 is already enabled in compile.sh, which is the only
- * runtime requirement.
+ * The blocking load(url) therefore uses EM_ASYNC_JS, which suspends the
+ * wasm caller until the JS coroutine resolves, and load(url, callback)
+ * completes through _al_web_sample_decoded and _al_web_sample_stream_opened
+ * below. Those are EMSCRIPTEN_KEEPALIVE inline functions, as in
+ * WebImage: every sketch that includes this header emits and exports
+ * them itself, and they are never listed in EXPORTED_FUNCTIONS.
+ *
+ * Asyncify: the one-argument load(url) and loadStreaming(url, seconds)
+ * suspend, which needs the program linked with ASYNCIFY, and ASYNCIFY
+ * instruments nearly every function of a sketch (onDraw and onSound
+ * included). compile.sh links with it only when the sketch's object
+ * imports a suspending call, so sketches that use the callback overloads
+ * (or no sample player) build without it.
+ *
+ * Loads take their turn in the AssetLoader queue (a blocking load() sleeps
+ * until it gets a slot). Players loading the same URL share one decoded
+ * buffer, whether the loads overlap or not. A player must stay at the
+ * same address while a callback load is pending.
+ *
+ * Memory: load() keeps the whole file decoded in the wasm heap (4 bytes
+ * per sample, ~200 MB for ten minutes of stereo). Two ways to cut that:
+ *
+ *   player.setStorage(WebSamplePlayer::Storage::Int16);  // before load()
+ *     Halves it; read() converts on the fly. data() is then null.
+ *
+ *   player.loadStreaming("soundscape.wav", 2.0f, callback);  // 2 s read-ahead
+ *     The heap holds only a ring of read-ahead frames, filled from JS on
+ *     a timer. WAV (8/16/24-bit PCM, 32-bit float) is parsed as the
+ *     download arrives, so playback can start before it finishes, and the
+ *     JS side keeps only the file bytes. Other formats are decoded whole
+ *     by decodeAudioData and kept in JS as 16-bit. Streams play forward:
+ *     read() advances the stream, and seek() jumps. Frames outside the
+ *     ring read as 0 and count as underruns(). Streams skip the
+ *     AssetLoader queue, since they would hold a slot for their lifetime.
  */
 
 #ifndef AL_WEB_SAMPLE_PLAYER_HPP
 #define AL_WEB_SAMPLE_PLAYER_HPP
 
 #include <emscripten.h>
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "al_WebAssetLoader.hpp"
 
 namespace al {
 class WebSamplePlayer;
 } // namespace al
 
-// JS coroutine: fetch URL, decode via Web Audio, allocate a single
-// packed buffer in WASM memory, return its pointer. Layout:
+// The fetch/decode and stream-open coroutines, installed once on
+// globalThis.__alSampleLoader and shared by the blocking (EM_ASYNC_JS) and
+// callback (EM_JS + ccall) entry points below.
+//
+// decode(url, int16) resolves with a single packed buffer malloc'd in
+// WASM memory, or 0 on failure (network, decode, OOM). Layout:
 //   bytes  0..3 : int32   numChannels
 //   bytes  4..7 : int32   numFrames
 //   bytes  8..11: float32 sampleRate
-//   bytes 12..  : float32 interleaved samples (channels * frames)
-// Caller is responsible for free()-ing the returned pointer. Returns
-// 0 on failure (network, decode, OOM).
-EM_ASYNC_JS(void*, _al_ws_fetch_and_decode, (const char* urlPtr), {
-    const url = UTF8ToString(urlPtr);
-    try {
-        const resp = await fetch(url);
-        if (!resp.ok) { console.error('[WebSamplePlayer] fetch failed', resp.status, url); return 0; }
-        const buf = await resp.arrayBuffer();
-        const Ctx = window.AudioContext || window.webkitAudioContext;
-        const ctx = new Ctx();
-        const ab = await ctx.decodeAudioData(buf);
-        const ch = ab.numberOfChannels;
-        const fr = ab.length;
-        const sr = ab.sampleRate;
-        const total = ch * fr;
-        const ptr = Module._malloc(12 + total * 4);
-        if (!ptr) { console.error('[WebSamplePlayer] malloc failed'); return 0; }
-        Module.HEAP32[(ptr + 0) >> 2] = ch;
-        Module.HEAP32[(ptr + 4) >> 2] = fr;
-        Module.HEAPF32[(ptr + 8) >> 2] = sr;
-        const dataIdx = (ptr + 12) >> 2;
-        // Pull each channel once, then interleave.
-        const channelData = [];
-        for (let c = 0; c < ch; c++) channelData.push(ab.getChannelData(c));
-        for (let f = 0; f < fr; f++) {
-            const base = dataIdx + f * ch;
-            for (let c = 0; c < ch; c++) {
-                Module.HEAPF32[base + c] = channelData[c][f];
+//   bytes 12..  : interleaved samples (channels * frames), float32, or
+//                 int16 when `int16` is non-zero
+// The receiver is responsible for free()-ing it.
+//
+// Streaming. A stream's source lives in JS (globalThis.__alSampleStreams);
+// the wasm side owns a ring which JS fills on a timer. Ring header, int32
+// fields (see WebSamplePlayer::StreamRing):
+//   [0] writeFrame   JS: frames written so far (absolute frame index)
+//   [1] readFrame    C++: oldest frame still needed
+//   [2] seekFrame    C++: restart request, -1 when none
+//   [3] state        JS: 0 streaming, 1 complete, -1 error
+//   [4] capacity     frames in the ring
+//   [5] channels
+// followed at byte 32 by float32 interleaved frames, frame f at slot
+// f % capacity. JS writes frame f only while f < readFrame + capacity.
+//
+// open(url, info) starts fetching `url` and resolves once the format is
+// known. Writes [channels, totalFrames (-1 if unknown), sampleRate (float)]
+// to `info` and resolves with a stream id, or 0 on failure.
+EM_JS(void, _al_ws_install_loader, (), {
+    if (globalThis.__alSampleLoader) return;
+    globalThis.__alSampleLoader = {
+        decode: async (url, int16) => {
+            try {
+                const resp = await fetch(url);
+                if (!resp.ok) { console.error('[WebSamplePlayer] fetch failed', resp.status, url); return 0; }
+                const buf = await resp.arrayBuffer();
+                const Ctx = window.AudioContext || window.webkitAudioContext;
+                const ctx = new Ctx();
+                const ab = await ctx.decodeAudioData(buf);
+                const ch = ab.numberOfChannels;
+                const fr = ab.length;
+                const sr = ab.sampleRate;
+                const total = ch * fr;
+                const ptr = Module._malloc(12 + total * (int16 ? 2 : 4));
+                if (!ptr) { console.error('[WebSamplePlayer] malloc failed'); return 0; }
+                Module.HEAP32[(ptr + 0) >> 2] = ch;
+                Module.HEAP32[(ptr + 4) >> 2] = fr;
+                Module.HEAPF32[(ptr + 8) >> 2] = sr;
+                // Pull each channel once, then interleave.
+                const channelData = [];
+                for (let c = 0; c < ch; c++) channelData.push(ab.getChannelData(c));
+                if (int16) {
+                    const dataIdx = (ptr + 12) >> 1;
+                    for (let f = 0; f < fr; f++) {
+                        const base = dataIdx + f * ch;
+                        for (let c = 0; c < ch; c++) {
+                            const v = Math.max(-1, Math.min(1, channelData[c][f]));
+                            Module.HEAP16[base + c] = Math.round(v * 32767);
+                        }
+                    }
+                    return ptr;
+                }
+                const dataIdx = (ptr + 12) >> 2;
+                for (let f = 0; f < fr; f++) {
+                    const base = dataIdx + f * ch;
+                    for (let c = 0; c < ch; c++) {
+                        Module.HEAPF32[base + c] = channelData[c][f];
+                    }
+                }
+                return ptr;
+            } catch (e) {
+                console.error('[WebSamplePlayer] load failed:', e);
+                return 0;
+            }
+        },
+        open: async (url, info) => {
+            const streams = globalThis.__alSampleStreams || (globalThis.__alSampleStreams = { next: 1, map: new Map() });
+
+            // Growable byte store for the download
+            const bytes = { data: new Uint8Array(1 << 16), length: 0, done: false };
+            const append = (chunk) => {
+                if (bytes.length + chunk.length > bytes.data.length) {
+                    let size = bytes.data.length;
+                    while (size < bytes.length + chunk.length) size *= 2;
+                    const grown = new Uint8Array(size);
+                    grown.set(bytes.data.subarray(0, bytes.length));
+                    bytes.data = grown;
+                }
+                bytes.data.set(chunk, bytes.length);
+                bytes.length += chunk.length;
+            };
+
+            // RIFF/WAVE header: returns null until enough bytes have arrived,
+            // false if this isn't PCM/float WAV
+            const parseWav = () => {
+                const d = bytes.data;
+                if (bytes.length < 12) return null;
+                const tag = (o) => String.fromCharCode(d[o], d[o + 1], d[o + 2], d[o + 3]);
+                if (tag(0) !== 'RIFF' || tag(8) !== 'WAVE') return false;
+                const view = new DataView(d.buffer);
+                let off = 12, fmt = null;
+                while (off + 8 <= bytes.length) {
+                    const id = tag(off);
+                    const size = view.getUint32(off + 4, true);
+                    if (id === 'fmt ') {
+                        if (off + 8 + 16 > bytes.length) return null;
+                        let format = view.getUint16(off + 8, true);
+                        if (format === 0xFFFE && size >= 40) {
+                            if (off + 8 + 26 > bytes.length) return null;
+                            format = view.getUint16(off + 8 + 24, true);
+                        }
+                        fmt = {
+                            format,
+                            channels: view.getUint16(off + 10, true),
+                            sampleRate: view.getUint32(off + 12, true),
+                            blockAlign: view.getUint16(off + 20, true),
+                            bits: view.getUint16(off + 22, true),
+                        };
+                    } else if (id === 'data') {
+                        if (!fmt) return false;
+                        const pcm = fmt.format === 1 && [8, 16, 24].includes(fmt.bits);
+                        const flt = fmt.format === 3 && fmt.bits === 32;
+                        if (!pcm && !flt) return false;
+                        const known = size !== 0 && size !== 0xFFFFFFFF;
+                        return Object.assign(fmt, {
+                            dataOffset: off + 8,
+                            totalFrames: known ? Math.floor(size / fmt.blockAlign) : -1,
+                        });
+                    }
+                    off += 8 + size + (size & 1);
+                }
+                return null;
+            };
+
+            try {
+                const resp = await fetch(url);
+                if (!resp.ok) { console.error('[WebSamplePlayer] fetch failed', resp.status, url); return 0; }
+                const reader = resp.body.getReader();
+                let wav = null;
+                while (wav === null) {
+                    const r = await reader.read();
+                    if (r.done) { bytes.done = true; wav = parseWav() || false; break; }
+                    append(r.value);
+                    wav = parseWav();
+                }
+
+                let source;
+                if (wav) {
+                    // Keep downloading in the background; the pump decodes what's there
+                    (async () => {
+                        try {
+                            for (;;) {
+                                const r = await reader.read();
+                                if (r.done) break;
+                                append(r.value);
+                            }
+                        } catch (e) {
+                            console.error('[WebSamplePlayer] stream download failed:', e);
+                        }
+                        bytes.done = true;
+                    })();
+                    const bps = wav.bits >> 3;
+                    source = {
+                        channels: wav.channels,
+                        sampleRate: wav.sampleRate,
+                        totalFrames: wav.totalFrames,
+                        available() {
+                            const n = Math.floor((bytes.length - wav.dataOffset) / wav.blockAlign);
+                            return wav.totalFrames >= 0 ? Math.min(n, wav.totalFrames) : Math.max(0, n);
+                        },
+                        finished() { return bytes.done; },
+                        decode(dst, dstIdx, frame, n) {
+                            const d = bytes.data;
+                            const view = new DataView(d.buffer);
+                            const ch = wav.channels;
+                            for (let f = 0; f < n; f++) {
+                                let o = wav.dataOffset + (frame + f) * wav.blockAlign;
+                                for (let c = 0; c < ch; c++, o += bps) {
+                                    let v;
+                                    if (wav.format === 3) v = view.getFloat32(o, true);
+                                    else if (bps === 2) v = view.getInt16(o, true) / 32768;
+                                    else if (bps === 3) v = ((d[o] | (d[o + 1] << 8) | (d[o + 2] << 16)) << 8 >> 8) / 8388608;
+                                    else v = (d[o] - 128) / 128;
+                                    dst[dstIdx + f * ch + c] = v;
+                                }
+                            }
+                        },
+                    };
+                } else {
+                    // Compressed: decode whole, keep 16-bit interleaved in JS
+                    for (;;) {
+                        const r = await reader.read();
+                        if (r.done) break;
+                        append(r.value);
+                    }
+                    const Ctx = window.AudioContext || window.webkitAudioContext;
+                    const ctx = new Ctx();
+                    const ab = await ctx.decodeAudioData(bytes.data.slice(0, bytes.length).buffer);
+                    bytes.data = null;
+                    const ch = ab.numberOfChannels, fr = ab.length;
+                    const pcm = new Int16Array(ch * fr);
+                    for (let c = 0; c < ch; c++) {
+                        const src = ab.getChannelData(c);
+                        for (let f = 0; f < fr; f++) {
+                            pcm[f * ch + c] = Math.round(Math.max(-1, Math.min(1, src[f])) * 32767);
+                        }
+                    }
+                    source = {
+                        channels: ch,
+                        sampleRate: ab.sampleRate,
+                        totalFrames: fr,
+                        available() { return fr; },
+                        finished() { return true; },
+                        decode(dst, dstIdx, frame, n) {
+                            const base = frame * ch;
+                            for (let i = 0; i < n * ch; i++) dst[dstIdx + i] = pcm[base + i] / 32768;
+                        },
+                    };
+                }
+
+                Module.HEAP32[(info >> 2) + 0] = source.channels;
+                Module.HEAP32[(info >> 2) + 1] = source.totalFrames;
+                Module.HEAPF32[(info >> 2) + 2] = source.sampleRate;
+                const id = streams.next++;
+                streams.map.set(id, { source, ring: 0, timer: 0 });
+                return id;
+            } catch (e) {
+                console.error('[WebSamplePlayer] stream open failed:', e);
+                return 0;
             }
+        },
+    };
+});
+
+// Blocking entry points (suspend via Asyncify)
+EM_ASYNC_JS(void*, _al_ws_fetch_and_decode, (const char* urlPtr, int int16), {
+    return await globalThis.__alSampleLoader.decode(UTF8ToString(urlPtr), int16);
+});
+
+EM_ASYNC_JS(int, _al_ws_stream_open, (const char* urlPtr, int32_t* info), {
+    return await globalThis.__alSampleLoader.open(UTF8ToString(urlPtr), info);
+});
+
+// Callback entry points: return at once, finish through the KEEPALIVE
+// functions at the end of this header
+EM_JS(void, _al_ws_decode_async, (const char* urlPtr, int int16, void* done), {
+    globalThis.__alSampleLoader.decode(UTF8ToString(urlPtr), int16).then(function (ptr) {
+        Module.ccall('_al_web_sample_decoded', null, ['number', 'number', 'number'], [done, ptr, int16]);
+    });
+});
+
+EM_JS(void, _al_ws_stream_open_async, (const char* urlPtr, void* pending, int32_t* info), {
+    globalThis.__alSampleLoader.open(UTF8ToString(urlPtr), info).then(function (id) {
+        Module.ccall('_al_web_sample_stream_opened', null, ['number', 'number'], [pending, id]);
+    });
+});
+
+// Start filling `ring` for stream `id` (10 ms timer plus immediately).
+EM_JS(void, _al_ws_stream_attach, (int id, void* ring), {
+    const streams = globalThis.__alSampleStreams;
+    const s = streams && streams.map.get(id);
+    if (!s) return;
+    s.ring = ring;
+    const H = ring >> 2;
+    const pump = () => {
+        // Views are re-read each pump: memory growth replaces them
+        const heap32 = Module.HEAP32, heapF32 = Module.HEAPF32;
+        const shared = typeof SharedArrayBuffer !== 'undefined' && heap32.buffer instanceof SharedArrayBuffer;
+        const load = (i) => shared ? Atomics.load(heap32, H + i) : heap32[H + i];
+        const store = (i, v) => shared ? Atomics.store(heap32, H + i, v) : (heap32[H + i] = v);
+
+        const seek = load(2);
+        if (seek >= 0) {
+            store(0, seek);
+            store(2, -1);
         }
-        return ptr;
-    } catch (e) {
-        console.error('[WebSamplePlayer] load failed:', e);
-        return 0;
-    }
+        const src = s.source;
+        const cap = load(4), ch = load(5);
+        let write = load(0);
+        const limit = Math.min(load(1) + cap, src.available());
+        const dataIdx = (ring + 32) >> 2;
+        while (write < limit) {
+            const slot = write % cap;
+            const n = Math.min(limit - write, cap - slot);
+            src.decode(heapF32, dataIdx + slot * ch, write, n);
+            write += n;
+            store(0, write);
+        }
+        const end = src.totalFrames >= 0 ? src.totalFrames : src.available();
+        store(3, src.finished() && write >= end ? 1 : 0);
+    };
+    s.pump = pump;
+    s.timer = setInterval(pump, 10);
+    pump();
+});
+
+EM_JS(void, _al_ws_stream_close, (int id), {
+    const streams = globalThis.__alSampleStreams;
+    const s = streams && streams.map.get(id);
+    if (!s) return;
+    clearInterval(s.timer);
+    streams.map.delete(id);
 });
 
 namespace al {
@@ -91,55 +392,153 @@ namespace al {
 /**
  * Web-based sample player using Web Audio API.
  *
- * Note: load() suspends via Asyncify until the file is decoded; on
- * return, ready() is true and read()/readInterp() work immediately.
+ * load(url, callback) and loadStreaming(url, seconds, callback) return at
+ * once and run the callback when the file is ready (ready() is then true)
+ * or has failed. load(url) and loadStreaming(url, seconds) suspend via
+ * Asyncify instead; see the note at the top of this header.
  */
 class WebSamplePlayer {
 public:
+    /// In-memory sample format for load()
+    enum class Storage { Float32, Int16 };
+
+    using LoadCallback = std::function<void(bool success)>;
+
     WebSamplePlayer() : mReady(false), mChannels(0), mFrames(0), mSampleRate(44100) {}
 
     ~WebSamplePlayer() {
-        if (mSamples) {
-            delete[] mSamples;
-            mSamples = nullptr;
+        // A pending load is dropped; its buffer or stream goes unused
+        cancel();
+    }
+
+    /**
+     * Load a sample from URL without suspending. `callback` runs with
+     * true once ready() (immediately if another player holds the decoded
+     * buffer), or with false after an error has been logged.
+     */
+    void load(const std::string& url, LoadCallback callback) {
+        begin(url);
+        mLoadCallback = std::move(callback);
+
+        const std::string key = cacheKey(url);
+        if (Buffer buffer = cache()[key].lock()) {
+            adopt(buffer);
+            finish(true);
+            return;
         }
+        const bool int16 = mStorage == Storage::Int16;
+        mTicket = AssetLoader::instance().request<Buffer>("sample:" + key, mPriority,
+            [url, int16](AssetLoader::Done<Buffer> done) {
+                installLoaderJS();
+                _al_ws_decode_async(url.c_str(), int16 ? 1 : 0,
+                                    new AssetLoader::Done<Buffer>(std::move(done)));
+            },
+            [this, key](const Buffer* buffer) {
+                mTicket = 0;
+                if (buffer && *buffer) {
+                    cache()[key] = *buffer;
+                    adopt(*buffer);
+                }
+                finish(buffer && *buffer);
+            });
     }
 
     /**
-     * Load a sample from URL. Suspends via Asyncify until decoded.
-     * On success, ready() returns true. On failure, ready() stays false
-     * and an error is logged to the console.
+     * Load a sample from URL. Suspends via Asyncify until decoded, so the
+     * sketch is linked with ASYNCIFY. On success, ready() returns true. On
+     * failure, ready() stays false and an error is logged to the console.
      */
     void load(const std::string& url) {
-        mReady = false;
-        mUrl = url;
+        begin(url);
 
-        void* p = _al_ws_fetch_and_decode(url.c_str());
-        if (!p) return;
+        const std::string key = cacheKey(url);
+        Buffer buffer = cache()[key].lock();
+        if (!buffer) {
+            buffer = schedule(key, url);
+            if (!buffer) return;
+            cache()[key] = buffer;
+        }
+        adopt(buffer);
+    }
 
-        // Read header (int32, int32, float32) then samples.
-        const auto* hdrInt   = reinterpret_cast<const int32_t*>(p);
-        const auto* hdrFloat = reinterpret_cast<const float*>(p);
-        const int   channels = hdrInt[0];
-        const int   frames   = hdrInt[1];
-        const float sampleRate = hdrFloat[2];
-        const auto* samples = reinterpret_cast<const float*>(
-            reinterpret_cast<const char*>(p) + 12);
-        const int totalSamples = channels * frames;
+    /**
+     * Stream from URL through a ring of `readAheadSeconds` without
+     * suspending. `callback` runs once the format is known (true, and
+     * read() returns frames as they arrive) or the stream failed (false).
+     */
+    void loadStreaming(const std::string& url, float readAheadSeconds, LoadCallback callback) {
+        begin(url);
+        mLoadCallback = std::move(callback);
 
-        if (mSamples) delete[] mSamples;
-        mSamples = new float[totalSamples];
-        for (int i = 0; i < totalSamples; ++i) mSamples[i] = samples[i];
+        installLoaderJS();
+        mPendingStream = new PendingStream{this, readAheadSeconds, {0, 0, 0}};
+        _al_ws_stream_open_async(url.c_str(), mPendingStream, mPendingStream->info);
+    }
 
-        mChannels   = channels;
-        mFrames     = frames;
-        mSampleRate = sampleRate;
-        mReady      = true;
+    /**
+     * Stream from URL through a ring of `readAheadSeconds`. Suspends via
+     * Asyncify until the format is known; ready() is then true and read()
+     * returns frames as they arrive. Returns false on failure.
+     */
+    bool loadStreaming(const std::string& url, float readAheadSeconds = 2.0f) {
+        begin(url);
 
-        std::free(p);
+        installLoaderJS();
+        int32_t info[3] = {0, 0, 0};
+        const int id = _al_ws_stream_open(url.c_str(), info);
+        return openStream(id, info, readAheadSeconds);
+    }
+
+    /**
+     * AssetLoader priority for load() (higher loads sooner). Applies to a
+     * queued load too.
+     */
+    void setPriority(float priority) {
+        mPriority = priority;
+        if (mTicket) AssetLoader::instance().setPriority(mTicket, priority);
+    }
+    float priority() const { return mPriority; }
+
+    /// Drop a pending callback load; the callback won't run
+    void cancel() {
+        if (mTicket) AssetLoader::instance().cancel(mTicket);
+        mTicket = 0;
+        if (mPendingStream) mPendingStream->player = nullptr;
+        mPendingStream = nullptr;
+    }
+
+    /// True while a callback load is queued or in flight
+    bool loading() const { return mTicket != 0 || mPendingStream != nullptr; }
+
+    /// Sample format for the next load(); Int16 halves memory
+    void setStorage(Storage storage) { mStorage = storage; }
+    Storage storage() const { return mStorage; }
+    bool streaming() const { return mStream != nullptr; }
+
+    /// Streaming: whole file has been written through the ring
+    bool streamComplete() const {
+        return mStream && mStream->ring->state.load(std::memory_order_acquire) == 1;
+    }
+
+    /// Streaming: frames available from the current read position
+    int bufferedFrames() const {
+        if (!mStream) return mFrames;
+        const StreamRing& r = *mStream->ring;
+        return std::max(0, r.writeFrame.load(std::memory_order_acquire) -
+                               r.readFrame.load(std::memory_order_relaxed));
+    }
 
-        std::printf("[WebSamplePlayer] Loaded: %d channels, %d frames, %.0f Hz\n",
-                    channels, frames, sampleRate);
+    /// Streaming: reads that fell outside the ring (not yet arrived, or
+    /// behind the read position)
+    int underruns() const { return mStream ? mStream->underruns : 0; }
+
+    /// Streaming: continue from `frame` (the ring refills from there)
+    void seek(int frame) {
+        if (!mStream) return;
+        StreamRing& r = *mStream->ring;
+        frame = std::max(0, frame);
+        r.readFrame.store(frame, std::memory_order_relaxed);
+        r.seekFrame.store(frame, std::memory_order_release);
     }
 
     bool  ready()      const { return mReady; }
@@ -149,9 +548,12 @@ public:
     float duration()   const { return mFrames / (float)mSampleRate; }
 
     float read(int channel, int frame) const {
-        if (!mReady || !mSamples) return 0;
-        if (frame < 0 || frame >= mFrames) return 0;
-        if (channel < 0 || channel >= mChannels) return 0;
+        if (!mReady) return 0;
+        if (channel < 0 || channel >= mChannels || frame < 0) return 0;
+        if (mStream) return readStream(channel, frame);
+        if (frame >= mFrames) return 0;
+        if (mSamples16) return mSamples16[frame * mChannels + channel] * (1.0f / 32768.0f);
+        if (!mSamples) return 0;
         return mSamples[frame * mChannels + channel];
     }
 
@@ -165,17 +567,269 @@ public:
         return s0 + (s1 - s0) * frac;
     }
 
+    /// Interleaved float samples; null for Int16 storage and streams
     const float* data() const { return mSamples; }
 
+    // Internal callbacks from JavaScript (see the KEEPALIVE functions below)
+    static void _onSampleDecoded(void* done, void* packed, int int16) {
+        auto* pending = static_cast<AssetLoader::Done<Buffer>*>(done);
+        Buffer buffer = packed ? unpack(packed, int16 != 0) : nullptr;
+        (*pending)(buffer ? &buffer : nullptr, bufferBytes(buffer));
+        delete pending;
+    }
+
+    // id 0 means the stream failed to open
+    static void _onStreamOpened(void* pendingPtr, int id) {
+        auto* pending = static_cast<PendingStream*>(pendingPtr);
+        WebSamplePlayer* player = pending->player;
+        if (!player) {
+            // Cancelled (or the player is gone) while the stream was opening
+            if (id) _al_ws_stream_close(id);
+            delete pending;
+            return;
+        }
+        player->mPendingStream = nullptr;
+        const bool ok = player->openStream(id, pending->info, pending->readAheadSeconds);
+        delete pending;
+        player->finish(ok);
+    }
+
 private:
+    struct SampleBuffer {
+        std::vector<float> samples;      // Interleaved (Storage::Float32)
+        std::vector<int16_t> samples16;  // Interleaved (Storage::Int16)
+        int channels = 0;
+        int frames = 0;
+        float sampleRate = 44100;
+    };
+    using Buffer = std::shared_ptr<const SampleBuffer>;
+
+    /// Ring header shared with JS by field offset (see _al_ws_stream_attach)
+    struct StreamRing {
+        std::atomic<int32_t> writeFrame{0};
+        std::atomic<int32_t> readFrame{0};
+        std::atomic<int32_t> seekFrame{-1};
+        std::atomic<int32_t> state{0};
+        int32_t capacity = 0;
+        int32_t channels = 0;
+        int32_t pad[2] = {};
+        float* data() { return reinterpret_cast<float*>(this + 1); }
+    };
+    static_assert(sizeof(StreamRing) == 32, "StreamRing is read by offset from JS");
+
+    /// A callback loadStreaming() waiting for the format; JS writes `info`
+    struct PendingStream {
+        WebSamplePlayer* player;  // Null once cancelled
+        float readAheadSeconds;
+        int32_t info[3];
+    };
+    static constexpr int kStreamKeepFrames = 256;
+
+    /// One open stream; closed when the last player sharing it goes away
+    struct Stream {
+        Stream(int id, StreamRing* ring) : id(id), ring(ring) {}
+        ~Stream() {
+            _al_ws_stream_close(id);
+            ring->~StreamRing();
+            std::free(ring);
+        }
+        Stream(const Stream&) = delete;
+        Stream& operator=(const Stream&) = delete;
+
+        int id;
+        StreamRing* ring;
+        int underruns = 0;
+    };
+
+    float readStream(int channel, int frame) const {
+        StreamRing& r = *mStream->ring;
+        const int written = r.writeFrame.load(std::memory_order_acquire);
+        const int read = r.readFrame.load(std::memory_order_relaxed);
+        if (frame >= written || frame < read || frame < written - r.capacity) {
+            if (channel == 0) mStream->underruns++;
+            return 0;
+        }
+        // Release frames well behind this one for JS to refill; the margin
+        // keeps readInterp() and small rewinds inside the ring
+        const int keep = frame - kStreamKeepFrames;
+        if (keep > read) r.readFrame.store(keep, std::memory_order_release);
+        return r.data()[(frame % r.capacity) * r.channels + channel];
+    }
+
+    /// Decoded buffers still held by some player, by URL
+    static std::unordered_map<std::string, std::weak_ptr<const SampleBuffer>>& cache() {
+        static std::unordered_map<std::string, std::weak_ptr<const SampleBuffer>> buffers;
+        return buffers;
+    }
+
+    std::string cacheKey(const std::string& url) const {
+        return (mStorage == Storage::Int16 ? "i16:" : "f32:") + url;
+    }
+
+    static void installLoaderJS() {
+        static bool installed = false;
+        if (!installed) _al_ws_install_loader();
+        installed = true;
+    }
+
+    /// Drop whatever the player held and any pending load
+    void begin(const std::string& url) {
+        cancel();
+        mReady = false;
+        mUrl = url;
+        mLoadCallback = nullptr;
+        mBuffer.reset();
+        mSamples = nullptr;
+        mSamples16 = nullptr;
+        mStream.reset();
+    }
+
+    void adopt(const Buffer& buffer) {
+        mBuffer     = buffer;
+        mSamples    = buffer->samples.empty() ? nullptr : buffer->samples.data();
+        mSamples16  = buffer->samples16.empty() ? nullptr : buffer->samples16.data();
+        mChannels   = buffer->channels;
+        mFrames     = buffer->frames;
+        mSampleRate = buffer->sampleRate;
+        mReady      = true;
+
+        std::printf("[WebSamplePlayer] Loaded: %d channels, %d frames, %.0f Hz%s\n",
+                    mChannels, mFrames, mSampleRate, mSamples16 ? " (16-bit)" : "");
+    }
+
+    void finish(bool success) {
+        // The callback may start another load, which replaces mLoadCallback
+        LoadCallback callback = std::move(mLoadCallback);
+        mLoadCallback = nullptr;
+        if (callback) callback(success);
+    }
+
+    /// Set up the ring for an opened stream (id 0: open failed)
+    bool openStream(int id, const int32_t info[3], float readAheadSeconds) {
+        if (!id) return false;
+        if (info[0] <= 0) {
+            _al_ws_stream_close(id);
+            return false;
+        }
+        float sampleRate;
+        std::memcpy(&sampleRate, &info[2], sizeof(float));
+
+        const int channels = info[0];
+        const int capacity = std::max(1024, int(readAheadSeconds * sampleRate));
+        auto* ring = static_cast<StreamRing*>(
+            std::malloc(sizeof(StreamRing) + size_t(capacity) * channels * sizeof(float)));
+        if (!ring) {
+            _al_ws_stream_close(id);
+            return false;
+        }
+        new (ring) StreamRing();
+        ring->capacity = capacity;
+        ring->channels = channels;
+
+        mStream     = std::make_shared<Stream>(id, ring);
+        mChannels   = channels;
+        mFrames     = info[1];  // -1 until the stream ends if the header didn't say
+        mSampleRate = sampleRate;
+        mReady      = true;
+        _al_ws_stream_attach(id, ring);
+
+        std::printf("[WebSamplePlayer] Streaming: %d channels, %d frames, %.0f Hz, %d-frame ring\n",
+                    mChannels, mFrames, mSampleRate, capacity);
+        return true;
+    }
+
+    /// Blocking load(): wait for an AssetLoader slot, then fetch and
+    /// decode; or wait for an identical load already queued or in flight
+    /// and share its buffer. The lambdas hold references into this frame,
+    /// which stays alive (suspended) until the result arrives.
+    Buffer schedule(const std::string& key, const std::string& url) {
+        AssetLoader::Done<Buffer> slot;
+        bool granted = false;
+        bool finished = false;
+        Buffer result;
+        AssetLoader::instance().request<Buffer>("sample:" + key, mPriority,
+            [&](AssetLoader::Done<Buffer> done) {
+                slot = std::move(done);
+                granted = true;
+            },
+            [&](const Buffer* buffer) {
+                if (buffer) result = *buffer;
+                finished = true;
+            });
+        while (!granted && !finished) emscripten_sleep(1);
+
+        if (granted) {
+            installLoaderJS();
+            void* packed = _al_ws_fetch_and_decode(url.c_str(), mStorage == Storage::Int16 ? 1 : 0);
+            Buffer buffer = packed ? unpack(packed, mStorage == Storage::Int16) : nullptr;
+            slot(buffer ? &buffer : nullptr, bufferBytes(buffer));
+        }
+        return result;
+    }
+
+    /// Copy a packed buffer from _al_ws_install_loader's decode() and free it
+    static Buffer unpack(void* p, bool int16) {
+        // Read header (int32, int32, float32) then samples.
+        const auto* hdrInt   = reinterpret_cast<const int32_t*>(p);
+        const auto* hdrFloat = reinterpret_cast<const float*>(p);
+        const char* samples = reinterpret_cast<const char*>(p) + 12;
+
+        auto buffer = std::make_shared<SampleBuffer>();
+        buffer->channels   = hdrInt[0];
+        buffer->frames     = hdrInt[1];
+        buffer->sampleRate = hdrFloat[2];
+        const size_t count = size_t(buffer->channels) * buffer->frames;
+        if (int16) {
+            const auto* s16 = reinterpret_cast<const int16_t*>(samples);
+            buffer->samples16.assign(s16, s16 + count);
+        } else {
+            const auto* f32 = reinterpret_cast<const float*>(samples);
+            buffer->samples.assign(f32, f32 + count);
+        }
+
+        std::free(p);
+        return buffer;
+    }
+
+    static size_t bufferBytes(const Buffer& buffer) {
+        return buffer ? buffer->samples.size() * sizeof(float) +
+                            buffer->samples16.size() * sizeof(int16_t)
+                      : 0;
+    }
+
     bool mReady;
     std::string mUrl;
-    float* mSamples = nullptr;
+    Buffer mBuffer;                  // Shared with players of the same URL
+    std::shared_ptr<Stream> mStream; // Set while streaming
+    const float* mSamples = nullptr;
+    const int16_t* mSamples16 = nullptr;
+    Storage mStorage = Storage::Float32;
     int mChannels;
     int mFrames;
     float mSampleRate;
+    float mPriority = 0.0f;
+    LoadCallback mLoadCallback;
+    AssetLoader::Ticket mTicket = 0;
+    PendingStream* mPendingStream = nullptr;  // Callback loadStreaming() in flight
 };
 
 } // namespace al
 
+// C callbacks for JavaScript
+extern "C" {
+    EMSCRIPTEN_KEEPALIVE
+    inline void _al_web_sample_decoded(void* done, void* packed, int int16) {
+        if (done) {
+            al::WebSamplePlayer::_onSampleDecoded(done, packed, int16);
+        }
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    inline void _al_web_sample_stream_opened(void* pending, int id) {
+        if (pending) {
+            al::WebSamplePlayer::_onStreamOpened(pending, id);
+        }
+    }
+}
+
 #endif // AL_WEB_SAMPLE_PLAYER_HPP
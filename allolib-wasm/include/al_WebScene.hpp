@@ -18,6 +18,8 @@
  *   - sampleAnimation(idx, time)
  *   - animatedMesh()
  *   - primitiveMaterial(i)  (PBR — vanilla al::Scene's Material is Phong)
+ *   - meshReady(i) / meshesReady() / progress()  (progressive loading)
+ *   - writeCache(path) / importCache(path, bundle)  (al_WebMeshCache.hpp)
  * Available via the underlying gltf() accessor when user code opts in.
  *
  * Caller owns the returned WebScene* (matches al::Scene::import which
@@ -28,6 +30,7 @@
 #define AL_WEB_SCENE_HPP
 
 #include "al_WebGLTF.hpp"
+#include "al_WebMeshCache.hpp"
 
 namespace al {
 
@@ -53,6 +56,7 @@ public:
     }
 
     /// Read primitive `i` into `dst`. Mirrors al::Scene::mesh(i, dst).
+    /// While meshReady(i) is false this is its bounding-box placeholder.
     void mesh(unsigned int i, Mesh& dst) const {
         if (i >= mInner.primitiveCount()) return;
         dst.copy(mInner.primitiveMesh(i));
@@ -62,8 +66,31 @@ public:
     /// al::Scene::meshAll(dst).
     void meshAll(Mesh& dst) const { dst.copy(mInner.mesh()); }
 
-    /// Get axis-aligned bounding box of the combined geometry.
+    /// Studio-fork extension: true once mesh(i) is the real geometry
+    /// rather than a placeholder. A .gltf with external buffers streams
+    /// in, so meshes() is known well before every mesh is ready.
+    bool meshReady(unsigned int i) const { return mInner.primitiveReady(i); }
+    unsigned int meshesReady() const {
+        return static_cast<unsigned int>(mInner.readyPrimitiveCount());
+    }
+    /// Fraction of the buffer bytes received so far
+    float progress() const { return mInner.progress(); }
+
+    /// Get axis-aligned bounding box of the combined geometry. Mid-load
+    /// this also covers the placeholders of meshes still streaming.
     void getBounds(Vec3f& mn, Vec3f& mx) const {
+        if (!mInner.ready() && mInner.primitiveCount() > 0) {
+            mInner.primitiveBounds(0, mn, mx);
+            for (size_t i = 1; i < mInner.primitiveCount(); ++i) {
+                Vec3f a, b;
+                mInner.primitiveBounds(i, a, b);
+                for (int k = 0; k < 3; ++k) {
+                    mn[k] = a[k] < mn[k] ? a[k] : mn[k];
+                    mx[k] = b[k] > mx[k] ? b[k] : mx[k];
+                }
+            }
+            return;
+        }
         const auto& verts = mInner.mesh().vertices();
         if (verts.empty()) {
             mn = mx = Vec3f(0, 0, 0);
@@ -89,6 +116,22 @@ public:
     WebGLTF&       gltf()       { return mInner; }
     const WebGLTF& gltf() const { return mInner; }
 
+    /// Studio-fork extension: bundle the combined geometry (plus an
+    /// optional LOD chain) into the binary mesh cache format and write it
+    /// to `path`, e.g. under WebMeshCache::cacheDirectory(). Returns false
+    /// before the scene has loaded.
+    bool writeCache(const std::string& path, int lodLevels = 1) const {
+        if (mInner.mesh().vertices().empty()) return false;
+        MeshBundle bundle;
+        WebMeshCache::build(mInner.mesh(), bundle, lodLevels);
+        return WebMeshCache::save(bundle, path);
+    }
+
+    /// Counterpart to writeCache(): loads a bundle with no glTF parsing.
+    static bool importCache(const std::string& path, MeshBundle& out) {
+        return WebMeshCache::load(path, out);
+    }
+
 private:
     WebGLTF mInner;
 };
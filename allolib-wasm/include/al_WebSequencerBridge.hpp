@@ -5,13 +5,26 @@
  * synth voices from the browser-based sequencer. These functions hook
  * into the SynthGUIManager's PolySynth voice pool.
  *
- * The JavaScript sequencer transport calls these at scheduled event times
- * during playback.
+ * Calls never touch the PolySynth directly. They push timestamped events
+ * onto a lock-free single-producer / single-consumer queue, which
+ * SynthGUIManager::render() drains at the top of each audio block. An
+ * event due inside the block starts its voice at that frame offset, via
+ * PolySynth's per-voice onset offset, so onsets are sample accurate. An
+ * enqueue is O(1) however many notes the sequencer bursts.
+ *
+ * Times are frames on the bridge's audio clock (al_seq_current_frame(),
+ * advanced by every rendered block). Events should be pushed in time
+ * order: the queue is FIFO, so an event stuck behind a later one fires
+ * with it. Frame 0 (the plain trigger calls) means "next block, offset 0".
  *
  * Usage from JavaScript:
  *   module._al_seq_trigger_on(voiceId, freq, amp, dur)
  *   module._al_seq_trigger_off(voiceId)
  *   module._al_seq_set_param(voiceId, paramIndex, value)
+ *
+ *   const f = module._al_seq_current_frame() + lookaheadFrames
+ *   module._al_seq_schedule_on(f, voiceId, freq, amp, dur)
+ *   module._al_seq_schedule_off(f + durFrames, voiceId)
  */
 
 #ifndef AL_WEB_SEQUENCER_BRIDGE_HPP
@@ -20,12 +33,74 @@
 #ifdef __EMSCRIPTEN__
 
 #include <emscripten.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include "al_WebControlGUI.hpp"
 #include "al/ui/al_Parameter.hpp"
 #include "al/scene/al_PolySynth.hpp"
 
 namespace al {
 
+struct SequencerEvent {
+    enum Type : int32_t { kTriggerOn, kTriggerOff, kSetParam };
+
+    uint64_t frame = 0;     // Bridge audio clock; 0 = as soon as possible
+    int32_t type = kTriggerOn;
+    int32_t id = 0;         // Voice id (on/off)
+    float freq = 0.0f;      // kTriggerOn
+    float amp = 0.0f;       // kTriggerOn
+    float dur = 0.0f;       // kTriggerOn, informational
+    int32_t paramIndex = 0; // kSetParam
+    float value = 0.0f;     // kSetParam
+};
+
+/**
+ * Fixed-capacity single-producer / single-consumer ring. push() is the
+ * only producer call (main thread, from JS); front()/pop() are the only
+ * consumer calls (audio callback). Neither side ever blocks.
+ */
+template <size_t Capacity>
+class SequencerEventQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /// Producer: false (and counted in dropped()) when the ring is full
+    bool push(const SequencerEvent& e) {
+        const uint32_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) >= Capacity) {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        mEvents[tail & (Capacity - 1)] = e;
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer: oldest event, or nullptr when empty
+    const SequencerEvent* front() const {
+        const uint32_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire)) return nullptr;
+        return &mEvents[head & (Capacity - 1)];
+    }
+
+    /// Consumer: drop the event returned by front()
+    void pop() {
+        mHead.store(mHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    uint32_t size() const {
+        return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+    }
+    uint32_t dropped() const { return mDropped.load(std::memory_order_relaxed); }
+
+private:
+    std::array<SequencerEvent, Capacity> mEvents{};
+    std::atomic<uint32_t> mHead{0};
+    std::atomic<uint32_t> mTail{0};
+    std::atomic<uint32_t> mDropped{0};
+};
+
 /**
  * WebSequencerBridge provides a static interface for the JS sequencer
  * to trigger voices in the active SynthGUIManager's PolySynth.
@@ -54,9 +129,119 @@ public:
     static PolySynth* getPolySynth() { return sPolySynth; }
     static const std::vector<ParameterMeta*>& getControlParams() { return sControlParams; }
 
+    using EventQueue = SequencerEventQueue<4096>;
+    static EventQueue& events() { return sEvents; }
+
+    /// Frames rendered so far; the time base for scheduled events
+    static uint64_t currentFrame() { return sFrame.load(std::memory_order_acquire); }
+
+    /**
+     * Audio thread, once per block before the PolySynth processes voices:
+     * apply every event due before the end of this block at its offset,
+     * then advance the clock. Late events play at offset 0.
+     */
+    static void dispatch(int numFrames) {
+        const uint64_t start = sFrame.load(std::memory_order_relaxed);
+        const uint64_t end = start + uint64_t(numFrames > 0 ? numFrames : 0);
+        while (const SequencerEvent* e = sEvents.front()) {
+            if (e->frame >= end) break;
+            const int offset = e->frame > start ? int(e->frame - start) : 0;
+            switch (e->type) {
+                case SequencerEvent::kTriggerOn:
+                    triggerOn(e->id, e->freq, e->amp, offset);
+                    break;
+                case SequencerEvent::kTriggerOff:
+                    triggerOff(e->id, offset);
+                    break;
+                case SequencerEvent::kSetParam:
+                    setParam(e->paramIndex, e->value);
+                    break;
+            }
+            sEvents.pop();
+        }
+        sFrame.store(end, std::memory_order_release);
+    }
+
 private:
+    // Audio thread: configure a free voice and start it `offset` frames
+    // into the current block
+    static void triggerOn(int id, float freq, float amp, int offset) {
+        auto* synth = sPolySynth;
+        if (!synth) {
+            EM_ASM({ console.warn('[SeqBridge] No PolySynth registered'); });
+            return;
+        }
+
+        // Get a voice from the pool
+        auto* voice = synth->getFreeVoice();
+        if (!voice) {
+            EM_ASM({ console.warn('[SeqBridge] No free voice available'); });
+            return;
+        }
+
+        // Set parameters on the voice by name convention
+        // AlloLib synth voices typically have "frequency" and "amplitude" parameters
+        auto params = voice->triggerParameters();
+        for (auto* paramMeta : params) {
+            auto* param = dynamic_cast<Parameter*>(paramMeta);
+            if (!param) continue;
+
+            const std::string& name = param->getName();
+            if (name == "frequency" || name == "freq") {
+                param->set(freq);
+            } else if (name == "amplitude" || name == "amp") {
+                param->set(amp);
+            }
+        }
+
+        // Also copy control voice parameters for any other settings
+        for (size_t i = 0; i < sControlParams.size() && i < params.size(); i++) {
+            auto* src = dynamic_cast<Parameter*>(sControlParams[i]);
+            auto* dst = dynamic_cast<Parameter*>(params[i]);
+            if (!src || !dst) continue;
+
+            const std::string& name = dst->getName();
+            // Skip freq/amp since we already set them from the sequencer
+            if (name == "frequency" || name == "freq" ||
+                name == "amplitude" || name == "amp") continue;
+
+            dst->set(src->get());
+        }
+
+        voice->id(id);
+        synth->triggerOn(voice, offset, id);
+    }
+
+    // Audio thread: release voice `id` `offset` frames into the block. A
+    // voice triggered earlier in this same block is still in PolySynth's
+    // insert queue, so it falls back to the queued release (offset 0).
+    static void triggerOff(int id, int offset) {
+        auto* synth = sPolySynth;
+        if (!synth) return;
+        for (auto* voice = synth->getActiveVoices(); voice; voice = voice->next) {
+            if (voice->id() == id && voice->active()) {
+                voice->triggerOff(offset);
+                return;
+            }
+        }
+        synth->triggerOff(id);
+    }
+
+    // Parameter changes land on the control voice, whose values are copied
+    // into the next triggered voice (applied in order with the triggers)
+    static void setParam(int paramIndex, float value) {
+        if (paramIndex >= 0 && paramIndex < static_cast<int>(sControlParams.size())) {
+            auto* param = dynamic_cast<Parameter*>(sControlParams[paramIndex]);
+            if (param) {
+                param->set(value);
+            }
+        }
+    }
+
     static inline PolySynth* sPolySynth = nullptr;
     static inline std::vector<ParameterMeta*> sControlParams;
+    static inline EventQueue sEvents;
+    static inline std::atomic<uint64_t> sFrame{0};
 };
 
 } // namespace al
@@ -68,7 +253,7 @@ private:
 extern "C" {
 
 /**
- * Trigger a voice with the given parameters.
+ * Trigger a voice with the given parameters at the start of the next block.
  *
  * @param id     Voice ID for later release
  * @param freq   Frequency in Hz (set on the voice's "frequency" parameter)
@@ -77,69 +262,33 @@ extern "C" {
  */
 __attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_seq_trigger_on(int id, float freq, float amp, float dur) {
-    auto* synth = al::WebSequencerBridge::getPolySynth();
-    if (!synth) {
-        EM_ASM({ console.warn('[SeqBridge] No PolySynth registered'); });
-        return;
-    }
-
-    // Get a voice from the pool
-    auto* voice = synth->getFreeVoice();
-    if (!voice) {
-        EM_ASM({ console.warn('[SeqBridge] No free voice available'); });
-        return;
-    }
-
-    // Set parameters on the voice by name convention
-    // AlloLib synth voices typically have "frequency" and "amplitude" parameters
-    auto params = voice->triggerParameters();
-    for (auto* paramMeta : params) {
-        auto* param = dynamic_cast<al::Parameter*>(paramMeta);
-        if (!param) continue;
-
-        const std::string& name = param->getName();
-        if (name == "frequency" || name == "freq") {
-            param->set(freq);
-        } else if (name == "amplitude" || name == "amp") {
-            param->set(amp);
-        }
-    }
-
-    // Also copy control voice parameters for any other settings
-    auto& controlParams = al::WebSequencerBridge::getControlParams();
-    auto voiceParams = voice->triggerParameters();
-    for (size_t i = 0; i < controlParams.size() && i < voiceParams.size(); i++) {
-        auto* src = dynamic_cast<al::Parameter*>(controlParams[i]);
-        auto* dst = dynamic_cast<al::Parameter*>(voiceParams[i]);
-        if (!src || !dst) continue;
-
-        const std::string& name = dst->getName();
-        // Skip freq/amp since we already set them from the sequencer
-        if (name == "frequency" || name == "freq" ||
-            name == "amplitude" || name == "amp") continue;
-
-        dst->set(src->get());
-    }
-
-    voice->id(id);
-    synth->triggerOn(voice);
+    al::SequencerEvent e;
+    e.type = al::SequencerEvent::kTriggerOn;
+    e.id = id;
+    e.freq = freq;
+    e.amp = amp;
+    e.dur = dur;
+    al::WebSequencerBridge::events().push(e);
 }
 
 /**
- * Release (trigger off) a voice by ID.
+ * Release (trigger off) a voice by ID at the start of the next block.
  *
  * @param id  The voice ID passed to al_seq_trigger_on
  */
 __attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_seq_trigger_off(int id) {
-    auto* synth = al::WebSequencerBridge::getPolySynth();
-    if (!synth) return;
-
-    synth->triggerOff(id);
+    al::SequencerEvent e;
+    e.type = al::SequencerEvent::kTriggerOff;
+    e.id = id;
+    al::WebSequencerBridge::events().push(e);
 }
 
 /**
- * Set a parameter on a triggered voice by index.
+ * Set a parameter by index before the next trigger.
+ *
+ * Parameter changes land on the control voice, so they configure the
+ * next triggered voice; voiceId is accepted for API symmetry.
  *
  * @param voiceId    The voice ID
  * @param paramIndex Parameter index in the voice's triggerParameters list
@@ -147,20 +296,62 @@ inline void al_seq_trigger_off(int id) {
  */
 __attribute__((used)) EMSCRIPTEN_KEEPALIVE
 inline void al_seq_set_param(int voiceId, int paramIndex, float value) {
-    auto* synth = al::WebSequencerBridge::getPolySynth();
-    if (!synth) return;
-
-    // Find the voice by ID in active voices - this is a best-effort operation
-    // In practice, parameter changes during playback are less common than
-    // trigger on/off, so iterating active voices is acceptable
-    // For now, we'll use the control voice parameters as a fallback
-    auto& controlParams = al::WebSequencerBridge::getControlParams();
-    if (paramIndex >= 0 && paramIndex < static_cast<int>(controlParams.size())) {
-        auto* param = dynamic_cast<al::Parameter*>(controlParams[paramIndex]);
-        if (param) {
-            param->set(value);
-        }
-    }
+    al::SequencerEvent e;
+    e.type = al::SequencerEvent::kSetParam;
+    e.id = voiceId;
+    e.paramIndex = paramIndex;
+    e.value = value;
+    al::WebSequencerBridge::events().push(e);
+}
+
+/**
+ * Sample-accurate variants: `frame` is on the al_seq_current_frame() clock.
+ */
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline void al_seq_schedule_on(double frame, int id, float freq, float amp, float dur) {
+    al::SequencerEvent e;
+    e.frame = frame > 0 ? uint64_t(frame) : 0;
+    e.type = al::SequencerEvent::kTriggerOn;
+    e.id = id;
+    e.freq = freq;
+    e.amp = amp;
+    e.dur = dur;
+    al::WebSequencerBridge::events().push(e);
+}
+
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline void al_seq_schedule_off(double frame, int id) {
+    al::SequencerEvent e;
+    e.frame = frame > 0 ? uint64_t(frame) : 0;
+    e.type = al::SequencerEvent::kTriggerOff;
+    e.id = id;
+    al::WebSequencerBridge::events().push(e);
+}
+
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline void al_seq_schedule_param(double frame, int voiceId, int paramIndex, float value) {
+    al::SequencerEvent e;
+    e.frame = frame > 0 ? uint64_t(frame) : 0;
+    e.type = al::SequencerEvent::kSetParam;
+    e.id = voiceId;
+    e.paramIndex = paramIndex;
+    e.value = value;
+    al::WebSequencerBridge::events().push(e);
+}
+
+/**
+ * Frames rendered so far (the scheduling clock). Rendering runs ahead of
+ * playback by the output buffering, so schedule at least a block ahead.
+ */
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline double al_seq_current_frame() {
+    return double(al::WebSequencerBridge::currentFrame());
+}
+
+/// Events rejected because the queue was full
+__attribute__((used)) EMSCRIPTEN_KEEPALIVE
+inline int al_seq_get_dropped_events() {
+    return int(al::WebSequencerBridge::events().dropped());
 }
 
 /**
@@ -18,6 +18,23 @@
  *   // Loads brick_albedo_2k.jpg, brick_normal_2k.jpg, etc.
  *
  *   bricks.bind(0, cameraDistance);  // Binds all maps with LOD
+ *
+ * Compressed Usage:
+ *   tex.load("/assets/textures/brick.ktx2");
+ *   bricks.load("/assets/textures/brick", {2048, 1024, 512}, ".ktx2");
+ *   // .ktx2 levels stay block-compressed on the GPU (BC7/ETC2/ASTC, see
+ *   // WebKTX2) with their pre-baked mip chains: 4-8x less texture memory
+ *
+ * Streaming Usage (bounded texture memory):
+ *   TextureStreamer::instance().setBudget(256 * 1024 * 1024);
+ *   bricks.loadStreamed("/assets/textures/brick", {4096, 2048, 1024, 512});
+ *   // Only the 512 levels load now; finer levels follow on demand
+ *
+ *   // Once per frame (onAnimate)
+ *   TextureStreamer::instance().update();
+ *
+ *   // In onDraw - requests the level for the object's projected size
+ *   bricks.bindScreenSize(0, projectedPixels);
  */
 
 #ifndef AL_WEB_TEXTURE_HPP
@@ -33,12 +50,17 @@
 #include <memory>
 #include <array>
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
 
 #include "al_WebImage.hpp"
+#include "al_WebKTX2.hpp"
 #include "al_WebLOD.hpp"
 
 namespace al {
 
+class TextureStreamer;
+
 /**
  * Multi-resolution texture with LOD support
  */
@@ -49,6 +71,7 @@ public:
     WebTexture() : mCurrentLevel(0), mReady(false), mUploaded(false) {}
 
     ~WebTexture() {
+        cancelFetches();
         destroy();
     }
 
@@ -56,21 +79,23 @@ public:
      * Load single texture from URL
      */
     void load(const std::string& url, LoadCallback callback = nullptr) {
+        if (mStreamed) destroy();
+        cancelFetches();
         mCallback = callback;
         mLevels.clear();
         mLevels.resize(1);
         mLevels[0].url = url;
         mLevels[0].resolution = 0;  // Unknown until loaded
 
-        mLevels[0].image.load(url, [this](bool success) {
+        fetch(mLevels[0], mLoadPriority, [this](bool success) {
             if (success) {
-                mLevels[0].resolution = mLevels[0].image.width();
+                mLevels[0].resolution = levelWidth(mLevels[0]);
                 mLevels[0].loaded = true;
                 mReady = true;
                 printf("[WebTexture] Loaded: %s (%dx%d)\n",
                        mLevels[0].url.c_str(),
-                       mLevels[0].image.width(),
-                       mLevels[0].image.height());
+                       levelWidth(mLevels[0]),
+                       levelHeight(mLevels[0]));
             }
             if (mCallback) mCallback(success, 0);
         });
@@ -87,6 +112,8 @@ public:
     void loadMultiRes(const std::string& basePath,
                       const std::vector<int>& resolutions,
                       const std::string& extension = ".jpg") {
+        if (mStreamed) destroy();
+        cancelFetches();
         mLevels.clear();
         mLevels.resize(resolutions.size());
         mLoadedCount = 0;
@@ -95,12 +122,19 @@ public:
         // Set up LOD thresholds
         mLOD.setLevels(std::vector<int>(resolutions.begin(), resolutions.end()));
 
+        // Queue the smallest levels first so something can draw early
+        std::vector<size_t> order(resolutions.size());
         for (size_t i = 0; i < resolutions.size(); i++) {
             mLevels[i].resolution = resolutions[i];
             mLevels[i].url = basePath + "_" + resolutionSuffix(resolutions[i]) + extension;
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return resolutions[a] < resolutions[b];
+        });
 
-            size_t idx = i;
-            mLevels[i].image.load(mLevels[i].url, [this, idx](bool success) {
+        for (size_t idx : order) {
+            fetch(mLevels[idx], mLoadPriority, [this, idx](bool success) {
                 if (success) {
                     mLevels[idx].loaded = true;
                     mLoadedCount++;
@@ -119,6 +153,28 @@ public:
         }
     }
 
+    /**
+     * Load a multi-resolution texture whose levels are streamed under
+     * TextureStreamer's memory budget. Only the coarsest level is fetched
+     * now; finer levels are fetched, uploaded and evicted by
+     * TextureStreamer::update() as bind requests come in.
+     * @param resolutions Resolution levels, highest first
+     */
+    inline void loadStreamed(const std::string& basePath,
+                             const std::vector<int>& resolutions,
+                             const std::string& extension = ".jpg");
+
+    /**
+     * AssetLoader priority for load() and loadMultiRes() (higher loads
+     * sooner, e.g. AssetLoader::distancePriority()). Streamed levels are
+     * ranked by their bind requests instead.
+     */
+    void setPriority(float priority) {
+        mLoadPriority = priority;
+        if (mStreamed) return;
+        for (auto& lvl : mLevels) setFetchPriority(lvl, priority);
+    }
+
     /**
      * Set LOD distance thresholds
      */
@@ -140,6 +196,20 @@ public:
      */
     void bind(int unit, float distance) {
         int level = mLOD.selectLevel(distance);
+        if (mStreamed) request(level, distanceToPixels(distance));
+        bindLevel(unit, level);
+    }
+
+    /**
+     * Bind the coarsest level that still has a texel per pixel
+     * @param pixels Projected screen size of the textured surface
+     */
+    void bindScreenSize(int unit, float pixels) {
+        int level = 0;
+        for (int i = (int)mLevels.size() - 1; i >= 0; i--) {
+            if (mLevels[i].resolution >= pixels || i == 0) { level = i; break; }
+        }
+        if (mStreamed) request(level, pixels);
         bindLevel(unit, level);
     }
 
@@ -150,6 +220,28 @@ public:
         // Clamp to valid range
         level = std::max(0, std::min(level, (int)mLevels.size() - 1));
 
+        if (mStreamed) {
+            // Levels arrive and leave under the streamer; bind the nearest
+            // resident one, preferring coarser
+            int resident = -1;
+            for (int l = level; l < (int)mLevels.size() && resident < 0; l++) {
+                if (mLevels[l].uploaded) resident = l;
+            }
+            for (int l = level - 1; l >= 0 && resident < 0; l--) {
+                if (mLevels[l].uploaded) resident = l;
+            }
+            // The base level is small enough to upload on first use
+            if (resident < 0 && mLevels.back().loaded) {
+                resident = (int)mLevels.size() - 1;
+                uploadLevel(resident);
+            }
+            if (resident < 0) return;
+            mCurrentLevel = resident;
+            glActiveTexture(GL_TEXTURE0 + unit);
+            glBindTexture(GL_TEXTURE_2D, mLevels[resident].textureId);
+            return;
+        }
+
         // Find best available level (may need to use higher res if lower not loaded)
         while (level < (int)mLevels.size() && !mLevels[level].loaded) {
             level++;
@@ -214,6 +306,40 @@ public:
      */
     int numLevels() const { return mLevels.size(); }
 
+    /**
+     * Check if a level is on the GPU
+     */
+    bool levelResident(int level) const {
+        return level >= 0 && level < (int)mLevels.size() && mLevels[level].uploaded;
+    }
+
+    /// Levels are managed by TextureStreamer (see loadStreamed())
+    bool streamed() const { return mStreamed; }
+
+    /**
+     * Estimated GPU memory of a level: RGBA8 plus a third for its mip chain,
+     * or the stored chain of a KTX2 level. Uses the requested resolution
+     * (at 1 byte per texel for KTX2) until the file has loaded.
+     */
+    size_t levelBytes(int level) const {
+        if (level < 0 || level >= (int)mLevels.size()) return 0;
+        const auto& lvl = mLevels[level];
+        if (lvl.ktx.byteSize() > 0) return lvl.ktx.byteSize();
+        size_t w = lvl.image.width(), h = lvl.image.height();
+        if (w == 0 || h == 0) w = h = (size_t)lvl.resolution;
+        size_t bytesPerTexel = WebKTX2::isKTX2(lvl.url) ? 1 : 4;
+        return w * h * bytesPerTexel * 4 / 3;
+    }
+
+    /// Estimated GPU memory of every uploaded level
+    size_t residentBytes() const {
+        size_t total = 0;
+        for (int i = 0; i < (int)mLevels.size(); i++) {
+            if (mLevels[i].uploaded) total += levelBytes(i);
+        }
+        return total;
+    }
+
     /**
      * Get loading progress (0.0 to 1.0)
      */
@@ -225,24 +351,20 @@ public:
     /**
      * Destroy GPU resources
      */
-    void destroy() {
-        for (auto& level : mLevels) {
-            if (level.textureId != 0) {
-                glDeleteTextures(1, &level.textureId);
-                level.textureId = 0;
-                level.uploaded = false;
-            }
-        }
-    }
+    inline void destroy();
 
 private:
+    friend class TextureStreamer;
+
     struct TextureLevel {
         std::string url;
         int resolution = 0;
         WebImage image;
+        WebKTX2 ktx;            // Holds the level instead of image for .ktx2 URLs
         GLuint textureId = 0;
         bool loaded = false;
         bool uploaded = false;
+        bool loading = false;   // Streamed fetch in flight
     };
 
     std::vector<TextureLevel> mLevels;
@@ -253,6 +375,62 @@ private:
     bool mUploaded;
     LoadCallback mCallback;
 
+    // Streaming: the finest level and largest screen size requested in the
+    // last frame that bound this texture, and the level granted by budget
+    bool mStreamed = false;
+    int mWantedLevel = 0;
+    float mPriority = 0.0f;
+    float mLoadPriority = 0.0f;
+    uint64_t mRequestFrame = 0;
+    int mGrantedLevel = 0;
+
+    inline void request(int level, float pixels);
+    inline float distanceToPixels(float distance) const;
+
+    void releaseLevels() {
+        for (auto& level : mLevels) {
+            if (level.textureId != 0) {
+                glDeleteTextures(1, &level.textureId);
+                level.textureId = 0;
+                level.uploaded = false;
+            }
+        }
+    }
+
+    /// Fetch a streamed level; it is uploaded by a later TextureStreamer::update()
+    void fetchLevel(int level) {
+        auto& lvl = mLevels[level];
+        if (lvl.loaded || lvl.loading) return;
+        lvl.loading = true;
+        fetch(lvl, mPriority, [this, level](bool success) {
+            auto& l = mLevels[level];
+            l.loading = false;
+            if (success) {
+                l.loaded = true;
+                mLoadedCount++;
+                mReady = true;
+            } else {
+                printf("[WebTexture] Failed to load: %s\n", l.url.c_str());
+            }
+            if (mCallback) mCallback(success, level);
+        });
+    }
+
+    /// Drop a streamed level from the GPU and CPU; it can be fetched again
+    void evictLevel(int level) {
+        auto& lvl = mLevels[level];
+        if (lvl.loading) return;
+        if (lvl.textureId != 0) {
+            glDeleteTextures(1, &lvl.textureId);
+            lvl.textureId = 0;
+        }
+        if (lvl.loaded) mLoadedCount--;
+        lvl.uploaded = false;
+        lvl.loaded = false;
+        lvl.image.release();
+        lvl.ktx.release();
+    }
+
     void uploadLevel(int level) {
         if (level < 0 || level >= (int)mLevels.size()) return;
         if (!mLevels[level].loaded || mLevels[level].uploaded) return;
@@ -262,15 +440,24 @@ private:
         glGenTextures(1, &lvl.textureId);
         glBindTexture(GL_TEXTURE_2D, lvl.textureId);
 
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
-                     lvl.image.width(), lvl.image.height(), 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, lvl.image.pixels());
+        bool mipmapped = true;
+        if (lvl.ktx.ready()) {
+            // Compressed levels come with their own mip chain
+            mipmapped = lvl.ktx.uploadGL();
+        } else {
+            if (!lvl.image.uploadBitmapGL()) {
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
+                             lvl.image.width(), lvl.image.height(), 0,
+                             GL_RGBA, GL_UNSIGNED_BYTE, lvl.image.pixels());
+            }
 
-        // Generate mipmaps for quality filtering
-        glGenerateMipmap(GL_TEXTURE_2D);
+            // Generate mipmaps for quality filtering
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
 
         // Set filtering
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                        mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -278,8 +465,47 @@ private:
         glBindTexture(GL_TEXTURE_2D, 0);
 
         lvl.uploaded = true;
-        printf("[WebTexture] Uploaded level %d to GPU (%dx%d)\n",
-               level, lvl.image.width(), lvl.image.height());
+        printf("[WebTexture] Uploaded level %d to GPU (%dx%d%s)\n",
+               level, levelWidth(lvl), levelHeight(lvl),
+               lvl.ktx.ready() ? ", compressed" : "");
+
+        // The GPU copy is the only one a streamed level needs, and bitmaps
+        // are only kept for upload
+        if (mStreamed || lvl.image.hasBitmap()) lvl.image.release();
+        if (mStreamed) lvl.ktx.release();
+    }
+
+    /// Fetch a level's file: .ktx2 URLs stay compressed, anything else
+    /// decodes off the main thread to a bitmap uploaded without a heap copy
+    void fetch(TextureLevel& lvl, float priority, std::function<void(bool)> done) {
+        setFetchPriority(lvl, priority);
+        if (WebKTX2::isKTX2(lvl.url)) {
+            lvl.ktx.load(lvl.url, std::move(done));
+        } else {
+            lvl.image.loadBitmap(lvl.url, std::move(done));
+        }
+    }
+
+    static void setFetchPriority(TextureLevel& lvl, float priority) {
+        lvl.ktx.setPriority(priority);
+        lvl.image.setPriority(priority);
+    }
+
+    /// Drop queued level fetches; their callbacks point at this texture
+    void cancelFetches() {
+        for (auto& lvl : mLevels) {
+            lvl.ktx.cancel();
+            lvl.image.cancel();
+            lvl.loading = false;
+        }
+    }
+
+    static int levelWidth(const TextureLevel& lvl) {
+        return WebKTX2::isKTX2(lvl.url) ? lvl.ktx.width() : lvl.image.width();
+    }
+
+    static int levelHeight(const TextureLevel& lvl) {
+        return WebKTX2::isKTX2(lvl.url) ? lvl.ktx.height() : lvl.image.height();
     }
 
     std::string resolutionSuffix(int resolution) {
@@ -291,6 +517,228 @@ private:
 };
 
 
+/**
+ * Texture Streamer - keeps streamed WebTextures within a GPU memory budget
+ *
+ * Each streamed texture keeps its coarsest level resident. Once per frame,
+ * update() ranks textures by the screen size they were last bound at,
+ * grants each the finest requested level that still fits the budget (a
+ * coarser one if not), then:
+ * - fetches granted levels, a few at a time
+ * - uploads fetched levels, a few per frame so uploads don't hitch
+ * - evicts levels finer than granted right away, and coarser ones once the
+ *   granted level is on the GPU, so there is always something to bind
+ *
+ * Textures not bound for setIdleFrames() frames fall back to their base
+ * level and release the rest.
+ */
+class TextureStreamer {
+public:
+    static TextureStreamer& instance() {
+        static TextureStreamer streamer;
+        return streamer;
+    }
+
+    /// GPU memory the streamed textures may use, in bytes (default 256 MB)
+    void setBudget(size_t bytes) {
+        mBudget = bytes;
+        printf("[TextureStreamer] Budget %.1f MB\n", bytes / (1024.0 * 1024.0));
+    }
+    size_t budget() const { return mBudget; }
+
+    /// Image fetches in flight at once (default 4), on top of the
+    /// AssetLoader's overall cap
+    void setMaxConcurrentLoads(int n) { mMaxLoads = std::max(1, n); }
+    /// Level uploads per update() (default 2)
+    void setMaxUploadsPerFrame(int n) { mMaxUploads = std::max(1, n); }
+    /// Frames without a bind before a texture drops to its base level (default 120)
+    void setIdleFrames(int frames) { mIdleFrames = std::max(1, frames); }
+
+    /**
+     * Screen size, in pixels, of a unit-sized surface at distance 1. Used to
+     * rank textures bound by distance (WebTexture::bind) against ones bound
+     * by screen size (default 1024).
+     */
+    void setPixelsAtUnitDistance(float px) { mPixelsAtUnitDistance = std::max(1.0f, px); }
+    float distanceToPixels(float distance) const {
+        return mPixelsAtUnitDistance / std::max(distance, 0.01f);
+    }
+
+    /**
+     * Re-plan residency from last frame's bind requests and start the
+     * resulting fetches, uploads and evictions. Call once per frame.
+     */
+    void update() {
+        mFrame++;
+        mUploadsLastFrame = 0;
+        mEvictionsLastFrame = 0;
+
+        struct Candidate { WebTexture* tex; float priority; int target; };
+        std::vector<Candidate> order;
+        order.reserve(mTextures.size());
+        size_t committed = 0;
+        int loading = 0;
+        for (WebTexture* tex : mTextures) {
+            int base = (int)tex->mLevels.size() - 1;
+            if (base < 0) continue;
+            committed += tex->levelBytes(base);
+            for (const auto& lvl : tex->mLevels) loading += lvl.loading ? 1 : 0;
+
+            bool active = tex->mRequestFrame != 0 &&
+                          mFrame - tex->mRequestFrame <= (uint64_t)mIdleFrames;
+            order.push_back({tex, active ? tex->mPriority : 0.0f,
+                             active ? std::min(tex->mWantedLevel, base) : base});
+        }
+        std::sort(order.begin(), order.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.priority > b.priority; });
+
+        // Grant the finest level that fits, largest screen size first
+        for (auto& c : order) {
+            WebTexture* tex = c.tex;
+            int base = (int)tex->mLevels.size() - 1;
+            int granted = base;
+            for (int l = c.target; l < base; l++) {
+                size_t extra = tex->levelBytes(l);
+                if (committed + extra <= mBudget) {
+                    granted = l;
+                    committed += extra;
+                    break;
+                }
+            }
+            tex->mGrantedLevel = granted;
+        }
+        mCommittedBytes = committed;
+
+        for (auto& c : order) {
+            WebTexture* tex = c.tex;
+            int base = (int)tex->mLevels.size() - 1;
+            int granted = tex->mGrantedLevel;
+            auto& want = tex->mLevels[granted];
+
+            if (!want.loaded && !want.loading && loading < mMaxLoads) {
+                tex->fetchLevel(granted);
+                loading++;
+            } else if (want.loading) {
+                // Still queued in the AssetLoader: keep it ranked by screen size
+                WebTexture::setFetchPriority(want, c.priority);
+            }
+            if (want.loaded && !want.uploaded && mUploadsLastFrame < mMaxUploads) {
+                tex->uploadLevel(granted);
+                mUploadsLastFrame++;
+            }
+            for (int l = 0; l < base; l++) {
+                if (l == granted) continue;
+                auto& lvl = tex->mLevels[l];
+                if (!lvl.loaded && !lvl.uploaded) continue;
+                if (l < granted || want.uploaded) {
+                    tex->evictLevel(l);
+                    mEvictionsLastFrame++;
+                }
+            }
+        }
+    }
+
+    // ── Stats ──
+
+    int textureCount() const { return (int)mTextures.size(); }
+    /// GPU memory of every uploaded streamed level
+    size_t residentBytes() const {
+        size_t total = 0;
+        for (const WebTexture* tex : mTextures) total += tex->residentBytes();
+        return total;
+    }
+    /// Memory the last update() granted (resident bytes converge to this)
+    size_t committedBytes() const { return mCommittedBytes; }
+    int pendingLoads() const {
+        int n = 0;
+        for (const WebTexture* tex : mTextures) {
+            for (const auto& lvl : tex->mLevels) n += lvl.loading ? 1 : 0;
+        }
+        return n;
+    }
+    int uploadsLastFrame() const { return mUploadsLastFrame; }
+    int evictionsLastFrame() const { return mEvictionsLastFrame; }
+    uint64_t frame() const { return mFrame; }
+
+private:
+    friend class WebTexture;
+
+    TextureStreamer() = default;
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    void add(WebTexture* tex) {
+        if (std::find(mTextures.begin(), mTextures.end(), tex) == mTextures.end()) {
+            mTextures.push_back(tex);
+        }
+    }
+    void remove(WebTexture* tex) {
+        mTextures.erase(std::remove(mTextures.begin(), mTextures.end(), tex), mTextures.end());
+    }
+
+    std::vector<WebTexture*> mTextures;
+    size_t mBudget = 256u * 1024u * 1024u;
+    size_t mCommittedBytes = 0;
+    int mMaxLoads = 4;
+    int mMaxUploads = 2;
+    int mIdleFrames = 120;
+    float mPixelsAtUnitDistance = 1024.0f;
+    uint64_t mFrame = 1;
+    int mUploadsLastFrame = 0;
+    int mEvictionsLastFrame = 0;
+};
+
+// ─── WebTexture streaming ──────────────────────────────────────────────────
+
+inline void WebTexture::loadStreamed(const std::string& basePath,
+                                     const std::vector<int>& resolutions,
+                                     const std::string& extension) {
+    destroy();
+    cancelFetches();
+    mLevels.clear();
+    mLevels.resize(resolutions.size());
+    mLoadedCount = 0;
+    mReady = false;
+    if (mLevels.empty()) return;
+
+    mLOD.setLevels(std::vector<int>(resolutions.begin(), resolutions.end()));
+    for (size_t i = 0; i < resolutions.size(); i++) {
+        mLevels[i].resolution = resolutions[i];
+        mLevels[i].url = basePath + "_" + resolutionSuffix(resolutions[i]) + extension;
+    }
+
+    mStreamed = true;
+    mRequestFrame = 0;
+    mWantedLevel = mGrantedLevel = (int)mLevels.size() - 1;
+    TextureStreamer::instance().add(this);
+    fetchLevel(mGrantedLevel);
+}
+
+inline void WebTexture::destroy() {
+    releaseLevels();
+    if (mStreamed) {
+        TextureStreamer::instance().remove(this);
+        mStreamed = false;
+    }
+}
+
+inline void WebTexture::request(int level, float pixels) {
+    uint64_t frame = TextureStreamer::instance().frame();
+    if (mRequestFrame != frame) {
+        mRequestFrame = frame;
+        mWantedLevel = level;
+        mPriority = pixels;
+    } else {
+        mWantedLevel = std::min(mWantedLevel, level);
+        mPriority = std::max(mPriority, pixels);
+    }
+}
+
+inline float WebTexture::distanceToPixels(float distance) const {
+    return TextureStreamer::instance().distanceToPixels(distance);
+}
+
+
 /**
  * PBR Texture Set - albedo, normal, roughness, metallic, AO
  */
@@ -315,34 +763,58 @@ public:
      * Load complete PBR texture set
      * @param basePath Base path (e.g., "/assets/textures/brick")
      * @param resolutions Resolution levels (default: {2048, 1024, 512})
+     * @param extension File extension; ".ktx2" keeps the maps compressed
      *
      * Loads: brick_albedo_2k.jpg, brick_normal_2k.jpg, etc.
      */
     void load(const std::string& basePath,
-              const std::vector<int>& resolutions = {2048, 1024, 512}) {
+              const std::vector<int>& resolutions = {2048, 1024, 512},
+              const std::string& extension = ".jpg") {
         mBasePath = basePath;
 
         // Load each map type that exists
-        loadMap(ALBEDO, basePath + "_albedo", resolutions);
-        loadMap(NORMAL, basePath + "_normal", resolutions);
-        loadMap(ROUGHNESS, basePath + "_roughness", resolutions);
-        loadMap(METALLIC, basePath + "_metallic", resolutions);
-        loadMap(AO, basePath + "_ao", resolutions);
+        loadMap(ALBEDO, basePath + "_albedo", resolutions, false, extension);
+        loadMap(NORMAL, basePath + "_normal", resolutions, false, extension);
+        loadMap(ROUGHNESS, basePath + "_roughness", resolutions, false, extension);
+        loadMap(METALLIC, basePath + "_metallic", resolutions, false, extension);
+        loadMap(AO, basePath + "_ao", resolutions, false, extension);
+    }
+
+    /**
+     * Load a PBR texture set streamed under TextureStreamer's budget
+     * (see WebTexture::loadStreamed)
+     */
+    void loadStreamed(const std::string& basePath,
+                      const std::vector<int>& resolutions = {2048, 1024, 512},
+                      const std::string& extension = ".jpg") {
+        mBasePath = basePath;
+
+        loadMap(ALBEDO, basePath + "_albedo", resolutions, true, extension);
+        loadMap(NORMAL, basePath + "_normal", resolutions, true, extension);
+        loadMap(ROUGHNESS, basePath + "_roughness", resolutions, true, extension);
+        loadMap(METALLIC, basePath + "_metallic", resolutions, true, extension);
+        loadMap(AO, basePath + "_ao", resolutions, true, extension);
     }
 
     /**
      * Load individual map with multi-resolution
      */
     void loadMap(MapType type, const std::string& basePath,
-                 const std::vector<int>& resolutions = {2048, 1024, 512}) {
+                 const std::vector<int>& resolutions = {2048, 1024, 512},
+                 bool streamed = false,
+                 const std::string& extension = ".jpg") {
         if (type >= NUM_MAPS) return;
 
-        mMaps[type].loadMultiRes(basePath, resolutions);
+        if (streamed) {
+            mMaps[type].loadStreamed(basePath, resolutions, extension);
+        } else {
+            mMaps[type].loadMultiRes(basePath, resolutions, extension);
+        }
         mMapEnabled[type] = true;
     }
 
     /**
-     * Load individual map (single resolution)
+     * Load individual map (single resolution; .ktx2 URLs stay compressed)
      */
     void loadMapSingle(MapType type, const std::string& url) {
         if (type >= NUM_MAPS) return;
@@ -364,6 +836,17 @@ public:
         }
     }
 
+    /**
+     * Bind all maps for a surface covering `pixels` on screen
+     */
+    void bindScreenSize(int baseUnit, float pixels) {
+        for (int i = 0; i < NUM_MAPS; i++) {
+            if (mMapEnabled[i] && mMaps[i].ready()) {
+                mMaps[i].bindScreenSize(baseUnit + i, pixels);
+            }
+        }
+    }
+
     /**
      * Bind specific map
      */
@@ -453,6 +936,10 @@ private:
 
 /**
  * Texture Cache - manages loaded textures to avoid duplicates
+ *
+ * Caches whole WebTextures (their levels stream in and out individually).
+ * Single GPU textures shared by URL or content - environments, mipmapped
+ * and procedural textures - live in GPUResourceCache.
  */
 class TextureCache {
 public:
@@ -472,7 +959,9 @@ public:
         }
 
         auto tex = std::make_unique<WebTexture>();
-        if (resolutions.size() > 1) {
+        if (resolutions.size() > 1 && mStreaming) {
+            tex->loadStreamed(path, resolutions);
+        } else if (resolutions.size() > 1) {
             tex->loadMultiRes(path, resolutions);
         } else {
             tex->load(path);
@@ -494,7 +983,11 @@ public:
         }
 
         auto set = std::make_unique<PBRTextureSet>();
-        set->load(basePath, resolutions);
+        if (mStreaming) {
+            set->loadStreamed(basePath, resolutions);
+        } else {
+            set->load(basePath, resolutions);
+        }
 
         PBRTextureSet* ptr = set.get();
         mPBRSets[basePath] = std::move(set);
@@ -509,6 +1002,13 @@ public:
         get(path, resolutions);
     }
 
+    /**
+     * Load new multi-resolution textures through TextureStreamer
+     * (already cached ones are unaffected)
+     */
+    void setStreaming(bool enabled) { mStreaming = enabled; }
+    bool streaming() const { return mStreaming; }
+
     /**
      * Clear all cached textures
      */
@@ -518,18 +1018,16 @@ public:
     }
 
     /**
-     * Get approximate memory usage in bytes
+     * Get approximate GPU memory usage in bytes (uploaded levels with mips)
      */
     size_t memoryUsage() const {
-        // Rough estimate: resolution^2 * 4 bytes per level
         size_t total = 0;
         for (const auto& pair : mTextures) {
-            const auto& tex = pair.second;
-            for (int i = 0; i < tex->numLevels(); i++) {
-                if (tex->levelReady(i)) {
-                    int res = tex->currentResolution();
-                    total += res * res * 4;
-                }
+            total += pair.second->residentBytes();
+        }
+        for (const auto& pair : mPBRSets) {
+            for (int m = 0; m < PBRTextureSet::NUM_MAPS; m++) {
+                total += pair.second->getMap((PBRTextureSet::MapType)m).residentBytes();
             }
         }
         return total;
@@ -542,6 +1040,7 @@ private:
 
     std::unordered_map<std::string, std::unique_ptr<WebTexture>> mTextures;
     std::unordered_map<std::string, std::unique_ptr<PBRTextureSet>> mPBRSets;
+    bool mStreaming = false;
 };
 
 } // namespace al
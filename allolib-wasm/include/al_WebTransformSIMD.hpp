@@ -0,0 +1,171 @@
+/**
+ * Web Transform SIMD - 4x4 transform kernels for the draw path
+ *
+ * mul (matrix product), transform (matrix * vec4) and normalMatrix3 /
+ * normalMatrix4 (inverse-transpose of a modelView's upper 3x3), on
+ * column-major float matrices as stored by al::Mat4f. They use wasm
+ * SIMD128 when built with -msimd128 (the default for libal_web and
+ * compile.sh), one column per vector, and scalar code otherwise.
+ *
+ * Graphics uses them for the per-draw matrices it computes itself: the
+ * modelView and modelViewProjection products, the lighting normal matrix
+ * and the view-space light positions. The model stack (translate, rotate,
+ * scale, push/pop) is RenderManager's, built unmodified from allolib.
+ *
+ * Usage:
+ *   Mat4f mv = transform_simd::mul(g.viewMatrix(), g.modelMatrix());
+ *   float normal[9];
+ *   if (!transform_simd::normalMatrix3(mv.elems(), normal)) { ... singular }
+ *
+ * Outputs may alias inputs. Pointers need no particular alignment.
+ */
+
+#ifndef AL_WEB_TRANSFORM_SIMD_HPP
+#define AL_WEB_TRANSFORM_SIMD_HPP
+
+#include <cmath>
+
+#include "al/math/al_Mat.hpp"
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+namespace al {
+namespace transform_simd {
+
+/// Determinants below this are treated as singular
+constexpr float kSingular = 1e-10f;
+
+/// out = a * b
+inline void mul(float* out, const float* a, const float* b) {
+#if defined(__wasm_simd128__)
+    const v128_t a0 = wasm_v128_load(a);
+    const v128_t a1 = wasm_v128_load(a + 4);
+    const v128_t a2 = wasm_v128_load(a + 8);
+    const v128_t a3 = wasm_v128_load(a + 12);
+    v128_t col[4];
+    for (int j = 0; j < 4; ++j) {
+        const float* bj = b + 4 * j;
+        v128_t c = wasm_f32x4_mul(a0, wasm_f32x4_splat(bj[0]));
+        c = wasm_f32x4_add(c, wasm_f32x4_mul(a1, wasm_f32x4_splat(bj[1])));
+        c = wasm_f32x4_add(c, wasm_f32x4_mul(a2, wasm_f32x4_splat(bj[2])));
+        c = wasm_f32x4_add(c, wasm_f32x4_mul(a3, wasm_f32x4_splat(bj[3])));
+        col[j] = c;
+    }
+    for (int j = 0; j < 4; ++j) wasm_v128_store(out + 4 * j, col[j]);
+#else
+    float r[16];
+    for (int j = 0; j < 4; ++j) {
+        for (int i = 0; i < 4; ++i) {
+            r[4 * j + i] = a[i] * b[4 * j] + a[4 + i] * b[4 * j + 1] +
+                           a[8 + i] * b[4 * j + 2] + a[12 + i] * b[4 * j + 3];
+        }
+    }
+    for (int k = 0; k < 16; ++k) out[k] = r[k];
+#endif
+}
+
+inline Mat4f mul(const Mat4f& a, const Mat4f& b) {
+    Mat4f r;
+    mul(r.elems(), a.elems(), b.elems());
+    return r;
+}
+
+/// out = m * v
+inline void transform(float* out, const float* m, const float* v) {
+#if defined(__wasm_simd128__)
+    v128_t r = wasm_f32x4_mul(wasm_v128_load(m), wasm_f32x4_splat(v[0]));
+    r = wasm_f32x4_add(r, wasm_f32x4_mul(wasm_v128_load(m + 4), wasm_f32x4_splat(v[1])));
+    r = wasm_f32x4_add(r, wasm_f32x4_mul(wasm_v128_load(m + 8), wasm_f32x4_splat(v[2])));
+    r = wasm_f32x4_add(r, wasm_f32x4_mul(wasm_v128_load(m + 12), wasm_f32x4_splat(v[3])));
+    wasm_v128_store(out, r);
+#else
+    float r[4];
+    for (int i = 0; i < 4; ++i) {
+        r[i] = m[i] * v[0] + m[4 + i] * v[1] + m[8 + i] * v[2] + m[12 + i] * v[3];
+    }
+    for (int i = 0; i < 4; ++i) out[i] = r[i];
+#endif
+}
+
+/**
+ * Inverse-transpose of the upper 3x3 of `mv`. Its columns are the cross
+ * products of mv's columns over the determinant, so there is no general
+ * inverse. Writes three columns of four floats (xyz, 0) to `cols` and
+ * returns false, writing nothing, when the 3x3 is singular.
+ */
+inline bool normalColumns(const float* mv, float* cols) {
+#if defined(__wasm_simd128__)
+    // Lane 3 of the cross products is c.w * d.w - c.w * d.w = 0
+    const auto cross = [](v128_t c, v128_t d) {
+        const v128_t cYZX = wasm_i32x4_shuffle(c, c, 1, 2, 0, 3);
+        const v128_t dYZX = wasm_i32x4_shuffle(d, d, 1, 2, 0, 3);
+        const v128_t r = wasm_f32x4_sub(wasm_f32x4_mul(c, dYZX), wasm_f32x4_mul(cYZX, d));
+        return wasm_i32x4_shuffle(r, r, 1, 2, 0, 3);
+    };
+    const v128_t c0 = wasm_v128_load(mv);
+    const v128_t c1 = wasm_v128_load(mv + 4);
+    const v128_t c2 = wasm_v128_load(mv + 8);
+    const v128_t r0 = cross(c1, c2);
+    const v128_t r1 = cross(c2, c0);
+    const v128_t r2 = cross(c0, c1);
+    const v128_t d = wasm_f32x4_mul(c0, r0);
+    const float det = wasm_f32x4_extract_lane(d, 0) + wasm_f32x4_extract_lane(d, 1) +
+                      wasm_f32x4_extract_lane(d, 2);
+    if (std::abs(det) < kSingular) return false;
+    const v128_t inv = wasm_f32x4_splat(1.0f / det);
+    wasm_v128_store(cols, wasm_f32x4_mul(r0, inv));
+    wasm_v128_store(cols + 4, wasm_f32x4_mul(r1, inv));
+    wasm_v128_store(cols + 8, wasm_f32x4_mul(r2, inv));
+#else
+    const float* c0 = mv;
+    const float* c1 = mv + 4;
+    const float* c2 = mv + 8;
+    const float r0[3] = {c1[1] * c2[2] - c1[2] * c2[1], c1[2] * c2[0] - c1[0] * c2[2],
+                         c1[0] * c2[1] - c1[1] * c2[0]};
+    const float r1[3] = {c2[1] * c0[2] - c2[2] * c0[1], c2[2] * c0[0] - c2[0] * c0[2],
+                         c2[0] * c0[1] - c2[1] * c0[0]};
+    const float r2[3] = {c0[1] * c1[2] - c0[2] * c1[1], c0[2] * c1[0] - c0[0] * c1[2],
+                         c0[0] * c1[1] - c0[1] * c1[0]};
+    const float det = c0[0] * r0[0] + c0[1] * r0[1] + c0[2] * r0[2];
+    if (std::abs(det) < kSingular) return false;
+    const float inv = 1.0f / det;
+    for (int i = 0; i < 3; ++i) {
+        cols[i] = r0[i] * inv;
+        cols[4 + i] = r1[i] * inv;
+        cols[8 + i] = r2[i] * inv;
+    }
+    cols[3] = cols[7] = cols[11] = 0.0f;
+#endif
+    return true;
+}
+
+/// Normal matrix as a column-major 3x3; false (out untouched) if singular
+inline bool normalMatrix3(const float* mv, float* out) {
+    float cols[12];
+    if (!normalColumns(mv, cols)) return false;
+    for (int j = 0; j < 3; ++j) {
+        for (int i = 0; i < 3; ++i) out[3 * j + i] = cols[4 * j + i];
+    }
+    return true;
+}
+
+/**
+ * Normal matrix as a 4x4 with (0, 0, 0, 1) as last row and column, for
+ * shaders that multiply vec4(normal, 0). Matches inverse(mv)^T on those
+ * for any affine mv. False (out untouched) if singular.
+ */
+inline bool normalMatrix4(const float* mv, float* out) {
+    float cols[12];
+    if (!normalColumns(mv, cols)) return false;
+    for (int k = 0; k < 12; ++k) out[k] = cols[k];
+    out[12] = out[13] = out[14] = 0.0f;
+    out[15] = 1.0f;
+    return true;
+}
+
+} // namespace transform_simd
+} // namespace al
+
+#endif // AL_WEB_TRANSFORM_SIMD_HPP
@@ -0,0 +1,143 @@
+/**
+ * Web WAV Writer - streaming WAV files on the Emscripten filesystem
+ *
+ * Writes planar float blocks to a RIFF/WAVE file as they are produced, so a
+ * long render never has to sit in memory; the header sizes are patched in
+ * on close(). The path is any filesystem path: MEMFS by default, persistent
+ * under an IDBFS mount (e.g. /presets). WebFile::downloadFile() hands the
+ * finished file to the browser.
+ *
+ * Usage:
+ *   WavFileWriter wav;
+ *   if (wav.open("/tmp/take.wav", 44100, 2)) {
+ *       const float* ch[2] = { left, right };
+ *       wav.write(ch, frames);       // repeat per block
+ *       wav.close();
+ *   }
+ *
+ * Int16 clamps to [-1, 1]; Float32 (WAVE_FORMAT_IEEE_FLOAT) keeps overs.
+ */
+
+#ifndef AL_WEB_WAV_WRITER_HPP
+#define AL_WEB_WAV_WRITER_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "al_WebAudioSIMD.hpp"
+
+namespace al {
+
+class WavFileWriter {
+public:
+    enum class Format { Int16, Float32 };
+
+    WavFileWriter() = default;
+    ~WavFileWriter() { close(); }
+
+    WavFileWriter(const WavFileWriter&) = delete;
+    WavFileWriter& operator=(const WavFileWriter&) = delete;
+
+    /// Create (truncate) the file and write a provisional header
+    bool open(const std::string& path, int sampleRate, int channels,
+              Format format = Format::Int16) {
+        close();
+        if (sampleRate <= 0 || channels <= 0) return false;
+        mFile = std::fopen(path.c_str(), "wb");
+        if (!mFile) {
+            printf("[WavFileWriter] Could not open %s\n", path.c_str());
+            return false;
+        }
+        mSampleRate = sampleRate;
+        mChannels = channels;
+        mFormat = format;
+        mFrames = 0;
+        mFailed = !writeHeader();
+        return !mFailed;
+    }
+
+    /// Append `frames` frames from planar channels (channels() pointers)
+    void write(const float* const* channels, int frames) {
+        if (!mFile || mFailed || frames <= 0) return;
+        const size_t samples = size_t(frames) * mChannels;
+        if (mInterleaved.size() < samples) mInterleaved.resize(samples);
+        audio_simd::interleave(mInterleaved.data(), channels, mChannels, frames);
+
+        size_t written;
+        if (mFormat == Format::Float32) {
+            written = std::fwrite(mInterleaved.data(), sizeof(float), samples, mFile);
+        } else {
+            if (mPCM.size() < samples) mPCM.resize(samples);
+            for (size_t i = 0; i < samples; ++i) {
+                float s = mInterleaved[i];
+                s = s > 1.0f ? 1.0f : (s < -1.0f ? -1.0f : s);
+                mPCM[i] = int16_t(s * 32767.0f);
+            }
+            written = std::fwrite(mPCM.data(), sizeof(int16_t), samples, mFile);
+        }
+        if (written != samples) mFailed = true;
+        mFrames += uint64_t(frames);
+    }
+
+    /// Patch the header sizes and close; false if any write failed
+    bool close() {
+        if (!mFile) return !mFailed;
+        if (!mFailed) {
+            std::fseek(mFile, 0, SEEK_SET);
+            mFailed = !writeHeader();
+        }
+        if (std::fclose(mFile) != 0) mFailed = true;
+        mFile = nullptr;
+        return !mFailed;
+    }
+
+    bool isOpen() const { return mFile != nullptr; }
+    uint64_t frames() const { return mFrames; }
+    int channels() const { return mChannels; }
+    int sampleRate() const { return mSampleRate; }
+
+private:
+    bool writeHeader() {
+        const uint16_t bytesPerSample = mFormat == Format::Float32 ? 4 : 2;
+        const uint64_t dataBytes64 = mFrames * mChannels * bytesPerSample;
+        // RIFF sizes are 32-bit; past 4 GB readers fall back on file length
+        const uint32_t dataBytes = dataBytes64 > 0xFFFFFFF0u ? 0xFFFFFFF0u : uint32_t(dataBytes64);
+
+        uint8_t h[44];
+        auto put16 = [&](int at, uint16_t v) { h[at] = uint8_t(v); h[at + 1] = uint8_t(v >> 8); };
+        auto put32 = [&](int at, uint32_t v) {
+            for (int i = 0; i < 4; ++i) h[at + i] = uint8_t(v >> (8 * i));
+        };
+        auto tag = [&](int at, const char* s) { for (int i = 0; i < 4; ++i) h[at + i] = uint8_t(s[i]); };
+
+        tag(0, "RIFF");
+        put32(4, 36 + dataBytes);
+        tag(8, "WAVE");
+        tag(12, "fmt ");
+        put32(16, 16);
+        put16(20, mFormat == Format::Float32 ? 3 : 1);  // IEEE float / PCM
+        put16(22, uint16_t(mChannels));
+        put32(24, uint32_t(mSampleRate));
+        put32(28, uint32_t(mSampleRate) * mChannels * bytesPerSample);
+        put16(32, uint16_t(mChannels * bytesPerSample));
+        put16(34, uint16_t(8 * bytesPerSample));
+        tag(36, "data");
+        put32(40, dataBytes);
+        return std::fwrite(h, 1, sizeof(h), mFile) == sizeof(h);
+    }
+
+    std::FILE* mFile = nullptr;
+    int mSampleRate = 0;
+    int mChannels = 0;
+    Format mFormat = Format::Int16;
+    uint64_t mFrames = 0;
+    bool mFailed = false;
+    std::vector<float> mInterleaved;
+    std::vector<int16_t> mPCM;
+};
+
+} // namespace al
+
+#endif // AL_WEB_WAV_WRITER_HPP
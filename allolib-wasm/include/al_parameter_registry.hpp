@@ -56,12 +56,16 @@
 #include <cstdint>
 #include <cstddef>
 #include <functional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 // Forward-declare ParameterMeta to avoid pulling in the full upstream
 // header from every translation unit that consumes the registry. The
 // only operations we perform on the pointer are address comparison and
-// passing it back out; we never dereference.
+// passing it back out; we never dereference. The one exception is the
+// name lookup, a template so `getName()` is only instantiated in
+// translation units that already include al_Parameter.hpp.
 namespace al { class ParameterMeta; }
 
 namespace al {
@@ -80,6 +84,9 @@ struct ParameterRegistrySubscription {
 class ParameterRegistry {
 public:
     using Callback = std::function<void(ParameterMeta*)>;
+    /// Receives every parameter added by one add/batch at once; a clear
+    /// arrives as (nullptr, 0).
+    using BatchCallback = std::function<void(ParameterMeta* const* added, size_t count)>;
 
     /**
      * Process-global registry. Meyer's-singleton storage so the lifetime
@@ -95,30 +102,90 @@ public:
     /**
      * Add a parameter. Returns true if newly added, false if already
      * present (idempotent). Bumps `version()` and fires `onChange`
-     * callbacks only on the true case.
+     * callbacks only on the true case. Inside a batch both are deferred
+     * to the end of the batch.
      */
     bool add(ParameterMeta* p) {
         if (!p) return false;
-        for (auto* existing : mParameters) {
-            if (existing == p) return false;
-        }
+        if (!mIndex.emplace(p, mParameters.size()).second) return false;
         mParameters.push_back(p);
+        if (mBatchDepth > 0) return true;
         mVersion.fetch_add(1, std::memory_order_release);
-        notifyAdd(p);
+        notifyAdd(&p, 1);
         return true;
     }
 
     /**
-     * Pointer-identity membership query. O(N) — the parameter list is
-     * always small (typically <50). If a future feature pushes this past
-     * a few hundred entries, swap to a `std::unordered_set<ParameterMeta*>`
-     * mirror — keep the vector ordering for `at(idx)` indexed access.
+     * Bulk add (a voice's parameters, a bundle): one version bump and one
+     * notification for the lot. Returns how many were newly added.
      */
-    bool has(ParameterMeta* p) const {
-        for (auto* existing : mParameters) {
-            if (existing == p) return true;
+    template <class Range>
+    size_t addAll(const Range& params) {
+        const size_t before = mParameters.size();
+        beginBatch();
+        for (auto* p : params) add(p);
+        endBatch();
+        return mParameters.size() - before;
+    }
+
+    /**
+     * Open / close a batch. Adds in between only append; the outermost
+     * endBatch bumps `version()` once and notifies subscribers once with
+     * everything added. Nests. Prefer the `Batch` guard.
+     */
+    void beginBatch() { if (mBatchDepth++ == 0) mBatchStart = mParameters.size(); }
+
+    void endBatch() {
+        if (mBatchDepth == 0 || --mBatchDepth > 0) return;
+        const size_t added = mParameters.size() - mBatchStart;
+        if (added == 0) return;
+        mVersion.fetch_add(1, std::memory_order_release);
+        // Copied: a subscriber that registers more would move mParameters
+        std::vector<ParameterMeta*> batch(mParameters.begin() + mBatchStart,
+                                          mParameters.end());
+        notifyAdd(batch.data(), batch.size());
+    }
+
+    class Batch {
+    public:
+        explicit Batch(ParameterRegistry& r = global()) : mRegistry(r) { mRegistry.beginBatch(); }
+        ~Batch() { mRegistry.endBatch(); }
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+    private:
+        ParameterRegistry& mRegistry;
+    };
+
+    /// Pointer-identity membership query, O(1) through the hashed index
+    /// (the vector keeps insertion order for `at(idx)`).
+    bool has(ParameterMeta* p) const { return mIndex.count(p) != 0; }
+
+    /// Registry index of `p`, or -1.
+    int indexOf(ParameterMeta* p) const {
+        auto it = mIndex.find(p);
+        return it == mIndex.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    /**
+     * Index of the first parameter registered under `name`, or -1. Names
+     * are not unique (distinct objects may share one); the first wins.
+     * The name map is extended lazily with whatever was added since the
+     * previous lookup, so registration itself never reads names.
+     */
+    template <class Meta = ParameterMeta>
+    int indexOf(const std::string& name) const {
+        for (; mNamesIndexed < mParameters.size(); ++mNamesIndexed) {
+            Meta* p = mParameters[mNamesIndexed];
+            mNameIndex.emplace(p->getName(), mNamesIndexed);
         }
-        return false;
+        auto it = mNameIndex.find(name);
+        return it == mNameIndex.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    template <class Meta = ParameterMeta>
+    ParameterMeta* find(const std::string& name) const {
+        const int idx = indexOf<Meta>(name);
+        return idx < 0 ? nullptr : mParameters[idx];
     }
 
     /// Number of registered parameters.
@@ -146,7 +213,15 @@ public:
     ParameterRegistrySubscription onChange(Callback cb) {
         ParameterRegistrySubscription tok;
         tok.id = ++mNextSubId;
-        mSubscribers.push_back({tok.id, std::move(cb)});
+        mSubscribers.push_back({tok.id, std::move(cb), nullptr});
+        return tok;
+    }
+
+    /// Like onChange, but called once per add or batch with all of it.
+    ParameterRegistrySubscription onAdded(BatchCallback cb) {
+        ParameterRegistrySubscription tok;
+        tok.id = ++mNextSubId;
+        mSubscribers.push_back({tok.id, nullptr, std::move(cb)});
         return tok;
     }
 
@@ -163,8 +238,15 @@ public:
      */
     void clear() {
         mParameters.clear();
+        mIndex.clear();
+        mNameIndex.clear();
+        mNamesIndexed = 0;
+        mBatchStart = 0;
         mVersion.fetch_add(1, std::memory_order_release);
-        for (auto& s : mSubscribers) s.cb(nullptr);
+        for (auto& s : mSubscribers) {
+            if (s.batchCb) s.batchCb(nullptr, 0);
+            else s.cb(nullptr);
+        }
     }
 
     /**
@@ -184,16 +266,25 @@ private:
     ParameterRegistry(const ParameterRegistry&) = delete;
     ParameterRegistry& operator=(const ParameterRegistry&) = delete;
 
-    void notifyAdd(ParameterMeta* p) {
-        for (auto& s : mSubscribers) s.cb(p);
+    void notifyAdd(ParameterMeta* const* added, size_t n) {
+        for (auto& s : mSubscribers) {
+            if (s.batchCb) s.batchCb(added, n);
+            else for (size_t i = 0; i < n; ++i) s.cb(added[i]);
+        }
     }
 
     struct Subscriber {
         uint64_t id;
         Callback cb;
+        BatchCallback batchCb;
     };
 
     std::vector<ParameterMeta*> mParameters;
+    std::unordered_map<ParameterMeta*, size_t> mIndex;
+    mutable std::unordered_map<std::string, size_t> mNameIndex;
+    mutable size_t mNamesIndexed = 0;
+    int mBatchDepth = 0;
+    size_t mBatchStart = 0;
     std::vector<Subscriber> mSubscribers;
     std::atomic<uint64_t> mVersion{0};
     uint64_t mNextSubId{0};
@@ -319,7 +319,7 @@ public:
     }
     WebPresetHandler& registerParameterBundle(ParameterBundle& b) {
         PresetHandler::registerParameterBundle(b);
-        for (auto* p : b.parameters()) if (p) ParameterRegistry::global().add(p);
+        ParameterRegistry::global().addAll(b.parameters());
         return *this;
     }
     WebPresetHandler& operator<<(ParameterMeta& p) { return registerParameter(p); }
@@ -853,9 +853,7 @@ public:
         // owned by the control voice — whether registered via
         // createInternalTriggerParameter, gui<<, mPresets<<, or
         // parameterServer()<< — appears once in the panel.
-        for (auto* p : mControlVoice.triggerParameters()) {
-            if (p) ParameterRegistry::global().add(p);
-        }
+        ParameterRegistry::global().addAll(mControlVoice.triggerParameters());
 #endif
 
         // Pre-allocate voices
@@ -923,6 +921,14 @@ public:
 
     // Render audio and graphics
     void render(AudioIOData& io) {
+#ifdef __EMSCRIPTEN__
+        // Sequencer events due in this block, before voices are inserted
+        // so their onset offsets apply to this block
+        if (WebSequencerBridge::getPolySynth() == &mPolySynth) {
+            WebSequencerBridge::dispatch(io.framesPerBuffer());
+        }
+#endif
+
         // In TIME_MASTER_FREE mode, we must manually process voices
         // This moves voices from the insert queue to the active list
         mPolySynth.processVoices();
@@ -939,7 +945,7 @@ public:
         // (handles UI slider changes reflected back to C++)
         auto* gui = WebControlGUI::getActiveInstance();
         if (gui) {
-            gui->draw(); // Calls syncParametersToJS()
+            gui->draw(); // Calls syncParameterTable()
         }
 #endif
     }
@@ -80,9 +80,7 @@ public:
     /// of the same parameters were already registered via another route.
     WebParameterServer& operator<<(ParameterBundle& bundle) {
         ParameterServer::registerParameterBundle(bundle);
-        for (auto* p : bundle.parameters()) {
-            if (p) ParameterRegistry::global().add(p);
-        }
+        ParameterRegistry::global().addAll(bundle.parameters());
         return *this;
     }
 
@@ -97,9 +95,7 @@ public:
 
     WebParameterServer& registerParameterBundle(ParameterBundle& bundle) {
         ParameterServer::registerParameterBundle(bundle);
-        for (auto* p : bundle.parameters()) {
-            if (p) ParameterRegistry::global().add(p);
-        }
+        ParameterRegistry::global().addAll(bundle.parameters());
         return *this;
     }
 };
@@ -0,0 +1,56 @@
+/**
+ * Precompiled Header for User Code
+ *
+ * The headers nearly every sketch includes, compiled once per library
+ * directory (/app/lib-<backend>[-<audio mode>]/al_web_pch.hpp.pch) by
+ * compile.sh and force-included into the user's translation unit with
+ * -include-pch. Include guards make the sketch's own #includes of these
+ * headers no-ops, so most of the compile time left is the sketch itself.
+ *
+ * Keep this list to headers that are cheap to have in every sketch and
+ * that don't depend on macros a sketch might define first. Adding a
+ * header here changes nothing for sketches that already include it, and
+ * costs the others only a larger PCH to load.
+ *
+ * Set AL_NO_PCH=1 in the compile environment to build without it.
+ */
+
+#ifndef AL_WEB_PCH_HPP
+#define AL_WEB_PCH_HPP
+
+// Standard library
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// AlloLib and the web layer
+#include "al_WebApp.hpp"
+#include "al_playground_compat.hpp"
+#include "al_WebPBR.hpp"
+#include "al_WebEnvironment.hpp"
+#include "al_WebOBJ.hpp"
+#include "al/graphics/al_Shapes.hpp"
+#include "al/graphics/al_Mesh.hpp"
+#include "al/math/al_Random.hpp"
+#include "al/scene/al_PolySynth.hpp"
+
+// Gamma
+#include "Gamma/Analysis.h"
+#include "Gamma/Effects.h"
+#include "Gamma/Envelope.h"
+#include "Gamma/Filter.h"
+#include "Gamma/Noise.h"
+#include "Gamma/Oscillator.h"
+
+#endif // AL_WEB_PCH_HPP
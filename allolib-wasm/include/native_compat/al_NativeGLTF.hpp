@@ -12,6 +12,8 @@
  *        #define CGLTF_IMPLEMENTATION
  *        #include "cgltf.h"
  *      (Same convention as stb_image.h.)
+ *      al_WebMeshoptDecode.hpp (header-only, EXT_meshopt_compression
+ *      decoding) is included from the directory above this one.
  *   3. Include this header where you use al::WebGLTF:
  *        #include "native_compat/al_NativeGLTF.hpp"
  *
@@ -24,6 +26,8 @@
  * Differences from web:
  *   - load() is synchronous on native (file I/O is fast on disk vs the web
  *     fetch path). The callback fires before load() returns.
+ *   - No progressive loading: every primitive is ready once load() returns
+ *     (primitiveReady() / onPrimitiveReady() are kept for source parity).
  *   - Image decode is unimplemented here — embedded image bytes are still
  *     populated in WebGLTFImage::bytes for callers to feed to stb_image
  *     or similar.
@@ -42,6 +46,7 @@
 #include <vector>
 
 #include "cgltf.h"
+#include "../al_WebMeshoptDecode.hpp"
 
 #include "al/graphics/al_Mesh.hpp"
 #include "al/math/al_Vec.hpp"
@@ -97,6 +102,7 @@ struct WebGLTFSkinInfo {
 class WebGLTF {
 public:
     using LoadCallback = std::function<void(bool success)>;
+    using PrimitiveCallback = std::function<void(size_t index)>;
 
     WebGLTF() = default;
     ~WebGLTF() { if (mData) { cgltf_free(mData); mData = nullptr; } }
@@ -116,6 +122,10 @@ public:
             cgltf_free(parsed);
             return false;
         }
+        if (!MeshoptDecoder::decodeGLTF(parsed)) {
+            cgltf_free(parsed);
+            return false;
+        }
         bool ok = extractAllPrimitives(parsed, out, nullptr, nullptr);
         cgltf_free(parsed);
         return ok;
@@ -136,6 +146,10 @@ public:
             cgltf_free(mData); mData = nullptr;
             return false;
         }
+        if (!MeshoptDecoder::decodeGLTF(mData)) {
+            cgltf_free(mData); mData = nullptr;
+            return false;
+        }
 
         mPrimitives.clear();
         mMaterials.clear();
@@ -196,6 +210,9 @@ public:
             return;
         }
         bool ok = parseAndRetain(bytes.data(), bytes.size(), url);
+        if (ok && mPrimitiveCallback) {
+            for (size_t i = 0; i < mPrimitives.size(); ++i) mPrimitiveCallback(i);
+        }
         if (mCallback) mCallback(ok);
     }
     void load(const std::string& url, LoadCallback cb) {
@@ -206,11 +223,30 @@ public:
     bool ready() const { return mReady; }
     const std::string& url() const { return mUrl; }
 
+    // Progressive loading surface of the web build; trivial here
+    void setPriority(float priority) { mPriority = priority; }
+    float priority() const { return mPriority; }
+    void cancel() {}
+    void onPrimitiveReady(PrimitiveCallback cb) { mPrimitiveCallback = std::move(cb); }
+    float progress() const { return mReady ? 1.0f : 0.0f; }
+
     const Mesh& mesh() const { return mCombined; }
     Mesh&       mesh()       { return mCombined; }
 
     size_t primitiveCount() const { return mPrimitives.size(); }
     const Mesh& primitiveMesh(size_t i) const { return mPrimitives.at(i); }
+    bool primitiveReady(size_t i) const { return i < mPrimitives.size(); }
+    size_t readyPrimitiveCount() const { return mPrimitives.size(); }
+    void primitiveBounds(size_t i, Vec3f& min, Vec3f& max) const {
+        const auto& verts = mPrimitives.at(i).vertices();
+        min = max = verts.empty() ? Vec3f(0, 0, 0) : verts[0];
+        for (const auto& v : verts) {
+            for (int k = 0; k < 3; ++k) {
+                min[k] = v[k] < min[k] ? v[k] : min[k];
+                max[k] = v[k] > max[k] ? v[k] : max[k];
+            }
+        }
+    }
     const WebGLTFMaterial& primitiveMaterial(size_t i) const { return mMaterials.at(i); }
 
     size_t imageCount() const { return mImages.size(); }
@@ -752,6 +788,8 @@ private:
     std::vector<WebGLTFSkinInfo>  mSkins;
     bool                         mReady = false;
     LoadCallback                 mCallback;
+    PrimitiveCallback            mPrimitiveCallback;
+    float                        mPriority = 0.0f;
     cgltf_data*                  mData = nullptr;
 };
 
@@ -102,6 +102,14 @@ public:
         return false;
     }
 
+    /// WebHDR::Format parity. Native always decodes to RGB float via
+    /// stb_image, so setFormat() is accepted and ignored.
+    enum class Format { Float32, RGBA16F, RGB9E5 };
+    void setFormat(Format) {}
+    Format format() const { return Format::Float32; }
+    void setPreviewWidth(int) {}
+    void releasePixels() {}  // sampleDirection() reads the full image
+
     // Accessors (same as WebHDR)
     bool ready() const { return mReady; }
     int width() const { return mWidth; }
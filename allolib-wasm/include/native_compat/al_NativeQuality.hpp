@@ -11,6 +11,10 @@
  *
  *   // In onAnimate
  *   quality.update(dt);
+ *
+ * update(dt, FrameTimings) is mirrored too. Native builds have no GPU timer
+ * or render scale, so pass cpuMs/intervalMs from your own timers and leave
+ * gpuMs at 0; a GPU bottleneck is then inferred from long frames.
  */
 
 #ifndef AL_NATIVE_QUALITY_HPP
@@ -21,6 +25,8 @@
 #include <functional>
 #include <algorithm>
 
+#include "../al_WebFrameStats.hpp"
+
 namespace al {
 
 /**
@@ -100,22 +106,31 @@ public:
      * Update with frame time
      */
     void update(double dt) {
-        mFrameTimeAccum += dt;
-        mFrameCount++;
-
-        if (mFrameTimeAccum >= 0.5) {
-            mCurrentFPS = mFrameCount / mFrameTimeAccum;
-            mFrameTimeAccum = 0;
-            mFrameCount = 0;
-
-            for (int i = FPS_HISTORY_SIZE - 1; i > 0; i--) {
-                mFPSHistory[i] = mFPSHistory[i-1];
-            }
-            mFPSHistory[0] = mCurrentFPS;
+        if (sampleFPS(dt) && mAdaptiveEnabled && mPreset == QualityPreset::Auto) {
+            adaptQuality();
+        }
+    }
 
-            if (mAdaptiveEnabled && mPreset == QualityPreset::Auto) {
-                adaptQuality();
-            }
+    /**
+     * Update with the measured cost of the last frame (see al_WebQuality.hpp)
+     */
+    void update(double dt, const FrameTimings& timings) {
+        sampleFPS(dt);
+
+        const auto smooth = [](float& avg, float sample) {
+            avg = avg > 0.0f ? avg + (sample - avg) * 0.1f : sample;
+        };
+        smooth(mCpuMs, timings.cpuMs);
+        smooth(mIntervalMs, timings.intervalMs);
+        if (timings.gpuMs > 0.0f) smooth(mGpuMs, timings.gpuMs);
+        else mGpuMs = 0.0f;
+
+        mControlTimer += dt;
+        if (mControlTimer < CONTROL_INTERVAL) return;
+        mControlTimer = 0;
+
+        if (mAdaptiveEnabled && mPreset == QualityPreset::Auto) {
+            adaptToFrameTime();
         }
     }
 
@@ -241,6 +256,17 @@ public:
         return sum / FPS_HISTORY_SIZE;
     }
 
+    float targetFrameMs() const { return 1000.0f / std::max(1.0f, mTargetFPS); }
+    float cpuFrameMs() const { return mCpuMs; }
+    float gpuFrameMs() const { return mGpuMs; }
+
+    void setRenderScaleRange(float minScale, float maxScale = 1.0f) {
+        mMinRenderScale = std::min(1.0f, std::max(0.25f, minScale));
+        mMaxRenderScale = std::min(1.0f, std::max(mMinRenderScale, maxScale));
+    }
+    float minRenderScale() const { return mMinRenderScale; }
+    float maxRenderScale() const { return mMaxRenderScale; }
+
     void setAdaptive(bool enabled) { mAdaptiveEnabled = enabled; }
     bool isAdaptive() const { return mAdaptiveEnabled; }
 
@@ -274,6 +300,8 @@ public:
     }
 
     float estimatedGPULoad() const {
+        if (mGpuMs > 0.0f) return std::min(1.0f, mGpuMs / targetFrameMs());
+
         float load = 0;
         load += mSettings.resolutionScale * 0.3f;
         load += (1.0f / mSettings.lodBias) * 0.2f;
@@ -287,6 +315,67 @@ public:
 
 private:
     static const int FPS_HISTORY_SIZE = 10;
+    static constexpr double CONTROL_INTERVAL = 0.25;
+    static constexpr float FRAME_HEADROOM = 0.9f;
+
+    bool sampleFPS(double dt) {
+        mFrameTimeAccum += dt;
+        mFrameCount++;
+
+        if (mFrameTimeAccum < 0.5) return false;
+        mCurrentFPS = mFrameCount / mFrameTimeAccum;
+        mFrameTimeAccum = 0;
+        mFrameCount = 0;
+
+        for (int i = FPS_HISTORY_SIZE - 1; i > 0; i--) {
+            mFPSHistory[i] = mFPSHistory[i-1];
+        }
+        mFPSHistory[0] = mCurrentFPS;
+        return true;
+    }
+
+    void adaptToFrameTime() {
+        const float target = targetFrameMs();
+        const float budget = target * FRAME_HEADROOM;
+        const bool cpuBound = mCpuMs > budget;
+
+        float gpu = mGpuMs;
+        if (gpu <= 0.0f && !cpuBound && mIntervalMs > target * 1.1f) gpu = mIntervalMs;
+
+        float scale = std::min(mMaxRenderScale, std::max(mMinRenderScale, mSettings.resolutionScale));
+        if (!cpuBound) {
+            float ideal = gpu > 0.0f ? scale * std::sqrt(budget / gpu) : mMaxRenderScale;
+            if (std::abs(ideal - scale) > 0.02f * scale) {
+                scale += std::min(0.05f, std::max(-0.1f, ideal - scale));
+            }
+            scale = std::min(mMaxRenderScale, std::max(mMinRenderScale, scale));
+        }
+        bool changed = std::abs(scale - mSettings.resolutionScale) >= 0.005f;
+        mSettings.resolutionScale = scale;
+
+        const bool gpuOver = gpu > budget && scale <= mMinRenderScale;
+        const bool roomy = mCpuMs < budget * 0.7f && scale >= mMaxRenderScale &&
+                           (mGpuMs > 0.0f ? mGpuMs < budget * 0.7f : gpu <= 0.0f);
+        if (cpuBound || gpuOver) {
+            mStabilityCounter = std::min(0, mStabilityCounter) - 1;
+            if (mStabilityCounter <= -4) {
+                decreaseQuality(false);
+                mStabilityCounter = 0;
+                changed = false;
+            }
+        } else if (roomy) {
+            mStabilityCounter = std::max(0, mStabilityCounter) + 1;
+            if (mStabilityCounter >= 12) {
+                increaseQuality(false);
+                mStabilityCounter = 0;
+                changed = false;
+            }
+        } else {
+            mStabilityCounter = 0;
+        }
+
+        if (changed && mCallback) mCallback(mSettings);
+    }
 
     void adaptQuality() {
         float avgFPS = averageFPS();
@@ -309,7 +398,7 @@ private:
         }
     }
 
-    void decreaseQuality() {
+    void decreaseQuality(bool withResolution = true) {
         if (mSettings.ambientOcclusion) {
             mSettings.ambientOcclusion = false;
             printf("[Quality] Disabled AO (FPS: %.1f)\n", mCurrentFPS);
@@ -328,7 +417,7 @@ private:
         } else if (mSettings.lodBias < 3.0f) {
             mSettings.lodBias += 0.5f;
             printf("[Quality] Increased LOD bias (FPS: %.1f)\n", mCurrentFPS);
-        } else if (mSettings.resolutionScale > 0.5f) {
+        } else if (withResolution && mSettings.resolutionScale > 0.5f) {
             mSettings.resolutionScale -= 0.1f;
             printf("[Quality] Reduced resolution scale (FPS: %.1f)\n", mCurrentFPS);
         } else if (mSettings.shadowsEnabled) {
@@ -339,11 +428,11 @@ private:
         if (mCallback) mCallback(mSettings);
     }
 
-    void increaseQuality() {
+    void increaseQuality(bool withResolution = true) {
         if (!mSettings.shadowsEnabled) {
             mSettings.shadowsEnabled = true;
             printf("[Quality] Enabled shadows (FPS: %.1f)\n", mCurrentFPS);
-        } else if (mSettings.resolutionScale < 1.0f) {
+        } else if (withResolution && mSettings.resolutionScale < 1.0f) {
             mSettings.resolutionScale = std::min(1.0f, mSettings.resolutionScale + 0.1f);
             printf("[Quality] Increased resolution scale (FPS: %.1f)\n", mCurrentFPS);
         } else if (mSettings.lodBias > 1.0f) {
@@ -379,6 +468,13 @@ private:
     bool mAdaptiveEnabled;
     int mStabilityCounter;
     QualityChangeCallback mCallback;
+
+    float mCpuMs = 0.0f;
+    float mGpuMs = 0.0f;
+    float mIntervalMs = 0.0f;
+    double mControlTimer = 0.0;
+    float mMinRenderScale = 0.5f;
+    float mMaxRenderScale = 1.0f;
 };
 
 // Alias for web compatibility
@@ -57,6 +57,11 @@ public:
     }
 
     bool ready() const { return mInner.ready(); }
+    bool meshReady(unsigned int i) const { return mInner.primitiveReady(i); }
+    unsigned int meshesReady() const {
+        return static_cast<unsigned int>(mInner.readyPrimitiveCount());
+    }
+    float progress() const { return mInner.progress(); }
 
     WebGLTF&       gltf()       { return mInner; }
     const WebGLTF& gltf() const { return mInner; }
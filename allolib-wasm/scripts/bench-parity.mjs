@@ -0,0 +1,269 @@
+#!/usr/bin/env node
+/**
+ * Native vs Web Benchmark Parity
+ *
+ * Compares the native and wasm builds of allolib_bench and dsp_bench.
+ * Both build from the same source and generate the same seeded inputs.
+ * Natively the loaders, LOD and quality code come from native_compat; in
+ * wasm they are the al_Web* headers. Each benchmark's ratio is the wasm
+ * time per unit of work divided by the native one, so 1.0 is parity and
+ * 2.0 means wasm is half as fast. Ratios are grouped by subsystem (the
+ * name up to the first '.') as a geometric mean, with the worst benchmark
+ * alongside.
+ *
+ * allolib_bench also records a digest of each benchmark's output. A digest
+ * that differs between the builds means the two sides did different work,
+ * e.g. a shim with a different simplifier. Such a ratio compares
+ * implementations, not codegen, and is marked.
+ *
+ * Run both builds (native executables; wasm .js files run under this Node):
+ *   node scripts/bench-parity.mjs --native-bin build-native --wasm-bin build [--quick]
+ *
+ * Or compare JSON from earlier runs:
+ *   node scripts/bench-parity.mjs --native bench-native.json --wasm bench-wasm.json \
+ *       --native-dsp dsp-native.json --wasm-dsp dsp-wasm.json
+ *
+ * Options:
+ *   --quick            pass --quick to the benchmarks
+ *   --filter <text>    pass --filter to the benchmarks
+ *   --out <file>       write the report as JSON
+ *   --max-ratio <r>    exit 1 if any subsystem's ratio is above r
+ */
+
+import { spawnSync } from 'child_process'
+import * as fs from 'fs'
+import * as os from 'os'
+import * as path from 'path'
+
+const DIGEST_TOLERANCE = 1e-3  // Relative; native and wasm round differently
+
+function usage (message) {
+  if (message) console.error(`bench-parity: ${message}`)
+  console.error('usage: bench-parity.mjs (--native-bin dir --wasm-bin dir | --native file --wasm file' +
+    ' [--native-dsp file --wasm-dsp file]) [--quick] [--filter text] [--out file] [--max-ratio r]')
+  process.exit(2)
+}
+
+function parseArgs (argv) {
+  const args = { quick: false }
+  const valued = {
+    '--native-bin': 'nativeBin',
+    '--wasm-bin': 'wasmBin',
+    '--native': 'native',
+    '--wasm': 'wasm',
+    '--native-dsp': 'nativeDsp',
+    '--wasm-dsp': 'wasmDsp',
+    '--filter': 'filter',
+    '--out': 'out',
+    '--max-ratio': 'maxRatio',
+  }
+  for (let i = 0; i < argv.length; i++) {
+    if (argv[i] === '--quick') {
+      args.quick = true
+    } else if (valued[argv[i]] && i + 1 < argv.length) {
+      args[valued[argv[i]]] = argv[++i]
+    } else {
+      usage(`unknown argument ${argv[i]}`)
+    }
+  }
+  if (args.maxRatio !== undefined) {
+    args.maxRatio = Number(args.maxRatio)
+    if (!(args.maxRatio > 0)) usage('--max-ratio needs a positive number')
+  }
+  const running = args.nativeBin || args.wasmBin
+  if (running && !(args.nativeBin && args.wasmBin)) usage('--native-bin and --wasm-bin go together')
+  if (!running && !(args.native && args.wasm) && !(args.nativeDsp && args.wasmDsp)) {
+    usage('nothing to compare')
+  }
+  return args
+}
+
+// ─── Running the benchmarks ─────────────────────────────────────────────────
+
+// The wasm builds are Node programs; the native ones are executables
+function benchCommand (dir, name, wasm) {
+  if (wasm) {
+    const file = path.join(dir, `${name}.js`)
+    return fs.existsSync(file) ? [process.execPath, [file]] : null
+  }
+  for (const file of [path.join(dir, name), path.join(dir, `${name}.exe`)]) {
+    if (fs.existsSync(file)) return [file, []]
+  }
+  return null
+}
+
+function runSuite (dir, name, wasm, args) {
+  const command = benchCommand(dir, name, wasm)
+  if (!command) {
+    console.error(`[bench-parity] No ${wasm ? 'wasm' : 'native'} ${name} in ${dir}, skipping`)
+    return null
+  }
+  const [program, prefix] = command
+  const flags = [...prefix]
+  if (args.quick) flags.push('--quick')
+  if (args.filter) flags.push('--filter', args.filter)
+
+  // allolib_bench writes its JSON to a file (the loaders log to stdout),
+  // dsp_bench prints it to stdout
+  let outFile = null
+  if (name === 'allolib_bench') {
+    outFile = path.join(os.tmpdir(), `bench-parity-${process.pid}-${wasm ? 'wasm' : 'native'}.json`)
+    flags.push('--out', outFile)
+  }
+
+  console.error(`[bench-parity] ${wasm ? 'wasm  ' : 'native'} ${name}`)
+  const run = spawnSync(program, flags, {
+    encoding: 'utf8',
+    maxBuffer: 64 * 1024 * 1024,
+    stdio: ['ignore', 'pipe', 'inherit'],
+  })
+  if (run.status !== 0) {
+    throw new Error(`${program} exited with ${run.status ?? run.signal}`)
+  }
+  if (!outFile) return JSON.parse(run.stdout)
+  const report = JSON.parse(fs.readFileSync(outFile, 'utf8'))
+  fs.unlinkSync(outFile)
+  return report
+}
+
+function readReport (file) {
+  return file ? JSON.parse(fs.readFileSync(file, 'utf8')) : null
+}
+
+// ─── Comparing ──────────────────────────────────────────────────────────────
+
+// Time per unit of work for each benchmark, keyed so native and wasm match
+function subsystemTimes (report) {
+  const times = new Map()
+  if (!report) return times
+  for (const r of report.results) {
+    if (r.bench !== undefined) {
+      times.set(r.bench, { time: r.medianMs, unit: 'ms', digest: r.digest })
+    } else {
+      times.set(`${r.kernel}@${r.block}`, { time: r.nsPerSample, unit: 'ns/sample' })
+    }
+  }
+  return times
+}
+
+function digestsMatch (a, b) {
+  if (a === undefined || b === undefined) return null
+  const scale = Math.max(Math.abs(a), Math.abs(b), 1e-9)
+  return Math.abs(a - b) / scale <= DIGEST_TOLERANCE
+}
+
+function compare (nativeReport, wasmReport) {
+  const native = subsystemTimes(nativeReport)
+  const wasm = subsystemTimes(wasmReport)
+  const rows = []
+  for (const [name, n] of native) {
+    const w = wasm.get(name)
+    if (!w || !(n.time > 0) || !(w.time > 0)) continue
+    rows.push({
+      bench: name,
+      subsystem: name.split('.')[0],
+      unit: n.unit,
+      native: n.time,
+      wasm: w.time,
+      ratio: w.time / n.time,
+      digestMatch: digestsMatch(n.digest, w.digest),
+    })
+  }
+  const unmatched = [...native.keys(), ...wasm.keys()].filter(k => !(native.has(k) && wasm.has(k)))
+  return { rows, unmatched: [...new Set(unmatched)] }
+}
+
+function summarize (rows) {
+  const groups = new Map()
+  for (const row of rows) {
+    if (!groups.has(row.subsystem)) groups.set(row.subsystem, [])
+    groups.get(row.subsystem).push(row)
+  }
+  return [...groups].map(([subsystem, list]) => {
+    const logSum = list.reduce((sum, r) => sum + Math.log(r.ratio), 0)
+    const worst = list.reduce((a, b) => (b.ratio > a.ratio ? b : a))
+    return {
+      subsystem,
+      benchmarks: list.length,
+      ratio: Math.exp(logSum / list.length),
+      worst: worst.bench,
+      worstRatio: worst.ratio,
+      digestMismatches: list.filter(r => r.digestMatch === false).map(r => r.bench),
+    }
+  }).sort((a, b) => b.ratio - a.ratio)
+}
+
+function printReport (rows, subsystems, unmatched) {
+  const pad = (s, n) => String(s).padEnd(n)
+  const num = (x, n, digits = 3) => x.toFixed(digits).padStart(n)
+
+  console.log(`\n${pad('benchmark', 34)} ${'native'.padStart(11)} ${'wasm'.padStart(11)} ${'wasm/native'.padStart(12)}`)
+  for (const r of rows) {
+    const mark = r.digestMatch === false ? '  output differs' : ''
+    console.log(`${pad(r.bench, 34)} ${num(r.native, 11)} ${num(r.wasm, 11)} ${num(r.ratio, 11, 2)}x${mark}`)
+  }
+
+  console.log(`\n${pad('subsystem', 16)} ${'n'.padStart(3)} ${'ratio'.padStart(8)}  worst`)
+  for (const s of subsystems) {
+    console.log(`${pad(s.subsystem, 16)} ${String(s.benchmarks).padStart(3)} ${num(s.ratio, 7, 2)}x  ` +
+      `${s.worst} (${s.worstRatio.toFixed(2)}x)`)
+  }
+
+  const mismatched = rows.filter(r => r.digestMatch === false)
+  if (mismatched.length > 0) {
+    console.log(`\nOutput differs between native and wasm (different work, ratio compares implementations):`)
+    for (const r of mismatched) console.log(`  ${r.bench}`)
+  }
+  if (unmatched.length > 0) {
+    console.log(`\nOnly in one build: ${unmatched.join(', ')}`)
+  }
+}
+
+// ─── Main ───────────────────────────────────────────────────────────────────
+
+const args = parseArgs(process.argv.slice(2))
+
+let reports
+if (args.nativeBin) {
+  reports = ['allolib_bench', 'dsp_bench'].map(name => [
+    runSuite(args.nativeBin, name, false, args),
+    runSuite(args.wasmBin, name, true, args),
+  ])
+} else {
+  reports = [
+    [readReport(args.native), readReport(args.wasm)],
+    [readReport(args.nativeDsp), readReport(args.wasmDsp)],
+  ]
+}
+
+const rows = []
+const unmatched = []
+const platforms = []
+for (const [native, wasm] of reports) {
+  if (!native || !wasm) continue
+  const result = compare(native, wasm)
+  rows.push(...result.rows)
+  unmatched.push(...result.unmatched)
+  platforms.push({ native: native.simd, wasm: wasm.simd })
+}
+if (rows.length === 0) {
+  console.error('bench-parity: no benchmarks in common')
+  process.exit(1)
+}
+
+const subsystems = summarize(rows)
+printReport(rows, subsystems, unmatched)
+
+if (args.out) {
+  const report = { version: 1, simd: platforms, subsystems, results: rows, unmatched }
+  fs.writeFileSync(args.out, JSON.stringify(report, null, 2) + '\n')
+  console.error(`\nWrote ${args.out}`)
+}
+
+if (args.maxRatio !== undefined) {
+  const over = subsystems.filter(s => s.ratio > args.maxRatio)
+  if (over.length > 0) {
+    console.error(`\nAbove ${args.maxRatio}x: ${over.map(s => `${s.subsystem} (${s.ratio.toFixed(2)}x)`).join(', ')}`)
+    process.exit(1)
+  }
+}
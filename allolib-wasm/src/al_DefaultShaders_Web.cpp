@@ -375,4 +375,42 @@ void compileMultiLightShader(ShaderProgram& s, ShaderType type, int num_lights,
             multilight_frag_shader(type, num_lights));
 }
 
+// clustered point lights, after the per-light terms (reuses d, r, n_d, e_r)
+std::string multilight_frag_body_clustered() {
+  return R"(
+    vec3 frag_eye = -eye_dir;
+    uvec2 range = al_clusterRange(-frag_eye.z);
+    for (uint i = 0u; i < range.y; i += 1u) {
+        vec4 pos_radius;
+        vec3 light_color;
+        al_clusterLight(range.x + i, pos_radius, light_color);
+        vec3 to_light = pos_radius.xyz - frag_eye;
+        float dist = length(to_light);
+        if (dist >= pos_radius.w) continue;
+        d = to_light / dist;
+        r = -reflect(d, n);
+        n_d = max(dot(n, d), 0.0);
+        e_r = max(dot(e, r), 0.0);
+        lighting += al_clusterAttenuation(dist, pos_radius.w) * light_color *
+                    (diffuse * n_d + specular * pow(e_r, shininess));
+    }
+)";
+}
+
+std::string clustered_multilight_frag_shader(ShaderType type, int num_lights) {
+  return multilight_frag_header_common() +
+         multilight_frag_header_pertype(type) +
+         multilight_frag_header_perlight(num_lights) +
+         al_clustered_lights_frag_functions() + multilight_frag_body_begin() +
+         multilight_frag_body_pertype(type) +
+         multilight_frag_body_perlight(num_lights) +
+         multilight_frag_body_clustered() + multilight_frag_body_end();
+}
+
+void compileClusteredLightShader(ShaderProgram& s, ShaderType type,
+                                 int num_lights) {
+  s.compile(multilight_vert_shader(type, num_lights, false),
+            clustered_multilight_frag_shader(type, num_lights));
+}
+
 }  // namespace al
@@ -3,6 +3,7 @@
  */
 
 #include "al_GraphicsWebExtension.hpp"
+#include "al_WebTransformSIMD.hpp"
 #include "al/graphics/al_OpenGL.hpp"
 #include <cstdio>
 #include <cstring>
@@ -107,7 +108,7 @@ void GraphicsWebExtension::syncMatrices() {
     if (!mBackend || !mGraphics) return;
 
     // Get model-view matrix
-    Mat4f mv = mGraphics->viewMatrix() * mGraphics->modelMatrix();
+    Mat4f mv = transform_simd::mul(mGraphics->viewMatrix(), mGraphics->modelMatrix());
     mBackend->setUniformMat4("modelViewMatrix", mv.elems());
 
     // Get projection matrix
@@ -169,6 +170,13 @@ void GraphicsWebExtension::drawWithBackend(const Mesh& mesh) {
 
     // 5. Prepare and draw mesh
     if (mMeshAdapter.prepareMesh(mesh)) {
+        const MeshCacheEntry* entry = mMeshAdapter.getCacheEntry(&mesh);
+        if (entry && entry->compression == VertexCompression::Quantized) {
+            // Quantized positions decode through the modelView matrix
+            Mat4f mv = transform_simd::mul(mGraphics->viewMatrix(), mGraphics->modelMatrix());
+            WebMeshAdapter::applyPositionDecode(*entry, mv.elems());
+            mBackend->setUniformMat4("modelViewMatrix", mv.elems());
+        }
         PrimitiveType prim = meshPrimitiveToPrimitiveType(mesh.primitive());
         mMeshAdapter.drawMesh(prim);
     }
@@ -13,15 +13,19 @@
 #include "al_WebGPUBackend.hpp"
 #endif
 #include "al_WebMeshAdapter.hpp"
+#include "al_WebClusteredLights.hpp"
 #include "al_FBOBridge.hpp"
+#include "al_WebTransformSIMD.hpp"
+#include <algorithm>
 #include <utility>
 #include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #include "al/graphics/al_OpenGL.hpp"
-#include <unordered_map>
-#include <vector>
 #endif
 
 namespace al {
@@ -32,6 +36,72 @@ static GraphicsBackend* sGraphicsBackend = nullptr;
 static WebMeshAdapter sMeshAdapter;
 static bool sWebGPUMode = false;
 
+static void flushInstanceBatches();
+
+// ─── Automatic Instancing ────────────────────────────────────────────────────
+// Opt-in (Graphics_setAutoInstancing). Draws the backend's instanced default
+// shader can reproduce - no lighting, texture or custom shader, depth
+// tested and written, opaque - are deferred. Deferred draws of the same mesh
+// under the same projection and draw state replay as one instanced draw with
+// a per-instance modelView and color. Batches are submitted before anything
+// order-dependent: the backend's flush hook (clear, viewport, render target,
+// shader change, end of frame) and immediate draws that could blend with them.
+
+struct InstanceBatch {
+    const Mesh* mesh = nullptr;
+    DrawState state;
+    float projection[16];
+    float pointSize = 1.0f;
+    float eyeSep = 0.0f;
+    float focLen = 6.0f;
+    std::vector<InstanceAttributes> instances;
+};
+
+static bool sAutoInstancing = false;
+static std::vector<InstanceBatch> sInstanceBatches;  // [0, sActiveBatches) pending
+static size_t sActiveBatches = 0;
+static std::unordered_map<const Mesh*, size_t> sBatchByMesh;  // Latest batch per mesh
+static BufferHandle sInstanceBuffer;
+static size_t sInstanceCapacity = 0;  // In records
+static size_t sInstanceCursor = 0;    // Records written this frame (never overwritten
+                                      // before the frame's commands run)
+
+// ─── Frustum Culling ─────────────────────────────────────────────────────────
+// Opt-in (Graphics_setFrustumCulling). Before a draw reaches either backend,
+// the mesh's model-space bounding box is tested against the six planes of
+// projection * view * model; a box wholly outside one plane is skipped.
+// VAOMesh and InterleavedMesh bounds are cached by mesh address and
+// recomputed when the vertex storage or count changes (VAOMesh) or the
+// version does (InterleavedMesh); Graphics_invalidateMeshBounds() covers
+// VAOMesh edits that keep both. Plain Mesh draws copy or diff every vertex
+// anyway, and are often temporaries that reuse an address, so their bounds
+// are scanned per draw instead of trusted from the cache.
+
+struct MeshBounds {
+    const void* data = nullptr;
+    size_t count = 0;
+    uint32_t version = 0;
+    uint64_t lastUsedFrame = 0;
+    float min[3] = {0.0f, 0.0f, 0.0f};
+    float max[3] = {0.0f, 0.0f, 0.0f};
+};
+
+static bool sFrustumCulling = false;
+static std::unordered_map<const void*, MeshBounds> sBoundsCache;
+static uint64_t sCullFrame = 0;
+static FrustumCullStats sCullCounts;  // This frame so far
+static FrustumCullStats sCullStats;   // Last completed frame
+// Entries not drawn for this long are dropped (their mesh may be gone)
+static constexpr uint64_t kBoundsEvictionFrames = 300;
+
+static DrawStats sDrawCounts;  // This frame so far
+static DrawStats sDrawStats;   // Last completed frame
+
+static void countDraw(size_t vertices) {
+    sDrawCounts.draws++;
+    sDrawCounts.vertices += vertices;
+}
+
 // ─── Texture Bridge (OpenGL ↔ WebGPU) ────────────────────────────────────────
 
 struct TextureBridgeEntry {
@@ -41,14 +111,36 @@ struct TextureBridgeEntry {
     uint32_t version = 0;  // To detect if texture data changed
 };
 
-static std::unordered_map<GLuint, TextureBridgeEntry> sTextureBridge;
+// Dense tables indexed by GL texture name: glGenTextures hands out small
+// consecutive names, so a bind is an array lookup. Synthetic depth ids for
+// RBO-backed FBOs count up from kSyntheticDepthIdBase in their own table.
+static constexpr GLuint kSyntheticDepthIdBase = 0x80000000;
+static std::vector<TextureBridgeEntry> sTextureBridge;
+static std::vector<TextureBridgeEntry> sSyntheticTextureBridge;
 static GLuint sLastBoundGLTexture = 0;
 
+// Registered entry for a GL texture, or nullptr
+static TextureBridgeEntry* findBridgeEntry(GLuint glTextureId) {
+    bool synthetic = glTextureId >= kSyntheticDepthIdBase;
+    auto& table = synthetic ? sSyntheticTextureBridge : sTextureBridge;
+    size_t index = synthetic ? glTextureId - kSyntheticDepthIdBase : glTextureId;
+    if (index >= table.size() || !table[index].webgpuHandle.valid()) return nullptr;
+    return &table[index];
+}
+
+static TextureBridgeEntry& bridgeEntry(GLuint glTextureId) {
+    bool synthetic = glTextureId >= kSyntheticDepthIdBase;
+    auto& table = synthetic ? sSyntheticTextureBridge : sTextureBridge;
+    size_t index = synthetic ? glTextureId - kSyntheticDepthIdBase : glTextureId;
+    if (index >= table.size()) table.resize(index + 1);
+    return table[index];
+}
+
 // Register a texture for WebGPU use (called after texture.submit())
 void Graphics_registerTexture(GLuint glTextureId, int width, int height, const void* pixels) {
     if (!sWebGPUMode || !sGraphicsBackend || glTextureId == 0) return;
 
-    auto it = sTextureBridge.find(glTextureId);
+    TextureBridgeEntry* entry = findBridgeEntry(glTextureId);
 
     // Create new or update existing
     TextureDesc desc;
@@ -59,26 +151,28 @@ void Graphics_registerTexture(GLuint glTextureId, int width, int height, const v
     desc.magFilter = FilterMode::Linear;
     desc.wrapS = WrapMode::Repeat;
     desc.wrapT = WrapMode::Repeat;
+    desc.mipmaps = true;  // Backend downsamples after upload; avoids level-0 aliasing at distance
 
-    if (it == sTextureBridge.end()) {
+    if (!entry) {
         // Create new WebGPU texture
         TextureHandle handle = sGraphicsBackend->createTexture(desc, pixels);
         if (handle.valid()) {
-            sTextureBridge[glTextureId] = {handle, width, height, 1};
+            bridgeEntry(glTextureId) = {handle, width, height, 1};
             printf("[Graphics] Registered GL texture %u → WebGPU (size: %dx%d)\n",
                    glTextureId, width, height);
         }
     } else {
         // Update existing texture
-        if (it->second.width != width || it->second.height != height) {
+        if (entry->width != width || entry->height != height) {
             // Size changed - recreate
-            sGraphicsBackend->destroyTexture(it->second.webgpuHandle);
+            sGraphicsBackend->destroyTexture(entry->webgpuHandle);
             TextureHandle handle = sGraphicsBackend->createTexture(desc, pixels);
-            it->second = {handle, width, height, it->second.version + 1};
+            *entry = {handle, width, height, entry->version + 1};
         } else {
             // Same size - just update data
-            sGraphicsBackend->updateTexture(it->second.webgpuHandle, pixels);
-            it->second.version++;
+            sGraphicsBackend->updateTexture(entry->webgpuHandle, pixels);
+            sGraphicsBackend->generateMipmaps(entry->webgpuHandle);
+            entry->version++;
         }
     }
 }
@@ -89,15 +183,14 @@ void Graphics_registerRenderTargetTexture(GLuint glTextureId, int width, int hei
     if (!sWebGPUMode || !sGraphicsBackend || glTextureId == 0) return;
 
     // Check if already registered
-    auto it = sTextureBridge.find(glTextureId);
-    if (it != sTextureBridge.end() && it->second.webgpuHandle.valid()) {
+    if (TextureBridgeEntry* entry = findBridgeEntry(glTextureId)) {
         // Already registered - check if size matches
-        if (it->second.width == width && it->second.height == height) {
+        if (entry->width == width && entry->height == height) {
             return; // Already registered with correct size
         }
         // Size changed - destroy old and recreate
-        sGraphicsBackend->destroyTexture(it->second.webgpuHandle);
-        sTextureBridge.erase(it);
+        sGraphicsBackend->destroyTexture(entry->webgpuHandle);
+        *entry = {};
     }
 
     TextureDesc desc;
@@ -120,7 +213,7 @@ void Graphics_registerRenderTargetTexture(GLuint glTextureId, int width, int hei
     // Create without initial data (it's a render target)
     TextureHandle handle = sGraphicsBackend->createTexture(desc, nullptr);
     if (handle.valid()) {
-        sTextureBridge[glTextureId] = {handle, width, height, 1};
+        bridgeEntry(glTextureId) = {handle, width, height, 1};
         printf("[Graphics] Registered GL texture %u as render target (size: %dx%d, depth: %s)\n",
                glTextureId, width, height, isDepth ? "yes" : "no");
     } else {
@@ -140,9 +233,8 @@ void Graphics_onTextureBind(GLuint glTextureId, int unit) {
         return;
     }
 
-    auto it = sTextureBridge.find(glTextureId);
-    if (it != sTextureBridge.end() && it->second.webgpuHandle.valid()) {
-        sGraphicsBackend->setTexture("tex0", it->second.webgpuHandle, unit);
+    if (TextureBridgeEntry* entry = findBridgeEntry(glTextureId)) {
+        sGraphicsBackend->setTexture("tex0", entry->webgpuHandle, unit);
     } else {
         printf("[Graphics] Warning: GL texture %u not found in WebGPU bridge\n", glTextureId);
     }
@@ -151,20 +243,22 @@ void Graphics_onTextureBind(GLuint glTextureId, int unit) {
 // Check if there's a registered texture for WebGPU
 bool Graphics_hasWebGPUTexture() {
     if (!sWebGPUMode || sLastBoundGLTexture == 0) return false;
-    auto it = sTextureBridge.find(sLastBoundGLTexture);
-    return it != sTextureBridge.end() && it->second.webgpuHandle.valid();
+    return findBridgeEntry(sLastBoundGLTexture) != nullptr;
 }
 
 // Clean up texture bridge
 void Graphics_clearTextureBridge() {
     if (sGraphicsBackend) {
-        for (auto& [glId, entry] : sTextureBridge) {
-            if (entry.webgpuHandle.valid()) {
-                sGraphicsBackend->destroyTexture(entry.webgpuHandle);
+        for (auto* table : {&sTextureBridge, &sSyntheticTextureBridge}) {
+            for (auto& entry : *table) {
+                if (entry.webgpuHandle.valid()) {
+                    sGraphicsBackend->destroyTexture(entry.webgpuHandle);
+                }
             }
         }
     }
     sTextureBridge.clear();
+    sSyntheticTextureBridge.clear();
     sLastBoundGLTexture = 0;
 }
 
@@ -175,9 +269,8 @@ TextureHandle Graphics_getTextureHandle(GLuint glTextureId) {
     if (!sWebGPUMode || !sGraphicsBackend || glTextureId == 0) {
         return TextureHandle{0};
     }
-    auto it = sTextureBridge.find(glTextureId);
-    if (it != sTextureBridge.end()) {
-        return it->second.webgpuHandle;
+    if (TextureBridgeEntry* entry = findBridgeEntry(glTextureId)) {
+        return entry->webgpuHandle;
     }
     return TextureHandle{0};
 }
@@ -208,7 +301,7 @@ void Graphics_bindFramebuffer(unsigned int fboId) {
 }
 
 // Counter for synthetic depth texture IDs (for FBOs using RBOs)
-static GLuint sSyntheticDepthIdCounter = 0x80000000;  // Start high to avoid conflicts
+static GLuint sSyntheticDepthIdCounter = kSyntheticDepthIdBase;  // Start high to avoid conflicts
 
 // Register an EasyFBO with the WebGPU bridge
 // Called after EasyFBO::init() to create WebGPU render target
@@ -260,9 +353,17 @@ void Graphics_setBackend(GraphicsBackend* backend) {
     if (sGraphicsBackend != backend) {
         FBO_clearAll();
     }
+    if (sGraphicsBackend != backend) {
+        // Pending batches and the instance buffer belong to the old backend
+        flushInstanceBatches();
+        sInstanceBuffer = {};
+        sInstanceCapacity = 0;
+        sInstanceCursor = 0;
+    }
     sGraphicsBackend = backend;
     sMeshAdapter.setBackend(backend);
     sWebGPUMode = backend && backend->isWebGPU();
+    if (backend) backend->setFlushHook(flushInstanceBatches);
 #ifdef __EMSCRIPTEN__
     EM_ASM({ console.log('[Graphics] Backend set, WebGPU mode: ' + $0); }, sWebGPUMode ? 1 : 0);
 #endif
@@ -272,6 +373,66 @@ GraphicsBackend* Graphics_getBackend() {
     return sGraphicsBackend;
 }
 
+WebMeshAdapter& Graphics_meshAdapter() {
+    return sMeshAdapter;
+}
+
+WebMeshAdapter::CacheStats Graphics_meshCacheStats() {
+    return sMeshAdapter.cacheStats();
+}
+
+void Graphics_setVertexCompression(VertexCompression compression) {
+    sMeshAdapter.setVertexCompression(compression);
+}
+
+void Graphics_beginFrame() {
+    // Transient mesh geometry from last frame has been uploaded by now
+    sMeshAdapter.beginFrame();
+    // Last frame's instance records have been consumed too
+    sInstanceCursor = 0;
+
+    sCullStats = sCullCounts;
+    sCullCounts = FrustumCullStats();
+    sDrawStats = sDrawCounts;
+    sDrawCounts = DrawStats();
+    if (++sCullFrame % 60 == 0) {
+        for (auto it = sBoundsCache.begin(); it != sBoundsCache.end();) {
+            if (it->second.lastUsedFrame + kBoundsEvictionFrames < sCullFrame) it = sBoundsCache.erase(it);
+            else ++it;
+        }
+    }
+}
+
+void Graphics_setAutoInstancing(bool enabled) {
+    if (!enabled) flushInstanceBatches();
+    sAutoInstancing = enabled;
+}
+
+bool Graphics_autoInstancing() {
+    return sAutoInstancing;
+}
+
+void Graphics_setFrustumCulling(bool enabled) {
+    sFrustumCulling = enabled;
+    if (!enabled) sBoundsCache.clear();
+}
+
+bool Graphics_frustumCulling() {
+    return sFrustumCulling;
+}
+
+void Graphics_invalidateMeshBounds(const void* mesh) {
+    sBoundsCache.erase(mesh);
+}
+
+FrustumCullStats Graphics_frustumCullStats() {
+    return sCullStats;
+}
+
+DrawStats Graphics_drawStats() {
+    return sDrawStats;
+}
+
 bool Graphics_isWebGPU() {
     return sWebGPUMode;
 }
@@ -488,6 +649,13 @@ void Graphics::light(Light const &l, int idx) {
     numLight(idx + 1);
 }
 
+void Graphics::clusteredLights(ClusteredLights *lights) {
+  if (mClusteredLights != lights) {
+    mClusteredLights = lights;
+    mRenderModeChanged = true;
+  }
+}
+
 void Graphics::enableLight(int idx) { mLightOn[idx] = true; }
 void Graphics::disableLight(int idx) { mLightOn[idx] = false; }
 void Graphics::toggleLight(int idx) { mLightOn[idx] = !mLightOn[idx]; }
@@ -569,15 +737,21 @@ void Graphics::camera(const Viewpoint &v) {
 void Graphics::send_lighting_uniforms(ShaderProgram &s,
                                       lighting_shader_uniforms const &u) {
   s.uniform4v(u.global_ambient, Light::globalAmbient().components);
-  s.uniformMatrix4(
-      u.normal_matrix,
-      (viewMatrix() * modelMatrix()).inversed().transpose().elems());
+  const Mat4f view = viewMatrix();
+  Mat4f mv = transform_simd::mul(view, modelMatrix());
+  float normal[16];
+  if (transform_simd::normalMatrix4(mv.elems(), normal)) {
+    s.uniformMatrix4(u.normal_matrix, normal);
+  } else {
+    s.uniformMatrix4(u.normal_matrix, mv.inversed().transpose().elems());
+  }
   for (int i = 0; i < u.num_lights; i += 1) {
     s.uniform4v(u.lights[i].ambient, mLights[i].ambient().components);
     s.uniform4v(u.lights[i].diffuse, mLights[i].diffuse().components);
     s.uniform4v(u.lights[i].specular, mLights[i].specular().components);
-    s.uniform4v(u.lights[i].position, (viewMatrix() * Vec4f{mLights[i].pos()})
-                                          .elems()); // could be optimized...
+    float position[4];
+    transform_simd::transform(position, view.elems(), Vec4f{mLights[i].pos()}.elems());
+    s.uniform4v(u.lights[i].position, position);
     s.uniform(u.lights[i].enabled,
               (mLightOn[i] ? 1.0f : 0.0f)); // could be optimized...
     // s.uniform4v(u.lights[i].atten, mLights[i].attenuation());
@@ -593,6 +767,14 @@ void Graphics::send_lighting_uniforms(ShaderProgram &s,
 }
 
 void Graphics::update() {
+  // WebGPU draws take the grid from the backend (syncLightingToBackend)
+  if (mClusteredLights && mLightingEnabled && !is_omni && !sWebGPUMode &&
+      mColoringMode != ColoringMode::CUSTOM) {
+    update_clustered();
+    RenderManager::update();
+    return;
+  }
+
   if (mRenderModeChanged) {
     switch (mColoringMode) {
     case ColoringMode::UNIFORM:
@@ -756,6 +938,62 @@ void Graphics::update() {
   RenderManager::update();
 }
 
+// lit draws with a ClusteredLights grid: same uniforms as the per-light
+// shaders plus the grid's textures, which are rebound every draw since the
+// grid changes each frame and other code may use those units in between
+void Graphics::update_clustered() {
+  int type = 0;
+  ShaderType shader_type = ShaderType::LIGHTING_COLOR;
+  switch (mColoringMode) {
+  case ColoringMode::MESH:
+    type = 1;
+    shader_type = ShaderType::LIGHTING_MESH;
+    break;
+  case ColoringMode::TEXTURE:
+    type = 2;
+    shader_type = ShaderType::LIGHTING_TEXTURE;
+    break;
+  case ColoringMode::MATERIAL:
+    type = 3;
+    shader_type = ShaderType::LIGHTING_MATERIAL;
+    break;
+  default:
+    break;
+  }
+  ClusteredShader &c = clustered_lighting[type][num_lights - 1];
+
+  if (mRenderModeChanged) {
+    if (!c.compiled) {
+      compileClusteredLightShader(c.shader, shader_type, num_lights);
+      c.uniforms = al_get_lighting_uniform_locations(c.shader);
+      c.color_location = c.shader.getUniformLocation("col0");
+      c.tint_location = c.shader.getUniformLocation("tint");
+      if (shader_type == ShaderType::LIGHTING_TEXTURE) {
+        c.shader.begin();
+        c.shader.uniform("tex0", 0);
+        c.shader.end();
+      }
+      c.compiled = true;
+    }
+    RenderManager::shader(c.shader);
+    mRenderModeChanged = false;
+    mUniformChanged = true;
+  }
+
+  auto &s = RenderManager::shader();
+  if (mUniformChanged) {
+    send_lighting_uniforms(s, c.uniforms);
+    if (shader_type == ShaderType::LIGHTING_COLOR)
+      s.uniform4v(c.color_location, mColor.components);
+    s.uniform4v(c.tint_location, mTint.components);
+    s.uniform("eye_sep", mLens.eyeSep() * mEye / 2.0f);
+    s.uniform("foc_len", mLens.focalLength());
+    s.uniform("al_PointSize", gl::getPointSize());
+    mUniformChanged = false;
+  }
+  mClusteredLights->bind(s);
+}
+
 void Graphics::eye(float e) {
   mEye = e;
   mUniformChanged = true;
@@ -781,30 +1019,6 @@ bool Graphics::omni() { return is_omni; }
 // ─── WebGPU Backend Draw Routing ─────────────────────────────────────────────
 
 #ifdef ALLOLIB_WEBGPU
-// Helper: compute 3x3 matrix inverse for normal matrix
-static bool invert3x3(const float* m, float* inv) {
-    // m is column-major 3x3 stored as m[col*3 + row]
-    float det = m[0] * (m[4] * m[8] - m[7] * m[5])
-              - m[3] * (m[1] * m[8] - m[7] * m[2])
-              + m[6] * (m[1] * m[5] - m[4] * m[2]);
-
-    if (std::abs(det) < 1e-10f) return false;
-
-    float invDet = 1.0f / det;
-
-    inv[0] = (m[4] * m[8] - m[7] * m[5]) * invDet;
-    inv[1] = (m[7] * m[2] - m[1] * m[8]) * invDet;
-    inv[2] = (m[1] * m[5] - m[4] * m[2]) * invDet;
-    inv[3] = (m[6] * m[5] - m[3] * m[8]) * invDet;
-    inv[4] = (m[0] * m[8] - m[6] * m[2]) * invDet;
-    inv[5] = (m[3] * m[2] - m[0] * m[5]) * invDet;
-    inv[6] = (m[3] * m[7] - m[6] * m[4]) * invDet;
-    inv[7] = (m[6] * m[1] - m[0] * m[7]) * invDet;
-    inv[8] = (m[0] * m[4] - m[3] * m[1]) * invDet;
-
-    return true;
-}
-
 // Helper: sync lighting state from Graphics to WebGPU backend
 static void syncLightingToBackend(Graphics& g, const Mat4f& mv) {
     auto* backend = dynamic_cast<WebGPUBackend*>(sGraphicsBackend);
@@ -815,26 +1029,18 @@ static void syncLightingToBackend(Graphics& g, const Mat4f& mv) {
 
     if (!lightingOn) return;
 
-    // Compute normal matrix = transpose(inverse(upper-left 3x3 of modelView))
-    // Extract upper-left 3x3 from modelView (column-major)
-    const float* mvElems = mv.elems();
-    float mv3x3[9] = {
-        mvElems[0], mvElems[1], mvElems[2],   // column 0
-        mvElems[4], mvElems[5], mvElems[6],   // column 1
-        mvElems[8], mvElems[9], mvElems[10]   // column 2
-    };
-
-    float invMv3x3[9];
-    if (invert3x3(mv3x3, invMv3x3)) {
-        // Transpose the inverse to get normal matrix
-        float normalMat[9] = {
-            invMv3x3[0], invMv3x3[3], invMv3x3[6],
-            invMv3x3[1], invMv3x3[4], invMv3x3[7],
-            invMv3x3[2], invMv3x3[5], invMv3x3[8]
-        };
+    // Normal matrix = transpose(inverse(upper-left 3x3 of modelView))
+    float normalMat[9];
+    if (transform_simd::normalMatrix3(mv.elems(), normalMat)) {
         backend->setNormalMatrix(normalMat);
     } else {
         // Fallback: use upper-left 3x3 directly (works for rotation-only transforms)
+        const float* mvElems = mv.elems();
+        float mv3x3[9] = {
+            mvElems[0], mvElems[1], mvElems[2],   // column 0
+            mvElems[4], mvElems[5], mvElems[6],   // column 1
+            mvElems[8], mvElems[9], mvElems[10]   // column 2
+        };
         backend->setNormalMatrix(mv3x3);
     }
 
@@ -866,14 +1072,158 @@ static void syncLightingToBackend(Graphics& g, const Mat4f& mv) {
     // AlloLib Material doesn't expose emission, use default (black/none)
     float matEmis[4] = {0.0f, 0.0f, 0.0f, 0.0f};
     backend->setMaterial(matAmb, matDiff, matSpec, matEmis, mat.shininess());
+
+    // Point lights binned by ClusteredLights::update()
+    backend->setClusteredLighting(g.clusteredLights() != nullptr && !g.omni());
 }
 #endif // ALLOLIB_WEBGPU
 
-static void drawMeshWithWebGPU(Graphics& g, const Mesh& m) {
+static bool sameDrawState(const DrawState& a, const DrawState& b) {
+    return a.blend == b.blend && a.cull == b.cull && a.depth == b.depth &&
+           a.depthWrite == b.depthWrite && a.depthTest == b.depthTest &&
+           a.scissorTest == b.scissorTest &&
+           a.scissorX == b.scissorX && a.scissorY == b.scissorY &&
+           a.scissorW == b.scissorW && a.scissorH == b.scissorH &&
+           a.lineWidth == b.lineWidth && a.pointSize == b.pointSize;
+}
+
+// Blend modes that reduce to a plain overwrite for fragments with alpha 1
+static bool opaqueUnder(BlendMode blend, float alpha, const MeshCacheEntry* entry) {
+    if (blend == BlendMode::None) return true;
+    if (blend != BlendMode::Alpha && blend != BlendMode::PreMultiplied) return false;
+    return alpha >= 1.0f && entry && entry->opaque;
+}
+
+static void flushInstanceBatches() {
+    if (sActiveBatches == 0 || !sGraphicsBackend) {
+        sActiveBatches = 0;
+        return;
+    }
+    GraphicsBackend* backend = sGraphicsBackend;
+
+    size_t total = 0;
+    for (size_t i = 0; i < sActiveBatches; i++) {
+        total += sInstanceBatches[i].instances.size();
+    }
+
+    // Records are appended for the whole frame: rewriting a range already
+    // used by an earlier flush would change what those draws read
+    if (sInstanceCursor + total > sInstanceCapacity) {
+        size_t capacity = std::max<size_t>(sInstanceCapacity * 2, 256);
+        while (capacity < total) capacity *= 2;
+        if (sInstanceBuffer.valid()) backend->destroyBuffer(sInstanceBuffer);
+        sInstanceBuffer = backend->createBuffer(
+            BufferType::Vertex, BufferUsage::Dynamic, nullptr,
+            capacity * sizeof(InstanceAttributes));
+        sInstanceCapacity = sInstanceBuffer.valid() ? capacity : 0;
+        sInstanceCursor = 0;
+        if (!sInstanceBuffer.valid()) {
+            printf("[Graphics] Failed to allocate the auto-instancing buffer\n");
+        }
+    }
+
+    DrawState saved = backend->getDrawState();
+    for (size_t i = 0; i < sActiveBatches; i++) {
+        InstanceBatch& batch = sInstanceBatches[i];
+        size_t count = batch.instances.size();
+        if (sInstanceBuffer.valid()) {
+            size_t offset = sInstanceCursor * sizeof(InstanceAttributes);
+            backend->updateBuffer(sInstanceBuffer, batch.instances.data(),
+                                  count * sizeof(InstanceAttributes), offset);
+            sInstanceCursor += count;
+
+            // Color travels per instance; the uniform color multiplies on top
+            backend->setDrawState(batch.state);
+            backend->setUniformMat4("projectionMatrix", batch.projection);
+            backend->setUniform("tint", 1.0f, 1.0f, 1.0f, 1.0f);
+            backend->setUniform("color", 1.0f, 1.0f, 1.0f, 1.0f);
+            backend->setUniform("pointSize", batch.pointSize);
+            backend->setUniform("eyeSep", batch.eyeSep);
+            backend->setUniform("focLen", batch.focLen);
+            backend->setInstanceBuffer(sInstanceBuffer, offset);
+            sMeshAdapter.drawMeshInstanced(batch.mesh, static_cast<int>(count));
+        }
+        batch.instances.clear();
+    }
+    backend->setInstanceBuffer({});
+    backend->setDrawState(saved);
+
+    sActiveBatches = 0;
+    sBatchByMesh.clear();
+}
+
+// Queue the draw for instancing; false means draw it now (after flushing
+// pending batches if the two could interact through draw order)
+static bool deferMesh(Graphics& g, const Mesh& m) {
+    GraphicsBackend* backend = sGraphicsBackend;
+    Color col = g.currentColor();
+    DrawState state = backend->getDrawState();
+    bool eligible = !g.lightingEnabled() &&
+                    (g.coloringMode() == Graphics::ColoringMode::UNIFORM ||
+                     g.coloringMode() == Graphics::ColoringMode::MESH) &&
+                    state.depthTest && state.depthWrite &&
+                    backend->supportsInstanceBuffer();
+
+    const MeshCacheEntry* entry = nullptr;
+    if (eligible && sMeshAdapter.prepareMesh(m)) {
+        entry = sMeshAdapter.getCacheEntry(&m);
+    }
+    if (entry && opaqueUnder(state.blend, col.a, entry) &&
+        entry->convertedPrimitive != PrimitiveType::TriangleFan &&
+        entry->convertedPrimitive != PrimitiveType::LineLoop) {
+        InstanceAttributes instance;
+        Mat4f mv = transform_simd::mul(g.viewMatrix(), g.modelMatrix());
+        WebMeshAdapter::applyPositionDecode(*entry, mv.elems());
+        memcpy(instance.modelView, mv.elems(), sizeof(instance.modelView));
+        instance.tint[0] = col.r;
+        instance.tint[1] = col.g;
+        instance.tint[2] = col.b;
+        instance.tint[3] = col.a;
+
+        Mat4f proj = g.projMatrix();
+        float pointSize = gl::getPointSize();
+        float eyeSep = static_cast<float>(g.lens().eyeSep() * g.eye() / 2.0f);
+        float focLen = static_cast<float>(g.lens().focalLength());
+
+        InstanceBatch* batch = nullptr;
+        auto it = sBatchByMesh.find(&m);
+        if (it != sBatchByMesh.end()) {
+            InstanceBatch& candidate = sInstanceBatches[it->second];
+            if (sameDrawState(candidate.state, state) &&
+                memcmp(candidate.projection, proj.elems(), sizeof(candidate.projection)) == 0 &&
+                candidate.pointSize == pointSize && candidate.eyeSep == eyeSep &&
+                candidate.focLen == focLen) {
+                batch = &candidate;
+            }
+        }
+        if (!batch) {
+            if (sActiveBatches == sInstanceBatches.size()) sInstanceBatches.emplace_back();
+            batch = &sInstanceBatches[sActiveBatches];
+            sBatchByMesh[&m] = sActiveBatches++;
+            batch->mesh = &m;
+            batch->state = state;
+            memcpy(batch->projection, proj.elems(), sizeof(batch->projection));
+            batch->pointSize = pointSize;
+            batch->eyeSep = eyeSep;
+            batch->focLen = focLen;
+        }
+        batch->instances.push_back(instance);
+        return true;
+    }
+
+    if (sActiveBatches > 0) {
+        if (!entry) entry = sMeshAdapter.getCacheEntry(&m);  // Last known contents
+        if (!state.depthTest || !state.depthWrite || !opaqueUnder(state.blend, col.a, entry)) {
+            flushInstanceBatches();
+        }
+    }
+    return false;
+}
+
+// Upload the per-draw matrices and uniforms; returns the modelView matrix
+static Mat4f syncDrawUniforms(Graphics& g) {
     // Sync matrices
-    Mat4f model = g.modelMatrix();
-    Mat4f view = g.viewMatrix();
-    Mat4f mv = view * model;
+    Mat4f mv = transform_simd::mul(g.viewMatrix(), g.modelMatrix());
     Mat4f proj = g.projMatrix();
 
     sGraphicsBackend->setUniformMat4("modelViewMatrix", mv.elems());
@@ -892,15 +1242,117 @@ static void drawMeshWithWebGPU(Graphics& g, const Mesh& m) {
     // Sync lighting state (Phase 2)
     syncLightingToBackend(g, mv);
 #endif
+    return mv;
+}
+
+// Quantized positions decode through the modelView matrix
+static void applyMeshPositionDecode(const void* mesh, Mat4f& mv) {
+    const MeshCacheEntry* entry = sMeshAdapter.getCacheEntry(mesh);
+    if (entry && entry->compression == VertexCompression::Quantized) {
+        WebMeshAdapter::applyPositionDecode(*entry, mv.elems());
+        sGraphicsBackend->setUniformMat4("modelViewMatrix", mv.elems());
+    }
+}
+
+static void drawMeshWithWebGPU(Graphics& g, const Mesh& m) {
+    if (sAutoInstancing && deferMesh(g, m)) return;
+
+    Mat4f mv = syncDrawUniforms(g);
 
     // Prepare and draw mesh
     if (sMeshAdapter.prepareMesh(m)) {
+        applyMeshPositionDecode(&m, mv);
         PrimitiveType prim = meshPrimitiveToPrimitiveType(m.primitive());
         sMeshAdapter.drawMesh(prim);
     }
 }
 
+static void scanBounds(const Mesh& m, float* mn, float* mx) {
+    const auto& verts = m.vertices();
+    for (int c = 0; c < 3; ++c) mn[c] = mx[c] = verts[0][c];
+    for (const auto& v : verts) {
+        for (int c = 0; c < 3; ++c) {
+            mn[c] = std::min(mn[c], v[c]);
+            mx[c] = std::max(mx[c], v[c]);
+        }
+    }
+}
+
+static void scanBounds(const InterleavedMesh& m, float* mn, float* mx) {
+    for (int c = 0; c < 3; ++c) mn[c] = mx[c] = m.vertices[0].position[c];
+    for (const InterleavedVertex& v : m.vertices) {
+        for (int c = 0; c < 3; ++c) {
+            mn[c] = std::min(mn[c], v.position[c]);
+            mx[c] = std::max(mx[c], v.position[c]);
+        }
+    }
+}
+
+// Cached bounds, rescanned when the storage, count or version moved
+template <class M>
+static const MeshBounds& cachedBounds(const M& m, const void* data, size_t count, uint32_t version) {
+    MeshBounds& b = sBoundsCache[&m];
+    if (b.lastUsedFrame == 0 || b.data != data || b.count != count || b.version != version) {
+        scanBounds(m, b.min, b.max);
+        b.data = data;
+        b.count = count;
+        b.version = version;
+    }
+    b.lastUsedFrame = sCullFrame + 1;  // Never 0 once scanned
+    return b;
+}
+
+// The draw's vertex shader must place positions by the current matrices
+static bool cullable(Graphics& g) {
+    return sFrustumCulling && g.coloringMode() != Graphics::ColoringMode::CUSTOM && !g.omni() &&
+           (g.eye() == 0.0f || g.lens().eyeSep() == 0.0);
+}
+
+// True when the model-space box lies wholly outside a clip plane
+static bool boxOffscreen(Graphics& g, const float* mn, const float* mx, size_t vertices) {
+    sCullCounts.tested++;
+    Mat4f m = transform_simd::mul(transform_simd::mul(g.projMatrix(), g.viewMatrix()), g.modelMatrix());
+    for (int i = 0; i < 6; ++i) {
+        // Gribb & Hartmann: row 3 +/- row i, tested at the box corner
+        // furthest along the plane normal
+        const int row = i / 2;
+        const float sign = (i & 1) ? -1.0f : 1.0f;
+        float d = m(3, 3) + sign * m(row, 3);
+        for (int c = 0; c < 3; ++c) {
+            float n = m(3, c) + sign * m(row, c);
+            d += n * (n >= 0.0f ? mx[c] : mn[c]);
+        }
+        if (d < 0.0f) {
+            sCullCounts.culled++;
+            sCullCounts.culledVertices += vertices;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool culled(Graphics& g, const Mesh& m) {
+    if (!cullable(g) || m.vertices().empty()) return false;
+    float mn[3], mx[3];
+    scanBounds(m, mn, mx);
+    return boxOffscreen(g, mn, mx, m.vertices().size());
+}
+
+static bool culled(Graphics& g, const VAOMesh& m) {
+    if (!cullable(g) || m.vertices().empty()) return false;
+    const MeshBounds& b = cachedBounds<Mesh>(m, m.vertices().data(), m.vertices().size(), 0);
+    return boxOffscreen(g, b.min, b.max, b.count);
+}
+
+static bool culled(Graphics& g, const InterleavedMesh& m) {
+    if (!cullable(g) || m.vertices.empty()) return false;
+    const MeshBounds& b = cachedBounds(m, m.vertices.data(), m.vertices.size(), m.version);
+    return boxOffscreen(g, b.min, b.max, b.count);
+}
+
 void Graphics::draw(const Mesh& mesh) {
+    if (culled(*this, mesh)) return;
+    countDraw(mesh.vertices().size());
     if (sWebGPUMode && sGraphicsBackend) {
         drawMeshWithWebGPU(*this, mesh);
         return;
@@ -909,6 +1361,8 @@ void Graphics::draw(const Mesh& mesh) {
 }
 
 void Graphics::draw(Mesh&& mesh) {
+    if (culled(*this, mesh)) return;
+    countDraw(mesh.vertices().size());
     if (sWebGPUMode && sGraphicsBackend) {
         drawMeshWithWebGPU(*this, mesh);
         return;
@@ -919,6 +1373,8 @@ void Graphics::draw(Mesh&& mesh) {
 }
 
 void Graphics::draw(VAOMesh& mesh) {
+    if (culled(*this, mesh)) return;
+    countDraw(mesh.vertices().size());
     if (sWebGPUMode && sGraphicsBackend) {
         // VAOMesh is a Mesh, route through backend
         drawMeshWithWebGPU(*this, mesh);
@@ -929,9 +1385,33 @@ void Graphics::draw(VAOMesh& mesh) {
     RenderManager::draw(mesh);
 }
 
+void Graphics::draw(const InterleavedMesh& mesh) {
+    if (culled(*this, mesh)) return;
+    countDraw(mesh.vertices.size());
+    if (sWebGPUMode && sGraphicsBackend) {
+        // Never deferred for auto-instancing: batches are keyed by Mesh
+        Mat4f mv = syncDrawUniforms(*this);
+        if (sMeshAdapter.prepareInterleaved(mesh)) {
+            applyMeshPositionDecode(&mesh, mv);
+            sMeshAdapter.drawMesh(meshPrimitiveToPrimitiveType(mesh.primitive));
+        }
+        return;
+    }
+
+    // WebGL2 renders through RenderManager, which needs an al::Mesh; build
+    // it once per version rather than per draw
+    if (!mesh.fallback || mesh.fallbackVersion != mesh.version) {
+        if (!mesh.fallback) mesh.fallback.reset(new Mesh());
+        mesh.toMesh(*mesh.fallback);
+        mesh.fallbackVersion = mesh.version;
+    }
+    RenderManager::draw(*mesh.fallback);
+}
+
 void Graphics::draw(EasyVAO& vao) {
     // EasyVAO doesn't have mesh data we can extract for WebGPU
     // Just delegate to RenderManager
+    countDraw(static_cast<size_t>(vao.mNumVertices));
     RenderManager::draw(vao);
 }
 
@@ -982,3 +1462,111 @@ void Graphics::popViewport() {
 }
 
 } // namespace al
+
+// =========================================================================
+// JavaScript bridge for GPU frame timing: WebGPU pass timestamps, or
+// WebGL2 EXT_disjoint_timer_query_webgl2 around the frame
+// =========================================================================
+#ifdef __EMSCRIPTEN__
+extern "C" {
+
+EMSCRIPTEN_KEEPALIVE
+int al_gpu_profiler_set_enabled(int enabled) {
+    if (auto* backend = al::Graphics_getBackend()) {
+        return backend->setGPUProfilingEnabled(enabled != 0) ? 1 : 0;
+    }
+    return enabled ? 0 : 1;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int al_gpu_profiler_get_enabled(void) {
+    if (auto* backend = al::Graphics_getBackend()) {
+        return backend->isGPUProfilingEnabled() ? 1 : 0;
+    }
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int al_gpu_profiler_is_supported(void) {
+    if (auto* backend = al::Graphics_getBackend()) {
+        return backend->isGPUProfilingSupported() ? 1 : 0;
+    }
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+double al_gpu_profiler_get_frame_ms(void) {
+    if (auto* backend = al::Graphics_getBackend()) {
+        return backend->getGPUFrameTimeMs();
+    }
+    return 0.0;
+}
+
+// Mesh cache (Graphics::draw adapter)
+
+EMSCRIPTEN_KEEPALIVE
+int al_mesh_cache_get_entries(void) {
+    return static_cast<int>(al::Graphics_meshCacheStats().entries);
+}
+
+EMSCRIPTEN_KEEPALIVE
+double al_mesh_cache_get_bytes(void) {
+    return static_cast<double>(al::Graphics_meshCacheStats().bytes);
+}
+
+EMSCRIPTEN_KEEPALIVE
+double al_mesh_cache_get_budget(void) {
+    return static_cast<double>(al::Graphics_meshCacheStats().budget);
+}
+
+EMSCRIPTEN_KEEPALIVE
+double al_mesh_cache_get_evictions(void) {
+    return static_cast<double>(al::Graphics_meshCacheStats().evictions);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_mesh_cache_set_budget(double bytes) {
+    al::Graphics_meshAdapter().setMemoryBudget(bytes > 0 ? static_cast<size_t>(bytes) : 0);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_mesh_cache_set_eviction_age(int frames) {
+    al::Graphics_meshAdapter().setEvictionAge(frames > 0 ? static_cast<uint32_t>(frames) : 0);
+}
+
+// Frustum culling (Graphics::draw), counts for the last completed frame
+
+EMSCRIPTEN_KEEPALIVE
+void al_frustum_culling_set_enabled(int enabled) {
+    al::Graphics_setFrustumCulling(enabled != 0);
+}
+
+EMSCRIPTEN_KEEPALIVE
+double al_frustum_culling_get_tested(void) {
+    return static_cast<double>(al::Graphics_frustumCullStats().tested);
+}
+
+EMSCRIPTEN_KEEPALIVE
+double al_frustum_culling_get_culled(void) {
+    return static_cast<double>(al::Graphics_frustumCullStats().culled);
+}
+
+EMSCRIPTEN_KEEPALIVE
+double al_frustum_culling_get_culled_vertices(void) {
+    return static_cast<double>(al::Graphics_frustumCullStats().culledVertices);
+}
+
+// Draw counts (Graphics::draw), last completed frame
+
+EMSCRIPTEN_KEEPALIVE
+double al_draw_stats_get_draws(void) {
+    return static_cast<double>(al::Graphics_drawStats().draws);
+}
+
+EMSCRIPTEN_KEEPALIVE
+double al_draw_stats_get_vertices(void) {
+    return static_cast<double>(al::Graphics_drawStats().vertices);
+}
+
+} // extern "C"
+#endif // __EMSCRIPTEN__
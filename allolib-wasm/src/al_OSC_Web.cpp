@@ -16,6 +16,11 @@
  *     bridge to actual UDP for cross-language interop.
  *   - For browser-to-browser direct messaging, both peers connect to
  *     the same WebSocket URL and the relay simply rebroadcasts.
+ *   - Optional per-Send bundling (al_WebOSCBundle.hpp) coalesces send()
+ *     calls into one OSC bundle per animation frame, so high-rate
+ *     streams cost one WebSocket frame per frame rather than per message.
+ *   - An optional per-Recv queue (al_WebOSCRecvQueue.hpp) defers handlers
+ *     to budgeted batches instead of running them inside the callback.
  *
  * Open items (deferred per the M5 sub-push plan):
  *   - The relay isn't bundled yet (M5.5). Until then, OSC works against
@@ -28,10 +33,15 @@
 #ifdef __EMSCRIPTEN__
 
 #include "al/protocol/al_OSC.hpp"
+#include "al_WebOSCBundle.hpp"
+#include "al_WebOSCRecvQueue.hpp"
 
 #include <emscripten.h>
+#include <emscripten/html5.h>
 #include <emscripten/websocket.h>
 
+#include <atomic>
+#include <climits>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
@@ -39,6 +49,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "osc/OscOutboundPacketStream.h"
@@ -267,6 +278,112 @@ static std::string buildRelayUrl(uint16_t port, const std::string& address) {
     return "ws://" + host + ":" + std::to_string(port) + "/osc";
 }
 
+// ─── Bundling ─────────────────────────────────────────────────────────────
+//
+// A bundle under construction: "#bundle\0", an 8-byte time tag of 1
+// (immediately), then each packet as a big-endian int32 size followed by
+// its bytes. OSC packets are 4-byte aligned, so elements need no padding.
+
+class BundleQueue {
+public:
+    using Transmit = size_t (*)(void* target, const char* data, size_t size);
+
+    BundleQueue(Transmit transmit, void* target) : mTransmit(transmit), mTarget(target) {}
+    ~BundleQueue() { cancelFlush(); }
+
+    void configure(const SendBundling& options) {
+        if (!options.enabled) flush();
+        mOptions = options;
+    }
+    const SendBundling& options() const { return mOptions; }
+    const SendBundleStats& stats() const { return mStats; }
+
+    size_t send(const char* data, size_t size) {
+        mStats.packets++;
+        if (!mOptions.enabled) return transmit(data, size);
+        if (mData.size() + 4 + size > mOptions.maxBytes) flush();
+        if (kHeaderSize + 4 + size > mOptions.maxBytes) return transmit(data, size);
+
+        if (mData.empty()) {
+            static const char header[kHeaderSize] = {'#', 'b', 'u', 'n', 'd', 'l', 'e', 0,
+                                                     0, 0, 0, 0, 0, 0, 0, 1};
+            mData.assign(header, header + kHeaderSize);
+            scheduleFlush();
+        }
+        const uint32_t n = (uint32_t)size;
+        const char prefix[4] = {char(n >> 24), char(n >> 16), char(n >> 8), char(n)};
+        mData.insert(mData.end(), prefix, prefix + 4);
+        mData.insert(mData.end(), data, data + size);
+        mElements++;
+        return size;  // Queued; goes out with the bundle
+    }
+
+    size_t flush() {
+        cancelFlush();
+        if (mData.empty()) return 0;
+        size_t sent;
+        if (mElements == 1) {
+            // A lone packet is sent as it is
+            sent = transmit(mData.data() + kHeaderSize + 4, mData.size() - kHeaderSize - 4);
+        } else {
+            sent = transmit(mData.data(), mData.size());
+        }
+        mData.clear();
+        mElements = 0;
+        return sent;
+    }
+
+private:
+    static constexpr size_t kHeaderSize = 16;
+
+    size_t transmit(const char* data, size_t size) {
+        mStats.frames++;
+        return mTransmit(mTarget, data, size);
+    }
+
+    void scheduleFlush() {
+        if (mOptions.maxDelayMs > 0.0) {
+            mTimer = emscripten_set_timeout(&BundleQueue::onTimeout, mOptions.maxDelayMs, this);
+        } else {
+            mFrame = emscripten_request_animation_frame(&BundleQueue::onFrame, this);
+        }
+    }
+
+    void cancelFlush() {
+        if (mTimer) emscripten_clear_timeout(mTimer);
+        if (mFrame) emscripten_cancel_animation_frame(mFrame);
+        mTimer = 0;
+        mFrame = 0;
+    }
+
+    static void onTimeout(void* userData) {
+        auto* self = (BundleQueue*)userData;
+        self->mTimer = 0;
+        self->flush();
+    }
+    static EM_BOOL onFrame(double, void* userData) {
+        auto* self = (BundleQueue*)userData;
+        self->mFrame = 0;
+        self->flush();
+        return EM_FALSE;
+    }
+
+    Transmit mTransmit;
+    void* mTarget;
+    SendBundling mOptions;
+    SendBundleStats mStats;
+    std::vector<char> mData;
+    size_t mElements = 0;
+    long mTimer = 0;
+    long mFrame = 0;
+};
+
+// Bundle queue of each live Send, for the free functions in al_WebOSCBundle.hpp
+static std::unordered_map<const Send*, BundleQueue*>& bundleQueues() {
+    static std::unordered_map<const Send*, BundleQueue*> queues;
+    return queues;
+}
+
 // ─── Send (Emscripten WebSocket transport) ────────────────────────────────
 
 class Send::SocketSender {
@@ -276,6 +393,11 @@ public:
     bool connecting = false;
     std::vector<std::vector<char>> pending;
     std::mutex mu;
+    BundleQueue bundle{&SocketSender::transmit, this};
+
+    static size_t transmit(void* target, const char* data, size_t size) {
+        return ((SocketSender*)target)->sendNow(data, size);
+    }
 
     static EM_BOOL onOpen(int, const EmscriptenWebSocketOpenEvent* e, void* userData) {
         auto* self = (SocketSender*)userData;
@@ -309,6 +431,11 @@ public:
     }
 
     size_t send(const char* data, size_t sz) {
+        if (ws <= 0) return 0;
+        return bundle.send(data, sz);
+    }
+
+    size_t sendNow(const char* data, size_t sz) {
         if (ws <= 0) return 0;
         std::lock_guard<std::mutex> lk(mu);
         if (connecting) {
@@ -321,6 +448,7 @@ public:
 
     void close() {
         if (ws > 0) {
+            bundle.flush();
             emscripten_websocket_close(ws, 1000, "shutdown");
             emscripten_websocket_delete(ws);
             ws = 0;
@@ -330,19 +458,43 @@ public:
 
 Send::Send() : Packet(1024) {
     socketSender = std::make_unique<SocketSender>();
+    bundleQueues()[this] = &socketSender->bundle;
 }
 Send::Send(int size) : Packet(size) {
     socketSender = std::make_unique<SocketSender>();
+    bundleQueues()[this] = &socketSender->bundle;
 }
 Send::Send(uint16_t port, const char* address, al_sec /*timeout*/, int size)
     : Packet(size) {
     socketSender = std::make_unique<SocketSender>();
+    bundleQueues()[this] = &socketSender->bundle;
     open(port, address);
 }
 Send::~Send() {
+    bundleQueues().erase(this);
     if (socketSender) socketSender->close();
 }
 
+void setBundling(Send& send, const SendBundling& options) {
+    auto it = bundleQueues().find(&send);
+    if (it != bundleQueues().end()) it->second->configure(options);
+}
+
+SendBundling bundling(const Send& send) {
+    auto it = bundleQueues().find(&send);
+    return it != bundleQueues().end() ? it->second->options() : SendBundling();
+}
+
+size_t flushBundle(Send& send) {
+    auto it = bundleQueues().find(&send);
+    return it != bundleQueues().end() ? it->second->flush() : 0;
+}
+
+SendBundleStats bundleStats(const Send& send) {
+    auto it = bundleQueues().find(&send);
+    return it != bundleQueues().end() ? it->second->stats() : SendBundleStats();
+}
+
 bool Send::open(uint16_t port, const char* address) {
     mPort = port;
     mAddress = address ? address : "";
@@ -361,23 +513,275 @@ size_t Send::send(const Packet& p) {
     return socketSender->send(p.data(), p.size());
 }
 
+// ─── Receive queue ────────────────────────────────────────────────────────
+//
+// Single-producer / single-consumer ring of messages in fixed-size slots,
+// allocated up front. push() (the WebSocket callback) is the only
+// producer; drain() is the only consumer and never blocks it.
+
+class RecvQueue {
+public:
+    using Dispatch = void (*)(void* target, const char* message, int size, TimeTag tag);
+
+    RecvQueue(Dispatch dispatch, void* target) : mDispatch(dispatch), mTarget(target) {}
+    ~RecvQueue() { cancelDrain(); }
+
+    void configure(const RecvQueueOptions& options) {
+        drain(INT_MAX, 0.0);
+        cancelDrain();
+        mOptions = options;
+        mCapacity = 1;
+        while (mCapacity < options.capacity) mCapacity <<= 1;
+        mHead.store(0, std::memory_order_relaxed);
+        mTail.store(0, std::memory_order_relaxed);
+        mIndexedTail = 0;
+        if (!options.enabled) {
+            std::vector<Slot>().swap(mSlots);
+            std::vector<char>().swap(mBytes);
+            std::vector<Latest>().swap(mLatest);
+            return;
+        }
+        mSlots.assign(mCapacity, Slot());
+        mBytes.assign(mCapacity * options.slotBytes, 0);
+        mLatest.assign(options.coalesce.empty() ? 0 : mCapacity * 2, Latest());
+    }
+
+    bool enabled() const { return mOptions.enabled; }
+    const RecvQueueOptions& options() const { return mOptions; }
+
+    /// Producer: queue the messages of one packet
+    void push(const char* packet, int size) {
+        try {
+            pushPacket(::osc::ReceivedPacket(packet, (::osc::osc_bundle_element_size_t)size), (TimeTag)1);
+        } catch (const ::osc::Exception& e) {
+            std::cerr << "[osc::Recv] parse error: " << e.what() << std::endl;
+        }
+        if (mOptions.autoDrain && !mFrame) {
+            mFrame = emscripten_request_animation_frame(&RecvQueue::onFrame, this);
+        }
+    }
+
+    /// Consumer: dispatch up to maxMessages within maxMicros (0 = no limit)
+    int drain(int maxMessages, double maxMicros) {
+        if (!mOptions.enabled) return 0;
+        const double start = maxMicros > 0.0 ? emscripten_get_now() : 0.0;
+        uint32_t head = mHead.load(std::memory_order_relaxed);
+        const uint32_t tail = mTail.load(std::memory_order_acquire);
+        if (!mLatest.empty() && tail != mIndexedTail) indexLatest(head, tail);
+
+        int handled = 0;
+        while (head != tail && handled < maxMessages) {
+            const Slot& s = mSlots[head & (mCapacity - 1)];
+            if (s.coalesce && superseded(head, s.hash)) {
+                mCoalesced++;
+            } else {
+                mDispatch(mTarget, slotData(head), (int)s.size, s.tag);
+                mLastSize = s.size;
+                mDispatched++;
+                handled++;
+            }
+            // The slot is reusable once head moves past it
+            mHead.store(++head, std::memory_order_release);
+            if (maxMicros > 0.0 && (emscripten_get_now() - start) * 1000.0 >= maxMicros) break;
+        }
+        return handled;
+    }
+
+    /// Size of the message the last drain() dispatched
+    size_t lastSize() const { return mLastSize; }
+
+    RecvQueueStats stats() const {
+        RecvQueueStats st;
+        st.received = mReceived.load(std::memory_order_relaxed);
+        st.dispatched = mDispatched;
+        st.coalesced = mCoalesced;
+        st.dropped = mDropped.load(std::memory_order_relaxed);
+        st.oversized = mOversized.load(std::memory_order_relaxed);
+        st.pending = mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire);
+        return st;
+    }
+
+private:
+    struct Slot {
+        uint32_t size = 0;
+        bool coalesce = false;
+        uint64_t hash = 0;  // Of the address, when coalescing
+        TimeTag tag = 1;
+    };
+
+    // Newest queued index per coalesced address hash (open addressing;
+    // entries from older passes are told apart by their stamp)
+    struct Latest {
+        uint64_t hash = 0;
+        uint32_t index = 0;
+        uint32_t stamp = 0;
+    };
+
+    void pushPacket(const ::osc::ReceivedPacket& packet, TimeTag tag) {
+        if (packet.IsBundle()) {
+            ::osc::ReceivedBundle bundle(packet);
+            for (auto it = bundle.ElementsBegin(); it != bundle.ElementsEnd(); ++it) {
+                pushPacket(::osc::ReceivedPacket(it->Contents(), it->Size()), (TimeTag)bundle.TimeTag());
+            }
+        } else {
+            pushMessage(packet.Contents(), (size_t)packet.Size(), tag);
+        }
+    }
+
+    void pushMessage(const char* message, size_t size, TimeTag tag) {
+        mReceived.fetch_add(1, std::memory_order_relaxed);
+        if (size > mOptions.slotBytes) {
+            mOversized.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const uint32_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) >= mCapacity) {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Slot& s = mSlots[tail & (mCapacity - 1)];
+        std::memcpy(slotData(tail), message, size);
+        s.size = (uint32_t)size;
+        s.tag = tag;
+        s.coalesce = coalesces(message);
+        s.hash = s.coalesce ? addressHash(message) : 0;
+        mTail.store(tail + 1, std::memory_order_release);
+    }
+
+    char* slotData(uint32_t index) {
+        return mBytes.data() + (index & (mCapacity - 1)) * mOptions.slotBytes;
+    }
+
+    // A message starts with its null-terminated address
+    bool coalesces(const char* address) const {
+        for (const std::string& prefix : mOptions.coalesce) {
+            if (std::strncmp(address, prefix.c_str(), prefix.size()) == 0) return true;
+        }
+        return false;
+    }
+
+    static uint64_t addressHash(const char* address) {
+        uint64_t h = 1469598103934665603ull;  // FNV-1a
+        for (; *address; ++address) h = (h ^ (unsigned char)*address) * 1099511628211ull;
+        return h;
+    }
+
+    Latest& latest(uint64_t hash) {
+        const size_t mask = mLatest.size() - 1;
+        for (size_t k = (size_t)hash & mask;; k = (k + 1) & mask) {
+            Latest& e = mLatest[k];
+            if (e.stamp != mStamp) {
+                e = {hash, 0, mStamp};
+                return e;
+            }
+            if (e.hash == hash) return e;
+        }
+    }
+
+    void indexLatest(uint32_t head, uint32_t tail) {
+        if (++mStamp == 0) {
+            for (Latest& e : mLatest) e.stamp = 0;
+            mStamp = 1;
+        }
+        for (uint32_t i = head; i != tail; ++i) {
+            const Slot& s = mSlots[i & (mCapacity - 1)];
+            if (s.coalesce) latest(s.hash).index = i;
+        }
+        mIndexedTail = tail;
+    }
+
+    // A newer message for the same address is queued behind this one
+    bool superseded(uint32_t index, uint64_t hash) {
+        const uint32_t newest = latest(hash).index;
+        return newest != index && std::strcmp(slotData(newest), slotData(index)) == 0;
+    }
+
+    void cancelDrain() {
+        if (mFrame) emscripten_cancel_animation_frame(mFrame);
+        mFrame = 0;
+    }
+
+    static EM_BOOL onFrame(double, void* userData) {
+        auto* self = (RecvQueue*)userData;
+        self->mFrame = 0;
+        self->drain(self->mOptions.frameMessages, self->mOptions.frameMicros);
+        if (self->stats().pending > 0) {
+            self->mFrame = emscripten_request_animation_frame(&RecvQueue::onFrame, self);
+        }
+        return EM_FALSE;
+    }
+
+    Dispatch mDispatch;
+    void* mTarget;
+    RecvQueueOptions mOptions;
+    uint32_t mCapacity = 1;
+    std::vector<Slot> mSlots;
+    std::vector<char> mBytes;
+    std::atomic<uint32_t> mHead{0};
+    std::atomic<uint32_t> mTail{0};
+    std::vector<Latest> mLatest;
+    uint32_t mStamp = 0;
+    uint32_t mIndexedTail = 0;
+    size_t mLastSize = 0;
+    long mFrame = 0;
+    std::atomic<uint64_t> mReceived{0};
+    std::atomic<uint64_t> mDropped{0};
+    std::atomic<uint64_t> mOversized{0};
+    uint64_t mDispatched = 0;  // Consumer only
+    uint64_t mCoalesced = 0;
+};
+
+// Receive queue of each live Recv, for the free functions in al_WebOSCRecvQueue.hpp
+static std::unordered_map<const Recv*, RecvQueue*>& recvQueues() {
+    static std::unordered_map<const Recv*, RecvQueue*> queues;
+    return queues;
+}
+
 // ─── Recv (Emscripten WebSocket transport) ────────────────────────────────
 
+// Visit a bundle's messages in order, descending into nested bundles; each
+// message carries the time tag of the bundle that holds it
+template <class F>
+static void forEachBundledMessage(const ::osc::ReceivedBundle& bundle, F&& f) {
+    TimeTag tag = (TimeTag)bundle.TimeTag();
+    for (auto it = bundle.ElementsBegin(); it != bundle.ElementsEnd(); ++it) {
+        if (it->IsBundle()) {
+            forEachBundledMessage(::osc::ReceivedBundle(*it), f);
+        } else {
+            f(it->Contents(), (int)it->Size(), tag);
+        }
+    }
+}
+
 class Recv::SocketReceiver {
 public:
     EMSCRIPTEN_WEBSOCKET_T ws = 0;
     std::string url;
     Recv* parent = nullptr;
+    RecvQueue queue{&SocketReceiver::dispatch, this};
 
     static EM_BOOL onMessage(int, const EmscriptenWebSocketMessageEvent* e, void* userData) {
         auto* self = (SocketReceiver*)userData;
         if (!self || !self->parent) return EM_TRUE;
         if (e->isText) return EM_TRUE;
+        if (self->queue.enabled()) {
+            self->queue.push((const char*)e->data, (int)e->numBytes);
+            return EM_TRUE;
+        }
         self->parent->parse((const char*)e->data, (int)e->numBytes,
                             self->url.c_str(), self->parent->port());
         return EM_TRUE;
     }
 
+    // One queued message to the handlers
+    static void dispatch(void* target, const char* message, int size, TimeTag tag) {
+        auto* self = (SocketReceiver*)target;
+        Recv* recv = self->parent;
+        if (!recv) return;
+        Message m(message, size, tag, self->url.c_str(), recv->port());
+        for (auto* h : recv->mHandlers) if (h) h->onMessage(m);
+    }
+
     bool open(uint16_t port, const std::string& address, Recv* p) {
         parent = p;
         url = buildRelayUrl(port, address);
@@ -400,15 +804,18 @@ public:
 Recv::Recv() {
     mBackground = false;
     socketReceiver = std::make_unique<SocketReceiver>();
+    recvQueues()[this] = &socketReceiver->queue;
     mBuffer.resize(8192);
 }
 Recv::Recv(uint16_t port, const char* address, al_sec /*timeout*/) {
     mBackground = false;
     socketReceiver = std::make_unique<SocketReceiver>();
+    recvQueues()[this] = &socketReceiver->queue;
     mBuffer.resize(8192);
     open(port, address);
 }
 Recv::~Recv() {
+    recvQueues().erase(this);
     if (socketReceiver) socketReceiver->close();
 }
 
@@ -429,14 +836,11 @@ void Recv::parse(const char* packet, int size,
             Message m(packet, size, (TimeTag)1, senderAddr, senderPort);
             for (auto* h : mHandlers) if (h) h->onMessage(m);
         } else if (rp.IsBundle()) {
-            ::osc::ReceivedBundle bundle(rp);
-            TimeTag bundleTag = (TimeTag)bundle.TimeTag();
-            for (auto it = bundle.ElementsBegin(); it != bundle.ElementsEnd(); ++it) {
-                if (it->IsMessage()) {
-                    Message m(it->Contents(), it->Size(), bundleTag, senderAddr, senderPort);
-                    for (auto* h : mHandlers) if (h) h->onMessage(m);
-                }
-            }
+            forEachBundledMessage(::osc::ReceivedBundle(rp),
+                                  [&](const char* contents, int bytes, TimeTag tag) {
+                Message m(contents, bytes, tag, senderAddr, senderPort);
+                for (auto* h : mHandlers) if (h) h->onMessage(m);
+            });
         }
     } catch (const ::osc::Exception& e) {
         std::cerr << "[osc::Recv] parse error: " << e.what() << std::endl;
@@ -444,9 +848,11 @@ void Recv::parse(const char* packet, int size,
 }
 
 int Recv::recv() {
-    // Emscripten WebSocket dispatches via callback automatically. Returning
-    // 0 ensures user-side `while(recv()){}` polling loops terminate cleanly.
-    return 0;
+    // With the receive queue on, dispatch one queued message. Otherwise the
+    // WebSocket callback has dispatched everything already; returning 0
+    // ensures user-side `while(recv()){}` polling loops terminate cleanly.
+    RecvQueue& queue = socketReceiver->queue;
+    return queue.drain(1, 0.0) > 0 ? (int)queue.lastSize() : 0;
 }
 
 bool Recv::start() { mBackground = true;  return true; }
@@ -468,14 +874,11 @@ Recv::parse(const char* packet, int size, TimeTag timeTag,
         if (rp.IsMessage()) {
             result.push_back(std::make_shared<Message>(packet, size, timeTag, senderAddr, senderPort));
         } else if (rp.IsBundle()) {
-            ::osc::ReceivedBundle bundle(rp);
-            TimeTag bundleTag = (TimeTag)bundle.TimeTag();
-            for (auto it = bundle.ElementsBegin(); it != bundle.ElementsEnd(); ++it) {
-                if (it->IsMessage()) {
-                    result.push_back(std::make_shared<Message>(
-                        it->Contents(), it->Size(), bundleTag, senderAddr, senderPort));
-                }
-            }
+            forEachBundledMessage(::osc::ReceivedBundle(rp),
+                                  [&](const char* contents, int bytes, TimeTag tag) {
+                result.push_back(std::make_shared<Message>(contents, bytes, tag, senderAddr,
+                                                           senderPort));
+            });
         }
     } catch (...) {}
     return result;
@@ -485,6 +888,26 @@ void Recv::loop() {
     // No-op; events arrive via WebSocket callback.
 }
 
+void setRecvQueue(Recv& recv, const RecvQueueOptions& options) {
+    auto it = recvQueues().find(&recv);
+    if (it != recvQueues().end()) it->second->configure(options);
+}
+
+RecvQueueOptions recvQueue(const Recv& recv) {
+    auto it = recvQueues().find(&recv);
+    return it != recvQueues().end() ? it->second->options() : RecvQueueOptions();
+}
+
+int recvBatch(Recv& recv, int maxMessages, double maxMicros) {
+    auto it = recvQueues().find(&recv);
+    return it != recvQueues().end() ? it->second->drain(maxMessages, maxMicros) : 0;
+}
+
+RecvQueueStats recvQueueStats(const Recv& recv) {
+    auto it = recvQueues().find(&recv);
+    return it != recvQueues().end() ? it->second->stats() : RecvQueueStats();
+}
+
 } // namespace osc
 
 // ─── Web stubs for al::Socket / al::Thread ────────────────────────────────
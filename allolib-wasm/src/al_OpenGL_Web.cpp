@@ -10,9 +10,12 @@
  * WebGPU mode:
  * - All GL functions become no-ops (rendering state managed by backend)
  * - Only pointSize/getPointSize remain functional for compatibility
+ * - Blend/depth/cull state is mirrored into a DrawState and forwarded to
+ *   the backend, which keys its pipeline cache on it
  */
 
 #include "al/graphics/al_OpenGL.hpp"
+#include "al_WebGraphicsBackend.hpp"
 
 #include <cstdio>
 #include <cstring>
@@ -37,6 +40,7 @@ extern "C" {
 // Forward declaration to check WebGPU mode
 namespace al {
     bool Graphics_isWebGPU();
+    GraphicsBackend* Graphics_getBackend();
 }
 
 namespace al {
@@ -45,6 +49,45 @@ namespace gl {
 // Helper macro to early-return in WebGPU mode
 #define WEBGPU_NOOP_CHECK() if (Graphics_isWebGPU()) return
 
+// ─── WebGPU Draw State Mirror ────────────────────────────────────────────────
+// GL state calls can't touch a WebGPU pipeline directly, so we track them here
+// and push the combined DrawState to the backend. Starts from the state the
+// WebGPU path has always rendered with (alpha blend, depth test, no culling).
+
+struct WebGPUStateMirror {
+    bool blendEnabled = true;
+    BlendMode blendFunc = BlendMode::Alpha;
+    bool cullEnabled = false;
+    CullFace cullFace = CullFace::Back;
+    bool depthTest = true;
+    bool depthWrite = true;
+};
+
+static WebGPUStateMirror sWebGPUState;
+
+static void pushWebGPUDrawState() {
+    GraphicsBackend* backend = Graphics_getBackend();
+    if (!backend) return;
+
+    DrawState state;
+    state.blend = sWebGPUState.blendEnabled ? sWebGPUState.blendFunc : BlendMode::None;
+    state.cull = sWebGPUState.cullEnabled ? sWebGPUState.cullFace : CullFace::None;
+    state.depthTest = sWebGPUState.depthTest;
+    state.depthWrite = sWebGPUState.depthWrite;
+    backend->setDrawState(state);
+}
+
+// Map a GL blend factor pair onto the backend's blend presets
+static BlendMode toBlendMode(unsigned int src, unsigned int dst) {
+    if (src == GL_SRC_ALPHA && dst == GL_ONE_MINUS_SRC_ALPHA) return BlendMode::Alpha;
+    if ((src == GL_SRC_ALPHA || src == GL_ONE) && dst == GL_ONE) return BlendMode::Additive;
+    if ((src == GL_DST_COLOR && dst == GL_ZERO) ||
+        (src == GL_ZERO && dst == GL_SRC_COLOR)) return BlendMode::Multiply;
+    if (src == GL_ONE && dst == GL_ONE_MINUS_SRC_ALPHA) return BlendMode::PreMultiplied;
+    if (src == GL_ONE && dst == GL_ONE_MINUS_SRC_COLOR) return BlendMode::Screen;
+    return BlendMode::Alpha;
+}
+
 // Point size is stored via the JS bridge in al_WebGL2Extensions.cpp
 // We use the extern "C" functions to maintain a single source of truth
 extern "C" {
@@ -159,23 +202,39 @@ void viewport(int left, int bottom, int width, int height) {
 }
 
 void blending(bool doBlend) {
-  WEBGPU_NOOP_CHECK();
+  if (Graphics_isWebGPU()) {
+    sWebGPUState.blendEnabled = doBlend;
+    pushWebGPUDrawState();
+    return;
+  }
   doBlend ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
 }
 
 void blendMode(unsigned int src, unsigned int dst, unsigned int eq) {
-  WEBGPU_NOOP_CHECK();
+  if (Graphics_isWebGPU()) {
+    sWebGPUState.blendFunc = toBlendMode(src, dst);
+    pushWebGPUDrawState();
+    return;
+  }
   glBlendEquation(eq);
   glBlendFunc(src, dst);
 }
 
 void depthTesting(bool testDepth) {
-  WEBGPU_NOOP_CHECK();
+  if (Graphics_isWebGPU()) {
+    sWebGPUState.depthTest = testDepth;
+    pushWebGPUDrawState();
+    return;
+  }
   testDepth ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
 }
 
 void depthMask(bool maskDepth) {
-  WEBGPU_NOOP_CHECK();
+  if (Graphics_isWebGPU()) {
+    sWebGPUState.depthWrite = maskDepth;
+    pushWebGPUDrawState();
+    return;
+  }
   glDepthMask(maskDepth ? GL_TRUE : GL_FALSE);
 }
 
@@ -190,12 +249,20 @@ void scissorArea(int left, int bottom, int width, int height) {
 }
 
 void culling(bool doCulling) {
-  WEBGPU_NOOP_CHECK();
+  if (Graphics_isWebGPU()) {
+    sWebGPUState.cullEnabled = doCulling;
+    pushWebGPUDrawState();
+    return;
+  }
   doCulling ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
 }
 
 void cullFace(unsigned int face) {
-  WEBGPU_NOOP_CHECK();
+  if (Graphics_isWebGPU()) {
+    sWebGPUState.cullFace = (face == GL_FRONT) ? CullFace::Front : CullFace::Back;
+    pushWebGPUDrawState();
+    return;
+  }
   glCullFace(face);
 }
 
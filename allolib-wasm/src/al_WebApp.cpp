@@ -1,10 +1,16 @@
 #include "al_WebApp.hpp"
-// M5.6: full ParameterServer definition for the lazy-init member +
-// parameterServer() accessor. Header-side has only a forward decl.
+// M5.6: full ParameterServer definition for the lazy-init member's
+// destructor. Header-side has only a forward decl; parameterServer() is
+// in al_web_parameter_server.cpp so sketches without it don't link OSC.
 // Phase 4: WebParameterServer subclass that feeds ParameterRegistry.
 #include "al/ui/al_ParameterServer.hpp"
 #include "al_web_parameter_server.hpp"
 #include "al_WebControlGUI.hpp"
+#include "al_WebAudioSIMD.hpp"
+#include "al_WebFile.hpp"
+#include "al_WebJobs.hpp"
+#include "al_WebWavWriter.hpp"
+#include "al_WebRenderTargetPool.hpp"
 
 // Conditionally include backends based on build configuration
 #if defined(ALLOLIB_WEBGL2)
@@ -19,6 +25,9 @@
 #include <emscripten.h>
 #include <emscripten/html5.h>
 #include <EGL/egl.h>
+#ifdef AL_WEB_AUDIO_WORKLET
+#include <emscripten/webaudio.h>
+#endif
 
 // Phase 5 (v0.7.6): IDBFS /presets mount + sync moved to Module.preRun in
 // runtime.ts, gated on Emscripten's run-dependency counter so main() can't
@@ -37,6 +46,10 @@
 // Forward declare GLAD loader
 extern "C" int gladLoadGLLoader(void* (*load)(const char*));
 
+// GPU frame timing, defined in al_Graphics_Web.cpp
+extern "C" int al_gpu_profiler_set_enabled(int enabled);
+
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <iostream>
@@ -50,8 +63,9 @@ extern "C" int gladLoadGLLoader(void* (*load)(const char*));
 // Gamma DSP library for oscillators etc.
 #include "Gamma/Domain.h"
 
-// EM_JS function to register AutoLOD JavaScript bridge
-// Using EM_JS instead of EM_ASM because EM_ASM has issues with JS object literals
+// EM_JS functions to register the JavaScript bridges (auto-LOD's is in
+// al_WebAutoLOD.cpp). Using EM_JS instead of EM_ASM because EM_ASM has
+// issues with JS object literals
 #ifdef __EMSCRIPTEN__
 EM_JS(void, registerPointSizeJSBridge, (), {
     window.allolib = window.allolib || {};
@@ -62,101 +76,147 @@ EM_JS(void, registerPointSizeJSBridge, (), {
     window.allolib.graphics.getPointSize = function() {
         return Module.ccall('al_web_get_point_size', 'number', [], []);
     };
-    console.log('[AlloLib] Graphics JS bridge registered');
-});
-
-EM_JS(void, registerAutoLODJSBridge, (), {
-    window.allolib = window.allolib || {};
-    window.allolib.autoLOD = {
-        setBias: function(bias) {
-            Module.ccall('al_autolod_set_bias', null, ['number'], [bias]);
-        },
+    // GPU frame timing (WebGPU timestamp-query or WebGL2 timer queries);
+    // WebGPU publishes per-pass timings to Module.gpuPassTimings
+    window.allolib.graphics.gpuProfiler = {
         setEnabled: function(enabled) {
-            Module.ccall('al_autolod_set_enabled', null, ['number'], [enabled ? 1 : 0]);
-        },
-        setBudget: function(budget) {
-            Module.ccall('al_autolod_set_budget', null, ['number'], [budget]);
-        },
-        setMode: function(mode) {
-            Module.ccall('al_autolod_set_mode', null, ['number'], [mode]);
+            return Module.ccall('al_gpu_profiler_set_enabled', 'number', ['number'], [enabled ? 1 : 0]) === 1;
         },
-        setMinFullQualityDistance: function(distance) {
-            Module.ccall('al_autolod_set_min_full_quality_distance', null, ['number'], [distance]);
+        isEnabled: function() {
+            return Module.ccall('al_gpu_profiler_get_enabled', 'number', [], []) === 1;
         },
-        setDistances: function(d0, d1, d2, d3) {
-            Module.ccall('al_autolod_set_distances', null, ['number', 'number', 'number', 'number'], [d0, d1, d2, d3]);
+        isSupported: function() {
+            return Module.ccall('al_gpu_profiler_is_supported', 'number', [], []) === 1;
         },
-        getTriangles: function() {
-            return Module.ccall('al_autolod_get_triangles', 'number', [], []);
+        getFrameMs: function() {
+            return Module.ccall('al_gpu_profiler_get_frame_ms', 'number', [], []);
         },
-        getBias: function() {
-            return Module.ccall('al_autolod_get_bias', 'number', [], []);
-        },
-        // New functions for enhanced LOD control
-        setDistanceScale: function(scale) {
-            Module.ccall('al_autolod_set_distance_scale', null, ['number'], [scale]);
-        },
-        getDistanceScale: function() {
-            return Module.ccall('al_autolod_get_distance_scale', 'number', [], []);
+        getPassTimings: function() {
+            return Module.gpuPassTimings || {};
+        }
+    };
+    window.allolib.graphics.meshCache = {
+        getStats: function() {
+            return {
+                entries: Module.ccall('al_mesh_cache_get_entries', 'number', [], []),
+                bytes: Module.ccall('al_mesh_cache_get_bytes', 'number', [], []),
+                budget: Module.ccall('al_mesh_cache_get_budget', 'number', [], []),
+                evictions: Module.ccall('al_mesh_cache_get_evictions', 'number', [], [])
+            };
         },
-        setLevels: function(levels) {
-            Module.ccall('al_autolod_set_levels', null, ['number'], [levels]);
+        setBudgetMB: function(mb) {
+            Module.ccall('al_mesh_cache_set_budget', null, ['number'], [mb * 1024 * 1024]);
         },
-        getLevels: function() {
-            return Module.ccall('al_autolod_get_levels', 'number', [], []);
+        setEvictionAge: function(frames) {
+            Module.ccall('al_mesh_cache_set_eviction_age', null, ['number'], [frames]);
+        }
+    };
+    console.log('[AlloLib] Graphics JS bridge registered');
+});
+
+// Audio timing (AudioMonitorTelemetry in al_WebAudioMonitor.hpp). Fetch the
+// pointer once, then readTelemetry(ptr) alongside the worklet stats.
+EM_JS(void, registerAudioMonitorJSBridge, (), {
+    window.allolib = window.allolib || {};
+    window.allolib.audioMonitor = {
+        getTelemetryPointer: function() {
+            return Module.ccall('al_audio_monitor_get_telemetry', 'number', [], []);
         },
-        setUnloadDistance: function(distance) {
-            Module.ccall('al_autolod_set_unload_distance', null, ['number'], [distance]);
+        readTelemetry: function(ptr) {
+            ptr = ptr || Module.ccall('al_audio_monitor_get_telemetry', 'number', [], []);
+            if (!ptr) return null;
+            var u = HEAPU32, f = HEAPF32, i = ptr >> 2;
+            if (u[i] !== 1) return null;  // Layout version
+            var bins = 12, maxSections = 8;
+            var t = {
+                version: u[i], blocks: u[i + 1], overruns: u[i + 2], framesPerBlock: u[i + 3],
+                deadlineMs: f[i + 4], lastMs: f[i + 5], meanMs: f[i + 6], peakMs: f[i + 7]
+            };
+            var o = i + 8;
+            t.histogram = Array.from(u.subarray(o, o + bins)); o += bins;
+            var count = u[o++];
+            t.sections = [];
+            for (var s = 0; s < count; s++) {
+                t.sections.push({
+                    name: UTF8ToString(Module.ccall('al_audio_monitor_get_section_name', 'number', ['number'], [s])),
+                    meanMs: f[o + s],
+                    peakMs: f[o + maxSections + s]
+                });
+            }
+            t.load = t.deadlineMs > 0 ? t.meanMs / t.deadlineMs : 0;
+            return t;
         },
-        setUnloadEnabled: function(enabled) {
-            Module.ccall('al_autolod_set_unload_enabled', null, ['number'], [enabled ? 1 : 0]);
+        reset: function() {
+            Module.ccall('al_audio_monitor_reset', null, [], []);
         }
     };
+});
 
-    // Texture LOD bridge
-    window.allolib.textureLOD = {
+// Frame profiler (al_WebProfiler.hpp). Enabling it also turns on the GPU
+// pass profiler, whose frame time is recorded as the "GPU ms" counter.
+EM_JS(void, registerProfilerJSBridge, (), {
+    window.allolib = window.allolib || {};
+    window.allolib.profiler = {
         setEnabled: function(enabled) {
-            Module.ccall('al_texture_lod_set_enabled', null, ['number'], [enabled ? 1 : 0]);
-        },
-        getEnabled: function() {
-            return Module.ccall('al_texture_lod_get_enabled', 'number', [], []) !== 0;
-        },
-        setBias: function(bias) {
-            Module.ccall('al_texture_lod_set_bias', null, ['number'], [bias]);
-        },
-        getBias: function() {
-            return Module.ccall('al_texture_lod_get_bias', 'number', [], []);
-        },
-        setMaxResolution: function(resolution) {
-            Module.ccall('al_texture_lod_set_max_resolution', null, ['number'], [resolution]);
-        },
-        getMaxResolution: function() {
-            return Module.ccall('al_texture_lod_get_max_resolution', 'number', [], []);
+            Module.ccall('al_profiler_set_enabled', null, ['number'], [enabled ? 1 : 0]);
         },
-        getResolutionForDistance: function(distance) {
-            return Module.ccall('al_texture_lod_get_resolution', 'number', ['number'], [distance]);
+        isEnabled: function() {
+            return Module.ccall('al_profiler_get_enabled', 'number', [], []) !== 0;
         },
-        getLevelForDistance: function(distance, numLevels) {
-            return Module.ccall('al_texture_lod_get_level', 'number', ['number', 'number'], [distance, numLevels || -1]);
+        setOverlay: function(show) {
+            Module.ccall('al_profiler_set_overlay', null, ['number'], [show ? 1 : 0]);
         },
-        // Continuous LOD methods (Unreal-style mipmap support)
-        setReferenceDistance: function(distance) {
-            Module.ccall('al_texture_lod_set_reference_distance', null, ['number'], [distance]);
+        clear: function() {
+            Module.ccall('al_profiler_clear', null, [], []);
         },
-        getReferenceDistance: function() {
-            return Module.ccall('al_texture_lod_get_reference_distance', 'number', [], []);
-        },
-        getContinuousLOD: function(distance, maxMipLevel) {
-            return Module.ccall('al_texture_lod_get_continuous', 'number', ['number', 'number'], [distance, maxMipLevel || 12]);
+        exportTrace: function() {
+            return Module.ccall('al_profiler_export_trace', 'number', [], []);
         }
     };
+});
 
-    console.log('[AlloLib] Auto-LOD and Texture LOD JS bridges registered');
+// Rendering stats for the perf regression suite (tests/e2e/perf-regression.spec.ts):
+// frame-time window (al_WebFrameStats.hpp), last frame's draws, heap sizes.
+// jsHeapBytes is null outside Chromium.
+EM_JS(void, registerPerfJSBridge, (), {
+    window.allolib = window.allolib || {};
+    window.allolib.perf = {
+        getStats: function() {
+            var ptr = Module.ccall('al_perf_get_frame_stats', 'number', [], []);
+            if (!ptr) return null;
+            var u = HEAPU32, f = HEAPF32, i = ptr >> 2;
+            var meanMs = f[i + 1];
+            var mem = performance.memory;
+            return {
+                frames: u[i], totalFrames: u[i + 6],
+                fps: meanMs > 0 ? 1000 / meanMs : 0,
+                meanMs: meanMs, p50Ms: f[i + 2], p95Ms: f[i + 3], p99Ms: f[i + 4], maxMs: f[i + 5],
+                cpuMs: f[i + 7], gpuMs: f[i + 8], renderScale: f[i + 9],
+                drawCalls: Module.ccall('al_draw_stats_get_draws', 'number', [], []),
+                vertices: Module.ccall('al_draw_stats_get_vertices', 'number', [], []),
+                meshCacheBytes: Module.ccall('al_mesh_cache_get_bytes', 'number', [], []),
+                wasmHeapBytes: HEAP8.length,
+                jsHeapBytes: mem ? mem.usedJSHeapSize : null
+            };
+        },
+        reset: function() {
+            Module.ccall('al_perf_reset', null, [], []);
+        }
+    };
 });
 #endif
 
 namespace al {
 
+// Set in WebApp::start() for the al_audio_monitor_* exports
+static AudioMonitor* gAudioMonitorInstance = nullptr;
+// Likewise for the al_perf_* exports
+static FrameStats* gFrameStatsInstance = nullptr;
+
+// Defined in al_WebAutoLOD.cpp, which is only linked when the sketch uses
+// auto-LOD; the weak reference leaves this null otherwise
+void attachAutoLOD(AutoLODManager* lod) __attribute__((weak));
+
 // Forward declarations for Emscripten event callbacks
 #ifdef __EMSCRIPTEN__
 static EM_BOOL keyCallback(int eventType, const EmscriptenKeyboardEvent* e, void* userData);
@@ -194,6 +254,8 @@ WebApp::~WebApp() {
     // closes the loop. Bumps version + fires onChange(nullptr) so any
     // subscribers (Vue panel polling fallback) see the reset.
     ParameterRegistry::global().clear();
+    if (gAudioMonitorInstance == &mAudioMonitor) gAudioMonitorInstance = nullptr;
+    if (gFrameStatsInstance == &mFrameStats) gFrameStatsInstance = nullptr;
 }
 
 void WebApp::configureWebAudio(const WebAudioConfig& config) {
@@ -207,6 +269,23 @@ void WebApp::configureWebAudio(int sampleRate, int bufferSize, int outputChannel
     mAudioConfig.inputChannels = inputChannels;
 }
 
+void WebApp::setAdaptiveLatency(bool enabled, int minFrames, int maxFrames) {
+    mAudioConfig.adaptiveLatency = enabled;
+    mAudioConfig.minLatencyFrames = minFrames;
+    mAudioConfig.maxLatencyFrames = maxFrames;
+    if (mAudioInitialized) publishLatencyConfig();
+}
+
+void WebApp::publishLatencyConfig() {
+#ifdef __EMSCRIPTEN__
+    // runtime.ts reads this at every latency window, so changes apply live
+    EM_ASM({
+        Module.alloAudioLatency = { adaptive: !!$0, minFrames: $1, maxFrames: $2 };
+    }, mAudioConfig.adaptiveLatency ? 1 : 0, mAudioConfig.minLatencyFrames,
+       mAudioConfig.maxLatencyFrames);
+#endif
+}
+
 void WebApp::dimensions(int width, int height) {
     mWidth = width;
     mHeight = height;
@@ -240,12 +319,26 @@ void WebApp::start() {
     // showed missing register-printf lines traces back to here.
     onInit();
 
-    // Register global AutoLOD for JS bridge
-    setGlobalAutoLOD(&mAutoLOD);
+    // Register global AutoLOD and its JS bridge, if the sketch linked them
+    if (attachAutoLOD) {
+        attachAutoLOD(&mAutoLOD);
+    } else {
+        // window.allolib outlives the module: drop a previous run's bridge
+        EM_ASM({
+            if (window.allolib) {
+                delete window.allolib.autoLOD;
+                delete window.allolib.textureLOD;
+            }
+        });
+    }
 
     // Register JS bridges
     registerPointSizeJSBridge();
-    registerAutoLODJSBridge();
+    gAudioMonitorInstance = &mAudioMonitor;
+    registerAudioMonitorJSBridge();
+    registerProfilerJSBridge();
+    gFrameStatsInstance = &mFrameStats;
+    registerPerfJSBridge();
 
     // Initialize graphics
 #ifdef __EMSCRIPTEN__
@@ -354,25 +447,114 @@ void WebApp::stop() {
     std::cout << "[AlloLib] Application stopped" << std::endl;
 }
 
-void WebApp::tick(double dt) {
+void WebApp::animateFrame(double dt) {
+    // Panel slider writes since the last frame, one set() per parameter
+    WebControlGUI::flushQueuedValues();
+
+    // Completions of finished background jobs (decoded assets, LODs), so
+    // onAnimate sees them this frame
+    JobSystem::instance().pump();
+
     // Call user's onAnimate. Preset morph auto-tick is wired
     // header-only via al_playground_compat.hpp's gPlaygroundAnimateHook
     // inline variable; user code that includes that header brings its
     // own definition, so libal_web.a stays unchanged on header revs.
-    onAnimate(dt);
+    {
+        AL_PROFILE_ZONE("onAnimate");
+        onAnimate(dt);
+    }
+
+    // Hand this frame's parameter values to onSound in one piece
+    mAudioParams.publish();
+
+    // And the ones onAnimate changed to the panel, in one call
+    WebControlGUI::syncParameterTable();
+}
+
+void WebApp::tick(double dt) {
+    {
+        AL_PROFILE_ZONE("frame");
+        renderFrame(dt);
+    }
+    // Last completed frame's GPU time, when the backend measures it
+    if (FrameProfiler::enabled() && mBackend) {
+        double gpuMs = mBackend->getGPUFrameTimeMs();
+        if (gpuMs > 0.0) FrameProfiler::instance().counter("GPU ms", gpuMs);
+    }
+    FrameProfiler::instance().endFrame();
+}
+
+bool WebApp::setGPUTiming(bool enabled) {
+    return mBackend && mBackend->setGPUProfilingEnabled(enabled);
+}
+
+void WebApp::setRenderScale(float scale) {
+    mRenderScale = std::min(1.0f, std::max(0.25f, scale));
+}
+
+bool WebApp::beginScaledFrame() {
+    if (mRenderScale >= 1.0f || !mGraphics) return false;
+    int w = 0, h = 0;
+#ifdef __EMSCRIPTEN__
+    emscripten_get_canvas_element_size("#canvas", &w, &h);
+#endif
+    if (w <= 0 || h <= 0) return false;
+
+    // Canvas-sized, so only a canvas resize reallocates it
+    if (!mScaledTarget || mScaledTarget->width() != w || mScaledTarget->height() != h) {
+        EasyFBOSetting setting;
+        setting.filterMin = GL_LINEAR;
+        setting.filterMag = GL_LINEAR;
+        mScaledTarget = std::make_unique<EasyFBO>();
+        mScaledTarget->init(w, h, setting);
+    }
+
+    int sw = std::max(1, int(std::lround(w * mRenderScale)));
+    int sh = std::max(1, int(std::lround(h * mRenderScale)));
+    mScaledU = float(sw) / float(w);
+    mScaledV = float(sh) / float(h);
+    mGraphics->pushFramebuffer(*mScaledTarget);
+    mGraphics->viewport(0, 0, sw, sh);
+    return true;
+}
+
+void WebApp::endScaledFrame() {
+    AL_PROFILE_ZONE("upscale");
+    mGraphics->popFramebuffer();
+    mGraphics->viewport(0, 0, mScaledTarget->width(), mScaledTarget->height());
+    mGraphics->clear(0.0f, 0.0f, 0.0f);
+
+    // A quad whose texture coordinates reach (u, v) at the canvas edge;
+    // the part past the edge is clipped
+    const Graphics::ColoringMode mode = mGraphics->coloringMode();
+    mGraphics->quadViewport(mScaledTarget->tex(), -1.0f, -1.0f, 2.0f / mScaledU, 2.0f / mScaledV);
+    switch (mode) {
+        case Graphics::ColoringMode::UNIFORM: mGraphics->color(); break;
+        case Graphics::ColoringMode::MESH: mGraphics->meshColor(); break;
+        case Graphics::ColoringMode::MATERIAL: mGraphics->material(); break;
+        case Graphics::ColoringMode::CUSTOM: mGraphics->shader(mGraphics->shader()); break;
+        default: break;
+    }
+}
+
+void WebApp::renderFrame(double dt) {
+    animateFrame(dt);
 
     // Update navigation direction vectors (needed for uf(), ur(), uu())
     mNav.updateDirectionVectors();
 
-    // Update auto-LOD with view parameters
-    mAutoLOD.setCameraPos(mNav.pos());
-    mAutoLOD.setScreenSize(mWidth, mHeight);
-    mAutoLOD.setFOV(mViewpoint.lens().fovy());
-    mAutoLOD.setFrameTime(dt);
-    mAutoLOD.resetFrameStats();
-
-    // Adaptive quality adjustment based on frame time
-    mAutoLOD.adaptQuality();
+    {
+        AL_PROFILE_ZONE("autoLOD");
+        // Update auto-LOD with view parameters
+        mAutoLOD.setCameraPos(mNav.pos());
+        mAutoLOD.setScreenSize(mWidth, mHeight);
+        mAutoLOD.setFOV(mViewpoint.lens().fovy());
+        mAutoLOD.setFrameTime(dt);
+        mAutoLOD.resetFrameStats();
+
+        // Adaptive quality adjustment based on frame time
+        mAutoLOD.adaptQuality();
+    }
 
     // Check if using WebGPU backend
     bool usingWebGPU = mBackend && mBackend->isWebGPU();
@@ -385,7 +567,13 @@ void WebApp::tick(double dt) {
             EM_ASM({ console.log('[WebGPU tick] Frame ' + $0 + ' - calling beginFrame'); }, frameCount);
         }
 #endif
-        mBackend->beginFrame();
+        {
+            AL_PROFILE_ZONE("beginFrame");
+            mBackend->beginFrame();
+            extern void Graphics_beginFrame();
+            Graphics_beginFrame();
+            mGraphicsExtension.meshAdapter().beginFrame();
+        }
 
         // WebGPU mode: Use Graphics methods that now route through backend
         if (mGraphics) {
@@ -394,9 +582,11 @@ void WebApp::tick(double dt) {
                 EM_ASM({ console.log('[WebGPU tick] Calling Graphics methods (now routed to backend)'); });
             }
 #endif
-            // Update viewport to match current canvas size
+            // Update viewport to match current canvas size (or the scaled
+            // part of the offscreen target)
             // This ensures correct aspect ratio for projection matrix
-            mGraphics->viewport(0, 0, mBackend->getWidth(), mBackend->getHeight());
+            bool scaled = beginScaledFrame();
+            if (!scaled) mGraphics->viewport(0, 0, mBackend->getWidth(), mBackend->getHeight());
 
             // Set up view matrix from navigation pose (same as WebGL2 path)
             mGraphics->camera(mNav);
@@ -405,10 +595,18 @@ void WebApp::tick(double dt) {
             mGraphics->clear(0.1f, 0.1f, 0.1f);
 
             // Call user's onDraw - g.draw() calls now route through backend
-            onDraw(*mGraphics);
+            {
+                AL_PROFILE_ZONE("onDraw");
+                onDraw(*mGraphics);
+            }
+            if (scaled) endScaledFrame();
         }
 
-        mBackend->endFrame();
+        {
+            AL_PROFILE_ZONE("endFrame");
+            mBackend->endFrame();
+            RenderTargetPool::instance().endFrame();
+        }
 
 #ifdef __EMSCRIPTEN__
         if (frameCount < 3) {
@@ -419,8 +617,18 @@ void WebApp::tick(double dt) {
         return;
     }
 
-    // WebGL2 mode: standard rendering path
+    // WebGL2 mode: standard rendering path. The backend brackets the frame
+    // for its GPU timer; Graphics rolls its per-frame stats over.
+    {
+        AL_PROFILE_ZONE("beginFrame");
+        if (mBackend) mBackend->beginFrame();
+        extern void Graphics_beginFrame();
+        Graphics_beginFrame();
+    }
+
     if (mGraphics) {
+        bool scaled = beginScaledFrame();
+
         // Set up view matrix from navigation pose
         mGraphics->camera(mNav);
 
@@ -428,8 +636,15 @@ void WebApp::tick(double dt) {
         mGraphics->clear(0.1f, 0.1f, 0.1f);
 
         // Call user's onDraw
-        onDraw(*mGraphics);
+        {
+            AL_PROFILE_ZONE("onDraw");
+            onDraw(*mGraphics);
+        }
+        if (scaled) endScaledFrame();
     }
+    AL_PROFILE_ZONE("endFrame");
+    if (mBackend) mBackend->endFrame();
+    RenderTargetPool::instance().endFrame();
 }
 
 void WebApp::mainLoopCallback(void* arg) {
@@ -439,14 +654,23 @@ void WebApp::mainLoopCallback(void* arg) {
 
 #ifdef __EMSCRIPTEN__
     // Calculate delta time
-    double now = emscripten_get_now() / 1000.0;
+    const double startMs = emscripten_get_now();
+    double now = startMs / 1000.0;
     double dt = now - app->mLastTime;
     app->mLastTime = now;
 
+    FrameTimings timings;
+    timings.intervalMs = float(dt * 1000.0);
+
     // Cap delta time to prevent huge jumps
     if (dt > 0.1) dt = 0.1;
 
     app->tick(dt);
+
+    timings.cpuMs = float(emscripten_get_now() - startMs);
+    timings.renderScale = app->mRenderScale;
+    timings.gpuMs = app->mBackend ? float(app->mBackend->getGPUFrameTimeMs()) : 0.0f;
+    app->mFrameStats.record(timings);
 #endif
 }
 
@@ -714,27 +938,12 @@ void WebApp::initGraphics() {
 #endif
 }
 
-WebParameterServer& WebApp::parameterServer() {
-    if (!mParameterServer) {
-        // Default OSC port 9010 — same as upstream al::App default. Web
-        // transport routes through ws://127.0.0.1:9010/osc via our
-        // WebSocket-backed osc::Recv (M5.1). autoStart=true so it
-        // begins listening immediately.
-        // WebParameterServer inherits ParameterServer's ctor; the (ip,
-        // port, autoStart) signature works unchanged.
-        mParameterServer.reset(new WebParameterServer("", 9010, true));
-    }
-    return *mParameterServer;
-}
-
-const WebParameterServer& WebApp::parameterServer() const {
-    return const_cast<WebApp*>(this)->parameterServer();
-}
-
 void WebApp::audioCBThunk(AudioIOData& io) {
     // Bridge AudioIO::callback → WebApp::onSound. The user pointer is set
     // in initAudio() to `this`, so we recover the WebApp and dispatch.
     if (auto* self = static_cast<WebApp*>(io.user())) {
+        AudioMonitor::Scope t(self->mAudioMonitor, AudioMonitor::kOnSound);
+        AL_PROFILE_ZONE("onSound");
         self->onSound(io);
     }
 }
@@ -756,6 +965,14 @@ void WebApp::initAudio() {
     mAudioIOReal.callback = &WebApp::audioCBThunk;
     mAudioIOReal.user(this);
 
+#ifdef AL_WEB_AUDIO_WORKLET
+    // The audio thread renders one render quantum per process() call
+    mAudioIOReal.framesPerBuffer(128);
+    startAudioWorklet();
+#endif
+
+    mAudioMonitor.setDeadline(mAudioIOReal.framesPerBuffer(), mAudioIOReal.framesPerSecond());
+    publishLatencyConfig();
     mAudioInitialized = true;
 
     std::cout << "[AlloLib] Audio initialized with sample rate: " << mAudioConfig.sampleRate << std::endl;
@@ -873,6 +1090,9 @@ void WebApp::initBackend() {
 }
 
 void WebApp::cleanupBackend() {
+    // Backend resources go with the backend
+    mScaledTarget.reset();
+
     // Clear graphics extension
     mGraphicsExtension.setBackend(nullptr);
     setGlobalGraphicsExtension(nullptr);
@@ -883,59 +1103,49 @@ void WebApp::cleanupBackend() {
     }
 }
 
+// Planar pointer table size for the interleave kernel
+static constexpr int kMaxAudioChannels = 32;
+
+#ifdef AL_WEB_AUDIO_DEBUG
 static int audioCallCount = 0;
+#endif
 
 void WebApp::processAudioBuffer(float* outputBuffer, int numFrames, int numChannels) {
-#ifdef __EMSCRIPTEN__
-    // Debug: log state on first few calls
+    // Per-block hot path: logging only in AL_WEB_AUDIO_DEBUG builds
+#if defined(__EMSCRIPTEN__) && defined(AL_WEB_AUDIO_DEBUG)
     if (audioCallCount < 5) {
         EM_ASM({
-            console.log('[WASM Audio] processAudioBuffer: mRunning=' + $0 + ', mAudioInit=' + $1);
-        }, mRunning ? 1 : 0, mAudioInitialized ? 1 : 0);
+            console.log('[WASM Audio] processAudioBuffer: mRunning=' + $0 + ', mAudioInit=' + $1 +
+                        ', frames=' + $2 + ', channels=' + $3);
+        }, mRunning ? 1 : 0, mAudioInitialized ? 1 : 0, numFrames, numChannels);
     }
 #endif
 
-    if (!mRunning || !mAudioInitialized) {
-        // Fill with silence
-        for (int i = 0; i < numFrames * numChannels; ++i) {
-            outputBuffer[i] = 0.0f;
-        }
-#ifdef __EMSCRIPTEN__
-        if (audioCallCount < 5) {
-            EM_ASM({ console.log('[WASM Audio] Early return - state check failed'); });
-        }
-#endif
-        audioCallCount++;
+    if (!renderAudioBlock()) {
+        audio_simd::zero(outputBuffer, numFrames * numChannels);
         return;
     }
 
-#ifdef __EMSCRIPTEN__
-    // Debug: log first few calls
-    if (audioCallCount < 5) {
-        EM_ASM({
-            console.log('[WASM Audio] Processing audio: frames=' + $0 + ', channels=' + $1);
-        }, numFrames, numChannels);
-    }
-#endif
-    audioCallCount++;
-
-    // Zero output, then run the unified callback chain:
-    //   1. AudioIO::callback (audioCBThunk → onSound)
-    //   2. each user-appended AudioCallback (post-FX)
-    // processAudio() resets the frame counter before each step.
-    mAudioIOReal.zeroOut();
-    mAudioIOReal.processAudio();
-
-    // Copy from non-interleaved format to interleaved output
-    for (int frame = 0; frame < numFrames; ++frame) {
-        for (int ch = 0; ch < numChannels; ++ch) {
-            outputBuffer[frame * numChannels + ch] = mAudioIOReal.out(ch, frame);
+    // Planar AudioIO → interleaved output
+    const int available = (int)mAudioIOReal.channelsOut();
+    if (numChannels <= available && numChannels <= kMaxAudioChannels &&
+        numFrames <= (int)mAudioIOReal.framesPerBuffer()) {
+        const float* planar[kMaxAudioChannels];
+        for (int ch = 0; ch < numChannels; ++ch) planar[ch] = mAudioIOReal.outBuffer(ch);
+        audio_simd::interleave(outputBuffer, planar, numChannels, numFrames);
+    } else {
+        // Layout mismatch: copy what exists, silence the rest
+        const int frames = std::min(numFrames, (int)mAudioIOReal.framesPerBuffer());
+        audio_simd::zero(outputBuffer, numFrames * numChannels);
+        for (int frame = 0; frame < frames; ++frame) {
+            for (int ch = 0; ch < std::min(numChannels, available); ++ch) {
+                outputBuffer[frame * numChannels + ch] = mAudioIOReal.out(ch, frame);
+            }
         }
     }
 
-#ifdef __EMSCRIPTEN__
-    // Debug: check if we have non-zero output
-    if (audioCallCount <= 5) {
+#if defined(__EMSCRIPTEN__) && defined(AL_WEB_AUDIO_DEBUG)
+    if (audioCallCount < 5) {
         float maxSample = 0;
         for (int i = 0; i < numFrames * numChannels; ++i) {
             float absVal = outputBuffer[i] > 0 ? outputBuffer[i] : -outputBuffer[i];
@@ -945,193 +1155,259 @@ void WebApp::processAudioBuffer(float* outputBuffer, int numFrames, int numChann
             console.log('[WASM Audio] Max output sample: ' + $0);
         }, maxSample);
     }
+    audioCallCount++;
 #endif
 }
 
-void WebApp::setListenerPose(const Pose& pose) {
-#ifdef __EMSCRIPTEN__
-    // Update spatial audio listener position
-    EM_ASM({
-        if (window.alloWorkletNode) {
-            window.alloWorkletNode.port.postMessage({
-                type: 'setListener',
-                pos: { x: $0, y: $1, z: $2 },
-                quat: { w: $3, x: $4, y: $5, z: $6 }
-            });
-        }
-    }, pose.pos().x, pose.pos().y, pose.pos().z,
-       pose.quat().w, pose.quat().x, pose.quat().y, pose.quat().z);
-#else
-    (void)pose;
-#endif
-}
-
-} // namespace al
+bool WebApp::renderAudioBlock() {
+    if (!mRunning || !mAudioInitialized) return false;
 
-// =========================================================================
-// JavaScript bridge function definitions for AutoLOD
-// These must be in .cpp file (not header) to avoid duplicate symbols
-// =========================================================================
-extern "C" {
-
-EMSCRIPTEN_KEEPALIVE
-void al_autolod_set_bias(float bias) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setBias(bias);
+    // Announce the block before checking for an offline render, which sets
+    // its flag before checking ours: one of the two always backs off
+    mAudioInBlock.store(true);
+    if (mOfflineRendering.load()) {
+        mAudioInBlock.store(false);
+        return false;
     }
-}
-
-EMSCRIPTEN_KEEPALIVE
-void al_autolod_set_enabled(int enabled) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->enable(enabled != 0);
+    mAudioMonitor.beginBlock();
+    {
+        FrameProfiler::TrackScope track(FrameProfiler::kAudio);
+        AL_PROFILE_ZONE("audio block");
+        processAudioBlock();
     }
+    mAudioMonitor.endBlock();
+    mAudioInBlock.store(false);
+    return true;
 }
 
-EMSCRIPTEN_KEEPALIVE
-void al_autolod_set_budget(int budget) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setTriangleBudget(budget);
-    }
+void WebApp::processAudioBlock() {
+    // Zero output, then run the unified callback chain:
+    //   1. AudioIO::callback (audioCBThunk → onSound)
+    //   2. each user-appended AudioCallback (post-FX)
+    // processAudio() resets the frame counter before each step.
+    mAudioParams.beginBlock(int(mAudioIOReal.framesPerBuffer()));
+    mAudioIOReal.zeroOut();
+    mAudioIOReal.processAudio();
 }
 
-EMSCRIPTEN_KEEPALIVE
-void al_autolod_set_mode(int mode) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setSelectionMode(static_cast<al::LODSelectionMode>(mode));
+bool WebApp::renderOffline(const OfflineRenderOptions& options) {
+    if (!mAudioInitialized) {
+        std::cout << "[AlloLib] renderOffline() needs audio; call it after start()" << std::endl;
+        return false;
+    }
+    const int rate = (int)mAudioIOReal.framesPerSecond();
+    const int channels = std::min((int)mAudioIOReal.channelsOut(), kMaxAudioChannels);
+    WavFileWriter wav;
+    if (!wav.open(options.path, rate, channels,
+                  options.float32 ? WavFileWriter::Format::Float32
+                                  : WavFileWriter::Format::Int16)) {
+        std::cout << "[AlloLib] renderOffline: cannot write " << options.path << std::endl;
+        return false;
     }
-}
 
-EMSCRIPTEN_KEEPALIVE
-int al_autolod_get_triangles() {
-    return al::gAutoLODInstance ? al::gAutoLODInstance->frameTriangles() : 0;
-}
+    // Take the AudioIO from the live output; on the worklet thread a block
+    // may be mid-flight, and it finishes within one quantum
+    mOfflineRendering.store(true);
+    while (mAudioInBlock.load()) {
+    }
 
-EMSCRIPTEN_KEEPALIVE
-float al_autolod_get_bias() {
-    return al::gAutoLODInstance ? al::gAutoLODInstance->bias() : 1.0f;
-}
+    const int block = (int)mAudioIOReal.framesPerBuffer();
+    const int64_t total = (int64_t)std::llround(std::max(0.0, options.seconds) * rate);
+    const double dt = 1.0 / (options.frameRate > 0 ? options.frameRate : 60.0);
+    const bool animate = options.animate || options.draw;
+    double nextFrame = 0.0;
+    const float* planar[kMaxAudioChannels];
 
-EMSCRIPTEN_KEEPALIVE
-void al_autolod_set_min_full_quality_distance(float distance) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setMinFullQualityDistance(distance);
+#ifdef __EMSCRIPTEN__
+    const double started = emscripten_get_now();
+#endif
+    for (int64_t done = 0; done < total; done += block) {
+        // Frames due before this block's first sample, at the fixed rate
+        const double blockTime = double(done) / rate;
+        while (animate && nextFrame <= blockTime) {
+            if (options.draw) tick(dt);
+            else animateFrame(dt);
+            nextFrame += dt;
+        }
+        for (int c = 0; c < (int)mAudioIOReal.channelsIn(); ++c) {
+            audio_simd::zero(mAudioIOReal.inBuffer(c), block);
+        }
+        processAudioBlock();
+        for (int c = 0; c < channels; ++c) planar[c] = mAudioIOReal.outBuffer(c);
+        wav.write(planar, (int)std::min<int64_t>(block, total - done));
     }
-}
+    const bool ok = wav.close();
+    mOfflineRendering.store(false);
 
-EMSCRIPTEN_KEEPALIVE
-void al_autolod_set_distances(float d0, float d1, float d2, float d3) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setDistances({d0, d1, d2, d3});
+#ifdef __EMSCRIPTEN__
+    const double ms = emscripten_get_now() - started;
+    std::cout << "[AlloLib] Rendered " << options.seconds << " s to " << options.path
+              << " in " << int(ms) << " ms (" << int(ms > 0 ? options.seconds * 1000.0 / ms : 0)
+              << "x realtime)" << std::endl;
+    if (ok && options.download) {
+        WebFile::downloadFile(options.path, "", "audio/wav");
+    } else if (ok) {
+        // Persist when the path is under an IDBFS mount
+        EM_ASM({
+            if (typeof FS !== 'undefined' && FS.syncfs) FS.syncfs(false, function(err) {});
+        });
     }
+#endif
+    if (!ok) std::cout << "[AlloLib] renderOffline: writing " << options.path << " failed" << std::endl;
+    return ok;
 }
 
-EMSCRIPTEN_KEEPALIVE
-void al_autolod_set_distance_scale(float scale) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setDistanceScale(scale);
-    }
-}
+#ifdef AL_WEB_AUDIO_WORKLET
+
+// Stack for the audio rendering thread; onSound runs on it
+alignas(16) static uint8_t gAudioThreadStack[128 * 1024];
+
+struct AudioWorkletGlue {
+    static constexpr const char* kProcessorName = "allolib-wasm-processor";
+    static constexpr int kQuantum = 128;
+
+    // Context the processor was registered on; a new AudioContext (after
+    // runtime destroy) needs the worklet thread and processor again
+    static inline EMSCRIPTEN_WEBAUDIO_T sProcessorContext = 0;
+
+    // Audio thread. Copies the worklet's planar input into AudioIO's input
+    // buffers and the planar AudioIO output straight into the worklet's
+    // planar output, silence until the app is running.
+    static EM_BOOL process(int numInputs, const AudioSampleFrame* inputs, int numOutputs,
+                           AudioSampleFrame* outputs, int, const AudioParamFrame*,
+                           void* user) {
+        if (numOutputs < 1) return EM_TRUE;
+        auto* self = static_cast<WebApp*>(user);
+        AudioSampleFrame& out = outputs[0];
+        const size_t bytes = kQuantum * sizeof(float);
+
+        AudioIO& in = self->mAudioIOReal;
+        const int captured = numInputs > 0 ? inputs[0].numberOfChannels : 0;
+        for (int ch = 0; ch < (int)in.channelsIn(); ++ch) {
+            // A mono microphone feeds every input channel
+            if (captured > 0) {
+                const int src = ch < captured ? ch : captured - 1;
+                std::memcpy(in.inBuffer(ch), inputs[0].data + src * kQuantum, bytes);
+            } else {
+                audio_simd::zero(in.inBuffer(ch), kQuantum);
+            }
+        }
 
-EMSCRIPTEN_KEEPALIVE
-float al_autolod_get_distance_scale() {
-    return al::gAutoLODInstance ? al::gAutoLODInstance->distanceScale() : 1.0f;
-}
+        if (!self->renderAudioBlock()) {
+            audio_simd::zero(out.data, kQuantum * out.numberOfChannels);
+            return EM_TRUE;
+        }
 
-EMSCRIPTEN_KEEPALIVE
-void al_autolod_set_levels(int levels) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setLevels(levels);
+        AudioIO& io = self->mAudioIOReal;
+        for (int ch = 0; ch < out.numberOfChannels; ++ch) {
+            float* dst = out.data + ch * kQuantum;
+            if (ch < (int)io.channelsOut()) {
+                std::memcpy(dst, io.outBuffer(ch), bytes);
+            } else {
+                audio_simd::zero(dst, kQuantum);
+            }
+        }
+        return EM_TRUE;
     }
-}
 
-EMSCRIPTEN_KEEPALIVE
-int al_autolod_get_levels() {
-    return al::gAutoLODInstance ? al::gAutoLODInstance->levels() : 4;
-}
+    static void createNode(WebApp* self) {
+        int outChannels = self->mAudioConfig.outputChannels;
+        EmscriptenAudioWorkletNodeCreateOptions options = {};
+        // runtime.ts connects the microphone when the app wants input
+        options.numberOfInputs = self->mAudioConfig.inputChannels > 0 ? 1 : 0;
+        options.numberOfOutputs = 1;
+        options.outputChannelCounts = &outChannels;
 
-EMSCRIPTEN_KEEPALIVE
-void al_autolod_set_unload_distance(float distance) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setUnloadDistance(distance);
-    }
-}
+        EMSCRIPTEN_AUDIO_WORKLET_NODE_T node = emscripten_create_wasm_audio_worklet_node(
+            self->mAudioContext, kProcessorName, &options, &process, self);
 
-EMSCRIPTEN_KEEPALIVE
-void al_autolod_set_unload_enabled(int enabled) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setUnloadEnabled(enabled != 0);
+        // runtime.ts wires the limiter chain onto whatever node is here
+        EM_ASM({
+            window.alloWorkletNode = emscriptenGetAudioObject($0);
+            if (window.alloOnWasmAudioNode) window.alloOnWasmAudioNode();
+        }, node);
+        std::cout << "[AlloLib] Audio callback running on the Web Audio thread" << std::endl;
     }
-}
 
-// =========================================================================
-// Texture LOD bridge functions
-// =========================================================================
-
-EMSCRIPTEN_KEEPALIVE
-void al_texture_lod_set_enabled(int enabled) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setTextureLODEnabled(enabled != 0);
+    static void onProcessorCreated(EMSCRIPTEN_WEBAUDIO_T context, EM_BOOL success,
+                                   void* user) {
+        if (!success) {
+            std::cout << "[AlloLib] Failed to create the audio worklet processor" << std::endl;
+            return;
+        }
+        sProcessorContext = context;
+        createNode(static_cast<WebApp*>(user));
     }
-}
 
-EMSCRIPTEN_KEEPALIVE
-int al_texture_lod_get_enabled() {
-    return (al::gAutoLODInstance && al::gAutoLODInstance->textureLODEnabled()) ? 1 : 0;
-}
-
-EMSCRIPTEN_KEEPALIVE
-void al_texture_lod_set_bias(float bias) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setTextureLODBias(bias);
+    static void onThreadStarted(EMSCRIPTEN_WEBAUDIO_T context, EM_BOOL success,
+                                void* user) {
+        if (!success) {
+            std::cout << "[AlloLib] Failed to start the audio worklet thread" << std::endl;
+            return;
+        }
+        WebAudioWorkletProcessorCreateOptions options = {};
+        options.name = kProcessorName;
+        emscripten_create_wasm_audio_worklet_processor_async(
+            context, &options, &onProcessorCreated, user);
     }
-}
-
-EMSCRIPTEN_KEEPALIVE
-float al_texture_lod_get_bias() {
-    return al::gAutoLODInstance ? al::gAutoLODInstance->textureLODBias() : 1.0f;
-}
+};
 
-EMSCRIPTEN_KEEPALIVE
-void al_texture_lod_set_max_resolution(int resolution) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setMaxTextureResolution(resolution);
+void WebApp::startAudioWorklet() {
+    // Reuse the context runtime.ts created (it owns resume/suspend and the
+    // limiter chain); create one only when running outside the Studio
+    if (!mAudioContext) {
+        mAudioContext = EM_ASM_INT({
+            Module.alloWasmAudioWorklet = true;
+            return window.alloAudioContext
+                ? emscriptenRegisterAudioObject(window.alloAudioContext) : 0;
+        });
+    }
+    if (!mAudioContext) {
+        mAudioContext = emscripten_create_audio_context(nullptr);
+        EM_ASM({ window.alloAudioContext = emscriptenGetAudioObject($0); }, mAudioContext);
     }
-}
-
-EMSCRIPTEN_KEEPALIVE
-int al_texture_lod_get_max_resolution() {
-    return al::gAutoLODInstance ? al::gAutoLODInstance->maxTextureResolution() : 4096;
-}
 
-EMSCRIPTEN_KEEPALIVE
-int al_texture_lod_get_resolution(float distance) {
-    return al::gAutoLODInstance ? al::gAutoLODInstance->getTextureResolution(distance) : 4096;
-}
+    // Follow the rate the browser actually negotiated
+    int rate = EM_ASM_INT({ return emscriptenGetAudioObject($0).sampleRate | 0; },
+                          mAudioContext);
+    if (rate > 0 && rate != mAudioConfig.sampleRate) {
+        mAudioConfig.sampleRate = rate;
+        mAudioIOReal.framesPerSecond(rate);
+        gam::sampleRate(rate);
+    }
 
-EMSCRIPTEN_KEEPALIVE
-int al_texture_lod_get_level(float distance, int numLevels) {
-    return al::gAutoLODInstance ? al::gAutoLODInstance->getTextureLODLevel(distance, numLevels) : 0;
+    if (AudioWorkletGlue::sProcessorContext == mAudioContext) {
+        AudioWorkletGlue::createNode(this);
+        return;
+    }
+    emscripten_start_wasm_audio_worklet_thread_async(
+        mAudioContext, gAudioThreadStack, sizeof(gAudioThreadStack),
+        &AudioWorkletGlue::onThreadStarted, this);
 }
 
-// Continuous texture LOD functions (mipmap support)
+#endif // AL_WEB_AUDIO_WORKLET
 
-EMSCRIPTEN_KEEPALIVE
-void al_texture_lod_set_reference_distance(float distance) {
-    if (al::gAutoLODInstance) {
-        al::gAutoLODInstance->setTextureReferenceDistance(distance);
-    }
+void WebApp::setListenerPose(const Pose& pose) {
+#ifdef __EMSCRIPTEN__
+    // Update spatial audio listener position
+    EM_ASM({
+        if (window.alloWorkletNode) {
+            window.alloWorkletNode.port.postMessage({
+                type: 'setListener',
+                pos: { x: $0, y: $1, z: $2 },
+                quat: { w: $3, x: $4, y: $5, z: $6 }
+            });
+        }
+    }, pose.pos().x, pose.pos().y, pose.pos().z,
+       pose.quat().w, pose.quat().x, pose.quat().y, pose.quat().z);
+#else
+    (void)pose;
+#endif
 }
 
-EMSCRIPTEN_KEEPALIVE
-float al_texture_lod_get_reference_distance() {
-    return al::gAutoLODInstance ? al::gAutoLODInstance->textureReferenceDistance() : 5.0f;
-}
+} // namespace al
 
-EMSCRIPTEN_KEEPALIVE
-float al_texture_lod_get_continuous(float distance, int maxMipLevel) {
-    return al::gAutoLODInstance ? al::gAutoLODInstance->getContinuousTextureLOD(distance, maxMipLevel) : 0.0f;
-}
+extern "C" {
 
 // ── MEMFS / IDBFS bridge for the IDE file explorer ─────────────────────────
 //
@@ -1197,6 +1473,64 @@ const char* al_list_dir(const char* path) {
     return buffer.c_str();
 }
 
+// Audio timing block; owned by the running WebApp
+EMSCRIPTEN_KEEPALIVE
+uintptr_t al_audio_monitor_get_telemetry() {
+    if (!al::gAudioMonitorInstance) return 0;
+    return reinterpret_cast<uintptr_t>(&al::gAudioMonitorInstance->telemetry());
+}
+
+EMSCRIPTEN_KEEPALIVE
+const char* al_audio_monitor_get_section_name(int index) {
+    if (!al::gAudioMonitorInstance) return "";
+    return al::gAudioMonitorInstance->sectionName(index).c_str();
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_audio_monitor_reset() {
+    if (al::gAudioMonitorInstance) al::gAudioMonitorInstance->reset();
+}
+
+// Frame profiler
+EMSCRIPTEN_KEEPALIVE
+void al_profiler_set_enabled(int enabled) {
+    al::FrameProfiler::instance().setEnabled(enabled != 0);
+    if (enabled) al_gpu_profiler_set_enabled(1);
+}
+
+EMSCRIPTEN_KEEPALIVE
+int al_profiler_get_enabled() {
+    return al::FrameProfiler::enabled() ? 1 : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_profiler_set_overlay(int show) {
+    al::FrameProfiler::instance().setOverlay(show != 0);
+    if (show) al_gpu_profiler_set_enabled(1);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_profiler_clear() {
+    al::FrameProfiler::instance().clear();
+}
+
+EMSCRIPTEN_KEEPALIVE
+int al_profiler_export_trace() {
+    return int(al::FrameProfiler::instance().exportTrace());
+}
+
+// Frame-time window; owned by the running WebApp
+EMSCRIPTEN_KEEPALIVE
+uintptr_t al_perf_get_frame_stats() {
+    if (!al::gFrameStatsInstance) return 0;
+    return reinterpret_cast<uintptr_t>(&al::gFrameStatsInstance->summary());
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_perf_reset() {
+    if (al::gFrameStatsInstance) al::gFrameStatsInstance->reset();
+}
+
 EMSCRIPTEN_KEEPALIVE
 void al_remove_dir(const char* path) {
     // Recursive rm. Walks the tree depth-first, unlinks files, rmdirs
@@ -0,0 +1,342 @@
+/**
+ * Auto-LOD component: the global AutoLODManager pointer, its JavaScript
+ * bridge (window.allolib.autoLOD / textureLOD and the al_autolod_* /
+ * al_texture_lod_* exports) and WebApp's auto-LOD accessors.
+ *
+ * Kept out of al_WebApp.cpp so that only sketches using auto-LOD link it:
+ * the helpers in al_WebAutoLOD.hpp and WebApp::autoLOD() / drawLOD() all
+ * reference symbols defined here. WebApp::start() attaches the app's
+ * manager through a weak reference to attachAutoLOD(), and the exports are
+ * EMSCRIPTEN_KEEPALIVE rather than listed in EXPORTED_FUNCTIONS, which
+ * would link them into every build.
+ */
+
+#include "al_WebApp.hpp"
+#include "al_WebAutoLOD.hpp"
+
+#include <emscripten.h>
+
+// EM_JS rather than EM_ASM, which has issues with JS object literals
+EM_JS(void, registerAutoLODJSBridge, (), {
+    window.allolib = window.allolib || {};
+    window.allolib.autoLOD = {
+        setBias: function(bias) {
+            Module.ccall('al_autolod_set_bias', null, ['number'], [bias]);
+        },
+        setEnabled: function(enabled) {
+            Module.ccall('al_autolod_set_enabled', null, ['number'], [enabled ? 1 : 0]);
+        },
+        setBudget: function(budget) {
+            Module.ccall('al_autolod_set_budget', null, ['number'], [budget]);
+        },
+        setMode: function(mode) {
+            Module.ccall('al_autolod_set_mode', null, ['number'], [mode]);
+        },
+        setMinFullQualityDistance: function(distance) {
+            Module.ccall('al_autolod_set_min_full_quality_distance', null, ['number'], [distance]);
+        },
+        setDistances: function(d0, d1, d2, d3) {
+            Module.ccall('al_autolod_set_distances', null, ['number', 'number', 'number', 'number'], [d0, d1, d2, d3]);
+        },
+        getTriangles: function() {
+            return Module.ccall('al_autolod_get_triangles', 'number', [], []);
+        },
+        getBias: function() {
+            return Module.ccall('al_autolod_get_bias', 'number', [], []);
+        },
+        // New functions for enhanced LOD control
+        setDistanceScale: function(scale) {
+            Module.ccall('al_autolod_set_distance_scale', null, ['number'], [scale]);
+        },
+        getDistanceScale: function() {
+            return Module.ccall('al_autolod_get_distance_scale', 'number', [], []);
+        },
+        setLevels: function(levels) {
+            Module.ccall('al_autolod_set_levels', null, ['number'], [levels]);
+        },
+        getLevels: function() {
+            return Module.ccall('al_autolod_get_levels', 'number', [], []);
+        },
+        setUnloadDistance: function(distance) {
+            Module.ccall('al_autolod_set_unload_distance', null, ['number'], [distance]);
+        },
+        setUnloadEnabled: function(enabled) {
+            Module.ccall('al_autolod_set_unload_enabled', null, ['number'], [enabled ? 1 : 0]);
+        },
+        // Per-frame stats block (LODTelemetry in al_WebAutoLOD.hpp). Fetch the
+        // pointer once, then readTelemetry(ptr) each frame without a ccall.
+        getTelemetryPointer: function() {
+            return Module.ccall('al_autolod_get_telemetry', 'number', [], []);
+        },
+        readTelemetry: function(ptr) {
+            ptr = ptr || Module.ccall('al_autolod_get_telemetry', 'number', [], []);
+            if (!ptr) return null;
+            var u = HEAPU32, f = HEAPF32, i = ptr >> 2;
+            if (u[i] !== 1) return null;  // Layout version
+            var levels = 16, texLevels = 8;
+            var t = {
+                version: u[i], frame: u[i + 1], triangles: u[i + 2], meshes: u[i + 3],
+                objectsDrawn: u[i + 4], objectsFrustumCulled: u[i + 5],
+                objectsOccluded: u[i + 6], meshesUnloaded: u[i + 7]
+            };
+            var o = i + 8;
+            t.levelTriangles = Array.from(u.subarray(o, o + levels)); o += levels;
+            t.levelDraws = Array.from(u.subarray(o, o + levels)); o += levels;
+            t.generationMs = f[o++];
+            t.pendingGenerations = u[o++];
+            t.cachedMeshes = u[o++];
+            t.cacheBytes = u[o++];
+            t.textureLevels = Array.from(u.subarray(o, o + texLevels)); o += texLevels;
+            t.triangleBudget = u[o++];
+            t.bias = f[o++];
+            return t;
+        }
+    };
+
+    // Texture LOD bridge
+    window.allolib.textureLOD = {
+        setEnabled: function(enabled) {
+            Module.ccall('al_texture_lod_set_enabled', null, ['number'], [enabled ? 1 : 0]);
+        },
+        getEnabled: function() {
+            return Module.ccall('al_texture_lod_get_enabled', 'number', [], []) !== 0;
+        },
+        setBias: function(bias) {
+            Module.ccall('al_texture_lod_set_bias', null, ['number'], [bias]);
+        },
+        getBias: function() {
+            return Module.ccall('al_texture_lod_get_bias', 'number', [], []);
+        },
+        setMaxResolution: function(resolution) {
+            Module.ccall('al_texture_lod_set_max_resolution', null, ['number'], [resolution]);
+        },
+        getMaxResolution: function() {
+            return Module.ccall('al_texture_lod_get_max_resolution', 'number', [], []);
+        },
+        getResolutionForDistance: function(distance) {
+            return Module.ccall('al_texture_lod_get_resolution', 'number', ['number'], [distance]);
+        },
+        getLevelForDistance: function(distance, numLevels) {
+            return Module.ccall('al_texture_lod_get_level', 'number', ['number', 'number'], [distance, numLevels || -1]);
+        },
+        // Continuous LOD methods (Unreal-style mipmap support)
+        setReferenceDistance: function(distance) {
+            Module.ccall('al_texture_lod_set_reference_distance', null, ['number'], [distance]);
+        },
+        getReferenceDistance: function() {
+            return Module.ccall('al_texture_lod_get_reference_distance', 'number', [], []);
+        },
+        getContinuousLOD: function(distance, maxMipLevel) {
+            return Module.ccall('al_texture_lod_get_continuous', 'number', ['number', 'number'], [distance, maxMipLevel || 12]);
+        }
+    };
+
+    console.log('[AlloLib] Auto-LOD and Texture LOD JS bridges registered');
+});
+
+namespace al {
+
+AutoLODManager* gAutoLODInstance = nullptr;
+
+void attachAutoLOD(AutoLODManager* lod) {
+    setGlobalAutoLOD(lod);
+    registerAutoLODJSBridge();
+}
+
+AutoLODManager& WebApp::autoLOD() { return mAutoLOD; }
+const AutoLODManager& WebApp::autoLOD() const { return mAutoLOD; }
+
+void WebApp::drawLOD(Graphics& g, const Mesh& mesh) {
+    if (mAutoLOD.enabled()) {
+        const Mesh& selected = mAutoLOD.selectMesh(mesh, g.modelMatrix());
+        g.draw(selected);
+    } else {
+        g.draw(mesh);
+    }
+}
+
+void WebApp::enableAutoLOD(int levels) {
+    mAutoLOD.enable();
+    mAutoLOD.setLevels(levels);
+}
+
+void WebApp::disableAutoLOD() {
+    mAutoLOD.disable();
+}
+
+} // namespace al
+
+// =========================================================================
+// JavaScript bridge function definitions for AutoLOD
+// =========================================================================
+extern "C" {
+
+EMSCRIPTEN_KEEPALIVE
+void al_autolod_set_bias(float bias) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setBias(bias);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_autolod_set_enabled(int enabled) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->enable(enabled != 0);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_autolod_set_budget(int budget) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setTriangleBudget(budget);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_autolod_set_mode(int mode) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setSelectionMode(static_cast<al::LODSelectionMode>(mode));
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+int al_autolod_get_triangles() {
+    return al::gAutoLODInstance ? al::gAutoLODInstance->frameTriangles() : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+float al_autolod_get_bias() {
+    return al::gAutoLODInstance ? al::gAutoLODInstance->bias() : 1.0f;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_autolod_set_min_full_quality_distance(float distance) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setMinFullQualityDistance(distance);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_autolod_set_distances(float d0, float d1, float d2, float d3) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setDistances({d0, d1, d2, d3});
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_autolod_set_distance_scale(float scale) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setDistanceScale(scale);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+float al_autolod_get_distance_scale() {
+    return al::gAutoLODInstance ? al::gAutoLODInstance->distanceScale() : 1.0f;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_autolod_set_levels(int levels) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setLevels(levels);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+int al_autolod_get_levels() {
+    return al::gAutoLODInstance ? al::gAutoLODInstance->levels() : 4;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_autolod_set_unload_distance(float distance) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setUnloadDistance(distance);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_autolod_set_unload_enabled(int enabled) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setUnloadEnabled(enabled != 0);
+    }
+}
+
+// The block is a member of the app's AutoLODManager, so the pointer stays
+// valid for the app's lifetime; asking for it turns on triangle stats
+EMSCRIPTEN_KEEPALIVE
+uintptr_t al_autolod_get_telemetry() {
+    if (!al::gAutoLODInstance) return 0;
+    al::gAutoLODInstance->enableStats(true);
+    return reinterpret_cast<uintptr_t>(&al::gAutoLODInstance->telemetry());
+}
+
+// =========================================================================
+// Texture LOD bridge functions
+// =========================================================================
+
+EMSCRIPTEN_KEEPALIVE
+void al_texture_lod_set_enabled(int enabled) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setTextureLODEnabled(enabled != 0);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+int al_texture_lod_get_enabled() {
+    return (al::gAutoLODInstance && al::gAutoLODInstance->textureLODEnabled()) ? 1 : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_texture_lod_set_bias(float bias) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setTextureLODBias(bias);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+float al_texture_lod_get_bias() {
+    return al::gAutoLODInstance ? al::gAutoLODInstance->textureLODBias() : 1.0f;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void al_texture_lod_set_max_resolution(int resolution) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setMaxTextureResolution(resolution);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+int al_texture_lod_get_max_resolution() {
+    return al::gAutoLODInstance ? al::gAutoLODInstance->maxTextureResolution() : 4096;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int al_texture_lod_get_resolution(float distance) {
+    return al::gAutoLODInstance ? al::gAutoLODInstance->getTextureResolution(distance) : 4096;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int al_texture_lod_get_level(float distance, int numLevels) {
+    return al::gAutoLODInstance ? al::gAutoLODInstance->getTextureLODLevel(distance, numLevels) : 0;
+}
+
+// Continuous texture LOD functions (mipmap support)
+
+EMSCRIPTEN_KEEPALIVE
+void al_texture_lod_set_reference_distance(float distance) {
+    if (al::gAutoLODInstance) {
+        al::gAutoLODInstance->setTextureReferenceDistance(distance);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+float al_texture_lod_get_reference_distance() {
+    return al::gAutoLODInstance ? al::gAutoLODInstance->textureReferenceDistance() : 5.0f;
+}
+
+EMSCRIPTEN_KEEPALIVE
+float al_texture_lod_get_continuous(float distance, int maxMipLevel) {
+    return al::gAutoLODInstance ? al::gAutoLODInstance->getContinuousTextureLOD(distance, maxMipLevel) : 0.0f;
+}
+
+} // extern "C"
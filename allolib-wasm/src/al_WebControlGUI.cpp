@@ -23,7 +23,11 @@
 #ifdef __EMSCRIPTEN__
 
 #include <emscripten.h>
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "al_WebControlGUI.hpp"
 #include "al_parameter_registry.hpp"
@@ -98,8 +102,143 @@ al::WebParamInfo WebControlGUI::dispatchInfo(ParameterMeta* p, int index) {
     return info;
 }
 
+// Panel writes waiting for the next frame, at most one per parameter
+static std::vector<std::pair<ParameterMeta*, float>> sQueuedValues;
+
+// ─── Shared value table ────────────────────────────────────────────────────
+//
+// One float per registry index for the scalar types (FLOAT / INT / BOOL /
+// MENU), plus two bitmasks over the same indices:
+//   outMask — set by syncParameterTable for values C++ changed this frame;
+//             the panel reads them in the one onParametersSynced callback.
+//   inMask  — set by the panel after writing a value into the table;
+//             flushQueuedValues applies those before onAnimate.
+// The arrays move when the registry changes, so the panel caches only the
+// address of sTableHeader (from al_webgui_sync_table) and re-reads the
+// pointers from it. `generation` bumps whenever they move or reindex.
+
+namespace {
+
+enum SlotKind : uint8_t { SLOT_NONE, SLOT_FLOAT, SLOT_INT, SLOT_BOOL, SLOT_MENU };
+
+struct SyncTableHeader {
+    float*    values;
+    uint32_t* outMask;
+    uint32_t* inMask;
+    int32_t   count;
+    uint32_t  generation;
+};
+
+SyncTableHeader            sTableHeader = {nullptr, nullptr, nullptr, 0, 0};
+std::vector<float>         sTableValues;
+std::vector<uint32_t>      sTableOut;
+std::vector<uint32_t>      sTableIn;
+std::vector<ParameterMeta*> sTableParams;
+std::vector<uint8_t>       sTableKinds;
+uint64_t                   sTableVersion = ~uint64_t(0);
+
+uint8_t slotKind(ParameterMeta* p) {
+    if (dynamic_cast<al::Parameter*>(p))     return SLOT_FLOAT;
+    if (dynamic_cast<al::ParameterInt*>(p))  return SLOT_INT;
+    if (dynamic_cast<al::ParameterBool*>(p)) return SLOT_BOOL;
+    if (dynamic_cast<al::ParameterMenu*>(p)) return SLOT_MENU;
+    return SLOT_NONE;
+}
+
+// Same reads as dispatchGetValue, minus the dynamic_casts
+float readSlot(ParameterMeta* p, uint8_t kind) {
+    switch (kind) {
+        case SLOT_FLOAT: return static_cast<al::Parameter*>(p)->get();
+        case SLOT_INT:   return (float)static_cast<al::ParameterInt*>(p)->get();
+        case SLOT_BOOL:  return static_cast<al::ParameterBool*>(p)->get() ? 1.f : 0.f;
+        case SLOT_MENU:  return (float)static_cast<al::ParameterMenu*>(p)->get();
+        default:         return 0.f;
+    }
+}
+
+bool inboundSet(size_t i) { return (sTableIn[i >> 5] >> (i & 31)) & 1u; }
+
+// Rebuild the table when parameters were added or cleared. Panel writes
+// still pending in the old table are queued by parameter, not index.
+void refreshTable() {
+    auto& registry = ParameterRegistry::global();
+    if (registry.version() == sTableVersion) return;
+
+    for (size_t i = 0; i < sTableParams.size(); ++i) {
+        if (inboundSet(i) && registry.has(sTableParams[i])) {
+            WebControlGUI::queueSetValue(sTableParams[i], sTableValues[i]);
+        }
+    }
+
+    sTableVersion = registry.version();
+    sTableParams = registry.snapshot();
+    const size_t n = sTableParams.size();
+    const size_t words = (n + 31) / 32;
+    sTableKinds.resize(n);
+    sTableValues.resize(n);
+    sTableOut.assign(words, 0u);
+    sTableIn.assign(words, 0u);
+    for (size_t i = 0; i < n; ++i) {
+        sTableKinds[i] = slotKind(sTableParams[i]);
+        sTableValues[i] = readSlot(sTableParams[i], sTableKinds[i]);
+    }
+
+    sTableHeader.values = sTableValues.data();
+    sTableHeader.outMask = sTableOut.data();
+    sTableHeader.inMask = sTableIn.data();
+    sTableHeader.count = (int32_t)n;
+    sTableHeader.generation++;
+}
+
+} // namespace
+
+void WebControlGUI::syncParameterTable() {
+    refreshTable();
+
+    bool changed = false;
+    for (size_t i = 0; i < sTableParams.size(); ++i) {
+        const uint8_t kind = sTableKinds[i];
+        // A panel write waiting for the next frame wins over the old value
+        if (kind == SLOT_NONE || inboundSet(i)) continue;
+        const float v = readSlot(sTableParams[i], kind);
+        if (v != sTableValues[i]) {
+            sTableValues[i] = v;
+            sTableOut[i >> 5] |= 1u << (i & 31);
+            changed = true;
+        }
+    }
+    if (!changed) return;
+
+    // One call per frame however many values moved. Panels that predate
+    // the table still get their per-index onParameterChanged, from JS.
+    EM_ASM({
+        var lib = window.allolib;
+        if (!lib) return;
+        if (lib.onParametersSynced) { lib.onParametersSynced($0); return; }
+        if (!lib.onParameterChanged) return;
+        var values = HEAPU32[$0 >> 2] >> 2;
+        var mask = HEAPU32[($0 >> 2) + 1] >> 2;
+        var count = HEAP32[($0 >> 2) + 3];
+        for (var w = 0; w * 32 < count; w++) {
+            var bits = HEAPU32[mask + w];
+            while (bits) {
+                var b = 31 - Math.clz32(bits);
+                bits &= ~(1 << b);
+                lib.onParameterChanged(w * 32 + b, HEAPF32[values + w * 32 + b]);
+            }
+        }
+    }, &sTableHeader);
+    std::fill(sTableOut.begin(), sTableOut.end(), 0u);
+}
+
 float WebControlGUI::dispatchGetValue(ParameterMeta* p) {
     if (!p) return 0.f;
+    for (const auto& q : sQueuedValues) {
+        if (q.first == p) return q.second;
+    }
+    for (size_t i = 0; i < sTableParams.size(); ++i) {
+        if (sTableParams[i] == p && inboundSet(i)) return sTableValues[i];
+    }
     if (auto* fp = dynamic_cast<al::Parameter*>(p))      return fp->get();
     if (auto* ip = dynamic_cast<al::ParameterInt*>(p))   return (float)ip->get();
     if (auto* bp = dynamic_cast<al::ParameterBool*>(p))  return bp->get() ? 1.f : 0.f;
@@ -115,6 +254,39 @@ void WebControlGUI::dispatchSetValue(ParameterMeta* p, float value) {
     else if (auto* mp = dynamic_cast<al::ParameterMenu*>(p))mp->set((int)value);
 }
 
+void WebControlGUI::queueSetValue(ParameterMeta* p, float value) {
+    if (!p) return;
+    for (auto& q : sQueuedValues) {
+        if (q.first == p) { q.second = value; return; }
+    }
+    sQueuedValues.emplace_back(p, value);
+}
+
+void WebControlGUI::flushQueuedValues() {
+    // Table writes from the panel join the queue, last value per parameter
+    refreshTable();
+    for (size_t w = 0; w < sTableIn.size(); ++w) {
+        uint32_t bits = sTableIn[w];
+        sTableIn[w] = 0u;
+        while (bits) {
+            const int b = __builtin_ctz(bits);
+            bits &= bits - 1;
+            const size_t i = w * 32 + b;
+            queueSetValue(sTableParams[i], sTableValues[i]);
+        }
+    }
+
+    if (sQueuedValues.empty()) return;
+    // set() callbacks may queue again; those wait for the next frame
+    std::vector<std::pair<ParameterMeta*, float>> pending;
+    pending.swap(sQueuedValues);
+    auto& registry = ParameterRegistry::global();
+    for (const auto& q : pending) {
+        // The registry is cleared when an app is torn down; skip stale entries
+        if (registry.has(q.first)) dispatchSetValue(q.first, q.second);
+    }
+}
+
 void WebControlGUI::dispatchSetString(ParameterMeta* p, const std::string& value) {
     if (auto* sp = dynamic_cast<al::ParameterString*>(p)) sp->set(value);
 }
@@ -167,6 +339,12 @@ const char* al_webgui_get_parameter_group(int index) {
     return "";
 }
 
+// Registry index of the first parameter named `name`, or -1
+EMSCRIPTEN_KEEPALIVE
+int al_webgui_get_parameter_index(const char* name) {
+    return name ? ParameterRegistry::global().indexOf(std::string(name)) : -1;
+}
+
 EMSCRIPTEN_KEEPALIVE
 int al_webgui_get_parameter_type(int index) {
     auto* p = ParameterRegistry::global().at(index);
@@ -200,7 +378,16 @@ float al_webgui_get_parameter_default(int index) {
 EMSCRIPTEN_KEEPALIVE
 void al_webgui_set_parameter_value(int index, float value) {
     auto* p = ParameterRegistry::global().at(index);
-    WebControlGUI::dispatchSetValue(p, value);
+    WebControlGUI::queueSetValue(p, value);
+}
+
+// Address of the shared value table header: { values, outMask, inMask,
+// count, generation }, five 32-bit words that stay put for the module's
+// lifetime.
+EMSCRIPTEN_KEEPALIVE
+const void* al_webgui_sync_table() {
+    refreshTable();
+    return &sTableHeader;
 }
 
 EMSCRIPTEN_KEEPALIVE
@@ -5,11 +5,144 @@
  */
 
 #include "al_WebGL2Backend.hpp"
+#include "al_WebProfiler.hpp"
+#include "al/graphics/al_WebGL2Extensions.hpp"
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 
+#ifdef __EMSCRIPTEN__
+// WEBGL_multi_draw is called straight on the context; the arrays are
+// passed as views into the wasm heap
+
+EM_JS(int, al_webgl2_enable_multi_draw, (), {
+    if (typeof GLctx === 'undefined' || !GLctx) return 0;
+    GLctx.alMultiDraw = GLctx.getExtension('WEBGL_multi_draw');
+    return GLctx.alMultiDraw ? 1 : 0;
+});
+
+// Enabling KHR_parallel_shader_compile is what lets the driver finish
+// compiles off the main thread; COMPLETION_STATUS_KHR then polls them
+EM_JS(int, al_webgl2_enable_parallel_compile, (), {
+    if (typeof GLctx === 'undefined' || !GLctx) return 0;
+    return GLctx.getExtension('KHR_parallel_shader_compile') ? 1 : 0;
+});
+
+// Compressed formats must be enabled on the context before upload; returns
+// a WebGL2Backend::kCompression* mask of what is available
+EM_JS(int, al_webgl2_enable_texture_compression, (), {
+    if (typeof GLctx === 'undefined' || !GLctx) return 0;
+    var mask = 0;
+    if (GLctx.getExtension('WEBGL_compressed_texture_s3tc')) mask |= 1;
+    if (GLctx.getExtension('EXT_texture_compression_bptc')) mask |= 2;
+    if (GLctx.getExtension('WEBGL_compressed_texture_etc')) mask |= 4;
+    if (GLctx.getExtension('WEBGL_compressed_texture_astc')) mask |= 8;
+    return mask;
+});
+
+// Bitmaps decoded by WebImage::loadBitmap() go straight to the bound texture
+EM_JS(int, al_webgl2_tex_image_bitmap, (int target, int bitmapId), {
+    var state = Module._alImageBitmaps;
+    var bitmap = state && state.bitmaps[bitmapId];
+    if (!bitmap) return 0;
+    GLctx.texImage2D(target, 0, GLctx.RGBA8, GLctx.RGBA, GLctx.UNSIGNED_BYTE, bitmap);
+    return 1;
+});
+
+EM_JS(void, al_webgl2_multi_draw_arrays, (int mode, const int* firsts, const int* counts,
+                                          const int* instanceCounts, int drawCount), {
+    var ext = GLctx.alMultiDraw;
+    if (instanceCounts) {
+        ext.multiDrawArraysInstancedWEBGL(mode, HEAP32, firsts >> 2, HEAP32, counts >> 2,
+                                          HEAP32, instanceCounts >> 2, drawCount);
+    } else {
+        ext.multiDrawArraysWEBGL(mode, HEAP32, firsts >> 2, HEAP32, counts >> 2, drawCount);
+    }
+});
+
+EM_JS(void, al_webgl2_multi_draw_elements, (int mode, const int* counts, int type,
+                                            const int* offsets, const int* instanceCounts,
+                                            int drawCount), {
+    var ext = GLctx.alMultiDraw;
+    if (instanceCounts) {
+        ext.multiDrawElementsInstancedWEBGL(mode, HEAP32, counts >> 2, type, HEAP32, offsets >> 2,
+                                            HEAP32, instanceCounts >> 2, drawCount);
+    } else {
+        ext.multiDrawElementsWEBGL(mode, HEAP32, counts >> 2, type, HEAP32, offsets >> 2,
+                                   drawCount);
+    }
+});
+
+// EXT_disjoint_timer_query_webgl2 around each frame. Queries resolve a few
+// frames later; a disjoint event (context loss, power state change) voids
+// every query in flight.
+EM_JS(int, al_webgl2_timer_init, (), {
+    if (typeof GLctx === 'undefined' || !GLctx) return 0;
+    var ext = GLctx.getExtension('EXT_disjoint_timer_query_webgl2');
+    if (!ext) return 0;
+    GLctx.alTimer = { ext: ext, free: [], pending: [], active: null };
+    return 1;
+});
+
+EM_JS(void, al_webgl2_timer_begin, (), {
+    var t = GLctx.alTimer;
+    if (!t || t.active || t.pending.length >= 4) return;
+    t.active = t.free.pop() || GLctx.createQuery();
+    GLctx.beginQuery(t.ext.TIME_ELAPSED_EXT, t.active);
+});
+
+EM_JS(void, al_webgl2_timer_end, (), {
+    var t = GLctx.alTimer;
+    if (!t || !t.active) return;
+    GLctx.endQuery(t.ext.TIME_ELAPSED_EXT);
+    t.pending.push(t.active);
+    t.active = null;
+});
+
+// Newest resolved frame in ms, or -1 if none resolved since the last poll
+EM_JS(double, al_webgl2_timer_poll, (), {
+    var t = GLctx.alTimer;
+    if (!t) return -1;
+    if (GLctx.getParameter(t.ext.GPU_DISJOINT_EXT)) {
+        while (t.pending.length) t.free.push(t.pending.shift());
+        return -1;
+    }
+    var ms = -1;
+    while (t.pending.length && GLctx.getQueryParameter(t.pending[0], GLctx.QUERY_RESULT_AVAILABLE)) {
+        ms = GLctx.getQueryParameter(t.pending[0], GLctx.QUERY_RESULT) / 1e6;
+        t.free.push(t.pending.shift());
+    }
+    return ms;
+});
+
+EM_JS(void, al_webgl2_timer_shutdown, (), {
+    if (typeof GLctx === 'undefined' || !GLctx || !GLctx.alTimer) return;
+    var t = GLctx.alTimer;
+    if (t.active) {
+        GLctx.endQuery(t.ext.TIME_ELAPSED_EXT);
+        t.free.push(t.active);
+    }
+    t.free.concat(t.pending).forEach(function(q) { GLctx.deleteQuery(q); });
+    GLctx.alTimer = null;
+});
+#endif
+
 namespace al {
 
+// Inserted after #version in vertex shaders that use AL_DRAW_ID. The
+// extension macro is only defined when WEBGL_multi_draw was enabled.
+static const char* kDrawIdPrelude = R"(
+#extension GL_ANGLE_multi_draw : enable
+#ifdef GL_ANGLE_multi_draw
+#define AL_DRAW_ID gl_DrawID
+#else
+uniform int al_DrawID;
+#define AL_DRAW_ID al_DrawID
+#endif
+struct al_DrawTransform { mat4 modelView; vec4 tint; };
+layout(std140) uniform al_DrawTransforms { al_DrawTransform al_drawTransforms[128]; };
+)";
+
 // ─── Constructor / Destructor ────────────────────────────────────────────────
 
 WebGL2Backend::WebGL2Backend() = default;
@@ -26,7 +159,27 @@ bool WebGL2Backend::init(int width, int height) {
 
     // Create a VAO for vertex attribute management
     glGenVertexArrays(1, &mVao);
-    glBindVertexArray(mVao);
+    bindVertexArray(mVao);
+
+    // Shared UBO for programs declaring the standard uniform block
+    glGenBuffers(1, &mStandardUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, mStandardUbo);
+    glBufferData(GL_UNIFORM_BUFFER, kStandardBlockSize, nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kStandardBlockBinding, mStandardUbo);
+    resetStandardUniforms();
+
+#ifdef __EMSCRIPTEN__
+    // Must be enabled before compiling shaders that use gl_DrawID
+    mMultiDraw = al_webgl2_enable_multi_draw() != 0;
+    mCompression = al_webgl2_enable_texture_compression();
+    mParallelCompile = al_webgl2_enable_parallel_compile() != 0;
+    mTimerSupported = al_webgl2_timer_init() != 0;
+#endif
+    glGenBuffers(1, &mDrawTransformUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, mDrawTransformUbo);
+    glBufferData(GL_UNIFORM_BUFFER, kMaxDrawTransforms * sizeof(InstanceAttributes),
+                 nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kDrawTransformBinding, mDrawTransformUbo);
 
     // Set default state
     glEnable(GL_DEPTH_TEST);
@@ -34,11 +187,24 @@ bool WebGL2Backend::init(int width, int height) {
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
 
-    printf("[WebGL2Backend] Initialized %dx%d\n", width, height);
+    printf("[WebGL2Backend] Initialized %dx%d (multi-draw: %s, parallel compile: %s, "
+           "GPU timer: %s, compression:%s%s%s%s)\n",
+           width, height, mMultiDraw ? "yes" : "no", mParallelCompile ? "yes" : "no",
+           mTimerSupported ? "yes" : "no",
+           (mCompression & kCompressionS3TC) ? " s3tc" : "",
+           (mCompression & kCompressionBPTC) ? " bptc" : "",
+           (mCompression & kCompressionETC) ? " etc" : "",
+           (mCompression & kCompressionASTC) ? " astc" : "");
     return true;
 }
 
 void WebGL2Backend::shutdown() {
+#ifdef __EMSCRIPTEN__
+    al_webgl2_timer_shutdown();
+#endif
+    mTimerSupported = false;
+    mTimerEnabled = false;
+
     // Destroy all resources
     for (auto& [id, buf] : mBuffers) {
         if (buf.glId) glDeleteBuffers(1, &buf.glId);
@@ -51,6 +217,8 @@ void WebGL2Backend::shutdown() {
     mTextures.clear();
 
     for (auto& [id, shader] : mShaders) {
+        if (shader.pendingVertex) glDeleteShader(shader.pendingVertex);
+        if (shader.pendingFragment) glDeleteShader(shader.pendingFragment);
         if (shader.glProgram) glDeleteProgram(shader.glProgram);
     }
     mShaders.clear();
@@ -60,10 +228,27 @@ void WebGL2Backend::shutdown() {
     }
     mRenderTargets.clear();
 
+    for (auto& [key, vao] : mVaoCache) {
+        glDeleteVertexArrays(1, &vao);
+    }
+    mVaoCache.clear();
+
     if (mVao) {
         glDeleteVertexArrays(1, &mVao);
         mVao = 0;
     }
+    mCurrentVao = 0;
+    mScratchAttribMask = 0;
+
+    if (mStandardUbo) {
+        glDeleteBuffers(1, &mStandardUbo);
+        mStandardUbo = 0;
+    }
+
+    if (mDrawTransformUbo) {
+        glDeleteBuffers(1, &mDrawTransformUbo);
+        mDrawTransformUbo = 0;
+    }
 
     mNextHandleId = 1;
     mCurrentShader = {};
@@ -76,16 +261,47 @@ void WebGL2Backend::resize(int width, int height) {
 }
 
 void WebGL2Backend::beginFrame() {
+    // Other GL users may have changed the binding since the last frame
     glBindVertexArray(mVao);
+    mCurrentVao = mVao;
+#ifdef __EMSCRIPTEN__
+    if (mTimerEnabled) al_webgl2_timer_begin();
+#endif
 }
 
 void WebGL2Backend::endFrame() {
+    AL_PROFILE_ZONE("WebGL2 flush");
+    runFlushHook();
+#ifdef __EMSCRIPTEN__
+    if (mTimerEnabled) {
+        al_webgl2_timer_end();
+        double ms = al_webgl2_timer_poll();
+        if (ms >= 0.0) mGPUFrameMs = mGPUFrameMs > 0.0 ? mGPUFrameMs * 0.9 + ms * 0.1 : ms;
+    }
+#endif
     // WebGL2 doesn't need explicit present - handled by browser
 }
 
+// ─── GPU Timing ──────────────────────────────────────────────────────────────
+
+bool WebGL2Backend::setGPUProfilingEnabled(bool enabled) {
+    if (!enabled) {
+        mTimerEnabled = false;
+        mGPUFrameMs = 0.0;
+        return true;
+    }
+    if (!mTimerSupported) {
+        printf("[WebGL2Backend] GPU timing unavailable (no EXT_disjoint_timer_query_webgl2)\n");
+        return false;
+    }
+    mTimerEnabled = true;
+    return true;
+}
+
 // ─── Render State ────────────────────────────────────────────────────────────
 
 void WebGL2Backend::clear(const ClearValues& values) {
+    runFlushHook();
     GLbitfield mask = 0;
 
     if (values.clearColor) {
@@ -109,10 +325,13 @@ void WebGL2Backend::clear(const ClearValues& values) {
 }
 
 void WebGL2Backend::viewport(int x, int y, int w, int h) {
+    runFlushHook();
     glViewport(x, y, w, h);
 }
 
 void WebGL2Backend::setDrawState(const DrawState& state) {
+    mDrawState = state;
+
     // Blending
     if (state.blend == BlendMode::None) {
         glDisable(GL_BLEND);
@@ -172,12 +391,12 @@ BufferHandle WebGL2Backend::createBuffer(
     GLenum target = toGLBufferType(type);
     GLenum glUsage = toGLBufferUsage(usage);
 
+    protectVaoElementBinding(target);
     glBindBuffer(target, resource.glId);
     glBufferData(target, size, data, glUsage);
     glBindBuffer(target, 0);
 
-    uint64_t id = generateHandleId();
-    mBuffers[id] = resource;
+    uint64_t id = mBuffers.insert(std::move(resource));
 
     return BufferHandle{id};
 }
@@ -192,6 +411,7 @@ void WebGL2Backend::updateBuffer(
     if (it == mBuffers.end()) return;
 
     GLenum target = toGLBufferType(it->second.type);
+    protectVaoElementBinding(target);
     glBindBuffer(target, it->second.glId);
     glBufferSubData(target, offset, size, data);
     glBindBuffer(target, 0);
@@ -201,6 +421,19 @@ void WebGL2Backend::destroyBuffer(BufferHandle handle) {
     auto it = mBuffers.find(handle.id);
     if (it == mBuffers.end()) return;
 
+    for (auto vaoIt = mVaoCache.begin(); vaoIt != mVaoCache.end();) {
+        if (vaoIt->first.vertexBuffer == handle.id || vaoIt->first.indexBuffer == handle.id) {
+            if (vaoIt->second == mCurrentVao) bindVertexArray(mVao);
+            glDeleteVertexArrays(1, &vaoIt->second);
+            vaoIt = mVaoCache.erase(vaoIt);
+        } else {
+            ++vaoIt;
+        }
+    }
+    if (mPendingVertexBuffer.id == handle.id) mPendingVertexBuffer = {};
+    if (mPendingIndexBuffer.id == handle.id) mPendingIndexBuffer = {};
+    if (mInstanceBuffer.id == handle.id) mInstanceBuffer = {};
+
     if (it->second.glId) {
         glDeleteBuffers(1, &it->second.glId);
     }
@@ -239,7 +472,19 @@ TextureHandle WebGL2Backend::createTexture(
     GLenum pixelFormat = toGLPixelFormat(desc.format);
     GLenum pixelType = toGLPixelType(desc.format);
 
-    if (target == GL_TEXTURE_2D) {
+    bool compressed = isCompressedFormat(desc.format);
+    if (compressed && target == GL_TEXTURE_2D) {
+        // Immutable storage for the whole pre-baked chain; updateTexture()
+        // fills the levels after the first
+        int levels = std::max(1, desc.mipLevels);
+        glTexStorage2D(target, levels, internalFormat, desc.width, desc.height);
+        glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levels - 1);
+        if (data) {
+            glCompressedTexSubImage2D(target, 0, 0, 0, desc.width, desc.height, internalFormat,
+                                      (GLsizei)compressedImageBytes(desc.format, desc.width, desc.height),
+                                      data);
+        }
+    } else if (target == GL_TEXTURE_2D) {
         glTexImage2D(target, 0, internalFormat, desc.width, desc.height, 0,
                      pixelFormat, pixelType, data);
     } else if (target == GL_TEXTURE_3D) {
@@ -250,14 +495,13 @@ TextureHandle WebGL2Backend::createTexture(
                                    desc.width, desc.height, GL_TRUE);
     }
 
-    if (desc.mipmaps && target == GL_TEXTURE_2D) {
+    if (desc.mipmaps && !compressed && target == GL_TEXTURE_2D) {
         glGenerateMipmap(target);
     }
 
     glBindTexture(target, 0);
 
-    uint64_t id = generateHandleId();
-    mTextures[id] = resource;
+    uint64_t id = mTextures.insert(std::move(resource));
 
     return TextureHandle{id};
 }
@@ -281,6 +525,17 @@ void WebGL2Backend::updateTexture(
 
     glBindTexture(target, it->second.glId);
 
+    if (isCompressedFormat(desc.format)) {
+        // Whole blocks only; the default size is that of the level
+        if (w < 0) width = std::max(1, desc.width >> level);
+        if (h < 0) height = std::max(1, desc.height >> level);
+        glCompressedTexSubImage2D(target, level, x, y, width, height,
+                                  toGLInternalFormat(desc.format),
+                                  (GLsizei)compressedImageBytes(desc.format, width, height), data);
+        glBindTexture(target, 0);
+        return;
+    }
+
     GLenum pixelFormat = toGLPixelFormat(desc.format);
     GLenum pixelType = toGLPixelType(desc.format);
 
@@ -289,9 +544,38 @@ void WebGL2Backend::updateTexture(
     glBindTexture(target, 0);
 }
 
+bool WebGL2Backend::supportsTextureFormat(PixelFormat format) const {
+    switch (format) {
+        case PixelFormat::BC1:
+        case PixelFormat::BC3:        return (mCompression & kCompressionS3TC) != 0;
+        case PixelFormat::BC7:        return (mCompression & kCompressionBPTC) != 0;
+        case PixelFormat::ETC2_RGB8:
+        case PixelFormat::ETC2_RGBA8: return (mCompression & kCompressionETC) != 0;
+        case PixelFormat::ASTC_4x4:   return (mCompression & kCompressionASTC) != 0;
+        default:                      return true;
+    }
+}
+
+bool WebGL2Backend::uploadImageBitmap(TextureHandle handle, int bitmapId) {
+#ifdef __EMSCRIPTEN__
+    auto it = mTextures.find(handle.id);
+    if (it == mTextures.end() || it->second.desc.depth > 1) return false;
+
+    glBindTexture(GL_TEXTURE_2D, it->second.glId);
+    bool ok = al_webgl2_tex_image_bitmap(GL_TEXTURE_2D, bitmapId) != 0;
+    if (ok && it->second.desc.mipmaps) glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return ok;
+#else
+    return false;
+#endif
+}
+
 void WebGL2Backend::generateMipmaps(TextureHandle handle) {
     auto it = mTextures.find(handle.id);
     if (it == mTextures.end()) return;
+    // Compressed chains are pre-baked and uploaded level by level
+    if (isCompressedFormat(it->second.desc.format)) return;
 
     GLenum target = GL_TEXTURE_2D;
     glBindTexture(target, it->second.glId);
@@ -352,13 +636,13 @@ RenderTargetHandle WebGL2Backend::createRenderTarget(
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-    uint64_t id = generateHandleId();
-    mRenderTargets[id] = resource;
+    uint64_t id = mRenderTargets.insert(std::move(resource));
 
     return RenderTargetHandle{id};
 }
 
 void WebGL2Backend::bindRenderTarget(RenderTargetHandle handle) {
+    runFlushHook();
     if (!handle.valid()) {
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(0, 0, mWidth, mHeight);
@@ -393,52 +677,48 @@ void WebGL2Backend::destroyRenderTarget(RenderTargetHandle handle) {
 
 ShaderHandle WebGL2Backend::createShader(const ShaderDesc& desc) {
     ShaderResource resource;
-    resource.name = desc.name;
+    submitShader(desc, resource);
+    if (!finishShader(resource)) return {};
 
-    // Create program
-    resource.glProgram = glCreateProgram();
+    uint64_t id = mShaders.insert(std::move(resource));
 
-    // Compile vertex shader
-    if (!desc.vertexSource.empty()) {
-        GLuint vs = glCreateShader(GL_VERTEX_SHADER);
-        if (!compileShader(vs, desc.vertexSource.c_str())) {
-            glDeleteShader(vs);
-            glDeleteProgram(resource.glProgram);
-            return {};
-        }
-        glAttachShader(resource.glProgram, vs);
-        glDeleteShader(vs);
-    }
+    printf("[WebGL2Backend] Created shader '%s'\n", desc.name.c_str());
+    return ShaderHandle{id};
+}
 
-    // Compile fragment shader
-    if (!desc.fragmentSource.empty()) {
-        GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
-        if (!compileShader(fs, desc.fragmentSource.c_str())) {
-            glDeleteShader(fs);
-            glDeleteProgram(resource.glProgram);
-            return {};
-        }
-        glAttachShader(resource.glProgram, fs);
-        glDeleteShader(fs);
-    }
+ShaderHandle WebGL2Backend::createShaderAsync(const ShaderDesc& desc) {
+    ShaderResource resource;
+    submitShader(desc, resource);
+    // Without the extension the first status query blocks anyway, so
+    // there is nothing to gain from deferring it
+    if (!mParallelCompile && !finishShader(resource)) return {};
 
-    // Link program
-    if (!linkProgram(resource.glProgram)) {
-        glDeleteProgram(resource.glProgram);
-        return {};
-    }
+    uint64_t id = mShaders.insert(std::move(resource));
+    return ShaderHandle{id};
+}
 
-    uint64_t id = generateHandleId();
-    mShaders[id] = resource;
+bool WebGL2Backend::isShaderReady(ShaderHandle handle) {
+    auto it = mShaders.find(handle.id);
+    if (it == mShaders.end()) return false;
 
-    printf("[WebGL2Backend] Created shader '%s'\n", desc.name.c_str());
-    return ShaderHandle{id};
+    ShaderResource& shader = it->second;
+    if (!shader.pending) return true;
+
+    GLint done = 0;
+    glGetProgramiv(shader.glProgram, kCompletionStatus, &done);
+    if (!done) return false;
+    if (finishShader(shader)) {
+        printf("[WebGL2Backend] Created shader '%s' (async)\n", shader.name.c_str());
+    }
+    return true;
 }
 
 void WebGL2Backend::destroyShader(ShaderHandle handle) {
     auto it = mShaders.find(handle.id);
     if (it == mShaders.end()) return;
 
+    if (it->second.pendingVertex) glDeleteShader(it->second.pendingVertex);
+    if (it->second.pendingFragment) glDeleteShader(it->second.pendingFragment);
     if (it->second.glProgram) {
         glDeleteProgram(it->second.glProgram);
     }
@@ -446,6 +726,7 @@ void WebGL2Backend::destroyShader(ShaderHandle handle) {
 }
 
 void WebGL2Backend::useShader(ShaderHandle handle) {
+    if (handle.id != mCurrentShader.id) runFlushHook();
     if (!handle.valid()) {
         glUseProgram(0);
         mCurrentShader = {};
@@ -455,29 +736,127 @@ void WebGL2Backend::useShader(ShaderHandle handle) {
     auto it = mShaders.find(handle.id);
     if (it == mShaders.end()) return;
 
+    // Binding a program that is still compiling waits for it here
+    if (it->second.pending) finishShader(it->second);
     glUseProgram(it->second.glProgram);
     mCurrentShader = handle;
 }
 
 // ─── Uniforms ────────────────────────────────────────────────────────────────
 
+// FNV-1a; uniform names are short, so this is cheaper than building a
+// std::string key per call
+static uint32_t hashUniformName(const char* name) {
+    uint32_t h = 2166136261u;
+    for (const char* c = name; *c; c++) {
+        h = (h ^ static_cast<uint8_t>(*c)) * 16777619u;
+    }
+    return h;
+}
+
+void WebGL2Backend::cacheUniformLocations(ShaderResource& shader) {
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(shader.glProgram, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(shader.glProgram, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    if (count <= 0 || maxLength <= 0) return;
+
+    std::vector<char> nameBuffer(maxLength);
+    for (GLuint i = 0; i < static_cast<GLuint>(count); i++) {
+        GLint blockIndex = -1;
+        glGetActiveUniformsiv(shader.glProgram, 1, &i, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+        if (blockIndex != -1) continue;  // Block members have no location
+
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(shader.glProgram, i, maxLength, &length, &size, &type, nameBuffer.data());
+        std::string name(nameBuffer.data(), length);
+        GLint location = glGetUniformLocation(shader.glProgram, name.c_str());
+        if (location < 0) continue;
+
+        shader.uniforms.push_back({hashUniformName(name.c_str()), location, name});
+        // Arrays are reported as "name[0]"; also accept the bare name
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            name.resize(name.size() - 3);
+            shader.uniforms.push_back({hashUniformName(name.c_str()), location, name});
+        }
+    }
+    std::sort(shader.uniforms.begin(), shader.uniforms.end(),
+              [](const UniformSlot& a, const UniformSlot& b) { return a.hash < b.hash; });
+}
+
 GLint WebGL2Backend::getUniformLocation(const char* name) {
     if (!mCurrentShader.valid()) return -1;
 
     auto it = mShaders.find(mCurrentShader.id);
     if (it == mShaders.end()) return -1;
 
-    // Check cache
-    auto& cache = it->second.uniformCache;
-    auto cacheIt = cache.find(name);
-    if (cacheIt != cache.end()) {
-        return cacheIt->second;
+    // Every active uniform was recorded at link time, so a miss means the
+    // program doesn't use it - no GL query needed
+    const auto& uniforms = it->second.uniforms;
+    uint32_t hash = hashUniformName(name);
+    auto slot = std::lower_bound(uniforms.begin(), uniforms.end(), hash,
+        [](const UniformSlot& s, uint32_t h) { return s.hash < h; });
+    for (; slot != uniforms.end() && slot->hash == hash; ++slot) {
+        if (slot->name == name) return slot->location;
+    }
+    return -1;
+}
+
+// ─── Standard Uniform Block ──────────────────────────────────────────────────
+// Offsets (in floats) match WebGPUBackend's uniform layout
+
+static int standardUniformOffset(const char* name, int floats) {
+    if (floats == 16) {
+        if (strcmp(name, "modelViewMatrix") == 0 || strcmp(name, "al_ModelViewMatrix") == 0) return 0;
+        if (strcmp(name, "projectionMatrix") == 0 || strcmp(name, "al_ProjectionMatrix") == 0) return 16;
+    } else if (floats == 4) {
+        if (strcmp(name, "tint") == 0 || strcmp(name, "color") == 0 ||
+            strcmp(name, "col0") == 0) return 32;
+    } else if (floats == 1) {
+        if (strcmp(name, "pointSize") == 0 || strcmp(name, "al_PointSize") == 0) return 36;
+        if (strcmp(name, "eyeSep") == 0 || strcmp(name, "eye_sep") == 0) return 37;
+        if (strcmp(name, "focLen") == 0 || strcmp(name, "foc_len") == 0) return 38;
+    }
+    return -1;
+}
+
+bool WebGL2Backend::currentShaderUsesStandardBlock() const {
+    auto it = mShaders.find(mCurrentShader.id);
+    return it != mShaders.end() && it->second.standardBlock;
+}
+
+bool WebGL2Backend::setStandardUniform(const char* name, const float* value, int floats) {
+    if (!currentShaderUsesStandardBlock()) return false;
+    int offset = standardUniformOffset(name, floats);
+    if (offset < 0) return false;
+
+    float* dst = mStandardUniforms + offset;
+    if (memcmp(dst, value, floats * sizeof(float)) != 0) {
+        memcpy(dst, value, floats * sizeof(float));
+        mStandardUniformsDirty = true;
     }
+    return true;
+}
 
-    // Query and cache
-    GLint loc = glGetUniformLocation(it->second.glProgram, name);
-    cache[name] = loc;
-    return loc;
+void WebGL2Backend::resetStandardUniforms() {
+    // Identity matrices, white tint, pointSize 1, focLen 6 (as on WebGPU)
+    memset(mStandardUniforms, 0, sizeof(mStandardUniforms));
+    for (int i = 0; i < 4; i++) {
+        mStandardUniforms[i * 5] = 1.0f;
+        mStandardUniforms[16 + i * 5] = 1.0f;
+        mStandardUniforms[32 + i] = 1.0f;
+    }
+    mStandardUniforms[36] = 1.0f;
+    mStandardUniforms[38] = 6.0f;
+    mStandardUniformsDirty = true;
+}
+
+void WebGL2Backend::flushStandardUniforms() {
+    if (!mStandardUniformsDirty || !mStandardUbo || !currentShaderUsesStandardBlock()) return;
+    glBindBuffer(GL_UNIFORM_BUFFER, mStandardUbo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, kStandardBlockSize, mStandardUniforms);
+    mStandardUniformsDirty = false;
 }
 
 void WebGL2Backend::setUniform(const char* name, int value) {
@@ -486,6 +865,7 @@ void WebGL2Backend::setUniform(const char* name, int value) {
 }
 
 void WebGL2Backend::setUniform(const char* name, float value) {
+    if (setStandardUniform(name, &value, 1)) return;
     GLint loc = getUniformLocation(name);
     if (loc >= 0) glUniform1f(loc, value);
 }
@@ -501,11 +881,14 @@ void WebGL2Backend::setUniform(const char* name, float x, float y, float z) {
 }
 
 void WebGL2Backend::setUniform(const char* name, float x, float y, float z, float w) {
+    float value[4] = {x, y, z, w};
+    if (setStandardUniform(name, value, 4)) return;
     GLint loc = getUniformLocation(name);
     if (loc >= 0) glUniform4f(loc, x, y, z, w);
 }
 
 void WebGL2Backend::setUniformMat4(const char* name, const float* value) {
+    if (setStandardUniform(name, value, 16)) return;
     GLint loc = getUniformLocation(name);
     if (loc >= 0) glUniformMatrix4fv(loc, 1, GL_FALSE, value);
 }
@@ -537,31 +920,151 @@ void WebGL2Backend::setUniformBuffer(int binding, BufferHandle handle) {
 
 // ─── Drawing ─────────────────────────────────────────────────────────────────
 
+static uint64_t hashVertexLayout(const VertexLayout& layout) {
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+    mix(static_cast<uint64_t>(layout.stride));
+    for (const auto& attr : layout.attributes) {
+        mix(static_cast<uint64_t>(attr.location));
+        mix(static_cast<uint64_t>(attr.components));
+        mix(static_cast<uint64_t>(attr.offset));
+        mix(attr.normalized ? 1 : 0);
+        mix(static_cast<uint64_t>(attr.format));
+    }
+    return h;
+}
+
 void WebGL2Backend::setVertexBuffer(BufferHandle handle, const VertexLayout& layout) {
+    if (mBuffers.find(handle.id) == mBuffers.end()) return;
+
+    mPendingVertexBuffer = handle;
+    mPendingLayout = layout;
+    mPendingLayoutHash = hashVertexLayout(layout);
+}
+
+void WebGL2Backend::setInstanceBuffer(BufferHandle handle, size_t offset) {
+    if (mBuffers.find(handle.id) == mBuffers.end()) {
+        mInstanceBuffer = {};
+        return;
+    }
+    mInstanceBuffer = handle;
+    mInstanceBufferOffset = offset;
+}
+
+bool WebGL2Backend::supportsInstanceBuffer() const {
+    auto it = mShaders.find(mCurrentShader.id);
+    return it != mShaders.end() && it->second.instanceAttributes;
+}
+
+void WebGL2Backend::setIndexBuffer(BufferHandle handle, bool use32Bit) {
     auto it = mBuffers.find(handle.id);
     if (it == mBuffers.end()) return;
 
-    glBindBuffer(GL_ARRAY_BUFFER, it->second.glId);
+    mPendingIndexBuffer = handle;
+    mIndexBuffer32Bit = use32Bit;
+}
+
+// ─── Vertex Arrays ───────────────────────────────────────────────────────────
+
+void WebGL2Backend::bindVertexArray(GLuint vao) {
+    if (vao == mCurrentVao) return;
+    glBindVertexArray(vao);
+    mCurrentVao = vao;
+}
+
+void WebGL2Backend::protectVaoElementBinding(GLenum target) {
+    if (target == GL_ELEMENT_ARRAY_BUFFER && mCurrentVao != mVao) {
+        bindVertexArray(mVao);
+    }
+}
+
+void WebGL2Backend::specifyVertexAttributes(GLuint buffer, const VertexLayout& layout) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
 
     for (const auto& attr : layout.attributes) {
+        GLenum type = GL_FLOAT;
+        bool normalized = attr.normalized;
+        switch (attr.format) {
+            case VertexFormat::Float16: type = GL_HALF_FLOAT; break;
+            case VertexFormat::Snorm16: type = GL_SHORT; normalized = true; break;
+            case VertexFormat::Unorm16: type = GL_UNSIGNED_SHORT; normalized = true; break;
+            case VertexFormat::Snorm8:  type = GL_BYTE; normalized = true; break;
+            case VertexFormat::Unorm8:  type = GL_UNSIGNED_BYTE; normalized = true; break;
+            default: break;
+        }
         glEnableVertexAttribArray(attr.location);
         glVertexAttribPointer(
             attr.location,
             attr.components,
-            GL_FLOAT,
-            attr.normalized ? GL_TRUE : GL_FALSE,
+            type,
+            normalized ? GL_TRUE : GL_FALSE,
             layout.stride,
             reinterpret_cast<const void*>(static_cast<intptr_t>(attr.offset))
         );
+        glVertexAttribDivisor(attr.location, 0);
     }
 }
 
-void WebGL2Backend::setIndexBuffer(BufferHandle handle, bool use32Bit) {
-    auto it = mBuffers.find(handle.id);
-    if (it == mBuffers.end()) return;
+void WebGL2Backend::bindVertexInput(bool indexed) {
+    auto vb = mBuffers.find(mPendingVertexBuffer.id);
+    if (vb == mBuffers.end()) return;
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, it->second.glId);
-    mIndexBuffer32Bit = use32Bit;
+    const BufferResource* ib = nullptr;
+    if (indexed) {
+        auto it = mBuffers.find(mPendingIndexBuffer.id);
+        if (it != mBuffers.end()) ib = &it->second;
+    }
+
+    // Instance pointers carry a per-draw offset, so instanced draws
+    // re-specify everything on the scratch VAO instead of caching
+    auto inst = mBuffers.find(mInstanceBuffer.id);
+    if (inst != mBuffers.end()) {
+        bindVertexArray(mVao);
+        specifyVertexAttributes(vb->second.glId, mPendingLayout);
+
+        uint32_t used = 0;
+        for (const auto& attr : mPendingLayout.attributes) used |= 1u << attr.location;
+
+        // ES 3.0 has no base instance, so the offset goes into the pointers.
+        // Locations 4-7 carry the modelView columns, 8 the tint.
+        glBindBuffer(GL_ARRAY_BUFFER, inst->second.glId);
+        for (GLuint i = 0; i < 5; i++) {
+            GLuint location = kInstanceModelViewLocation + i;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(
+                location, 4, GL_FLOAT, GL_FALSE,
+                sizeof(InstanceAttributes),
+                reinterpret_cast<const void*>(static_cast<intptr_t>(mInstanceBufferOffset + i * 16))
+            );
+            glVertexAttribDivisor(location, 1);
+            used |= 1u << location;
+        }
+
+        for (GLuint location = 0; location < 32; location++) {
+            if ((mScratchAttribMask & ~used) & (1u << location)) {
+                glDisableVertexAttribArray(location);
+                glVertexAttribDivisor(location, 0);
+            }
+        }
+        mScratchAttribMask = used;
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ib ? ib->glId : 0);
+        return;
+    }
+
+    VaoKey key{mPendingVertexBuffer.id, ib ? mPendingIndexBuffer.id : 0, mPendingLayoutHash};
+    auto it = mVaoCache.find(key);
+    if (it != mVaoCache.end()) {
+        bindVertexArray(it->second);
+        return;
+    }
+
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    bindVertexArray(vao);
+    specifyVertexAttributes(vb->second.glId, mPendingLayout);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ib ? ib->glId : 0);
+    mVaoCache.emplace(key, vao);
 }
 
 void WebGL2Backend::draw(
@@ -569,6 +1072,8 @@ void WebGL2Backend::draw(
     int vertexCount,
     int firstVertex
 ) {
+    bindVertexInput(false);
+    flushStandardUniforms();
     glDrawArrays(toGLPrimitive(primitive), firstVertex, vertexCount);
 }
 
@@ -578,6 +1083,8 @@ void WebGL2Backend::drawIndexed(
     int firstIndex,
     int baseVertex
 ) {
+    bindVertexInput(true);
+    flushStandardUniforms();
     GLenum indexType = mIndexBuffer32Bit ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
     size_t indexSize = mIndexBuffer32Bit ? 4 : 2;
 
@@ -608,6 +1115,8 @@ void WebGL2Backend::drawInstanced(
 ) {
     // Note: firstInstance requires GL_ARB_base_instance, not available in ES 3.0
     (void)firstInstance;
+    bindVertexInput(false);
+    flushStandardUniforms();
     glDrawArraysInstanced(toGLPrimitive(primitive), firstVertex, vertexCount, instanceCount);
 }
 
@@ -620,6 +1129,8 @@ void WebGL2Backend::drawIndexedInstanced(
     int firstInstance
 ) {
     (void)firstInstance;
+    bindVertexInput(true);
+    flushStandardUniforms();
     GLenum indexType = mIndexBuffer32Bit ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
     size_t indexSize = mIndexBuffer32Bit ? 4 : 2;
 
@@ -643,6 +1154,113 @@ void WebGL2Backend::drawIndexedInstanced(
     }
 }
 
+// ─── Multi-Draw ──────────────────────────────────────────────────────────────
+
+void WebGL2Backend::setDrawId(int drawId) {
+    auto it = mShaders.find(mCurrentShader.id);
+    if (it != mShaders.end() && it->second.drawIdLocation >= 0) {
+        glUniform1i(it->second.drawIdLocation, drawId);
+    }
+}
+
+void WebGL2Backend::setDrawTransforms(const InstanceAttributes* transforms, int count) {
+    if (!mDrawTransformUbo || count <= 0) return;
+    if (count > kMaxDrawTransforms) {
+        printf("[WebGL2Backend] setDrawTransforms: %d records, only %d used\n",
+               count, kMaxDrawTransforms);
+        count = kMaxDrawTransforms;
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, mDrawTransformUbo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, count * sizeof(InstanceAttributes), transforms);
+}
+
+void WebGL2Backend::multiDraw(
+    PrimitiveType primitive,
+    const int* firsts,
+    const int* counts,
+    int drawCount
+) {
+    multiDrawInstanced(primitive, firsts, counts, nullptr, drawCount);
+}
+
+void WebGL2Backend::multiDrawIndexed(
+    PrimitiveType primitive,
+    const int* firsts,
+    const int* counts,
+    int drawCount
+) {
+    multiDrawIndexedInstanced(primitive, firsts, counts, nullptr, drawCount);
+}
+
+void WebGL2Backend::multiDrawInstanced(
+    PrimitiveType primitive,
+    const int* firsts,
+    const int* counts,
+    const int* instanceCounts,
+    int drawCount
+) {
+    if (drawCount <= 0) return;
+    bindVertexInput(false);
+    flushStandardUniforms();
+    GLenum mode = toGLPrimitive(primitive);
+
+#ifdef __EMSCRIPTEN__
+    if (mMultiDraw) {
+        al_webgl2_multi_draw_arrays(mode, firsts, counts, instanceCounts, drawCount);
+        return;
+    }
+#endif
+    for (int i = 0; i < drawCount; i++) {
+        setDrawId(i);
+        if (instanceCounts) {
+            glDrawArraysInstanced(mode, firsts[i], counts[i], instanceCounts[i]);
+        } else {
+            glDrawArrays(mode, firsts[i], counts[i]);
+        }
+    }
+    setDrawId(0);
+}
+
+void WebGL2Backend::multiDrawIndexedInstanced(
+    PrimitiveType primitive,
+    const int* firsts,
+    const int* counts,
+    const int* instanceCounts,
+    int drawCount
+) {
+    if (drawCount <= 0) return;
+    bindVertexInput(true);
+    flushStandardUniforms();
+    GLenum mode = toGLPrimitive(primitive);
+    GLenum indexType = mIndexBuffer32Bit ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+    size_t indexSize = mIndexBuffer32Bit ? 4 : 2;
+
+    // The extension takes byte offsets rather than first indices
+    mMultiDrawOffsets.resize(drawCount);
+    for (int i = 0; i < drawCount; i++) {
+        mMultiDrawOffsets[i] = static_cast<int32_t>(firsts[i] * indexSize);
+    }
+
+#ifdef __EMSCRIPTEN__
+    if (mMultiDraw) {
+        al_webgl2_multi_draw_elements(mode, counts, indexType, mMultiDrawOffsets.data(),
+                                      instanceCounts, drawCount);
+        return;
+    }
+#endif
+    for (int i = 0; i < drawCount; i++) {
+        setDrawId(i);
+        const void* offset = reinterpret_cast<const void*>(
+            static_cast<intptr_t>(mMultiDrawOffsets[i]));
+        if (instanceCounts) {
+            glDrawElementsInstanced(mode, counts[i], indexType, offset, instanceCounts[i]);
+        } else {
+            glDrawElements(mode, counts[i], indexType, offset);
+        }
+    }
+    setDrawId(0);
+}
+
 // ─── Buffer Operations ───────────────────────────────────────────────────────
 
 void WebGL2Backend::readBuffer(
@@ -655,6 +1273,7 @@ void WebGL2Backend::readBuffer(
     if (it == mBuffers.end()) return;
 
     GLenum target = toGLBufferType(it->second.type);
+    protectVaoElementBinding(target);
     glBindBuffer(target, it->second.glId);
 
     // Map buffer and copy
@@ -718,8 +1337,10 @@ GLenum WebGL2Backend::toGLPixelFormat(PixelFormat format) {
         case PixelFormat::RG32F:
             return GL_RG;
         case PixelFormat::RGB8:
+        case PixelFormat::RGB9E5:
             return GL_RGB;
         case PixelFormat::RGBA8:
+        case PixelFormat::SRGBA8:
         case PixelFormat::RGBA16F:
         case PixelFormat::RGBA32F:
             return GL_RGBA;
@@ -740,12 +1361,20 @@ GLenum WebGL2Backend::toGLInternalFormat(PixelFormat format) {
         case PixelFormat::RG8:          return GL_RG8;
         case PixelFormat::RGB8:         return GL_RGB8;
         case PixelFormat::RGBA8:        return GL_RGBA8;
+        case PixelFormat::SRGBA8:       return GL_SRGB8_ALPHA8;
         case PixelFormat::R16F:         return GL_R16F;
         case PixelFormat::RG16F:        return GL_RG16F;
         case PixelFormat::RGBA16F:      return GL_RGBA16F;
         case PixelFormat::R32F:         return GL_R32F;
         case PixelFormat::RG32F:        return GL_RG32F;
         case PixelFormat::RGBA32F:      return GL_RGBA32F;
+        case PixelFormat::RGB9E5:       return GL_RGB9_E5;
+        case PixelFormat::BC1:          return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case PixelFormat::BC3:          return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case PixelFormat::BC7:          return GL_COMPRESSED_RGBA_BPTC_UNORM_EXT;
+        case PixelFormat::ETC2_RGB8:    return GL_COMPRESSED_RGB8_ETC2;
+        case PixelFormat::ETC2_RGBA8:   return GL_COMPRESSED_RGBA8_ETC2_EAC;
+        case PixelFormat::ASTC_4x4:     return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
         case PixelFormat::Depth16:      return GL_DEPTH_COMPONENT16;
         case PixelFormat::Depth24:      return GL_DEPTH_COMPONENT24;
         case PixelFormat::Depth32F:     return GL_DEPTH_COMPONENT32F;
@@ -760,6 +1389,7 @@ GLenum WebGL2Backend::toGLPixelType(PixelFormat format) {
         case PixelFormat::RG8:
         case PixelFormat::RGB8:
         case PixelFormat::RGBA8:
+        case PixelFormat::SRGBA8:
             return GL_UNSIGNED_BYTE;
         case PixelFormat::R16F:
         case PixelFormat::RG16F:
@@ -770,6 +1400,8 @@ GLenum WebGL2Backend::toGLPixelType(PixelFormat format) {
         case PixelFormat::RGBA32F:
         case PixelFormat::Depth32F:
             return GL_FLOAT;
+        case PixelFormat::RGB9E5:
+            return GL_UNSIGNED_INT_5_9_9_9_REV;
         case PixelFormat::Depth16:
             return GL_UNSIGNED_SHORT;
         case PixelFormat::Depth24:
@@ -804,6 +1436,8 @@ GLenum WebGL2Backend::toGLBlendFactor(BlendMode mode, bool isSrc) {
             return isSrc ? GL_DST_COLOR : GL_ZERO;
         case BlendMode::PreMultiplied:
             return isSrc ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA;
+        case BlendMode::Screen:
+            return isSrc ? GL_ONE : GL_ONE_MINUS_SRC_COLOR;
         default:
             return isSrc ? GL_ONE : GL_ZERO;
     }
@@ -854,32 +1488,88 @@ GLenum WebGL2Backend::toGLWrap(WrapMode mode) {
     }
 }
 
-bool WebGL2Backend::compileShader(GLuint shader, const char* source) {
-    glShaderSource(shader, 1, &source, nullptr);
-    glCompileShader(shader);
+void WebGL2Backend::submitShader(const ShaderDesc& desc, ShaderResource& resource) {
+    resource.name = desc.name;
+    resource.glProgram = glCreateProgram();
+
+    auto submitStage = [&resource](GLenum type, const std::string& source) {
+        GLuint stage = glCreateShader(type);
+        const char* text = source.c_str();
+        glShaderSource(stage, 1, &text, nullptr);
+        glCompileShader(stage);
+        glAttachShader(resource.glProgram, stage);
+        return stage;
+    };
 
-    GLint success;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char log[512];
-        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
-        printf("[WebGL2Backend] Shader compile error: %s\n", log);
-        return false;
+    if (!desc.vertexSource.empty()) {
+        std::string vertexSource = desc.vertexSource;
+        if (vertexSource.find("AL_DRAW_ID") != std::string::npos) {
+            size_t versionEnd = vertexSource.rfind("#version", 0) == 0
+                ? vertexSource.find('\n') : std::string::npos;
+            vertexSource.insert(versionEnd == std::string::npos ? 0 : versionEnd + 1,
+                                kDrawIdPrelude);
+        }
+        resource.pendingVertex = submitStage(GL_VERTEX_SHADER, vertexSource);
     }
-    return true;
+    if (!desc.fragmentSource.empty()) {
+        resource.pendingFragment = submitStage(GL_FRAGMENT_SHADER, desc.fragmentSource);
+    }
+
+    // Instance attributes sit at fixed locations (unless the shader
+    // places them itself), so setInstanceBuffer() works with any program
+    glBindAttribLocation(resource.glProgram, kInstanceModelViewLocation, "al_InstanceModelView");
+    glBindAttribLocation(resource.glProgram, kInstanceTintLocation, "al_InstanceTint");
+
+    glLinkProgram(resource.glProgram);
+    resource.pending = true;
 }
 
-bool WebGL2Backend::linkProgram(GLuint program) {
-    glLinkProgram(program);
+bool WebGL2Backend::finishShader(ShaderResource& resource) {
+    resource.pending = false;
 
-    GLint success;
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success) {
+    GLint linked = 0;
+    glGetProgramiv(resource.glProgram, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // A stage that failed to compile also fails the link; its log is
+        // the useful one
         char log[512];
-        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
-        printf("[WebGL2Backend] Program link error: %s\n", log);
+        for (GLuint stage : {resource.pendingVertex, resource.pendingFragment}) {
+            GLint compiled = 1;
+            if (stage) glGetShaderiv(stage, GL_COMPILE_STATUS, &compiled);
+            if (!compiled) {
+                glGetShaderInfoLog(stage, sizeof(log), nullptr, log);
+                printf("[WebGL2Backend] Shader compile error: %s\n", log);
+            }
+        }
+        glGetProgramInfoLog(resource.glProgram, sizeof(log), nullptr, log);
+        printf("[WebGL2Backend] Program link error in '%s': %s\n", resource.name.c_str(), log);
+    }
+
+    // Stages are flagged for deletion and go away with the program
+    if (resource.pendingVertex) glDeleteShader(resource.pendingVertex);
+    if (resource.pendingFragment) glDeleteShader(resource.pendingFragment);
+    resource.pendingVertex = resource.pendingFragment = 0;
+
+    if (!linked) {
+        glDeleteProgram(resource.glProgram);
+        resource.glProgram = 0;
         return false;
     }
+
+    resource.instanceAttributes =
+        glGetAttribLocation(resource.glProgram, "al_InstanceModelView") == kInstanceModelViewLocation;
+
+    GLuint blockIndex = glGetUniformBlockIndex(resource.glProgram, "al_Uniforms");
+    if (blockIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(resource.glProgram, blockIndex, kStandardBlockBinding);
+        resource.standardBlock = true;
+    }
+    GLuint transformIndex = glGetUniformBlockIndex(resource.glProgram, "al_DrawTransforms");
+    if (transformIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(resource.glProgram, transformIndex, kDrawTransformBinding);
+    }
+    resource.drawIdLocation = glGetUniformLocation(resource.glProgram, "al_DrawID");
+    cacheUniformLocations(resource);
     return true;
 }
 
@@ -30,6 +30,9 @@ void WebGL2Extensions::printCapabilities() {
     std::cout << "S3TC Compression: " << (caps.s3tcCompression ? "Yes" : "No") << std::endl;
     std::cout << "ETC2 Compression: " << (caps.etc2Compression ? "Yes" : "No") << std::endl;
     std::cout << "ASTC Compression: " << (caps.astcCompression ? "Yes" : "No") << std::endl;
+    std::cout << "BPTC Compression: " << (caps.bptcCompression ? "Yes" : "No") << std::endl;
+    std::cout << "Multi-Draw: " << (caps.multiDraw ? "Yes" : "No") << std::endl;
+    std::cout << "Parallel Shader Compile: " << (caps.parallelShaderCompile ? "Yes" : "No") << std::endl;
 
     if (caps.hasDebugInfo) {
         std::cout << "GPU Vendor: " << caps.vendor << std::endl;
@@ -60,6 +63,10 @@ EMSCRIPTEN_KEEPALIVE void al_webgl2_set_capability(int index, int value) {
         case 4: caps.hasDebugInfo = (value != 0); break;
         case 5: caps.s3tcCompression = (value != 0); break;
         case 6: caps.astcCompression = (value != 0); break;
+        case 7: caps.multiDraw = (value != 0); break;
+        case 8: caps.bptcCompression = (value != 0); break;
+        case 9: caps.etc2Compression = (value != 0); break;
+        case 10: caps.parallelShaderCompile = (value != 0); break;
     }
 }
 
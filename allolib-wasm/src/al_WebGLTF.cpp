@@ -10,9 +10,15 @@
 #include "cgltf.h"
 
 #include "al_WebGLTF.hpp"
+#include "al_WebMeshAdapter.hpp"
+#include "al_WebMeshCache.hpp"
+#include "al_WebMeshOptimize.hpp"
+#include "al_WebMeshoptDecode.hpp"
+#include "al_WebResourceCache.hpp"
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdio>
 #include <cstring>
 #include <vector>
@@ -22,6 +28,7 @@
 namespace al {
 
 WebGLTF::~WebGLTF() {
+    cancel();
     if (mData) {
         cgltf_free(mData);
         mData = nullptr;
@@ -192,6 +199,162 @@ bool extractPrimitive(const cgltf_node* node,
     return true;
 }
 
+// ─── Direct-to-interleaved extraction ─────────────────────────────────────
+// parseInterleaved() path: accessors are read straight into the strided
+// InterleavedVertex fields and indices are kept shared, so an asset costs
+// one pass over its buffer views instead of unpack + Mesh + interleave.
+
+// Read an accessor into the float field at fieldOffset of each vertex.
+// Plain float data is copied straight out of the buffer view; normalized
+// integer and sparse accessors go through cgltf's converter. Components
+// beyond the accessor's keep their defaults (e.g. alpha for RGB colors).
+void readAttribute(const cgltf_accessor* acc, size_t fieldComps, size_t fieldOffset,
+                   InterleavedVertex* out, cgltf_size count) {
+    const cgltf_size comps = cgltf_num_components(acc->type);
+    if (comps == 0 || comps > fieldComps) return;
+
+    const uint8_t* src = acc->buffer_view ? cgltf_buffer_view_data(acc->buffer_view) : nullptr;
+    if (src && !acc->is_sparse && acc->component_type == cgltf_component_type_r_32f) {
+        src += acc->offset;
+        for (cgltf_size i = 0; i < count; ++i) {
+            std::memcpy(reinterpret_cast<char*>(&out[i]) + fieldOffset,
+                        src + i * acc->stride, comps * sizeof(float));
+        }
+        return;
+    }
+
+    float tmp[4];
+    for (cgltf_size i = 0; i < count; ++i) {
+        if (cgltf_accessor_read_float(acc, i, tmp, comps)) {
+            std::memcpy(reinterpret_cast<char*>(&out[i]) + fieldOffset, tmp, comps * sizeof(float));
+        }
+    }
+}
+
+bool isIdentity(const float m[16]) {
+    for (int i = 0; i < 16; ++i) {
+        if (m[i] != ((i % 5 == 0) ? 1.0f : 0.0f)) return false;
+    }
+    return true;
+}
+
+// Append one primitive to `out` with its vertices shared as in the source.
+// Same primitive coverage as extractPrimitive(); strips and fans are
+// rewritten as triangle index lists rather than unrolled.
+bool extractPrimitiveInterleaved(const cgltf_node* node,
+                                 const cgltf_primitive* prim,
+                                 InterleavedMesh& out) {
+    if (prim->type != cgltf_primitive_type_triangles &&
+        prim->type != cgltf_primitive_type_triangle_strip &&
+        prim->type != cgltf_primitive_type_triangle_fan) {
+        return false;
+    }
+
+    const cgltf_accessor* posAcc = nullptr;
+    const cgltf_accessor* nrmAcc = nullptr;
+    const cgltf_accessor* uvAcc  = nullptr;
+    const cgltf_accessor* colAcc = nullptr;
+    for (cgltf_size i = 0; i < prim->attributes_count; ++i) {
+        const cgltf_attribute* a = &prim->attributes[i];
+        switch (a->type) {
+            case cgltf_attribute_type_position: if (!posAcc) posAcc = a->data; break;
+            case cgltf_attribute_type_normal:   if (!nrmAcc) nrmAcc = a->data; break;
+            case cgltf_attribute_type_texcoord: if (!uvAcc)  uvAcc  = a->data; break;
+            case cgltf_attribute_type_color:    if (!colAcc) colAcc = a->data; break;
+            default: break;
+        }
+    }
+    if (!posAcc || posAcc->count == 0) return false;
+
+    const cgltf_size vCount = posAcc->count;
+    const size_t base = out.vertices.size();
+    const InterleavedVertex defaults = {
+        {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}
+    };
+    out.vertices.resize(base + vCount, defaults);
+    InterleavedVertex* verts = out.vertices.data() + base;
+
+    readAttribute(posAcc, 3, offsetof(InterleavedVertex, position), verts, vCount);
+    if (nrmAcc && nrmAcc->count == vCount) {
+        readAttribute(nrmAcc, 3, offsetof(InterleavedVertex, normal), verts, vCount);
+    }
+    if (uvAcc && uvAcc->count == vCount) {
+        readAttribute(uvAcc, 2, offsetof(InterleavedVertex, texCoord), verts, vCount);
+    }
+    if (colAcc && colAcc->count == vCount) {
+        readAttribute(colAcc, 4, offsetof(InterleavedVertex, color), verts, vCount);
+    }
+
+    float xform[16];
+    getNodeWorldTransform(node, xform);
+    if (!isIdentity(xform)) {
+        const bool hasNormals = nrmAcc && nrmAcc->count == vCount;
+        for (cgltf_size i = 0; i < vCount; ++i) {
+            float* p = verts[i].position;
+            Vec3f tp = transformPoint(xform, Vec3f(p[0], p[1], p[2]));
+            p[0] = tp.x; p[1] = tp.y; p[2] = tp.z;
+            if (hasNormals) {
+                float* n = verts[i].normal;
+                Vec3f tn = transformNormal(xform, Vec3f(n[0], n[1], n[2]));
+                n[0] = tn.x; n[1] = tn.y; n[2] = tn.z;
+            }
+        }
+    }
+
+    // Indices read in their stored width; out-of-range ones are dropped
+    // with their triangle, as extractPrimitive() does
+    const cgltf_accessor* idxAcc = prim->indices;
+    const uint8_t* idxSrc = (idxAcc && idxAcc->buffer_view && !idxAcc->is_sparse)
+        ? cgltf_buffer_view_data(idxAcc->buffer_view) : nullptr;
+    if (idxSrc) idxSrc += idxAcc->offset;
+    auto getIdx = [&](cgltf_size i) -> cgltf_size {
+        if (!idxAcc) return i;
+        if (!idxSrc) return cgltf_accessor_read_index(idxAcc, i);
+        const uint8_t* e = idxSrc + i * idxAcc->stride;
+        switch (idxAcc->component_type) {
+            case cgltf_component_type_r_8u:  return *e;
+            case cgltf_component_type_r_16u: { uint16_t v; std::memcpy(&v, e, 2); return v; }
+            case cgltf_component_type_r_32u: { uint32_t v; std::memcpy(&v, e, 4); return v; }
+            default: return cgltf_accessor_read_index(idxAcc, i);
+        }
+    };
+    auto triangle = [&](cgltf_size a, cgltf_size b, cgltf_size c) {
+        if (a >= vCount || b >= vCount || c >= vCount) return;
+        out.pushIndex(static_cast<uint32_t>(base + a));
+        out.pushIndex(static_cast<uint32_t>(base + b));
+        out.pushIndex(static_cast<uint32_t>(base + c));
+    };
+
+    const cgltf_size idxCount = idxAcc ? idxAcc->count : vCount;
+    if (prim->type == cgltf_primitive_type_triangles) {
+        for (cgltf_size i = 0; i + 2 < idxCount; i += 3) {
+            triangle(getIdx(i), getIdx(i+1), getIdx(i+2));
+        }
+    } else if (prim->type == cgltf_primitive_type_triangle_strip) {
+        for (cgltf_size i = 0; i + 2 < idxCount; ++i) {
+            if (i % 2 == 0) triangle(getIdx(i), getIdx(i+1), getIdx(i+2));
+            else            triangle(getIdx(i+1), getIdx(i), getIdx(i+2));
+        }
+    } else if (idxCount >= 3) { // triangle_fan
+        const cgltf_size center = getIdx(0);
+        for (cgltf_size i = 1; i + 1 < idxCount; ++i) {
+            triangle(center, getIdx(i), getIdx(i+1));
+        }
+    }
+    return true;
+}
+
+void walkSceneNodeInterleaved(const cgltf_node* node, InterleavedMesh& out) {
+    if (node->mesh) {
+        for (cgltf_size i = 0; i < node->mesh->primitives_count; ++i) {
+            extractPrimitiveInterleaved(node, &node->mesh->primitives[i], out);
+        }
+    }
+    for (cgltf_size i = 0; i < node->children_count; ++i) {
+        walkSceneNodeInterleaved(node->children[i], out);
+    }
+}
+
 // ─── Material extraction (M8.2) ────────────────────────────────────────────
 // Maps cgltf_material → WebGLTFMaterial. Unset texture references stay at
 // index -1 so callers can branch on (mat.baseColorTextureIndex >= 0).
@@ -276,6 +439,133 @@ void walkSceneNode(const cgltf_data* data,
     }
 }
 
+// ─── Progressive loading helpers ───────────────────────────────────────────
+
+// The primitives extractPrimitive() accepts, in walkSceneNode order: these
+// are the primitiveMesh(i) slots, known from the JSON alone.
+const cgltf_accessor* positionAccessor(const cgltf_primitive* prim) {
+    for (cgltf_size i = 0; i < prim->attributes_count; ++i) {
+        if (prim->attributes[i].type == cgltf_attribute_type_position) {
+            return prim->attributes[i].data;
+        }
+    }
+    return nullptr;
+}
+
+void collectPrimitives(const cgltf_node* node,
+                       std::vector<std::pair<const cgltf_node*, const cgltf_primitive*>>& out) {
+    if (node->mesh) {
+        for (cgltf_size i = 0; i < node->mesh->primitives_count; ++i) {
+            const cgltf_primitive* prim = &node->mesh->primitives[i];
+            if (prim->type != cgltf_primitive_type_triangles &&
+                prim->type != cgltf_primitive_type_triangle_strip &&
+                prim->type != cgltf_primitive_type_triangle_fan) continue;
+            if (!positionAccessor(prim)) continue;
+            out.push_back({node, prim});
+        }
+    }
+    for (cgltf_size i = 0; i < node->children_count; ++i) {
+        collectPrimitives(node->children[i], out);
+    }
+}
+
+// cgltf_load_buffers() minus file I/O: binds the GLB chunk and decodes
+// data: URIs, leaving external buffers for the caller to fetch.
+cgltf_result loadInlineBuffers(const cgltf_options* opts, cgltf_data* data) {
+    if (data->buffers_count && !data->buffers[0].data && !data->buffers[0].uri && data->bin) {
+        if (data->bin_size < data->buffers[0].size) return cgltf_result_data_too_short;
+        data->buffers[0].data = (void*)data->bin;
+        data->buffers[0].data_free_method = cgltf_data_free_method_none;
+    }
+    for (cgltf_size i = 0; i < data->buffers_count; ++i) {
+        cgltf_buffer& buf = data->buffers[i];
+        if (buf.data || !buf.uri || std::strncmp(buf.uri, "data:", 5) != 0) continue;
+        const char* comma = std::strchr(buf.uri, ',');
+        if (!comma || comma - buf.uri < 7 || std::strncmp(comma - 7, ";base64", 7) != 0) {
+            return cgltf_result_unknown_format;
+        }
+        cgltf_result r = cgltf_load_buffer_base64(opts, buf.size, comma + 1, &buf.data);
+        buf.data_free_method = cgltf_data_free_method_memory_free;
+        if (r != cgltf_result_success) return r;
+    }
+    return cgltf_result_success;
+}
+
+bool isExternalBuffer(const cgltf_buffer& buf) {
+    return !buf.data && buf.uri && std::strncmp(buf.uri, "data:", 5) != 0;
+}
+
+// Buffer URIs are relative to the .gltf unless absolute
+std::string resolveURI(const std::string& base, const char* uri) {
+    if (uri[0] == '/' || std::strstr(uri, "://")) return uri;
+    size_t slash = base.find_last_of('/');
+    return slash == std::string::npos ? std::string(uri) : base.substr(0, slash + 1) + uri;
+}
+
+bool viewLoaded(const cgltf_buffer_view* view) {
+    if (!view || view->data) return true;
+    if (view->has_meshopt_compression) return false;  // Decoded into view->data
+    return view->buffer && view->buffer->data;
+}
+
+bool accessorLoaded(const cgltf_accessor* acc) {
+    if (!acc) return true;
+    if (!viewLoaded(acc->buffer_view)) return false;
+    return !acc->is_sparse || (viewLoaded(acc->sparse.indices_buffer_view) &&
+                               viewLoaded(acc->sparse.values_buffer_view));
+}
+
+bool primitiveLoaded(const cgltf_primitive* prim) {
+    for (cgltf_size i = 0; i < prim->attributes_count; ++i) {
+        if (!accessorLoaded(prim->attributes[i].data)) return false;
+    }
+    return accessorLoaded(prim->indices);
+}
+
+// World-space box around the POSITION accessor's min/max (required by the
+// glTF spec, so present before any buffer has arrived)
+bool primitiveWorldBounds(const cgltf_node* node, const cgltf_primitive* prim,
+                          Vec3f& mn, Vec3f& mx) {
+    const cgltf_accessor* pos = positionAccessor(prim);
+    if (!pos || !pos->has_min || !pos->has_max) return false;
+    float xform[16];
+    getNodeWorldTransform(node, xform);
+    for (int c = 0; c < 8; ++c) {
+        Vec3f p(c & 1 ? pos->max[0] : pos->min[0],
+                c & 2 ? pos->max[1] : pos->min[1],
+                c & 4 ? pos->max[2] : pos->min[2]);
+        p = transformPoint(xform, p);
+        if (c == 0) { mn = mx = p; continue; }
+        for (int k = 0; k < 3; ++k) {
+            mn[k] = std::min(mn[k], p[k]);
+            mx[k] = std::max(mx[k], p[k]);
+        }
+    }
+    return true;
+}
+
+// Placeholder geometry: the bounds as 12 TRIANGLES with face normals
+void appendBox(const Vec3f& mn, const Vec3f& mx, Mesh& out) {
+    out.primitive(Mesh::TRIANGLES);
+    auto corner = [&](int c) {
+        return Vec3f(c & 1 ? mx.x : mn.x, c & 2 ? mx.y : mn.y, c & 4 ? mx.z : mn.z);
+    };
+    // Corners of each face, counter-clockwise seen from outside
+    static const int faces[6][4] = {
+        {0, 4, 6, 2}, {1, 3, 7, 5},   // -X, +X
+        {0, 1, 5, 4}, {2, 6, 7, 3},   // -Y, +Y
+        {0, 2, 3, 1}, {4, 5, 7, 6}};  // -Z, +Z
+    static const float normals[6][3] = {
+        {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}};
+    for (int f = 0; f < 6; ++f) {
+        const int* q = faces[f];
+        for (int v : {q[0], q[1], q[2], q[0], q[2], q[3]}) {
+            out.vertex(corner(v));
+            out.normal(normals[f][0], normals[f][1], normals[f][2]);
+        }
+    }
+}
+
 } // anonymous namespace
 
 // ─── WebGLTF impl ──────────────────────────────────────────────────────────
@@ -366,42 +656,220 @@ bool WebGLTF::parse(const uint8_t* data, size_t size, Mesh& out) {
         cgltf_free(parsed);
         return false;
     }
+    if (!MeshoptDecoder::decodeGLTF(parsed)) {
+        cgltf_free(parsed);
+        return false;
+    }
     if (cgltf_validate(parsed) != cgltf_result_success) {
         std::printf("[WebGLTF] cgltf_validate failed\n");
     }
 
     bool ok = extractAllPrimitives(parsed, out, nullptr, nullptr);
     cgltf_free(parsed);
-    std::printf("[WebGLTF] parsed: %zu vertices, %zu normals, %zu texcoords\n",
+    if (ok && MeshOptimizer::autoOptimize()) MeshOptimizer::optimize(out);
+    std::printf("[WebGLTF] parsed: %zu vertices, %zu normals, %zu texcoords, %zu indices\n",
                 out.vertices().size(), out.normals().size(),
-                out.texCoord2s().size());
+                out.texCoord2s().size(), out.indices().size());
     return ok;
 }
 
-bool WebGLTF::parseAndRetain(const uint8_t* data, size_t size) {
-    if (mData) { cgltf_free(mData); mData = nullptr; }
-
+bool WebGLTF::parseInterleaved(const uint8_t* data, size_t size, InterleavedMesh& out) {
     cgltf_options opts{};
-    cgltf_result r = cgltf_parse(&opts, data, size, &mData);
+    cgltf_data* parsed = nullptr;
+    cgltf_result r = cgltf_parse(&opts, data, size, &parsed);
     if (r != cgltf_result_success) {
         std::printf("[WebGLTF] cgltf_parse failed: %d\n", (int)r);
         return false;
     }
-    r = cgltf_load_buffers(&opts, mData, nullptr);
+    r = cgltf_load_buffers(&opts, parsed, nullptr);
     if (r != cgltf_result_success) {
         std::printf("[WebGLTF] cgltf_load_buffers failed: %d\n", (int)r);
-        cgltf_free(mData); mData = nullptr;
+        cgltf_free(parsed);
         return false;
     }
-    cgltf_validate(mData); // log-only
+    if (!MeshoptDecoder::decodeGLTF(parsed)) {
+        cgltf_free(parsed);
+        return false;
+    }
+    if (cgltf_validate(parsed) != cgltf_result_success) {
+        std::printf("[WebGLTF] cgltf_validate failed\n");
+    }
+
+    out.clear();
+    out.primitive = Mesh::TRIANGLES;
+
+    // Size the vertex array once: every position accessor is read anyway
+    size_t vertexTotal = 0;
+    for (cgltf_size i = 0; i < parsed->meshes_count; ++i) {
+        for (cgltf_size j = 0; j < parsed->meshes[i].primitives_count; ++j) {
+            const cgltf_primitive& prim = parsed->meshes[i].primitives[j];
+            for (cgltf_size k = 0; k < prim.attributes_count; ++k) {
+                if (prim.attributes[k].type == cgltf_attribute_type_position) {
+                    vertexTotal += prim.attributes[k].data->count;
+                    break;
+                }
+            }
+        }
+    }
+    out.vertices.reserve(vertexTotal);
+
+    const cgltf_scene* scene = parsed->scene
+        ? parsed->scene
+        : (parsed->scenes_count > 0 ? &parsed->scenes[0] : nullptr);
+    if (scene) {
+        for (cgltf_size i = 0; i < scene->nodes_count; ++i) {
+            walkSceneNodeInterleaved(scene->nodes[i], out);
+        }
+    } else {
+        for (cgltf_size i = 0; i < parsed->nodes_count; ++i) {
+            if (parsed->nodes[i].parent == nullptr) {
+                walkSceneNodeInterleaved(&parsed->nodes[i], out);
+            }
+        }
+    }
+    cgltf_free(parsed);
+
+    out.computeBounds();
+    out.version++;
+    std::printf("[WebGLTF] parsed interleaved: %zu vertices, %zu %d-bit indices\n",
+                out.vertices.size(), out.indexCount(), out.wideIndices ? 32 : 16);
+    return !out.vertices.empty();
+}
+
+bool WebGLTF::parseCached(const uint8_t* data, size_t size, MeshBundle& out, int lodLevels) {
+    uint64_t settings = 0x474C5400u | (uint32_t)lodLevels;  // "GLT" + levels
+    return WebMeshCache::loadOrBuild(data, size, settings, out, [&](MeshBundle& bundle) {
+        if (lodLevels > 1) {
+            Mesh mesh;
+            if (!parse(data, size, mesh)) return false;
+            WebMeshCache::build(mesh, bundle, lodLevels);
+            return true;
+        }
+        InterleavedMesh mesh;
+        if (!parseInterleaved(data, size, mesh)) return false;
+        WebMeshCache::build(std::move(mesh), bundle);
+        return true;
+    });
+}
+
+bool WebGLTF::parseAndRetain(const uint8_t* data, size_t size) {
+    if (!retain(data, size)) return false;
+    for (cgltf_size i = 0; i < mData->buffers_count; ++i) {
+        if (isExternalBuffer(mData->buffers[i])) {
+            std::printf("[WebGLTF] external buffer %s needs load(url)\n", mData->buffers[i].uri);
+            return false;
+        }
+    }
+    return finishRetain();
+}
 
+// ─── Progressive loading ───────────────────────────────────────────────────
+// retain() parses the JSON and binds the buffers already in hand (GLB chunk,
+// data: URIs), giving every primitive a placeholder. load() then fetches the
+// external buffers; as each arrives, promoteReadyPrimitives() extracts the
+// primitives whose accessors are now all backed, and finishRetain() does the
+// whole-asset work (images, skins, animations) once the last one is in.
+
+bool WebGLTF::retain(const uint8_t* data, size_t size) {
+    if (mData) { cgltf_free(mData); mData = nullptr; }
+    mReady = false;
+    mCombined.reset();
+    mCombined.primitive(Mesh::TRIANGLES);
+    mAnimated.reset();
     mPrimitives.clear();
     mMaterials.clear();
     mImages.clear();
     mAnimations.clear();
     mSkins.clear();
     mCache.clear();
-    bool ok = extractAllPrimitives(mData, mCombined, &mPrimitives, &mMaterials);
+    mSlots.clear();
+    mReadyCount = 0;
+
+    cgltf_options opts{};
+    cgltf_result r = cgltf_parse(&opts, data, size, &mData);
+    if (r != cgltf_result_success) {
+        std::printf("[WebGLTF] cgltf_parse failed: %d\n", (int)r);
+        return false;
+    }
+    r = loadInlineBuffers(&opts, mData);
+    if (r != cgltf_result_success) {
+        std::printf("[WebGLTF] cgltf_load_buffers failed: %d\n", (int)r);
+        cgltf_free(mData); mData = nullptr;
+        return false;
+    }
+    if (!MeshoptDecoder::decodeGLTF(mData, true)) {
+        cgltf_free(mData); mData = nullptr;
+        return false;
+    }
+
+    std::vector<std::pair<const cgltf_node*, const cgltf_primitive*>> prims;
+    const cgltf_scene* scene = mData->scene
+        ? mData->scene
+        : (mData->scenes_count > 0 ? &mData->scenes[0] : nullptr);
+    if (scene) {
+        for (cgltf_size i = 0; i < scene->nodes_count; ++i) {
+            collectPrimitives(scene->nodes[i], prims);
+        }
+    } else {
+        for (cgltf_size i = 0; i < mData->nodes_count; ++i) {
+            if (mData->nodes[i].parent == nullptr) collectPrimitives(&mData->nodes[i], prims);
+        }
+    }
+
+    mSlots.resize(prims.size());
+    mPrimitives.resize(prims.size());
+    mMaterials.reserve(prims.size());
+    for (size_t i = 0; i < prims.size(); ++i) {
+        PrimitiveSlot& slot = mSlots[i];
+        slot.node = prims[i].first;
+        slot.prim = prims[i].second;
+        if (primitiveWorldBounds(slot.node, slot.prim, slot.min, slot.max)) {
+            appendBox(slot.min, slot.max, mPrimitives[i]);
+        }
+        mMaterials.push_back(extractMaterial(mData, slot.prim->material));
+    }
+    return true;
+}
+
+void WebGLTF::promoteReadyPrimitives() {
+    for (size_t i = 0; i < mSlots.size(); ++i) {
+        PrimitiveSlot& slot = mSlots[i];
+        if (slot.ready || !primitiveLoaded(slot.prim)) continue;
+
+        Mesh m;
+        extractPrimitive(slot.node, slot.prim, m);
+        // Appended unoptimized; finishRetain() optimizes the combined mesh once
+        extractPrimitive(slot.node, slot.prim, mCombined);
+        if (MeshOptimizer::autoOptimize()) MeshOptimizer::optimize(m);
+
+        // Tighten the placeholder bounds to the real geometry
+        const auto& verts = m.vertices();
+        if (!verts.empty()) {
+            slot.min = slot.max = verts[0];
+            for (const auto& v : verts) {
+                for (int k = 0; k < 3; ++k) {
+                    slot.min[k] = std::min(slot.min[k], v[k]);
+                    slot.max[k] = std::max(slot.max[k], v[k]);
+                }
+            }
+        }
+        mPrimitives[i] = std::move(m);
+        slot.ready = true;
+        mReadyCount++;
+        if (mPrimitiveCallback) mPrimitiveCallback(i);
+    }
+}
+
+bool WebGLTF::finishRetain() {
+    if (!MeshoptDecoder::decodeGLTF(mData)) return false;
+    cgltf_validate(mData); // log-only
+
+    promoteReadyPrimitives();
+    bool ok = mCombined.vertices().size() > 0;
+    if (ok && MeshOptimizer::autoOptimize()) {
+        // Static draws only; rebuildAnimatedMesh() re-emits from the cache
+        MeshOptimizer::optimize(mCombined);
+    }
     extractImages(mData, mImages);
     buildSkinCache();
 
@@ -441,9 +909,48 @@ bool WebGLTF::parseAndRetain(const uint8_t* data, size_t size) {
     std::printf("[WebGLTF] extracted: %zu primitives, %zu materials, %zu images, %zu animations, %zu skins\n",
                 mPrimitives.size(), mMaterials.size(), mImages.size(),
                 mAnimations.size(), mSkins.size());
+    if (!mCombined.indices().empty()) {
+        std::printf("[WebGLTF] combined mesh ACMR %.2f\n",
+                    MeshOptimizer::acmr(mCombined.indices(), (int)mCombined.vertices().size()));
+    }
     return ok;
 }
 
+void WebGLTF::onBufferLoaded(size_t index, const UploadedFile& file) {
+    mPendingBuffers--;
+    cgltf_buffer& buf = mData->buffers[index];
+    if (file.data.size() < buf.size) {
+        std::printf("[WebGLTF] Buffer %s: got %zu of %zu bytes\n",
+                    buf.uri, file.data.size(), (size_t)buf.size);
+        mBufferFailed = true;
+    } else if (!mBufferFailed) {
+        // cgltf_free releases it through the asset's allocator
+        buf.data = mData->memory.alloc_func(mData->memory.user_data, buf.size);
+        std::memcpy(buf.data, file.data.data(), buf.size);
+        buf.data_free_method = cgltf_data_free_method_memory_free;
+        mStreamBytesLoaded += buf.size;
+
+        if (MeshoptDecoder::decodeGLTF(mData, true)) {
+            promoteReadyPrimitives();
+            std::printf("[WebGLTF] Buffer %s: %zu/%zu primitives ready\n",
+                        buf.uri, mReadyCount, mPrimitives.size());
+        } else {
+            mBufferFailed = true;
+        }
+    }
+    if (mPendingBuffers > 0) return;
+
+    mBufferTickets.clear();
+    finishLoad(!mBufferFailed && finishRetain());
+}
+
+void WebGLTF::finishLoad(bool ok) {
+    if (ok) std::printf("[WebGLTF] Loaded: %s (%zu primitives)\n",
+                        mUrl.c_str(), mPrimitives.size());
+    else    std::printf("[WebGLTF] Failed to load: %s\n", mUrl.c_str());
+    if (mCallback) mCallback(ok);
+}
+
 // ─── M8.3 sampleAnimation impl ────────────────────────────────────────────
 // Linear interpolation only (covers >95% of real-world glTF; cubic spline
 // is a future extension). CPU skinning — each call rebuilds mAnimated from
@@ -889,26 +1396,121 @@ void WebGLTF::rebuildAnimatedMesh() {
 }
 
 void WebGLTF::load(const std::string& url) {
+    cancel();
     mReady = false;
     mUrl = url;
     mCombined.reset();
     mPrimitives.clear();
     mMaterials.clear();
     mImages.clear();
+    mSlots.clear();
+    mReadyCount = 0;
+    mBufferFailed = false;
+    mStreamBytesTotal = mStreamBytesLoaded = 0;
     if (mData) { cgltf_free(mData); mData = nullptr; }
 
-    WebFile::loadFromURL(url, [this](const UploadedFile& file) {
-        bool ok = parseAndRetain(file.data.data(), file.data.size());
-        if (ok) std::printf("[WebGLTF] Loaded: %s (%zu primitives)\n",
-                            mUrl.c_str(), mPrimitives.size());
-        else    std::printf("[WebGLTF] Failed to load: %s\n", mUrl.c_str());
-        if (mCallback) mCallback(ok);
+    mTicket = AssetLoader::instance().fetch(url, mPriority, [this](const UploadedFile& file) {
+        mTicket = 0;
+        if (file.data.empty()) {
+            finishLoad(false);
+            return;
+        }
+        // Parse (and for self-contained files, extract everything) into a
+        // staging asset on the job pool; the main thread then takes it over
+        auto staged = std::make_shared<WebGLTF>();
+        mJob = JobSystem::instance().submit(
+            [bytes = file.data, staged] {
+                if (!staged->retain(bytes.data(), bytes.size())) return false;
+                for (cgltf_size i = 0; i < staged->mData->buffers_count; ++i) {
+                    if (isExternalBuffer(staged->mData->buffers[i])) return true;
+                }
+                staged->finishRetain();
+                return true;
+            },
+            [this, staged](bool& ok) {
+                mJob = JobFuture<bool>();
+                if (!ok) {
+                    finishLoad(false);
+                    return;
+                }
+                adopt(*staged);
+                onRetained();
+            });
     });
 }
 
+// Move a staging asset's parsed state (load()'s job) into this one
+void WebGLTF::adopt(WebGLTF& staged) {
+    if (mData) cgltf_free(mData);
+    mData = staged.mData;
+    staged.mData = nullptr;
+    mCombined = std::move(staged.mCombined);
+    mAnimated = std::move(staged.mAnimated);
+    mPrimitives = std::move(staged.mPrimitives);
+    mMaterials = std::move(staged.mMaterials);
+    mImages = std::move(staged.mImages);
+    mAnimations = std::move(staged.mAnimations);
+    mSkins = std::move(staged.mSkins);
+    mCache = std::move(staged.mCache);
+    mSlots = std::move(staged.mSlots);
+    mReadyCount = staged.mReadyCount;
+    mReady = staged.mReady;
+}
+
+// load(), once the file is parsed: finish, or fetch its external buffers
+void WebGLTF::onRetained() {
+    std::vector<size_t> external;
+    for (cgltf_size i = 0; i < mData->buffers_count; ++i) {
+        if (isExternalBuffer(mData->buffers[i])) {
+            external.push_back(i);
+            mStreamBytesTotal += mData->buffers[i].size;
+        }
+    }
+    if (external.empty()) {
+        // The job ran finishRetain(); report what it extracted
+        for (size_t i = 0; i < mSlots.size(); ++i) {
+            if (mSlots[i].ready && mPrimitiveCallback) mPrimitiveCallback(i);
+        }
+        finishLoad(mReady);
+        return;
+    }
+
+    // Primitives backed by the GLB chunk or data: URIs draw right away
+    promoteReadyPrimitives();
+    std::printf("[WebGLTF] %s: %zu primitives, streaming %zu buffers (%zu KB)\n",
+                mUrl.c_str(), mPrimitives.size(), external.size(), mStreamBytesTotal / 1024);
+    mPendingBuffers = external.size();
+    for (size_t index : external) {
+        std::string bufferUrl = resolveURI(mUrl, mData->buffers[index].uri);
+        mBufferTickets.push_back(AssetLoader::instance().fetch(bufferUrl, mPriority,
+            [this, index](const UploadedFile& buffer) { onBufferLoaded(index, buffer); }));
+    }
+}
+
+void WebGLTF::setPriority(float priority) {
+    mPriority = priority;
+    AssetLoader::instance().setPriority(mTicket, priority);
+    for (auto ticket : mBufferTickets) AssetLoader::instance().setPriority(ticket, priority);
+}
+
+void WebGLTF::cancel() {
+    mJob.cancel();
+    mJob = JobFuture<bool>();
+    if (mTicket) AssetLoader::instance().cancel(mTicket);
+    for (auto ticket : mBufferTickets) AssetLoader::instance().cancel(ticket);
+    mTicket = 0;
+    mBufferTickets.clear();
+    mPendingBuffers = 0;
+}
+
 void WebGLTF::load(const std::string& url, LoadCallback cb) {
     mCallback = std::move(cb);
     load(url);
 }
 
+std::string WebGLTF::imageKey(size_t i) const {
+    const WebGLTFImage& img = mImages.at(i);
+    return GPUResourceCache::contentKey(img.bytes.data(), img.bytes.size(), "gltf-image:");
+}
+
 } // namespace al
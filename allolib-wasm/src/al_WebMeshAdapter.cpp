@@ -3,6 +3,9 @@
  */
 
 #include "al_WebMeshAdapter.hpp"
+#include "al_WebProfiler.hpp"
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <cstdio>
 
@@ -20,129 +23,352 @@ void WebMeshAdapter::setBackend(GraphicsBackend* backend) {
     }
 }
 
+// Widen [first, last) by the elements of an attribute that differ from its
+// shadow copy, then refresh the shadow. Elements past `limit` (the vertex
+// count) are never uploaded, so they don't count as dirty.
+static void diffAttribute(const void* data, size_t count, size_t elemSize,
+                          std::vector<char>& shadow, size_t limit,
+                          size_t& first, size_t& last) {
+    const char* bytes = static_cast<const char*>(data);
+    size_t oldCount = shadow.size() / elemSize;
+    size_t common = std::min(oldCount, count);
+
+    auto widen = [&](size_t begin, size_t end) {
+        end = std::min(end, limit);
+        if (begin >= end) return;
+        first = std::min(first, begin);
+        last = std::max(last, end);
+    };
+
+    bool changed = (count != oldCount);
+    if (common > 0 && memcmp(bytes, shadow.data(), common * elemSize) != 0) {
+        changed = true;
+        size_t lo = 0;
+        while (memcmp(bytes + lo * elemSize, shadow.data() + lo * elemSize, elemSize) == 0) lo++;
+        size_t hi = common;
+        while (memcmp(bytes + (hi - 1) * elemSize, shadow.data() + (hi - 1) * elemSize, elemSize) == 0) hi--;
+        widen(lo, hi);
+    }
+    if (count > oldCount) {
+        widen(oldCount, count);      // New elements
+    } else if (count < oldCount) {
+        widen(count, oldCount);      // Attribute shrank: those vertices fall back to defaults
+    }
+
+    if (changed) {
+        shadow.assign(bytes, bytes + count * elemSize);
+    }
+}
+
+// Arena usage past which prepareMesh() recycles it by itself
+static constexpr size_t kArenaAutoResetBytes = 64 * 1024 * 1024;
+
+static size_t growCapacity(size_t current, size_t needed) {
+    size_t capacity = std::max<size_t>(current, 64);
+    while (capacity < needed) capacity *= 2;
+    return capacity;
+}
+
 bool WebMeshAdapter::prepareMesh(const Mesh& mesh) {
     if (!mBackend) return false;
 
-    const Mesh* meshPtr = &mesh;
-    mCurrentMesh = meshPtr;
+    // Nothing from the arena outlives a prepareMesh() call, so a caller
+    // that never calls beginFrame() can't make it grow without bound
+    if (mArena.used() > kArenaAutoResetBytes) {
+        mArena.reset();
+    }
 
-    // Check if mesh is in cache
-    auto it = mCache.find(meshPtr);
+    mCurrentMesh = &mesh;
 
-    // Get current mesh state for version check
     size_t vertCount = mesh.vertices().size();
     size_t indexCount = mesh.indices().size();
 
-    // Simple version check - could use mesh's version counter if available
-    uint32_t currentVersion = static_cast<uint32_t>(vertCount + indexCount * 1000);
+    bool isNew = false;
+    MeshCacheEntry& entry = acquireEntry(&mesh, mesh.primitive(), vertCount, isNew);
+    if (entry.indexSize != sizeof(uint32_t)) {
+        // Address last held an InterleavedMesh with 16-bit indices
+        if (entry.indexBuffer.valid()) mBackend->destroyBuffer(entry.indexBuffer);
+        mTotalBufferMemory -= entry.indexCapacity * entry.indexSize;
+        entry.indexBuffer = {};
+        entry.indexCapacity = 0;
+        entry.indexSize = sizeof(uint32_t);
+    }
+    entry.sourceVersion = 0;
 
-    if (it != mCache.end()) {
-        // Check if mesh needs updating
-        if (it->second.meshVersion == currentVersion &&
-            it->second.vertexCount == vertCount &&
-            it->second.originalPrimitive == mesh.primitive()) {
-            // Cache hit - buffers are up to date
-            return true;
-        }
+    if (!isNew && !mContentTracking &&
+        entry.positions.size() == vertCount * sizeof(Vec3f) &&
+        entry.indices.size() == indexCount * sizeof(unsigned int)) {
+        // Size-only tracking - unchanged counts mean a cache hit
+        return entry.vertexBuffer.valid() && entry.vertexCount > 0;
+    }
 
-        // Mesh changed - destroy old buffers
-        if (it->second.vertexBuffer.valid()) {
-            mBackend->destroyBuffer(it->second.vertexBuffer);
-            mTotalBufferMemory -= it->second.vertexCount * sizeof(InterleavedVertex);
+    // Find the vertex range touched by any attribute
+    size_t vFirst = SIZE_MAX, vLast = 0;
+    diffAttribute(mesh.vertices().data(), vertCount, sizeof(Vec3f),
+                  entry.positions, vertCount, vFirst, vLast);
+    diffAttribute(mesh.colors().data(), mesh.colors().size(), sizeof(Color),
+                  entry.colors, vertCount, vFirst, vLast);
+    diffAttribute(mesh.texCoord2s().data(), mesh.texCoord2s().size(), sizeof(Vec2f),
+                  entry.texCoords, vertCount, vFirst, vLast);
+    diffAttribute(mesh.normals().data(), mesh.normals().size(), sizeof(Vec3f),
+                  entry.normals, vertCount, vFirst, vLast);
+
+    size_t iFirst = SIZE_MAX, iLast = 0;
+    diffAttribute(mesh.indices().data(), indexCount, sizeof(unsigned int),
+                  entry.indices, indexCount, iFirst, iLast);
+
+    if (vFirst < vLast || vertCount > entry.vertexCapacity) {
+        AL_PROFILE_ZONE("mesh upload");
+        uploadVertices(entry, mesh, vFirst, vLast);
+        entry.opaque = true;
+        for (const Color& c : mesh.colors()) {
+            if (c.a < 1.0f) { entry.opaque = false; break; }
         }
-        if (it->second.indexBuffer.valid()) {
-            mBackend->destroyBuffer(it->second.indexBuffer);
-            mTotalBufferMemory -= it->second.indexCount * sizeof(uint32_t);
-        }
-        mCache.erase(it);
     }
+    entry.vertexCount = vertCount;
 
-    // Create new cache entry
-    MeshCacheEntry entry;
-    entry.meshVersion = currentVersion;
-    entry.layout = createVertexLayout();
-    entry.originalPrimitive = mesh.primitive();
-    printf("[WebMeshAdapter::prepareMesh] Original primitive=%d (TRIANGLE_FAN=6), vertices=%zu\n",
-           static_cast<int>(mesh.primitive()), mesh.vertices().size());
-
-    // Create interleaved vertex data
-    std::vector<InterleavedVertex> interleavedData;
-    createInterleavedData(mesh, interleavedData);
-
-    // Check if we need to convert unsupported primitives (TRIANGLE_FAN, LINE_LOOP)
-    bool needsConversion = needsPrimitiveConversion(mesh.primitive());
-    printf("[WebMeshAdapter::prepareMesh] needsConversion=%d\n", needsConversion ? 1 : 0);
+    // Check if we need to convert unsupported primitives (TRIANGLE_FAN, LINE_LOOP).
+    // Non-indexed ones are drawn as-is: the backend expands them with its
+    // shared conversion index buffers, so vertices aren't duplicated here.
+    bool needsConversion = needsPrimitiveConversion(mesh.primitive()) && indexCount > 0;
     if (needsConversion) {
-        std::vector<InterleavedVertex> convertedVertices;
-        std::vector<uint32_t> convertedIndices;
-
-        entry.convertedPrimitive = convertPrimitive(
-            mesh.primitive(),
-            interleavedData,
-            mesh.indices(),
-            convertedVertices,
-            convertedIndices
-        );
-
-        // Use converted data
-        entry.vertexCount = convertedVertices.size();
-        entry.indexCount = convertedIndices.size();
-        entry.hasIndices = !convertedIndices.empty();
-
-        // Create vertex buffer with converted data
-        if (!convertedVertices.empty()) {
-            entry.vertexBuffer = mBackend->createBuffer(
-                BufferType::Vertex,
-                BufferUsage::Dynamic,
-                convertedVertices.data(),
-                convertedVertices.size() * sizeof(InterleavedVertex)
-            );
-            mTotalBufferMemory += convertedVertices.size() * sizeof(InterleavedVertex);
-        }
-
-        // Create index buffer if needed
-        if (entry.hasIndices) {
-            entry.indexBuffer = mBackend->createBuffer(
-                BufferType::Index,
-                BufferUsage::Dynamic,
-                convertedIndices.data(),
-                convertedIndices.size() * sizeof(uint32_t)
+        if (iFirst < iLast || isNew) {
+            // Converted indices don't map 1:1 onto the source, rewrite all
+            uint32_t* convertedIndices = nullptr;
+            size_t convertedCount = 0;
+            entry.convertedPrimitive = convertPrimitive(
+                mesh.primitive(),
+                mesh.indices(),
+                convertedIndices,
+                convertedCount
             );
-            mTotalBufferMemory += convertedIndices.size() * sizeof(uint32_t);
+            uploadIndices(entry, convertedIndices, convertedCount, 0, convertedCount);
+            entry.indexCount = convertedCount;
         }
     } else {
         // No conversion needed - use original primitive
         entry.convertedPrimitive = meshPrimitiveToPrimitiveType(mesh.primitive());
-        entry.vertexCount = vertCount;
+        if (iFirst < iLast) {
+            uploadIndices(entry, mesh.indices().data(), indexCount, iFirst, iLast);
+        }
         entry.indexCount = indexCount;
-        entry.hasIndices = indexCount > 0;
-
-        // Create vertex buffer
-        if (!interleavedData.empty()) {
-            entry.vertexBuffer = mBackend->createBuffer(
-                BufferType::Vertex,
-                BufferUsage::Dynamic,
-                interleavedData.data(),
-                interleavedData.size() * sizeof(InterleavedVertex)
-            );
-            mTotalBufferMemory += interleavedData.size() * sizeof(InterleavedVertex);
+    }
+    entry.hasIndices = entry.indexCount > 0;
+
+    return entry.vertexBuffer.valid() && entry.vertexCount > 0;
+}
+
+MeshCacheEntry& WebMeshAdapter::acquireEntry(const void* key, Mesh::Primitive primitive,
+                                             size_t vertexCount, bool& isNew) {
+    auto it = mCache.find(key);
+    isNew = (it == mCache.end());
+    if (!isNew && (it->second.originalPrimitive != primitive ||
+                   it->second.compression != mCompression)) {
+        // Primitive or storage layout changed - start over
+        releaseEntry(it->second);
+        mCache.erase(it);
+        isNew = true;
+    }
+
+    if (isNew) {
+        MeshCacheEntry entry;
+        entry.layout = createVertexLayout(mCompression);
+        entry.compression = mCompression;
+        if (mCompression == VertexCompression::Quantized) {
+            entry.positionScale = 0.0f;  // Fitted on first upload
         }
+        entry.originalPrimitive = primitive;
+        printf("[WebMeshAdapter::prepareMesh] Original primitive=%d (TRIANGLE_FAN=6), vertices=%zu\n",
+               static_cast<int>(primitive), vertexCount);
+        it = mCache.emplace(key, std::move(entry)).first;
+    }
+    it->second.lastUsedFrame = mFrame;
+    return it->second;
+}
 
-        // Create index buffer if needed
-        if (entry.hasIndices) {
-            const auto& indices = mesh.indices();
-            entry.indexBuffer = mBackend->createBuffer(
-                BufferType::Index,
-                BufferUsage::Dynamic,
-                indices.data(),
-                indices.size() * sizeof(uint32_t)
-            );
-            mTotalBufferMemory += indices.size() * sizeof(uint32_t);
+bool WebMeshAdapter::prepareInterleaved(const InterleavedMesh& mesh) {
+    if (!mBackend) return false;
+
+    if (mArena.used() > kArenaAutoResetBytes) {
+        mArena.reset();
+    }
+    mCurrentMesh = &mesh;
+
+    size_t vertCount = mesh.vertices.size();
+    size_t indexCount = mesh.indexCount();
+
+    bool isNew = false;
+    MeshCacheEntry& entry = acquireEntry(&mesh, mesh.primitive, vertCount, isNew);
+    if (!isNew && entry.sourceVersion == mesh.version) {
+        return entry.vertexBuffer.valid() && entry.vertexCount > 0;
+    }
+    entry.sourceVersion = mesh.version;
+
+    // No per-attribute shadows: a version bump re-uploads everything
+    // (a Mesh drawn at this address before would otherwise keep them)
+    entry.positions.clear();
+    entry.colors.clear();
+    entry.texCoords.clear();
+    entry.normals.clear();
+    entry.indices.clear();
+
+    size_t stride = entry.layout.stride;
+    reserveBuffer(entry.vertexBuffer, entry.vertexCapacity, vertCount, stride, BufferType::Vertex);
+    entry.vertexCount = vertCount;
+    if (entry.vertexBuffer.valid() && vertCount > 0) {
+        const void* data = mesh.vertices.data();
+        if (entry.compression != VertexCompression::None) {
+            if (entry.compression == VertexCompression::Quantized) {
+                float lo[3], hi[3];
+                for (int c = 0; c < 3; ++c) lo[c] = hi[c] = mesh.vertices[0].position[c];
+                for (const InterleavedVertex& v : mesh.vertices) {
+                    for (int c = 0; c < 3; ++c) {
+                        lo[c] = std::min(lo[c], v.position[c]);
+                        hi[c] = std::max(hi[c], v.position[c]);
+                    }
+                }
+                setQuantizationRange(entry, lo, hi);
+            }
+            data = packVertices(entry, mesh.vertices.data(), vertCount);
         }
+        mBackend->updateBuffer(entry.vertexBuffer, data, vertCount * stride, 0);
+        entry.meshVersion++;
+    }
+
+    entry.opaque = true;
+    for (const InterleavedVertex& v : mesh.vertices) {
+        if (v.color[3] < 1.0f) { entry.opaque = false; break; }
+    }
+
+    // Indices go up in their source width; converted fans / loops are 32-bit
+    const void* indexData = mesh.indexData();
+    size_t indexSize = mesh.wideIndices ? sizeof(uint32_t) : sizeof(uint16_t);
+    entry.convertedPrimitive = meshPrimitiveToPrimitiveType(mesh.primitive);
+    if (needsPrimitiveConversion(mesh.primitive) && indexCount > 0) {
+        std::vector<unsigned int> source(indexCount);
+        for (size_t i = 0; i < indexCount; ++i) {
+            source[i] = mesh.wideIndices ? mesh.indices32[i] : mesh.indices16[i];
+        }
+        uint32_t* converted = nullptr;
+        entry.convertedPrimitive = convertPrimitive(mesh.primitive, source, converted, indexCount);
+        indexData = converted;
+        indexSize = sizeof(uint32_t);
+    }
+
+    if (entry.indexSize != indexSize && entry.indexBuffer.valid()) {
+        // Width changed - the old buffer's capacity is in the other unit
+        mBackend->destroyBuffer(entry.indexBuffer);
+        mTotalBufferMemory -= entry.indexCapacity * entry.indexSize;
+        entry.indexBuffer = {};
+        entry.indexCapacity = 0;
+    }
+    entry.indexSize = indexSize;
+    entry.indexCount = indexCount;
+    if (indexCount > 0) {
+        // Capacities are even, so an odd 16-bit count can be padded to the
+        // 4-byte multiple WebGPU requires for buffer writes
+        reserveBuffer(entry.indexBuffer, entry.indexCapacity, indexCount + 1, indexSize,
+                      BufferType::Index);
+        if (entry.indexBuffer.valid()) {
+            size_t bytes = indexCount * indexSize;
+            if (bytes % 4 != 0) {
+                uint16_t* padded = mArena.allocate<uint16_t>(indexCount + 1);
+                memcpy(padded, indexData, bytes);
+                padded[indexCount] = 0;
+                indexData = padded;
+                bytes += sizeof(uint16_t);
+            }
+            mBackend->updateBuffer(entry.indexBuffer, indexData, bytes, 0);
+            entry.meshVersion++;
+        }
+    }
+    entry.hasIndices = entry.indexCount > 0;
+
+    return entry.vertexBuffer.valid() && entry.vertexCount > 0;
+}
+
+bool WebMeshAdapter::reserveBuffer(BufferHandle& buffer, size_t& capacity, size_t needed,
+                                   size_t elemSize, BufferType type) {
+    if (needed <= capacity && buffer.valid()) return false;
+
+    // Grow by doubling; the caller refills everything
+    size_t grown = growCapacity(capacity, needed);
+    if (buffer.valid()) {
+        mBackend->destroyBuffer(buffer);
+        mTotalBufferMemory -= capacity * elemSize;
+    }
+    buffer = mBackend->createBuffer(type, BufferUsage::Dynamic, nullptr, grown * elemSize);
+    capacity = buffer.valid() ? grown : 0;
+    mTotalBufferMemory += capacity * elemSize;
+    if (mMemoryBudget > 0 && mTotalBufferMemory > mMemoryBudget) evict();
+    return true;
+}
+
+void WebMeshAdapter::uploadVertices(MeshCacheEntry& entry, const Mesh& mesh,
+                                    size_t first, size_t last) {
+    size_t vertCount = mesh.vertices().size();
+    size_t stride = entry.layout.stride;
+    if (vertCount > entry.vertexCapacity &&
+        reserveBuffer(entry.vertexBuffer, entry.vertexCapacity, vertCount, stride,
+                      BufferType::Vertex)) {
+        first = 0;
+        last = vertCount;
+    }
+    if (!entry.vertexBuffer.valid() || first >= last) return;
+
+    if (entry.compression == VertexCompression::Quantized &&
+        fitQuantization(entry, mesh, first, last)) {
+        // New range - every stored position has to be re-encoded
+        first = 0;
+        last = vertCount;
+    }
+
+    size_t count = last - first;
+    InterleavedVertex* interleavedData = mArena.allocate<InterleavedVertex>(count);
+    createInterleavedData(mesh, interleavedData, first, count);
+    const void* data = interleavedData;
+    if (entry.compression != VertexCompression::None) {
+        data = packVertices(entry, interleavedData, count);
+    }
+    mBackend->updateBuffer(
+        entry.vertexBuffer,
+        data,
+        count * stride,
+        first * stride
+    );
+    entry.meshVersion++;
+}
+
+void WebMeshAdapter::uploadIndices(MeshCacheEntry& entry, const uint32_t* indices, size_t count,
+                                   size_t first, size_t last) {
+    if (count > entry.indexCapacity &&
+        reserveBuffer(entry.indexBuffer, entry.indexCapacity, count, sizeof(uint32_t),
+                      BufferType::Index)) {
+        first = 0;
+        last = count;
     }
+    if (!entry.indexBuffer.valid() || first >= last) return;
+
+    mBackend->updateBuffer(
+        entry.indexBuffer,
+        indices + first,
+        (last - first) * sizeof(uint32_t),
+        first * sizeof(uint32_t)
+    );
+    entry.meshVersion++;
+}
 
-    mCache[meshPtr] = entry;
-    return entry.vertexBuffer.valid();
+void WebMeshAdapter::releaseEntry(MeshCacheEntry& entry) {
+    if (mBackend) {
+        if (entry.vertexBuffer.valid()) mBackend->destroyBuffer(entry.vertexBuffer);
+        if (entry.indexBuffer.valid()) mBackend->destroyBuffer(entry.indexBuffer);
+    }
+    mTotalBufferMemory -= entry.vertexCapacity * entry.layout.stride;
+    mTotalBufferMemory -= entry.indexCapacity * entry.indexSize;
+    entry.vertexBuffer = {};
+    entry.indexBuffer = {};
+    entry.vertexCapacity = 0;
+    entry.indexCapacity = 0;
 }
 
 void WebMeshAdapter::drawMesh(PrimitiveType primitive, int vertexCount) {
@@ -166,7 +392,7 @@ void WebMeshAdapter::drawMesh(PrimitiveType primitive, int vertexCount) {
 
     if (entry.hasIndices && entry.indexBuffer.valid()) {
         // Indexed draw
-        mBackend->setIndexBuffer(entry.indexBuffer, true); // 32-bit indices
+        mBackend->setIndexBuffer(entry.indexBuffer, entry.indexSize == sizeof(uint32_t));
         int indexCount = static_cast<int>(entry.indexCount);
         mBackend->drawIndexed(actualPrimitive, indexCount, 0, 0);
     } else {
@@ -175,45 +401,116 @@ void WebMeshAdapter::drawMesh(PrimitiveType primitive, int vertexCount) {
     }
 }
 
-const MeshCacheEntry* WebMeshAdapter::getCacheEntry(const Mesh* mesh) const {
+bool WebMeshAdapter::drawMeshInstanced(const Mesh* mesh, int instanceCount) {
+    if (!mBackend || instanceCount <= 0) return false;
+
     auto it = mCache.find(mesh);
-    return (it != mCache.end()) ? &it->second : nullptr;
+    if (it == mCache.end()) return false;
+
+    const auto& entry = it->second;
+    if (!entry.vertexBuffer.valid()) return false;
+    if (entry.convertedPrimitive == PrimitiveType::TriangleFan ||
+        entry.convertedPrimitive == PrimitiveType::LineLoop) return false;
+
+    mBackend->setVertexBuffer(entry.vertexBuffer, entry.layout);
+    if (entry.hasIndices && entry.indexBuffer.valid()) {
+        mBackend->setIndexBuffer(entry.indexBuffer, entry.indexSize == sizeof(uint32_t));
+        mBackend->drawIndexedInstanced(entry.convertedPrimitive,
+                                       static_cast<int>(entry.indexCount), instanceCount);
+    } else {
+        mBackend->drawInstanced(entry.convertedPrimitive,
+                                static_cast<int>(entry.vertexCount), instanceCount);
+    }
+    return true;
 }
 
-void WebMeshAdapter::clearCache() {
-    if (!mBackend) {
-        mCache.clear();
-        mTotalBufferMemory = 0;
-        return;
+void WebMeshAdapter::beginFrame() {
+    mArena.reset();
+    mFrame++;
+    evict();
+}
+
+void WebMeshAdapter::setMemoryBudget(size_t bytes) {
+    mMemoryBudget = bytes;
+    evict();
+}
+
+WebMeshAdapter::CacheStats WebMeshAdapter::cacheStats() const {
+    CacheStats stats;
+    stats.entries = mCache.size();
+    stats.bytes = mTotalBufferMemory;
+    stats.budget = mMemoryBudget;
+    stats.evictions = mEvictions;
+    stats.evictedBytes = mEvictedBytes;
+    return stats;
+}
+
+void WebMeshAdapter::evict() {
+    if (mCache.empty()) return;
+
+    auto entryBytes = [](const MeshCacheEntry& entry) {
+        return entry.vertexCapacity * entry.layout.stride + entry.indexCapacity * entry.indexSize;
+    };
+    auto drop = [&](std::unordered_map<const void*, MeshCacheEntry>::iterator it) {
+        mEvictions++;
+        mEvictedBytes += entryBytes(it->second);
+        if (mCurrentMesh == it->first) mCurrentMesh = nullptr;
+        releaseEntry(it->second);
+        return mCache.erase(it);
+    };
+
+    // Not drawn for a while (also reclaims entries of destroyed meshes)
+    if (mEvictionAge > 0) {
+        for (auto it = mCache.begin(); it != mCache.end();) {
+            if (mFrame - it->second.lastUsedFrame > mEvictionAge) {
+                it = drop(it);
+            } else {
+                ++it;
+            }
+        }
     }
 
+    if (mMemoryBudget == 0 || mTotalBufferMemory <= mMemoryBudget) return;
+
+    // Over budget: least recently drawn first, never one drawn this frame
+    std::vector<std::pair<uint64_t, const void*>> candidates;
+    for (const auto& [meshPtr, entry] : mCache) {
+        if (entry.lastUsedFrame < mFrame) candidates.emplace_back(entry.lastUsedFrame, meshPtr);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    size_t before = mTotalBufferMemory;
+    size_t evicted = 0;
+    for (const auto& candidate : candidates) {
+        if (mTotalBufferMemory <= mMemoryBudget) break;
+        drop(mCache.find(candidate.second));
+        evicted++;
+    }
+    if (evicted > 0) {
+        printf("[WebMeshAdapter] Over budget: evicted %zu meshes (%zu -> %zu KB, budget %zu KB)\n",
+               evicted, before / 1024, mTotalBufferMemory / 1024, mMemoryBudget / 1024);
+    }
+}
+
+const MeshCacheEntry* WebMeshAdapter::getCacheEntry(const void* mesh) const {
+    auto it = mCache.find(mesh);
+    return (it != mCache.end()) ? &it->second : nullptr;
+}
+
+void WebMeshAdapter::clearCache() {
     for (auto& [meshPtr, entry] : mCache) {
-        if (entry.vertexBuffer.valid()) {
-            mBackend->destroyBuffer(entry.vertexBuffer);
-        }
-        if (entry.indexBuffer.valid()) {
-            mBackend->destroyBuffer(entry.indexBuffer);
-        }
+        releaseEntry(entry);
     }
     mCache.clear();
     mTotalBufferMemory = 0;
     mCurrentMesh = nullptr;
 }
 
-void WebMeshAdapter::removeMesh(const Mesh* mesh) {
+void WebMeshAdapter::removeMesh(const void* mesh) {
     auto it = mCache.find(mesh);
     if (it == mCache.end()) return;
 
-    if (mBackend) {
-        if (it->second.vertexBuffer.valid()) {
-            mBackend->destroyBuffer(it->second.vertexBuffer);
-            mTotalBufferMemory -= it->second.vertexCount * sizeof(InterleavedVertex);
-        }
-        if (it->second.indexBuffer.valid()) {
-            mBackend->destroyBuffer(it->second.indexBuffer);
-            mTotalBufferMemory -= it->second.indexCount * sizeof(uint32_t);
-        }
-    }
+    releaseEntry(it->second);
     mCache.erase(it);
 
     if (mCurrentMesh == mesh) {
@@ -223,16 +520,15 @@ void WebMeshAdapter::removeMesh(const Mesh* mesh) {
 
 void WebMeshAdapter::createInterleavedData(
     const Mesh& mesh,
-    std::vector<InterleavedVertex>& outVertices
+    InterleavedVertex* outVertices,
+    size_t first,
+    size_t count
 ) {
     const auto& positions = mesh.vertices();
     const auto& colors = mesh.colors();
     const auto& texCoords = mesh.texCoord2s();
     const auto& normals = mesh.normals();
 
-    size_t vertexCount = positions.size();
-    outVertices.resize(vertexCount);
-
     bool hasColors = !colors.empty();
     bool hasTexCoords = !texCoords.empty();
     bool hasNormals = !normals.empty();
@@ -242,8 +538,8 @@ void WebMeshAdapter::createInterleavedData(
     const float defaultTexCoord[2] = {0.0f, 0.0f};
     const float defaultNormal[3] = {0.0f, 0.0f, 1.0f};
 
-    for (size_t i = 0; i < vertexCount; ++i) {
-        InterleavedVertex& v = outVertices[i];
+    for (size_t i = first; i < first + count; ++i) {
+        InterleavedVertex& v = outVertices[i - first];
 
         // Position
         v.position[0] = positions[i].x;
@@ -279,128 +575,364 @@ void WebMeshAdapter::createInterleavedData(
     }
 }
 
-VertexLayout WebMeshAdapter::createVertexLayout() {
+VertexLayout WebMeshAdapter::createVertexLayout(VertexCompression compression) {
     VertexLayout layout;
-    layout.stride = sizeof(InterleavedVertex); // 48 bytes
 
-    // Position: location 0, vec3f, offset 0
-    layout.attributes.push_back({0, 3, 0, false});
+    if (compression == VertexCompression::None) {
+        layout.stride = sizeof(InterleavedVertex); // 48 bytes
+
+        // Position: location 0, vec3f, offset 0
+        layout.attributes.push_back({0, 3, 0, false});
+
+        // Color: location 1, vec4f, offset 12
+        layout.attributes.push_back({1, 4, 12, false});
+
+        // TexCoord: location 2, vec2f, offset 28
+        layout.attributes.push_back({2, 2, 28, false});
+
+        // Normal: location 3, vec3f, offset 36
+        layout.attributes.push_back({3, 3, 36, false});
+
+        return layout;
+    }
+
+    // Position: float32x3 (12 bytes) or snorm16x4 (8 bytes)
+    int offset = 0;
+    if (compression == VertexCompression::Quantized) {
+        layout.attributes.push_back({0, 3, offset, true, VertexFormat::Snorm16});
+        offset += 8;
+    } else {
+        layout.attributes.push_back({0, 3, offset, false});
+        offset += 12;
+    }
 
-    // Color: location 1, vec4f, offset 12
-    layout.attributes.push_back({1, 4, 12, false});
+    // Color: unorm8x4, 4 bytes
+    layout.attributes.push_back({1, 4, offset, true, VertexFormat::Unorm8});
+    offset += 4;
 
-    // TexCoord: location 2, vec2f, offset 28
-    layout.attributes.push_back({2, 2, 28, false});
+    // TexCoord: float16x2, 4 bytes
+    layout.attributes.push_back({2, 2, offset, false, VertexFormat::Float16});
+    offset += 4;
 
-    // Normal: location 3, vec3f, offset 36
-    layout.attributes.push_back({3, 3, 36, false});
+    // Normal: snorm16x4 (w unused), 8 bytes
+    layout.attributes.push_back({3, 3, offset, true, VertexFormat::Snorm16});
+    offset += 8;
 
+    layout.stride = offset;  // 28 or 24 bytes
     return layout;
 }
 
+// IEEE 754 binary32 -> binary16, round to nearest even
+static uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent >= 31) {
+        // Overflow, Inf and NaN
+        bool isNaN = ((bits >> 23) & 0xFF) == 0xFF && mantissa;
+        return static_cast<uint16_t>(sign | 0x7C00u | (isNaN ? 0x200u : 0u));
+    }
+    if (exponent <= 0) {
+        // Subnormal or zero
+        if (exponent < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1))) half++;  // May carry into exponent
+    return static_cast<uint16_t>(half);
+}
+
+static int16_t toSnorm16(float value) {
+    value = std::max(-1.0f, std::min(1.0f, value));
+    return static_cast<int16_t>(std::lround(value * 32767.0f));
+}
+
+static uint8_t toUnorm8(float value) {
+    value = std::max(0.0f, std::min(1.0f, value));
+    return static_cast<uint8_t>(std::lround(value * 255.0f));
+}
+
+const void* WebMeshAdapter::packVertices(const MeshCacheEntry& entry,
+                                         const InterleavedVertex* vertices, size_t count) {
+    size_t stride = entry.layout.stride;
+    bool quantized = entry.compression == VertexCompression::Quantized;
+    float invScale = entry.positionScale > 0.0f ? 1.0f / entry.positionScale : 1.0f;
+
+    // Strides are multiples of 4, so uint32_t keeps the 16-bit fields aligned
+    char* out = reinterpret_cast<char*>(mArena.allocate<uint32_t>(count * stride / 4));
+    for (size_t i = 0; i < count; ++i) {
+        const InterleavedVertex& v = vertices[i];
+        char* dst = out + i * stride;
+
+        if (quantized) {
+            int16_t pos[4] = {
+                toSnorm16((v.position[0] - entry.positionOffset[0]) * invScale),
+                toSnorm16((v.position[1] - entry.positionOffset[1]) * invScale),
+                toSnorm16((v.position[2] - entry.positionOffset[2]) * invScale),
+                32767  // w = 1 for shaders that read a vec4 position
+            };
+            memcpy(dst, pos, sizeof(pos));
+            dst += sizeof(pos);
+        } else {
+            memcpy(dst, v.position, sizeof(v.position));
+            dst += sizeof(v.position);
+        }
+
+        uint8_t color[4] = {
+            toUnorm8(v.color[0]), toUnorm8(v.color[1]), toUnorm8(v.color[2]), toUnorm8(v.color[3])
+        };
+        memcpy(dst, color, sizeof(color));
+        dst += sizeof(color);
+
+        uint16_t texCoord[2] = {floatToHalf(v.texCoord[0]), floatToHalf(v.texCoord[1])};
+        memcpy(dst, texCoord, sizeof(texCoord));
+        dst += sizeof(texCoord);
+
+        int16_t normal[4] = {
+            toSnorm16(v.normal[0]), toSnorm16(v.normal[1]), toSnorm16(v.normal[2]), 0
+        };
+        memcpy(dst, normal, sizeof(normal));
+    }
+    return out;
+}
+
+bool WebMeshAdapter::fitQuantization(MeshCacheEntry& entry, const Mesh& mesh,
+                                     size_t first, size_t last) {
+    const auto& positions = mesh.vertices();
+
+    // Still inside the current range?
+    if (entry.positionScale > 0.0f) {
+        bool inside = true;
+        for (size_t i = first; i < last && inside; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                float d = positions[i][c] - entry.positionOffset[c];
+                if (std::fabs(d) > entry.positionScale) { inside = false; break; }
+            }
+        }
+        if (inside) return false;
+    }
+
+    float lo[3] = {positions[0].x, positions[0].y, positions[0].z};
+    float hi[3] = {lo[0], lo[1], lo[2]};
+    for (const auto& p : positions) {
+        for (int c = 0; c < 3; ++c) {
+            lo[c] = std::min(lo[c], p[c]);
+            hi[c] = std::max(hi[c], p[c]);
+        }
+    }
+    setQuantizationRange(entry, lo, hi);
+    return true;
+}
+
+void WebMeshAdapter::setQuantizationRange(MeshCacheEntry& entry, const float lo[3],
+                                          const float hi[3]) {
+    // Uniform scale keeps normals valid under the decode matrix; the margin
+    // lets slowly growing meshes stay in range for a while
+    float extent = 0.0f;
+    for (int c = 0; c < 3; ++c) {
+        entry.positionOffset[c] = 0.5f * (lo[c] + hi[c]);
+        extent = std::max(extent, 0.5f * (hi[c] - lo[c]));
+    }
+    entry.positionScale = extent > 0.0f ? extent * 1.125f : 1.0f;
+}
+
+void WebMeshAdapter::applyPositionDecode(const MeshCacheEntry& entry, float* m) {
+    if (entry.compression != VertexCompression::Quantized || !m) return;
+
+    // m = m * translate(offset) * scale(positionScale), column-major
+    const float* o = entry.positionOffset;
+    for (int r = 0; r < 4; ++r) {
+        m[12 + r] += m[r] * o[0] + m[4 + r] * o[1] + m[8 + r] * o[2];
+    }
+    for (int i = 0; i < 12; ++i) {
+        m[i] *= entry.positionScale;
+    }
+}
+
 PrimitiveType WebMeshAdapter::convertPrimitive(
     Mesh::Primitive primitive,
-    const std::vector<InterleavedVertex>& vertices,
     const std::vector<unsigned int>& indices,
-    std::vector<InterleavedVertex>& outVertices,
-    std::vector<uint32_t>& outIndices
+    uint32_t*& outIndices,
+    size_t& outCount
 ) {
     // Handle TRIANGLE_FAN conversion to TRIANGLES
     // TRIANGLE_FAN: v0 is center, draws triangles (v0,v1,v2), (v0,v2,v3), (v0,v3,v4), ...
     if (primitive == Mesh::TRIANGLE_FAN) {
-        if (indices.empty()) {
-            // Non-indexed TRIANGLE_FAN
-            if (vertices.size() < 3) {
-                outVertices = vertices;
-                return PrimitiveType::Triangles;
-            }
-
-            // Convert to non-indexed TRIANGULAR
-            // For n vertices, we get (n-2) triangles, each with 3 vertices
-            size_t numTriangles = vertices.size() - 2;
-            outVertices.reserve(numTriangles * 3);
-
-            const InterleavedVertex& center = vertices[0];
-            for (size_t i = 0; i < numTriangles; ++i) {
-                outVertices.push_back(center);           // v0 (center)
-                outVertices.push_back(vertices[i + 1]);  // v[i+1]
-                outVertices.push_back(vertices[i + 2]);  // v[i+2]
-            }
-
-            printf("[WebMeshAdapter] Converted TRIANGLE_FAN (%zu verts) to TRIANGLES (%zu verts)\n",
-                   vertices.size(), outVertices.size());
-        } else {
-            // Indexed TRIANGLE_FAN - convert indices
-            if (indices.size() < 3) {
-                outVertices = vertices;
-                outIndices.assign(indices.begin(), indices.end());
-                return PrimitiveType::Triangles;
-            }
+        if (indices.size() < 3) {
+            outCount = indices.size();
+            outIndices = mArena.allocate<uint32_t>(outCount);
+            std::copy(indices.begin(), indices.end(), outIndices);
+            return PrimitiveType::Triangles;
+        }
 
-            outVertices = vertices; // Keep vertices as-is
-            size_t numTriangles = indices.size() - 2;
-            outIndices.reserve(numTriangles * 3);
+        size_t numTriangles = indices.size() - 2;
+        outCount = numTriangles * 3;
+        outIndices = mArena.allocate<uint32_t>(outCount);
 
-            uint32_t centerIdx = indices[0];
-            for (size_t i = 0; i < numTriangles; ++i) {
-                outIndices.push_back(centerIdx);
-                outIndices.push_back(indices[i + 1]);
-                outIndices.push_back(indices[i + 2]);
-            }
-
-            printf("[WebMeshAdapter] Converted indexed TRIANGLE_FAN (%zu indices) to TRIANGLES (%zu indices)\n",
-                   indices.size(), outIndices.size());
+        uint32_t centerIdx = indices[0];
+        for (size_t i = 0; i < numTriangles; ++i) {
+            outIndices[i * 3 + 0] = centerIdx;
+            outIndices[i * 3 + 1] = indices[i + 1];
+            outIndices[i * 3 + 2] = indices[i + 2];
         }
+
+        printf("[WebMeshAdapter] Converted indexed TRIANGLE_FAN (%zu indices) to TRIANGLES (%zu indices)\n",
+               indices.size(), outCount);
         return PrimitiveType::Triangles;
     }
 
     // Handle LINE_LOOP conversion to LINES
     // LINE_LOOP: draws lines v0-v1, v1-v2, v2-v3, ..., v[n-1]-v0
     if (primitive == Mesh::LINE_LOOP) {
-        if (indices.empty()) {
-            // Non-indexed LINE_LOOP
-            if (vertices.size() < 2) {
-                outVertices = vertices;
-                return PrimitiveType::Lines;
-            }
+        if (indices.size() < 2) {
+            outCount = indices.size();
+            outIndices = mArena.allocate<uint32_t>(outCount);
+            std::copy(indices.begin(), indices.end(), outIndices);
+            return PrimitiveType::Lines;
+        }
 
-            // Convert to non-indexed LINES
-            // For n vertices, we get n lines, each with 2 vertices
-            outVertices.reserve(vertices.size() * 2);
+        outCount = indices.size() * 2;
+        outIndices = mArena.allocate<uint32_t>(outCount);
 
-            for (size_t i = 0; i < vertices.size(); ++i) {
-                outVertices.push_back(vertices[i]);
-                outVertices.push_back(vertices[(i + 1) % vertices.size()]);
-            }
+        for (size_t i = 0; i < indices.size(); ++i) {
+            outIndices[i * 2 + 0] = indices[i];
+            outIndices[i * 2 + 1] = indices[(i + 1) % indices.size()];
+        }
 
-            printf("[WebMeshAdapter] Converted LINE_LOOP (%zu verts) to LINES (%zu verts)\n",
-                   vertices.size(), outVertices.size());
-        } else {
-            // Indexed LINE_LOOP - convert indices
-            if (indices.size() < 2) {
-                outVertices = vertices;
-                outIndices.assign(indices.begin(), indices.end());
-                return PrimitiveType::Lines;
-            }
+        printf("[WebMeshAdapter] Converted indexed LINE_LOOP (%zu indices) to LINES (%zu indices)\n",
+               indices.size(), outCount);
+        return PrimitiveType::Lines;
+    }
+
+    // No conversion needed - shouldn't reach here if needsPrimitiveConversion() was checked
+    outCount = indices.size();
+    outIndices = mArena.allocate<uint32_t>(outCount);
+    std::copy(indices.begin(), indices.end(), outIndices);
+    return meshPrimitiveToPrimitiveType(primitive);
+}
 
-            outVertices = vertices;
-            outIndices.reserve(indices.size() * 2);
+// ─── InterleavedMesh ─────────────────────────────────────────────────────────
 
-            for (size_t i = 0; i < indices.size(); ++i) {
-                outIndices.push_back(indices[i]);
-                outIndices.push_back(indices[(i + 1) % indices.size()]);
-            }
+void InterleavedMesh::widenIndices() {
+    if (wideIndices) return;
+    indices32.assign(indices16.begin(), indices16.end());
+    indices16.clear();
+    indices16.shrink_to_fit();
+    wideIndices = true;
+}
+
+void InterleavedMesh::computeBounds() {
+    if (vertices.empty()) {
+        for (int c = 0; c < 3; ++c) boundsMin[c] = boundsMax[c] = 0.0f;
+        return;
+    }
+    for (int c = 0; c < 3; ++c) boundsMin[c] = boundsMax[c] = vertices[0].position[c];
+    for (const InterleavedVertex& v : vertices) {
+        for (int c = 0; c < 3; ++c) {
+            boundsMin[c] = std::min(boundsMin[c], v.position[c]);
+            boundsMax[c] = std::max(boundsMax[c], v.position[c]);
+        }
+    }
+}
 
-            printf("[WebMeshAdapter] Converted indexed LINE_LOOP (%zu indices) to LINES (%zu indices)\n",
-                   indices.size(), outIndices.size());
+void InterleavedMesh::clear() {
+    vertices.clear();
+    indices16.clear();
+    indices32.clear();
+    wideIndices = false;
+    for (int c = 0; c < 3; ++c) boundsMin[c] = boundsMax[c] = 0.0f;
+    version++;
+}
+
+void InterleavedMesh::toMesh(Mesh& out) const {
+    out.reset();
+    out.primitive(primitive);
+    for (const InterleavedVertex& v : vertices) {
+        out.vertex(v.position[0], v.position[1], v.position[2]);
+        out.color(v.color[0], v.color[1], v.color[2], v.color[3]);
+        out.texCoord(v.texCoord[0], v.texCoord[1]);
+        out.normal(v.normal[0], v.normal[1], v.normal[2]);
+    }
+    size_t count = indexCount();
+    for (size_t i = 0; i < count; ++i) {
+        out.index(wideIndices ? indices32[i] : indices16[i]);
+    }
+}
+
+void InterleavedMesh::fromMesh(const Mesh& in) {
+    clear();
+    primitive = static_cast<Mesh::Primitive>(in.primitive());
+    const auto& positions = in.vertices();
+    const auto& colors = in.colors();
+    const auto& texCoords = in.texCoord2s();
+    const auto& normals = in.normals();
+
+    vertices.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        InterleavedVertex& v = vertices[i];
+        for (int c = 0; c < 3; ++c) v.position[c] = positions[i][c];
+        if (i < colors.size()) {
+            v.color[0] = colors[i].r; v.color[1] = colors[i].g;
+            v.color[2] = colors[i].b; v.color[3] = colors[i].a;
+        } else {
+            v.color[0] = v.color[1] = v.color[2] = v.color[3] = 1.0f;
+        }
+        v.texCoord[0] = i < texCoords.size() ? texCoords[i][0] : 0.0f;
+        v.texCoord[1] = i < texCoords.size() ? texCoords[i][1] : 0.0f;
+        if (i < normals.size()) {
+            for (int c = 0; c < 3; ++c) v.normal[c] = normals[i][c];
+        } else {
+            v.normal[0] = 0.0f; v.normal[1] = 0.0f; v.normal[2] = 1.0f;
         }
-        return PrimitiveType::Lines;
     }
 
-    // No conversion needed - shouldn't reach here if needsPrimitiveConversion() was checked
-    outVertices = vertices;
-    outIndices.assign(indices.begin(), indices.end());
-    return meshPrimitiveToPrimitiveType(primitive);
+    const auto& indices = in.indices();
+    wideIndices = positions.size() > 0x10000;
+    if (wideIndices) indices32.assign(indices.begin(), indices.end());
+    else indices16.assign(indices.begin(), indices.end());
+    computeBounds();
+}
+
+// ─── FrameArena ──────────────────────────────────────────────────────────────
+
+void* FrameArena::allocateBytes(size_t bytes, size_t align) {
+    if (bytes == 0) bytes = 1;
+    mUsed += bytes + align;
+
+    size_t offset = (mOffset + align - 1) & ~(align - 1);
+    if (mBlock && offset + bytes <= mBlockSize) {
+        mOffset = offset + bytes;
+        return mBlock.get() + offset;
+    }
+
+    // Main block is full this frame - overflow until the next reset()
+    mOverflow.emplace_back(new char[bytes + align]);
+    char* base = mOverflow.back().get();
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(base) + align - 1) & ~(uintptr_t)(align - 1);
+    return reinterpret_cast<void*>(aligned);
+}
+
+void FrameArena::reset() {
+    if (!mOverflow.empty()) {
+        size_t size = std::max<size_t>(mBlockSize, 64 * 1024);
+        while (size < mUsed) size *= 2;
+        mOverflow.clear();
+        mBlock.reset(new char[size]);
+        mBlockSize = size;
+    }
+    mOffset = 0;
+    mUsed = 0;
 }
 
 } // namespace al
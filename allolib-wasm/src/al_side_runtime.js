@@ -0,0 +1,30 @@
+/**
+ * AlloLib Side-Module Runtime Glue
+ *
+ * Passed as --pre-js to the runtime main module that compile.sh builds for
+ * side-module mode (libal_web, Gamma and the WebControlGUI exports linked
+ * whole, shared by every sketch of a backend). The sketch itself arrives
+ * as a side module through Module.dynamicLibraries and is loaded, with its
+ * symbols resolved, before main() runs.
+ *
+ * Emscripten only publishes the main module's exports as Module._name, but
+ * the frontend also calls C functions that sketch headers define (the
+ * sequencer bridge, MIDI, OSC) through Module._name and ccall. Publish the
+ * side modules' function exports the same way once they are loaded;
+ * exports the main module already has keep the main module's version.
+ */
+Module['onRuntimeInitialized'] = (function (previous) {
+  return function () {
+    for (var name in LDSO.loadedLibsByName) {
+      var lib = LDSO.loadedLibsByName[name];
+      if (name === '__main__' || !lib.exports) continue;
+      for (var sym in lib.exports) {
+        var value = lib.exports[sym];
+        if (typeof value === 'function' && !(('_' + sym) in Module)) {
+          Module['_' + sym] = value;
+        }
+      }
+    }
+    if (previous) previous();
+  };
+})(Module['onRuntimeInitialized']);
@@ -0,0 +1,31 @@
+/**
+ * WebApp::parameterServer(), on its own so that the ParameterServer, the
+ * WebSocket OSC transport and oscpack are only linked into sketches that
+ * ask for the server. WebApp's destructor deletes it through
+ * ParameterServer's virtual destructor, which references none of them.
+ */
+
+#include "al_WebApp.hpp"
+#include "al/ui/al_ParameterServer.hpp"
+#include "al_web_parameter_server.hpp"
+
+namespace al {
+
+WebParameterServer& WebApp::parameterServer() {
+    if (!mParameterServer) {
+        // Default OSC port 9010 — same as upstream al::App default. Web
+        // transport routes through ws://127.0.0.1:9010/osc via our
+        // WebSocket-backed osc::Recv (M5.1). autoStart=true so it
+        // begins listening immediately.
+        // WebParameterServer inherits ParameterServer's ctor; the (ip,
+        // port, autoStart) signature works unchanged.
+        mParameterServer.reset(new WebParameterServer("", 9010, true));
+    }
+    return *mParameterServer;
+}
+
+const WebParameterServer& WebApp::parameterServer() const {
+    return const_cast<WebApp*>(this)->parameterServer();
+}
+
+} // namespace al
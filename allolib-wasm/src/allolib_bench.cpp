@@ -0,0 +1,728 @@
+/**
+ * Core Subsystem Benchmark
+ *
+ * Throughput of the CPU-side work behind loading and drawing: OBJ and glTF
+ * parsing, HDR decoding, MeshSimplifier and LODMesh, a LODGroup scene,
+ * QualityManager, WebMeshAdapter::prepareMesh (against a backend that only
+ * counts bytes), ProceduralTexture generators and the audio_simd buffer
+ * kernels. Every dataset is generated in memory
+ * from fixed sizes and seeds, so runs are comparable across machines and
+ * builds. Headless: no window, GL or audio device. Results go to a JSON
+ * file (the loaders log to stdout) with a readable table on stderr.
+ *
+ * dsp_bench covers the Gamma and _studio_shared DSP per block size; the
+ * DSP here is the buffer arithmetic WebApp runs on every block.
+ *
+ * Web (Node), built by CMake with BUILD_BENCH=ON:
+ *   emcmake cmake -B build -DBUILD_BENCH=ON
+ *   cmake --build build --target allolib_bench
+ *   node build/allolib_bench.js --out bench-wasm.json
+ *
+ * Native, from the same source: the loaders come from native_compat (the
+ * same API, as in a native AlloLib sketch), everything else is shared.
+ * Native AlloLib's headers go first so its al/graphics headers win:
+ *   g++ -O2 -std=c++17 -I<allolib>/include -Iinclude src/allolib_bench.cpp \
+ *       src/al_WebMeshAdapter.cpp -L<allolib build> -lal -o allolib_bench
+ *   ./allolib_bench --out bench-native.json
+ *
+ * scripts/bench-parity.mjs runs both builds (or reads their JSON) and
+ * reports wasm/native ratios per subsystem. Benchmarks with a digest also
+ * record a summary of their output (vertex counts, a few texels), so it can
+ * tell a slow shim from one that is doing different work.
+ *
+ * Options:
+ *   --quick            fewer iterations and a smaller time budget
+ *   --filter <text>    only benchmarks whose name contains text
+ *   --out <file>       JSON results (default allolib_bench.json)
+ *
+ * Each benchmark runs a warm-up, then iterations until both a minimum
+ * count and a time budget are reached; best, median and mean are per
+ * iteration, throughput is from the median.
+ */
+
+#include "al/graphics/al_Mesh.hpp"
+#include "al/graphics/al_Shapes.hpp"
+
+#include "al_WebAudioSIMD.hpp"
+#include "al_WebMeshAdapter.hpp"
+#include "al_WebProcedural.hpp"
+
+#ifdef __EMSCRIPTEN__
+#include "al_WebGLTF.hpp"
+#include "al_WebHDR.hpp"
+#include "al_WebLOD.hpp"
+#include "al_WebMeshOptimize.hpp"
+#include "al_WebOBJ.hpp"
+#include "al_WebQuality.hpp"
+#else
+#define CGLTF_IMPLEMENTATION
+#include "cgltf.h"
+#include "native_compat/al_NativeGLTF.hpp"
+#include "native_compat/al_StudioCompat.hpp"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace al;
+
+namespace {
+
+// Results are folded into here so the work can't be optimised away
+volatile double gSink = 0.0;
+
+struct Case {
+    std::function<void()> run;      // One iteration
+    double work = 0.0;              // Units of `unit` per iteration
+    std::function<double()> digest; // Output summary after a run; unset if it depends on the run count
+};
+
+struct Bench {
+    std::string name;
+    const char* unit;           // Throughput unit, per second
+    std::function<Case()> make;
+};
+
+struct Result {
+    std::string name;
+    const char* unit;
+    int iterations;
+    double bestMs, medianMs, meanMs, throughput;
+    bool hasDigest;
+    double digest;
+};
+
+// ─── Datasets ────────────────────────────────────────────────────────────────
+
+// (n + 1)^2 vertices, 2 n^2 triangles
+std::string makeGridOBJ(int n, bool normals, bool texcoords) {
+    std::string obj;
+    obj.reserve(size_t(n + 1) * (n + 1) * 64 + size_t(n) * n * 64);
+    char line[128];
+    for (int y = 0; y <= n; y++) {
+        for (int x = 0; x <= n; x++) {
+            std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n",
+                          x / float(n) - 0.5f, y / float(n) - 0.5f, 0.02f * ((x * y) % 7));
+            obj += line;
+        }
+    }
+    if (texcoords) {
+        for (int y = 0; y <= n; y++) {
+            for (int x = 0; x <= n; x++) {
+                std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", x / float(n), y / float(n));
+                obj += line;
+            }
+        }
+    }
+    if (normals) obj += "vn 0 0 1\n";
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            int a = y * (n + 1) + x + 1, b = a + 1, c = a + n + 1, d = c + 1;
+            if (normals && texcoords) {
+                std::snprintf(line, sizeof(line), "f %d/%d/1 %d/%d/1 %d/%d/1 %d/%d/1\n",
+                              a, a, b, b, d, d, c, c);
+            } else if (normals) {
+                std::snprintf(line, sizeof(line), "f %d//1 %d//1 %d//1 %d//1\n", a, b, d, c);
+            } else {
+                std::snprintf(line, sizeof(line), "f %d %d %d %d\n", a, b, d, c);
+            }
+            obj += line;
+        }
+    }
+    return obj;
+}
+
+template <class T>
+void appendBytes(std::vector<uint8_t>& out, const T* data, size_t count) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    out.insert(out.end(), p, p + count * sizeof(T));
+}
+
+void appendU32(std::vector<uint8_t>& out, uint32_t v) { appendBytes(out, &v, 1); }
+
+// Binary glTF of an n x n heightfield grid: POSITION, NORMAL, TEXCOORD_0
+// and 32-bit indices in one buffer
+std::vector<uint8_t> makeGridGLB(int n) {
+    const int side = n + 1;
+    std::vector<float> positions, normals, uvs;
+    std::vector<uint32_t> indices;
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            float u = x / float(n), v = y / float(n);
+            positions.insert(positions.end(), {u - 0.5f, 0.05f * std::sin(12.0f * u) * std::cos(9.0f * v), v - 0.5f});
+            normals.insert(normals.end(), {0.0f, 1.0f, 0.0f});
+            uvs.insert(uvs.end(), {u, v});
+        }
+    }
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            uint32_t a = y * side + x, b = a + 1, c = a + side, d = c + 1;
+            indices.insert(indices.end(), {a, c, b, b, c, d});
+        }
+    }
+
+    std::vector<uint8_t> bin;
+    appendBytes(bin, positions.data(), positions.size());
+    appendBytes(bin, normals.data(), normals.size());
+    appendBytes(bin, uvs.data(), uvs.size());
+    appendBytes(bin, indices.data(), indices.size());
+    const size_t posBytes = positions.size() * 4, nrmBytes = normals.size() * 4;
+    const size_t uvBytes = uvs.size() * 4, idxBytes = indices.size() * 4;
+    const int vertexCount = side * side;
+
+    char json[2048];
+    std::snprintf(json, sizeof(json),
+        "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+        "\"nodes\":[{\"mesh\":0}],"
+        "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}],"
+        "\"buffers\":[{\"byteLength\":%zu}],"
+        "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":%zu,\"target\":34962},"
+        "{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu,\"target\":34962},"
+        "{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu,\"target\":34962},"
+        "{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu,\"target\":34963}],"
+        "\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":%d,\"type\":\"VEC3\","
+        "\"min\":[-0.5,-0.05,-0.5],\"max\":[0.5,0.05,0.5]},"
+        "{\"bufferView\":1,\"componentType\":5126,\"count\":%d,\"type\":\"VEC3\"},"
+        "{\"bufferView\":2,\"componentType\":5126,\"count\":%d,\"type\":\"VEC2\"},"
+        "{\"bufferView\":3,\"componentType\":5125,\"count\":%zu,\"type\":\"SCALAR\"}]}",
+        bin.size(), posBytes, posBytes, nrmBytes, posBytes + nrmBytes, uvBytes,
+        posBytes + nrmBytes + uvBytes, idxBytes, vertexCount, vertexCount, vertexCount,
+        indices.size());
+
+    std::string jsonChunk = json;
+    while (jsonChunk.size() % 4) jsonChunk += ' ';
+    while (bin.size() % 4) bin.push_back(0);
+
+    std::vector<uint8_t> glb;
+    appendU32(glb, 0x46546C67);  // "glTF"
+    appendU32(glb, 2);
+    appendU32(glb, uint32_t(12 + 8 + jsonChunk.size() + 8 + bin.size()));
+    appendU32(glb, uint32_t(jsonChunk.size()));
+    appendU32(glb, 0x4E4F534A);  // "JSON"
+    appendBytes(glb, jsonChunk.data(), jsonChunk.size());
+    appendU32(glb, uint32_t(bin.size()));
+    appendU32(glb, 0x004E4942);  // "BIN"
+    appendBytes(glb, bin.data(), bin.size());
+    return glb;
+}
+
+void floatToRGBE(float r, float g, float b, uint8_t* out) {
+    float v = std::max(r, std::max(g, b));
+    if (v < 1e-32f) {
+        out[0] = out[1] = out[2] = out[3] = 0;
+        return;
+    }
+    int e;
+    float scale = std::frexp(v, &e) * 256.0f / v;
+    out[0] = uint8_t(r * scale);
+    out[1] = uint8_t(g * scale);
+    out[2] = uint8_t(b * scale);
+    out[3] = uint8_t(e + 128);
+}
+
+// Radiance .hdr of a sky-like gradient with a bright sun, in the RLE
+// scanline format most environment maps use
+std::vector<uint8_t> makeSkyHDR(int width, int height) {
+    char header[128];
+    int len = std::snprintf(header, sizeof(header),
+                            "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y %d +X %d\n", height, width);
+    std::vector<uint8_t> out(header, header + len);
+
+    std::vector<uint8_t> rgbe(size_t(width) * 4), channel(width);
+    for (int y = 0; y < height; y++) {
+        float elevation = 1.0f - float(y) / float(height);
+        for (int x = 0; x < width; x++) {
+            float az = float(x) / float(width);
+            float dx = az - 0.3f, dy = elevation - 0.7f;
+            float sun = 40.0f * std::exp(-(dx * dx + dy * dy) * 4000.0f);
+            floatToRGBE(0.2f + 0.6f * elevation + sun, 0.4f + 0.5f * elevation + sun,
+                        0.9f * elevation + 0.1f + sun, &rgbe[size_t(x) * 4]);
+        }
+        out.insert(out.end(), {2, 2, uint8_t(width >> 8), uint8_t(width & 0xFF)});
+        for (int c = 0; c < 4; c++) {
+            for (int x = 0; x < width; x++) channel[x] = rgbe[size_t(x) * 4 + c];
+            // Runs of 4+ equal bytes as (128 + count, value), the rest literal
+            int x = 0;
+            while (x < width) {
+                int run = 1;
+                while (x + run < width && run < 127 && channel[x + run] == channel[x]) run++;
+                if (run >= 4) {
+                    out.push_back(uint8_t(128 + run));
+                    out.push_back(channel[x]);
+                    x += run;
+                    continue;
+                }
+                int start = x, count = 0;
+                while (x < width && count < 128) {
+                    int ahead = 1;
+                    while (x + ahead < width && ahead < 4 && channel[x + ahead] == channel[x]) ahead++;
+                    if (ahead >= 4) break;
+                    x++;
+                    count++;
+                }
+                out.push_back(uint8_t(count));
+                out.insert(out.end(), channel.begin() + start, channel.begin() + start + count);
+            }
+        }
+    }
+    return out;
+}
+
+// Grid with every attribute prepareMesh uploads
+void makeGridMesh(Mesh& mesh, int n) {
+    mesh.reset();
+    mesh.primitive(Mesh::TRIANGLES);
+    for (int y = 0; y <= n; y++) {
+        for (int x = 0; x <= n; x++) {
+            float u = x / float(n), v = y / float(n);
+            mesh.vertex(u - 0.5f, v - 0.5f, 0.0f);
+            mesh.normal(0.0f, 0.0f, 1.0f);
+            mesh.color(u, v, 1.0f - u, 1.0f);
+            mesh.texCoord(u, v);
+        }
+    }
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            unsigned a = y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+            for (unsigned i : {a, b, d, a, d, c}) mesh.index(i);
+        }
+    }
+}
+
+// ─── Backend stand-in for WebMeshAdapter ─────────────────────────────────────
+
+/// Accepts every call; buffers are ids and the bytes written are counted
+class NullBackend : public GraphicsBackend {
+public:
+    size_t bytesUploaded = 0;
+
+    bool init(int, int) override { return true; }
+    void shutdown() override {}
+    void resize(int, int) override {}
+    void beginFrame() override {}
+    void endFrame() override {}
+    void clear(const ClearValues&) override {}
+    void viewport(int, int, int, int) override {}
+    void setDrawState(const DrawState&) override {}
+
+    BufferHandle createBuffer(BufferType, BufferUsage, const void*, size_t size) override {
+        bytesUploaded += size;
+        return BufferHandle{++mNextId};
+    }
+    void updateBuffer(BufferHandle, const void*, size_t size, size_t) override {
+        bytesUploaded += size;
+    }
+    void destroyBuffer(BufferHandle) override {}
+
+    TextureHandle createTexture(const TextureDesc&, const void*) override {
+        return TextureHandle{++mNextId};
+    }
+    void updateTexture(TextureHandle, const void*, int, int, int, int, int) override {}
+    void generateMipmaps(TextureHandle) override {}
+    void destroyTexture(TextureHandle) override {}
+
+    RenderTargetHandle createRenderTarget(TextureHandle, TextureHandle) override {
+        return RenderTargetHandle{++mNextId};
+    }
+    void bindRenderTarget(RenderTargetHandle) override {}
+    void destroyRenderTarget(RenderTargetHandle) override {}
+
+    ShaderHandle createShader(const ShaderDesc&) override { return ShaderHandle{++mNextId}; }
+    void destroyShader(ShaderHandle) override {}
+    void useShader(ShaderHandle) override {}
+
+    void setUniform(const char*, int) override {}
+    void setUniform(const char*, float) override {}
+    void setUniform(const char*, float, float) override {}
+    void setUniform(const char*, float, float, float) override {}
+    void setUniform(const char*, float, float, float, float) override {}
+    void setUniformMat4(const char*, const float*) override {}
+    void setUniformMat3(const char*, const float*) override {}
+    void setTexture(const char*, TextureHandle, int) override {}
+    void setUniformBuffer(int, BufferHandle) override {}
+
+    void setVertexBuffer(BufferHandle, const VertexLayout&) override {}
+    void setIndexBuffer(BufferHandle, bool) override {}
+    void draw(PrimitiveType, int, int) override {}
+    void drawIndexed(PrimitiveType, int, int, int) override {}
+    void drawInstanced(PrimitiveType, int, int, int, int) override {}
+    void drawIndexedInstanced(PrimitiveType, int, int, int, int, int) override {}
+
+    BackendType getType() const override { return BackendType::WebGL2; }
+    const char* getName() const override { return "Null"; }
+    int getWidth() const override { return 1280; }
+    int getHeight() const override { return 720; }
+
+private:
+    uint64_t mNextId = 0;
+};
+
+// ─── Benchmarks ──────────────────────────────────────────────────────────────
+
+Bench objParse(const char* name, int n, bool normals, bool texcoords) {
+    return {name, "MB", [=] {
+        auto obj = std::make_shared<std::string>(makeGridOBJ(n, normals, texcoords));
+        auto mesh = std::make_shared<Mesh>();
+        Case c;
+        c.run = [obj, mesh] {
+            WebOBJ::parse(reinterpret_cast<const uint8_t*>(obj->data()), obj->size(), *mesh);
+            gSink = gSink + double(mesh->vertices().size());
+        };
+        c.work = obj->size() / 1e6;
+        c.digest = [mesh] { return double(mesh->vertices().size()); };
+        return c;
+    }};
+}
+
+Bench gltfParse(const char* name, int n) {
+    return {name, "MB", [=] {
+        auto glb = std::make_shared<std::vector<uint8_t>>(makeGridGLB(n));
+        auto mesh = std::make_shared<Mesh>();
+        Case c;
+        c.run = [glb, mesh] {
+            WebGLTF::parse(glb->data(), glb->size(), *mesh);
+            gSink = gSink + double(mesh->vertices().size());
+        };
+        c.work = glb->size() / 1e6;
+        c.digest = [mesh] { return double(mesh->vertices().size() + mesh->indices().size()); };
+        return c;
+    }};
+}
+
+Bench hdrDecode(const char* name, int width, int height) {
+    return {name, "Mpixels", [=] {
+        auto hdr = std::make_shared<std::vector<uint8_t>>(makeSkyHDR(width, height));
+        auto pixels = std::make_shared<std::vector<float>>();
+        Case c;
+        c.run = [hdr, pixels] {
+            int w = 0, h = 0;
+            WebHDR::parse(hdr->data(), hdr->size(), *pixels, w, h);
+            gSink = gSink + (pixels->empty() ? 0.0 : (*pixels)[pixels->size() / 2]);
+        };
+        c.work = double(width) * height / 1e6;
+        c.digest = [pixels] { return pixels->empty() ? 0.0 : double((*pixels)[pixels->size() / 2]); };
+        return c;
+    }};
+}
+
+Bench simplify(const char* name, int resolution, float ratio) {
+    return {name, "Mtris", [=] {
+        auto source = std::make_shared<Mesh>();
+        addSphere(*source, 1.0, resolution, resolution);
+        source->generateNormals();
+        auto output = std::make_shared<Mesh>();
+        Case c;
+        c.run = [source, output, ratio] {
+            MeshSimplifier::simplify(*source, *output, ratio);
+            gSink = gSink + double(output->indices().size());
+        };
+        c.work = source->indices().size() / 3 / 1e6;
+        c.digest = [output] { return double(output->indices().size()); };
+        return c;
+    }};
+}
+
+// Every level of a LODMesh from one source, as a sketch's setup does
+Bench lodGenerate(const char* name, int resolution, int levels) {
+    return {name, "Mtris", [=] {
+        auto source = std::make_shared<Mesh>();
+        addSphere(*source, 1.0, resolution, resolution);
+        source->generateNormals();
+        auto lod = std::make_shared<LODMesh>();
+        Case c;
+        c.run = [source, lod, levels] {
+            lod->generate(*source, levels, 0.5f);
+            gSink = gSink + double(lod->triangleCount(lod->numLevels() - 1));
+        };
+        c.work = source->indices().size() / 3 / 1e6;
+        c.digest = [lod] {
+            double triangles = 0.0;
+            for (int i = 0; i < lod->numLevels(); i++) triangles += lod->triangleCount(i);
+            return triangles;
+        };
+        return c;
+    }};
+}
+
+// A grid of `count` LOD objects sharing one mesh; each iteration is
+// kFrames level selections with the camera flying over the grid
+Bench lodScene(const char* name, int count) {
+    constexpr int kFrames = 60;
+    return {name, "Mobjects", [=] {
+        auto source = std::make_shared<Mesh>();
+        addSphere(*source, 1.0, 32, 32);
+        source->generateNormals();
+        auto lod = std::make_shared<LODMesh>();
+        lod->generate(*source, 4, 0.5f);
+        auto group = std::make_shared<LODGroup>();
+        const int side = int(std::ceil(std::sqrt(double(count))));
+        for (int i = 0; i < count; i++) {
+            group->add(lod.get(), Vec3f(float(i % side) * 4.0f, 0.0f, float(i / side) * 4.0f));
+        }
+        auto triangles = std::make_shared<double>(0.0);
+        Case c;
+        c.run = [lod, group, side, triangles] {
+            *triangles = 0.0;
+            for (int f = 0; f < kFrames; f++) {
+                const float t = float(f) / kFrames;
+                group->update(Vec3f(t * side * 4.0f, 6.0f, side * 2.0f));
+                *triangles += group->totalTriangles();
+            }
+            gSink = gSink + *triangles;
+        };
+        c.work = double(count) * kFrames / 1e6;
+        c.digest = [triangles] { return *triangles; };
+        return c;
+    }};
+}
+
+// QualityManager in Auto over kFrames synthetic frames whose GPU cost
+// swings above and below the budget, so every controller path runs
+Bench qualityUpdate(const char* name) {
+    constexpr int kFrames = 10000;
+    return {name, "Mframes", [=] {
+        auto quality = std::make_shared<QualityManager>();
+        Case c;
+        c.run = [quality] {
+            quality->setPreset(QualityPreset::Auto);
+            quality->setTargetFPS(60.0f);
+            quality->setRenderScaleRange(0.5f, 1.0f);
+            FrameTimings timings;
+            for (int f = 0; f < kFrames; f++) {
+                timings.cpuMs = 6.0f + 2.0f * float((f * 7) % 5) / 5.0f;
+                timings.gpuMs = 16.0f + 8.0f * std::sin(f * 0.005f);
+                timings.renderScale = quality->resolutionScale();
+                timings.intervalMs = std::max(timings.cpuMs, timings.gpuMs);
+                quality->update(timings.intervalMs / 1000.0, timings);
+            }
+            gSink = gSink + quality->resolutionScale();
+        };
+        c.work = kFrames / 1e6;
+        c.digest = [quality] { return double(quality->resolutionScale()) + 10.0 * int(quality->preset()); };
+        return c;
+    }};
+}
+
+// `animate`: every iteration moves the vertices (re-upload); otherwise the
+// mesh is unchanged and prepareMesh only verifies its cached copy
+Bench prepareMesh(const char* name, int n, bool animate) {
+    return {name, "Mverts", [=] {
+        auto backend = std::make_shared<NullBackend>();
+        auto adapter = std::make_shared<WebMeshAdapter>();
+        adapter->setBackend(backend.get());
+        auto mesh = std::make_shared<Mesh>();
+        makeGridMesh(*mesh, n);
+        auto frame = std::make_shared<int>(0);
+        Case c;
+        c.run = [backend, adapter, mesh, frame, animate] {
+            if (animate) {
+                float t = 0.1f * float(++*frame);
+                auto& v = mesh->vertices();
+                for (size_t i = 0; i < v.size(); i++) v[i].z = 0.05f * std::sin(t + 0.01f * float(i));
+            }
+            adapter->beginFrame();
+            gSink = gSink + (adapter->prepareMesh(*mesh) ? 1.0 : 0.0) + double(backend->bytesUploaded);
+        };
+        c.work = mesh->vertices().size() / 1e6;
+        return c;
+    }};
+}
+
+Bench procedural(const char* name, int size, std::function<void(ProceduralTexture&, int)> generate) {
+    return {name, "Mpixels", [=] {
+        auto tex = std::make_shared<ProceduralTexture>();
+        tex->setSeed(1234);
+        Case c;
+        c.run = [tex, size, generate] {
+            generate(*tex, size);
+            gSink = gSink + tex->pixels()[size_t(size) * size * 2];
+        };
+        c.work = double(size) * size / 1e6;
+        c.digest = [tex, size] {
+            const auto& p = tex->pixels();
+            return double(p[0]) + p[size_t(size) * size * 2] + p[p.size() - 4];
+        };
+        return c;
+    }};
+}
+
+// One 128-frame stereo block per call, over kBlocks blocks
+Bench audioKernel(const char* name, std::function<void(float* const*, const float* const*, int)> kernel) {
+    constexpr int kFrames = 128, kBlocks = 4096;
+    return {name, "Msamples", [=] {
+        auto buffers = std::make_shared<std::vector<float>>(size_t(4) * kFrames);
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+        for (float& s : *buffers) s = dist(rng);
+        Case c;
+        c.run = [buffers, kernel] {
+            float* b = buffers->data();
+            float* const dst[2] = {b, b + kFrames};
+            const float* const src[2] = {b + 2 * kFrames, b + 3 * kFrames};
+            for (int i = 0; i < kBlocks; i++) kernel(dst, src, kFrames);
+            gSink = gSink + b[kFrames - 1];
+        };
+        c.work = double(kFrames) * 2 * kBlocks / 1e6;
+        return c;
+    }};
+}
+
+std::vector<Bench> allBenches() {
+    std::vector<Bench> list;
+    list.push_back(objParse("obj.parse_v", 300, false, false));
+    list.push_back(objParse("obj.parse_v_vt_vn", 300, true, true));
+    list.push_back(gltfParse("gltf.parse_grid", 300));
+    list.push_back(hdrDecode("hdr.decode_1024x512", 1024, 512));
+    list.push_back(simplify("lod.simplify_50", 128, 0.5f));
+    list.push_back(simplify("lod.simplify_10", 128, 0.1f));
+    list.push_back(lodGenerate("lod.generate_4", 96, 4));
+    list.push_back(lodScene("scene.lod_group_1k", 1024));
+    list.push_back(qualityUpdate("quality.update_auto"));
+    list.push_back(prepareMesh("mesh_adapter.prepare_unchanged", 256, false));
+    list.push_back(prepareMesh("mesh_adapter.prepare_animated", 256, true));
+    list.push_back(procedural("procedural.perlin_512", 512, [](ProceduralTexture& t, int s) {
+        t.perlinNoise(s, s);
+    }));
+    list.push_back(procedural("procedural.worley_512", 512, [](ProceduralTexture& t, int s) {
+        t.worleyNoise(s, s);
+    }));
+    list.push_back(procedural("procedural.marble_512", 512, [](ProceduralTexture& t, int s) {
+        t.marble(s, s);
+    }));
+    list.push_back(procedural("procedural.normal_map_512", 512, [](ProceduralTexture& t, int s) {
+        t.fbmNoise(s, s);
+        t.normalMapFromHeight(s, s);
+    }));
+    list.push_back(audioKernel("dsp.gain", [](float* const* dst, const float* const*, int n) {
+        audio_simd::gain(dst[0], 0.9f, n);
+        audio_simd::gain(dst[1], 1.1f, n);
+    }));
+    list.push_back(audioKernel("dsp.mix_ramp", [](float* const* dst, const float* const* src, int n) {
+        audio_simd::mixRamp(dst[0], src[0], 0.2f, 0.4f, n);
+        audio_simd::mixRamp(dst[1], src[1], 0.4f, 0.2f, n);
+    }));
+    list.push_back(audioKernel("dsp.interleave", [](float* const* dst, const float* const* src, int n) {
+        audio_simd::interleave(dst[0], src, 2, n / 2);
+        audio_simd::deinterleave(dst, src[0], 2, n / 2);
+    }));
+    return list;
+}
+
+// ─── Driver ──────────────────────────────────────────────────────────────────
+
+Result measure(const Bench& bench, int minIterations, double budgetMs) {
+    Case c = bench.make();
+    using Clock = std::chrono::steady_clock;
+    auto elapsedMs = [](Clock::time_point t0) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    };
+
+    // Warm-up: caches, allocator and (in wasm) tier-up
+    const auto warm = Clock::now();
+    for (int i = 0; i < 3 && elapsedMs(warm) < budgetMs / 4; i++) c.run();
+
+    std::vector<double> times;
+    const auto start = Clock::now();
+    while ((int)times.size() < minIterations || elapsedMs(start) < budgetMs) {
+        const auto t0 = Clock::now();
+        c.run();
+        times.push_back(elapsedMs(t0));
+        if (times.size() >= 1000) break;
+    }
+
+    std::vector<double> sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double t : times) sum += t;
+    Result r{bench.name, bench.unit, int(times.size()), sorted.front(),
+             sorted[sorted.size() / 2], sum / times.size(), 0.0, bool(c.digest), c.digest ? c.digest() : 0.0};
+    r.throughput = r.medianMs > 0.0 ? c.work / (r.medianMs / 1000.0) : 0.0;
+    return r;
+}
+
+const char* simdName() {
+#if defined(__wasm_simd128__)
+    return "wasm-simd128";
+#else
+    return "scalar";
+#endif
+}
+
+const char* platformName() {
+#if defined(__EMSCRIPTEN__)
+    return "wasm";
+#else
+    return "native";
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int minIterations = 10;
+    double budgetMs = 2000.0;
+    std::string filterText;
+    std::string outPath = "allolib_bench.json";
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--quick")) {
+            minIterations = 3;
+            budgetMs = 300.0;
+        } else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) {
+            filterText = argv[++i];
+        } else if (!std::strcmp(argv[i], "--out") && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: allolib_bench [--quick] [--filter text] [--out file.json]\n");
+            return 2;
+        }
+    }
+
+#ifdef __EMSCRIPTEN__
+    // Parse time only; native_compat's loaders don't optimize either
+    MeshOptimizer::setAutoOptimize(false);
+#endif
+
+    std::vector<Result> results;
+    for (const Bench& bench : allBenches()) {
+        if (!filterText.empty() && bench.name.find(filterText) == std::string::npos) continue;
+        results.push_back(measure(bench, minIterations, budgetMs));
+    }
+
+    std::fprintf(stderr, "\n%-32s %6s %10s %10s %14s\n", "benchmark", "iters", "best ms", "median ms",
+                 "throughput");
+    for (const Result& r : results) {
+        std::fprintf(stderr, "%-32s %6d %10.3f %10.3f %10.2f %s/s\n", r.name.c_str(), r.iterations,
+                     r.bestMs, r.medianMs, r.throughput, r.unit);
+    }
+
+    FILE* out = std::fopen(outPath.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "allolib_bench: cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+    std::fprintf(out, "{\n  \"version\": 1,\n  \"platform\": \"%s\",\n  \"simd\": \"%s\",\n"
+                      "  \"minIterations\": %d,\n  \"budgetMs\": %.0f,\n  \"results\": [\n",
+                 platformName(), simdName(), minIterations, budgetMs);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        char digest[48] = "";
+        if (r.hasDigest) std::snprintf(digest, sizeof(digest), ", \"digest\": %.9g", r.digest);
+        std::fprintf(out, "    {\"bench\": \"%s\", \"iterations\": %d, \"bestMs\": %.4f, \"medianMs\": %.4f, "
+                          "\"meanMs\": %.4f, \"throughput\": %.3f, \"unit\": \"%s/s\"%s}%s\n",
+                     r.name.c_str(), r.iterations, r.bestMs, r.medianMs, r.meanMs, r.throughput, r.unit, digest,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    std::fclose(out);
+    std::fprintf(stderr, "\nWrote %s\n", outPath.c_str());
+    return 0;
+}
@@ -0,0 +1,288 @@
+/**
+ * DSP Kernel Benchmark
+ *
+ * ns/sample for the DSP the Studio's audio examples lean on: Gamma
+ * oscillators and filters, WebConvolver, PVResynth, AudioFeatureExtractor
+ * and BatchSpatializer, each at several block sizes. Headless: no window,
+ * no audio device. Results go to stdout as one JSON object for regression
+ * tracking, with a readable table on stderr.
+ *
+ * Web (Node), built by CMake with BUILD_DSP_BENCH=ON:
+ *   emcmake cmake -B build -DBUILD_DSP_BENCH=ON
+ *   cmake --build build --target dsp_bench
+ *   node build/dsp_bench.js > bench.json
+ *
+ * Native, from the same source (the kernels take their scalar paths):
+ *   g++ -O2 -std=c++17 -Iinclude -I../allolib/include -I../allolib/external/Gamma \
+ *       src/dsp_bench.cpp ../allolib/external/Gamma/src/{Conversion,DFT,Domain,\
+ *       FFT_fftpack,arr,fftpack++1,fftpack++2,scl}.cpp -o dsp_bench
+ *   ./dsp_bench > bench.json
+ *
+ * Options:
+ *   --quick            ~8x fewer samples per measurement
+ *   --filter <text>    only kernels whose name contains text
+ *   --blocks 64,128    block sizes (default 64,128,256,512)
+ *
+ * Each measurement is the best of three runs over the same number of
+ * samples, after a warm-up; realtime is how many times faster than the
+ * audio clock the kernel runs at 48 kHz.
+ */
+
+#include "Gamma/Delay.h"
+#include "Gamma/Domain.h"
+#include "Gamma/Filter.h"
+#include "Gamma/Noise.h"
+#include "Gamma/Oscillator.h"
+
+#include "_studio_shared/audio_features.hpp"
+#include "_studio_shared/batch_spatializer.hpp"
+#include "_studio_shared/pv_resynth.hpp"
+#include "_studio_shared/web_convolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr float kSampleRate = 48000.f;
+constexpr int kMaxBlock = 1024;
+
+// Outputs are summed into here so the work can't be optimised away
+volatile float gSink = 0.f;
+
+using Kernel = std::function<void(int)>;  // Process one block of n frames
+
+struct Bench {
+    std::string name;
+    // Builds fresh state for one block size
+    std::function<Kernel(int block)> make;
+};
+
+struct Result {
+    std::string name;
+    int block;
+    double nsPerSample;
+};
+
+struct Buffers {
+    std::vector<float> in, out, outR;
+    Buffers() : in(kMaxBlock), out(kMaxBlock), outR(kMaxBlock) {
+        gam::NoiseWhite<> noise(1234);
+        for (float& s : in) s = 0.5f * noise();
+    }
+    void sink(int n) { gSink = gSink + out[n - 1] + outR[n - 1]; }
+};
+
+Buffers& buffers() {
+    static Buffers b;
+    return b;
+}
+
+// Exponentially decaying noise, like a room response
+std::vector<float> makeIR(float seconds) {
+    std::vector<float> ir(size_t(seconds * kSampleRate));
+    gam::NoiseWhite<> noise(99);
+    const float decay = -6.9f / float(ir.size());  // -60 dB at the end
+    for (size_t i = 0; i < ir.size(); ++i) ir[i] = noise() * std::exp(decay * float(i)) * 0.1f;
+    return ir;
+}
+
+template <class Osc>
+Bench oscillator(const char* name, float freq) {
+    return {name, [freq](int) {
+        auto osc = std::make_shared<Osc>(freq);
+        return Kernel([osc](int n) {
+            Buffers& b = buffers();
+            for (int i = 0; i < n; ++i) b.out[i] = (*osc)();
+            b.sink(n);
+        });
+    }};
+}
+
+template <class Filter>
+Bench filter(const char* name, std::function<std::shared_ptr<Filter>()> make) {
+    return {name, [make](int) {
+        auto f = make();
+        return Kernel([f](int n) {
+            Buffers& b = buffers();
+            for (int i = 0; i < n; ++i) b.out[i] = (*f)(b.in[i]);
+            b.sink(n);
+        });
+    }};
+}
+
+Bench convolver(const char* name, float irSeconds) {
+    return {name, [irSeconds](int block) {
+        static std::vector<float> ir;  // Shared between block sizes
+        if (ir.size() != size_t(irSeconds * kSampleRate)) ir = makeIR(irSeconds);
+        auto conv = std::make_shared<studio::WebConvolver>();
+        conv->setBlockSize(size_t(block));
+        conv->loadIR(ir);
+        return Kernel([conv](int n) {
+            Buffers& b = buffers();
+            conv->process(b.in.data(), b.out.data(), size_t(n));
+            b.sink(n);
+        });
+    }};
+}
+
+Bench spatializer(const char* name, int sources) {
+    return {name, [sources](int block) {
+        auto sp = std::make_shared<studio::BatchSpatializer>(sources, kSampleRate, block);
+        auto ins = std::make_shared<std::vector<const float*>>(size_t(sources), nullptr);
+        for (int s = 0; s < sources; ++s) {
+            const int id = sp->addSource();
+            // Rings at growing distance, so every tier gets work
+            const float a = 6.2831853f * float(s) / float(sources);
+            const float r = 1.f + 40.f * float(s) / float(sources);
+            sp->setPosition(id, r * std::cos(a), 0.f, r * std::sin(a));
+            (*ins)[id] = buffers().in.data();
+        }
+        return Kernel([sp, ins](int n) {
+            Buffers& b = buffers();
+            std::memset(b.out.data(), 0, sizeof(float) * n);
+            std::memset(b.outR.data(), 0, sizeof(float) * n);
+            sp->process(ins->data(), b.out.data(), b.outR.data(), n);
+            b.sink(n);
+        });
+    }};
+}
+
+std::vector<Bench> allBenches() {
+    std::vector<Bench> list;
+    list.push_back(oscillator<gam::Sine<>>("gamma.sine", 440.f));
+    list.push_back(oscillator<gam::Saw<>>("gamma.saw", 220.f));
+    list.push_back(oscillator<gam::Square<>>("gamma.square", 220.f));
+    list.push_back(filter<gam::Biquad<>>("gamma.biquad_lowpass", [] {
+        return std::make_shared<gam::Biquad<>>(1200.f, 0.7f, gam::LOW_PASS);
+    }));
+    list.push_back(filter<gam::OnePole<>>("gamma.onepole", [] {
+        return std::make_shared<gam::OnePole<>>(200.f);
+    }));
+    list.push_back(filter<gam::Delay<float, gam::ipl::Cubic>>("gamma.delay_cubic", [] {
+        return std::make_shared<gam::Delay<float, gam::ipl::Cubic>>(0.5f, 0.0123f);
+    }));
+    list.push_back(convolver("studio.convolver_1s", 1.f));
+    list.push_back(convolver("studio.convolver_6s", 6.f));
+    list.push_back({"studio.pv_resynth_2048", [](int) {
+        auto pv = std::make_shared<studio::PVResynth>(2048, 512, kSampleRate);
+        return Kernel([pv](int n) {
+            Buffers& b = buffers();
+            pv->analyze(b.in.data(), n);
+            pv->scaleMagnitudes(0.9f);
+            pv->resynthesize(b.out.data(), n);
+            b.sink(n);
+        });
+    }});
+    list.push_back({"studio.features_full", [](int) {
+        auto fx = std::make_shared<studio::AudioFeatureExtractor>(2048, 512, kSampleRate);
+        fx->enableMFCC(true);
+        fx->enablePitch(true);
+        return Kernel([fx](int n) {
+            Buffers& b = buffers();
+            fx->processBlock(b.in.data(), n);
+            studio::FeatureFrame f;
+            if (fx->latest(f)) gSink = gSink + f.rms;
+        });
+    }});
+    list.push_back(spatializer("studio.spatializer_64", 64));
+    list.push_back(spatializer("studio.spatializer_256", 256));
+    return list;
+}
+
+double measure(const Kernel& run, int block, long samples) {
+    const long blocks = std::max(1L, samples / block);
+    for (long i = 0; i < std::min(blocks, 32L); ++i) run(block);  // Warm-up
+
+    using Clock = std::chrono::steady_clock;
+    double best = 1e300;
+    for (int rep = 0; rep < 3; ++rep) {
+        const auto t0 = Clock::now();
+        for (long i = 0; i < blocks; ++i) run(block);
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        best = std::min(best, ns / (double(blocks) * block));
+    }
+    return best;
+}
+
+std::vector<int> parseBlocks(const char* arg) {
+    std::vector<int> blocks;
+    for (const char* p = arg; *p;) {
+        const int b = std::atoi(p);
+        if (b > 0 && b <= kMaxBlock) blocks.push_back(b);
+        while (*p && *p != ',') ++p;
+        if (*p == ',') ++p;
+    }
+    return blocks;
+}
+
+const char* simdName() {
+#if defined(__wasm_simd128__)
+    return "wasm-simd128";
+#else
+    return "scalar";
+#endif
+}
+
+const char* platformName() {
+#if defined(__EMSCRIPTEN__)
+    return "wasm";
+#else
+    return "native";
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long samples = 1L << 21;  // ~44 s of audio per measurement
+    std::string filterText;
+    std::vector<int> blocks = {64, 128, 256, 512};
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--quick")) {
+            samples = 1L << 18;
+        } else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) {
+            filterText = argv[++i];
+        } else if (!std::strcmp(argv[i], "--blocks") && i + 1 < argc) {
+            blocks = parseBlocks(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: dsp_bench [--quick] [--filter text] [--blocks 64,128,...]\n");
+            return 2;
+        }
+    }
+
+    gam::sampleRate(kSampleRate);
+
+    std::vector<Result> results;
+    std::fprintf(stderr, "%-28s %6s %12s %12s\n", "kernel", "block", "ns/sample", "x realtime");
+    for (const Bench& bench : allBenches()) {
+        if (!filterText.empty() && bench.name.find(filterText) == std::string::npos) continue;
+        for (int block : blocks) {
+            const Kernel run = bench.make(block);
+            const double ns = measure(run, block, samples);
+            results.push_back({bench.name, block, ns});
+            std::fprintf(stderr, "%-28s %6d %12.2f %12.1f\n", bench.name.c_str(), block, ns,
+                         1e9 / (ns * kSampleRate));
+        }
+    }
+
+    std::printf("{\n  \"version\": 1,\n  \"platform\": \"%s\",\n  \"simd\": \"%s\",\n"
+                "  \"sampleRate\": %d,\n  \"samplesPerMeasurement\": %ld,\n  \"results\": [\n",
+                platformName(), simdName(), int(kSampleRate), samples);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::printf("    {\"kernel\": \"%s\", \"block\": %d, \"nsPerSample\": %.3f, \"realtime\": %.2f}%s\n",
+                    r.name.c_str(), r.block, r.nsPerSample, 1e9 / (r.nsPerSample * kSampleRate),
+                    i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+    return 0;
+}
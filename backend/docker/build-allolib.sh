@@ -6,6 +6,39 @@
 set -e
 
 BACKEND="${1:-all}"  # webgl2, webgpu, or all (default)
+AUDIO_MODE="${2:-main}"  # main (default), worklet (onSound on the audio thread) or threads (audio graph and job pools)
+LINK_MODE="${3:-static}"  # static (default) or side (position-independent, for the side-module runtime)
+
+# Worklet and threads builds need shared memory, so they get their own library directories
+AUDIO_SUFFIX=""
+AUDIO_FLAG="-DALLOLIB_AUDIO_WORKLET=OFF -DALLOLIB_AUDIO_THREADS=OFF -DALLOLIB_JOB_THREADS=OFF"
+if [ "$AUDIO_MODE" = "worklet" ]; then
+    AUDIO_SUFFIX="-worklet"
+    AUDIO_FLAG="-DALLOLIB_AUDIO_WORKLET=ON -DALLOLIB_AUDIO_THREADS=OFF -DALLOLIB_JOB_THREADS=OFF"
+elif [ "$AUDIO_MODE" = "threads" ]; then
+    AUDIO_SUFFIX="-threads"
+    AUDIO_FLAG="-DALLOLIB_AUDIO_WORKLET=OFF -DALLOLIB_AUDIO_THREADS=ON -DALLOLIB_JOB_THREADS=ON"
+elif [ "$AUDIO_MODE" != "main" ]; then
+    echo "[ERROR] Unknown audio mode: $AUDIO_MODE"
+    echo "[INFO] Valid options: main, worklet, threads"
+    exit 1
+fi
+
+# Side-module builds link the libraries into a shared main module, which
+# needs position-independent code; they get their own library directories
+PIC_FLAG="-DALLOLIB_PIC=OFF"
+if [ "$LINK_MODE" = "side" ]; then
+    if [ "$AUDIO_MODE" != "main" ]; then
+        echo "[ERROR] Side-module builds support main-thread audio only"
+        exit 1
+    fi
+    AUDIO_SUFFIX="$AUDIO_SUFFIX-pic"
+    PIC_FLAG="-DALLOLIB_PIC=ON"
+elif [ "$LINK_MODE" != "static" ]; then
+    echo "[ERROR] Unknown link mode: $LINK_MODE"
+    echo "[INFO] Valid options: static, side"
+    exit 1
+fi
 
 ALLOLIB_DIR="${ALLOLIB_DIR:-/app/allolib}"
 ALLOLIB_WASM_DIR="${ALLOLIB_WASM_DIR:-/app/allolib-wasm}"
@@ -13,6 +46,8 @@ ALLOLIB_WASM_DIR="${ALLOLIB_WASM_DIR:-/app/allolib-wasm}"
 echo "[INFO] ================================================"
 echo "[INFO] Building AlloLib for WebAssembly"
 echo "[INFO] Backend: $BACKEND"
+echo "[INFO] Audio mode: $AUDIO_MODE"
+echo "[INFO] Link mode: $LINK_MODE"
 echo "[INFO] ================================================"
 echo "[INFO] AlloLib source: $ALLOLIB_DIR"
 echo "[INFO] AlloLib-WASM config: $ALLOLIB_WASM_DIR"
@@ -20,8 +55,8 @@ echo "[INFO] AlloLib-WASM config: $ALLOLIB_WASM_DIR"
 build_backend() {
     local backend_type=$1
     local backend_flag=$2
-    local build_dir="/app/build-wasm-$backend_type"
-    local lib_dir="/app/lib-$backend_type"
+    local build_dir="/app/build-wasm-$backend_type$AUDIO_SUFFIX"
+    local lib_dir="/app/lib-$backend_type$AUDIO_SUFFIX"
 
     echo ""
     echo "[INFO] ================================================"
@@ -33,6 +68,8 @@ build_backend() {
     # Force rebuild
     echo "[INFO] Removing old libraries..."
     rm -f "$lib_dir/libal_web.a" "$lib_dir/libGamma.a" 2>/dev/null || true
+    # compile.sh rebuilds the precompiled header against the new headers
+    rm -f "$lib_dir/al_web_pch.hpp.pch" 2>/dev/null || true
 
     # Create build directory
     mkdir -p "$build_dir"
@@ -44,6 +81,8 @@ build_backend() {
         -DCMAKE_BUILD_TYPE=Release \
         -DBUILD_TEST_APP=OFF \
         $backend_flag \
+        $AUDIO_FLAG \
+        $PIC_FLAG \
         -G Ninja
 
     # Build
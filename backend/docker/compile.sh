@@ -5,18 +5,49 @@
 
 set -e
 
+# Warm mode: `compile.sh --warm <backend> <audio mode> [<link mode>]` builds
+# the libraries, the precompiled header, Emscripten's system libraries and
+# (side-module mode) the shared runtime by compiling an empty sketch, so the
+# first real job of a compile worker starts hot.
+if [ "$1" = "--warm" ]; then
+    WARM_DIR="$(mktemp -d /tmp/al-warm.XXXXXX)"
+    echo 'int main() { return 0; }' > "$WARM_DIR/main.cpp"
+    export AL_RUNTIME_DIR="${AL_RUNTIME_DIR:-/app/output/.runtime}"
+    status=0
+    bash "$0" "$WARM_DIR/main.cpp" "$WARM_DIR/out" warm "${2:-webgl2}" "${3:-main}" "${4:-static}" || status=$?
+    rm -rf "$WARM_DIR"
+    exit $status
+fi
+
+now_ms() { date +%s%3N; }
+
 SOURCE_FILE="${1:-/app/source/main.cpp}"
 OUTPUT_DIR="${2:-/app/output}"
 JOB_ID="${3:-default}"
 BACKEND="${4:-webgl2}"  # webgl2 or webgpu
+AUDIO_MODE="${5:-main}"  # main, worklet (onSound on the Web Audio thread) or threads (audio graph pool)
+LINK_MODE="${6:-static}"  # static (one wasm per sketch) or side (sketch as a side module of a shared runtime)
 
 ALLOLIB_DIR="${ALLOLIB_DIR:-/app/allolib}"
 ALLOLIB_WASM_DIR="${ALLOLIB_WASM_DIR:-/app/allolib-wasm}"
 GAMMA_DIR="${GAMMA_DIR:-/app/allolib/external/Gamma}"
 AL_EXT_DIR="${AL_EXT_DIR:-/app/al_ext}"
 
-# Select library directory based on backend
-LIB_DIR="/app/lib-$BACKEND"
+# Select library directory based on backend (worklet/threads builds link their own)
+AUDIO_SUFFIX=""
+if [ "$AUDIO_MODE" = "worklet" ] || [ "$AUDIO_MODE" = "threads" ]; then
+    AUDIO_SUFFIX="-$AUDIO_MODE"
+fi
+# Side-module builds link against position-independent libraries kept in
+# their own directory; the shared-memory audio modes always link statically
+if [ "$LINK_MODE" = "side" ] && [ "$AUDIO_MODE" != "main" ]; then
+    echo "[WARN] Side-module linking supports main-thread audio only, linking statically"
+    LINK_MODE="static"
+fi
+if [ "$LINK_MODE" = "side" ]; then
+    AUDIO_SUFFIX="$AUDIO_SUFFIX-pic"
+fi
+LIB_DIR="/app/lib-$BACKEND$AUDIO_SUFFIX"
 
 echo "[INFO] ================================================"
 echo "[INFO] AlloLib WASM Compilation"
@@ -25,6 +56,8 @@ echo "[INFO] Job ID: $JOB_ID"
 echo "[INFO] Source: $SOURCE_FILE"
 echo "[INFO] Output: $OUTPUT_DIR"
 echo "[INFO] Backend: $BACKEND"
+echo "[INFO] Audio mode: $AUDIO_MODE"
+echo "[INFO] Link mode: $LINK_MODE"
 echo "[INFO] Library: $LIB_DIR"
 
 # Validate backend
@@ -34,28 +67,42 @@ if [ "$BACKEND" != "webgl2" ] && [ "$BACKEND" != "webgpu" ]; then
     exit 1
 fi
 
+if [ "$AUDIO_MODE" != "main" ] && [ "$AUDIO_MODE" != "worklet" ] && [ "$AUDIO_MODE" != "threads" ]; then
+    echo "[ERROR] Invalid audio mode: $AUDIO_MODE"
+    echo "[INFO] Valid options: main, worklet, threads"
+    exit 1
+fi
+
+if [ "$LINK_MODE" != "static" ] && [ "$LINK_MODE" != "side" ]; then
+    echo "[ERROR] Invalid link mode: $LINK_MODE"
+    echo "[INFO] Valid options: static, side"
+    exit 1
+fi
+
 # Build AlloLib if not already built for this backend
 if [ ! -f "$LIB_DIR/libal_web.a" ]; then
-    echo "[INFO] AlloLib not built for $BACKEND, building..."
-    /app/build-allolib.sh "$BACKEND"
+    echo "[INFO] AlloLib not built for $BACKEND ($AUDIO_MODE audio, $LINK_MODE link), building..."
+    /app/build-allolib.sh "$BACKEND" "$AUDIO_MODE" "$LINK_MODE"
 fi
 
 # Create output directory
 mkdir -p "$OUTPUT_DIR"
 
-# Base Emscripten compilation flags
+# Base Emscripten compilation flags. EXPORTED_FUNCTIONS lists core entry
+# points only; optional components (auto-LOD, the parameter server and OSC,
+# glTF) are linked, with their EMSCRIPTEN_KEEPALIVE exports, only when the
+# sketch references them.
 EMCC_FLAGS=(
     -O2
     -std=c++17
+    -msimd128
     -sUSE_GLFW=3
     -sALLOW_MEMORY_GROWTH=1
     -sEXPORTED_RUNTIME_METHODS="['ccall','cwrap','UTF8ToString','stringToUTF8','FS','IDBFS','addRunDependency','removeRunDependency']"
-    -sEXPORTED_FUNCTIONS="['_main','_malloc','_free','_allolib_create','_allolib_configure_backend','_allolib_start','_allolib_stop','_allolib_destroy','_allolib_process_audio','_allolib_configure_audio','_al_webgui_get_parameter_count','_al_webgui_get_parameter_name','_al_webgui_get_parameter_group','_al_webgui_get_parameter_type','_al_webgui_get_parameter_min','_al_webgui_get_parameter_max','_al_webgui_get_parameter_value','_al_webgui_get_parameter_default','_al_webgui_set_parameter_value','_al_webgui_set_parameter_string','_al_webgui_trigger_parameter','_al_webgui_set_parameter_vec3','_al_webgui_set_parameter_vec4','_al_webgui_set_parameter_pose','_al_list_dir','_al_remove_dir','_al_web_set_point_size','_al_web_get_point_size','_al_autolod_set_bias','_al_autolod_set_enabled','_al_autolod_set_budget','_al_autolod_set_mode','_al_autolod_get_triangles','_al_autolod_get_bias','_al_autolod_set_min_full_quality_distance','_al_autolod_set_distances','_al_autolod_set_distance_scale','_al_autolod_get_distance_scale','_al_autolod_set_levels','_al_autolod_get_levels','_al_autolod_set_unload_distance','_al_autolod_set_unload_enabled','_al_texture_lod_set_enabled','_al_texture_lod_get_enabled','_al_texture_lod_set_bias','_al_texture_lod_get_bias','_al_texture_lod_set_max_resolution','_al_texture_lod_get_max_resolution','_al_texture_lod_get_resolution','_al_texture_lod_get_level','_al_texture_lod_set_reference_distance','_al_texture_lod_get_reference_distance','_al_texture_lod_get_continuous']"
+    -sEXPORTED_FUNCTIONS="['_main','_malloc','_free','_allolib_create','_allolib_configure_backend','_allolib_start','_allolib_stop','_allolib_destroy','_allolib_process_audio','_allolib_configure_audio','_al_webgui_get_parameter_count','_al_webgui_get_parameter_name','_al_webgui_get_parameter_group','_al_webgui_get_parameter_index','_al_webgui_get_parameter_type','_al_webgui_get_parameter_min','_al_webgui_get_parameter_max','_al_webgui_get_parameter_value','_al_webgui_get_parameter_default','_al_webgui_set_parameter_value','_al_webgui_set_parameter_string','_al_webgui_trigger_parameter','_al_webgui_sync_table','_al_webgui_set_parameter_vec3','_al_webgui_set_parameter_vec4','_al_webgui_set_parameter_pose','_al_list_dir','_al_remove_dir','_al_web_set_point_size','_al_web_get_point_size','_al_gpu_profiler_set_enabled','_al_gpu_profiler_get_enabled','_al_gpu_profiler_is_supported','_al_gpu_profiler_get_frame_ms','_al_mesh_cache_get_entries','_al_mesh_cache_get_bytes','_al_mesh_cache_get_budget','_al_mesh_cache_get_evictions','_al_mesh_cache_set_budget','_al_mesh_cache_set_eviction_age','_al_frustum_culling_set_enabled','_al_frustum_culling_get_tested','_al_frustum_culling_get_culled','_al_frustum_culling_get_culled_vertices','_al_draw_stats_get_draws','_al_draw_stats_get_vertices','_al_audio_monitor_get_telemetry','_al_audio_monitor_get_section_name','_al_audio_monitor_reset','_al_profiler_set_enabled','_al_profiler_get_enabled','_al_profiler_set_overlay','_al_profiler_clear','_al_profiler_export_trace','_al_perf_get_frame_stats','_al_perf_reset','_allolib_audio_input_channels','_allolib_audio_input_buffer','_allolib_set_audio_latency']"
     -sMODULARIZE=1
     -sEXPORT_ES6=1
     -sENVIRONMENT='web'
-    -sASYNCIFY=1
-    -sASYNCIFY_STACK_SIZE=131072
     -sSTACK_SIZE=524288
     -sASSERTIONS=1
     -lidbfs.js
@@ -74,6 +121,23 @@ else
     EMCC_FLAGS+=(-sUSE_WEBGL2=1 -sFULL_ES3=1)
 fi
 
+# Audio worklet mode: shared memory + Wasm Audio Worklets; keep in sync with CMakeLists.txt
+if [ "$AUDIO_MODE" = "worklet" ]; then
+    echo "[INFO] Audio callback runs on the Web Audio thread (requires cross-origin isolation)"
+    EMCC_FLAGS+=(-sWASM_WORKERS=1 -sAUDIO_WORKLET=1)
+fi
+
+# Audio graph (AudioCallbackGraph) and job (JobSystem) worker pools; keep in sync with CMakeLists.txt
+if [ "$AUDIO_MODE" = "threads" ]; then
+    echo "[INFO] Audio graph nodes and asset jobs run on a pthread pool (requires cross-origin isolation)"
+    EMCC_FLAGS+=(-pthread -sPTHREAD_POOL_SIZE=8)
+fi
+
+# Side-module mode: everything, sketch included, is position-independent
+if [ "$LINK_MODE" = "side" ]; then
+    EMCC_FLAGS+=(-fPIC)
+fi
+
 # Include paths - ALLOLIB_WASM_DIR must come FIRST to override AlloLib headers
 INCLUDE_FLAGS=(
     -I"$ALLOLIB_WASM_DIR/include"
@@ -81,6 +145,7 @@ INCLUDE_FLAGS=(
     -I"$ALLOLIB_DIR/external/glfw/include"
     -I"$ALLOLIB_DIR/external/glad/include"
     -I"$ALLOLIB_DIR/external/json/include"
+    -I"$ALLOLIB_DIR/external/oscpack"
     -I"$GAMMA_DIR"
 )
 
@@ -105,21 +170,216 @@ else
     DEFS+=(-DALLOLIB_WEBGL2=1)
 fi
 
+if [ "$AUDIO_MODE" = "worklet" ]; then
+    DEFS+=(-DAL_WEB_AUDIO_WORKLET=1)
+fi
+
+if [ "$AUDIO_MODE" = "threads" ]; then
+    DEFS+=(-DAL_WEB_AUDIO_THREADS=1 -DAL_WEB_JOB_THREADS=1)
+fi
+
+# Precompiled header: al_web_pch.hpp built with exactly the flags below,
+# one per library directory (backend + audio mode). Rebuilt when any
+# header it could include is newer; built under a lock so concurrent jobs
+# don't race. AL_NO_PCH=1 compiles without it.
+PCH_HEADER="$ALLOLIB_WASM_DIR/include/al_web_pch.hpp"
+PCH_FILE="$LIB_DIR/al_web_pch.hpp.pch"
+USE_PCH=0
+if [ "${AL_NO_PCH:-0}" != "1" ] && [ -f "$PCH_HEADER" ]; then
+    pch_stale() {
+        [ ! -f "$PCH_FILE" ] && return 0
+        [ -n "$(find "$ALLOLIB_WASM_DIR/include" "$ALLOLIB_DIR/include" "$GAMMA_DIR/Gamma" \
+            -newer "$PCH_FILE" -type f -print -quit 2>/dev/null)" ]
+    }
+    if pch_stale; then
+        (
+            flock 9
+            if pch_stale; then
+                echo "[INFO] Building precompiled header for $BACKEND ($AUDIO_MODE audio)..."
+                em++ "${EMCC_FLAGS[@]}" "${INCLUDE_FLAGS[@]}" "${DEFS[@]}" \
+                    -x c++-header "$PCH_HEADER" -o "$PCH_FILE.tmp.$$" \
+                    && mv -f "$PCH_FILE.tmp.$$" "$PCH_FILE"
+                rm -f "$PCH_FILE.tmp.$$"
+            fi
+        ) 9>"$PCH_FILE.lock" || true
+    fi
+    if [ -f "$PCH_FILE" ] && ! pch_stale; then
+        USE_PCH=1
+        echo "[INFO] Using precompiled header: $PCH_FILE"
+    else
+        echo "[WARN] Precompiled header unavailable, compiling without it"
+    fi
+fi
+
 echo "[INFO] Compiling with em++..."
 echo "[INFO] Flags: ${EMCC_FLAGS[*]}"
 
 # WebControlGUI stubs file
 WEBGUI_STUBS="$ALLOLIB_WASM_DIR/src/al_WebControlGUI.cpp"
 
-# Compile
-em++ "${EMCC_FLAGS[@]}" "${INCLUDE_FLAGS[@]}" "${DEFS[@]}" \
-    "$SOURCE_FILE" \
-    "$WEBGUI_STUBS" \
-    "${LIB_FLAGS[@]}" \
-    -o "$OUTPUT_DIR/app.js"
+# wasm-opt timing: Emscripten runs binaryen from BINARYEN_ROOT, which the
+# EM_BINARYEN_ROOT override points at a shim whose wasm-opt logs its
+# run time before handing over to the real one
+BINARYEN_SHIM="/tmp/al-binaryen-shim"
+if [ ! -x "$BINARYEN_SHIM/bin/wasm-opt" ]; then
+    REAL_BINARYEN="$(em-config BINARYEN_ROOT 2>/dev/null || true)"
+    if [ -n "$REAL_BINARYEN" ] && [ -x "$REAL_BINARYEN/bin/wasm-opt" ]; then
+        mkdir -p "$BINARYEN_SHIM.tmp.$$/bin"
+        for tool in "$REAL_BINARYEN"/bin/*; do
+            ln -sf "$tool" "$BINARYEN_SHIM.tmp.$$/bin/"
+        done
+        [ -d "$REAL_BINARYEN/lib" ] && ln -sfn "$REAL_BINARYEN/lib" "$BINARYEN_SHIM.tmp.$$/lib"
+        rm -f "$BINARYEN_SHIM.tmp.$$/bin/wasm-opt"
+        cat > "$BINARYEN_SHIM.tmp.$$/bin/wasm-opt" <<SHIM
+#!/bin/bash
+start=\$(date +%s%3N)
+"$REAL_BINARYEN/bin/wasm-opt" "\$@"
+status=\$?
+[ -n "\$AL_WASM_OPT_LOG" ] && echo \$(( \$(date +%s%3N) - start )) >> "\$AL_WASM_OPT_LOG"
+exit \$status
+SHIM
+        chmod +x "$BINARYEN_SHIM.tmp.$$/bin/wasm-opt"
+        mv -T "$BINARYEN_SHIM.tmp.$$" "$BINARYEN_SHIM" 2>/dev/null || rm -rf "$BINARYEN_SHIM.tmp.$$"
+    fi
+fi
+WASM_OPT_LOG="$OUTPUT_DIR/wasm-opt.times"
+rm -f "$WASM_OPT_LOG"
+if [ -x "$BINARYEN_SHIM/bin/wasm-opt" ]; then
+    export EM_BINARYEN_ROOT="$BINARYEN_SHIM"
+    export AL_WASM_OPT_LOG="$WASM_OPT_LOG"
+fi
+
+# Compile the sketch to an object, then link it with the stubs; each stage
+# reports "[TIMING] <stage> <ms>" for the backend's metrics. The PCH is for
+# the sketch's translation unit only. A PCH the compiler rejects (e.g. a
+# header touched mid-build) falls back to a plain compile; errors in the
+# sketch itself are reported once, as usual.
+COMPILE_LOG="$OUTPUT_DIR/compile.log"
+compile_sketch() {
+    local pch_args=()
+    [ "$USE_PCH" = "1" ] && pch_args=(-include-pch "$PCH_FILE")
+    em++ "${EMCC_FLAGS[@]}" "${INCLUDE_FLAGS[@]}" "${DEFS[@]}" "${pch_args[@]}" \
+        -c "$SOURCE_FILE" -o "$OUTPUT_DIR/main.o" 2>"$COMPILE_LOG"
+}
+
+STAGE_START=$(now_ms)
+if ! compile_sketch; then
+    if [ "$USE_PCH" = "1" ] && grep -qi "precompiled\|\.pch" "$COMPILE_LOG"; then
+        echo "[WARN] Precompiled header rejected, compiling without it"
+        rm -f "$PCH_FILE"
+        USE_PCH=0
+        compile_sketch || { cat "$COMPILE_LOG" >&2; rm -f "$COMPILE_LOG"; exit 1; }
+    else
+        cat "$COMPILE_LOG" >&2
+        rm -f "$COMPILE_LOG"
+        exit 1
+    fi
+fi
+cat "$COMPILE_LOG" >&2
+rm -f "$COMPILE_LOG"
+echo "[TIMING] compile $(( $(now_ms) - STAGE_START ))"
+
+# ASYNCIFY instruments every function that could be on the stack when a
+# suspending import is called, which in a sketch is nearly all of it, the
+# draw and audio paths included. Only blocking calls need it (the
+# one-argument WebSamplePlayer::load/loadStreaming, emscripten_sleep), so
+# link with it only when the sketch's object imports one of those. If the
+# imports can't be listed, link with it to be safe. AL_ASYNCIFY=1 forces it.
+ASYNCIFY_FLAGS=()
+NEEDS_ASYNCIFY="${AL_ASYNCIFY:-0}"
+if [ "$NEEDS_ASYNCIFY" != "1" ]; then
+    if ! SKETCH_IMPORTS="$(emnm -u "$OUTPUT_DIR/main.o" 2>/dev/null)"; then
+        NEEDS_ASYNCIFY=1
+    elif grep -qE '__asyncjs__|emscripten_sleep|emscripten_wget' <<<"$SKETCH_IMPORTS"; then
+        NEEDS_ASYNCIFY=1
+    fi
+fi
+if [ "$NEEDS_ASYNCIFY" = "1" ]; then
+    echo "[INFO] Linking with ASYNCIFY"
+    ASYNCIFY_FLAGS=(-sASYNCIFY=1 -sASYNCIFY_STACK_SIZE=131072)
+    # The shared runtime is built without it, and the whole call stack
+    # (main loop included) has to be instrumented
+    if [ "$LINK_MODE" = "side" ]; then
+        echo "[INFO] ASYNCIFY needs the whole program, linking statically"
+        LINK_MODE="static"
+    fi
+fi
+
+# Side-module mode: the runtime (libal_web, Gamma and the stubs) is a main
+# module linked once per version into $RUNTIME_ROOT/<id>/al_runtime.{js,wasm},
+# the id hashing its inputs and flags so a rebuilt library gets a new URL
+# and the old one can be cached forever. Only the sketch is linked per job,
+# into user.wasm; runtime.txt tells the backend which runtime loads it.
+if [ "$LINK_MODE" = "side" ]; then
+    RUNTIME_PRE_JS="$ALLOLIB_WASM_DIR/src/al_side_runtime.js"
+    RUNTIME_ROOT="${AL_RUNTIME_DIR:-$(dirname "$OUTPUT_DIR")/.runtime}"
+    # main() and the allolib_* entry points (ALLOLIB_WEB_MAIN) are defined
+    # by the sketch, so the side module exports them, not the runtime
+    RUNTIME_FLAGS=()
+    for flag in "${EMCC_FLAGS[@]}"; do
+        case "$flag" in
+            -sEXPORTED_FUNCTIONS=*)
+                flag="$(echo "$flag" | sed -E "s/'_(main|allolib_[a-z_]+)',//g; s/,'_(main|allolib_[a-z_]+)'//g")" ;;
+        esac
+        RUNTIME_FLAGS+=("$flag")
+    done
+    RUNTIME_FLAGS+=(-sMAIN_MODULE=1 --pre-js "$RUNTIME_PRE_JS")
+    RUNTIME_ID="$BACKEND-$( { cat "$LIB_DIR/libal_web.a" "$LIB_DIR/libGamma.a" "$WEBGUI_STUBS" "$RUNTIME_PRE_JS"
+        echo "${RUNTIME_FLAGS[*]} ${DEFS[*]}"; } | sha256sum | cut -c1-16)"
+    RUNTIME_DIR="$RUNTIME_ROOT/$RUNTIME_ID"
+    if [ ! -f "$RUNTIME_DIR/al_runtime.wasm" ]; then
+        mkdir -p "$RUNTIME_ROOT"
+        (
+            flock 9
+            if [ ! -f "$RUNTIME_DIR/al_runtime.wasm" ]; then
+                echo "[INFO] Linking runtime $RUNTIME_ID..."
+                STAGE_START=$(now_ms)
+                STAGING="$RUNTIME_DIR.tmp.$$"
+                mkdir -p "$STAGING"
+                # Whole archives: the runtime can't know which symbols sketches use
+                em++ "${RUNTIME_FLAGS[@]}" "${INCLUDE_FLAGS[@]}" "${DEFS[@]}" \
+                    "$WEBGUI_STUBS" \
+                    -L"$LIB_DIR" -Wl,--whole-archive -lal_web -lGamma -Wl,--no-whole-archive \
+                    -o "$STAGING/al_runtime.js" || { rm -rf "$STAGING"; exit 1; }
+                if [ -f "$ALLOLIB_WASM_DIR/src/allolib-audio-processor.js" ]; then
+                    cp "$ALLOLIB_WASM_DIR/src/allolib-audio-processor.js" "$STAGING/"
+                fi
+                rm -rf "$RUNTIME_DIR"
+                mv -T "$STAGING" "$RUNTIME_DIR"
+                echo "[TIMING] runtime $(( $(now_ms) - STAGE_START ))"
+            fi
+        ) 9>"$RUNTIME_ROOT/$RUNTIME_ID.lock" || { echo "[ERROR] Failed to link runtime $RUNTIME_ID" >&2; exit 1; }
+    fi
+    echo "[INFO] Using runtime: $RUNTIME_DIR"
+    # wasm-opt times from the runtime link aren't the sketch's
+    rm -f "$WASM_OPT_LOG"
+fi
+
+STAGE_START=$(now_ms)
+if [ "$LINK_MODE" = "side" ]; then
+    em++ -O2 -msimd128 -fPIC -sSIDE_MODULE=1 \
+        "$OUTPUT_DIR/main.o" \
+        -o "$OUTPUT_DIR/user.wasm"
+    echo "$RUNTIME_ID" > "$OUTPUT_DIR/runtime.txt"
+else
+    em++ "${EMCC_FLAGS[@]}" "${ASYNCIFY_FLAGS[@]}" "${INCLUDE_FLAGS[@]}" "${DEFS[@]}" \
+        "$OUTPUT_DIR/main.o" \
+        "$WEBGUI_STUBS" \
+        "${LIB_FLAGS[@]}" \
+        -o "$OUTPUT_DIR/app.js"
+fi
+LINK_MS=$(( $(now_ms) - STAGE_START ))
+rm -f "$OUTPUT_DIR/main.o"
+WASM_OPT_MS=0
+if [ -f "$WASM_OPT_LOG" ]; then
+    WASM_OPT_MS=$(awk '{ s += $1 } END { print s + 0 }' "$WASM_OPT_LOG")
+    rm -f "$WASM_OPT_LOG"
+fi
+echo "[TIMING] link $(( LINK_MS - WASM_OPT_MS ))"
+echo "[TIMING] wasm-opt $WASM_OPT_MS"
 
-# Copy audio worklet processor
-if [ -f "$ALLOLIB_WASM_DIR/src/allolib-audio-processor.js" ]; then
+# Copy audio worklet processor (side-module builds load it from the runtime)
+if [ "$LINK_MODE" = "static" ] && [ -f "$ALLOLIB_WASM_DIR/src/allolib-audio-processor.js" ]; then
     cp "$ALLOLIB_WASM_DIR/src/allolib-audio-processor.js" "$OUTPUT_DIR/"
     echo "[INFO] Copied audio worklet processor"
 fi
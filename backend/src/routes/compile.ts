@@ -5,9 +5,12 @@ import {
   createCompilationJob,
   getJob,
   getCompiledFile,
+  getRuntimeFile,
   cleanupJob,
+  getCompileMetrics,
   BackendType,
 } from '../services/compiler.js'
+import { CompilePriority, QueueFullError } from '../services/compile-pool.js'
 
 export const compileRouter = Router()
 
@@ -24,11 +27,15 @@ const FileSchema = z.object({
 // Backend type schema
 const BackendSchema = z.enum(['webgl2', 'webgpu']).default('webgl2')
 
+// Queue priority: 'high' for interactive runs, 'low' for prefetches
+const PrioritySchema = z.enum(['high', 'normal', 'low']).default('normal')
+
 // New multi-file request schema
 const MultiFileRequestSchema = z.object({
   files: z.array(FileSchema).min(1).max(20),
   mainFile: z.string().default('main.cpp'),
   backend: BackendSchema,
+  priority: PrioritySchema,
 })
 
 // Single-file request schema retained to support older clients and the CLI tool.
@@ -36,6 +43,7 @@ const LegacyRequestSchema = z.object({
   source: z.string().min(1).max(100000),
   filename: z.string().default('main.cpp'),
   backend: BackendSchema,
+  priority: PrioritySchema,
 })
 
 // Submit compilation request
@@ -44,6 +52,7 @@ compileRouter.post('/', async (req: Request, res: Response) => {
     let files: Array<{ name: string; content: string }>
     let mainFile: string
     let backend: BackendType
+    let priority: CompilePriority
 
     // Check if this is a multi-file or legacy request
     if (req.body.files) {
@@ -52,16 +61,18 @@ compileRouter.post('/', async (req: Request, res: Response) => {
       files = parsed.files
       mainFile = parsed.mainFile
       backend = parsed.backend as BackendType
+      priority = parsed.priority
       logger.info(`Multi-file compilation requested: ${files.length} files, main: ${mainFile}, backend: ${backend}`)
     } else {
       const parsed = LegacyRequestSchema.parse(req.body)
       files = [{ name: parsed.filename, content: parsed.source }]
       mainFile = parsed.filename
       backend = parsed.backend as BackendType
+      priority = parsed.priority
       logger.info(`Single-file compilation requested: ${mainFile}, backend: ${backend}`)
     }
 
-    const job = await createCompilationJob(files, mainFile, backend)
+    const job = await createCompilationJob(files, mainFile, backend, priority)
 
     res.json({
       success: true,
@@ -80,6 +91,15 @@ compileRouter.post('/', async (req: Request, res: Response) => {
       return
     }
 
+    if (error instanceof QueueFullError) {
+      res.setHeader('Retry-After', '5')
+      res.status(503).json({
+        success: false,
+        error: error.message,
+      })
+      return
+    }
+
     logger.error('Compilation error:', error)
     res.status(500).json({
       success: false,
@@ -88,6 +108,11 @@ compileRouter.post('/', async (req: Request, res: Response) => {
   }
 })
 
+// Compile pool metrics: queue depth, workers, counters, stage percentiles
+compileRouter.get('/metrics', (_req: Request, res: Response) => {
+  res.json({ success: true, ...getCompileMetrics() })
+})
+
 // Get job status
 compileRouter.get('/status/:jobId', (req: Request, res: Response) => {
   const { jobId } = req.params
@@ -145,6 +170,39 @@ compileRouter.get('/output/:jobId/:filename', async (req: Request, res: Response
   res.send(file)
 })
 
+// Side-module runtimes: the id changes whenever the runtime does, so a
+// runtime URL's content never changes and browsers may cache it for good
+compileRouter.get('/runtime/:runtimeId/:filename', async (req: Request, res: Response) => {
+  const { runtimeId, filename } = req.params
+
+  if (!/^[\w-]+$/.test(runtimeId) || !/^[\w.-]+$/.test(filename)) {
+    res.status(400).json({
+      success: false,
+      error: 'Invalid runtime file',
+    })
+    return
+  }
+
+  const file = await getRuntimeFile(runtimeId, filename)
+
+  if (!file) {
+    res.status(404).json({
+      success: false,
+      error: 'File not found',
+    })
+    return
+  }
+
+  if (filename.endsWith('.wasm')) {
+    res.setHeader('Content-Type', 'application/wasm')
+  } else if (filename.endsWith('.js')) {
+    res.setHeader('Content-Type', 'application/javascript')
+  }
+  res.setHeader('Cache-Control', 'public, max-age=31536000, immutable')
+
+  res.send(file)
+})
+
 // Cleanup job
 compileRouter.delete('/:jobId', async (req: Request, res: Response) => {
   const { jobId } = req.params
@@ -0,0 +1,217 @@
+import { logger } from './logger.js'
+
+/**
+ * Compile worker pool.
+ *
+ * A fixed set of workers, each bound to a compiler container (Docker) or
+ * to this host (emcc), takes jobs from one bounded queue. Each worker
+ * starts by running `compile.sh --warm` for the configured backends, so
+ * libraries, the precompiled header and Emscripten's system libraries are
+ * built before the first student job rather than during it.
+ *
+ * Jobs are picked by effective wait: queue time plus a priority head start
+ * (high 20s, normal 10s, low 0), so interactive runs go first but queued
+ * prefetches still get their turn under sustained load. A full queue
+ * rejects new jobs with QueueFullError.
+ *
+ * Stage timings (queue, compile, link, wasm-opt, total) are kept for the
+ * last STAGE_WINDOW jobs and reported as percentiles by metrics().
+ */
+
+export type CompilePriority = 'high' | 'normal' | 'low'
+
+export interface CompileWorker {
+  id: number
+  container: string | null // null: runs compile.sh on this host
+  busy: boolean
+  ready: boolean
+  jobsRun: number
+}
+
+export class QueueFullError extends Error {
+  constructor(readonly depth: number) {
+    super(`Compile queue is full (${depth} jobs waiting)`)
+  }
+}
+
+interface QueuedTask {
+  jobId: string
+  priority: CompilePriority
+  enqueuedAt: number
+  run: (worker: CompileWorker) => Promise<void>
+  resolve: (queueMs: number) => void
+  reject: (err: Error) => void
+}
+
+export interface StageSummary {
+  count: number
+  mean: number
+  p50: number
+  p95: number
+  p99: number
+  max: number
+}
+
+const PRIORITY_HEAD_START_MS: Record<CompilePriority, number> = {
+  high: 20_000,
+  normal: 10_000,
+  low: 0,
+}
+const STAGE_WINDOW = 500
+
+export class CompilePool {
+  private readonly workers: CompileWorker[] = []
+  private readonly queue: QueuedTask[] = []
+  private readonly stages = new Map<string, number[]>()
+  private readonly counters = {
+    submitted: 0,
+    completed: 0,
+    failed: 0,
+    rejected: 0,
+    cached: 0,
+  }
+
+  constructor(
+    size: number,
+    containers: Array<string | null>,
+    private readonly maxQueue: number,
+    private readonly warm: ((worker: CompileWorker) => Promise<void>) | null
+  ) {
+    for (let i = 0; i < Math.max(1, size); i++) {
+      this.workers.push({
+        id: i,
+        container: containers[i % containers.length] ?? null,
+        busy: false,
+        ready: warm === null,
+        jobsRun: 0,
+      })
+    }
+  }
+
+  /** Warm every worker; each starts taking jobs once its warm-up ends */
+  start(): void {
+    if (!this.warm) return
+    // Workers sharing a container share its caches: warm once per container
+    const warming = new Map<string, Promise<void>>()
+    for (const worker of this.workers) {
+      const key = worker.container ?? 'local'
+      let done = warming.get(key)
+      if (!done) {
+        const started = Date.now()
+        done = this.warm(worker).then(
+          () => logger.info(`[pool] Warmed ${key} in ${Date.now() - started}ms`),
+          err => logger.warn(`[pool] Warm-up failed for ${key}: ${(err as Error).message}`)
+        )
+        warming.set(key, done)
+      }
+      done.finally(() => {
+        worker.ready = true
+        this.dispatch()
+      })
+    }
+  }
+
+  /** Throws QueueFullError when no more jobs can be accepted */
+  ensureCapacity(): void {
+    if (this.queue.length >= this.maxQueue) {
+      this.counters.rejected++
+      throw new QueueFullError(this.queue.length)
+    }
+  }
+
+  /**
+   * Queue `run` for the next free worker. Resolves with the time the job
+   * waited in the queue once `run` has finished.
+   */
+  submit(
+    jobId: string,
+    priority: CompilePriority,
+    run: (worker: CompileWorker) => Promise<void>
+  ): Promise<number> {
+    this.ensureCapacity()
+    this.counters.submitted++
+    return new Promise((resolve, reject) => {
+      this.queue.push({ jobId, priority, enqueuedAt: Date.now(), run, resolve, reject })
+      this.dispatch()
+    })
+  }
+
+  recordStages(stages: Record<string, number>, success: boolean): void {
+    if (success) this.counters.completed++
+    else this.counters.failed++
+    for (const [stage, ms] of Object.entries(stages)) {
+      let samples = this.stages.get(stage)
+      if (!samples) this.stages.set(stage, (samples = []))
+      samples.push(ms)
+      if (samples.length > STAGE_WINDOW) samples.shift()
+    }
+  }
+
+  recordCacheHit(): void {
+    this.counters.cached++
+  }
+
+  metrics() {
+    const byPriority: Record<CompilePriority, number> = { high: 0, normal: 0, low: 0 }
+    for (const task of this.queue) byPriority[task.priority]++
+    const now = Date.now()
+    const stages: Record<string, StageSummary> = {}
+    for (const [stage, samples] of this.stages) stages[stage] = summarize(samples)
+    return {
+      workers: this.workers.map(w => ({ ...w })),
+      queue: {
+        depth: this.queue.length,
+        max: this.maxQueue,
+        byPriority,
+        oldestWaitMs: this.queue.reduce((m, t) => Math.max(m, now - t.enqueuedAt), 0),
+      },
+      counters: { ...this.counters },
+      stages,
+    }
+  }
+
+  private dispatch(): void {
+    for (const worker of this.workers) {
+      if (worker.busy || !worker.ready || this.queue.length === 0) continue
+      const task = this.takeNext()
+      worker.busy = true
+      const queueMs = Date.now() - task.enqueuedAt
+      logger.info(`[pool] Worker ${worker.id} takes ${task.jobId} (${task.priority}, waited ${queueMs}ms)`)
+      task.run(worker).then(
+        () => task.resolve(queueMs),
+        err => task.reject(err as Error)
+      ).finally(() => {
+        worker.busy = false
+        worker.jobsRun++
+        this.dispatch()
+      })
+    }
+  }
+
+  private takeNext(): QueuedTask {
+    const now = Date.now()
+    let best = 0
+    let bestScore = -Infinity
+    this.queue.forEach((task, i) => {
+      const score = now - task.enqueuedAt + PRIORITY_HEAD_START_MS[task.priority]
+      if (score > bestScore) {
+        best = i
+        bestScore = score
+      }
+    })
+    return this.queue.splice(best, 1)[0]
+  }
+}
+
+function summarize(samples: number[]): StageSummary {
+  const sorted = [...samples].sort((a, b) => a - b)
+  const at = (q: number) => sorted[Math.min(sorted.length - 1, Math.floor(q * sorted.length))]
+  return {
+    count: sorted.length,
+    mean: Math.round(sorted.reduce((s, v) => s + v, 0) / sorted.length),
+    p50: at(0.5),
+    p95: at(0.95),
+    p99: at(0.99),
+    max: sorted[sorted.length - 1],
+  }
+}
@@ -1,9 +1,11 @@
-import { spawn } from 'child_process'
-import { writeFile, mkdir, readFile, rm } from 'fs/promises'
+import { spawn, execFile } from 'child_process'
+import { writeFile, mkdir, readFile, rm, readdir, copyFile, stat, rename } from 'fs/promises'
 import { join } from 'path'
-import { randomUUID } from 'crypto'
+import { randomUUID, createHash } from 'crypto'
+import { promisify } from 'util'
 import { logger } from './logger.js'
 import { broadcast } from './ws-manager.js'
+import { CompilePool, CompilePriority, CompileWorker } from './compile-pool.js'
 
 export type BackendType = 'webgl2' | 'webgpu'
 
@@ -12,10 +14,13 @@ export interface CompilationResult {
   jobId: string
   wasmUrl?: string
   jsUrl?: string
+  sideModuleUrl?: string // side-module builds: the sketch, loaded by the runtime at jsUrl
   errors?: string[]
   warnings?: string[]
   duration?: number
   backend?: BackendType
+  cached?: boolean // served from the compile cache without compiling
+  timings?: Record<string, number> // ms per stage: queue, compile, link, wasm-opt, total
 }
 
 export interface ProjectFile {
@@ -28,10 +33,12 @@ export interface CompilationJob {
   files: ProjectFile[]
   mainFile: string
   backend: BackendType
+  priority: CompilePriority
   status: 'pending' | 'compiling' | 'completed' | 'failed'
   createdAt: Date
   completedAt?: Date
   result?: CompilationResult
+  artifactDir?: string // where output files are served from, if not COMPILE_DIR/<id>
 }
 
 const jobs = new Map<string, CompilationJob>()
@@ -41,25 +48,146 @@ const USE_DOCKER = process.env.USE_DOCKER === 'true'
 const USE_EMCC = process.env.USE_EMCC === 'true'
 const COMPILER_CONTAINER = process.env.COMPILER_CONTAINER || 'allolib-compiler'
 const COMPILE_SCRIPT = process.env.COMPILE_SCRIPT || '/app/compile.sh'
+// 'worklet' runs onSound on the Web Audio thread, 'threads' runs audio graph
+// nodes and asset/generation jobs on a pthread pool; both need the frontend served cross-origin
+// isolated (COOP/COEP) for shared memory
+const AUDIO_MODES = ['main', 'worklet', 'threads']
+const AUDIO_MODE = AUDIO_MODES.includes(process.env.ALLOLIB_AUDIO_MODE || '')
+  ? process.env.ALLOLIB_AUDIO_MODE as string
+  : 'main'
+// 'side' links each sketch as a small side module loaded by a shared,
+// versioned runtime main module (libal_web, Gamma), so a compile links
+// only the sketch and browsers keep the runtime's compiled code cached.
+// Main-thread audio only; other audio modes link statically.
+const LINK_MODE = process.env.COMPILE_LINK_MODE === 'side' && AUDIO_MODE === 'main' ? 'side' : 'static'
+// compile.sh writes runtimes to <output volume>/.runtime/<id>
+const RUNTIME_DIR = join(COMPILE_DIR, '.runtime')
+
+// ── Compile cache ───────────────────────────────────────────────────────────
+// Successful builds are kept under COMPILE_CACHE_DIR/<key>, the key hashing
+// the sources, main file, backend, audio mode and the toolchain fingerprint
+// (libal_web.a, compile.sh, newest allolib-wasm header). Identical requests
+// are served from there without compiling, and requests arriving while the
+// same key is compiling wait for that compile instead of starting another.
+// Artifacts live on the shared output volume rather than in Redis: they are
+// multi-megabyte binaries the output route already serves from disk.
+const CACHE_ENABLED = process.env.COMPILE_CACHE !== 'off'
+const CACHE_DIR = process.env.COMPILE_CACHE_DIR || join(COMPILE_DIR, '.cache')
+const CACHE_MAX_ENTRIES = Number(process.env.COMPILE_CACHE_MAX_ENTRIES) || 200
+const CACHE_MAX_BYTES = (Number(process.env.COMPILE_CACHE_MAX_MB) || 2048) * 1024 * 1024
+const CACHE_FORMAT = 1 // bump when the artifact layout changes
+const TOOLCHAIN_TTL_MS = 30_000
+const LIB_ROOT = process.env.ALLOLIB_LIB_ROOT || '/app'
+const ALLOLIB_WASM_DIR = process.env.ALLOLIB_WASM_DIR || '/app/allolib-wasm'
+
+interface CacheEntry {
+  dir: string
+  bytes: number
+  lastUsed: number
+}
+
+const cacheIndex = new Map<string, CacheEntry>()
+const inFlight = new Map<string, Promise<string>>() // key -> artifact dir
+const toolchainVersions = new Map<string, { version: string | null; at: number }>()
+let cacheLoaded: Promise<void> | null = null
+const execFileAsync = promisify(execFile)
+
+// ── Worker pool ─────────────────────────────────────────────────────────────
+// COMPILE_WORKERS concurrent compiles spread over COMPILER_CONTAINERS
+// (comma-separated; defaults to COMPILER_CONTAINER), at most
+// COMPILE_QUEUE_MAX waiting. Workers warm up with compile.sh --warm for
+// each of COMPILE_WARM_BACKENDS before taking jobs.
+const POOL_SIZE = Number(process.env.COMPILE_WORKERS) || 2
+const POOL_CONTAINERS = (process.env.COMPILER_CONTAINERS || COMPILER_CONTAINER)
+  .split(',').map(c => c.trim()).filter(Boolean)
+const QUEUE_MAX = Number(process.env.COMPILE_QUEUE_MAX) || 100
+const WARM_BACKENDS = (process.env.COMPILE_WARM_BACKENDS || 'webgl2')
+  .split(',').map(b => b.trim()).filter((b): b is BackendType => b === 'webgl2' || b === 'webgpu')
+
+const pool = new CompilePool(
+  POOL_SIZE,
+  USE_DOCKER ? POOL_CONTAINERS : [null],
+  QUEUE_MAX,
+  USE_DOCKER || USE_EMCC ? warmWorker : null
+)
+pool.start()
+
+async function warmWorker(worker: CompileWorker): Promise<void> {
+  for (const backend of WARM_BACKENDS) {
+    logger.info(`[pool] Warming ${worker.container ?? 'local'} for ${backend}...`)
+    if (worker.container) {
+      await execFileAsync('docker', ['exec', worker.container, '/app/compile.sh', '--warm', backend, AUDIO_MODE, LINK_MODE],
+        { maxBuffer: 16 * 1024 * 1024 })
+    } else {
+      await execFileAsync('bash', [COMPILE_SCRIPT, '--warm', backend, AUDIO_MODE, LINK_MODE],
+        { maxBuffer: 16 * 1024 * 1024, env: { ...process.env, AL_RUNTIME_DIR: RUNTIME_DIR } })
+    }
+  }
+}
+
+/** Queue depth, worker state, counters and per-stage latency percentiles */
+export function getCompileMetrics() {
+  return pool.metrics()
+}
 
 export async function createCompilationJob(
   files: ProjectFile[],
   mainFile: string = 'main.cpp',
-  backend: BackendType = 'webgl2'
+  backend: BackendType = 'webgl2',
+  priority: CompilePriority = 'normal'
 ): Promise<CompilationJob> {
   const job: CompilationJob = {
     id: randomUUID(),
     files,
     mainFile,
     backend,
+    priority,
     status: 'pending',
     createdAt: new Date(),
   }
 
   jobs.set(job.id, job)
 
+  const key = CACHE_ENABLED ? await cacheKey(job) : null
+  if (key) {
+    const hit = await cacheLookup(key)
+    if (hit) {
+      await completeFromCache(job, hit, Date.now())
+      return job
+    }
+    const pending = inFlight.get(key)
+    if (pending) {
+      logger.info(`[${job.id}] Waiting for identical compilation in progress`)
+      job.status = 'compiling'
+      const startTime = Date.now()
+      pending.then(
+        dir => completeFromCache(job, dir, startTime),
+        err => {
+          job.status = 'failed'
+          job.completedAt = new Date()
+          job.result = { success: false, jobId: job.id, errors: [err.message] }
+        }
+      )
+      return job
+    }
+  }
+
+  // Throws QueueFullError before the job is accepted
+  try {
+    pool.ensureCapacity()
+  } catch (err) {
+    jobs.delete(job.id)
+    throw err
+  }
+
   // Start compilation asynchronously
-  compileAsync(job).catch(err => {
+  const compiled = compileAsync(job)
+  if (key) {
+    const stored = compiled.then(() => cacheStore(key, join(COMPILE_DIR, job.id)))
+    inFlight.set(key, stored)
+    stored.catch(() => {}).finally(() => inFlight.delete(key))
+  }
+  compiled.catch(err => {
     logger.error(`Compilation failed for job ${job.id}:`, err)
     job.status = 'failed'
     job.result = {
@@ -78,7 +206,6 @@ export function getJob(jobId: string): CompilationJob | undefined {
 
 async function compileAsync(job: CompilationJob): Promise<void> {
   const startTime = Date.now()
-  job.status = 'compiling'
 
   // Both dirs are Docker-mounted volumes so the compiler container can read source and write output.
   const sourceJobDir = join(SOURCE_DIR, job.id)
@@ -101,29 +228,36 @@ async function compileAsync(job: CompilationJob): Promise<void> {
 
     const mainSourceFile = join(sourceJobDir, job.mainFile)
 
-    if (USE_DOCKER) {
-      await compileWithDocker(job, mainSourceFile, outputDir)
-    } else if (USE_EMCC) {
-      await compileWithEmcc(job, mainSourceFile, outputDir)
-    } else {
-      await compileLocal(job, mainSourceFile, outputDir)
-    }
+    const timings: Record<string, number> = {}
+    timings.queue = await pool.submit(job.id, job.priority, async worker => {
+      job.status = 'compiling'
+      if (USE_DOCKER) {
+        await compileWithDocker(job, worker, timings)
+      } else if (USE_EMCC) {
+        await compileWithEmcc(job, mainSourceFile, outputDir, worker, timings)
+      } else {
+        await compileLocal(job, mainSourceFile, outputDir)
+      }
+    })
 
     const duration = Date.now() - startTime
+    timings.total = duration
+    pool.recordStages(timings, true)
 
     job.status = 'completed'
     job.completedAt = new Date()
     job.result = {
       success: true,
       jobId: job.id,
-      wasmUrl: `/api/compile/output/${job.id}/app.wasm`,
-      jsUrl: `/api/compile/output/${job.id}/app.js`,
+      ...(await artifactUrls(job.id, outputDir)),
       duration,
       backend: job.backend,
+      timings,
     }
 
     logger.info(`Compilation completed for job ${job.id} in ${duration}ms`)
   } catch (error) {
+    if (job.status === 'compiling') pool.recordStages({}, false)
     job.status = 'failed'
     job.completedAt = new Date()
     job.result = {
@@ -136,18 +270,25 @@ async function compileAsync(job: CompilationJob): Promise<void> {
   }
 }
 
+/** Collect compile.sh's "[TIMING] <stage> <ms>" lines into `timings` */
+function parseTiming(line: string, timings: Record<string, number>): void {
+  const m = /^\[TIMING\] ([\w-]+) (\d+)$/.exec(line)
+  if (m) timings[m[1]] = Number(m[2])
+}
+
 async function compileWithDocker(
   job: CompilationJob,
-  _sourceFile: string,
-  _outputDir: string
+  worker: CompileWorker,
+  timings: Record<string, number>
 ): Promise<void> {
+  const container = worker.container ?? COMPILER_CONTAINER
   return new Promise((resolve, reject) => {
     // Paths inside the compiler container (mounted volumes)
     const containerSourceFile = `/app/source/${job.id}/${job.mainFile}`
     const containerOutputDir = `/app/output/${job.id}`
 
     logger.info(`[${job.id}] Starting Docker compilation...`)
-    logger.info(`[${job.id}] Container: ${COMPILER_CONTAINER}`)
+    logger.info(`[${job.id}] Container: ${container} (worker ${worker.id})`)
     logger.info(`[${job.id}] Source: ${containerSourceFile}`)
     logger.info(`[${job.id}] Output: ${containerOutputDir}`)
     logger.info(`[${job.id}] Backend: ${job.backend}`)
@@ -156,12 +297,14 @@ async function compileWithDocker(
 
     const dockerProcess = spawn('docker', [
       'exec',
-      COMPILER_CONTAINER,
+      container,
       '/app/compile.sh',
       containerSourceFile,
       containerOutputDir,
       job.id,
       job.backend,  // Pass backend as 4th argument
+      AUDIO_MODE,
+      LINK_MODE,
     ])
 
     let stderr = ''
@@ -169,6 +312,7 @@ async function compileWithDocker(
     dockerProcess.stdout.on('data', (data) => {
       const text = data.toString()
       for (const line of text.split('\n').filter((l: string) => l.trim())) {
+        parseTiming(line.trim(), timings)
         logger.info(`[${job.id}] ${line.trim()}`)
         broadcast('compile:output', { jobId: job.id, stream: 'stdout', line: line.trim() })
       }
@@ -205,18 +349,20 @@ async function compileWithDocker(
 async function compileWithEmcc(
   job: CompilationJob,
   sourceFile: string,
-  outputDir: string
+  outputDir: string,
+  worker: CompileWorker,
+  timings: Record<string, number>
 ): Promise<void> {
   return new Promise((resolve, reject) => {
-    logger.info(`[${job.id}] Starting native emcc compilation via ${COMPILE_SCRIPT}`)
+    logger.info(`[${job.id}] Starting native emcc compilation via ${COMPILE_SCRIPT} (worker ${worker.id})`)
     logger.info(`[${job.id}] Source: ${sourceFile}`)
     logger.info(`[${job.id}] Output: ${outputDir}`)
     logger.info(`[${job.id}] Backend: ${job.backend}`)
 
     broadcast('compile:status', { jobId: job.id, status: 'compiling', backend: job.backend })
 
-    const proc = spawn('bash', [COMPILE_SCRIPT, sourceFile, outputDir, job.id, job.backend], {
-      env: { ...process.env },
+    const proc = spawn('bash', [COMPILE_SCRIPT, sourceFile, outputDir, job.id, job.backend, AUDIO_MODE, LINK_MODE], {
+      env: { ...process.env, AL_RUNTIME_DIR: RUNTIME_DIR },
     })
 
     let stderr = ''
@@ -224,6 +370,7 @@ async function compileWithEmcc(
     proc.stdout.on('data', (data) => {
       const text = data.toString()
       for (const line of text.split('\n').filter((l: string) => l.trim())) {
+        parseTiming(line.trim(), timings)
         logger.info(`[${job.id}] ${line.trim()}`)
         broadcast('compile:output', { jobId: job.id, stream: 'stdout', line: line.trim() })
       }
@@ -282,9 +429,164 @@ export default function createModule(config = {}) {
   logger.info(`[${job.id}] Mock compilation complete`)
 }
 
+/**
+ * Output URLs of a finished job. Side-module builds name their runtime in
+ * runtime.txt: the runtime is served from its versioned URL and the sketch
+ * from the job's output.
+ */
+async function artifactUrls(
+  jobId: string,
+  dir: string
+): Promise<Pick<CompilationResult, 'wasmUrl' | 'jsUrl' | 'sideModuleUrl'>> {
+  let runtimeId = ''
+  try {
+    runtimeId = (await readFile(join(dir, 'runtime.txt'), 'utf8')).trim()
+  } catch {
+    // statically linked
+  }
+  if (runtimeId) {
+    return {
+      wasmUrl: `/api/compile/runtime/${runtimeId}/al_runtime.wasm`,
+      jsUrl: `/api/compile/runtime/${runtimeId}/al_runtime.js`,
+      sideModuleUrl: `/api/compile/output/${jobId}/user.wasm`,
+    }
+  }
+  return {
+    wasmUrl: `/api/compile/output/${jobId}/app.wasm`,
+    jsUrl: `/api/compile/output/${jobId}/app.js`,
+  }
+}
+
+async function completeFromCache(job: CompilationJob, dir: string, startTime: number): Promise<void> {
+  const urls = await artifactUrls(job.id, dir)
+  job.status = 'completed'
+  job.completedAt = new Date()
+  job.artifactDir = dir
+  job.result = {
+    success: true,
+    jobId: job.id,
+    ...urls,
+    duration: Date.now() - startTime,
+    backend: job.backend,
+    cached: true,
+  }
+  pool.recordCacheHit()
+  logger.info(`[${job.id}] Served from compile cache`)
+  broadcast('compile:complete', { jobId: job.id, success: true, cached: true })
+}
+
+/**
+ * Cache key for a job, or null when the toolchain can't be identified
+ * (libraries not built yet), in which case the job is compiled uncached.
+ */
+async function cacheKey(job: CompilationJob): Promise<string | null> {
+  const toolchain = await toolchainVersion(job.backend)
+  if (!toolchain) return null
+  const hash = createHash('sha256')
+  hash.update(`v${CACHE_FORMAT}\0${job.backend}\0${AUDIO_MODE}\0${LINK_MODE}\0${toolchain}\0${job.mainFile}\0`)
+  const files = [...job.files].sort((a, b) => (a.name < b.name ? -1 : a.name > b.name ? 1 : 0))
+  for (const file of files) {
+    hash.update(`${file.name}\0${file.content.length}\0`)
+    hash.update(file.content)
+  }
+  return hash.digest('hex')
+}
+
+/**
+ * Fingerprint of what a compile depends on besides the sources: the size and
+ * mtime of libal_web.a and compile.sh, and the newest allolib-wasm header.
+ * Probed in the compiler container (Docker) or on this host (emcc), and
+ * remembered for TOOLCHAIN_TTL_MS.
+ */
+async function toolchainVersion(backend: BackendType): Promise<string | null> {
+  if (!USE_DOCKER && !USE_EMCC) return 'mock'
+  const suffix = (AUDIO_MODE === 'main' ? '' : `-${AUDIO_MODE}`) + (LINK_MODE === 'side' ? '-pic' : '')
+  const libDir = `${LIB_ROOT}/lib-${backend}${suffix}`
+  const memo = toolchainVersions.get(libDir)
+  if (memo && Date.now() - memo.at < TOOLCHAIN_TTL_MS) return memo.version
+
+  const script = USE_DOCKER ? '/app/compile.sh' : COMPILE_SCRIPT
+  const headers = USE_DOCKER ? '/app/allolib-wasm/include' : `${ALLOLIB_WASM_DIR}/include`
+  const probe = `stat -c '%s:%Y' '${libDir}/libal_web.a' '${script}' && ` +
+    `find '${headers}' -type f -printf '%T@\\n' | sort -n | tail -1`
+  let version: string | null = null
+  try {
+    const { stdout } = USE_DOCKER
+      ? await execFileAsync('docker', ['exec', COMPILER_CONTAINER, 'sh', '-c', probe])
+      : await execFileAsync('sh', ['-c', probe])
+    version = stdout.trim().split('\n').join('|') || null
+  } catch {
+    version = null // libraries not built yet; compile.sh builds them
+  }
+  toolchainVersions.set(libDir, { version, at: Date.now() })
+  return version
+}
+
+async function loadCacheIndex(): Promise<void> {
+  await mkdir(CACHE_DIR, { recursive: true })
+  for (const key of await readdir(CACHE_DIR)) {
+    const dir = join(CACHE_DIR, key)
+    try {
+      const info = await stat(join(dir, 'app.js')).catch(() => stat(join(dir, 'user.wasm')))
+      cacheIndex.set(key, { dir, bytes: await dirBytes(dir), lastUsed: info.mtimeMs })
+    } catch {
+      await rm(dir, { recursive: true, force: true }) // partial or foreign entry
+    }
+  }
+}
+
+async function cacheLookup(key: string): Promise<string | null> {
+  cacheLoaded ??= loadCacheIndex().catch(err => {
+    logger.warn('Failed to load compile cache index:', err)
+  })
+  await cacheLoaded
+  const entry = cacheIndex.get(key)
+  if (!entry) return null
+  entry.lastUsed = Date.now()
+  return entry.dir
+}
+
+/** Copy a finished job's output into the cache; resolves to the entry's dir */
+async function cacheStore(key: string, outputDir: string): Promise<string> {
+  await cacheLoaded
+  const dir = join(CACHE_DIR, key)
+  const staging = `${dir}.tmp-${randomUUID()}`
+  await mkdir(staging, { recursive: true })
+  for (const name of await readdir(outputDir)) {
+    await copyFile(join(outputDir, name), join(staging, name))
+  }
+  await rm(dir, { recursive: true, force: true })
+  await rename(staging, dir)
+  cacheIndex.set(key, { dir, bytes: await dirBytes(dir), lastUsed: Date.now() })
+  await evictCache()
+  return dir
+}
+
+async function evictCache(): Promise<void> {
+  let bytes = 0
+  for (const entry of cacheIndex.values()) bytes += entry.bytes
+  if (cacheIndex.size <= CACHE_MAX_ENTRIES && bytes <= CACHE_MAX_BYTES) return
+  const byAge = [...cacheIndex.entries()].sort((a, b) => a[1].lastUsed - b[1].lastUsed)
+  for (const [key, entry] of byAge) {
+    if (cacheIndex.size <= CACHE_MAX_ENTRIES && bytes <= CACHE_MAX_BYTES) break
+    if (inFlight.has(key)) continue
+    cacheIndex.delete(key)
+    bytes -= entry.bytes
+    await rm(entry.dir, { recursive: true, force: true })
+  }
+}
+
+async function dirBytes(dir: string): Promise<number> {
+  let total = 0
+  for (const name of await readdir(dir)) total += (await stat(join(dir, name))).size
+  return total
+}
+
 export async function getCompiledFile(jobId: string, filename: string): Promise<Buffer | null> {
-  // Output files are directly in the job directory (copied from compiler output volume)
-  const filePath = join(COMPILE_DIR, jobId, filename)
+  // Output files are directly in the job directory (copied from compiler
+  // output volume), or in the compile cache for jobs served from it
+  const artifactDir = jobs.get(jobId)?.artifactDir ?? join(COMPILE_DIR, jobId)
+  const filePath = join(artifactDir, filename)
   try {
     return await readFile(filePath)
   } catch (error: any) {
@@ -295,6 +597,19 @@ export async function getCompiledFile(jobId: string, filename: string): Promise<
   }
 }
 
+/** A file of a side-module runtime, or null if there is no such file */
+export async function getRuntimeFile(runtimeId: string, filename: string): Promise<Buffer | null> {
+  const filePath = join(RUNTIME_DIR, runtimeId, filename)
+  try {
+    return await readFile(filePath)
+  } catch (error: any) {
+    if (error?.code !== 'ENOENT') {
+      logger.warn(`Failed to read runtime file ${filePath}:`, error)
+    }
+    return null
+  }
+}
+
 export async function cleanupJob(jobId: string): Promise<void> {
   const compileJobDir = join(COMPILE_DIR, jobId)
   const sourceJobDir = join(SOURCE_DIR, jobId)
@@ -5,12 +5,25 @@
  * for AlloLib applications running in the browser.
  *
  * Features:
+ * - Lock-free shared-memory ring (when the page is cross-origin isolated)
  * - Buffer queue management with underrun detection
  * - Sample-accurate scheduling via currentTime
  * - Spatial audio listener state
  * - Audio statistics reporting
  *
- * Communication with the main thread:
+ * Shared ring (processorOptions.ringBuffer, see frontend/src/services/audioRing.ts):
+ * - The main thread writes interleaved frames and advances the write index;
+ *   process() copies them out and advances the read index with Atomics, so
+ *   no message or allocation happens per block
+ * - Sends a single 'ringLow' message when the fill drops below ringLowWater
+ *   (moved by 'configure' as the runtime adapts its latency target)
+ *
+ * Input ring (processorOptions.inputRing, AudioInputRing in the same file):
+ * - process() writes inputs[0] into planar per-channel runs and advances the
+ *   write index; the main thread reads them into AudioIO's input buffers
+ * - Silence is written while nothing is connected so the fill follows time
+ *
+ * Communication with the main thread (fallback when no ring is given):
  * - Sends 'requestBuffer' messages to request audio data from WASM
  * - Receives 'audioBuffer' messages with processed audio data
  * - Receives 'setListener' messages for spatial audio positioning
@@ -31,8 +44,9 @@ class AllolibProcessor extends AudioWorkletProcessor {
 
         // Audio buffer queue with timing
         this.bufferQueue = [];
-        this.maxQueueSize = 16;  // Allow larger queue for stability
-        this.minQueueSize = 6;   // Keep more buffers queued to prevent underruns
+        // Both follow the runtime's adaptive latency target via 'configure'
+        this.maxQueueSize = processorOptions.maxQueueSize || 16;
+        this.minQueueSize = processorOptions.minQueueSize || 6;
 
         // Sample-accurate scheduling
         this.scheduledEvents = [];  // [{time: number, event: any}]
@@ -53,15 +67,126 @@ class AllolibProcessor extends AudioWorkletProcessor {
         this.lastBufferRequestTime = 0;
         this.bufferRoundtripMs = 0;
 
+        // Shared ring - layout must match frontend/src/services/audioRing.ts
+        this.ring = null;
+        if (processorOptions.ringBuffer) {
+            const sab = processorOptions.ringBuffer;
+            const headerInts = 4;
+            const data = new Float32Array(sab, headerInts * 4);
+            this.ring = {
+                header: new Int32Array(sab, 0, headerInts),
+                data: data,
+                capacity: data.length / this.outputChannels,
+                lowWater: processorOptions.ringLowWater || 512,
+                lowSignalled: false
+            };
+        }
+
+        // Input ring - planar, layout must match AudioInputRing in audioRing.ts
+        this.inputRing = null;
+        if (processorOptions.inputRing) {
+            const sab = processorOptions.inputRing;
+            const headerInts = 4;
+            const channels = processorOptions.inputChannels || 1;
+            const data = new Float32Array(sab, headerInts * 4);
+            this.inputRing = {
+                header: new Int32Array(sab, 0, headerInts),
+                data: data,
+                channels: channels,
+                capacity: data.length / channels
+            };
+        }
+
         // Handle messages from main thread
         this.port.onmessage = (event) => {
             this.handleMessage(event.data);
         };
 
         // Request initial buffers - need enough to build up queue before playback
-        for (let i = 0; i < 8; i++) {
-            this.requestBuffer();
+        if (!this.ring) {
+            for (let i = 0; i < 8; i++) {
+                this.requestBuffer();
+            }
+        }
+    }
+
+    /**
+     * Copy numFrames from the shared ring into the output channels.
+     * @returns {boolean} false on underrun (output left untouched)
+     */
+    readRing(output, numChannels, numFrames) {
+        const ring = this.ring;
+        const h = ring.header;
+        const cap = ring.capacity;
+        const w = Atomics.load(h, 0);
+        let r = Atomics.load(h, 1);
+        const fill = (w - r + cap) % cap;
+
+        // Telemetry: lowest fill since the main thread last reset it (-1)
+        const minFill = Atomics.load(h, 3);
+        if (minFill < 0 || fill < minFill) {
+            Atomics.store(h, 3, fill);
+        }
+
+        if (fill < ring.lowWater) {
+            if (!ring.lowSignalled) {
+                ring.lowSignalled = true;
+                this.port.postMessage({ type: 'ringLow', fill: fill });
+            }
+        } else {
+            ring.lowSignalled = false;
+        }
+
+        if (fill < numFrames) {
+            Atomics.add(h, 2, 1);
+            return false;
+        }
+
+        const ringChannels = this.outputChannels;
+        const data = ring.data;
+        for (let i = 0; i < numFrames; i++) {
+            const base = r * ringChannels;
+            for (let channel = 0; channel < numChannels; channel++) {
+                output[channel][i] = channel < ringChannels ? data[base + channel] : 0;
+            }
+            if (++r === cap) r = 0;
         }
+        Atomics.store(h, 1, r);
+        return true;
+    }
+
+    /**
+     * Append one quantum of input to the input ring. A mono source feeds
+     * every ring channel; a full ring drops the quantum and counts it.
+     */
+    writeInputRing(input, numFrames) {
+        const ring = this.inputRing;
+        const h = ring.header;
+        const cap = ring.capacity;
+        const w = Atomics.load(h, 0);
+        const r = Atomics.load(h, 1);
+        if (cap - 1 - (w - r + cap) % cap < numFrames) {
+            Atomics.add(h, 2, 1);
+            return;
+        }
+
+        const data = ring.data;
+        const first = Math.min(numFrames, cap - w);
+        for (let channel = 0; channel < ring.channels; channel++) {
+            const base = channel * cap;
+            const src = input && input.length > 0
+                ? input[Math.min(channel, input.length - 1)] : null;
+            if (!src) {
+                data.fill(0, base + w, base + w + first);
+                if (first < numFrames) data.fill(0, base, base + numFrames - first);
+            } else if (first === numFrames) {
+                data.set(src, base + w);
+            } else {
+                data.set(src.subarray(0, first), base + w);
+                data.set(src.subarray(first, numFrames), base);
+            }
+        }
+        Atomics.store(h, 0, (w + numFrames) % cap);
     }
 
     handleMessage(data) {
@@ -102,6 +227,11 @@ class AllolibProcessor extends AudioWorkletProcessor {
                 // Reconfigure audio settings
                 if (data.bufferSize) this.bufferSize = data.bufferSize;
                 if (data.outputChannels) this.outputChannels = data.outputChannels;
+                // Latency target changes: the queue fills up or drains
+                // gradually, so the stream itself never jumps
+                if (data.minQueueSize) this.minQueueSize = data.minQueueSize;
+                if (data.maxQueueSize) this.maxQueueSize = data.maxQueueSize;
+                if (data.ringLowWater && this.ring) this.ring.lowWater = data.ringLowWater;
                 break;
 
             case 'scheduleEvent':
@@ -125,12 +255,21 @@ class AllolibProcessor extends AudioWorkletProcessor {
      * @param {any} event - Event data to trigger
      */
     scheduleEvent(time, event) {
-        // Insert in sorted order
-        let i = 0;
-        while (i < this.scheduledEvents.length && this.scheduledEvents[i].time < time) {
-            i++;
+        const events = this.scheduledEvents;
+        // Sequencers schedule in time order: append without searching
+        if (events.length === 0 || events[events.length - 1].time <= time) {
+            events.push({ time, event });
+            return;
+        }
+        // Otherwise binary-search the first later event (keeps equal times FIFO)
+        let lo = 0;
+        let hi = events.length;
+        while (lo < hi) {
+            const mid = (lo + hi) >> 1;
+            if (events[mid].time <= time) lo = mid + 1;
+            else hi = mid;
         }
-        this.scheduledEvents.splice(i, 0, { time, event });
+        events.splice(lo, 0, { time, event });
     }
 
     /**
@@ -180,6 +319,7 @@ class AllolibProcessor extends AudioWorkletProcessor {
         this.port.postMessage({
             type: 'stats',
             queueLength: this.bufferQueue.length,
+            ringFill: this.ring ? (Atomics.load(this.ring.header, 0) - Atomics.load(this.ring.header, 1) + this.ring.capacity) % this.ring.capacity : -1,
             underrunCount: this.underrunCount,
             totalFramesProcessed: this.totalFramesProcessed,
             bufferRoundtripMs: this.bufferRoundtripMs,
@@ -207,6 +347,28 @@ class AllolibProcessor extends AudioWorkletProcessor {
         // Process scheduled events for this time window
         this.processScheduledEvents(currentTime, currentTime + bufferDuration);
 
+        if (this.inputRing) {
+            this.writeInputRing(inputs[0], numFrames);
+        }
+
+        if (this.ring) {
+            if (!this.readRing(output, numChannels, numFrames)) {
+                this.underrunCount++;
+                for (let channel = 0; channel < numChannels; channel++) {
+                    output[channel].fill(0);
+                }
+            }
+
+            this.totalFramesProcessed += numFrames;
+            this.currentSample += numFrames;
+
+            if (currentTime - this.lastStatsTime >= this.statsInterval) {
+                this.sendStats();
+                this.lastStatsTime = currentTime;
+            }
+            return true;
+        }
+
         // Get buffer from queue
         let bufferEntry = this.bufferQueue.shift();
 
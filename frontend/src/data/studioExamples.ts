@@ -5145,28 +5145,25 @@ public:
         objectManager().initMeshes();
 
         // Create some objects via ObjectManager
-        auto* obj1 = objectManager().createObject("sphere1", "Red Sphere", ObjectPrimitive::Sphere);
-        if (obj1) {
-            obj1->material.color = Color(1, 0.3, 0.3, 1);
-            obj1->material.type = MaterialType::PBR;
-            obj1->material.metallic = 0.8;
-            obj1->material.roughness = 0.2;
-        }
-
-        auto* obj2 = objectManager().createObject("cube1", "Blue Cube", ObjectPrimitive::Cube);
-        if (obj2) {
-            obj2->material.color = Color(0.3, 0.5, 1, 1);
-            obj2->material.type = MaterialType::PBR;
-            obj2->material.metallic = 0.3;
-            obj2->material.roughness = 0.6;
-        }
-
-        auto* obj3 = objectManager().createObject("torus1", "Gold Torus", ObjectPrimitive::Torus);
-        if (obj3) {
-            obj3->material.color = Color(1, 0.8, 0.2, 1);
-            obj3->material.type = MaterialType::PBR;
-            obj3->material.metallic = 0.9;
-            obj3->material.roughness = 0.1;
+        ObjectHandle obj1 = objectManager().createObject("sphere1", "Red Sphere", ObjectPrimitive::Sphere);
+        if (obj1 != kInvalidObject) {
+            objectManager().setColor(obj1, 1, 0.3, 0.3, 1);
+            objectManager().setMaterialType(obj1, MaterialType::PBR);
+            objectManager().setPBRParams(obj1, 0.8, 0.2);
+        }
+
+        ObjectHandle obj2 = objectManager().createObject("cube1", "Blue Cube", ObjectPrimitive::Cube);
+        if (obj2 != kInvalidObject) {
+            objectManager().setColor(obj2, 0.3, 0.5, 1, 1);
+            objectManager().setMaterialType(obj2, MaterialType::PBR);
+            objectManager().setPBRParams(obj2, 0.3, 0.6);
+        }
+
+        ObjectHandle obj3 = objectManager().createObject("torus1", "Gold Torus", ObjectPrimitive::Torus);
+        if (obj3 != kInvalidObject) {
+            objectManager().setColor(obj3, 1, 0.8, 0.2, 1);
+            objectManager().setMaterialType(obj3, MaterialType::PBR);
+            objectManager().setPBRParams(obj3, 0.9, 0.1);
         }
 
         // Create manual meshes as fallback
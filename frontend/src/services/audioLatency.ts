@@ -0,0 +1,103 @@
+/**
+ * Adaptive output latency
+ *
+ * Chooses how many frames the main thread keeps rendered ahead of the
+ * worklet: the shared ring's fill target, or the message queue depth on the
+ * fallback path. A fixed value is either conservative everywhere or glitchy
+ * on slow machines. This grows the target quickly when the worklet
+ * underruns or the producer stalls, and shrinks it one quantum at a time
+ * after a quiet stretch. Each time a shrink has to be undone, it waits
+ * longer before trying again.
+ *
+ * Transitions are glitch-free by construction. The worklet keeps consuming
+ * the same continuous stream, and the producer either renders further ahead
+ * (grow) or lets the queue drain (shrink); nothing is skipped or repeated.
+ *
+ * Limits come from the app (WebAudioConfig / WebApp::setAdaptiveLatency via
+ * Module.alloAudioLatency); with adaptive off the target stays put.
+ */
+
+export interface AudioLatencyLimits {
+  adaptive: boolean
+  minFrames: number
+  maxFrames: number
+}
+
+/** What the producer saw over one stats window */
+export interface AudioLatencyWindow {
+  ms: number          // Window length
+  underruns: number   // Cumulative short blocks in the worklet
+  minFill?: number    // Lowest queued frames in the window, when known
+  maxGapMs?: number   // Longest gap between producer runs, when known
+}
+
+export const DEFAULT_LATENCY_LIMITS: AudioLatencyLimits = {
+  adaptive: true,
+  minFrames: 256,
+  maxFrames: 3072,
+}
+
+const QUANTUM = 128
+const GROW_FACTOR = 1.5
+// Quiet time before the first shrink, doubled (up to the cap) whenever a
+// shrink leads straight to an underrun
+const CALM_MS = 10000
+const MAX_CALM_MS = 120000
+// Follow-up shrinks after a successful one come faster
+const SHRINK_STEP_MS = 2000
+
+function roundUpToQuantum(frames: number): number {
+  return Math.ceil(frames / QUANTUM) * QUANTUM
+}
+
+export class AudioLatencyController {
+  private current: number
+  private lastUnderruns = 0
+  private calmMs = 0
+  private calmNeededMs = CALM_MS
+  private lastWasShrink = false
+
+  constructor(initialFrames: number, private sampleRate: number) {
+    this.current = roundUpToQuantum(initialFrames)
+  }
+
+  /** Frames to keep queued ahead of the worklet */
+  get target(): number {
+    return this.current
+  }
+
+  /** Feed one stats window; returns true when the target changed */
+  update(w: AudioLatencyWindow, limits: AudioLatencyLimits): boolean {
+    const underran = w.underruns > this.lastUnderruns
+    this.lastUnderruns = w.underruns
+    if (!limits.adaptive) return false
+
+    const before = this.current
+    // Stay a quantum ahead of the longest producer stall seen
+    const floor = roundUpToQuantum(((w.maxGapMs ?? 0) * this.sampleRate) / 1000 + QUANTUM)
+
+    if (underran || floor > this.current) {
+      if (underran && this.lastWasShrink) {
+        this.calmNeededMs = Math.min(this.calmNeededMs * 2, MAX_CALM_MS)
+      }
+      this.current = Math.max(floor, roundUpToQuantum(this.current * GROW_FACTOR))
+      this.calmMs = 0
+      this.lastWasShrink = false
+    } else if (w.minFill !== undefined && w.minFill < QUANTUM) {
+      // Near miss: not calm, but not worth growing for either
+      this.calmMs = 0
+    } else {
+      this.calmMs += w.ms
+      if (this.calmMs >= this.calmNeededMs && this.current - QUANTUM >= floor) {
+        this.current -= QUANTUM
+        this.calmMs = this.calmNeededMs - SHRINK_STEP_MS
+        this.lastWasShrink = true
+      }
+    }
+
+    const lo = roundUpToQuantum(Math.max(QUANTUM, limits.minFrames))
+    const hi = Math.max(lo, Math.floor(limits.maxFrames / QUANTUM) * QUANTUM)
+    this.current = Math.min(hi, Math.max(lo, this.current))
+    return this.current !== before
+  }
+}
@@ -0,0 +1,161 @@
+/**
+ * Shared-memory audio ring
+ *
+ * Single-producer / single-consumer ring of interleaved float frames in a
+ * SharedArrayBuffer. The main thread renders blocks from WASM into it and
+ * allolib-audio-processor.js reads them straight out of process(), so the
+ * steady state needs no postMessage and no per-block allocation.
+ *
+ * The WASM heap itself is not shared (libal_web is built without pthreads),
+ * so the ring is a separate buffer; each block is rendered into one reusable
+ * scratch allocation in the heap and copied in.
+ *
+ * Layout (must match allolib-audio-processor.js):
+ *   Int32 header[RING_HEADER_INTS]
+ *     [RING_WRITE]     write index in frames, stored by the producer only
+ *     [RING_READ]      read index in frames, stored by the consumer only
+ *     [RING_UNDERRUNS] blocks the consumer found short
+ *     [RING_MIN_FILL]  lowest fill seen by the consumer since the producer
+ *                      last reset it (-1 = reset)
+ *   Float32 data[capacity * channels]
+ *
+ * One frame slot is always left empty so write == read means "empty".
+ * Requires crossOriginIsolated; without it runtime.ts keeps the message path.
+ */
+
+export const RING_WRITE = 0
+export const RING_READ = 1
+export const RING_UNDERRUNS = 2
+export const RING_MIN_FILL = 3
+export const RING_HEADER_INTS = 4
+
+export interface AudioRingStats {
+  fill: number       // Frames queued right now
+  minFill: number    // Lowest fill the worklet saw since the last call
+  capacity: number   // Usable frames
+  underruns: number  // Total short blocks
+}
+
+export class AudioRing {
+  readonly sab: SharedArrayBuffer
+  readonly capacity: number
+  readonly channels: number
+  private header: Int32Array
+  private data: Float32Array
+
+  static isSupported(): boolean {
+    return typeof SharedArrayBuffer !== 'undefined' &&
+      typeof Atomics !== 'undefined' &&
+      (globalThis as any).crossOriginIsolated === true
+  }
+
+  constructor(capacityFrames: number, channels: number) {
+    this.capacity = capacityFrames
+    this.channels = channels
+    const headerBytes = RING_HEADER_INTS * 4
+    this.sab = new SharedArrayBuffer(headerBytes + capacityFrames * channels * 4)
+    this.header = new Int32Array(this.sab, 0, RING_HEADER_INTS)
+    this.data = new Float32Array(this.sab, headerBytes, capacityFrames * channels)
+    Atomics.store(this.header, RING_MIN_FILL, -1)
+  }
+
+  /** Frames queued for the worklet */
+  fill(): number {
+    const w = Atomics.load(this.header, RING_WRITE)
+    const r = Atomics.load(this.header, RING_READ)
+    return (w - r + this.capacity) % this.capacity
+  }
+
+  /** Frames that can be written without overtaking the reader */
+  space(): number {
+    return this.capacity - 1 - this.fill()
+  }
+
+  /**
+   * Append `frames` interleaved frames. The caller checks space() first;
+   * the write index is published only after the samples are in place.
+   */
+  write(src: Float32Array, frames: number): void {
+    const w = Atomics.load(this.header, RING_WRITE)
+    const first = Math.min(frames, this.capacity - w)
+    this.data.set(src.subarray(0, first * this.channels), w * this.channels)
+    if (first < frames) {
+      this.data.set(src.subarray(first * this.channels, frames * this.channels), 0)
+    }
+    Atomics.store(this.header, RING_WRITE, (w + frames) % this.capacity)
+  }
+
+  /** Read telemetry and restart the min-fill window */
+  stats(): AudioRingStats {
+    const fill = this.fill()
+    const minFill = Atomics.exchange(this.header, RING_MIN_FILL, -1)
+    return {
+      fill,
+      minFill: minFill < 0 ? fill : minFill,
+      capacity: this.capacity - 1,
+      underruns: Atomics.load(this.header, RING_UNDERRUNS),
+    }
+  }
+}
+
+/**
+ * Shared-memory input ring
+ *
+ * The same header in the other direction: allolib-audio-processor.js writes
+ * each render quantum of its input (the microphone) and the main thread
+ * reads blocks straight into AudioIO's input buffers in the WASM heap right
+ * before rendering them, so onSound sees io.in() without a message, a
+ * temporary array or a second copy.
+ *
+ * Data is planar, channel c at data[c * capacity, (c + 1) * capacity), so
+ * both ends move whole channel runs with TypedArray.set. RING_UNDERRUNS
+ * counts quanta the worklet dropped because the main thread fell behind.
+ */
+export class AudioInputRing {
+  readonly sab: SharedArrayBuffer
+  readonly capacity: number
+  readonly channels: number
+  private header: Int32Array
+  private data: Float32Array
+
+  constructor(capacityFrames: number, channels: number) {
+    this.capacity = capacityFrames
+    this.channels = channels
+    const headerBytes = RING_HEADER_INTS * 4
+    this.sab = new SharedArrayBuffer(headerBytes + capacityFrames * channels * 4)
+    this.header = new Int32Array(this.sab, 0, RING_HEADER_INTS)
+    this.data = new Float32Array(this.sab, headerBytes, capacityFrames * channels)
+  }
+
+  /** Frames captured and not yet read */
+  fill(): number {
+    const w = Atomics.load(this.header, RING_WRITE)
+    const r = Atomics.load(this.header, RING_READ)
+    return (w - r + this.capacity) % this.capacity
+  }
+
+  /**
+   * Copy up to `frames` frames of channel c to heap[offsets[c]...] for each
+   * offset, zero-filling what hasn't been captured yet. Returns frames read.
+   */
+  readInto(heap: Float32Array, offsets: number[], frames: number): number {
+    const cap = this.capacity
+    const r = Atomics.load(this.header, RING_READ)
+    const n = Math.min(frames, this.fill())
+    const first = Math.min(n, cap - r)
+    for (let c = 0; c < offsets.length; c++) {
+      const src = Math.min(c, this.channels - 1) * cap
+      const dst = offsets[c]
+      heap.set(this.data.subarray(src + r, src + r + first), dst)
+      if (first < n) heap.set(this.data.subarray(src, src + n - first), dst + first)
+      if (n < frames) heap.fill(0, dst + n, dst + frames)
+    }
+    Atomics.store(this.header, RING_READ, (r + n) % cap)
+    return n
+  }
+
+  /** Quanta the worklet dropped on a full ring */
+  dropped(): number {
+    return Atomics.load(this.header, RING_UNDERRUNS)
+  }
+}
@@ -34,6 +34,7 @@ export interface JobStatusResponse {
     success: boolean
     wasmUrl?: string
     jsUrl?: string
+    sideModuleUrl?: string // the sketch as a side module of the runtime at jsUrl
     errors?: string[]
     warnings?: string[]
     duration?: number
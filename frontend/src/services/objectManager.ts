@@ -32,6 +32,13 @@ interface ObjectManagerWasm {
   _al_obj_count: () => number
   _al_obj_visible_count: () => number
 
+  // Handles and bulk setters (JS → WASM): handles is an Int32Array and
+  // values a Float32Array on the heap, packed per object
+  _al_obj_handle?: (idPtr: number) => number
+  _al_obj_set_transforms?: (handlesPtr: number, valuesPtr: number, count: number) => void
+  _al_obj_set_colors?: (handlesPtr: number, valuesPtr: number, count: number) => void
+  _al_obj_set_pbr_params_bulk?: (handlesPtr: number, valuesPtr: number, count: number) => void
+
   // Object enumeration (WASM → JS) - for syncing C++ objects to timeline
   _al_obj_get_id_by_index: (index: number) => number  // returns char*
   _al_obj_get_name: (idPtr: number) => number         // returns char*
@@ -65,8 +72,13 @@ interface ObjectManagerWasm {
   allocateUTF8: (str: string) => number
   UTF8ToString: (ptr: number) => string
   _free: (ptr: number) => void
+  _malloc?: (size: number) => number
+  HEAPU8?: Uint8Array
 }
 
+// Floats per object in al_obj_set_transforms: position xyz, rotation xyzw, scale xyz
+const TRANSFORM_FLOATS = 10
+
 // ─── Object Manager Bridge Class ─────────────────────────────────────────────
 
 class ObjectManagerBridge {
@@ -76,6 +88,16 @@ class ObjectManagerBridge {
   private unwatchFns: Array<() => void> = []
   private syncedObjects: Set<string> = new Set()
   private animationFrameId: number | null = null
+  // WASM handles by object id, resolved once per object
+  private handles: Map<string, number> = new Map()
+  // Material type / lifecycle last sent per object (syncObjectState)
+  private sentState: Map<string, string> = new Map()
+  // Heap scratch for bulk setters, grown as needed
+  private stagingPtr = 0
+  private stagingBytes = 0
+  // Objects whose keyframed values changed this frame, flushed in bulk
+  private pendingTransforms: SceneObject[] = []
+  private pendingMaterials: SceneObject[] = []
 
   /**
    * Check if WASM module has object manager functions
@@ -244,6 +266,9 @@ class ObjectManagerBridge {
     if (this.wasmModule?._al_obj_clear) {
       this.wasmModule._al_obj_clear()
     }
+    if (this.stagingPtr) this.wasmModule?._free(this.stagingPtr)
+    this.stagingPtr = 0
+    this.stagingBytes = 0
 
     // Clear the objects store (timeline) - this resets for new project
     // Do this even if wasmModule wasn't available
@@ -257,6 +282,8 @@ class ObjectManagerBridge {
     this.objectsStore = null
     this.timelineStore = null
     this.syncedObjects.clear()
+    this.handles.clear()
+    this.sentState.clear()
 
   }
 
@@ -431,6 +458,8 @@ class ObjectManagerBridge {
     })
 
     this.syncedObjects.delete(id)
+    this.handles.delete(id)
+    this.sentState.delete(id)
   }
 
   /**
@@ -490,6 +519,22 @@ class ObjectManagerBridge {
     })
   }
 
+  /**
+   * Sync material type and lifecycle when they differ from what was last sent
+   */
+  private syncObjectState(obj: SceneObject): void {
+    const key = `${obj.material.type}|${obj.visible ? 1 : 0}|${obj.spawnTime ?? -1}|${obj.destroyTime ?? -1}`
+    if (this.sentState.get(obj.id) === key) return
+    this.sentState.set(obj.id, key)
+    if (!this.wasmModule) return
+    this.withStr(obj.id, (idPtr) => {
+      this.withStr(obj.material.type, (typePtr) => {
+        this.wasmModule!._al_obj_set_material_type(idPtr, typePtr)
+      })
+    })
+    this.syncObjectLifecycle(obj)
+  }
+
   /**
    * Setup watchers for store changes
    */
@@ -506,18 +551,21 @@ class ObjectManagerBridge {
       )
     )
 
-    // Watch each object for transform/material changes
+    // Watch each object for transform/material changes. Transforms, colors
+    // and PBR params go over in bulk; material type and lifecycle only when
+    // they changed
     this.unwatchFns.push(
       watch(
         () => this.objectsStore!.objects,
         () => {
           for (const obj of this.objectsStore!.objectList) {
             if (this.syncedObjects.has(obj.id)) {
-              this.syncObjectTransform(obj)
-              this.syncObjectMaterial(obj)
-              this.syncObjectLifecycle(obj)
+              this.pendingTransforms.push(obj)
+              this.pendingMaterials.push(obj)
+              this.syncObjectState(obj)
             }
           }
+          this.flushPending()
         },
         { deep: true }
       )
@@ -586,6 +634,105 @@ class ObjectManagerBridge {
     for (const obj of this.objectsStore.objectList) {
       this.interpolateObject(obj.id, time)
     }
+    this.flushPending()
+  }
+
+  /**
+   * Send this frame's changed objects to WASM: one bulk call per kind when
+   * the module has handle-based setters, one string-keyed call per object
+   * otherwise
+   */
+  private flushPending(): void {
+    const transforms = this.pendingTransforms
+    const materials = this.pendingMaterials
+    this.pendingTransforms = []
+    this.pendingMaterials = []
+    const wasm = this.wasmModule
+    if (!wasm) return
+
+    if (wasm._al_obj_set_transforms) {
+      this.sendBulk(transforms, TRANSFORM_FLOATS, wasm._al_obj_set_transforms, (obj, out, at) => {
+        out.set(obj.transform.position, at)
+        out.set(obj.transform.rotation, at + 3)
+        out.set(obj.transform.scale, at + 7)
+      })
+    } else {
+      for (const obj of transforms) this.syncObjectTransform(obj)
+    }
+
+    if (wasm._al_obj_set_colors && wasm._al_obj_set_pbr_params_bulk) {
+      const colored = materials.filter(obj => obj.material.color)
+      this.sendBulk(colored, 4, wasm._al_obj_set_colors, (obj, out, at) => {
+        out.set(obj.material.color!, at)
+      })
+      const pbr = materials.filter(obj => obj.material.type === 'pbr')
+      this.sendBulk(pbr, 2, wasm._al_obj_set_pbr_params_bulk, (obj, out, at) => {
+        out[at] = obj.material.metallic ?? 0.5
+        out[at + 1] = obj.material.roughness ?? 0.5
+      })
+    } else {
+      for (const obj of materials) this.syncObjectMaterial(obj)
+    }
+  }
+
+  /**
+   * Pack handles and `stride` floats per object into heap scratch and make
+   * one `setter(handles, values, count)` call
+   */
+  private sendBulk(
+    objs: SceneObject[],
+    stride: number,
+    setter: (handlesPtr: number, valuesPtr: number, count: number) => void,
+    pack: (obj: SceneObject, out: Float32Array, at: number) => void
+  ): void {
+    if (objs.length === 0) return
+    const handles: number[] = []
+    const packed: SceneObject[] = []
+    for (const obj of objs) {
+      const h = this.handleFor(obj.id)
+      if (h >= 0) {
+        handles.push(h)
+        packed.push(obj)
+      }
+    }
+    const count = handles.length
+    if (count === 0) return
+    const base = this.staging(count * (1 + stride) * 4)
+    if (!base || !this.wasmModule?.HEAPU8) return
+
+    // Views are made after staging(): a malloc may grow (replace) the heap
+    const buffer = this.wasmModule.HEAPU8.buffer
+    new Int32Array(buffer, base, count).set(handles)
+    const valuesPtr = base + count * 4
+    const values = new Float32Array(buffer, valuesPtr, count * stride)
+    for (let i = 0; i < count; i++) pack(packed[i], values, i * stride)
+    setter(base, valuesPtr, count)
+  }
+
+  /**
+   * WASM handle for an object id (-1 if unknown), cached after the first lookup
+   */
+  private handleFor(id: string): number {
+    const cached = this.handles.get(id)
+    if (cached !== undefined) return cached
+    if (!this.wasmModule?._al_obj_handle || !this.syncedObjects.has(id)) return -1
+    const handle = this.withStr(id, (idPtr) => this.wasmModule!._al_obj_handle!(idPtr))
+    if (handle >= 0) this.handles.set(id, handle)
+    return handle
+  }
+
+  /**
+   * Heap scratch of at least `bytes`, reused between frames
+   */
+  private staging(bytes: number): number {
+    if (bytes <= this.stagingBytes) return this.stagingPtr
+    if (!this.wasmModule?._malloc) return 0
+    if (this.stagingPtr) this.wasmModule._free(this.stagingPtr)
+    let size = Math.max(1024, this.stagingBytes)
+    while (size < bytes) size *= 2
+    this.stagingPtr = this.wasmModule._malloc(size)
+    this.stagingBytes = this.stagingPtr ? size : 0
+    return this.stagingPtr
   }
 
   /**
@@ -658,12 +805,12 @@ class ObjectManagerBridge {
       }
     }
 
-    // Sync to WASM if anything changed
-    if (transformChanged) {
-      this.syncObjectTransform(obj)
+    // Queue for this frame's bulk sync (flushPending)
+    if (transformChanged && this.syncedObjects.has(obj.id)) {
+      this.pendingTransforms.push(obj)
     }
-    if (materialChanged) {
-      this.syncObjectMaterial(obj)
+    if (materialChanged && this.syncedObjects.has(obj.id)) {
+      this.pendingMaterials.push(obj)
     }
   }
 
@@ -9,6 +9,13 @@ import { parameterSystem } from '@/utils/parameter-system'
 import { useSettingsStore } from '@/stores/settings'
 import { useProjectStore } from '@/stores/project'
 import { objectManagerBridge } from '@/services/objectManager'
+import { AudioInputRing, AudioRing, type AudioRingStats } from '@/services/audioRing'
+import {
+  AudioLatencyController,
+  DEFAULT_LATENCY_LIMITS,
+  type AudioLatencyLimits,
+  type AudioLatencyWindow,
+} from '@/services/audioLatency'
 
 export interface RuntimeConfig {
   canvas: HTMLCanvasElement
@@ -38,11 +45,20 @@ export interface WasmModule {
   _allolib_destroy?: () => void
   _allolib_process_audio?: (buffer: number, frames: number, channels: number) => void
   _allolib_configure_audio?: (sampleRate: number, bufferSize: number, outCh: number, inCh: number) => void
+  _allolib_audio_input_channels?: () => number
+  _allolib_audio_input_buffer?: (channel: number) => number // AudioIO's planar input channel
+  _allolib_set_audio_latency?: (frames: number) => void
+  // Adaptive latency limits published by WebApp (WebAudioConfig)
+  alloAudioLatency?: AudioLatencyLimits
+  // Set by libraries built with ALLOLIB_AUDIO_WORKLET: onSound runs on the
+  // Web Audio thread and WASM creates the AudioWorkletNode itself
+  alloWasmAudioWorklet?: boolean
 
   // WebControlGUI exports (parameter panel)
   _al_webgui_get_parameter_count?: () => number
   _al_webgui_get_parameter_name?: (index: number) => number // Returns pointer to string
   _al_webgui_get_parameter_group?: (index: number) => number // Returns pointer to string
+  _al_webgui_get_parameter_index?: (namePtr: number) => number // -1 if no parameter has that name
   _al_webgui_get_parameter_type?: (index: number) => number
   _al_webgui_get_parameter_min?: (index: number) => number
   _al_webgui_get_parameter_max?: (index: number) => number
@@ -50,17 +66,26 @@ export interface WasmModule {
   _al_webgui_get_parameter_default?: (index: number) => number
   _al_webgui_set_parameter_value?: (index: number, value: number) => void
   _al_webgui_trigger_parameter?: (index: number) => void
+  // Shared value table header: { values, outMask, inMask, count, generation } as 32-bit words
+  _al_webgui_sync_table?: () => number
 
   // WebSequencerBridge exports (voice triggering from sequencer)
   _al_seq_trigger_on?: (id: number, freq: number, amp: number, dur: number) => void
   _al_seq_trigger_off?: (id: number) => void
   _al_seq_set_param?: (voiceId: number, paramIndex: number, value: number) => void
   _al_seq_get_voice_count?: () => number
+  _al_seq_schedule_on?: (frame: number, id: number, freq: number, amp: number, dur: number) => void
+  _al_seq_schedule_off?: (frame: number, id: number) => void
+  _al_seq_schedule_param?: (frame: number, voiceId: number, paramIndex: number, value: number) => void
+  _al_seq_current_frame?: () => number
+  _al_seq_get_dropped_events?: () => number
 
   // WebGPU context references (set by JS before module renders)
   _webgpuCanvasContext?: GPUCanvasContext
   _webgpuDevice?: GPUDevice
   _webgpuFormat?: GPUTextureFormat
+  // Set when the canvas size changes; beginFrame() re-reads the size only then
+  _webgpuCanvasResized?: boolean
 }
 
 declare global {
@@ -71,6 +96,7 @@ declare global {
     alloSoftClipper: WaveShaperNode | null
     alloLimiter: DynamicsCompressorNode | null
     alloLimiterGain: GainNode | null // For monitoring gain reduction
+    alloOnWasmAudioNode?: (() => void) | null // Called when WASM has created alloWorkletNode
   }
 }
 
@@ -153,6 +179,19 @@ function createSoftClipCurve(drive: number = 1.5, samples: number = 8192): Float
   return curve
 }
 
+// Shared audio ring sizing (frames at 44.1 kHz). The target starts at ~23 ms
+// queued, well under the old 6-16 block message queue, with capacity left
+// for a stalled main thread to catch up in one pump; AudioLatencyController
+// moves it from there.
+const AUDIO_RING_BLOCK = 128
+const AUDIO_RING_TARGET = 1024
+const AUDIO_RING_CAPACITY = 4096
+const AUDIO_RING_PUMP_MS = 5
+const AUDIO_LATENCY_WINDOW_MS = 500
+// Message path: blocks queued in the worklet before it asks for more
+const AUDIO_QUEUE_MIN_BLOCKS = 6
+const AUDIO_QUEUE_SLACK_BLOCKS = 10
+
 export class AllolibRuntime {
   private module: WasmModule | null = null
   private canvas: HTMLCanvasElement
@@ -167,6 +206,25 @@ export class AllolibRuntime {
     softClipDrive: 1.5,
   }
 
+  // Shared-memory audio path (null when the page isn't cross-origin isolated)
+  private audioRing: AudioRing | null = null
+  private audioPumpTimer: ReturnType<typeof setInterval> | null = null
+  // Frames kept queued ahead of the worklet; adapted by audioLatency
+  private audioLatency: AudioLatencyController | null = null
+  private audioLatencyWindowStart = 0
+  private audioLastPump = 0
+  private audioMaxPumpGapMs = 0
+  // Microphone capture into io.in() (apps configured with input channels)
+  private audioInputRing: AudioInputRing | null = null
+  private audioInputOffsets: number[] = [] // HEAPF32 index of each input channel
+  private audioInputStream: MediaStream | null = null
+  private audioInputSource: MediaStreamAudioSourceNode | null = null
+  // One reusable WASM heap block that allolib_process_audio renders into
+  private audioScratchPtr = 0
+  private audioScratchSize = 0
+  // Last periodic 'stats' message from the worklet (sendStats)
+  private workletStats: Record<string, unknown> | null = null
+
   constructor(config: RuntimeConfig) {
     this.canvas = config.canvas
     this.onPrint = config.onPrint || console.log
@@ -180,7 +238,12 @@ export class AllolibRuntime {
     this.resize()
   }
 
-  async load(jsUrl: string): Promise<void> {
+  /**
+   * Load and instantiate a compiled sketch. For side-module builds jsUrl is
+   * the shared runtime and sideModuleUrl the sketch, which the runtime
+   * loads as a dynamic library before main() runs.
+   */
+  async load(jsUrl: string, sideModuleUrl: string | null = null): Promise<void> {
     this.onPrint('[INFO] Loading AlloLib WASM module...')
 
     // Clean up any previous module
@@ -217,7 +280,18 @@ export class AllolibRuntime {
             const adapter = await navigator.gpu.requestAdapter()
             if (adapter) {
               this.onPrint('[Backend] Adapter acquired, requesting device...')
-              webgpuDevice = await adapter.requestDevice()
+              // Timestamp queries back the backend's GPU pass profiler;
+              // compressed formats let KTX2 textures stay compressed on the GPU
+              const optionalFeatures = [
+                'timestamp-query',
+                'texture-compression-bc',
+                'texture-compression-etc2',
+                'texture-compression-astc',
+              ]
+              const requiredFeatures: string[] = optionalFeatures.filter(
+                (f) => adapter.features?.has(f)
+              )
+              webgpuDevice = await adapter.requestDevice({ requiredFeatures })
               useWebGPU = true
               this.onPrint('[Backend] WebGPU device acquired successfully!')
             } else {
@@ -325,6 +399,7 @@ export class AllolibRuntime {
         printErr: (text: string) => void
         onExit: (code: number) => void
         locateFile: (path: string) => string
+        dynamicLibraries?: string[]
         postMainLoop?: () => void
         preinitializedWebGLContext?: WebGL2RenderingContext | null
         preinitializedWebGPUDevice?: GPUDevice
@@ -338,6 +413,9 @@ export class AllolibRuntime {
           this.onExit(code)
         },
         locateFile: (path: string) => {
+          if (sideModuleUrl && path === 'user.wasm') {
+            return sideModuleUrl
+          }
           if (path.endsWith('.wasm')) {
             return jsUrl.replace('.js', '.wasm')
           }
@@ -411,6 +489,21 @@ export class AllolibRuntime {
               console.warn('[IDBFS] /presets mount failed:', e)
               return
             }
+            // Generated LOD chains (al_WebLOD.hpp). Mounted before the
+            // syncfs(true) below so the same restore populates it.
+            try { FS.mkdir('/lodcache') } catch (_e) { /* exists */ }
+            try {
+              FS.mount(mod.IDBFS, {}, '/lodcache')
+            } catch (e) {
+              console.warn('[IDBFS] /lodcache mount failed:', e)
+            }
+            // Preprocessed mesh bundles (al_WebMeshCache.hpp)
+            try { FS.mkdir('/meshcache') } catch (_e) { /* exists */ }
+            try {
+              FS.mount(mod.IDBFS, {}, '/meshcache')
+            } catch (e) {
+              console.warn('[IDBFS] /meshcache mount failed:', e)
+            }
             addDep('idbfs-presets-restore')
             // v0.7.10: when the previous module's IndexedDB connection
             // is still held (project-switch without page reload), a fresh
@@ -458,6 +551,13 @@ export class AllolibRuntime {
         this.onPrint('[Backend] Passing WebGL2 context to WASM module')
       }
 
+      // Side-module build: the runtime fetches the sketch (via locateFile)
+      // and links it in before main()
+      if (sideModuleUrl) {
+        moduleConfig.dynamicLibraries = ['user.wasm']
+        this.onPrint('[INFO] Loading sketch as a side module of the shared runtime')
+      }
+
       // Hook into Emscripten main loop to count frames and enable captures
       moduleConfig.postMainLoop = () => {
         const w = window as any
@@ -597,21 +697,69 @@ export class AllolibRuntime {
       return
     }
 
+    // Worklet-thread builds: WASM creates the node asynchronously during
+    // _allolib_start(); hook up the limiter chain once it exists
+    if (this.module.alloWasmAudioWorklet) {
+      const attach = () => {
+        window.alloOnWasmAudioNode = null
+        this.setupSafetyLimiter()
+        this.connectAudioInput()
+        // onSound renders inside process(): one quantum, nothing to adapt
+        this.reportAudioLatency(AUDIO_RING_BLOCK)
+        this.onPrint('[INFO] Audio callback running on the Web Audio thread')
+      }
+      if (window.alloWorkletNode) {
+        attach()
+      } else {
+        window.alloOnWasmAudioNode = attach
+      }
+      return
+    }
+
     try {
       this.onPrint('[INFO] Creating AudioWorkletNode...')
 
+      // With cross-origin isolation the worklet reads blocks from a shared
+      // ring that pumpAudioRing() keeps topped up; otherwise it falls back to
+      // requesting each block by message.
+      this.audioRing = AudioRing.isSupported()
+        ? new AudioRing(AUDIO_RING_CAPACITY, 2)
+        : null
+
+      // Input goes the other way through its own ring, read straight into
+      // AudioIO's input buffers by pumpAudioRing()
+      const inputChannels = this.module._allolib_audio_input_channels?.() ?? 0
+      if (inputChannels > 0 && this.audioRing && this.module._allolib_audio_input_buffer) {
+        this.audioInputRing = new AudioInputRing(AUDIO_RING_CAPACITY, inputChannels)
+        this.audioInputOffsets = []
+        for (let c = 0; c < inputChannels; c++) {
+          this.audioInputOffsets.push(this.module._allolib_audio_input_buffer(c) / 4)
+        }
+      } else if (inputChannels > 0) {
+        this.onPrint('[WARN] Audio input needs a cross-origin isolated page; io.in() stays silent')
+      }
+
       // Create the AudioWorkletNode
       window.alloWorkletNode = new AudioWorkletNode(
         window.alloAudioContext,
         'allolib-processor',
         {
-          numberOfInputs: 0,
+          numberOfInputs: this.audioInputRing ? 1 : 0,
           numberOfOutputs: 1,
           outputChannelCount: [2],
+          // Up/down-mix the microphone to exactly the app's input channels
+          channelCount: this.audioInputRing?.channels ?? 2,
+          channelCountMode: 'explicit',
           processorOptions: {
             bufferSize: 128,
             sampleRate: 44100,
             outputChannels: 2,
+            ringBuffer: this.audioRing?.sab ?? null,
+            ringLowWater: AUDIO_RING_TARGET / 2,
+            minQueueSize: AUDIO_QUEUE_MIN_BLOCKS,
+            maxQueueSize: AUDIO_QUEUE_MIN_BLOCKS + AUDIO_QUEUE_SLACK_BLOCKS,
+            inputRing: this.audioInputRing?.sab ?? null,
+            inputChannels: this.audioInputRing?.channels ?? 0,
           },
         }
       )
@@ -620,11 +768,35 @@ export class AllolibRuntime {
       window.alloWorkletNode.port.onmessage = (event) => {
         if (event.data.type === 'requestBuffer') {
           this.processAudioRequest(event.data.frames, event.data.channels)
+        } else if (event.data.type === 'ringLow') {
+          this.pumpAudioRing()
+        } else if (event.data.type === 'stats') {
+          this.workletStats = event.data
+          // The ring path adapts from pumpAudioRing(); the message path here
+          if (!this.audioRing) {
+            this.adaptAudioLatency({ ms: 1000, underruns: event.data.underrunCount ?? 0 })
+          }
         }
       }
 
+      this.audioLatency = new AudioLatencyController(
+        this.audioRing ? AUDIO_RING_TARGET : AUDIO_QUEUE_MIN_BLOCKS * AUDIO_RING_BLOCK,
+        window.alloAudioContext.sampleRate
+      )
+      this.reportAudioLatency(this.audioLatency.target)
+
+      if (this.audioRing) {
+        this.audioLatencyWindowStart = performance.now()
+        this.audioLastPump = 0
+        this.audioMaxPumpGapMs = 0
+        this.pumpAudioRing()
+        this.audioPumpTimer = setInterval(() => this.pumpAudioRing(), AUDIO_RING_PUMP_MS)
+        this.onPrint(`[INFO] Audio using shared ring (${AUDIO_RING_TARGET} frame target, adaptive)`)
+      }
+
       // Create safety limiter chain: worklet → soft clipper → limiter → destination
       this.setupSafetyLimiter()
+      if (this.audioInputRing) this.connectAudioInput()
 
       this.onPrint(`[INFO] Audio worklet connected (state: ${window.alloAudioContext.state})`)
     } catch (error) {
@@ -715,6 +887,167 @@ export class AllolibRuntime {
 
   private audioRequestCount = 0
 
+  /** Reusable heap block for one rendered block; grows, never shrinks */
+  private audioScratch(bytes: number): number {
+    if (!this.module?._malloc) return 0
+    if (this.audioScratchPtr && this.audioScratchSize >= bytes) return this.audioScratchPtr
+    if (this.audioScratchPtr) this.module._free?.(this.audioScratchPtr)
+    this.audioScratchPtr = this.module._malloc(bytes)
+    this.audioScratchSize = this.audioScratchPtr ? bytes : 0
+    return this.audioScratchPtr
+  }
+
+  private releaseAudioScratch(): void {
+    if (this.audioScratchPtr) this.module?._free?.(this.audioScratchPtr)
+    this.audioScratchPtr = 0
+    this.audioScratchSize = 0
+  }
+
+  /**
+   * Render blocks from WASM into the shared ring until it holds the
+   * current latency target. Runs on a timer and when the worklet reports
+   * the ring running low; also times its own gaps for the latency window.
+   */
+  private pumpAudioRing(): void {
+    const ring = this.audioRing
+    if (!ring || !this.module?._allolib_process_audio) return
+
+    const now = performance.now()
+    if (this.audioLastPump > 0) {
+      this.audioMaxPumpGapMs = Math.max(this.audioMaxPumpGapMs, now - this.audioLastPump)
+    }
+    this.audioLastPump = now
+    if (now - this.audioLatencyWindowStart >= AUDIO_LATENCY_WINDOW_MS) {
+      const stats = ring.stats()
+      this.adaptAudioLatency({
+        ms: now - this.audioLatencyWindowStart,
+        underruns: stats.underruns,
+        minFill: stats.minFill,
+        maxGapMs: this.audioMaxPumpGapMs,
+      })
+      this.audioLatencyWindowStart = now
+      this.audioMaxPumpGapMs = 0
+    }
+
+    try {
+      const target = this.audioLatency?.target ?? AUDIO_RING_TARGET
+      const frames = AUDIO_RING_BLOCK
+      const channels = ring.channels
+      const ptr = this.audioScratch(frames * channels * 4)
+      if (!ptr) return
+
+      const input = this.audioInputRing
+      while (ring.fill() < target && ring.space() >= frames) {
+        if (input) input.readInto(this.module.HEAPF32!, this.audioInputOffsets, frames)
+        this.module._allolib_process_audio(ptr, frames, channels)
+        // Re-read HEAPF32 each block: memory growth replaces the view
+        const offset = ptr / 4
+        ring.write(this.module.HEAPF32!.subarray(offset, offset + frames * channels), frames)
+      }
+    } catch (error) {
+      console.warn('Audio processing error:', error)
+    }
+  }
+
+  /**
+   * Feed one stats window to the latency controller and apply a new target:
+   * the ring's low-water mark or the worklet's queue depth follow it, and
+   * WASM learns the new total for WebApp::audioLatencyFrames().
+   */
+  private adaptAudioLatency(stats: AudioLatencyWindow): void {
+    const latency = this.audioLatency
+    if (!latency) return
+    const limits = { ...DEFAULT_LATENCY_LIMITS, ...this.module?.alloAudioLatency }
+    // Leave room for one block beyond the target in the ring
+    limits.maxFrames = Math.min(limits.maxFrames, AUDIO_RING_CAPACITY - 2 * AUDIO_RING_BLOCK)
+    if (!latency.update(stats, limits)) return
+
+    const target = latency.target
+    const blocks = Math.ceil(target / AUDIO_RING_BLOCK)
+    window.alloWorkletNode?.port.postMessage({
+      type: 'configure',
+      ringLowWater: target / 2,
+      minQueueSize: blocks,
+      maxQueueSize: blocks + AUDIO_QUEUE_SLACK_BLOCKS,
+    })
+    this.reportAudioLatency(target)
+  }
+
+  /** Tell WASM the output latency: queued frames plus the device's own */
+  private reportAudioLatency(queuedFrames: number): void {
+    const ctx = window.alloAudioContext
+    if (!ctx || !this.module?._allolib_set_audio_latency) return
+    const device = Math.round(((ctx.baseLatency || 0) + (ctx.outputLatency || 0)) * ctx.sampleRate)
+    this.module._allolib_set_audio_latency(queuedFrames + device)
+  }
+
+  /**
+   * Ask for the microphone and feed it into the worklet node's input. The
+   * app opted in by configuring input channels; processing is left off so
+   * analysis sees the raw signal.
+   */
+  private async connectAudioInput(): Promise<void> {
+    const ctx = window.alloAudioContext
+    if (!ctx || !window.alloWorkletNode || !navigator.mediaDevices?.getUserMedia) return
+    if (window.alloWorkletNode.numberOfInputs < 1) return
+
+    try {
+      const stream = await navigator.mediaDevices.getUserMedia({
+        audio: { echoCancellation: false, noiseSuppression: false, autoGainControl: false },
+      })
+      // The app may have stopped while the permission prompt was open
+      if (!this.isRunning || !window.alloWorkletNode) {
+        stream.getTracks().forEach((track) => track.stop())
+        return
+      }
+      this.audioInputStream = stream
+      this.audioInputSource = ctx.createMediaStreamSource(stream)
+      this.audioInputSource.connect(window.alloWorkletNode)
+      this.onPrint('[INFO] Microphone connected to audio input')
+    } catch (error) {
+      this.onPrint(`[WARN] Microphone unavailable: ${error}`)
+    }
+  }
+
+  private disconnectAudioInput(): void {
+    if (this.audioInputSource) {
+      this.audioInputSource.disconnect()
+      this.audioInputSource = null
+    }
+    if (this.audioInputStream) {
+      this.audioInputStream.getTracks().forEach((track) => track.stop())
+      this.audioInputStream = null
+    }
+    this.audioInputRing = null
+    this.audioInputOffsets = []
+  }
+
+  /**
+   * Everything known about audio health: the worklet's own stats (queue,
+   * underruns), the shared ring's fill level, and the DSP timing WASM
+   * keeps per block (time vs deadline, load histogram, per-callback
+   * breakdown). Underruns with few DSP overruns point at scheduling.
+   */
+  getAudioStats(): {
+    worklet: Record<string, unknown> | null
+    ring: AudioRingStats | null
+    dsp: Record<string, unknown> | null
+  } {
+    const monitor = (window as any).allolib?.audioMonitor
+    let dsp = null
+    try {
+      dsp = this.module && monitor ? monitor.readTelemetry() : null
+    } catch (error) {
+      console.warn('[Audio] Could not read DSP telemetry:', error)
+    }
+    return { worklet: this.workletStats, ring: this.getAudioRingStats(), dsp }
+  }
+
+  /** Fill-level telemetry for the shared ring, or null on the message path */
+  getAudioRingStats(): AudioRingStats | null {
+    return this.audioRing ? this.audioRing.stats() : null
+  }
+
   private processAudioRequest(frames: number, channels: number): void {
     if (!this.module || !window.alloWorkletNode) return
 
@@ -723,9 +1056,7 @@ export class AllolibRuntime {
       // (Reserved for future first-request diagnostic logging.)
       this.audioRequestCount++
 
-      // Allocate buffer in WASM memory
-      const bufferSize = frames * channels * 4 // float32 = 4 bytes
-      const bufferPtr = this.module._malloc?.(bufferSize)
+      const bufferPtr = this.audioScratch(frames * channels * 4) // float32 = 4 bytes
 
       if (!bufferPtr) {
         console.warn('[Audio] Failed to allocate buffer')
@@ -744,15 +1075,12 @@ export class AllolibRuntime {
       const elementOffset = bufferPtr / 4  // Convert byte offset to Float32Array element index
       const audioData = this.module.HEAPF32!.subarray(elementOffset, elementOffset + frames * channels)
 
-      // Send to worklet (make a copy before freeing the WASM allocation)
+      // Send to worklet (the scratch block is reused, so transfer a copy)
       const bufferCopy = audioData.slice()
       window.alloWorkletNode.port.postMessage({
         type: 'audioBuffer',
         buffer: bufferCopy.buffer,
       }, [bufferCopy.buffer])
-
-      // Free the buffer
-      this.module._free?.(bufferPtr)
     } catch (error) {
       console.warn('Audio processing error:', error)
     }
@@ -935,6 +1263,17 @@ export class AllolibRuntime {
       window.alloAudioContext.suspend()
     }
 
+    window.alloOnWasmAudioNode = null
+    if (this.audioPumpTimer !== null) {
+      clearInterval(this.audioPumpTimer)
+      this.audioPumpTimer = null
+    }
+    this.audioRing = null
+    this.audioLatency = null
+    this.disconnectAudioInput()
+    this.workletStats = null
+    this.releaseAudioScratch()
+
     // Disconnect audio chain in reverse order (output → input)
     if (window.alloLimiterGain) {
       window.alloLimiterGain.disconnect()
@@ -971,6 +1310,9 @@ export class AllolibRuntime {
   }
 
   private cleanup(): void {
+    // The scratch block belongs to this module's heap
+    this.releaseAudioScratch()
+
     if (this.module?._allolib_destroy) {
       try {
         this.module._allolib_destroy()
@@ -1008,7 +1350,11 @@ export class AllolibRuntime {
           }
         }
       }
-      // For WebGPU, the backend handles viewport via the resize callback
+      // For WebGPU, the backend handles viewport via the resize callback;
+      // flag the resize so beginFrame() re-reads the swap chain size.
+      if (this.module) {
+        this.module._webgpuCanvasResized = true
+      }
     }
   }
 
@@ -1040,6 +1386,45 @@ export class AllolibRuntime {
     this.module._al_seq_set_param(voiceId, paramIndex, value)
   }
 
+  /**
+   * Frame on the sequencer bridge's audio clock (frames rendered so far).
+   * The *At() calls below take times on this clock.
+   */
+  audioFrame(): number {
+    return this.module?._al_seq_current_frame?.() ?? 0
+  }
+
+  get audioSampleRate(): number {
+    return window.alloAudioContext?.sampleRate ?? 44100
+  }
+
+  /** Sample-accurate triggerVoice(); falls back to the next block */
+  triggerVoiceAt(frame: number, id: number, freq: number, amp: number, dur: number): void {
+    if (this.module?._al_seq_schedule_on) {
+      this.module._al_seq_schedule_on(frame, id, freq, amp, dur)
+    } else {
+      this.triggerVoice(id, freq, amp, dur)
+    }
+  }
+
+  /** Sample-accurate releaseVoice(); falls back to the next block */
+  releaseVoiceAt(frame: number, id: number): void {
+    if (this.module?._al_seq_schedule_off) {
+      this.module._al_seq_schedule_off(frame, id)
+    } else {
+      this.releaseVoice(id)
+    }
+  }
+
+  /** setVoiceParam() ordered with the *At() triggers */
+  setVoiceParamAt(frame: number, voiceId: number, paramIndex: number, value: number): void {
+    if (this.module?._al_seq_schedule_param) {
+      this.module._al_seq_schedule_param(frame, voiceId, paramIndex, value)
+    } else {
+      this.setVoiceParam(voiceId, paramIndex, value)
+    }
+  }
+
   /**
    * Check if the sequencer bridge is available in the loaded WASM module.
    */
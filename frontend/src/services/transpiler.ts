@@ -628,6 +628,11 @@ const webToNativePatterns: Array<{
     replacement: '// WebMipmapTexture: continuous LOD textures (no native compat yet)\n// Native OpenGL has glGenerateMipmap() and glTexParameterf(GL_TEXTURE_LOD_BIAS)\n// #include "al_WebMipmapTexture.hpp"',
     description: 'WebMipmapTexture include'
   },
+  {
+    pattern: /#include\s*["<]al_WebParticles\.hpp[">]/g,
+    replacement: '// WebParticles: GPU particles (no native compat yet)\n// Requires manual porting - WebGPU compute / WebGL2 transform feedback\n// #include "al_WebParticles.hpp"',
+    description: 'WebParticles include'
+  },
 
   // Base class transformations
   {
@@ -778,6 +783,7 @@ export function detectCodeType(code: string): 'native' | 'web' | 'unknown' {
       code.includes('al_WebMipmapTexture.hpp') ||
       code.includes('al_WebLOD.hpp') ||
       code.includes('al_WebQuality.hpp') ||
+      code.includes('al_WebParticles.hpp') ||
       code.includes('ALLOLIB_WEB_MAIN') ||
       code.includes('configureWebAudio') ||
       code.includes('WebSamplePlayer') ||
@@ -794,6 +800,7 @@ export function detectCodeType(code: string): 'native' | 'web' | 'unknown' {
       code.includes('AutoLODManager') ||
       code.includes('ProceduralTexture') ||
       code.includes('MipmapTexture') ||
+      code.includes('GPUParticles') ||
       code.includes('drawLOD(') ||
       code.includes('WebControlGUI')) {
     return 'web'
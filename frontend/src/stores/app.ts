@@ -62,7 +62,7 @@ const autoLODPatterns: Array<{ pattern: RegExp; replacement: string | ((match: s
  * imported native) gets the al_playground_compat.hpp include + the
  * `PresetHandler` macro before it hits Emscripten.
  */
-function preprocessForWasm(content: string): string {
+function preprocessForWasm(content: string, autoLOD: boolean): string {
   let result = content
 
   // v0.7.10: auto-transpile native code to web equivalents. Idempotent
@@ -83,8 +83,10 @@ function preprocessForWasm(content: string): string {
   }
 
   // Apply Auto-LOD transformations: g.draw(mesh) -> drawLOD(g, mesh)
-  // This enables automatic LOD for all mesh draw calls when Auto-LOD is enabled
-  for (const { pattern, replacement } of autoLODPatterns) {
+  // This enables automatic LOD for all mesh draw calls when Auto-LOD is enabled.
+  // With it disabled the calls stay plain draws, and a sketch that doesn't
+  // use LOD itself doesn't link the auto-LOD component at all.
+  for (const { pattern, replacement } of autoLOD ? autoLODPatterns : []) {
     const before = result
     if (typeof replacement === 'function') {
       result = result.replace(pattern, replacement as (match: string, ...args: string[]) => string)
@@ -122,6 +124,7 @@ export const useAppStore = defineStore('app', () => {
   const consoleOutput = ref<string[]>([])
   const wasmUrl = ref<string | null>(null)
   const jsUrl = ref<string | null>(null)
+  const sideModuleUrl = ref<string | null>(null)
   const errorMessage = ref<string | null>(null)
   const diagnostics = ref<CompilerDiagnostic[]>([])
 
@@ -152,16 +155,17 @@ export const useAppStore = defineStore('app', () => {
     log(`[INFO] Starting compilation... (${files.length} file${files.length > 1 ? 's' : ''})`)
 
     try {
+      const settings = useSettingsStore()
+
       // Preprocess each .cpp/.hpp file: inject ALLOLIB_WEB_MAIN and apply Auto-LOD transforms.
       const preprocessedFiles = files.map(file => ({
         name: file.name,
         content: file.name.endsWith('.cpp') || file.name.endsWith('.hpp')
-          ? preprocessForWasm(file.content)
+          ? preprocessForWasm(file.content, settings.graphics.lodEnabled)
           : file.content
       }))
 
       // Get backend setting
-      const settings = useSettingsStore()
       const backend = (settings.graphics.backendType || 'webgl2') as BackendType
 
       // Submit compilation request with backend selection
@@ -192,6 +196,9 @@ export const useAppStore = defineStore('app', () => {
       if (result.result?.wasmUrl && result.result?.jsUrl) {
         wasmUrl.value = toAbsoluteUrl(result.result.wasmUrl)
         jsUrl.value = toAbsoluteUrl(result.result.jsUrl)
+        sideModuleUrl.value = result.result.sideModuleUrl
+          ? toAbsoluteUrl(result.result.sideModuleUrl)
+          : null
         log(`[SUCCESS] Compilation complete (${result.result.duration}ms)`)
         status.value = 'loading'
       } else {
@@ -217,6 +224,7 @@ export const useAppStore = defineStore('app', () => {
     }
     wasmUrl.value = null
     jsUrl.value = null
+    sideModuleUrl.value = null
     status.value = 'idle'
     log('[INFO] Stopped')
   }
@@ -240,6 +248,7 @@ export const useAppStore = defineStore('app', () => {
     consoleOutput,
     wasmUrl,
     jsUrl,
+    sideModuleUrl,
     errorMessage,
     diagnostics,
 
@@ -1058,6 +1058,17 @@ export const useSequencerStore = defineStore('sequencer', () => {
 
     const notes = allArrangementNotes.value
 
+    // Boundaries crossed since the last animation frame are placed on the
+    // audio clock at their offset from prevTime, so they keep their exact
+    // spacing (one animation frame of latency) instead of bunching up at
+    // the next block. The WASM queue is FIFO, so they are sent in time
+    // order (stable sort keeps each note's params ahead of its trigger).
+    const rt = runtime
+    const baseFrame = rt.audioFrame()
+    const sampleRate = rt.audioSampleRate
+    const frameAt = (t: number) => baseFrame + Math.max(0, Math.round((t - prevTime) * sampleRate))
+    const pending: Array<{ frame: number, send: () => void }> = []
+
     for (const note of notes) {
       const noteStart = note.absoluteStartTime
       const noteEnd = noteStart + note.duration
@@ -1072,11 +1083,16 @@ export const useSequencerStore = defineStore('sequencer', () => {
 
         // Set all note parameters on control voice BEFORE triggering
         // These get copied to the new voice by al_seq_trigger_on
-        for (let i = 0; i < note.params.length; i++) {
-          runtime.setVoiceParam(0, i, note.params[i])
-        }
-
-        runtime.triggerVoice(voiceId, note.frequency, note.amplitude, note.duration)
+        const frame = frameAt(noteStart)
+        pending.push({
+          frame,
+          send: () => {
+            for (let i = 0; i < note.params.length; i++) {
+              rt.setVoiceParamAt(frame, 0, i, note.params[i])
+            }
+            rt.triggerVoiceAt(frame, voiceId, note.frequency, note.amplitude, note.duration)
+          },
+        })
       }
 
       // Check if note should end (crossed end boundary)
@@ -1086,13 +1102,17 @@ export const useSequencerStore = defineStore('sequencer', () => {
         if (parts[1] === note.id) {
           if (noteEnd >= prevTime && noteEnd < currentTime) {
             const voiceId = parseInt(parts[0])
-            runtime.releaseVoice(voiceId)
+            const frame = frameAt(noteEnd)
+            pending.push({ frame, send: () => rt.releaseVoiceAt(frame, voiceId) })
             triggeredNotes.delete(key)
           }
           break
         }
       }
     }
+
+    pending.sort((a, b) => a.frame - b.frame)
+    for (const event of pending) event.send()
   }
 
   // ── Clip File I/O ────────────────────────────────────────────────
@@ -114,6 +114,7 @@ class ParameterSystem {
   private callbacks: Set<ParameterCallback> = new Set()
   private wasmModule: WasmModule | null = null
   private pollInterval: number | null = null
+  private syncTable = 0 // address of the WASM value table header, 0 = per-value exports
   private retryTimeouts: number[] = []
 
   // Currently selected object for parameter panel
@@ -320,6 +321,49 @@ class ParameterSystem {
         this.notifyChange()
       }
     }
+
+    // Called once per frame with every value C++ changed, via the table
+    ;(window as any).allolib.onParametersSynced = (header: number) => {
+      const table = this.readSyncTable(header)
+      if (!table) return
+      let changed = false
+      for (let w = 0; w * 32 < table.count; w++) {
+        let bits = table.outMask[w]
+        while (bits) {
+          const b = 31 - Math.clz32(bits)
+          bits &= ~(1 << b)
+          const param = this.parameters.get(w * 32 + b)
+          if (param && typeof param.value === 'number') {
+            param.value = table.values[w * 32 + b]
+            changed = true
+          }
+        }
+      }
+      if (changed) this.notifyChange()
+    }
+  }
+
+  /**
+   * View the WASM value table. The arrays move when parameters are added,
+   * and memory growth replaces the buffer, so this is re-read per use.
+   */
+  private readSyncTable(header: number): {
+    values: Float32Array
+    outMask: Uint32Array
+    inMask: Uint32Array
+    count: number
+  } | null {
+    const heap = this.wasmModule?.HEAPF32 ?? (window as any).Module?.HEAPF32
+    if (!header || !heap) return null
+    const words = new Uint32Array(heap.buffer, header, 5)
+    const count = words[3]
+    const maskWords = (count + 31) >>> 5
+    return {
+      values: new Float32Array(heap.buffer, words[0], count),
+      outMask: new Uint32Array(heap.buffer, words[1], maskWords),
+      inMask: new Uint32Array(heap.buffer, words[2], maskWords),
+      count,
+    }
   }
 
   /**
@@ -329,6 +373,7 @@ class ParameterSystem {
     this.stopPolling()
     this.cancelRetries()
     this.wasmModule = module
+    this.syncTable = module._al_webgui_sync_table?.() ?? 0
     this.parameters.clear()
 
     // Load any existing parameters from WASM
@@ -351,6 +396,7 @@ class ParameterSystem {
   disconnectWasm(): void {
     this.cancelRetries()
     this.wasmModule = null
+    this.syncTable = 0
     this.parameters.clear()
     this.stopPolling()
     this.notifyChange()
@@ -519,7 +565,9 @@ class ParameterSystem {
       return
     }
 
-    // Same count → just refresh values.
+    // Same count → just refresh values. With the value table, C++ pushes
+    // changes every frame through onParametersSynced instead.
+    if (this.syncTable) return
     let changed = false
     for (const [index, param] of this.parameters) {
       if (param.source !== 'synth') continue
@@ -900,8 +948,13 @@ class ParameterSystem {
 
     param.value = value
 
-    // Send to WASM
-    if (this.wasmModule?._al_webgui_set_parameter_value) {
+    // Send to WASM: into the value table when there is one (applied at the
+    // next frame with every other write), else through the per-value export
+    const table = this.readSyncTable(this.syncTable)
+    if (table && index < table.count) {
+      table.values[index] = value
+      table.inMask[index >>> 5] |= 1 << (index & 31)
+    } else if (this.wasmModule?._al_webgui_set_parameter_value) {
       this.wasmModule._al_webgui_set_parameter_value(index, value)
     }
 
@@ -16,8 +16,13 @@ interface GPUAdapterInfo {
   description?: string
 }
 
+interface GPUDeviceDescriptor {
+  requiredFeatures?: string[]
+}
+
 interface GPUAdapter {
-  requestDevice(): Promise<GPUDevice>
+  readonly features?: ReadonlySet<string>
+  requestDevice(descriptor?: GPUDeviceDescriptor): Promise<GPUDevice>
   requestAdapterInfo?(): Promise<GPUAdapterInfo>
 }
 
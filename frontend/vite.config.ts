@@ -21,6 +21,13 @@ export default defineConfig(({ command }) => ({
   },
   server: {
     port: 3000,
+    // Cross-origin isolation enables SharedArrayBuffer, which the audio
+    // worklet's shared ring needs (see src/services/audioRing.ts).
+    // 'credentialless' keeps the no-CORS font/CDN requests working.
+    headers: {
+      'Cross-Origin-Opener-Policy': 'same-origin',
+      'Cross-Origin-Embedder-Policy': 'credentialless',
+    },
     proxy: {
       '/api': {
         target: 'http://localhost:4000',
@@ -0,0 +1,411 @@
+/**
+ * Rendering Performance Regression Tests @perf
+ *
+ * Runs four stress scenes (many objects, many lights, a heavy glTF scene,
+ * a post-FX stack) on the project's backend and reads the runtime's own
+ * stats from window.allolib.perf: FPS and p95 frame time over a sampling
+ * window, draw calls in the last frame and the wasm / JS heap sizes.
+ *
+ * Each (scene, project) pair is compared with its baseline in
+ * baselines/perf/. A run fails when FPS drops, or p95 frame time, draw
+ * calls or heap size grow, by more than the tolerances below. A missing
+ * baseline is recorded instead; run with UPDATE_PERF_BASELINES=true
+ * (npm run test:perf:update) after an intended change, on the machine the
+ * baselines belong to. Frame times depend on the GPU, so baselines from
+ * one machine say little about another.
+ */
+
+import { test, expect, Page } from './fixtures'
+import * as fs from 'fs'
+import * as path from 'path'
+import {
+  COMPILE_TIMEOUT,
+  setBackend,
+  getBackendFromProject,
+  isWebGPUFunctional,
+} from './test-helpers'
+
+const BASELINE_DIR = path.join(__dirname, '../baselines/perf')
+const UPDATE_PERF_BASELINES = process.env.UPDATE_PERF_BASELINES === 'true'
+
+const WARMUP_MS = 3000 // Shader compiles, first uploads, glTF fetch
+const SAMPLE_MS = 6000
+
+// Allowed change against the baseline before the test fails
+const TOLERANCE = {
+  fps: 0.25, // Drop
+  p95Ms: 0.5, // Growth; the tail is noisier than the mean
+  drawCalls: 0.1, // Growth; deterministic for a given scene
+  heapBytes: 0.25, // Growth
+}
+
+interface PerfStats {
+  frames: number
+  totalFrames: number
+  fps: number
+  meanMs: number
+  p50Ms: number
+  p95Ms: number
+  p99Ms: number
+  maxMs: number
+  drawCalls: number
+  vertices: number
+  meshCacheBytes: number
+  wasmHeapBytes: number
+  jsHeapBytes: number | null
+}
+
+interface PerfBaseline {
+  scene: string
+  project: string
+  recordedAt: string
+  fps: number
+  p95Ms: number
+  drawCalls: number
+  wasmHeapBytes: number
+  jsHeapBytes: number | null
+}
+
+// ============================================================================
+// Scenes
+// ============================================================================
+
+const SCENES: { id: string; title: string; code: string }[] = [
+  {
+    id: 'many-objects',
+    title: 'many objects',
+    code: `
+#include "al_WebApp.hpp"
+#include "al/graphics/al_Shapes.hpp"
+using namespace al;
+
+// 2500 separately drawn cubes, each with its own transform and colour
+struct ManyObjectsApp : WebApp {
+  Mesh cube;
+  double t = 0;
+
+  void onCreate() override {
+    addCube(cube, 0.15);
+    cube.generateNormals();
+    nav().pos(0, 0, 14);
+  }
+
+  void onAnimate(double dt) override { t += dt; }
+
+  void onDraw(Graphics& g) override {
+    g.clear(0.05);
+    g.depthTesting(true);
+    for (int i = 0; i < 50; ++i) {
+      for (int j = 0; j < 50; ++j) {
+        g.pushMatrix();
+        g.translate(i * 0.3 - 7.35, j * 0.3 - 7.35, 0);
+        g.rotate(t * 40 + i * 7 + j * 3, 0, 1, 0);
+        g.color(i / 50.0, j / 50.0, 0.6);
+        g.draw(cube);
+        g.popMatrix();
+      }
+    }
+  }
+};
+
+ALLOLIB_WEB_MAIN(ManyObjectsApp)
+`,
+  },
+  {
+    id: 'many-lights',
+    title: 'many lights',
+    code: `
+#include "al_WebApp.hpp"
+#include "al/graphics/al_Shapes.hpp"
+#include <cmath>
+using namespace al;
+
+// Every light slot in use over a field of lit spheres
+struct ManyLightsApp : WebApp {
+  static const int kLights = 8;  // al_max_num_lights()
+  Mesh sphere;
+  Light lights[kLights];
+  double t = 0;
+
+  void onCreate() override {
+    addSphere(sphere, 0.3, 32, 32);
+    sphere.generateNormals();
+    nav().pos(0, 0, 10);
+  }
+
+  void onAnimate(double dt) override { t += dt; }
+
+  void onDraw(Graphics& g) override {
+    g.clear(0.02);
+    g.depthTesting(true);
+    g.lighting(true);
+    for (int i = 0; i < kLights; ++i) {
+      double a = t + i * 6.2832 / kLights;
+      lights[i].pos(4 * std::cos(a), 4 * std::sin(a), 2)
+          .diffuse(Color(HSV(i / float(kLights), 0.7, 1)));
+      g.light(lights[i], i);
+    }
+    for (int i = 0; i < 15; ++i) {
+      for (int j = 0; j < 15; ++j) {
+        g.pushMatrix();
+        g.translate(i * 0.7 - 4.9, j * 0.7 - 4.9, 0);
+        g.color(0.9);
+        g.draw(sphere);
+        g.popMatrix();
+      }
+    }
+    g.lighting(false);
+  }
+};
+
+ALLOLIB_WEB_MAIN(ManyLightsApp)
+`,
+  },
+  {
+    id: 'big-gltf',
+    title: 'big glTF scene',
+    code: `
+#include "al_WebApp.hpp"
+#include "al_WebGLTF.hpp"
+using namespace al;
+
+// The bundled Duck.glb drawn 400 times: a few million triangles a frame
+struct BigGLTFApp : WebApp {
+  WebGLTF duck;
+  double t = 0;
+
+  void onCreate() override {
+    duck.load("/assets/meshes/Duck.glb");
+    nav().pos(0, 0, 2400);
+  }
+
+  void onAnimate(double dt) override { t += dt; }
+
+  void onDraw(Graphics& g) override {
+    g.clear(0.1);
+    g.depthTesting(true);
+    g.lighting(true);
+    if (!duck.ready()) return;
+    for (int i = 0; i < 20; ++i) {
+      for (int j = 0; j < 20; ++j) {
+        g.pushMatrix();
+        g.translate(i * 180.0 - 1710, j * 180.0 - 1710, 0);
+        g.rotate(t * 30 + i * 11 + j * 5, 0, 1, 0);
+        g.color(1, 0.85, 0.2);
+        g.draw(duck.mesh());
+        g.popMatrix();
+      }
+    }
+    g.lighting(false);
+  }
+};
+
+ALLOLIB_WEB_MAIN(BigGLTFApp)
+`,
+  },
+  {
+    id: 'post-fx',
+    title: 'post-FX stack',
+    code: `
+#include "al_WebApp.hpp"
+#include "al/graphics/al_Shapes.hpp"
+#include "_studio_shared/post_fx.hpp"
+using namespace al;
+using studio::FX;
+
+// A modest scene under every effect the chain has
+struct PostFXApp : WebApp {
+  studio::PostFXChain fx;
+  Mesh sphere;
+  double t = 0;
+
+  void onCreate() override {
+    addSphere(sphere, 0.4, 48, 48);
+    sphere.generateNormals();
+    fx.init(fbWidth(), fbHeight());
+    fx.push(FX::Phosphor, 0.9f);
+    fx.push(FX::Bloom, 0.6f);
+    fx.push(FX::ChromaticAberration, 0.5f);
+    fx.push(FX::Glitch, 0.3f);
+    fx.push(FX::Vignette, 0.4f);
+    nav().pos(0, 0, 6);
+  }
+
+  void onAnimate(double dt) override { t += dt; }
+
+  void onResize(int w, int h) override { fx.resize(fbWidth(), fbHeight()); }
+
+  void onDraw(Graphics& g) override {
+    fx.beginCapture();
+    g.clear(0);
+    g.depthTesting(true);
+    g.lighting(true);
+    for (int i = 0; i < 25; ++i) {
+      g.pushMatrix();
+      g.translate((i % 5) - 2.0, (i / 5) - 2.0, 0);
+      g.rotate(t * 50 + i * 13, 1, 1, 0);
+      g.color(HSV(i / 25.0, 0.8, 1));
+      g.draw(sphere);
+      g.popMatrix();
+    }
+    g.lighting(false);
+    fx.endCaptureAndRender(g);
+  }
+};
+
+ALLOLIB_WEB_MAIN(PostFXApp)
+`,
+  },
+]
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+/**
+ * Load `code` into the editor and run it; true once the app is running and
+ * window.allolib.perf is registered
+ */
+async function runScene(page: Page, code: string, backend: 'webgl2' | 'webgpu'): Promise<boolean> {
+  await page.goto('/')
+  await page.evaluate(() => {
+    localStorage.removeItem('allolib-project')
+    localStorage.removeItem('allolib-code')
+    localStorage.removeItem('unified-project')
+  })
+  // Also turns auto-LOD off, which would trade triangles for frame time
+  await setBackend(page, backend)
+  await page.reload()
+  await page.waitForLoadState('networkidle')
+  await page.waitForTimeout(1000)
+
+  await page.evaluate((code) => {
+    const win = window as any
+    if (win.__stores?.project) {
+      const projectStore = win.__stores.project
+      projectStore.updateFileContent(projectStore.project?.activeFile || 'main.cpp', code)
+    }
+    if (win.monaco?.editor) {
+      const models = win.monaco.editor.getModels()
+      if (models?.length > 0) models[0].setValue(code)
+    }
+  }, code)
+  await page.waitForTimeout(500)
+
+  await page.locator('[data-testid="run-button"]').first().click()
+  try {
+    await page.waitForFunction(() => !!(window as any).allolib?.perf?.getStats(), null, {
+      timeout: COMPILE_TIMEOUT,
+    })
+    return true
+  } catch {
+    return false
+  }
+}
+
+/**
+ * Stats over SAMPLE_MS after a warm-up. Draw calls and heap sizes are the
+ * largest seen while sampling.
+ */
+async function samplePerf(page: Page): Promise<PerfStats> {
+  await page.waitForTimeout(WARMUP_MS)
+  await page.evaluate(() => (window as any).allolib.perf.reset())
+
+  let peak: PerfStats | null = null
+  for (let elapsed = 0; elapsed < SAMPLE_MS; elapsed += 1000) {
+    await page.waitForTimeout(1000)
+    const s: PerfStats = await page.evaluate(() => (window as any).allolib.perf.getStats())
+    peak = peak ?? s
+    peak.drawCalls = Math.max(peak.drawCalls, s.drawCalls)
+    peak.wasmHeapBytes = Math.max(peak.wasmHeapBytes, s.wasmHeapBytes)
+    if (s.jsHeapBytes !== null) peak.jsHeapBytes = Math.max(peak.jsHeapBytes ?? 0, s.jsHeapBytes)
+  }
+
+  // Frame times cover the whole window, so take them from the last read
+  const last: PerfStats = await page.evaluate(() => (window as any).allolib.perf.getStats())
+  return { ...last, drawCalls: peak!.drawCalls, wasmHeapBytes: peak!.wasmHeapBytes, jsHeapBytes: peak!.jsHeapBytes }
+}
+
+function baselinePath(scene: string, project: string): string {
+  return path.join(BASELINE_DIR, `${scene}-${project}.json`)
+}
+
+/** Regressions beyond TOLERANCE, one message each */
+function compareWithBaseline(stats: PerfStats, base: PerfBaseline): string[] {
+  const failures: string[] = []
+  const grew = (name: string, now: number, was: number, tolerance: number) => {
+    if (was > 0 && now > was * (1 + tolerance)) {
+      failures.push(`${name} ${now.toFixed(1)} vs baseline ${was.toFixed(1)} (+${((now / was - 1) * 100).toFixed(0)}%)`)
+    }
+  }
+
+  if (base.fps > 0 && stats.fps < base.fps * (1 - TOLERANCE.fps)) {
+    failures.push(`FPS ${stats.fps.toFixed(1)} vs baseline ${base.fps.toFixed(1)} (-${((1 - stats.fps / base.fps) * 100).toFixed(0)}%)`)
+  }
+  grew('p95 frame ms', stats.p95Ms, base.p95Ms, TOLERANCE.p95Ms)
+  grew('draw calls', stats.drawCalls, base.drawCalls, TOLERANCE.drawCalls)
+  grew('wasm heap bytes', stats.wasmHeapBytes, base.wasmHeapBytes, TOLERANCE.heapBytes)
+  if (stats.jsHeapBytes !== null && base.jsHeapBytes !== null) {
+    grew('JS heap bytes', stats.jsHeapBytes, base.jsHeapBytes, TOLERANCE.heapBytes)
+  }
+  return failures
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test.describe('Rendering performance regressions @perf', () => {
+  // Scenes running side by side would measure each other
+  test.describe.configure({ mode: 'serial' })
+  test.setTimeout(COMPILE_TIMEOUT + 60000)
+
+  test.beforeAll(() => {
+    fs.mkdirSync(BASELINE_DIR, { recursive: true })
+  })
+
+  for (const scene of SCENES) {
+    test(`${scene.title}`, async ({ page }, testInfo) => {
+      const project = testInfo.project.name
+      const backend = getBackendFromProject(project)
+      if (backend === 'webgpu') {
+        await page.goto('/')
+        test.skip(!(await isWebGPUFunctional(page)), 'WebGPU not functional')
+      }
+
+      const started = await runScene(page, scene.code, backend)
+      expect(started, `${scene.id} did not start`).toBe(true)
+
+      const stats = await samplePerf(page)
+      console.log(`  [perf] ${scene.id} (${project}): ${stats.fps.toFixed(1)} fps, ` +
+        `p95 ${stats.p95Ms.toFixed(2)} ms, ${stats.drawCalls} draws, ` +
+        `wasm heap ${(stats.wasmHeapBytes / 1048576).toFixed(1)} MB`)
+      await testInfo.attach(`perf-${scene.id}.json`, {
+        body: JSON.stringify(stats, null, 2),
+        contentType: 'application/json',
+      })
+      expect(stats.frames, 'no frames rendered while sampling').toBeGreaterThan(0)
+
+      const file = baselinePath(scene.id, project)
+      if (UPDATE_PERF_BASELINES || !fs.existsSync(file)) {
+        const baseline: PerfBaseline = {
+          scene: scene.id,
+          project,
+          recordedAt: new Date().toISOString(),
+          fps: stats.fps,
+          p95Ms: stats.p95Ms,
+          drawCalls: stats.drawCalls,
+          wasmHeapBytes: stats.wasmHeapBytes,
+          jsHeapBytes: stats.jsHeapBytes,
+        }
+        fs.writeFileSync(file, JSON.stringify(baseline, null, 2) + '\n')
+        console.log('  Saved perf baseline:', file)
+        return
+      }
+
+      const base: PerfBaseline = JSON.parse(fs.readFileSync(file, 'utf8'))
+      const failures = compareWithBaseline(stats, base)
+      expect(failures, `${scene.id} regressed against ${path.basename(file)}`).toEqual([])
+    })
+  }
+})